@@ -17,28 +17,134 @@
 
 #include "Base.hh"
 
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
+#include <BulletCollision/CollisionDispatch/btManifoldResult.h>
+#include <LinearMath/btThreads.h>
+
+#include <gz/common/SubMesh.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
 #include <utility>
+#include <vector>
 
 namespace gz {
 namespace physics {
 namespace bullet_featherstone {
 
+/////////////////////////////////////////////////
+/// \brief Value of the second user index of the colliders of this plugin
+/// whose contacts record the child of their compound shape that was hit.
+/// Other colliders may use the contact added callback too, and are left
+/// to the callback that was installed before this plugin's.
+static constexpr int kRecordsCompoundChildIndex = 0x677a6266;
+
+/// \brief Contact added callback that was installed before
+/// RecordCompoundChildIndices, which is called for all contacts.
+static ContactAddedCallback gPreviousContactAddedCallback = nullptr;
+
+/// \brief Guards installing RecordCompoundChildIndices, since worlds may be
+/// created concurrently.
+static std::mutex gContactAddedCallbackMutex;
+
+/////////////////////////////////////////////////
+/// \brief Have the contacts of a collider record the child of its compound
+/// shape that was hit, see RecordCompoundChildIndices.
+/// \param[in,out] _collider The collider.
+static void EnableCompoundChildIndices(btCollisionObject &_collider)
+{
+  _collider.setUserIndex2(kRecordsCompoundChildIndex);
+  _collider.setCollisionFlags(_collider.getCollisionFlags() |
+    btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the index of the child of the collider's root compound shape
+/// that a collision query is processing.
+/// \param[in] _wrap Innermost wrapper of the collision query.
+/// \param[in] _index Current shape identifier of the contact.
+/// \return Index of the child shape, or _index if the collider does not
+/// record child indices.
+static int CompoundChildIndex(
+    const btCollisionObjectWrapper *_wrap, int _index)
+{
+  if (!_wrap ||
+      _wrap->getCollisionObject()->getUserIndex2() !=
+        kRecordsCompoundChildIndex)
+  {
+    return _index;
+  }
+
+  // Wrappers form a chain from the current (possibly nested) child shape up
+  // to the root shape of the collision object. The wrapper just below the
+  // root holds the index of the child of the root compound shape.
+  const btCollisionObjectWrapper *child = _wrap;
+  while (child->m_parent && child->m_parent->m_parent)
+    child = child->m_parent;
+
+  return child->m_parent ? child->m_index : -1;
+}
+
+/////////////////////////////////////////////////
+/// \brief Contact added callback that replaces the shape identifiers of
+/// contacts on link colliders with the index of the child of the link's
+/// compound shape that was hit. Bullet otherwise stores triangle indices there
+/// for mesh shapes, and the child index is lost.
+static bool RecordCompoundChildIndices(
+    btManifoldPoint &_cp,
+    const btCollisionObjectWrapper *_colObj0Wrap, int _partId0,
+    int _index0,
+    const btCollisionObjectWrapper *_colObj1Wrap, int _partId1,
+    int _index1)
+{
+  // The previous callback sees the contact as bullet reported it
+  bool modified = false;
+  if (gPreviousContactAddedCallback)
+  {
+    modified = gPreviousContactAddedCallback(_cp, _colObj0Wrap, _partId0,
+      _index0, _colObj1Wrap, _partId1, _index1);
+  }
+  _cp.m_index0 = CompoundChildIndex(_colObj0Wrap, _cp.m_index0);
+  _cp.m_index1 = CompoundChildIndex(_colObj1Wrap, _cp.m_index1);
+  return modified;
+}
+
 /////////////////////////////////////////////////
 WorldInfo::WorldInfo(std::string name_)
   : name(std::move(name_))
 {
   this->collisionConfiguration =
     std::make_unique<btDefaultCollisionConfiguration>();
+  // The multithreaded dispatcher runs the narrowphase of the overlapping
+  // pairs through bullet's task scheduler. It behaves like a plain
+  // btCollisionDispatcher when the sequential scheduler is in use.
   this->dispatcher =
-    std::make_unique<btCollisionDispatcher>(collisionConfiguration.get());
+    std::make_unique<GzCollisionDispatcher>(collisionConfiguration.get());
   this->broadphase = std::make_unique<btDbvtBroadphase>();
-  this->solver = std::make_unique<btMultiBodyConstraintSolver>();
-  this->world = std::make_unique<btMultiBodyDynamicsWorld>(
+  this->solver = std::make_unique<GzMultiBodyConstraintSolver>();
+  this->world = std::make_unique<GzMultiBodyDynamicsWorld>(
     dispatcher.get(), broadphase.get(), solver.get(),
     collisionConfiguration.get());
 
   btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher.get());
 
+  {
+    // Chain to a callback that was installed before, e.g. by the
+    // application, rather than replace it
+    std::lock_guard<std::mutex> lock(gContactAddedCallbackMutex);
+    if (gContactAddedCallback != &RecordCompoundChildIndices)
+    {
+      gPreviousContactAddedCallback = gContactAddedCallback;
+      gContactAddedCallback = &RecordCompoundChildIndices;
+    }
+  }
+
   // Needed for force-torque sensor
   this->world->getSolverInfo().m_jointFeedbackInJointFrame = true;
   this->world->getSolverInfo().m_jointFeedbackInWorldSpace = false;
@@ -56,6 +162,610 @@ WorldInfo::WorldInfo(std::string name_)
   this->world->getSolverInfo().m_numIterations = 50u;
 }
 
+/////////////////////////////////////////////////
+ModelJointConstraint &JointConstraintsOf(
+    WorldInfo &_worldInfo, btMultiBody *_body)
+{
+  auto &constraint = _worldInfo.jointConstraints[_body];
+  if (!constraint)
+  {
+    constraint = std::make_unique<ModelJointConstraint>(_body);
+    _worldInfo.world->addMultiBodyConstraint(constraint.get());
+  }
+  return *constraint;
+}
+
+/////////////////////////////////////////////////
+/// \brief Pair test result that records whether any contact point was found.
+struct AnyContactCallback : public btCollisionWorld::ContactResultCallback
+{
+  btScalar addSingleResult(
+      btManifoldPoint &/*_point*/,
+      const btCollisionObjectWrapper */*_object0*/, int /*_part0*/,
+      int /*_index0*/,
+      const btCollisionObjectWrapper */*_object1*/, int /*_part1*/,
+      int /*_index1*/) override
+  {
+    this->found = true;
+    return 0;
+  }
+
+  bool found = false;
+};
+
+/////////////////////////////////////////////////
+std::vector<bool> SampleNeverCollidingLinkPairs(
+    btCollisionWorld &_world, btMultiBody &_body, std::size_t _numSamples)
+{
+  const int numLinks = _body.getNumLinks();
+  if (_numSamples == 0u || numLinks < 1 || !_body.hasSelfCollision())
+    return {};
+
+  // Range of each single degree of freedom joint. Joints without a finite
+  // range cannot be sampled, except revolute joints, which turn at most
+  // once around.
+  std::vector<std::pair<btScalar, btScalar>> ranges(
+      static_cast<std::size_t>(numLinks), {btScalar(0), btScalar(0)});
+  for (int i = 0; i < numLinks; ++i)
+  {
+    const btMultibodyLink &link = _body.getLink(i);
+    const btScalar lower = link.m_jointLowerLimit;
+    const btScalar upper = link.m_jointUpperLimit;
+    const bool limited = std::isfinite(lower) && std::isfinite(upper) &&
+        lower <= upper;
+    auto &range = ranges[static_cast<std::size_t>(i)];
+    if (link.m_jointType == btMultibodyLink::eRevolute)
+    {
+      if (limited && upper - lower < SIMD_2_PI)
+        range = {lower, upper};
+      else
+        range = {-SIMD_PI, SIMD_PI};
+    }
+    else if (link.m_jointType == btMultibodyLink::ePrismatic)
+    {
+      // The default limits of SDF are not a range worth sampling
+      if (!limited || upper - lower > btScalar(1e3))
+        return {};
+      range = {lower, upper};
+    }
+    else if (link.m_jointType != btMultibodyLink::eFixed)
+    {
+      return {};
+    }
+  }
+
+  // Index 0 is the base and i + 1 is link i
+  const std::size_t numColliders = static_cast<std::size_t>(numLinks) + 1u;
+  std::vector<btMultiBodyLinkCollider *> colliders(numColliders, nullptr);
+  colliders[0] = _body.getBaseCollider();
+  for (int i = 0; i < numLinks; ++i)
+    colliders[static_cast<std::size_t>(i) + 1u] = _body.getLink(i).m_collider;
+
+  // Pairs that bullet tests, and that were not in collision yet
+  std::vector<std::pair<std::size_t, std::size_t>> candidates;
+  for (std::size_t a = 0; a < numColliders; ++a)
+  {
+    for (std::size_t b = a + 1u; b < numColliders; ++b)
+    {
+      if (colliders[a] && colliders[b] &&
+          colliders[a]->checkCollideWith(colliders[b]))
+      {
+        candidates.emplace_back(a, b);
+      }
+    }
+  }
+  if (candidates.empty())
+    return {};
+
+  std::vector<btScalar> positions(static_cast<std::size_t>(numLinks), 0);
+  for (int i = 0; i < numLinks; ++i)
+  {
+    if (_body.getLink(i).m_dofCount == 1)
+      positions[static_cast<std::size_t>(i)] = _body.getJointPos(i);
+  }
+
+  // The seed is fixed so that a model gets the same pairs on every load.
+  // The first sample is the configuration the model was loaded at.
+  std::mt19937 random(0u);
+  btAlignedObjectArray<btQuaternion> worldToLocal;
+  btAlignedObjectArray<btVector3> localOrigin;
+  for (std::size_t s = 0; s < _numSamples && !candidates.empty(); ++s)
+  {
+    for (int i = 0; s > 0u && i < numLinks; ++i)
+    {
+      if (_body.getLink(i).m_dofCount != 1)
+        continue;
+      const auto &range = ranges[static_cast<std::size_t>(i)];
+      _body.setJointPos(i, std::uniform_real_distribution<btScalar>(
+          range.first, range.second)(random));
+    }
+    _body.forwardKinematics(worldToLocal, localOrigin);
+    _body.updateCollisionObjectWorldTransforms(worldToLocal, localOrigin);
+
+    for (std::size_t c = 0; c < candidates.size();)
+    {
+      AnyContactCallback result;
+      _world.contactPairTest(colliders[candidates[c].first],
+                             colliders[candidates[c].second], result);
+      if (result.found)
+      {
+        candidates[c] = candidates.back();
+        candidates.pop_back();
+      }
+      else
+      {
+        ++c;
+      }
+    }
+  }
+
+  for (int i = 0; i < numLinks; ++i)
+  {
+    if (_body.getLink(i).m_dofCount == 1)
+      _body.setJointPos(i, positions[static_cast<std::size_t>(i)]);
+  }
+  _body.forwardKinematics(worldToLocal, localOrigin);
+  _body.updateCollisionObjectWorldTransforms(worldToLocal, localOrigin);
+
+  if (candidates.empty())
+    return {};
+
+  std::vector<bool> pairs(numColliders * numColliders, false);
+  for (const auto &[a, b] : candidates)
+  {
+    pairs[a * numColliders + b] = true;
+    pairs[b * numColliders + a] = true;
+  }
+  return pairs;
+}
+
+/////////////////////////////////////////////////
+void StepBulletWorldWithThreads(WorldInfo &_worldInfo, btScalar _stepSize,
+    std::size_t _numThreads, const std::shared_ptr<TaskScheduler> &_scheduler)
+{
+  // Held exclusively while the scheduler is switched or used by more than
+  // one thread, and shared by the steps on the sequential scheduler.
+  static std::shared_mutex schedulerMutex;
+
+  if (_numThreads > 1u)
+  {
+    std::unique_lock<std::shared_mutex> lock(schedulerMutex);
+    bullet::UseBulletThreads(_numThreads, _scheduler);
+    StepBulletWorld(_worldInfo, _stepSize);
+    return;
+  }
+
+  std::shared_lock<std::shared_mutex> lock(schedulerMutex);
+  while (btGetTaskScheduler() != btGetSequentialTaskScheduler())
+  {
+    // A multithreaded step left its scheduler in place
+    lock.unlock();
+    {
+      std::unique_lock<std::shared_mutex> switchLock(schedulerMutex);
+      bullet::UseBulletThreads(1u);
+    }
+    lock.lock();
+  }
+  StepBulletWorld(_worldInfo, _stepSize);
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the velocities of all multibodies of a world to
+/// _velocities, which only allocates if the world gained degrees of freedom.
+static void MultiBodyVelocities(
+    const btMultiBodyDynamicsWorld &_world, std::vector<btScalar> &_velocities)
+{
+  _velocities.clear();
+  for (int i = 0; i < _world.getNumMultibodies(); ++i)
+  {
+    const btMultiBody *body = _world.getMultiBody(i);
+    const btScalar *velocities = body->getVelocityVector();
+    _velocities.insert(_velocities.end(), velocities,
+                       velocities + 6 + body->getNumDofs());
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the largest change of a velocity of the multibodies of a world
+/// since MultiBodyVelocities wrote _velocities.
+static double MaxVelocityChange(
+    const btMultiBodyDynamicsWorld &_world,
+    const std::vector<btScalar> &_velocities)
+{
+  double change = 0.0;
+  std::size_t k = 0;
+  for (int i = 0; i < _world.getNumMultibodies(); ++i)
+  {
+    const btMultiBody *body = _world.getMultiBody(i);
+    const btScalar *velocities = body->getVelocityVector();
+    for (int j = 0; j < 6 + body->getNumDofs(); ++j)
+    {
+      if (k >= _velocities.size())
+        return change;
+      change = std::max(change, static_cast<double>(
+          btFabs(velocities[j] - _velocities[k++])));
+    }
+  }
+  return change;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the deepest penetration between two colliders of a world.
+static double MaxPenetration(btMultiBodyDynamicsWorld &_world)
+{
+  double penetration = 0.0;
+  auto *dispatcher = _world.getDispatcher();
+  for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+  {
+    const btPersistentManifold *manifold =
+        dispatcher->getManifoldByIndexInternal(i);
+    for (int j = 0; j < manifold->getNumContacts(); ++j)
+    {
+      penetration = std::max(penetration,
+          -static_cast<double>(manifold->getContactPoint(j).getDistance()));
+    }
+  }
+  return penetration;
+}
+
+/////////////////////////////////////////////////
+btScalar NextBulletStepSize(const WorldInfo &_worldInfo, btScalar _stepSize)
+{
+  return static_cast<btScalar>(_worldInfo.adaptiveTimeStep.NextStepSize(
+      static_cast<double>(_stepSize)));
+}
+
+/////////////////////////////////////////////////
+void StepBulletWorld(WorldInfo &_worldInfo, btScalar _stepSize)
+{
+  const bool adaptive = _worldInfo.adaptiveTimeStep.Enabled();
+  if (adaptive)
+  {
+    _stepSize = NextBulletStepSize(_worldInfo, _stepSize);
+    MultiBodyVelocities(*_worldInfo.world, _worldInfo.preStepVelocities);
+  }
+  _worldInfo.lastStepSize = static_cast<double>(_stepSize);
+  _worldInfo.time += static_cast<double>(_stepSize);
+
+  const std::size_t subSteps = _worldInfo.subSteps;
+  if (subSteps <= 1u)
+  {
+    _worldInfo.world->stepSimulation(_stepSize, 1, _stepSize);
+  }
+  else
+  {
+    // Bullet runs as many fixed substeps as fit in the time it has
+    // accumulated and carries the rest over to the next call. Half a
+    // substep of slack keeps rounding from dropping a substep, and the one
+    // extra substep that the slack adds up to every other call is clamped
+    // away. Bullet clears the applied forces once, after the last substep.
+    const btScalar fixedStep = _stepSize / static_cast<btScalar>(subSteps);
+    _worldInfo.world->stepSimulation(
+        fixedStep * (static_cast<btScalar>(subSteps) + btScalar(0.5)),
+        static_cast<int>(subSteps), fixedStep);
+  }
+
+  // Bullet finds the contacts before it moves the bodies, so the deepest
+  // penetration is the one that the step started from and resolved
+  if (adaptive)
+  {
+    _worldInfo.adaptiveTimeStep.Update(
+        static_cast<double>(_stepSize),
+        MaxPenetration(*_worldInfo.world),
+        MaxVelocityChange(*_worldInfo.world, _worldInfo.preStepVelocities));
+  }
+}
+
+/////////////////////////////////////////////////
+Identity Base::AddLinkCollision(
+    CollisionInfo _collisionInfo,
+    const ColliderSurfaceInfo &_surface,
+    bool _isStatic,
+    bool _bake)
+{
+  const Identity linkID = _collisionInfo.link;
+  auto *linkInfo = this->ReferenceInterface<LinkInfo>(linkID);
+  auto *model = this->ReferenceInterface<ModelInfo>(linkInfo->model);
+  btCollisionShape *shape = _collisionInfo.collider.get();
+
+  const btTransform btInertialToCollision = convertTf(
+    linkInfo->inertiaToLinkFrame * _collisionInfo.linkToCollision);
+
+  int linkIndexInModel = -1;
+  if (linkInfo->indexInModel.has_value())
+    linkIndexInModel = *linkInfo->indexInModel;
+
+  // The new collision was not part of the sampled configurations, see
+  // SampleNeverCollidingLinkPairs, so all pairs of the model are tested again
+  if (auto *dispatcher = dynamic_cast<GzCollisionDispatcher *>(
+          this->ReferenceInterface<WorldInfo>(model->world)->dispatcher.get()))
+  {
+    dispatcher->RemoveIgnoredLinkPairs(model->body.get());
+  }
+
+  // Infinite planes of links without other baked collisions get a collider
+  // of their own, which the dispatcher tests without the broadphase, see
+  // GzCollisionDispatcher::AddPlaneCollider. Later collisions of the link
+  // join that collider.
+  if (_bake && !linkInfo->collider && (linkInfo->shape ||
+      shape->getShapeType() != STATIC_PLANE_PROXYTYPE))
+  {
+    // The link keeps a compound shape of its baked collisions for its
+    // bounding box, but it has no collider of its own.
+    if (!linkInfo->shape)
+      linkInfo->shape = std::make_unique<btCompoundShape>();
+    linkInfo->shape->addChildShape(btInertialToCollision, shape);
+
+    btTransform linkTf = model->body->getBaseWorldTransform();
+    if (linkIndexInModel >= 0)
+    {
+      linkTf = btTransform(
+        model->body->localFrameToWorld(
+          linkIndexInModel, btMatrix3x3::getIdentity()),
+        model->body->localPosToWorld(linkIndexInModel, btVector3(0, 0, 0)));
+    }
+
+    auto *world = this->ReferenceInterface<WorldInfo>(model->world);
+    const auto collisionID = this->AddCollision(std::move(_collisionInfo));
+    this->AddBakedCollision(*world, linkTf * btInertialToCollision, shape,
+      collisionID.id, _surface);
+    return collisionID;
+  }
+
+  // Index of the shape in the compound shape of the link, if it is added
+  int childIndex = -1;
+  if (!linkInfo->collider)
+  {
+    linkInfo->shape = std::make_unique<btCompoundShape>();
+
+    // NOTE: Bullet does not appear to support different surface properties
+    // for different shapes attached to the same link.
+    linkInfo->collider = std::make_unique<btMultiBodyLinkCollider>(
+      model->body.get(), linkIndexInModel);
+
+    linkInfo->shape->addChildShape(btInertialToCollision, shape);
+    childIndex = linkInfo->shape->getNumChildShapes() - 1;
+
+    linkInfo->collider->setCollisionShape(linkInfo->shape.get());
+    // Let contact readout find the link of this collider without a search
+    linkInfo->collider->setUserIndex(static_cast<int>(std::size_t(linkID)));
+    // Have contacts record which child shape they hit
+    EnableCompoundChildIndices(*linkInfo->collider);
+    linkInfo->collider->setRestitution(
+      static_cast<btScalar>(_surface.restitution));
+    linkInfo->collider->setRollingFriction(
+      static_cast<btScalar>(_surface.rollingFriction));
+    linkInfo->collider->setSpinningFriction(
+      static_cast<btScalar>(_surface.torsionalCoefficient));
+    linkInfo->collider->setFriction(static_cast<btScalar>(_surface.mu));
+    linkInfo->collider->setAnisotropicFriction(
+      btVector3(static_cast<btScalar>(_surface.mu),
+                static_cast<btScalar>(_surface.mu2), 1),
+      btCollisionObject::CF_ANISOTROPIC_FRICTION);
+
+    if (_surface.softContacts)
+    {
+      // \todo(iche033) load <kp> and <kd> values from SDF
+      const btScalar kp = btScalar(1e15);
+      const btScalar kd = btScalar(1e14);
+      linkInfo->collider->setContactStiffnessAndDamping(kp, kd);
+    }
+
+    if (linkIndexInModel >= 0)
+    {
+      model->body->getLink(linkIndexInModel).m_collider =
+        linkInfo->collider.get();
+      const auto p = model->body->localPosToWorld(
+        linkIndexInModel, btVector3(0, 0, 0));
+      const auto rot = model->body->localFrameToWorld(
+        linkIndexInModel, btMatrix3x3::getIdentity());
+      linkInfo->collider->setWorldTransform(btTransform(rot, p));
+    }
+    else
+    {
+      model->body->setBaseCollider(linkInfo->collider.get());
+      linkInfo->collider->setWorldTransform(
+        model->body->getBaseWorldTransform());
+    }
+
+    auto *world = this->ReferenceInterface<WorldInfo>(model->world);
+
+    if (_isStatic)
+    {
+      world->world->addCollisionObject(
+        linkInfo->collider.get(),
+        btBroadphaseProxy::StaticFilter,
+        btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
+    }
+    else
+    {
+      world->world->addCollisionObject(
+        linkInfo->collider.get(),
+        btBroadphaseProxy::DefaultFilter,
+        btBroadphaseProxy::AllFilter);
+    }
+  }
+  else if (linkInfo->shape)
+  {
+    linkInfo->shape->addChildShape(btInertialToCollision, shape);
+    childIndex = linkInfo->shape->getNumChildShapes() - 1;
+
+    // A plane collider goes through the broadphase once it has other shapes
+    this->ReferenceInterface<WorldInfo>(model->world)->world
+      ->UpdatePlaneCollider(linkInfo->collider.get());
+  }
+  else
+  {
+    // TODO(MXG): Maybe we should check if the new collider's properties
+    // match the existing collider and issue a warning if they don't.
+  }
+
+  const auto collisionID = this->AddCollision(std::move(_collisionInfo));
+
+  if (childIndex >= 0)
+  {
+    auto &childToCollision = linkInfo->childIndexToCollisionEntityId;
+    if (childToCollision.size() <= static_cast<std::size_t>(childIndex))
+    {
+      childToCollision.resize(static_cast<std::size_t>(childIndex) + 1,
+        std::numeric_limits<std::size_t>::max());
+    }
+    childToCollision[static_cast<std::size_t>(childIndex)] = collisionID.id;
+  }
+
+  return collisionID;
+}
+
+/////////////////////////////////////////////////
+void Base::AddBakedCollision(
+    WorldInfo &_world,
+    const btTransform &_worldToCollision,
+    btCollisionShape *_shape,
+    std::size_t _collisionID,
+    const ColliderSurfaceInfo &_surface)
+{
+  if (!_world.bakedStatic)
+  {
+    auto baked = std::make_unique<BakedStaticCollisions>();
+    baked->shape = std::make_unique<btCompoundShape>();
+    baked->collider = std::make_unique<btCollisionObject>();
+    baked->collider->setCollisionShape(baked->shape.get());
+    // The collider belongs to no link, see SimulationFeatures::
+    // FindLinkOfCollider, and its contacts record the child they hit.
+    baked->collider->setUserIndex(-1);
+    baked->collider->setCollisionFlags(
+      baked->collider->getCollisionFlags() |
+      btCollisionObject::CF_STATIC_OBJECT);
+    EnableCompoundChildIndices(*baked->collider);
+    // NOTE: Bullet only supports one set of surface properties per collider,
+    // so they are taken from the first baked collision.
+    baked->collider->setRestitution(
+      static_cast<btScalar>(_surface.restitution));
+    baked->collider->setRollingFriction(
+      static_cast<btScalar>(_surface.rollingFriction));
+    baked->collider->setSpinningFriction(
+      static_cast<btScalar>(_surface.torsionalCoefficient));
+    baked->collider->setFriction(static_cast<btScalar>(_surface.mu));
+    baked->collider->setAnisotropicFriction(
+      btVector3(static_cast<btScalar>(_surface.mu),
+                static_cast<btScalar>(_surface.mu2), 1),
+      btCollisionObject::CF_ANISOTROPIC_FRICTION);
+    if (_surface.softContacts)
+    {
+      const btScalar kp = btScalar(1e15);
+      const btScalar kd = btScalar(1e14);
+      baked->collider->setContactStiffnessAndDamping(kp, kd);
+    }
+
+    _world.world->addCollisionObject(
+      baked->collider.get(),
+      btBroadphaseProxy::StaticFilter,
+      btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
+    _world.bakedStatic = std::move(baked);
+  }
+
+  auto &baked = *_world.bakedStatic;
+  baked.shape->addChildShape(_worldToCollision, _shape);
+  const int childIndex = baked.shape->getNumChildShapes() - 1;
+  baked.childIndexToCollisionEntityId.push_back(_collisionID);
+  baked.collisionEntityIdToChildIndex[_collisionID] = childIndex;
+
+  // Static objects are not refit by every step
+  _world.world->updateSingleAabb(baked.collider.get());
+}
+
+/////////////////////////////////////////////////
+void Base::RemoveBakedCollision(WorldInfo &_world, std::size_t _collisionID)
+{
+  if (!_world.bakedStatic)
+    return;
+
+  auto &baked = *_world.bakedStatic;
+  const auto it = baked.collisionEntityIdToChildIndex.find(_collisionID);
+  if (it == baked.collisionEntityIdToChildIndex.end())
+    return;
+
+  // Bullet moves the last child into the place of the removed one
+  const int childIndex = it->second;
+  baked.collisionEntityIdToChildIndex.erase(it);
+  baked.shape->removeChildShapeByIndex(childIndex);
+  baked.shape->recalculateLocalAabb();
+
+  auto &children = baked.childIndexToCollisionEntityId;
+  children[static_cast<std::size_t>(childIndex)] = children.back();
+  children.pop_back();
+  if (static_cast<std::size_t>(childIndex) < children.size())
+  {
+    baked.collisionEntityIdToChildIndex[
+      children[static_cast<std::size_t>(childIndex)]] = childIndex;
+  }
+
+  // Contacts of the last step may refer to the old child indices
+  _world.world->getBroadphase()->getOverlappingPairCache()
+    ->cleanProxyFromPairs(baked.collider->getBroadphaseHandle(),
+                          _world.world->getDispatcher());
+  _world.world->updateSingleAabb(baked.collider.get());
+}
+
+/////////////////////////////////////////////////
+Base::MeshShapes Base::ConvexHullShapes(
+    const common::Mesh &_convexMesh,
+    const btVector3 &_scale)
+{
+  MeshShapes meshShapes;
+  for (std::size_t j = 0u; j < _convexMesh.SubMeshCount(); ++j)
+  {
+    auto submesh = _convexMesh.SubMeshByIndex(j).lock();
+    if (!submesh || submesh->VertexCount() == 0u)
+      continue;
+
+    // Each hull is centered on its centroid, which keeps the points close to
+    // the origin of the shape.
+    gz::math::Vector3d centroid;
+    for (std::size_t i = 0; i < submesh->VertexCount(); ++i)
+        centroid += submesh->Vertex(i);
+    centroid *= 1.0/static_cast<double>(submesh->VertexCount());
+    btAlignedObjectArray<btVector3> vertices;
+    for (std::size_t i = 0; i < submesh->VertexCount(); ++i)
+    {
+      gz::math::Vector3d v = submesh->Vertex(i) - centroid;
+      vertices.push_back(convertVec(v) * _scale);
+    }
+
+    float collisionMargin = 0.001f;
+    this->meshesConvex.push_back(std::make_unique<btConvexHullShape>(
+        &(vertices[0].getX()), vertices.size()));
+    auto *convexShape = this->meshesConvex.back().get();
+    convexShape->setMargin(collisionMargin);
+
+    btTransform trans;
+    trans.setIdentity();
+    trans.setOrigin(convertVec(centroid) * _scale);
+    meshShapes.emplace_back(trans, convexShape);
+  }
+  return meshShapes;
+}
+
+/////////////////////////////////////////////////
+bool Base::IsLinkFixed(const Identity &_linkID) const
+{
+  const auto *linkInfo = this->ReferenceInterface<LinkInfo>(_linkID);
+  const auto *model = this->ReferenceInterface<ModelInfo>(linkInfo->model);
+  if (!model->body->hasFixedBase())
+    return false;
+
+  // check if it's a base link
+  if (std::size_t(_linkID) ==
+      static_cast<std::size_t>(model->body->getUserIndex()))
+  {
+    return true;
+  }
+
+  // check if link has zero dofs
+  return linkInfo->indexInModel.has_value() &&
+      model->body->getLink(linkInfo->indexInModel.value()).m_dofCount == 0;
+}
+
 }  // namespace bullet_featherstone
 }  // namespace physics
 }  // namespace gz
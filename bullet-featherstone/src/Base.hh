@@ -18,16 +18,16 @@
 #ifndef GZ_PHYSICS_BULLET_FEATHERSTONE_BASE_HH_
 #define GZ_PHYSICS_BULLET_FEATHERSTONE_BASE_HH_
 
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
 #include <BulletCollision/CollisionShapes/btCollisionShape.h>
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
 #include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 #include <BulletDynamics/Featherstone/btMultiBody.h>
 #include <BulletDynamics/Featherstone/btMultiBodyConstraintSolver.h>
 #include <BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h>
-#include <BulletDynamics/Featherstone/btMultiBodyGearConstraint.h>
 #include <BulletDynamics/Featherstone/btMultiBodyJointFeedback.h>
-#include <BulletDynamics/Featherstone/btMultiBodyJointMotor.h>
-#include <BulletDynamics/Featherstone/btMultiBodyJointLimitConstraint.h>
 #include <BulletDynamics/Featherstone/btMultiBodyLinkCollider.h>
 #include <BulletDynamics/Featherstone/btMultiBodyFixedConstraint.h>
 #include <LinearMath/btVector3.h>
@@ -37,7 +37,12 @@
 #include <Eigen/Geometry>
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -46,8 +51,19 @@
 #include <vector>
 
 #include <gz/common/Console.hh>
+#include <gz/common/WorkerPool.hh>
 #include <gz/math/eigen3/Conversions.hh>
+#include <gz/physics/AdaptiveTimeStep.hh>
+#include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/Implements.hh>
+#include <gz/physics/TaskScheduler.hh>
+#include <gz/physics/bullet/TaskSchedulerBridge.hh>
+#include <gz/physics/mesh/MeshContentHash.hh>
+#include <gz/physics/mesh/PrimitiveFitting.hh>
+
+#include "BvhCache.hh"
+#include "GzMultiBodyDynamicsWorld.hh"
+#include "ModelJointConstraint.hh"
 
 namespace gz {
 namespace physics {
@@ -63,6 +79,21 @@ namespace bullet_featherstone {
 // Note: For Bullet library it's important the order in which the elements
 // are destroyed. The current implementation relies on C++ destroying the
 // elements in the opposite order stated in the structure
+/// \brief Collisions of static models merged into a single collider of
+/// their world, see sdf::BakeStaticCollisions.
+struct BakedStaticCollisions
+{
+  /// Shapes of the collisions in the world frame. Its dynamic AABB tree lets
+  /// bullet find the children near another collider.
+  std::unique_ptr<btCompoundShape> shape;
+  std::unique_ptr<btCollisionObject> collider;
+  /// Entity ID of the collision held by each child of `shape`, see
+  /// RecordCompoundChildIndices in Base.cc.
+  std::vector<std::size_t> childIndexToCollisionEntityId;
+  /// Index of the child of `shape` holding each collision entity.
+  std::unordered_map<std::size_t, int> collisionEntityIdToChildIndex;
+};
+
 struct WorldInfo
 {
   std::string name;
@@ -70,15 +101,101 @@ struct WorldInfo
   std::unique_ptr<btCollisionDispatcher> dispatcher;
   std::unique_ptr<btBroadphaseInterface> broadphase;
   std::unique_ptr<btMultiBodyConstraintSolver> solver;
-  std::unique_ptr<btMultiBodyDynamicsWorld> world;
+  std::unique_ptr<GzMultiBodyDynamicsWorld> world;
 
   std::unordered_map<int, std::size_t> modelIndexToEntityId;
   std::unordered_map<std::string, std::size_t> modelNameToEntityId;
   int nextModelIndex = 0;
 
+  /// Number of threads used to step this world, see UseBulletThreads
+  std::size_t numThreads = 1u;
+
+  /// Number of substeps of each step of this world, see StepBulletWorld
+  std::size_t subSteps = 1u;
+
+  /// Controller of the step size, see AdaptiveTimeStepFeature
+  AdaptiveTimeStep adaptiveTimeStep;
+
+  /// Velocities of the multibodies before a step with adaptive stepping,
+  /// reused from step to step
+  std::vector<btScalar> preStepVelocities;
+
+  /// Length of the last step, in seconds
+  double lastStepSize = 0.0;
+
+  /// Name of the broadphase in use, see WorldFeatures::SetWorldBroadphase
+  std::string broadphaseType = "dbvt";
+
+  /// Time spent writing the poses of the last step, in seconds
+  double poseWriteTime = 0.0;
+
+  /// Heap allocations of writing the poses of the last step
+  std::size_t poseWriteAllocations = 0u;
+
+  /// Simulation time of the world, the sum of the sizes of its steps
+  double time = 0.0;
+
+  /// Static collisions merged into one collider, or null if there are none
+  std::unique_ptr<BakedStaticCollisions> bakedStatic;
+
+  /// Joint motors, limits and mimic gears of each multibody that has any,
+  /// see JointConstraintsOf
+  std::unordered_map<const btMultiBody *,
+      std::unique_ptr<ModelJointConstraint>> jointConstraints;
+
   explicit WorldInfo(std::string name);
 };
 
+/// \brief Get the constraint that holds the joint motors, limits and mimic
+/// gears of a multibody, adding it to the world the first time.
+/// \param[in] _worldInfo World of the multibody.
+/// \param[in] _body Multibody.
+/// \return Constraint of the multibody.
+ModelJointConstraint &JointConstraintsOf(
+    WorldInfo &_worldInfo, btMultiBody *_body);
+
+/// \brief Sample the joint configurations of a multibody with self
+/// collisions and find the pairs of its links that collided at none of them,
+/// see SelfCollisionSamplingFeature. The multibody is left at the
+/// configuration it was at.
+/// \param[in] _world World of the multibody, which tests the pairs.
+/// \param[in,out] _body Multibody.
+/// \param[in] _numSamples Number of configurations, the first of which is
+/// the current one.
+/// \return Flags of the pairs, laid out as in
+/// GzCollisionDispatcher::SetIgnoredLinkPairs, or an empty vector if every
+/// pair collided or the multibody could not be sampled.
+std::vector<bool> SampleNeverCollidingLinkPairs(
+    btCollisionWorld &_world, btMultiBody &_body, std::size_t _numSamples);
+
+/// \brief Step a world like StepBulletWorld, on bullet's process wide task
+/// scheduler set up by UseBulletThreads. Multithreaded steps switch the
+/// scheduler, so they run alone, while steps on a single thread share the
+/// sequential scheduler and may run concurrently, including the steps of
+/// other engines.
+/// \param[in] _worldInfo World to step.
+/// \param[in] _stepSize Length of the whole step, in seconds.
+/// \param[in] _numThreads Number of bullet threads, see UseBulletThreads.
+/// \param[in] _scheduler Scheduler that runs the tasks of bullet, see
+/// UseBulletThreads.
+void StepBulletWorldWithThreads(WorldInfo &_worldInfo, btScalar _stepSize,
+    std::size_t _numThreads,
+    const std::shared_ptr<TaskScheduler> &_scheduler = {});
+
+/// \brief Step a world forward by a step size, in the number of substeps of
+/// the world. Forces applied before the step act on all of its substeps.
+/// If the world has adaptive stepping enabled, the step size is the
+/// shortest step, and the length of the step is picked by its controller.
+/// \param[in] _worldInfo World to step.
+/// \param[in] _stepSize Length of the whole step, in seconds.
+void StepBulletWorld(WorldInfo &_worldInfo, btScalar _stepSize);
+
+/// \brief Get the length of the next step of a world, see StepBulletWorld.
+/// \param[in] _worldInfo World to step.
+/// \param[in] _stepSize Step size given to the engine, in seconds.
+/// \return Length of the next step, in seconds.
+btScalar NextBulletStepSize(const WorldInfo &_worldInfo, btScalar _stepSize);
+
 struct ModelInfo
 {
   std::string name;
@@ -98,6 +215,29 @@ struct ModelInfo
   /// constraints.
   std::unordered_set<std::size_t> external_constraints;
 
+  /// Whether the model is kinematic, see KinematicModelFeature. The base of a
+  /// kinematic model is fixed and moved by kinematicLinearVelocity and
+  /// kinematicAngularVelocity before each step.
+  bool kinematic = false;
+  /// Whether the base was fixed before the model was made kinematic.
+  bool fixedBaseBeforeKinematic = false;
+  btVector3 kinematicLinearVelocity = btVector3(0, 0, 0);
+  btVector3 kinematicAngularVelocity = btVector3(0, 0, 0);
+
+  /// Thresholds set through SleepThresholdsFeature. Bullet puts the body to
+  /// sleep once the sum of the squares of its base and joint velocities has
+  /// stayed below the sum of their squares, 0.05 by default, for
+  /// sleepTimeout.
+  btScalar sleepLinearSpeed = static_cast<btScalar>(std::sqrt(0.025));
+  btScalar sleepAngularSpeed = static_cast<btScalar>(std::sqrt(0.025));
+  btScalar sleepTimeout = 2;
+
+  /// World poses of the inertial frames of the links, in link index order,
+  /// see Base::LinkInertiaPoses. Only valid while linkPosesGeneration is
+  /// equal to Base::linkPosesGeneration.
+  mutable std::vector<btTransform> linkInertiaPoses;
+  mutable std::size_t linkPosesGeneration = 0;
+
   ModelInfo(
     std::string _name,
     Identity _world,
@@ -124,15 +264,56 @@ struct LinkInfo
   std::unique_ptr<btCompoundShape> shape = nullptr;
   std::vector<std::size_t> collisionEntityIds = {};
   std::unordered_map<std::string, std::size_t> collisionNameToEntityId = {};
+  /// Entity ID of the collision held by each child of `shape`. Contacts on
+  /// `collider` record the index of the child they hit, see
+  /// RecordCompoundChildIndices in Base.cc.
+  std::vector<std::size_t> childIndexToCollisionEntityId = {};
+  /// Pose of the link the last time it was reported in ChangedWorldPoses.
+  /// Only valid if hasReportedPose is true.
+  math::Pose3d reportedPose;
+  bool hasReportedPose = false;
+  /// World velocity of the link before the current step. It is recorded when
+  /// the output of the step has accelerations, which bullet does not keep.
+  math::Vector3d preStepLinearVelocity;
+  math::Vector3d preStepAngularVelocity;
 };
 
 struct CollisionInfo
 {
   std::string name;
-  std::unique_ptr<btCollisionShape> collider;
+  std::shared_ptr<btCollisionShape> collider;
   Identity link;
   Eigen::Isometry3d linkToCollision;
   int indexInLink = 0;
+  /// Bounding box of collider in the collision frame. Shapes do not change
+  /// once they are attached, so this is computed once by AddCollision.
+  Eigen::AlignedBox3d localBoundingBox;
+};
+
+/// \brief Surface properties of a link collider. Bullet does not appear to
+/// support different surface properties for different shapes attached to the
+/// same link, so these are taken from the first collision of the link.
+struct ColliderSurfaceInfo
+{
+  double mu = 1.0;
+  double mu2 = 1.0;
+  double restitution = 0.0;
+  double torsionalCoefficient = 1.0;
+  double rollingFriction = 0.0;
+
+  /// Use softer contacts, for stability of mesh collisions
+  bool softContacts = false;
+};
+
+/// \brief Heights of a heightmap and the heightfield shape built on them.
+/// btHeightfieldTerrainShape refers to the heights instead of copying them,
+/// so they must outlive the shape.
+struct HeightfieldInfo
+{
+  std::vector<float> heights;
+  float minHeight = 0.0f;
+  float maxHeight = 0.0f;
+  std::unique_ptr<btHeightfieldTerrainShape> shape;
 };
 
 struct InternalJoint
@@ -171,11 +352,124 @@ struct JointInfo
   std::size_t indexInGzModel = 0;
   btScalar effort = 0;
 
-  std::shared_ptr<btMultiBodyJointMotor> motor = nullptr;
-  std::shared_ptr<btMultiBodyJointLimitConstraint> jointLimits = nullptr;
+  /// Velocity target of the motor of the joint in the ModelJointConstraint
+  /// of its model, which bullet does not give back.
+  btScalar velocityCommand = 0;
   std::shared_ptr<btMultiBodyFixedConstraint> fixedConstraint = nullptr;
-  std::shared_ptr<btMultiBodyGearConstraint> gearConstraint = nullptr;
   std::shared_ptr<btMultiBodyJointFeedback> jointFeedback = nullptr;
+  /// Positions followed by velocities of the degrees of freedom of the joint
+  /// the last time it was written to ChangedJointStates. Empty if it has not
+  /// been written yet.
+  std::vector<double> reportedState;
+};
+
+/// \brief A map from entity ID to entity info that keeps its entries in one
+/// contiguous array. Entity IDs come from a counter and are never reused, so
+/// the ID of an entity indexes a slot array holding its position in the
+/// entries directly. Lookups therefore cost one array access instead of a
+/// hash, and iterating over every entity is a linear pass. Erasing an entry
+/// moves the last entry into its place, so the iteration order is not stable
+/// across erasures.
+///
+/// The interface follows the subset of std::unordered_map used by this
+/// plugin. Inserting or erasing invalidates iterators and references to
+/// entries, but not the info objects the entries point at.
+template <typename T>
+class EntityMap
+{
+  public: using value_type = std::pair<std::size_t, T>;
+  public: using iterator = typename std::vector<value_type>::iterator;
+  public: using const_iterator =
+      typename std::vector<value_type>::const_iterator;
+
+  public: iterator begin() { return this->entries.begin(); }
+  public: iterator end() { return this->entries.end(); }
+  public: const_iterator begin() const { return this->entries.begin(); }
+  public: const_iterator end() const { return this->entries.end(); }
+
+  public: std::size_t size() const { return this->entries.size(); }
+  public: bool empty() const { return this->entries.empty(); }
+
+  public: iterator find(const std::size_t _id)
+  {
+    const std::size_t slot = this->SlotOf(_id);
+    return slot == 0u ? this->end() : this->begin() + (slot - 1u);
+  }
+
+  public: const_iterator find(const std::size_t _id) const
+  {
+    const std::size_t slot = this->SlotOf(_id);
+    return slot == 0u ? this->end() : this->begin() + (slot - 1u);
+  }
+
+  public: std::size_t count(const std::size_t _id) const
+  {
+    return this->SlotOf(_id) == 0u ? 0u : 1u;
+  }
+
+  public: T &at(const std::size_t _id)
+  {
+    const std::size_t slot = this->SlotOf(_id);
+    if (slot == 0u)
+      throw std::out_of_range("EntityMap: unknown entity");
+    return this->entries[slot - 1u].second;
+  }
+
+  public: const T &at(const std::size_t _id) const
+  {
+    const std::size_t slot = this->SlotOf(_id);
+    if (slot == 0u)
+      throw std::out_of_range("EntityMap: unknown entity");
+    return this->entries[slot - 1u].second;
+  }
+
+  public: T &operator[](const std::size_t _id)
+  {
+    if (_id >= this->slots.size())
+      this->slots.resize(_id + 1u, 0u);
+
+    if (this->slots[_id] == 0u)
+    {
+      this->entries.emplace_back(_id, T());
+      this->slots[_id] = this->entries.size();
+    }
+    return this->entries[this->slots[_id] - 1u].second;
+  }
+
+  public: std::size_t erase(const std::size_t _id)
+  {
+    const std::size_t slot = this->SlotOf(_id);
+    if (slot == 0u)
+      return 0u;
+
+    if (slot != this->entries.size())
+    {
+      this->entries[slot - 1u] = std::move(this->entries.back());
+      this->slots[this->entries[slot - 1u].first] = slot;
+    }
+    this->entries.pop_back();
+    this->slots[_id] = 0u;
+    return 1u;
+  }
+
+  public: void clear()
+  {
+    this->entries.clear();
+    this->slots.clear();
+  }
+
+  /// \brief Position of an entity in entries plus one, or 0 if absent.
+  private: std::size_t SlotOf(const std::size_t _id) const
+  {
+    return _id < this->slots.size() ? this->slots[_id] : 0u;
+  }
+
+  /// \brief The entries, in no particular order.
+  private: std::vector<value_type> entries;
+
+  /// \brief Position of each entity in entries plus one, indexed by entity
+  /// ID. 0 marks an ID that is not in this map.
+  private: std::vector<std::size_t> slots;
 };
 
 inline btMatrix3x3 convertMat(const Eigen::Matrix3d& mat)
@@ -200,6 +494,20 @@ inline btVector3 convertVec(const math::Vector3d& vec)
                    static_cast<btScalar>(vec[2]));
 }
 
+/// \brief Describe the geometry of a shape for Base::InternShape. Floating
+/// point values are written exactly, so only identical geometry shares a key.
+/// \param[in] _type Type of the shape.
+/// \param[in] _values Parameters of the shape.
+/// \return The key.
+template <typename... Values>
+std::string ShapeKey(const std::string &_type, const Values &... _values)
+{
+  std::ostringstream key;
+  key << _type << std::hexfloat;
+  ((key << '|' << _values), ...);
+  return key.str();
+}
+
 inline btTransform convertTf(const Eigen::Isometry3d& tf)
 {
   return btTransform(
@@ -231,30 +539,25 @@ inline Eigen::Isometry3d convert(const btTransform& tf)
   return output;
 }
 
-inline btTransform GetWorldTransformOfLinkInertiaFrame(
-    const btMultiBody &body,
-    const int linkIndexInModel)
+/// \brief Append the world poses of the inertial frames of every link of
+/// _body to _poses, in link index order. This is a single pass over the
+/// links, instead of walking to the base once per link.
+inline void AppendLinkInertiaPoses(
+    const btMultiBody &_body, std::vector<btTransform> &_poses)
 {
-  const auto p = body.localPosToWorld(
-    linkIndexInModel, btVector3(0, 0, 0));
-  const auto rot = body.localFrameToWorld(
-    linkIndexInModel, btMatrix3x3::getIdentity());
-  return btTransform(rot, p);
-}
-
-inline Eigen::Isometry3d GetWorldTransformOfLink(
-    const ModelInfo &model,
-    const LinkInfo &linkInfo)
-{
-  const auto &body = *model.body;
-  const auto indexOpt = linkInfo.indexInModel;
-  if (indexOpt.has_value())
+  const std::size_t offset = _poses.size();
+  const btTransform base = _body.getBaseWorldTransform();
+  _poses.reserve(offset + static_cast<std::size_t>(_body.getNumLinks()));
+  for (int i = 0; i < _body.getNumLinks(); ++i)
   {
-    return convert(GetWorldTransformOfLinkInertiaFrame(body, *indexOpt))
-        * linkInfo.inertiaToLinkFrame;
+    // Bullet orders the links so that a parent always precedes its children.
+    const int parent = _body.getParent(i);
+    const btTransform parentPose =
+        parent < 0 ? base : _poses[offset + static_cast<std::size_t>(parent)];
+    const btQuaternion rot = _body.getParentToLocalRot(i).inverse();
+    _poses.push_back(
+        parentPose * btTransform(rot, quatRotate(rot, _body.getRVector(i))));
   }
-
-  return convert(body.getBaseWorldTransform()) * model.baseInertiaToLinkFrame;
 }
 
 class Base : public Implements3d<FeatureList<Feature>>
@@ -357,6 +660,14 @@ class Base : public Implements3d<FeatureList<Feature>>
   {
    const auto id = this->GetNextEntity();
    auto collision = std::make_shared<CollisionInfo>(std::move(_collisionInfo));
+   if (collision->collider)
+   {
+     btVector3 minBox(0, 0, 0);
+     btVector3 maxBox(0, 0, 0);
+     collision->collider->getAabb(btTransform::getIdentity(), minBox, maxBox);
+     collision->localBoundingBox = Eigen::AlignedBox3d(
+       convert(minBox), convert(maxBox));
+   }
    this->collisions[id] = collision;
    auto *link = this->ReferenceInterface<LinkInfo>(_collisionInfo.link);
    collision->indexInLink = static_cast<int>(link->collisionEntityIds.size());
@@ -366,6 +677,85 @@ class Base : public Implements3d<FeatureList<Feature>>
    return this->GenerateIdentity(id, collision);
   }
 
+  /// \brief Get the shape shared by every collision with the same geometry,
+  /// building it if there is none yet. Collisions only hold their pose, and
+  /// their link collider the surface properties, so the geometry of
+  /// identical collisions, such as many copies of a model, is stored once.
+  /// \param[in] _key Describes the geometry, see ShapeKey.
+  /// \param[in] _factory Builds the shape if no collision uses it anymore.
+  /// \return The shared shape.
+  public: template <typename FactoryT>
+  std::shared_ptr<btCollisionShape> InternShape(
+      const std::string &_key, FactoryT &&_factory)
+  {
+    auto &shared = this->sharedShapes[_key];
+    if (auto shape = shared.lock())
+      return shape;
+
+    std::shared_ptr<btCollisionShape> shape = _factory();
+    shared = shape;
+
+    // Drop the keys of geometry that is no longer used, once they could
+    // make up half of the table.
+    if (this->sharedShapes.size() > 2u * this->sharedShapesAfterPrune + 64u)
+    {
+      for (auto it = this->sharedShapes.begin();
+           it != this->sharedShapes.end();)
+      {
+        if (it->second.expired())
+          it = this->sharedShapes.erase(it);
+        else
+          ++it;
+      }
+      this->sharedShapesAfterPrune = this->sharedShapes.size();
+    }
+    return shape;
+  }
+
+  /// \brief Add a collision to the collider of its link, creating the
+  /// collider if the link does not have one yet.
+  /// \param[in] _collisionInfo Collision to add.
+  /// \param[in] _surface Surface properties of the collider. Only used if
+  /// the collider is created.
+  /// \param[in] _isStatic True if the link never moves, so the collider can
+  /// use the static broadphase filter.
+  /// \param[in] _bake True to add the collision to the baked static collider
+  /// of the world instead, see sdf::BakeStaticCollisions.
+  /// \return Identity of the collision.
+  public: Identity AddLinkCollision(
+    CollisionInfo _collisionInfo,
+    const ColliderSurfaceInfo &_surface,
+    bool _isStatic,
+    bool _bake = false);
+
+  /// \brief Add a collision to the baked static collider of a world,
+  /// creating the collider if the world does not have one yet.
+  /// \param[in] _world World to add the collision to.
+  /// \param[in] _worldToCollision Pose of the collision in the world.
+  /// \param[in] _shape Shape of the collision.
+  /// \param[in] _collisionID Entity ID of the collision.
+  /// \param[in] _surface Surface properties of the collider. Only used if
+  /// the collider is created.
+  public: void AddBakedCollision(
+    WorldInfo &_world,
+    const btTransform &_worldToCollision,
+    btCollisionShape *_shape,
+    std::size_t _collisionID,
+    const ColliderSurfaceInfo &_surface);
+
+  /// \brief Remove a collision from the baked static collider of its world.
+  /// \param[in] _world World of the collision.
+  /// \param[in] _collisionID Entity ID of the collision. Nothing is done if
+  /// it is not baked.
+  public: void RemoveBakedCollision(
+    WorldInfo &_world, std::size_t _collisionID);
+
+  /// \brief Check whether a link is fixed to the world, either as the base
+  /// link of a fixed base model or as a link with zero dofs in one.
+  /// \param[in] _linkID Link to check.
+  /// \return True if the link can not move.
+  public: bool IsLinkFixed(const Identity &_linkID) const;
+
   public: inline Identity AddJoint(JointInfo _jointInfo)
   {
     const auto id = this->GetNextEntity();
@@ -446,20 +836,24 @@ class Base : public Implements3d<FeatureList<Feature>>
     for (const auto jointID : model->jointEntityIds)
     {
       const auto joint = this->joints.at(jointID);
-      if (joint->motor)
-      {
-        world->world->removeMultiBodyConstraint(joint->motor.get());
-      }
       if (joint->fixedConstraint)
       {
         world->world->removeMultiBodyConstraint(joint->fixedConstraint.get());
       }
-      if (joint->jointLimits)
-      {
-        world->world->removeMultiBodyConstraint(joint->jointLimits.get());
-      }
       this->joints.erase(jointID);
     }
+    const auto jointConstraints =
+        world->jointConstraints.find(model->body.get());
+    if (jointConstraints != world->jointConstraints.end())
+    {
+      world->world->removeMultiBodyConstraint(jointConstraints->second.get());
+      world->jointConstraints.erase(jointConstraints);
+    }
+    if (auto *dispatcher =
+            dynamic_cast<GzCollisionDispatcher *>(world->dispatcher.get()))
+    {
+      dispatcher->RemoveIgnoredLinkPairs(model->body.get());
+    }
     // \todo(iche033) Remove external constraints related to this model
     // (model->external_constraints) once this is supported
 
@@ -468,10 +862,13 @@ class Base : public Implements3d<FeatureList<Feature>>
     {
       const auto &link = this->links.at(linkID);
       if (link->collider)
-      {
         world->world->removeCollisionObject(link->collider.get());
-        for (const auto shapeID : link->collisionEntityIds)
-          this->collisions.erase(shapeID);
+
+      for (const auto shapeID : link->collisionEntityIds)
+      {
+        if (world->bakedStatic)
+          this->RemoveBakedCollision(*world, shapeID);
+        this->collisions.erase(shapeID);
       }
 
       this->links.erase(linkID);
@@ -485,7 +882,12 @@ class Base : public Implements3d<FeatureList<Feature>>
   public: ~Base() override {
     // The order of destruction between meshesGImpact and triangleMeshes is
     // important.
+    this->meshShapeCache.clear();
+    this->heightfieldCache.clear();
     this->meshesGImpact.clear();
+    this->meshesBvh.clear();
+    this->meshViewArrays.clear();
+    this->meshViewOwners.clear();
     this->triangleMeshes.clear();
     this->meshesConvex.clear();
 
@@ -501,6 +903,12 @@ class Base : public Implements3d<FeatureList<Feature>>
         }
     }
 
+    for (const auto &[k, world] : worlds)
+    {
+      if (world->bakedStatic)
+        world->world->removeCollisionObject(world->bakedStatic->collider.get());
+    }
+
     this->collisions.clear();
     this->links.clear();
     this->models.clear();
@@ -515,13 +923,178 @@ class Base : public Implements3d<FeatureList<Feature>>
 
   public: std::unordered_map<std::size_t, WorldInfoPtr> worlds;
   public: std::unordered_map<std::size_t, ModelInfoPtr> models;
-  public: std::unordered_map<std::size_t, LinkInfoPtr> links;
-  public: std::unordered_map<std::size_t, CollisionInfoPtr> collisions;
-  public: std::unordered_map<std::size_t, JointInfoPtr> joints;
+  public: EntityMap<LinkInfoPtr> links;
+  public: EntityMap<CollisionInfoPtr> collisions;
+  public: EntityMap<JointInfoPtr> joints;
+
+  /// \brief FrameData returned by FrameDataRelativeToWorld, when enabled
+  /// through SetFrameDataCacheFeature. Invalidated by every call that
+  /// changes the kinematic state of a frame.
+  public: mutable SetFrameDataCacheFeature::FrameDataCache<FeaturePolicy3d>
+      frameDataCache;
+
+  /// \brief Generation of the link poses cached in ModelInfo. Incremented by
+  /// InvalidateFrameData, so that caches from an older one are recomputed.
+  /// It is atomic, since the steps of other worlds invalidate it while the
+  /// links of a world are queried, see ConcurrentWorldStepFeature.
+  public: mutable std::atomic<std::size_t> linkPosesGeneration{1};
+
+  /// \brief Mark the cached frame data and link poses as stale. This must be
+  /// called by every call that changes the kinematic state of a frame.
+  public: void InvalidateFrameData() const
+  {
+    this->frameDataCache.Invalidate();
+    ++this->linkPosesGeneration;
+  }
+
+  /// \brief Get the world poses of the inertial frames of the links of a
+  /// model, in link index order. They are computed in one pass from the base
+  /// to the leaves, and cached until InvalidateFrameData is called. This
+  /// fills the cache of the model, so it must not be called concurrently for
+  /// the same model.
+  /// \param[in] _model Model of the links, which must have a body
+  /// \return Poses of the links
+  public: const std::vector<btTransform> &LinkInertiaPoses(
+      const ModelInfo &_model) const
+  {
+    const auto numLinks = static_cast<std::size_t>(_model.body->getNumLinks());
+    const std::size_t generation = this->linkPosesGeneration;
+    if (_model.linkPosesGeneration != generation ||
+        _model.linkInertiaPoses.size() != numLinks)
+    {
+      _model.linkInertiaPoses.clear();
+      AppendLinkInertiaPoses(*_model.body, _model.linkInertiaPoses);
+      _model.linkPosesGeneration = generation;
+    }
+    return _model.linkInertiaPoses;
+  }
+
+  /// \brief Get the world transform of a link frame, from LinkInertiaPoses.
+  /// \param[in] _model Model of the link, which must have a body
+  /// \param[in] _link Link to get the world transform of
+  /// \return World transform of the link frame
+  public: Eigen::Isometry3d LinkWorldTransform(
+      const ModelInfo &_model, const LinkInfo &_link) const
+  {
+    if (!_link.indexInModel.has_value())
+    {
+      return convert(_model.body->getBaseWorldTransform())
+          * _model.baseInertiaToLinkFrame;
+    }
+
+    const auto index = static_cast<std::size_t>(*_link.indexInModel);
+    return convert(this->LinkInertiaPoses(_model)[index])
+        * _link.inertiaToLinkFrame;
+  }
 
   public: std::vector<std::unique_ptr<btTriangleMesh>> triangleMeshes;
   public: std::vector<std::unique_ptr<btGImpactMeshShape>> meshesGImpact;
+
+  /// \brief BVHs of meshesBvh that were read from the on-disk cache, see
+  /// CreateCachedBvhTriangleMeshShape. Declared before meshesBvh so that the
+  /// BVHs outlive the shapes.
+  public: std::vector<std::unique_ptr<SerializedBvh>> serializedBvhs;
+  public: std::vector<std::unique_ptr<btBvhTriangleMeshShape>> meshesBvh;
   public: std::vector<std::unique_ptr<btConvexHullShape>> meshesConvex;
+
+  /// \brief Bullet's descriptions of mesh views attached with
+  /// AttachMeshViewShapeFeature. They point into the arrays of the views
+  /// rather than copying them.
+  public: std::vector<std::unique_ptr<btTriangleIndexVertexArray>>
+      meshViewArrays;
+
+  /// \brief Owners of the arrays of the attached mesh views, which must
+  /// outlive meshViewArrays and the shapes built on them.
+  public: std::vector<std::shared_ptr<const void>> meshViewOwners;
+
+  /// \brief Child shapes built from a mesh and their poses in the mesh frame
+  public: using MeshShapes =
+      std::vector<std::pair<btTransform, btCollisionShape *>>;
+
+  /// \brief Shapes built from meshes, keyed by mesh name, scale and
+  /// optimization. The shapes are owned by triangleMeshes, meshesGImpact,
+  /// meshesBvh and meshesConvex, and are shared by every collision that uses
+  /// the same mesh.
+  public: std::unordered_map<std::string, MeshShapes> meshShapeCache;
+
+  /// \brief Build a convex hull shape for each submesh of a convex
+  /// decomposition, see mesh::CachedConvexMesh. The hulls are owned by
+  /// meshesConvex.
+  /// \param[in] _convexMesh The decomposition, one hull per submesh.
+  /// \param[in] _scale Scale applied to the vertices.
+  /// \return The hulls and their poses in the mesh frame.
+  public: MeshShapes ConvexHullShapes(
+    const common::Mesh &_convexMesh,
+    const btVector3 &_scale);
+
+  /// \brief Heightfields keyed by heightmap file, size and subsampling. The
+  /// heights and shape are shared by every collision that uses the same
+  /// heightmap, and with other engines of the process through
+  /// heightmap::SharedHeightfieldCache.
+  public: std::unordered_map<std::string,
+      std::shared_ptr<const HeightfieldInfo>> heightfieldCache;
+
+  /// \brief Shapes shared by collisions with the same geometry, see
+  /// InternShape. Primitive shapes are freed with the last collision that
+  /// uses them.
+  public: std::unordered_map<std::string, std::weak_ptr<btCollisionShape>>
+      sharedShapes;
+
+  /// \brief Size of sharedShapes after its unused keys were last dropped.
+  public: std::size_t sharedShapesAfterPrune = 0u;
+
+  /// \brief Content hashes of meshes, which key their shapes.
+  public: mesh::MeshContentHashCache meshContentHashes;
+
+  /// \brief Triangle budget of non-convex collision meshes, see
+  /// SimplifyCollisionMeshesFeature. 0 disables simplification.
+  public: std::size_t collisionMeshTriangleBudget = 0u;
+
+  /// \brief Largest error of the primitives that replace collision meshes,
+  /// see FitCollisionMeshPrimitivesFeature. 0 disables the fitting.
+  public: double collisionMeshPrimitiveTolerance = 0.0;
+
+  /// \brief Number of configurations that models with self collisions are
+  /// sampled at, see SelfCollisionSamplingFeature. 0 disables the sampling.
+  public: std::size_t selfCollisionSampleCount = 0u;
+
+  /// \brief Primitives fitted to collision meshes, by content hash.
+  public: mesh::PrimitiveFitCache primitiveFits;
+
+  /// \brief Scheduler of the parallel work of the engine, nullptr if the
+  /// engine uses thread pools of its own, see TaskSchedulerFeature.
+  public: std::shared_ptr<TaskScheduler> taskScheduler;
+
+  /// \brief Run tasks on taskScheduler, or on a thread pool of the engine
+  /// without a scheduler.
+  /// \param[in,out] _pool Pool used without a scheduler. Created, or
+  /// replaced, to have _numThreads threads.
+  /// \param[in,out] _poolThreads Number of threads of _pool.
+  /// \param[in] _numThreads Number of threads of the pool.
+  /// \param[in] _count Number of tasks.
+  /// \param[in] _task Task, called with the index of each task.
+  public: inline void RunTasks(
+      std::unique_ptr<gz::common::WorkerPool> &_pool,
+      std::size_t &_poolThreads, std::size_t _numThreads, std::size_t _count,
+      const std::function<void(std::size_t)> &_task) const
+  {
+    if (this->taskScheduler)
+    {
+      this->taskScheduler->Run(_count, _task);
+      return;
+    }
+
+    if (!_pool || _poolThreads != _numThreads)
+    {
+      _pool = std::make_unique<gz::common::WorkerPool>(
+          static_cast<unsigned int>(_numThreads));
+      _poolThreads = _numThreads;
+    }
+
+    for (std::size_t i = 0; i < _count; ++i)
+      _pool->AddWork([&_task, i]() { _task(i); });
+    _pool->WaitForResults();
+  }
 };
 
 }  // namespace bullet_featherstone
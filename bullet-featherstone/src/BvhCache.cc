@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "BvhCache.hh"
+
+#include <LinearMath/btAlignedAllocator.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+#include <gz/common/Console.hh>
+#include <gz/common/Util.hh>
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
+
+namespace gz {
+namespace physics {
+namespace bullet_featherstone {
+
+/// \brief Identifies a BVH cache file.
+static constexpr char kBvhMagic[4] = {'G', 'Z', 'B', 'V'};
+
+/// \brief Version of the cache file layout. Bump this to invalidate existing
+/// files when the layout changes.
+static constexpr std::uint32_t kBvhVersion = 1u;
+
+/// \brief Alignment that bullet requires of serialized BVH buffers.
+static constexpr int kBvhAlignment = 16;
+
+/////////////////////////////////////////////////
+/// \brief Directory of the cache, or an empty string if the cache is
+/// disabled.
+static std::string BvhCacheDirectory()
+{
+  std::string dir;
+  if (!common::env(kBvhCachePathEnv, dir))
+    return std::string();
+  return dir;
+}
+
+/////////////////////////////////////////////////
+/// \brief Path of the cache file of a key.
+static std::string BvhCachePath(const std::string &_dir, std::uint64_t _key)
+{
+  std::ostringstream name;
+  name << std::hex << std::setw(16) << std::setfill('0') << _key << ".gzbv";
+  return (std::filesystem::path(_dir) / name.str()).string();
+}
+
+/////////////////////////////////////////////////
+/// \brief Hash of a buffer, which detects truncated or corrupt files.
+static std::uint64_t BufferChecksum(const void *_data, std::size_t _size)
+{
+  mesh::detail::Fnv1a fnv;
+  fnv.Add(_data, _size);
+  return fnv.hash;
+}
+
+/////////////////////////////////////////////////
+void SerializedBvh::BufferDeleter::operator()(void *_buffer) const
+{
+  btAlignedFree(_buffer);
+}
+
+/////////////////////////////////////////////////
+std::unique_ptr<SerializedBvh> SerializedBvh::Read(
+    const std::string &_path, std::uint64_t _key)
+{
+  std::ifstream in(_path, std::ios::binary);
+  if (!in)
+    return nullptr;
+
+  char magic[4];
+  std::uint32_t version = 0u;
+  std::uint64_t key = 0u;
+  std::uint64_t checksum = 0u;
+  std::uint32_t size = 0u;
+  in.read(magic, sizeof(magic));
+  if (!in || std::memcmp(magic, kBvhMagic, sizeof(magic)) != 0 ||
+      !mesh::detail::ReadPod(in, version) || version != kBvhVersion ||
+      !mesh::detail::ReadPod(in, key) || key != _key ||
+      !mesh::detail::ReadPod(in, checksum) ||
+      !mesh::detail::ReadPod(in, size) || size == 0u)
+  {
+    return nullptr;
+  }
+
+  std::unique_ptr<SerializedBvh> result(new SerializedBvh);
+  result->buffer.reset(btAlignedAlloc(size, kBvhAlignment));
+  if (!result->buffer)
+    return nullptr;
+
+  in.read(static_cast<char *>(result->buffer.get()), size);
+  if (!in || BufferChecksum(result->buffer.get(), size) != checksum)
+    return nullptr;
+
+  result->bvh = btOptimizedBvh::deSerializeInPlace(
+      result->buffer.get(), size, false);
+  if (!result->bvh)
+    return nullptr;
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+SerializedBvh::~SerializedBvh()
+{
+  // The BVH was constructed in the buffer, and its arrays point into the
+  // buffer without owning it.
+  if (this->bvh)
+    static_cast<btQuantizedBvh *>(this->bvh)->~btQuantizedBvh();
+}
+
+/////////////////////////////////////////////////
+btOptimizedBvh *SerializedBvh::Bvh() const
+{
+  return this->bvh;
+}
+
+/////////////////////////////////////////////////
+std::uint64_t BvhCacheKey(
+    const btStridingMeshInterface &_mesh, bool _quantized)
+{
+  mesh::detail::Fnv1a fnv;
+  fnv.Add(kBvhVersion);
+  fnv.Add(static_cast<std::int32_t>(BT_BULLET_VERSION));
+  fnv.Add(static_cast<std::uint32_t>(sizeof(btScalar)));
+  fnv.Add(_quantized);
+
+  const btVector3 &scaling = _mesh.getScaling();
+  fnv.Add(scaling.x());
+  fnv.Add(scaling.y());
+  fnv.Add(scaling.z());
+
+  const int numSubParts = _mesh.getNumSubParts();
+  fnv.Add(static_cast<std::int32_t>(numSubParts));
+  for (int part = 0; part < numSubParts; ++part)
+  {
+    const unsigned char *vertexBase = nullptr;
+    const unsigned char *indexBase = nullptr;
+    int numVertices = 0;
+    int vertexStride = 0;
+    int indexStride = 0;
+    int numFaces = 0;
+    PHY_ScalarType vertexType = PHY_FLOAT;
+    PHY_ScalarType indexType = PHY_INTEGER;
+    _mesh.getLockedReadOnlyVertexIndexBase(
+        &vertexBase, numVertices, vertexType, vertexStride,
+        &indexBase, indexStride, numFaces, indexType, part);
+
+    // Only the coordinates of the vertices are hashed, since strided
+    // vertices may have padding that is not initialized.
+    const std::size_t coordinateSize =
+        vertexType == PHY_DOUBLE ? sizeof(double) : sizeof(float);
+    fnv.Add(static_cast<std::int32_t>(vertexType));
+    fnv.Add(static_cast<std::int32_t>(numVertices));
+    for (int i = 0; i < numVertices; ++i)
+      fnv.Add(vertexBase + i * vertexStride, 3u * coordinateSize);
+
+    std::size_t indexSize = sizeof(std::int32_t);
+    if (indexType == PHY_SHORT)
+      indexSize = sizeof(std::int16_t);
+    else if (indexType == PHY_UCHAR)
+      indexSize = sizeof(std::uint8_t);
+    fnv.Add(static_cast<std::int32_t>(indexType));
+    fnv.Add(static_cast<std::int32_t>(numFaces));
+    for (int i = 0; i < numFaces; ++i)
+      fnv.Add(indexBase + i * indexStride, 3u * indexSize);
+
+    _mesh.unLockReadOnlyVertexBase(part);
+  }
+  return fnv.hash;
+}
+
+/////////////////////////////////////////////////
+bool WriteBvh(
+    const std::string &_path, std::uint64_t _key, const btOptimizedBvh &_bvh)
+{
+  const unsigned int size = _bvh.calculateSerializeBufferSize();
+  std::unique_ptr<void, void (*)(void *)> data(
+      btAlignedAlloc(size, kBvhAlignment), [](void *_buffer)
+      {
+        btAlignedFree(_buffer);
+      });
+  if (!data || !_bvh.serializeInPlace(data.get(), size, false))
+    return false;
+
+  const std::filesystem::path path(_path);
+  std::error_code ec;
+  if (path.has_parent_path())
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+  // Give each writer its own temporary file, so processes sharing the cache
+  // do not interleave their writes.
+  std::ostringstream tmpName;
+  tmpName << _path << ".tmp." << std::hex
+          << std::random_device()() << std::random_device()();
+  const std::string tmpPath = tmpName.str();
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+
+    out.write(kBvhMagic, sizeof(kBvhMagic));
+    mesh::detail::WritePod(out, kBvhVersion);
+    mesh::detail::WritePod(out, _key);
+    mesh::detail::WritePod(out, BufferChecksum(data.get(), size));
+    mesh::detail::WritePod(out, static_cast<std::uint32_t>(size));
+    out.write(static_cast<const char *>(data.get()), size);
+
+    if (!out)
+    {
+      out.close();
+      std::filesystem::remove(tmpPath, ec);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec)
+  {
+    std::filesystem::remove(tmpPath, ec);
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::unique_ptr<btBvhTriangleMeshShape> CreateCachedBvhTriangleMeshShape(
+    btStridingMeshInterface *_mesh,
+    std::vector<std::unique_ptr<SerializedBvh>> &_serializedBvhs)
+{
+  const bool quantized = true;
+  const std::string dir = BvhCacheDirectory();
+  if (dir.empty())
+    return std::make_unique<btBvhTriangleMeshShape>(_mesh, quantized);
+
+  const std::uint64_t key = BvhCacheKey(*_mesh, quantized);
+  const std::string path = BvhCachePath(dir, key);
+  if (auto serialized = SerializedBvh::Read(path, key))
+  {
+    auto shape = std::make_unique<btBvhTriangleMeshShape>(
+        _mesh, quantized, false);
+    shape->setOptimizedBvh(serialized->Bvh());
+    _serializedBvhs.push_back(std::move(serialized));
+    return shape;
+  }
+
+  auto shape = std::make_unique<btBvhTriangleMeshShape>(_mesh, quantized);
+  if (!WriteBvh(path, key, *shape->getOptimizedBvh()))
+  {
+    gzwarn << "Failed to write BVH cache file [" << path << "]."
+           << std::endl;
+  }
+  return shape;
+}
+
+}  // namespace bullet_featherstone
+}  // namespace physics
+}  // namespace gz
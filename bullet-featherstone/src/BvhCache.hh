@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_BVHCACHE_HH_
+#define GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_BVHCACHE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <BulletCollision/CollisionShapes/btStridingMeshInterface.h>
+
+namespace gz {
+namespace physics {
+namespace bullet_featherstone {
+
+/// \brief Name of the environment variable holding the directory of the
+/// on-disk cache of mesh BVHs. The cache is disabled when the variable is
+/// unset or empty.
+constexpr const char *kBvhCachePathEnv = "GZ_PHYSICS_BVH_CACHE_PATH";
+
+/// \brief A BVH read back from the on-disk cache. Bullet deserializes the
+/// BVH in place, so it lives in the buffer that the file was read into,
+/// which this owns. It must outlive the shapes that use the BVH.
+class SerializedBvh
+{
+  /// \brief Read a BVH from a cache file.
+  /// \param[in] _path Path of the file.
+  /// \param[in] _key Key that the file must have been written with.
+  /// \return The BVH, or nullptr if the file is missing, does not match
+  /// _key or is corrupt.
+  public: static std::unique_ptr<SerializedBvh> Read(
+      const std::string &_path, std::uint64_t _key);
+
+  public: ~SerializedBvh();
+
+  /// \brief The deserialized BVH.
+  public: btOptimizedBvh *Bvh() const;
+
+  private: SerializedBvh() = default;
+
+  private: struct BufferDeleter
+  {
+    void operator()(void *_buffer) const;
+  };
+
+  private: std::unique_ptr<void, BufferDeleter> buffer;
+  private: btOptimizedBvh *bvh = nullptr;
+};
+
+/// \brief Hash of the triangles of a mesh, its scaling and the BVH
+/// parameters. This names the cache file of the BVH of the mesh.
+/// \param[in] _mesh Mesh to hash.
+/// \param[in] _quantized Whether the BVH uses quantized AABBs.
+/// \return The key.
+std::uint64_t BvhCacheKey(
+    const btStridingMeshInterface &_mesh, bool _quantized);
+
+/// \brief Write a BVH to a cache file. The file is written to a temporary
+/// name and renamed, so concurrent processes can share the cache.
+/// \param[in] _path Path of the file.
+/// \param[in] _key Key of the BVH, see BvhCacheKey.
+/// \param[in] _bvh BVH to write.
+/// \return True if the file was written.
+bool WriteBvh(
+    const std::string &_path, std::uint64_t _key, const btOptimizedBvh &_bvh);
+
+/// \brief Create a triangle mesh shape with a quantized BVH, reading the BVH
+/// from the on-disk cache if an earlier process built it for the same mesh.
+/// New BVHs are added to the cache.
+/// \param[in] _mesh Mesh of the shape, which must outlive it.
+/// \param[in,out] _serializedBvhs BVHs read from the cache are added here.
+/// They must outlive the shape.
+/// \return The shape.
+/// \sa kBvhCachePathEnv
+std::unique_ptr<btBvhTriangleMeshShape> CreateCachedBvhTriangleMeshShape(
+    btStridingMeshInterface *_mesh,
+    std::vector<std::unique_ptr<SerializedBvh>> &_serializedBvhs);
+
+}  // namespace bullet_featherstone
+}  // namespace physics
+}  // namespace gz
+
+#endif
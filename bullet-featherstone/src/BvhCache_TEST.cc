@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <BulletCollision/CollisionShapes/btTriangleCallback.h>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+
+#include <gz/common/Util.hh>
+
+#include "BvhCache.hh"
+
+using namespace gz;
+using namespace gz::physics::bullet_featherstone;
+
+/////////////////////////////////////////////////
+/// \brief A square grid of triangles in the xy plane, large enough for its
+/// BVH to have many nodes.
+/// \param[in] _height Height of the grid.
+static std::unique_ptr<btTriangleMesh> Grid(btScalar _height)
+{
+  auto mesh = std::make_unique<btTriangleMesh>();
+  const int cells = 16;
+  for (int i = 0; i < cells; ++i)
+  {
+    for (int j = 0; j < cells; ++j)
+    {
+      const btVector3 v00(i, j, _height);
+      const btVector3 v10(i + 1, j, _height);
+      const btVector3 v01(i, j + 1, _height);
+      const btVector3 v11(i + 1, j + 1, _height);
+      mesh->addTriangle(v00, v10, v11);
+      mesh->addTriangle(v00, v11, v01);
+    }
+  }
+  return mesh;
+}
+
+/////////////////////////////////////////////////
+/// \brief Counts the triangles that a shape reports in an AABB.
+class TriangleCounter : public btTriangleCallback
+{
+  // Documentation inherited
+  public: void processTriangle(btVector3 *, int, int) override
+  {
+    ++this->count;
+  }
+
+  /// \brief Number of triangles reported.
+  public: int count = 0;
+};
+
+/////////////////////////////////////////////////
+/// \brief Number of triangles of a shape that overlap an AABB, which goes
+/// through the BVH of the shape.
+static int CountTriangles(const btBvhTriangleMeshShape &_shape,
+                          const btVector3 &_min, const btVector3 &_max)
+{
+  TriangleCounter counter;
+  _shape.processAllTriangles(&counter, _min, _max);
+  return counter.count;
+}
+
+/////////////////////////////////////////////////
+/// \brief Expect two BVHs to have the same nodes.
+static void ExpectEqualBvhs(btOptimizedBvh &_expected,
+                            btOptimizedBvh &_actual)
+{
+  ASSERT_EQ(_expected.isQuantized(), _actual.isQuantized());
+  auto &expectedNodes = _expected.getQuantizedNodeArray();
+  auto &actualNodes = _actual.getQuantizedNodeArray();
+  ASSERT_EQ(expectedNodes.size(), actualNodes.size());
+  ASSERT_GT(expectedNodes.size(), 1);
+  for (int i = 0; i < expectedNodes.size(); ++i)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      EXPECT_EQ(expectedNodes[i].m_quantizedAabbMin[k],
+                actualNodes[i].m_quantizedAabbMin[k]);
+      EXPECT_EQ(expectedNodes[i].m_quantizedAabbMax[k],
+                actualNodes[i].m_quantizedAabbMax[k]);
+    }
+    EXPECT_EQ(expectedNodes[i].m_escapeIndexOrTriangleIndex,
+              actualNodes[i].m_escapeIndexOrTriangleIndex);
+  }
+  EXPECT_EQ(_expected.getSubtreeInfoArray().size(),
+            _actual.getSubtreeInfoArray().size());
+}
+
+/////////////////////////////////////////////////
+/// \brief Gives each test an empty cache directory, and disables the cache
+/// before and after it.
+class BvhCache : public testing::Test
+{
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    common::unsetenv(kBvhCachePathEnv);
+    this->dir = std::filesystem::temp_directory_path() /
+        ("gz_physics_bvh_cache_" +
+         std::string(testing::UnitTest::GetInstance()->current_test_info()
+             ->name()));
+    std::filesystem::remove_all(this->dir);
+    this->path = (this->dir / "grid.gzbv").string();
+    this->mesh = Grid(0.0);
+    this->shape =
+        std::make_unique<btBvhTriangleMeshShape>(this->mesh.get(), true);
+    this->key = BvhCacheKey(*this->mesh, true);
+  }
+
+  // Documentation inherited
+  protected: void TearDown() override
+  {
+    common::unsetenv(kBvhCachePathEnv);
+    std::filesystem::remove_all(this->dir);
+  }
+
+  /// \brief Enable the cache in dir.
+  protected: void EnableCache()
+  {
+    ASSERT_TRUE(common::setenv(kBvhCachePathEnv, this->dir.string()));
+  }
+
+  /// \brief The files of the cache directory.
+  protected: std::vector<std::filesystem::path> CacheFiles() const
+  {
+    std::vector<std::filesystem::path> files;
+    if (std::filesystem::exists(this->dir))
+    {
+      for (const auto &entry : std::filesystem::directory_iterator(this->dir))
+        files.push_back(entry.path());
+    }
+    return files;
+  }
+
+  /// \brief Cache directory of the test.
+  protected: std::filesystem::path dir;
+
+  /// \brief Path of a cache file in dir.
+  protected: std::string path;
+
+  /// \brief Mesh of the shape.
+  protected: std::unique_ptr<btTriangleMesh> mesh;
+
+  /// \brief Shape with a BVH built from mesh.
+  protected: std::unique_ptr<btBvhTriangleMeshShape> shape;
+
+  /// \brief Cache key of mesh.
+  protected: std::uint64_t key = 0u;
+};
+
+/////////////////////////////////////////////////
+TEST_F(BvhCache, RoundTrip)
+{
+  ASSERT_TRUE(WriteBvh(this->path, this->key,
+                       *this->shape->getOptimizedBvh()));
+
+  // No temporary files are left behind
+  const auto files = this->CacheFiles();
+  ASSERT_EQ(1u, files.size());
+  EXPECT_EQ(this->path, files[0].string());
+
+  auto serialized = SerializedBvh::Read(this->path, this->key);
+  ASSERT_NE(nullptr, serialized);
+  ASSERT_NE(nullptr, serialized->Bvh());
+  ExpectEqualBvhs(*this->shape->getOptimizedBvh(), *serialized->Bvh());
+
+  // A shape on the BVH that was read reports the same triangles
+  btBvhTriangleMeshShape cached(this->mesh.get(), true, false);
+  cached.setOptimizedBvh(serialized->Bvh());
+  for (const auto &[min, max] : {
+         std::make_pair(btVector3(-1, -1, -1), btVector3(17, 17, 1)),
+         std::make_pair(btVector3(2.5, 3.5, -1), btVector3(4.5, 5.5, 1)),
+         std::make_pair(btVector3(20, 20, -1), btVector3(21, 21, 1))})
+  {
+    EXPECT_EQ(CountTriangles(*this->shape, min, max),
+              CountTriangles(cached, min, max));
+  }
+  EXPECT_EQ(512, CountTriangles(cached, btVector3(-1, -1, -1),
+                                btVector3(17, 17, 1)));
+}
+
+/////////////////////////////////////////////////
+TEST_F(BvhCache, CorruptFile)
+{
+  // A missing file
+  EXPECT_EQ(nullptr, SerializedBvh::Read(this->path, this->key));
+
+  ASSERT_TRUE(WriteBvh(this->path, this->key,
+                       *this->shape->getOptimizedBvh()));
+  const auto size = std::filesystem::file_size(this->path);
+
+  // Truncated files, in the header and in the BVH
+  for (const auto truncated : {size - 1u, size / 2u, std::uintmax_t{10u}})
+  {
+    ASSERT_TRUE(WriteBvh(this->path, this->key,
+                         *this->shape->getOptimizedBvh()));
+    std::filesystem::resize_file(this->path, truncated);
+    EXPECT_EQ(nullptr, SerializedBvh::Read(this->path, this->key))
+        << truncated;
+  }
+
+  // A changed byte of the BVH fails the checksum
+  ASSERT_TRUE(WriteBvh(this->path, this->key,
+                       *this->shape->getOptimizedBvh()));
+  {
+    std::fstream file(this->path,
+        std::ios::binary | std::ios::in | std::ios::out);
+    file.seekg(static_cast<std::streamoff>(size / 2u));
+    const char byte = static_cast<char>(file.get());
+    file.seekp(static_cast<std::streamoff>(size / 2u));
+    file.put(static_cast<char>(~byte));
+  }
+  EXPECT_EQ(nullptr, SerializedBvh::Read(this->path, this->key));
+
+  // A file of another format
+  {
+    std::ofstream out(this->path, std::ios::binary | std::ios::trunc);
+    out << "solid grid\nendsolid grid\n";
+  }
+  EXPECT_EQ(nullptr, SerializedBvh::Read(this->path, this->key));
+}
+
+/////////////////////////////////////////////////
+TEST_F(BvhCache, StaleKey)
+{
+  ASSERT_TRUE(WriteBvh(this->path, this->key,
+                       *this->shape->getOptimizedBvh()));
+  EXPECT_EQ(nullptr, SerializedBvh::Read(this->path, this->key + 1u));
+  EXPECT_NE(nullptr, SerializedBvh::Read(this->path, this->key));
+
+  // The key covers the triangles, the scaling and the BVH parameters
+  EXPECT_EQ(this->key, BvhCacheKey(*Grid(0.0), true));
+  EXPECT_NE(this->key, BvhCacheKey(*this->mesh, false));
+  EXPECT_NE(this->key, BvhCacheKey(*Grid(0.5), true));
+
+  auto scaled = Grid(0.0);
+  scaled->setScaling(btVector3(2, 2, 2));
+  EXPECT_NE(this->key, BvhCacheKey(*scaled, true));
+
+  auto larger = Grid(0.0);
+  larger->addTriangle(btVector3(0, 0, 1), btVector3(1, 0, 1),
+                      btVector3(0, 1, 1));
+  EXPECT_NE(this->key, BvhCacheKey(*larger, true));
+}
+
+/////////////////////////////////////////////////
+TEST_F(BvhCache, CachedShape)
+{
+  const btVector3 min(2.5, 3.5, -1);
+  const btVector3 max(4.5, 5.5, 1);
+  const int expectedCount = CountTriangles(*this->shape, min, max);
+  std::vector<std::unique_ptr<SerializedBvh>> serializedBvhs;
+
+  // Without a cache directory the BVH is built and nothing is written
+  {
+    auto built =
+        CreateCachedBvhTriangleMeshShape(this->mesh.get(), serializedBvhs);
+    ASSERT_NE(nullptr, built);
+    EXPECT_EQ(expectedCount, CountTriangles(*built, min, max));
+    EXPECT_TRUE(serializedBvhs.empty());
+    EXPECT_TRUE(this->CacheFiles().empty());
+  }
+
+  // The first shape of the cache writes its BVH
+  this->EnableCache();
+  {
+    auto built =
+        CreateCachedBvhTriangleMeshShape(this->mesh.get(), serializedBvhs);
+    ASSERT_NE(nullptr, built);
+    EXPECT_TRUE(serializedBvhs.empty());
+    ASSERT_EQ(1u, this->CacheFiles().size());
+  }
+  const std::filesystem::path cachePath = this->CacheFiles()[0];
+
+  // Later shapes of the same mesh use the BVH of the file
+  {
+    auto cached =
+        CreateCachedBvhTriangleMeshShape(this->mesh.get(), serializedBvhs);
+    ASSERT_NE(nullptr, cached);
+    ASSERT_EQ(1u, serializedBvhs.size());
+    EXPECT_EQ(serializedBvhs[0]->Bvh(), cached->getOptimizedBvh());
+    EXPECT_EQ(expectedCount, CountTriangles(*cached, min, max));
+  }
+
+  // A corrupt file is replaced by the BVH of a new shape
+  std::filesystem::resize_file(cachePath, 10u);
+  {
+    auto rebuilt =
+        CreateCachedBvhTriangleMeshShape(this->mesh.get(), serializedBvhs);
+    ASSERT_NE(nullptr, rebuilt);
+    EXPECT_EQ(1u, serializedBvhs.size());
+    EXPECT_EQ(expectedCount, CountTriangles(*rebuilt, min, max));
+  }
+  EXPECT_NE(nullptr, SerializedBvh::Read(cachePath.string(), this->key));
+
+  // A mesh with other triangles does not use the file of this one
+  auto other = Grid(0.5);
+  {
+    auto built =
+        CreateCachedBvhTriangleMeshShape(other.get(), serializedBvhs);
+    ASSERT_NE(nullptr, built);
+    EXPECT_EQ(1u, serializedBvhs.size());
+    EXPECT_EQ(2u, this->CacheFiles().size());
+  }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#include "CommandFeatures.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include <gz/common/Console.hh>
+
+namespace gz {
+namespace physics {
+namespace bullet_featherstone {
+
+using CommandType = WorldCommandBufferFeature::CommandType;
+
+/////////////////////////////////////////////////
+void CommandFeatures::ApplyWorldCommands(
+    const Identity &_id,
+    const WorldCommandBufferFeature::Command *_commands,
+    std::size_t _count)
+{
+  // Resolve the model of every command first, so the commands can be
+  // applied one multibody at a time.
+  this->commandOrder.clear();
+  this->commandOrder.reserve(_count);
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const auto &command = _commands[i];
+    const bool isJoint = command.type == CommandType::JOINT_FORCE ||
+        command.type == CommandType::JOINT_VELOCITY_COMMAND;
+
+    std::size_t modelID;
+    if (isJoint && this->joints.count(command.entity))
+      modelID = this->joints.at(command.entity)->model.id;
+    else if (!isJoint && this->links.count(command.entity))
+      modelID = this->links.at(command.entity)->model.id;
+    else
+    {
+      gzerr << "Command " << i << " refers to unknown "
+            << (isJoint ? "joint" : "link") << " [" << command.entity
+            << "]. The command will be ignored\n";
+      continue;
+    }
+
+    const auto modelIt = this->models.find(modelID);
+    if (modelIt == this->models.end() ||
+        modelIt->second->world.id != _id.id)
+    {
+      gzerr << "Command " << i << " refers to entity [" << command.entity
+            << "], which is not in world [" << _id.id
+            << "]. The command will be ignored\n";
+      continue;
+    }
+
+    this->commandOrder.emplace_back(modelID, i);
+  }
+
+  // A stable sort keeps the order of commands given for the same model, so
+  // the last force given to a joint DOF still wins.
+  std::stable_sort(this->commandOrder.begin(), this->commandOrder.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.first < _b.first;
+      });
+
+  for (const auto &order : this->commandOrder)
+  {
+    const auto &command = _commands[order.second];
+    switch (command.type)
+    {
+      case CommandType::JOINT_FORCE:
+      case CommandType::JOINT_VELOCITY_COMMAND:
+      {
+        const auto &jointInfo = this->joints.at(command.entity);
+        const Identity jointID =
+            this->GenerateIdentity(command.entity, jointInfo);
+        if (command.dof >= this->GetJointDegreesOfFreedom(jointID))
+        {
+          gzerr << "Invalid DOF [" << command.dof << "] commanded on joint ["
+                << jointInfo->name << "]. The command will be ignored\n";
+          break;
+        }
+
+        if (command.type == CommandType::JOINT_FORCE)
+          this->SetJointForce(jointID, command.dof, command.value);
+        else
+          this->SetJointVelocityCommand(jointID, command.dof, command.value);
+        break;
+      }
+      case CommandType::LINK_FORCE:
+      case CommandType::LINK_TORQUE:
+      {
+        const auto &linkInfo = this->links.at(command.entity);
+        if (command.dof >= 3u || !std::isfinite(command.value))
+        {
+          gzerr << "Invalid component [" << command.dof << "] or value ["
+                << command.value << "] commanded on link [" << linkInfo->name
+                << "]. The command will be ignored\n";
+          break;
+        }
+
+        // Bullet link and base frames are at the center of mass, so the
+        // force needs no torque correction.
+        btVector3 value(0, 0, 0);
+        value[static_cast<int>(command.dof)] =
+            static_cast<btScalar>(command.value);
+        auto *body = this->models.at(order.first)->body.get();
+        const bool isForce = command.type == CommandType::LINK_FORCE;
+        if (linkInfo->indexInModel.has_value())
+        {
+          const int index = linkInfo->indexInModel.value();
+          if (isForce)
+            body->addLinkForce(index, value);
+          else
+            body->addLinkTorque(index, value);
+        }
+        else if (isForce)
+        {
+          body->addBaseForce(value);
+        }
+        else
+        {
+          body->addBaseTorque(value);
+        }
+
+        // Forces are cleared after each step, so only a force that is not
+        // zero changes what the next step does.
+        if (command.value != 0.0)
+          body->wakeUp();
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace bullet_featherstone
+}  // namespace physics
+}  // namespace gz
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_COMMANDFEATURES_HH_
+#define GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_COMMANDFEATURES_HH_
+
+#include <utility>
+#include <vector>
+
+#include <gz/physics/World.hh>
+
+#include "Base.hh"
+#include "JointFeatures.hh"
+
+namespace gz {
+namespace physics {
+namespace bullet_featherstone {
+
+struct CommandFeatureList : FeatureList<
+  WorldCommandBufferFeature
+> { };
+
+class CommandFeatures :
+    public virtual JointFeatures,
+    public virtual Implements3d<CommandFeatureList>
+{
+  // Documentation inherited
+  public: void ApplyWorldCommands(
+      const Identity &_id,
+      const WorldCommandBufferFeature::Command *_commands,
+      std::size_t _count) override;
+
+  /// \brief Model ID and buffer index of each command being applied, sorted
+  /// by model. Kept between calls to avoid reallocating every step.
+  private: std::vector<std::pair<std::size_t, std::size_t>> commandOrder;
+};
+
+}
+}
+}
+#endif  // GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_COMMANDFEATURES_HH_
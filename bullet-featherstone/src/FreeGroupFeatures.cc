@@ -18,6 +18,7 @@
 #include "FreeGroupFeatures.hh"
 
 #include <memory>
+#include <unordered_set>
 
 namespace gz {
 namespace physics {
@@ -29,8 +30,9 @@ Identity FreeGroupFeatures::FindFreeGroupForModel(
 {
   const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
 
-  // Reject if the model has fixed base
-  if (model->body->hasFixedBase())
+  // Reject if the model has fixed base, unless it is only fixed for being
+  // kinematic
+  if (model->body->hasFixedBase() && !model->kinematic)
     return this->GenerateInvalidId();
 
   return _modelID;
@@ -42,7 +44,7 @@ Identity FreeGroupFeatures::FindFreeGroupForLink(
 {
   const auto *link = this->ReferenceInterface<LinkInfo>(_linkID);
   const auto *model = this->ReferenceInterface<ModelInfo>(link->model);
-  if (model->body->hasFixedBase())
+  if (model->body->hasFixedBase() && !model->kinematic)
     return this->GenerateInvalidId();
 
   return link->model;
@@ -63,10 +65,15 @@ Identity FreeGroupFeatures::GetFreeGroupRootLink(const Identity &_groupID) const
 void FreeGroupFeatures::SetFreeGroupWorldAngularVelocity(
     const Identity &_groupID, const AngularVelocity &_angularVelocity)
 {
+  this->InvalidateFrameData();
   // Free groups in bullet-featherstone are always represented by ModelInfo
-  const auto *model = this->ReferenceInterface<ModelInfo>(_groupID);
+  auto *model = this->ReferenceInterface<ModelInfo>(_groupID);
 
-  if (model)
+  if (model && model->kinematic)
+  {
+    model->kinematicAngularVelocity = convertVec(_angularVelocity);
+  }
+  else if (model)
   {
     model->body->setBaseOmega(convertVec(_angularVelocity));
     model->body->wakeUp();
@@ -77,10 +84,15 @@ void FreeGroupFeatures::SetFreeGroupWorldAngularVelocity(
 void FreeGroupFeatures::SetFreeGroupWorldLinearVelocity(
     const Identity &_groupID, const LinearVelocity &_linearVelocity)
 {
+  this->InvalidateFrameData();
   // Free groups in bullet-featherstone are always represented by ModelInfo
-  const auto *model = this->ReferenceInterface<ModelInfo>(_groupID);
-  // Set Base Vel
-  if (model)
+  auto *model = this->ReferenceInterface<ModelInfo>(_groupID);
+  // Kinematic models are moved by SimulationFeatures before each step
+  if (model && model->kinematic)
+  {
+    model->kinematicLinearVelocity = convertVec(_linearVelocity);
+  }
+  else if (model)
   {
     model->body->setBaseVel(convertVec(_linearVelocity));
     model->body->wakeUp();
@@ -92,6 +104,7 @@ void FreeGroupFeatures::SetFreeGroupWorldPose(
     const Identity &_groupID,
     const PoseType &_pose)
 {
+  this->InvalidateFrameData();
   const auto *model = this->ReferenceInterface<ModelInfo>(_groupID);
   if (model)
   {
@@ -101,6 +114,58 @@ void FreeGroupFeatures::SetFreeGroupWorldPose(
   }
 }
 
+/////////////////////////////////////////////////
+void FreeGroupFeatures::SetWorldFreeGroupStates(
+    const Identity &_worldID,
+    const FreeGroupState *_states,
+    std::size_t _count)
+{
+  this->InvalidateFrameData();
+
+  std::unordered_set<btMultiBody *> moved;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const FreeGroupState &state = _states[i];
+
+    // Free groups in bullet-featherstone are always represented by ModelInfo
+    const auto it = this->models.find(state.freeGroup);
+    if (it == this->models.end() || !it->second ||
+        it->second->world.id != _worldID.id)
+    {
+      continue;
+    }
+
+    auto *model = it->second.get();
+    auto *body = model->body.get();
+    body->setBaseWorldTransform(
+        convertTf(state.pose * model->baseInertiaToLinkFrame.inverse()));
+
+    // Kinematic models are moved by SimulationFeatures before each step
+    if (model->kinematic)
+    {
+      model->kinematicLinearVelocity = convertVec(state.linearVelocity);
+      model->kinematicAngularVelocity = convertVec(state.angularVelocity);
+    }
+    else
+    {
+      body->setBaseVel(convertVec(state.linearVelocity));
+      body->setBaseOmega(convertVec(state.angularVelocity));
+    }
+    body->wakeUp();
+    moved.insert(body);
+  }
+
+  // Update the link frames and colliders of the moved bodies once, so that
+  // queries made before the next step see the new poses.
+  btAlignedObjectArray<btQuaternion> worldToLocal;
+  btAlignedObjectArray<btVector3> localOrigin;
+  for (btMultiBody *body : moved)
+  {
+    body->forwardKinematics(worldToLocal, localOrigin);
+    body->updateCollisionObjectWorldTransforms(worldToLocal, localOrigin);
+  }
+}
+
 }  // namespace bullet_featherstone
 }  // namespace physics
 }  // namespace gz
@@ -18,6 +18,8 @@
 #ifndef GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_FREEGROUPFEATURES_HH_
 #define GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_FREEGROUPFEATURES_HH_
 
+#include <cstddef>
+
 #include <gz/physics/FreeGroup.hh>
 
 #include "Base.hh"
@@ -29,7 +31,8 @@ namespace bullet_featherstone {
 struct FreeGroupFeatureList : gz::physics::FeatureList<
   FindFreeGroupFeature,
   SetFreeGroupWorldPose,
-  SetFreeGroupWorldVelocity
+  SetFreeGroupWorldVelocity,
+  SetFreeGroupWorldStates
 > { };
 
 class FreeGroupFeatures
@@ -56,6 +59,12 @@ class FreeGroupFeatures
   void SetFreeGroupWorldAngularVelocity(
       const Identity &_groupID,
       const AngularVelocity &_angularVelocity) override;
+
+  // ----- SetFreeGroupWorldStates -----
+  void SetWorldFreeGroupStates(
+      const Identity &_worldID,
+      const FreeGroupState *_states,
+      std::size_t _count) override;
 };
 
 }  // namespace bullet_featherstone
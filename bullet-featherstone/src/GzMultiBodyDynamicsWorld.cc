@@ -0,0 +1,692 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "GzMultiBodyDynamicsWorld.hh"
+
+#include <BulletCollision/BroadphaseCollision/btCollisionAlgorithm.h>
+#include <BulletCollision/BroadphaseCollision/btOverlappingPairCache.h>
+#include <BulletCollision/NarrowPhaseCollision/btPersistentManifold.h>
+#include <BulletDynamics/Featherstone/btMultiBody.h>
+#include <BulletDynamics/Featherstone/btMultiBodyConstraint.h>
+#include <BulletDynamics/Featherstone/btMultiBodyLinkCollider.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+#include <gz/physics/AllocationCounter.hh>
+
+namespace gz {
+namespace physics {
+namespace bullet_featherstone {
+
+/////////////////////////////////////////////////
+/// \brief Run a function and add its wall clock time to a counter.
+/// \param[in,out] _time Time in seconds to add to.
+/// \param[in] _func Function to run.
+template <typename F>
+static void AddTime(double &_time, F &&_func)
+{
+  const auto start = std::chrono::steady_clock::now();
+  std::forward<F>(_func)();
+  _time += std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+/////////////////////////////////////////////////
+/// \brief Run a function and add its wall clock time and its heap
+/// allocations to counters.
+/// \param[in,out] _time Time in seconds to add to.
+/// \param[in,out] _allocations Allocations to add to, see AllocationCount.
+/// \param[in] _func Function to run.
+template <typename F>
+static void AddCost(double &_time, std::size_t &_allocations, F &&_func)
+{
+  const std::size_t allocations = AllocationCount();
+  AddTime(_time, std::forward<F>(_func));
+  _allocations += AllocationCount() - allocations;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the multibody that a collision object belongs to.
+/// \param[in] _object Collision object.
+/// \return User index of the multibody of the object, or -1 if the object
+/// is not the collider of a multibody link.
+static int MultiBodyIndex(const btCollisionObject *_object)
+{
+  const auto *collider = btMultiBodyLinkCollider::upcast(_object);
+  if (!collider || !collider->m_multiBody)
+    return -1;
+  return collider->m_multiBody->getUserIndex();
+}
+
+/////////////////////////////////////////////////
+bool GzPlaneOverlapFilter::needBroadphaseCollision(
+    btBroadphaseProxy *_proxy0, btBroadphaseProxy *_proxy1) const
+{
+  if ((_proxy0->m_collisionFilterGroup | _proxy1->m_collisionFilterGroup) &
+      kPlaneFilter)
+  {
+    return false;
+  }
+
+  return (_proxy0->m_collisionFilterGroup & _proxy1->m_collisionFilterMask) &&
+         (_proxy1->m_collisionFilterGroup & _proxy0->m_collisionFilterMask);
+}
+
+/////////////////////////////////////////////////
+GzCollisionDispatcher::GzCollisionDispatcher(
+    btCollisionConfiguration *_collisionConfiguration)
+  : btCollisionDispatcherMt(_collisionConfiguration)
+{
+}
+
+/////////////////////////////////////////////////
+GzCollisionDispatcher::~GzCollisionDispatcher()
+{
+  // The algorithms of the planes release their manifolds through this
+  // dispatcher, so they go before its pools
+  this->planePairs.Release(*this, nullptr);
+}
+
+/////////////////////////////////////////////////
+void GzCollisionDispatcher::SetPairTiming(bool _enable)
+{
+  this->pairTiming = _enable;
+  if (!_enable)
+    this->pairTimes.clear();
+}
+
+/////////////////////////////////////////////////
+const std::vector<double> &GzCollisionDispatcher::PairTimes() const
+{
+  return this->pairTimes;
+}
+
+/////////////////////////////////////////////////
+void GzCollisionDispatcher::SetMaxPairContacts(std::size_t _maxContacts)
+{
+  this->contactLimiter.SetMaxPairContacts(_maxContacts);
+}
+
+/////////////////////////////////////////////////
+std::size_t GzCollisionDispatcher::GetMaxPairContacts() const
+{
+  return this->contactLimiter.GetMaxPairContacts();
+}
+
+/////////////////////////////////////////////////
+void GzCollisionDispatcher::SetIgnoredLinkPairs(
+    const btMultiBody *_body, std::vector<bool> _pairs)
+{
+  this->ignoredLinkPairs[_body] = std::move(_pairs);
+}
+
+/////////////////////////////////////////////////
+void GzCollisionDispatcher::RemoveIgnoredLinkPairs(const btMultiBody *_body)
+{
+  this->ignoredLinkPairs.erase(_body);
+}
+
+/////////////////////////////////////////////////
+std::size_t GzCollisionDispatcher::IgnoredLinkPairCount(
+    const btMultiBody *_body) const
+{
+  const auto it = this->ignoredLinkPairs.find(_body);
+  if (it == this->ignoredLinkPairs.end())
+    return 0u;
+
+  // Each unordered pair has two flags
+  return static_cast<std::size_t>(
+      std::count(it->second.begin(), it->second.end(), true)) / 2u;
+}
+
+/////////////////////////////////////////////////
+void GzCollisionDispatcher::SetCollisionObjects(
+    const btCollisionObjectArray *_objects)
+{
+  this->collisionObjects = _objects;
+}
+
+/////////////////////////////////////////////////
+void GzCollisionDispatcher::AddPlaneCollider(btCollisionObject *_object)
+{
+  if (!this->IsPlaneCollider(_object))
+    this->planeColliders.push_back(_object);
+}
+
+/////////////////////////////////////////////////
+bool GzCollisionDispatcher::IsPlaneCollider(
+    const btCollisionObject *_object) const
+{
+  return std::find(this->planeColliders.begin(), this->planeColliders.end(),
+      _object) != this->planeColliders.end();
+}
+
+/////////////////////////////////////////////////
+void GzCollisionDispatcher::RemoveCollider(const btCollisionObject *_object)
+{
+  this->planeColliders.erase(std::remove(this->planeColliders.begin(),
+      this->planeColliders.end(), _object), this->planeColliders.end());
+  this->planePairs.Release(*this, _object);
+}
+
+/////////////////////////////////////////////////
+bool GzCollisionDispatcher::needsCollision(
+    const btCollisionObject *_body0, const btCollisionObject *_body1)
+{
+  if (!btCollisionDispatcherMt::needsCollision(_body0, _body1))
+    return false;
+  if (this->ignoredLinkPairs.empty())
+    return true;
+
+  const auto *collider0 = btMultiBodyLinkCollider::upcast(_body0);
+  const auto *collider1 = btMultiBodyLinkCollider::upcast(_body1);
+  if (!collider0 || !collider1 ||
+      collider0->m_multiBody != collider1->m_multiBody)
+  {
+    return true;
+  }
+
+  // Only looked up for pairs of the same multibody, which are read
+  // concurrently by the dispatch, while the tables only change between
+  // steps
+  const auto it = this->ignoredLinkPairs.find(collider0->m_multiBody);
+  if (it == this->ignoredLinkPairs.end())
+    return true;
+
+  const auto numColliders =
+      static_cast<std::size_t>(collider0->m_multiBody->getNumLinks()) + 1u;
+  const auto index =
+      static_cast<std::size_t>(collider0->m_link + 1) * numColliders +
+      static_cast<std::size_t>(collider1->m_link + 1);
+  return index >= it->second.size() || !it->second[index];
+}
+
+/////////////////////////////////////////////////
+void GzCollisionDispatcher::dispatchAllCollisionPairs(
+    btOverlappingPairCache *_pairCache,
+    const btDispatcherInfo &_dispatchInfo,
+    btDispatcher *_dispatcher)
+{
+  if (!this->pairTiming)
+  {
+    btCollisionDispatcherMt::dispatchAllCollisionPairs(
+        _pairCache, _dispatchInfo, _dispatcher);
+  }
+  else
+  {
+    this->pairTimes.assign(
+        static_cast<std::size_t>(_pairCache->getNumOverlappingPairs()), 0.0);
+    this->pairs = _pairCache->getOverlappingPairArrayPtr();
+    this->timedCallback = this->getNearCallback();
+    this->setNearCallback(&GzCollisionDispatcher::TimedNearCallback);
+    btCollisionDispatcherMt::dispatchAllCollisionPairs(
+        _pairCache, _dispatchInfo, _dispatcher);
+    this->setNearCallback(this->timedCallback);
+    this->pairs = nullptr;
+  }
+
+  if (!this->planeColliders.empty() && this->collisionObjects)
+  {
+    this->planePairs.Dispatch(
+        *this, _dispatchInfo, this->planeColliders, *this->collisionObjects);
+  }
+  this->contactLimiter.LimitPairContacts(*this);
+}
+
+/////////////////////////////////////////////////
+void GzCollisionDispatcher::TimedNearCallback(
+    btBroadphasePair &_pair, btCollisionDispatcher &_dispatcher,
+    const btDispatcherInfo &_dispatchInfo)
+{
+  // The callback is only set on a GzCollisionDispatcher
+  auto &self = static_cast<GzCollisionDispatcher &>(_dispatcher);
+  double time = 0.0;
+  AddTime(time, [&]()
+  {
+    self.timedCallback(_pair, _dispatcher, _dispatchInfo);
+  });
+
+  const auto index = static_cast<std::size_t>(&_pair - self.pairs);
+  if (index < self.pairTimes.size())
+    self.pairTimes[index] = time;
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyConstraintSolver::SetStatisticsEnabled(bool _enable)
+{
+  this->statisticsEnabled = _enable;
+  this->statistics = Statistics();
+}
+
+/////////////////////////////////////////////////
+bool GzMultiBodyConstraintSolver::GetStatisticsEnabled() const
+{
+  return this->statisticsEnabled;
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyConstraintSolver::ResetStatistics()
+{
+  this->statistics = Statistics();
+}
+
+/////////////////////////////////////////////////
+auto GzMultiBodyConstraintSolver::GetStatistics() const
+    -> const Statistics &
+{
+  return this->statistics;
+}
+
+/////////////////////////////////////////////////
+btScalar GzMultiBodyConstraintSolver::solveGroupCacheFriendlySetup(
+    btCollisionObject **_bodies, int _numBodies,
+    btPersistentManifold **_manifolds, int _numManifolds,
+    btTypedConstraint **_constraints, int _numConstraints,
+    const btContactSolverInfo &_infoGlobal, btIDebugDraw *_debugDrawer)
+{
+  const btScalar result = btMultiBodyConstraintSolver::
+      solveGroupCacheFriendlySetup(_bodies, _numBodies, _manifolds,
+          _numManifolds, _constraints, _numConstraints, _infoGlobal,
+          _debugDrawer);
+
+  this->solveRows = 0u;
+  this->solveIterations = 0u;
+  this->solveResidual = 0.0;
+  if (!this->statisticsEnabled)
+    return result;
+
+  // Every row of the problem is an entry of one of the pools
+  const auto contactRows = static_cast<std::size_t>(
+      this->m_tmpSolverContactConstraintPool.size() +
+      this->m_tmpSolverContactFrictionConstraintPool.size() +
+      this->m_multiBodyNormalContactConstraints.size() +
+      this->m_multiBodyFrictionContactConstraints.size());
+  const auto jointRows = static_cast<std::size_t>(
+      this->m_tmpSolverNonContactConstraintPool.size() +
+      this->m_multiBodyNonContactConstraints.size());
+  this->statistics.contactRowCount += contactRows;
+  this->statistics.jointRowCount += jointRows;
+  this->solveRows = contactRows + jointRows;
+  return result;
+}
+
+/////////////////////////////////////////////////
+btScalar GzMultiBodyConstraintSolver::solveSingleIteration(
+    int _iteration, btCollisionObject **_bodies, int _numBodies,
+    btPersistentManifold **_manifolds, int _numManifolds,
+    btTypedConstraint **_constraints, int _numConstraints,
+    const btContactSolverInfo &_infoGlobal, btIDebugDraw *_debugDrawer)
+{
+  const btScalar residual = btMultiBodyConstraintSolver::solveSingleIteration(
+      _iteration, _bodies, _numBodies, _manifolds, _numManifolds,
+      _constraints, _numConstraints, _infoGlobal, _debugDrawer);
+  ++this->solveIterations;
+  this->solveResidual = static_cast<double>(residual);
+  return residual;
+}
+
+/////////////////////////////////////////////////
+btScalar GzMultiBodyConstraintSolver::solveGroupCacheFriendlyFinish(
+    btCollisionObject **_bodies, int _numBodies,
+    const btContactSolverInfo &_infoGlobal)
+{
+  // Islands without constraints still go through the solver
+  if (this->statisticsEnabled && this->solveRows > 0u)
+  {
+    ++this->statistics.solveCount;
+    this->statistics.iterations =
+        std::max(this->statistics.iterations, this->solveIterations);
+    this->statistics.residual =
+        std::max(this->statistics.residual, this->solveResidual);
+  }
+
+  return btMultiBodyConstraintSolver::solveGroupCacheFriendlyFinish(
+      _bodies, _numBodies, _infoGlobal);
+}
+
+/////////////////////////////////////////////////
+GzMultiBodyDynamicsWorld::GzMultiBodyDynamicsWorld(
+    btDispatcher *_dispatcher,
+    btBroadphaseInterface *_broadphase,
+    btMultiBodyConstraintSolver *_solver,
+    btCollisionConfiguration *_collisionConfiguration)
+  : btMultiBodyDynamicsWorld(
+      _dispatcher, _broadphase, _solver, _collisionConfiguration)
+{
+  this->m_broadphasePairCache->getOverlappingPairCache()
+      ->setOverlapFilterCallback(&this->planeFilter);
+  if (auto *dispatcher = dynamic_cast<GzCollisionDispatcher *>(_dispatcher))
+    dispatcher->SetCollisionObjects(&this->m_collisionObjects);
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::SetBroadphase(
+    btBroadphaseInterface *_broadphase)
+{
+  this->setBroadphase(_broadphase);
+  _broadphase->getOverlappingPairCache()->setOverlapFilterCallback(
+      &this->planeFilter);
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::UpdatePlaneCollider(btCollisionObject *_object)
+{
+  auto *dispatcher = dynamic_cast<GzCollisionDispatcher *>(this->m_dispatcher1);
+  btBroadphaseProxy *proxy = _object->getBroadphaseHandle();
+  if (!dispatcher || !proxy)
+    return;
+
+  btTransform planeToWorld;
+  const bool isPlane =
+      bullet::PlanePairs::PlaneShape(_object, planeToWorld) != nullptr;
+  if (isPlane == dispatcher->IsPlaneCollider(_object))
+    return;
+
+  const int group =
+      static_cast<int>(proxy->m_collisionFilterGroup) & ~kPlaneFilter;
+  const int mask = static_cast<int>(proxy->m_collisionFilterMask);
+  this->removeCollisionObject(_object);
+  this->addCollisionObject(_object, group, mask);
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::addCollisionObject(
+    btCollisionObject *_object, int _group, int _mask)
+{
+  auto *dispatcher = dynamic_cast<GzCollisionDispatcher *>(this->m_dispatcher1);
+  btTransform planeToWorld;
+  if (!dispatcher ||
+      !bullet::PlanePairs::PlaneShape(_object, planeToWorld))
+  {
+    btMultiBodyDynamicsWorld::addCollisionObject(_object, _group, _mask);
+    return;
+  }
+
+  btMultiBodyDynamicsWorld::addCollisionObject(
+      _object, _group | kPlaneFilter, _mask);
+  dispatcher->AddPlaneCollider(_object);
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::removeCollisionObject(
+    btCollisionObject *_object)
+{
+  if (auto *dispatcher =
+      dynamic_cast<GzCollisionDispatcher *>(this->m_dispatcher1))
+  {
+    dispatcher->RemoveCollider(_object);
+  }
+  btMultiBodyDynamicsWorld::removeCollisionObject(_object);
+}
+
+/////////////////////////////////////////////////
+auto GzMultiBodyDynamicsWorld::GetStepStatistics() const
+    -> const StepStatistics &
+{
+  return this->statistics;
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::SetMultiBodyStatisticsEnabled(bool _enable)
+{
+  this->multiBodyStatisticsEnabled = _enable;
+  if (!_enable)
+    this->multiBodyStatistics.clear();
+  if (auto *dispatcher =
+      dynamic_cast<GzCollisionDispatcher *>(this->m_dispatcher1))
+  {
+    dispatcher->SetPairTiming(_enable);
+  }
+}
+
+/////////////////////////////////////////////////
+bool GzMultiBodyDynamicsWorld::GetMultiBodyStatisticsEnabled() const
+{
+  return this->multiBodyStatisticsEnabled;
+}
+
+/////////////////////////////////////////////////
+auto GzMultiBodyDynamicsWorld::GetMultiBodyStatistics() const
+    -> const std::map<int, MultiBodyStatistics> &
+{
+  return this->multiBodyStatistics;
+}
+
+/////////////////////////////////////////////////
+int GzMultiBodyDynamicsWorld::stepSimulation(
+    btScalar _timeStep, int _maxSubSteps, btScalar _fixedTimeStep)
+{
+  this->statistics = StepStatistics();
+  this->multiBodyStatistics.clear();
+  if (auto *solver =
+      dynamic_cast<GzMultiBodyConstraintSolver *>(this->getConstraintSolver()))
+  {
+    solver->ResetStatistics();
+  }
+  this->stepping = true;
+  int numSteps = 0;
+  AddCost(this->statistics.stepTime, this->statistics.stepAllocations, [&]()
+  {
+    numSteps = btMultiBodyDynamicsWorld::stepSimulation(
+        _timeStep, _maxSubSteps, _fixedTimeStep);
+  });
+  this->stepping = false;
+  return numSteps;
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::updateAabbs()
+{
+  if (!this->stepping)
+  {
+    btMultiBodyDynamicsWorld::updateAabbs();
+    return;
+  }
+
+  AddCost(this->statistics.broadphaseTime,
+      this->statistics.broadphaseAllocations,
+      [this]() { btMultiBodyDynamicsWorld::updateAabbs(); });
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::computeOverlappingPairs()
+{
+  if (!this->stepping)
+  {
+    btMultiBodyDynamicsWorld::computeOverlappingPairs();
+    return;
+  }
+
+  AddCost(this->statistics.broadphaseTime,
+      this->statistics.broadphaseAllocations,
+      [this]() { btMultiBodyDynamicsWorld::computeOverlappingPairs(); });
+  this->statistics.candidatePairCount = static_cast<std::size_t>(
+      this->m_broadphasePairCache->getOverlappingPairCache()
+          ->getNumOverlappingPairs());
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::performDiscreteCollisionDetection()
+{
+  if (!this->stepping)
+  {
+    btMultiBodyDynamicsWorld::performDiscreteCollisionDetection();
+    return;
+  }
+
+  // The broadphase runs first within this call and records its own time,
+  // the rest is the narrowphase.
+  const double broadphaseTime = this->statistics.broadphaseTime;
+  const std::size_t broadphaseAllocations =
+      this->statistics.broadphaseAllocations;
+  double collisionTime = 0.0;
+  std::size_t collisionAllocations = 0u;
+  AddCost(collisionTime, collisionAllocations, [this]()
+  {
+    btMultiBodyDynamicsWorld::performDiscreteCollisionDetection();
+  });
+  this->statistics.narrowphaseTime += std::max(0.0,
+      collisionTime - (this->statistics.broadphaseTime - broadphaseTime));
+  this->statistics.narrowphaseAllocations += collisionAllocations -
+      (this->statistics.broadphaseAllocations - broadphaseAllocations);
+
+  std::size_t contactCount = 0u;
+  const int numManifolds = this->m_dispatcher1->getNumManifolds();
+  for (int i = 0; i < numManifolds; ++i)
+  {
+    contactCount += static_cast<std::size_t>(
+        this->m_dispatcher1->getManifoldByIndexInternal(i)->getNumContacts());
+  }
+  this->statistics.contactCount = contactCount;
+
+  if (this->multiBodyStatisticsEnabled)
+    this->CollectCollisionStatistics();
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::CollectCollisionStatistics()
+{
+  // Adds to both multibodies of a pair, or once if the pair is within one
+  // multibody
+  auto forEachMultiBody = [this](const btCollisionObject *_object0,
+      const btCollisionObject *_object1, auto &&_func)
+  {
+    const int index0 = MultiBodyIndex(_object0);
+    const int index1 = MultiBodyIndex(_object1);
+    if (index0 >= 0)
+      _func(this->multiBodyStatistics[index0]);
+    if (index1 >= 0 && index1 != index0)
+      _func(this->multiBodyStatistics[index1]);
+  };
+
+  const auto *dispatcher =
+      dynamic_cast<const GzCollisionDispatcher *>(this->m_dispatcher1);
+  const std::vector<double> *pairTimes =
+      dispatcher ? &dispatcher->PairTimes() : nullptr;
+  const btBroadphasePairArray &pairArray =
+      this->m_broadphasePairCache->getOverlappingPairCache()
+          ->getOverlappingPairArray();
+  for (int i = 0; i < pairArray.size(); ++i)
+  {
+    const btBroadphasePair &pair = pairArray[i];
+    const auto p = static_cast<std::size_t>(i);
+    const double time =
+        pairTimes && p < pairTimes->size() ? (*pairTimes)[p] : 0.0;
+    forEachMultiBody(
+        static_cast<const btCollisionObject *>(pair.m_pProxy0->m_clientObject),
+        static_cast<const btCollisionObject *>(pair.m_pProxy1->m_clientObject),
+        [time](MultiBodyStatistics &_stats)
+        {
+          ++_stats.candidatePairCount;
+          _stats.narrowphaseTime += time;
+        });
+  }
+
+  const int numManifolds = this->m_dispatcher1->getNumManifolds();
+  for (int i = 0; i < numManifolds; ++i)
+  {
+    const btPersistentManifold *manifold =
+        this->m_dispatcher1->getManifoldByIndexInternal(i);
+    const auto numContacts =
+        static_cast<std::size_t>(manifold->getNumContacts());
+    forEachMultiBody(manifold->getBody0(), manifold->getBody1(),
+        [numContacts](MultiBodyStatistics &_stats)
+        {
+          _stats.contactCount += numContacts;
+          _stats.constraintRowCount += 3u * numContacts;
+        });
+  }
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::CollectConstraintStatistics()
+{
+  const int numConstraints = this->getNumMultiBodyConstraints();
+  for (int i = 0; i < numConstraints; ++i)
+  {
+    btMultiBodyConstraint *constraint = this->getMultiBodyConstraint(i);
+    const auto rows = static_cast<std::size_t>(constraint->getNumRows());
+    const btMultiBody *bodyA = constraint->getMultiBodyA();
+    const btMultiBody *bodyB = constraint->getMultiBodyB();
+    for (const btMultiBody *body : {bodyA, bodyB == bodyA ? nullptr : bodyB})
+    {
+      if (body)
+        this->multiBodyStatistics[body->getUserIndex()].constraintRowCount +=
+            rows;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::predictUnconstraintMotion(btScalar _timeStep)
+{
+  AddCost(this->statistics.integrationTime,
+      this->statistics.integrationAllocations, [&]()
+  {
+    btMultiBodyDynamicsWorld::predictUnconstraintMotion(_timeStep);
+  });
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::calculateSimulationIslands()
+{
+  AddCost(this->statistics.solverTime, this->statistics.solverAllocations,
+      [this]() { btMultiBodyDynamicsWorld::calculateSimulationIslands(); });
+
+  // Bodies of an island share the tag of its root, static and kinematic
+  // objects are tagged -1.
+  this->islandTags.clear();
+  const int numObjects = this->m_collisionObjects.size();
+  for (int i = 0; i < numObjects; ++i)
+  {
+    const int tag = this->m_collisionObjects[i]->getIslandTag();
+    if (tag >= 0)
+      this->islandTags.push_back(tag);
+  }
+  std::sort(this->islandTags.begin(), this->islandTags.end());
+  this->statistics.islandCount = static_cast<std::size_t>(
+      std::unique(this->islandTags.begin(), this->islandTags.end()) -
+      this->islandTags.begin());
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::solveConstraints(
+    btContactSolverInfo &_solverInfo)
+{
+  AddCost(this->statistics.solverTime, this->statistics.solverAllocations,
+      [&]() { btMultiBodyDynamicsWorld::solveConstraints(_solverInfo); });
+
+  if (this->multiBodyStatisticsEnabled)
+    this->CollectConstraintStatistics();
+}
+
+/////////////////////////////////////////////////
+void GzMultiBodyDynamicsWorld::integrateTransforms(btScalar _timeStep)
+{
+  AddCost(this->statistics.integrationTime,
+      this->statistics.integrationAllocations, [&]()
+  {
+    btMultiBodyDynamicsWorld::integrateTransforms(_timeStep);
+  });
+}
+
+}  // namespace bullet_featherstone
+}  // namespace physics
+}  // namespace gz
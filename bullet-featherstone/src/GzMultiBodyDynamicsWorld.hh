@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_GZMULTIBODYDYNAMICSWORLD_HH_
+#define GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_GZMULTIBODYDYNAMICSWORLD_HH_
+
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <BulletCollision/BroadphaseCollision/btOverlappingPairCache.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletCollision/CollisionShapes/btStaticPlaneShape.h>
+#include <BulletDynamics/Featherstone/btMultiBodyConstraintSolver.h>
+#include <BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h>
+
+#include <gz/physics/World.hh>
+#include <gz/physics/bullet/CollisionDispatch.hh>
+
+namespace gz {
+namespace physics {
+namespace bullet_featherstone {
+
+/// \brief Broadphase filter group of the colliders that are infinite
+/// planes, see GzCollisionDispatcher::AddPlaneCollider. It is added to the
+/// group of their proxies, next to the ones that bullet defines.
+constexpr int kPlaneFilter = 64;
+
+/// \brief Overlap filter that keeps the colliders that are infinite planes
+/// out of the overlapping pairs of the broadphase. Their bounding boxes
+/// overlap every other collider, so the dispatcher tests them against each
+/// collider itself instead. Other pairs are filtered by their groups and
+/// masks, like bullet does without a filter.
+class GzPlaneOverlapFilter : public btOverlapFilterCallback
+{
+  // Documentation inherited
+  public: bool needBroadphaseCollision(
+      btBroadphaseProxy *_proxy0,
+      btBroadphaseProxy *_proxy1) const override;
+};
+
+/// \brief A btCollisionDispatcherMt that can time the narrowphase of each
+/// overlapping pair, see
+/// GzMultiBodyDynamicsWorld::SetMultiBodyStatisticsEnabled, and limit the
+/// number of contact points of each pair. Colliders that are infinite
+/// planes are tested against the bounding box of every other collider after
+/// the overlapping pairs are dispatched, see AddPlaneCollider.
+class GzCollisionDispatcher : public btCollisionDispatcherMt
+{
+  /// \brief Constructor
+  /// \param[in] _collisionConfiguration Collision configuration.
+  public: explicit GzCollisionDispatcher(
+      btCollisionConfiguration *_collisionConfiguration);
+
+  /// \brief Destructor
+  public: ~GzCollisionDispatcher() override;
+
+  /// \brief Set whether the following dispatches time each pair.
+  /// \param[in] _enable True to time each pair.
+  public: void SetPairTiming(bool _enable);
+
+  /// \brief Get the narrowphase time of each pair of the last dispatch.
+  /// \return Seconds spent on each pair, in the order of the overlapping
+  /// pair array, or an empty vector if the pairs were not timed.
+  public: const std::vector<double> &PairTimes() const;
+
+  /// \brief Set the maximum number of contact points of each pair of
+  /// collision objects, applied after each dispatch. The points of pairs
+  /// over the maximum are chosen to be spread out, starting from the
+  /// deepest one.
+  /// \param[in] _maxContacts Maximum number of contact points per pair.
+  /// Unlimited by default.
+  public: void SetMaxPairContacts(std::size_t _maxContacts);
+
+  /// \brief Get the maximum number of contact points of each pair.
+  /// \return Maximum number of contact points per pair.
+  public: std::size_t GetMaxPairContacts() const;
+
+  /// \brief Set the pairs of links of a multibody that are not tested for
+  /// collisions, e.g. because they never collided at sampled
+  /// configurations, see SampleNeverCollidingLinkPairs.
+  /// \param[in] _body Multibody.
+  /// \param[in] _pairs One flag per ordered pair of links of the multibody,
+  /// true if the pair is ignored. The pair of the links i and j, where the
+  /// base is -1, has the flag (i + 1) * (getNumLinks() + 1) + j + 1.
+  public: void SetIgnoredLinkPairs(
+      const btMultiBody *_body, std::vector<bool> _pairs);
+
+  /// \brief Test all the pairs of links of a multibody again.
+  /// \param[in] _body Multibody.
+  public: void RemoveIgnoredLinkPairs(const btMultiBody *_body);
+
+  /// \brief Get the number of ignored pairs of links of a multibody.
+  /// \param[in] _body Multibody.
+  /// \return Number of unordered pairs that are ignored.
+  public: std::size_t IgnoredLinkPairCount(const btMultiBody *_body) const;
+
+  /// \brief Set the collision objects that are tested against the plane
+  /// colliders.
+  /// \param[in] _objects Collision objects of the world.
+  public: void SetCollisionObjects(const btCollisionObjectArray *_objects);
+
+  /// \brief Test a collider whose shape is an infinite plane against the
+  /// bounding boxes of the other colliders after each dispatch, instead of
+  /// through the broadphase, see bullet::PlanePairs.
+  /// \param[in] _object Collider, see bullet::PlanePairs::PlaneShape. Its
+  /// proxy is given the kPlaneFilter group by
+  /// GzMultiBodyDynamicsWorld::addCollisionObject.
+  public: void AddPlaneCollider(btCollisionObject *_object);
+
+  /// \brief Check whether a collider is tested as a plane.
+  /// \param[in] _object Collider.
+  /// \return True if AddPlaneCollider was called for the collider.
+  public: bool IsPlaneCollider(const btCollisionObject *_object) const;
+
+  /// \brief Release the pairs of a collider with the plane colliders, and
+  /// stop testing it as a plane. Called before the collider is removed
+  /// from the world.
+  /// \param[in] _object Collider.
+  public: void RemoveCollider(const btCollisionObject *_object);
+
+  // Documentation inherited
+  public: bool needsCollision(
+      const btCollisionObject *_body0,
+      const btCollisionObject *_body1) override;
+
+  // Documentation inherited
+  public: void dispatchAllCollisionPairs(
+      btOverlappingPairCache *_pairCache,
+      const btDispatcherInfo &_dispatchInfo,
+      btDispatcher *_dispatcher) override;
+
+  /// \brief Near callback that runs the near callback that was set before
+  /// the dispatch and records its time. Pairs may be dispatched
+  /// concurrently, and each of them writes its own entry of pairTimes.
+  /// \param[in] _pair Overlapping pair.
+  /// \param[in] _dispatcher This dispatcher.
+  /// \param[in] _dispatchInfo Dispatch settings.
+  private: static void TimedNearCallback(
+      btBroadphasePair &_pair, btCollisionDispatcher &_dispatcher,
+      const btDispatcherInfo &_dispatchInfo);
+
+  /// \brief True to time each pair.
+  private: bool pairTiming = false;
+
+  /// \brief Time of each pair of the last dispatch.
+  private: std::vector<double> pairTimes;
+
+  /// \brief First pair of the dispatch in progress.
+  private: const btBroadphasePair *pairs = nullptr;
+
+  /// \brief Near callback that was set before the dispatch in progress.
+  private: btNearCallback timedCallback = nullptr;
+
+  /// \brief Limits the contact points of each pair after each dispatch.
+  private: bullet::PairContactLimiter contactLimiter;
+
+  /// \brief Ignored pairs of links of each multibody that has any, see
+  /// SetIgnoredLinkPairs.
+  private: std::unordered_map<const btMultiBody *, std::vector<bool>>
+      ignoredLinkPairs;
+
+  /// \brief Colliders that are tested as planes.
+  private: std::vector<btCollisionObject *> planeColliders;
+
+  /// \brief Pairs of the plane colliders with the other collision objects.
+  private: bullet::PlanePairs planePairs;
+
+  /// \brief Collision objects of the world, see SetCollisionObjects.
+  private: const btCollisionObjectArray *collisionObjects = nullptr;
+};
+
+/// \brief A btMultiBodyConstraintSolver that can count the rows and
+/// iterations of its solves, see SetStatisticsEnabled. Bullet solves the
+/// constraints of a step as one problem per batch of islands, with
+/// projected Gauss-Seidel iterations that stop once the least squares
+/// residual of the impulse changes of an iteration drops below
+/// m_leastSquaresResidualThreshold, and has no fallback solver.
+class GzMultiBodyConstraintSolver : public btMultiBodyConstraintSolver
+{
+  /// \brief Counters of the solves of a step.
+  public: using Statistics = GetSolverStatisticsFeature::SolverStatistics;
+
+  /// \brief Set whether the solves collect statistics.
+  /// \param[in] _enable True to collect statistics.
+  public: void SetStatisticsEnabled(bool _enable);
+
+  /// \brief Get whether the solves collect statistics.
+  /// \return True if statistics are collected.
+  public: bool GetStatisticsEnabled() const;
+
+  /// \brief Reset the statistics, before a step.
+  public: void ResetStatistics();
+
+  /// \brief Get the statistics collected since the last reset. The
+  /// residual is the least squares residual of the last iteration.
+  /// \return Statistics.
+  public: const Statistics &GetStatistics() const;
+
+  // Documentation inherited
+  protected: btScalar solveGroupCacheFriendlySetup(
+      btCollisionObject **_bodies, int _numBodies,
+      btPersistentManifold **_manifolds, int _numManifolds,
+      btTypedConstraint **_constraints, int _numConstraints,
+      const btContactSolverInfo &_infoGlobal,
+      btIDebugDraw *_debugDrawer) override;
+
+  // Documentation inherited
+  protected: btScalar solveSingleIteration(
+      int _iteration, btCollisionObject **_bodies, int _numBodies,
+      btPersistentManifold **_manifolds, int _numManifolds,
+      btTypedConstraint **_constraints, int _numConstraints,
+      const btContactSolverInfo &_infoGlobal,
+      btIDebugDraw *_debugDrawer) override;
+
+  // Documentation inherited
+  protected: btScalar solveGroupCacheFriendlyFinish(
+      btCollisionObject **_bodies, int _numBodies,
+      const btContactSolverInfo &_infoGlobal) override;
+
+  /// \brief Whether the solves collect statistics.
+  private: bool statisticsEnabled = false;
+
+  /// \brief Statistics collected since the last reset.
+  private: Statistics statistics;
+
+  /// \brief Number of rows of the solve in progress.
+  private: std::size_t solveRows = 0u;
+
+  /// \brief Iterations of the solve in progress.
+  private: std::size_t solveIterations = 0u;
+
+  /// \brief Residual of the last iteration of the solve in progress.
+  private: double solveResidual = 0.0;
+};
+
+/// \brief A btMultiBodyDynamicsWorld that records counters and timings of
+/// each phase of its steps.
+///
+/// Bullet computes the forward dynamics of multibodies and integrates their
+/// velocities while solving constraints, so that time is counted as solver
+/// time. Building the simulation islands is counted as solver time as well.
+/// Collision queries made outside of stepSimulation are not recorded.
+class GzMultiBodyDynamicsWorld : public btMultiBodyDynamicsWorld
+{
+  public: using StepStatistics = GetStepStatisticsFeature::StepStatistics;
+
+  /// \brief Counters and timings of a multibody in a step, see
+  /// SetMultiBodyStatisticsEnabled. When a step has several internal steps,
+  /// they add up over them.
+  public: struct MultiBodyStatistics
+  {
+    /// \brief Number of overlapping pairs of the colliders of the
+    /// multibody.
+    std::size_t candidatePairCount = 0u;
+
+    /// \brief Time spent on the overlapping pairs of the colliders of the
+    /// multibody, in seconds. Only measured with a GzCollisionDispatcher.
+    double narrowphaseTime = 0.0;
+
+    /// \brief Number of contact points of the colliders of the multibody.
+    std::size_t contactCount = 0u;
+
+    /// \brief Number of rows of the multibody constraints of the
+    /// multibody, such as joint limits and motors, plus a normal and two
+    /// friction rows per contact point.
+    std::size_t constraintRowCount = 0u;
+  };
+
+  /// \brief Constructor
+  /// \param[in] _dispatcher Collision dispatcher.
+  /// \param[in] _broadphase Broadphase.
+  /// \param[in] _solver Constraint solver.
+  /// \param[in] _collisionConfiguration Collision configuration.
+  public: GzMultiBodyDynamicsWorld(
+      btDispatcher *_dispatcher,
+      btBroadphaseInterface *_broadphase,
+      btMultiBodyConstraintSolver *_solver,
+      btCollisionConfiguration *_collisionConfiguration);
+
+  /// \brief Replace the broadphase of the world, keeping the colliders that
+  /// are infinite planes out of its overlapping pairs. The collision objects
+  /// need to be moved to the new broadphase by the caller.
+  /// \param[in] _broadphase New broadphase.
+  public: void SetBroadphase(btBroadphaseInterface *_broadphase);
+
+  /// \brief Add a collider again after its shape changed, if it became or
+  /// stopped being an infinite plane, see
+  /// GzCollisionDispatcher::AddPlaneCollider.
+  /// \param[in] _object Collider in the world.
+  public: void UpdatePlaneCollider(btCollisionObject *_object);
+
+  /// \brief Get counters and timings of the last call to stepSimulation.
+  /// The pose write-out time is not known to the world and is left at 0.
+  /// \return Statistics of the last step.
+  public: const StepStatistics &GetStepStatistics() const;
+
+  /// \brief Set whether the steps collect counters and timings of each
+  /// multibody. Disabled by default.
+  /// \param[in] _enable True to collect the statistics of each multibody.
+  public: void SetMultiBodyStatisticsEnabled(bool _enable);
+
+  /// \brief Get whether the steps collect the statistics of each
+  /// multibody.
+  /// \return True if the statistics of each multibody are collected.
+  public: bool GetMultiBodyStatisticsEnabled() const;
+
+  /// \brief Get counters and timings of each multibody in the last call to
+  /// stepSimulation. Colliders and constraints that belong to no multibody
+  /// are not counted.
+  /// \return Statistics of each multibody by its user index, which is the
+  /// entity ID of its model. Empty if they were not collected.
+  public: const std::map<int, MultiBodyStatistics> &GetMultiBodyStatistics()
+      const;
+
+  // Documentation inherited
+  public: int stepSimulation(
+      btScalar _timeStep, int _maxSubSteps = 1,
+      btScalar _fixedTimeStep = btScalar(1.) / btScalar(60.)) override;
+
+  /// \brief Add a collision object. Colliders whose shape is an infinite
+  /// plane are tested by the dispatcher instead of the broadphase, see
+  /// GzCollisionDispatcher::AddPlaneCollider.
+  /// \param[in] _object Collision object.
+  /// \param[in] _group Broadphase filter group.
+  /// \param[in] _mask Broadphase filter mask.
+  public: void addCollisionObject(
+      btCollisionObject *_object,
+      int _group = btBroadphaseProxy::DefaultFilter,
+      int _mask = btBroadphaseProxy::AllFilter) override;
+
+  // Documentation inherited
+  public: void removeCollisionObject(btCollisionObject *_object) override;
+
+  // Documentation inherited
+  public: void updateAabbs() override;
+
+  // Documentation inherited
+  public: void computeOverlappingPairs() override;
+
+  // Documentation inherited
+  public: void performDiscreteCollisionDetection() override;
+
+  // Documentation inherited
+  protected: void predictUnconstraintMotion(btScalar _timeStep) override;
+
+  // Documentation inherited
+  protected: void calculateSimulationIslands() override;
+
+  // Documentation inherited
+  protected: void solveConstraints(btContactSolverInfo &_solverInfo) override;
+
+  // Documentation inherited
+  public: void integrateTransforms(btScalar _timeStep) override;
+
+  /// \brief Add the overlapping pairs and contacts of the collision
+  /// detection that just ran to multiBodyStatistics.
+  private: void CollectCollisionStatistics();
+
+  /// \brief Add the rows of the multibody constraints to
+  /// multiBodyStatistics.
+  private: void CollectConstraintStatistics();
+
+  /// \brief Statistics of the last step.
+  private: StepStatistics statistics;
+
+  /// \brief Statistics of each multibody in the last step.
+  private: std::map<int, MultiBodyStatistics> multiBodyStatistics;
+
+  /// \brief True to collect multiBodyStatistics.
+  private: bool multiBodyStatisticsEnabled = false;
+
+  /// \brief True while stepSimulation runs.
+  private: bool stepping = false;
+
+  /// \brief Island tags of the collision objects, reused across steps.
+  private: std::vector<int> islandTags;
+
+  /// \brief Filter of the overlapping pairs of the broadphase.
+  private: GzPlaneOverlapFilter planeFilter;
+};
+
+}  // namespace bullet_featherstone
+}  // namespace physics
+}  // namespace gz
+
+#endif
@@ -19,6 +19,8 @@
 
 #include <algorithm>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <gz/common/Console.hh>
 #include <sdf/Joint.hh>
@@ -27,6 +29,93 @@ namespace gz {
 namespace physics {
 namespace bullet_featherstone {
 
+/////////////////////////////////////////////////
+/// \brief Index in the btMultiBody and DOF count of every joint of a model,
+/// in the layout used by GetModelJointState. Joints that are not part of the
+/// multibody have no DOFs and are skipped.
+static std::vector<std::pair<int, int>> ModelJointDofs(
+    const EntityMap<JointInfoPtr> &_joints, const ModelInfo &_model)
+{
+  std::vector<std::pair<int, int>> dofs;
+  dofs.reserve(_model.jointEntityIds.size());
+  for (const auto jointID : _model.jointEntityIds)
+  {
+    const auto *identifier =
+        std::get_if<InternalJoint>(&_joints.at(jointID)->identifier);
+    if (!identifier)
+      continue;
+
+    const int index = identifier->indexInBtModel;
+    dofs.emplace_back(index, _model.body->getLink(index).m_dofCount);
+  }
+  return dofs;
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy one btMultiBody array, read through _get(linkIndex), into
+/// _values for every joint DOF of a model.
+template <typename GetT>
+static void GetModelJointValues(
+    const EntityMap<JointInfoPtr> &_joints, const ModelInfo &_model,
+    Eigen::VectorXd &_values, GetT _get)
+{
+  const auto dofs = ModelJointDofs(_joints, _model);
+  Eigen::Index size = 0;
+  for (const auto &[index, count] : dofs)
+    size += count;
+
+  _values.resize(size);
+  Eigen::Index k = 0;
+  for (const auto &[index, count] : dofs)
+  {
+    const btScalar *array = _get(index);
+    for (int i = 0; i < count; ++i)
+      _values[k++] = static_cast<double>(array[i]);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy _values into one btMultiBody array, accessed through
+/// _get(linkIndex), for every joint DOF of a model.
+/// \return False, without setting anything, if _values has the wrong size
+/// or holds a non-finite value.
+template <typename GetT>
+static bool SetModelJointValues(
+    const EntityMap<JointInfoPtr> &_joints, const ModelInfo &_model,
+    const Eigen::VectorXd &_values, const char *_quantity, GetT _get)
+{
+  const auto dofs = ModelJointDofs(_joints, _model);
+  Eigen::Index size = 0;
+  for (const auto &[index, count] : dofs)
+    size += count;
+
+  if (_values.size() != size)
+  {
+    gzerr << "Invalid number of joint " << _quantity << " values ["
+          << _values.size() << "] set on model [" << _model.name
+          << "], which has [" << size << "] joint DOFs. The values will be "
+          << "ignored\n";
+    return false;
+  }
+
+  if (!_values.allFinite())
+  {
+    gzerr << "Invalid joint " << _quantity << " values set on model ["
+          << _model.name << "]. The values will be ignored\n";
+    return false;
+  }
+
+  Eigen::Index k = 0;
+  for (const auto &[index, count] : dofs)
+  {
+    btScalar *array = _get(index);
+    for (int i = 0; i < count; ++i)
+      array[i] = static_cast<btScalar>(_values[k++]);
+  }
+  _model.body->wakeUp();
+  return true;
+}
+
 /////////////////////////////////////////////////
 double JointFeatures::GetJointPosition(
     const Identity &_id, const std::size_t _dof) const
@@ -104,6 +193,7 @@ Pose3d JointFeatures::GetJointTransform(const Identity &_id) const
 void JointFeatures::SetJointPosition(
   const Identity &_id, const std::size_t _dof, const double _value)
 {
+  this->InvalidateFrameData();
   const auto *joint = this->ReferenceInterface<JointInfo>(_id);
   const auto *identifier = std::get_if<InternalJoint>(&joint->identifier);
   if (!identifier)
@@ -119,6 +209,7 @@ void JointFeatures::SetJointPosition(
 void JointFeatures::SetJointVelocity(
   const Identity &_id, const std::size_t _dof, const double _value)
 {
+  this->InvalidateFrameData();
   const auto *joint = this->ReferenceInterface<JointInfo>(_id);
   const auto *identifier = std::get_if<InternalJoint>(&joint->identifier);
   if (!identifier)
@@ -158,7 +249,11 @@ void JointFeatures::SetJointForce(
   const auto *model = this->ReferenceInterface<ModelInfo>(joint->model);
   model->body->getJointTorqueMultiDof(
     identifier->indexInBtModel)[_dof] = static_cast<btScalar>(_value);
-  model->body->wakeUp();
+
+  // Bullet clears the forces after each step, so only a force that is not
+  // zero changes what the next step does.
+  if (_value != 0.0)
+    model->body->wakeUp();
 }
 
 /////////////////////////////////////////////////
@@ -286,19 +381,19 @@ void JointFeatures::SetJointVelocityCommand(
   }
 
   auto modelInfo = this->ReferenceInterface<ModelInfo>(jointInfo->model);
-  if (!jointInfo->motor)
+  auto *world = this->ReferenceInterface<WorldInfo>(modelInfo->world);
+  auto &constraints = JointConstraintsOf(*world, modelInfo->body.get());
+  const int link =
+      std::get<InternalJoint>(jointInfo->identifier).indexInBtModel;
+  const auto velocity = static_cast<btScalar>(_value);
+  if (constraints.HasMotor(link) && jointInfo->velocityCommand == velocity)
   {
-    jointInfo->motor = std::make_shared<btMultiBodyJointMotor>(
-      modelInfo->body.get(),
-      std::get<InternalJoint>(jointInfo->identifier).indexInBtModel,
-      0,
-      static_cast<btScalar>(0),
-      static_cast<btScalar>(jointInfo->effort));
-    auto *world = this->ReferenceInterface<WorldInfo>(modelInfo->world);
-    world->world->addMultiBodyConstraint(jointInfo->motor.get());
+    // Repeating the last command does not wake the model up
+    return;
   }
 
-  jointInfo->motor->setVelocityTarget(static_cast<btScalar>(_value));
+  constraints.SetMotor(link, velocity, jointInfo->effort);
+  jointInfo->velocityCommand = velocity;
   modelInfo->body->wakeUp();
 }
 
@@ -308,6 +403,7 @@ Identity JointFeatures::AttachFixedJoint(
     const BaseLink3dPtr &_parent,
     const std::string &_name)
 {
+  this->InvalidateFrameData();
   auto *linkInfo = this->ReferenceInterface<LinkInfo>(_childID);
   auto *modelInfo = this->ReferenceInterface<ModelInfo>(linkInfo->model);
   auto *parentLinkInfo = this->ReferenceInterface<LinkInfo>(
@@ -350,6 +446,7 @@ Identity JointFeatures::AttachFixedJoint(
 /////////////////////////////////////////////////
 void JointFeatures::DetachJoint(const Identity &_jointId)
 {
+  this->InvalidateFrameData();
   auto jointInfo = this->ReferenceInterface<JointInfo>(_jointId);
   if (jointInfo->fixedConstraint)
   {
@@ -368,6 +465,7 @@ void JointFeatures::DetachJoint(const Identity &_jointId)
 void JointFeatures::SetJointTransformFromParent(
     const Identity &_id, const Pose3d &_pose)
 {
+  this->InvalidateFrameData();
   auto jointInfo = this->ReferenceInterface<JointInfo>(_id);
 
   if (jointInfo->fixedConstraint)
@@ -381,21 +479,48 @@ void JointFeatures::SetJointTransformFromParent(
 }
 
 /////////////////////////////////////////////////
-Wrench3d JointFeatures::GetJointTransmittedWrenchInJointFrame(
-    const Identity &_id) const
+/// \brief Transmitted wrench of a joint in the joint frame, from the
+/// btMultiBodyJointFeedback of the joint.
+static Wrench3d JointTransmittedWrench(const JointInfo &_jointInfo)
 {
-  auto jointInfo = this->ReferenceInterface<JointInfo>(_id);
-
   Wrench3d wrenchOut;
 
   // Convert the force and torque into the joint's frame of reference.
-  wrenchOut.force = jointInfo->tf_to_child.rotation() * convert(
-    jointInfo->jointFeedback->m_reactionForces.getLinear());
-  wrenchOut.torque = jointInfo->tf_to_child.rotation() * convert(
-    jointInfo->jointFeedback->m_reactionForces.getAngular());
+  wrenchOut.force = _jointInfo.tf_to_child.rotation() * convert(
+    _jointInfo.jointFeedback->m_reactionForces.getLinear());
+  wrenchOut.torque = _jointInfo.tf_to_child.rotation() * convert(
+    _jointInfo.jointFeedback->m_reactionForces.getAngular());
   return wrenchOut;
 }
 
+/////////////////////////////////////////////////
+Wrench3d JointFeatures::GetJointTransmittedWrenchInJointFrame(
+    const Identity &_id) const
+{
+  return JointTransmittedWrench(*this->ReferenceInterface<JointInfo>(_id));
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointTransmittedWrenches(
+    const Identity &_modelID, std::vector<Wrench3d> &_wrenches) const
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  _wrenches.resize(model->jointEntityIds.size());
+  for (std::size_t i = 0; i < model->jointEntityIds.size(); ++i)
+  {
+    // Joints that are not part of the multibody have no feedback
+    const auto &jointInfo = this->joints.at(model->jointEntityIds[i]);
+    if (!jointInfo->jointFeedback)
+    {
+      _wrenches[i].force.setZero();
+      _wrenches[i].torque.setZero();
+      continue;
+    }
+
+    _wrenches[i] = JointTransmittedWrench(*jointInfo);
+  }
+}
+
 /////////////////////////////////////////////////
 bool JointFeatures::SetJointMimicConstraint(
     const Identity &_id,
@@ -405,6 +530,44 @@ bool JointFeatures::SetJointMimicConstraint(
     double _multiplier,
     double _offset,
     double _reference)
+{
+  return this->SetMimicConstraintImpl(_id, _dof, _leaderJoint->FullIdentity(),
+      _leaderAxisDof, _multiplier, _offset, _reference);
+}
+
+/////////////////////////////////////////////////
+std::size_t JointFeatures::SetWorldMimicConstraints(
+    const Identity &/*_worldID*/,
+    const MimicConstraint *_constraints,
+    std::size_t _count)
+{
+  std::size_t numSet = 0;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const MimicConstraint &constraint = _constraints[i];
+    if (!constraint.follower || !constraint.leader)
+      continue;
+
+    if (this->SetMimicConstraintImpl(constraint.follower->FullIdentity(),
+          constraint.followerDof, constraint.leader->FullIdentity(),
+          constraint.leaderDof, constraint.multiplier, constraint.offset,
+          constraint.reference))
+    {
+      ++numSet;
+    }
+  }
+  return numSet;
+}
+
+/////////////////////////////////////////////////
+bool JointFeatures::SetMimicConstraintImpl(
+    const Identity &_id,
+    std::size_t _dof,
+    const Identity &_leaderJointId,
+    std::size_t _leaderAxisDof,
+    double _multiplier,
+    double _offset,
+    double _reference)
 {
   if (_dof != 0 || _leaderAxisDof != 0)
   {
@@ -423,35 +586,20 @@ bool JointFeatures::SetJointMimicConstraint(
   const auto *model =
       this->ReferenceInterface<ModelInfo>(followerJoint->model);
 
-  auto leaderJointId = _leaderJoint->FullIdentity();
-  auto leaderJoint = this->ReferenceInterface<JointInfo>(leaderJointId);
+  auto leaderJoint = this->ReferenceInterface<JointInfo>(_leaderJointId);
   auto leaderChild = this->ReferenceInterface<LinkInfo>(
       leaderJoint->childLinkID);
   auto leaderChildIndexInModel = leaderChild->indexInModel.value_or(-1);
 
-  // Get world pointer and remove an existing mimic / gear constraint
-  // after follower and leader entities have been found.
+  // The gear of the follower is replaced in the constraint of the model,
+  // which the world keeps, so its constraint list is not rebuilt.
   auto *world = this->ReferenceInterface<WorldInfo>(model->world);
-  if (followerJoint->gearConstraint)
-  {
-    world->world->removeMultiBodyConstraint(
-        followerJoint->gearConstraint.get());
-    followerJoint->gearConstraint.reset();
-  }
+  auto &constraints = JointConstraintsOf(*world, model->body.get());
 
-  followerJoint->gearConstraint = std::make_shared<btMultiBodyGearConstraint>(
-      model->body.get(),
-      followerChildIndexInModel,
-      model->body.get(),
-      leaderChildIndexInModel,
-      btVector3(0, 0, 0),
-      btVector3(0, 0, 0),
-      btMatrix3x3::getIdentity(),
-      btMatrix3x3::getIdentity());
   // btMultiBodyGearConstraint isn't clearly documented, but from trial and
   // and error, I found that the Gear Ratio should have the opposite sign
   // of the multiplier parameter.
-  followerJoint->gearConstraint->setGearRatio(btScalar(-_multiplier));
+  //
   // Recall the linear equation from the definition of the mimic constraint:
   // follower_position = multiplier * (leader_position - reference) + offset
   //
@@ -459,17 +607,110 @@ bool JointFeatures::SetJointMimicConstraint(
   // reference and offset parameters together:
   // follower_position = multiplier*leader_position
   //                   + offset - multiplier * reference
-  // The RelativePositionTarget is then set as (offset - multiplier * reference)
-  followerJoint->gearConstraint->setRelativePositionTarget(
-      btScalar(_offset - _multiplier * _reference));
-  // TODO(scpeters): figure out what is a good value for this
-  followerJoint->gearConstraint->setMaxAppliedImpulse(btScalar(1e8));
-  // setErp is needed to correct position constraint errors
-  // this is especially relevant to the offset and reference parameters
-  followerJoint->gearConstraint->setErp(btScalar(0.3));
-  world->world->addMultiBodyConstraint(followerJoint->gearConstraint.get());
+  // The relative position target is then (offset - multiplier * reference).
+  //
+  // An erp is needed to correct position constraint errors, this is
+  // especially relevant to the offset and reference parameters.
+  // TODO(scpeters): figure out what is a good value for the max impulse
+  constraints.SetGear(
+      followerChildIndexInModel,
+      leaderChildIndexInModel,
+      btScalar(-_multiplier),
+      btScalar(_offset - _multiplier * _reference),
+      btScalar(0.3),
+      btScalar(1e8));
   return true;
 }
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointPositions(
+    const Identity &_modelID, Eigen::VectorXd &_positions) const
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  GetModelJointValues(this->joints, *model, _positions, [model](int _index)
+      {
+        return model->body->getJointPosMultiDof(_index);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointVelocities(
+    const Identity &_modelID, Eigen::VectorXd &_velocities) const
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  GetModelJointValues(this->joints, *model, _velocities, [model](int _index)
+      {
+        return model->body->getJointVelMultiDof(_index);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointAccelerations(
+    const Identity &_modelID, Eigen::VectorXd &_accelerations) const
+{
+  // Joint accelerations are not available, as in GetJointAcceleration.
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  Eigen::Index size = 0;
+  for (const auto &[index, count] : ModelJointDofs(this->joints, *model))
+    size += count;
+  _accelerations.setConstant(size, gz::math::NAN_D);
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointForces(
+    const Identity &_modelID, Eigen::VectorXd &_forces) const
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  GetModelJointValues(this->joints, *model, _forces, [model](int _index)
+      {
+        return model->body->getJointTorqueMultiDof(_index);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointPositions(
+    const Identity &_modelID, const Eigen::VectorXd &_positions)
+{
+  this->InvalidateFrameData();
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  SetModelJointValues(this->joints, *model, _positions, "position",
+      [model](int _index)
+      {
+        return model->body->getJointPosMultiDof(_index);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointVelocities(
+    const Identity &_modelID, const Eigen::VectorXd &_velocities)
+{
+  this->InvalidateFrameData();
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  SetModelJointValues(this->joints, *model, _velocities, "velocity",
+      [model](int _index)
+      {
+        return model->body->getJointVelMultiDof(_index);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointAccelerations(
+    const Identity &/*_modelID*/, const Eigen::VectorXd &/*_accelerations*/)
+{
+  // Do nothing, as in SetJointAcceleration
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointForces(
+    const Identity &_modelID, const Eigen::VectorXd &_forces)
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  SetModelJointValues(this->joints, *model, _forces, "force",
+      [model](int _index)
+      {
+        return model->body->getJointTorqueMultiDof(_index);
+      });
+}
 }  // namespace bullet_featherstone
 }  // namespace physics
 }  // namespace gz
@@ -19,6 +19,7 @@
 #define GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_JOINTFEATURES_HH_
 
 #include <string>
+#include <vector>
 
 #include <gz/physics/FixedJoint.hh>
 #include <gz/physics/Joint.hh>
@@ -48,8 +49,13 @@ struct JointFeatureList : FeatureList<
   FixedJointCast,
 
   GetJointTransmittedWrench,
+  GetModelJointTransmittedWrenches,
 
   SetMimicConstraintFeature,
+  SetMimicConstraintsFeature,
+
+  GetModelJointState,
+  SetModelJointState,
 
   FixedJointCast
 > { };
@@ -58,6 +64,9 @@ class JointFeatures :
     public virtual Base,
     public virtual Implements3d<JointFeatureList>
 {
+  public: using MimicConstraint =
+      SetMimicConstraintsFeature::MimicConstraintT<FeaturePolicy3d>;
+
   // ----- Get Basic Joint State -----
   public: double GetJointPosition(
       const Identity &_id, const std::size_t _dof) const override;
@@ -144,6 +153,10 @@ class JointFeatures :
   public: Wrench3d GetJointTransmittedWrenchInJointFrame(
       const Identity &_id) const override;
 
+  public: void GetModelJointTransmittedWrenches(
+      const Identity &_modelID,
+      std::vector<Wrench3d> &_wrenches) const override;
+
   // ----- Mimic joint constraint -----
   public: bool SetJointMimicConstraint(
       const Identity &_id,
@@ -153,6 +166,50 @@ class JointFeatures :
       double _multiplier,
       double _offset,
       double _reference) override;
+
+  public: std::size_t SetWorldMimicConstraints(
+      const Identity &_worldID,
+      const MimicConstraint *_constraints,
+      std::size_t _count) override;
+
+  // ----- Model joint state -----
+  public: void GetModelJointPositions(
+      const Identity &_modelID, Eigen::VectorXd &_positions) const override;
+
+  public: void GetModelJointVelocities(
+      const Identity &_modelID, Eigen::VectorXd &_velocities) const override;
+
+  public: void GetModelJointAccelerations(
+      const Identity &_modelID,
+      Eigen::VectorXd &_accelerations) const override;
+
+  public: void GetModelJointForces(
+      const Identity &_modelID, Eigen::VectorXd &_forces) const override;
+
+  public: void SetModelJointPositions(
+      const Identity &_modelID, const Eigen::VectorXd &_positions) override;
+
+  public: void SetModelJointVelocities(
+      const Identity &_modelID, const Eigen::VectorXd &_velocities) override;
+
+  public: void SetModelJointAccelerations(
+      const Identity &_modelID,
+      const Eigen::VectorXd &_accelerations) override;
+
+  public: void SetModelJointForces(
+      const Identity &_modelID, const Eigen::VectorXd &_forces) override;
+
+  /// \brief Set the mimic constraint of a follower joint, updating its
+  /// existing gear constraint in place if it is between the same links.
+  /// See SetJointMimicConstraint.
+  private: bool SetMimicConstraintImpl(
+      const Identity &_id,
+      std::size_t _dof,
+      const Identity &_leaderJointId,
+      std::size_t _leaderAxisDof,
+      double _multiplier,
+      double _offset,
+      double _reference);
 };
 }  // namespace bullet_featherstone
 }  // namespace physics
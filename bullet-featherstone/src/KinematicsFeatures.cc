@@ -15,6 +15,9 @@
  *
 */
 
+#include <algorithm>
+#include <vector>
+
 #include <gz/common/Console.hh>
 #include "KinematicsFeatures.hh"
 
@@ -22,101 +25,216 @@ namespace gz {
 namespace physics {
 namespace bullet_featherstone {
 
+/////////////////////////////////////////////////
+static FrameData3d LinkFrameData(
+    const ModelInfo &_model,
+    const LinkInfo &_link,
+    const Eigen::Isometry3d &_pose,
+    const FrameDataComponents _components = FRAME_DATA_ALL)
+{
+  FrameData3d data;
+  data.pose = _pose;
+  if (!(_components & FRAME_DATA_VELOCITY))
+    return data;
+
+  const auto &link = _model.body->getLink(*_link.indexInModel);
+  data.linearVelocity = convert(link.m_absFrameTotVelocity.getLinear());
+  data.angularVelocity = convert(link.m_absFrameTotVelocity.getAngular());
+  return data;
+}
+
+/////////////////////////////////////////////////
+static FrameData3d BaseFrameData(
+    const ModelInfo *_model,
+    const FrameDataComponents _components = FRAME_DATA_ALL)
+{
+  FrameData3d data;
+  if (_model && _model->body)
+  {
+    data.pose = convert(_model->body->getBaseWorldTransform())
+      * _model->baseInertiaToLinkFrame;
+    if (_components & FRAME_DATA_VELOCITY)
+    {
+      data.linearVelocity = convert(_model->body->getBaseVel());
+      data.angularVelocity = convert(_model->body->getBaseOmega());
+    }
+  }
+  return data;
+}
+
 /////////////////////////////////////////////////
 FrameData3d KinematicsFeatures::FrameDataRelativeToWorld(
     const FrameID &_id) const
 {
-  const auto linkIt = this->links.find(_id.ID());
+  return this->PartialFrameDataRelativeToWorld(_id, FRAME_DATA_ALL);
+}
+
+/////////////////////////////////////////////////
+FrameData3d KinematicsFeatures::PartialFrameDataRelativeToWorld(
+    const FrameID &_id, const FrameDataComponents _components) const
+{
+  FrameData3d cached;
+  if (this->frameDataCache.Find(_id.ID(), cached))
+    return cached;
+
   const ModelInfo *model = nullptr;
-  if (linkIt != this->links.end())
+  const LinkInfo *link = this->FindFrameLink(_id, model);
+
+  // A link without an index is the base link, whose data is the model data.
+  const FrameData3d data = (!link || !link->indexInModel.has_value()) ?
+      BaseFrameData(model, _components) :
+      LinkFrameData(*model, *link,
+          this->LinkWorldTransform(*model, *link), _components);
+
+  // Only complete FrameData is cached, since it answers every query.
+  if ((_components & FRAME_DATA_ALL) == FRAME_DATA_ALL)
+    this->frameDataCache.Insert(_id.ID(), data);
+  return data;
+}
+
+/////////////////////////////////////////////////
+template <typename Scalar>
+void KinematicsFeatures::FillBatchFrameData(
+    const FrameID *_ids,
+    const std::size_t _count,
+    FrameData<Scalar, 3> *_output) const
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const ModelInfo *model = nullptr;
+    const LinkInfo *link = this->FindFrameLink(_ids[i], model);
+    if (!link || !link->indexInModel.has_value())
+    {
+      _output[i] = CastFrameData<Scalar>(BaseFrameData(model));
+      continue;
+    }
+
+    // The link poses of each model are computed once, when the first frame
+    // of the model is requested.
+    _output[i] = CastFrameData<Scalar>(LinkFrameData(*model, *link,
+        this->LinkWorldTransform(*model, *link)));
+  }
+}
+
+/////////////////////////////////////////////////
+template <typename Scalar>
+void KinematicsFeatures::FillLinkFrameData(
+    const Identity &_modelID,
+    std::vector<FrameData<Scalar, 3>> &_output) const
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  _output.resize(model->linkEntityIds.size());
+  if (!model->body)
   {
-    const auto &linkInfo = linkIt->second;
-    const auto indexOpt = linkInfo->indexInModel;
-    model = this->ReferenceInterface<ModelInfo>(linkInfo->model);
+    std::fill(_output.begin(), _output.end(), FrameData<Scalar, 3>());
+    return;
+  }
+
+  const auto &linkPoses = this->LinkInertiaPoses(*model);
 
-    if (indexOpt.has_value())
+  for (std::size_t i = 0; i < model->linkEntityIds.size(); ++i)
+  {
+    const auto &link = *this->links.at(model->linkEntityIds[i]);
+    if (!link.indexInModel.has_value())
     {
-      const auto index = *indexOpt;
-      FrameData data;
-      data.pose = GetWorldTransformOfLink(*model, *linkInfo);
-      const auto &link = model->body->getLink(index);
-      data.linearVelocity = convert(link.m_absFrameTotVelocity.getLinear());
-      data.angularVelocity = convert(link.m_absFrameTotVelocity.getAngular());
-      return data;
+      _output[i] = CastFrameData<Scalar>(BaseFrameData(model));
+      continue;
     }
 
-    // If indexOpt is nullopt then the link is the base link which will be
-    // calculated below.
+    const auto index = static_cast<std::size_t>(*link.indexInModel);
+    _output[i] = CastFrameData<Scalar>(LinkFrameData(*model, link,
+        convert(linkPoses[index]) * link.inertiaToLinkFrame));
+  }
+}
+
+/////////////////////////////////////////////////
+void KinematicsFeatures::BatchFrameDataRelativeToWorld(
+    const FrameID *_ids,
+    const std::size_t _count,
+    FrameData3d *_output) const
+{
+  this->FillBatchFrameData(_ids, _count, _output);
+}
+
+/////////////////////////////////////////////////
+void KinematicsFeatures::LinkFrameDataRelativeToWorld(
+    const Identity &_modelID,
+    std::vector<FrameData3d> &_output) const
+{
+  this->FillLinkFrameData(_modelID, _output);
+}
+
+/////////////////////////////////////////////////
+void KinematicsFeatures::BatchFloatFrameDataRelativeToWorld(
+    const FrameID *_ids,
+    const std::size_t _count,
+    FrameData3f *_output) const
+{
+  this->FillBatchFrameData(_ids, _count, _output);
+}
+
+/////////////////////////////////////////////////
+void KinematicsFeatures::LinkFloatFrameDataRelativeToWorld(
+    const Identity &_modelID,
+    std::vector<FrameData3f> &_output) const
+{
+  this->FillLinkFrameData(_modelID, _output);
+}
+
+/////////////////////////////////////////////////
+void KinematicsFeatures::SetFrameDataCacheEnabled(
+    const Identity &, const bool _enabled)
+{
+  this->frameDataCache.SetEnabled(_enabled);
+}
+
+/////////////////////////////////////////////////
+bool KinematicsFeatures::GetFrameDataCacheEnabled(const Identity &) const
+{
+  return this->frameDataCache.Enabled();
+}
+
+/////////////////////////////////////////////////
+const LinkInfo *KinematicsFeatures::FindFrameLink(
+    const FrameID &_id, const ModelInfo *&_model) const
+{
+  const LinkInfo *link = nullptr;
+  const auto linkIt = this->links.find(_id.ID());
+  if (linkIt != this->links.end())
+  {
+    link = linkIt->second.get();
   }
   else
   {
-    auto jointIt = this->joints.find(_id.ID());
+    // Joints and collisions use the kinematics of the link they are
+    // attached to.
+    const auto jointIt = this->joints.find(_id.ID());
     if (jointIt != this->joints.end())
     {
-      const auto &jointInfo = jointIt->second;
-
-      const auto linkIt2 = this->links.find(jointInfo->childLinkID);
-      if (linkIt2 != this->links.end())
-      {
-        const auto &linkInfo2 = linkIt2->second;
-        const auto indexOpt2 = linkInfo2->indexInModel;
-        model = this->ReferenceInterface<ModelInfo>(linkInfo2->model);
-
-        if (indexOpt2.has_value())
-        {
-          const auto index2 = *indexOpt2;
-          FrameData data;
-          data.pose = GetWorldTransformOfLink(*model, *linkInfo2);
-          const auto &link = model->body->getLink(index2);
-          data.linearVelocity = convert(
-            link.m_absFrameTotVelocity.getLinear());
-          data.angularVelocity = convert(
-            link.m_absFrameTotVelocity.getAngular());
-          return data;
-        }
-      }
+      const auto childIt = this->links.find(jointIt->second->childLinkID);
+      if (childIt != this->links.end())
+        link = childIt->second.get();
     }
-
-    auto collisionIt = this->collisions.find(_id.ID());
-    if (collisionIt != this->collisions.end())
+    else
     {
-      const auto &collisionInfo = collisionIt->second;
-
-      const auto linkIt2 = this->links.find(collisionInfo->link);
-      if (linkIt2 != this->links.end())
+      const auto collisionIt = this->collisions.find(_id.ID());
+      if (collisionIt != this->collisions.end())
       {
-        const auto &linkInfo2 = linkIt2->second;
-        const auto indexOpt2 = linkInfo2->indexInModel;
-        model = this->ReferenceInterface<ModelInfo>(linkInfo2->model);
-
-        if (indexOpt2.has_value())
-        {
-          const auto index2 = *indexOpt2;
-          FrameData data;
-          data.pose = GetWorldTransformOfLink(*model, *linkInfo2);
-          const auto &link = model->body->getLink(index2);
-          data.linearVelocity = convert(
-            link.m_absFrameTotVelocity.getLinear());
-          data.angularVelocity = convert(
-            link.m_absFrameTotVelocity.getAngular());
-          return data;
-        }
+        const auto parentIt = this->links.find(collisionIt->second->link);
+        if (parentIt != this->links.end())
+          link = parentIt->second.get();
       }
     }
-
-    if (!model || model->body == nullptr)
-      model = this->FrameInterface<ModelInfo>(_id);
   }
 
-  FrameData data;
-  if(model && model->body)
+  if (link)
   {
-    data.pose = convert(model->body->getBaseWorldTransform())
-      * model->baseInertiaToLinkFrame;
-    data.linearVelocity = convert(model->body->getBaseVel());
-    data.angularVelocity = convert(model->body->getBaseOmega());
+    _model = this->ReferenceInterface<ModelInfo>(link->model);
+    return link;
   }
-  return data;
+
+  _model = this->FrameInterface<ModelInfo>(_id);
+  return nullptr;
 }
 
 }  // namespace bullet_featherstone
@@ -18,6 +18,8 @@
 #ifndef GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_KINEMATICSFEATURES_HH_
 #define GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_KINEMATICSFEATURES_HH_
 
+#include <vector>
+
 #include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/FreeGroup.hh>
 
@@ -30,7 +32,10 @@ namespace bullet_featherstone {
 struct KinematicsFeatureList : gz::physics::FeatureList<
   LinkFrameSemantics,
   ModelFrameSemantics,
-  FreeGroupFrameSemantics
+  FreeGroupFrameSemantics,
+  BatchFrameSemantics,
+  BatchFloatFrameSemantics,
+  SetFrameDataCacheFeature
 > { };
 
 class KinematicsFeatures :
@@ -39,6 +44,65 @@ class KinematicsFeatures :
 {
   public: FrameData3d FrameDataRelativeToWorld(
               const FrameID &_id) const override;
+
+  // Documentation inherited
+  public: FrameData3d PartialFrameDataRelativeToWorld(
+              const FrameID &_id,
+              FrameDataComponents _components) const override;
+
+  // Documentation inherited
+  public: void BatchFrameDataRelativeToWorld(
+              const FrameID *_ids,
+              std::size_t _count,
+              FrameData3d *_output) const override;
+
+  // Documentation inherited
+  public: void LinkFrameDataRelativeToWorld(
+              const Identity &_modelID,
+              std::vector<FrameData3d> &_output) const override;
+
+  // Documentation inherited
+  public: void BatchFloatFrameDataRelativeToWorld(
+              const FrameID *_ids,
+              std::size_t _count,
+              FrameData3f *_output) const override;
+
+  // Documentation inherited
+  public: void LinkFloatFrameDataRelativeToWorld(
+              const Identity &_modelID,
+              std::vector<FrameData3f> &_output) const override;
+
+  // Documentation inherited
+  public: void SetFrameDataCacheEnabled(
+              const Identity &_engineID, bool _enabled) override;
+
+  // Documentation inherited
+  public: bool GetFrameDataCacheEnabled(
+              const Identity &_engineID) const override;
+
+  /// \brief Find the model and link whose kinematics describe a frame.
+  /// \param[in] _id The frame to look up.
+  /// \param[out] _model The model of the frame.
+  /// \return The link of the frame, or nullptr if the frame is a model.
+  private: const LinkInfo *FindFrameLink(
+              const FrameID &_id, const ModelInfo *&_model) const;
+
+  /// \brief Fill _output[i] with the FrameData of _ids[i] with respect to
+  /// the world, converted to Scalar.
+  /// \param[in] _ids Frames to read
+  /// \param[in] _count Number of frames
+  /// \param[out] _output FrameData of each frame
+  private: template <typename Scalar>
+  void FillBatchFrameData(const FrameID *_ids, std::size_t _count,
+              FrameData<Scalar, 3> *_output) const;
+
+  /// \brief Fill _output with the FrameData of each link of a model with
+  /// respect to the world, converted to Scalar.
+  /// \param[in] _modelID Model to read
+  /// \param[out] _output FrameData of each link, in link index order
+  private: template <typename Scalar>
+  void FillLinkFrameData(const Identity &_modelID,
+              std::vector<FrameData<Scalar, 3>> &_output) const;
 };
 
 }  // namespace bullet_featherstone
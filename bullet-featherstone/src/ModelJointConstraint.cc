@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "ModelJointConstraint.hh"
+
+#include <BulletDynamics/Featherstone/btMultiBodyLinkCollider.h>
+
+#include <algorithm>
+
+namespace gz {
+namespace physics {
+namespace bullet_featherstone {
+
+/////////////////////////////////////////////////
+/// \brief Find the entry of a link in a vector sorted by link.
+/// \param[in] _entries Entries sorted by link.
+/// \param[in] _link Index of the link.
+/// \param[in] _linkOf Gets the link of an entry.
+/// \return Iterator to the first entry whose link is not less than _link.
+template <typename EntriesT, typename LinkOfT>
+static auto FindLink(EntriesT &_entries, int _link, LinkOfT _linkOf)
+{
+  return std::lower_bound(_entries.begin(), _entries.end(), _link,
+      [&_linkOf](const auto &_entry, int _value)
+      {
+        return _linkOf(_entry) < _value;
+      });
+}
+
+/////////////////////////////////////////////////
+ModelJointConstraint::ModelJointConstraint(btMultiBody *_body)
+  : btMultiBodyConstraint(_body, _body, -1, -1, 0, false,
+                          MULTIBODY_CONSTRAINT_1DOF_JOINT_MOTOR)
+{
+}
+
+/////////////////////////////////////////////////
+void ModelJointConstraint::SetMotor(
+    const int _link, const btScalar _velocity, const btScalar _maxImpulse)
+{
+  auto it = FindLink(this->motors, _link,
+      [](const Motor &_motor) { return _motor.link; });
+  if (it != this->motors.end() && it->link == _link)
+  {
+    it->velocity = _velocity;
+    it->maxImpulse = _maxImpulse;
+    return;
+  }
+
+  this->motors.insert(it, Motor{_link, _velocity, _maxImpulse});
+  this->Rebuild();
+}
+
+/////////////////////////////////////////////////
+bool ModelJointConstraint::HasMotor(const int _link) const
+{
+  const auto it = FindLink(this->motors, _link,
+      [](const Motor &_motor) { return _motor.link; });
+  return it != this->motors.end() && it->link == _link;
+}
+
+/////////////////////////////////////////////////
+void ModelJointConstraint::SetLimits(
+    const int _link, const btScalar _lower, const btScalar _upper)
+{
+  auto it = FindLink(this->limits, _link,
+      [](const Limits &_limits) { return _limits.link; });
+  if (it != this->limits.end() && it->link == _link)
+  {
+    it->lower = _lower;
+    it->upper = _upper;
+    return;
+  }
+
+  this->limits.insert(it, Limits{_link, _lower, _upper});
+  this->Rebuild();
+}
+
+/////////////////////////////////////////////////
+void ModelJointConstraint::SetGear(
+    const int _followerLink, const int _leaderLink, const btScalar _ratio,
+    const btScalar _offset, const btScalar _erp, const btScalar _maxImpulse)
+{
+  const Gear gear{
+      _followerLink, _leaderLink, _ratio, _offset, _erp, _maxImpulse};
+  auto it = FindLink(this->gears, _followerLink,
+      [](const Gear &_gear) { return _gear.followerLink; });
+  if (it != this->gears.end() && it->followerLink == _followerLink)
+  {
+    // Only the leader and ratio are part of the jacobian
+    const bool sameJacobian =
+        it->leaderLink == _leaderLink && it->ratio == _ratio;
+    *it = gear;
+    if (sameJacobian)
+      return;
+  }
+  else
+  {
+    this->gears.insert(it, gear);
+  }
+  this->Rebuild();
+}
+
+/////////////////////////////////////////////////
+std::size_t ModelJointConstraint::JointConstraintCount() const
+{
+  return this->motors.size() + this->limits.size() + this->gears.size();
+}
+
+/////////////////////////////////////////////////
+void ModelJointConstraint::finalizeMultiDof()
+{
+  this->Rebuild();
+}
+
+/////////////////////////////////////////////////
+int ModelJointConstraint::getIslandIdA() const
+{
+  // All the moving colliders of a multibody are in the same island, while a
+  // fixed base is static and in none.
+  const btMultiBodyLinkCollider *base = this->m_bodyA->getBaseCollider();
+  if (base && base->getIslandTag() >= 0)
+    return base->getIslandTag();
+
+  for (int i = 0; i < this->m_bodyA->getNumLinks(); ++i)
+  {
+    const btMultiBodyLinkCollider *collider =
+        this->m_bodyA->getLink(i).m_collider;
+    if (collider && collider->getIslandTag() >= 0)
+      return collider->getIslandTag();
+  }
+  return base ? base->getIslandTag() : -1;
+}
+
+/////////////////////////////////////////////////
+int ModelJointConstraint::getIslandIdB() const
+{
+  return this->getIslandIdA();
+}
+
+/////////////////////////////////////////////////
+void ModelJointConstraint::createConstraintRows(
+    btMultiBodyConstraintArray &_constraintRows,
+    btMultiBodyJacobianData &_data,
+    const btContactSolverInfo &_infoGlobal)
+{
+  if (this->m_numDofsFinalized != this->m_jacSizeBoth)
+    this->finalizeMultiDof();
+  if (this->m_numDofsFinalized != this->m_jacSizeBoth)
+    return;
+
+  const btVector3 dummy(0, 0, 0);
+  btMultiBody *body = this->m_bodyA;
+  int row = 0;
+
+  // Motors drive the joint velocity to its target, as
+  // btMultiBodyJointMotor with its default gains does.
+  for (const Motor &motor : this->motors)
+  {
+    const int motorRow = row++;
+    if (motor.maxImpulse == btScalar(0))
+      continue;
+
+    auto &constraintRow = _constraintRows.expandNonInitializing();
+    this->fillMultiBodyConstraint(constraintRow, _data,
+        this->jacobianA(motorRow), this->jacobianB(motorRow),
+        dummy, dummy, dummy, dummy, btScalar(0), _infoGlobal,
+        -motor.maxImpulse, motor.maxImpulse, false, btScalar(1), false,
+        motor.velocity);
+    constraintRow.m_orgConstraint = this;
+    constraintRow.m_orgDofIndex = motorRow;
+    constraintRow.m_linkA = motor.link;
+    constraintRow.m_linkB = motor.link;
+    this->SetRowAxis(motor.link, btScalar(1), constraintRow);
+  }
+
+  // Limits push the joint back inside them while it is outside, as
+  // btMultiBodyJointLimitConstraint does.
+  for (const Limits &limit : this->limits)
+  {
+    const btScalar position = body->getJointPosMultiDof(limit.link)[0];
+    for (int side = 0; side < 2; ++side)
+    {
+      const int limitRow = row++;
+      const btScalar penetration =
+          side == 0 ? position - limit.lower : limit.upper - position;
+      if (penetration > 0)
+        continue;
+
+      auto &constraintRow = _constraintRows.expandNonInitializing();
+      constraintRow.m_multiBodyA = body;
+      constraintRow.m_multiBodyB = body;
+      const btScalar relVel = this->fillMultiBodyConstraint(constraintRow,
+          _data, this->jacobianA(limitRow), this->jacobianB(limitRow),
+          dummy, dummy, dummy, dummy, btScalar(0), _infoGlobal,
+          btScalar(0), this->m_maxAppliedImpulse);
+      constraintRow.m_orgConstraint = this;
+      constraintRow.m_orgDofIndex = limitRow;
+      constraintRow.m_linkA = limit.link;
+      constraintRow.m_linkB = body->getLink(limit.link).m_parent;
+      this->SetRowAxis(
+          limit.link, side == 0 ? btScalar(1) : btScalar(-1), constraintRow);
+
+      btScalar erp = _infoGlobal.m_erp2;
+      if (!_infoGlobal.m_splitImpulse ||
+          penetration > _infoGlobal.m_splitImpulsePenetrationThreshold)
+      {
+        erp = _infoGlobal.m_erp;
+      }
+      const btScalar penetrationImpulse = -penetration * erp /
+          _infoGlobal.m_timeStep * constraintRow.m_jacDiagABInv;
+      const btScalar velocityImpulse = -relVel * constraintRow.m_jacDiagABInv;
+      if (!_infoGlobal.m_splitImpulse ||
+          penetration > _infoGlobal.m_splitImpulsePenetrationThreshold)
+      {
+        constraintRow.m_rhs = penetrationImpulse + velocityImpulse;
+        constraintRow.m_rhsPenetration = btScalar(0);
+      }
+      else
+      {
+        constraintRow.m_rhs = velocityImpulse;
+        constraintRow.m_rhsPenetration = penetrationImpulse;
+      }
+    }
+  }
+
+  // Gears keep follower + ratio * leader at their offset, as
+  // btMultiBodyGearConstraint does.
+  for (const Gear &gear : this->gears)
+  {
+    const int gearRow = row++;
+    if (gear.maxImpulse == btScalar(0))
+      continue;
+
+    btScalar posError = 0;
+    if (gear.erp != btScalar(0))
+    {
+      const btScalar diff =
+          gear.ratio * body->getJointPosMultiDof(gear.leaderLink)[0] +
+          body->getJointPosMultiDof(gear.followerLink)[0];
+      posError = -gear.erp * (gear.offset - diff);
+    }
+
+    auto &constraintRow = _constraintRows.expandNonInitializing();
+    this->fillMultiBodyConstraint(constraintRow, _data,
+        this->jacobianA(gearRow), this->jacobianB(gearRow),
+        dummy, dummy, dummy, dummy, posError, _infoGlobal,
+        -gear.maxImpulse, gear.maxImpulse, false, btScalar(1), false,
+        btScalar(0));
+    constraintRow.m_orgConstraint = this;
+    constraintRow.m_orgDofIndex = gearRow;
+    constraintRow.m_linkA = gear.followerLink;
+    constraintRow.m_linkB = gear.leaderLink;
+    this->SetRowAxis(gear.followerLink, btScalar(1), constraintRow);
+  }
+}
+
+/////////////////////////////////////////////////
+void ModelJointConstraint::debugDraw(btIDebugDraw * /*_drawer*/)
+{
+}
+
+/////////////////////////////////////////////////
+void ModelJointConstraint::Rebuild()
+{
+  // Each row has a jacobian over all the degrees of freedom of the
+  // multibody, for both of its sides, which are the same multibody here.
+  this->m_numRows = static_cast<int>(this->motors.size() +
+      2u * this->limits.size() + this->gears.size());
+  this->allocateJacobiansMultiDof();
+  for (int i = 0; i < this->m_data.size(); ++i)
+    this->m_data[i] = btScalar(0);
+
+  const auto offset = [this](int _link)
+  {
+    return 6 + this->m_bodyA->getLink(_link).m_dofOffset;
+  };
+
+  int row = 0;
+  for (const Motor &motor : this->motors)
+    this->jacobianA(row++)[offset(motor.link)] = btScalar(1);
+  for (const Limits &limit : this->limits)
+  {
+    this->jacobianA(row++)[offset(limit.link)] = btScalar(1);
+    this->jacobianB(row++)[offset(limit.link)] = btScalar(-1);
+  }
+  for (const Gear &gear : this->gears)
+  {
+    this->jacobianA(row)[offset(gear.followerLink)] = btScalar(1);
+    this->jacobianB(row++)[offset(gear.leaderLink)] = gear.ratio;
+  }
+
+  this->m_numDofsFinalized = this->m_jacSizeBoth;
+}
+
+/////////////////////////////////////////////////
+void ModelJointConstraint::SetRowAxis(const int _link,
+    const btScalar _direction, btMultiBodySolverConstraint &_row) const
+{
+  const btMultibodyLink &link = this->m_bodyA->getLink(_link);
+  const btQuaternion rotation = link.m_cachedWorldTransform.getRotation();
+  if (link.m_jointType == btMultibodyLink::eRevolute)
+  {
+    const btVector3 axis =
+        _direction * quatRotate(rotation, link.getAxisTop(0));
+    _row.m_contactNormal1.setZero();
+    _row.m_contactNormal2.setZero();
+    _row.m_relpos1CrossNormal = axis;
+    _row.m_relpos2CrossNormal = -axis;
+  }
+  else if (link.m_jointType == btMultibodyLink::ePrismatic)
+  {
+    const btVector3 axis =
+        _direction * quatRotate(rotation, link.getAxisBottom(0));
+    _row.m_contactNormal1 = axis;
+    _row.m_contactNormal2 = -axis;
+    _row.m_relpos1CrossNormal.setZero();
+    _row.m_relpos2CrossNormal.setZero();
+  }
+  else
+  {
+    _row.m_contactNormal1.setZero();
+    _row.m_contactNormal2.setZero();
+    _row.m_relpos1CrossNormal.setZero();
+    _row.m_relpos2CrossNormal.setZero();
+  }
+}
+
+}  // namespace bullet_featherstone
+}  // namespace physics
+}  // namespace gz
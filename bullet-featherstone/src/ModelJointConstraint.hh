@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_MODELJOINTCONSTRAINT_HH_
+#define GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_MODELJOINTCONSTRAINT_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include <BulletDynamics/Featherstone/btMultiBody.h>
+#include <BulletDynamics/Featherstone/btMultiBodyConstraint.h>
+
+namespace gz {
+namespace physics {
+namespace bullet_featherstone {
+
+/// \brief The joint motors, joint limits and mimic gears of a multibody as
+/// one multibody constraint, instead of a btMultiBodyJointMotor,
+/// btMultiBodyJointLimitConstraint or btMultiBodyGearConstraint per joint.
+/// The world then keeps one constraint per model, which sets up all of its
+/// rows in one pass over a single jacobian array.
+///
+/// The rows are those of the bullet constraints they replace: a motor row
+/// that drives the joint velocity to its target, a lower and an upper limit
+/// row that are only added while the limit is violated, and a gear row
+/// that keeps follower_position + ratio * leader_position at an offset.
+/// Only single degree of freedom joints, revolute and prismatic, are
+/// supported.
+class ModelJointConstraint : public btMultiBodyConstraint
+{
+  /// \brief Constructor
+  /// \param[in] _body Multibody whose joints are constrained.
+  public: explicit ModelJointConstraint(btMultiBody *_body);
+
+  /// \brief Set the velocity target of the motor of a joint, adding the
+  /// motor if the joint has none.
+  /// \param[in] _link Index of the child link of the joint.
+  /// \param[in] _velocity Velocity target.
+  /// \param[in] _maxImpulse Largest impulse of the motor in a step.
+  public: void SetMotor(int _link, btScalar _velocity, btScalar _maxImpulse);
+
+  /// \brief Check whether a joint has a motor.
+  /// \param[in] _link Index of the child link of the joint.
+  /// \return True if the joint has a motor.
+  public: bool HasMotor(int _link) const;
+
+  /// \brief Set the position limits of a joint, adding them if the joint
+  /// has none.
+  /// \param[in] _link Index of the child link of the joint.
+  /// \param[in] _lower Lower limit.
+  /// \param[in] _upper Upper limit.
+  public: void SetLimits(int _link, btScalar _lower, btScalar _upper);
+
+  /// \brief Set the gear that makes a joint follow another one, replacing
+  /// the gear of the follower if it has one.
+  /// \param[in] _followerLink Index of the child link of the follower joint.
+  /// \param[in] _leaderLink Index of the child link of the leader joint.
+  /// \param[in] _ratio Gear ratio, see btMultiBodyGearConstraint.
+  /// \param[in] _offset Relative position target.
+  /// \param[in] _erp Error reduction parameter of the position error.
+  /// \param[in] _maxImpulse Largest impulse of the gear in a step.
+  public: void SetGear(int _followerLink, int _leaderLink, btScalar _ratio,
+                       btScalar _offset, btScalar _erp, btScalar _maxImpulse);
+
+  /// \brief Number of motors, limits and gears.
+  /// \return Number of joint constraints held by this constraint.
+  public: std::size_t JointConstraintCount() const;
+
+  // Documentation inherited
+  public: void finalizeMultiDof() override;
+
+  // Documentation inherited
+  public: int getIslandIdA() const override;
+
+  // Documentation inherited
+  public: int getIslandIdB() const override;
+
+  // Documentation inherited
+  public: void createConstraintRows(
+      btMultiBodyConstraintArray &_constraintRows,
+      btMultiBodyJacobianData &_data,
+      const btContactSolverInfo &_infoGlobal) override;
+
+  // Documentation inherited
+  public: void debugDraw(btIDebugDraw *_drawer) override;
+
+  /// \brief Lay the rows out again and fill in their jacobians, after a
+  /// motor, limit or gear was added.
+  private: void Rebuild();
+
+  /// \brief Give a solver row the axis of a joint, like the bullet joint
+  /// constraints do, so the constraint force is reported on the joint.
+  /// \param[in] _link Index of the child link of the joint.
+  /// \param[in] _direction Sign of the axis.
+  /// \param[out] _row Solver row.
+  private: void SetRowAxis(int _link, btScalar _direction,
+                           btMultiBodySolverConstraint &_row) const;
+
+  /// \brief Motor of a joint.
+  private: struct Motor
+  {
+    int link;
+    btScalar velocity;
+    btScalar maxImpulse;
+  };
+
+  /// \brief Position limits of a joint.
+  private: struct Limits
+  {
+    int link;
+    btScalar lower;
+    btScalar upper;
+  };
+
+  /// \brief Gear between two joints.
+  private: struct Gear
+  {
+    int followerLink;
+    int leaderLink;
+    btScalar ratio;
+    btScalar offset;
+    btScalar erp;
+    btScalar maxImpulse;
+  };
+
+  /// \brief Motors, sorted by link. Motor i has row i.
+  private: std::vector<Motor> motors;
+
+  /// \brief Limits, sorted by link. The limits i have the rows
+  /// motors.size() + 2 * i for the lower limit and the one after it for the
+  /// upper limit.
+  private: std::vector<Limits> limits;
+
+  /// \brief Gears, sorted by follower link. They have the last rows.
+  private: std::vector<Gear> gears;
+};
+
+}  // namespace bullet_featherstone
+}  // namespace physics
+}  // namespace gz
+
+#endif
@@ -16,12 +16,17 @@
 */
 
 #include "SDFFeatures.hh"
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
 #include <gz/common/Mesh.hh>
 #include <gz/common/MeshManager.hh>
 #include <gz/common/SubMesh.hh>
+#include <gz/common/WorkerPool.hh>
 #include <gz/math/eigen3/Conversions.hh>
 #include <gz/math/Helpers.hh>
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
+#include <gz/physics/mesh/MeshSimplification.hh>
+#include <gz/physics/mesh/PrimitiveFitting.hh>
 
 #include <sdf/Box.hh>
 #include <sdf/Capsule.hh>
@@ -32,17 +37,27 @@
 #include <sdf/JointAxis.hh>
 #include <sdf/Link.hh>
 #include <sdf/Mesh.hh>
+#include <sdf/Model.hh>
 #include <sdf/Plane.hh>
 #include <sdf/Sphere.hh>
 #include <sdf/Surface.hh>
+#include <sdf/World.hh>
 
 #include <BulletDynamics/Featherstone/btMultiBodyLinkCollider.h>
-#include <BulletDynamics/Featherstone/btMultiBodyJointLimitConstraint.h>
 
 #include <LinearMath/btQuaternion.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -77,17 +92,155 @@ static std::optional<Eigen::Isometry3d> ResolveSdfPose(
   return math::eigen3::convert(pose);
 }
 
+/////////////////////////////////////////////////
+/// \brief Number of convex hulls a mesh collision is decomposed into
+/// \param[in] _meshSdf Mesh of the collision
+/// \return The maximum number of convex hulls, or 0 if the mesh is not
+/// decomposed
+static std::size_t MaxConvexHulls(const ::sdf::Mesh &_meshSdf)
+{
+  if (_meshSdf.Optimization() == ::sdf::MeshOptimization::CONVEX_HULL)
+  {
+    /// create 1 convex hull for the whole submesh
+    return 1u;
+  }
+
+  if (_meshSdf.Optimization() ==
+      ::sdf::MeshOptimization::CONVEX_DECOMPOSITION)
+  {
+    // limit max number of convex hulls to generate
+    if (_meshSdf.ConvexDecomposition())
+      return _meshSdf.ConvexDecomposition()->MaxConvexHulls();
+    return 16u;
+  }
+
+  return 0u;
+}
+
+/////////////////////////////////////////////////
+/// \brief Collect the mesh collisions of a model and its nested models that
+/// need a convex decomposition
+static void CollectConvexMeshes(
+    const ::sdf::Model &_sdfModel,
+    std::vector<const ::sdf::Mesh *> &_meshes)
+{
+  for (std::size_t l = 0; l < _sdfModel.LinkCount(); ++l)
+  {
+    const auto *link = _sdfModel.LinkByIndex(l);
+    for (std::size_t c = 0; c < link->CollisionCount(); ++c)
+    {
+      const auto *geom = link->CollisionByIndex(c)->Geom();
+      if (geom && geom->MeshShape() && MaxConvexHulls(*geom->MeshShape()) > 0u)
+        _meshes.push_back(geom->MeshShape());
+    }
+  }
+
+  for (std::size_t m = 0; m < _sdfModel.ModelCount(); ++m)
+    CollectConvexMeshes(*_sdfModel.ModelByIndex(m), _meshes);
+}
+
+/////////////////////////////////////////////////
+/// \brief Run the convex decompositions needed by the mesh collisions of a
+/// world concurrently, and add them to the MeshManager, where AddSdfCollision
+/// finds them. Meshes are still loaded serially, since the MeshManager is not
+/// safe to use from multiple threads.
+/// \param[in] _sdfWorld World to prepare the decompositions of
+/// \param[in] _loadTimer Timer charged with the mesh loading and the
+/// decompositions
+static void PrepareConvexDecompositions(const ::sdf::World &_sdfWorld,
+    sdf::LoadTimer &_loadTimer)
+{
+  std::vector<const ::sdf::Mesh *> meshSdfs;
+  for (std::size_t i = 0; i < _sdfWorld.ModelCount(); ++i)
+  {
+    if (const ::sdf::Model *model = _sdfWorld.ModelByIndex(i))
+      CollectConvexMeshes(*model, meshSdfs);
+  }
+
+  struct Job
+  {
+    const common::Mesh *mesh;
+    std::size_t maxConvexHulls;
+    std::string optimizationStr;
+    std::unique_ptr<common::Mesh> decomposed;
+  };
+
+  auto &meshManager = *gz::common::MeshManager::Instance();
+  std::vector<Job> jobs;
+  std::unordered_set<std::string> queued;
+  for (const auto *meshSdf : meshSdfs)
+  {
+    // Failures are reported when the collision itself is constructed
+    const auto *mesh = _loadTimer.Measure(
+        sdf::LoadTimer::Phase::MESH_LOADING,
+        [&]{ return meshManager.Load(meshSdf->Uri()); });
+    if (nullptr == mesh)
+      continue;
+
+    const std::size_t maxConvexHulls = MaxConvexHulls(*meshSdf);
+    const std::string convexMeshName =
+        physics::mesh::ConvexMeshName(mesh->Name(), maxConvexHulls);
+    if (meshManager.HasMesh(convexMeshName) ||
+        !queued.insert(convexMeshName).second)
+    {
+      continue;
+    }
+
+    jobs.push_back(
+        Job{mesh, maxConvexHulls, meshSdf->OptimizationStr(), nullptr});
+  }
+
+  // A single decomposition is left to AddSdfCollision
+  if (jobs.size() < 2u)
+    return;
+
+  const auto numThreads = std::min<std::size_t>(
+      jobs.size(), std::max(1u, std::thread::hardware_concurrency()));
+  {
+    sdf::LoadTimer::PhaseScope scope(
+        _loadTimer, sdf::LoadTimer::Phase::CONVEX_DECOMPOSITION);
+    gz::common::WorkerPool pool(static_cast<unsigned int>(numThreads));
+    for (auto &job : jobs)
+    {
+      Job *j = &job;
+      pool.AddWork([j]()
+      {
+        j->decomposed = physics::mesh::ConvexDecomposeMesh(
+            *j->mesh, j->maxConvexHulls, j->optimizationStr);
+      });
+    }
+    pool.WaitForResults();
+  }
+
+  // Note: MeshManager will call delete on these meshes in its destructor
+  // \todo(iche033) Consider updating MeshManager to accept
+  // unique pointers instead
+  for (auto &job : jobs)
+  {
+    if (job.decomposed)
+      meshManager.AddMesh(job.decomposed.release());
+  }
+}
+
 /////////////////////////////////////////////////
 Identity SDFFeatures::ConstructSdfWorld(
     const Identity &_engine,
     const ::sdf::World &_sdfWorld)
 {
   const Identity worldID = this->ConstructEmptyWorld(_engine, _sdfWorld.Name());
+  auto &loadReport = this->loadReports[worldID];
+  loadReport = {};
+  sdf::LoadTimer::WorldScope worldScope(this->loadTimer, loadReport);
 
   const WorldInfoPtr &worldInfo = this->worlds.at(worldID);
 
   worldInfo->world->setGravity(convertVec(_sdfWorld.Gravity()));
 
+  // The mesh decompositions are independent of the engine and dominate the
+  // load time of worlds with many meshes, so do them all up front on a
+  // thread pool. The models are then constructed serially.
+  PrepareConvexDecompositions(_sdfWorld, this->loadTimer);
+
   for (std::size_t i = 0; i < _sdfWorld.ModelCount(); ++i)
   {
     const ::sdf::Model *model = _sdfWorld.ModelByIndex(i);
@@ -465,7 +618,12 @@ Identity SDFFeatures::ConstructSdfModelImpl(
                                   this->models.at(nestedModelID));
   }
 
-  auto structures = validateModel(_sdfModel);
+  sdf::LoadTimer::ModelScope modelScope(
+      this->loadTimer, this->loadReports[_parentID], _sdfModel.Name());
+
+  auto structures = this->loadTimer.Measure(
+      sdf::LoadTimer::Phase::SDF_RESOLUTION,
+      [&]{ return validateModel(_sdfModel); });
   if (structures.empty())
     return this->GenerateInvalidId();
 
@@ -633,8 +791,12 @@ Identity SDFFeatures::ConstructSdfModelImpl(
       Eigen::Isometry3d poseParentComToJoint;
       {
         gz::math::Pose3d gzPoseParentToJoint;
-        errors = resolveJointPoseRelToLink(gzPoseParentToJoint,
-            parentInfo.model, joint->Name(), parentLinkName);
+        errors = this->loadTimer.Measure(
+            sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+            {
+              return resolveJointPoseRelToLink(gzPoseParentToJoint,
+                  parentInfo.model, joint->Name(), parentLinkName);
+            });
 
         if (!errors.empty())
         {
@@ -665,8 +827,12 @@ Identity SDFFeatures::ConstructSdfModelImpl(
         {
           childLinkName = joint->ChildName();
         }
-        errors = resolveJointPoseRelToLink(gzPoseChildToJoint,
-            parentInfo.model, joint->Name(), childLinkName);
+        errors = this->loadTimer.Measure(
+            sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+            {
+              return resolveJointPoseRelToLink(gzPoseChildToJoint,
+                  parentInfo.model, joint->Name(), childLinkName);
+            });
 
         if (!errors.empty())
         {
@@ -783,11 +949,9 @@ Identity SDFFeatures::ConstructSdfModelImpl(
             static_cast<btScalar>(joint->Axis()->Effort());
         jointInfo->effort = static_cast<btScalar>(joint->Axis()->Effort());
 
-        jointInfo->jointLimits =
-          std::make_shared<btMultiBodyJointLimitConstraint>(
-            model->body.get(), i, static_cast<btScalar>(joint->Axis()->Lower()),
+        JointConstraintsOf(*world, model->body.get()).SetLimits(
+            i, static_cast<btScalar>(joint->Axis()->Lower()),
             static_cast<btScalar>(joint->Axis()->Upper()));
-        world->world->addMultiBodyConstraint(jointInfo->jointLimits.get());
       }
 
       jointInfo->jointFeedback = std::make_shared<btMultiBodyJointFeedback>();
@@ -799,7 +963,9 @@ Identity SDFFeatures::ConstructSdfModelImpl(
   model->body->setHasSelfCollision(_sdfModel.SelfCollide());
   model->body->finalizeMultiDof();
 
-  const auto worldToModel = ResolveSdfPose(_sdfModel.SemanticPose());
+  const auto worldToModel = this->loadTimer.Measure(
+      sdf::LoadTimer::Phase::SDF_RESOLUTION,
+      [&]{ return ResolveSdfPose(_sdfModel.SemanticPose()); });
   if (!worldToModel)
     return this->GenerateInvalidId();
 
@@ -845,8 +1011,9 @@ Identity SDFFeatures::ConstructSdfModelImpl(
     modelToNestedModel = math::eigen3::convert(modelPose).inverse();
   }
 
-  const auto modelToRootLink =
-    ResolveSdfPose(structure.rootLink->SemanticPose());
+  const auto modelToRootLink = this->loadTimer.Measure(
+      sdf::LoadTimer::Phase::SDF_RESOLUTION,
+      [&]{ return ResolveSdfPose(structure.rootLink->SemanticPose()); });
   if (!modelToRootLink)
     return this->GenerateInvalidId();
 
@@ -881,6 +1048,18 @@ Identity SDFFeatures::ConstructSdfModelImpl(
     }
   }
 
+  // Sampled after all the collisions of the model were added, which drops
+  // the ignored pairs of the model
+  if (this->selfCollisionSampleCount > 0u)
+  {
+    auto pairs = SampleNeverCollidingLinkPairs(
+        *world->world, *model->body, this->selfCollisionSampleCount);
+    auto *dispatcher =
+        dynamic_cast<GzCollisionDispatcher *>(world->dispatcher.get());
+    if (dispatcher && !pairs.empty())
+      dispatcher->SetIgnoredLinkPairs(model->body.get(), std::move(pairs));
+  }
+
   // Add the remaining links in the model without constructing the bullet
   // objects. These are dummy links for book-keeping purposes
   // \todo(iche033) The code will need to be updated when multiple subtrees in
@@ -925,6 +1104,32 @@ Identity SDFFeatures::ConstructSdfModelImpl(
   return modelID;
 }
 
+/////////////////////////////////////////////////
+/// \brief Key of the shapes built for a mesh in Base::meshShapeCache
+/// \param[in] _contentHash Content hash of the mesh, see
+/// mesh::MeshContentHash
+/// \param[in] _scale Scale applied to the mesh vertices
+/// \param[in] _maxConvexHulls Number of convex hulls the mesh is decomposed
+/// into, or 0 if it is not decomposed
+/// \param[in] _useBvh True if the triangles use a static BVH
+/// \param[in] _maxTriangles Triangle budget the mesh is simplified to, or 0
+/// if it is not simplified
+/// \return The cache key
+static std::string MeshShapeCacheKey(
+    std::uint64_t _contentHash,
+    const btVector3 &_scale,
+    std::size_t _maxConvexHulls,
+    bool _useBvh,
+    std::size_t _maxTriangles)
+{
+  std::ostringstream key;
+  key << std::setprecision(std::numeric_limits<btScalar>::max_digits10)
+      << std::hex << _contentHash << std::dec << "|" << _scale.x() << " "
+      << _scale.y() << " " << _scale.z() << "|" << _maxConvexHulls << "|"
+      << _useBvh << "|" << _maxTriangles;
+  return key.str();
+}
+
 /////////////////////////////////////////////////
 Identity SDFFeatures::ConstructSdfModel(
     const Identity &_worldID,
@@ -933,6 +1138,119 @@ Identity SDFFeatures::ConstructSdfModel(
   return this->ConstructSdfModelImpl(_worldID, _sdfModel);
 }
 
+/////////////////////////////////////////////////
+std::vector<Identity> SDFFeatures::ConstructSdfModels(
+    const Identity &_worldID,
+    const std::vector<const ::sdf::Model *> &_sdfModels)
+{
+  std::vector<Identity> result;
+  result.reserve(_sdfModels.size());
+  for (const ::sdf::Model *sdfModel : _sdfModels)
+  {
+    if (sdfModel)
+      result.push_back(this->ConstructSdfModelImpl(_worldID, *sdfModel));
+    else
+      result.push_back(this->GenerateInvalidId());
+  }
+
+  // Each collision object was inserted into the dbvt on its own, which
+  // leaves the tree unbalanced after adding many objects. Rebuild it once
+  // for the whole batch.
+  auto worldIt = this->worlds.find(_worldID);
+  if (worldIt != this->worlds.end())
+  {
+    auto *dbvt = dynamic_cast<btDbvtBroadphase *>(
+        worldIt->second->broadphase.get());
+    if (dbvt)
+      dbvt->optimize();
+  }
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<btCollisionShape> SDFFeatures::ConstructFittedPrimitive(
+    const ::sdf::Mesh &_meshSdf)
+{
+  // Decomposed meshes keep the shape they were asked for
+  if (this->collisionMeshPrimitiveTolerance <= 0.0 ||
+      MaxConvexHulls(_meshSdf) > 0u)
+  {
+    return nullptr;
+  }
+
+  auto &meshManager = *gz::common::MeshManager::Instance();
+  const auto *mesh = this->loadTimer.Measure(
+      sdf::LoadTimer::Phase::MESH_LOADING,
+      [&]{ return meshManager.Load(_meshSdf.Uri()); });
+  if (nullptr == mesh)
+    return nullptr;
+
+  using Type = physics::mesh::FittedPrimitive::Type;
+  const physics::mesh::FittedPrimitive fit = physics::mesh::ScaledPrimitive(
+      this->primitiveFits.Fit(*mesh, this->meshContentHashes.Hash(*mesh),
+          this->collisionMeshPrimitiveTolerance),
+      _meshSdf.Scale());
+  const auto radius = static_cast<btScalar>(fit.radius);
+  const auto length = static_cast<btScalar>(fit.length);
+
+  std::string key;
+  std::shared_ptr<btCollisionShape> primitive;
+  switch (fit.type)
+  {
+    case Type::kBox:
+    {
+      const btVector3 halfExtents = convertVec(fit.size) * btScalar(0.5);
+      key = ShapeKey(
+          "box", halfExtents.x(), halfExtents.y(), halfExtents.z());
+      primitive = this->InternShape(key,
+          [&]{ return std::make_unique<btBoxShape>(halfExtents); });
+      break;
+    }
+    case Type::kSphere:
+      key = ShapeKey("sphere", radius);
+      primitive = this->InternShape(key,
+          [&]{ return std::make_unique<btSphereShape>(radius); });
+      break;
+    case Type::kCylinder:
+    {
+      const btScalar halfLength = length * btScalar(0.5);
+      key = ShapeKey("cylinder", radius, halfLength);
+      primitive = this->InternShape(key, [&]
+          {
+            return std::make_unique<btCylinderShapeZ>(
+                btVector3(radius, radius, halfLength));
+          });
+      break;
+    }
+    case Type::kCapsule:
+      key = ShapeKey("capsule", radius, length);
+      primitive = this->InternShape(key,
+          [&]{ return std::make_unique<btCapsuleShapeZ>(radius, length); });
+      break;
+    default:
+      return nullptr;
+  }
+
+  if (fit.pose == math::Pose3d::Zero)
+    return primitive;
+
+  // The primitive is offset from the mesh frame, so it is the only child of
+  // a compound, which keeps it alive.
+  const btTransform childPose = convertTf(math::eigen3::convert(fit.pose));
+  const btVector3 &p = childPose.getOrigin();
+  const btQuaternion q = childPose.getRotation();
+  return this->InternShape(
+      ShapeKey("fitted|" + key, p.x(), p.y(), p.z(),
+               q.w(), q.x(), q.y(), q.z()), [&]
+      {
+        auto compoundShape = std::make_unique<btCompoundShape>();
+        compoundShape->addChildShape(childPose, primitive.get());
+        return std::shared_ptr<btCollisionShape>(compoundShape.release(),
+            [primitive](btCollisionShape *_shape) { delete _shape; });
+      });
+}
+
 /////////////////////////////////////////////////
 bool SDFFeatures::AddSdfCollision(
     const Identity &_linkID,
@@ -949,93 +1267,129 @@ bool SDFFeatures::AddSdfCollision(
   auto *linkInfo = this->ReferenceInterface<LinkInfo>(_linkID);
   const auto *model = this->ReferenceInterface<ModelInfo>(linkInfo->model);
 
+  // Set static filter for collisions in
+  // 1) a static model
+  // 2) a fixed base link
+  // 3) a (non-base) link with zero dofs
+  const bool isFixed = this->IsLinkFixed(_linkID);
+
+  // Time spent loading and decomposing meshes is charged to those steps.
+  std::optional<sdf::LoadTimer::PhaseScope> shapeScope;
+  shapeScope.emplace(this->loadTimer, sdf::LoadTimer::Phase::SHAPE_CREATION);
+
   const auto &geom = _collision.Geom();
-  std::unique_ptr<btCollisionShape> shape;
+  // Collisions with the same geometry share their shape, see InternShape
+  std::shared_ptr<btCollisionShape> shape;
 
   if (const auto *box = geom->BoxShape())
   {
     const auto size = math::eigen3::convert(box->Size());
     const auto halfExtents = convertVec(size)*0.5;
-    shape = std::make_unique<btBoxShape>(halfExtents);
+    shape = this->InternShape(
+        ShapeKey("box", halfExtents.x(), halfExtents.y(), halfExtents.z()),
+        [&]{ return std::make_unique<btBoxShape>(halfExtents); });
   }
   else if (const auto *sphere = geom->SphereShape())
   {
-    const auto radius = sphere->Radius();
-    shape = std::make_unique<btSphereShape>(static_cast<btScalar>(radius));
+    const auto radius = static_cast<btScalar>(sphere->Radius());
+    shape = this->InternShape(ShapeKey("sphere", radius),
+        [&]{ return std::make_unique<btSphereShape>(radius); });
   }
   else if (const auto *cylinder = geom->CylinderShape())
   {
     const auto radius = static_cast<btScalar>(cylinder->Radius());
     const auto halfLength = static_cast<btScalar>(cylinder->Length()*0.5);
-    shape =
-      std::make_unique<btCylinderShapeZ>(btVector3(radius, radius, halfLength));
+    shape = this->InternShape(ShapeKey("cylinder", radius, halfLength), [&]
+        {
+          return std::make_unique<btCylinderShapeZ>(
+              btVector3(radius, radius, halfLength));
+        });
   }
   else if (const auto *plane = geom->PlaneShape())
   {
     const auto normal = convertVec(math::eigen3::convert(plane->Normal()));
-    shape = std::make_unique<btStaticPlaneShape>(normal, btScalar(0));
+    shape = this->InternShape(
+        ShapeKey("plane", normal.x(), normal.y(), normal.z()),
+        [&]
+        {
+          return std::make_unique<btStaticPlaneShape>(normal, btScalar(0));
+        });
   }
   else if (const auto *capsule = geom->CapsuleShape())
   {
-    shape = std::make_unique<btCapsuleShapeZ>(
-        static_cast<btScalar>(capsule->Radius()),
-        static_cast<btScalar>(capsule->Length()));
+    const auto radius = static_cast<btScalar>(capsule->Radius());
+    const auto length = static_cast<btScalar>(capsule->Length());
+    shape = this->InternShape(ShapeKey("capsule", radius, length),
+        [&]{ return std::make_unique<btCapsuleShapeZ>(radius, length); });
   }
   else if (const auto *ellipsoid = geom->EllipsoidShape())
   {
-    // This code is from bullet3 examples/SoftDemo/SoftDemo.cpp
-    struct Hammersley
+    const btVector3 radius = convertVec(ellipsoid->Radii());
+    shape = this->InternShape(
+        ShapeKey("ellipsoid", radius.x(), radius.y(), radius.z()), [&]
     {
-      static void Generate(btVector3* x, int n)
+      // This code is from bullet3 examples/SoftDemo/SoftDemo.cpp
+      struct Hammersley
       {
-        for (int i = 0; i < n; i++)
+        static void Generate(btVector3* x, int n)
         {
-          btScalar p = 0.5, t = 0;
-          for (int j = i; j; p *= btScalar(0.5), j >>= 1)
-            if (j & 1) t += p;
-          btScalar w = 2 * t - 1;
-          btScalar a =
-              (SIMD_PI + btScalar(2.0) * static_cast<btScalar>(i) * SIMD_PI) /
-              static_cast<btScalar>(n);
-          btScalar s = btSqrt(1 - w * w);
-          *x++ = btVector3(s * btCos(a), s * btSin(a), w);
+          for (int i = 0; i < n; i++)
+          {
+            btScalar p = 0.5, t = 0;
+            for (int j = i; j; p *= btScalar(0.5), j >>= 1)
+              if (j & 1) t += p;
+            btScalar w = 2 * t - 1;
+            btScalar a =
+                (SIMD_PI + btScalar(2.0) * static_cast<btScalar>(i) * SIMD_PI) /
+                static_cast<btScalar>(n);
+            btScalar s = btSqrt(1 - w * w);
+            *x++ = btVector3(s * btCos(a), s * btSin(a), w);
+          }
         }
+      };
+      btAlignedObjectArray<btVector3> vtx;
+      vtx.resize(3 + 128);
+      Hammersley::Generate(&vtx[0], vtx.size());
+      btVector3 center(0, 0, 0);
+      for (int i = 0; i < vtx.size(); ++i)
+      {
+        vtx[i] = vtx[i] * radius + center;
       }
-    };
-    btAlignedObjectArray<btVector3> vtx;
-    vtx.resize(3 + 128);
-    Hammersley::Generate(&vtx[0], vtx.size());
-    btVector3 center(0, 0, 0);
-    btVector3 radius = convertVec(ellipsoid->Radii());
-    for (int i = 0; i < vtx.size(); ++i)
-    {
-      vtx[i] = vtx[i] * radius + center;
-    }
 
-    this->triangleMeshes.push_back(std::make_unique<btTriangleMesh>());
+      this->triangleMeshes.push_back(std::make_unique<btTriangleMesh>());
 
-    for (int i = 0; i < vtx.size()/3; i++)
-    {
-      const btVector3& v0 = vtx[i * 3 + 0];
-      const btVector3& v1 = vtx[i * 3 + 1];
-      const btVector3& v2 = vtx[i * 3 + 2];
-      this->triangleMeshes.back()->addTriangle(v0, v1, v2);
-    }
-    auto compoundShape = std::make_unique<btCompoundShape>();
-
-    this->meshesGImpact.push_back(
-      std::make_unique<btGImpactMeshShape>(
-        this->triangleMeshes.back().get()));
-    this->meshesGImpact.back()->updateBound();
-    this->meshesGImpact.back()->setMargin(btScalar(0.001));
-    compoundShape->addChildShape(btTransform::getIdentity(),
-      this->meshesGImpact.back().get());
-    shape = std::move(compoundShape);
+      for (int i = 0; i < vtx.size()/3; i++)
+      {
+        const btVector3& v0 = vtx[i * 3 + 0];
+        const btVector3& v1 = vtx[i * 3 + 1];
+        const btVector3& v2 = vtx[i * 3 + 2];
+        this->triangleMeshes.back()->addTriangle(v0, v1, v2);
+      }
+      auto compoundShape = std::make_unique<btCompoundShape>();
+
+      this->meshesGImpact.push_back(
+        std::make_unique<btGImpactMeshShape>(
+          this->triangleMeshes.back().get()));
+      this->meshesGImpact.back()->updateBound();
+      this->meshesGImpact.back()->setMargin(btScalar(0.001));
+      compoundShape->addChildShape(btTransform::getIdentity(),
+        this->meshesGImpact.back().get());
+      return compoundShape;
+    });
+  }
+  else if (auto primitive = geom->MeshShape() ?
+               this->ConstructFittedPrimitive(*geom->MeshShape()) : nullptr)
+  {
+    // Meshes that are primitives in all but name collide as those
+    // primitives, see FitCollisionMeshPrimitivesFeature.
+    shape = std::move(primitive);
   }
   else if (const auto *meshSdf = geom->MeshShape())
   {
     auto &meshManager = *gz::common::MeshManager::Instance();
-    auto *mesh = meshManager.Load(meshSdf->Uri());
+    auto *mesh = this->loadTimer.Measure(
+        sdf::LoadTimer::Phase::MESH_LOADING,
+        [&]{ return meshManager.Load(meshSdf->Uri()); });
     if (nullptr == mesh)
     {
       gzwarn << "Failed to load mesh from [" << meshSdf->Uri()
@@ -1044,134 +1398,122 @@ bool SDFFeatures::AddSdfCollision(
     }
     const btVector3 scale = convertVec(meshSdf->Scale());
 
-    auto compoundShape = std::make_unique<btCompoundShape>();
-
-    bool meshCreated = false;
-    if (meshSdf->Optimization() ==
-        ::sdf::MeshOptimization::CONVEX_DECOMPOSITION ||
-        meshSdf->Optimization() ==
-        ::sdf::MeshOptimization::CONVEX_HULL)
+    const std::size_t maxConvexHulls = MaxConvexHulls(*meshSdf);
+    const bool convexOptimization = maxConvexHulls > 0u;
+
+    // Links that never move can collide against a static BVH of the
+    // triangles, which is much cheaper to build and query than GImpact.
+    const bool useBvh = isStatic || isFixed;
+
+    // The child shapes only depend on the mesh, its scale and its
+    // optimization, so collisions that use the same mesh share them instead
+    // of each holding a copy of the triangles and their bounding volumes.
+    // Meshes are keyed by their content, so copies of the same file loaded
+    // under different names are shared too.
+    // Decomposed meshes are not simplified, since the decomposition already
+    // bounds their number of triangles.
+    const std::uint64_t contentHash = this->meshContentHashes.Hash(*mesh);
+    const std::size_t maxTriangles =
+        convexOptimization ? 0u : this->collisionMeshTriangleBudget;
+    const std::string cacheKey = MeshShapeCacheKey(
+        contentHash, scale, maxConvexHulls, useBvh, maxTriangles);
+    auto cached = this->meshShapeCache.find(cacheKey);
+    if (cached == this->meshShapeCache.end())
     {
-      std::size_t maxConvexHulls = 16u;
-      if (meshSdf->Optimization() == ::sdf::MeshOptimization::CONVEX_HULL)
-      {
-        /// create 1 convex hull for the whole submesh
-        maxConvexHulls = 1u;
-      }
-      else if (meshSdf->ConvexDecomposition())
-      {
-        // limit max number of convex hulls to generate
-        maxConvexHulls = meshSdf->ConvexDecomposition()->MaxConvexHulls();
-      }
+      MeshShapes meshShapes;
 
-      // Check if MeshManager contains the decomposed mesh already. If not
-      // add it to the MeshManager so we do not need to decompose it again.
-      const std::string convexMeshName =
-          mesh->Name() + "_CONVEX_" + std::to_string(maxConvexHulls);
-      auto *decomposedMesh = meshManager.MeshByName(convexMeshName);
-      if (!decomposedMesh)
+      bool meshCreated = false;
+      if (convexOptimization)
       {
-        // Merge meshes before convex decomposition
-        auto mergedMesh = gz::common::MeshManager::MergeSubMeshes(*mesh);
-        if (mergedMesh && mergedMesh->SubMeshCount() == 1u)
+        // The decomposition is added to the MeshManager, so that it is not
+        // decomposed again.
+        const auto *decomposedMesh = this->loadTimer.Measure(
+            sdf::LoadTimer::Phase::CONVEX_DECOMPOSITION, [&]
+            {
+              return physics::mesh::CachedConvexMesh(
+                  *mesh, maxConvexHulls, meshSdf->OptimizationStr());
+            });
+
+        if (decomposedMesh)
         {
-          // Decompose and add mesh to MeshManager
-          auto mergedSubmesh = mergedMesh->SubMeshByIndex(0u).lock();
-          std::vector<common::SubMesh> decomposed =
-            gz::common::MeshManager::ConvexDecomposition(
-            *mergedSubmesh.get(), maxConvexHulls);
-          gzdbg << "Optimizing mesh (" << meshSdf->OptimizationStr() << "): "
-                <<  mesh->Name() << std::endl;
-          // Create decomposed mesh and add it to MeshManager
-          // Note: MeshManager will call delete on this mesh in its destructor
-          // \todo(iche033) Consider updating MeshManager to accept
-          // unique pointers instead
-          common::Mesh *convexMesh = new common::Mesh;
-          convexMesh->SetName(convexMeshName);
-          for (const auto & submesh : decomposed)
-            convexMesh->AddSubMesh(submesh);
-          meshManager.AddMesh(convexMesh);
-          if (decomposed.empty())
-          {
-            // Print an error if convex decomposition returned empty submeshes
-            // but still add it to MeshManager to avoid going through the
-            // expensive convex decomposition process for the same mesh again
-            gzerr << "Convex decomposition generated zero meshes: "
-                   << mesh->Name() << std::endl;
-          }
-          decomposedMesh = meshManager.MeshByName(convexMeshName);
+          meshShapes = this->ConvexHullShapes(*decomposedMesh, scale);
+          meshCreated = true;
         }
       }
 
-      if (decomposedMesh)
+      if (!meshCreated)
       {
-        for (std::size_t j = 0u; j < decomposedMesh->SubMeshCount(); ++j)
+        const gz::common::Mesh &collisionMesh =
+            physics::mesh::CachedSimplifiedMesh(
+                *mesh, contentHash, maxTriangles);
+        for (unsigned int submeshIdx = 0;
+             submeshIdx < collisionMesh.SubMeshCount();
+             ++submeshIdx)
         {
-          auto submesh = decomposedMesh->SubMeshByIndex(j).lock();
-          gz::math::Vector3d centroid;
-          for (std::size_t i = 0; i < submesh->VertexCount(); ++i)
-              centroid += submesh->Vertex(i);
-          centroid *= 1.0/static_cast<double>(submesh->VertexCount());
-          btAlignedObjectArray<btVector3> vertices;
-          for (std::size_t i = 0; i < submesh->VertexCount(); ++i)
+          auto s = collisionMesh.SubMeshByIndex(submeshIdx).lock();
+          auto vertexCount = s->VertexCount();
+          auto indexCount = s->IndexCount();
+
+          // Store each vertex once and refer to it by index, rather than
+          // copying the three vertices of every triangle.
+          this->triangleMeshes.push_back(std::make_unique<btTriangleMesh>());
+          auto *triangleMesh = this->triangleMeshes.back().get();
+          triangleMesh->preallocateVertices(static_cast<int>(vertexCount));
+          triangleMesh->preallocateIndices(static_cast<int>(indexCount));
+          for (unsigned int i = 0; i < vertexCount; i++)
           {
-            gz::math::Vector3d v = submesh->Vertex(i) - centroid;
-            vertices.push_back(convertVec(v) * scale);
+            triangleMesh->findOrAddVertex(btVector3(
+                  static_cast<btScalar>(s->Vertex(i).X()) * scale[0],
+                  static_cast<btScalar>(s->Vertex(i).Y()) * scale[1],
+                  static_cast<btScalar>(s->Vertex(i).Z()) * scale[2]),
+                false);
+          }
+          for (unsigned int i = 0; i < indexCount/3; i++)
+          {
+            triangleMesh->addTriangleIndices(
+                s->Index(i*3), s->Index(i*3 + 1), s->Index(i*3 + 2));
           }
 
-          float collisionMargin = 0.001f;
-          this->meshesConvex.push_back(std::make_unique<btConvexHullShape>(
-              &(vertices[0].getX()), vertices.size()));
-          auto *convexShape = this->meshesConvex.back().get();
-          convexShape->setMargin(collisionMargin);
-
-          btTransform trans;
-          trans.setIdentity();
-          trans.setOrigin(convertVec(centroid) * scale);
-          compoundShape->addChildShape(trans, convexShape);
+          if (useBvh)
+          {
+            this->meshesBvh.push_back(CreateCachedBvhTriangleMeshShape(
+                triangleMesh, this->serializedBvhs));
+            this->meshesBvh.back()->setMargin(btScalar(0.01));
+            meshShapes.emplace_back(btTransform::getIdentity(),
+              this->meshesBvh.back().get());
+          }
+          else
+          {
+            this->meshesGImpact.push_back(
+              std::make_unique<btGImpactMeshShape>(triangleMesh));
+            this->meshesGImpact.back()->updateBound();
+            this->meshesGImpact.back()->setMargin(btScalar(0.01));
+            meshShapes.emplace_back(btTransform::getIdentity(),
+              this->meshesGImpact.back().get());
+          }
         }
-        meshCreated = true;
       }
+
+      cached = this->meshShapeCache.emplace(
+          cacheKey, std::move(meshShapes)).first;
     }
 
-    if (!meshCreated)
+    const MeshShapes &meshShapes = cached->second;
+    shape = this->InternShape("mesh|" + cacheKey, [&]
     {
-      for (unsigned int submeshIdx = 0;
-           submeshIdx < mesh->SubMeshCount();
-           ++submeshIdx)
-      {
-        auto s = mesh->SubMeshByIndex(submeshIdx).lock();
-        auto vertexCount = s->VertexCount();
-        auto indexCount = s->IndexCount();
-        btAlignedObjectArray<btVector3> convertedVerts;
-        convertedVerts.reserve(static_cast<int>(vertexCount));
-        for (unsigned int i = 0; i < vertexCount; i++)
-        {
-          convertedVerts.push_back(btVector3(
-                static_cast<btScalar>(s->Vertex(i).X()) * scale[0],
-                static_cast<btScalar>(s->Vertex(i).Y()) * scale[1],
-                static_cast<btScalar>(s->Vertex(i).Z()) * scale[2]));
-        }
-
-        this->triangleMeshes.push_back(std::make_unique<btTriangleMesh>());
-        for (unsigned int i = 0; i < indexCount/3; i++)
-        {
-          const btVector3& v0 = convertedVerts[s->Index(i*3)];
-          const btVector3& v1 = convertedVerts[s->Index(i*3 + 1)];
-          const btVector3& v2 = convertedVerts[s->Index(i*3 + 2)];
-          this->triangleMeshes.back()->addTriangle(v0, v1, v2);
-        }
-
-        this->meshesGImpact.push_back(
-          std::make_unique<btGImpactMeshShape>(
-            this->triangleMeshes.back().get()));
-        this->meshesGImpact.back()->updateBound();
-        this->meshesGImpact.back()->setMargin(btScalar(0.01));
-        compoundShape->addChildShape(btTransform::getIdentity(),
-          this->meshesGImpact.back().get());
-      }
-    }
-    shape = std::move(compoundShape);
+      auto compoundShape = std::make_unique<btCompoundShape>();
+      for (const auto &[childPose, childShape] : meshShapes)
+        compoundShape->addChildShape(childPose, childShape);
+      return compoundShape;
+    });
+  }
+  else if (geom->HeightmapShape())
+  {
+    // The consumer loads the heightmap data and attaches it, like in dartsim
+    gzdbg << "Heightmap construction from an SDF has not been implemented "
+          << "for bullet-featherstone. Use AttachHeightmapShapeFeature to use "
+          << "heightmaps.\n";
+    return false;
   }
   else
   {
@@ -1183,11 +1525,7 @@ bool SDFFeatures::AddSdfCollision(
     return false;
   }
 
-  double mu = 1.0;
-  double mu2 = 1.0;
-  double restitution = 0.0;
-  double torsionalCoefficient = 1.0;
-  double rollingFriction = 0.0;
+  ColliderSurfaceInfo surfaceInfo;
   if (const auto *surface = _collision.Surface())
   {
     if (const auto *friction = surface->Friction())
@@ -1197,20 +1535,20 @@ bool SDFFeatures::AddSdfCollision(
         if (const auto bullet = frictionElement->FindElement("bullet"))
         {
           if (const auto f1 = bullet->FindElement("friction"))
-            mu = f1->Get<double>();
+            surfaceInfo.mu = f1->Get<double>();
 
           if (const auto f2 = bullet->FindElement("friction2"))
-            mu2 = f2->Get<double>();
+            surfaceInfo.mu2 = f2->Get<double>();
 
           // What is fdir1 for in the SDF's <bullet> spec?
 
           if (const auto rolling = bullet->FindElement("rolling_friction"))
-            rollingFriction = rolling->Get<double>();
+            surfaceInfo.rollingFriction = rolling->Get<double>();
         }
         if (const auto torsional = frictionElement->FindElement("torsional"))
         {
           if (const auto coefficient = torsional->FindElement("coefficient"))
-            torsionalCoefficient = coefficient->Get<double>();
+            surfaceInfo.torsionalCoefficient = coefficient->Get<double>();
         }
       }
     }
@@ -1220,139 +1558,46 @@ bool SDFFeatures::AddSdfCollision(
       if (const auto bounce = surfaceElement->FindElement("bounce"))
       {
         if (const auto r = bounce->FindElement("restitution_coefficient"))
-          restitution = r->Get<double>();
+          surfaceInfo.restitution = r->Get<double>();
       }
     }
   }
 
-  Eigen::Isometry3d linkFrameToCollision;
+  // Set meshes to use softer contacts for stability
+  surfaceInfo.softContacts = geom->MeshShape() != nullptr;
+  shapeScope.reset();
+
   if (shape != nullptr)
   {
-    {
-      gz::math::Pose3d gzLinkToCollision;
-      const auto errors =
-        _collision.SemanticPose().Resolve(gzLinkToCollision, linkInfo->name);
-      if (!errors.empty())
-      {
-        gzerr << "An error occurred while resolving the transform of the "
-          << "collider [" << _collision.Name() << "] in Link ["
-          << linkInfo->name << "] in Model [" << model->name << "]:\n";
-        for (const auto &error : errors)
+    gz::math::Pose3d gzLinkToCollision;
+    const auto errors = this->loadTimer.Measure(
+        sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
         {
-          gzerr << error << "\n";
-        }
-
-        return false;
-      }
-
-      linkFrameToCollision = gz::math::eigen3::convert(gzLinkToCollision);
-    }
-
-    const btTransform btInertialToCollision =
-      convertTf(linkInfo->inertiaToLinkFrame * linkFrameToCollision);
-
-    int linkIndexInModel = -1;
-    if (linkInfo->indexInModel.has_value())
-      linkIndexInModel = *linkInfo->indexInModel;
-
-    if (!linkInfo->collider)
+          return _collision.SemanticPose().Resolve(
+              gzLinkToCollision, linkInfo->name);
+        });
+    if (!errors.empty())
     {
-      linkInfo->shape = std::make_unique<btCompoundShape>();
-
-      // NOTE: Bullet does not appear to support different surface properties
-      // for different shapes attached to the same link.
-      linkInfo->collider = std::make_unique<btMultiBodyLinkCollider>(
-        model->body.get(), linkIndexInModel);
-
-      linkInfo->shape->addChildShape(btInertialToCollision, shape.get());
-
-      linkInfo->collider->setCollisionShape(linkInfo->shape.get());
-      linkInfo->collider->setRestitution(static_cast<btScalar>(restitution));
-      linkInfo->collider->setRollingFriction(
-        static_cast<btScalar>(rollingFriction));
-      linkInfo->collider->setSpinningFriction(
-        static_cast<btScalar>(torsionalCoefficient));
-      linkInfo->collider->setFriction(static_cast<btScalar>(mu));
-      linkInfo->collider->setAnisotropicFriction(
-        btVector3(static_cast<btScalar>(mu), static_cast<btScalar>(mu2), 1),
-        btCollisionObject::CF_ANISOTROPIC_FRICTION);
-
-      if (geom->MeshShape())
-      {
-        // Set meshes to use softer contacts for stability
-        // \todo(iche033) load <kp> and <kd> values from SDF
-        const btScalar kp = btScalar(1e15);
-        const btScalar kd = btScalar(1e14);
-        linkInfo->collider->setContactStiffnessAndDamping(kp, kd);
-      }
-
-      if (linkIndexInModel >= 0)
-      {
-        model->body->getLink(linkIndexInModel).m_collider =
-          linkInfo->collider.get();
-        const auto p = model->body->localPosToWorld(
-          linkIndexInModel, btVector3(0, 0, 0));
-        const auto rot = model->body->localFrameToWorld(
-          linkIndexInModel, btMatrix3x3::getIdentity());
-        linkInfo->collider->setWorldTransform(btTransform(rot, p));
-      }
-      else
+      gzerr << "An error occurred while resolving the transform of the "
+        << "collider [" << _collision.Name() << "] in Link ["
+        << linkInfo->name << "] in Model [" << model->name << "]:\n";
+      for (const auto &error : errors)
       {
-        model->body->setBaseCollider(linkInfo->collider.get());
-        linkInfo->collider->setWorldTransform(
-          model->body->getBaseWorldTransform());
+        gzerr << error << "\n";
       }
 
-      auto *world = this->ReferenceInterface<WorldInfo>(model->world);
-
-      // Set static filter for collisions in
-      // 1) a static model
-      // 2) a fixed base link
-      // 3) a (non-base) link with zero dofs
-      bool isFixed = false;
-      if (model->body->hasFixedBase())
-      {
-        // check if it's a base link
-        isFixed = std::size_t(_linkID) ==
-            static_cast<std::size_t>(model->body->getUserIndex());
-        // check if link has zero dofs
-        if (!isFixed && linkInfo->indexInModel.has_value())
-        {
-           isFixed = model->body->getLink(
-              linkInfo->indexInModel.value()).m_dofCount == 0;
-        }
-      }
-      if (isStatic || isFixed)
-      {
-        world->world->addCollisionObject(
-          linkInfo->collider.get(),
-          btBroadphaseProxy::StaticFilter,
-          btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
-      }
-      else
-      {
-        world->world->addCollisionObject(
-          linkInfo->collider.get(),
-          btBroadphaseProxy::DefaultFilter,
-          btBroadphaseProxy::AllFilter);
-      }
-    }
-    else if (linkInfo->shape)
-    {
-      linkInfo->shape->addChildShape(btInertialToCollision, shape.get());
-    }
-    else
-    {
-      // TODO(MXG): Maybe we should check if the new collider's properties
-      // match the existing collider and issue a warning if they don't.
+      return false;
     }
 
-    this->AddCollision(
+    this->AddLinkCollision(
       CollisionInfo{
         _collision.Name(),
         std::move(shape),
         _linkID,
-        linkFrameToCollision});
+        gz::math::eigen3::convert(gzLinkToCollision)},
+      surfaceInfo,
+      isStatic || isFixed,
+      isStatic && this->bakeStaticCollisions);
   }
 
   return true;
@@ -1376,6 +1621,55 @@ Identity SDFFeatures::ConstructSdfCollision(
   return this->GenerateInvalidId();
 }
 
+/////////////////////////////////////////////////
+sdf::GetSdfLoadReport::LoadReport SDFFeatures::GetSdfWorldLoadReport(
+    const Identity &_worldID) const
+{
+  const auto it = this->loadReports.find(_worldID);
+  if (it == this->loadReports.end())
+    return {};
+  return it->second;
+}
+
+/////////////////////////////////////////////////
+void SDFFeatures::SetEngineBakeStaticCollisions(
+    const Identity &/*_engineID*/, const bool _bake)
+{
+  this->bakeStaticCollisions = _bake;
+}
+
+/////////////////////////////////////////////////
+bool SDFFeatures::GetEngineBakeStaticCollisions(
+    const Identity &/*_engineID*/) const
+{
+  return this->bakeStaticCollisions;
+}
+
+/////////////////////////////////////////////////
+void SDFFeatures::SetEngineSelfCollisionSampleCount(
+    const Identity &/*_engineID*/, std::size_t _numSamples)
+{
+  this->selfCollisionSampleCount = _numSamples;
+}
+
+/////////////////////////////////////////////////
+std::size_t SDFFeatures::GetEngineSelfCollisionSampleCount(
+    const Identity &/*_engineID*/) const
+{
+  return this->selfCollisionSampleCount;
+}
+
+/////////////////////////////////////////////////
+std::size_t SDFFeatures::GetModelNeverCollidingLinkPairCount(
+    const Identity &_modelID) const
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  const auto *world = this->ReferenceInterface<WorldInfo>(model->world);
+  const auto *dispatcher =
+      dynamic_cast<const GzCollisionDispatcher *>(world->dispatcher.get());
+  return dispatcher ? dispatcher->IgnoredLinkPairCount(model->body.get()) : 0u;
+}
+
 /////////////////////////////////////////////////
 Identity SDFFeatures::ConstructSdfJoint(
     const Identity &_modelID,
@@ -18,16 +18,23 @@
 #ifndef GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_SDFFEATURES_HH_
 #define GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_SDFFEATURES_HH_
 
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include <gz/physics/CollisionCheck.hh>
+#include <gz/physics/sdf/BakeStaticCollisions.hh>
 #include <gz/physics/sdf/ConstructCollision.hh>
 #include <gz/physics/sdf/ConstructJoint.hh>
 #include <gz/physics/sdf/ConstructModel.hh>
 #include <gz/physics/sdf/ConstructNestedModel.hh>
 #include <gz/physics/sdf/ConstructWorld.hh>
+#include <gz/physics/sdf/LoadReport.hh>
 #include <gz/physics/Implements.hh>
 
 #include <sdf/Collision.hh>
+#include <sdf/Mesh.hh>
 
 #include "EntityManagementFeatures.hh"
 
@@ -36,11 +43,15 @@ namespace physics {
 namespace bullet_featherstone {
 
 struct SDFFeatureList : gz::physics::FeatureList<
+  sdf::BakeStaticCollisions,
   sdf::ConstructSdfJoint,
   sdf::ConstructSdfModel,
+  sdf::ConstructSdfModels,
   sdf::ConstructSdfNestedModel,
   sdf::ConstructSdfWorld,
-  sdf::ConstructSdfCollision
+  sdf::ConstructSdfCollision,
+  sdf::GetSdfLoadReport,
+  SelfCollisionSamplingFeature
 > { };
 
 class SDFFeatures :
@@ -55,6 +66,10 @@ class SDFFeatures :
       const Identity &_worldID,
       const ::sdf::Model &_sdfModel) override;
 
+  public: std::vector<Identity> ConstructSdfModels(
+      const Identity &_worldID,
+      const std::vector<const ::sdf::Model *> &_sdfModels) override;
+
   public: Identity ConstructSdfNestedModel(
       const Identity &_parentID,
       const ::sdf::Model &_sdfModel) override;
@@ -68,6 +83,24 @@ class SDFFeatures :
       const Identity &_modelID,
       const ::sdf::Joint &_sdfJoint) override;
 
+  public: sdf::GetSdfLoadReport::LoadReport GetSdfWorldLoadReport(
+      const Identity &_worldID) const override;
+
+  public: void SetEngineBakeStaticCollisions(
+      const Identity &_engineID, bool _bake) override;
+
+  public: bool GetEngineBakeStaticCollisions(
+      const Identity &_engineID) const override;
+
+  public: void SetEngineSelfCollisionSampleCount(
+      const Identity &_engineID, std::size_t _numSamples) override;
+
+  public: std::size_t GetEngineSelfCollisionSampleCount(
+      const Identity &_engineID) const override;
+
+  public: std::size_t GetModelNeverCollidingLinkPairCount(
+      const Identity &_modelID) const override;
+
   private: Identity ConstructSdfCollision(
       const Identity &_linkID,
       const ::sdf::Collision &_collision) override;
@@ -78,6 +111,25 @@ class SDFFeatures :
   /// \return The entity identity if constructed otherwise an invalid identity
   private: Identity ConstructSdfModelImpl(std::size_t _parentID,
                                           const ::sdf::Model &_sdfModel);
+
+  /// \brief Construct the primitive that a mesh is fitted by, see
+  /// FitCollisionMeshPrimitivesFeature.
+  /// \param[in] _meshSdf Mesh of the collision.
+  /// \return The shared primitive, or nullptr if the mesh is not fitted by
+  /// one.
+  private: std::shared_ptr<btCollisionShape> ConstructFittedPrimitive(
+      const ::sdf::Mesh &_meshSdf);
+
+  /// \brief Whether the collisions of static models are added to the baked
+  /// static collider of their world, see sdf::BakeStaticCollisions.
+  private: bool bakeStaticCollisions = false;
+
+  /// \brief Charges the time spent constructing entities to loadReports.
+  private: sdf::LoadTimer loadTimer;
+
+  /// \brief Load reports of the worlds, keyed by world ID.
+  private: std::unordered_map<std::size_t, sdf::GetSdfLoadReport::LoadReport>
+      loadReports;
 };
 
 }  // namespace bullet_featherstone
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+
+#include <gz/common/MeshManager.hh>
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
+
+#include <sdf/Root.hh>
+
+#include "test/Resources.hh"
+
+#include "SDFFeatures.hh"
+
+using namespace gz;
+using namespace gz::physics;
+
+/////////////////////////////////////////////////
+/// \brief SDF of a model with one mesh collision.
+/// \param[in] _name Name of the model.
+/// \param[in] _uri File of the mesh.
+/// \param[in] _scale Scale of the mesh.
+/// \param[in] _static Whether the model is static.
+/// \param[in] _maxConvexHulls Number of hulls to decompose the mesh into,
+/// or 0 to collide with its triangles.
+static std::string MeshModel(const std::string &_name, const std::string &_uri,
+                             double _scale, bool _static,
+                             std::size_t _maxConvexHulls)
+{
+  std::ostringstream out;
+  out << "<model name='" << _name << "'><static>" << _static << "</static>"
+      << "<link name='link'><collision name='collision'><geometry><mesh";
+  if (_maxConvexHulls > 0u)
+  {
+    out << " optimization='convex_decomposition'><convex_decomposition>"
+        << "<max_convex_hulls>" << _maxConvexHulls << "</max_convex_hulls>"
+        << "</convex_decomposition>";
+  }
+  else
+  {
+    out << ">";
+  }
+  out << "<uri>" << _uri << "</uri><scale>" << _scale << " " << _scale << " "
+      << _scale << "</scale></mesh></geometry></collision></link></model>";
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Construct a world of models with the SDF features of the plugin.
+/// \param[in] _features The SDF features.
+/// \param[in] _models SDF of the models.
+/// \return Identity of the world.
+static Identity ConstructWorld(bullet_featherstone::SDFFeatures &_features,
+                               const std::string &_models)
+{
+  sdf::Root root;
+  const sdf::Errors errors = root.LoadSdfString(
+      "<sdf version='1.11'><world name='meshes'>" + _models +
+      "</world></sdf>");
+  EXPECT_TRUE(errors.empty()) << errors.front();
+  return _features.ConstructSdfWorld(
+      _features.InitiateEngine(0), *root.WorldByIndex(0));
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the shape of a collision by the name of its model.
+static std::shared_ptr<btCollisionShape> CollisionShape(
+    const bullet_featherstone::SDFFeatures &_features,
+    const std::string &_modelName)
+{
+  for (const auto &[id, model] : _features.models)
+  {
+    if (model->name != _modelName)
+      continue;
+    for (const auto &[collisionID, collision] : _features.collisions)
+    {
+      const auto &link = _features.links.at(collision->link);
+      if (_features.models.at(link->model) == model)
+        return collision->collider;
+    }
+  }
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+TEST(SDFFeatures, SharedMeshShapes)
+{
+  // Collisions of the same mesh at the same scale share their shape, down
+  // to the BVH of its triangles. Another scale needs shapes of its own.
+  bullet_featherstone::SDFFeatures features;
+  const std::string uri = physics::test::resources::kVShapeObj;
+  ConstructWorld(features,
+      MeshModel("a", uri, 1.0, true, 0u) +
+      MeshModel("b", uri, 1.0, true, 0u) +
+      MeshModel("scaled", uri, 2.0, true, 0u));
+
+  const auto a = CollisionShape(features, "a");
+  const auto b = CollisionShape(features, "b");
+  const auto scaled = CollisionShape(features, "scaled");
+  ASSERT_NE(nullptr, a);
+  ASSERT_NE(nullptr, b);
+  ASSERT_NE(nullptr, scaled);
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, scaled);
+
+  EXPECT_EQ(2u, features.meshShapeCache.size());
+  std::set<const btCollisionShape *> children;
+  for (const auto &[key, meshShapes] : features.meshShapeCache)
+  {
+    for (const auto &[pose, child] : meshShapes)
+      EXPECT_TRUE(children.insert(child).second) << key;
+  }
+  EXPECT_EQ(features.meshesBvh.size(), children.size());
+  EXPECT_TRUE(features.meshesGImpact.empty());
+}
+
+/////////////////////////////////////////////////
+TEST(SDFFeatures, ParallelConvexDecomposition)
+{
+  // Worlds with several meshes to decompose decompose them all on a thread
+  // pool before their models are built. The hulls are those of a serial
+  // decomposition.
+  const std::string chassis = physics::test::resources::kChassisDae;
+  const std::string vShape = physics::test::resources::kVShapeObj;
+  auto &meshManager = *common::MeshManager::Instance();
+  for (const auto &uri : {chassis, vShape})
+  {
+    const auto *mesh = meshManager.Load(uri);
+    ASSERT_NE(nullptr, mesh);
+    ASSERT_FALSE(meshManager.HasMesh(
+        physics::mesh::ConvexMeshName(mesh->Name(), 4u)));
+  }
+
+  bullet_featherstone::SDFFeatures features;
+  ConstructWorld(features,
+      MeshModel("chassis", chassis, 1.0, false, 4u) +
+      MeshModel("v_shape", vShape, 1.0, false, 4u));
+
+  for (const auto &[modelName, uri] :
+       {std::make_pair("chassis", chassis), std::make_pair("v_shape", vShape)})
+  {
+    const auto *mesh = meshManager.MeshByName(uri);
+    ASSERT_NE(nullptr, mesh);
+    const auto serial =
+        physics::mesh::ConvexDecomposeMesh(*mesh, 4u, "convex_decomposition");
+    ASSERT_NE(nullptr, serial);
+    EXPECT_LT(0u, serial->SubMeshCount()) << modelName;
+
+    const auto *parallel = meshManager.MeshByName(
+        physics::mesh::ConvexMeshName(mesh->Name(), 4u));
+    ASSERT_NE(nullptr, parallel) << modelName;
+    EXPECT_EQ(serial->SubMeshCount(), parallel->SubMeshCount()) << modelName;
+
+    // The collision has a hull per submesh of the decomposition
+    const auto shape = CollisionShape(features, modelName);
+    ASSERT_NE(nullptr, shape);
+    const auto *compound = dynamic_cast<const btCompoundShape *>(shape.get());
+    ASSERT_NE(nullptr, compound);
+    EXPECT_EQ(static_cast<int>(serial->SubMeshCount()),
+              compound->getNumChildShapes()) << modelName;
+  }
+}
@@ -17,10 +17,23 @@
 
 #include "ShapeFeatures.hh"
 
+#include <gz/common/geospatial/HeightmapData.hh>
 #include <gz/math/eigen3/Conversions.hh>
+#include <gz/math/Helpers.hh>
+#include <gz/physics/heightmap/HeightfieldCache.hh>
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace gz {
 namespace physics {
@@ -32,19 +45,123 @@ AlignedBox3d ShapeFeatures::GetShapeAxisAlignedBoundingBox(
 {
   const auto *collider = this->ReferenceInterface<CollisionInfo>(_shapeID);
   if (collider)
+    return collider->localBoundingBox;
+  return math::eigen3::convert(math::AxisAlignedBox());
+}
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldShapeBoundingBoxes(
+    const Identity &_worldID) const -> ShapeBoundingBoxBatch
+{
+  this->shapeBoundingBoxes.Clear();
+
+  // Collisions are ordered by ID, so the collisions of a link follow each
+  // other and the pose of each link is computed once.
+  const LinkInfo *lastLink = nullptr;
+  bool lastLinkInWorld = false;
+  Eigen::Isometry3d linkPose = Eigen::Isometry3d::Identity();
+  for (const auto &[id, collision] : this->collisions)
   {
-    btTransform t;
-    t.setIdentity();
-    btVector3 minBox(0, 0, 0);
-    btVector3 maxBox(0, 0, 0);
-    btVector3 minBox2(0, 0, 0);
-    btVector3 maxBox2(0, 0, 0);
-    collider->collider->getAabb(t, minBox, maxBox);
-    return math::eigen3::convert(math::AxisAlignedBox(
-      math::Vector3d(minBox[0], minBox[1], minBox[2]),
-      math::Vector3d(maxBox[0], maxBox[1], maxBox[2])));
+    const auto linkIt = this->links.find(collision->link);
+    if (linkIt == this->links.end())
+      continue;
+
+    const LinkInfo *link = linkIt->second.get();
+    if (link != lastLink)
+    {
+      lastLink = link;
+      const auto modelIt = this->models.find(link->model);
+      lastLinkInWorld = modelIt != this->models.end() &&
+          modelIt->second->world.id == _worldID.id && modelIt->second->body;
+      if (lastLinkInWorld)
+        linkPose = this->LinkWorldTransform(*modelIt->second, *link);
+    }
+
+    if (!lastLinkInWorld)
+      continue;
+
+    this->shapeBoundingBoxes.Add(id, linkPose * collision->linkToCollision,
+        collision->localBoundingBox);
   }
-  return math::eigen3::convert(math::AxisAlignedBox());
+
+  return this->shapeBoundingBoxes.View();
+}
+
+/////////////////////////////////////////////////
+bool ShapeFeatures::LinkWorldBoundingBox(
+    const ModelInfo &_model, const LinkInfo &_link, AlignedBox3d &_box) const
+{
+  if (!_link.shape || _link.shape->getNumChildShapes() == 0)
+    return false;
+
+  // The compound shape is expressed in the inertial frame of the link and
+  // keeps the bounding box of its children, which is also what bullet
+  // refits the broadphase proxy of the link collider with.
+  const btTransform inertiaFrame = _link.indexInModel.has_value() ?
+      this->LinkInertiaPoses(_model)[
+          static_cast<std::size_t>(*_link.indexInModel)] :
+      _model.body->getBaseWorldTransform();
+  btVector3 min;
+  btVector3 max;
+  _link.shape->getAabb(inertiaFrame, min, max);
+  _box = AlignedBox3d(convert(min), convert(max));
+  return true;
+}
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldLinkBoundingBoxes(
+    const Identity &_worldID) const -> BoundingBoxBatch
+{
+  this->linkBoundingBoxes.Clear();
+
+  AlignedBox3d box;
+  for (const auto &[id, link] : this->links)
+  {
+    const auto modelIt = this->models.find(link->model);
+    if (modelIt == this->models.end() || !modelIt->second->body ||
+        modelIt->second->world.id != _worldID.id)
+    {
+      continue;
+    }
+
+    if (this->LinkWorldBoundingBox(*modelIt->second, *link, box))
+      this->linkBoundingBoxes.Add(id, box);
+  }
+
+  return this->linkBoundingBoxes.View();
+}
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldModelBoundingBoxes(
+    const Identity &_worldID) const -> BoundingBoxBatch
+{
+  this->modelBoundingBoxes.Clear();
+
+  // Links are ordered by ID, so a model is added when its first link with
+  // shapes is found, and the boxes of its other links are merged into it.
+  std::unordered_map<std::size_t, std::size_t> modelBoxIndex;
+  AlignedBox3d box;
+  for (const auto &[id, link] : this->links)
+  {
+    const auto modelIt = this->models.find(link->model);
+    if (modelIt == this->models.end() || !modelIt->second->body ||
+        modelIt->second->world.id != _worldID.id)
+    {
+      continue;
+    }
+
+    if (!this->LinkWorldBoundingBox(*modelIt->second, *link, box))
+      continue;
+
+    const auto [indexIt, inserted] = modelBoxIndex.emplace(
+        link->model.id, this->modelBoundingBoxes.entity.size());
+    if (inserted)
+      this->modelBoundingBoxes.Add(link->model.id, box);
+    else
+      this->modelBoundingBoxes.box[indexIt->second].extend(box);
+  }
+
+  return this->modelBoundingBoxes.View();
 }
 
 /////////////////////////////////////////////////
@@ -89,8 +206,9 @@ Identity ShapeFeatures::AttachBoxShape(
       const Pose3d &_pose)
 {
   const btVector3 halfExtents = convertVec(_size * 0.5);
-  std::unique_ptr<btCollisionShape> shape =
-    std::make_unique<btBoxShape>(halfExtents);
+  auto shape = this->InternShape(
+      ShapeKey("box", halfExtents.x(), halfExtents.y(), halfExtents.z()),
+      [&]{ return std::make_unique<btBoxShape>(halfExtents); });
 
   auto identity = this->AddCollision(
     CollisionInfo{
@@ -166,8 +284,10 @@ Identity ShapeFeatures::AttachCapsuleShape(
     const double _length,
     const Pose3d &_pose)
 {
-  auto shape = std::make_unique<btCapsuleShapeZ>(
-      static_cast<btScalar>(_radius), static_cast<btScalar>(_length / 2));
+  const auto radius = static_cast<btScalar>(_radius);
+  const auto length = static_cast<btScalar>(_length / 2);
+  auto shape = this->InternShape(ShapeKey("capsule", radius, length),
+      [&]{ return std::make_unique<btCapsuleShapeZ>(radius, length); });
 
   auto identity = this->AddCollision(
     CollisionInfo{
@@ -245,8 +365,11 @@ Identity ShapeFeatures::AttachCylinderShape(
 {
   const auto radius = static_cast<btScalar>(_radius);
   const auto halfLength = static_cast<btScalar>(_height * 0.5);
-  auto shape =
-    std::make_unique<btCylinderShapeZ>(btVector3(radius, radius, halfLength));
+  auto shape = this->InternShape(ShapeKey("cylinder", radius, halfLength), [&]
+      {
+        return std::make_unique<btCylinderShapeZ>(
+            btVector3(radius, radius, halfLength));
+      });
 
   auto identity = this->AddCollision(
     CollisionInfo{
@@ -305,15 +428,20 @@ Identity ShapeFeatures::AttachEllipsoidShape(
     const Vector3d &_radii,
     const Pose3d &_pose)
 {
-  btVector3 positions[1];
-  btScalar radius[1];
-  positions[0] = btVector3(0, 0, 0);
-  radius[0] = 1;
+  const btVector3 radii = convertVec(_radii);
+  auto shape = this->InternShape(
+      ShapeKey("ellipsoid_multisphere", radii.x(), radii.y(), radii.z()), [&]
+      {
+        btVector3 positions[1];
+        btScalar radius[1];
+        positions[0] = btVector3(0, 0, 0);
+        radius[0] = 1;
 
-  auto btSphere = std::make_unique<btMultiSphereShape>(
-    positions, radius, 1);
-  btSphere->setLocalScaling(convertVec(_radii));
-  auto shape = std::move(btSphere);
+        auto btSphere = std::make_unique<btMultiSphereShape>(
+          positions, radius, 1);
+        btSphere->setLocalScaling(radii);
+        return btSphere;
+      });
 
   auto identity = this->AddCollision(
     CollisionInfo{
@@ -324,6 +452,412 @@ Identity ShapeFeatures::AttachEllipsoidShape(
   return identity;
 }
 
+/////////////////////////////////////////////////
+/// \brief Get the heightfield of a collision attached by
+/// AttachHeightmapShape, which wraps it in a compound shape.
+/// \param[in] _shape Collision shape.
+/// \return The heightfield, or nullptr if the shape is not a heightmap.
+static const btHeightfieldTerrainShape *HeightfieldOf(
+    const btCollisionShape *_shape)
+{
+  const auto *compound = dynamic_cast<const btCompoundShape *>(_shape);
+  if (nullptr == compound || compound->getNumChildShapes() != 1)
+    return nullptr;
+  return dynamic_cast<const btHeightfieldTerrainShape *>(
+      compound->getChildShape(0));
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::CastToHeightmapShape(
+      const Identity &_shapeID) const
+{
+  const auto *shapeInfo = this->ReferenceInterface<CollisionInfo>(_shapeID);
+  if (shapeInfo != nullptr && HeightfieldOf(shapeInfo->collider.get()))
+    return this->GenerateIdentity(_shapeID, this->Reference(_shapeID));
+
+  return this->GenerateInvalidId();
+}
+
+/////////////////////////////////////////////////
+LinearVector3d ShapeFeatures::GetHeightmapShapeSize(
+      const Identity &_heightmapID) const
+{
+  const auto *shapeInfo =
+      this->ReferenceInterface<CollisionInfo>(_heightmapID);
+  const auto *heightfield = HeightfieldOf(shapeInfo->collider.get());
+  if (nullptr == heightfield)
+    return LinearVector3d(-1.0, -1.0, -1.0);
+
+  btVector3 minBox(0, 0, 0);
+  btVector3 maxBox(0, 0, 0);
+  heightfield->getAabb(btTransform::getIdentity(), minBox, maxBox);
+  const btVector3 size =
+      maxBox - minBox - btVector3(2, 2, 2) * heightfield->getMargin();
+  return LinearVector3d(size.x(), size.y(), size.z());
+}
+
+/////////////////////////////////////////////////
+/// \brief Build the heights and heightfield shape of a heightmap.
+/// \param[in] _heightmapData Heightmap data.
+/// \param[in] _size Size of the heightmap in meters.
+/// \param[in] _subSampling How much to subsample, at least 1.
+/// \param[in] _vertSize Number of vertices along each edge.
+/// \return The heightfield.
+static std::shared_ptr<const HeightfieldInfo> BuildHeightfield(
+    const common::HeightmapData &_heightmapData,
+    const LinearVector3d &_size,
+    int _subSampling,
+    int _vertSize)
+{
+  auto info = std::make_shared<HeightfieldInfo>();
+
+  // The heights span the size of the heightmap exactly, instead of one
+  // vertex spacing less as in the dartsim plugin.
+  const float heightmapSizeZ =
+      _heightmapData.MaxElevation() - _heightmapData.MinElevation();
+  math::Vector3d scale;
+  scale.X(_size.x() / (_vertSize - 1));
+  scale.Y(_size.y() / (_vertSize - 1));
+  if (math::equal(heightmapSizeZ, 0.0f))
+    scale.Z(1.0);
+  else
+    scale.Z(std::fabs(_size.z()) / heightmapSizeZ);
+
+  // FillHeightMap subsamples the heightmap by bilinear interpolation
+  std::vector<float> heights;
+  const bool flipY = false;
+  _heightmapData.FillHeightMap(_subSampling,
+      static_cast<unsigned int>(_vertSize), math::eigen3::convert(_size),
+      scale, flipY, heights);
+
+  // The first row of a heightmap is its +y edge, and the first row of a
+  // bullet heightfield is its -y edge.
+  const auto width = static_cast<std::size_t>(_vertSize);
+  info->heights.resize(heights.size());
+  for (std::size_t row = 0; row < width; ++row)
+  {
+    std::copy_n(heights.begin() + (width - 1 - row) * width, width,
+                info->heights.begin() + row * width);
+  }
+
+  const auto [minIt, maxIt] =
+      std::minmax_element(info->heights.begin(), info->heights.end());
+  info->minHeight = *minIt;
+  info->maxHeight = *maxIt;
+
+  // The shape refers to the heights rather than copying them
+  info->shape = std::make_unique<btHeightfieldTerrainShape>(
+      _vertSize, _vertSize, info->heights.data(), btScalar(1),
+      btScalar(info->minHeight), btScalar(info->maxHeight), 2, PHY_FLOAT,
+      false);
+  info->shape->setLocalScaling(btVector3(
+      static_cast<btScalar>(scale.X()), static_cast<btScalar>(scale.Y()),
+      btScalar(1)));
+#if BT_BULLET_VERSION >= 307
+  // Groups the heights into chunks with their min and max height, so rays
+  // skip the chunks they pass over.
+  info->shape->buildAccelerator();
+#endif
+  return info;
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachHeightmapShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const common::HeightmapData &_heightmapData,
+    const Pose3d &_pose,
+    const LinearVector3d &_size,
+    int _subSampling)
+{
+  const int subSampling = std::max(1, _subSampling);
+  const int vertSize =
+      static_cast<int>(_heightmapData.Width()) * subSampling - subSampling + 1;
+  if (vertSize < 2)
+  {
+    gzerr << "Heightmap [" << _name << "] needs at least 2 samples along "
+          << "each edge\n";
+    return this->GenerateInvalidId();
+  }
+
+  const bool isFixed = this->IsLinkFixed(_linkID);
+  if (!isFixed)
+  {
+    gzwarn << "Heightmap [" << _name << "] is attached to a link that can "
+           << "move. Bullet heightfields are meant for static terrain.\n";
+  }
+
+  // Collisions that use the same heightmap share its heights and shape
+  std::ostringstream key;
+  key << std::setprecision(std::numeric_limits<double>::max_digits10)
+      << _heightmapData.Filename() << "|" << _size.x() << " " << _size.y()
+      << " " << _size.z() << "|" << subSampling;
+  auto cached = this->heightfieldCache.find(key.str());
+  if (cached == this->heightfieldCache.end())
+  {
+    // Engines of the process that attach the same heightmap file share its
+    // heightfield as well
+    auto info =
+        heightmap::SharedHeightfieldCache<const HeightfieldInfo>::Instance()
+            .Get(heightmap::HeightfieldKey(_heightmapData,
+                     math::eigen3::convert(_size), subSampling), [&]
+            {
+              return BuildHeightfield(
+                  _heightmapData, _size, subSampling, vertSize);
+            });
+    cached = this->heightfieldCache.emplace(key.str(), std::move(info)).first;
+  }
+
+  // Bullet centers heightfields between their min and max height, so shift
+  // it to keep the heights relative to the collision frame.
+  const HeightfieldInfo &info = *cached->second;
+  auto compoundShape = this->InternShape("heightmap|" + key.str(), [&]
+  {
+    auto compound = std::make_unique<btCompoundShape>();
+    compound->addChildShape(
+        btTransform(btMatrix3x3::getIdentity(), btVector3(0, 0,
+            btScalar(0.5) * btScalar(info.minHeight + info.maxHeight))),
+        info.shape.get());
+    return compound;
+  });
+
+  return this->AddLinkCollision(
+    CollisionInfo{
+      _name,
+      std::move(compoundShape),
+      _linkID,
+      _pose},
+    ColliderSurfaceInfo(),
+    isFixed);
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::CastToMeshShape(
+      const Identity &_shapeID) const
+{
+  const auto *shapeInfo = this->ReferenceInterface<CollisionInfo>(_shapeID);
+  if (shapeInfo == nullptr)
+    return this->GenerateInvalidId();
+
+  // Meshes are compounds of triangle mesh shapes, one per submesh, or of
+  // the convex hulls of their decomposition
+  const auto *compound =
+      dynamic_cast<const btCompoundShape *>(shapeInfo->collider.get());
+  if (nullptr == compound || compound->getNumChildShapes() == 0)
+    return this->GenerateInvalidId();
+
+  for (int i = 0; i < compound->getNumChildShapes(); ++i)
+  {
+    const btCollisionShape *child = compound->getChildShape(i);
+    if (!dynamic_cast<const btBvhTriangleMeshShape *>(child) &&
+        !dynamic_cast<const btGImpactMeshShape *>(child) &&
+        !dynamic_cast<const btConvexHullShape *>(child))
+    {
+      return this->GenerateInvalidId();
+    }
+  }
+  return this->GenerateIdentity(_shapeID, this->Reference(_shapeID));
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachMeshViewShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const mesh::TriangleMeshView &_view,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale)
+{
+  if (!mesh::ValidTriangleMeshView(_view) ||
+      _view.vertexCount >
+          static_cast<std::size_t>(std::numeric_limits<int>::max()) ||
+      _view.indexCount / 3u >
+          static_cast<std::size_t>(std::numeric_limits<int>::max()))
+  {
+    gzerr << "Mesh view of shape [" << _name << "] has no triangles, an "
+          << "index out of range or more triangles than bullet supports\n";
+    return this->GenerateInvalidId();
+  }
+
+  // Same choice as for SDF meshes: a BVH for links that cannot move, and
+  // GImpact for the rest.
+  const bool isFixed = this->IsLinkFixed(_linkID);
+
+  // Views with the same content and scale share their shapes, like meshes
+  // constructed from SDF. Only views that own their arrays are shared, since
+  // the arrays of the others may be freed once their shapes are removed.
+  std::string cacheKey;
+  if (_view.owner)
+  {
+    cacheKey = ShapeKey("mesh_view", mesh::MeshContentHash(_view),
+                        _scale.x(), _scale.y(), _scale.z(), isFixed);
+  }
+  else
+  {
+    cacheKey = ShapeKey("mesh_view_unowned", this->meshViewArrays.size());
+  }
+
+  auto cached = this->meshShapeCache.find(cacheKey);
+  if (cached == this->meshShapeCache.end())
+  {
+    // Bullet reads the triangles straight from the arrays of the view
+    btIndexedMesh indexedMesh;
+    indexedMesh.m_numTriangles = static_cast<int>(_view.indexCount / 3u);
+    indexedMesh.m_triangleIndexBase =
+        reinterpret_cast<const unsigned char *>(_view.indices);
+    indexedMesh.m_triangleIndexStride = 3 * sizeof(std::uint32_t);
+    indexedMesh.m_numVertices = static_cast<int>(_view.vertexCount);
+    indexedMesh.m_vertexBase =
+        reinterpret_cast<const unsigned char *>(_view.vertices);
+    indexedMesh.m_vertexStride = 3 * sizeof(float);
+    indexedMesh.m_indexType = PHY_INTEGER;
+    indexedMesh.m_vertexType = PHY_FLOAT;
+
+    auto array = std::make_unique<btTriangleIndexVertexArray>();
+    array->addIndexedMesh(indexedMesh, PHY_INTEGER);
+    array->setScaling(convertVec(_scale));
+
+    btCollisionShape *meshShape = nullptr;
+    if (isFixed)
+    {
+      this->meshesBvh.push_back(CreateCachedBvhTriangleMeshShape(
+          array.get(), this->serializedBvhs));
+      this->meshesBvh.back()->setMargin(btScalar(0.01));
+      meshShape = this->meshesBvh.back().get();
+    }
+    else
+    {
+      this->meshesGImpact.push_back(
+        std::make_unique<btGImpactMeshShape>(array.get()));
+      this->meshesGImpact.back()->updateBound();
+      this->meshesGImpact.back()->setMargin(btScalar(0.01));
+      meshShape = this->meshesGImpact.back().get();
+    }
+    this->meshViewArrays.push_back(std::move(array));
+    if (_view.owner)
+      this->meshViewOwners.push_back(_view.owner);
+
+    cached = this->meshShapeCache.emplace(cacheKey,
+        MeshShapes{{btTransform::getIdentity(), meshShape}}).first;
+  }
+
+  const MeshShapes &meshShapes = cached->second;
+  auto compoundShape = this->InternShape("mesh|" + cacheKey, [&]
+  {
+    auto compound = std::make_unique<btCompoundShape>();
+    for (const auto &[childPose, childShape] : meshShapes)
+      compound->addChildShape(childPose, childShape);
+    return compound;
+  });
+
+  return this->AddLinkCollision(
+    CollisionInfo{
+      _name,
+      std::move(compoundShape),
+      _linkID,
+      _pose},
+    ColliderSurfaceInfo(),
+    isFixed);
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachConvexMeshShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const common::Mesh &_mesh,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale)
+{
+  return this->AttachConvexDecompositionShape(
+      _linkID, _name, _mesh, 1u, _pose, _scale);
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachConvexDecompositionShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const common::Mesh &_mesh,
+    std::size_t _maxConvexHulls,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale)
+{
+  if (_maxConvexHulls == 0u)
+  {
+    gzerr << "Convex decomposition of shape [" << _name << "] needs at "
+          << "least one hull\n";
+    return this->GenerateInvalidId();
+  }
+
+  // The hulls only depend on the content of the mesh, its scale and the
+  // number of hulls, so shapes attached from the same mesh share them.
+  const std::uint64_t hash = this->meshContentHashes.Hash(_mesh);
+  const std::string cacheKey = ShapeKey("convex_mesh", hash, _maxConvexHulls,
+                                        _scale.x(), _scale.y(), _scale.z());
+  auto cached = this->meshShapeCache.find(cacheKey);
+  if (cached == this->meshShapeCache.end())
+  {
+    const common::Mesh *convexMesh = mesh::CachedConvexMesh(
+        _mesh, hash, _maxConvexHulls,
+        _maxConvexHulls == 1u ? "convex_hull" : "convex_decomposition");
+    MeshShapes meshShapes;
+    if (convexMesh)
+      meshShapes = this->ConvexHullShapes(*convexMesh, convertVec(_scale));
+    if (meshShapes.empty())
+    {
+      gzerr << "Failed to compute the convex hulls of shape [" << _name
+            << "]\n";
+      return this->GenerateInvalidId();
+    }
+    cached = this->meshShapeCache.emplace(
+        cacheKey, std::move(meshShapes)).first;
+  }
+
+  const MeshShapes &meshShapes = cached->second;
+  auto compoundShape = this->InternShape("mesh|" + cacheKey, [&]
+  {
+    auto compound = std::make_unique<btCompoundShape>();
+    for (const auto &[childPose, childShape] : meshShapes)
+      compound->addChildShape(childPose, childShape);
+    return compound;
+  });
+
+  return this->AddLinkCollision(
+    CollisionInfo{
+      _name,
+      std::move(compoundShape),
+      _linkID,
+      _pose},
+    ColliderSurfaceInfo(),
+    this->IsLinkFixed(_linkID));
+}
+
+/////////////////////////////////////////////////
+void ShapeFeatures::SetEngineCollisionMeshTriangleBudget(
+    const Identity &/*_engineID*/, std::size_t _maxTriangles)
+{
+  this->collisionMeshTriangleBudget = _maxTriangles;
+}
+
+/////////////////////////////////////////////////
+std::size_t ShapeFeatures::GetEngineCollisionMeshTriangleBudget(
+    const Identity &/*_engineID*/) const
+{
+  return this->collisionMeshTriangleBudget;
+}
+
+/////////////////////////////////////////////////
+void ShapeFeatures::SetEngineCollisionMeshPrimitiveTolerance(
+    const Identity &/*_engineID*/, double _tolerance)
+{
+  this->collisionMeshPrimitiveTolerance = _tolerance;
+}
+
+/////////////////////////////////////////////////
+double ShapeFeatures::GetEngineCollisionMeshPrimitiveTolerance(
+    const Identity &/*_engineID*/) const
+{
+  return this->collisionMeshPrimitiveTolerance;
+}
+
 /////////////////////////////////////////////////
 Identity ShapeFeatures::CastToSphereShape(
     const Identity &_shapeID) const
@@ -365,8 +899,9 @@ Identity ShapeFeatures::AttachSphereShape(
     const double _radius,
     const Pose3d &_pose)
 {
-  std::unique_ptr<btCollisionShape> shape =
-    std::make_unique<btSphereShape>(static_cast<btScalar>(_radius));
+  const auto radius = static_cast<btScalar>(_radius);
+  auto shape = this->InternShape(ShapeKey("sphere", radius),
+      [&]{ return std::make_unique<btSphereShape>(radius); });
 
   auto identity = this->AddCollision(
     CollisionInfo{
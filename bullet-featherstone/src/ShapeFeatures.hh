@@ -20,11 +20,15 @@
 
 #include <gz/physics/Shape.hh>
 #include <gz/physics/BoxShape.hh>
+#include <gz/physics/GetBoundingBox.hh>
 #include <gz/physics/CapsuleShape.hh>
 #include <gz/physics/CylinderShape.hh>
 #include <gz/physics/EllipsoidShape.hh>
+#include <gz/physics/heightmap/HeightmapShape.hh>
+#include <gz/physics/mesh/MeshShape.hh>
 #include <gz/physics/SphereShape.hh>
 
+#include <cstddef>
 #include <string>
 
 #include "Base.hh"
@@ -35,6 +39,8 @@ namespace bullet_featherstone {
 
 struct ShapeFeatureList : FeatureList<
   GetShapeBoundingBox,
+  GetWorldShapeBoundingBoxes,
+  GetWorldLinkBoundingBoxes,
 
   GetBoxShapeProperties,
   AttachBoxShapeFeature,
@@ -48,6 +54,15 @@ struct ShapeFeatureList : FeatureList<
   GetEllipsoidShapeProperties,
   AttachEllipsoidShapeFeature,
 
+  heightmap::GetHeightmapShapeProperties,
+  heightmap::AttachHeightmapShapeFeature,
+
+  mesh::AttachMeshViewShapeFeature,
+  mesh::AttachConvexMeshShapeFeature,
+  mesh::AttachConvexDecompositionShapeFeature,
+  mesh::SimplifyCollisionMeshesFeature,
+  mesh::FitCollisionMeshPrimitivesFeature,
+
   GetSphereShapeProperties,
   AttachSphereShapeFeature
 > { };
@@ -56,10 +71,28 @@ class ShapeFeatures :
     public virtual Base,
     public virtual Implements3d<ShapeFeatureList>
 {
+  public: using ShapeBoundingBoxBatch =
+      GetWorldShapeBoundingBoxes::ShapeBoundingBoxBatchT<FeaturePolicy3d>;
+  public: using ShapeBoundingBoxStorage = GetWorldShapeBoundingBoxes::
+      Implementation<FeaturePolicy3d>::ShapeBoundingBoxStorage;
+  public: using BoundingBoxBatch =
+      GetWorldLinkBoundingBoxes::BoundingBoxBatchT<FeaturePolicy3d>;
+  public: using BoundingBoxStorage = GetWorldLinkBoundingBoxes::
+      Implementation<FeaturePolicy3d>::BoundingBoxStorage;
+
   // ----- Boundingbox Features -----
   public: AlignedBox3d GetShapeAxisAlignedBoundingBox(
               const Identity &_shapeID) const override;
 
+  public: ShapeBoundingBoxBatch GetWorldShapeBoundingBoxes(
+              const Identity &_worldID) const override;
+
+  public: BoundingBoxBatch GetWorldLinkBoundingBoxes(
+              const Identity &_worldID) const override;
+
+  public: BoundingBoxBatch GetWorldModelBoundingBoxes(
+              const Identity &_worldID) const override;
+
   // ----- Box Features -----
   public: Identity CastToBoxShape(
       const Identity &_shapeID) const override;
@@ -120,6 +153,59 @@ class ShapeFeatures :
       const Vector3d &_radii,
       const Pose3d &_pose) override;
 
+  // ----- Heightmap Features -----
+  public: Identity CastToHeightmapShape(
+      const Identity &_shapeID) const override;
+
+  public: LinearVector3d GetHeightmapShapeSize(
+      const Identity &_heightmapID) const override;
+
+  public: Identity AttachHeightmapShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const common::HeightmapData &_heightmapData,
+      const Pose3d &_pose,
+      const LinearVector3d &_size,
+      int _subSampling) override;
+
+  // ----- Mesh Features -----
+  public: Identity CastToMeshShape(
+      const Identity &_shapeID) const override;
+
+  public: Identity AttachMeshViewShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const mesh::TriangleMeshView &_view,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale) override;
+
+  public: Identity AttachConvexMeshShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const common::Mesh &_mesh,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale) override;
+
+  public: Identity AttachConvexDecompositionShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const common::Mesh &_mesh,
+      std::size_t _maxConvexHulls,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale) override;
+
+  public: void SetEngineCollisionMeshTriangleBudget(
+      const Identity &_engineID, std::size_t _maxTriangles) override;
+
+  public: std::size_t GetEngineCollisionMeshTriangleBudget(
+      const Identity &_engineID) const override;
+
+  public: void SetEngineCollisionMeshPrimitiveTolerance(
+      const Identity &_engineID, double _tolerance) override;
+
+  public: double GetEngineCollisionMeshPrimitiveTolerance(
+      const Identity &_engineID) const override;
+
   // ----- Sphere Features -----
   public: Identity CastToSphereShape(
       const Identity &_shapeID) const override;
@@ -132,6 +218,25 @@ class ShapeFeatures :
       const std::string &_name,
       double _radius,
       const Pose3d &_pose) override;
+
+  /// \brief Buffers backing the views returned by
+  /// GetWorldShapeBoundingBoxes.
+  private: mutable ShapeBoundingBoxStorage shapeBoundingBoxes;
+
+  /// \brief Get the world bounding box of the compound shape of a link.
+  /// \param[in] _model Model of the link.
+  /// \param[in] _link Link to get the box of.
+  /// \param[out] _box World bounding box of the link.
+  /// \return False if the link has no shapes.
+  private: bool LinkWorldBoundingBox(const ModelInfo &_model,
+      const LinkInfo &_link, AlignedBox3d &_box) const;
+
+  /// \brief Buffers backing the views returned by GetWorldLinkBoundingBoxes.
+  private: mutable BoundingBoxStorage linkBoundingBoxes;
+
+  /// \brief Buffers backing the views returned by
+  /// GetWorldModelBoundingBoxes.
+  private: mutable BoundingBoxStorage modelBoundingBoxes;
 };
 
 }
@@ -17,152 +17,2735 @@
 
 #include "SimulationFeatures.hh"
 
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionShapes/btStaticPlaneShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleCallback.h>
+#include <BulletCollision/CollisionShapes/btTriangleShape.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
+#include <BulletCollision/NarrowPhaseCollision/btPointCollector.h>
+#include <BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h>
+#include <LinearMath/btAabbUtil2.h>
+#include <LinearMath/btTransformUtil.h>
+
 #include <gz/math/eigen3/Conversions.hh>
+#include <gz/physics/AllocationCounter.hh>
+#include <gz/physics/detail/WorldStateSnapshot.hh>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 namespace gz {
 namespace physics {
 namespace bullet_featherstone {
 
+/// \brief Identifies a bullet-featherstone world state snapshot.
+static constexpr std::uint32_t kSnapshotMagic = 0x42535753;  // "SWSB"
+
+/// \brief Version of the snapshot layout.
+static constexpr std::uint32_t kSnapshotVersion = 1;
+
+using detail::AppendToSnapshot;
+using detail::ReadFromSnapshot;
+using detail::SnapshotReader;
+
+/////////////////////////////////////////////////
+static void AppendToSnapshot(
+    WorldStateSnapshotFeature::Snapshot &_snapshot, const btVector3 &_value)
+{
+  for (int i = 0; i < 3; ++i)
+    AppendToSnapshot(_snapshot, _value[i]);
+}
+
+/////////////////////////////////////////////////
+static bool ReadFromSnapshot(SnapshotReader &_reader, btVector3 &_value)
+{
+  btScalar values[3];
+  if (!ReadFromSnapshot(_reader, values, 3))
+    return false;
+  _value.setValue(values[0], values[1], values[2]);
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Append the contact data that bullet reuses in the next step to
+/// warm start the solver.
+static void AppendToSnapshot(
+    WorldStateSnapshotFeature::Snapshot &_snapshot,
+    const btManifoldPoint &_point)
+{
+  AppendToSnapshot(_snapshot, _point.m_localPointA);
+  AppendToSnapshot(_snapshot, _point.m_localPointB);
+  AppendToSnapshot(_snapshot, _point.m_positionWorldOnA);
+  AppendToSnapshot(_snapshot, _point.m_positionWorldOnB);
+  AppendToSnapshot(_snapshot, _point.m_normalWorldOnB);
+  AppendToSnapshot(_snapshot, _point.m_lateralFrictionDir1);
+  AppendToSnapshot(_snapshot, _point.m_lateralFrictionDir2);
+  for (const btScalar value : {
+      _point.m_distance1, _point.m_combinedFriction,
+      _point.m_combinedRollingFriction, _point.m_combinedSpinningFriction,
+      _point.m_combinedRestitution, _point.m_appliedImpulse,
+      _point.m_prevRHS, _point.m_appliedImpulseLateral1,
+      _point.m_appliedImpulseLateral2, _point.m_contactMotion1,
+      _point.m_contactMotion2, _point.m_contactCFM, _point.m_contactERP,
+      _point.m_frictionCFM})
+  {
+    AppendToSnapshot(_snapshot, value);
+  }
+  for (const int value : {
+      _point.m_partId0, _point.m_partId1, _point.m_index0, _point.m_index1,
+      _point.m_contactPointFlags, _point.m_lifeTime})
+  {
+    AppendToSnapshot(_snapshot, static_cast<std::int32_t>(value));
+  }
+}
+
+/////////////////////////////////////////////////
+static bool ReadFromSnapshot(SnapshotReader &_reader, btManifoldPoint &_point)
+{
+  bool ok = ReadFromSnapshot(_reader, _point.m_localPointA) &&
+            ReadFromSnapshot(_reader, _point.m_localPointB) &&
+            ReadFromSnapshot(_reader, _point.m_positionWorldOnA) &&
+            ReadFromSnapshot(_reader, _point.m_positionWorldOnB) &&
+            ReadFromSnapshot(_reader, _point.m_normalWorldOnB) &&
+            ReadFromSnapshot(_reader, _point.m_lateralFrictionDir1) &&
+            ReadFromSnapshot(_reader, _point.m_lateralFrictionDir2);
+  for (btScalar *value : {
+      &_point.m_distance1, &_point.m_combinedFriction,
+      &_point.m_combinedRollingFriction, &_point.m_combinedSpinningFriction,
+      &_point.m_combinedRestitution, &_point.m_appliedImpulse,
+      &_point.m_prevRHS, &_point.m_appliedImpulseLateral1,
+      &_point.m_appliedImpulseLateral2, &_point.m_contactMotion1,
+      &_point.m_contactMotion2, &_point.m_contactCFM, &_point.m_contactERP,
+      &_point.m_frictionCFM})
+  {
+    ok = ok && ReadFromSnapshot(_reader, *value);
+  }
+  for (int *value : {
+      &_point.m_partId0, &_point.m_partId1, &_point.m_index0,
+      &_point.m_index1, &_point.m_contactPointFlags, &_point.m_lifeTime})
+  {
+    std::int32_t stored = 0;
+    ok = ok && ReadFromSnapshot(_reader, stored);
+    *value = stored;
+  }
+  _point.m_userPersistentData = nullptr;
+  return ok;
+}
+
 /////////////////////////////////////////////////
 void SimulationFeatures::WorldForwardStep(
     const Identity &_worldID,
     ForwardStep::Output & _h,
-    ForwardStep::State & /*_x*/,
+    ForwardStep::State & _x,
     const ForwardStep::Input & _u)
 {
+  // Other worlds may be stepped at the same time, see
+  // ConcurrentWorldStepFeature, so only the integration of this world runs
+  // without stepMutex.
+  std::shared_lock<std::shared_mutex> changeLock(this->entityChangeMutex);
+  std::unique_lock<std::mutex> lock(this->stepMutex);
+
+  this->InvalidateFrameData();
   const auto worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  this->UpdateStepSize(_u);
+
+  auto *stateSnapshot = _x.Query<WorldStateSnapshot>();
+  Snapshot liveState;
+  if (!detail::BeginSnapshotStep(*this, _worldID, stateSnapshot, liveState))
+    return;
+
+  // Links of other worlds may be moving on other threads
+  this->filterWrittenLinks = this->worlds.size() > 1u;
+  this->writeWorldID = _worldID.id;
+
+  this->IntegrateKinematicModels({_worldID.id});
+  this->ApplyForceFields({_worldID.id});
+  this->RecordPreStepVelocities(_h);
+  this->filterWrittenLinks = false;
+
+  const std::size_t numThreads = this->StepThreads(*worldInfo);
+  const auto stepSize = static_cast<btScalar>(this->stepSize);
+  lock.unlock();
+  StepBulletWorldWithThreads(
+      *worldInfo, stepSize, numThreads, this->taskScheduler);
+  lock.lock();
+  this->InvalidateFrameData();
+
+  this->filterWrittenLinks = this->worlds.size() > 1u;
+  this->writeWorldID = _worldID.id;
+  const auto writeStart = std::chrono::steady_clock::now();
+  const std::size_t writeAllocations = AllocationCount();
+  this->WriteRequiredData(_h);
+  this->Write(_h.Get<ChangedWorldPoses>());
+  this->WriteTwists(_h);
+  this->WriteAccelerations(_h);
+  this->WriteJointStates(_h);
+  worldInfo->poseWriteTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - writeStart).count();
+  worldInfo->poseWriteAllocations = AllocationCount() - writeAllocations;
+  this->filterWrittenLinks = false;
+  this->ExportSharedState(_worldID.id);
+
+  detail::EndSnapshotStep(*this, _worldID, stateSnapshot, liveState);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::StepEngineWorlds(
+    const Identity &/*_engineID*/,
+    const std::size_t *_worldIDs,
+    std::size_t _count,
+    ForwardStep::Output &_h,
+    ForwardStep::State &/*_x*/,
+    const ForwardStep::Input &_u,
+    std::size_t _numThreads)
+{
+  this->InvalidateFrameData();
+  this->UpdateStepSize(_u);
+
+  std::vector<WorldInfo *> stepWorlds;
+  std::unordered_set<std::size_t> stepWorldIDs;
+  stepWorlds.reserve(_count);
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const auto it = this->worlds.find(_worldIDs[i]);
+    if (it == this->worlds.end() || !stepWorldIDs.insert(_worldIDs[i]).second)
+    {
+      gzerr << "Entity [" << _worldIDs[i] << "] is not a world, or is given "
+            << "more than once. It will not be stepped\n";
+      continue;
+    }
+    stepWorlds.push_back(it->second.get());
+  }
+
+  std::size_t numThreads = _numThreads;
+  if (numThreads == 0)
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  numThreads = std::min(numThreads, stepWorlds.size());
+
+  this->IntegrateKinematicModels(stepWorldIDs);
+  this->ApplyForceFields(stepWorldIDs);
+  this->RecordPreStepVelocities(_h);
+
+  const auto stepSize = static_cast<btScalar>(this->stepSize);
+  if (numThreads <= 1u)
+  {
+    for (auto *worldInfo : stepWorlds)
+    {
+      StepBulletWorldWithThreads(*worldInfo, stepSize,
+          this->StepThreads(*worldInfo), this->taskScheduler);
+    }
+  }
+  else
+  {
+    // The bullet task scheduler is global, so the worlds are parallelized
+    // here instead and each of them is stepped on a single thread.
+    this->RunTasks(this->stepWorldsPool, this->stepWorldsPoolThreads,
+        numThreads, stepWorlds.size(), [&stepWorlds, stepSize](std::size_t _i)
+    {
+      StepBulletWorldWithThreads(*stepWorlds[_i], stepSize, 1u);
+    });
+  }
+  this->InvalidateFrameData();
+
+  const auto writeStart = std::chrono::steady_clock::now();
+  const std::size_t writeAllocations = AllocationCount();
+  this->WriteRequiredData(_h);
+  this->Write(_h.Get<ChangedWorldPoses>());
+  this->WriteTwists(_h);
+  this->WriteAccelerations(_h);
+  this->WriteJointStates(_h);
+  const double poseWriteTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - writeStart).count();
+  const std::size_t poseWriteAllocations =
+      AllocationCount() - writeAllocations;
+  for (auto *worldInfo : stepWorlds)
+  {
+    worldInfo->poseWriteTime = poseWriteTime;
+    worldInfo->poseWriteAllocations = poseWriteAllocations;
+  }
+  for (const std::size_t worldID : stepWorldIDs)
+    this->ExportSharedState(worldID);
+}
+
+/////////////////////////////////////////////////
+std::shared_mutex &SimulationFeatures::EngineEntityChangeMutex(
+    const Identity &/*_engineID*/)
+{
+  return this->entityChangeMutex;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldSharedStateExport(
+    const Identity &_worldID,
+    std::shared_ptr<SharedStateRingWriter> _writer)
+{
+  if (_writer)
+    this->sharedStateExports[_worldID.id] = std::move(_writer);
+  else
+    this->sharedStateExports.erase(_worldID.id);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::ExportSharedState(std::size_t _worldID) const
+{
+  const auto it = this->sharedStateExports.find(_worldID);
+  if (it == this->sharedStateExports.end())
+    return;
+
+  SharedStateRingWriter &writer = *it->second;
+  const auto &worldInfo = this->worlds.at(_worldID);
+  if (!writer.BeginFrame(worldInfo->time))
+    return;
+
+  for (const auto &[id, info] : this->links)
+  {
+    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+    if (model->world.id != _worldID)
+      continue;
+
+    writer.AddPose(id, gz::math::eigen3::convert(
+        this->LinkWorldTransform(*model, *info)));
+  }
+
+  for (const auto &[id, info] : this->joints)
+  {
+    const auto *identifier = std::get_if<InternalJoint>(&info->identifier);
+    if (!identifier)
+      continue;
+
+    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+    if (model->world.id != _worldID)
+      continue;
+
+    // Bullet does not give the accelerations of the joints
+    const btMultiBody &body = *model->body;
+    const int index = identifier->indexInBtModel;
+    const auto numDofs =
+        static_cast<std::size_t>(body.getLink(index).m_dofCount);
+    for (std::size_t d = 0; d < numDofs; ++d)
+    {
+      writer.AddJointState(id, d, body.getJointPosMultiDof(index)[d],
+          body.getJointVelMultiDof(index)[d], gz::math::NAN_D,
+          body.getJointTorqueMultiDof(index)[d]);
+    }
+  }
+
+  const auto contacts = this->GetContactBatchFromLastStep(
+      this->GenerateIdentity(_worldID, worldInfo));
+  for (std::size_t i = 0; i < contacts.size; ++i)
+  {
+    SharedStateContact contact;
+    contact.collision1 = contacts.collision1[i];
+    contact.collision2 = contacts.collision2[i];
+    contact.point = gz::math::eigen3::convert(contacts.point[i]);
+    contact.normal = gz::math::eigen3::convert(contacts.normal[i]);
+    contact.depth = contacts.depth[i];
+    contact.force = gz::math::eigen3::convert(contacts.force[i]);
+    writer.AddContact(contact);
+  }
+
+  writer.EndFrame();
+}
+
+/////////////////////////////////////////////////
+std::shared_future<void> SimulationFeatures::StartWorldStep(
+    const Identity &_worldID,
+    const ForwardStep::Input &_u)
+{
+  return this->asyncSteppers.Start(_worldID, _u);
+}
+
+/////////////////////////////////////////////////
+const ForwardStep::Output &SimulationFeatures::FinishWorldStep(
+    const Identity &_worldID)
+{
+  return this->asyncSteppers.Finish(_worldID);
+}
+
+/////////////////////////////////////////////////
+double SimulationFeatures::LastStepSize(const ModelInfo &_model) const
+{
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_model.world);
+  if (worldInfo && worldInfo->lastStepSize > 0.0)
+    return worldInfo->lastStepSize;
+  return this->stepSize;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::UpdateStepSize(const ForwardStep::Input &_u)
+{
   auto *dtDur =
     _u.Query<std::chrono::steady_clock::duration>();
   if (dtDur)
   {
     std::chrono::duration<double> dt = *dtDur;
-    stepSize = dt.count();
+    this->stepSize = dt.count();
   }
+}
 
-  worldInfo->world->stepSimulation(static_cast<btScalar>(this->stepSize), 1,
-                                   static_cast<btScalar>(this->stepSize));
+/////////////////////////////////////////////////
+SimulationFeatures::StepStatistics SimulationFeatures::GetWorldStepStatistics(
+    const Identity &_worldID) const
+{
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  StepStatistics stats = worldInfo->world->GetStepStatistics();
+  stats.poseWriteTime = worldInfo->poseWriteTime;
+  stats.stepTime += worldInfo->poseWriteTime;
+  stats.poseWriteAllocations = worldInfo->poseWriteAllocations;
+  stats.stepAllocations += worldInfo->poseWriteAllocations;
+  return stats;
+}
 
-  this->WriteRequiredData(_h);
-  this->Write(_h.Get<ChangedWorldPoses>());
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldModelStepStatisticsEnabled(
+    const Identity &_worldID, bool _enable)
+{
+  auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  worldInfo->world->SetMultiBodyStatisticsEnabled(_enable);
 }
 
 /////////////////////////////////////////////////
-std::vector<SimulationFeatures::ContactInternal>
-SimulationFeatures::GetContactsFromLastStep(const Identity &_worldID) const
+std::vector<SimulationFeatures::ModelStepStatistics>
+SimulationFeatures::GetWorldModelStepStatistics(
+    const Identity &_worldID) const
 {
-  std::vector<SimulationFeatures::ContactInternal> outContacts;
-  auto *const world = this->ReferenceInterface<WorldInfo>(_worldID);
-  if (!world)
+  // A model and its nested models share one multibody, whose user index is
+  // the entity ID of the model, so nested models are counted in it
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  const auto &multiBodies = worldInfo->world->GetMultiBodyStatistics();
+  std::vector<ModelStepStatistics> result;
+  result.reserve(multiBodies.size());
+  for (const auto &[index, stats] : multiBodies)
   {
-    return outContacts;
+    ModelStepStatistics model;
+    model.model = static_cast<std::size_t>(index);
+    model.candidatePairCount = stats.candidatePairCount;
+    model.narrowphaseTime = stats.narrowphaseTime;
+    model.contactCount = stats.contactCount;
+    model.constraintRowCount = stats.constraintRowCount;
+    result.push_back(model);
   }
+  return result;
+}
 
-  int numManifolds = world->world->getDispatcher()->getNumManifolds();
-  for (int i = 0; i < numManifolds; i++)
+/////////////////////////////////////////////////
+/// \brief Get the bytes allocated by a bullet array.
+template <typename T>
+static std::size_t ArrayBytes(const btAlignedObjectArray<T> &_array)
+{
+  return static_cast<std::size_t>(_array.capacity()) * sizeof(T);
+}
+
+/////////////////////////////////////////////////
+/// \brief Gives access to the scratch pools of the constraint solver, which
+/// are protected members.
+class SolverPoolAccess : public btMultiBodyConstraintSolver
+{
+  /// \brief Estimate the memory used by the scratch pools of a solver.
+  /// \param[in] _solver Constraint solver of a world.
+  /// \return Bytes used.
+  public: static std::size_t Bytes(const btMultiBodyConstraintSolver &_solver)
   {
-    btPersistentManifold* contactManifold =
-      world->world->getDispatcher()->getManifoldByIndexInternal(i);
-    const btMultiBodyLinkCollider* obA =
-      dynamic_cast<const btMultiBodyLinkCollider*>(contactManifold->getBody0());
-    const btMultiBodyLinkCollider* obB =
-      dynamic_cast<const btMultiBodyLinkCollider*>(contactManifold->getBody1());
-    std::size_t collision1ID = std::numeric_limits<std::size_t>::max();
-    std::size_t collision2ID = std::numeric_limits<std::size_t>::max();
+    using S = SolverPoolAccess;
+    const auto &data = _solver.*&S::m_data;
+    return ArrayBytes(_solver.*&S::m_tmpSolverBodyPool) +
+        ArrayBytes(_solver.*&S::m_tmpSolverContactConstraintPool) +
+        ArrayBytes(_solver.*&S::m_tmpSolverNonContactConstraintPool) +
+        ArrayBytes(_solver.*&S::m_tmpSolverContactFrictionConstraintPool) +
+        ArrayBytes(_solver.*&S::m_multiBodyNonContactConstraints) +
+        ArrayBytes(_solver.*&S::m_multiBodyNormalContactConstraints) +
+        ArrayBytes(_solver.*&S::m_multiBodyFrictionContactConstraints) +
+        ArrayBytes(data.m_jacobians) +
+        ArrayBytes(data.m_deltaVelocitiesUnitImpulse) +
+        ArrayBytes(data.m_deltaVelocities);
+  }
+};
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::ShapeBytes(
+    const btCollisionShape *_shape,
+    std::unordered_set<const void *> &_counted) const
+{
+  if (!_shape || !_counted.insert(_shape).second)
+    return 0u;
+
+  // Bytes of a triangle mesh, unless its arrays belong to a mesh view
+  auto meshBytes = [&](const btStridingMeshInterface *_mesh) -> std::size_t
+  {
+    const auto *array = dynamic_cast<const btTriangleIndexVertexArray *>(_mesh);
+    if (!array || !_counted.insert(array).second)
+      return 0u;
+    for (const auto &view : this->meshViewArrays)
+    {
+      if (view.get() == array)
+        return sizeof(*array);
+    }
+    std::size_t bytes = sizeof(btTriangleMesh);
+    const auto &parts = array->getIndexedMeshArray();
+    for (int i = 0; i < parts.size(); ++i)
+    {
+      bytes += static_cast<std::size_t>(parts[i].m_numTriangles) *
+          parts[i].m_triangleIndexStride +
+          static_cast<std::size_t>(parts[i].m_numVertices) *
+          parts[i].m_vertexStride;
+    }
+    return bytes;
+  };
 
-    for (const auto & link : this->links)
+  switch (_shape->getShapeType())
+  {
+    case BOX_SHAPE_PROXYTYPE:
+      return sizeof(btBoxShape);
+    case SPHERE_SHAPE_PROXYTYPE:
+      return sizeof(btSphereShape);
+    case CAPSULE_SHAPE_PROXYTYPE:
+      return sizeof(btCapsuleShape);
+    case CYLINDER_SHAPE_PROXYTYPE:
+      return sizeof(btCylinderShape);
+    case STATIC_PLANE_PROXYTYPE:
+      return sizeof(btStaticPlaneShape);
+    case MULTI_SPHERE_SHAPE_PROXYTYPE:
     {
-      if (obA == link.second->collider.get())
+      const auto *multi = static_cast<const btMultiSphereShape *>(_shape);
+      return sizeof(*multi) + static_cast<std::size_t>(
+          multi->getSphereCount()) * (sizeof(btVector3) + sizeof(btScalar));
+    }
+    case CONVEX_HULL_SHAPE_PROXYTYPE:
+    {
+      const auto *hull = static_cast<const btConvexHullShape *>(_shape);
+      return sizeof(*hull) +
+          static_cast<std::size_t>(hull->getNumPoints()) * sizeof(btVector3);
+    }
+    case TRIANGLE_MESH_SHAPE_PROXYTYPE:
+    {
+      const auto *mesh = static_cast<const btBvhTriangleMeshShape *>(_shape);
+      std::size_t bytes = sizeof(*mesh) + meshBytes(mesh->getMeshInterface());
+      // getOptimizedBvh has no const overload
+      const auto *bvh =
+          const_cast<btBvhTriangleMeshShape *>(mesh)->getOptimizedBvh();
+      if (bvh && _counted.insert(bvh).second)
+        bytes += bvh->calculateSerializeBufferSize();
+      return bytes;
+    }
+    case GIMPACT_SHAPE_PROXYTYPE:
+    {
+      const auto *mesh = static_cast<const btGImpactMeshShape *>(_shape);
+      std::size_t bytes = sizeof(*mesh) + meshBytes(mesh->getMeshInterface());
+      for (int i = 0; i < mesh->getMeshPartCount(); ++i)
       {
-        for (const auto &v : link.second->collisionNameToEntityId)
-        {
-          collision1ID = v.second;
-        }
+        // Each part keeps a box tree with about two nodes per triangle
+        bytes += sizeof(btGImpactMeshShapePart) + 2u *
+            static_cast<std::size_t>(
+                mesh->getMeshPart(i)->getNumChildShapes()) *
+            sizeof(GIM_BVH_TREE_NODE);
       }
-      if (obB == link.second->collider.get())
+      return bytes;
+    }
+    case TERRAIN_SHAPE_PROXYTYPE:
+    {
+      for (const auto &[key, heightfield] : this->heightfieldCache)
       {
-        for (const auto &v : link.second->collisionNameToEntityId)
+        if (heightfield->shape.get() == _shape)
         {
-          collision2ID = v.second;
+          return sizeof(btHeightfieldTerrainShape) +
+              heightfield->heights.capacity() * sizeof(float);
         }
       }
+      return sizeof(btHeightfieldTerrainShape);
     }
-    int numContacts = contactManifold->getNumContacts();
-    for (int j = 0; j < numContacts; j++)
+    case COMPOUND_SHAPE_PROXYTYPE:
     {
-      btManifoldPoint& pt = contactManifold->getContactPoint(j);
-      CompositeData extraData;
-
-      // Add normal, depth and wrench to extraData.
-      auto& extraContactData =
-        extraData.Get<SimulationFeatures::ExtraContactData>();
-      extraContactData.force =
-        convert(btVector3(pt.m_appliedImpulse,
-                          pt.m_appliedImpulse,
-                          pt.m_appliedImpulse));
-      extraContactData.normal = convert(pt.m_normalWorldOnB);
-      extraContactData.depth = pt.getDistance();
-
-      outContacts.push_back(SimulationFeatures::ContactInternal {
-        this->GenerateIdentity(collision1ID, this->collisions.at(collision1ID)),
-        this->GenerateIdentity(collision2ID, this->collisions.at(collision2ID)),
-        convert(pt.getPositionWorldOnA()), extraData});
+      const auto *compound = static_cast<const btCompoundShape *>(_shape);
+      const auto children =
+          static_cast<std::size_t>(compound->getNumChildShapes());
+      std::size_t bytes = sizeof(*compound) +
+          children * sizeof(btCompoundShapeChild);
+      if (compound->getDynamicAabbTree())
+        bytes += 2u * children * sizeof(btDbvtNode);
+      for (int i = 0; i < compound->getNumChildShapes(); ++i)
+        bytes += this->ShapeBytes(compound->getChildShape(i), _counted);
+      return bytes;
+    }
+    default:
+      return sizeof(btCollisionShape);
+  }
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::MemoryUsage SimulationFeatures::GetWorldMemoryUsage(
+    const Identity &_worldID) const
+{
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+
+  MemoryUsage usage;
+  usage.entityBytes = sizeof(WorldInfo) + sizeof(GzMultiBodyDynamicsWorld);
+  std::unordered_set<const void *> counted;
+  if (const auto &baked = worldInfo->bakedStatic)
+  {
+    usage.entityBytes += sizeof(BakedStaticCollisions) +
+        sizeof(btCollisionObject) +
+        baked->childIndexToCollisionEntityId.size() *
+        (sizeof(std::size_t) + sizeof(std::pair<std::size_t, int>));
+    usage.geometryBytes += this->ShapeBytes(baked->shape.get(), counted);
+  }
+  for (const auto &[modelID, model] : this->models)
+  {
+    if (model->world.id != _worldID.id)
+      continue;
+
+    usage.entityBytes += sizeof(ModelInfo);
+    if (model->body && counted.insert(model->body.get()).second)
+    {
+      usage.entityBytes += sizeof(btMultiBody) +
+          static_cast<std::size_t>(model->body->getNumLinks()) *
+          sizeof(btMultibodyLink);
+    }
+    usage.entityBytes += model->jointEntityIds.size() * sizeof(JointInfo);
+
+    for (const std::size_t linkID : model->linkEntityIds)
+    {
+      const auto linkIt = this->links.find(linkID);
+      if (linkIt == this->links.end())
+        continue;
+      const auto &link = linkIt->second;
+      usage.entityBytes += sizeof(LinkInfo) +
+          (link->collider ? sizeof(btMultiBodyLinkCollider) : 0u);
+      usage.geometryBytes += this->ShapeBytes(link->shape.get(), counted);
+
+      for (const std::size_t collisionID : link->collisionEntityIds)
+      {
+        const auto collisionIt = this->collisions.find(collisionID);
+        if (collisionIt == this->collisions.end())
+          continue;
+        usage.entityBytes += sizeof(CollisionInfo);
+        usage.geometryBytes += this->ShapeBytes(
+            collisionIt->second->collider.get(), counted);
       }
+    }
   }
-  return outContacts;
+
+  // The dispatcher does not give const access to its manifolds.
+  auto *dispatcher = worldInfo->world->getDispatcher();
+  usage.solverBytes = SolverPoolAccess::Bytes(*worldInfo->solver) +
+      static_cast<std::size_t>(dispatcher->getNumManifolds()) *
+      sizeof(btPersistentManifold) +
+      static_cast<std::size_t>(worldInfo->broadphase->getOverlappingPairCache()
+          ->getNumOverlappingPairs()) * sizeof(btBroadphasePair);
+  return usage;
 }
 
 /////////////////////////////////////////////////
-void SimulationFeatures::Write(WorldPoses &_worldPoses) const
+WorldStateSnapshotFeature::Snapshot SimulationFeatures::GetWorldStateSnapshot(
+    const Identity &_worldID) const
 {
-  // remove link poses from the previous iteration
-  _worldPoses.entries.clear();
-  _worldPoses.entries.reserve(this->links.size());
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  const auto &world = *worldInfo->world;
+  // The dispatcher does not give const access to its manifolds.
+  auto *dispatcher = worldInfo->world->getDispatcher();
 
-  for (const auto &[id, info] : this->links)
+  Snapshot snapshot;
+  AppendToSnapshot(snapshot, kSnapshotMagic);
+  AppendToSnapshot(snapshot, kSnapshotVersion);
+
+  // State of every multibody
+  AppendToSnapshot(
+      snapshot, static_cast<std::uint64_t>(world.getNumMultibodies()));
+  for (int i = 0; i < world.getNumMultibodies(); ++i)
   {
-    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
-    WorldPose wp;
-    wp.pose = gz::math::eigen3::convert(GetWorldTransformOfLink(*model, *info));
-    wp.body = id;
-    _worldPoses.entries.push_back(wp);
+    const auto *body = world.getMultiBody(i);
+    AppendToSnapshot(snapshot, static_cast<std::uint64_t>(body->getNumLinks()));
+    AppendToSnapshot(snapshot, static_cast<std::uint8_t>(body->isAwake()));
+    AppendToSnapshot(snapshot, body->getBasePos());
+    const btQuaternion &rot = body->getWorldToBaseRot();
+    for (const btScalar value : {rot.x(), rot.y(), rot.z(), rot.w()})
+      AppendToSnapshot(snapshot, value);
+    AppendToSnapshot(snapshot, body->getBaseVel());
+    AppendToSnapshot(snapshot, body->getBaseOmega());
+
+    for (int j = 0; j < body->getNumLinks(); ++j)
+    {
+      const auto &link = body->getLink(j);
+      const btScalar *pos = body->getJointPosMultiDof(j);
+      const btScalar *vel = body->getJointVelMultiDof(j);
+      for (int k = 0; k < link.m_posVarCount; ++k)
+        AppendToSnapshot(snapshot, pos[k]);
+      for (int k = 0; k < link.m_dofCount; ++k)
+        AppendToSnapshot(snapshot, vel[k]);
+    }
+  }
+
+  // Contact manifolds, which hold the impulses bullet uses to warm start the
+  // solver. Their colliders are identified by their index in the world.
+  AppendToSnapshot(
+      snapshot, static_cast<std::uint64_t>(dispatcher->getNumManifolds()));
+  for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+  {
+    const auto *manifold = dispatcher->getManifoldByIndexInternal(i);
+    AppendToSnapshot(snapshot, static_cast<std::int32_t>(
+        manifold->getBody0()->getWorldArrayIndex()));
+    AppendToSnapshot(snapshot, static_cast<std::int32_t>(
+        manifold->getBody1()->getWorldArrayIndex()));
+    AppendToSnapshot(
+        snapshot, static_cast<std::int32_t>(manifold->getNumContacts()));
+    for (int j = 0; j < manifold->getNumContacts(); ++j)
+      AppendToSnapshot(snapshot, manifold->getContactPoint(j));
   }
+
+  return snapshot;
 }
+
 /////////////////////////////////////////////////
-void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
+bool SimulationFeatures::SetWorldStateSnapshot(
+    const Identity &_worldID, const Snapshot &_snapshot)
 {
-  // remove link poses from the previous iteration
-  _changedPoses.entries.clear();
-  _changedPoses.entries.reserve(this->links.size());
+  auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  auto &world = *worldInfo->world;
+  auto *dispatcher = world.getDispatcher();
+  SnapshotReader reader(_snapshot);
+
+  auto fail = [&]()
+  {
+    gzerr << "Snapshot does not match the state of world [" << worldInfo->name
+          << "]\n";
+    return false;
+  };
 
-  std::unordered_map<std::size_t, math::Pose3d> newPoses;
+  std::uint32_t magic = 0;
+  std::uint32_t version = 0;
+  std::uint64_t numBodies = 0;
+  if (!ReadFromSnapshot(reader, magic) || magic != kSnapshotMagic ||
+      !ReadFromSnapshot(reader, version) || version != kSnapshotVersion ||
+      !ReadFromSnapshot(reader, numBodies) ||
+      numBodies != static_cast<std::uint64_t>(world.getNumMultibodies()))
+  {
+    return fail();
+  }
 
-  for (const auto &[id, info] : this->links)
+  struct BodyState
   {
-    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
-    WorldPose wp;
-    wp.pose = gz::math::eigen3::convert(GetWorldTransformOfLink(*model, *info));
-    wp.body = id;
+    bool awake = true;
+    btVector3 basePos;
+    btQuaternion worldToBaseRot;
+    btVector3 baseVel;
+    btVector3 baseOmega;
+    std::vector<btScalar> jointValues;
+  };
+  std::vector<BodyState> bodies(numBodies);
+  for (std::size_t i = 0; i < numBodies; ++i)
+  {
+    const auto *body = world.getMultiBody(static_cast<int>(i));
+    auto &state = bodies[i];
+
+    std::uint64_t numLinks = 0;
+    std::uint8_t awake = 0;
+    btScalar rot[4];
+    if (!ReadFromSnapshot(reader, numLinks) ||
+        numLinks != static_cast<std::uint64_t>(body->getNumLinks()) ||
+        !ReadFromSnapshot(reader, awake) ||
+        !ReadFromSnapshot(reader, state.basePos) ||
+        !ReadFromSnapshot(reader, rot, 4) ||
+        !ReadFromSnapshot(reader, state.baseVel) ||
+        !ReadFromSnapshot(reader, state.baseOmega))
+    {
+      return fail();
+    }
+    state.awake = awake != 0;
+    state.worldToBaseRot.setValue(rot[0], rot[1], rot[2], rot[3]);
+
+    for (int j = 0; j < body->getNumLinks(); ++j)
+    {
+      const auto &link = body->getLink(j);
+      for (int k = 0; k < link.m_posVarCount + link.m_dofCount; ++k)
+      {
+        btScalar value;
+        if (!ReadFromSnapshot(reader, value))
+          return fail();
+        state.jointValues.push_back(value);
+      }
+    }
+  }
+
+  std::uint64_t numManifolds = 0;
+  if (!ReadFromSnapshot(reader, numManifolds))
+    return fail();
+
+  struct ManifoldState
+  {
+    std::pair<int, int> bodies;
+    std::vector<btManifoldPoint> points;
+  };
+  std::vector<ManifoldState> manifolds(numManifolds);
+  for (auto &manifold : manifolds)
+  {
+    std::int32_t body0 = 0;
+    std::int32_t body1 = 0;
+    std::int32_t numContacts = 0;
+    if (!ReadFromSnapshot(reader, body0) || !ReadFromSnapshot(reader, body1) ||
+        !ReadFromSnapshot(reader, numContacts) || numContacts < 0 ||
+        numContacts > MANIFOLD_CACHE_SIZE)
+    {
+      return fail();
+    }
+    manifold.bodies = {body0, body1};
+    manifold.points.resize(static_cast<std::size_t>(numContacts));
+    for (auto &point : manifold.points)
+    {
+      if (!ReadFromSnapshot(reader, point))
+        return fail();
+    }
+  }
+
+  if (!reader.AtEnd())
+    return fail();
+
+  this->InvalidateFrameData();
 
-    auto iter = this->prevLinkPoses.find(id);
-    if ((iter == this->prevLinkPoses.end()) ||
-        !iter->second.Pos().Equal(wp.pose.Pos(), 1e-6) ||
-        !iter->second.Rot().Equal(wp.pose.Rot(), 1e-6))
+  btAlignedObjectArray<btQuaternion> worldToLocal;
+  btAlignedObjectArray<btVector3> localOrigin;
+  for (std::size_t i = 0; i < numBodies; ++i)
+  {
+    auto *body = world.getMultiBody(static_cast<int>(i));
+    const auto &state = bodies[i];
+    body->setBasePos(state.basePos);
+    body->setWorldToBaseRot(state.worldToBaseRot);
+    body->setBaseVel(state.baseVel);
+    body->setBaseOmega(state.baseOmega);
+
+    std::size_t offset = 0;
+    for (int j = 0; j < body->getNumLinks(); ++j)
     {
-      _changedPoses.entries.push_back(wp);
-      newPoses[id] = wp.pose;
+      const auto &link = body->getLink(j);
+      btScalar *pos = body->getJointPosMultiDof(j);
+      btScalar *vel = body->getJointVelMultiDof(j);
+      for (int k = 0; k < link.m_posVarCount; ++k)
+        pos[k] = state.jointValues[offset++];
+      for (int k = 0; k < link.m_dofCount; ++k)
+        vel[k] = state.jointValues[offset++];
     }
+
+    // Update the link frames and colliders, which bullet otherwise only
+    // refreshes while stepping.
+    body->forwardKinematics(worldToLocal, localOrigin);
+    body->updateCollisionObjectWorldTransforms(worldToLocal, localOrigin);
+
+    if (state.awake)
+      body->wakeUp();
     else
-      newPoses[id] = iter->second;
+      body->goToSleep();
+  }
+
+  // Restore the contacts of the manifolds that exist for the same pairs of
+  // colliders. Manifolds of other pairs are rebuilt by the next step, and the
+  // contacts they currently hold belong to a state that no longer applies.
+  std::map<std::pair<int, int>, btPersistentManifold *> manifoldOfPair;
+  for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+  {
+    auto *manifold = dispatcher->getManifoldByIndexInternal(i);
+    manifold->clearManifold();
+    manifoldOfPair[{manifold->getBody0()->getWorldArrayIndex(),
+                    manifold->getBody1()->getWorldArrayIndex()}] = manifold;
+  }
+  for (const auto &saved : manifolds)
+  {
+    auto it = manifoldOfPair.find(saved.bodies);
+    if (it == manifoldOfPair.end())
+      continue;
+    for (const auto &point : saved.points)
+      it->second->addManifoldPoint(point);
+  }
+
+  // The poses of sleeping bodies are not compared when writing changed
+  // poses, so report the links of the bodies restored asleep again.
+  for (const auto &[id, info] : this->links)
+  {
+    const auto *model = this->ReferenceInterface<ModelInfo>(info->model);
+    if (model->body && !model->body->isAwake())
+      info->hasReportedPose = false;
   }
 
-  // Save the new poses so that they can be used to check for updates in the
-  // next iteration. Re-setting this->prevLinkPoses with the contents of
-  // newPoses ensures that we aren't caching data for links that were removed
-  this->prevLinkPoses = std::move(newPoses);
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the baked static collisions of a world, if a collider is their
+/// collider.
+/// \param[in] _world World of the collider.
+/// \param[in] _collider Collision object reported by bullet.
+/// \return The baked static collisions, or nullptr if _collider is not
+/// theirs.
+static const BakedStaticCollisions *BakedCollisionsOf(
+    const WorldInfo &_world, const btCollisionObject *_collider)
+{
+  if (_world.bakedStatic && _world.bakedStatic->collider.get() == _collider)
+    return _world.bakedStatic.get();
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+template <typename F>
+void SimulationFeatures::ForEachContact(
+    const WorldInfo &_world, const ContactFilter *_filter, F &&_func) const
+{
+  const double stepSize =
+      _world.lastStepSize > 0.0 ? _world.lastStepSize : this->stepSize;
+  int numManifolds = _world.world->getDispatcher()->getNumManifolds();
+  for (int i = 0; i < numManifolds; i++)
+  {
+    btPersistentManifold* contactManifold =
+      _world.world->getDispatcher()->getManifoldByIndexInternal(i);
+    // Colliders store the entity ID of their link in their user index, see
+    // SDFFeatures::AddSdfCollision. The baked static collider of the world
+    // belongs to no link, and its points belong to the links of their
+    // collisions.
+    const btCollisionObject *body0 = contactManifold->getBody0();
+    const btCollisionObject *body1 = contactManifold->getBody1();
+    const LinkInfo *link1 = this->FindLinkOfCollider(body0);
+    const LinkInfo *link2 = this->FindLinkOfCollider(body1);
+    const BakedStaticCollisions *baked1 =
+      link1 ? nullptr : BakedCollisionsOf(_world, body0);
+    const BakedStaticCollisions *baked2 =
+      link2 ? nullptr : BakedCollisionsOf(_world, body1);
+    if ((!link1 && !baked1) || (!link2 && !baked2))
+      continue;
+
+    // All points of a manifold are between the same two links, so if one of
+    // the links or their models is filtered for, they all pass.
+    auto linkPasses = [_filter](const btCollisionObject *_collider,
+                                const LinkInfo *_link)
+    {
+      return _link && (_filter->Contains(
+                 static_cast<std::size_t>(_collider->getUserIndex())) ||
+             _filter->Contains(_link->model.id));
+    };
+    const bool manifoldPasses = !_filter ||
+      linkPasses(body0, link1) || linkPasses(body1, link2);
+
+    auto collisionPasses = [this, _filter](std::size_t _collisionID,
+                                           bool _baked)
+    {
+      if (_filter->Contains(_collisionID))
+        return true;
+      if (!_baked)
+        return false;
+      const Identity &link = this->collisions.at(_collisionID)->link;
+      return _filter->Contains(link.id) ||
+             _filter->Contains(this->links.at(link.id)->model.id);
+    };
+
+    int numContacts = contactManifold->getNumContacts();
+    for (int j = 0; j < numContacts; j++)
+    {
+      btManifoldPoint& pt = contactManifold->getContactPoint(j);
+
+      // Each contact point records the child of the link's compound shape
+      // that it belongs to.
+      const std::size_t collision1ID =
+        this->FindCollisionOfChild(link1, baked1, pt.m_index0);
+      const std::size_t collision2ID =
+        this->FindCollisionOfChild(link2, baked2, pt.m_index1);
+      if (collision1ID == std::numeric_limits<std::size_t>::max() ||
+          collision2ID == std::numeric_limits<std::size_t>::max())
+      {
+        continue;
+      }
+      if (!manifoldPasses &&
+          !collisionPasses(collision1ID, baked1 != nullptr) &&
+          !collisionPasses(collision2ID, baked2 != nullptr))
+      {
+        continue;
+      }
+
+      // The solver stores the impulses it applied to the first body along the
+      // contact normal and the two friction directions. Dividing them by the
+      // length of the last step gives the average force.
+      const btVector3 impulse =
+        pt.m_appliedImpulse * pt.m_normalWorldOnB +
+        pt.m_appliedImpulseLateral1 * pt.m_lateralFrictionDir1 +
+        pt.m_appliedImpulseLateral2 * pt.m_lateralFrictionDir2;
+
+      _func(collision1ID, collision2ID,
+            convert(pt.getPositionWorldOnA()),
+            convert(pt.m_normalWorldOnB),
+            static_cast<double>(pt.getDistance()),
+            Eigen::Vector3d(convert(impulse) / stepSize));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+std::vector<SimulationFeatures::ContactInternal>
+SimulationFeatures::GetContactsFromLastStep(const Identity &_worldID) const
+{
+  std::vector<SimulationFeatures::ContactInternal> outContacts;
+  auto *const world = this->ReferenceInterface<WorldInfo>(_worldID);
+  if (!world)
+  {
+    return outContacts;
+  }
+
+  this->ForEachContact(*world, this->FindContactFilter(_worldID), [&](
+      std::size_t _collision1ID, std::size_t _collision2ID,
+      const Eigen::Vector3d &_point, const Eigen::Vector3d &_normal,
+      double _depth, const Eigen::Vector3d &_force)
+  {
+    CompositeData extraData;
+    extraData.SetQueryTracking(false);
+
+    // Add normal, depth and wrench to extraData.
+    auto& extraContactData =
+      extraData.Get<SimulationFeatures::ExtraContactData>();
+    extraContactData.force = _force;
+    extraContactData.normal = _normal;
+    extraContactData.depth = _depth;
+
+    outContacts.push_back(SimulationFeatures::ContactInternal {
+      this->GenerateIdentity(
+        _collision1ID, this->collisions.at(_collision1ID)),
+      this->GenerateIdentity(
+        _collision2ID, this->collisions.at(_collision2ID)),
+      _point, extraData});
+  });
+  if (this->deterministic)
+    SortContacts(outContacts);
+  return outContacts;
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::ContactBatch
+SimulationFeatures::GetContactBatchFromLastStep(const Identity &_worldID) const
+{
+  this->contactBatch.Clear();
+  auto *const world = this->ReferenceInterface<WorldInfo>(_worldID);
+  if (world)
+  {
+    this->ForEachContact(*world, this->FindContactFilter(_worldID), [this](
+        std::size_t _collision1ID, std::size_t _collision2ID,
+        const Eigen::Vector3d &_point, const Eigen::Vector3d &_normal,
+        double _depth, const Eigen::Vector3d &_force)
+    {
+      this->contactBatch.Add(
+        _collision1ID, _collision2ID, _point, _normal, _depth, _force);
+    });
+    if (this->deterministic)
+      this->contactBatch.Sort();
+  }
+  return this->contactBatch.View();
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::ContactPairBatch
+SimulationFeatures::GetContactPairsFromLastStep(const Identity &_worldID) const
+{
+  // Deterministic steps sort the batch already
+  this->GetContactBatchFromLastStep(_worldID);
+  if (!this->deterministic)
+    this->contactBatch.Sort();
+  this->contactPairs.Build(this->contactBatch.View());
+  return this->contactPairs.View();
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::ContactEventBatch
+SimulationFeatures::GetContactEvents(const Identity &_worldID) const
+{
+  ContactEventTracker &tracker = this->contactEvents[_worldID.id];
+  auto *const world = this->ReferenceInterface<WorldInfo>(_worldID);
+  if (world)
+  {
+    // Bullet keeps a persistent manifold for each pair of colliders that
+    // are close, and its points are the contacts of the pair. Points of
+    // compound shapes are listed with the child collision they belong to.
+    this->ForEachContact(*world, this->FindContactFilter(_worldID), [&](
+        std::size_t _collision1ID, std::size_t _collision2ID,
+        const Eigen::Vector3d &, const Eigen::Vector3d &, double,
+        const Eigen::Vector3d &)
+    {
+      tracker.AddContact(_collision1ID, _collision2ID);
+    });
+  }
+  tracker.Update();
+  return tracker.View();
+}
+
+/////////////////////////////////////////////////
+const LinkInfo *SimulationFeatures::FindLinkOfCollider(
+    const btCollisionObject *_collider) const
+{
+  const int linkIndex = _collider->getUserIndex();
+  if (linkIndex < 0)
+    return nullptr;
+
+  const auto linkIt = this->links.find(static_cast<std::size_t>(linkIndex));
+  if (linkIt == this->links.end() ||
+      linkIt->second->collider.get() != _collider)
+  {
+    return nullptr;
+  }
+
+  return linkIt->second.get();
+}
+
+/////////////////////////////////////////////////
+namespace
+{
+/// \brief Collects the collision objects of the dbvt leaves visited by a
+/// query.
+struct LeafCollector : btDbvt::ICollide
+{
+  std::vector<const btCollisionObject *> *objects;
+
+  void Process(const btDbvtNode *_leaf)
+  {
+    const auto *proxy = static_cast<const btBroadphaseProxy *>(_leaf->data);
+    this->objects->push_back(
+        static_cast<const btCollisionObject *>(proxy->m_clientObject));
+  }
+};
+
+/// \brief Collect the collision objects of a world whose broadphase box
+/// overlaps a box.
+/// \param[in] _world World to query.
+/// \param[in] _min Minimum corner of the box in the world frame.
+/// \param[in] _max Maximum corner of the box in the world frame.
+/// \param[out] _objects The objects are appended to this vector.
+void CollectObjectsInBox(const WorldInfo &_world,
+    const btVector3 &_min, const btVector3 &_max,
+    std::vector<const btCollisionObject *> &_objects)
+{
+  // collideTV keeps its traversal stack on the calling thread
+  const auto *dbvt =
+      dynamic_cast<const btDbvtBroadphase *>(_world.broadphase.get());
+  if (dbvt)
+  {
+    LeafCollector collector;
+    collector.objects = &_objects;
+    const btDbvtVolume volume = btDbvtVolume::FromMM(_min, _max);
+    for (const btDbvt &tree : dbvt->m_sets)
+      tree.collideTV(tree.m_root, volume, collector);
+    return;
+  }
+
+  const auto &objects = _world.world->getCollisionObjectArray();
+  for (int i = 0; i < objects.size(); ++i)
+  {
+    btVector3 aabbMin, aabbMax;
+    objects[i]->getCollisionShape()->getAabb(
+        objects[i]->getWorldTransform(), aabbMin, aabbMax);
+    if (TestAabbAgainstAabb2(aabbMin, aabbMax, _min, _max))
+      _objects.push_back(objects[i]);
+  }
+}
+
+/// \brief Collects the indices of the children of a compound shape whose
+/// leaves in its dynamic AABB tree are visited by a query.
+struct ChildCollector : btDbvt::ICollide
+{
+  std::vector<int> *children;
+
+  void Process(const btDbvtNode *_leaf)
+  {
+    this->children->push_back(_leaf->dataAsInt);
+  }
+};
+
+/// \brief Collect the children of a compound shape whose bounding boxes
+/// overlap a box, so that the baked static collider of a world, which holds
+/// many children, is not searched one child at a time.
+/// \param[in] _compound Compound shape.
+/// \param[in] _compoundTf World transform of the compound shape.
+/// \param[in] _min Minimum corner of the box in the world frame.
+/// \param[in] _max Maximum corner of the box in the world frame.
+/// \param[out] _children Indices of the children, in increasing order.
+void CollectChildrenInBox(const btCompoundShape &_compound,
+    const btTransform &_compoundTf,
+    const btVector3 &_min, const btVector3 &_max,
+    std::vector<int> &_children)
+{
+  _children.clear();
+  const btDbvt *tree = _compound.getDynamicAabbTree();
+  if (!tree)
+  {
+    for (int i = 0; i < _compound.getNumChildShapes(); ++i)
+      _children.push_back(i);
+    return;
+  }
+
+  // The tree holds the boxes of the children in the frame of the compound
+  btVector3 localMin, localMax;
+  btTransformAabb(_min, _max, btScalar(0), _compoundTf.inverse(),
+      localMin, localMax);
+  ChildCollector collector;
+  collector.children = &_children;
+  tree->collideTV(tree->m_root,
+      btDbvtVolume::FromMM(localMin, localMax), collector);
+  std::sort(_children.begin(), _children.end());
+}
+
+/// \brief Make the bullet shape and world transform of a query volume.
+/// \param[in] _volume Sphere or box.
+/// \param[out] _transform World transform of the volume.
+/// \return The shape.
+std::unique_ptr<btConvexShape> MakeQueryShape(
+    const SimulationFeatures::QueryVolume &_volume, btTransform &_transform)
+{
+  _transform = convertTf(_volume.pose);
+  if (_volume.type == SimulationFeatures::QueryVolume::Type::BOX)
+    return std::make_unique<btBoxShape>(convertVec(_volume.size * 0.5));
+  return std::make_unique<btSphereShape>(
+      static_cast<btScalar>(_volume.radius));
+}
+
+/// \brief Check whether two convex shapes overlap, margins included.
+/// \param[in] _a First shape.
+/// \param[in] _aTf Transform of the first shape.
+/// \param[in] _b Second shape.
+/// \param[in] _bTf Transform of the second shape.
+/// \return True if they overlap.
+bool ConvexOverlap(const btConvexShape &_a, const btTransform &_aTf,
+    const btConvexShape &_b, const btTransform &_bTf)
+{
+  btVoronoiSimplexSolver simplex;
+  btGjkEpaPenetrationDepthSolver penetration;
+  btGjkPairDetector gjk(&_a, &_b, &simplex, &penetration);
+  btGjkPairDetector::ClosestPointInput input;
+  input.m_transformA = _aTf;
+  input.m_transformB = _bTf;
+  btPointCollector output;
+  gjk.getClosestPoints(input, output, nullptr);
+  return output.m_hasResult && output.m_distance <= btScalar(0);
+}
+
+/// \brief Stops at the first triangle of a concave shape that overlaps a
+/// convex volume.
+struct TriangleOverlapCallback : btTriangleCallback
+{
+  const btConvexShape *volume = nullptr;
+  btTransform volumeTf;
+  bool overlap = false;
+
+  void processTriangle(btVector3 *_triangle, int, int) override
+  {
+    if (this->overlap)
+      return;
+    btTriangleShape triangle(_triangle[0], _triangle[1], _triangle[2]);
+    this->overlap = ConvexOverlap(*this->volume, this->volumeTf, triangle,
+        btTransform::getIdentity());
+  }
+};
+
+/// \brief Check whether a convex volume overlaps a child shape of a link.
+/// \param[in] _volume Volume.
+/// \param[in] _volumeTf World transform of the volume.
+/// \param[in] _shape Child shape, convex or concave.
+/// \param[in] _shapeTf World transform of the child shape.
+/// \return True if they overlap.
+bool VolumeOverlaps(const btConvexShape &_volume, const btTransform &_volumeTf,
+    const btCollisionShape &_shape, const btTransform &_shapeTf)
+{
+  if (_shape.isConvex())
+  {
+    return ConvexOverlap(_volume, _volumeTf,
+        static_cast<const btConvexShape &>(_shape), _shapeTf);
+  }
+  if (!_shape.isConcave())
+    return false;
+
+  // Test the triangles of meshes, heightfields and planes near the volume,
+  // in the frame of the shape
+  TriangleOverlapCallback callback;
+  callback.volume = &_volume;
+  callback.volumeTf = _shapeTf.inverse() * _volumeTf;
+  btVector3 aabbMin, aabbMax;
+  _volume.getAabb(callback.volumeTf, aabbMin, aabbMax);
+  static_cast<const btConcaveShape &>(_shape).processAllTriangles(
+      &callback, aabbMin, aabbMax);
+  return callback.overlap;
+}
+
+/// \brief Signed distance between two shapes, with their closest points.
+struct PairDistance
+{
+  btScalar distance = BT_LARGE_FLOAT;
+  /// Closest point of the first shape
+  btVector3 point1 = btVector3(0, 0, 0);
+  /// Closest point of the second shape
+  btVector3 point2 = btVector3(0, 0, 0);
+  /// Direction from the first shape towards the second
+  btVector3 normal = btVector3(0, 0, 0);
+};
+
+/// \brief Compute the signed distance between two convex shapes, margins
+/// included, with GJK and EPA.
+/// \param[in] _a First shape.
+/// \param[in] _aTf Transform of the first shape.
+/// \param[in] _b Second shape.
+/// \param[in] _bTf Transform of the second shape.
+/// \param[out] _result Distance, in the frame of the transforms.
+/// \return False if bullet did not find a result.
+bool ConvexDistance(const btConvexShape &_a, const btTransform &_aTf,
+    const btConvexShape &_b, const btTransform &_bTf, PairDistance &_result)
+{
+  btVoronoiSimplexSolver simplex;
+  btGjkEpaPenetrationDepthSolver penetration;
+  btGjkPairDetector gjk(&_a, &_b, &simplex, &penetration);
+  btGjkPairDetector::ClosestPointInput input;
+  input.m_transformA = _aTf;
+  input.m_transformB = _bTf;
+  btPointCollector output;
+  gjk.getClosestPoints(input, output, nullptr);
+  if (!output.m_hasResult)
+    return false;
+
+  // bullet reports the point of the second shape, and a normal from the
+  // second shape towards the first
+  _result.distance = output.m_distance;
+  _result.point2 = output.m_pointInWorld;
+  _result.point1 =
+      output.m_pointInWorld + output.m_normalOnBInWorld * output.m_distance;
+  _result.normal = -output.m_normalOnBInWorld;
+  return true;
+}
+
+/// \brief Keeps the triangle of a concave shape that is closest to a convex
+/// shape.
+struct TriangleDistanceCallback : btTriangleCallback
+{
+  const btConvexShape *convex = nullptr;
+  btTransform convexTf;
+  bool found = false;
+  PairDistance closest;
+
+  void processTriangle(btVector3 *_triangle, int, int) override
+  {
+    btTriangleShape triangle(_triangle[0], _triangle[1], _triangle[2]);
+    triangle.setMargin(btScalar(0));
+    PairDistance result;
+    if (ConvexDistance(*this->convex, this->convexTf, triangle,
+          btTransform::getIdentity(), result) &&
+        (!this->found || result.distance < this->closest.distance))
+    {
+      this->closest = result;
+      this->found = true;
+    }
+  }
+};
+
+/// \brief Compute the signed distance between a convex shape and a concave
+/// one, such as a mesh, a heightfield or a plane. Only the triangles within
+/// _cutoff of the bounding box of the convex shape are tested.
+/// \param[in] _convex Convex shape.
+/// \param[in] _convexTf World transform of the convex shape.
+/// \param[in] _concave Concave shape.
+/// \param[in] _concaveTf World transform of the concave shape.
+/// \param[in] _cutoff Largest distance of interest.
+/// \param[out] _result Distance, with the convex shape first.
+/// \return False if no triangle was within _cutoff.
+bool ConcaveDistance(const btConvexShape &_convex,
+    const btTransform &_convexTf,
+    const btConcaveShape &_concave, const btTransform &_concaveTf,
+    btScalar _cutoff, PairDistance &_result)
+{
+  const btTransform convexInConcave = _concaveTf.inverse() * _convexTf;
+
+  // Planes are infinite, so they are measured from the support point of
+  // the convex shape instead of from triangles.
+  if (const auto *plane = dynamic_cast<const btStaticPlaneShape *>(&_concave))
+  {
+    const btVector3 &n = plane->getPlaneNormal();
+    const btVector3 support = convexInConcave(
+        _convex.localGetSupportingVertex(
+            -(convexInConcave.getBasis().transpose() * n)));
+    _result.distance = n.dot(support) - plane->getPlaneConstant();
+    _result.point1 = _concaveTf(support);
+    _result.point2 = _concaveTf(support - n * _result.distance);
+    _result.normal = -(_concaveTf.getBasis() * n);
+    return true;
+  }
+
+  TriangleDistanceCallback callback;
+  callback.convex = &_convex;
+  callback.convexTf = convexInConcave;
+  btVector3 aabbMin, aabbMax;
+  _convex.getAabb(convexInConcave, aabbMin, aabbMax);
+  const btVector3 pad(_cutoff, _cutoff, _cutoff);
+  _concave.processAllTriangles(&callback, aabbMin - pad, aabbMax + pad);
+  if (!callback.found)
+    return false;
+
+  _result.distance = callback.closest.distance;
+  _result.point1 = _concaveTf(callback.closest.point1);
+  _result.point2 = _concaveTf(callback.closest.point2);
+  _result.normal = _concaveTf.getBasis() * callback.closest.normal;
+  return true;
+}
+
+/// \brief Compute the signed distance between two collision shapes. The
+/// children of compound shapes are measured in turn. Distances between two
+/// concave shapes are not supported.
+/// \param[in] _a First shape.
+/// \param[in] _aTf World transform of the first shape.
+/// \param[in] _b Second shape.
+/// \param[in] _bTf World transform of the second shape.
+/// \param[in] _cutoff Largest distance of interest, see ConcaveDistance.
+/// \param[out] _result Distance in the world frame.
+/// \return False if the distance could not be computed.
+bool CollisionShapeDistance(
+    const btCollisionShape &_a, const btTransform &_aTf,
+    const btCollisionShape &_b, const btTransform &_bTf,
+    btScalar _cutoff, PairDistance &_result)
+{
+  auto closestChild = [&](const btCompoundShape &_compound,
+                          const btTransform &_compoundTf, bool _first)
+  {
+    bool found = false;
+    PairDistance child;
+    for (int i = 0; i < _compound.getNumChildShapes(); ++i)
+    {
+      const btTransform childTf =
+          _compoundTf * _compound.getChildTransform(i);
+      const bool computed = _first ?
+          CollisionShapeDistance(*_compound.getChildShape(i), childTf,
+              _b, _bTf, _cutoff, child) :
+          CollisionShapeDistance(_a, _aTf,
+              *_compound.getChildShape(i), childTf, _cutoff, child);
+      if (computed && (!found || child.distance < _result.distance))
+      {
+        _result = child;
+        found = true;
+      }
+    }
+    return found;
+  };
+
+  if (_a.isCompound())
+    return closestChild(static_cast<const btCompoundShape &>(_a), _aTf, true);
+  if (_b.isCompound())
+    return closestChild(static_cast<const btCompoundShape &>(_b), _bTf, false);
+
+  if (_a.isConvex() && _b.isConvex())
+  {
+    return ConvexDistance(static_cast<const btConvexShape &>(_a), _aTf,
+        static_cast<const btConvexShape &>(_b), _bTf, _result);
+  }
+
+  if (_a.isConvex() && _b.isConcave())
+  {
+    return ConcaveDistance(static_cast<const btConvexShape &>(_a), _aTf,
+        static_cast<const btConcaveShape &>(_b), _bTf, _cutoff, _result);
+  }
+
+  if (_a.isConcave() && _b.isConvex() &&
+      ConcaveDistance(static_cast<const btConvexShape &>(_b), _bTf,
+        static_cast<const btConcaveShape &>(_a), _aTf, _cutoff, _result))
+  {
+    std::swap(_result.point1, _result.point2);
+    _result.normal = -_result.normal;
+    return true;
+  }
+
+  return false;
+}
+
+/// \brief Distance between two axis aligned boxes, 0 if they overlap.
+btScalar AabbDistance(const btVector3 &_min1, const btVector3 &_max1,
+    const btVector3 &_min2, const btVector3 &_max2)
+{
+  btVector3 gap(0, 0, 0);
+  for (int i = 0; i < 3; ++i)
+    gap[i] = std::max({btScalar(0), _min2[i] - _max1[i], _min1[i] - _max2[i]});
+  return gap.length();
+}
+
+/// \brief Fill a distance result from the distance between two shapes.
+/// \param[in] _distance Distance between the shapes.
+/// \param[out] _result Result to fill.
+void FillShapeDistance(const PairDistance &_distance,
+    SimulationFeatures::ShapeDistance &_result)
+{
+  _result.valid = true;
+  _result.distance = _distance.distance;
+  _result.point1 = convert(_distance.point1);
+  _result.point2 = convert(_distance.point2);
+  _result.normal = Eigen::Vector3d::Zero();
+  if (_distance.normal.length2() > btScalar(0))
+    _result.normal = convert(_distance.normal.normalized());
+}
+}  // namespace
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::CastRay(
+    const WorldInfo &_world,
+    const btVector3 &_from,
+    const btVector3 &_to,
+    double &_distance,
+    Eigen::Vector3d &_normal) const
+{
+  thread_local std::vector<const btCollisionObject *> candidates;
+  candidates.clear();
+
+  // btDbvtBroadphase::rayTest shares one traversal stack unless bullet is
+  // built thread safe, so walk its trees with the static btDbvt::rayTest,
+  // which keeps its stack on the calling thread.
+  const auto *dbvt =
+      dynamic_cast<const btDbvtBroadphase *>(_world.broadphase.get());
+  if (dbvt)
+  {
+    LeafCollector collector;
+    collector.objects = &candidates;
+    btDbvt::rayTest(dbvt->m_sets[0].m_root, _from, _to, collector);
+    btDbvt::rayTest(dbvt->m_sets[1].m_root, _from, _to, collector);
+  }
+  else
+  {
+    const auto &objects = _world.world->getCollisionObjectArray();
+    for (int i = 0; i < objects.size(); ++i)
+    {
+      btVector3 aabbMin, aabbMax;
+      objects[i]->getCollisionShape()->getAabb(
+          objects[i]->getWorldTransform(), aabbMin, aabbMax);
+      btScalar param = 1;
+      btVector3 normal;
+      if (btRayAabb(_from, _to, aabbMin, aabbMax, param, normal))
+        candidates.push_back(objects[i]);
+    }
+  }
+
+  const btTransform fromTf(btMatrix3x3::getIdentity(), _from);
+  const btTransform toTf(btMatrix3x3::getIdentity(), _to);
+  const double length = static_cast<double>((_to - _from).length());
+
+  std::size_t hitID = std::numeric_limits<std::size_t>::max();
+  btScalar closestFraction = 1;
+  thread_local std::vector<int> children;
+  for (const btCollisionObject *object : candidates)
+  {
+    const LinkInfo *link = this->FindLinkOfCollider(object);
+    const BakedStaticCollisions *baked =
+      link ? nullptr : BakedCollisionsOf(_world, object);
+    const btCompoundShape *shape =
+      link ? link->shape.get() : baked ? baked->shape.get() : nullptr;
+    if (!shape)
+      continue;
+
+    // Test the children one by one, so that a hit maps to its collision
+    // even when the child is a mesh, which reports its triangle instead.
+    const btCompoundShape &compound = *shape;
+    btVector3 rayMin = _from;
+    btVector3 rayMax = _from;
+    rayMin.setMin(_to);
+    rayMax.setMax(_to);
+    CollectChildrenInBox(
+        compound, object->getWorldTransform(), rayMin, rayMax, children);
+    for (const int i : children)
+    {
+      btCollisionWorld::ClosestRayResultCallback callback(_from, _to);
+      callback.m_closestHitFraction = closestFraction;
+      btCollisionWorld::rayTestSingle(fromTf, toTf,
+          const_cast<btCollisionObject *>(object), compound.getChildShape(i),
+          object->getWorldTransform() * compound.getChildTransform(i),
+          callback);
+      if (!callback.hasHit() ||
+          callback.m_closestHitFraction >= closestFraction)
+      {
+        continue;
+      }
+
+      const std::size_t collisionID =
+          this->FindCollisionOfChild(link, baked, i);
+      if (collisionID == std::numeric_limits<std::size_t>::max())
+        continue;
+
+      closestFraction = callback.m_closestHitFraction;
+      hitID = collisionID;
+      _distance = static_cast<double>(closestFraction) * length;
+      _normal = convert(callback.m_hitNormalWorld.normalized());
+    }
+  }
+  return hitID;
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::RayIntersectionBatch SimulationFeatures::CastWorldRays(
+    const Identity &_worldID,
+    const LinearVector3d *_from,
+    const LinearVector3d *_to,
+    std::size_t _count,
+    std::size_t _numThreads) const
+{
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  this->rayHits.Reset(_count);
+
+  auto castRange = [&](std::size_t _begin, std::size_t _end)
+  {
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      double distance = 0.0;
+      Eigen::Vector3d normal;
+      const std::size_t hitID = this->CastRay(*worldInfo,
+          convertVec(_from[i]), convertVec(_to[i]), distance, normal);
+      if (hitID != std::numeric_limits<std::size_t>::max())
+        this->rayHits.Set(i, distance, normal, hitID);
+    }
+  };
+
+  this->RunQueries(_count, _numThreads, castRange);
+  return this->rayHits.View();
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::RayIntersectionBatch SimulationFeatures::CastWorldShapes(
+    const Identity &_worldID,
+    const QueryVolume *_volumes,
+    const LinearVector3d *_to,
+    std::size_t _count,
+    std::size_t _numThreads) const
+{
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  this->rayHits.Reset(_count);
+
+  auto castRange = [&](std::size_t _begin, std::size_t _end)
+  {
+    std::vector<const btCollisionObject *> candidates;
+    std::vector<int> children;
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      btTransform fromTf;
+      const std::unique_ptr<btConvexShape> shape =
+          MakeQueryShape(_volumes[i], fromTf);
+      const btTransform toTf(fromTf.getBasis(), convertVec(_to[i]));
+
+      // Candidates are the objects near any part of the sweep
+      btVector3 startMin, startMax, endMin, endMax;
+      shape->getAabb(fromTf, startMin, startMax);
+      shape->getAabb(toTf, endMin, endMax);
+      startMin.setMin(endMin);
+      startMax.setMax(endMax);
+      candidates.clear();
+      CollectObjectsInBox(*worldInfo, startMin, startMax, candidates);
+
+      const double length = static_cast<double>(
+          (toTf.getOrigin() - fromTf.getOrigin()).length());
+      btScalar closestFraction = 1;
+      for (const btCollisionObject *object : candidates)
+      {
+        const LinkInfo *link = this->FindLinkOfCollider(object);
+        const BakedStaticCollisions *baked =
+          link ? nullptr : BakedCollisionsOf(*worldInfo, object);
+        const btCompoundShape *compoundShape =
+          link ? link->shape.get() : baked ? baked->shape.get() : nullptr;
+        if (!compoundShape)
+          continue;
+
+        const btCompoundShape &compound = *compoundShape;
+        CollectChildrenInBox(compound, object->getWorldTransform(),
+            startMin, startMax, children);
+        for (const int j : children)
+        {
+          btCollisionWorld::ClosestConvexResultCallback callback(
+              fromTf.getOrigin(), toTf.getOrigin());
+          callback.m_closestHitFraction = closestFraction;
+          btCollisionWorld::objectQuerySingle(shape.get(), fromTf, toTf,
+              const_cast<btCollisionObject *>(object),
+              compound.getChildShape(j),
+              object->getWorldTransform() * compound.getChildTransform(j),
+              callback, btScalar(0));
+          if (!callback.hasHit() ||
+              callback.m_closestHitFraction >= closestFraction)
+          {
+            continue;
+          }
+
+          const std::size_t collisionID =
+              this->FindCollisionOfChild(link, baked, j);
+          if (collisionID == std::numeric_limits<std::size_t>::max())
+            continue;
+
+          closestFraction = callback.m_closestHitFraction;
+          this->rayHits.Set(i, static_cast<double>(closestFraction) * length,
+              convert(callback.m_hitNormalWorld.normalized()), collisionID);
+        }
+      }
+    }
+  };
+
+  this->RunQueries(_count, _numThreads, castRange);
+  return this->rayHits.View();
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::OverlapBatch SimulationFeatures::FindWorldOverlaps(
+    const Identity &_worldID,
+    const QueryVolume *_volumes,
+    std::size_t _count,
+    std::size_t _numThreads) const
+{
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  this->volumeOverlaps.resize(_count);
+
+  auto overlapRange = [&](std::size_t _begin, std::size_t _end)
+  {
+    std::vector<const btCollisionObject *> candidates;
+    std::vector<int> children;
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      std::vector<std::size_t> &result = this->volumeOverlaps[i];
+      result.clear();
+
+      btTransform volumeTf;
+      const std::unique_ptr<btConvexShape> shape =
+          MakeQueryShape(_volumes[i], volumeTf);
+      btVector3 aabbMin, aabbMax;
+      shape->getAabb(volumeTf, aabbMin, aabbMax);
+      candidates.clear();
+      CollectObjectsInBox(*worldInfo, aabbMin, aabbMax, candidates);
+
+      for (const btCollisionObject *object : candidates)
+      {
+        const LinkInfo *link = this->FindLinkOfCollider(object);
+        const BakedStaticCollisions *baked =
+          link ? nullptr : BakedCollisionsOf(*worldInfo, object);
+        const btCompoundShape *compoundShape =
+          link ? link->shape.get() : baked ? baked->shape.get() : nullptr;
+        if (!compoundShape)
+          continue;
+
+        const btCompoundShape &compound = *compoundShape;
+        CollectChildrenInBox(compound, object->getWorldTransform(),
+            aabbMin, aabbMax, children);
+        for (const int j : children)
+        {
+          const btTransform childTf =
+              object->getWorldTransform() * compound.getChildTransform(j);
+          if (!VolumeOverlaps(*shape, volumeTf,
+                *compound.getChildShape(j), childTf))
+          {
+            continue;
+          }
+
+          const std::size_t collisionID =
+              this->FindCollisionOfChild(link, baked, j);
+          if (collisionID != std::numeric_limits<std::size_t>::max())
+            result.push_back(collisionID);
+        }
+      }
+    }
+  };
+
+  this->RunQueries(_count, _numThreads, overlapRange);
+  this->overlaps.Assign(this->volumeOverlaps);
+  return this->overlaps.View();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::ComputeWorldShapeDistances(
+    const Identity &_worldID,
+    const ShapePair *_pairs,
+    std::size_t _count,
+    double _cutoff,
+    ShapeDistance *_results) const
+{
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  const btScalar cutoff = static_cast<btScalar>(
+      std::min(_cutoff, static_cast<double>(BT_LARGE_FLOAT)));
+
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    ShapeDistance &result = _results[i];
+    result = ShapeDistance();
+    result.shape1 = _pairs[i].first;
+    result.shape2 = _pairs[i].second;
+
+    const btCollisionShape *shape1 = nullptr;
+    const btCollisionShape *shape2 = nullptr;
+    btTransform tf1, tf2;
+    if (!this->FindWorldCollisionShape(
+          *worldInfo, result.shape1, shape1, tf1) ||
+        !this->FindWorldCollisionShape(
+          *worldInfo, result.shape2, shape2, tf2))
+    {
+      continue;
+    }
+
+    btVector3 min1, max1, min2, max2;
+    shape1->getAabb(tf1, min1, max1);
+    shape2->getAabb(tf2, min2, max2);
+    if (AabbDistance(min1, max1, min2, max2) > cutoff)
+      continue;
+
+    PairDistance distance;
+    if (CollisionShapeDistance(
+          *shape1, tf1, *shape2, tf2, cutoff, distance) &&
+        distance.distance <= cutoff)
+    {
+      FillShapeDistance(distance, result);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::ComputeWorldLinkDistances(
+    const Identity &_worldID,
+    const std::vector<std::size_t> &_links,
+    double _cutoff) const -> std::vector<ShapeDistance>
+{
+  const auto *worldInfo = this->ReferenceInterface<WorldInfo>(_worldID);
+  const btScalar cutoff = static_cast<btScalar>(
+      std::min(_cutoff, static_cast<double>(BT_LARGE_FLOAT)));
+  const btScalar pad = std::max(btScalar(0), cutoff);
+  const std::unordered_set<std::size_t> linkSet(_links.begin(), _links.end());
+
+  std::vector<ShapeDistance> results;
+  std::vector<const btCollisionObject *> candidates;
+  std::vector<int> children;
+  for (const std::size_t linkID : linkSet)
+  {
+    const auto linkIt = this->links.find(linkID);
+    if (linkIt == this->links.end() || !linkIt->second)
+      continue;
+
+    for (const std::size_t collisionID : linkIt->second->collisionEntityIds)
+    {
+      const btCollisionShape *shape = nullptr;
+      btTransform tf;
+      if (!this->FindWorldCollisionShape(*worldInfo, collisionID, shape, tf))
+        continue;
+
+      // Find the children of the other colliders whose bounding boxes are
+      // within the cutoff of the box of this collision
+      btVector3 aabbMin, aabbMax;
+      shape->getAabb(tf, aabbMin, aabbMax);
+      aabbMin -= btVector3(pad, pad, pad);
+      aabbMax += btVector3(pad, pad, pad);
+      candidates.clear();
+      CollectObjectsInBox(*worldInfo, aabbMin, aabbMax, candidates);
+
+      for (const btCollisionObject *object : candidates)
+      {
+        const LinkInfo *link = this->FindLinkOfCollider(object);
+        const BakedStaticCollisions *baked =
+          link ? nullptr : BakedCollisionsOf(*worldInfo, object);
+        const btCompoundShape *compoundShape =
+          link ? link->shape.get() : baked ? baked->shape.get() : nullptr;
+        if (!compoundShape || (link && linkSet.count(
+              static_cast<std::size_t>(object->getUserIndex())) > 0u))
+        {
+          continue;
+        }
+
+        const btCompoundShape &compound = *compoundShape;
+        CollectChildrenInBox(compound, object->getWorldTransform(),
+            aabbMin, aabbMax, children);
+        for (const int j : children)
+        {
+          const std::size_t otherID =
+              this->FindCollisionOfChild(link, baked, j);
+          if (otherID == std::numeric_limits<std::size_t>::max())
+            continue;
+
+          // Baked collisions of the links of the set are skipped as well
+          if (baked)
+          {
+            const auto otherIt = this->collisions.find(otherID);
+            if (otherIt == this->collisions.end() ||
+                linkSet.count(otherIt->second->link.id) > 0u)
+            {
+              continue;
+            }
+          }
+
+          const btTransform childTf =
+              object->getWorldTransform() * compound.getChildTransform(j);
+          PairDistance distance;
+          if (!CollisionShapeDistance(*shape, tf, *compound.getChildShape(j),
+                childTf, cutoff, distance) || distance.distance > cutoff)
+          {
+            continue;
+          }
+
+          ShapeDistance &result = results.emplace_back();
+          result.shape1 = collisionID;
+          result.shape2 = otherID;
+          FillShapeDistance(distance, result);
+        }
+      }
+    }
+  }
+
+  std::sort(results.begin(), results.end(),
+      [](const ShapeDistance &_a, const ShapeDistance &_b)
+      {
+        return std::tie(_a.shape1, _a.shape2) < std::tie(_b.shape1, _b.shape2);
+      });
+  return results;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::FindWorldCollisionShape(
+    const WorldInfo &_world,
+    std::size_t _collisionID,
+    const btCollisionShape *&_shape,
+    btTransform &_transform) const
+{
+  const auto collisionIt = this->collisions.find(_collisionID);
+  if (collisionIt == this->collisions.end() || !collisionIt->second)
+    return false;
+
+  const auto linkIt = this->links.find(collisionIt->second->link.id);
+  if (linkIt == this->links.end() || !linkIt->second)
+    return false;
+  const LinkInfo &link = *linkIt->second;
+
+  const auto modelIt = this->models.find(link.model.id);
+  if (modelIt == this->models.end() ||
+      this->worlds.at(modelIt->second->world.id).get() != &_world)
+  {
+    return false;
+  }
+
+  if (link.collider && link.shape)
+  {
+    const auto &children = link.childIndexToCollisionEntityId;
+    const auto child = std::find(children.begin(), children.end(),
+        _collisionID);
+    if (child != children.end())
+    {
+      const int index = static_cast<int>(child - children.begin());
+      _shape = link.shape->getChildShape(index);
+      _transform = link.collider->getWorldTransform() *
+          link.shape->getChildTransform(index);
+      return true;
+    }
+  }
+
+  if (_world.bakedStatic)
+  {
+    const auto &childIndices =
+        _world.bakedStatic->collisionEntityIdToChildIndex;
+    const auto child = childIndices.find(_collisionID);
+    if (child != childIndices.end())
+    {
+      const btCompoundShape &compound = *_world.bakedStatic->shape;
+      _shape = compound.getChildShape(child->second);
+      _transform = _world.bakedStatic->collider->getWorldTransform() *
+          compound.getChildTransform(child->second);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::RunQueries(
+    std::size_t _count, std::size_t _numThreads,
+    const std::function<void(std::size_t, std::size_t)> &_query) const
+{
+  if (_numThreads == 0u)
+    _numThreads = std::max(1u, std::thread::hardware_concurrency());
+  if (_numThreads <= 1u || _count < 2u)
+  {
+    _query(0u, _count);
+    return;
+  }
+
+  // Queries only read the collision world and write their own result.
+  const auto tasks = RayChunkTasks(_count, _numThreads, _query);
+  this->RunTasks(this->rayPool, this->rayPoolThreads, _numThreads,
+      tasks.size(), [&tasks](std::size_t _i) { tasks[_i](); });
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::FindCollisionOfChild(
+    const LinkInfo &_link, int _childIndex) const
+{
+  if (_childIndex >= 0 && static_cast<std::size_t>(_childIndex) <
+      _link.childIndexToCollisionEntityId.size())
+  {
+    return _link.childIndexToCollisionEntityId[
+        static_cast<std::size_t>(_childIndex)];
+  }
+
+  // The contact did not record a child, which can only be resolved if the
+  // link has a single collision.
+  if (_link.collisionEntityIds.size() == 1u)
+    return _link.collisionEntityIds.front();
+
+  return std::numeric_limits<std::size_t>::max();
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::FindCollisionOfChild(
+    const LinkInfo *_link, const BakedStaticCollisions *_baked,
+    int _childIndex) const
+{
+  if (_link)
+    return this->FindCollisionOfChild(*_link, _childIndex);
+
+  if (_baked && _childIndex >= 0 && static_cast<std::size_t>(_childIndex) <
+      _baked->childIndexToCollisionEntityId.size())
+  {
+    return _baked->childIndexToCollisionEntityId[
+        static_cast<std::size_t>(_childIndex)];
+  }
+
+  return std::numeric_limits<std::size_t>::max();
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the world velocity of a link to _twist, as reported by
+/// FrameDataRelativeToWorld.
+static void LinkWorldTwist(
+    const ModelInfo &_model, const LinkInfo &_link, WorldTwist &_twist)
+{
+  if (_link.indexInModel.has_value())
+  {
+    const auto &link = _model.body->getLink(*_link.indexInModel);
+    _twist.linearVelocity = gz::math::eigen3::convert(
+        convert(link.m_absFrameTotVelocity.getLinear()));
+    _twist.angularVelocity = gz::math::eigen3::convert(
+        convert(link.m_absFrameTotVelocity.getAngular()));
+  }
+  else if (_model.body)
+  {
+    _twist.linearVelocity =
+        gz::math::eigen3::convert(convert(_model.body->getBaseVel()));
+    _twist.angularVelocity =
+        gz::math::eigen3::convert(convert(_model.body->getBaseOmega()));
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(WorldPoses &_worldPoses) const
+{
+  // remove link poses from the previous iteration
+  _worldPoses.entries.clear();
+  _worldPoses.entries.reserve(this->links.size());
+
+  for (const auto &[id, info] : this->links)
+  {
+    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+    if (!this->IsModelWritten(*model))
+      continue;
+
+    WorldPose wp;
+    wp.pose =
+        gz::math::eigen3::convert(this->LinkWorldTransform(*model, *info));
+    wp.body = id;
+    _worldPoses.entries.push_back(wp);
+  }
+}
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
+{
+  // remove link poses from the previous iteration
+  _changedPoses.entries.clear();
+  _changedPoses.entries.reserve(this->links.size());
+
+  // The last reported pose lives in the LinkInfo, which also drops it when
+  // the link is removed. Each link is only touched by the range holding it,
+  // so ranges can be written concurrently.
+  const auto linksBegin = this->links.begin();
+  auto writeRange = [&](std::size_t _begin, std::size_t _end,
+                        std::vector<WorldPose> &_entries)
+  {
+    for (auto it = linksBegin + _begin; it != linksBegin + _end; ++it)
+    {
+      const auto &[id, info] = *it;
+      const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+      if (!this->IsModelWritten(*model))
+        continue;
+
+      // Sleeping bodies are not integrated, and setting their pose or
+      // velocity wakes them up, so their links have not moved since they
+      // were last reported.
+      if (info->hasReportedPose && model->body && !model->body->isAwake())
+        continue;
+
+      WorldPose wp;
+      wp.pose = gz::math::eigen3::convert(
+          this->LinkWorldTransform(*model, *info));
+      wp.body = id;
+
+      if (!info->hasReportedPose ||
+          !info->reportedPose.Pos().Equal(wp.pose.Pos(), 1e-6) ||
+          !info->reportedPose.Rot().Equal(wp.pose.Rot(), 1e-6))
+      {
+        _entries.push_back(wp);
+        info->reportedPose = wp.pose;
+        info->hasReportedPose = true;
+      }
+    }
+  };
+
+  const std::size_t count = this->links.size();
+  if (!this->poseWriter.IsParallel(count))
+  {
+    writeRange(0u, count, _changedPoses.entries);
+    return;
+  }
+
+  // Compute the link poses of every model up front, since the ranges would
+  // otherwise fill the cache of a model concurrently.
+  for (const auto &[id, model] : this->models)
+  {
+    if (model->body && this->IsModelWritten(*model))
+      this->LinkInertiaPoses(*model);
+  }
+
+  this->poseWriter.Write(count, this->taskScheduler.get(),
+      _changedPoses.entries, writeRange);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(WorldTwists &_twists) const
+{
+  _twists.entries.clear();
+  _twists.entries.reserve(this->links.size());
+
+  for (const auto &[id, info] : this->links)
+  {
+    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+    if (!this->IsModelWritten(*model))
+      continue;
+
+    WorldTwist twist;
+    LinkWorldTwist(*model, *info, twist);
+    twist.body = id;
+    _twists.entries.push_back(twist);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(ChangedWorldTwists &_changedTwists,
+    const ChangedWorldPoses &_changedPoses) const
+{
+  _changedTwists.entries.clear();
+  _changedTwists.entries.reserve(_changedPoses.entries.size());
+
+  for (const auto &wp : _changedPoses.entries)
+  {
+    WorldTwist twist;
+    twist.body = wp.body;
+    const auto linkIt = this->links.find(wp.body);
+    if (linkIt != this->links.end())
+    {
+      const auto &info = linkIt->second;
+      const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+      LinkWorldTwist(*model, *info, twist);
+    }
+    _changedTwists.entries.push_back(twist);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WriteTwists(ForwardStep::Output &_h) const
+{
+  if (auto *twists = _h.Query<WorldTwists>())
+    this->Write(*twists);
+  if (auto *changedTwists = _h.Query<ChangedWorldTwists>())
+    this->Write(*changedTwists, _h.Get<ChangedWorldPoses>());
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::RecordPreStepVelocities(
+    const ForwardStep::Output &_h)
+{
+  if (!_h.Query<WorldAccelerations>() &&
+      !_h.Query<ChangedWorldAccelerations>())
+  {
+    return;
+  }
+
+  for (const auto &[id, info] : this->links)
+  {
+    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+    if (!this->IsModelWritten(*model))
+      continue;
+
+    WorldTwist twist;
+    LinkWorldTwist(*model, *info, twist);
+    info->preStepLinearVelocity = twist.linearVelocity;
+    info->preStepAngularVelocity = twist.angularVelocity;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the world acceleration of a link over the last step to
+/// _acceleration, from its velocity before the step.
+static void LinkWorldAcceleration(const ModelInfo &_model,
+    const LinkInfo &_link, const double _stepSize,
+    WorldAcceleration &_acceleration)
+{
+  WorldTwist twist;
+  LinkWorldTwist(_model, _link, twist);
+  _acceleration.linearAcceleration =
+      (twist.linearVelocity - _link.preStepLinearVelocity) / _stepSize;
+  _acceleration.angularAcceleration =
+      (twist.angularVelocity - _link.preStepAngularVelocity) / _stepSize;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(WorldAccelerations &_accelerations) const
+{
+  _accelerations.entries.clear();
+  _accelerations.entries.reserve(this->links.size());
+
+  for (const auto &[id, info] : this->links)
+  {
+    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+    if (!this->IsModelWritten(*model))
+      continue;
+
+    WorldAcceleration acceleration;
+    LinkWorldAcceleration(*model, *info, this->LastStepSize(*model),
+                          acceleration);
+    acceleration.body = id;
+    _accelerations.entries.push_back(acceleration);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(
+    ChangedWorldAccelerations &_changedAccelerations,
+    const ChangedWorldPoses &_changedPoses) const
+{
+  _changedAccelerations.entries.clear();
+  _changedAccelerations.entries.reserve(_changedPoses.entries.size());
+
+  for (const auto &wp : _changedPoses.entries)
+  {
+    WorldAcceleration acceleration;
+    acceleration.body = wp.body;
+    const auto linkIt = this->links.find(wp.body);
+    if (linkIt != this->links.end())
+    {
+      const auto &info = linkIt->second;
+      const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+      LinkWorldAcceleration(*model, *info, this->LastStepSize(*model),
+                            acceleration);
+    }
+    _changedAccelerations.entries.push_back(acceleration);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WriteAccelerations(ForwardStep::Output &_h) const
+{
+  if (auto *accelerations = _h.Query<WorldAccelerations>())
+    this->Write(*accelerations);
+  if (auto *changedAccelerations = _h.Query<ChangedWorldAccelerations>())
+    this->Write(*changedAccelerations, _h.Get<ChangedWorldPoses>());
+}
+
+/////////////////////////////////////////////////
+/// \brief Clear the arrays of a JointStates or ChangedJointStates, keeping
+/// room for _size entries.
+template <typename StatesT>
+static void ClearJointStates(StatesT &_states, const std::size_t _size)
+{
+  for (auto *values : {&_states.joints, &_states.dofs})
+  {
+    values->clear();
+    values->reserve(_size);
+  }
+  for (auto *values : {&_states.positions, &_states.velocities,
+                       &_states.accelerations, &_states.efforts})
+  {
+    values->clear();
+    values->reserve(_size);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Append the state of every degree of freedom of a joint of a
+/// multibody to a JointStates or ChangedJointStates. Bullet does not give
+/// the accelerations of the joints, so they are NaN like in
+/// GetJointAcceleration.
+template <typename StatesT>
+static void AppendJointState(StatesT &_states, const std::size_t _id,
+    const btMultiBody &_body, const int _index)
+{
+  const auto numDofs =
+      static_cast<std::size_t>(_body.getLink(_index).m_dofCount);
+  const btScalar *positions = _body.getJointPosMultiDof(_index);
+  const btScalar *velocities = _body.getJointVelMultiDof(_index);
+  const btScalar *torques = _body.getJointTorqueMultiDof(_index);
+  for (std::size_t i = 0; i < numDofs; ++i)
+  {
+    _states.joints.push_back(_id);
+    _states.dofs.push_back(i);
+    _states.positions.push_back(positions[i]);
+    _states.velocities.push_back(velocities[i]);
+    _states.accelerations.push_back(gz::math::NAN_D);
+    _states.efforts.push_back(torques[i]);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(JointStates &_states) const
+{
+  ClearJointStates(_states, this->joints.size());
+
+  for (const auto &[id, info] : this->joints)
+  {
+    const auto *identifier = std::get_if<InternalJoint>(&info->identifier);
+    if (!identifier)
+      continue;
+
+    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+    if (!this->IsModelWritten(*model))
+      continue;
+
+    AppendJointState(_states, id, *model->body, identifier->indexInBtModel);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(ChangedJointStates &_changedStates) const
+{
+  ClearJointStates(_changedStates, this->joints.size());
+
+  // Same tolerance as the one of ChangedWorldPoses
+  const double tol = 1e-6;
+  for (const auto &[id, info] : this->joints)
+  {
+    const auto *identifier = std::get_if<InternalJoint>(&info->identifier);
+    if (!identifier)
+      continue;
+
+    const auto &model = this->ReferenceInterface<ModelInfo>(info->model);
+    if (!this->IsModelWritten(*model))
+      continue;
+
+    const btMultiBody &body = *model->body;
+    const int index = identifier->indexInBtModel;
+    const auto numDofs =
+        static_cast<std::size_t>(body.getLink(index).m_dofCount);
+    const btScalar *positions = body.getJointPosMultiDof(index);
+    const btScalar *velocities = body.getJointVelMultiDof(index);
+
+    auto &reported = info->reportedState;
+    bool changed = reported.size() != 2 * numDofs;
+    for (std::size_t d = 0; !changed && d < numDofs; ++d)
+    {
+      changed = std::abs(positions[d] - reported[d]) > tol ||
+          std::abs(velocities[d] - reported[numDofs + d]) > tol;
+    }
+    if (!changed)
+      continue;
+
+    reported.resize(2 * numDofs);
+    for (std::size_t d = 0; d < numDofs; ++d)
+    {
+      reported[d] = positions[d];
+      reported[numDofs + d] = velocities[d];
+    }
+    AppendJointState(_changedStates, id, body, index);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WriteJointStates(ForwardStep::Output &_h) const
+{
+  if (auto *states = _h.Query<JointStates>())
+    this->Write(*states);
+  if (auto *changedStates = _h.Query<ChangedJointStates>())
+    this->Write(*changedStates);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEnginePoseWriteThreads(
+    const Identity &/*_engineID*/,
+    std::size_t _numThreads,
+    std::size_t _minLinks)
+{
+  this->poseWriter.Set(_numThreads, _minLinks);
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::GetEnginePoseWriteThreads(
+    const Identity &/*_engineID*/) const
+{
+  return this->poseWriter.GetThreads();
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::GetEnginePoseWriteMinLinks(
+    const Identity &/*_engineID*/) const
+{
+  return this->poseWriter.GetMinLinks();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEngineDeterministic(
+    const Identity &/*_engineID*/, bool _deterministic)
+{
+  this->deterministic = _deterministic;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetEngineDeterministic(
+    const Identity &/*_engineID*/) const
+{
+  return this->deterministic;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEngineTaskScheduler(
+    const Identity &/*_engineID*/, std::shared_ptr<TaskScheduler> _scheduler)
+{
+  this->taskScheduler = std::move(_scheduler);
+
+  // The pools are not used while there is a scheduler. Bullet switches to
+  // it before the next step of a world.
+  if (this->taskScheduler)
+  {
+    this->stepWorldsPool.reset();
+    this->stepWorldsPoolThreads = 0u;
+    this->poseWriter.ReleasePool();
+    this->rayPool.reset();
+    this->rayPoolThreads = 0u;
+  }
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<TaskScheduler> SimulationFeatures::GetEngineTaskScheduler(
+    const Identity &/*_engineID*/) const
+{
+  return this->taskScheduler;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleepEnabled(
+    const Identity &_modelID, bool _enabled)
+{
+  auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  if (!model->body)
+    return;
+  model->body->setCanSleep(_enabled);
+  if (!_enabled)
+    model->body->wakeUp();
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelSleepEnabled(
+    const Identity &_modelID) const
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  return model->body && model->body->getCanSleep();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleeping(
+    const Identity &_modelID, bool _sleeping)
+{
+  auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  auto *body = model->body.get();
+  if (!body || (_sleeping && !body->getCanSleep()))
+    return;
+
+  // bullet only updates the activation state of the colliders at the end of
+  // a step, so set them as well for the change to apply to the next step.
+  // A body that still moves is woken again by bullet, so stop it first.
+  std::vector<btMultiBodyLinkCollider *> colliders;
+  if (body->getBaseCollider())
+    colliders.push_back(body->getBaseCollider());
+  for (int i = 0; i < body->getNumLinks(); ++i)
+  {
+    if (body->getLink(i).m_collider)
+      colliders.push_back(body->getLink(i).m_collider);
+  }
+
+  if (!_sleeping)
+  {
+    body->wakeUp();
+    for (auto *collider : colliders)
+      collider->activate(true);
+    return;
+  }
+
+  body->setBaseVel(btVector3(0, 0, 0));
+  body->setBaseOmega(btVector3(0, 0, 0));
+  for (int i = 0; i < body->getNumLinks(); ++i)
+  {
+    btScalar *vel = body->getJointVelMultiDof(i);
+    for (int j = 0; j < body->getLink(i).m_dofCount; ++j)
+      vel[j] = 0;
+  }
+  body->goToSleep();
+  for (auto *collider : colliders)
+    collider->setActivationState(ISLAND_SLEEPING);
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelSleeping(
+    const Identity &_modelID) const
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  return model->body && !model->body->isAwake();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleepThresholds(
+    const Identity &_modelID, const SleepThresholds &_thresholds)
+{
+  auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  if (!model->body)
+    return;
+
+#if BT_BULLET_VERSION >= 289
+  model->sleepLinearSpeed = static_cast<btScalar>(_thresholds.linearSpeed);
+  model->sleepAngularSpeed = static_cast<btScalar>(_thresholds.angularSpeed);
+  model->sleepTimeout = static_cast<btScalar>(_thresholds.timeout);
+  model->body->setSleepThreshold(
+      model->sleepLinearSpeed * model->sleepLinearSpeed +
+      model->sleepAngularSpeed * model->sleepAngularSpeed);
+  model->body->setSleepTimeout(model->sleepTimeout);
+#else
+  gzerr << "Sleep thresholds require bullet 2.89 or newer. Model ["
+        << model->name << "] is left unchanged.\n";
+#endif
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::GetModelSleepThresholds(
+    const Identity &_modelID) const -> SleepThresholds
+{
+  const auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  SleepThresholds thresholds;
+  thresholds.linearSpeed = model->sleepLinearSpeed;
+  thresholds.angularSpeed = model->sleepAngularSpeed;
+  thresholds.timeout = model->sleepTimeout;
+  return thresholds;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelKinematic(
+    const Identity &_modelID, bool _kinematic)
+{
+  auto *model = this->ReferenceInterface<ModelInfo>(_modelID);
+  auto *body = model->body.get();
+  if (!body || model->kinematic == _kinematic)
+    return;
+
+#if BT_BULLET_VERSION >= 289
+  this->InvalidateFrameData();
+  if (_kinematic)
+  {
+    // The base is fixed so that contacts and joints cannot move it, and its
+    // velocity is kept aside to move it between steps instead.
+    model->fixedBaseBeforeKinematic = body->hasFixedBase();
+    model->kinematicLinearVelocity = body->getBaseVel();
+    model->kinematicAngularVelocity = body->getBaseOmega();
+    body->setBaseVel(btVector3(0, 0, 0));
+    body->setBaseOmega(btVector3(0, 0, 0));
+    body->setFixedBase(true);
+  }
+  else
+  {
+    body->setFixedBase(model->fixedBaseBeforeKinematic);
+    if (!model->fixedBaseBeforeKinematic)
+    {
+      body->setBaseVel(model->kinematicLinearVelocity);
+      body->setBaseOmega(model->kinematicAngularVelocity);
+    }
+  }
+  model->kinematic = _kinematic;
+  body->wakeUp();
+#else
+  gzerr << "Kinematic models require bullet 2.89 or newer. Model ["
+        << model->name << "] is left unchanged.\n";
+#endif
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelKinematic(
+    const Identity &_modelID) const
+{
+  return this->ReferenceInterface<ModelInfo>(_modelID)->kinematic;
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::AddWorldForceField(
+    const Identity &_worldID, const ForceField &_field)
+{
+  auto &worldFields = this->forceFields[_worldID.id];
+  const std::size_t id = worldFields.nextID++;
+  worldFields.fields.emplace(id, _field);
+  return id;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::SetWorldForceField(
+    const Identity &_worldID,
+    std::size_t _fieldID,
+    const ForceField &_field)
+{
+  const auto worldIt = this->forceFields.find(_worldID.id);
+  if (worldIt == this->forceFields.end())
+    return false;
+
+  const auto fieldIt = worldIt->second.fields.find(_fieldID);
+  if (fieldIt == worldIt->second.fields.end())
+    return false;
+
+  fieldIt->second = _field;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::RemoveWorldForceField(
+    const Identity &_worldID, std::size_t _fieldID)
+{
+  const auto worldIt = this->forceFields.find(_worldID.id);
+  return worldIt != this->forceFields.end() &&
+      worldIt->second.fields.erase(_fieldID) > 0;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::ApplyForceFields(
+    const std::unordered_set<std::size_t> &_worldIDs)
+{
+  for (const std::size_t worldID : _worldIDs)
+  {
+    const auto worldIt = this->forceFields.find(worldID);
+    if (worldIt == this->forceFields.end() || worldIt->second.fields.empty())
+      continue;
+
+    const Eigen::Vector3d g =
+        convert(this->worlds.at(worldID)->world->getGravity());
+    Eigen::Vector3d force;
+    Eigen::Vector3d torque;
+    for (const auto &[fieldID, field] : worldIt->second.fields)
+    {
+      for (const ForceFieldLink &fieldLink : field.links)
+      {
+        const auto linkIt = this->links.find(fieldLink.link);
+        if (linkIt == this->links.end())
+          continue;
+
+        const LinkInfo &link = *linkIt->second;
+        const auto modelIt = this->models.find(link.model);
+        if (modelIt == this->models.end() || !modelIt->second->body ||
+            modelIt->second->world.id != worldID)
+        {
+          continue;
+        }
+
+        // Bullet link and base frames are at the center of mass, so the
+        // force needs no torque correction.
+        auto *body = modelIt->second->body.get();
+        if (link.indexInModel.has_value())
+        {
+          const int index = *link.indexInModel;
+          const auto &velocity = body->getLink(index).m_absFrameTotVelocity;
+          ComputeForceFieldWrench(field, fieldLink, g,
+              convert(velocity.getLinear()), convert(velocity.getAngular()),
+              force, torque);
+          body->addLinkForce(index, convertVec(force));
+          body->addLinkTorque(index, convertVec(torque));
+        }
+        else
+        {
+          ComputeForceFieldWrench(field, fieldLink, g,
+              convert(body->getBaseVel()), convert(body->getBaseOmega()),
+              force, torque);
+          body->addBaseForce(convertVec(force));
+          body->addBaseTorque(convertVec(torque));
+        }
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::IntegrateKinematicModels(
+    const std::unordered_set<std::size_t> &_worldIDs)
+{
+  for (const auto &[id, model] : this->models)
+  {
+    if (!model->kinematic || !model->body ||
+        !_worldIDs.count(model->world.id))
+    {
+      continue;
+    }
+
+    const btVector3 &v = model->kinematicLinearVelocity;
+    const btVector3 &w = model->kinematicAngularVelocity;
+    if (v.isZero() && w.isZero())
+      continue;
+
+    const auto *worldInfo = this->ReferenceInterface<WorldInfo>(model->world);
+    const btScalar stepSize = NextBulletStepSize(
+        *worldInfo, static_cast<btScalar>(this->stepSize));
+    btTransform next;
+    btTransformUtil::integrateTransform(
+        model->body->getBaseWorldTransform(), v, w, stepSize, next);
+    model->body->setBaseWorldTransform(next);
+    model->body->wakeUp();
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldContactFilter(
+    const Identity &_worldID, const std::vector<std::size_t> &_entities)
+{
+  if (_entities.empty())
+  {
+    this->contactFilters.erase(_worldID.id);
+  }
+  else
+  {
+    this->contactFilters.insert_or_assign(
+        _worldID.id, ContactFilter(_entities));
+  }
+}
+
+/////////////////////////////////////////////////
+std::vector<std::size_t> SimulationFeatures::GetWorldContactFilter(
+    const Identity &_worldID) const
+{
+  const auto *filter = this->FindContactFilter(_worldID);
+  if (!filter)
+    return {};
+  return filter->Entities();
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::FindContactFilter(const Identity &_worldID) const
+    -> const ContactFilter *
+{
+  const auto it = this->contactFilters.find(_worldID.id);
+  return it == this->contactFilters.end() ? nullptr : &it->second;
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::StepThreads(const WorldInfo &_world) const
+{
+  // Bullet's task scheduler hands out work to whichever thread is free, and
+  // the multithreaded dispatcher records contact manifolds in the order the
+  // threads finish, so the result of a multithreaded step depends on timing.
+  return this->deterministic ? 1u : _world.numThreads;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::IsModelWritten(const ModelInfo &_model) const
+{
+  return !this->filterWrittenLinks || _model.world.id == this->writeWorldID;
 }
 }  // namespace bullet_featherstone
 }  // namespace physics
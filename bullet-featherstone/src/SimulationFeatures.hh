@@ -18,12 +18,29 @@
 #ifndef GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_SIMULATIONFEATURES_HH_
 #define GZ_PHYSICS_BULLET_FEATHERSTONE_SRC_SIMULATIONFEATURES_HH_
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <gz/common/WorkerPool.hh>
+
 #include <gz/physics/CanWriteData.hh>
+#include <gz/physics/ForceField.hh>
 #include <gz/physics/ForwardStep.hh>
 #include <gz/physics/GetContacts.hh>
+#include <gz/physics/KinematicModel.hh>
+#include <gz/physics/RayIntersection.hh>
+#include <gz/physics/ShapeQueries.hh>
+#include <gz/physics/SharedStateRing.hh>
+#include <gz/physics/Sleep.hh>
+#include <gz/physics/TaskScheduler.hh>
+#include <gz/physics/World.hh>
 
 #include "Base.hh"
 
@@ -33,7 +50,29 @@ namespace bullet_featherstone {
 
 struct SimulationFeatureList : gz::physics::FeatureList<
   ForwardStep,
-  GetContactsFromLastStepFeature
+  StepWorldsFeature,
+  ConcurrentWorldStepFeature,
+  AsyncForwardStepFeature,
+  SharedStateExportFeature,
+  GetContactsFromLastStepFeature,
+  GetContactBatchFromLastStepFeature,
+  GetContactPairsFromLastStepFeature,
+  ContactFilterFeature,
+  ContactEventsFeature,
+  WorldStateSnapshotFeature,
+  GetStepStatisticsFeature,
+  GetModelStepStatisticsFeature,
+  GetMemoryUsageFeature,
+  ParallelPoseWriteFeature,
+  DeterministicStepFeature,
+  RayIntersectionFeature,
+  ShapeQueryFeature,
+  ShapeDistanceFeature,
+  SleepFeature,
+  SleepThresholdsFeature,
+  KinematicModelFeature,
+  ForceFieldFeature,
+  TaskSchedulerFeature
 > { };
 
 class SimulationFeatures :
@@ -45,6 +84,29 @@ class SimulationFeatures :
 {
   public: using GetContactsFromLastStepFeature::Implementation<FeaturePolicy3d>
     ::ContactInternal;
+  public: using GetContactBatchFromLastStepFeature::Implementation<
+    FeaturePolicy3d>::ContactBatch;
+  public: using ContactPairBatch =
+    GetContactPairsFromLastStepFeature::ContactPairBatchT<FeaturePolicy3d>;
+  public: using ContactFilter =
+    ContactFilterFeature::Implementation<FeaturePolicy3d>::ContactFilter;
+  public: using ContactEventBatch = ContactEventsFeature::ContactEventBatch;
+  public: using ContactEventTracker =
+    ContactEventsFeature::Implementation<FeaturePolicy3d>::ContactEventTracker;
+  public: using Snapshot = WorldStateSnapshotFeature::Snapshot;
+  public: using StepStatistics = GetStepStatisticsFeature::StepStatistics;
+  public: using ModelStepStatistics =
+    GetModelStepStatisticsFeature::ModelStepStatistics;
+  public: using MemoryUsage = GetMemoryUsageFeature::MemoryUsage;
+  public: using RayIntersectionBatch =
+    RayIntersectionFeature::RayIntersectionBatchT<FeaturePolicy3d>;
+  public: using QueryVolume =
+    ShapeQueryFeature::QueryVolumeT<FeaturePolicy3d>;
+  public: using OverlapBatch =
+    ShapeQueryFeature::OverlapBatchT<FeaturePolicy3d>;
+  public: using ShapeDistance =
+    ShapeDistanceFeature::ShapeDistanceT<FeaturePolicy3d>;
+  public: using ShapePair = std::pair<std::size_t, std::size_t>;
 
   public: void WorldForwardStep(
       const Identity &_worldID,
@@ -52,17 +114,427 @@ class SimulationFeatures :
       ForwardStep::State &_x,
       const ForwardStep::Input &_u) override;
 
+  public: void StepEngineWorlds(
+      const Identity &_engineID,
+      const std::size_t *_worldIDs,
+      std::size_t _count,
+      ForwardStep::Output &_h,
+      ForwardStep::State &_x,
+      const ForwardStep::Input &_u,
+      std::size_t _numThreads) override;
+
+  public: std::shared_mutex &EngineEntityChangeMutex(
+      const Identity &_engineID) override;
+
+  public: void SetWorldSharedStateExport(
+      const Identity &_worldID,
+      std::shared_ptr<SharedStateRingWriter> _writer) override;
+
+  public: std::shared_future<void> StartWorldStep(
+      const Identity &_worldID,
+      const ForwardStep::Input &_u) override;
+
+  public: const ForwardStep::Output &FinishWorldStep(
+      const Identity &_worldID) override;
+
   public: void Write(WorldPoses &_worldPoses) const;
   public: void Write(ChangedWorldPoses &_changedPoses) const;
+  public: void Write(WorldTwists &_twists) const;
+  public: void Write(ChangedWorldTwists &_changedTwists,
+                     const ChangedWorldPoses &_changedPoses) const;
+  public: void Write(WorldAccelerations &_accelerations) const;
+  public: void Write(ChangedWorldAccelerations &_changedAccelerations,
+                     const ChangedWorldPoses &_changedPoses) const;
+  public: void Write(JointStates &_states) const;
+  public: void Write(ChangedJointStates &_changedStates) const;
 
   public: std::vector<ContactInternal> GetContactsFromLastStep(
       const Identity &_worldID) const override;
 
+  public: ContactBatch GetContactBatchFromLastStep(
+      const Identity &_worldID) const override;
+
+  public: ContactPairBatch GetContactPairsFromLastStep(
+      const Identity &_worldID) const override;
+
+  public: void SetWorldContactFilter(
+      const Identity &_worldID,
+      const std::vector<std::size_t> &_entities) override;
+
+  public: std::vector<std::size_t> GetWorldContactFilter(
+      const Identity &_worldID) const override;
+
+  public: ContactEventBatch GetContactEvents(
+      const Identity &_worldID) const override;
+
+  public: Snapshot GetWorldStateSnapshot(
+      const Identity &_worldID) const override;
+
+  public: bool SetWorldStateSnapshot(
+      const Identity &_worldID, const Snapshot &_snapshot) override;
+
+  public: StepStatistics GetWorldStepStatistics(
+      const Identity &_worldID) const override;
+
+  public: void SetWorldModelStepStatisticsEnabled(
+      const Identity &_worldID, bool _enable) override;
+
+  public: std::vector<ModelStepStatistics> GetWorldModelStepStatistics(
+      const Identity &_worldID) const override;
+
+  public: MemoryUsage GetWorldMemoryUsage(
+      const Identity &_worldID) const override;
+
+  public: void SetEnginePoseWriteThreads(
+      const Identity &_engineID,
+      std::size_t _numThreads,
+      std::size_t _minLinks) override;
+
+  public: std::size_t GetEnginePoseWriteThreads(
+      const Identity &_engineID) const override;
+
+  public: std::size_t GetEnginePoseWriteMinLinks(
+      const Identity &_engineID) const override;
+
+  public: void SetEngineDeterministic(
+      const Identity &_engineID, bool _deterministic) override;
+
+  public: bool GetEngineDeterministic(
+      const Identity &_engineID) const override;
+
+  public: void SetEngineTaskScheduler(
+      const Identity &_engineID,
+      std::shared_ptr<TaskScheduler> _scheduler) override;
+
+  public: std::shared_ptr<TaskScheduler> GetEngineTaskScheduler(
+      const Identity &_engineID) const override;
+
+  public: void SetModelSleepEnabled(
+      const Identity &_modelID, bool _enabled) override;
+
+  public: bool GetModelSleepEnabled(
+      const Identity &_modelID) const override;
+
+  public: void SetModelSleeping(
+      const Identity &_modelID, bool _sleeping) override;
+
+  public: bool GetModelSleeping(
+      const Identity &_modelID) const override;
+
+  public: void SetModelSleepThresholds(
+      const Identity &_modelID,
+      const SleepThresholds &_thresholds) override;
+
+  public: SleepThresholds GetModelSleepThresholds(
+      const Identity &_modelID) const override;
+
+  public: void SetModelKinematic(
+      const Identity &_modelID, bool _kinematic) override;
+
+  public: bool GetModelKinematic(
+      const Identity &_modelID) const override;
+
+  public: std::size_t AddWorldForceField(
+      const Identity &_worldID, const ForceField &_field) override;
+
+  public: bool SetWorldForceField(
+      const Identity &_worldID,
+      std::size_t _fieldID,
+      const ForceField &_field) override;
+
+  public: bool RemoveWorldForceField(
+      const Identity &_worldID, std::size_t _fieldID) override;
+
+  public: RayIntersectionBatch CastWorldRays(
+      const Identity &_worldID,
+      const LinearVector3d *_from,
+      const LinearVector3d *_to,
+      std::size_t _count,
+      std::size_t _numThreads) const override;
+
+  public: RayIntersectionBatch CastWorldShapes(
+      const Identity &_worldID,
+      const QueryVolume *_volumes,
+      const LinearVector3d *_to,
+      std::size_t _count,
+      std::size_t _numThreads) const override;
+
+  public: OverlapBatch FindWorldOverlaps(
+      const Identity &_worldID,
+      const QueryVolume *_volumes,
+      std::size_t _count,
+      std::size_t _numThreads) const override;
+
+  public: void ComputeWorldShapeDistances(
+      const Identity &_worldID,
+      const ShapePair *_pairs,
+      std::size_t _count,
+      double _cutoff,
+      ShapeDistance *_results) const override;
+
+  public: std::vector<ShapeDistance> ComputeWorldLinkDistances(
+      const Identity &_worldID,
+      const std::vector<std::size_t> &_links,
+      double _cutoff) const override;
+
+  /// \brief Find the shape of a collision of a world and its world
+  /// transform, whether it is a child of its link collider or of the baked
+  /// static collider of the world.
+  /// \param[in] _world World of the collision.
+  /// \param[in] _collisionID Entity ID of the collision.
+  /// \param[out] _shape Shape of the collision.
+  /// \param[out] _transform World transform of the shape.
+  /// \return False if the collision is not in _world.
+  private: bool FindWorldCollisionShape(
+      const WorldInfo &_world,
+      std::size_t _collisionID,
+      const btCollisionShape *&_shape,
+      btTransform &_transform) const;
+
+  /// \brief Run the queries of CastWorldRays, CastWorldShapes or
+  /// FindWorldOverlaps, on rayPool if more than one thread is requested.
+  /// \param[in] _count Number of queries.
+  /// \param[in] _numThreads Number of threads, 0 for one per core.
+  /// \param[in] _query Runs the queries of a range [_begin, _end). Ranges
+  /// run concurrently, so it must only write the results of its range.
+  private: void RunQueries(std::size_t _count, std::size_t _numThreads,
+      const std::function<void(std::size_t, std::size_t)> &_query) const;
+
+  /// \brief Cast one ray against every link collider of a world whose
+  /// bounding box it crosses.
+  /// \param[in] _world World to cast the ray in.
+  /// \param[in] _from Start of the ray in the world frame.
+  /// \param[in] _to End of the ray in the world frame.
+  /// \param[out] _distance Distance to the closest hit.
+  /// \param[out] _normal Normal at the closest hit.
+  /// \return Entity ID of the collision that was hit, or the max value of
+  /// std::size_t if the ray hit nothing.
+  private: std::size_t CastRay(
+      const WorldInfo &_world,
+      const btVector3 &_from,
+      const btVector3 &_to,
+      double &_distance,
+      Eigen::Vector3d &_normal) const;
+
+  /// \brief Estimate the memory used by a collision shape and the shapes
+  /// and meshes it refers to, skipping those already counted.
+  /// \param[in] _shape Shape to measure.
+  /// \param[in,out] _counted Shapes and meshes already counted.
+  /// \return Bytes used.
+  private: std::size_t ShapeBytes(
+      const btCollisionShape *_shape,
+      std::unordered_set<const void *> &_counted) const;
+
+  /// \brief Call a function for every contact point of the last step whose
+  /// collisions are known entities.
+  /// \param[in] _world World to read the contacts of.
+  /// \param[in] _filter Filter of the world, see ContactFilterFeature.
+  /// Contacts it rejects are skipped before they are converted. nullptr
+  /// visits all contacts.
+  /// \param[in] _func Called with the entity IDs of both collisions, the
+  /// contact point, normal, depth and force, all in the world frame.
+  private: template <typename F>
+  void ForEachContact(const WorldInfo &_world, const ContactFilter *_filter,
+      F &&_func) const;
+
+  /// \brief Write the twists requested by the output of a step, if any.
+  /// Must be called after the changed poses of the step are written.
+  /// \param[in] _h Output of the step.
+  private: void WriteTwists(ForwardStep::Output &_h) const;
+
+  /// \brief Record the world velocities of the links before a step, if the
+  /// output of the step has accelerations. Bullet does not keep the
+  /// accelerations of the links, so they are computed from the change of
+  /// the velocities over the step.
+  /// \param[in] _h Output of the step.
+  private: void RecordPreStepVelocities(const ForwardStep::Output &_h);
+
+  /// \brief Write the accelerations requested by the output of a step, if
+  /// any. Must be called after the changed poses of the step are written.
+  /// \param[in] _h Output of the step.
+  private: void WriteAccelerations(ForwardStep::Output &_h) const;
+
+  /// \brief Write the joint states requested by the output of a step, if
+  /// any.
+  /// \param[in] _h Output of the step.
+  private: void WriteJointStates(ForwardStep::Output &_h) const;
+
+  /// \brief Find the contact filter of a world.
+  /// \param[in] _worldID World to get the filter of.
+  /// \return The filter, or nullptr if the world reports all contacts.
+  private: const ContactFilter *FindContactFilter(
+      const Identity &_worldID) const;
+
+  /// \brief Find the link of a collider from the link entity ID stored in its
+  /// user index.
+  /// \param[in] _collider Collision object reported by bullet.
+  /// \return The link, or nullptr if the collider does not belong to a known
+  /// link.
+  private: const LinkInfo *FindLinkOfCollider(
+      const btCollisionObject *_collider) const;
+
+  /// \brief Find the collision entity held by a child of a link's compound
+  /// shape.
+  /// \param[in] _link Link owning the compound shape.
+  /// \param[in] _childIndex Child index recorded in the contact point.
+  /// \return Entity ID of the collision, or the max value of std::size_t if
+  /// it could not be resolved.
+  private: std::size_t FindCollisionOfChild(
+      const LinkInfo &_link, int _childIndex) const;
+
+  /// \brief Find the collision entity held by a child of the compound shape
+  /// of a link collider or of the baked static collider of a world.
+  /// \param[in] _link Link of the collider, or nullptr if it is baked.
+  /// \param[in] _baked Baked static collisions of the collider, used if _link
+  /// is nullptr.
+  /// \param[in] _childIndex Child index recorded in the contact point.
+  /// \return Entity ID of the collision, or the max value of std::size_t if
+  /// it could not be resolved.
+  private: std::size_t FindCollisionOfChild(
+      const LinkInfo *_link, const BakedStaticCollisions *_baked,
+      int _childIndex) const;
+
+  /// \brief Set the step size from the input of a step, if the input has
+  /// one.
+  /// \param[in] _u Input of the step.
+  private: void UpdateStepSize(const ForwardStep::Input &_u);
+
+  /// \brief Get the length of the last step of the world of a model, which
+  /// differs from stepSize if the world has adaptive stepping enabled.
+  /// \param[in] _model The model.
+  /// \return Length of the last step, in seconds.
+  private: double LastStepSize(const ModelInfo &_model) const;
+
+  /// \brief Number of bullet threads to step a world with.
+  /// \param[in] _world World to step.
+  /// \return The thread count of the world, or 1 when stepping
+  /// deterministically.
+  private: std::size_t StepThreads(const WorldInfo &_world) const;
+
+  /// \brief Whether the write-out of the current step includes the links
+  /// and joints of a model, see filterWrittenLinks.
+  /// \param[in] _model The model
+  /// \return True if the model is written.
+  private: bool IsModelWritten(const ModelInfo &_model) const;
+
+  /// \brief Move the bases of the kinematic models of some worlds by their
+  /// kinematic velocities over one step.
+  /// \param[in] _worldIDs Worlds about to be stepped.
+  private: void IntegrateKinematicModels(
+      const std::unordered_set<std::size_t> &_worldIDs);
+
+  /// \brief Add the wrenches of the force fields of some worlds to their
+  /// links, see ForceFieldFeature. Bullet clears them after the step.
+  /// \param[in] _worldIDs Worlds about to be stepped.
+  private: void ApplyForceFields(
+      const std::unordered_set<std::size_t> &_worldIDs);
+
+  /// \brief Force fields of a world, see ForceFieldFeature.
+  private: struct WorldForceFields
+  {
+    /// \brief ID of the next field that is added
+    std::size_t nextID = 0u;
+
+    /// \brief Fields of the world, by field ID
+    std::map<std::size_t, ForceField> fields;
+  };
+
+  /// \brief Force fields, by world ID.
+  private: std::unordered_map<std::size_t, WorldForceFields> forceFields;
+
+  /// \brief Write the state of a world to its shared state ring, if it has
+  /// one. See SharedStateExportFeature. Called after stepping.
+  /// \param[in] _worldID ID of the world.
+  private: void ExportSharedState(std::size_t _worldID) const;
+
+  /// \brief Writers of the worlds that export their state, by world ID.
+  /// See SharedStateExportFeature.
+  private: std::unordered_map<std::size_t,
+      std::shared_ptr<SharedStateRingWriter>> sharedStateExports;
+
   private: double stepSize = 0.001;
 
-  /// \brief link poses from the most recent pose change/update.
-  /// The key is the link's ID, and the value is the link's pose
-  private: mutable std::unordered_map<std::size_t, math::Pose3d> prevLinkPoses;
+  /// \brief Held shared by WorldForwardStep and by LockEntityState, and
+  /// exclusively by LockEntityChanges, so that entities do not change while
+  /// worlds are stepped or queried concurrently.
+  private: std::shared_mutex entityChangeMutex;
+
+  /// \brief Serializes the parts of concurrent calls to WorldForwardStep
+  /// that use the state shared by the worlds of the engine. The
+  /// integration of each world runs outside of it.
+  private: std::mutex stepMutex;
+
+  /// \brief Whether the write-out of the current step only includes the
+  /// models of writeWorldID. Set by WorldForwardStep when the engine has
+  /// more than one world, since other worlds may be stepped at the same
+  /// time.
+  private: bool filterWrittenLinks = false;
+
+  /// \brief World whose models are being written, see filterWrittenLinks.
+  private: std::size_t writeWorldID = 0u;
+
+  /// \brief Thread pool used by StepEngineWorlds without a task
+  /// scheduler. Created on first use.
+  private: std::unique_ptr<gz::common::WorkerPool> stepWorldsPool;
+
+  /// \brief Number of threads of stepWorldsPool.
+  private: std::size_t stepWorldsPoolThreads = 0;
+
+  /// \brief Buffers backing the views returned by
+  /// GetContactBatchFromLastStep.
+  private: mutable GetContactBatchFromLastStepFeature::Implementation<
+    FeaturePolicy3d>::ContactBatchStorage contactBatch;
+
+  /// \brief Buffers backing the views returned by
+  /// GetContactPairsFromLastStep.
+  private: mutable GetContactPairsFromLastStepFeature::Implementation<
+    FeaturePolicy3d>::ContactPairStorage contactPairs;
+
+  /// \brief Settings, threads and buffers of the parallel pose write-out.
+  private: mutable ParallelPoseWriteFeature::Implementation<
+      FeaturePolicy3d>::PoseWriter poseWriter;
+
+  /// \brief Contact filters by world ID, for worlds that have one. See
+  /// ContactFilterFeature.
+  private: std::unordered_map<std::size_t, ContactFilter> contactFilters;
+
+  /// \brief Pairs in contact and events by world ID, for worlds whose
+  /// events were requested. See ContactEventsFeature.
+  private: mutable std::unordered_map<std::size_t, ContactEventTracker>
+      contactEvents;
+
+  /// \brief Whether worlds are stepped deterministically, see
+  /// DeterministicStepFeature.
+  private: bool deterministic = false;
+
+  /// \brief Buffers backing the views returned by CastWorldRays and
+  /// CastWorldShapes.
+  private: mutable RayIntersectionStorage rayHits;
+
+  /// \brief Buffers backing the views returned by FindWorldOverlaps.
+  private: mutable OverlapStorage overlaps;
+
+  /// \brief Overlapping collisions of each volume of the most recent
+  /// FindWorldOverlaps call.
+  private: mutable std::vector<std::vector<std::size_t>> volumeOverlaps;
+
+  /// \brief Thread pool used by the ray and shape queries. Created when more
+  /// than one thread is requested.
+  private: mutable std::unique_ptr<gz::common::WorkerPool> rayPool;
+
+  /// \brief Number of threads of rayPool.
+  private: mutable std::size_t rayPoolThreads = 0u;
+
+  /// \brief Steppers of the worlds stepped through AsyncForwardStepFeature.
+  /// Declared last, so the steps in flight finish before the other members
+  /// are destroyed.
+  private: AsyncForwardStepFeature::Implementation<FeaturePolicy3d>::
+      AsyncSteppers asyncSteppers{
+          [this](const Identity &_worldID, ForwardStep::Output &_h,
+                 ForwardStep::State &_x, const ForwardStep::Input &_u)
+          {
+            this->WorldForwardStep(_worldID, _h, _x, _u);
+          }};
 };
 
 }  // namespace bullet_featherstone
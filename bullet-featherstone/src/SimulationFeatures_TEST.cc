@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
+#include <BulletCollision/CollisionDispatch/btManifoldResult.h>
+
+#include <gz/plugin/Loader.hh>
+
+#include <gz/physics/FindFeatures.hh>
+#include <gz/physics/ForwardStep.hh>
+#include <gz/physics/GetContacts.hh>
+#include <gz/physics/GetEntities.hh>
+#include <gz/physics/RequestEngine.hh>
+#include <gz/physics/sdf/ConstructWorld.hh>
+
+#include <sdf/Root.hh>
+
+struct TestFeatureList : gz::physics::FeatureList<
+    gz::physics::ForwardStep,
+    gz::physics::GetContactsFromLastStepFeature,
+    gz::physics::GetEntities,
+    gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using TestWorld = gz::physics::World3d<TestFeatureList>;
+
+/// \brief Number of contacts seen by ApplicationContactAdded.
+static std::size_t gApplicationContacts = 0u;
+
+/////////////////////////////////////////////////
+/// \brief Contact added callback of an application that uses bullet
+/// besides the plugin.
+static bool ApplicationContactAdded(
+    btManifoldPoint &, const btCollisionObjectWrapper *, int, int,
+    const btCollisionObjectWrapper *, int, int)
+{
+  ++gApplicationContacts;
+  return false;
+}
+
+/// \brief A dumbbell of two boxes, which are children of the compound shape
+/// of its link, resting on the ground. The world steps by 1 ms.
+static const char kDumbbellWorld[] = R"(
+<sdf version="1.11">
+  <world name="dumbbell">
+    <physics type="bullet-featherstone">
+      <max_step_size>0.001</max_step_size>
+    </physics>
+    <gravity>0 0 -10</gravity>
+    <model name="ground">
+      <static>true</static>
+      <link name="link">
+        <collision name="collision">
+          <geometry>
+            <plane><normal>0 0 1</normal><size>10 10</size></plane>
+          </geometry>
+        </collision>
+      </link>
+    </model>
+    <model name="dumbbell">
+      <pose>0 0 0.1 0 0 0</pose>
+      <link name="link">
+        <inertial>
+          <mass>2</mass>
+          <inertia>
+            <ixx>0.1</ixx><iyy>0.5</iyy><izz>0.5</izz>
+          </inertia>
+        </inertial>
+        <collision name="left">
+          <pose>-0.5 0 0 0 0 0</pose>
+          <geometry><box><size>0.2 0.2 0.2</size></box></geometry>
+        </collision>
+        <collision name="right">
+          <pose>0.5 0 0 0 0 0</pose>
+          <geometry><box><size>0.2 0.2 0.2</size></box></geometry>
+        </collision>
+      </link>
+    </model>
+  </world>
+</sdf>)";
+
+/////////////////////////////////////////////////
+TEST(SimulationFeatures, CompoundChildContacts)
+{
+  // The plugin chains to the callback that was installed before its worlds
+  const ContactAddedCallback applicationCallback = gContactAddedCallback;
+  gContactAddedCallback = &ApplicationContactAdded;
+
+  gz::plugin::Loader loader;
+  loader.LoadLib(bullet_featherstone_plugin_LIB);
+  auto engine = gz::physics::RequestEngine3d<TestFeatureList>::From(
+      loader.Instantiate("gz::physics::bullet_featherstone::Plugin"));
+  ASSERT_NE(nullptr, engine);
+
+  sdf::Root root;
+  const sdf::Errors errors = root.LoadSdfString(kDumbbellWorld);
+  ASSERT_TRUE(errors.empty()) << errors.front();
+  auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+  ASSERT_NE(nullptr, world);
+  EXPECT_NE(&ApplicationContactAdded, gContactAddedCallback);
+
+  auto link = world->GetModel("dumbbell")->GetLink("link");
+  ASSERT_NE(nullptr, link);
+  const std::size_t leftID = link->GetShape("left")->EntityID();
+  const std::size_t rightID = link->GetShape("right")->EntityID();
+
+  gz::physics::ForwardStep::Output output;
+  gz::physics::ForwardStep::State state;
+  gz::physics::ForwardStep::Input input;
+  for (std::size_t i = 0; i < 1000u; ++i)
+    world->Step(output, state, input);
+  EXPECT_GT(gApplicationContacts, 0u);
+
+  // Each contact names the box it is on, rather than the last collision of
+  // the link
+  std::size_t leftContacts = 0u;
+  std::size_t rightContacts = 0u;
+  double supportForce = 0.0;
+  for (const auto &contact : world->GetContactsFromLastStep())
+  {
+    const auto &point = contact.Get<TestWorld::ContactPoint>();
+    const auto *extra = contact.Query<TestWorld::ExtraContactData>();
+    ASSERT_NE(nullptr, extra);
+
+    const bool dumbbellFirst =
+        point.collision1->GetLink()->EntityID() == link->EntityID();
+    const auto &collision =
+        dumbbellFirst ? point.collision1 : point.collision2;
+    ASSERT_EQ(link->EntityID(), collision->GetLink()->EntityID());
+    if (point.point.x() < 0.0)
+    {
+      EXPECT_EQ(leftID, collision->EntityID());
+      ++leftContacts;
+    }
+    else
+    {
+      EXPECT_EQ(rightID, collision->EntityID());
+      ++rightContacts;
+    }
+
+    // The force is that on the first body
+    supportForce += dumbbellFirst ? extra->force.z() : -extra->force.z();
+  }
+  EXPECT_GT(leftContacts, 0u);
+  EXPECT_GT(rightContacts, 0u);
+
+  // The impulses of the step divided by the step size hold up the weight of
+  // the resting dumbbell, which the impulses alone are a thousandth of
+  EXPECT_NEAR(20.0, std::abs(supportForce), 2.0);
+
+  gContactAddedCallback = applicationCallback;
+}
@@ -15,10 +15,15 @@
  *
  */
 
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <utility>
 
 #include <gz/common/Console.hh>
 
+#include <gz/physics/bullet/Broadphase.hh>
+
 #include "WorldFeatures.hh"
 
 namespace gz {
@@ -52,6 +57,247 @@ WorldFeatures::LinearVectorType WorldFeatures::GetWorldGravity(
     return WorldFeatures::LinearVectorType(0, 0, 0);
   }
 }
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldBroadphase(
+    const Identity &_id, const std::string &_broadphase)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (!worldInfo || _broadphase == worldInfo->broadphaseType)
+    return;
+
+  auto broadphase = bullet::CreateBroadphase(_broadphase, *worldInfo->world);
+  if (!broadphase)
+  {
+    gzerr << "Broadphase [" << _broadphase << "] is not supported, keeping ["
+          << worldInfo->broadphaseType << "]." << std::endl;
+    return;
+  }
+
+  GzMultiBodyDynamicsWorld &world = *worldInfo->world;
+  bullet::ReplaceBroadphase(world, broadphase.get(),
+      [&world](btBroadphaseInterface *_new) { world.SetBroadphase(_new); });
+  worldInfo->broadphase = std::move(broadphase);
+  worldInfo->broadphaseType = _broadphase;
+
+  gzmsg << "Using [" << worldInfo->broadphaseType << "] broadphase"
+        << std::endl;
+}
+
+/////////////////////////////////////////////////
+const std::string &WorldFeatures::GetWorldBroadphase(
+    const Identity &_id) const
+{
+  static const std::string empty{""};
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    return worldInfo->broadphaseType;
+  return empty;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldCollisionPairMaxContacts(
+    const Identity &_id, std::size_t _maxContacts)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  auto *dispatcher =
+    dynamic_cast<GzCollisionDispatcher *>(worldInfo->world->getDispatcher());
+  if (dispatcher)
+    dispatcher->SetMaxPairContacts(_maxContacts);
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldFeatures::GetWorldCollisionPairMaxContacts(
+    const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  const auto *dispatcher = dynamic_cast<const GzCollisionDispatcher *>(
+    worldInfo->world->getDispatcher());
+  if (dispatcher)
+    return dispatcher->GetMaxPairContacts();
+  return std::numeric_limits<std::size_t>::max();
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldNumThreads(
+    const Identity &_id, std::size_t _numThreads)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    worldInfo->numThreads = std::max<std::size_t>(1u, _numThreads);
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldFeatures::GetWorldNumThreads(const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    return worldInfo->numThreads;
+  return 0u;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSubSteps(
+    const Identity &_id, std::size_t _subSteps)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    worldInfo->subSteps = std::max<std::size_t>(1u, _subSteps);
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldFeatures::GetWorldSubSteps(const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    return worldInfo->subSteps;
+  return 0u;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldAdaptiveTimeStep(
+    const Identity &_id, const AdaptiveTimeStep::Parameters &_parameters)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    worldInfo->adaptiveTimeStep.SetParameters(_parameters);
+}
+
+/////////////////////////////////////////////////
+AdaptiveTimeStep::Parameters WorldFeatures::GetWorldAdaptiveTimeStep(
+    const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    return worldInfo->adaptiveTimeStep.GetParameters();
+  return AdaptiveTimeStep::Parameters();
+}
+
+/////////////////////////////////////////////////
+double WorldFeatures::GetWorldLastStepSize(const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    return worldInfo->lastStepSize;
+  return 0.0;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverIterations(
+    const Identity &_id, std::size_t _iterations)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+  {
+    worldInfo->world->getSolverInfo().m_numIterations =
+        static_cast<int>(_iterations);
+  }
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldFeatures::GetWorldSolverIterations(const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+  {
+    return static_cast<std::size_t>(
+        worldInfo->world->getSolverInfo().m_numIterations);
+  }
+  return 0u;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverWarmStarting(
+    const Identity &_id, bool _warmStarting)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (!worldInfo)
+    return;
+
+  auto &solverMode = worldInfo->world->getSolverInfo().m_solverMode;
+  if (_warmStarting)
+    solverMode |= SOLVER_USE_WARMSTARTING;
+  else
+    solverMode &= ~SOLVER_USE_WARMSTARTING;
+}
+
+/////////////////////////////////////////////////
+bool WorldFeatures::GetWorldSolverWarmStarting(const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  return worldInfo &&
+      (worldInfo->world->getSolverInfo().m_solverMode &
+       SOLVER_USE_WARMSTARTING) != 0;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverSplitImpulse(
+    const Identity &_id, bool _splitImpulse)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    worldInfo->world->getSolverInfo().m_splitImpulse = _splitImpulse ? 1 : 0;
+}
+
+/////////////////////////////////////////////////
+bool WorldFeatures::GetWorldSolverSplitImpulse(const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  return worldInfo && worldInfo->world->getSolverInfo().m_splitImpulse != 0;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverTolerance(
+    const Identity &_id, double _tolerance)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+  {
+    worldInfo->world->getSolverInfo().m_leastSquaresResidualThreshold =
+        static_cast<btScalar>(std::max(0.0, _tolerance));
+  }
+}
+
+/////////////////////////////////////////////////
+double WorldFeatures::GetWorldSolverTolerance(const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+  {
+    return static_cast<double>(
+        worldInfo->world->getSolverInfo().m_leastSquaresResidualThreshold);
+  }
+  return 0.0;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverStatisticsEnabled(
+    const Identity &_id, bool _enable)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (!worldInfo)
+    return;
+
+  if (auto *solver =
+      dynamic_cast<GzMultiBodyConstraintSolver *>(worldInfo->solver.get()))
+  {
+    solver->SetStatisticsEnabled(_enable);
+  }
+}
+
+/////////////////////////////////////////////////
+GetSolverStatisticsFeature::SolverStatistics
+WorldFeatures::GetWorldSolverStatistics(const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  const auto *solver = worldInfo ?
+      dynamic_cast<const GzMultiBodyConstraintSolver *>(
+          worldInfo->solver.get()) : nullptr;
+  if (!solver || !solver->GetStatisticsEnabled())
+    return GetSolverStatisticsFeature::SolverStatistics();
+  return solver->GetStatistics();
+}
+
 }
 }
 }
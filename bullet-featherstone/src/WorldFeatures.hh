@@ -29,7 +29,14 @@ namespace physics {
 namespace bullet_featherstone {
 
 struct WorldFeatureList : FeatureList<
-  Gravity
+  Broadphase,
+  CollisionPairMaxContacts,
+  Gravity,
+  NumThreads,
+  SolverProfile,
+  SubSteps,
+  AdaptiveTimeStepFeature,
+  GetSolverStatisticsFeature
 > { };
 
 class WorldFeatures :
@@ -42,6 +49,85 @@ class WorldFeatures :
 
   // Documentation inherited
   public: LinearVectorType GetWorldGravity(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldBroadphase(
+      const Identity &_id, const std::string &_broadphase) override;
+
+  // Documentation inherited
+  public: const std::string &GetWorldBroadphase(const Identity &_id)
+      const override;
+
+  // Documentation inherited
+  public: void SetWorldCollisionPairMaxContacts(
+      const Identity &_id, std::size_t _maxContacts) override;
+
+  // Documentation inherited
+  public: std::size_t GetWorldCollisionPairMaxContacts(const Identity &_id)
+      const override;
+
+  // Documentation inherited
+  public: void SetWorldNumThreads(
+      const Identity &_id, std::size_t _numThreads) override;
+
+  // Documentation inherited
+  public: std::size_t GetWorldNumThreads(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSubSteps(
+      const Identity &_id, std::size_t _subSteps) override;
+
+  // Documentation inherited
+  public: std::size_t GetWorldSubSteps(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldAdaptiveTimeStep(
+      const Identity &_id, const AdaptiveTimeStep::Parameters &_parameters)
+      override;
+
+  // Documentation inherited
+  public: AdaptiveTimeStep::Parameters GetWorldAdaptiveTimeStep(
+      const Identity &_id) const override;
+
+  // Documentation inherited
+  public: double GetWorldLastStepSize(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverIterations(
+      const Identity &_id, std::size_t _iterations) override;
+
+  // Documentation inherited
+  public: std::size_t GetWorldSolverIterations(const Identity &_id)
+      const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverWarmStarting(
+      const Identity &_id, bool _warmStarting) override;
+
+  // Documentation inherited
+  public: bool GetWorldSolverWarmStarting(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverSplitImpulse(
+      const Identity &_id, bool _splitImpulse) override;
+
+  // Documentation inherited
+  public: bool GetWorldSolverSplitImpulse(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverTolerance(
+      const Identity &_id, double _tolerance) override;
+
+  // Documentation inherited
+  public: double GetWorldSolverTolerance(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverStatisticsEnabled(
+      const Identity &_id, bool _enable) override;
+
+  // Documentation inherited
+  public: GetSolverStatisticsFeature::SolverStatistics
+      GetWorldSolverStatistics(const Identity &_id) const override;
 };
 
 }
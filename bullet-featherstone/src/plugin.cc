@@ -21,6 +21,7 @@
 #include <gz/physics/Register.hh>
 
 #include "Base.hh"
+#include "CommandFeatures.hh"
 #include "EntityManagementFeatures.hh"
 #include "FreeGroupFeatures.hh"
 #include "ShapeFeatures.hh"
@@ -36,6 +37,7 @@ namespace physics {
 namespace bullet_featherstone {
 
 struct BulletFeatures : FeatureList <
+  CommandFeatureList,
   EntityManagementFeatureList,
   SimulationFeatureList,
   FreeGroupFeatureList,
@@ -50,6 +52,7 @@ struct BulletFeatures : FeatureList <
 class Plugin :
     public virtual Implements3d<BulletFeatures>,
     public virtual Base,
+    public virtual CommandFeatures,
     public virtual EntityManagementFeatures,
     public virtual SimulationFeatures,
     public virtual FreeGroupFeatures,
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_BROADPHASE_HH_
+#define GZ_PHYSICS_BULLET_BROADPHASE_HH_
+
+#include <btBulletDynamicsCommon.h>
+
+#include <memory>
+#include <string>
+
+namespace gz
+{
+namespace physics
+{
+namespace bullet
+{
+  /// \brief Create a broadphase sized for the objects already in a world.
+  /// \param[in] _type Name of the broadphase, one of "dbvt", "simple" or
+  /// "axis_sweep".
+  /// \param[in] _world World the broadphase will be used by.
+  /// \return The broadphase, or nullptr if _type is not supported.
+  std::unique_ptr<btBroadphaseInterface> CreateBroadphase(
+      const std::string &_type, const btCollisionWorld &_world);
+
+  /// \brief Move all collision objects of a world to a new broadphase,
+  /// keeping their collision filters. The old broadphase is no longer
+  /// referenced by the world afterwards.
+  /// \param[in] _world World whose broadphase is replaced.
+  /// \param[in] _broadphase New broadphase.
+  /// \param[in] _setBroadphase Called with _broadphase once the objects
+  /// left the old one. It has to hand it to the world, and to anything
+  /// else of the world that refers to the broadphase.
+  template <typename SetBroadphaseT>
+  void ReplaceBroadphase(btCollisionWorld &_world,
+      btBroadphaseInterface *_broadphase, SetBroadphaseT &&_setBroadphase);
+}
+}
+}
+
+#include <gz/physics/bullet/detail/Broadphase.hh>
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_COLLISIONDISPATCH_HH_
+#define GZ_PHYSICS_BULLET_COLLISIONDISPATCH_HH_
+
+#include <btBulletDynamicsCommon.h>
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace gz
+{
+namespace physics
+{
+namespace bullet
+{
+  /// \brief Limits the number of contact points of each pair of collision
+  /// objects of a dispatcher, after the pairs are dispatched. Used by the
+  /// collision dispatchers of the bullet and bullet-featherstone plugins.
+  class PairContactLimiter
+  {
+    /// \brief Destructor
+    public: virtual ~PairContactLimiter() = default;
+
+    /// \brief Set the maximum number of contact points of each pair of
+    /// collision objects. The points of pairs over the maximum are chosen
+    /// to be spread out, starting from the deepest one.
+    /// \param[in] _maxContacts Maximum number of contact points per pair.
+    /// Unlimited by default.
+    public: void SetMaxPairContacts(std::size_t _maxContacts);
+
+    /// \brief Get the maximum number of contact points of each pair.
+    /// \return Maximum number of contact points per pair.
+    public: std::size_t GetMaxPairContacts() const;
+
+    /// \brief Remove the contact points of each pair of collision objects
+    /// over the maximum. A pair has a manifold for each pair of child
+    /// shapes of its compound shapes.
+    /// \param[in] _dispatcher Dispatcher that just dispatched the pairs.
+    public: void LimitPairContacts(btDispatcher &_dispatcher);
+
+    /// \brief Remove the contact points over the maximum from the manifolds
+    /// of a pair.
+    /// \param[in] _manifolds Manifolds of the dispatcher.
+    /// \param[in] _begin First entry of the pair in pairManifolds.
+    /// \param[in] _end Entry after the last one of the pair in
+    /// pairManifolds.
+    private: void LimitManifoldContacts(btPersistentManifold **_manifolds,
+        std::size_t _begin, std::size_t _end);
+
+    /// \brief A pair of collision objects and a manifold of it.
+    private: struct PairManifold
+    {
+      /// \brief Lower world array index of the objects.
+      int object1;
+
+      /// \brief Higher world array index of the objects.
+      int object2;
+
+      /// \brief Index of the manifold.
+      int manifold;
+    };
+
+    /// \brief A contact point of a manifold.
+    private: struct ManifoldPoint
+    {
+      /// \brief Index of the manifold.
+      int manifold;
+
+      /// \brief Index of the point in the manifold.
+      int point;
+    };
+
+    /// \brief Maximum number of contact points per pair.
+    private: std::size_t maxPairContacts =
+        std::numeric_limits<std::size_t>::max();
+
+    /// \brief Manifolds with contact points sorted by pair, reused across
+    /// dispatches.
+    private: std::vector<PairManifold> pairManifolds;
+
+    /// \brief Contact points of the pair being limited, kept ones first.
+    private: std::vector<ManifoldPoint> pairPoints;
+
+    /// \brief Squared distance from each contact point of the pair being
+    /// limited to the nearest kept one.
+    private: std::vector<btScalar> spreadDistances;
+  };
+
+  /// \brief Pairs of the colliders of a world that are infinite planes with
+  /// its other collision objects. The bounding box of a plane overlaps every
+  /// other collider, so planes are kept out of the overlapping pairs of the
+  /// broadphase, and each collision object is tested against them by the
+  /// lowest corner of its bounding box along their normal instead. The pairs
+  /// that pass go through the near callback like overlapping pairs, keeping
+  /// their collision algorithm and manifold while they keep passing.
+  class PlanePairs
+  {
+    /// \brief Get the plane of a collider whose only shape is an infinite
+    /// plane, either directly or as the only child of a compound shape.
+    /// \param[in] _object Collider.
+    /// \param[out] _planeToWorld Pose of the plane shape in the world.
+    /// \return The plane shape, or nullptr if the collider has other
+    /// shapes.
+    public: static const btStaticPlaneShape *PlaneShape(
+        const btCollisionObject *_object, btTransform &_planeToWorld);
+
+    /// \brief Test the collision objects against the planes and dispatch
+    /// the pairs whose bounding boxes reach below a plane. Pairs that no
+    /// longer do are released. Objects are filtered by their groups and
+    /// masks like the broadphase would, and planes are not tested against
+    /// each other.
+    /// \param[in] _dispatcher Dispatcher that just dispatched the
+    /// overlapping pairs.
+    /// \param[in] _dispatchInfo Dispatch settings.
+    /// \param[in] _planes Colliders that are planes, see PlaneShape.
+    /// \param[in] _objects Collision objects of the world.
+    public: void Dispatch(btCollisionDispatcher &_dispatcher,
+        const btDispatcherInfo &_dispatchInfo,
+        const std::vector<btCollisionObject *> &_planes,
+        const btCollisionObjectArray &_objects);
+
+    /// \brief Release the pairs of a collision object with the planes.
+    /// Needs to be called before the object is removed from the world, and
+    /// for all pairs before the dispatcher is destroyed.
+    /// \param[in] _dispatcher Dispatcher of the pairs.
+    /// \param[in] _object Collision object, or nullptr for all pairs.
+    public: void Release(btCollisionDispatcher &_dispatcher,
+        const btCollisionObject *_object);
+
+    /// \brief Destroy the collision algorithm of a pair, which releases its
+    /// manifolds.
+    /// \param[in] _dispatcher Dispatcher of the pair.
+    /// \param[in] _algorithm Algorithm, or nullptr.
+    private: static void ReleaseAlgorithm(
+        btDispatcher &_dispatcher, btCollisionAlgorithm *_algorithm);
+
+    /// \brief A pair of a plane and a collision object.
+    private: struct PlanePair
+    {
+      /// \brief Collision algorithm, nullptr until the near callback finds
+      /// one.
+      btCollisionAlgorithm *algorithm = nullptr;
+
+      /// \brief True if the pair passed the test of the last dispatch.
+      bool reached = false;
+    };
+
+    /// \brief Pairs by plane and collision object.
+    private: std::map<std::pair<const btCollisionObject *,
+        const btCollisionObject *>, PlanePair> pairs;
+  };
+}
+}
+}
+
+#include <gz/physics/bullet/detail/CollisionDispatch.hh>
+
+#endif
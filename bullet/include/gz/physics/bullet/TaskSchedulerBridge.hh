@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_TASKSCHEDULERBRIDGE_HH_
+#define GZ_PHYSICS_BULLET_TASKSCHEDULERBRIDGE_HH_
+
+#include <LinearMath/btThreads.h>
+
+#include <cstddef>
+#include <memory>
+
+#include <gz/physics/TaskScheduler.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace bullet
+{
+  /// \brief A bullet task scheduler that runs the parallel loops of bullet
+  /// on a TaskScheduler, so that bullet does not start threads of its own.
+  ///
+  /// Bullet indexes its per thread buffers with btGetCurrentThreadIndex, so
+  /// the scheduler must not run tasks on more than BT_MAX_THREAD_COUNT
+  /// threads over the life of the process, callers included.
+  class TaskSchedulerBridge : public btITaskScheduler
+  {
+    /// \brief Constructor
+    public: TaskSchedulerBridge();
+
+    /// \brief Set the scheduler that runs the tasks.
+    /// \param[in] _scheduler Scheduler.
+    public: void SetScheduler(
+        const std::shared_ptr<TaskScheduler> &_scheduler);
+
+    // Documentation inherited
+    public: int getMaxNumThreads() const override;
+
+    // Documentation inherited
+    public: int getNumThreads() const override;
+
+    // Documentation inherited
+    public: void setNumThreads(int _numThreads) override;
+
+    // Documentation inherited
+    public: void parallelFor(int _begin, int _end, int _grainSize,
+                             const btIParallelForBody &_body) override;
+
+#if BT_BULLET_VERSION >= 288
+    // Documentation inherited
+    public: btScalar parallelSum(int _begin, int _end, int _grainSize,
+                                 const btIParallelSumBody &_body) override;
+#endif
+
+    /// \brief Get the number of iterations of each task of a loop, which
+    /// splits the loop into one task per thread unless that makes the tasks
+    /// smaller than the grain size.
+    /// \param[in] _begin First iteration of the loop.
+    /// \param[in] _end Iteration after the last one of the loop.
+    /// \param[in] _grainSize Minimum number of iterations per task.
+    /// \return Number of iterations per task.
+    private: int ChunkSize(int _begin, int _end, int _grainSize) const;
+
+    /// \brief Scheduler that runs the tasks.
+    private: std::shared_ptr<TaskScheduler> scheduler;
+
+    /// \brief Number of tasks that loops are split into.
+    private: int numThreads = 1;
+  };
+
+  /// \brief Make bullet's process wide task scheduler use a number of
+  /// threads. Bullet only supports one task scheduler at a time, so this is
+  /// called before each world is stepped with the thread count of that
+  /// world.
+  /// \param[in] _numThreads Number of threads. A value of 0 or 1 selects the
+  /// sequential scheduler.
+  /// \param[in] _scheduler Scheduler that runs the tasks of bullet, or
+  /// nullptr for the default scheduler of bullet, see TaskSchedulerFeature.
+  void UseBulletThreads(std::size_t _numThreads,
+      const std::shared_ptr<TaskScheduler> &_scheduler = {});
+}
+}
+}
+
+#include <gz/physics/bullet/detail/TaskSchedulerBridge.hh>
+
+#endif
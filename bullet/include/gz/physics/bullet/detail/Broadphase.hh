@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_DETAIL_BROADPHASE_HH_
+#define GZ_PHYSICS_BULLET_DETAIL_BROADPHASE_HH_
+
+#include <BulletCollision/BroadphaseCollision/btAxisSweep3.h>
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/BroadphaseCollision/btSimpleBroadphase.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gz/physics/bullet/Broadphase.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace bullet
+{
+  /////////////////////////////////////////////////
+  inline std::unique_ptr<btBroadphaseInterface> CreateBroadphase(
+      const std::string &_type, const btCollisionWorld &_world)
+  {
+    const int numObjects = _world.getNumCollisionObjects();
+    if (_type == "dbvt")
+      return std::make_unique<btDbvtBroadphase>();
+
+    if (_type == "simple")
+    {
+      // The brute force broadphase has a fixed capacity
+      return std::make_unique<btSimpleBroadphase>(
+        std::max(16384, 2 * numObjects));
+    }
+
+    if (_type == "axis_sweep")
+    {
+      // Sweep and prune quantizes positions within fixed world bounds.
+      // Cover the finite objects currently in the world, and at least a
+      // 2 km cube. Objects outside of the bounds still collide, but less
+      // efficiently.
+      const btScalar kMaxExtent = btScalar(1e5);
+      btVector3 aabbMin(-1000, -1000, -1000);
+      btVector3 aabbMax(1000, 1000, 1000);
+      const auto &objects = _world.getCollisionObjectArray();
+      for (int i = 0; i < objects.size(); ++i)
+      {
+        btVector3 objectMin, objectMax;
+        objects[i]->getCollisionShape()->getAabb(
+          objects[i]->getWorldTransform(), objectMin, objectMax);
+        // Skip unbounded shapes such as planes
+        const btVector3 extent = objectMax - objectMin;
+        if (extent[extent.maxAxis()] > kMaxExtent)
+          continue;
+        aabbMin.setMin(objectMin);
+        aabbMax.setMax(objectMax);
+      }
+      const btVector3 margin = (aabbMax - aabbMin) * btScalar(0.1);
+      return std::make_unique<bt32BitAxisSweep3>(
+        aabbMin - margin, aabbMax + margin,
+        static_cast<unsigned int>(std::max(65536, 4 * numObjects)));
+    }
+
+    return nullptr;
+  }
+
+  /////////////////////////////////////////////////
+  template <typename SetBroadphaseT>
+  void ReplaceBroadphase(btCollisionWorld &_world,
+      btBroadphaseInterface *_broadphase, SetBroadphaseT &&_setBroadphase)
+  {
+    btBroadphaseInterface *oldBroadphase = _world.getBroadphase();
+    btDispatcher *dispatcher = _world.getDispatcher();
+    btCollisionObjectArray &objects = _world.getCollisionObjectArray();
+
+    // Collision filters are stored in the proxies, keep them while the
+    // proxies are recreated.
+    std::vector<std::optional<std::pair<int, int>>> filters(
+      static_cast<std::size_t>(objects.size()));
+    for (int i = 0; i < objects.size(); ++i)
+    {
+      btCollisionObject *object = objects[i];
+      btBroadphaseProxy *proxy = object->getBroadphaseHandle();
+      if (!proxy)
+        continue;
+
+      filters[static_cast<std::size_t>(i)] = std::make_pair(
+        static_cast<int>(proxy->m_collisionFilterGroup),
+        static_cast<int>(proxy->m_collisionFilterMask));
+      oldBroadphase->getOverlappingPairCache()->cleanProxyFromPairs(
+        proxy, dispatcher);
+      oldBroadphase->destroyProxy(proxy, dispatcher);
+      object->setBroadphaseHandle(nullptr);
+    }
+
+    _setBroadphase(_broadphase);
+
+    for (int i = 0; i < objects.size(); ++i)
+    {
+      const auto &filter = filters[static_cast<std::size_t>(i)];
+      if (!filter)
+        continue;
+
+      btCollisionObject *object = objects[i];
+      btVector3 aabbMin, aabbMax;
+      object->getCollisionShape()->getAabb(
+        object->getWorldTransform(), aabbMin, aabbMax);
+      object->setBroadphaseHandle(_broadphase->createProxy(
+        aabbMin, aabbMax, object->getCollisionShape()->getShapeType(),
+        object, filter->first, filter->second, dispatcher));
+    }
+  }
+}
+}
+}
+
+#endif
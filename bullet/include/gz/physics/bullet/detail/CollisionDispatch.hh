@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_DETAIL_COLLISIONDISPATCH_HH_
+#define GZ_PHYSICS_BULLET_DETAIL_COLLISIONDISPATCH_HH_
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gz/physics/bullet/CollisionDispatch.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace bullet
+{
+  /////////////////////////////////////////////////
+  inline void PairContactLimiter::SetMaxPairContacts(
+      const std::size_t _maxContacts)
+  {
+    this->maxPairContacts = _maxContacts;
+  }
+
+  /////////////////////////////////////////////////
+  inline std::size_t PairContactLimiter::GetMaxPairContacts() const
+  {
+    return this->maxPairContacts;
+  }
+
+  /////////////////////////////////////////////////
+  inline void PairContactLimiter::LimitPairContacts(btDispatcher &_dispatcher)
+  {
+    if (this->maxPairContacts == std::numeric_limits<std::size_t>::max())
+      return;
+
+    btPersistentManifold **manifolds =
+        _dispatcher.getInternalManifoldPointer();
+    const int numManifolds = _dispatcher.getNumManifolds();
+    if (this->maxPairContacts == 0u)
+    {
+      for (int i = 0; i < numManifolds; ++i)
+        manifolds[i]->clearManifold();
+      return;
+    }
+
+    this->pairManifolds.clear();
+    std::size_t numPoints = 0u;
+    for (int i = 0; i < numManifolds; ++i)
+    {
+      const int numContacts = manifolds[i]->getNumContacts();
+      if (numContacts == 0)
+        continue;
+
+      numPoints += static_cast<std::size_t>(numContacts);
+      int object1 = manifolds[i]->getBody0()->getWorldArrayIndex();
+      int object2 = manifolds[i]->getBody1()->getWorldArrayIndex();
+      if (object1 > object2)
+        std::swap(object1, object2);
+      this->pairManifolds.push_back({object1, object2, i});
+    }
+
+    // No pair can be over the limit
+    if (numPoints <= this->maxPairContacts)
+      return;
+
+    std::sort(this->pairManifolds.begin(), this->pairManifolds.end(),
+        [](const PairManifold &_a, const PairManifold &_b)
+        {
+          return std::tie(_a.object1, _a.object2, _a.manifold) <
+                 std::tie(_b.object1, _b.object2, _b.manifold);
+        });
+
+    std::size_t begin = 0u;
+    while (begin < this->pairManifolds.size())
+    {
+      const PairManifold &first = this->pairManifolds[begin];
+      std::size_t end = begin + 1u;
+      while (end < this->pairManifolds.size() &&
+             this->pairManifolds[end].object1 == first.object1 &&
+             this->pairManifolds[end].object2 == first.object2)
+      {
+        ++end;
+      }
+      this->LimitManifoldContacts(manifolds, begin, end);
+      begin = end;
+    }
+  }
+
+  /////////////////////////////////////////////////
+  inline void PairContactLimiter::LimitManifoldContacts(
+      btPersistentManifold **_manifolds,
+      const std::size_t _begin, const std::size_t _end)
+  {
+    this->pairPoints.clear();
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      const int manifold = this->pairManifolds[i].manifold;
+      for (int p = 0; p < _manifolds[manifold]->getNumContacts(); ++p)
+        this->pairPoints.push_back({manifold, p});
+    }
+
+    const std::size_t maxContacts = this->maxPairContacts;
+    const std::size_t count = this->pairPoints.size();
+    if (count <= maxContacts)
+      return;
+
+    auto point = [&](const ManifoldPoint &_point) -> const btManifoldPoint &
+    {
+      return _manifolds[_point.manifold]->getContactPoint(_point.point);
+    };
+
+    // Greedy farthest point selection seeded with the deepest point, like
+    // the spread selection of the dartsim plugin. Kept points are swapped to
+    // the front.
+    auto first = this->pairPoints.begin();
+    auto deepest = std::min_element(first, this->pairPoints.end(),
+        [&](const ManifoldPoint &_a, const ManifoldPoint &_b)
+        {
+          return point(_a).getDistance() < point(_b).getDistance();
+        });
+    std::iter_swap(first, deepest);
+
+    this->spreadDistances.assign(count,
+        std::numeric_limits<btScalar>::infinity());
+    for (std::size_t k = 1; k < maxContacts; ++k)
+    {
+      const btVector3 &lastPoint =
+          point(this->pairPoints[k - 1]).getPositionWorldOnB();
+      std::size_t farthest = k;
+      for (std::size_t j = k; j < count; ++j)
+      {
+        const btScalar d =
+            point(this->pairPoints[j]).getPositionWorldOnB().distance2(
+                lastPoint);
+        this->spreadDistances[j] = std::min(this->spreadDistances[j], d);
+        if (this->spreadDistances[j] > this->spreadDistances[farthest])
+          farthest = j;
+      }
+      std::iter_swap(first + k, first + farthest);
+      std::swap(this->spreadDistances[k], this->spreadDistances[farthest]);
+    }
+
+    // Removing a point moves the last point of its manifold into its place,
+    // so the points of each manifold are removed from the last one down
+    auto removed = first + static_cast<std::ptrdiff_t>(maxContacts);
+    std::sort(removed, this->pairPoints.end(),
+        [](const ManifoldPoint &_a, const ManifoldPoint &_b)
+        {
+          return std::tie(_a.manifold, _b.point) <
+                 std::tie(_b.manifold, _a.point);
+        });
+    for (auto it = removed; it != this->pairPoints.end(); ++it)
+      _manifolds[it->manifold]->removeContactPoint(it->point);
+  }
+
+  /////////////////////////////////////////////////
+  inline const btStaticPlaneShape *PlanePairs::PlaneShape(
+      const btCollisionObject *_object, btTransform &_planeToWorld)
+  {
+    const btCollisionShape *shape = _object->getCollisionShape();
+    _planeToWorld = _object->getWorldTransform();
+    if (shape && shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE)
+    {
+      const auto *compound = static_cast<const btCompoundShape *>(shape);
+      if (compound->getNumChildShapes() != 1)
+        return nullptr;
+      _planeToWorld = _planeToWorld * compound->getChildTransform(0);
+      shape = compound->getChildShape(0);
+    }
+
+    if (!shape || shape->getShapeType() != STATIC_PLANE_PROXYTYPE)
+      return nullptr;
+    return static_cast<const btStaticPlaneShape *>(shape);
+  }
+
+  /////////////////////////////////////////////////
+  inline void PlanePairs::ReleaseAlgorithm(
+      btDispatcher &_dispatcher, btCollisionAlgorithm *_algorithm)
+  {
+    if (!_algorithm)
+      return;
+
+    // Like btHashedOverlappingPairCache::cleanOverlappingPair
+    _algorithm->~btCollisionAlgorithm();
+    _dispatcher.freeCollisionAlgorithm(_algorithm);
+  }
+
+  /////////////////////////////////////////////////
+  inline void PlanePairs::Dispatch(btCollisionDispatcher &_dispatcher,
+      const btDispatcherInfo &_dispatchInfo,
+      const std::vector<btCollisionObject *> &_planes,
+      const btCollisionObjectArray &_objects)
+  {
+    btTransform planeToWorld;
+    for (btCollisionObject *planeObject : _planes)
+    {
+      btBroadphaseProxy *planeProxy = planeObject->getBroadphaseHandle();
+      const btStaticPlaneShape *shape = PlaneShape(planeObject, planeToWorld);
+      if (!planeProxy || !shape)
+        continue;
+
+      const btVector3 normal =
+          planeToWorld.getBasis() * shape->getPlaneNormal();
+      const btScalar offset =
+          shape->getPlaneConstant() + normal.dot(planeToWorld.getOrigin());
+
+      for (int i = 0; i < _objects.size(); ++i)
+      {
+        btCollisionObject *object = _objects[i];
+        btBroadphaseProxy *proxy = object->getBroadphaseHandle();
+
+        // Filtered like the broadphase would. The bounding boxes are the
+        // ones the broadphase was just updated with, grown by the contact
+        // breaking threshold.
+        btTransform otherToWorld;
+        if (!proxy || object == planeObject ||
+            !(proxy->m_collisionFilterGroup &
+              planeProxy->m_collisionFilterMask) ||
+            !(planeProxy->m_collisionFilterGroup &
+              proxy->m_collisionFilterMask) ||
+            PlaneShape(object, otherToWorld))
+        {
+          continue;
+        }
+
+        const btVector3 lowest(
+            normal.x() >= 0 ? proxy->m_aabbMin.x() : proxy->m_aabbMax.x(),
+            normal.y() >= 0 ? proxy->m_aabbMin.y() : proxy->m_aabbMax.y(),
+            normal.z() >= 0 ? proxy->m_aabbMin.z() : proxy->m_aabbMax.z());
+        if (normal.dot(lowest) > offset)
+          continue;
+
+        PlanePair &planePair = this->pairs[{planeObject, object}];
+        planePair.reached = true;
+
+        // The plane stays the first object of the pair, which its algorithm
+        // was found for, even if the proxies were recreated by a new
+        // broadphase
+        btBroadphasePair pair;
+        pair.m_pProxy0 = planeProxy;
+        pair.m_pProxy1 = proxy;
+        pair.m_algorithm = planePair.algorithm;
+        _dispatcher.getNearCallback()(pair, _dispatcher, _dispatchInfo);
+        planePair.algorithm = pair.m_algorithm;
+      }
+    }
+
+    for (auto it = this->pairs.begin(); it != this->pairs.end();)
+    {
+      if (it->second.reached)
+      {
+        it->second.reached = false;
+        ++it;
+        continue;
+      }
+
+      ReleaseAlgorithm(_dispatcher, it->second.algorithm);
+      it = this->pairs.erase(it);
+    }
+  }
+
+  /////////////////////////////////////////////////
+  inline void PlanePairs::Release(btCollisionDispatcher &_dispatcher,
+      const btCollisionObject *_object)
+  {
+    for (auto it = this->pairs.begin(); it != this->pairs.end();)
+    {
+      if (_object && it->first.first != _object &&
+          it->first.second != _object)
+      {
+        ++it;
+        continue;
+      }
+
+      ReleaseAlgorithm(_dispatcher, it->second.algorithm);
+      it = this->pairs.erase(it);
+    }
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_DETAIL_TASKSCHEDULERBRIDGE_HH_
+#define GZ_PHYSICS_BULLET_DETAIL_TASKSCHEDULERBRIDGE_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <gz/common/Console.hh>
+
+#include <gz/physics/bullet/TaskSchedulerBridge.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace bullet
+{
+  /////////////////////////////////////////////////
+  inline TaskSchedulerBridge::TaskSchedulerBridge()
+    : btITaskScheduler("GzTaskScheduler")
+  {
+  }
+
+  /////////////////////////////////////////////////
+  inline void TaskSchedulerBridge::SetScheduler(
+      const std::shared_ptr<TaskScheduler> &_scheduler)
+  {
+    this->scheduler = _scheduler;
+  }
+
+  /////////////////////////////////////////////////
+  inline int TaskSchedulerBridge::getMaxNumThreads() const
+  {
+    return BT_MAX_THREAD_COUNT;
+  }
+
+  /////////////////////////////////////////////////
+  inline int TaskSchedulerBridge::getNumThreads() const
+  {
+    return this->numThreads;
+  }
+
+  /////////////////////////////////////////////////
+  inline void TaskSchedulerBridge::setNumThreads(int _numThreads)
+  {
+    this->numThreads = std::clamp(_numThreads, 1, BT_MAX_THREAD_COUNT);
+  }
+
+  /////////////////////////////////////////////////
+  inline void TaskSchedulerBridge::parallelFor(int _begin, int _end,
+      int _grainSize, const btIParallelForBody &_body)
+  {
+    const int chunk = this->ChunkSize(_begin, _end, _grainSize);
+    if (_end - _begin <= chunk)
+    {
+      _body.forLoop(_begin, _end);
+      return;
+    }
+
+    this->scheduler->Run(static_cast<std::size_t>(
+        (_end - _begin + chunk - 1) / chunk), [&](std::size_t _i)
+    {
+      const int begin = _begin + static_cast<int>(_i) * chunk;
+      _body.forLoop(begin, std::min(_end, begin + chunk));
+    });
+  }
+
+#if BT_BULLET_VERSION >= 288
+  /////////////////////////////////////////////////
+  inline btScalar TaskSchedulerBridge::parallelSum(int _begin, int _end,
+      int _grainSize, const btIParallelSumBody &_body)
+  {
+    const int chunk = this->ChunkSize(_begin, _end, _grainSize);
+    if (_end - _begin <= chunk)
+      return _body.sumLoop(_begin, _end);
+
+    // Partial sums are added in chunk order, so the result does not depend
+    // on which thread ran which chunk
+    std::vector<btScalar> sums(static_cast<std::size_t>(
+        (_end - _begin + chunk - 1) / chunk));
+    this->scheduler->Run(sums.size(), [&](std::size_t _i)
+    {
+      const int begin = _begin + static_cast<int>(_i) * chunk;
+      sums[_i] = _body.sumLoop(begin, std::min(_end, begin + chunk));
+    });
+
+    btScalar sum = 0;
+    for (const btScalar partial : sums)
+      sum += partial;
+    return sum;
+  }
+#endif
+
+  /////////////////////////////////////////////////
+  inline int TaskSchedulerBridge::ChunkSize(
+      int _begin, int _end, int _grainSize) const
+  {
+    const int count = std::max(0, _end - _begin);
+    return std::max({1, _grainSize,
+        (count + this->numThreads - 1) / this->numThreads});
+  }
+
+  /////////////////////////////////////////////////
+  inline void UseBulletThreads(std::size_t _numThreads,
+      const std::shared_ptr<TaskScheduler> &_scheduler)
+  {
+    if (_numThreads <= 1u)
+    {
+      if (btGetTaskScheduler() != btGetSequentialTaskScheduler())
+        btSetTaskScheduler(btGetSequentialTaskScheduler());
+      return;
+    }
+
+    if (_scheduler)
+    {
+      // Shared by all worlds and kept alive for the lifetime of the
+      // process, like the default scheduler below.
+      static TaskSchedulerBridge *bridge = new TaskSchedulerBridge;
+      bridge->SetScheduler(_scheduler);
+      bridge->setNumThreads(static_cast<int>(std::min<std::size_t>(
+          _numThreads, BT_MAX_THREAD_COUNT)));
+      if (btGetTaskScheduler() != bridge)
+        btSetTaskScheduler(bridge);
+      return;
+    }
+
+    // Shared by all worlds and kept alive for the lifetime of the process.
+    // This is nullptr if bullet was built without BT_THREADSAFE.
+    static btITaskScheduler *scheduler = btCreateDefaultTaskScheduler();
+    if (!scheduler)
+    {
+      static bool warned = false;
+      if (!warned)
+      {
+        gzwarn << "Bullet was built without multithreading support "
+               << "(BT_THREADSAFE), worlds will be stepped on a single "
+               << "thread." << std::endl;
+        warned = true;
+      }
+      return;
+    }
+
+    const int numThreads = std::min(
+      static_cast<int>(_numThreads), scheduler->getMaxNumThreads());
+    if (scheduler->getNumThreads() != numThreads)
+      scheduler->setNumThreads(numThreads);
+    if (btGetTaskScheduler() != scheduler)
+      btSetTaskScheduler(scheduler);
+  }
+}
+}
+}
+
+#endif
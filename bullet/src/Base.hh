@@ -56,9 +56,19 @@ struct WorldInfo
   std::shared_ptr<btCollisionDispatcher> dispatcher;
   std::shared_ptr<btBroadphaseInterface> broadphase;
   std::shared_ptr<btConstraintSolver> solver;
+  /// Solver used by btDiscreteDynamicsWorldMt for large islands, nullptr
+  /// unless world is a btDiscreteDynamicsWorldMt
+  std::shared_ptr<btConstraintSolver> solverMt;
   std::shared_ptr<btDiscreteDynamicsWorld> world;
   std::vector<std::size_t> models = {};
   std::unordered_map<std::string, std::size_t> modelsByName = {};
+  /// Index of each model in models, by model ID
+  std::unordered_map<std::size_t, std::size_t> modelIndices = {};
+  /// Name of the broadphase in use, see WorldFeatures::SetWorldBroadphase
+  std::string broadphaseType = "dbvt";
+  /// Number of threads used to step this world, see
+  /// WorldFeatures::SetWorldNumThreads
+  std::size_t numThreads = 1u;
 };
 
 struct ModelInfo
@@ -70,8 +80,16 @@ struct ModelInfo
   math::Pose3d pose;
   std::vector<std::size_t> links = {};
   std::unordered_map<std::string, std::size_t> linksByName = {};
+  /// Index of each link in links, by link ID
+  std::unordered_map<std::size_t, std::size_t> linkIndices = {};
   std::vector<std::size_t> joints = {};
   std::unordered_map<std::string, std::size_t> jointsByName = {};
+  /// Index of each joint in joints, by joint ID
+  std::unordered_map<std::size_t, std::size_t> jointIndices = {};
+  /// Whether the links are kinematic objects, see KinematicModelFeature
+  bool kinematic = false;
+  /// Whether the links could sleep before the model was made kinematic
+  bool sleepEnabledBeforeKinematic = false;
 };
 
 struct LinkInfo
@@ -87,6 +105,10 @@ struct LinkInfo
   std::shared_ptr<btCompoundShape> collisionShape;
   std::shared_ptr<btRigidBody> link;
   std::vector<std::size_t> shapes = {};
+  /// Pose of the link the last time it was reported in ChangedWorldPoses.
+  /// Only valid if hasReportedPose is true.
+  math::Pose3d reportedPose;
+  bool hasReportedPose = false;
 };
 
 struct CollisionInfo
@@ -99,6 +121,9 @@ struct CollisionInfo
   // cppcheck-suppress unusedStructMember
   bool isMesh;
   std::shared_ptr<btTriangleMesh> mesh;
+  /// Children of shape when it is a compound, such as the hulls of a convex
+  /// decomposition, which the compound does not own.
+  std::vector<std::shared_ptr<btCollisionShape>> children = {};
 };
 
 struct JointInfo
@@ -197,6 +222,7 @@ class Base : public Implements3d<FeatureList<Feature>>
     const auto model = std::make_shared<ModelInfo>(_modelInfo);
     this->models[id] = model;
     const auto world = this->worlds.at(_worldId);
+    world->modelIndices[id] = world->models.size();
     world->models.push_back(id);
     world->modelsByName[model->name] = id;
     return this->GenerateIdentity(id, this->models.at(id));
@@ -209,6 +235,7 @@ class Base : public Implements3d<FeatureList<Feature>>
     this->links[id] = link;
 
     auto model = this->models.at(link->model);
+    model->linkIndices[id] = model->links.size();
     model->links.push_back(id);
     model->linksByName[link->name] = id;
     return this->GenerateIdentity(id, this->links.at(id));
@@ -231,6 +258,7 @@ class Base : public Implements3d<FeatureList<Feature>>
     if (_modelId.has_value())
     {
       const auto model = this->models.at(*_modelId);
+      model->jointIndices[id] = model->joints.size();
       model->joints.push_back(id);
       model->jointsByName[joint->name] = id;
     }
@@ -17,11 +17,15 @@
 
 #include <btBulletDynamicsCommon.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "EntityManagementFeatures.hh"
+#include "GzCollisionDispatcher.hh"
 #include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 
 namespace gz {
@@ -36,7 +40,8 @@ Identity EntityManagementFeatures::ConstructEmptyWorld(
   const auto collisionConfiguration =
     std::make_shared<btDefaultCollisionConfiguration>();
   const auto dispatcher =
-    std::make_shared<btCollisionDispatcher>(collisionConfiguration.get());
+    std::make_shared<GzCollisionDispatcher<btCollisionDispatcher>>(
+      collisionConfiguration.get());
   const auto broadphase = std::make_shared<btDbvtBroadphase>();
   const auto solver =
     std::make_shared<btSequentialImpulseConstraintSolver>();
@@ -48,9 +53,11 @@ Identity EntityManagementFeatures::ConstructEmptyWorld(
   world->getSolverInfo().m_globalCfm = 0;
 
   btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher.get());
+  dispatcher->AttachTo(*world);
 
   return this->AddWorld(
-    {_name, collisionConfiguration, dispatcher, broadphase, solver, world});
+    {_name, collisionConfiguration, dispatcher, broadphase, solver, nullptr,
+     world});
 }
 
 /////////////////////////////////////////////////
@@ -75,10 +82,32 @@ bool EntityManagementFeatures::RemoveModel(const Identity &_modelID)
     for (const auto shapeID : link->shapes)
       this->collisions.erase(shapeID);
 
+    if (auto *tester = dynamic_cast<PlanePairTester *>(
+            this->worlds.at(worldID)->dispatcher.get()))
+    {
+      tester->RemoveCollider(link->link.get());
+    }
     bulletWorld->removeRigidBody(link->link.get());
     this->links.erase(linkID);
   }
 
+  // Remove the model from its world and shift the indices of the models
+  // that came after it
+  const auto world = this->worlds.at(worldID);
+  const auto indexIt = world->modelIndices.find(_modelID.id);
+  if (indexIt != world->modelIndices.end())
+  {
+    const std::size_t index = indexIt->second;
+    world->modelIndices.erase(indexIt);
+    world->models.erase(world->models.begin() +
+      static_cast<std::ptrdiff_t>(index));
+    for (std::size_t i = index; i < world->models.size(); ++i)
+      world->modelIndices[world->models[i]] = i;
+  }
+  const auto nameIt = world->modelsByName.find(model->name);
+  if (nameIt != world->modelsByName.end() && nameIt->second == _modelID.id)
+    world->modelsByName.erase(nameIt);
+
   // Clean up model
   this->models.erase(_modelID.id);
   return true;
@@ -169,7 +198,8 @@ std::size_t EntityManagementFeatures::GetWorldIndex(
       "with " + std::to_string(this->worlds.size()) + " worlds");
   }
 
-  return *it;
+  return static_cast<std::size_t>(
+    std::distance(this->worldsByIndex.begin(), it));
 }
 
 Identity EntityManagementFeatures::GetEngineOfWorld(const Identity &) const
@@ -215,17 +245,16 @@ std::size_t EntityManagementFeatures::GetModelIndex(
 {
   const auto model = this->ReferenceInterface<ModelInfo>(_modelID);
   const auto world = this->ReferenceInterface<WorldInfo>(model->world);
-  const auto it =
-      std::find(world->models.begin(), world->models.end(), _modelID.id);
+  const auto it = world->modelIndices.find(_modelID.id);
 
-  if (it == world->models.end())
+  if (it == world->modelIndices.end())
   {
     throw std::runtime_error(
           "Model [" + std::to_string(_modelID.id) + "] cannot be found in "
           "world [" + std::to_string(model->world.id) + "]");
   }
 
-  return *it;
+  return it->second;
 }
 
 Identity EntityManagementFeatures::GetWorldOfModel(
@@ -310,17 +339,16 @@ std::size_t EntityManagementFeatures::GetLinkIndex(
 {
   const auto link = this->ReferenceInterface<LinkInfo>(_linkID);
   const auto model = this->ReferenceInterface<ModelInfo>(link->model);
-  const auto it =
-      std::find(model->links.begin(), model->links.end(), _linkID.id);
+  const auto it = model->linkIndices.find(_linkID.id);
 
-  if (it == model->links.end())
+  if (it == model->linkIndices.end())
   {
     throw std::runtime_error(
           "Link [" + std::to_string(_linkID.id) + "] cannot be found in "
           "model [" + std::to_string(link->model.id) + "]");
   }
 
-  return *it;
+  return it->second;
 }
 
 Identity EntityManagementFeatures::GetModelOfLink(
@@ -380,16 +408,15 @@ std::size_t EntityManagementFeatures::GetJointIndex(
   const auto joint = this->ReferenceInterface<JointInfo>(_jointID);
   const auto parentLink = this->links.at(joint->parentLinkId);
   const auto model = this->ReferenceInterface<ModelInfo>(parentLink->model);
-  const auto it =
-      std::find(model->joints.begin(), model->joints.end(), _jointID.id);
-  if (it == model->joints.end())
+  const auto it = model->jointIndices.find(_jointID.id);
+  if (it == model->jointIndices.end())
   {
     throw std::runtime_error(
           "Joint [" + std::to_string(_jointID.id) + "] cannot be found in "
           "model [" + std::to_string(parentLink->model.id) + "]");
   }
 
-  return *it;
+  return it->second;
 }
 
 Identity EntityManagementFeatures::GetModelOfJoint(
@@ -420,7 +447,7 @@ std::size_t EntityManagementFeatures::GetShapeIndex(
           "link [" + std::to_string(shape->link.id) + "]");
   }
 
-  return *it;
+  return static_cast<std::size_t>(std::distance(link->shapes.begin(), it));
 }
 
 Identity EntityManagementFeatures::GetLinkOfShape(
@@ -428,6 +455,40 @@ Identity EntityManagementFeatures::GetLinkOfShape(
 {
   return this->ReferenceInterface<CollisionInfo>(_shapeID)->link;
 }
+
+std::vector<Identity> EntityManagementFeatures::GetWorldModels(
+    const Identity &_worldID) const
+{
+  const auto world = this->ReferenceInterface<WorldInfo>(_worldID);
+  std::vector<Identity> models;
+  models.reserve(world->models.size());
+  for (const auto modelID : world->models)
+    models.push_back(this->GenerateIdentity(modelID, this->models.at(modelID)));
+  return models;
+}
+
+std::vector<Identity> EntityManagementFeatures::GetModelLinks(
+    const Identity &_modelID) const
+{
+  const auto model = this->ReferenceInterface<ModelInfo>(_modelID);
+  std::vector<Identity> links;
+  links.reserve(model->links.size());
+  for (const auto linkID : model->links)
+    links.push_back(this->GenerateIdentity(linkID, this->links.at(linkID)));
+  return links;
+}
+
+std::vector<Identity> EntityManagementFeatures::GetModelJoints(
+    const Identity &_modelID) const
+{
+  const auto model = this->ReferenceInterface<ModelInfo>(_modelID);
+  std::vector<Identity> joints;
+  joints.reserve(model->joints.size());
+  for (const auto jointID : model->joints)
+    joints.push_back(this->GenerateIdentity(jointID, this->joints.at(jointID)));
+  return joints;
+}
+
 }  // namespace bullet
 }  // namespace physics
 }  // namespace gz
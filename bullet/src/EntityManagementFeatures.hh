@@ -19,6 +19,7 @@
 #define GZ_PHYSICS_BULLET_SRC_GETENTITIESFEATURE_HH_
 
 #include <string>
+#include <vector>
 
 #include <gz/physics/ConstructEmpty.hh>
 #include <gz/physics/GetEntities.hh>
@@ -38,6 +39,7 @@ struct EntityManagementFeatureList : gz::physics::FeatureList<
   GetLinkFromModel,
   GetJointFromModel,
   GetShapeFromLink,
+  GetEntityBatchFeature,
   RemoveModelFromWorld,
   ConstructEmptyWorldFeature
 > { };
@@ -142,6 +144,16 @@ class EntityManagementFeatures :
   public: std::size_t GetShapeIndex(const Identity &_shapeID) const override;
 
   public: Identity GetLinkOfShape(const Identity &_shapeID) const override;
+
+  // ----- Get entity batches -----
+  public: std::vector<Identity> GetWorldModels(
+      const Identity &_worldID) const override;
+
+  public: std::vector<Identity> GetModelLinks(
+      const Identity &_modelID) const override;
+
+  public: std::vector<Identity> GetModelJoints(
+      const Identity &_modelID) const override;
 };
 
 }  // namespace bullet
@@ -32,8 +32,8 @@ Identity FreeGroupFeatures::FindFreeGroupForModel(
   if (model->links.size() == 0)
     return this->GenerateInvalidId();
 
-  // Reject also if the model has fixed base
-  if (model->fixed)
+  // Reject also if the model has fixed base, unless it is kinematic
+  if (model->fixed && !model->kinematic)
     return this->GenerateInvalidId();
 
   return _modelID;
@@ -75,7 +75,12 @@ void FreeGroupFeatures::SetFreeGroupWorldPose(
   const auto &model = this->models.at(_groupID);
   for (auto link : model->links)
   {
-    this->links.at(link)->link->setCenterOfMassTransform(baseTransform);
+    const auto &body = this->links.at(link)->link;
+    body->setCenterOfMassTransform(baseTransform);
+    // Kinematic objects are moved to their motion state every step
+    if (body->isKinematicObject())
+      body->getMotionState()->setWorldTransform(baseTransform);
+    body->activate();
   }
 }
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "GzCollisionDispatcher.hh"
+
+namespace gz {
+namespace physics {
+namespace bullet {
+
+/////////////////////////////////////////////////
+void PlanePairTester::AttachTo(btCollisionWorld &_world)
+{
+  this->collisionObjects = &_world.getCollisionObjectArray();
+  _world.getBroadphase()->getOverlappingPairCache()
+      ->setOverlapFilterCallback(this);
+}
+
+/////////////////////////////////////////////////
+bool PlanePairTester::needBroadphaseCollision(
+    btBroadphaseProxy *_proxy0, btBroadphaseProxy *_proxy1) const
+{
+  if (!(_proxy0->m_collisionFilterGroup & _proxy1->m_collisionFilterMask) ||
+      !(_proxy1->m_collisionFilterGroup & _proxy0->m_collisionFilterMask))
+  {
+    return false;
+  }
+
+  // Links get their shapes after they are added to the world, so planes are
+  // recognized by their shape rather than by a filter group
+  btTransform planeToWorld;
+  for (const btBroadphaseProxy *proxy : {_proxy0, _proxy1})
+  {
+    const auto *object =
+        static_cast<const btCollisionObject *>(proxy->m_clientObject);
+    if (object && PlanePairs::PlaneShape(object, planeToWorld))
+      return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void PlanePairTester::DispatchPlanePairs(
+    btCollisionDispatcher &_dispatcher, const btDispatcherInfo &_dispatchInfo)
+{
+  if (!this->collisionObjects)
+    return;
+
+  const btCollisionObjectArray &objects = *this->collisionObjects;
+  btTransform planeToWorld;
+  this->planes.clear();
+  for (int i = 0; i < objects.size(); ++i)
+  {
+    if (PlanePairs::PlaneShape(objects[i], planeToWorld))
+      this->planes.push_back(objects[i]);
+  }
+
+  this->planePairs.Dispatch(_dispatcher, _dispatchInfo, this->planes, objects);
+}
+
+/////////////////////////////////////////////////
+void PlanePairTester::ReleasePlanePairs(
+    btCollisionDispatcher &_dispatcher, const btCollisionObject *_object)
+{
+  this->planePairs.Release(_dispatcher, _object);
+}
+
+}  // namespace bullet
+}  // namespace physics
+}  // namespace gz
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_SRC_GZCOLLISIONDISPATCHER_HH_
+#define GZ_PHYSICS_BULLET_SRC_GZCOLLISIONDISPATCHER_HH_
+
+#include <btBulletDynamicsCommon.h>
+
+#include <vector>
+
+#include <gz/physics/bullet/CollisionDispatch.hh>
+
+namespace gz {
+namespace physics {
+namespace bullet {
+
+/// \brief Tests the collision objects of a world against its colliders
+/// that are infinite planes, see PlanePairs, and keeps the planes out of the
+/// overlapping pairs of its broadphase.
+class PlanePairTester : public btOverlapFilterCallback
+{
+  /// \brief Test the collision objects of a world against its planes, and
+  /// keep its planes out of the overlapping pairs of its broadphase. Needs
+  /// to be called again when the broadphase of the world is replaced.
+  /// \param[in] _world World whose dispatcher this is.
+  public: void AttachTo(btCollisionWorld &_world);
+
+  /// \brief Release the pairs of a collision object with the planes.
+  /// Needs to be called before the object is removed from the world.
+  /// \param[in] _object Collision object.
+  public: virtual void RemoveCollider(const btCollisionObject *_object) = 0;
+
+  // Documentation inherited
+  public: bool needBroadphaseCollision(
+      btBroadphaseProxy *_proxy0,
+      btBroadphaseProxy *_proxy1) const override;
+
+  /// \brief Test the collision objects against the planes and dispatch the
+  /// pairs whose bounding boxes reach below a plane. Pairs that no longer
+  /// do are released.
+  /// \param[in] _dispatcher Dispatcher that just dispatched the pairs.
+  /// \param[in] _dispatchInfo Dispatch settings.
+  protected: void DispatchPlanePairs(btCollisionDispatcher &_dispatcher,
+      const btDispatcherInfo &_dispatchInfo);
+
+  /// \brief Release the pairs of a collision object with the planes.
+  /// \param[in] _dispatcher Dispatcher of the pairs.
+  /// \param[in] _object Collision object, or nullptr for all pairs.
+  protected: void ReleasePlanePairs(btCollisionDispatcher &_dispatcher,
+      const btCollisionObject *_object);
+
+  /// \brief Pairs of the planes with the other collision objects.
+  private: PlanePairs planePairs;
+
+  /// \brief Planes of the dispatch in progress.
+  private: std::vector<btCollisionObject *> planes;
+
+  /// \brief Collision objects of the world, see AttachTo.
+  private: const btCollisionObjectArray *collisionObjects = nullptr;
+};
+
+/// \brief A collision dispatcher that tests the collision objects against
+/// the infinite planes and limits the number of contact points of each pair
+/// after dispatching the pairs.
+/// \tparam DispatcherT btCollisionDispatcher or btCollisionDispatcherMt.
+template <typename DispatcherT>
+class GzCollisionDispatcher
+  : public DispatcherT, public PairContactLimiter, public PlanePairTester
+{
+  /// \brief Constructor
+  /// \param[in] _collisionConfiguration Collision configuration.
+  public: explicit GzCollisionDispatcher(
+      btCollisionConfiguration *_collisionConfiguration)
+    : DispatcherT(_collisionConfiguration)
+  {
+  }
+
+  /// \brief Destructor. The algorithms of the plane pairs release their
+  /// manifolds through the dispatcher, so they go first.
+  public: ~GzCollisionDispatcher() override
+  {
+    this->ReleasePlanePairs(*this, nullptr);
+  }
+
+  // Documentation inherited
+  public: void RemoveCollider(const btCollisionObject *_object) override
+  {
+    this->ReleasePlanePairs(*this, _object);
+  }
+
+  // Documentation inherited
+  public: void dispatchAllCollisionPairs(
+      btOverlappingPairCache *_pairCache,
+      const btDispatcherInfo &_dispatchInfo,
+      btDispatcher *_dispatcher) override
+  {
+    DispatcherT::dispatchAllCollisionPairs(
+        _pairCache, _dispatchInfo, _dispatcher);
+    this->DispatchPlanePairs(*this, _dispatchInfo);
+    this->LimitPairContacts(*this);
+  }
+};
+
+}  // namespace bullet
+}  // namespace physics
+}  // namespace gz
+
+#endif
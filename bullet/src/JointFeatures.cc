@@ -339,6 +339,14 @@ void JointFeatures::SetJointForce(
 
           hinge->getRigidBodyA().applyTorque(hingeTorqueA);
           hinge->getRigidBodyB().applyTorque(-hingeTorqueB);
+
+          // Bullet clears the forces after each step, so only a force that
+          // is not zero changes what the next step does.
+          if (_value != 0.0)
+          {
+            hinge->getRigidBodyA().activate();
+            hinge->getRigidBodyB().activate();
+          }
         }
       }
       break;
@@ -377,7 +385,12 @@ void JointFeatures::SetJointVelocityCommand(
     btVector3 motion = quatRotate(trans.getRotation(),
       convertVec(gz::math::eigen3::convert(jointInfo->axis)));
     btVector3 angular_vel = motion * static_cast<btScalar>(_value);
+
+    // Repeating the velocity that the link already has does not wake it up
+    if (angular_vel == link->getAngularVelocity())
+      break;
     link->setAngularVelocity(angular_vel);
+    link->activate();
   }
   break;
   default:
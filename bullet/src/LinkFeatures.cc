@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "LinkFeatures.hh"
+
+#include <algorithm>
+
+namespace gz {
+namespace physics {
+namespace bullet {
+
+/////////////////////////////////////////////////
+void LinkFeatures::SetLinkContinuousCollision(
+    const Identity &_id, double _motionThreshold, double _sweptSphereRadius)
+{
+  // bullet sweeps the body whenever its squared motion in a step exceeds the
+  // squared threshold, and skips the sweep for a threshold of 0
+  auto &body = *this->links.at(_id)->link;
+  body.setCcdMotionThreshold(
+      static_cast<btScalar>(std::max(0.0, _motionThreshold)));
+  body.setCcdSweptSphereRadius(
+      static_cast<btScalar>(std::max(0.0, _sweptSphereRadius)));
+}
+
+/////////////////////////////////////////////////
+double LinkFeatures::GetLinkContinuousCollisionMotionThreshold(
+    const Identity &_id) const
+{
+  return this->links.at(_id)->link->getCcdMotionThreshold();
+}
+
+/////////////////////////////////////////////////
+double LinkFeatures::GetLinkContinuousCollisionSweptSphereRadius(
+    const Identity &_id) const
+{
+  return this->links.at(_id)->link->getCcdSweptSphereRadius();
+}
+
+}  // namespace bullet
+}  // namespace physics
+}  // namespace gz
@@ -18,12 +18,36 @@
 #include "ShapeFeatures.hh"
 #include <BulletCollision/Gimpact/btGImpactShape.h>
 
+#include <gz/common/SubMesh.hh>
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
+#include <gz/physics/mesh/MeshContentHash.hh>
+
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace gz {
 namespace physics {
 namespace bullet {
 
+/////////////////////////////////////////////////
+/// \brief Get the transform of a shape in the compound shape of its link,
+/// which is expressed in the inertial frame of the link.
+/// \param[in] _link Link of the shape.
+/// \param[in] _pose Pose of the shape relative to the link.
+/// \return The transform of the shape in the compound shape.
+static btTransform ShapeTransform(
+    const LinkInfo &_link, const Pose3d &_pose)
+{
+  auto poseWithInertia =
+    _link.inertialPose.Inverse() * gz::math::eigen3::convert(_pose);
+  const auto poseIsometry = gz::math::eigen3::convert(poseWithInertia);
+  btTransform baseTransform;
+  baseTransform.setOrigin(convertVec(poseIsometry.translation()));
+  baseTransform.setBasis(convertMat(poseIsometry.linear()));
+  return baseTransform;
+}
+
 /////////////////////////////////////////////////
 Identity ShapeFeatures::AttachMeshShape(
     const Identity &_linkID,
@@ -81,14 +105,7 @@ Identity ShapeFeatures::AttachMeshShape(
   const auto &modelID = linkInfo->model;
   const auto &body = linkInfo->link.get();
 
-  auto poseWithInertia =
-    linkInfo->inertialPose.Inverse() * gz::math::eigen3::convert(_pose);
-  const auto poseIsometry = gz::math::eigen3::convert(poseWithInertia);
-  const auto poseTranslation = poseIsometry.translation();
-  const auto poseLinear = poseIsometry.linear();
-  btTransform baseTransform;
-  baseTransform.setOrigin(convertVec(poseTranslation));
-  baseTransform.setBasis(convertMat(poseLinear));
+  const btTransform baseTransform = ShapeTransform(*linkInfo, _pose);
 
   /* TO-DO(Lobotuerk): figure out if this line is needed */
   // gimpactMeshShape->setMargin(btScalar(0.001));
@@ -104,6 +121,85 @@ Identity ShapeFeatures::AttachMeshShape(
 
 }
 
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachConvexMeshShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const gz::common::Mesh &_mesh,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale)
+{
+  return this->AttachConvexDecompositionShape(
+      _linkID, _name, _mesh, 1u, _pose, _scale);
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachConvexDecompositionShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const gz::common::Mesh &_mesh,
+    std::size_t _maxConvexHulls,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale)
+{
+  if (_maxConvexHulls == 0u)
+  {
+    gzerr << "Convex decomposition of shape [" << _name << "] needs at "
+          << "least one hull\n";
+    return this->GenerateInvalidId();
+  }
+
+  const common::Mesh *convexMesh = mesh::CachedConvexMesh(
+      _mesh, mesh::MeshContentHash(_mesh), _maxConvexHulls,
+      _maxConvexHulls == 1u ? "convex_hull" : "convex_decomposition");
+  if (nullptr == convexMesh)
+  {
+    gzerr << "Failed to compute the convex hulls of shape [" << _name
+          << "]\n";
+    return this->GenerateInvalidId();
+  }
+
+  // Each hull is a child of a compound, which bullet collides with its
+  // convex algorithms instead of testing each triangle of the mesh.
+  auto compound = std::make_shared<btCompoundShape>();
+  std::vector<std::shared_ptr<btCollisionShape>> hulls;
+  for (unsigned int j = 0; j < convexMesh->SubMeshCount(); ++j)
+  {
+    auto submesh = convexMesh->SubMeshByIndex(j).lock();
+    if (!submesh || submesh->VertexCount() == 0u)
+      continue;
+
+    auto hull = std::make_shared<btConvexHullShape>();
+    for (unsigned int i = 0; i < submesh->VertexCount(); ++i)
+    {
+      const auto &v = submesh->Vertex(i);
+      hull->addPoint(btVector3(
+          static_cast<btScalar>(v.X() * _scale[0]),
+          static_cast<btScalar>(v.Y() * _scale[1]),
+          static_cast<btScalar>(v.Z() * _scale[2])), false);
+    }
+    hull->recalcLocalAabb();
+    hull->setMargin(btScalar(0.001));
+    compound->addChildShape(btTransform::getIdentity(), hull.get());
+    hulls.push_back(std::move(hull));
+  }
+  if (hulls.empty())
+  {
+    gzerr << "Failed to compute the convex hulls of shape [" << _name
+          << "]\n";
+    return this->GenerateInvalidId();
+  }
+
+  const auto &linkInfo = this->links.at(_linkID);
+  dynamic_cast<btCompoundShape *>(
+    linkInfo->link->getCollisionShape())->addChildShape(
+    ShapeTransform(*linkInfo, _pose), compound.get());
+
+  return this->AddCollision(
+    _linkID, {_name, compound, _linkID, linkInfo->model,
+    gz::math::eigen3::convert(_pose), true, nullptr, std::move(hulls)});
+}
+
 /////////////////////////////////////////////////
 Identity ShapeFeatures::CastToMeshShape(
     const Identity &_shapeID) const
@@ -115,6 +211,73 @@ Identity ShapeFeatures::CastToMeshShape(
   return this->GenerateInvalidId();
 }
 
+/////////////////////////////////////////////////
+/// \brief Get the world bounding box of the compound shape of a link.
+/// \param[in] _link Link to get the box of.
+/// \param[out] _box World bounding box of the link.
+/// \return False if the link has no shapes.
+static bool LinkWorldBoundingBox(const LinkInfo &_link, AlignedBox3d &_box)
+{
+  if (!_link.link || !_link.collisionShape ||
+      _link.collisionShape->getNumChildShapes() == 0)
+  {
+    return false;
+  }
+
+  // The compound shape keeps the bounding box of its children, which bullet
+  // also refits the broadphase proxy of the body with while stepping.
+  btVector3 min;
+  btVector3 max;
+  _link.link->getAabb(min, max);
+  _box = AlignedBox3d(convert(min), convert(max));
+  return true;
+}
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldLinkBoundingBoxes(
+    const Identity &_worldID) const -> BoundingBoxBatch
+{
+  this->linkBoundingBoxes.Clear();
+
+  AlignedBox3d box;
+  const auto *world = this->ReferenceInterface<WorldInfo>(_worldID);
+  for (const std::size_t modelID : world->models)
+  {
+    for (const std::size_t linkID : this->models.at(modelID)->links)
+    {
+      if (LinkWorldBoundingBox(*this->links.at(linkID), box))
+        this->linkBoundingBoxes.Add(linkID, box);
+    }
+  }
+
+  return this->linkBoundingBoxes.View();
+}
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldModelBoundingBoxes(
+    const Identity &_worldID) const -> BoundingBoxBatch
+{
+  this->modelBoundingBoxes.Clear();
+
+  AlignedBox3d box;
+  AlignedBox3d modelBox;
+  const auto *world = this->ReferenceInterface<WorldInfo>(_worldID);
+  for (const std::size_t modelID : world->models)
+  {
+    modelBox.setEmpty();
+    for (const std::size_t linkID : this->models.at(modelID)->links)
+    {
+      if (LinkWorldBoundingBox(*this->links.at(linkID), box))
+        modelBox.extend(box);
+    }
+
+    if (!modelBox.isEmpty())
+      this->modelBoundingBoxes.Add(modelID, modelBox);
+  }
+
+  return this->modelBoundingBoxes.View();
+}
+
 }  // namespace bullet
 }  // namespace physics
 }  // namespace gz
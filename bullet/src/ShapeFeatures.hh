@@ -18,7 +18,9 @@
 #ifndef GZ_PHYSICS_BULLET_SRC_SHAPEFEATURES_HH_
 #define GZ_PHYSICS_BULLET_SRC_SHAPEFEATURES_HH_
 
+#include <gz/physics/GetBoundingBox.hh>
 #include <gz/physics/mesh/MeshShape.hh>
+#include <cstddef>
 #include <string>
 
 #include "Base.hh"
@@ -28,13 +30,21 @@ namespace physics {
 namespace bullet {
 
 struct ShapeFeatureList : gz::physics::FeatureList<
-  mesh::AttachMeshShapeFeature
+  mesh::AttachMeshShapeFeature,
+  mesh::AttachConvexMeshShapeFeature,
+  mesh::AttachConvexDecompositionShapeFeature,
+  GetWorldLinkBoundingBoxes
 > { };
 
 class ShapeFeatures :
     public virtual Base,
     public virtual Implements3d<ShapeFeatureList>
 {
+  public: using BoundingBoxBatch =
+      GetWorldLinkBoundingBoxes::BoundingBoxBatchT<FeaturePolicy3d>;
+  public: using BoundingBoxStorage = GetWorldLinkBoundingBoxes::
+      Implementation<FeaturePolicy3d>::BoundingBoxStorage;
+
   public: Identity AttachMeshShape(
       const Identity &_linkID,
       const std::string &_name,
@@ -42,8 +52,37 @@ class ShapeFeatures :
       const Pose3d &_pose,
       const LinearVector3d &_scale) override;
 
+  public: Identity AttachConvexMeshShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const gz::common::Mesh &_mesh,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale) override;
+
+  public: Identity AttachConvexDecompositionShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const gz::common::Mesh &_mesh,
+      std::size_t _maxConvexHulls,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale) override;
+
   public: Identity CastToMeshShape(
       const Identity &_shapeID) const override;
+
+  // ----- Boundingbox Features -----
+  public: BoundingBoxBatch GetWorldLinkBoundingBoxes(
+      const Identity &_worldID) const override;
+
+  public: BoundingBoxBatch GetWorldModelBoundingBoxes(
+      const Identity &_worldID) const override;
+
+  /// \brief Buffers backing the views returned by GetWorldLinkBoundingBoxes.
+  private: mutable BoundingBoxStorage linkBoundingBoxes;
+
+  /// \brief Buffers backing the views returned by
+  /// GetWorldModelBoundingBoxes.
+  private: mutable BoundingBoxStorage modelBoundingBoxes;
 };
 
 }  // namespace bullet
@@ -17,8 +17,11 @@
 
 #include "SimulationFeatures.hh"
 
-#include <unordered_map>
+#include <memory>
 #include <utility>
+#include <vector>
+
+#include <gz/physics/bullet/TaskSchedulerBridge.hh>
 
 namespace gz {
 namespace physics {
@@ -41,10 +44,25 @@ void SimulationFeatures::WorldForwardStep(
     stepSize = dt.count();
   }
 
+  UseBulletThreads(this->StepThreads(*worldInfo), this->taskScheduler);
   worldInfo->world->stepSimulation(static_cast<btScalar>(this->stepSize), 1,
                                    static_cast<btScalar>(this->stepSize));
   this->WriteRequiredData(_h);
   this->Write(_h.Get<ChangedWorldPoses>());
+  this->WriteTwists(_h);
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the world velocity of a link to _twist, as reported by
+/// FrameDataRelativeToWorld.
+static void LinkWorldTwist(const LinkInfo &_info, WorldTwist &_twist)
+{
+  const auto pose = convertToGz(_info.link->getCenterOfMassTransform()) *
+                    _info.inertialPose.Inverse();
+  const auto omega = convertToGz(_info.link->getAngularVelocity());
+  _twist.linearVelocity = convertToGz(_info.link->getLinearVelocity()) +
+      omega.Cross(-pose.Rot() * _info.inertialPose.Pos());
+  _twist.angularVelocity = omega;
 }
 
 void SimulationFeatures::Write(WorldPoses &_worldPoses) const
@@ -69,35 +87,333 @@ void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
   _changedPoses.entries.clear();
   _changedPoses.entries.reserve(this->links.size());
 
-  std::unordered_map<std::size_t, math::Pose3d> newPoses;
+  // The last reported pose lives in the LinkInfo, which also drops it when
+  // the link is removed.
+  auto writeLink = [](std::size_t _id, LinkInfo &_info,
+                      std::vector<WorldPose> &_entries)
+  {
+    // Sleeping bodies are not integrated, and setting their pose or
+    // velocity wakes them up, so they have not moved since they were last
+    // reported.
+    if (_info.hasReportedPose &&
+        _info.link->getActivationState() == ISLAND_SLEEPING)
+    {
+      return;
+    }
 
+    WorldPose wp;
+    wp.pose = convertToGz(_info.link->getCenterOfMassTransform()) *
+              _info.inertialPose.Inverse();
+    wp.body = _id;
+
+    if (!_info.hasReportedPose ||
+        !_info.reportedPose.Pos().Equal(wp.pose.Pos(), 1e-6) ||
+        !_info.reportedPose.Rot().Equal(wp.pose.Rot(), 1e-6))
+    {
+      _entries.push_back(wp);
+      _info.reportedPose = wp.pose;
+      _info.hasReportedPose = true;
+    }
+  };
+
+  if (!this->poseWriter.IsParallel(this->links.size()))
+  {
+    for (const auto &[id, info] : this->links)
+    {
+      // make sure the link exists
+      if (info)
+        writeLink(id, *info, _changedPoses.entries);
+    }
+    return;
+  }
+
+  // The links are kept in a hash map, so flatten them into an array whose
+  // ranges can be written concurrently.
+  this->poseWriteLinks.clear();
   for (const auto &[id, info] : this->links)
   {
-    // make sure the link exists
     if (info)
+      this->poseWriteLinks.emplace_back(id, info.get());
+  }
+
+  this->poseWriter.Write(this->poseWriteLinks.size(),
+      this->taskScheduler.get(), _changedPoses.entries,
+      [&](std::size_t _begin, std::size_t _end,
+          std::vector<WorldPose> &_entries)
+      {
+        for (std::size_t i = _begin; i < _end; ++i)
+        {
+          const auto &[id, info] = this->poseWriteLinks[i];
+          writeLink(id, *info, _entries);
+        }
+      });
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEnginePoseWriteThreads(
+    const Identity &/*_engineID*/,
+    std::size_t _numThreads,
+    std::size_t _minLinks)
+{
+  this->poseWriter.Set(_numThreads, _minLinks);
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::GetEnginePoseWriteThreads(
+    const Identity &/*_engineID*/) const
+{
+  return this->poseWriter.GetThreads();
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::GetEnginePoseWriteMinLinks(
+    const Identity &/*_engineID*/) const
+{
+  return this->poseWriter.GetMinLinks();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEngineDeterministic(
+    const Identity &/*_engineID*/, bool _deterministic)
+{
+  this->deterministic = _deterministic;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetEngineDeterministic(
+    const Identity &/*_engineID*/) const
+{
+  return this->deterministic;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEngineTaskScheduler(
+    const Identity &/*_engineID*/, std::shared_ptr<TaskScheduler> _scheduler)
+{
+  this->taskScheduler = std::move(_scheduler);
+
+  // The pool is not used while there is a scheduler. Bullet switches to it
+  // before the next step of a world.
+  if (this->taskScheduler)
+    this->poseWriter.ReleasePool();
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<TaskScheduler> SimulationFeatures::GetEngineTaskScheduler(
+    const Identity &/*_engineID*/) const
+{
+  return this->taskScheduler;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(WorldTwists &_twists) const
+{
+  _twists.entries.clear();
+  _twists.entries.reserve(this->links.size());
+
+  for (const auto &[id, info] : this->links)
+  {
+    if (!info)
+      continue;
+    WorldTwist twist;
+    LinkWorldTwist(*info, twist);
+    twist.body = id;
+    _twists.entries.push_back(twist);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(ChangedWorldTwists &_changedTwists,
+    const ChangedWorldPoses &_changedPoses) const
+{
+  _changedTwists.entries.clear();
+  _changedTwists.entries.reserve(_changedPoses.entries.size());
+
+  for (const auto &wp : _changedPoses.entries)
+  {
+    WorldTwist twist;
+    twist.body = wp.body;
+    const auto linkIt = this->links.find(wp.body);
+    if (linkIt != this->links.end() && linkIt->second)
+      LinkWorldTwist(*linkIt->second, twist);
+    _changedTwists.entries.push_back(twist);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WriteTwists(ForwardStep::Output &_h) const
+{
+  if (auto *twists = _h.Query<WorldTwists>())
+    this->Write(*twists);
+  if (auto *changedTwists = _h.Query<ChangedWorldTwists>())
+    this->Write(*changedTwists, _h.Get<ChangedWorldPoses>());
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleepEnabled(
+    const Identity &_modelID, bool _enabled)
+{
+  // Links are created with deactivation disabled
+  for (const auto linkID : this->models.at(_modelID)->links)
+  {
+    auto &body = *this->links.at(linkID)->link;
+    if (!_enabled)
     {
-      WorldPose wp;
-      wp.pose = convertToGz(info->link->getCenterOfMassTransform()) *
-                info->inertialPose.Inverse();
-      wp.body = id;
-
-      auto iter = this->prevLinkPoses.find(id);
-      if ((iter == this->prevLinkPoses.end()) ||
-          !iter->second.Pos().Equal(wp.pose.Pos(), 1e-6) ||
-          !iter->second.Rot().Equal(wp.pose.Rot(), 1e-6))
+      body.forceActivationState(DISABLE_DEACTIVATION);
+    }
+    else if (body.getActivationState() == DISABLE_DEACTIVATION)
+    {
+      body.forceActivationState(ACTIVE_TAG);
+      body.setDeactivationTime(0);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelSleepEnabled(
+    const Identity &_modelID) const
+{
+  const auto &modelLinks = this->models.at(_modelID)->links;
+  return !modelLinks.empty() && std::all_of(
+      modelLinks.begin(), modelLinks.end(), [this](std::size_t _linkID)
       {
-        _changedPoses.entries.push_back(wp);
-        newPoses[id] = wp.pose;
-      }
-      else
-        newPoses[id] = iter->second;
+        return this->links.at(_linkID)->link->getActivationState() !=
+            DISABLE_DEACTIVATION;
+      });
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleeping(
+    const Identity &_modelID, bool _sleeping)
+{
+  for (const auto linkID : this->models.at(_modelID)->links)
+  {
+    auto &body = *this->links.at(linkID)->link;
+    if (!_sleeping)
+    {
+      body.activate(true);
+    }
+    else if (body.getActivationState() != DISABLE_DEACTIVATION)
+    {
+      // Same as bullet does for the islands it puts to sleep
+      body.forceActivationState(ISLAND_SLEEPING);
+      body.setLinearVelocity(btVector3(0, 0, 0));
+      body.setAngularVelocity(btVector3(0, 0, 0));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelSleeping(
+    const Identity &_modelID) const
+{
+  const auto &modelLinks = this->models.at(_modelID)->links;
+  return !modelLinks.empty() && std::all_of(
+      modelLinks.begin(), modelLinks.end(), [this](std::size_t _linkID)
+      {
+        return this->links.at(_linkID)->link->getActivationState() ==
+            ISLAND_SLEEPING;
+      });
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleepThresholds(
+    const Identity &_modelID, const SleepThresholds &_thresholds)
+{
+  for (const auto linkID : this->models.at(_modelID)->links)
+  {
+    this->links.at(linkID)->link->setSleepingThresholds(
+        static_cast<btScalar>(_thresholds.linearSpeed),
+        static_cast<btScalar>(_thresholds.angularSpeed));
+  }
+
+  // The time that bodies must be at rest for is global in bullet
+  gDeactivationTime = static_cast<btScalar>(_thresholds.timeout);
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::GetModelSleepThresholds(
+    const Identity &_modelID) const -> SleepThresholds
+{
+  SleepThresholds thresholds;
+  thresholds.timeout = gDeactivationTime;
+
+  // Links are given the same thresholds, so report the ones of the first
+  const auto &modelLinks = this->models.at(_modelID)->links;
+  if (!modelLinks.empty())
+  {
+    const auto &body = *this->links.at(modelLinks.front())->link;
+    thresholds.linearSpeed = body.getLinearSleepingThreshold();
+    thresholds.angularSpeed = body.getAngularSleepingThreshold();
+  }
+  return thresholds;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelKinematic(
+    const Identity &_modelID, bool _kinematic)
+{
+  auto &model = *this->models.at(_modelID);
+  if (model.kinematic == _kinematic)
+    return;
+
+  // bullet moves kinematic objects to the transform of their motion state
+  // every step, so they have to stay active.
+  if (_kinematic)
+  {
+    model.sleepEnabledBeforeKinematic = this->GetModelSleepEnabled(_modelID);
+    this->SetModelSleepEnabled(_modelID, false);
+  }
+
+  auto &world = *this->worlds.at(model.world)->world;
+  for (const auto linkID : model.links)
+  {
+    auto &linkInfo = *this->links.at(linkID);
+    auto &body = *linkInfo.link;
+
+    // The body is added again so that bullet picks the broadphase filter of
+    // its new type
+    world.removeRigidBody(&body);
+    if (_kinematic)
+    {
+      body.setCollisionFlags(
+          body.getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+      body.setMassProps(0, btVector3(0, 0, 0));
+      body.setLinearVelocity(btVector3(0, 0, 0));
+      body.setAngularVelocity(btVector3(0, 0, 0));
+      body.getMotionState()->setWorldTransform(body.getWorldTransform());
+      body.setInterpolationWorldTransform(body.getWorldTransform());
+    }
+    else
+    {
+      body.setCollisionFlags(
+          body.getCollisionFlags() & ~btCollisionObject::CF_KINEMATIC_OBJECT);
+      body.setMassProps(static_cast<btScalar>(linkInfo.mass),
+                        linkInfo.inertia);
     }
+    body.updateInertiaTensor();
+    world.addRigidBody(&body);
   }
 
-  // Save the new poses so that they can be used to check for updates in the
-  // next iteration. Re-setting this->prevLinkPoses with the contents of
-  // newPoses ensures that we aren't caching data for links that were removed
-  this->prevLinkPoses = std::move(newPoses);
+  model.kinematic = _kinematic;
+  if (!_kinematic)
+    this->SetModelSleepEnabled(_modelID, model.sleepEnabledBeforeKinematic);
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelKinematic(
+    const Identity &_modelID) const
+{
+  return this->models.at(_modelID)->kinematic;
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::StepThreads(const WorldInfo &_world) const
+{
+  // The multithreaded dispatcher records contact manifolds, and the
+  // multithreaded solver its constraints, in the order that bullet's task
+  // scheduler hands out work, so a multithreaded step depends on timing.
+  return this->deterministic ? 1u : _world.numThreads;
 }
 
 }  // namespace bullet
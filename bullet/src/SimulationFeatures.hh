@@ -18,11 +18,15 @@
 #ifndef GZ_PHYSICS_BULLET_SRC_SIMULATIONFEATURES_HH_
 #define GZ_PHYSICS_BULLET_SRC_SIMULATIONFEATURES_HH_
 
-#include <unordered_map>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include <gz/physics/CanWriteData.hh>
 #include <gz/physics/ForwardStep.hh>
+#include <gz/physics/KinematicModel.hh>
+#include <gz/physics/Sleep.hh>
+#include <gz/physics/TaskScheduler.hh>
 
 #include "Base.hh"
 
@@ -31,7 +35,13 @@ namespace physics {
 namespace bullet {
 
 struct SimulationFeatureList : gz::physics::FeatureList<
-  ForwardStep
+  ForwardStep,
+  ParallelPoseWriteFeature,
+  DeterministicStepFeature,
+  SleepFeature,
+  SleepThresholdsFeature,
+  KinematicModelFeature,
+  TaskSchedulerFeature
 > { };
 
 class SimulationFeatures :
@@ -47,14 +57,90 @@ class SimulationFeatures :
       ForwardStep::State &_x,
       const ForwardStep::Input &_u) override;
 
+  public: void SetEnginePoseWriteThreads(
+      const Identity &_engineID,
+      std::size_t _numThreads,
+      std::size_t _minLinks) override;
+
+  public: std::size_t GetEnginePoseWriteThreads(
+      const Identity &_engineID) const override;
+
+  public: std::size_t GetEnginePoseWriteMinLinks(
+      const Identity &_engineID) const override;
+
+  public: void SetEngineDeterministic(
+      const Identity &_engineID, bool _deterministic) override;
+
+  public: bool GetEngineDeterministic(
+      const Identity &_engineID) const override;
+
+  public: void SetEngineTaskScheduler(
+      const Identity &_engineID,
+      std::shared_ptr<TaskScheduler> _scheduler) override;
+
+  public: std::shared_ptr<TaskScheduler> GetEngineTaskScheduler(
+      const Identity &_engineID) const override;
+
+  public: void SetModelSleepEnabled(
+      const Identity &_modelID, bool _enabled) override;
+
+  public: bool GetModelSleepEnabled(
+      const Identity &_modelID) const override;
+
+  public: void SetModelSleeping(
+      const Identity &_modelID, bool _sleeping) override;
+
+  public: bool GetModelSleeping(
+      const Identity &_modelID) const override;
+
+  public: void SetModelSleepThresholds(
+      const Identity &_modelID,
+      const SleepThresholds &_thresholds) override;
+
+  public: SleepThresholds GetModelSleepThresholds(
+      const Identity &_modelID) const override;
+
+  public: void SetModelKinematic(
+      const Identity &_modelID, bool _kinematic) override;
+
+  public: bool GetModelKinematic(
+      const Identity &_modelID) const override;
+
   public: void Write(WorldPoses &_worldPoses) const;
   public: void Write(ChangedWorldPoses &_changedPoses) const;
+  public: void Write(WorldTwists &_twists) const;
+  public: void Write(ChangedWorldTwists &_changedTwists,
+                     const ChangedWorldPoses &_changedPoses) const;
+
+  /// \brief Write the twists requested by the output of a step, if any.
+  /// Must be called after the changed poses of the step are written.
+  /// \param[in] _h Output of the step.
+  private: void WriteTwists(ForwardStep::Output &_h) const;
+
+  /// \brief Number of bullet threads to step a world with.
+  /// \param[in] _world World to step.
+  /// \return The thread count of the world, or 1 when stepping
+  /// deterministically.
+  private: std::size_t StepThreads(const WorldInfo &_world) const;
 
   private: double stepSize = 0.001;
 
-  /// \brief link poses from the most recent pose change/update.
-  /// The key is the link's ID, and the value is the link's pose
-  private: mutable std::unordered_map<std::size_t, math::Pose3d> prevLinkPoses;
+  /// \brief Whether worlds are stepped deterministically, see
+  /// DeterministicStepFeature.
+  private: bool deterministic = false;
+
+  /// \brief Settings, threads and buffers of the parallel pose write-out.
+  private: mutable ParallelPoseWriteFeature::Implementation<
+      FeaturePolicy3d>::PoseWriter poseWriter;
+
+  /// \brief Scheduler of the parallel work of the engine, nullptr if the
+  /// engine uses threads of its own, see TaskSchedulerFeature.
+  private: std::shared_ptr<TaskScheduler> taskScheduler;
+
+  /// \brief Links in the order of the last pose write-out, so that ranges
+  /// of them can be handed to the pose write threads.
+  private: mutable std::vector<std::pair<std::size_t, LinkInfo *>>
+      poseWriteLinks;
 };
 
 }  // namespace bullet
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <LinearMath/btScalar.h>
+#if BT_BULLET_VERSION >= 288
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gz/common/Console.hh>
+
+#include <gz/physics/bullet/Broadphase.hh>
+
+#include "GzCollisionDispatcher.hh"
+#include "WorldFeatures.hh"
+
+namespace gz {
+namespace physics {
+namespace bullet {
+
+/////////////////////////////////////////////////
+/// \brief Replace the dynamics world of a world with a
+/// btDiscreteDynamicsWorldMt, which dispatches the narrowphase and solves the
+/// simulation islands through bullet's task scheduler. The collision objects,
+/// constraints, gravity and solver settings are moved to the new world.
+/// \param[in] _worldInfo World to make multithreaded.
+static void MakeWorldMultithreaded(WorldInfo &_worldInfo)
+{
+  btDiscreteDynamicsWorld &oldWorld = *_worldInfo.world;
+
+  // Size the new broadphase while the objects are still in the old world
+  std::shared_ptr<btBroadphaseInterface> broadphase =
+    CreateBroadphase(_worldInfo.broadphaseType, oldWorld);
+
+  // Keep the order of the objects and constraints, the solver results
+  // depend on it.
+  struct ObjectEntry
+  {
+    btCollisionObject *object;
+    int group;
+    int mask;
+  };
+  std::vector<ObjectEntry> objects;
+  const btCollisionObjectArray &oldObjects =
+    oldWorld.getCollisionObjectArray();
+  for (int i = 0; i < oldObjects.size(); ++i)
+  {
+    const btBroadphaseProxy *proxy = oldObjects[i]->getBroadphaseHandle();
+    if (!proxy)
+      continue;
+    objects.push_back({oldObjects[i],
+      static_cast<int>(proxy->m_collisionFilterGroup),
+      static_cast<int>(proxy->m_collisionFilterMask)});
+  }
+
+  std::vector<btTypedConstraint *> constraints;
+  for (int i = 0; i < oldWorld.getNumConstraints(); ++i)
+    constraints.push_back(oldWorld.getConstraint(i));
+
+  for (btTypedConstraint *constraint : constraints)
+    oldWorld.removeConstraint(constraint);
+  for (const ObjectEntry &entry : objects)
+  {
+    btRigidBody *body = btRigidBody::upcast(entry.object);
+    if (body)
+      oldWorld.removeRigidBody(body);
+    else
+      oldWorld.removeCollisionObject(entry.object);
+  }
+
+  btCollisionConfiguration *collisionConfiguration =
+    _worldInfo.collisionConfiguration.get();
+  auto dispatcher =
+    std::make_shared<GzCollisionDispatcher<btCollisionDispatcherMt>>(
+      collisionConfiguration);
+  const auto *oldLimiter =
+    dynamic_cast<const PairContactLimiter *>(_worldInfo.dispatcher.get());
+  if (oldLimiter)
+    dispatcher->SetMaxPairContacts(oldLimiter->GetMaxPairContacts());
+  btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher.get());
+  auto solverPool =
+    std::make_shared<btConstraintSolverPoolMt>(BT_MAX_THREAD_COUNT);
+#if BT_BULLET_VERSION >= 288
+  auto solverMt = std::make_shared<btSequentialImpulseConstraintSolverMt>();
+  auto world = std::make_shared<btDiscreteDynamicsWorldMt>(
+    dispatcher.get(), broadphase.get(), solverPool.get(), solverMt.get(),
+    collisionConfiguration);
+#else
+  std::shared_ptr<btConstraintSolver> solverMt;
+  auto world = std::make_shared<btDiscreteDynamicsWorldMt>(
+    dispatcher.get(), broadphase.get(), solverPool.get(),
+    collisionConfiguration);
+#endif
+  world->setGravity(oldWorld.getGravity());
+  world->getSolverInfo() = oldWorld.getSolverInfo();
+  dispatcher->AttachTo(*world);
+
+  for (const ObjectEntry &entry : objects)
+  {
+    btRigidBody *body = btRigidBody::upcast(entry.object);
+    if (body)
+      world->addRigidBody(body, entry.group, entry.mask);
+    else
+      world->addCollisionObject(entry.object, entry.group, entry.mask);
+  }
+  // The plugin always disables collisions between the bodies of a joint
+  for (btTypedConstraint *constraint : constraints)
+    world->addConstraint(constraint, true);
+
+  // The old world goes first, it references the other objects
+  _worldInfo.world = std::move(world);
+  _worldInfo.solverMt = std::move(solverMt);
+  _worldInfo.solver = std::move(solverPool);
+  _worldInfo.broadphase = std::move(broadphase);
+  _worldInfo.dispatcher = std::move(dispatcher);
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldBroadphase(
+    const Identity &_id, const std::string &_broadphase)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (!worldInfo || _broadphase == worldInfo->broadphaseType)
+    return;
+
+  std::shared_ptr<btBroadphaseInterface> broadphase =
+    CreateBroadphase(_broadphase, *worldInfo->world);
+  if (!broadphase)
+  {
+    gzerr << "Broadphase [" << _broadphase << "] is not supported, keeping ["
+          << worldInfo->broadphaseType << "]." << std::endl;
+    return;
+  }
+
+  btDiscreteDynamicsWorld &world = *worldInfo->world;
+  ReplaceBroadphase(world, broadphase.get(),
+      [&world](btBroadphaseInterface *_new)
+      {
+        world.setBroadphase(_new);
+        if (auto *tester = dynamic_cast<PlanePairTester *>(
+                world.getDispatcher()))
+        {
+          tester->AttachTo(world);
+        }
+      });
+  worldInfo->broadphase = std::move(broadphase);
+  worldInfo->broadphaseType = _broadphase;
+
+  gzmsg << "Using [" << worldInfo->broadphaseType << "] broadphase"
+        << std::endl;
+}
+
+/////////////////////////////////////////////////
+const std::string &WorldFeatures::GetWorldBroadphase(
+    const Identity &_id) const
+{
+  static const std::string empty{""};
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    return worldInfo->broadphaseType;
+  return empty;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldCollisionPairMaxContacts(
+    const Identity &_id, std::size_t _maxContacts)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (!worldInfo)
+    return;
+
+  auto *limiter =
+    dynamic_cast<PairContactLimiter *>(worldInfo->dispatcher.get());
+  if (limiter)
+    limiter->SetMaxPairContacts(_maxContacts);
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldFeatures::GetWorldCollisionPairMaxContacts(
+    const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  const auto *limiter = worldInfo ?
+    dynamic_cast<const PairContactLimiter *>(worldInfo->dispatcher.get()) :
+    nullptr;
+  if (limiter)
+    return limiter->GetMaxPairContacts();
+  return std::numeric_limits<std::size_t>::max();
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldNumThreads(
+    const Identity &_id, std::size_t _numThreads)
+{
+  auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (!worldInfo)
+    return;
+
+  worldInfo->numThreads = std::max<std::size_t>(1u, _numThreads);
+
+  // Worlds are single threaded until more threads are requested. They stay
+  // multithreaded afterwards, and only switch to bullet's sequential task
+  // scheduler when stepped with one thread.
+  if (worldInfo->numThreads > 1u &&
+      !dynamic_cast<btDiscreteDynamicsWorldMt *>(worldInfo->world.get()))
+  {
+    MakeWorldMultithreaded(*worldInfo);
+  }
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldFeatures::GetWorldNumThreads(const Identity &_id) const
+{
+  const auto worldInfo = this->ReferenceInterface<WorldInfo>(_id);
+  if (worldInfo)
+    return worldInfo->numThreads;
+  return 0u;
+}
+
+}  // namespace bullet
+}  // namespace physics
+}  // namespace gz
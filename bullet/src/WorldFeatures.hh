@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_BULLET_SRC_WORLDFEATURES_HH_
+#define GZ_PHYSICS_BULLET_SRC_WORLDFEATURES_HH_
+
+#include <cstddef>
+#include <string>
+
+#include <gz/physics/World.hh>
+
+#include "Base.hh"
+
+namespace gz {
+namespace physics {
+namespace bullet {
+
+struct WorldFeatureList : FeatureList<
+  Broadphase,
+  CollisionPairMaxContacts,
+  NumThreads
+> { };
+
+class WorldFeatures :
+    public virtual Base,
+    public virtual Implements3d<WorldFeatureList>
+{
+  // Documentation inherited
+  public: void SetWorldBroadphase(
+      const Identity &_id, const std::string &_broadphase) override;
+
+  // Documentation inherited
+  public: const std::string &GetWorldBroadphase(const Identity &_id)
+      const override;
+
+  // Documentation inherited
+  public: void SetWorldCollisionPairMaxContacts(
+      const Identity &_id, std::size_t _maxContacts) override;
+
+  // Documentation inherited
+  public: std::size_t GetWorldCollisionPairMaxContacts(const Identity &_id)
+      const override;
+
+  // Documentation inherited
+  public: void SetWorldNumThreads(
+      const Identity &_id, std::size_t _numThreads) override;
+
+  // Documentation inherited
+  public: std::size_t GetWorldNumThreads(const Identity &_id) const override;
+};
+
+}  // namespace bullet
+}  // namespace physics
+}  // namespace gz
+
+#endif
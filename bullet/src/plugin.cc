@@ -28,6 +28,8 @@
 #include "FreeGroupFeatures.hh"
 #include "ShapeFeatures.hh"
 #include "JointFeatures.hh"
+#include "LinkFeatures.hh"
+#include "WorldFeatures.hh"
 
 namespace gz {
 namespace physics {
@@ -40,7 +42,9 @@ struct BulletFeatures : FeatureList <
   KinematicsFeatureList,
   SDFFeatureList,
   ShapeFeatureList,
-  JointFeatureList
+  JointFeatureList,
+  LinkFeatureList,
+  WorldFeatureList
 > { };
 
 class Plugin :
@@ -52,7 +56,9 @@ class Plugin :
     public virtual KinematicsFeatures,
     public virtual SDFFeatures,
     public virtual ShapeFeatures,
-    public virtual JointFeatures
+    public virtual JointFeatures,
+    public virtual LinkFeatures,
+    public virtual WorldFeatures
 {
   public: Identity InitiateEngine(std::size_t /*_engineID*/) override
   {
@@ -69,6 +69,7 @@ void AddedMassFeatures::SetLinkAddedMass(const Identity &_link,
           math::eigen3::convert(featherstoneMatrix));
     }
     bn->setInertia(newInertia);
+    this->UpdateAddedMassLink(_link.id);
   }
 }
 
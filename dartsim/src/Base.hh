@@ -26,21 +26,37 @@
 #include <dart/dynamics/Skeleton.hpp>
 #include <dart/simulation/World.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <gz/common/Console.hh>
+#include <gz/common/WorkerPool.hh>
 #include <gz/math/eigen3/Conversions.hh>
 #include <gz/math/Inertial.hh>
+#include <gz/physics/AdaptiveTimeStep.hh>
+#include <gz/physics/EntityChangeJournal.hh>
+#include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/Implements.hh>
+#include <gz/physics/TaskScheduler.hh>
+#include <gz/physics/mesh/MeshContentHash.hh>
+#include <gz/physics/mesh/PrimitiveFitting.hh>
 
 #include <sdf/Types.hh>
 
+#include "CollisionDetectorSelection.hh"
+#include "GzContactMaterialHandler.hh"
+
 #if DART_VERSION_AT_LEAST(6, 13, 0)
 // The BodyNode::getShapeNodes method was deprecated in dart 6.13.0
 // in favor of an iterator approach with BodyNode::eachShapeNode
@@ -52,6 +68,22 @@ namespace gz {
 namespace physics {
 namespace dartsim {
 
+class TiledHeightmap;
+
+/// \brief Describe the geometry of a shape for Base::InternShape. Floating
+/// point values are written exactly, so only identical geometry shares a key.
+/// \param[in] _type Type of the shape.
+/// \param[in] _values Parameters of the shape.
+/// \return The key.
+template <typename... Values>
+std::string ShapeKey(const std::string &_type, const Values &... _values)
+{
+  std::ostringstream key;
+  key << _type << std::hexfloat;
+  ((key << '|' << _values), ...);
+  return key.str();
+}
+
 /// \brief The structs ModelInfo, LinkInfo, JointInfo, and ShapeInfo are used
 /// for two reasons:
 /// 1) Holding extra information such as the name or offset
@@ -80,12 +112,100 @@ struct LinkInfo
   /// \brief The total link inertia, which may be split between the `link` and
   /// `weldedNodes` body nodes.
   std::optional<math::Inertiald> inertial;
+  /// \brief World transform of the link the last time it was reported as
+  /// changed in ChangedWorldPoses. Only valid if hasReportedWorldTransform is
+  /// true.
+  Eigen::Isometry3d reportedWorldTransform = Eigen::Isometry3d::Identity();
+  /// \brief Whether reportedWorldTransform has been set.
+  bool hasReportedWorldTransform = false;
+  /// \brief Frame of a link that was merged into the body node `link` of
+  /// another link when its model was constructed, see
+  /// sdf::MergeFixedJoints. Null for other links.
+  dart::dynamics::SimpleFramePtr mergedFrame;
+  /// \brief Entity ID of a merged link. Other links are found by their body
+  /// node instead.
+  std::size_t mergedID = 0;
+
+  /// \brief Get the frame of the link.
+  /// \return mergedFrame for merged links, the body node otherwise.
+  const dart::dynamics::Frame *Frame() const
+  {
+    if (this->mergedFrame)
+      return this->mergedFrame.get();
+    return this->link.get();
+  }
+};
+
+/// \brief Gravity of a link with fluid added mass. Gravity is not applied
+/// to such links by dartsim, so it is added as an external force at the
+/// center of mass before each step.
+struct AddedMassLink
+{
+  /// \brief ID of the link
+  std::size_t id;
+  /// \brief The link
+  LinkInfo *info;
+  /// \brief Center of mass in the link frame
+  Eigen::Vector3d com;
+  /// \brief Mass of the link
+  double mass;
+};
+
+/// \brief PD controller with gravity compensation on the joints of a model,
+/// see ModelJointPDControlFeature. Vectors have one value per joint DOF of
+/// the model, in the layout of GetModelJointState.
+struct ModelJointPDControl
+{
+  /// \brief Gain on the position error of each DOF
+  Eigen::VectorXd positionGains;
+  /// \brief Gain on the velocity error of each DOF
+  Eigen::VectorXd velocityGains;
+  /// \brief Target position of each DOF
+  Eigen::VectorXd targetPositions;
+  /// \brief Target velocity of each DOF
+  Eigen::VectorXd targetVelocities;
+  /// \brief Whether to add the gravity forces of the model
+  bool gravityCompensation;
+  /// \brief Joint forces commanded by the user for the step being taken,
+  /// which the control forces of every substep are added to. Kept between
+  /// steps to avoid reallocating.
+  Eigen::VectorXd commands;
+  /// \brief Whether the controller matches the joints of the model in the
+  /// step being taken. Joints may be attached to or detached from the model
+  /// after the controller was set.
+  bool active = false;
 };
 
 struct JointInfo
 {
   dart::dynamics::JointPtr joint;
   dart::dynamics::SimpleFramePtr frame;
+
+  /// \brief Constraint of a fixed joint attached through
+  /// AttachFixedJointAsConstraintFeature, which has no `joint`. Reset when
+  /// the joint is detached.
+  dart::constraint::WeldJointConstraintPtr weldConstraint;
+
+  /// \brief The fields below are only used by joints with a weldConstraint.
+  /// Name of the joint.
+  std::string name;
+
+  /// \brief Parent body node of weldConstraint, nullptr for the world.
+  dart::dynamics::BodyNode *parentBody = nullptr;
+
+  /// \brief Child body node of weldConstraint.
+  dart::dynamics::BodyNode *childBody = nullptr;
+
+  /// \brief Transform of the joint in the parent body node.
+  Eigen::Isometry3d transformFromParent = Eigen::Isometry3d::Identity();
+
+  /// \brief Transform of the joint in the child body node.
+  Eigen::Isometry3d transformFromChild = Eigen::Isometry3d::Identity();
+
+  /// \brief Positions followed by velocities of the degrees of freedom of
+  /// `joint` the last time it was written to ChangedJointStates. Empty if it
+  /// has not been written yet.
+  std::vector<double> reportedState;
 };
 
 struct ModelInfo
@@ -97,6 +217,15 @@ struct ModelInfo
   std::vector<std::shared_ptr<LinkInfo>> links {};
   std::vector<std::shared_ptr<JointInfo>> joints {};
   std::vector<std::size_t> nestedModels = {};
+
+  /// \brief Index in `links` of each link by its Gazebo-specified name, so
+  /// that links can be looked up by name without scanning the model.
+  std::unordered_map<std::string, std::size_t> linkNameToIndex {};
+
+  /// \brief Index in `joints` of each joint by the name it was created
+  /// with. Like `joints`, it keeps track of joints even as they move to other
+  /// skeletons.
+  std::unordered_map<std::string, std::size_t> jointNameToIndex {};
 };
 
 struct ShapeInfo
@@ -114,13 +243,40 @@ struct ShapeInfo
   /// where T_g is the relative transform according to Gazebo and T_d is the
   /// relative transform according to dartsim.
   Eigen::Isometry3d tf_offset = Eigen::Isometry3d::Identity();
+
+  /// \brief Tiles of the heightmap, if this shape is the placeholder of a
+  /// tiled heightmap. The tiles are attached to the link as they are needed.
+  std::shared_ptr<TiledHeightmap> tiledHeightmap;
 };
 
+/// \brief Storage for the entities of one type.
+///
+/// The objects and their entity IDs are kept in two contiguous arrays, so
+/// iterating over every entity of a type is a linear pass, see Ids() and
+/// Objects(). Looking up an entity by ID indexes a slot array directly
+/// instead of hashing. Entity IDs are never reused, so a slot cannot be
+/// claimed by a different entity once its entity is removed. Removing an
+/// entity moves the last object into its place, so the order of Objects()
+/// is not stable across removals.
 template <typename Value1, typename Key2 = Value1>
 struct EntityStorage
 {
-  /// \brief Map from an entity ID to its corresponding object
-  std::unordered_map<std::size_t, Value1> idToObject;
+  /// \brief Marks a slot, container or index that is not set.
+  static constexpr std::size_t kInvalid =
+      std::numeric_limits<std::size_t>::max();
+
+  /// \brief Per entity ID bookkeeping
+  struct Slot
+  {
+    /// \brief Index of the entity in ids and objects
+    std::size_t dense = kInvalid;
+
+    /// \brief ID of the container of the entity
+    std::size_t containerID = kInvalid;
+
+    /// \brief Index of the entity within its container
+    std::size_t indexInContainer = kInvalid;
+  };
 
   /// \brief Map from an object pointer (or other unique key) to its entity ID
   std::unordered_map<Key2, std::size_t> objectToID;
@@ -140,50 +296,98 @@ struct EntityStorage
   /// their Models, so we do not need to use this field for Joints
   IndexMap indexInContainerToID;
 
-  /// \brief Map from an entity ID to its index within its container
-  std::unordered_map<std::size_t, std::size_t> idToIndexInContainer;
-
-  /// \brief Map from an entity ID to the ID of its container
-  std::unordered_map<std::size_t, std::size_t> idToContainerID;
-
   Value1 &operator[](const std::size_t _id)
   {
-    return idToObject[_id];
+    Slot &slot = this->SlotOf(_id);
+    if (slot.dense == kInvalid)
+    {
+      slot.dense = this->objects.size();
+      this->ids.push_back(_id);
+      this->objects.emplace_back();
+    }
+    return this->objects[slot.dense];
   }
 
   Value1 &at(const std::size_t _id)
   {
-    return idToObject.at(_id);
+    Value1 *value = this->Find(_id);
+    if (!value)
+      throw std::out_of_range("EntityStorage: unknown entity");
+    return *value;
   }
 
   const Value1 &at(const std::size_t _id) const
   {
-    return idToObject.at(_id);
+    const Value1 *value = this->Find(_id);
+    if (!value)
+      throw std::out_of_range("EntityStorage: unknown entity");
+    return *value;
+  }
+
+  /// \brief Find the object of an entity.
+  /// \param[in] _id Entity ID.
+  /// \return The object, or nullptr if there is no such entity.
+  Value1 *Find(const std::size_t _id)
+  {
+    if (_id >= this->slots.size() || this->slots[_id].dense == kInvalid)
+      return nullptr;
+    return &this->objects[this->slots[_id].dense];
+  }
+
+  /// \brief Find the object of an entity.
+  /// \param[in] _id Entity ID.
+  /// \return The object, or nullptr if there is no such entity.
+  const Value1 *Find(const std::size_t _id) const
+  {
+    if (_id >= this->slots.size() || this->slots[_id].dense == kInvalid)
+      return nullptr;
+    return &this->objects[this->slots[_id].dense];
   }
 
   std::optional<Value1> MaybeAt(const std::size_t _id) const
   {
-    auto it = this->idToObject.find(_id);
-    if (it != this->idToObject.end())
+    const Value1 *value = this->Find(_id);
+    if (value)
     {
-      return it->second;
+      return *value;
     }
     return std::nullopt;
   }
 
   Value1 &at(const Key2 &_key)
   {
-    return idToObject.at(objectToID.at(_key));
+    return this->at(objectToID.at(_key));
   }
 
   const Value1 &at(const Key2 &_key) const
   {
-    return idToObject.at(objectToID.at(_key));
+    return this->at(objectToID.at(_key));
   }
 
   std::size_t size() const
   {
-    return idToObject.size();
+    return this->objects.size();
+  }
+
+  /// \brief Estimate the bytes used by the bookkeeping of one entity, not
+  /// counting what its object points to.
+  static constexpr std::size_t EntryBytes()
+  {
+    return sizeof(Slot) + sizeof(std::size_t) + sizeof(Value1) +
+        sizeof(typename std::unordered_map<Key2, std::size_t>::value_type) +
+        2 * sizeof(void *);
+  }
+
+  /// \brief IDs of every entity, parallel to Objects().
+  const std::vector<std::size_t> &Ids() const
+  {
+    return this->ids;
+  }
+
+  /// \brief Objects of every entity, parallel to Ids().
+  const std::vector<Value1> &Objects() const
+  {
+    return this->objects;
   }
 
   std::size_t IdentityOf(const Key2 &_key) const
@@ -198,21 +402,65 @@ struct EntityStorage
 
   bool HasEntity(const std::size_t _id) const
   {
-    return idToObject.find(_id) != idToObject.end();
+    return nullptr != this->Find(_id);
+  }
+
+  /// \brief Check whether an entity was added with a container.
+  /// \param[in] _id Entity ID.
+  bool HasContainer(const std::size_t _id) const
+  {
+    return _id < this->slots.size() &&
+        this->slots[_id].containerID != kInvalid;
+  }
+
+  /// \brief Get the ID of the container of an entity.
+  /// \param[in] _id Entity ID.
+  /// \throws std::out_of_range if the entity has no container.
+  std::size_t ContainerIDOf(const std::size_t _id) const
+  {
+    if (!this->HasContainer(_id))
+      throw std::out_of_range("EntityStorage: entity has no container");
+    return this->slots[_id].containerID;
+  }
+
+  /// \brief Get the index of an entity within its container.
+  /// \param[in] _id Entity ID.
+  /// \throws std::out_of_range if the entity has no container.
+  std::size_t IndexInContainerOf(const std::size_t _id) const
+  {
+    if (!this->HasContainer(_id))
+      throw std::out_of_range("EntityStorage: entity has no container");
+    return this->slots[_id].indexInContainer;
+  }
+
+  /// \brief Add an entity that is not tracked within a container.
+  void AddEntity(std::size_t _id, const Value1 &_value1, const Key2 &_key)
+  {
+    (*this)[_id] = _value1;
+    this->objectToID[_key] = _id;
   }
 
   void AddEntity(std::size_t _id, const Value1 &_value1, const Key2 &_key,
                  std::size_t _containerID)
   {
-    this->idToObject[_id] = _value1;
+    this->AddEntityWithoutKey(_id, _value1, _containerID);
     this->objectToID[_key] = _id;
+  }
+
+  /// \brief Add an entity that has no key of its own, e.g. because its
+  /// object is shared with another entity. It can only be looked up and
+  /// removed by its ID.
+  void AddEntityWithoutKey(std::size_t _id, const Value1 &_value1,
+                           std::size_t _containerID)
+  {
+    (*this)[_id] = _value1;
     std::vector<std::size_t> &indexInContainerToIDVector =
         this->indexInContainerToID[_containerID];
-    const std::size_t indexInContainer = indexInContainerToIDVector.size();
 
-    this->idToIndexInContainer[_id] = indexInContainer;
+    Slot &slot = this->slots[_id];
+    slot.containerID = _containerID;
+    slot.indexInContainer = indexInContainerToIDVector.size();
     indexInContainerToIDVector.push_back(_id);
-    this->idToContainerID[_id] = _containerID;
   }
 
   bool RemoveEntity(const Key2 &_key)
@@ -224,38 +472,140 @@ struct EntityStorage
 
       // Check if we are keeping track of the index of this entity in its
       // container
-      auto contIter = this->idToContainerID.find(entId);
-      if (contIter != this->idToContainerID.end())
+      if (this->HasContainer(entId))
       {
-        std::size_t contId = contIter->second;
-        std::size_t entIndex = this->idToIndexInContainer.at(entId);
-
-        // house keeping
-        // The key in indexInContainerToID is the index of the vector so erasing
-        // the element automatically decrements the index of the rest of the
-        // elements of the vector. The indices in idToIndexInContainer, however,
-        // are stored as numbers (as values in the map). We need to decrement
-        // all the indices greater than the index of the model we are removing.
-        for (auto indIter =
-                 this->indexInContainerToID[contId].begin() + entIndex + 1;
-             indIter != this->indexInContainerToID[contId].end(); ++indIter)
+        Slot &slot = this->slots[entId];
+        std::vector<std::size_t> &siblings =
+            this->indexInContainerToID[slot.containerID];
+
+        // The entities after this one in the container move down by one.
+        for (auto indIter = siblings.begin() + slot.indexInContainer + 1;
+             indIter != siblings.end(); ++indIter)
         {
-          // decrement the index (the value of the map)
-          --this->idToIndexInContainer[*indIter];
+          --this->slots[*indIter].indexInContainer;
         }
 
-        this->idToIndexInContainer.erase(entId);
-        this->indexInContainerToID[contId].erase(
-            this->indexInContainerToID[contId].begin() + entIndex);
-        this->idToContainerID.erase(entId);
+        siblings.erase(siblings.begin() + slot.indexInContainer);
+        slot.containerID = kInvalid;
+        slot.indexInContainer = kInvalid;
       }
 
       this->objectToID.erase(entIter);
-      this->idToObject.erase(entId);
+      this->RemoveDense(entId);
       return true;
     }
     return false;
   }
+
+  /// \brief Remove several entities at once. Each container that holds some
+  /// of them is compacted once, instead of once per entity as RemoveEntity
+  /// does, so removing all the entities of a container is linear in its size.
+  /// The order of the remaining entities within their containers is kept.
+  /// \param[in] _keys Keys of the entities to remove.
+  /// \return Number of entities that were found and removed.
+  std::size_t RemoveEntities(const std::vector<Key2> &_keys)
+  {
+    std::vector<std::size_t> ids;
+    ids.reserve(_keys.size());
+    for (const Key2 &key : _keys)
+    {
+      auto entIter = this->objectToID.find(key);
+      if (entIter == this->objectToID.end())
+        continue;
+
+      ids.push_back(entIter->second);
+      this->objectToID.erase(entIter);
+    }
+    return this->RemoveEntitiesByID(ids);
+  }
+
+  /// \brief Remove several entities by their IDs, see RemoveEntities. This
+  /// also removes entities added with AddEntityWithoutKey. Keys of the
+  /// entities are not forgotten, so entities with a key should be removed
+  /// with RemoveEntities.
+  /// \param[in] _ids IDs of the entities to remove.
+  /// \return Number of entities that were found and removed.
+  std::size_t RemoveEntitiesByID(const std::vector<std::size_t> &_ids)
+  {
+    std::vector<std::size_t> containers;
+    std::size_t removed = 0u;
+    for (const std::size_t entId : _ids)
+    {
+      if (!this->HasEntity(entId))
+        continue;
+
+      if (this->HasContainer(entId))
+      {
+        // Leave a hole in the container, which is closed below
+        Slot &slot = this->slots[entId];
+        this->indexInContainerToID[slot.containerID][slot.indexInContainer] =
+            kInvalid;
+        containers.push_back(slot.containerID);
+        slot.containerID = kInvalid;
+        slot.indexInContainer = kInvalid;
+      }
+
+      this->RemoveDense(entId);
+      ++removed;
+    }
+
+    std::sort(containers.begin(), containers.end());
+    containers.erase(std::unique(containers.begin(), containers.end()),
+                     containers.end());
+    for (const std::size_t containerID : containers)
+    {
+      std::vector<std::size_t> &siblings =
+          this->indexInContainerToID[containerID];
+      std::size_t kept = 0u;
+      for (const std::size_t id : siblings)
+      {
+        if (id == kInvalid)
+          continue;
+        this->slots[id].indexInContainer = kept;
+        siblings[kept++] = id;
+      }
+      siblings.resize(kept);
+    }
+    return removed;
+  }
+
+  /// \brief Move the last object into the place of a removed entity to keep
+  /// the arrays dense.
+  /// \param[in] _id ID of the removed entity.
+  private: void RemoveDense(const std::size_t _id)
+  {
+    if (_id >= this->slots.size() || this->slots[_id].dense == kInvalid)
+      return;
+
+    const std::size_t dense = this->slots[_id].dense;
+    const std::size_t last = this->objects.size() - 1u;
+    if (dense != last)
+    {
+      this->objects[dense] = std::move(this->objects[last]);
+      this->ids[dense] = this->ids[last];
+      this->slots[this->ids[dense]].dense = dense;
+    }
+    this->objects.pop_back();
+    this->ids.pop_back();
+    this->slots[_id].dense = kInvalid;
+  }
+
+  /// \brief Get the slot of an entity ID, growing the slot array if needed.
+  private: Slot &SlotOf(const std::size_t _id)
+  {
+    if (_id >= this->slots.size())
+      this->slots.resize(_id + 1u);
+    return this->slots[_id];
+  }
+
+  /// \brief Entity IDs, parallel to objects
+  private: std::vector<std::size_t> ids;
+
+  /// \brief Objects of the entities, parallel to ids
+  private: std::vector<Value1> objects;
+
+  /// \brief Bookkeeping of each entity, indexed by entity ID
+  private: std::vector<Slot> slots;
 };
 
 class Base : public Implements3d<FeatureList<Feature>>
@@ -293,6 +643,24 @@ class Base : public Implements3d<FeatureList<Feature>>
     return entityCount++;
   }
 
+  /// \brief Record a structural change of a world in its journal, see
+  /// EntityChangeJournalFeature.
+  /// \param[in] _worldID ID of the world. Changes of entities that are not
+  /// in a world are not recorded.
+  /// \param[in] _type What happened to the entity.
+  /// \param[in] _kind Kind of the entity.
+  /// \param[in] _entity ID of the entity.
+  /// \param[in] _related ID of the entity the change relates to, see
+  /// EntityChange::Type.
+  public: void RecordEntityChange(const std::size_t _worldID,
+      const EntityChange::Type _type, const EntityChange::Kind _kind,
+      const std::size_t _entity, const std::size_t _related)
+  {
+    if (!this->worlds.HasEntity(_worldID))
+      return;
+    this->entityChanges[_worldID].Record(_type, _kind, _entity, _related);
+  }
+
   public: std::size_t entityCount = 0;
 
   public: inline std::size_t AddWorld(
@@ -310,9 +678,26 @@ class Base : public Implements3d<FeatureList<Feature>>
     modelInfo->localName = _name;
     this->modelProxiesToWorld.AddEntity(id, modelInfo, _world, 0);
 
+#ifdef DART_HAS_CONTACT_SURFACE
+    auto materials =
+        std::make_shared<dart::constraint::GzContactMaterialHandler>();
+    _world->getConstraintSolver()->addContactSurfaceHandler(materials);
+    this->contactMaterials[id] = materials;
+#endif
+
     return id;
   }
 
+  /// \brief Drop the cached contact surface parameters of all worlds. Call
+  /// this whenever the surface properties of a shape node change.
+  public: void InvalidateContactMaterials()
+  {
+#ifdef DART_HAS_CONTACT_SURFACE
+    for (auto &entry : this->contactMaterials)
+      entry.second->Clear();
+#endif
+  }
+
   public: inline std::tuple<std::size_t, ModelInfo&> AddModel(
       const ModelInfo &_info, const std::size_t _worldID)
   {
@@ -328,6 +713,8 @@ class Base : public Implements3d<FeatureList<Feature>>
     }
     auto modelProxy = this->modelProxiesToWorld.at(_worldID);
     modelProxy->nestedModels.push_back(id);
+    this->RecordEntityChange(_worldID, EntityChange::Type::CREATED,
+                             EntityChange::Kind::MODEL, id, _worldID);
 
     return std::forward_as_tuple(id, *entry);
   }
@@ -347,6 +734,8 @@ class Base : public Implements3d<FeatureList<Feature>>
 
     auto parentModelInfo = this->GetModelInfo(_parentID);
     parentModelInfo->nestedModels.push_back(id);
+    this->RecordEntityChange(_worldID, EntityChange::Type::CREATED,
+                             EntityChange::Kind::MODEL, id, _parentID);
     return {id, *entry};
   }
 
@@ -367,11 +756,79 @@ class Base : public Implements3d<FeatureList<Feature>>
     this->frames[id] = _bn;
 
     this->linksByName[_fullName] = _bn;
-    this->models.at(_modelID)->links.push_back(linkInfo);
+    auto &modelInfo = *this->models.at(_modelID);
+    modelInfo.linkNameToIndex.emplace(linkInfo->name, modelInfo.links.size());
+    modelInfo.links.push_back(linkInfo);
+    this->UpdateAddedMassLink(id);
+    this->RecordEntityChange(this->GetWorldOfModelImpl(_modelID),
+        EntityChange::Type::CREATED, EntityChange::Kind::LINK, id, _modelID);
 
     return id;
   }
 
+  /// \brief Add a link that was merged into the body node of another link
+  /// when its model was constructed, see sdf::MergeFixedJoints. The link has
+  /// a frame of its own, but no body node.
+  /// \param[in] _bn Body node that the link was merged into
+  /// \param[in] _name Gazebo-specified name of the link
+  /// \param[in] _tf Transform of the link relative to _bn
+  /// \param[in] _modelID ID of the model of the link
+  /// \param[in] _inertial Inertial of the link, which should already be
+  /// part of the inertia of _bn
+  /// \return ID of the link
+  public: inline std::size_t AddMergedLink(DartBodyNode *_bn,
+        const std::string &_name, const Eigen::Isometry3d &_tf,
+        std::size_t _modelID,
+        std::optional<math::Inertiald> _inertial = std::nullopt)
+  {
+    const std::size_t id = this->GetNextEntity();
+    auto linkInfo = std::make_shared<LinkInfo>();
+    linkInfo->link = _bn;
+    linkInfo->name = _name;
+    linkInfo->inertial = _inertial;
+    linkInfo->mergedFrame = dart::dynamics::SimpleFrame::createShared(
+        _bn, _bn->getName() + "::" + _name, _tf);
+    linkInfo->mergedID = id;
+    this->links.AddEntityWithoutKey(id, linkInfo, _modelID);
+    this->frames[id] = linkInfo->mergedFrame.get();
+
+    auto &modelInfo = *this->models.at(_modelID);
+    modelInfo.linkNameToIndex.emplace(linkInfo->name, modelInfo.links.size());
+    modelInfo.links.push_back(linkInfo);
+    this->RecordEntityChange(this->GetWorldOfModelImpl(_modelID),
+        EntityChange::Type::CREATED, EntityChange::Kind::LINK, id, _modelID);
+
+    return id;
+  }
+
+  /// \brief Add, update or remove the entry of a link in addedMassLinks
+  /// after its inertial changed.
+  /// \param[in] _linkID ID of the link
+  public: void UpdateAddedMassLink(std::size_t _linkID)
+  {
+    auto it = std::find_if(
+        this->addedMassLinks.begin(), this->addedMassLinks.end(),
+        [_linkID](const AddedMassLink &_entry)
+        {
+          return _entry.id == _linkID;
+        });
+
+    LinkInfo *info = this->links.at(_linkID).get();
+    if (!info->inertial || !info->inertial->FluidAddedMass().has_value())
+    {
+      if (it != this->addedMassLinks.end())
+        this->addedMassLinks.erase(it);
+      return;
+    }
+
+    if (it == this->addedMassLinks.end())
+      it = this->addedMassLinks.emplace(this->addedMassLinks.end());
+    it->id = _linkID;
+    it->info = info;
+    it->com = math::eigen3::convert(info->inertial->Pose().Pos());
+    it->mass = info->inertial->MassMatrix().Mass();
+  }
+
   private: static math::Inertiald DivideInertial(
                const math::Inertiald &_wholeInertial, std::size_t _count)
   {
@@ -390,7 +847,7 @@ class Base : public Implements3d<FeatureList<Feature>>
     return dividedInertial;
   }
 
-  private: static void AssignInertialToBody(
+  public: static void AssignInertialToBody(
                const math::Inertiald &_inertial, DartBodyNode * _body)
   {
     const math::Matrix3d &moi = _inertial.Moi();
@@ -486,8 +943,14 @@ class Base : public Implements3d<FeatureList<Feature>>
     }
   }
 
+  /// \brief Add a joint to a model.
+  /// \param[in] _joint The joint
+  /// \param[in] _name Gazebo-specified name of the joint, which dartsim may
+  /// have changed to keep the names of a skeleton unique
+  /// \param[in] _modelID ID of the model of the joint
+  /// \return ID of the joint
   public: inline std::size_t AddJoint(DartJoint *_joint,
-      const std::string &_fullName, std::size_t _modelID)
+      const std::string &_name, std::size_t _modelID)
   {
     const std::size_t id = this->GetNextEntity();
     auto jointInfo = std::make_shared<JointInfo>();
@@ -499,10 +962,13 @@ class Base : public Implements3d<FeatureList<Feature>>
             _joint->getChildBodyNode(), _joint->getName() + "_frame",
             _joint->getTransformFromChildBodyNode());
 
-    this->jointsByName[_fullName] = _joint;
-    this->GetModelInfo(_modelID)->joints.push_back(jointInfo);
-    this->joints.idToObject[id]->frame = jointFrame;
-    this->frames[id] = this->joints.idToObject[id]->frame.get();
+    const auto modelInfo = this->GetModelInfo(_modelID);
+    modelInfo->jointNameToIndex[_name] = modelInfo->joints.size();
+    modelInfo->joints.push_back(jointInfo);
+    this->joints.at(id)->frame = jointFrame;
+    this->frames[id] = this->joints.at(id)->frame.get();
+    this->RecordEntityChange(this->GetWorldOfModelImpl(_modelID),
+        EntityChange::Type::CREATED, EntityChange::Kind::JOINT, id, _modelID);
 
     return id;
   }
@@ -511,65 +977,289 @@ class Base : public Implements3d<FeatureList<Feature>>
       const ShapeInfo &_info)
   {
     const std::size_t id = this->GetNextEntity();
-    this->shapes.idToObject[id] = std::make_shared<ShapeInfo>(_info);
-    this->shapes.objectToID[_info.node] = id;
+    this->shapes.AddEntity(id, std::make_shared<ShapeInfo>(_info),
+                           _info.node.get());
     this->frames[id] = _info.node.get();
 
     return id;
   }
 
+  /// \brief Get the shape shared by every shape node with the same geometry,
+  /// building it if there is none yet. Shape nodes only hold their pose and
+  /// surface properties, so the geometry of identical collisions, such as
+  /// many copies of a model, is stored once.
+  /// \param[in] _key Describes the geometry, see ShapeKey.
+  /// \param[in] _factory Builds the shape if no shape node uses it anymore.
+  /// \return The shared shape.
+  public: template <typename FactoryT>
+  dart::dynamics::ShapePtr InternShape(
+      const std::string &_key, FactoryT &&_factory)
+  {
+    auto &shared = this->sharedShapes[_key];
+    if (auto shape = shared.lock())
+      return shape;
+
+    dart::dynamics::ShapePtr shape = _factory();
+    shared = shape;
+
+    // Drop the keys of geometry that is no longer used, once they could
+    // make up half of the table.
+    if (this->sharedShapes.size() > 2u * this->sharedShapesAfterPrune + 64u)
+    {
+      for (auto it = this->sharedShapes.begin();
+           it != this->sharedShapes.end();)
+      {
+        if (it->second.expired())
+          it = this->sharedShapes.erase(it);
+        else
+          ++it;
+      }
+      this->sharedShapesAfterPrune = this->sharedShapes.size();
+    }
+    return shape;
+  }
+
   public: bool RemoveModelImpl(const std::size_t _worldID,
                                const std::size_t _modelID)
+  {
+    return 1u == this->RemoveModelsImpl(_worldID, {_modelID});
+  }
+
+  /// \brief Remove models of a world along with their nested models, links,
+  /// joints and shapes. The bookkeeping of each container is compacted once
+  /// for the whole batch, so removing many models at once does not cost time
+  /// quadratic in the number of their parts.
+  /// Note, it is the responsibility of the caller to avoid passing IDs of
+  /// proxy models of worlds.
+  /// \param[in] _worldID ID of the world of the models.
+  /// \param[in] _modelIDs IDs of the models to remove. IDs of unknown models,
+  /// and of models nested in other models of the batch, are skipped.
+  /// \return Number of models of _modelIDs that were removed.
+  public: std::size_t RemoveModelsImpl(
+      const std::size_t _worldID, const std::vector<std::size_t> &_modelIDs)
   {
     const auto &world = this->worlds.at(_worldID);
-    auto modelInfo = this->models.at(_modelID);
-    auto skel = modelInfo->model;
-    // Remove the contents of the skeleton from local entity storage containers
-    for (auto &nestedModel : modelInfo->nestedModels)
+
+    ModelRemoval removal;
+    std::size_t removed = 0u;
+    for (const std::size_t modelID : _modelIDs)
+    {
+      if (!this->models.HasEntity(modelID) ||
+          removal.modelIDs.count(modelID) > 0u)
+      {
+        continue;
+      }
+
+      // Entries of the batch are taken out of the nested models of their
+      // parents below. Nested models go with their parents.
+      const std::size_t parentID = this->models.ContainerIDOf(modelID);
+      removal.parents.emplace_back(parentID, modelID);
+      this->CollectModelRemoval(world->getName(), modelID, removal);
+      ++removed;
+    }
+
+    auto isRemoved = [&removal](const std::size_t _id)
+    {
+      return removal.modelIDs.count(_id) > 0u;
+    };
+    std::sort(removal.parents.begin(), removal.parents.end());
+    for (auto it = removal.parents.begin(); it != removal.parents.end();)
+    {
+      const std::size_t parentID = it->first;
+      while (it != removal.parents.end() && it->first == parentID)
+        ++it;
+
+      // Parents that are removed as well had their nested models cleared
+      if (isRemoved(parentID))
+        continue;
+
+      auto &nestedModels = this->GetModelInfo(parentID)->nestedModels;
+      nestedModels.erase(std::remove_if(
+          nestedModels.begin(), nestedModels.end(), isRemoved),
+          nestedModels.end());
+    }
+
+    this->RemoveWeldConstraintJoints(_worldID, removal.skeletons);
+
+    // Parts are recorded before the models that contain them, while their
+    // IDs can still be looked up. Body nodes and joints of a skeleton that
+    // are not entities, such as its root FreeJoint, are skipped.
+    auto recordRemoval = [this, _worldID](
+        const auto &_storage, EntityChange::Kind _kind, std::size_t _id)
+    {
+      this->RecordEntityChange(_worldID, EntityChange::Type::REMOVED, _kind,
+                               _id, _storage.ContainerIDOf(_id));
+    };
+    for (const DartJoint *joint : removal.joints)
+    {
+      if (this->joints.HasEntity(joint))
+      {
+        recordRemoval(this->joints, EntityChange::Kind::JOINT,
+                      this->joints.IdentityOf(joint));
+      }
+    }
+    for (const DartBodyNode *bn : removal.links)
+    {
+      if (this->links.HasEntity(bn))
+      {
+        recordRemoval(this->links, EntityChange::Kind::LINK,
+                      this->links.IdentityOf(bn));
+      }
+    }
+    for (const std::size_t linkID : removal.mergedLinks)
+      recordRemoval(this->links, EntityChange::Kind::LINK, linkID);
+    for (auto it = removal.skeletons.rbegin();
+         it != removal.skeletons.rend(); ++it)
+    {
+      recordRemoval(this->models, EntityChange::Kind::MODEL,
+                    this->models.IdentityOf(*it));
+    }
+
+    this->joints.RemoveEntities(removal.joints);
+    this->shapes.RemoveEntities(removal.shapes);
+    this->links.RemoveEntities(removal.links);
+    this->links.RemoveEntitiesByID(removal.mergedLinks);
+    this->models.RemoveEntities(std::vector<DartConstSkeletonPtr>(
+        removal.skeletons.begin(), removal.skeletons.end()));
+    for (const auto &skel : removal.skeletons)
+      world->removeSkeleton(skel);
+
+    this->addedMassLinks.erase(std::remove_if(
+        this->addedMassLinks.begin(), this->addedMassLinks.end(),
+        [this](const AddedMassLink &_entry)
+        {
+          return !this->links.HasEntity(_entry.id);
+        }), this->addedMassLinks.end());
+    for (const std::size_t modelID : removal.modelIDs)
+      this->jointPDControls.erase(modelID);
+    return removed;
+  }
+
+  /// \brief Remove a joint attached through
+  /// AttachFixedJointAsConstraintFeature: take its constraint out of the
+  /// solver and drop its entity. Identities of the joint stay valid, but
+  /// refer to a detached joint.
+  /// \param[in] _jointID ID of the joint.
+  public: void RemoveWeldConstraintJoint(const std::size_t _jointID)
+  {
+    auto it = this->weldConstraintJoints.find(_jointID);
+    if (it == this->weldConstraintJoints.end())
+      return;
+
+    auto jointInfo = this->joints.at(_jointID);
+    this->worlds.at(it->second)->getConstraintSolver()->removeConstraint(
+        jointInfo->weldConstraint);
+    const DartBodyNode *child = jointInfo->childBody;
+    this->RecordEntityChange(it->second, EntityChange::Type::REMOVED,
+        EntityChange::Kind::JOINT, _jointID,
+        this->links.HasEntity(child) ?
+            this->links.ContainerIDOf(this->links.IdentityOf(child)) :
+            INVALID_ENTITY_ID);
+    jointInfo->weldConstraint.reset();
+    jointInfo->parentBody = nullptr;
+    jointInfo->childBody = nullptr;
+    this->joints.RemoveEntitiesByID({_jointID});
+    this->frames.erase(_jointID);
+    this->weldConstraintJoints.erase(it);
+  }
+
+  /// \brief Remove the joints attached through
+  /// AttachFixedJointAsConstraintFeature that hold a body node of the given
+  /// skeletons, which are about to be removed from their world.
+  /// \param[in] _worldID ID of the world of the skeletons.
+  /// \param[in] _skeletons Skeletons to be removed.
+  private: void RemoveWeldConstraintJoints(const std::size_t _worldID,
+      const std::vector<DartSkeletonPtr> &_skeletons)
+  {
+    if (this->weldConstraintJoints.empty())
+      return;
+
+    std::unordered_set<const dart::dynamics::Skeleton *> removed;
+    for (const auto &skel : _skeletons)
+      removed.insert(skel.get());
+    auto holdsRemoved = [&removed](const dart::dynamics::BodyNode *_body)
     {
-      this->RemoveModelImpl(_worldID, nestedModel);
+      return nullptr != _body && removed.count(_body->getSkeleton().get()) > 0;
+    };
+
+    std::vector<std::size_t> jointIDs;
+    for (const auto &[jointID, worldID] : this->weldConstraintJoints)
+    {
+      const auto &jointInfo = this->joints.at(jointID);
+      if (worldID == _worldID &&
+          (holdsRemoved(jointInfo->parentBody) ||
+           holdsRemoved(jointInfo->childBody)))
+      {
+        jointIDs.push_back(jointID);
+      }
     }
+    for (const std::size_t jointID : jointIDs)
+      this->RemoveWeldConstraintJoint(jointID);
+  }
+
+  /// \brief Entities gathered by CollectModelRemoval for RemoveModelsImpl.
+  private: struct ModelRemoval
+  {
+    /// \brief IDs of the gathered models, including nested ones.
+    std::unordered_set<std::size_t> modelIDs;
+
+    /// \brief Pairs of parent ID and model ID of the models of the batch.
+    std::vector<std::pair<std::size_t, std::size_t>> parents;
+
+    std::vector<DartSkeletonPtr> skeletons;
+    std::vector<const DartJoint*> joints;
+    std::vector<const DartBodyNode*> links;
+    std::vector<const DartShapeNode*> shapes;
+
+    /// \brief IDs of links that were merged into other links, which are
+    /// not found by their body node.
+    std::vector<std::size_t> mergedLinks;
+  };
+
+  /// \brief Gather a model, its nested models and their parts for removal,
+  /// and drop their names from linksByName.
+  /// \param[in] _worldName Name of the world of the model.
+  /// \param[in] _modelID ID of the model.
+  /// \param[in,out] _removal Entities to remove.
+  private: void CollectModelRemoval(const std::string &_worldName,
+                                    const std::size_t _modelID,
+                                    ModelRemoval &_removal)
+  {
+    if (!_removal.modelIDs.insert(_modelID).second)
+      return;
+
+    auto modelInfo = this->models.at(_modelID);
+    for (const std::size_t nestedModel : modelInfo->nestedModels)
+      this->CollectModelRemoval(_worldName, nestedModel, _removal);
     modelInfo->nestedModels.clear();
 
-    for (auto &jt : skel->getJoints())
+    for (const auto &linkInfo : modelInfo->links)
     {
-      this->joints.RemoveEntity(jt);
-      this->jointsByName.erase(::sdf::JoinName(
-          world->getName(), ::sdf::JoinName(skel->getName(), jt->getName())));
+      if (linkInfo->mergedFrame)
+        _removal.mergedLinks.push_back(linkInfo->mergedID);
     }
-    for (auto &bn : skel->getBodyNodes())
+
+    const auto &skel = modelInfo->model;
+    _removal.skeletons.push_back(skel);
+    for (auto *jt : skel->getJoints())
+      _removal.joints.push_back(jt);
+    for (auto *bn : skel->getBodyNodes())
     {
 #ifdef DART_HAS_EACH_SHAPE_NODE_API
-      bn->eachShapeNode([this](dart::dynamics::ShapeNode *_sn)
+      bn->eachShapeNode([&_removal](dart::dynamics::ShapeNode *_sn)
       {
-        this->shapes.RemoveEntity(_sn);
+        _removal.shapes.push_back(_sn);
       });
 #else
-      for (auto &sn : bn->getShapeNodes())
+      for (auto *sn : bn->getShapeNodes())
       {
-        this->shapes.RemoveEntity(sn);
+        _removal.shapes.push_back(sn);
       }
 #endif
-      this->links.RemoveEntity(bn);
+      _removal.links.push_back(bn);
       this->linksByName.erase(::sdf::JoinName(
-          world->getName(), ::sdf::JoinName(skel->getName(), bn->getName())));
-    }
-
-    // If this is a nested model, remove an entry from the parent models
-    // "nestedModels" vector
-    // Note, it is the responsibility of the caller to avoid calling this
-    // function when `_modelID` points to a proxy model to a world.
-    auto parentID = this->models.idToContainerID.at(_modelID);
-    const std::size_t modelIndex =
-        this->models.idToIndexInContainer.at(_modelID);
-    auto parentModelInfo = this->GetModelInfo(parentID);
-    if (modelIndex >= parentModelInfo->nestedModels.size())
-      return false;
-    parentModelInfo->nestedModels.erase(parentModelInfo->nestedModels.begin() +
-                                        modelIndex);
-    this->models.RemoveEntity(skel);
-    world->removeSkeleton(skel);
-    return true;
+          _worldName, ::sdf::JoinName(skel->getName(), bn->getName())));
+    }
   }
 
   public: inline std::size_t GetWorldOfModelImpl(
@@ -583,14 +1273,14 @@ class Base : public Implements3d<FeatureList<Feature>>
 
     if (this->models.HasEntity(_modelID))
     {
-      auto parentIt = this->models.idToContainerID.find(_modelID);
-      if (parentIt != this->models.idToContainerID.end())
+      if (this->models.HasContainer(_modelID))
       {
-        if (this->worlds.HasEntity(parentIt->second))
+        const std::size_t parentID = this->models.ContainerIDOf(_modelID);
+        if (this->worlds.HasEntity(parentID))
         {
-          return parentIt->second;
+          return parentID;
         }
-        return this->GetWorldOfModelImpl(parentIt->second);
+        return this->GetWorldOfModelImpl(parentID);
       }
     }
     return this->GenerateInvalidId();
@@ -598,7 +1288,7 @@ class Base : public Implements3d<FeatureList<Feature>>
 
   public: inline Identity GetModelOfLinkImpl(const Identity &_linkID) const
   {
-    const std::size_t modelID = this->links.idToContainerID.at(_linkID);
+    const std::size_t modelID = this->links.ContainerIDOf(_linkID);
     if (this->models.HasEntity(modelID))
     {
       return this->GenerateIdentity(modelID, this->models.at(modelID));
@@ -610,40 +1300,6 @@ class Base : public Implements3d<FeatureList<Feature>>
   };
 
 
-  /// \brief Create a fully (world) scoped joint name.
-  /// \param _modelID Identity of the parent model of the joint's child link.
-  /// \param _name The unscoped joint name.
-  /// \return The fully (world) scoped joint name, or an empty string
-  /// if a world cannot be resolved.
-  public: inline std::string FullyScopedJointName(
-    const std::size_t &_modelID,
-    const std::string &_name) const
-  {
-    if (this->modelProxiesToWorld.HasEntity(_modelID))
-    {
-      auto world = this->worlds.at(_modelID);
-      return ::sdf::JoinName(world->getName(), _name);
-    }
-    else
-    {
-      const auto modelInfo = this->models.at(_modelID);
-
-      auto worldID = this->GetWorldOfModelImpl(_modelID);
-      if (worldID == INVALID_ENTITY_ID)
-      {
-        gzerr << "World of model [" << modelInfo->model->getName()
-              << "] could not be found when creating the fully scoped name of "
-                 "joint ["
-              << _name << "]\n";
-        return "";
-      }
-      auto world = this->worlds.at(worldID);
-      return ::sdf::JoinName(
-          world->getName(),
-          ::sdf::JoinName(modelInfo->model->getName(), _name));
-    }
-  }
-
   public: ModelInfoPtr GetModelInfo(std::size_t _modelID) const
   {
     auto modelProxy = this->modelProxiesToWorld.MaybeAt(_modelID);
@@ -667,15 +1323,134 @@ class Base : public Implements3d<FeatureList<Feature>>
   /// as they move to other skeletons.
   public: std::unordered_map<std::string, DartBodyNode*> linksByName;
 
-  /// \brief Map from the fully qualified joint name (including the world name)
-  /// to the dart Joint object. This is useful for keeping track of
-  /// dart Joints even as they move to other skeletons.
-  public: std::unordered_map<std::string, DartJoint*> jointsByName;
+  /// \brief Number of substeps of each step by world ID, for worlds with
+  /// more than one. See SubSteps.
+  public: std::unordered_map<std::size_t, std::size_t> worldSubSteps;
+
+  /// \brief Adaptive stepping of a world, see AdaptiveTimeStepFeature.
+  public: struct AdaptiveStep
+  {
+    /// \brief Controller that picks the length of the steps.
+    AdaptiveTimeStep controller;
+
+    /// \brief Generalized velocities of the world before a step, reused
+    /// from step to step.
+    Eigen::VectorXd velocities;
+  };
+
+  /// \brief Structural changes of each world by world ID, see
+  /// EntityChangeJournalFeature.
+  public: std::unordered_map<std::size_t, EntityChangeJournal> entityChanges;
+
+  /// \brief Adaptive stepping by world ID, for worlds that have it enabled.
+  public: std::unordered_map<std::size_t, AdaptiveStep> worldAdaptiveSteps;
+
+  /// \brief Length of the last step by world ID, for worlds that have been
+  /// stepped.
+  public: std::unordered_map<std::size_t, double> worldLastStepSizes;
+
+  /// \brief Collision detector selection by world ID, for worlds that use
+  /// the "auto" collision detector.
+  public: std::unordered_map<std::size_t, AutoCollisionDetector>
+      autoCollisionDetectors;
+
+  /// \brief Links with fluid added mass, see AddedMassLink. Kept up to date
+  /// by UpdateAddedMassLink so steps do not visit every link.
+  public: std::vector<AddedMassLink> addedMassLinks;
+
+  /// \brief Joint PD controllers by model ID, see
+  /// ModelJointPDControlFeature.
+  public: std::unordered_map<std::size_t, ModelJointPDControl>
+      jointPDControls;
+
+  /// \brief World ID of each joint attached through
+  /// AttachFixedJointAsConstraintFeature, by joint ID.
+  public: std::unordered_map<std::size_t, std::size_t> weldConstraintJoints;
+
+  /// \brief Whether AttachFixedJoint attaches links with a constraint, see
+  /// AttachFixedJointAsConstraintFeature.
+  public: bool attachFixedJointAsConstraint = false;
 
   /// \brief Map from welded body nodes to the LinkInfo for the original link
   /// they are welded to. This is useful when detaching joints.
   public: std::unordered_map<DartBodyNode*, LinkInfo*> linkByWeldedNode;
 
+  /// \brief Map from the ShapeNodes of heightmap tiles to the ID of the
+  /// heightmap shape they belong to. The tiles are not entities themselves,
+  /// so their contacts are reported for the heightmap.
+  public: std::unordered_map<const DartShapeNode*, std::size_t>
+      heightmapTiles;
+
+  /// \brief Shapes shared by shape nodes with the same geometry, see
+  /// InternShape. Geometry is freed with the last shape node that uses it.
+  public: std::unordered_map<std::string,
+      std::weak_ptr<dart::dynamics::Shape>> sharedShapes;
+
+  /// \brief Size of sharedShapes after its unused keys were last dropped.
+  public: std::size_t sharedShapesAfterPrune = 0u;
+
+#ifdef DART_HAS_CONTACT_SURFACE
+  /// \brief Cached contact surface parameters of each world by world ID,
+  /// see GzContactMaterialHandler.
+  public: std::unordered_map<std::size_t,
+      dart::constraint::GzContactMaterialHandlerPtr> contactMaterials;
+#endif
+
+  /// \brief Content hashes of attached meshes, which key their shapes.
+  public: mesh::MeshContentHashCache meshContentHashes;
+
+  /// \brief Triangle budget of attached meshes, see
+  /// SimplifyCollisionMeshesFeature. 0 disables simplification.
+  public: std::size_t collisionMeshTriangleBudget = 0u;
+
+  /// \brief Largest error of the primitives that replace collision meshes,
+  /// see FitCollisionMeshPrimitivesFeature. 0 disables the fitting.
+  public: double collisionMeshPrimitiveTolerance = 0.0;
+
+  /// \brief Primitives fitted to collision meshes, by content hash.
+  public: mesh::PrimitiveFitCache primitiveFits;
+
+  /// \brief FrameData returned by FrameDataRelativeToWorld, when enabled
+  /// through SetFrameDataCacheFeature. Invalidated by every call that
+  /// changes the kinematic state of a frame.
+  public: mutable SetFrameDataCacheFeature::FrameDataCache<FeaturePolicy3d>
+      frameDataCache;
+
+  /// \brief Scheduler of the parallel work of the engine, nullptr if the
+  /// engine uses thread pools of its own, see TaskSchedulerFeature.
+  public: std::shared_ptr<TaskScheduler> taskScheduler;
+
+  /// \brief Run tasks on taskScheduler, or on a thread pool of the engine
+  /// without a scheduler.
+  /// \param[in,out] _pool Pool used without a scheduler. Created, or
+  /// replaced, to have _numThreads threads.
+  /// \param[in,out] _poolThreads Number of threads of _pool.
+  /// \param[in] _numThreads Number of threads of the pool.
+  /// \param[in] _count Number of tasks.
+  /// \param[in] _task Task, called with the index of each task.
+  public: inline void RunTasks(
+      std::unique_ptr<gz::common::WorkerPool> &_pool,
+      std::size_t &_poolThreads, std::size_t _numThreads, std::size_t _count,
+      const std::function<void(std::size_t)> &_task) const
+  {
+    if (this->taskScheduler)
+    {
+      this->taskScheduler->Run(_count, _task);
+      return;
+    }
+
+    if (!_pool || _poolThreads != _numThreads)
+    {
+      _pool = std::make_unique<gz::common::WorkerPool>(
+          static_cast<unsigned int>(_numThreads));
+      _poolThreads = _numThreads;
+    }
+
+    for (std::size_t i = 0; i < _count; ++i)
+      _pool->AddWork([&_task, i]() { _task(i); });
+    _pool->WaitForResults();
+  }
+
   /// \brief A debug function to list the models and their immediate
   /// nested models, links and joints.
   /// \return A string containing the list of model information.
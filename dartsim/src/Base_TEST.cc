@@ -17,6 +17,12 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <gz/physics/Implements.hh>
 
 #include <gz/physics/sdf/ConstructCollision.hh>
@@ -29,12 +35,16 @@
 #include <sdf/Root.hh>
 #include <sdf/Model.hh>
 
+#include "dart/collision/CollisionGroup.hpp"
+#include "dart/collision/fcl/FCLCollisionDetector.hpp"
 #include "dart/dynamics/BoxShape.hpp"
 #include "dart/dynamics/FreeJoint.hpp"
+#include "dart/dynamics/RevoluteJoint.hpp"
 #include "dart/dynamics/Skeleton.hpp"
 #include "dart/simulation/World.hpp"
 
 #include "Base.hh"
+#include "BitmaskContactFilter.hh"
 #include "EntityManagementFeatures.hh"
 #include "SDFFeatures.hh"
 
@@ -82,12 +92,11 @@ TEST(BaseClass, RemoveModel)
     EXPECT_EQ(pair.second->getName(), linkInfo->name);
     EXPECT_EQ(pair.second, linkInfo->link);
 
-    auto modelID = base.models.IdentityOf(modelInfo->model);
-    const std::string fullJointName = ::sdf::JoinName(
-        world->getName(),
-        ::sdf::JoinName(modelInfo->model->getName(), pair.first->getName()));
+    EXPECT_EQ(0u, modelInfo->linkNameToIndex.at(linkInfo->name));
 
-    base.AddJoint(pair.first, fullJointName, modelID);
+    auto modelID = base.models.IdentityOf(modelInfo->model);
+    base.AddJoint(pair.first, pair.first->getName(), modelID);
+    EXPECT_EQ(0u, modelInfo->jointNameToIndex.at(pair.first->getName()));
     base.AddShape({sn, name + "_shape"});
 
     modelIDs[name] = std::get<0>(res);
@@ -106,7 +115,7 @@ TEST(BaseClass, RemoveModel)
   EXPECT_EQ(5u, base.shapes.size());
 
   std::size_t testModelID = modelIDs["skel2"];
-  EXPECT_EQ(2u, base.models.idToIndexInContainer[testModelID]);
+  EXPECT_EQ(2u, base.models.IndexInContainerOf(testModelID));
 
   // Remove skel2
   base.RemoveModelImpl(worldID, testModelID);
@@ -124,7 +133,7 @@ TEST(BaseClass, RemoveModel)
   {
     for (const auto &[name, modelID] : modelIDs)
     {
-      auto modelIndex = base.models.idToIndexInContainer[modelID];
+      auto modelIndex = base.models.IndexInContainerOf(modelID);
       EXPECT_EQ(name, world->getSkeleton(modelIndex)->getName());
     }
   };
@@ -159,6 +168,105 @@ TEST(BaseClass, RemoveModel)
 }
 
 
+TEST(BaseClass, EntityStorageIsDense)
+{
+  dartsim::EntityStorage<std::shared_ptr<int>, const int *> storage;
+  std::vector<std::shared_ptr<int>> values;
+  for (int i = 0; i < 4; ++i)
+  {
+    values.push_back(std::make_shared<int>(i));
+    // Sparse IDs, as entity IDs are shared between all entity types
+    storage.AddEntity(10u * i + 1u, values.back(), values.back().get(), 0u);
+  }
+
+  ASSERT_EQ(4u, storage.size());
+  ASSERT_EQ(4u, storage.Ids().size());
+  ASSERT_EQ(4u, storage.Objects().size());
+  EXPECT_FALSE(storage.HasEntity(std::size_t(2u)));
+  EXPECT_EQ(nullptr, storage.Find(1000u));
+  EXPECT_EQ(values[2], storage.at(std::size_t(21u)));
+  EXPECT_EQ(2u, storage.IndexInContainerOf(21u));
+
+  // Removing an entity keeps the arrays packed and the lookups valid.
+  EXPECT_TRUE(storage.RemoveEntity(values[1].get()));
+  EXPECT_FALSE(storage.RemoveEntity(values[1].get()));
+  ASSERT_EQ(3u, storage.size());
+  EXPECT_FALSE(storage.HasEntity(std::size_t(11u)));
+  EXPECT_FALSE(storage.HasContainer(11u));
+  for (std::size_t i = 0; i < storage.size(); ++i)
+  {
+    EXPECT_EQ(storage.Objects()[i], storage.at(storage.Ids()[i]));
+  }
+  EXPECT_EQ(0u, storage.IndexInContainerOf(1u));
+  EXPECT_EQ(1u, storage.IndexInContainerOf(21u));
+  EXPECT_EQ(2u, storage.IndexInContainerOf(31u));
+  EXPECT_EQ(0u, storage.ContainerIDOf(31u));
+}
+
+TEST(BaseClass, EntityStorageRemoveEntities)
+{
+  dartsim::EntityStorage<std::shared_ptr<int>, const int *> storage;
+  std::vector<std::shared_ptr<int>> values;
+  for (int i = 0; i < 8; ++i)
+  {
+    values.push_back(std::make_shared<int>(i));
+    // Even values in container 0, odd values in container 1
+    storage.AddEntity(10u * i + 1u, values.back(), values.back().get(),
+                      static_cast<std::size_t>(i % 2));
+  }
+
+  // Unknown and repeated keys are skipped
+  const int unknown = 0;
+  EXPECT_EQ(4u, storage.RemoveEntities(
+      {values[0].get(), values[3].get(), &unknown, values[4].get(),
+       values[7].get(), values[3].get()}));
+  ASSERT_EQ(4u, storage.size());
+  for (std::size_t i = 0; i < storage.size(); ++i)
+  {
+    EXPECT_EQ(storage.Objects()[i], storage.at(storage.Ids()[i]));
+  }
+
+  // The remaining entities keep their order within their containers
+  const std::vector<std::size_t> even{21u, 61u};
+  const std::vector<std::size_t> odd{11u, 51u};
+  EXPECT_EQ(even, storage.indexInContainerToID[0u]);
+  EXPECT_EQ(odd, storage.indexInContainerToID[1u]);
+  for (std::size_t i = 0; i < 2u; ++i)
+  {
+    EXPECT_EQ(i, storage.IndexInContainerOf(even[i]));
+    EXPECT_EQ(i, storage.IndexInContainerOf(odd[i]));
+  }
+  EXPECT_FALSE(storage.HasEntity(std::size_t(1u)));
+  EXPECT_FALSE(storage.HasContainer(31u));
+}
+
+TEST(BaseClass, EntityStorageWithoutKey)
+{
+  dartsim::EntityStorage<std::shared_ptr<int>, const int *> storage;
+  auto keyed = std::make_shared<int>(1);
+  auto shared = std::make_shared<int>(2);
+  storage.AddEntity(1u, keyed, keyed.get(), 0u);
+  storage.AddEntityWithoutKey(2u, shared, 0u);
+  storage.AddEntityWithoutKey(3u, keyed, 0u);
+
+  EXPECT_EQ(3u, storage.size());
+  EXPECT_EQ(1u, storage.IdentityOf(keyed.get()));
+  EXPECT_FALSE(storage.HasEntity(shared.get()));
+  EXPECT_EQ(shared, storage.at(2u));
+  EXPECT_EQ(2u, storage.IndexInContainerOf(3u));
+
+  // Unknown and repeated IDs are skipped
+  EXPECT_EQ(1u, storage.RemoveEntitiesByID({2u, 7u, 2u}));
+  EXPECT_FALSE(storage.HasEntity(std::size_t(2u)));
+  EXPECT_EQ(1u, storage.IndexInContainerOf(3u));
+
+  // Removing by key leaves the entities without a key
+  EXPECT_EQ(1u, storage.RemoveEntities({keyed.get()}));
+  EXPECT_FALSE(storage.HasEntity(keyed.get()));
+  EXPECT_TRUE(storage.HasEntity(std::size_t(3u)));
+  EXPECT_EQ(0u, storage.IndexInContainerOf(3u));
+}
+
 TEST(BaseClass, SdfConstructionBookkeeping)
 {
   dartsim::SDFFeatures sdfFeatures;
@@ -192,15 +300,108 @@ TEST(BaseClass, SdfConstructionBookkeeping)
   {
     auto jointID = sdfFeatures.GetJoint(modelID, i);
     ASSERT_TRUE(jointID);
-    ASSERT_EQ(1u, sdfFeatures.joints.idToIndexInContainer.count(jointID));
-    EXPECT_EQ(sdfFeatures.joints.idToIndexInContainer[jointID], i);
-    EXPECT_EQ(sdfFeatures.joints.idToContainerID[jointID], modelID.id);
+    ASSERT_TRUE(sdfFeatures.joints.HasContainer(jointID));
+    EXPECT_EQ(sdfFeatures.joints.IndexInContainerOf(jointID), i);
+    EXPECT_EQ(sdfFeatures.joints.ContainerIDOf(jointID), modelID.id);
 
     ASSERT_GE(sdfFeatures.joints.indexInContainerToID[modelID].size(), i);
     EXPECT_EQ(sdfFeatures.joints.indexInContainerToID[modelID][i], jointID.id);
   }
 }
 
+TEST(BaseClass, MergeFixedJoints)
+{
+  const std::string sdfStr = R"(
+  <sdf version="1.11">
+    <model name="robot">
+      <link name="base">
+        <inertial><mass>2</mass></inertial>
+        <collision name="collision">
+          <geometry><box><size>1 1 1</size></box></geometry>
+        </collision>
+      </link>
+      <link name="mount">
+        <pose>0 0 1 0 0 0</pose>
+        <inertial><mass>1</mass></inertial>
+        <collision name="collision">
+          <geometry><box><size>0.1 0.1 0.1</size></box></geometry>
+        </collision>
+      </link>
+      <link name="sensor">
+        <pose>0 0 1.5 0 0 0</pose>
+        <inertial><mass>1</mass></inertial>
+      </link>
+      <link name="arm">
+        <pose>1 0 0 0 0 0</pose>
+      </link>
+      <joint name="mount_joint" type="fixed">
+        <parent>base</parent>
+        <child>mount</child>
+      </joint>
+      <joint name="sensor_joint" type="fixed">
+        <parent>mount</parent>
+        <child>sensor</child>
+      </joint>
+      <joint name="arm_joint" type="revolute">
+        <parent>base</parent>
+        <child>arm</child>
+        <axis><xyz>0 0 1</xyz></axis>
+      </joint>
+    </model>
+  </sdf>)";
+
+  ::sdf::Root root;
+  ASSERT_TRUE(root.LoadSdfString(sdfStr).empty());
+  const ::sdf::Model *sdfModel = root.Model();
+  ASSERT_NE(nullptr, sdfModel);
+
+  dartsim::SDFFeatures sdfFeatures;
+  auto engineId = sdfFeatures.InitiateEngine(0);
+  auto worldID = sdfFeatures.ConstructEmptyWorld(engineId, "default");
+  EXPECT_FALSE(sdfFeatures.GetEngineMergeFixedJoints(engineId));
+  sdfFeatures.SetEngineMergeFixedJoints(engineId, true);
+  EXPECT_TRUE(sdfFeatures.GetEngineMergeFixedJoints(engineId));
+
+  auto modelID = sdfFeatures.ConstructSdfModel(worldID, *sdfModel);
+  const auto &skel = sdfFeatures.models.at(modelID)->model;
+
+  // mount and sensor are merged into base, arm stays articulated
+  EXPECT_EQ(2u, skel->getNumBodyNodes());
+  EXPECT_EQ(1u, sdfFeatures.GetJointCount(modelID));
+  EXPECT_EQ(4u, sdfFeatures.GetLinkCount(modelID));
+  EXPECT_EQ(4u, sdfFeatures.links.size());
+  EXPECT_EQ(2u, sdfFeatures.shapes.size());
+
+  auto *base = skel->getBodyNode("base");
+  ASSERT_NE(nullptr, base);
+  EXPECT_DOUBLE_EQ(4.0, base->getMass());
+  EXPECT_TRUE(base->getLocalCOM().isApprox(Eigen::Vector3d(0, 0, 0.625)));
+
+  for (const std::string name : {"mount", "sensor"})
+  {
+    auto linkID = sdfFeatures.GetLink(modelID, name);
+    ASSERT_TRUE(linkID) << name;
+    EXPECT_EQ(modelID.id, sdfFeatures.GetModelOfLink(linkID).id);
+    const auto *linkInfo = sdfFeatures.links.at(linkID).get();
+    EXPECT_EQ(base, linkInfo->link.get());
+    EXPECT_NE(nullptr, linkInfo->mergedFrame);
+    EXPECT_EQ(linkInfo->Frame(), sdfFeatures.frames.at(linkID));
+  }
+
+  const auto sensorID = sdfFeatures.GetLink(modelID, "sensor");
+  EXPECT_TRUE(sdfFeatures.links.at(sensorID)->Frame()->getWorldTransform()
+      .translation().isApprox(Eigen::Vector3d(0, 0, 1.5)));
+
+  // The collision of mount is attached to base at the pose of mount
+  EXPECT_EQ(2u, base->getNumShapeNodes());
+  EXPECT_TRUE(base->getShapeNode(1)->getRelativeTransform().translation()
+      .isApprox(Eigen::Vector3d(0, 0, 1)));
+
+  // Merged links are removed with their model
+  EXPECT_TRUE(sdfFeatures.RemoveModel(modelID));
+  EXPECT_EQ(0u, sdfFeatures.links.size());
+}
+
 TEST(BaseClass, AddNestedModel)
 {
   dartsim::Base base;
@@ -237,3 +438,104 @@ TEST(BaseClass, AddNestedModel)
   ASSERT_EQ(2u, parentModelInfo.nestedModels.size());
   EXPECT_EQ(nestedModel2ID, parentModelInfo.nestedModels[1]);
 }
+
+/////////////////////////////////////////////////
+/// \brief Get the names of the pairs of bodies in contact in a world.
+static std::set<std::pair<std::string, std::string>> BodyPairsInContact(
+    const dart::simulation::WorldPtr &_world,
+    const std::shared_ptr<dartsim::BitmaskContactFilter> &_filter)
+{
+  auto detector = dart::collision::FCLCollisionDetector::create();
+  auto group = detector->createCollisionGroup();
+  for (std::size_t i = 0; i < _world->getNumSkeletons(); ++i)
+    group->addShapeFramesOf(_world->getSkeleton(i).get());
+
+  dart::collision::CollisionOption option(true, 1000u, _filter);
+  dart::collision::CollisionResult result;
+  group->collide(option, &result);
+
+  std::set<std::pair<std::string, std::string>> pairs;
+  for (const auto &contact : result.getContacts())
+  {
+    const std::string name1 = contact.collisionObject1->getShapeFrame()
+        ->asShapeNode()->getBodyNodePtr()->getName();
+    const std::string name2 = contact.collisionObject2->getShapeFrame()
+        ->asShapeNode()->getBodyNodePtr()->getName();
+    pairs.insert(std::minmax(name1, name2));
+  }
+  return pairs;
+}
+
+/////////////////////////////////////////////////
+TEST(BitmaskContactFilter, IgnoredPairTables)
+{
+  auto world = dart::simulation::World::create("default");
+  auto boxShape = std::make_shared<dart::dynamics::BoxShape>(
+      Eigen::Vector3d::Constant(1.0));
+
+  // A chain of three overlapping boxes, and a box of another skeleton that
+  // overlaps all of them
+  auto chain = dart::dynamics::Skeleton::create("chain");
+  std::vector<dart::dynamics::BodyNode *> bodies;
+  for (std::size_t i = 0; i < 3u; ++i)
+  {
+    dart::dynamics::BodyNode *body = bodies.empty() ?
+        chain->createJointAndBodyNodePair<dart::dynamics::FreeJoint>().second :
+        chain->createJointAndBodyNodePair<dart::dynamics::RevoluteJoint>(
+            bodies.back()).second;
+    body->setName("body" + std::to_string(i));
+    body->createShapeNodeWith<dart::dynamics::CollisionAspect>(boxShape);
+    bodies.push_back(body);
+  }
+  chain->setSelfCollisionCheck(true);
+  chain->setAdjacentBodyCheck(false);
+  world->addSkeleton(chain);
+
+  auto other = dart::dynamics::Skeleton::create("other");
+  auto *otherBody =
+      other->createJointAndBodyNodePair<dart::dynamics::FreeJoint>().second;
+  otherBody->setName("other");
+  otherBody->createShapeNodeWith<dart::dynamics::CollisionAspect>(boxShape);
+  world->addSkeleton(other);
+
+  using Pairs = std::set<std::pair<std::string, std::string>>;
+  auto filter = std::make_shared<dartsim::BitmaskContactFilter>();
+
+  // The tables give the same pairs as the checks of the skeletons
+  const Pairs expected{{"body0", "body2"}, {"body0", "other"},
+      {"body1", "other"}, {"body2", "other"}};
+  EXPECT_EQ(expected, BodyPairsInContact(world, filter));
+  filter->UpdateIgnoredPairs(*world);
+  EXPECT_EQ(expected, BodyPairsInContact(world, filter));
+
+  // Black listed pairs, in and across skeletons
+  filter->addBodyNodePairToBlackList(bodies[2], bodies[0]);
+  filter->addBodyNodePairToBlackList(bodies[1], otherBody);
+  filter->UpdateIgnoredPairs(*world);
+  EXPECT_EQ(Pairs({{"body0", "other"}, {"body2", "other"}}),
+            BodyPairsInContact(world, filter));
+  filter->removeAllBodyNodePairsFromBlackList();
+
+  // Adjacent bodies
+  chain->setAdjacentBodyCheck(true);
+  filter->UpdateIgnoredPairs(*world);
+  EXPECT_EQ(Pairs({{"body0", "body1"}, {"body0", "body2"},
+                   {"body0", "other"}, {"body1", "body2"},
+                   {"body1", "other"}, {"body2", "other"}}),
+            BodyPairsInContact(world, filter));
+
+  // Self collision and collidable bodies
+  chain->setSelfCollisionCheck(false);
+  bodies[1]->setCollidable(false);
+  filter->UpdateIgnoredPairs(*world);
+  EXPECT_EQ(Pairs({{"body0", "other"}, {"body2", "other"}}),
+            BodyPairsInContact(world, filter));
+
+  // Removed skeletons fall back to the checks of the skeletons until the
+  // next update
+  filter->RemoveSkeletonCollisions(other);
+  world->removeSkeleton(other);
+  EXPECT_TRUE(BodyPairsInContact(world, filter).empty());
+  filter->UpdateIgnoredPairs(*world);
+  EXPECT_TRUE(BodyPairsInContact(world, filter).empty());
+}
@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DARTSIM_SRC_BITMASKCONTACTFILTER_HH_
+#define GZ_PHYSICS_DARTSIM_SRC_BITMASKCONTACTFILTER_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <dart/collision/CollisionFilter.hpp>
+#include <dart/collision/CollisionObject.hpp>
+#include <dart/dynamics/BodyNode.hpp>
+#include <dart/dynamics/ShapeNode.hpp>
+#include <dart/dynamics/Skeleton.hpp>
+#include <dart/simulation/World.hpp>
+
+namespace gz {
+namespace physics {
+namespace dartsim {
+
+/////////////////////////////////////////////////
+/// This class filters collision based on a bitmask:
+/// Each objects has a bitmask. If the bitwise-and of two objects' bitmasks
+/// evaluates to 0, then collisions between them are ignored.
+///
+/// Collision detectors that can test the masks in their broadphase, such as
+/// GzOdeCollisionDetector, read them through FindMask and only call
+/// IgnoresCollisionWithoutMasks for the pairs that remain.
+///
+/// The checks of BodyNodeCollisionFilter walk the skeletons of each pair.
+/// After UpdateIgnoredPairs they are instead read from a table of the
+/// ignored body pairs of each skeleton, built again only when the structure
+/// of the world changed. Pairs of shapes that are not in the table fall back
+/// to BodyNodeCollisionFilter.
+class BitmaskContactFilter : public dart::collision::BodyNodeCollisionFilter
+{
+  public: using DartCollisionConstPtr = const dart::collision::CollisionObject*;
+  public: using DartShapeConstPtr = const dart::dynamics::ShapeNode*;
+  public: using DartBodyConstPtr = const dart::dynamics::BodyNode*;
+
+  private: std::unordered_map<DartShapeConstPtr, uint16_t> bitmaskMap;
+
+  /// \brief Incremented whenever a mask is set or removed.
+  private: std::size_t version = 0u;
+
+  /// \brief Where the body of a shape is in the tables of ignored pairs.
+  private: struct ShapeEntry
+  {
+    /// \brief Body of the shape.
+    DartBodyConstPtr body;
+
+    /// \brief Index of the skeleton of the body in skeletonTables.
+    std::size_t skeleton;
+
+    /// \brief Index of the body in its skeleton.
+    std::size_t index;
+
+    /// \brief Whether the body is collidable.
+    bool collidable;
+  };
+
+  /// \brief Ignored body pairs of a skeleton.
+  private: struct SkeletonTable
+  {
+    /// \brief Number of bodies of the skeleton.
+    std::size_t numBodies;
+
+    /// \brief Bit of the pair of the bodies 0 and 0 in ignoredPairs. The
+    /// pair of the bodies i and j has the bit offset + i * numBodies + j.
+    std::size_t offset;
+  };
+
+  /// \brief Entries of the shapes of the world, see UpdateIgnoredPairs.
+  private: std::unordered_map<DartShapeConstPtr, ShapeEntry> shapeEntries;
+
+  /// \brief Tables of the skeletons of the world.
+  private: std::vector<SkeletonTable> skeletonTables;
+
+  /// \brief Bits of the ignored body pairs of all the skeletons.
+  private: std::vector<bool> ignoredPairs;
+
+  /// \brief Structure of the world that the tables were built for.
+  private: std::vector<std::uintptr_t> structure;
+
+  /// \brief Structure of the world at the last update, reused from update
+  /// to update.
+  private: std::vector<std::uintptr_t> newStructure;
+
+  /// \brief Body pairs added to the black list through this class, with
+  /// the lower address first. Pairs added through BodyNodeCollisionFilter
+  /// itself are not in the tables.
+  private: std::set<std::pair<DartBodyConstPtr, DartBodyConstPtr>> blackList;
+
+  /// \brief Incremented whenever the black list changes.
+  private: std::size_t blackListVersion = 0u;
+
+  public: bool ignoresCollision(
+      DartCollisionConstPtr _object1,
+      DartCollisionConstPtr _object2) const override
+  {
+    if (this->IgnoresCollisionWithoutMasks(_object1, _object2))
+      return true;
+
+    if (bitmaskMap.empty())
+      return false;
+
+    auto shapeNode1 = _object1->getShapeFrame()->asShapeNode();
+    auto shapeNode2 = _object2->getShapeFrame()->asShapeNode();
+    auto shape1Iter = bitmaskMap.find(shapeNode1);
+    if (shape1Iter == bitmaskMap.end())
+      return false;
+    auto shape2Iter = bitmaskMap.find(shapeNode2);
+    if (shape2Iter != bitmaskMap.end() &&
+        ((shape1Iter->second & shape2Iter->second) == 0))
+      return true;
+
+    return false;
+  }
+
+  /// \brief Apply only the checks of BodyNodeCollisionFilter, for pairs
+  /// whose masks were already tested.
+  /// \param[in] _object1 First object of the pair.
+  /// \param[in] _object2 Second object of the pair.
+  /// \return True if the pair is ignored.
+  public: bool IgnoresCollisionWithoutMasks(
+      DartCollisionConstPtr _object1,
+      DartCollisionConstPtr _object2) const
+  {
+    if (_object1 == _object2)
+      return true;
+
+    if (!this->shapeEntries.empty())
+    {
+      const auto entry1 = this->shapeEntries.find(
+          _object1->getShapeFrame()->asShapeNode());
+      const auto entry2 = this->shapeEntries.find(
+          _object2->getShapeFrame()->asShapeNode());
+      if (entry1 != this->shapeEntries.end() &&
+          entry2 != this->shapeEntries.end())
+      {
+        return this->IgnoresBodies(entry1->second, entry2->second);
+      }
+    }
+
+    return dart::collision::BodyNodeCollisionFilter::ignoresCollision(
+        _object1, _object2);
+  }
+
+  /// \brief Build the tables of ignored body pairs again if the skeletons,
+  /// bodies or shapes of a world, or their collision settings, changed
+  /// since the last update. Call this before each collision detection of
+  /// the world.
+  /// \param[in] _world World whose collisions are filtered.
+  public: void UpdateIgnoredPairs(const dart::simulation::World &_world)
+  {
+    auto &current = this->newStructure;
+    current.clear();
+    current.push_back(this->blackListVersion);
+    for (std::size_t k = 0; k < _world.getNumSkeletons(); ++k)
+    {
+      const dart::dynamics::Skeleton *skeleton = _world.getSkeleton(k).get();
+      current.push_back(reinterpret_cast<std::uintptr_t>(skeleton));
+      current.push_back(
+          (skeleton->isEnabledSelfCollisionCheck() ? 1u : 0u) |
+          (skeleton->isEnabledAdjacentBodyCheck() ? 2u : 0u));
+      current.push_back(skeleton->getNumBodyNodes());
+      for (std::size_t b = 0; b < skeleton->getNumBodyNodes(); ++b)
+      {
+        const auto *body = skeleton->getBodyNode(b);
+        current.push_back(reinterpret_cast<std::uintptr_t>(body));
+        current.push_back(
+            reinterpret_cast<std::uintptr_t>(body->getParentBodyNode()));
+        current.push_back(body->isCollidable() ? 1u : 0u);
+        current.push_back(body->getNumShapeNodes());
+        for (std::size_t s = 0; s < body->getNumShapeNodes(); ++s)
+        {
+          current.push_back(
+              reinterpret_cast<std::uintptr_t>(body->getShapeNode(s)));
+        }
+      }
+    }
+
+    if (current == this->structure)
+      return;
+    std::swap(this->structure, current);
+
+    this->shapeEntries.clear();
+    this->skeletonTables.clear();
+    this->ignoredPairs.clear();
+    for (std::size_t k = 0; k < _world.getNumSkeletons(); ++k)
+    {
+      const dart::dynamics::Skeleton *skeleton = _world.getSkeleton(k).get();
+      const std::size_t numBodies = skeleton->getNumBodyNodes();
+      const std::size_t offset = this->ignoredPairs.size();
+      this->skeletonTables.push_back(SkeletonTable{numBodies, offset});
+      this->ignoredPairs.resize(offset + numBodies * numBodies, false);
+
+      const bool selfCollide = skeleton->isEnabledSelfCollisionCheck();
+      const bool adjacentCollide = skeleton->isEnabledAdjacentBodyCheck();
+      for (std::size_t i = 0; i < numBodies; ++i)
+      {
+        const auto *body1 = skeleton->getBodyNode(i);
+        for (std::size_t s = 0; s < body1->getNumShapeNodes(); ++s)
+        {
+          this->shapeEntries[body1->getShapeNode(s)] =
+              ShapeEntry{body1, k, i, body1->isCollidable()};
+        }
+
+        for (std::size_t j = i + 1; j < numBodies; ++j)
+        {
+          const auto *body2 = skeleton->getBodyNode(j);
+          const bool ignored = !selfCollide ||
+              (!adjacentCollide &&
+               (body1->getParentBodyNode() == body2 ||
+                body2->getParentBodyNode() == body1)) ||
+              this->IsBlackListed(body1, body2);
+          this->ignoredPairs[offset + i * numBodies + j] = ignored;
+          this->ignoredPairs[offset + j * numBodies + i] = ignored;
+        }
+      }
+    }
+  }
+
+  /// \brief Add a pair of bodies to the black list, see
+  /// BodyNodeCollisionFilter.
+  /// \param[in] _body1 First body.
+  /// \param[in] _body2 Second body.
+  public: void addBodyNodePairToBlackList(
+      const dart::dynamics::BodyNode *_body1,
+      const dart::dynamics::BodyNode *_body2)
+  {
+    dart::collision::BodyNodeCollisionFilter::addBodyNodePairToBlackList(
+        _body1, _body2);
+    this->blackList.insert(std::minmax(_body1, _body2));
+    ++this->blackListVersion;
+  }
+
+  /// \brief Remove a pair of bodies from the black list, see
+  /// BodyNodeCollisionFilter.
+  /// \param[in] _body1 First body.
+  /// \param[in] _body2 Second body.
+  public: void removeBodyNodePairFromBlackList(
+      const dart::dynamics::BodyNode *_body1,
+      const dart::dynamics::BodyNode *_body2)
+  {
+    dart::collision::BodyNodeCollisionFilter::removeBodyNodePairFromBlackList(
+        _body1, _body2);
+    this->blackList.erase(std::minmax(_body1, _body2));
+    ++this->blackListVersion;
+  }
+
+  /// \brief Remove all pairs of bodies from the black list, see
+  /// BodyNodeCollisionFilter.
+  public: void removeAllBodyNodePairsFromBlackList()
+  {
+    dart::collision::BodyNodeCollisionFilter::
+        removeAllBodyNodePairsFromBlackList();
+    this->blackList.clear();
+    ++this->blackListVersion;
+  }
+
+  /// \brief Apply the checks of BodyNodeCollisionFilter to the bodies of two
+  /// shapes from the tables.
+  /// \param[in] _entry1 Entry of the first shape.
+  /// \param[in] _entry2 Entry of the second shape.
+  /// \return True if the pair is ignored.
+  private: bool IgnoresBodies(
+      const ShapeEntry &_entry1, const ShapeEntry &_entry2) const
+  {
+    if (_entry1.body == _entry2.body)
+      return true;
+    if (!_entry1.collidable || !_entry2.collidable)
+      return true;
+    if (_entry1.skeleton == _entry2.skeleton)
+    {
+      const SkeletonTable &table = this->skeletonTables[_entry1.skeleton];
+      return this->ignoredPairs[
+          table.offset + _entry1.index * table.numBodies + _entry2.index];
+    }
+    return this->IsBlackListed(_entry1.body, _entry2.body);
+  }
+
+  /// \brief Check whether a pair of bodies was added to the black list.
+  /// \param[in] _body1 First body.
+  /// \param[in] _body2 Second body.
+  /// \return True if the pair is black listed.
+  private: bool IsBlackListed(
+      DartBodyConstPtr _body1, DartBodyConstPtr _body2) const
+  {
+    return !this->blackList.empty() &&
+        this->blackList.count(std::minmax(_body1, _body2)) > 0u;
+  }
+
+  /// \brief Find the mask of a shape.
+  /// \param[in] _shapePtr Shape to find.
+  /// \param[out] _mask Mask of the shape, if it has one.
+  /// \return True if the shape has a mask.
+  public: bool FindMask(DartShapeConstPtr _shapePtr, uint16_t &_mask) const
+  {
+    auto shapeIter = bitmaskMap.find(_shapePtr);
+    if (shapeIter == bitmaskMap.end())
+      return false;
+    _mask = shapeIter->second;
+    return true;
+  }
+
+  /// \brief Get a number that changes whenever a mask is set or removed.
+  /// \return Version of the masks.
+  public: std::size_t Version() const
+  {
+    return this->version;
+  }
+
+  public: void SetIgnoredCollision(DartShapeConstPtr _shapePtr, uint16_t _mask)
+  {
+    auto result = bitmaskMap.emplace(_shapePtr, _mask);
+    if (!result.second && result.first->second == _mask)
+      return;
+    result.first->second = _mask;
+    ++this->version;
+  }
+
+  public: uint16_t GetIgnoredCollision(DartShapeConstPtr _shapePtr) const
+  {
+    auto shapeIter = bitmaskMap.find(_shapePtr);
+    if (shapeIter != bitmaskMap.end())
+      return shapeIter->second;
+    return 0xff;
+  }
+
+  public: void RemoveIgnoredCollision(DartShapeConstPtr _shapePtr)
+  {
+    auto shapeIter = bitmaskMap.find(_shapePtr);
+    if (shapeIter != bitmaskMap.end())
+    {
+      bitmaskMap.erase(shapeIter);
+      ++this->version;
+    }
+  }
+
+  public: void CopyIgnoredCollision(const BitmaskContactFilter &_other,
+      DartShapeConstPtr _from, DartShapeConstPtr _to)
+  {
+    auto shapeIter = _other.bitmaskMap.find(_from);
+    if (shapeIter != _other.bitmaskMap.end())
+      this->SetIgnoredCollision(_to, shapeIter->second);
+  }
+
+  public: void RemoveSkeletonCollisions(dart::dynamics::SkeletonPtr _skelPtr)
+  {
+    // The shapes of the skeleton are about to be freed, so the tables are
+    // not used again until the next update
+    this->shapeEntries.clear();
+    this->structure.clear();
+
+    for (std::size_t i = 0; i < _skelPtr->getNumShapeNodes(); ++i)
+    {
+      auto shapePtr = _skelPtr->getShapeNode(i);
+      this->RemoveIgnoredCollision(shapePtr);
+    }
+  }
+
+  public: virtual ~BitmaskContactFilter() = default;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "CollisionCheckFeatures.hh"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include <ode/ode.h>
+
+#include <dart/collision/CollisionResult.hpp>
+#include <dart/collision/DistanceOption.hpp>
+#include <dart/collision/DistanceResult.hpp>
+#include <dart/collision/fcl/FCLCollisionDetector.hpp>
+#include <dart/collision/ode/OdeCollisionDetector.hpp>
+#include <dart/constraint/ConstraintSolver.hpp>
+#include <dart/dynamics/BodyNode.hpp>
+#include <dart/dynamics/ShapeNode.hpp>
+#include <dart/dynamics/Skeleton.hpp>
+
+#include "BitmaskContactFilter.hh"
+#include "GzOdeCollisionDetector.hh"
+
+namespace gz::physics::dartsim
+{
+
+namespace
+{
+/////////////////////////////////////////////////
+/// \brief Create a detector of the same kind as that of a world, which
+/// shares no collision objects with it. The checks only need to know
+/// whether there is a contact, so the threaded ODE detector is not used.
+std::shared_ptr<dart::collision::CollisionDetector> PrivateDetector(
+    const dart::collision::CollisionDetector &_worldDetector)
+{
+  if (dynamic_cast<const GzOdeCollisionDetector *>(&_worldDetector))
+    return GzOdeCollisionDetector::create();
+  return _worldDetector.cloneWithoutCollisionObjects();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the skeletons of a world other than the checked one.
+std::vector<const dart::dynamics::Skeleton *> OtherSkeletons(
+    const DartWorld &_world, const dart::dynamics::Skeleton *_skeleton)
+{
+  std::vector<const dart::dynamics::Skeleton *> others;
+  for (std::size_t i = 0; i < _world.getNumSkeletons(); ++i)
+  {
+    const dart::dynamics::Skeleton *other = _world.getSkeleton(i).get();
+    if (other != _skeleton)
+      others.push_back(other);
+  }
+  return others;
+}
+
+/////////////////////////////////////////////////
+/// \brief Build a checker for a skeleton of a model, or for a clone of it.
+/// \param[in] _world World of the model
+/// \param[in] _model Skeleton of the model
+/// \param[in] _clone True to check a clone of the skeleton instead
+/// \param[in] _computeDistance True to build the distance groups as well
+std::unique_ptr<ConfigurationChecker> MakeChecker(
+    DartWorld &_world, const dart::dynamics::SkeletonPtr &_model,
+    bool _clone, bool _computeDistance)
+{
+  auto checker = std::make_unique<ConfigurationChecker>();
+  const auto &solver = _world.getConstraintSolver();
+  const auto worldFilter = std::static_pointer_cast<BitmaskContactFilter>(
+      solver->getCollisionOption().collisionFilter);
+
+  checker->skeleton = _clone ? _model->cloneSkeleton() : _model;
+  checker->others = OtherSkeletons(_world, _model.get());
+  checker->option =
+      dart::collision::CollisionOption(true, 1u, worldFilter);
+
+  if (_clone)
+  {
+    // The masks of the world are kept by shape node, so the clone gets a
+    // filter with the masks of the model copied to its own shape nodes.
+    auto filter = std::make_shared<BitmaskContactFilter>();
+    for (std::size_t b = 0; b < _model->getNumBodyNodes(); ++b)
+    {
+      const auto *modelBody = _model->getBodyNode(b);
+      const auto *cloneBody = checker->skeleton->getBodyNode(b);
+      for (std::size_t s = 0; s < modelBody->getNumShapeNodes(); ++s)
+      {
+        const DartShapeNode *modelNode = modelBody->getShapeNode(s);
+        const DartShapeNode *cloneNode = cloneBody->getShapeNode(s);
+        checker->modelNodes[cloneNode] = modelNode;
+        if (worldFilter)
+          filter->CopyIgnoredCollision(*worldFilter, modelNode, cloneNode);
+      }
+    }
+    if (worldFilter)
+    {
+      for (const auto *other : checker->others)
+      {
+        for (std::size_t b = 0; b < other->getNumBodyNodes(); ++b)
+        {
+          const auto *body = other->getBodyNode(b);
+          for (std::size_t s = 0; s < body->getNumShapeNodes(); ++s)
+          {
+            const DartShapeNode *node = body->getShapeNode(s);
+            filter->CopyIgnoredCollision(*worldFilter, node, node);
+          }
+        }
+      }
+    }
+    checker->option.collisionFilter = filter;
+  }
+
+  checker->detector = PrivateDetector(*solver->getCollisionDetector());
+  checker->modelGroup = checker->detector->createCollisionGroup();
+  checker->otherGroup = checker->detector->createCollisionGroup();
+  checker->modelGroup->subscribeTo(checker->skeleton);
+  for (std::size_t i = 0; i < _world.getNumSkeletons(); ++i)
+  {
+    if (_world.getSkeleton(i) != _model)
+      checker->otherGroup->subscribeTo(_world.getSkeleton(i));
+  }
+
+  // Build the collision objects here, since the groups are not safe to
+  // update from the threads of CheckModelConfigurations.
+  checker->modelGroup->update();
+  checker->otherGroup->update();
+
+  if (_computeDistance)
+  {
+    // ODE does not compute distances
+    checker->distanceDetector =
+        dart::collision::FCLCollisionDetector::create();
+    checker->modelDistanceGroup =
+        checker->distanceDetector->createCollisionGroup();
+    checker->otherDistanceGroup =
+        checker->distanceDetector->createCollisionGroup();
+    checker->modelDistanceGroup->subscribeTo(checker->skeleton);
+    for (std::size_t i = 0; i < _world.getNumSkeletons(); ++i)
+    {
+      if (_world.getSkeleton(i) != _model)
+        checker->otherDistanceGroup->subscribeTo(_world.getSkeleton(i));
+    }
+    checker->modelDistanceGroup->update();
+    checker->otherDistanceGroup->update();
+  }
+
+  return checker;
+}
+}  // namespace
+
+/////////////////////////////////////////////////
+auto CollisionCheckFeatures::CheckModelConfiguration(
+    const Identity &_modelID,
+    const GeneralizedVector &_positions,
+    bool _computeDistance) const -> CollisionCheck
+{
+  CollisionCheck check;
+  this->CheckModelConfigurations(
+      _modelID, &_positions, 1u, _computeDistance, 1u, &check);
+  return check;
+}
+
+/////////////////////////////////////////////////
+void CollisionCheckFeatures::CheckModelConfigurations(
+    const Identity &_modelID,
+    const GeneralizedVector *_positions,
+    std::size_t _count,
+    bool _computeDistance,
+    std::size_t _numThreads,
+    CollisionCheck *_results) const
+{
+  if (_count == 0u)
+    return;
+
+  if (_numThreads == 0u)
+    _numThreads = std::max(1u, std::thread::hardware_concurrency());
+  _numThreads = std::min(_numThreads, _count);
+
+  const auto *modelInfo = this->ReferenceInterface<ModelInfo>(_modelID);
+  const dart::dynamics::SkeletonPtr &skeleton = modelInfo->model;
+
+  if (_numThreads <= 1u)
+  {
+    ConfigurationChecker &checker =
+        this->ModelChecker(_modelID, _computeDistance);
+    const Eigen::VectorXd positions = skeleton->getPositions();
+    for (std::size_t i = 0; i < _count; ++i)
+      _results[i] = this->Check(checker, _positions[i], _computeDistance);
+    skeleton->setPositions(positions);
+    return;
+  }
+
+  DartWorld &world = *this->worlds.at(this->GetWorldOfModelImpl(_modelID));
+
+  // The other skeletons stay where they are, so compute their transforms
+  // once here. The threads then only read them.
+  for (const auto *other : OtherSkeletons(world, skeleton.get()))
+  {
+    for (std::size_t b = 0; b < other->getNumBodyNodes(); ++b)
+    {
+      const auto *body = other->getBodyNode(b);
+      for (std::size_t s = 0; s < body->getNumShapeNodes(); ++s)
+        body->getShapeNode(s)->getWorldTransform();
+    }
+  }
+
+  // Each thread moves a clone of the skeleton, with its own detector and
+  // groups, so the skeleton of the model is not touched.
+  std::vector<std::unique_ptr<ConfigurationChecker>> threadCheckers;
+  for (std::size_t t = 0; t < _numThreads; ++t)
+  {
+    threadCheckers.push_back(
+        MakeChecker(world, skeleton, true, _computeDistance));
+  }
+
+  const bool usesOde = nullptr != dynamic_cast<
+      dart::collision::OdeCollisionDetector *>(
+          threadCheckers.front()->detector.get());
+  const std::size_t chunk = (_count + _numThreads - 1u) / _numThreads;
+  const std::size_t numTasks = (_count + chunk - 1u) / chunk;
+  this->RunTasks(this->checkPool, this->checkPoolThreads, _numThreads,
+      numTasks, [&](std::size_t _t)
+  {
+    // ODE needs its per thread collision data before it is used on a
+    // thread, which is a no-op after the first time.
+    if (usesOde)
+      dAllocateODEDataForThread(dAllocateMaskAll);
+
+    ConfigurationChecker &checker = *threadCheckers[_t];
+    const std::size_t begin = _t * chunk;
+    const std::size_t end = std::min(_count, begin + chunk);
+    for (std::size_t i = begin; i < end; ++i)
+      _results[i] = this->Check(checker, _positions[i], _computeDistance);
+  });
+}
+
+/////////////////////////////////////////////////
+ConfigurationChecker &CollisionCheckFeatures::ModelChecker(
+    std::size_t _modelID, bool _computeDistance) const
+{
+  // Drop the checkers of removed models
+  for (auto it = this->checkers.begin(); it != this->checkers.end();)
+  {
+    if (this->models.HasEntity(it->first))
+      ++it;
+    else
+      it = this->checkers.erase(it);
+  }
+
+  const auto *modelInfo = this->ReferenceInterface<ModelInfo>(_modelID);
+  DartWorld &world = *this->worlds.at(this->GetWorldOfModelImpl(_modelID));
+
+  auto &checker = this->checkers[_modelID];
+  if (!checker || checker->skeleton != modelInfo->model
+      || checker->others != OtherSkeletons(world, modelInfo->model.get())
+      || (_computeDistance && !checker->distanceDetector))
+  {
+    checker = MakeChecker(world, modelInfo->model, false, _computeDistance);
+  }
+  return *checker;
+}
+
+/////////////////////////////////////////////////
+auto CollisionCheckFeatures::Check(
+    ConfigurationChecker &_checker,
+    const GeneralizedVector &_positions,
+    bool _computeDistance) const -> CollisionCheck
+{
+  CollisionCheck check;
+  dart::dynamics::Skeleton &skeleton = *_checker.skeleton;
+  if (static_cast<std::size_t>(_positions.size()) != skeleton.getNumDofs())
+    return check;
+
+  check.valid = true;
+  skeleton.setPositions(_positions);
+
+  dart::collision::CollisionResult result;
+  if (!_checker.modelGroup->collide(
+        _checker.otherGroup.get(), _checker.option, &result))
+  {
+    _checker.modelGroup->collide(_checker.option, &result);
+  }
+
+  if (result.isCollision())
+  {
+    const auto &contact = result.getContact(0);
+    const auto *node1 = contact.collisionObject1->getShapeFrame()
+        ->asShapeNode();
+    const auto *node2 = contact.collisionObject2->getShapeFrame()
+        ->asShapeNode();
+    if (node1 && node1->getSkeleton().get() != &skeleton)
+      std::swap(node1, node2);
+
+    check.inCollision = true;
+    check.collision1 = this->FindCheckedShape(_checker, node1);
+    check.collision2 = this->FindCheckedShape(_checker, node2);
+    check.distance = 0.0;
+    return check;
+  }
+
+  if (_computeDistance && _checker.distanceDetector
+      && _checker.modelDistanceGroup->getNumShapeFrames() > 0u
+      && _checker.otherDistanceGroup->getNumShapeFrames() > 0u)
+  {
+    dart::collision::DistanceResult distance;
+    _checker.modelDistanceGroup->distance(
+        _checker.otherDistanceGroup.get(),
+        dart::collision::DistanceOption(false, 0.0, nullptr), &distance);
+    check.distance = distance.minDistance;
+  }
+
+  return check;
+}
+
+/////////////////////////////////////////////////
+std::size_t CollisionCheckFeatures::FindCheckedShape(
+    const ConfigurationChecker &_checker,
+    const DartShapeNode *_node) const
+{
+  if (nullptr == _node)
+    return 0u;
+
+  const auto modelNode = _checker.modelNodes.find(_node);
+  if (modelNode != _checker.modelNodes.end())
+    _node = modelNode->second;
+
+  if (this->shapes.HasEntity(_node))
+    return this->shapes.IdentityOf(_node);
+
+  const auto tile = this->heightmapTiles.find(_node);
+  if (tile != this->heightmapTiles.end())
+    return tile->second;
+
+  return 0u;
+}
+
+}  // namespace gz::physics::dartsim
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DARTSIM_SRC_COLLISIONCHECKFEATURES_HH_
+#define GZ_PHYSICS_DARTSIM_SRC_COLLISIONCHECKFEATURES_HH_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <dart/collision/CollisionDetector.hpp>
+#include <dart/collision/CollisionGroup.hpp>
+#include <dart/collision/CollisionOption.hpp>
+
+#include <gz/common/WorkerPool.hh>
+#include <gz/physics/CollisionCheck.hh>
+
+#include "Base.hh"
+
+namespace gz::physics::dartsim
+{
+
+struct CollisionCheckFeatureList: FeatureList<
+  ModelCollisionCheckFeature
+> { };
+
+/// \brief Collision groups that check the configurations of a skeleton
+/// against the other skeletons of its world. They are owned by a private
+/// collision detector, so that checkers used by different threads share no
+/// collision state.
+struct ConfigurationChecker
+{
+  /// \brief The skeleton whose configurations are checked. Either the
+  /// skeleton of the model or a clone of it.
+  dart::dynamics::SkeletonPtr skeleton;
+
+  /// \brief Shape nodes of the model by the shape nodes of a cloned
+  /// skeleton. Empty if the skeleton is that of the model.
+  std::unordered_map<const DartShapeNode *, const DartShapeNode *>
+      modelNodes;
+
+  /// \brief Other skeletons of the world when the groups were built.
+  std::vector<const dart::dynamics::Skeleton *> others;
+
+  /// \brief Detector of the same kind as that of the world.
+  std::shared_ptr<dart::collision::CollisionDetector> detector;
+
+  /// \brief Shapes of the checked skeleton
+  std::unique_ptr<dart::collision::CollisionGroup> modelGroup;
+
+  /// \brief Shapes of the other skeletons
+  std::unique_ptr<dart::collision::CollisionGroup> otherGroup;
+
+  /// \brief Options of the checks, with the filter of the world or a copy
+  /// of its masks for the shapes of a cloned skeleton.
+  dart::collision::CollisionOption option;
+
+  /// \brief FCL detector for distance queries, which the default ODE
+  /// detector does not support. Null until distances are requested.
+  std::shared_ptr<dart::collision::CollisionDetector> distanceDetector;
+
+  /// \brief Shapes of the checked skeleton for distance queries
+  std::unique_ptr<dart::collision::CollisionGroup> modelDistanceGroup;
+
+  /// \brief Shapes of the other skeletons for distance queries
+  std::unique_ptr<dart::collision::CollisionGroup> otherDistanceGroup;
+};
+
+class CollisionCheckFeatures :
+    public virtual Base,
+    public virtual Implements3d<CollisionCheckFeatureList>
+{
+  public: using CollisionCheck =
+      ModelCollisionCheckFeature::CollisionCheckT<FeaturePolicy3d>;
+  public: using GeneralizedVector = Eigen::VectorXd;
+
+  // Documentation inherited
+  public: CollisionCheck CheckModelConfiguration(
+      const Identity &_modelID,
+      const GeneralizedVector &_positions,
+      bool _computeDistance) const override;
+
+  // Documentation inherited
+  public: void CheckModelConfigurations(
+      const Identity &_modelID,
+      const GeneralizedVector *_positions,
+      std::size_t _count,
+      bool _computeDistance,
+      std::size_t _numThreads,
+      CollisionCheck *_results) const override;
+
+  /// \brief Get the checker of a model on its own skeleton, building it if
+  /// the model has none yet or the skeletons of its world changed.
+  /// \param[in] _modelID Entity ID of the model
+  /// \param[in] _computeDistance True if distances will be computed
+  /// \return The checker
+  private: ConfigurationChecker &ModelChecker(
+      std::size_t _modelID, bool _computeDistance) const;
+
+  /// \brief Check one configuration with a checker. The skeleton of the
+  /// checker is left at the configuration.
+  /// \param[in] _checker Checker to use
+  /// \param[in] _positions One position per coordinate
+  /// \param[in] _computeDistance True to compute the distance
+  /// \return Result of the check
+  private: CollisionCheck Check(
+      ConfigurationChecker &_checker,
+      const GeneralizedVector &_positions,
+      bool _computeDistance) const;
+
+  /// \brief Find the entity ID of a shape node reported by a checker.
+  /// \param[in] _checker Checker that reported the node
+  /// \param[in] _node Shape node of the checked skeleton or of another one
+  /// \return Entity ID of the collision, or 0 if it is not an entity
+  private: std::size_t FindCheckedShape(
+      const ConfigurationChecker &_checker,
+      const DartShapeNode *_node) const;
+
+  /// \brief Checkers of the models on their own skeletons, by model ID.
+  private: mutable std::unordered_map<std::size_t,
+      std::unique_ptr<ConfigurationChecker>> checkers;
+
+  /// \brief Threads of CheckModelConfigurations without a task scheduler.
+  /// Created on first use.
+  private: mutable std::unique_ptr<gz::common::WorkerPool> checkPool;
+
+  /// \brief Number of threads of checkPool.
+  private: mutable std::size_t checkPoolThreads = 0u;
+};
+}  // namespace gz::physics::dartsim
+
+#endif  // GZ_PHYSICS_DARTSIM_SRC_COLLISIONCHECKFEATURES_HH_
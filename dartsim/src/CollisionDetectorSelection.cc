@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dart/collision/bullet/BulletCollisionDetector.hpp>
+#include <dart/collision/dart/DARTCollisionDetector.hpp>
+#include <dart/collision/fcl/FCLCollisionDetector.hpp>
+#include <dart/constraint/ConstraintSolver.hpp>
+#include <dart/dynamics/BodyNode.hpp>
+#include <dart/dynamics/BoxShape.hpp>
+#include <dart/dynamics/HeightmapShape.hpp>
+#include <dart/dynamics/MeshShape.hpp>
+#include <dart/dynamics/ShapeNode.hpp>
+#include <dart/dynamics/Skeleton.hpp>
+#include <dart/dynamics/SoftMeshShape.hpp>
+#include <dart/dynamics/SphereShape.hpp>
+
+#include "CollisionDetectorSelection.hh"
+#include "GzOdeCollisionDetector.hh"
+#include "GzThreadedOdeCollisionDetector.hh"
+
+namespace gz {
+namespace physics {
+namespace dartsim {
+
+/// \brief Largest number of pairs that the DART detector is ranked first
+/// for. It has no broadphase, so it tests every pair of shapes.
+static constexpr std::size_t kMaxDartPairs = 500u;
+
+/////////////////////////////////////////////////
+dart::collision::CollisionDetectorPtr CreateCollisionDetector(
+    const std::string &_name)
+{
+  if (_name == "bullet")
+    return dart::collision::BulletCollisionDetector::create();
+  if (_name == "fcl")
+    return dart::collision::FCLCollisionDetector::create();
+  if (_name == "ode")
+    return dart::collision::GzOdeCollisionDetector::create();
+  if (_name == "threaded_ode")
+    return dart::collision::GzThreadedOdeCollisionDetector::create();
+  if (_name == "dart")
+    return dart::collision::DARTCollisionDetector::create();
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+bool SwitchCollisionDetector(
+    dart::simulation::World &_world, const std::string &_name)
+{
+  auto detector = CreateCollisionDetector(_name);
+  if (!detector)
+    return false;
+
+  auto *solver = _world.getConstraintSolver();
+  auto oldOde = std::dynamic_pointer_cast<
+      dart::collision::GzOdeCollisionDetector>(
+          solver->getCollisionDetector());
+  auto newOde = std::dynamic_pointer_cast<
+      dart::collision::GzOdeCollisionDetector>(detector);
+  if (oldOde && newOde)
+  {
+    newOde->SetCollisionPairMaxContacts(
+        oldOde->GetCollisionPairMaxContacts());
+    newOde->SetCollisionPairContactSelection(
+        oldOde->GetCollisionPairContactSelection());
+  }
+
+  solver->setCollisionDetector(detector);
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::size_t CollisionShapeCensus::Count() const
+{
+  return this->boxesAndSpheres + this->otherPrimitives + this->meshes +
+      this->heightmaps;
+}
+
+/////////////////////////////////////////////////
+std::size_t CollisionShapeCensus::PairCount() const
+{
+  const std::size_t count = this->Count();
+  return count < 2u ? 0u : count * (count - 1u) / 2u;
+}
+
+/////////////////////////////////////////////////
+CollisionShapeCensus CountCollisionShapes(
+    const dart::simulation::World &_world)
+{
+  CollisionShapeCensus census;
+  for (std::size_t i = 0; i < _world.getNumSkeletons(); ++i)
+  {
+    const auto skeleton = _world.getSkeleton(i);
+    for (std::size_t j = 0; j < skeleton->getNumBodyNodes(); ++j)
+    {
+      const auto *bodyNode = skeleton->getBodyNode(j);
+      const std::size_t numShapes =
+          bodyNode->getNumShapeNodesWith<dart::dynamics::CollisionAspect>();
+      for (std::size_t k = 0; k < numShapes; ++k)
+      {
+        const auto *shape = bodyNode->getShapeNodeWith<
+            dart::dynamics::CollisionAspect>(k)->getShape().get();
+        if (!shape)
+          continue;
+
+        if (dynamic_cast<const dart::dynamics::BoxShape *>(shape) ||
+            dynamic_cast<const dart::dynamics::SphereShape *>(shape))
+        {
+          ++census.boxesAndSpheres;
+        }
+        else if (dynamic_cast<const dart::dynamics::MeshShape *>(shape) ||
+                 dynamic_cast<const dart::dynamics::SoftMeshShape *>(shape))
+        {
+          ++census.meshes;
+        }
+        else if (dynamic_cast<const dart::dynamics::HeightmapShape<float> *>(
+                     shape) ||
+                 dynamic_cast<const dart::dynamics::HeightmapShape<double> *>(
+                     shape))
+        {
+          ++census.heightmaps;
+        }
+        else
+        {
+          ++census.otherPrimitives;
+        }
+      }
+    }
+  }
+  return census;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> RankCollisionDetectors(
+    const CollisionShapeCensus &_census)
+{
+  std::vector<std::string> ranked;
+  const bool dartSupported = _census.boxesAndSpheres == _census.Count();
+  if (dartSupported && _census.PairCount() <= kMaxDartPairs)
+    ranked.push_back("dart");
+
+  // Meshes are tested against each other by their triangles, which Bullet
+  // and FCL prune with bounding volume trees
+  if (_census.meshes > 0u && _census.meshes * 4u >= _census.Count())
+  {
+    ranked.push_back("bullet");
+    if (_census.heightmaps == 0u)
+      ranked.push_back("fcl");
+    ranked.push_back("ode");
+  }
+  else
+  {
+    ranked.push_back("ode");
+    ranked.push_back("bullet");
+    if (_census.heightmaps == 0u)
+      ranked.push_back("fcl");
+  }
+
+  if (dartSupported && ranked.front() != "dart")
+    ranked.push_back("dart");
+  return ranked;
+}
+
+/////////////////////////////////////////////////
+AutoCollisionDetector::AutoCollisionDetector(
+    std::vector<std::string> _candidates, bool _benchmark)
+  : candidates(std::move(_candidates)),
+    benchmarking(_benchmark && this->candidates.size() > 1u)
+{
+  this->stepTimes.reserve(kTimedSteps);
+}
+
+/////////////////////////////////////////////////
+const std::string &AutoCollisionDetector::Current() const
+{
+  return this->candidates[this->current];
+}
+
+/////////////////////////////////////////////////
+bool AutoCollisionDetector::Benchmarking() const
+{
+  return this->benchmarking;
+}
+
+/////////////////////////////////////////////////
+bool AutoCollisionDetector::Update(double _stepTime)
+{
+  if (!this->benchmarking)
+    return false;
+
+  // The first step of a detector builds its collision objects
+  if (this->steps++ > 0u)
+    this->stepTimes.push_back(_stepTime);
+  if (this->stepTimes.size() < kTimedSteps)
+    return false;
+
+  const auto median = this->stepTimes.begin() + kTimedSteps / 2u;
+  std::nth_element(this->stepTimes.begin(), median, this->stepTimes.end());
+  if (this->current == 0u || *median < this->fastestTime)
+  {
+    this->fastest = this->current;
+    this->fastestTime = *median;
+  }
+  this->stepTimes.clear();
+  this->steps = 0u;
+
+  const std::size_t last =
+      std::min(this->candidates.size(), kMaxBenchmarked) - 1u;
+  if (this->current < last)
+  {
+    ++this->current;
+    return true;
+  }
+
+  this->benchmarking = false;
+  const bool switched = this->current != this->fastest;
+  this->current = this->fastest;
+  return switched;
+}
+
+/////////////////////////////////////////////////
+bool AutoCollisionDetector::StopBenchmarking()
+{
+  const bool switched = this->current != 0u;
+  this->benchmarking = false;
+  this->current = 0u;
+  this->stepTimes.clear();
+  this->steps = 0u;
+  return switched;
+}
+
+}
+}
+}
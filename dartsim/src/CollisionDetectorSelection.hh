@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DARTSIM_SRC_COLLISIONDETECTORSELECTION_HH_
+#define GZ_PHYSICS_DARTSIM_SRC_COLLISIONDETECTORSELECTION_HH_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <dart/collision/CollisionDetector.hpp>
+#include <dart/simulation/World.hpp>
+
+namespace gz {
+namespace physics {
+namespace dartsim {
+
+/// \brief Create a collision detector by the name that
+/// SetWorldCollisionDetector takes.
+/// \param[in] _name One of "bullet", "fcl", "ode", "threaded_ode" or
+/// "dart".
+/// \return The detector, or nullptr if the name is not known.
+dart::collision::CollisionDetectorPtr CreateCollisionDetector(
+    const std::string &_name);
+
+/// \brief Replace the collision detector of a world. The contact settings
+/// of an ODE detector are carried over to another ODE detector.
+/// \param[in] _world The world.
+/// \param[in] _name Name of the new detector, see CreateCollisionDetector.
+/// \return False if the name is not known, which keeps the detector.
+bool SwitchCollisionDetector(
+    dart::simulation::World &_world, const std::string &_name);
+
+/// \brief Shapes that collide in a world, by the kind of geometry that the
+/// detectors handle differently.
+struct CollisionShapeCensus
+{
+  /// \brief Boxes and spheres, the only shapes of the DART detector.
+  std::size_t boxesAndSpheres = 0u;
+
+  /// \brief Other primitives, including planes.
+  std::size_t otherPrimitives = 0u;
+
+  /// \brief Triangle meshes, including soft meshes.
+  std::size_t meshes = 0u;
+
+  /// \brief Heightmaps, which FCL does not support.
+  std::size_t heightmaps = 0u;
+
+  /// \brief Get the number of shapes.
+  /// \return Number of shapes that collide.
+  std::size_t Count() const;
+
+  /// \brief Get the number of pairs that a detector without a broadphase
+  /// tests.
+  /// \return Number of pairs of shapes.
+  std::size_t PairCount() const;
+};
+
+/// \brief Count the shapes that collide in a world.
+/// \param[in] _world The world.
+/// \return Census of the shapes.
+CollisionShapeCensus CountCollisionShapes(
+    const dart::simulation::World &_world);
+
+/// \brief Rank the collision detectors that support every shape of a
+/// census. Scenes of primitives favor ODE, and the DART detector while it
+/// has few pairs to test, since it tests every pair. Scenes with many
+/// meshes favor Bullet and FCL.
+/// \param[in] _census Shapes of the world.
+/// \return Names of the detectors, the most suitable first.
+std::vector<std::string> RankCollisionDetectors(
+    const CollisionShapeCensus &_census);
+
+/// \brief Selection of the collision detector of a world in the "auto"
+/// mode of SetWorldCollisionDetector. The detectors are ranked by the
+/// shapes of the world. With benchmarking, the top candidates then step the
+/// world in turn, each for a warm-up step and a few timed steps, and the one
+/// with the shortest median step is kept.
+class AutoCollisionDetector
+{
+  /// \brief Constructor
+  /// \param[in] _candidates Ranked detectors, see RankCollisionDetectors.
+  /// \param[in] _benchmark Whether to time the top candidates, or to keep
+  /// the first one.
+  public: AutoCollisionDetector(
+      std::vector<std::string> _candidates, bool _benchmark);
+
+  /// \brief Get the detector that the next step uses.
+  /// \return Name of the detector.
+  public: const std::string &Current() const;
+
+  /// \brief Whether the candidates are still being timed.
+  /// \return True until a detector is selected.
+  public: bool Benchmarking() const;
+
+  /// \brief Record the time of a step with the current detector.
+  /// \param[in] _stepTime Wall clock time of the step, in seconds.
+  /// \return True if the next step uses another detector.
+  public: bool Update(double _stepTime);
+
+  /// \brief Stop timing the candidates and keep the first one, as without
+  /// benchmarking. Step times depend on the machine and its load, so this
+  /// is used while steps have to be deterministic.
+  /// \return True if the next step uses another detector.
+  public: bool StopBenchmarking();
+
+  /// \brief Number of timed steps of each candidate, after its warm-up
+  /// step.
+  public: static constexpr std::size_t kTimedSteps = 5u;
+
+  /// \brief Number of candidates that are timed.
+  public: static constexpr std::size_t kMaxBenchmarked = 3u;
+
+  /// \brief Ranked candidates, of which the first kMaxBenchmarked are
+  /// timed.
+  private: std::vector<std::string> candidates;
+
+  /// \brief Index of the current detector in candidates.
+  private: std::size_t current = 0u;
+
+  /// \brief Index of the fastest candidate that was timed.
+  private: std::size_t fastest = 0u;
+
+  /// \brief Median step time of the fastest candidate.
+  private: double fastestTime = 0.0;
+
+  /// \brief Steps of the current candidate, including its warm-up step.
+  private: std::size_t steps = 0u;
+
+  /// \brief Timed steps of the current candidate.
+  private: std::vector<double> stepTimes;
+
+  /// \brief See Benchmarking.
+  private: bool benchmarking = false;
+};
+
+}
+}
+}
+
+#endif
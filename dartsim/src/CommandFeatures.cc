@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <dart/dynamics/BodyNode.hpp>
+#include <dart/dynamics/Joint.hpp>
+
+#include <gz/common/Console.hh>
+
+#include "CommandFeatures.hh"
+
+namespace gz {
+namespace physics {
+namespace dartsim {
+
+using CommandType = WorldCommandBufferFeature::CommandType;
+
+/////////////////////////////////////////////////
+void CommandFeatures::ApplyWorldCommands(
+    const Identity &_id,
+    const WorldCommandBufferFeature::Command *_commands,
+    std::size_t _count)
+{
+  // Resolve the model of every command first, so the commands can be
+  // applied one model at a time.
+  this->commandOrder.clear();
+  this->commandOrder.reserve(_count);
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const auto &command = _commands[i];
+    const bool isJoint = command.type == CommandType::JOINT_FORCE ||
+        command.type == CommandType::JOINT_VELOCITY_COMMAND;
+
+    std::size_t modelID;
+    if (isJoint && this->joints.HasContainer(command.entity))
+      modelID = this->joints.ContainerIDOf(command.entity);
+    else if (!isJoint && this->links.HasContainer(command.entity))
+      modelID = this->links.ContainerIDOf(command.entity);
+    else
+    {
+      gzerr << "Command " << i << " refers to unknown "
+            << (isJoint ? "joint" : "link") << " [" << command.entity
+            << "]. The command will be ignored\n";
+      continue;
+    }
+
+    if (this->GetWorldOfModelImpl(modelID) != _id.id)
+    {
+      gzerr << "Command " << i << " refers to entity [" << command.entity
+            << "], which is not in world [" << _id.id
+            << "]. The command will be ignored\n";
+      continue;
+    }
+
+    this->commandOrder.emplace_back(modelID, i);
+  }
+
+  // A stable sort keeps the order of commands given for the same model, so
+  // the last force given to a joint DOF still wins.
+  std::stable_sort(this->commandOrder.begin(), this->commandOrder.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.first < _b.first;
+      });
+
+  for (const auto &order : this->commandOrder)
+  {
+    const auto &command = _commands[order.second];
+    switch (command.type)
+    {
+      case CommandType::JOINT_FORCE:
+      case CommandType::JOINT_VELOCITY_COMMAND:
+      {
+        const auto &jointInfo = this->joints.at(command.entity);
+        if (command.dof >= jointInfo->joint->getNumDofs())
+        {
+          gzerr << "Invalid DOF [" << command.dof << "] commanded on joint ["
+                << jointInfo->joint->getName()
+                << "]. The command will be ignored\n";
+          break;
+        }
+
+        const Identity jointID =
+            this->GenerateIdentity(command.entity, jointInfo);
+        if (command.type == CommandType::JOINT_FORCE)
+          this->SetJointForce(jointID, command.dof, command.value);
+        else
+          this->SetJointVelocityCommand(jointID, command.dof, command.value);
+        break;
+      }
+      case CommandType::LINK_FORCE:
+      case CommandType::LINK_TORQUE:
+      {
+        auto *bn = this->links.at(command.entity)->link.get();
+        if (command.dof >= 3u || !std::isfinite(command.value))
+        {
+          gzerr << "Invalid component [" << command.dof << "] or value ["
+                << command.value << "] commanded on link [" << bn->getName()
+                << "]. The command will be ignored\n";
+          break;
+        }
+
+        Eigen::Vector3d value = Eigen::Vector3d::Zero();
+        value[static_cast<Eigen::Index>(command.dof)] = command.value;
+        if (command.type == CommandType::LINK_FORCE)
+          bn->addExtForce(value, bn->getLocalCOM(), false, true);
+        else
+          bn->addExtTorque(value, false);
+        break;
+      }
+    }
+  }
+}
+
+}
+}
+}
@@ -19,6 +19,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <gz/common/Console.hh>
 #include <gz/common/SubMesh.hh>
@@ -93,41 +95,154 @@ unsigned int GetPrimitiveType(
 
   return 0;
 }
+
+/////////////////////////////////////////////////
+/// \brief Check that the indices of a submesh refer to its vertices.
+/// \param[in] _inputSubmesh Submesh to check.
+/// \param[in] _submeshIndex Index of the submesh in its mesh.
+/// \param[in] _path Path of the mesh.
+/// \return True if all indices are in range.
+bool CheckIndices(
+    const common::SubMesh &_inputSubmesh,
+    const unsigned int _submeshIndex,
+    const std::string &_path)
+{
+  const unsigned int numVertices = _inputSubmesh.VertexCount();
+  for (unsigned int i = 0; i < _inputSubmesh.IndexCount(); ++i)
+  {
+    const int vertexIndex = _inputSubmesh.Index(i);
+    if (vertexIndex < 0 ||
+        static_cast<unsigned int>(vertexIndex) >= numVertices)
+    {
+      gzwarn << "[dartsim::CustomMeshShape] The submesh [" << _submeshIndex
+             << ":" << _inputSubmesh.Name() << "] of mesh [" << _path
+             << "] has an index [" << vertexIndex << "] at [" << i
+             << "] that is out of range of its [" << numVertices
+             << "] vertices. This submesh will be ignored.\n";
+      return false;
+    }
+  }
+  return true;
 }
 
 /////////////////////////////////////////////////
-CustomMeshShape::CustomMeshShape(
-    const common::Mesh &_input,
-    const Eigen::Vector3d &_scale)
-  : dart::dynamics::MeshShape(_scale, nullptr)
+/// \brief Allocate an aiMesh.
+/// \param[in] _numVertices Number of vertices.
+/// \param[in] _numFaces Number of faces.
+/// \param[in] _numVerticesPerFace Number of vertices of each face.
+/// \param[in] _normals True to allocate a normal per vertex.
+/// \return The mesh.
+std::unique_ptr<aiMesh> NewMesh(
+    const unsigned int _numVertices,
+    const unsigned int _numFaces,
+    const unsigned int _numVerticesPerFace,
+    const bool _normals)
 {
-  // Create the root
-  aiNode* node = new aiNode;
-
-  // Allocate space for pointer arrays
-  const unsigned int numSubMeshes = _input.SubMeshCount();
-  node->mNumMeshes = numSubMeshes;
-  node->mMeshes = new unsigned int[numSubMeshes];
-  for (unsigned int i = 0; i < numSubMeshes; ++i)
-    node->mMeshes[i] = i;
+  auto mesh = std::make_unique<aiMesh>();
+  mesh->mMaterialIndex = static_cast<unsigned int>(-1);
+  mesh->mNumVertices = _numVertices;
+  mesh->mVertices = new aiVector3D[_numVertices];
+  if (_normals)
+    mesh->mNormals = new aiVector3D[_numVertices];
+
+  mesh->mNumFaces = _numFaces;
+  mesh->mFaces = new aiFace[_numFaces];
+  for (unsigned int j = 0; j < _numFaces; ++j)
+  {
+    mesh->mFaces[j].mNumIndices = _numVerticesPerFace;
+    mesh->mFaces[j].mIndices = new unsigned int[_numVerticesPerFace];
+  }
+  return mesh;
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy the vertices, normals and faces of a submesh into a range of
+/// an aiMesh allocated by NewMesh.
+/// \param[in] _inputSubmesh Submesh to copy, checked by CheckIndices.
+/// \param[in] _numVerticesPerFace Number of vertices of each face.
+/// \param[in] _vertexOffset Index of the first vertex of the range.
+/// \param[in] _faceOffset Index of the first face of the range.
+/// \param[out] _mesh Mesh to copy into.
+void CopySubMesh(
+    const common::SubMesh &_inputSubmesh,
+    const unsigned int _numVerticesPerFace,
+    const unsigned int _vertexOffset,
+    const unsigned int _faceOffset,
+    aiMesh &_mesh)
+{
+  for (unsigned int j = 0; j < _inputSubmesh.VertexCount(); ++j)
+  {
+    const math::Vector3d &v = _inputSubmesh.Vertex(j);
+    const math::Vector3d &n = _inputSubmesh.Normal(j);
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+      _mesh.mVertices[_vertexOffset + j][k] = static_cast<ai_real>(v[k]);
+      _mesh.mNormals[_vertexOffset + j][k] = static_cast<ai_real>(n[k]);
+    }
+  }
+
+  const unsigned int numFaces =
+      _inputSubmesh.IndexCount() / _numVerticesPerFace;
+  unsigned int index = 0;
+  for (unsigned int j = 0; j < numFaces; ++j)
+  {
+    aiFace &face = _mesh.mFaces[_faceOffset + j];
+    for (unsigned int k = 0; k < _numVerticesPerFace; ++k)
+    {
+      face.mIndices[k] = _vertexOffset +
+          static_cast<unsigned int>(_inputSubmesh.Index(index++));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a scene whose root node holds the given meshes.
+/// \param[in] _meshes Meshes of the scene, released to it.
+/// \return The scene.
+aiScene *NewScene(std::vector<std::unique_ptr<aiMesh>> &_meshes)
+{
+  const auto numMeshes = static_cast<unsigned int>(_meshes.size());
+
+  aiNode *node = new aiNode;
+  node->mNumMeshes = numMeshes;
+  node->mMeshes = new unsigned int[numMeshes];
 
   aiScene *scene = new aiScene;
-  scene->mNumMeshes = numSubMeshes;
-  scene->mMeshes = new aiMesh*[numSubMeshes];
+  scene->mNumMeshes = numMeshes;
+  scene->mMeshes = new aiMesh*[numMeshes];
   scene->mRootNode = node;
 
   // NOTE(MXG): We are ignoring materials and colors from the mesh, because
   // gazebo will only use dartsim for physics, not for rendering.
   scene->mMaterials = nullptr;
 
-  // Fill in submesh contents
-  for (unsigned int i = 0; i < numSubMeshes; ++i)
+  for (unsigned int i = 0; i < numMeshes; ++i)
   {
-    const common::SubMeshPtr &inputSubmesh =
-        _input.SubMeshByIndex(i).lock();
-
-    scene->mMeshes[i] = nullptr;
+    node->mMeshes[i] = i;
+    scene->mMeshes[i] = _meshes[i].release();
+  }
+  return scene;
+}
+}
 
+/////////////////////////////////////////////////
+CustomMeshShape::CustomMeshShape(
+    const common::Mesh &_input,
+    const Eigen::Vector3d &_scale)
+  : dart::dynamics::MeshShape(_scale, nullptr)
+{
+  // The triangle submeshes are copied into a single aiMesh, with their
+  // indices offset to its vertices, so that the collision detector builds
+  // one native mesh out of all of them. Point and line submeshes keep an
+  // aiMesh each. Submeshes that are ignored get no aiMesh at all.
+  std::vector<std::unique_ptr<aiMesh>> meshes;
+  std::vector<common::SubMeshPtr> triangleSubmeshes;
+  unsigned int numTriangleVertices = 0;
+  unsigned int numTriangles = 0;
+
+  for (unsigned int i = 0; i < _input.SubMeshCount(); ++i)
+  {
+    const common::SubMeshPtr inputSubmesh = _input.SubMeshByIndex(i).lock();
     if (!inputSubmesh)
     {
       gzerr << "[dartsim::CustomMeshShape] One of the submeshes [" << i
@@ -135,9 +250,6 @@ CustomMeshShape::CustomMeshShape(
       continue;
     }
 
-    std::unique_ptr<aiMesh> mesh = std::make_unique<aiMesh>();
-    mesh->mMaterialIndex = static_cast<unsigned int>(-1);
-
     const unsigned int numVertices = inputSubmesh->VertexCount();
     if (inputSubmesh->NormalCount() != numVertices)
     {
@@ -150,74 +262,82 @@ CustomMeshShape::CustomMeshShape(
       continue;
     }
 
-    mesh->mNumVertices = numVertices;
-    mesh->mVertices = new aiVector3D[numVertices];
-    mesh->mNormals = new aiVector3D[numVertices];
-
     const unsigned int numVerticesPerFace =
         CheckNumVerticesPerFaces(*inputSubmesh, i, _input.Path());
     if (0 == numVerticesPerFace)
       continue;
 
-    mesh->mPrimitiveTypes = GetPrimitiveType(*inputSubmesh);
-    if (0 == mesh->mPrimitiveTypes)
+    const unsigned int primitiveType = GetPrimitiveType(*inputSubmesh);
+    if (0 == primitiveType)
       continue;
 
-    const unsigned int numFaces = static_cast<unsigned int>(
-          static_cast<double>(inputSubmesh->IndexCount())
-          /static_cast<double>(numVerticesPerFace));
+    if (!CheckIndices(*inputSubmesh, i, _input.Path()))
+      continue;
 
-    // Fill in the contents of each submesh
-    mesh->mNumFaces = numFaces;
-    mesh->mFaces = new aiFace[numFaces];
-    unsigned int currentPrimitiveIndex = 0;
-    bool primitiveIndexOverflow = false;
-    for (unsigned int j = 0; j < numFaces; ++j)
+    const unsigned int numFaces =
+        inputSubmesh->IndexCount() / numVerticesPerFace;
+    if (aiPrimitiveType_TRIANGLE == primitiveType)
     {
-      mesh->mFaces[j].mNumIndices = numVerticesPerFace;
-      mesh->mFaces[j].mIndices = new unsigned int[numVerticesPerFace];
-
-      for (unsigned int k = 0; k < numVerticesPerFace; ++k)
-      {
-        int vertexIndex = inputSubmesh->Index(currentPrimitiveIndex);
-        if (vertexIndex == -1)
-        {
-          gzwarn << "[dartsim::CustomMeshShape] The submesh [" << i << ":"
-                  << inputSubmesh->Name() << "] of mesh [" << _input.Path()
-                  << "] overflowed at primitive index ["
-                  << currentPrimitiveIndex << "]. Its expected number of "
-                  << "primitive indices is [" << _input.IndexCount()
-                  << "]. This submesh will be ignored.\n";
-          primitiveIndexOverflow = true;
-          break;
-        }
-
-        mesh->mFaces[j].mIndices[k] = static_cast<unsigned int>(vertexIndex);
-        ++currentPrimitiveIndex;
-      }
-
-      if (primitiveIndexOverflow)
-        break;
+      triangleSubmeshes.push_back(inputSubmesh);
+      numTriangleVertices += numVertices;
+      numTriangles += numFaces;
+      continue;
     }
 
-    if (primitiveIndexOverflow)
-      continue;
+    auto mesh = NewMesh(numVertices, numFaces, numVerticesPerFace, true);
+    mesh->mPrimitiveTypes = primitiveType;
+    CopySubMesh(*inputSubmesh, numVerticesPerFace, 0, 0, *mesh);
+    meshes.push_back(std::move(mesh));
+  }
 
-    for (unsigned int j = 0; j < numVertices; ++j)
+  if (!triangleSubmeshes.empty())
+  {
+    auto mesh = NewMesh(numTriangleVertices, numTriangles, 3, true);
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    unsigned int vertexOffset = 0;
+    unsigned int faceOffset = 0;
+    for (const auto &inputSubmesh : triangleSubmeshes)
     {
-      const math::Vector3d &v = inputSubmesh->Vertex(j);
-      for (unsigned int k = 0; k < 3; ++k)
-        mesh->mVertices[j][k] = static_cast<ai_real>(v[k]);
-
-      const math::Vector3d &n = inputSubmesh->Normal(j);
-      for (unsigned int k = 0; k < 3; ++k)
-        mesh->mNormals[j][k] = static_cast<ai_real>(n[k]);
+      CopySubMesh(*inputSubmesh, 3, vertexOffset, faceOffset, *mesh);
+      vertexOffset += inputSubmesh->VertexCount();
+      faceOffset += inputSubmesh->IndexCount() / 3;
     }
+    meshes.insert(meshes.begin(), std::move(mesh));
+  }
 
-    scene->mMeshes[i] = mesh.release();
+  this->mMesh = NewScene(meshes);
+  this->mIsBoundingBoxDirty = true;
+  this->mIsVolumeDirty = true;
+}
+
+/////////////////////////////////////////////////
+CustomMeshShape::CustomMeshShape(
+    const mesh::TriangleMeshView &_view,
+    const Eigen::Vector3d &_scale)
+  : dart::dynamics::MeshShape(_scale, nullptr)
+{
+  // Collision detection does not use normals, so unlike the common::Mesh
+  // constructor this one leaves them out rather than requiring them.
+  const auto numVertices = static_cast<unsigned int>(_view.vertexCount);
+  const auto numFaces = static_cast<unsigned int>(_view.indexCount / 3u);
+  auto mesh = NewMesh(numVertices, numFaces, 3, false);
+  mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+
+  for (unsigned int j = 0; j < numVertices; ++j)
+  {
+    for (unsigned int k = 0; k < 3; ++k)
+      mesh->mVertices[j][k] = static_cast<ai_real>(_view.vertices[3*j + k]);
+  }
+
+  for (unsigned int j = 0; j < numFaces; ++j)
+  {
+    for (unsigned int k = 0; k < 3; ++k)
+      mesh->mFaces[j].mIndices[k] = _view.indices[3*j + k];
   }
 
-  this->mMesh = scene;
+  std::vector<std::unique_ptr<aiMesh>> meshes;
+  meshes.push_back(std::move(mesh));
+  this->mMesh = NewScene(meshes);
   this->mIsBoundingBoxDirty = true;
   this->mIsVolumeDirty = true;
 }
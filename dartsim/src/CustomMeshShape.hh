@@ -20,6 +20,7 @@
 
 #include <dart/dynamics/MeshShape.hpp>
 #include <gz/common/Mesh.hh>
+#include <gz/physics/mesh/TriangleMeshView.hh>
 
 namespace gz {
 namespace physics {
@@ -30,9 +31,23 @@ namespace dartsim {
 /// can be used by dartsim.
 class CustomMeshShape : public dart::dynamics::MeshShape
 {
+  /// \brief Build the shape from the submeshes of a mesh. The triangle
+  /// submeshes are merged into a single aiMesh, so the collision detector
+  /// builds one native mesh for the whole shape.
+  /// \param[in] _input Mesh to build the shape from.
+  /// \param[in] _scale Scale applied to the vertices.
   public: CustomMeshShape(
       const common::Mesh &_input,
       const Eigen::Vector3d &_scale);
+
+  /// \brief Build the shape straight from vertex and index arrays. DART
+  /// only collides with an aiScene, so the arrays are copied into one, but
+  /// no common::Mesh is needed to get there.
+  /// \param[in] _view Vertices and indices of a triangle mesh.
+  /// \param[in] _scale Scale applied to the vertices.
+  public: CustomMeshShape(
+      const mesh::TriangleMeshView &_view,
+      const Eigen::Vector3d &_scale);
 };
 
 }
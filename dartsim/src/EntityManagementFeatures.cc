@@ -19,84 +19,30 @@
 
 #include <memory>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include <dart/config.hpp>
+#include <dart/constraint/BoxedLcpConstraintSolver.hpp>
 #include <dart/constraint/ConstraintSolver.hpp>
+#include <dart/constraint/PgsBoxedLcpSolver.hpp>
+#include <dart/constraint/WeldJointConstraint.hpp>
 #include <dart/dynamics/FreeJoint.hpp>
 
 #include <dart/collision/CollisionFilter.hpp>
 #include <dart/collision/CollisionObject.hpp>
 
+#include "BitmaskContactFilter.hh"
+#include "GzContactConstraintSolver.hh"
+#include "GzIslandConstraintSolver.hh"
 #include "GzOdeCollisionDetector.hh"
+#include "TiledHeightmap.hh"
 
 namespace gz {
 namespace physics {
 namespace dartsim {
 
-/////////////////////////////////////////////////
-/// This class filters collision based on a bitmask:
-/// Each objects has a bitmask. If the bitwise-and of two objects' bitmasks
-/// evaluates to 0, then collisions between them are ignored.
-class BitmaskContactFilter : public dart::collision::BodyNodeCollisionFilter
-{
-  public: using DartCollisionConstPtr = const dart::collision::CollisionObject*;
-  public: using DartShapeConstPtr = const dart::dynamics::ShapeNode*;
-
-  private: std::unordered_map<DartShapeConstPtr, uint16_t> bitmaskMap;
-
-  public: bool ignoresCollision(
-      DartCollisionConstPtr _object1,
-      DartCollisionConstPtr _object2) const override
-  {
-    auto shapeNode1 = _object1->getShapeFrame()->asShapeNode();
-    auto shapeNode2 = _object2->getShapeFrame()->asShapeNode();
-
-    if (dart::collision::BodyNodeCollisionFilter::ignoresCollision(
-          _object1, _object2))
-      return true;
-
-    auto shape1Iter = bitmaskMap.find(shapeNode1);
-    auto shape2Iter = bitmaskMap.find(shapeNode2);
-    if (shape1Iter != bitmaskMap.end() && shape2Iter != bitmaskMap.end() &&
-        ((shape1Iter->second & shape2Iter->second) == 0))
-      return true;
-
-    return false;
-  }
-
-  public: void SetIgnoredCollision(DartShapeConstPtr _shapePtr, uint16_t _mask)
-  {
-    bitmaskMap[_shapePtr] = _mask;
-  }
-
-  public: uint16_t GetIgnoredCollision(DartShapeConstPtr _shapePtr) const
-  {
-    auto shapeIter = bitmaskMap.find(_shapePtr);
-    if (shapeIter != bitmaskMap.end())
-      return shapeIter->second;
-    return 0xff;
-  }
-
-  public: void RemoveIgnoredCollision(DartShapeConstPtr _shapePtr)
-  {
-    auto shapeIter = bitmaskMap.find(_shapePtr);
-    if (shapeIter != bitmaskMap.end())
-      bitmaskMap.erase(shapeIter);
-  }
-
-  public: void RemoveSkeletonCollisions(dart::dynamics::SkeletonPtr _skelPtr)
-  {
-    for (std::size_t i = 0; i < _skelPtr->getNumShapeNodes(); ++i)
-    {
-      auto shapePtr = _skelPtr->getShapeNode(i);
-      this->RemoveIgnoredCollision(shapePtr);
-    }
-  }
-
-  public: virtual ~BitmaskContactFilter() = default;
-};
-
 /// Utility functions
 /////////////////////////////////////////////////
 /// TODO (addisu): There's a lot of code duplication in model removal code, such
@@ -128,6 +74,184 @@ static std::size_t GetWorldOfShapeNode(const EntityManagementFeatures *_emf,
   return _emf->GetWorldOfModelImpl(modelID);
 }
 
+/////////////////////////////////////////////////
+/// \brief State shared by the steps of EntityManagementFeatures::CloneWorld.
+struct WorldCloneContext
+{
+  /// \brief Entity ID of the new world.
+  std::size_t worldID;
+
+  /// \brief Collision filter of the source world.
+  std::shared_ptr<BitmaskContactFilter> srcFilter;
+
+  /// \brief Collision filter of the new world.
+  std::shared_ptr<BitmaskContactFilter> filter;
+
+  /// \brief Cloned skeleton of every skeleton of the source world.
+  std::unordered_map<const dart::dynamics::Skeleton *,
+                     dart::dynamics::SkeletonPtr> skeletons;
+
+  /// \brief Model frames of the new world, keyed by the frames they were
+  /// cloned from.
+  std::unordered_map<const dart::dynamics::Frame *,
+                     dart::dynamics::Frame *> frames;
+};
+
+/////////////////////////////////////////////////
+static dart::dynamics::BodyNode *ClonedBodyNode(
+    const WorldCloneContext &_ctx, const dart::dynamics::BodyNode *_bn)
+{
+  auto it = _ctx.skeletons.find(_bn->getSkeleton().get());
+  if (it == _ctx.skeletons.end())
+    return nullptr;
+  return it->second->getBodyNode(_bn->getIndexInSkeleton());
+}
+
+/////////////////////////////////////////////////
+static dart::dynamics::Joint *ClonedJoint(
+    const WorldCloneContext &_ctx, const dart::dynamics::Joint *_joint)
+{
+  auto it = _ctx.skeletons.find(_joint->getSkeleton().get());
+  if (it == _ctx.skeletons.end())
+    return nullptr;
+  return it->second->getJoint(_joint->getJointIndexInSkeleton());
+}
+
+/////////////////////////////////////////////////
+static void CloneJoints(EntityManagementFeatures *_emf,
+    const WorldCloneContext &_ctx, const ModelInfo &_src,
+    std::size_t _modelID)
+{
+  for (const auto &srcJoint : _src.joints)
+  {
+    auto *joint = ClonedJoint(_ctx, srcJoint->joint.get());
+    if (nullptr == joint)
+      continue;
+    _emf->AddJoint(joint, joint->getName(), _modelID);
+  }
+}
+
+/////////////////////////////////////////////////
+static void CloneModel(EntityManagementFeatures *_emf,
+    WorldCloneContext &_ctx, const ModelInfo &_src, std::size_t _parentID)
+{
+  auto skelIt = _ctx.skeletons.find(_src.model.get());
+  if (skelIt == _ctx.skeletons.end())
+  {
+    gzerr << "Unable to clone model [" << _src.model->getName()
+          << "]: its skeleton is not part of the world.\n";
+    return;
+  }
+
+  ModelInfo info{skelIt->second, _src.localName, nullptr,
+                 _src.canonicalLinkName};
+  if (_src.frame)
+  {
+    auto parentIt = _ctx.frames.find(_src.frame->getParentFrame());
+    if (parentIt != _ctx.frames.end())
+    {
+      info.frame = dart::dynamics::SimpleFrame::createShared(
+          parentIt->second, _src.frame->getName(),
+          _src.frame->getRelativeTransform());
+    }
+    else
+    {
+      info.frame = dart::dynamics::SimpleFrame::createShared(
+          dart::dynamics::Frame::World(), _src.frame->getName(),
+          _src.frame->getWorldTransform());
+    }
+    _ctx.frames[_src.frame.get()] = info.frame.get();
+  }
+
+  const std::size_t modelID =
+      _emf->modelProxiesToWorld.HasEntity(_parentID) ?
+      std::get<0>(_emf->AddModel(info, _ctx.worldID)) :
+      std::get<0>(_emf->AddNestedModel(info, _parentID, _ctx.worldID));
+
+  const std::string &worldName = _emf->worlds.at(_ctx.worldID)->getName();
+  auto *solver = _emf->worlds.at(_ctx.worldID)->getConstraintSolver();
+  for (const auto &srcLink : _src.links)
+  {
+    auto *bn = ClonedBodyNode(_ctx, srcLink->link.get());
+    if (nullptr == bn)
+      continue;
+
+    // The shapes of a merged link are cloned with the body node it was
+    // merged into.
+    if (srcLink->mergedFrame)
+    {
+      _emf->AddMergedLink(bn, srcLink->name,
+          srcLink->mergedFrame->getRelativeTransform(), modelID,
+          srcLink->inertial);
+      continue;
+    }
+
+    const std::string fullName = ::sdf::JoinName(
+        worldName, ::sdf::JoinName(info.model->getName(), srcLink->name));
+    const std::size_t linkID =
+        _emf->AddLink(bn, fullName, modelID, srcLink->inertial);
+    const auto linkInfo = _emf->links.at(linkID);
+    if (linkInfo->name != srcLink->name)
+    {
+      auto &linkIndices = _emf->models.at(modelID)->linkNameToIndex;
+      auto entry = linkIndices.extract(linkInfo->name);
+      if (!entry.empty())
+      {
+        entry.key() = srcLink->name;
+        linkIndices.insert(std::move(entry));
+      }
+      linkInfo->name = srcLink->name;
+    }
+
+    // The welded mirror nodes were cloned with the skeletons, but the weld
+    // constraints belong to the constraint solver of the source world.
+    for (const auto &[srcWelded, srcWeld] : srcLink->weldedNodes)
+    {
+      auto *welded = ClonedBodyNode(_ctx, srcWelded);
+      if (nullptr == welded)
+        continue;
+      auto weld = std::make_shared<dart::constraint::WeldJointConstraint>(
+          bn, welded);
+      solver->addConstraint(weld);
+      linkInfo->weldedNodes.emplace_back(welded, weld);
+      _emf->linkByWeldedNode[welded] = linkInfo.get();
+    }
+
+    // The cloned shape nodes refer to the same dart::dynamics::Shape objects
+    // as the source, so meshes and other shape data are not copied.
+    const auto *srcBn = srcLink->link.get();
+    std::vector<dart::dynamics::ShapeNode *> heightmapTiles;
+    for (std::size_t i = 0; i < srcBn->getNumShapeNodes(); ++i)
+    {
+      const auto *srcNode = srcBn->getShapeNode(i);
+      if (_emf->heightmapTiles.count(srcNode) > 0u)
+        heightmapTiles.push_back(bn->getShapeNode(i));
+      if (!_emf->shapes.HasEntity(srcNode))
+        continue;
+
+      ShapeInfo shapeInfo = *_emf->shapes.at(srcNode);
+      shapeInfo.node = bn->getShapeNode(i);
+      if (shapeInfo.tiledHeightmap)
+      {
+        shapeInfo.tiledHeightmap =
+            shapeInfo.tiledHeightmap->CloneFor(shapeInfo.node.get());
+      }
+      _emf->AddShape(shapeInfo);
+      _ctx.filter->CopyIgnoredCollision(
+          *_ctx.srcFilter, srcNode, shapeInfo.node.get());
+    }
+
+    // The tiles of a cloned heightmap are attached again on its next step
+    for (auto *tile : heightmapTiles)
+      tile->remove();
+  }
+
+  CloneJoints(_emf, _ctx, _src, modelID);
+
+  for (const std::size_t nestedID : _src.nestedModels)
+    CloneModel(_emf, _ctx, *_emf->models.at(nestedID), modelID);
+}
+
 /////////////////////////////////////////////////
 const std::string &EntityManagementFeatures::GetEngineName(
     const Identity &/*_engineID*/) const
@@ -158,7 +282,7 @@ Identity EntityManagementFeatures::GetWorld(
 {
   const std::size_t id =
       this->worlds.indexInContainerToID.begin()->second[_worldIndex];
-  return this->GenerateIdentity(id, this->worlds.idToObject.at(id));
+  return this->GenerateIdentity(id, this->worlds.at(id));
 }
 
 /////////////////////////////////////////////////
@@ -166,7 +290,7 @@ Identity EntityManagementFeatures::GetWorld(
     const Identity &, const std::string &_worldName) const
 {
   const std::size_t id = this->worlds.IdentityOf(_worldName);
-  return this->GenerateIdentity(id, this->worlds.idToObject.at(id));
+  return this->GenerateIdentity(id, this->worlds.at(id));
 }
 
 /////////////////////////////////////////////////
@@ -181,7 +305,7 @@ std::size_t EntityManagementFeatures::GetWorldIndex(
     const Identity &_worldID) const
 {
   // TODO(anyone) this will throw if the world has been removed
-  return this->worlds.idToIndexInContainer.at(_worldID);
+  return this->worlds.IndexInContainerOf(_worldID);
 }
 
 /////////////////////////////////////////////////
@@ -267,7 +391,7 @@ std::size_t EntityManagementFeatures::GetModelIndex(
   // TODO(anyone) this will throw if the model has been removed. The alternative
   // is to first check if the model exists, but what should we return if it
   // doesn't exist
-  return this->models.idToIndexInContainer.at(_modelID);
+  return this->models.IndexInContainerOf(_modelID);
 }
 
 /////////////////////////////////////////////////
@@ -360,7 +484,16 @@ Identity EntityManagementFeatures::GetLink(
 
   // If the link doesn't exist in "links", it means the containing entity has
   // been removed.
-  if (this->links.HasEntity(linkInfo->link))
+  if (linkInfo->mergedFrame)
+  {
+    if (this->links.HasEntity(linkInfo->mergedID))
+    {
+      return this->GenerateIdentity(
+          linkInfo->mergedID, this->links.at(linkInfo->mergedID));
+    }
+    return this->GenerateInvalidId();
+  }
+  else if (this->links.HasEntity(linkInfo->link))
   {
     const std::size_t linkID = this->links.IdentityOf(linkInfo->link);
     return this->GenerateIdentity(linkID, this->links.at(linkID));
@@ -380,28 +513,11 @@ Identity EntityManagementFeatures::GetLink(
     const Identity &_modelID, const std::string &_linkName) const
 {
   const auto &modelInfo = this->ReferenceInterface<ModelInfo>(_modelID);
-  for (const auto &linkInfo : modelInfo->links)
-  {
-    if (_linkName == linkInfo->name)
-    {
-      // If the link doesn't exist in "links", it means the containing entity
-      // has been removed.
-      if (this->links.HasEntity(linkInfo->link))
-      {
-        const std::size_t linkID = this->links.IdentityOf(linkInfo->link);
-        return this->GenerateIdentity(linkID, this->links.at(linkID));
-      }
-      else
-      {
-        // TODO(addisu) It's not clear what to do when `GetLink` is called on a
-        // model that has been removed. Right now we are returning an invalid
-        // identity, but that could cause a segfault if the user doesn't check
-        // the returned value before using it.
-        return this->GenerateInvalidId();
-      }
-    }
-  }
-  return this->GenerateInvalidId();
+  const auto it = modelInfo->linkNameToIndex.find(_linkName);
+  if (it == modelInfo->linkNameToIndex.end())
+    return this->GenerateInvalidId();
+
+  return this->GetLink(_modelID, it->second);
 }
 
 /////////////////////////////////////////////////
@@ -446,15 +562,11 @@ Identity EntityManagementFeatures::GetJoint(
 Identity EntityManagementFeatures::GetJoint(
     const Identity &_modelID, const std::string &_jointName) const
 {
-  const std::string fullJointName =
-      this->FullyScopedJointName(_modelID, _jointName);
-  if (fullJointName.empty())
-    return this->GenerateInvalidId();
-
-  auto it = this->jointsByName.find(fullJointName);
-  if (it != this->jointsByName.end())
+  const auto &modelInfo = this->ReferenceInterface<ModelInfo>(_modelID);
+  const auto it = modelInfo->jointNameToIndex.find(_jointName);
+  if (it != modelInfo->jointNameToIndex.end())
   {
-    auto joint = it->second;
+    const auto &joint = modelInfo->joints[it->second]->joint;
     if (this->joints.HasEntity(joint))
     {
       const std::size_t jointID = this->joints.IdentityOf(joint);
@@ -483,7 +595,7 @@ const std::string &EntityManagementFeatures::GetLinkName(
 std::size_t EntityManagementFeatures::GetLinkIndex(
     const Identity &_linkID) const
 {
-  return this->links.idToIndexInContainer.at(_linkID);
+  return this->links.IndexInContainerOf(_linkID);
 }
 
 /////////////////////////////////////////////////
@@ -555,21 +667,24 @@ Identity EntityManagementFeatures::GetShape(
 const std::string &EntityManagementFeatures::GetJointName(
     const Identity &_jointID) const
 {
-  return this->ReferenceInterface<JointInfo>(_jointID)->joint->getName();
+  const auto *jointInfo = this->ReferenceInterface<JointInfo>(_jointID);
+  if (!jointInfo->joint)
+    return jointInfo->name;
+  return jointInfo->joint->getName();
 }
 
 /////////////////////////////////////////////////
 std::size_t EntityManagementFeatures::GetJointIndex(
     const Identity &_jointID) const
 {
-  return this->joints.idToIndexInContainer.at(_jointID);
+  return this->joints.IndexInContainerOf(_jointID);
 }
 
 /////////////////////////////////////////////////
 Identity EntityManagementFeatures::GetModelOfJoint(
     const Identity &_jointID) const
 {
-  const std::size_t modelID = this->joints.idToContainerID.at(_jointID);
+  const std::size_t modelID = this->joints.ContainerIDOf(_jointID);
   auto modelInfo = this->GetModelInfo(modelID);
 
 
@@ -653,6 +768,27 @@ bool EntityManagementFeatures::RemoveModelByName(const Identity &_worldID,
   return false;
 }
 
+/////////////////////////////////////////////////
+std::size_t EntityManagementFeatures::RemoveModelsByName(
+    const Identity &_worldID, const std::vector<std::string> &_modelNames)
+{
+  auto *const world = this->ReferenceInterface<DartWorld>(_worldID);
+  auto filterPtr = GetFilterPtr(this, _worldID);
+
+  std::vector<std::size_t> modelIDs;
+  modelIDs.reserve(_modelNames.size());
+  for (const std::string &name : _modelNames)
+  {
+    const DartSkeletonPtr &model = world->getSkeleton(name);
+    if (model != nullptr && this->models.HasEntity(model))
+    {
+      filterPtr->RemoveSkeletonCollisions(model);
+      modelIDs.push_back(this->models.IdentityOf(model));
+    }
+  }
+  return this->RemoveModelsImpl(_worldID, modelIDs);
+}
+
 /////////////////////////////////////////////////
 bool EntityManagementFeatures::RemoveModel(const Identity &_modelID)
 {
@@ -740,6 +876,132 @@ Identity EntityManagementFeatures::ConstructEmptyWorld(
   return this->GenerateIdentity(worldID, this->worlds.at(worldID));
 }
 
+/////////////////////////////////////////////////
+Identity EntityManagementFeatures::CloneWorld(
+    const Identity &_worldID, const std::string &_name)
+{
+  const auto srcWorld = this->worlds.at(_worldID);
+  if (this->worlds.HasEntity(_name))
+  {
+    gzerr << "Unable to clone world [" << srcWorld->getName()
+          << "]: a world named [" << _name << "] already exists.\n";
+    return this->GenerateInvalidId();
+  }
+
+  auto *srcSolver = srcWorld->getConstraintSolver();
+
+  const auto world = std::make_shared<dart::simulation::World>(_name);
+  world->setGravity(srcWorld->getGravity());
+  world->setTimeStep(srcWorld->getTimeStep());
+  world->setTime(srcWorld->getTime());
+
+  if (auto *srcIslandSolver =
+          dynamic_cast<dart::constraint::GzIslandConstraintSolver *>(
+              srcSolver))
+  {
+    auto islandSolver =
+        std::make_unique<dart::constraint::GzIslandConstraintSolver>();
+    islandSolver->SetNumThreads(srcIslandSolver->GetNumThreads());
+    world->setConstraintSolver(std::move(islandSolver));
+  }
+  else if (dynamic_cast<dart::constraint::GzContactConstraintSolver *>(
+               srcSolver))
+  {
+    world->setConstraintSolver(
+        std::make_unique<dart::constraint::GzContactConstraintSolver>());
+  }
+
+  if (auto *srcContactSolver =
+          dynamic_cast<dart::constraint::GzContactConstraintSolver *>(
+              srcSolver))
+  {
+    auto *contactSolver =
+        static_cast<dart::constraint::GzContactConstraintSolver *>(
+            world->getConstraintSolver());
+    contactSolver->SetWarmStarting(srcContactSolver->GetWarmStarting());
+    contactSolver->SetPenaltyContact(
+        srcContactSolver->GetPenaltyStiffness(),
+        srcContactSolver->GetPenaltyDamping());
+    contactSolver->SetStatisticsEnabled(
+        srcContactSolver->GetStatisticsEnabled());
+  }
+
+  auto *solver = world->getConstraintSolver();
+  solver->setCollisionDetector(
+      srcSolver->getCollisionDetector()->cloneWithoutCollisionObjects());
+
+  auto *srcBoxedSolver =
+      dynamic_cast<dart::constraint::BoxedLcpConstraintSolver *>(srcSolver);
+  auto *boxedSolver =
+      dynamic_cast<dart::constraint::BoxedLcpConstraintSolver *>(solver);
+  if (srcBoxedSolver && boxedSolver)
+  {
+    // Copy the PGS settings of both solvers, see SolverProfile
+    auto copyPgs = [](const dart::constraint::BoxedLcpSolverPtr &_src)
+        -> std::shared_ptr<dart::constraint::PgsBoxedLcpSolver>
+    {
+      auto srcPgs =
+          std::dynamic_pointer_cast<dart::constraint::PgsBoxedLcpSolver>(
+              _src);
+      if (!srcPgs)
+        return nullptr;
+      auto pgs = std::make_shared<dart::constraint::PgsBoxedLcpSolver>();
+      pgs->setOption(srcPgs->getOption());
+      return pgs;
+    };
+
+    if (auto pgs = copyPgs(srcBoxedSolver->getBoxedLcpSolver()))
+      boxedSolver->setBoxedLcpSolver(pgs);
+    if (auto pgs = copyPgs(srcBoxedSolver->getSecondaryBoxedLcpSolver()))
+      boxedSolver->setSecondaryBoxedLcpSolver(pgs);
+  }
+
+  WorldCloneContext ctx;
+  ctx.srcFilter = GetFilterPtr(this, _worldID);
+  ctx.filter = std::make_shared<BitmaskContactFilter>();
+
+  auto collOpt = srcSolver->getCollisionOption();
+  collOpt.collisionFilter = ctx.filter;
+  solver->setCollisionOption(collOpt);
+
+  ctx.worldID = this->AddWorld(world, _name);
+  const auto subSteps = this->worldSubSteps.find(_worldID);
+  if (subSteps != this->worldSubSteps.end())
+    this->worldSubSteps[ctx.worldID] = subSteps->second;
+  const auto adaptive = this->worldAdaptiveSteps.find(_worldID);
+  if (adaptive != this->worldAdaptiveSteps.end())
+  {
+    const auto parameters = adaptive->second.controller.GetParameters();
+    this->worldAdaptiveSteps[ctx.worldID].controller.SetParameters(
+        parameters);
+  }
+  ctx.frames[dart::dynamics::Frame::World()] = dart::dynamics::Frame::World();
+
+  // Skeletons are cloned up front, since a link may have been moved to the
+  // skeleton of another model by a joint between the two.
+  for (std::size_t i = 0; i < srcWorld->getNumSkeletons(); ++i)
+  {
+    const auto srcSkel = srcWorld->getSkeleton(i);
+    ctx.skeletons[srcSkel.get()] = srcSkel->cloneSkeleton(srcSkel->getName());
+  }
+
+  const auto srcProxy = this->modelProxiesToWorld.at(_worldID);
+  for (const std::size_t modelID : srcProxy->nestedModels)
+    CloneModel(this, ctx, *this->models.at(modelID), ctx.worldID);
+  CloneJoints(this, ctx, *srcProxy, ctx.worldID);
+
+  // Keep skeletons that are not owned by any model, so the clone simulates
+  // the same bodies as the source.
+  for (std::size_t i = 0; i < srcWorld->getNumSkeletons(); ++i)
+  {
+    const auto &skel = ctx.skeletons.at(srcWorld->getSkeleton(i).get());
+    if (!world->hasSkeleton(skel))
+      world->addSkeleton(skel);
+  }
+
+  return this->GenerateIdentity(ctx.worldID, this->worlds.at(ctx.worldID));
+}
+
 /////////////////////////////////////////////////
 Identity EntityManagementFeatures::ConstructEmptyModel(
     const Identity &_worldID, const std::string &_name)
@@ -855,6 +1117,30 @@ Identity EntityManagementFeatures::GetWorldModel(const Identity &_worldID) const
   }
   return this->GenerateInvalidId();
 }
+
+/////////////////////////////////////////////////
+bool EntityManagementFeatures::GetWorldEntityChanges(
+    const Identity &_worldID, std::size_t &_cursor,
+    std::vector<EntityChange> &_changes) const
+{
+  const auto it = this->entityChanges.find(_worldID);
+  if (it == this->entityChanges.end())
+  {
+    // Nothing has changed since the world was created
+    _cursor = 0u;
+    _changes.clear();
+    return true;
+  }
+  return it->second.Read(_cursor, _changes);
+}
+
+/////////////////////////////////////////////////
+std::size_t EntityManagementFeatures::GetWorldEntityChangeCursor(
+    const Identity &_worldID) const
+{
+  const auto it = this->entityChanges.find(_worldID);
+  return it == this->entityChanges.end() ? 0u : it->second.End();
+}
 }  // namespace dartsim
 }
 }
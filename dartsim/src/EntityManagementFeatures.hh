@@ -19,12 +19,14 @@
 #define GZ_PHYSICS_DARTSIM_SRC_GETENTITIESFEATURE_HH_
 
 #include <string>
+#include <vector>
 
 #include <gz/physics/ConstructEmpty.hh>
 #include <gz/physics/Shape.hh>
 #include <gz/physics/GetEntities.hh>
 #include <gz/physics/RemoveEntities.hh>
 #include <gz/physics/Implements.hh>
+#include <gz/physics/World.hh>
 
 #include "Base.hh"
 
@@ -35,12 +37,15 @@ namespace dartsim {
 struct EntityManagementFeatureList : FeatureList<
   GetEntities,
   RemoveEntities,
+  RemoveModelsFromWorld,
   ConstructEmptyWorldFeature,
   ConstructEmptyModelFeature,
   ConstructEmptyNestedModelFeature,
   ConstructEmptyLinkFeature,
   CollisionFilterMaskFeature,
-  WorldModelFeature
+  WorldModelFeature,
+  CloneWorldFeature,
+  EntityChangeJournalFeature
 > { };
 
 class EntityManagementFeatures :
@@ -146,6 +151,10 @@ class EntityManagementFeatures :
 
   public: bool RemoveModel(const Identity &_modelID) override;
 
+  public: std::size_t RemoveModelsByName(
+      const Identity &_worldID,
+      const std::vector<std::string> &_modelNames) override;
+
   public: bool ModelRemoved(const Identity &_modelID) const override;
 
   public: bool RemoveNestedModelByIndex(
@@ -178,6 +187,18 @@ class EntityManagementFeatures :
 
   // ----- World model feature -----
   public: Identity GetWorldModel(const Identity &_worldID) const override;
+
+  // ----- Clone world -----
+  public: Identity CloneWorld(
+      const Identity &_worldID, const std::string &_name) override;
+
+  // ----- Entity change journal -----
+  public: bool GetWorldEntityChanges(
+      const Identity &_worldID, std::size_t &_cursor,
+      std::vector<EntityChange> &_changes) const override;
+
+  public: std::size_t GetWorldEntityChangeCursor(
+      const Identity &_worldID) const override;
 };
 
 }
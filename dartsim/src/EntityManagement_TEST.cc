@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include <gz/plugin/Loader.hh>
 
 #include <gz/common/geospatial/Dem.hh>
@@ -26,14 +29,18 @@
 
 #include <gz/math/eigen3/Conversions.hh>
 
+#include <gz/physics/FrameSemantics.hh>
+#include <gz/physics/heightmap/HeightfieldCache.hh>
 #include <gz/physics/Joint.hh>
 #include <gz/physics/RequestEngine.hh>
 #include <gz/physics/RevoluteJoint.hh>
 
+#include "CustomHeightmapShape.hh"
 #include "EntityManagementFeatures.hh"
 #include "JointFeatures.hh"
 #include "KinematicsFeatures.hh"
 #include "ShapeFeatures.hh"
+#include "SimulationFeatures.hh"
 
 #include "test/Resources.hh"
 
@@ -268,6 +275,128 @@ TEST(EntityManagement_TEST, ConstructEmptyWorld)
   EXPECT_NEAR(sizeDem.Z(), demShapeRecast->GetSize()[2], 1e-6);
 }
 
+struct TiledHeightmapFeatureList : physics::FeatureList<
+    TestFeatureList,
+    physics::dartsim::SimulationFeatureList
+> { };
+
+/// \brief Drop a sphere in the middle of a bowl heightmap and return the
+/// height it comes to rest at.
+double DropSphereOnHeightmap(
+    const physics::Engine3dPtr<TiledHeightmapFeatureList> &_engine,
+    const std::string &_worldName, int _subSampling)
+{
+  auto world = _engine->ConstructEmptyWorld(_worldName);
+  auto terrain = world->ConstructEmptyModel("terrain");
+  auto terrainLink = terrain->ConstructEmptyLink("link");
+  terrainLink->AttachFixedJoint(nullptr, "fixed");
+
+  common::ImageHeightmap data;
+  EXPECT_EQ(0, data.Load(gz::physics::test::resources::kHeightmapBowlPng));
+  const math::Vector3d size({129, 129, 10});
+  auto heightmap = terrainLink->AttachHeightmapShape("heightmap", data,
+      Eigen::Isometry3d::Identity(), math::eigen3::convert(size),
+      _subSampling);
+  EXPECT_NEAR(size.X(), heightmap->GetSize()[0], 1e-6);
+  EXPECT_NEAR(size.Y(), heightmap->GetSize()[1], 1e-6);
+  EXPECT_NEAR(size.Z(), heightmap->GetSize()[2], 1e-6);
+
+  auto sphere = world->ConstructEmptyModel("sphere");
+  auto sphereLink = sphere->ConstructEmptyLink("link");
+  sphereLink->AttachSphereShape("sphere", 0.5);
+  sphere->GetJoint(0)->SetPosition(5, 12.0);
+
+  physics::ForwardStep::Output output;
+  physics::ForwardStep::State state;
+  physics::ForwardStep::Input input;
+  for (std::size_t i = 0; i < 3000; ++i)
+    world->Step(output, state, input);
+
+  // The sphere is resting on the heightmap
+  bool touchesHeightmap = false;
+  for (const auto &contact : world->GetContactsFromLastStep())
+  {
+    const auto &point = contact.Get<
+        physics::World3d<TiledHeightmapFeatureList>::ContactPoint>();
+    touchesHeightmap |=
+        point.collision1->EntityID() == heightmap->EntityID() ||
+        point.collision2->EntityID() == heightmap->EntityID();
+  }
+  EXPECT_TRUE(touchesHeightmap);
+
+  return sphereLink->FrameDataRelativeToWorld().pose.translation().z();
+}
+
+TEST(EntityManagement_TEST, TiledHeightmap)
+{
+  plugin::Loader loader;
+  loader.LoadLib(dartsim_plugin_LIB);
+
+  plugin::PluginPtr dartsim =
+      loader.Instantiate("gz::physics::dartsim::Plugin");
+
+  auto engine =
+      physics::RequestEngine3d<TiledHeightmapFeatureList>::From(dartsim);
+  ASSERT_NE(nullptr, engine);
+
+  // Subsampling the 129 pixel image 40 times gives more vertices than are
+  // allowed in a single heightmap, so it is split into tiles.
+  ASSERT_GT(129u * 40u - 39u,
+      physics::dartsim::kMaxUntiledHeightmapVertices);
+  const double untiledZ = DropSphereOnHeightmap(engine, "untiled", 1);
+  const double tiledZ = DropSphereOnHeightmap(engine, "tiled", 40);
+
+  EXPECT_GT(untiledZ, 0.0);
+  EXPECT_NEAR(untiledZ, tiledZ, 1e-2);
+}
+
+TEST(EntityManagement_TEST, SharedHeightmaps)
+{
+  plugin::Loader loader;
+  loader.LoadLib(dartsim_plugin_LIB);
+
+  common::ImageHeightmap data;
+  EXPECT_EQ(0, data.Load(gz::physics::test::resources::kHeightmapBowlPng));
+  const Eigen::Vector3d size(129, 129, 10);
+
+  auto &cache = physics::heightmap::SharedHeightfieldCache<
+      physics::dartsim::CustomHeightmapShape>::Instance();
+  const std::size_t initialSize = cache.Size();
+
+  // Worlds of different engines that attach the same heightmap share one
+  // heightfield, and subsampling it differently gives another one
+  std::vector<plugin::PluginPtr> plugins;
+  for (std::size_t i = 0; i < 2u; ++i)
+  {
+    plugins.push_back(loader.Instantiate("gz::physics::dartsim::Plugin"));
+    auto engine =
+        physics::RequestEngine3d<TestFeatureList>::From(plugins.back());
+    ASSERT_NE(nullptr, engine);
+
+    for (const std::string &worldName : {"world1", "world2"})
+    {
+      auto link = engine->ConstructEmptyWorld(worldName)
+          ->ConstructEmptyModel("terrain")->ConstructEmptyLink("link");
+      auto heightmap = link->AttachHeightmapShape("heightmap", data,
+          Eigen::Isometry3d::Identity(), size);
+      ASSERT_NE(nullptr, heightmap);
+      EXPECT_NEAR(size.x(), heightmap->GetSize()[0], 1e-6);
+    }
+    EXPECT_EQ(initialSize + 1u, cache.Size());
+  }
+
+  auto engine = physics::RequestEngine3d<TestFeatureList>::From(plugins[0]);
+  engine->ConstructEmptyWorld("world3")->ConstructEmptyModel("terrain")
+      ->ConstructEmptyLink("link")->AttachHeightmapShape("heightmap", data,
+          Eigen::Isometry3d::Identity(), size, 2);
+  EXPECT_EQ(initialSize + 2u, cache.Size());
+
+  // The heightfields are freed with the last world that uses them
+  engine.reset();
+  plugins.clear();
+  EXPECT_EQ(initialSize, cache.Size());
+}
+
 TEST(EntityManagement_TEST, RemoveEntities)
 {
   plugin::Loader loader;
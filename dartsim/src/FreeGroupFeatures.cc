@@ -17,6 +17,8 @@
 
 #include "FreeGroupFeatures.hh"
 
+#include <algorithm>
+
 #include <dart/constraint/ConstraintSolver.hpp>
 #include <dart/dynamics/FreeJoint.hpp>
 #include <gz/common/Console.hh>
@@ -113,10 +115,9 @@ Identity FreeGroupFeatures::GetFreeGroupRootLink(const Identity &_groupID) const
 FreeGroupFeatures::FreeGroupInfo FreeGroupFeatures::GetCanonicalInfo(
     const Identity &_groupID) const
 {
-  const auto model_it = this->models.idToObject.find(_groupID);
-  if (model_it != this->models.idToObject.end())
+  if (const auto *modelInfoPtr = this->models.Find(_groupID))
   {
-    const auto &modelInfo = model_it->second;
+    const auto &modelInfo = *modelInfoPtr;
     if (modelInfo->model->getNumBodyNodes() > 0)
     {
       return FreeGroupInfo{
@@ -151,6 +152,7 @@ void FreeGroupFeatures::SetFreeGroupWorldPose(
     const Identity &_groupID,
     const PoseType &_pose)
 {
+  this->frameDataCache.Invalidate();
   const FreeGroupInfo &info = GetCanonicalInfo(_groupID);
   if (!info.model)
   {
@@ -199,6 +201,7 @@ void FreeGroupFeatures::SetFreeGroupWorldPose(
 void FreeGroupFeatures::SetFreeGroupWorldLinearVelocity(
     const Identity &_groupID, const LinearVelocity &_linearVelocity)
 {
+  this->frameDataCache.Invalidate();
   const FreeGroupInfo &info = GetCanonicalInfo(_groupID);
   if (!info.model)
   {
@@ -224,6 +227,7 @@ void FreeGroupFeatures::SetFreeGroupWorldLinearVelocity(
 void FreeGroupFeatures::SetFreeGroupWorldAngularVelocity(
     const Identity &_groupID, const AngularVelocity &_angularVelocity)
 {
+  this->frameDataCache.Invalidate();
   const FreeGroupInfo &info = GetCanonicalInfo(_groupID);
   if (!info.model)
   {
@@ -251,6 +255,97 @@ void FreeGroupFeatures::SetFreeGroupWorldAngularVelocity(
   }
 }
 
+/////////////////////////////////////////////////
+void FreeGroupFeatures::SetWorldFreeGroupStates(
+    const Identity &_worldID,
+    const FreeGroupState *_states,
+    std::size_t _count)
+{
+  this->frameDataCache.Invalidate();
+  const auto &world = this->worlds.at(_worldID);
+
+  // Compute the state of every root joint first, so that the kinematics of
+  // the skeletons are only brought up to date for the current poses, and
+  // are invalidated once when the states are applied.
+  struct RootState
+  {
+    dart::dynamics::FreeJoint *joint;
+    Eigen::Isometry3d transform;
+    Eigen::Vector3d linearVelocity;
+    Eigen::Vector3d angularVelocity;
+  };
+  std::vector<RootState> rootStates;
+  std::vector<DartBodyNode *> roots;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const FreeGroupState &state = _states[i];
+    if (!this->models.HasEntity(state.freeGroup) &&
+        !this->links.HasEntity(state.freeGroup))
+    {
+      continue;
+    }
+
+    const FreeGroupInfo &info =
+        this->GetCanonicalInfo(this->GenerateIdentity(state.freeGroup));
+    if (nullptr == info.link ||
+        !world->hasSkeleton(info.link->getSkeleton()))
+    {
+      continue;
+    }
+
+    roots.clear();
+    if (info.model)
+      this->CollectRootBodyNodes(state.freeGroup, roots);
+    else
+      roots.push_back(info.link);
+
+    // The trees move rigidly with the root link, and get the velocities of
+    // a rigid body moving with it
+    const Eigen::Isometry3d tfChange =
+        state.pose * info.link->getWorldTransform().inverse();
+    for (DartBodyNode *bn : roots)
+    {
+      auto *joint =
+          dynamic_cast<dart::dynamics::FreeJoint *>(bn->getParentJoint());
+      if (nullptr == joint)
+        continue;
+
+      const Eigen::Isometry3d tf = tfChange * bn->getWorldTransform();
+      const Eigen::Vector3d r = tf.translation() - state.pose.translation();
+      rootStates.push_back({joint, tf,
+          state.linearVelocity + state.angularVelocity.cross(r),
+          state.angularVelocity});
+    }
+  }
+
+  for (const RootState &root : rootStates)
+  {
+    root.joint->setTransform(root.transform);
+    root.joint->setLinearVelocity(root.linearVelocity);
+    root.joint->setAngularVelocity(root.angularVelocity);
+  }
+}
+
+/////////////////////////////////////////////////
+void FreeGroupFeatures::CollectRootBodyNodes(
+    std::size_t _modelID, std::vector<DartBodyNode *> &_roots) const
+{
+  const auto *modelInfo = this->models.Find(_modelID);
+  if (nullptr == modelInfo || !*modelInfo)
+    return;
+
+  const auto &skeleton = (*modelInfo)->model;
+  for (std::size_t i = 0; i < skeleton->getNumTrees(); ++i)
+  {
+    DartBodyNode *bn = skeleton->getRootBodyNode(i);
+    if (std::find(_roots.begin(), _roots.end(), bn) == _roots.end())
+      _roots.push_back(bn);
+  }
+
+  for (const auto &nestedModel : (*modelInfo)->nestedModels)
+    this->CollectRootBodyNodes(nestedModel, _roots);
+}
+
 }
 }
 }
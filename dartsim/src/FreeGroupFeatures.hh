@@ -18,6 +18,9 @@
 #ifndef GZ_PHYSICS_DARTSIM_SRC_FREEGROUPFEATURES_HH_
 #define GZ_PHYSICS_DARTSIM_SRC_FREEGROUPFEATURES_HH_
 
+#include <cstddef>
+#include <vector>
+
 #include <gz/physics/FreeGroup.hh>
 
 #include "Base.hh"
@@ -29,7 +32,8 @@ namespace dartsim {
 struct FreeGroupFeatureList : FeatureList<
   FindFreeGroupFeature,
   SetFreeGroupWorldPose,
-  SetFreeGroupWorldVelocity
+  SetFreeGroupWorldVelocity,
+  SetFreeGroupWorldStates
   // Note: FreeGroupFrameSemantics is covered in KinematicsFeatures.hh
 > { };
 
@@ -67,6 +71,19 @@ class FreeGroupFeatures
   void SetFreeGroupWorldAngularVelocity(
       const Identity &_groupID,
       const AngularVelocity &_angularVelocity) override;
+
+  // ----- SetFreeGroupWorldStates -----
+  void SetWorldFreeGroupStates(
+      const Identity &_worldID,
+      const FreeGroupState *_states,
+      std::size_t _count) override;
+
+  /// \brief Collect the root BodyNodes of the trees of a model and of its
+  /// nested models, without duplicates.
+  /// \param[in] _modelID Entity ID of the model
+  /// \param[in,out] _roots The root BodyNodes are appended to this
+  void CollectRootBodyNodes(
+      std::size_t _modelID, std::vector<DartBodyNode *> &_roots) const;
 };
 
 }
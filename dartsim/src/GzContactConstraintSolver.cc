@@ -0,0 +1,597 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dart/collision/CollisionObject.hpp>
+#include <dart/collision/CollisionResult.hpp>
+#include <dart/collision/Contact.hpp>
+#include <dart/constraint/BoxedLcpSolver.hpp>
+#include <dart/constraint/ContactConstraint.hpp>
+#include <dart/constraint/SoftContactConstraint.hpp>
+#include <dart/dynamics/BodyNode.hpp>
+#include <dart/dynamics/ShapeNode.hpp>
+#include <dart/dynamics/Skeleton.hpp>
+
+#include "GzContactConstraintSolver.hh"
+
+namespace dart {
+namespace constraint {
+
+/////////////////////////////////////////////////
+/// \brief Get the residual of a solution of a boxed LCP, A x = b + w, where
+/// each row has w = 0 between its bounds, w >= 0 at its lower bound and
+/// w <= 0 at its upper one. The rows of A are padded to a multiple of 4
+/// entries, as for the boxed LCP solvers of DART, and the bounds of rows
+/// with a friction index scale with the solution of that row.
+/// \param[in] _n Number of rows.
+/// \param[in] _A Matrix of the LCP.
+/// \param[in] _x Solution.
+/// \param[in] _b Vector of the LCP.
+/// \param[in] _lo Lower bounds.
+/// \param[in] _hi Upper bounds.
+/// \param[in] _findex Friction index of each row, or nullptr.
+/// \return Largest violation of the bounds or of the conditions on w.
+static double lcpResidual(int _n, const double *_A, const double *_x,
+                          const double *_b, const double *_lo,
+                          const double *_hi, const int *_findex)
+{
+  const int nSkip = (_n > 1) ? (((_n - 1) | 3) + 1) : _n;
+  double residual = 0.0;
+  for (int i = 0; i < _n; ++i)
+  {
+    double lo = _lo[i];
+    double hi = _hi[i];
+    if (_findex && _findex[i] >= 0)
+    {
+      hi = std::abs(hi * _x[_findex[i]]);
+      lo = -hi;
+    }
+
+    double w = -_b[i];
+    for (int j = 0; j < _n; ++j)
+      w += _A[i * nSkip + j] * _x[j];
+
+    double error = std::max({0.0, lo - _x[i], _x[i] - hi});
+    if (_x[i] <= lo)
+      error = std::max(error, -w);
+    else if (_x[i] >= hi)
+      error = std::max(error, w);
+    else
+      error = std::max(error, std::abs(w));
+    residual = std::max(residual, error);
+  }
+  return residual;
+}
+
+/////////////////////////////////////////////////
+/// \brief Boxed LCP solver that starts another solver from a given seed
+/// and keeps its solution. BoxedLcpConstraintSolver sets the start of the
+/// contact rows to zero right before it solves, so this is the only place
+/// to put the seed in. It also counts the LCPs for the statistics of
+/// GzContactConstraintSolver.
+class GzWarmStartLcpSolver : public BoxedLcpSolver
+{
+  /// \brief Constructor
+  /// \param[in] _seed Start of the LCP, used if it has the size of the LCP.
+  /// \param[out] _result Solution of the LCP.
+  /// \param[in] _fallback Whether this wraps the secondary solver, which
+  /// only runs after the primary one failed.
+  public: GzWarmStartLcpSolver(const Eigen::VectorXd &_seed,
+                               Eigen::VectorXd &_result, bool _fallback)
+    : seed(_seed), result(_result), fallback(_fallback)
+  {
+  }
+
+  // Documentation inherited
+  public: const std::string &getType() const override
+  {
+    return this->solver->getType();
+  }
+
+  // Documentation inherited
+  public: bool solve(int _n, double *_A, double *_x, double *_b, int _nub,
+                     double *_lo, double *_hi, int *_findex,
+                     bool _earlyTermination) override
+  {
+    if (this->seed.size() == _n)
+      Eigen::Map<Eigen::VectorXd>(_x, _n) = this->seed;
+
+    // The solvers overwrite the matrix and the bounds
+    if (this->statistics)
+    {
+      const int nSkip = (_n > 1) ? (((_n - 1) | 3) + 1) : _n;
+      this->a.assign(_A, _A + _n * nSkip);
+      this->b.assign(_b, _b + _n);
+      this->lo.assign(_lo, _lo + _n);
+      this->hi.assign(_hi, _hi + _n);
+    }
+
+    const bool success = this->solver->solve(
+        _n, _A, _x, _b, _nub, _lo, _hi, _findex, _earlyTermination);
+
+    // The secondary solver runs after a failure of the primary one, so the
+    // last solution kept is the one that is applied.
+    this->result = Eigen::Map<const Eigen::VectorXd>(_x, _n);
+
+    if (this->statistics)
+    {
+      if (this->fallback)
+        ++this->statistics->fallbackCount;
+      else
+        ++this->statistics->solveCount;
+      *this->residual = lcpResidual(_n, this->a.data(), _x, this->b.data(),
+          this->lo.data(), this->hi.data(), _findex);
+    }
+    return success;
+  }
+
+#ifndef NDEBUG
+  // Documentation inherited
+  public: bool canSolve(int _n, const double *_A) override
+  {
+    return this->solver->canSolve(_n, _A);
+  }
+#endif
+
+  /// \brief Solver that is started from the seed.
+  public: BoxedLcpSolverPtr solver;
+
+  /// \brief Statistics to count the LCPs in, or nullptr to not collect
+  /// them.
+  public: GzContactConstraintSolver::Statistics *statistics = nullptr;
+
+  /// \brief Residual of the last solution, written if statistics is set.
+  public: double *residual = nullptr;
+
+  /// \brief Start of the LCP.
+  private: const Eigen::VectorXd &seed;
+
+  /// \brief Solution of the LCP.
+  private: Eigen::VectorXd &result;
+
+  /// \brief Whether this wraps the secondary solver.
+  private: bool fallback;
+
+  /// \brief Copies of the matrix, vector and bounds of the LCP, kept to
+  /// measure the residual.
+  private: std::vector<double> a, b, lo, hi;
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the friction coefficient of a shape.
+/// \param[in] _shapeFrame The shape.
+/// \return Friction coefficient, 1 if the shape has none.
+static double frictionOf(const dynamics::ShapeFrame *_shapeFrame)
+{
+  const auto *shapeNode = _shapeFrame->asShapeNode();
+  const auto *aspect = shapeNode ? shapeNode->getDynamicsAspect() : nullptr;
+  return aspect ? aspect->getFrictionCoeff() : 1.0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the body of a shape.
+/// \param[in] _shapeFrame The shape.
+/// \return Body of the shape, or nullptr if it is not a shape node.
+static dynamics::BodyNode *bodyOf(const dynamics::ShapeFrame *_shapeFrame)
+{
+  const auto *shapeNode = _shapeFrame->asShapeNode();
+  if (!shapeNode)
+    return nullptr;
+
+  // Impulses are applied to bodies during the solve, as by the constraints
+  return const_cast<dynamics::BodyNode *>(
+      shapeNode->getBodyNodePtr().get());
+}
+
+/////////////////////////////////////////////////
+GzContactConstraintSolver::GzContactConstraintSolver()
+  : BoxedLcpConstraintSolver(),
+    primary(std::make_shared<GzWarmStartLcpSolver>(
+        this->seed, this->result, false)),
+    secondary(std::make_shared<GzWarmStartLcpSolver>(
+        this->seed, this->result, true))
+{
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::SetWarmStarting(bool _warmStarting)
+{
+  this->warmStarting = _warmStarting;
+  this->cache.clear();
+  this->stepContacts.clear();
+  this->stepContactIndex.clear();
+}
+
+/////////////////////////////////////////////////
+bool GzContactConstraintSolver::GetWarmStarting() const
+{
+  return this->warmStarting;
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::SetPenaltyContact(
+    double _stiffness, double _damping)
+{
+  this->penaltyStiffness = std::max(0.0, _stiffness);
+  this->penaltyDamping = std::max(0.0, _damping);
+}
+
+/////////////////////////////////////////////////
+double GzContactConstraintSolver::GetPenaltyStiffness() const
+{
+  return this->penaltyStiffness;
+}
+
+/////////////////////////////////////////////////
+double GzContactConstraintSolver::GetPenaltyDamping() const
+{
+  return this->penaltyDamping;
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::SetStatisticsEnabled(bool _enable)
+{
+  this->statisticsEnabled = _enable;
+  this->statistics = Statistics();
+}
+
+/////////////////////////////////////////////////
+bool GzContactConstraintSolver::GetStatisticsEnabled() const
+{
+  return this->statisticsEnabled;
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::ResetStatistics()
+{
+  this->statistics = Statistics();
+}
+
+/////////////////////////////////////////////////
+auto GzContactConstraintSolver::GetStatistics() const -> const Statistics &
+{
+  return this->statistics;
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::MergeStatistics(
+    GzContactConstraintSolver &_other)
+{
+  const Statistics &other = _other.statistics;
+  this->statistics.solveCount += other.solveCount;
+  this->statistics.iterations =
+      std::max(this->statistics.iterations, other.iterations);
+  this->statistics.residual =
+      std::max(this->statistics.residual, other.residual);
+  this->statistics.contactRowCount += other.contactRowCount;
+  this->statistics.jointRowCount += other.jointRowCount;
+  this->statistics.fallbackCount += other.fallbackCount;
+  this->statistics.failureCount += other.failureCount;
+  _other.statistics = Statistics();
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::solveConstrainedGroup(
+    ConstrainedGroup &_group)
+{
+  this->PrepareContacts(_group);
+  this->SolveGroup(_group, *this);
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::PrepareContacts(
+    const ConstrainedGroup &_group)
+{
+  // ConstraintSolver hands the groups of a step over in the order they are
+  // stored, so the first one starts a new step.
+  if ((!this->warmStarting && this->penaltyStiffness <= 0.0) ||
+      this->mConstrainedGroups.empty() ||
+      &_group != &this->mConstrainedGroups.front())
+  {
+    return;
+  }
+
+  this->cache.clear();
+  for (const StepContact &contact : this->stepContacts)
+  {
+    if (this->warmStarting && contact.dimension > 0u)
+    {
+      this->cache[contact.shapes].push_back(
+          {contact.point, contact.force, contact.dimension});
+    }
+  }
+  this->stepContacts.clear();
+  this->stepContactIndex.clear();
+
+  // ConstraintSolver makes one contact constraint for every contact of the
+  // collision result with a valid normal, in the same order. Skip the step
+  // if that does not hold, e.g. when there are soft contacts.
+  const auto &contacts = this->getLastCollisionResult().getContacts();
+  std::size_t numContacts = 0u;
+  for (const auto &contact : contacts)
+  {
+    if (!collision::Contact::isZeroNormal(contact.normal))
+      ++numContacts;
+  }
+  if (numContacts != this->mContactConstraints.size())
+    return;
+
+  this->stepContacts.reserve(numContacts);
+  for (const auto &contact : contacts)
+  {
+    if (collision::Contact::isZeroNormal(contact.normal))
+      continue;
+
+    StepContact stepContact;
+    const auto *shape1 = contact.collisionObject1->getShapeFrame();
+    const auto *shape2 = contact.collisionObject2->getShapeFrame();
+    stepContact.contact = &contact;
+    stepContact.shapes = {shape1, shape2};
+    stepContact.friction = std::min(frictionOf(shape1), frictionOf(shape2));
+    stepContact.point = shape1->getWorldTransform().inverse() * contact.point;
+
+    const auto cached = this->cache.find(stepContact.shapes);
+    if (cached != this->cache.end())
+    {
+      double closest = kMatchDistance;
+      for (const CachedContact &previous : cached->second)
+      {
+        const double distance = (previous.point - stepContact.point).norm();
+        if (distance <= closest)
+        {
+          closest = distance;
+          stepContact.seed = previous.force;
+          stepContact.seedDimension = previous.dimension;
+        }
+      }
+    }
+
+    const std::size_t index = this->stepContacts.size();
+    this->stepContactIndex[this->mContactConstraints[index].get()] = index;
+    this->stepContacts.push_back(stepContact);
+  }
+
+  if (this->penaltyStiffness > 0.0)
+  {
+    std::map<ShapePair, std::size_t> pairContacts;
+    for (const StepContact &contact : this->stepContacts)
+      ++pairContacts[contact.shapes];
+    for (StepContact &contact : this->stepContacts)
+      contact.pairContacts = pairContacts[contact.shapes];
+  }
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::SolveGroup(
+    ConstrainedGroup &_group, GzContactConstraintSolver &_owner)
+{
+  if (_owner.penaltyStiffness <= 0.0 || _owner.stepContacts.empty())
+  {
+    this->SolveLcpGroup(_group, _owner);
+    return;
+  }
+
+  this->lcpGroup.removeAllConstraints();
+  for (std::size_t i = 0; i < _group.getNumConstraints(); ++i)
+  {
+    const auto constraint = _group.getConstraint(i);
+    const auto it = _owner.stepContactIndex.find(constraint.get());
+    if (it != _owner.stepContactIndex.end())
+      this->ApplyPenaltyContact(_owner.stepContacts[it->second], _owner);
+    else
+      this->lcpGroup.addConstraint(constraint);
+  }
+
+  if (this->lcpGroup.getNumConstraints() > 0u)
+    this->SolveLcpGroup(this->lcpGroup, _owner);
+  this->lcpGroup.removeAllConstraints();
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::CountRows(const ConstrainedGroup &_group)
+{
+  for (std::size_t i = 0; i < _group.getNumConstraints(); ++i)
+  {
+    const auto &constraint = _group.getConstraint(i);
+    const std::size_t dimension = constraint->getDimension();
+    if (dynamic_cast<const ContactConstraint *>(constraint.get()) ||
+        dynamic_cast<const SoftContactConstraint *>(constraint.get()))
+    {
+      this->statistics.contactRowCount += dimension;
+    }
+    else
+    {
+      this->statistics.jointRowCount += dimension;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::ApplyPenaltyContact(
+    const StepContact &_contact, const GzContactConstraintSolver &_owner)
+{
+  const collision::Contact &contact = *_contact.contact;
+  dynamics::BodyNode *bodies[2] = {bodyOf(_contact.shapes.first),
+                                   bodyOf(_contact.shapes.second)};
+  if (!bodies[0] || !bodies[1])
+    return;
+
+  // The normal points from the second body to the first one
+  Eigen::Vector3d offsets[2];
+  Eigen::Vector3d velocity = Eigen::Vector3d::Zero();
+  double inverseMass = 0.0;
+  for (int i = 0; i < 2; ++i)
+  {
+    offsets[i] = bodies[i]->getWorldTransform().inverse() * contact.point;
+    const Eigen::Vector3d v = bodies[i]->getLinearVelocity(offsets[i]);
+    velocity += (i == 0) ? v : Eigen::Vector3d(-v);
+    if (bodies[i]->isReactive() && bodies[i]->getMass() > 0.0)
+      inverseMass += 1.0 / bodies[i]->getMass();
+  }
+  if (inverseMass <= 0.0)
+    return;
+
+  const double timeStep = this->getTimeStep();
+  const double mass =
+      1.0 / (inverseMass * static_cast<double>(_contact.pairContacts));
+  const double stiffness =
+      std::min(_owner.penaltyStiffness, mass / (timeStep * timeStep));
+  const double damping = std::min(_owner.penaltyDamping, mass / timeStep);
+
+  const double normalVelocity = velocity.dot(contact.normal);
+  const double normalImpulse = timeStep * std::max(0.0,
+      stiffness * contact.penetrationDepth - damping * normalVelocity);
+  if (normalImpulse <= 0.0)
+    return;
+
+  Eigen::Vector3d impulse = normalImpulse * contact.normal;
+  const Eigen::Vector3d slipVelocity =
+      velocity - normalVelocity * contact.normal;
+  const double slip = slipVelocity.norm();
+  if (slip > 0.0)
+  {
+    impulse -= std::min(_contact.friction * normalImpulse, mass * slip) /
+        slip * slipVelocity;
+  }
+
+  for (int i = 0; i < 2; ++i)
+  {
+    if (!bodies[i]->isReactive())
+      continue;
+
+    bodies[i]->addConstraintImpulse(
+        (i == 0) ? impulse : Eigen::Vector3d(-impulse), offsets[i]);
+    bodies[i]->getSkeleton()->setImpulseApplied(true);
+  }
+}
+
+/////////////////////////////////////////////////
+void GzContactConstraintSolver::SolveLcpGroup(
+    ConstrainedGroup &_group, GzContactConstraintSolver &_owner)
+{
+  const std::size_t n = _group.getTotalDimension();
+  const bool warmStart =
+      _owner.warmStarting && !_owner.stepContacts.empty() && 0u != n;
+  const bool collect = _owner.statisticsEnabled && 0u != n;
+  if (!warmStart && !collect)
+  {
+    BoxedLcpConstraintSolver::solveConstrainedGroup(_group);
+    return;
+  }
+
+  // The rows of a group follow the order of its constraints, see
+  // BoxedLcpConstraintSolver::solveConstrainedGroup
+  const double timeStep = this->getTimeStep();
+  this->seed.resize(0);
+  this->result.resize(0);
+  std::size_t offset = 0u;
+  if (warmStart)
+  {
+    this->seed.setZero(static_cast<Eigen::Index>(n));
+    for (std::size_t i = 0; i < _group.getNumConstraints(); ++i)
+    {
+      const auto &constraint = _group.getConstraint(i);
+      const std::size_t dimension = constraint->getDimension();
+      const auto it = _owner.stepContactIndex.find(constraint.get());
+      if (it != _owner.stepContactIndex.end())
+      {
+        const StepContact &contact = _owner.stepContacts[it->second];
+        if (contact.seedDimension == dimension)
+        {
+          this->seed.segment(offset, dimension) =
+              contact.seed.head(dimension) * timeStep;
+        }
+      }
+      offset += dimension;
+    }
+  }
+
+  // Groups solved on worker solvers are counted in the statistics of the
+  // worker, see MergeStatistics
+  if (collect)
+    this->CountRows(_group);
+  Statistics *statistics = collect ? &this->statistics : nullptr;
+  this->lcpResidual = 0.0;
+
+  const BoxedLcpSolverPtr primarySolver = this->getBoxedLcpSolver();
+  const BoxedLcpSolverPtr secondarySolver =
+      this->getSecondaryBoxedLcpSolver();
+  this->primary->solver = primarySolver;
+  this->primary->statistics = statistics;
+  this->primary->residual = &this->lcpResidual;
+  this->setBoxedLcpSolver(this->primary);
+  if (secondarySolver)
+  {
+    this->secondary->solver = secondarySolver;
+    this->secondary->statistics = statistics;
+    this->secondary->residual = &this->lcpResidual;
+    this->setSecondaryBoxedLcpSolver(this->secondary);
+  }
+
+  BoxedLcpConstraintSolver::solveConstrainedGroup(_group);
+
+  this->setBoxedLcpSolver(primarySolver);
+  if (secondarySolver)
+    this->setSecondaryBoxedLcpSolver(secondarySolver);
+
+  // A solution with NaNs is thrown away by BoxedLcpConstraintSolver
+  const bool solved = this->result.size() == static_cast<Eigen::Index>(n) &&
+      !this->result.hasNaN();
+  if (collect)
+  {
+    if (solved)
+    {
+      this->statistics.residual =
+          std::max(this->statistics.residual, this->lcpResidual);
+    }
+    else
+    {
+      ++this->statistics.failureCount;
+    }
+  }
+
+  if (!solved || !warmStart)
+    return;
+
+  offset = 0u;
+  for (std::size_t i = 0; i < _group.getNumConstraints(); ++i)
+  {
+    const auto &constraint = _group.getConstraint(i);
+    const std::size_t dimension = constraint->getDimension();
+    const auto it = _owner.stepContactIndex.find(constraint.get());
+    if (it != _owner.stepContactIndex.end() && dimension <= 3u)
+    {
+      // Each contact belongs to a single group, so concurrent groups write
+      // to different contacts.
+      StepContact &contact = _owner.stepContacts[it->second];
+      contact.force.setZero();
+      contact.force.head(dimension) =
+          this->result.segment(offset, dimension) / timeStep;
+      contact.dimension = dimension;
+    }
+    offset += dimension;
+  }
+}
+
+}
+}
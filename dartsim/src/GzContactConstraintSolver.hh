@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DARTSIM_SRC_GZCONTACTCONSTRAINTSOLVER_HH_
+#define GZ_PHYSICS_DARTSIM_SRC_GZCONTACTCONSTRAINTSOLVER_HH_
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <dart/collision/Contact.hpp>
+#include <dart/constraint/BoxedLcpConstraintSolver.hpp>
+#include <dart/constraint/ConstrainedGroup.hpp>
+#include <dart/dynamics/ShapeFrame.hpp>
+
+#include <gz/physics/World.hh>
+
+namespace dart {
+namespace constraint {
+
+class GzWarmStartLcpSolver;
+
+/// \brief A boxed LCP constraint solver with two optional ways of handling
+/// contacts.
+///
+/// With warm starting, the LCP of every step starts from the contact
+/// impulses of the previous step. Contacts are matched across steps by the
+/// pair of shapes in contact and by the contact point, in the frame of the
+/// first shape, which has to be within kMatchDistance of the previous one.
+/// A matched contact starts from the force of its match, times the time
+/// step, so the seed follows changes of the time step. Only iterative boxed
+/// LCP solvers such as PGS use the start, Dantzig solves the LCP directly
+/// and ignores it.
+///
+/// With penalty contacts, contacts are left out of the LCP. Each one applies
+/// the impulse of a spring-damper along its normal, and of Coulomb friction
+/// that stops sliding within the step, computed from the velocities before
+/// the solve. The stiffness and damping are limited for light bodies, to
+/// the values at which the spring of a contact, shared among the contacts
+/// between the same shapes, would overshoot within a step. Only the other
+/// constraints of a group, if any, are solved as an LCP.
+///
+/// With statistics enabled, the solver counts the rows of the LCPs it
+/// solves and measures the residual of their solutions. The boxed LCP
+/// solvers of DART do not report their iterations.
+class GzContactConstraintSolver : public BoxedLcpConstraintSolver
+{
+  /// \brief Counters of the LCPs of a step.
+  public: using Statistics =
+      gz::physics::GetSolverStatisticsFeature::SolverStatistics;
+
+  /// \brief Constructor
+  public: GzContactConstraintSolver();
+
+  /// \brief Set whether the LCP starts from the impulses of the previous
+  /// step.
+  /// \param[in] _warmStarting True to warm start the LCP.
+  public: void SetWarmStarting(bool _warmStarting);
+
+  /// \brief Get whether the LCP starts from the impulses of the previous
+  /// step.
+  /// \return True if the LCP is warm started.
+  public: bool GetWarmStarting() const;
+
+  /// \brief Set the spring-damper of penalty contacts.
+  /// \param[in] _stiffness Stiffness in N/m. A value of 0 turns penalty
+  /// contacts off.
+  /// \param[in] _damping Damping in N s/m.
+  public: void SetPenaltyContact(double _stiffness, double _damping);
+
+  /// \brief Get the stiffness of penalty contacts.
+  /// \return Stiffness in N/m, 0 if penalty contacts are off.
+  public: double GetPenaltyStiffness() const;
+
+  /// \brief Get the damping of penalty contacts.
+  /// \return Damping in N s/m.
+  public: double GetPenaltyDamping() const;
+
+  /// \brief Set whether the solves collect statistics.
+  /// \param[in] _enable True to collect statistics.
+  public: void SetStatisticsEnabled(bool _enable);
+
+  /// \brief Get whether the solves collect statistics.
+  /// \return True if statistics are collected.
+  public: bool GetStatisticsEnabled() const;
+
+  /// \brief Reset the statistics, before a step.
+  public: void ResetStatistics();
+
+  /// \brief Get the statistics collected since the last reset. The
+  /// residual is the largest violation of the complementarity conditions
+  /// of the LCP, a velocity in m/s or rad/s.
+  /// \return Statistics.
+  public: const Statistics &GetStatistics() const;
+
+  /// \brief Largest distance, in meters, between the points of two contacts
+  /// of consecutive steps that are matched.
+  public: static constexpr double kMatchDistance = 0.01;
+
+  // Documentation inherited
+  protected: void solveConstrainedGroup(ConstrainedGroup &_group) override;
+
+  /// \brief Collect the contacts of the step and match them against the
+  /// previous step, if _group is the first group of the step. Does nothing
+  /// if neither warm starting nor penalty contacts are enabled.
+  /// \param[in] _group Group handed over by ConstraintSolver.
+  protected: void PrepareContacts(const ConstrainedGroup &_group);
+
+  /// \brief Solve a group, with the contacts collected by _owner. The group
+  /// may belong to another solver, so this can run on worker solvers
+  /// concurrently for different groups.
+  /// \param[in] _group Group to solve.
+  /// \param[in] _owner Solver that owns the group and its contacts.
+  protected: void SolveGroup(ConstrainedGroup &_group,
+                             GzContactConstraintSolver &_owner);
+
+  /// \brief Add the statistics of another solver, which solved groups of
+  /// this one, to those of this solver, and reset them.
+  /// \param[in] _other Solver whose statistics are added.
+  protected: void MergeStatistics(GzContactConstraintSolver &_other);
+
+  /// \brief Pair of shapes in contact.
+  private: using ShapePair = std::pair<const dynamics::ShapeFrame *,
+                                       const dynamics::ShapeFrame *>;
+
+  /// \brief Contact force of a step, kept for the next step.
+  private: struct CachedContact
+  {
+    /// \brief Contact point in the frame of the first shape.
+    Eigen::Vector3d point;
+
+    /// \brief Force of each row of the contact constraint.
+    Eigen::Vector3d force;
+
+    /// \brief Number of rows of the contact constraint.
+    std::size_t dimension;
+  };
+
+  /// \brief Contact of the current step.
+  private: struct StepContact
+  {
+    /// \brief Contact of the collision result of the step.
+    const collision::Contact *contact = nullptr;
+
+    /// \brief Shapes in contact.
+    ShapePair shapes;
+
+    /// \brief Number of contacts of the step between the same shapes.
+    std::size_t pairContacts = 1u;
+
+    /// \brief Friction coefficient of the shapes.
+    double friction = 0.0;
+
+    /// \brief Contact point in the frame of the first shape.
+    Eigen::Vector3d point;
+
+    /// \brief Force of the matched contact of the previous step.
+    Eigen::Vector3d seed = Eigen::Vector3d::Zero();
+
+    /// \brief Number of rows of the matched contact, or 0 if there is no
+    /// match.
+    std::size_t seedDimension = 0u;
+
+    /// \brief Force found by this step.
+    Eigen::Vector3d force = Eigen::Vector3d::Zero();
+
+    /// \brief Number of rows of the solved contact, or 0 if it was not
+    /// solved.
+    std::size_t dimension = 0u;
+  };
+
+  /// \brief Solve the LCP of a group, warm started from the contacts
+  /// matched by _owner.
+  /// \param[in] _group Group to solve.
+  /// \param[in] _owner Solver that owns the contacts.
+  private: void SolveLcpGroup(ConstrainedGroup &_group,
+                              GzContactConstraintSolver &_owner);
+
+  /// \brief Add the rows of the constraints of a group to the statistics.
+  /// \param[in] _group Group that is solved as an LCP.
+  private: void CountRows(const ConstrainedGroup &_group);
+
+  /// \brief Apply the impulse of a penalty contact to its bodies.
+  /// \param[in] _contact Contact of the step.
+  /// \param[in] _owner Solver that holds the spring-damper.
+  private: void ApplyPenaltyContact(const StepContact &_contact,
+                                    const GzContactConstraintSolver &_owner);
+
+  /// \brief Whether the LCP is warm started.
+  private: bool warmStarting = false;
+
+  /// \brief Stiffness of penalty contacts, 0 if they are off.
+  private: double penaltyStiffness = 0.0;
+
+  /// \brief Damping of penalty contacts.
+  private: double penaltyDamping = 0.0;
+
+  /// \brief Whether the solves collect statistics.
+  private: bool statisticsEnabled = false;
+
+  /// \brief Statistics collected since the last reset.
+  private: Statistics statistics;
+
+  /// \brief Residual of the last LCP solved.
+  private: double lcpResidual = 0.0;
+
+  /// \brief Constraints of the group being solved that are not penalty
+  /// contacts.
+  private: ConstrainedGroup lcpGroup;
+
+  /// \brief Contact forces of the previous step, by pair of shapes.
+  private: std::map<ShapePair, std::vector<CachedContact>> cache;
+
+  /// \brief Contacts of the current step.
+  private: std::vector<StepContact> stepContacts;
+
+  /// \brief Index into stepContacts of each contact constraint of the
+  /// current step.
+  private: std::unordered_map<const ConstraintBase *, std::size_t>
+      stepContactIndex;
+
+  /// \brief Start of the LCP of the group being solved.
+  private: Eigen::VectorXd seed;
+
+  /// \brief Solution of the LCP of the group being solved.
+  private: Eigen::VectorXd result;
+
+  /// \brief Wrapper of the primary boxed LCP solver, which copies the seed
+  /// in and the result out, and measures the residual.
+  private: std::shared_ptr<GzWarmStartLcpSolver> primary;
+
+  /// \brief Wrapper of the secondary boxed LCP solver.
+  private: std::shared_ptr<GzWarmStartLcpSolver> secondary;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifdef DART_HAS_CONTACT_SURFACE
+
+#include <dart/collision/CollisionObject.hpp>
+#include <dart/collision/Contact.hpp>
+
+#include "GzContactMaterialHandler.hh"
+
+using namespace dart;
+using namespace constraint;
+
+/////////////////////////////////////////////////
+/// \brief Whether the parameters of contacts on a shape node depend on its
+/// pose.
+/// \param[in] _shapeNode Shape node to check.
+/// \return True if the shape node has a first friction direction.
+static bool hasFrictionDirection(const dynamics::ShapeNode *_shapeNode)
+{
+  const auto *aspect = _shapeNode->getDynamicsAspect();
+  return aspect && !aspect->getFirstFrictionDirection().isZero();
+}
+
+/////////////////////////////////////////////////
+ContactSurfaceParams GzContactMaterialHandler::createParams(
+    const collision::Contact &_contact,
+    const std::size_t _numContactsOnCollisionObject) const
+{
+  const auto *shapeNode1 =
+      _contact.collisionObject1->getShapeFrame()->asShapeNode();
+  const auto *shapeNode2 =
+      _contact.collisionObject2->getShapeFrame()->asShapeNode();
+  if (!shapeNode1 || !shapeNode2)
+  {
+    return ContactSurfaceHandler::createParams(
+        _contact, _numContactsOnCollisionObject);
+  }
+
+  const Key key(shapeNode1, shapeNode2);
+  auto it = this->entries.find(key);
+  if (it != this->entries.end() &&
+      it->second.numContacts == _numContactsOnCollisionObject &&
+      it->second.shapeNode1.lock().get() == shapeNode1 &&
+      it->second.shapeNode2.lock().get() == shapeNode2)
+  {
+    return it->second.params;
+  }
+
+  auto params = ContactSurfaceHandler::createParams(
+      _contact, _numContactsOnCollisionObject);
+  if (hasFrictionDirection(shapeNode1) || hasFrictionDirection(shapeNode2))
+    return params;
+
+  // Drop the entries of removed shape nodes, once they could make up half of
+  // the cache.
+  if (this->entries.size() > 2u * this->sizeAfterPrune + 64u)
+  {
+    for (auto e = this->entries.begin(); e != this->entries.end();)
+    {
+      if (!e->second.shapeNode1.lock() || !e->second.shapeNode2.lock())
+        e = this->entries.erase(e);
+      else
+        ++e;
+    }
+    this->sizeAfterPrune = this->entries.size();
+  }
+
+  Entry &entry = this->entries[key];
+  entry.shapeNode1 = shapeNode1;
+  entry.shapeNode2 = shapeNode2;
+  entry.numContacts = _numContactsOnCollisionObject;
+  entry.params = params;
+  return params;
+}
+
+/////////////////////////////////////////////////
+void GzContactMaterialHandler::Clear()
+{
+  this->entries.clear();
+  this->sizeAfterPrune = 0u;
+}
+
+/////////////////////////////////////////////////
+std::size_t GzContactMaterialHandler::Size() const
+{
+  return this->entries.size();
+}
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DARTSIM_SRC_GZCONTACTMATERIALHANDLER_HH_
+#define GZ_PHYSICS_DARTSIM_SRC_GZCONTACTMATERIALHANDLER_HH_
+
+#ifdef DART_HAS_CONTACT_SURFACE
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include <dart/constraint/ContactSurface.hpp>
+#include <dart/dynamics/ShapeNode.hpp>
+
+namespace dart {
+namespace constraint {
+
+/// \brief A contact surface handler that caches the surface parameters of
+/// each pair of shape nodes.
+///
+/// The default handler of dart combines the friction, slip and restitution
+/// coefficients of the dynamics aspects of both shape nodes for every
+/// contact. This handler sits right above it and keeps the combined
+/// parameters of each pair, so later contacts of the pair are a single
+/// lookup. Pairs where one of the shape nodes has a first friction direction
+/// are not cached, since the direction follows the shape node.
+///
+/// The cache has to be cleared when the surface properties of a shape node
+/// change, see Clear(). Entries of removed shape nodes are detected and
+/// replaced, and dropped as the cache grows.
+class GzContactMaterialHandler : public ContactSurfaceHandler
+{
+  // Documentation inherited
+  public: ContactSurfaceParams createParams(
+    const collision::Contact &_contact,
+    std::size_t _numContactsOnCollisionObject) const override;
+
+  /// \brief Drop the parameters of all pairs.
+  public: void Clear();
+
+  /// \brief Get the number of cached pairs.
+  /// \return Number of pairs.
+  public: std::size_t Size() const;
+
+  /// \brief Shape nodes of a pair, in the order of the contact.
+  private: using Key =
+    std::pair<const dynamics::ShapeNode *, const dynamics::ShapeNode *>;
+
+  private: struct KeyHash
+  {
+    std::size_t operator()(const Key &_key) const
+    {
+      const std::size_t h1 = std::hash<const void *>()(_key.first);
+      const std::size_t h2 = std::hash<const void *>()(_key.second);
+      return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+    }
+  };
+
+  private: struct Entry
+  {
+    /// \brief Shape nodes of the pair, to detect entries of removed shape
+    /// nodes whose address was reused.
+    dynamics::WeakConstShapeNodePtr shapeNode1;
+    dynamics::WeakConstShapeNodePtr shapeNode2;
+
+    /// \brief Number of contacts that the parameters were created for.
+    std::size_t numContacts = 0u;
+
+    /// \brief Combined parameters of the pair.
+    ContactSurfaceParams params;
+  };
+
+  /// \brief Cached parameters by pair of shape nodes.
+  private: mutable std::unordered_map<Key, Entry, KeyHash> entries;
+
+  /// \brief Number of entries after entries of removed shape nodes were last
+  /// dropped.
+  private: mutable std::size_t sizeAfterPrune = 0u;
+};
+
+using GzContactMaterialHandlerPtr = std::shared_ptr<GzContactMaterialHandler>;
+
+}
+}
+
+#endif
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dart/constraint/DantzigBoxedLcpSolver.hpp>
+#include <dart/constraint/PgsBoxedLcpSolver.hpp>
+
+#include "GzIslandConstraintSolver.hh"
+
+using namespace dart;
+using namespace constraint;
+
+/////////////////////////////////////////////////
+/// \brief Copy a boxed LCP solver, so it can be used on another thread.
+/// \param[in] _solver Solver to copy.
+/// \param[in] _previous Copy made on an earlier step, reused if it has the
+/// same type.
+/// \param[out] _copy Copy of the solver, or nullptr if _solver is nullptr.
+/// \return False if solvers of this type can not be copied.
+static bool copyBoxedLcpSolver(
+    const BoxedLcpSolverPtr &_solver,
+    const BoxedLcpSolverPtr &_previous,
+    BoxedLcpSolverPtr &_copy)
+{
+  _copy = nullptr;
+  if (!_solver)
+    return true;
+
+  const auto &type = _solver->getType();
+  if (type == DantzigBoxedLcpSolver::getStaticType())
+  {
+    _copy = (_previous && _previous->getType() == type) ?
+        _previous : std::make_shared<DantzigBoxedLcpSolver>();
+    return true;
+  }
+
+  if (type == PgsBoxedLcpSolver::getStaticType())
+  {
+    auto pgs = std::dynamic_pointer_cast<PgsBoxedLcpSolver>(_previous);
+    if (!pgs)
+      pgs = std::make_shared<PgsBoxedLcpSolver>();
+    pgs->setOption(
+        std::static_pointer_cast<PgsBoxedLcpSolver>(_solver)->getOption());
+    _copy = pgs;
+    return true;
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+GzIslandConstraintSolver::GzIslandConstraintSolver()
+  : GzContactConstraintSolver(),
+    numThreads(std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+/////////////////////////////////////////////////
+void GzIslandConstraintSolver::SetNumThreads(std::size_t _numThreads)
+{
+  this->numThreads = std::max<std::size_t>(1u, _numThreads);
+  this->workerPool.reset();
+  this->workers.clear();
+}
+
+/////////////////////////////////////////////////
+std::size_t GzIslandConstraintSolver::GetNumThreads() const
+{
+  return this->numThreads;
+}
+
+/////////////////////////////////////////////////
+void GzIslandConstraintSolver::SetTaskScheduler(
+    std::shared_ptr<gz::physics::TaskScheduler> _scheduler)
+{
+  this->taskScheduler = std::move(_scheduler);
+  if (this->taskScheduler)
+    this->workerPool.reset();
+}
+
+/////////////////////////////////////////////////
+void GzIslandConstraintSolver::solveConstrainedGroup(
+    ConstrainedGroup &_group)
+{
+  this->PrepareContacts(_group);
+  if (this->numThreads <= 1u || this->mConstrainedGroups.size() < 2u)
+  {
+    this->SolveGroup(_group, *this);
+    return;
+  }
+
+  // ConstraintSolver hands the groups of a step over one at a time, in the
+  // order they are stored. Hold them back until the last one arrives.
+  this->pendingGroups.push_back(&_group);
+  if (&_group != &this->mConstrainedGroups.back())
+    return;
+
+  this->SolvePendingGroups();
+  this->pendingGroups.clear();
+}
+
+/////////////////////////////////////////////////
+void GzIslandConstraintSolver::SolvePendingGroups()
+{
+  const std::size_t numTasks =
+      std::min(this->numThreads, this->pendingGroups.size());
+
+  if (!this->UpdateWorkers(numTasks - 1u))
+  {
+    for (ConstrainedGroup *group : this->pendingGroups)
+      this->SolveGroup(*group, *this);
+    return;
+  }
+
+  // The cost of a group grows roughly with the cube of its size, so give
+  // the largest remaining group to the least loaded task.
+  std::vector<std::size_t> costs(this->pendingGroups.size());
+  for (std::size_t i = 0; i < costs.size(); ++i)
+  {
+    const std::size_t n = this->pendingGroups[i]->getNumConstraints();
+    costs[i] = n * n * n;
+  }
+
+  std::vector<std::size_t> order(costs.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+      [&costs](std::size_t _a, std::size_t _b)
+      {
+        return costs[_a] > costs[_b];
+      });
+
+  std::vector<std::vector<ConstrainedGroup *>> taskGroups(numTasks);
+  std::vector<std::size_t> loads(numTasks, 0u);
+  for (const std::size_t i : order)
+  {
+    const std::size_t task = static_cast<std::size_t>(
+        std::min_element(loads.begin(), loads.end()) - loads.begin());
+    taskGroups[task].push_back(this->pendingGroups[i]);
+    loads[task] += costs[i];
+  }
+
+  auto solveTask = [this, &taskGroups](std::size_t _task)
+  {
+    GzIslandConstraintSolver *solver =
+        (_task == 0u) ? this : this->workers[_task - 1u].get();
+    for (ConstrainedGroup *group : taskGroups[_task])
+      solver->SolveGroup(*group, *this);
+  };
+
+  if (this->taskScheduler)
+  {
+    this->taskScheduler->Run(numTasks, solveTask);
+  }
+  else
+  {
+    if (!this->workerPool)
+    {
+      this->workerPool = std::make_unique<gz::common::WorkerPool>(
+          static_cast<unsigned int>(this->numThreads));
+    }
+
+    for (std::size_t t = 0; t < numTasks; ++t)
+      this->workerPool->AddWork([&solveTask, t]() { solveTask(t); });
+    this->workerPool->WaitForResults();
+  }
+
+  for (std::size_t t = 1; t < numTasks; ++t)
+    this->MergeStatistics(*this->workers[t - 1u]);
+}
+
+/////////////////////////////////////////////////
+bool GzIslandConstraintSolver::UpdateWorkers(std::size_t _numWorkers)
+{
+  if (this->workers.size() < _numWorkers)
+    this->workers.resize(_numWorkers);
+
+  for (std::size_t i = 0; i < _numWorkers; ++i)
+  {
+    auto &worker = this->workers[i];
+    if (!worker)
+    {
+      worker = std::make_unique<GzIslandConstraintSolver>();
+      worker->SetNumThreads(1u);
+    }
+
+    BoxedLcpSolverPtr primary;
+    BoxedLcpSolverPtr secondary;
+    if (!copyBoxedLcpSolver(this->getBoxedLcpSolver(),
+            worker->getBoxedLcpSolver(), primary) ||
+        !copyBoxedLcpSolver(this->getSecondaryBoxedLcpSolver(),
+            worker->getSecondaryBoxedLcpSolver(), secondary))
+    {
+      return false;
+    }
+
+    worker->setBoxedLcpSolver(primary);
+    worker->setSecondaryBoxedLcpSolver(secondary);
+    worker->setTimeStep(this->getTimeStep());
+  }
+
+  return true;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DARTSIM_SRC_GZISLANDCONSTRAINTSOLVER_HH_
+#define GZ_PHYSICS_DARTSIM_SRC_GZISLANDCONSTRAINTSOLVER_HH_
+
+#include <memory>
+#include <vector>
+
+#include <dart/constraint/ConstrainedGroup.hpp>
+
+#include <gz/common/WorkerPool.hh>
+#include <gz/physics/TaskScheduler.hh>
+
+#include "GzContactConstraintSolver.hh"
+
+namespace dart {
+namespace constraint {
+
+/// \brief A boxed LCP constraint solver that solves independent constraint
+/// islands on multiple threads.
+///
+/// Every step, ConstraintSolver partitions the skeletons into constrained
+/// groups that share no constraints with each other. This solver collects
+/// the groups of a step and solves them concurrently on a thread pool. The
+/// groups are dealt out to one task per thread, largest first, and every
+/// task uses a private copy of the boxed LCP solvers, since their scratch
+/// buffers can not be shared. The impulses of each group only depend on the
+/// constraints of that group, so results match the serial solver.
+///
+/// Steps with a single group, and boxed LCP solvers other than Dantzig and
+/// PGS, use the serial implementation. Warm starting and penalty contacts,
+/// see GzContactConstraintSolver, work the same on either path.
+class GzIslandConstraintSolver : public GzContactConstraintSolver
+{
+  /// \brief Constructor
+  public: GzIslandConstraintSolver();
+
+  /// \brief Set the number of threads used to solve the islands.
+  /// \param[in] _numThreads Number of threads. A value of 0 or 1 solves the
+  /// islands serially.
+  public: void SetNumThreads(std::size_t _numThreads);
+
+  /// \brief Get the number of threads used to solve the islands.
+  /// \return Number of threads.
+  public: std::size_t GetNumThreads() const;
+
+  /// \brief Set the scheduler that runs the tasks of the islands.
+  /// \param[in] _scheduler Scheduler, or nullptr to use a thread pool of
+  /// this solver. The number of threads still sets the number of tasks.
+  public: void SetTaskScheduler(
+      std::shared_ptr<gz::physics::TaskScheduler> _scheduler);
+
+  // Documentation inherited
+  protected: void solveConstrainedGroup(ConstrainedGroup &_group) override;
+
+  /// \brief Solve the groups collected during this step concurrently.
+  private: void SolvePendingGroups();
+
+  /// \brief Make sure there is a worker solver, using copies of the boxed
+  /// LCP solvers of this solver, for every task but the first.
+  /// \param[in] _numWorkers Number of worker solvers needed.
+  /// \return False if the boxed LCP solvers can not be copied.
+  private: bool UpdateWorkers(std::size_t _numWorkers);
+
+  /// \brief Number of threads used to solve the islands.
+  private: std::size_t numThreads;
+
+  /// \brief Groups handed over so far in this step.
+  private: std::vector<ConstrainedGroup *> pendingGroups;
+
+  /// \brief Solvers owning the scratch buffers of the second and later
+  /// tasks. The first task uses this solver.
+  private: std::vector<std::unique_ptr<GzIslandConstraintSolver>> workers;
+
+  /// \brief Thread pool running the tasks without a task scheduler.
+  /// Created on first use.
+  private: std::unique_ptr<gz::common::WorkerPool> workerPool;
+
+  /// \brief Scheduler running the tasks, or nullptr to use workerPool.
+  private: std::shared_ptr<gz::physics::TaskScheduler> taskScheduler;
+};
+
+}
+}
+
+#endif
@@ -15,10 +15,24 @@
  *
 */
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 
+#include <dart/collision/CollisionGroup.hpp>
 #include <dart/collision/CollisionObject.hpp>
+#include <dart/collision/ode/OdeCollisionObject.hpp>
+#include <dart/dynamics/BoxShape.hpp>
+#include <dart/dynamics/ShapeFrame.hpp>
+
+#include <ode/ode.h>
+
+#include <gz/physics/AllocationCounter.hh>
 
 #include "GzOdeCollisionDetector.hh"
 
@@ -45,14 +59,36 @@ std::shared_ptr<GzOdeCollisionDetector> GzOdeCollisionDetector::create()
   return std::shared_ptr<GzOdeCollisionDetector>(new GzOdeCollisionDetector());
 }
 
+/////////////////////////////////////////////////
+std::shared_ptr<CollisionDetector>
+GzOdeCollisionDetector::cloneWithoutCollisionObjects() const
+{
+  auto clone = GzOdeCollisionDetector::create();
+  clone->SetCollisionPairMaxContacts(this->GetCollisionPairMaxContacts());
+  clone->SetCollisionPairContactSelection(
+      this->GetCollisionPairContactSelection());
+  return clone;
+}
+
 /////////////////////////////////////////////////
 bool GzOdeCollisionDetector::collide(
     CollisionGroup *_group,
     const CollisionOption &_option,
     CollisionResult *_result)
 {
-  bool ret = OdeCollisionDetector::collide(_group, _option, _result);
+  const auto start = std::chrono::steady_clock::now();
+  const std::size_t startAllocations = gz::physics::AllocationCount();
+  CollisionOption maskedOption;
+  const bool masked =
+      this->ApplyCollisionMasks(_group, _option, maskedOption);
+  this->ApplyPlaneBits(_group, nullptr, _option);
+  bool ret = masked ?
+      OdeCollisionDetector::collide(_group, maskedOption, _result) :
+      OdeCollisionDetector::collide(_group, _option, _result);
   this->LimitCollisionPairMaxContacts(_result);
+  this->collideTime += std::chrono::steady_clock::now() - start;
+  this->collideAllocations +=
+      gz::physics::AllocationCount() - startAllocations;
   return ret;
 }
 
@@ -63,11 +99,278 @@ bool GzOdeCollisionDetector::collide(
     const CollisionOption &_option,
     CollisionResult *_result)
 {
-  bool ret = OdeCollisionDetector::collide(_group1, _group2, _option, _result);
+  const auto start = std::chrono::steady_clock::now();
+  const std::size_t startAllocations = gz::physics::AllocationCount();
+  CollisionOption maskedOption;
+  const bool masked =
+      this->ApplyCollisionMasks(_group1, _option, maskedOption) &&
+      this->ApplyCollisionMasks(_group2, _option, maskedOption);
+  this->ApplyPlaneBits(_group1, _group2, _option);
+  bool ret = masked ?
+      OdeCollisionDetector::collide(_group1, _group2, maskedOption, _result) :
+      OdeCollisionDetector::collide(_group1, _group2, _option, _result);
   this->LimitCollisionPairMaxContacts(_result);
+  this->collideTime += std::chrono::steady_clock::now() - start;
+  this->collideAllocations +=
+      gz::physics::AllocationCount() - startAllocations;
   return ret;
 }
 
+/////////////////////////////////////////////////
+bool GzOdeCollisionDetector::MaskedFilter::ignoresCollision(
+    const CollisionObject *_object1, const CollisionObject *_object2) const
+{
+  return this->filter->IgnoresCollisionWithoutMasks(_object1, _object2);
+}
+
+/////////////////////////////////////////////////
+bool GzOdeCollisionDetector::ApplyCollisionMasks(CollisionGroup *_group,
+    const CollisionOption &_option, CollisionOption &_maskedOption)
+{
+  const auto *filter =
+      dynamic_cast<const gz::physics::dartsim::BitmaskContactFilter *>(
+          _option.collisionFilter.get());
+  if (nullptr == filter)
+    return false;
+
+  // Sync the group with the skeletons it is subscribed to, so that all of
+  // its shape frames have their collision objects.
+  if (_group->getAutomaticUpdate())
+    _group->update();
+
+  auto &masked = this->maskedGroups[_group];
+  const std::size_t numShapeFrames = _group->getNumShapeFrames();
+  bool changed = masked.filter != filter ||
+      masked.version != filter->Version() ||
+      masked.shapeFrames.size() != numShapeFrames;
+  for (std::size_t i = 0; !changed && i < numShapeFrames; ++i)
+  {
+    changed = masked.shapeFrames[i] != _group->getShapeFrame(i) ||
+        masked.objects[i].expired();
+  }
+
+  if (changed)
+  {
+    masked.filter = filter;
+    masked.version = filter->Version();
+    masked.shapeFrames.resize(numShapeFrames);
+    masked.objects.resize(numShapeFrames);
+    for (std::size_t i = 0; i < numShapeFrames; ++i)
+    {
+      const auto *shapeFrame = _group->getShapeFrame(i);
+      // The objects are shared by the groups of this detector, so this
+      // returns the object of the group.
+      const auto object = this->claimCollisionObject(shapeFrame);
+      masked.shapeFrames[i] = shapeFrame;
+      masked.objects[i] = object;
+
+      // ODE skips a pair unless the category bits of one geom share a bit
+      // with the collide bits of the other. Geoms with a mask carry a
+      // category bit above the 16 bits of the masks, so they still collide
+      // with the geoms without a mask, which keep all their bits set, like
+      // the filter does.
+      const dGeomID geom =
+          static_cast<OdeCollisionObject *>(object.get())->getOdeGeomId();
+      uint16_t mask = 0u;
+      const auto *shapeNode = shapeFrame->asShapeNode();
+      if (nullptr != shapeNode && filter->FindMask(shapeNode, mask))
+      {
+        dGeomSetCategoryBits(
+            geom, static_cast<unsigned long>(mask) | 0x10000ul);
+        dGeomSetCollideBits(geom, mask);
+      }
+      else
+      {
+        dGeomSetCategoryBits(geom, ~0ul);
+        dGeomSetCollideBits(geom, ~0ul);
+      }
+    }
+  }
+
+  this->maskedFilter->filter = filter;
+  _maskedOption = _option;
+  _maskedOption.collisionFilter = this->maskedFilter;
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Category bit of the plane boxes, above the category bit of the
+/// geoms with a mask, see ApplyCollisionMasks.
+static constexpr unsigned long kPlaneBit = 0x20000ul;
+
+/////////////////////////////////////////////////
+/// \brief Check whether a shape is the box of an infinite plane.
+/// \param[in] _shape Shape.
+/// \return True if the shape is a box of
+/// GzOdeCollisionDetector::kPlaneBoxSize.
+static bool IsPlaneBox(const dynamics::Shape *_shape)
+{
+  const auto *box = dynamic_cast<const dynamics::BoxShape *>(_shape);
+  return nullptr != box &&
+      box->getSize().minCoeff() >= GzOdeCollisionDetector::kPlaneBoxSize;
+}
+
+/////////////////////////////////////////////////
+void GzOdeCollisionDetector::ApplyPlaneBits(CollisionGroup *_group1,
+    CollisionGroup *_group2, const CollisionOption &_option)
+{
+  const auto *filter =
+      dynamic_cast<const gz::physics::dartsim::BitmaskContactFilter *>(
+          _option.collisionFilter.get());
+
+  this->queryPlanes.clear();
+  std::array<PlaneGroup *, 2> groups{nullptr, nullptr};
+  for (std::size_t g = 0; g < groups.size(); ++g)
+  {
+    CollisionGroup *group = g == 0 ? _group1 : _group2;
+    if (nullptr == group || (g == 1 && _group2 == _group1))
+      continue;
+
+    if (group->getAutomaticUpdate())
+      group->update();
+
+    const std::size_t numShapeFrames = group->getNumShapeFrames();
+    auto it = this->planeGroups.find(group);
+    if (it == this->planeGroups.end())
+    {
+      // Groups are only tracked once they have a plane box
+      bool hasPlane = false;
+      for (std::size_t i = 0; !hasPlane && i < numShapeFrames; ++i)
+        hasPlane = IsPlaneBox(group->getShapeFrame(i)->getShape().get());
+      if (!hasPlane)
+        continue;
+      it = this->planeGroups.emplace(group, PlaneGroup()).first;
+    }
+
+    PlaneGroup &planeGroup = it->second;
+    bool changed = planeGroup.filter != filter ||
+        (filter && planeGroup.version != filter->Version()) ||
+        planeGroup.shapeFrames.size() != numShapeFrames;
+    for (std::size_t i = 0; !changed && i < numShapeFrames; ++i)
+    {
+      const auto *shapeFrame = group->getShapeFrame(i);
+      changed = planeGroup.shapeFrames[i] != shapeFrame ||
+          planeGroup.shapes[i] != shapeFrame->getShape().get() ||
+          planeGroup.objects[i].expired();
+    }
+
+    if (changed)
+    {
+      planeGroup.filter = filter;
+      planeGroup.version = filter ? filter->Version() : 0u;
+      planeGroup.shapeFrames.resize(numShapeFrames);
+      planeGroup.shapes.resize(numShapeFrames);
+      planeGroup.objects.resize(numShapeFrames);
+      planeGroup.geoms.resize(numShapeFrames);
+      planeGroup.collideBits.resize(numShapeFrames);
+      planeGroup.masks.resize(numShapeFrames);
+      planeGroup.planes.clear();
+      for (std::size_t i = 0; i < numShapeFrames; ++i)
+      {
+        const auto *shapeFrame = group->getShapeFrame(i);
+        const auto object = this->claimCollisionObject(shapeFrame);
+        const dGeomID geom =
+            static_cast<OdeCollisionObject *>(object.get())->getOdeGeomId();
+        planeGroup.shapeFrames[i] = shapeFrame;
+        planeGroup.shapes[i] = shapeFrame->getShape().get();
+        planeGroup.objects[i] = object;
+        planeGroup.geoms[i] = geom;
+
+        // Same bits as ApplyCollisionMasks, or all of them without masks
+        uint16_t mask = 0u;
+        const auto *shapeNode = shapeFrame->asShapeNode();
+        const bool hasMask = nullptr != filter && nullptr != shapeNode &&
+            filter->FindMask(shapeNode, mask);
+        planeGroup.masks[i] = hasMask ? static_cast<int32_t>(mask) : -1;
+        planeGroup.collideBits[i] = hasMask ? mask : ~0ul;
+        if (IsPlaneBox(planeGroup.shapes[i]))
+        {
+          planeGroup.planes.push_back(i);
+          dGeomSetCategoryBits(geom, kPlaneBit);
+          dGeomSetCollideBits(geom, 0ul);
+        }
+        else
+        {
+          dGeomSetCategoryBits(geom, hasMask ?
+              static_cast<unsigned long>(mask) | 0x10000ul : ~0ul);
+          dGeomSetCollideBits(geom, planeGroup.collideBits[i]);
+        }
+      }
+    }
+
+    groups[g] = &planeGroup;
+    for (const std::size_t i : planeGroup.planes)
+    {
+      const Eigen::Isometry3d &tf =
+          planeGroup.shapeFrames[i]->getWorldTransform();
+      const Eigen::Vector3d normal = tf.linear().col(2);
+      const double halfSize = 0.5 * static_cast<const dynamics::BoxShape *>(
+          planeGroup.shapes[i])->getSize().z();
+      this->queryPlanes.push_back(
+          {normal, normal.dot(tf.translation()) + halfSize,
+           planeGroup.masks[i]});
+    }
+  }
+
+  for (PlaneGroup *planeGroup : groups)
+  {
+    if (nullptr == planeGroup)
+      continue;
+
+    const std::size_t numPlanes = planeGroup->planes.size();
+    for (std::size_t i = 0, p = 0; i < planeGroup->shapeFrames.size(); ++i)
+    {
+      if (p < numPlanes && planeGroup->planes[p] == i)
+      {
+        ++p;
+        continue;
+      }
+
+      // Lowest point of the bounding box of the shape along each normal
+      const Eigen::Isometry3d &tf =
+          planeGroup->shapeFrames[i]->getWorldTransform();
+      const auto &box = planeGroup->shapes[i]->getBoundingBox();
+      const Eigen::Vector3d center = tf * (0.5 * (box.getMin() + box.getMax()));
+      const Eigen::Vector3d halfExtents = 0.5 * (box.getMax() - box.getMin());
+      const int32_t mask = planeGroup->masks[i];
+      bool reaches = false;
+      for (std::size_t k = 0; !reaches && k < this->queryPlanes.size(); ++k)
+      {
+        const WorldPlane &plane = this->queryPlanes[k];
+        if (mask >= 0 && plane.mask >= 0 && (mask & plane.mask) == 0)
+          continue;
+        const double lowest = plane.normal.dot(center) -
+            (tf.linear().transpose() * plane.normal).cwiseAbs().dot(
+                halfExtents);
+        reaches = lowest <= plane.offset;
+      }
+
+      const unsigned long bits = planeGroup->collideBits[i];
+      dGeomSetCollideBits(planeGroup->geoms[i],
+          reaches ? bits | kPlaneBit : bits & ~kPlaneBit);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+double GzOdeCollisionDetector::GetCollideTime() const
+{
+  return std::chrono::duration<double>(this->collideTime).count();
+}
+
+/////////////////////////////////////////////////
+std::size_t GzOdeCollisionDetector::GetCollideAllocations() const
+{
+  return this->collideAllocations;
+}
+
+/////////////////////////////////////////////////
+void GzOdeCollisionDetector::ResetCollideTime()
+{
+  this->collideTime = std::chrono::steady_clock::duration::zero();
+  this->collideAllocations = 0u;
+}
+
 /////////////////////////////////////////////////
 void GzOdeCollisionDetector::SetCollisionPairMaxContacts(
     std::size_t _maxContacts)
@@ -81,6 +384,29 @@ std::size_t GzOdeCollisionDetector::GetCollisionPairMaxContacts() const
   return this->maxCollisionPairContacts;
 }
 
+/////////////////////////////////////////////////
+void GzOdeCollisionDetector::SetCollisionPairContactSelection(
+    ContactSelection _selection)
+{
+  this->contactSelection = _selection;
+}
+
+/////////////////////////////////////////////////
+GzOdeCollisionDetector::ContactSelection
+GzOdeCollisionDetector::GetCollisionPairContactSelection() const
+{
+  return this->contactSelection;
+}
+
+/////////////////////////////////////////////////
+std::size_t GzOdeCollisionDetector::PairHash::operator()(
+    const std::pair<CollisionObject *, CollisionObject *> &_pair) const
+{
+  const std::size_t h1 = std::hash<CollisionObject *>()(_pair.first);
+  const std::size_t h2 = std::hash<CollisionObject *>()(_pair.second);
+  return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
+}
+
 /////////////////////////////////////////////////
 void GzOdeCollisionDetector::LimitCollisionPairMaxContacts(
     CollisionResult *_result)
@@ -89,24 +415,148 @@ void GzOdeCollisionDetector::LimitCollisionPairMaxContacts(
     std::numeric_limits<std::size_t>::max())
     return;
 
-  auto allContacts = _result->getContacts();
+  if (nullptr == _result)
+    return;
+
+  // No pair can be over the limit if the whole result is within it.
+  const std::size_t numContacts = _result->getNumContacts();
+  if (numContacts <= this->maxCollisionPairContacts)
+    return;
+
+  // Give every unordered pair of objects a dense slot and count its contacts.
+  this->pairSlots.clear();
+  this->slotOffsets.clear();
+  this->contactSlots.resize(numContacts);
+  bool overLimit = false;
+  for (std::size_t i = 0; i < numContacts; ++i)
+  {
+    const auto &contact = _result->getContact(i);
+    std::pair<CollisionObject *, CollisionObject *> key(
+        contact.collisionObject1, contact.collisionObject2);
+    if (std::less<CollisionObject *>()(key.second, key.first))
+      std::swap(key.first, key.second);
+
+    const auto inserted =
+        this->pairSlots.emplace(key, this->slotOffsets.size());
+    if (inserted.second)
+      this->slotOffsets.push_back(0u);
+
+    const std::size_t slot = inserted.first->second;
+    this->contactSlots[i] = slot;
+    if (++this->slotOffsets[slot] > this->maxCollisionPairContacts)
+      overLimit = true;
+  }
+
+  if (!overLimit)
+    return;
+
+  // Turn the counts into offsets and group the contact indices by slot,
+  // keeping generation order within each slot.
+  const std::size_t numSlots = this->slotOffsets.size();
+  std::size_t offset = 0u;
+  for (std::size_t s = 0; s < numSlots; ++s)
+  {
+    const std::size_t count = this->slotOffsets[s];
+    this->slotOffsets[s] = offset;
+    offset += count;
+  }
+  this->slotOffsets.push_back(numContacts);
+
+  this->pairContacts.resize(numContacts);
+  for (std::size_t i = 0; i < numContacts; ++i)
+    this->pairContacts[this->slotOffsets[this->contactSlots[i]]++] = i;
+  // Each offset now points at the start of the next slot, shift them back.
+  for (std::size_t s = numSlots; s > 0; --s)
+    this->slotOffsets[s] = this->slotOffsets[s - 1];
+  this->slotOffsets[0] = 0u;
+
+  this->keep.assign(numContacts, 1);
+  for (std::size_t s = 0; s < numSlots; ++s)
+  {
+    const std::size_t begin = this->slotOffsets[s];
+    const std::size_t end = this->slotOffsets[s + 1];
+    if (end - begin > this->maxCollisionPairContacts)
+      this->SelectPairContacts(_result, begin, end);
+  }
+
+  // CollisionResult can only be cleared and appended to, so copy the kept
+  // contacts out into a reused buffer and add them back in order.
+  this->keptContacts.clear();
+  for (std::size_t i = 0; i < numContacts; ++i)
+  {
+    if (this->keep[i])
+      this->keptContacts.push_back(_result->getContact(i));
+  }
+
   _result->clear();
+  for (const auto &contact : this->keptContacts)
+    _result->addContact(contact);
+}
+
+/////////////////////////////////////////////////
+void GzOdeCollisionDetector::SelectPairContacts(
+    CollisionResult *_result, std::size_t _begin, std::size_t _end)
+{
+  const std::size_t maxContacts = this->maxCollisionPairContacts;
+  for (std::size_t i = _begin; i < _end; ++i)
+    this->keep[this->pairContacts[i]] = 0;
+
+  if (maxContacts == 0u)
+    return;
 
-  std::unordered_map<dart::collision::CollisionObject *,
-      std::unordered_map<dart::collision::CollisionObject *, std::size_t>>
-      contactMap;
+  auto first = this->pairContacts.begin() + _begin;
+  auto last = this->pairContacts.begin() + _end;
 
-  for (auto &contact : allContacts)
+  switch (this->contactSelection)
   {
-    auto &count =
-      contactMap[contact.collisionObject1][contact.collisionObject2];
-    count++;
-    auto &otherCount =
-      contactMap[contact.collisionObject2][contact.collisionObject1];
-    std::size_t total =  count + otherCount;
-    if (total <= this->maxCollisionPairContacts)
+    case ContactSelection::DEEPEST:
     {
-      _result->addContact(contact);
+      std::nth_element(first, first + (maxContacts - 1), last,
+          [&](std::size_t _a, std::size_t _b)
+          {
+            return _result->getContact(_a).penetrationDepth >
+                   _result->getContact(_b).penetrationDepth;
+          });
+      break;
     }
+    case ContactSelection::SPREAD:
+    {
+      // Greedy farthest point selection seeded with the deepest contact.
+      // Kept contacts are swapped to the front of the range.
+      auto deepest = std::max_element(first, last,
+          [&](std::size_t _a, std::size_t _b)
+          {
+            return _result->getContact(_a).penetrationDepth <
+                   _result->getContact(_b).penetrationDepth;
+          });
+      std::iter_swap(first, deepest);
+
+      const std::size_t count = _end - _begin;
+      this->spreadDistances.assign(count,
+          std::numeric_limits<double>::infinity());
+      for (std::size_t k = 1; k < maxContacts; ++k)
+      {
+        const Eigen::Vector3d &lastPoint =
+            _result->getContact(*(first + (k - 1))).point;
+        std::size_t farthest = k;
+        for (std::size_t j = k; j < count; ++j)
+        {
+          const double d = (_result->getContact(*(first + j)).point -
+              lastPoint).squaredNorm();
+          this->spreadDistances[j] = std::min(this->spreadDistances[j], d);
+          if (this->spreadDistances[j] > this->spreadDistances[farthest])
+            farthest = j;
+        }
+        std::iter_swap(first + k, first + farthest);
+        std::swap(this->spreadDistances[k], this->spreadDistances[farthest]);
+      }
+      break;
+    }
+    case ContactSelection::FIRST:
+    default:
+      break;
   }
+
+  for (auto it = first; it != first + maxContacts; ++it)
+    this->keep[*it] = 1;
 }
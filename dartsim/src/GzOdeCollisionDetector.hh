@@ -15,11 +15,21 @@
  *
 */
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <dart/collision/ode/OdeCollisionDetector.hpp>
 
+#include <ode/ode.h>
+
+#include "BitmaskContactFilter.hh"
+
 namespace dart {
 namespace collision {
 
@@ -38,6 +48,10 @@ class GzOdeCollisionDetector : public dart::collision::OdeCollisionDetector
       const CollisionOption& option = CollisionOption(false, 1u, nullptr),
       CollisionResult* result = nullptr) override;
 
+  // Documentation inherited
+  public: std::shared_ptr<CollisionDetector> cloneWithoutCollisionObjects()
+      const override;
+
   /// \brief Set the maximum number of contacts between a pair of collision
   /// objects
   /// \param[in] _maxContacts Maximum number of contacts between a pair of
@@ -49,6 +63,48 @@ class GzOdeCollisionDetector : public dart::collision::OdeCollisionDetector
   /// \return Maximum number of contacts between a pair of collision objects.
   public: std::size_t GetCollisionPairMaxContacts() const;
 
+  /// \brief Strategy used to choose which contacts are kept when a pair of
+  /// collision objects has more contacts than the maximum.
+  public: enum class ContactSelection
+  {
+    /// \brief Keep the first contacts generated by ODE.
+    FIRST,
+
+    /// \brief Keep the contacts with the largest penetration depth.
+    DEEPEST,
+
+    /// \brief Keep the deepest contact, then repeatedly the contact farthest
+    /// from the ones already kept, so the kept contacts span the manifold.
+    SPREAD
+  };
+
+  /// \brief Set which contacts are kept between a pair of collision objects.
+  /// \param[in] _selection Contact selection strategy.
+  public: void SetCollisionPairContactSelection(ContactSelection _selection);
+
+  /// \brief Get which contacts are kept between a pair of collision objects.
+  /// \return Contact selection strategy.
+  public: ContactSelection GetCollisionPairContactSelection() const;
+
+  /// \brief Get the time spent in collision queries since the last call to
+  /// ResetCollideTime. ODE finds and tests the candidate pairs in a single
+  /// pass, so this covers both the broadphase and the narrowphase.
+  /// \return Time in seconds.
+  public: double GetCollideTime() const;
+
+  /// \brief Get the heap allocations of collision queries since the last
+  /// call to ResetCollideTime, see gz::physics::AllocationCount.
+  /// \return Number of allocations, 0 if they are not counted.
+  public: std::size_t GetCollideAllocations() const;
+
+  /// \brief Set the time returned by GetCollideTime and the allocations
+  /// returned by GetCollideAllocations back to 0.
+  public: void ResetCollideTime();
+
+  /// \brief Edge length of the boxes that stand in for infinite planes,
+  /// whose top face is the plane, see ConstructPlane in SDFFeatures.cc. This
+  /// number was taken from osrf/gazebo.
+  public: static constexpr double kPlaneBoxSize = 2100.0;
 
   /// \brief Create the GzOdeCollisionDetector
   public: static std::shared_ptr<GzOdeCollisionDetector> create();
@@ -56,16 +112,186 @@ class GzOdeCollisionDetector : public dart::collision::OdeCollisionDetector
   /// Constructor
   protected: GzOdeCollisionDetector();
 
+  /// \brief If the filter of a query is a BitmaskContactFilter, set the
+  /// category and collide bits of the ODE geoms of a group from its masks,
+  /// so that ODE drops the pairs whose masks do not overlap before it calls
+  /// the filter. The bits are only updated when the masks or the shape
+  /// frames of the group changed since the last query of the group.
+  /// \param[in] _group Group being queried.
+  /// \param[in] _option Options of the query.
+  /// \param[out] _maskedOption Copy of _option whose filter skips the masks.
+  /// \return True if the bits were applied and _maskedOption is to be used.
+  protected: bool ApplyCollisionMasks(CollisionGroup *_group,
+      const CollisionOption &_option, CollisionOption &_maskedOption);
+
+  /// \brief Keep the boxes of infinite planes, see kPlaneBoxSize, out of
+  /// the pairs that ODE tests, except with the geoms whose bounding box
+  /// reaches below the top face of one of them. The bounding box of a plane
+  /// box overlaps every other geom, so ODE would otherwise run the
+  /// narrowphase of every geom against it. The plane boxes get a category
+  /// bit of their own and no collide bits, and the other geoms get that bit
+  /// in their collide bits while their lowest point along the normal of a
+  /// plane with a matching mask is below it. All bits of a group are written
+  /// again when its shape frames or masks change, after ApplyCollisionMasks.
+  /// \param[in] _group1 Group being queried.
+  /// \param[in] _group2 Second group of a query between two groups, or
+  /// nullptr.
+  /// \param[in] _option Options of the query.
+  protected: void ApplyPlaneBits(CollisionGroup *_group1,
+      CollisionGroup *_group2, const CollisionOption &_option);
+
   /// \brief Limit max number of contacts between a pair of collision objects.
   /// The function modifies the contacts vector inside the CollisionResult
   /// object to cap the number of contacts for each collision pair based on the
-  /// maxCollisionPairContacts value
-  private: void LimitCollisionPairMaxContacts(CollisionResult *_result);
+  /// maxCollisionPairContacts value. The kept contacts are chosen according to
+  /// contactSelection and stay in their original order.
+  protected: void LimitCollisionPairMaxContacts(CollisionResult *_result);
+
+  /// \brief Time spent in collision queries since the last call to
+  /// ResetCollideTime.
+  protected: std::chrono::steady_clock::duration collideTime{0};
+
+  /// \brief Heap allocations of collision queries since the last call to
+  /// ResetCollideTime.
+  protected: std::size_t collideAllocations{0};
+
+  /// \brief Mark the contacts to keep for a pair that is over the limit.
+  /// \param[in] _result Collision result holding the contacts.
+  /// \param[in] _begin First entry of the pair's contacts in pairContacts.
+  /// \param[in] _end One past the last entry of the pair's contacts.
+  private: void SelectPairContacts(
+      CollisionResult *_result, std::size_t _begin, std::size_t _end);
+
+  /// \brief Filter that applies a BitmaskContactFilter without its masks,
+  /// for queries whose masks are tested by ODE.
+  private: class MaskedFilter : public CollisionFilter
+  {
+    // Documentation inherited
+    public: bool ignoresCollision(const CollisionObject *_object1,
+        const CollisionObject *_object2) const override;
+
+    /// \brief Filter of the current query.
+    public: const gz::physics::dartsim::BitmaskContactFilter *filter =
+        nullptr;
+  };
+
+  /// \brief State of the bits of the geoms of a group, see
+  /// ApplyCollisionMasks.
+  private: struct MaskedGroup
+  {
+    /// \brief Filter the bits were applied from.
+    const gz::physics::dartsim::BitmaskContactFilter *filter = nullptr;
+
+    /// \brief Version of the masks of filter that were applied.
+    std::size_t version = 0u;
+
+    /// \brief Shape frames of the group when the bits were applied.
+    std::vector<const dynamics::ShapeFrame *> shapeFrames;
+
+    /// \brief Collision object of each entry of shapeFrames. An expired
+    /// object was recreated without the bits.
+    std::vector<std::weak_ptr<CollisionObject>> objects;
+  };
+
+  /// \brief Geoms of a group with the bits ApplyPlaneBits starts from,
+  /// see ApplyPlaneBits.
+  private: struct PlaneGroup
+  {
+    /// \brief Filter the masks were read from, or nullptr.
+    const gz::physics::dartsim::BitmaskContactFilter *filter = nullptr;
+
+    /// \brief Version of the masks of filter that were read.
+    std::size_t version = 0u;
+
+    /// \brief Shape frames of the group when the bits were written.
+    std::vector<const dynamics::ShapeFrame *> shapeFrames;
+
+    /// \brief Shape of each entry of shapeFrames.
+    std::vector<const dynamics::Shape *> shapes;
+
+    /// \brief Collision object of each entry of shapeFrames.
+    std::vector<std::weak_ptr<CollisionObject>> objects;
+
+    /// \brief ODE geom of each entry of shapeFrames.
+    std::vector<dGeomID> geoms;
+
+    /// \brief Collide bits of each geom before the plane bit is added.
+    std::vector<unsigned long> collideBits;
+
+    /// \brief Mask of each entry of shapeFrames, -1 if it has none.
+    std::vector<int32_t> masks;
+
+    /// \brief Indices of the entries of shapeFrames that are plane boxes.
+    std::vector<std::size_t> planes;
+  };
+
+  /// \brief A plane of the query in progress, see ApplyPlaneBits.
+  private: struct WorldPlane
+  {
+    /// \brief Normal in the world frame.
+    Eigen::Vector3d normal;
+
+    /// \brief Distance of the plane from the origin along the normal.
+    double offset;
+
+    /// \brief Mask of the plane box, -1 if it has none.
+    int32_t mask;
+  };
+
+  /// \brief Bits of each group queried that has or had plane boxes, by
+  /// group.
+  private: std::unordered_map<const CollisionGroup *, PlaneGroup>
+      planeGroups;
+
+  /// \brief Planes of the query in progress, reused across queries.
+  private: std::vector<WorldPlane> queryPlanes;
+
+  /// \brief Filter passed to the queries whose masks are tested by ODE.
+  private: std::shared_ptr<MaskedFilter> maskedFilter =
+      std::make_shared<MaskedFilter>();
+
+  /// \brief Applied bits of each group queried, by group.
+  private: std::unordered_map<const CollisionGroup *, MaskedGroup>
+      maskedGroups;
+
+  /// \brief Hash for an unordered pair of collision objects.
+  private: struct PairHash
+  {
+    std::size_t operator()(
+        const std::pair<CollisionObject *, CollisionObject *> &_pair) const;
+  };
 
   /// \brief Maximum number of contacts between a pair of collision objects.
   private: std::size_t maxCollisionPairContacts =
       std::numeric_limits<std::size_t>::max();
 
+  /// \brief Which contacts are kept for pairs that are over the limit.
+  private: ContactSelection contactSelection = ContactSelection::FIRST;
+
+  /// \brief Pair slot of every object pair in the last result. The buckets
+  /// are reused across steps.
+  private: std::unordered_map<std::pair<CollisionObject *, CollisionObject *>,
+      std::size_t, PairHash> pairSlots;
+
+  /// \brief Pair slot of every contact.
+  private: std::vector<std::size_t> contactSlots;
+
+  /// \brief Offset of every pair slot into pairContacts.
+  private: std::vector<std::size_t> slotOffsets;
+
+  /// \brief Contact indices grouped by pair slot, in generation order.
+  private: std::vector<std::size_t> pairContacts;
+
+  /// \brief Whether each contact is kept.
+  private: std::vector<char> keep;
+
+  /// \brief Distance from each candidate to the closest kept contact, used by
+  /// ContactSelection::SPREAD.
+  private: std::vector<double> spreadDistances;
+
+  /// \brief Kept contacts, copied out before the result is rebuilt.
+  private: std::vector<Contact> keptContacts;
+
   private: static Registrar<GzOdeCollisionDetector> mRegistrar;
 };
 
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ode/ode.h>
+
+#include <dart/collision/ode/OdeCollisionDetector.hpp>
+
+#include <gz/physics/AllocationCounter.hh>
+
+#include "GzThreadedOdeCollisionDetector.hh"
+
+using namespace dart;
+using namespace collision;
+
+/////////////////////////////////////////////////
+GzThreadedOdeCollisionDetector::GzThreadedOdeCollisionDetector()
+  : GzOdeCollisionDetector(),
+    numThreads(std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+/////////////////////////////////////////////////
+GzThreadedOdeCollisionDetector::Registrar<GzThreadedOdeCollisionDetector>
+    GzThreadedOdeCollisionDetector::mRegistrar{
+        GzThreadedOdeCollisionDetector::getStaticType(),
+        []() -> std::shared_ptr<GzThreadedOdeCollisionDetector> {
+          return GzThreadedOdeCollisionDetector::create();
+        }};
+
+/////////////////////////////////////////////////
+std::shared_ptr<GzThreadedOdeCollisionDetector>
+GzThreadedOdeCollisionDetector::create()
+{
+  return std::shared_ptr<GzThreadedOdeCollisionDetector>(
+      new GzThreadedOdeCollisionDetector());
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<CollisionDetector>
+GzThreadedOdeCollisionDetector::cloneWithoutCollisionObjects() const
+{
+  auto clone = GzThreadedOdeCollisionDetector::create();
+  clone->SetNumThreads(this->numThreads);
+  clone->SetTaskScheduler(this->taskScheduler);
+  clone->SetCollisionPairMaxContacts(this->GetCollisionPairMaxContacts());
+  clone->SetCollisionPairContactSelection(
+      this->GetCollisionPairContactSelection());
+  return clone;
+}
+
+/////////////////////////////////////////////////
+const std::string &GzThreadedOdeCollisionDetector::getType() const
+{
+  return getStaticType();
+}
+
+/////////////////////////////////////////////////
+const std::string &GzThreadedOdeCollisionDetector::getStaticType()
+{
+  static const std::string type = "threaded_ode";
+  return type;
+}
+
+/////////////////////////////////////////////////
+void GzThreadedOdeCollisionDetector::SetNumThreads(std::size_t _numThreads)
+{
+  this->numThreads = std::max<std::size_t>(1u, _numThreads);
+  this->workerPool.reset();
+  // Force the tasks to be rebuilt for the new block count on the next query.
+  // The tasks themselves are kept until then, since the last result may still
+  // refer to their collision objects.
+  this->shapeFrames.clear();
+}
+
+/////////////////////////////////////////////////
+std::size_t GzThreadedOdeCollisionDetector::GetNumThreads() const
+{
+  return this->numThreads;
+}
+
+/////////////////////////////////////////////////
+void GzThreadedOdeCollisionDetector::SetTaskScheduler(
+    std::shared_ptr<gz::physics::TaskScheduler> _scheduler)
+{
+  this->taskScheduler = std::move(_scheduler);
+  if (this->taskScheduler)
+    this->workerPool.reset();
+}
+
+/////////////////////////////////////////////////
+bool GzThreadedOdeCollisionDetector::collide(
+    CollisionGroup *_group,
+    const CollisionOption &_option,
+    CollisionResult *_result)
+{
+  // Binary queries are cheap and can stop at the first contact, so there is
+  // nothing to gain from splitting them.
+  if (this->numThreads <= 1u || nullptr == _result || !_option.enableContact)
+    return GzOdeCollisionDetector::collide(_group, _option, _result);
+
+  // Sync the group with the skeletons it is subscribed to, so the shape
+  // frames below match what the serial query would see.
+  if (_group->getAutomaticUpdate())
+    _group->update();
+
+  if (_group->getNumShapeFrames() < 2u * this->numThreads)
+    return GzOdeCollisionDetector::collide(_group, _option, _result);
+
+  const auto start = std::chrono::steady_clock::now();
+  const std::size_t startAllocations = gz::physics::AllocationCount();
+  this->UpdateTasks(_group);
+
+  auto runTask = [this, &_option](std::size_t _index)
+  {
+    // Allocates ODE's per thread collision data the first time a thread
+    // runs a task, and is a no-op after that.
+    dAllocateODEDataForThread(dAllocateMaskAll);
+
+    Task &t = this->tasks[_index];
+    t.result.clear();
+    if (t.group2)
+      t.detector->collide(t.group1.get(), t.group2.get(), _option, &t.result);
+    else
+      t.detector->collide(t.group1.get(), _option, &t.result);
+  };
+
+  if (this->taskScheduler)
+  {
+    this->taskScheduler->Run(this->tasks.size(), runTask);
+  }
+  else
+  {
+    if (!this->workerPool)
+    {
+      this->workerPool = std::make_unique<gz::common::WorkerPool>(
+          static_cast<unsigned int>(this->numThreads));
+    }
+
+    for (std::size_t i = 0; i < this->tasks.size(); ++i)
+      this->workerPool->AddWork([&runTask, i]() { runTask(i); });
+    this->workerPool->WaitForResults();
+  }
+
+  // Merge in task order so the contact order does not depend on thread
+  // scheduling.
+  _result->clear();
+  for (const auto &task : this->tasks)
+  {
+    for (std::size_t i = 0; i < task.result.getNumContacts(); ++i)
+    {
+      if (_result->getNumContacts() >= _option.maxNumContacts)
+        break;
+      _result->addContact(task.result.getContact(i));
+    }
+  }
+
+  this->LimitCollisionPairMaxContacts(_result);
+  this->collideTime += std::chrono::steady_clock::now() - start;
+  this->collideAllocations +=
+      gz::physics::AllocationCount() - startAllocations;
+  return _result->isCollision();
+}
+
+/////////////////////////////////////////////////
+void GzThreadedOdeCollisionDetector::UpdateTasks(const CollisionGroup *_group)
+{
+  const std::size_t numShapeFrames = _group->getNumShapeFrames();
+  bool changed = numShapeFrames != this->shapeFrames.size();
+  for (std::size_t i = 0; !changed && i < numShapeFrames; ++i)
+    changed = _group->getShapeFrame(i) != this->shapeFrames[i];
+
+  if (!changed)
+    return;
+
+  this->shapeFrames.resize(numShapeFrames);
+  for (std::size_t i = 0; i < numShapeFrames; ++i)
+    this->shapeFrames[i] = _group->getShapeFrame(i);
+
+  // Use the smallest number of blocks whose self and cross pairs give at
+  // least one task per thread. Every shape frame is mirrored once per block.
+  std::size_t numBlocks = 1u;
+  while (numBlocks * (numBlocks + 1u) / 2u < this->numThreads)
+    ++numBlocks;
+
+  // Round robin assignment keeps the blocks evenly sized.
+  auto addBlock = [&](CollisionGroup *_blockGroup, std::size_t _block)
+  {
+    for (std::size_t i = _block; i < numShapeFrames; i += numBlocks)
+      _blockGroup->addShapeFrame(this->shapeFrames[i]);
+  };
+
+  this->tasks.clear();
+  this->tasks.reserve(numBlocks * (numBlocks + 1u) / 2u);
+  for (std::size_t b = 0; b < numBlocks; ++b)
+  {
+    for (std::size_t c = b; c < numBlocks; ++c)
+    {
+      Task task;
+      // Tasks apply the masks of the filter to their own geoms
+      task.detector = GzOdeCollisionDetector::create();
+      task.group1 = task.detector->createCollisionGroup();
+      addBlock(task.group1.get(), b);
+      if (c != b)
+      {
+        task.group2 = task.detector->createCollisionGroup();
+        addBlock(task.group2.get(), c);
+      }
+      this->tasks.push_back(std::move(task));
+    }
+  }
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DARTSIM_SRC_GZTHREADEDODECOLLISIONDETECTOR_HH_
+#define GZ_PHYSICS_DARTSIM_SRC_GZTHREADEDODECOLLISIONDETECTOR_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dart/collision/CollisionGroup.hpp>
+#include <dart/collision/CollisionResult.hpp>
+
+#include <gz/common/WorkerPool.hh>
+#include <gz/physics/TaskScheduler.hh>
+
+#include "GzOdeCollisionDetector.hh"
+
+namespace dart {
+namespace collision {
+
+/// \brief An ODE based collision detector that runs the narrowphase of a
+/// single group query on multiple threads.
+///
+/// The shape frames of the queried group are split into blocks. Every block
+/// and every pair of blocks is mirrored by collision groups owned by a
+/// private ODE collision detector, so the resulting tasks share no ODE state
+/// and can be run concurrently. Their contacts are merged into the output
+/// CollisionResult in a fixed order, so results are deterministic for a given
+/// thread count.
+///
+/// Queries between two groups, binary queries and queries on small groups
+/// fall back to the serial ODE implementation.
+///
+/// ODE must be built with thread local storage support (--enable-ou) for
+/// concurrent trimesh collisions to be safe.
+class GzThreadedOdeCollisionDetector : public GzOdeCollisionDetector
+{
+  // Documentation inherited
+  public: bool collide(
+      CollisionGroup* group,
+      const CollisionOption& option = CollisionOption(false, 1u, nullptr),
+      CollisionResult* result = nullptr) override;
+
+  /// \brief Queries between two groups use the serial implementation.
+  public: using GzOdeCollisionDetector::collide;
+
+  // Documentation inherited
+  public: std::shared_ptr<CollisionDetector> cloneWithoutCollisionObjects()
+      const override;
+
+  // Documentation inherited
+  public: const std::string &getType() const override;
+
+  /// \brief Get the type of this collision detector.
+  /// \return "threaded_ode"
+  public: static const std::string &getStaticType();
+
+  /// \brief Set the number of threads used for the narrowphase.
+  /// \param[in] _numThreads Number of threads. A value of 0 or 1 runs the
+  /// query serially.
+  public: void SetNumThreads(std::size_t _numThreads);
+
+  /// \brief Get the number of threads used for the narrowphase.
+  /// \return Number of threads.
+  public: std::size_t GetNumThreads() const;
+
+  /// \brief Set the scheduler that runs the narrowphase tasks.
+  /// \param[in] _scheduler Scheduler, or nullptr to use a thread pool of
+  /// this detector. The number of threads still sets the number of blocks.
+  public: void SetTaskScheduler(
+      std::shared_ptr<gz::physics::TaskScheduler> _scheduler);
+
+  /// \brief Create the GzThreadedOdeCollisionDetector
+  public: static std::shared_ptr<GzThreadedOdeCollisionDetector> create();
+
+  /// Constructor
+  protected: GzThreadedOdeCollisionDetector();
+
+  /// \brief Rebuild the block groups if the shape frames of the queried
+  /// group changed since the last query.
+  /// \param[in] _group Group being queried.
+  private: void UpdateTasks(const CollisionGroup *_group);
+
+  /// \brief A collision query between one block, or a pair of blocks, of
+  /// shape frames.
+  private: struct Task
+  {
+    /// \brief Detector owning the groups of this task.
+    std::shared_ptr<CollisionDetector> detector;
+
+    /// \brief Shape frames of the first block.
+    std::unique_ptr<CollisionGroup> group1;
+
+    /// \brief Shape frames of the second block, or nullptr if this task
+    /// collides the first block against itself.
+    std::unique_ptr<CollisionGroup> group2;
+
+    /// \brief Contacts found by this task.
+    CollisionResult result;
+  };
+
+  /// \brief Number of threads used for the narrowphase.
+  private: std::size_t numThreads;
+
+  /// \brief Shape frames of the group the tasks were built for.
+  private: std::vector<const dynamics::ShapeFrame *> shapeFrames;
+
+  /// \brief Cached collision tasks.
+  private: std::vector<Task> tasks;
+
+  /// \brief Thread pool running the tasks without a task scheduler.
+  /// Created on first use.
+  private: std::unique_ptr<gz::common::WorkerPool> workerPool;
+
+  /// \brief Scheduler running the tasks, or nullptr to use workerPool.
+  private: std::shared_ptr<gz::physics::TaskScheduler> taskScheduler;
+
+  private: static Registrar<GzThreadedOdeCollisionDetector> mRegistrar;
+};
+
+}
+}
+
+#endif
@@ -28,6 +28,80 @@ namespace gz {
 namespace physics {
 namespace dartsim {
 
+/////////////////////////////////////////////////
+/// \brief Total number of DOFs of the joints of a model, in the layout used
+/// by GetModelJointState.
+static std::size_t ModelJointDofs(const ModelInfo &_modelInfo)
+{
+  std::size_t dofs = 0;
+  for (const auto &jointInfo : _modelInfo.joints)
+  {
+    if (jointInfo->joint)
+      dofs += jointInfo->joint->getNumDofs();
+  }
+  return dofs;
+}
+
+/////////////////////////////////////////////////
+/// \brief Fill _values with _get(joint, dof) for every joint DOF of a model.
+template <typename GetT>
+static void GetModelJointValues(
+    const ModelInfo &_modelInfo, Eigen::VectorXd &_values, GetT _get)
+{
+  _values.resize(static_cast<Eigen::Index>(ModelJointDofs(_modelInfo)));
+  Eigen::Index k = 0;
+  for (const auto &jointInfo : _modelInfo.joints)
+  {
+    const auto *joint = jointInfo->joint.get();
+    if (!joint)
+      continue;
+
+    for (std::size_t i = 0; i < joint->getNumDofs(); ++i)
+      _values[k++] = _get(joint, i);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Call _set(joint, dof, value) for every joint DOF of a model.
+/// \return False, without setting anything, if _values has the wrong size
+/// or holds a non-finite value.
+template <typename SetT>
+static bool SetModelJointValues(
+    const ModelInfo &_modelInfo, const Eigen::VectorXd &_values,
+    const char *_quantity, SetT _set)
+{
+  const std::size_t dofs = ModelJointDofs(_modelInfo);
+  if (static_cast<std::size_t>(_values.size()) != dofs)
+  {
+    gzerr << "Invalid number of joint " << _quantity << " values ["
+          << _values.size() << "] set on model [" << _modelInfo.localName
+          << "], which has [" << dofs << "] joint DOFs. The values will be "
+          << "ignored\n";
+    return false;
+  }
+
+  // Take extra care that the values are finite, for the same reason as in
+  // SetJointPosition.
+  if (!_values.allFinite())
+  {
+    gzerr << "Invalid joint " << _quantity << " values set on model ["
+          << _modelInfo.localName << "]. The values will be ignored\n";
+    return false;
+  }
+
+  Eigen::Index k = 0;
+  for (const auto &jointInfo : _modelInfo.joints)
+  {
+    auto *joint = jointInfo->joint.get();
+    if (!joint)
+      continue;
+
+    for (std::size_t i = 0; i < joint->getNumDofs(); ++i)
+      _set(joint, i, _values[k++]);
+  }
+  return true;
+}
+
 /////////////////////////////////////////////////
 double JointFeatures::GetJointPosition(
     const Identity &_id, std::size_t _dof) const
@@ -67,6 +141,7 @@ Pose3d JointFeatures::GetJointTransform(const Identity &_id) const
 void JointFeatures::SetJointPosition(
     const Identity &_id, std::size_t _dof, double _value)
 {
+  this->frameDataCache.Invalidate();
   auto joint = this->ReferenceInterface<JointInfo>(_id)->joint;
 
   // Take extra care that the value is finite. A nan can cause the DART
@@ -86,6 +161,7 @@ void JointFeatures::SetJointPosition(
 void JointFeatures::SetJointVelocity(
     const Identity &_id, std::size_t _dof, double _value)
 {
+  this->frameDataCache.Invalidate();
   auto joint = this->ReferenceInterface<JointInfo>(_id)->joint;
 
   // Take extra care that the value is finite. A nan can cause the DART
@@ -105,6 +181,7 @@ void JointFeatures::SetJointVelocity(
 void JointFeatures::SetJointAcceleration(
     const Identity &_id, std::size_t _dof, double _value)
 {
+  this->frameDataCache.Invalidate();
   auto joint = this->ReferenceInterface<JointInfo>(_id)->joint;
 
   // Take extra care that the value is finite. A nan can cause the DART
@@ -327,43 +404,83 @@ void JointFeatures::SetJointMaxEffort(
 /////////////////////////////////////////////////
 std::size_t JointFeatures::GetJointDegreesOfFreedom(const Identity &_id) const
 {
-  return this->ReferenceInterface<JointInfo>(_id)->joint->getNumDofs();
+  const auto &joint = this->ReferenceInterface<JointInfo>(_id)->joint;
+  // Joints attached as a constraint have no DOFs
+  if (!joint)
+    return 0u;
+  return joint->getNumDofs();
 }
 
 /////////////////////////////////////////////////
 Pose3d JointFeatures::GetJointTransformFromParent(const Identity &_id) const
 {
-  return this->ReferenceInterface<JointInfo>(_id)
-      ->joint->getTransformFromParentBodyNode();
+  const auto *jointInfo = this->ReferenceInterface<JointInfo>(_id);
+  if (!jointInfo->joint)
+    return jointInfo->transformFromParent;
+  return jointInfo->joint->getTransformFromParentBodyNode();
 }
 
 /////////////////////////////////////////////////
 Pose3d JointFeatures::GetJointTransformToChild(const Identity &_id) const
 {
-  return this->ReferenceInterface<JointInfo>(_id)
-      ->joint->getTransformFromChildBodyNode().inverse();
+  const auto *jointInfo = this->ReferenceInterface<JointInfo>(_id);
+  if (!jointInfo->joint)
+    return jointInfo->transformFromChild.inverse();
+  return jointInfo->joint->getTransformFromChildBodyNode().inverse();
 }
 
 /////////////////////////////////////////////////
 void JointFeatures::SetJointTransformFromParent(
     const Identity &_id, const Pose3d &_pose)
 {
-  this->ReferenceInterface<JointInfo>(_id)
-      ->joint->setTransformFromParentBodyNode(_pose);
+  this->frameDataCache.Invalidate();
+  auto *jointInfo = this->ReferenceInterface<JointInfo>(_id);
+  if (!jointInfo->joint)
+  {
+    jointInfo->transformFromParent = _pose;
+    UpdateWeldConstraint(*jointInfo);
+    return;
+  }
+  jointInfo->joint->setTransformFromParentBodyNode(_pose);
 }
 
 /////////////////////////////////////////////////
 void JointFeatures::SetJointTransformToChild(
     const Identity &_id, const Pose3d &_pose)
 {
-  this->ReferenceInterface<JointInfo>(_id)
-      ->joint->setTransformFromChildBodyNode(_pose.inverse());
+  this->frameDataCache.Invalidate();
+  auto *jointInfo = this->ReferenceInterface<JointInfo>(_id);
+  if (!jointInfo->joint)
+  {
+    jointInfo->transformFromChild = _pose.inverse();
+    jointInfo->frame->setRelativeTransform(jointInfo->transformFromChild);
+    UpdateWeldConstraint(*jointInfo);
+    return;
+  }
+  jointInfo->joint->setTransformFromChildBodyNode(_pose.inverse());
 }
 
 /////////////////////////////////////////////////
 void JointFeatures::DetachJoint(const Identity &_jointId)
 {
-  auto joint = this->ReferenceInterface<JointInfo>(_jointId)->joint;
+  this->frameDataCache.Invalidate();
+  auto jointInfo = this->ReferenceInterface<JointInfo>(_jointId);
+  auto joint = jointInfo->joint;
+  if (!joint)
+  {
+    // Attached as a constraint, or already detached
+    const auto constraint = this->weldConstraintJoints.find(_jointId);
+    if (constraint != this->weldConstraintJoints.end() &&
+        this->links.HasEntity(jointInfo->childBody))
+    {
+      this->RecordEntityChange(constraint->second,
+          EntityChange::Type::DETACHED, EntityChange::Kind::JOINT,
+          _jointId, this->links.IdentityOf(jointInfo->childBody));
+    }
+    this->RemoveWeldConstraintJoint(_jointId);
+    return;
+  }
+
   if (joint->getType() == "FreeJoint")
   {
     // don't need to do anything, joint is already a FreeJoint
@@ -372,6 +489,9 @@ void JointFeatures::DetachJoint(const Identity &_jointId)
 
   auto child = joint->getChildBodyNode();
   auto transform = child->getWorldTransform();
+  const std::size_t worldID = this->joints.HasContainer(_jointId) ?
+      this->GetWorldOfModelImpl(this->joints.ContainerIDOf(_jointId)) :
+      INVALID_ENTITY_ID;
   auto spatialVelocity =
       child->getSpatialVelocity(
           dart::dynamics::Frame::World(),
@@ -386,6 +506,9 @@ void JointFeatures::DetachJoint(const Identity &_jointId)
            this->linkByWeldedNode.end())
   {
     childLinkInfo = this->linkByWeldedNode.at(child);
+    this->RecordEntityChange(worldID, EntityChange::Type::DETACHED,
+        EntityChange::Kind::JOINT, _jointId,
+        this->links.IdentityOf(childLinkInfo->link.get()));
     this->MergeLinkAndWeldedBody(childLinkInfo, child);
     this->linkByWeldedNode.erase(child);
     child->remove();
@@ -400,6 +523,9 @@ void JointFeatures::DetachJoint(const Identity &_jointId)
     return;
   }
 
+  this->RecordEntityChange(worldID, EntityChange::Type::DETACHED,
+      EntityChange::Kind::JOINT, _jointId, this->links.IdentityOf(child));
+
   dart::dynamics::SkeletonPtr skeleton;
   {
     // Find the original skeleton the child BodyNode belonged to
@@ -454,6 +580,9 @@ void JointFeatures::DetachJoint(const Identity &_jointId)
 Identity JointFeatures::CastToFixedJoint(
     const Identity &_jointID) const
 {
+  if (this->ReferenceInterface<JointInfo>(_jointID)->weldConstraint)
+    return this->GenerateIdentity(_jointID, this->Reference(_jointID));
+
   dart::dynamics::WeldJoint *const weld =
       dynamic_cast<dart::dynamics::WeldJoint *>(
           this->ReferenceInterface<JointInfo>(_jointID)->joint.get());
@@ -470,6 +599,7 @@ Identity JointFeatures::AttachFixedJoint(
     const BaseLink3dPtr &_parent,
     const std::string &_name)
 {
+  this->frameDataCache.Invalidate();
   auto linkInfo = this->ReferenceInterface<LinkInfo>(_childID);
   DartBodyNode *bn = linkInfo->link.get();
   dart::dynamics::WeldJoint::Properties properties;
@@ -478,6 +608,9 @@ Identity JointFeatures::AttachFixedJoint(
   auto *const parentBn = _parent ? this->ReferenceInterface<LinkInfo>(
       _parent->FullIdentity())->link.get() : nullptr;
 
+  if (this->attachFixedJointAsConstraint)
+    return this->AttachFixedJointAsConstraint(_childID, bn, parentBn, _name);
+
   std::string childLinkName = linkInfo->name;
   if (bn->getParentJoint()->getType() != "FreeJoint")
   {
@@ -495,16 +628,21 @@ Identity JointFeatures::AttachFixedJoint(
     }
   }
 
-  // Get the model of child link and fully scoped joint name.
+  // Get the model of child link.
   auto modelID = this->GetModelOfLinkImpl(_childID);
-  const std::string fullJointName =
-      this->FullyScopedJointName(modelID, _name);
-  if (fullJointName.empty())
+  if (this->GetWorldOfModelImpl(modelID) == INVALID_ENTITY_ID)
+  {
+    gzerr << "World of the child link of joint [" << _name
+          << "] could not be found\n";
     return this->GenerateInvalidId();
+  }
 
   const std::size_t jointID = this->AddJoint(
       bn->moveTo<dart::dynamics::WeldJoint>(parentBn, properties),
-      fullJointName, modelID);
+      _name, modelID);
+  this->RecordEntityChange(this->GetWorldOfModelImpl(modelID),
+      EntityChange::Type::ATTACHED, EntityChange::Kind::JOINT, jointID,
+      _childID.id);
   if (!linkInfo->weldedNodes.empty())
   {
     // weld constraint needs to be updated after moving to new skeleton
@@ -517,6 +655,69 @@ Identity JointFeatures::AttachFixedJoint(
   return this->GenerateIdentity(jointID, this->joints.at(jointID));
 }
 
+/////////////////////////////////////////////////
+Identity JointFeatures::AttachFixedJointAsConstraint(
+    const Identity &_childID, DartBodyNode *_childBn, DartBodyNode *_parentBn,
+    const std::string &_name)
+{
+  const std::size_t modelID = this->GetModelOfLinkImpl(_childID);
+  const std::size_t worldID = this->GetWorldOfModelImpl(modelID);
+
+  // Neither body node changes skeleton, so unlike a WeldJoint nothing is
+  // split, moved or renamed. The constraint starts out holding the child at
+  // the origin of the parent, like a WeldJoint with identity transforms.
+  auto jointInfo = std::make_shared<JointInfo>();
+  jointInfo->name = _name;
+  jointInfo->parentBody = _parentBn;
+  jointInfo->childBody = _childBn;
+  jointInfo->weldConstraint = _parentBn ?
+      std::make_shared<dart::constraint::WeldJointConstraint>(
+          _parentBn, _childBn) :
+      std::make_shared<dart::constraint::WeldJointConstraint>(_childBn);
+  UpdateWeldConstraint(*jointInfo);
+  jointInfo->frame = dart::dynamics::SimpleFrame::createShared(
+      _childBn, _name + "_frame", jointInfo->transformFromChild);
+  this->worlds.at(worldID)->getConstraintSolver()->addConstraint(
+      jointInfo->weldConstraint);
+
+  // The joint is not one of the joints of its model, whose indices follow
+  // the joints of its skeleton.
+  const std::size_t jointID = this->GetNextEntity();
+  this->joints[jointID] = jointInfo;
+  this->frames[jointID] = jointInfo->frame.get();
+  this->weldConstraintJoints[jointID] = worldID;
+  this->RecordEntityChange(worldID, EntityChange::Type::CREATED,
+      EntityChange::Kind::JOINT, jointID, modelID);
+  this->RecordEntityChange(worldID, EntityChange::Type::ATTACHED,
+      EntityChange::Kind::JOINT, jointID, _childID.id);
+  return this->GenerateIdentity(jointID, this->joints.at(jointID));
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::UpdateWeldConstraint(const JointInfo &_jointInfo)
+{
+  if (!_jointInfo.weldConstraint)
+    return;
+
+  // Same relation between the parent and the child as a WeldJoint
+  _jointInfo.weldConstraint->setRelativeTransform(
+      _jointInfo.transformFromParent * _jointInfo.transformFromChild.inverse());
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetEngineAttachFixedJointAsConstraint(
+    const Identity &, bool _asConstraint)
+{
+  this->attachFixedJointAsConstraint = _asConstraint;
+}
+
+/////////////////////////////////////////////////
+bool JointFeatures::GetEngineAttachFixedJointAsConstraint(
+    const Identity &) const
+{
+  return this->attachFixedJointAsConstraint;
+}
+
 /////////////////////////////////////////////////
 Identity JointFeatures::CastToFreeJoint(
     const Identity &_jointID) const
@@ -535,6 +736,7 @@ Identity JointFeatures::CastToFreeJoint(
 void JointFeatures::SetFreeJointRelativeTransform(
     const Identity &_jointID, const Pose3d &_pose)
 {
+  this->frameDataCache.Invalidate();
   static_cast<dart::dynamics::FreeJoint *>(
       this->ReferenceInterface<JointInfo>(_jointID)->joint.get())
       ->setRelativeTransform(_pose);
@@ -566,6 +768,7 @@ AngularVector3d JointFeatures::GetRevoluteJointAxis(
 void JointFeatures::SetRevoluteJointAxis(
     const Identity &_jointID, const AngularVector3d &_axis)
 {
+  this->frameDataCache.Invalidate();
   static_cast<dart::dynamics::RevoluteJoint *>(
       this->ReferenceInterface<JointInfo>(_jointID)->joint.get())
       ->setAxis(_axis);
@@ -578,6 +781,7 @@ Identity JointFeatures::AttachRevoluteJoint(
     const std::string &_name,
     const AngularVector3d &_axis)
 {
+  this->frameDataCache.Invalidate();
   auto linkInfo = this->ReferenceInterface<LinkInfo>(_childID);
   DartBodyNode *const bn = linkInfo->link.get();
   dart::dynamics::RevoluteJoint::Properties properties;
@@ -602,16 +806,18 @@ Identity JointFeatures::AttachRevoluteJoint(
     }
   }
 
-  // Get the model of child link and fully scoped joint name.
+  // Get the model of child link.
   auto modelID = this->GetModelOfLinkImpl(_childID);
-  const std::string fullJointName =
-      this->FullyScopedJointName(modelID, _name);
-  if (fullJointName.empty())
+  if (this->GetWorldOfModelImpl(modelID) == INVALID_ENTITY_ID)
+  {
+    gzerr << "World of the child link of joint [" << _name
+          << "] could not be found\n";
     return this->GenerateInvalidId();
+  }
 
   const std::size_t jointID = this->AddJoint(
       bn->moveTo<dart::dynamics::RevoluteJoint>(parentBn, properties),
-        fullJointName, modelID);
+        _name, modelID);
   // TODO(addisu) Remove incrementVersion once DART has been updated to
   // internally increment the BodyNode's version after moveTo.
   bn->incrementVersion();
@@ -644,6 +850,7 @@ LinearVector3d JointFeatures::GetPrismaticJointAxis(
 void JointFeatures::SetPrismaticJointAxis(
     const Identity &_jointID, const LinearVector3d &_axis)
 {
+  this->frameDataCache.Invalidate();
   static_cast<dart::dynamics::PrismaticJoint *>(
       this->ReferenceInterface<JointInfo>(_jointID)->joint.get())
       ->setAxis(_axis);
@@ -656,6 +863,7 @@ Identity JointFeatures::AttachPrismaticJoint(
     const std::string &_name,
     const LinearVector3d &_axis)
 {
+  this->frameDataCache.Invalidate();
   auto linkInfo = this->ReferenceInterface<LinkInfo>(_childID);
   DartBodyNode *const bn = linkInfo->link.get();
   dart::dynamics::PrismaticJoint::Properties properties;
@@ -680,27 +888,53 @@ Identity JointFeatures::AttachPrismaticJoint(
     }
   }
 
-  // Get the model of child link and fully scoped joint name.
+  // Get the model of child link.
   auto modelID = this->GetModelOfLinkImpl(_childID);
-  const std::string fullJointName =
-      this->FullyScopedJointName(modelID, _name);
-  if (fullJointName.empty())
+  if (this->GetWorldOfModelImpl(modelID) == INVALID_ENTITY_ID)
+  {
+    gzerr << "World of the child link of joint [" << _name
+          << "] could not be found\n";
     return this->GenerateInvalidId();
+  }
 
   const std::size_t jointID = this->AddJoint(
       bn->moveTo<dart::dynamics::PrismaticJoint>(parentBn, properties),
-      fullJointName, modelID);
+      _name, modelID);
   // TODO(addisu) Remove incrementVersion once DART has been updated to
   // internally increment the BodyNode's version after moveTo.
   bn->incrementVersion();
   return this->GenerateIdentity(jointID, this->joints.at(jointID));
 }
 
+/////////////////////////////////////////////////
+/// \brief Transmitted wrench of a joint in the joint frame. The joint must
+/// have a child body node.
+static Wrench3d JointTransmittedWrench(const dart::dynamics::Joint &_joint,
+    const dart::dynamics::BodyNode &_childBn)
+{
+  const Eigen::Vector6d transmittedWrenchInBody = _childBn.getBodyForce();
+  // C - Child body frame
+  // J - Joint frame
+  // X_CJ - Pose of joint in child body frame
+  const Eigen::Isometry3d &X_CJ = _joint.getTransformFromChildBodyNode();
+
+  const Eigen::Vector6d transmittedWrenchInJoint =
+      dart::math::dAdT(X_CJ, transmittedWrenchInBody);
+  Wrench3d wrenchOut;
+  wrenchOut.torque = transmittedWrenchInJoint.head<3>();
+  wrenchOut.force = transmittedWrenchInJoint.tail<3>();
+  return wrenchOut;
+}
+
 /////////////////////////////////////////////////
 Wrench3d JointFeatures::GetJointTransmittedWrenchInJointFrame(
     const Identity &_id) const
 {
   auto &joint = this->ReferenceInterface<JointInfo>(_id)->joint;
+  // Joints attached as a constraint transmit no wrench of their own
+  if (!joint)
+    return {};
+
   auto *childBn = joint->getChildBodyNode();
   if (nullptr == childBn)
   {
@@ -710,18 +944,217 @@ Wrench3d JointFeatures::GetJointTransmittedWrenchInJointFrame(
     return {};
   }
 
-  const Eigen::Vector6d transmittedWrenchInBody = childBn->getBodyForce();
-  // C - Child body frame
-  // J - Joint frame
-  // X_CJ - Pose of joint in child body frame
-  const Eigen::Isometry3d X_CJ = joint->getTransformFromChildBodyNode();
+  return JointTransmittedWrench(*joint, *childBn);
+}
 
-  const Eigen::Vector6d transmittedWrenchInJoint =
-      dart::math::dAdT(X_CJ, transmittedWrenchInBody);
-  Wrench3d wrenchOut;
-  wrenchOut.torque = transmittedWrenchInJoint.head<3>();
-  wrenchOut.force = transmittedWrenchInJoint.tail<3>();
-  return wrenchOut;
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointTransmittedWrenches(
+    const Identity &_modelID, std::vector<Wrench3d> &_wrenches) const
+{
+  const auto &joints = this->ReferenceInterface<ModelInfo>(_modelID)->joints;
+  _wrenches.resize(joints.size());
+  for (std::size_t i = 0; i < joints.size(); ++i)
+  {
+    const auto *joint = joints[i]->joint.get();
+    const auto *childBn = joint ? joint->getChildBodyNode() : nullptr;
+    if (nullptr == childBn)
+    {
+      _wrenches[i].torque.setZero();
+      _wrenches[i].force.setZero();
+      continue;
+    }
+
+    _wrenches[i] = JointTransmittedWrench(*joint, *childBn);
+  }
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointPositions(
+    const Identity &_modelID, Eigen::VectorXd &_positions) const
+{
+  GetModelJointValues(*this->ReferenceInterface<ModelInfo>(_modelID),
+      _positions, [](const dart::dynamics::Joint *_joint, std::size_t _dof)
+      {
+        return _joint->getPosition(_dof);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointVelocities(
+    const Identity &_modelID, Eigen::VectorXd &_velocities) const
+{
+  GetModelJointValues(*this->ReferenceInterface<ModelInfo>(_modelID),
+      _velocities, [](const dart::dynamics::Joint *_joint, std::size_t _dof)
+      {
+        return _joint->getVelocity(_dof);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointAccelerations(
+    const Identity &_modelID, Eigen::VectorXd &_accelerations) const
+{
+  GetModelJointValues(*this->ReferenceInterface<ModelInfo>(_modelID),
+      _accelerations, [](const dart::dynamics::Joint *_joint, std::size_t _dof)
+      {
+        return _joint->getAcceleration(_dof);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::GetModelJointForces(
+    const Identity &_modelID, Eigen::VectorXd &_forces) const
+{
+  GetModelJointValues(*this->ReferenceInterface<ModelInfo>(_modelID),
+      _forces, [](const dart::dynamics::Joint *_joint, std::size_t _dof)
+      {
+        return _joint->getForce(_dof);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointPositions(
+    const Identity &_modelID, const Eigen::VectorXd &_positions)
+{
+  this->frameDataCache.Invalidate();
+  SetModelJointValues(*this->ReferenceInterface<ModelInfo>(_modelID),
+      _positions, "position",
+      [](dart::dynamics::Joint *_joint, std::size_t _dof, double _value)
+      {
+        _joint->setPosition(_dof, _value);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointVelocities(
+    const Identity &_modelID, const Eigen::VectorXd &_velocities)
+{
+  this->frameDataCache.Invalidate();
+  SetModelJointValues(*this->ReferenceInterface<ModelInfo>(_modelID),
+      _velocities, "velocity",
+      [](dart::dynamics::Joint *_joint, std::size_t _dof, double _value)
+      {
+        _joint->setVelocity(_dof, _value);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointAccelerations(
+    const Identity &_modelID, const Eigen::VectorXd &_accelerations)
+{
+  this->frameDataCache.Invalidate();
+  SetModelJointValues(*this->ReferenceInterface<ModelInfo>(_modelID),
+      _accelerations, "acceleration",
+      [](dart::dynamics::Joint *_joint, std::size_t _dof, double _value)
+      {
+        _joint->setAcceleration(_dof, _value);
+      });
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::SetModelJointForces(
+    const Identity &_modelID, const Eigen::VectorXd &_forces)
+{
+  // Forces are applied as commands, like SetJointForce, so they only last
+  // for the next step.
+  SetModelJointValues(*this->ReferenceInterface<ModelInfo>(_modelID),
+      _forces, "force",
+      [](dart::dynamics::Joint *_joint, std::size_t _dof, double _value)
+      {
+        if (_joint->getActuatorType() != dart::dynamics::Joint::FORCE)
+          _joint->setActuatorType(dart::dynamics::Joint::FORCE);
+        _joint->setCommand(_dof, _value);
+      });
+}
+
+/////////////////////////////////////////////////
+/// \brief Whether a vector of a joint PD controller has one finite value per
+/// joint DOF of a model, printing an error if it does not.
+static bool IsValidJointPDControlVector(
+    const ModelInfo &_modelInfo, const Eigen::VectorXd &_values,
+    const char *_quantity)
+{
+  const std::size_t dofs = ModelJointDofs(_modelInfo);
+  if (static_cast<std::size_t>(_values.size()) != dofs ||
+      !_values.allFinite())
+  {
+    gzerr << "Invalid joint PD control " << _quantity << " set on model ["
+          << _modelInfo.localName << "], which needs [" << dofs
+          << "] finite values. The controller will not be changed\n";
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool JointFeatures::SetModelJointPDControl(
+    const Identity &_modelID, const JointPDControl &_control)
+{
+  const auto &modelInfo = *this->ReferenceInterface<ModelInfo>(_modelID);
+  if (!IsValidJointPDControlVector(
+          modelInfo, _control.positionGains, "position gains") ||
+      !IsValidJointPDControlVector(
+          modelInfo, _control.velocityGains, "velocity gains") ||
+      !IsValidJointPDControlVector(
+          modelInfo, _control.targetPositions, "target positions") ||
+      !IsValidJointPDControlVector(
+          modelInfo, _control.targetVelocities, "target velocities"))
+  {
+    return false;
+  }
+
+  // The control forces are applied as commands, like SetJointForce
+  for (const auto &jointInfo : modelInfo.joints)
+  {
+    auto *joint = jointInfo->joint.get();
+    if (joint && joint->getNumDofs() > 0 &&
+        joint->getActuatorType() != dart::dynamics::Joint::FORCE)
+    {
+      joint->setActuatorType(dart::dynamics::Joint::FORCE);
+    }
+  }
+
+  auto &control = this->jointPDControls[_modelID.id];
+  control.positionGains = _control.positionGains;
+  control.velocityGains = _control.velocityGains;
+  control.targetPositions = _control.targetPositions;
+  control.targetVelocities = _control.targetVelocities;
+  control.gravityCompensation = _control.gravityCompensation;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool JointFeatures::SetModelJointPDControlTargets(
+    const Identity &_modelID,
+    const Eigen::VectorXd &_positions,
+    const Eigen::VectorXd &_velocities)
+{
+  const auto it = this->jointPDControls.find(_modelID.id);
+  if (it == this->jointPDControls.end())
+  {
+    gzerr << "Joint PD control targets set on model ["
+          << this->ReferenceInterface<ModelInfo>(_modelID)->localName
+          << "], which has no controller. The targets will be ignored\n";
+    return false;
+  }
+
+  const auto &modelInfo = *this->ReferenceInterface<ModelInfo>(_modelID);
+  if (!IsValidJointPDControlVector(modelInfo, _positions, "target positions")
+      || !IsValidJointPDControlVector(
+          modelInfo, _velocities, "target velocities"))
+  {
+    return false;
+  }
+
+  it->second.targetPositions = _positions;
+  it->second.targetVelocities = _velocities;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void JointFeatures::RemoveModelJointPDControl(const Identity &_modelID)
+{
+  this->jointPDControls.erase(_modelID.id);
 }
 }
 }
@@ -19,6 +19,7 @@
 #define GZ_PHYSICS_DARTSIM_SRC_JOINTFEATURES_HH_
 
 #include <string>
+#include <vector>
 
 #include <gz/physics/Joint.hh>
 #include <gz/physics/FixedJoint.hh>
@@ -43,6 +44,7 @@ struct JointFeatureList : FeatureList<
   SetFreeJointRelativeTransformFeature,
 
   AttachFixedJointFeature,
+  AttachFixedJointAsConstraintFeature,
 
   SetRevoluteJointProperties,
   GetRevoluteJointProperties,
@@ -56,13 +58,20 @@ struct JointFeatureList : FeatureList<
   SetJointPositionLimitsFeature,
   SetJointVelocityLimitsFeature,
   SetJointEffortLimitsFeature,
-  GetJointTransmittedWrench
+  GetJointTransmittedWrench,
+  GetModelJointTransmittedWrenches,
+  GetModelJointState,
+  SetModelJointState,
+  ModelJointPDControlFeature
 > { };
 
 class JointFeatures :
     public virtual Base,
     public virtual Implements3d<JointFeatureList>
 {
+  public: using JointPDControl =
+      ModelJointPDControlFeature::JointPDControlT<FeaturePolicy3d>;
+
   // ----- Get Basic Joint State -----
   public: double GetJointPosition(
       const Identity &_id, std::size_t _dof) const override;
@@ -129,6 +138,31 @@ class JointFeatures :
       const BaseLink3dPtr &_parent,
       const std::string &_name) override;
 
+  public: void SetEngineAttachFixedJointAsConstraint(
+      const Identity &_engineID, bool _asConstraint) override;
+
+  public: bool GetEngineAttachFixedJointAsConstraint(
+      const Identity &_engineID) const override;
+
+  /// \brief Attach a fixed joint with a WeldJointConstraint, see
+  /// AttachFixedJointAsConstraintFeature.
+  /// \param[in] _childID ID of the child link.
+  /// \param[in] _childBn Body node of the child link.
+  /// \param[in] _parentBn Body node of the parent link, nullptr to attach
+  /// the child to the world.
+  /// \param[in] _name Name of the joint.
+  /// \return Identity of the joint.
+  private: Identity AttachFixedJointAsConstraint(
+      const Identity &_childID,
+      DartBodyNode *_childBn,
+      DartBodyNode *_parentBn,
+      const std::string &_name);
+
+  /// \brief Set the relative transform of the weld constraint of a joint
+  /// attached as a constraint from the transforms of the joint.
+  /// \param[in] _jointInfo Joint to update.
+  private: static void UpdateWeldConstraint(const JointInfo &_jointInfo);
+
 
   // ----- Free Joint -----
   public: Identity CastToFreeJoint(
@@ -203,6 +237,48 @@ class JointFeatures :
   // ----- Transmitted wrench -----
   public: Wrench3d GetJointTransmittedWrenchInJointFrame(
       const Identity &_id) const override;
+
+  public: void GetModelJointTransmittedWrenches(
+      const Identity &_modelID,
+      std::vector<Wrench3d> &_wrenches) const override;
+
+  // ----- Model joint state -----
+  public: void GetModelJointPositions(
+      const Identity &_modelID, Eigen::VectorXd &_positions) const override;
+
+  public: void GetModelJointVelocities(
+      const Identity &_modelID, Eigen::VectorXd &_velocities) const override;
+
+  public: void GetModelJointAccelerations(
+      const Identity &_modelID,
+      Eigen::VectorXd &_accelerations) const override;
+
+  public: void GetModelJointForces(
+      const Identity &_modelID, Eigen::VectorXd &_forces) const override;
+
+  public: void SetModelJointPositions(
+      const Identity &_modelID, const Eigen::VectorXd &_positions) override;
+
+  public: void SetModelJointVelocities(
+      const Identity &_modelID, const Eigen::VectorXd &_velocities) override;
+
+  public: void SetModelJointAccelerations(
+      const Identity &_modelID,
+      const Eigen::VectorXd &_accelerations) override;
+
+  public: void SetModelJointForces(
+      const Identity &_modelID, const Eigen::VectorXd &_forces) override;
+
+  // ----- Joint PD control -----
+  public: bool SetModelJointPDControl(
+      const Identity &_modelID, const JointPDControl &_control) override;
+
+  public: bool SetModelJointPDControlTargets(
+      const Identity &_modelID,
+      const Eigen::VectorXd &_positions,
+      const Eigen::VectorXd &_velocities) override;
+
+  public: void RemoveModelJointPDControl(const Identity &_modelID) override;
 };
 
 }
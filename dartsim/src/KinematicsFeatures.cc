@@ -24,9 +24,40 @@ namespace gz {
 namespace physics {
 namespace dartsim {
 
+/////////////////////////////////////////////////
+/// \brief Read the FrameData of a frame. The pose is always read; the
+/// velocities and accelerations are only read when they are requested, since
+/// DART computes them recursively from the root of the skeleton.
+template <typename Scalar>
+static FrameData<Scalar, 3> FrameDataOf(
+    const dart::dynamics::Frame &_frame,
+    const FrameDataComponents _components = FRAME_DATA_ALL)
+{
+  FrameData<Scalar, 3> data;
+  data.pose = _frame.getWorldTransform().cast<Scalar>();
+  if (_components & FRAME_DATA_VELOCITY)
+  {
+    data.linearVelocity = _frame.getLinearVelocity().cast<Scalar>();
+    data.angularVelocity = _frame.getAngularVelocity().cast<Scalar>();
+  }
+  if (_components & FRAME_DATA_ACCELERATION)
+  {
+    data.linearAcceleration = _frame.getLinearAcceleration().cast<Scalar>();
+    data.angularAcceleration = _frame.getAngularAcceleration().cast<Scalar>();
+  }
+  return data;
+}
+
 /////////////////////////////////////////////////
 FrameData3d KinematicsFeatures::FrameDataRelativeToWorld(
     const FrameID &_id) const
+{
+  return this->PartialFrameDataRelativeToWorld(_id, FRAME_DATA_ALL);
+}
+
+/////////////////////////////////////////////////
+FrameData3d KinematicsFeatures::PartialFrameDataRelativeToWorld(
+    const FrameID &_id, const FrameDataComponents _components) const
 {
   FrameData3d data;
 
@@ -39,6 +70,9 @@ FrameData3d KinematicsFeatures::FrameDataRelativeToWorld(
     return data;
   }
 
+  if (this->frameDataCache.Find(_id.ID(), data))
+    return data;
+
   const dart::dynamics::Frame *frame = SelectFrame(_id);
   // A missing frame ID indicates that frame semantics is not properly
   // implemented for the type of frame represented by the ID.
@@ -51,25 +85,109 @@ FrameData3d KinematicsFeatures::FrameDataRelativeToWorld(
     return data;
   }
 
-  data.pose = frame->getWorldTransform();
-  data.linearVelocity = frame->getLinearVelocity();
-  data.angularVelocity = frame->getAngularVelocity();
-  data.linearAcceleration = frame->getLinearAcceleration();
-  data.angularAcceleration = frame->getAngularAcceleration();
+  data = FrameDataOf<double>(*frame, _components);
 
+  // Only complete FrameData is cached, since it answers every query.
+  if ((_components & FRAME_DATA_ALL) == FRAME_DATA_ALL)
+    this->frameDataCache.Insert(_id.ID(), data);
   return data;
 }
 
+/////////////////////////////////////////////////
+void KinematicsFeatures::BatchFrameDataRelativeToWorld(
+    const FrameID *_ids,
+    const std::size_t _count,
+    FrameData3d *_output) const
+{
+  this->FillBatchFrameData(_ids, _count, _output);
+}
+
+/////////////////////////////////////////////////
+void KinematicsFeatures::LinkFrameDataRelativeToWorld(
+    const Identity &_modelID,
+    std::vector<FrameData3d> &_output) const
+{
+  this->FillLinkFrameData(_modelID, _output);
+}
+
+/////////////////////////////////////////////////
+void KinematicsFeatures::BatchFloatFrameDataRelativeToWorld(
+    const FrameID *_ids,
+    const std::size_t _count,
+    FrameData3f *_output) const
+{
+  this->FillBatchFrameData(_ids, _count, _output);
+}
+
+/////////////////////////////////////////////////
+void KinematicsFeatures::LinkFloatFrameDataRelativeToWorld(
+    const Identity &_modelID,
+    std::vector<FrameData3f> &_output) const
+{
+  this->FillLinkFrameData(_modelID, _output);
+}
+
+/////////////////////////////////////////////////
+template <typename Scalar>
+void KinematicsFeatures::FillBatchFrameData(
+    const FrameID *_ids,
+    const std::size_t _count,
+    FrameData<Scalar, 3> *_output) const
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const dart::dynamics::Frame *frame =
+        _ids[i].IsWorld() ? nullptr : this->SelectFrame(_ids[i]);
+    if (nullptr == frame)
+    {
+      // Report the bad frame the same way as the single frame query.
+      _output[i] =
+          CastFrameData<Scalar>(this->FrameDataRelativeToWorld(_ids[i]));
+      continue;
+    }
+
+    _output[i] = FrameDataOf<Scalar>(*frame);
+  }
+}
+
+/////////////////////////////////////////////////
+template <typename Scalar>
+void KinematicsFeatures::FillLinkFrameData(
+    const Identity &_modelID,
+    std::vector<FrameData<Scalar, 3>> &_output) const
+{
+  const auto *modelInfo = this->ReferenceInterface<ModelInfo>(_modelID);
+  _output.resize(modelInfo->links.size());
+  for (std::size_t i = 0; i < modelInfo->links.size(); ++i)
+  {
+    const auto *frame = modelInfo->links[i]->Frame();
+    _output[i] = (nullptr == frame) ?
+        FrameData<Scalar, 3>() : FrameDataOf<Scalar>(*frame);
+  }
+}
+
+/////////////////////////////////////////////////
+void KinematicsFeatures::SetFrameDataCacheEnabled(
+    const Identity &, const bool _enabled)
+{
+  this->frameDataCache.SetEnabled(_enabled);
+}
+
+/////////////////////////////////////////////////
+bool KinematicsFeatures::GetFrameDataCacheEnabled(const Identity &) const
+{
+  return this->frameDataCache.Enabled();
+}
+
 /////////////////////////////////////////////////
 const dart::dynamics::Frame *KinematicsFeatures::SelectFrame(
     const FrameID &_id) const
 {
-  const auto model_it = this->models.idToObject.find(_id.ID());
-  if (model_it != this->models.idToObject.end())
+  if (const auto *modelInfo = this->models.Find(_id.ID()))
   {
     // This is a model FreeGroup frame, so we'll use the first root link as the
     // frame
-    return model_it->second->model->getRootBodyNode();
+    return (*modelInfo)->model->getRootBodyNode();
   }
 
   auto framesIt = this->frames.find(_id.ID());
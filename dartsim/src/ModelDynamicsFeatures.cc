@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ModelDynamicsFeatures.hh"
+
+#include <dart/dynamics/BodyNode.hpp>
+#include <dart/dynamics/DegreeOfFreedom.hpp>
+#include <dart/dynamics/Joint.hpp>
+#include <dart/dynamics/Skeleton.hpp>
+
+namespace gz::physics::dartsim
+{
+
+/////////////////////////////////////////////////
+void ModelDynamicsFeatures::GetModelDynamics(
+    const Identity &_modelID, ModelDynamics &_dynamics) const
+{
+  constexpr std::size_t rows = ModelDynamics::LinkJacobianRows;
+
+  const auto *modelInfo = this->ReferenceInterface<ModelInfo>(_modelID);
+  const dart::dynamics::SkeletonPtr &skeleton = modelInfo->model;
+  const auto numDofs = static_cast<Eigen::Index>(skeleton->getNumDofs());
+
+  // DART caches these in the skeleton until its state changes
+  _dynamics.massMatrix = skeleton->getMassMatrix();
+  _dynamics.coriolisAndGravity = skeleton->getCoriolisAndGravityForces();
+
+  _dynamics.linkJacobians.setZero(
+      static_cast<Eigen::Index>(rows * modelInfo->links.size()), numDofs);
+  for (std::size_t i = 0; i < modelInfo->links.size(); ++i)
+  {
+    const dart::dynamics::BodyNode *bn = modelInfo->links[i]->link;
+
+    // Links that were moved to another skeleton, e.g. by detaching a joint,
+    // do not move with the coordinates of this model.
+    if (nullptr == bn || bn->getSkeleton() != skeleton)
+      continue;
+
+    // DART puts the angular rows first
+    const dart::math::Jacobian J = skeleton->getWorldJacobian(bn);
+    const auto row = static_cast<Eigen::Index>(rows * i);
+    _dynamics.linkJacobians.block(row, 0, 3, numDofs) = J.bottomRows<3>();
+    _dynamics.linkJacobians.block(row + 3, 0, 3, numDofs) = J.topRows<3>();
+  }
+
+  _dynamics.jointCoordinates.assign(
+      modelInfo->joints.size(), ModelDynamics::kNoCoordinate);
+  for (std::size_t i = 0; i < modelInfo->joints.size(); ++i)
+  {
+    const dart::dynamics::Joint *joint = modelInfo->joints[i]->joint.get();
+    if (nullptr == joint || joint->getNumDofs() == 0
+        || joint->getSkeleton() != skeleton)
+    {
+      continue;
+    }
+
+    _dynamics.jointCoordinates[i] = joint->getIndexInSkeleton(0);
+  }
+}
+
+/////////////////////////////////////////////////
+auto ModelDynamicsFeatures::ComputeModelInverseDynamics(
+    const Identity &_modelID,
+    const GeneralizedVector &_accelerations) const -> GeneralizedVector
+{
+  const auto *modelInfo = this->ReferenceInterface<ModelInfo>(_modelID);
+  const dart::dynamics::SkeletonPtr &skeleton = modelInfo->model;
+
+  if (static_cast<std::size_t>(_accelerations.size())
+      != skeleton->getNumDofs())
+  {
+    return GeneralizedVector();
+  }
+
+  // Skeleton::computeInverseDynamics would overwrite the joint forces that
+  // were commanded for the next step, so the forces are computed from the
+  // equations of motion instead.
+  return skeleton->getMassMatrix() * _accelerations
+      + skeleton->getCoriolisAndGravityForces();
+}
+
+/////////////////////////////////////////////////
+/// \brief Generalized accelerations of a skeleton at its current state,
+/// without contacts or other constraints.
+/// \param[in] _skeleton The skeleton
+/// \param[in] _forces Generalized forces of its joints
+/// \return One acceleration per coordinate
+static Eigen::VectorXd UnconstrainedAccelerations(
+    dart::dynamics::Skeleton &_skeleton, const Eigen::VectorXd &_forces)
+{
+  return _skeleton.getInvMassMatrix() * (_forces
+      + _skeleton.getExternalForces()
+      - _skeleton.getCoriolisAndGravityForces());
+}
+
+/////////////////////////////////////////////////
+void ModelDynamicsFeatures::GetModelStepDerivatives(
+    const Identity &_modelID, StepDerivatives &_derivatives) const
+{
+  const auto *modelInfo = this->ReferenceInterface<ModelInfo>(_modelID);
+  dart::dynamics::Skeleton &skeleton = *modelInfo->model;
+  const auto numDofs = static_cast<Eigen::Index>(skeleton.getNumDofs());
+  const double dt = skeleton.getTimeStep();
+  _derivatives.timeStep = dt;
+
+  // Only force actuated joints apply their commands as forces
+  Eigen::VectorXd forces = Eigen::VectorXd::Zero(numDofs);
+  for (Eigen::Index i = 0; i < numDofs; ++i)
+  {
+    const auto *dof = skeleton.getDof(static_cast<std::size_t>(i));
+    if (dof->getJoint()->getActuatorType() == dart::dynamics::Joint::FORCE)
+      forces[i] = dof->getCommand();
+  }
+
+  // DART does not differentiate its dynamics, so the accelerations are
+  // differentiated with respect to the state by central differences. Only
+  // the forward dynamics of the skeleton is evaluated for each of them, not
+  // collision detection or the constraint solver of its world.
+  const double h = 1e-6;
+  Eigen::MatrixXd accelerationJacobian(numDofs, 2 * numDofs);
+  const Eigen::VectorXd positions = skeleton.getPositions();
+  Eigen::VectorXd perturbed = positions;
+  for (Eigen::Index j = 0; j < numDofs; ++j)
+  {
+    perturbed[j] = positions[j] + h;
+    skeleton.setPositions(perturbed);
+    accelerationJacobian.col(j) = UnconstrainedAccelerations(skeleton, forces);
+    perturbed[j] = positions[j] - h;
+    skeleton.setPositions(perturbed);
+    accelerationJacobian.col(j) -= UnconstrainedAccelerations(skeleton, forces);
+    accelerationJacobian.col(j) /= 2.0 * h;
+    perturbed[j] = positions[j];
+  }
+  skeleton.setPositions(positions);
+
+  const Eigen::VectorXd velocities = skeleton.getVelocities();
+  perturbed = velocities;
+  for (Eigen::Index j = 0; j < numDofs; ++j)
+  {
+    const Eigen::Index col = numDofs + j;
+    perturbed[j] = velocities[j] + h;
+    skeleton.setVelocities(perturbed);
+    accelerationJacobian.col(col) =
+        UnconstrainedAccelerations(skeleton, forces);
+    perturbed[j] = velocities[j] - h;
+    skeleton.setVelocities(perturbed);
+    accelerationJacobian.col(col) -=
+        UnconstrainedAccelerations(skeleton, forces);
+    accelerationJacobian.col(col) /= 2.0 * h;
+    perturbed[j] = velocities[j];
+  }
+  skeleton.setVelocities(velocities);
+
+  // dartsim integrates with semi-implicit Euler, v' = v + dt * a followed
+  // by q' = q + dt * v', and the accelerations are linear in the forces.
+  const Eigen::Index rows = 2 * numDofs;
+  _derivatives.stateJacobian.resize(rows, rows);
+  auto velocityRows = _derivatives.stateJacobian.bottomRows(numDofs);
+  velocityRows = dt * accelerationJacobian;
+  velocityRows.rightCols(numDofs).diagonal().array() += 1.0;
+  _derivatives.stateJacobian.topRows(numDofs) = dt * velocityRows;
+  _derivatives.stateJacobian.topLeftCorner(numDofs, numDofs)
+      .diagonal().array() += 1.0;
+
+  _derivatives.forceJacobian.resize(rows, numDofs);
+  _derivatives.forceJacobian.bottomRows(numDofs) =
+      dt * skeleton.getInvMassMatrix();
+  _derivatives.forceJacobian.topRows(numDofs) =
+      dt * _derivatives.forceJacobian.bottomRows(numDofs);
+}
+
+}  // namespace gz::physics::dartsim
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GZ_PHYSICS_DARTSIM_SRC_MODELDYNAMICSFEATURES_HH_
+#define GZ_PHYSICS_DARTSIM_SRC_MODELDYNAMICSFEATURES_HH_
+
+#include <gz/physics/ModelDynamics.hh>
+
+#include "Base.hh"
+
+namespace gz::physics::dartsim
+{
+
+struct ModelDynamicsFeatureList: FeatureList<
+  ModelDynamicsFeature,
+  ModelStepDerivativesFeature
+> { };
+
+class ModelDynamicsFeatures :
+    public virtual Base,
+    public virtual Implements3d<ModelDynamicsFeatureList>
+{
+  public: using ModelDynamics =
+      ModelDynamicsFeature::ModelDynamicsT<FeaturePolicy3d>;
+  public: using GeneralizedVector = ModelDynamics::GeneralizedVector;
+  public: using StepDerivatives =
+      ModelStepDerivativesFeature::StepDerivativesT<FeaturePolicy3d>;
+
+  // Documentation inherited
+  public: void GetModelDynamics(
+      const Identity &_modelID, ModelDynamics &_dynamics) const override;
+
+  // Documentation inherited
+  public: GeneralizedVector ComputeModelInverseDynamics(
+      const Identity &_modelID,
+      const GeneralizedVector &_accelerations) const override;
+
+  // Documentation inherited
+  public: void GetModelStepDerivatives(
+      const Identity &_modelID,
+      StepDerivatives &_derivatives) const override;
+};
+}  // namespace gz::physics::dartsim
+
+#endif  // GZ_PHYSICS_DARTSIM_SRC_MODELDYNAMICSFEATURES_HH_
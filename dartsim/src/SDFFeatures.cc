@@ -20,6 +20,9 @@
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include <dart/constraint/ConstraintSolver.hpp>
@@ -45,6 +48,7 @@
 #include <gz/common/MeshManager.hh>
 #include <gz/math/eigen3/Conversions.hh>
 #include <gz/math/Helpers.hh>
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
 
 #include <sdf/Box.hh>
 #include <sdf/Collision.hh>
@@ -66,6 +70,7 @@
 
 #include "AddedMassFeatures.hh"
 #include "CustomMeshShape.hh"
+#include "GzOdeCollisionDetector.hh"
 
 namespace gz {
 namespace physics {
@@ -98,6 +103,102 @@ static Eigen::Isometry3d ResolveSdfPose(const ::sdf::SemanticPose &_semPose)
   return math::eigen3::convert(pose);
 }
 
+/////////////////////////////////////////////////
+/// \brief Links of a model that are merged into other links through fixed
+/// joints, see sdf::MergeFixedJoints.
+struct FixedJointMerge
+{
+  /// \brief Name of the link that each merged link is merged into, by the
+  /// name of the merged link. The links merged into are not merged
+  /// themselves.
+  std::unordered_map<std::string, std::string> rootOf;
+
+  /// \brief Names of the fixed joints of the merged links, which are not
+  /// constructed.
+  std::unordered_set<std::string> joints;
+};
+
+/////////////////////////////////////////////////
+/// \brief Find the links of a model that can be merged into other links
+/// through fixed joints. A link is merged into the parent link of its fixed
+/// joint if it is not the canonical link of the model, is the child of no
+/// other joint, is the parent of fixed joints only and has no fluid added
+/// mass. Joints with links in nested models or the world are left alone.
+static FixedJointMerge FindFixedJointMerge(const ::sdf::Model &_sdfModel)
+{
+  std::string canonical = _sdfModel.CanonicalLinkName();
+  if (canonical.empty() && _sdfModel.LinkCount() > 0)
+    canonical = _sdfModel.LinkByIndex(0)->Name();
+
+  // Links that may not be merged, and the number of joints each link is the
+  // child of
+  std::unordered_set<std::string> articulated;
+  std::unordered_map<std::string, std::size_t> parentJointCount;
+  // Pairs of parent link and joint name, by child link
+  std::unordered_map<std::string, std::pair<std::string, std::string>>
+      fixedParents;
+  for (std::size_t i = 0; i < _sdfModel.JointCount(); ++i)
+  {
+    const ::sdf::Joint *sdfJoint = _sdfModel.JointByIndex(i);
+    if (!sdfJoint)
+      continue;
+
+    std::string parent;
+    std::string child;
+    if (!sdfJoint->ResolveParentLink(parent).empty() ||
+        !sdfJoint->ResolveChildLink(child).empty())
+    {
+      articulated.insert(sdfJoint->ParentName());
+      articulated.insert(sdfJoint->ChildName());
+      continue;
+    }
+
+    ++parentJointCount[child];
+    if (sdfJoint->Type() != ::sdf::JointType::FIXED)
+    {
+      articulated.insert(parent);
+      articulated.insert(child);
+      continue;
+    }
+    fixedParents[child] = {parent, sdfJoint->Name()};
+  }
+
+  std::unordered_map<std::string, std::pair<std::string, std::string>>
+      candidates;
+  for (const auto &[child, parentAndJoint] : fixedParents)
+  {
+    if (child == canonical || parentJointCount[child] != 1u ||
+        articulated.count(child) > 0u ||
+        !_sdfModel.LinkNameExists(child) ||
+        !_sdfModel.LinkNameExists(parentAndJoint.first) ||
+        _sdfModel.LinkByName(child)->Inertial().FluidAddedMass().has_value())
+    {
+      continue;
+    }
+    candidates.insert({child, parentAndJoint});
+  }
+
+  FixedJointMerge merge;
+  for (const auto &[child, parentAndJoint] : candidates)
+  {
+    // Follow chains of fixed joints up to a link that is not merged. Links
+    // in a loop of fixed joints never get there and are not merged.
+    std::string root = parentAndJoint.first;
+    for (std::size_t steps = 0;
+         candidates.count(root) > 0u && steps < candidates.size(); ++steps)
+    {
+      root = candidates.at(root).first;
+    }
+    if (candidates.count(root) > 0u)
+      continue;
+
+    merge.rootOf[child] = root;
+    merge.joints.insert(parentAndJoint.second);
+  }
+
+  return merge;
+}
+
 /////////////////////////////////////////////////
 double infIfNeg(const double _value)
 {
@@ -250,38 +351,54 @@ struct ShapeAndTransform
 
 /////////////////////////////////////////////////
 static ShapeAndTransform ConstructBox(
-    const ::sdf::Box &_box)
+    Base &_base, const ::sdf::Box &_box)
 {
-  return {std::make_shared<dart::dynamics::BoxShape>(
-        math::eigen3::convert(_box.Size()))};
+  const Eigen::Vector3d size = math::eigen3::convert(_box.Size());
+  return {_base.InternShape(
+      ShapeKey("box", size.x(), size.y(), size.z()), [&]
+      {
+        return std::make_shared<dart::dynamics::BoxShape>(size);
+      })};
 }
 
 /////////////////////////////////////////////////
 static ShapeAndTransform ConstructCylinder(
-    const ::sdf::Cylinder &_cylinder)
+    Base &_base, const ::sdf::Cylinder &_cylinder)
 {
-  return {std::make_shared<dart::dynamics::CylinderShape>(
-        _cylinder.Radius(), _cylinder.Length())};
+  return {_base.InternShape(
+      ShapeKey("cylinder", _cylinder.Radius(), _cylinder.Length()), [&]
+      {
+        return std::make_shared<dart::dynamics::CylinderShape>(
+            _cylinder.Radius(), _cylinder.Length());
+      })};
 }
 
 /////////////////////////////////////////////////
 static ShapeAndTransform ConstructSphere(
-    const ::sdf::Sphere &_sphere)
+    Base &_base, const ::sdf::Sphere &_sphere)
 {
-  return {std::make_shared<dart::dynamics::SphereShape>(_sphere.Radius())};
+  return {_base.InternShape(ShapeKey("sphere", _sphere.Radius()), [&]
+      {
+        return std::make_shared<dart::dynamics::SphereShape>(
+            _sphere.Radius());
+      })};
 }
 
 /////////////////////////////////////////////////
 static ShapeAndTransform ConstructCapsule(
-    const ::sdf::Capsule &_capsule)
+    Base &_base, const ::sdf::Capsule &_capsule)
 {
-  return {std::make_shared<dart::dynamics::CapsuleShape>(
-        _capsule.Radius(), _capsule.Length())};
+  return {_base.InternShape(
+      ShapeKey("capsule", _capsule.Radius(), _capsule.Length()), [&]
+      {
+        return std::make_shared<dart::dynamics::CapsuleShape>(
+            _capsule.Radius(), _capsule.Length());
+      })};
 }
 
 /////////////////////////////////////////////////
 static ShapeAndTransform ConstructPlane(
-    const ::sdf::Plane &_plane)
+    Base &_base, const ::sdf::Plane &_plane)
 {
   // TODO(anyone): We use BoxShape until PlaneShape is completely supported in
   // DART. Please see: https://github.com/dartsim/dart/issues/114
@@ -296,12 +413,17 @@ static ShapeAndTransform ConstructPlane(
   if (angle > 1e-12)
     tf.rotate(Eigen::AngleAxisd(angle, axis/norm));
 
-  // This number was taken from osrf/gazebo. Seems arbitrary.
-  const double planeDim = 2100;
+  // The ODE collision detector tests the box like a plane, see
+  // GzOdeCollisionDetector::ApplyPlaneBits
+  const double planeDim =
+      dart::collision::GzOdeCollisionDetector::kPlaneBoxSize;
   tf.translate(Eigen::Vector3d(0.0, 0.0, -planeDim*0.5));
 
-  return {std::make_shared<dart::dynamics::BoxShape>(
-          Eigen::Vector3d(planeDim, planeDim, planeDim)), tf};
+  return {_base.InternShape(ShapeKey("box", planeDim, planeDim, planeDim), [&]
+      {
+        return std::make_shared<dart::dynamics::BoxShape>(
+            Eigen::Vector3d(planeDim, planeDim, planeDim));
+      }), tf};
 }
 
 /////////////////////////////////////////////////
@@ -330,41 +452,63 @@ static ShapeAndTransform ConstructMesh(
   return {nullptr};
 }
 
+/////////////////////////////////////////////////
+/// \brief Number of convex hulls a mesh collision is decomposed into
+/// \param[in] _meshSdf Mesh of the collision
+/// \return The maximum number of convex hulls, or 0 if the mesh is not
+/// decomposed
+static std::size_t MaxConvexHulls(const ::sdf::Mesh &_meshSdf)
+{
+  if (_meshSdf.Optimization() == ::sdf::MeshOptimization::CONVEX_HULL)
+    return 1u;
+
+  if (_meshSdf.Optimization() ==
+      ::sdf::MeshOptimization::CONVEX_DECOMPOSITION)
+  {
+    if (_meshSdf.ConvexDecomposition())
+      return _meshSdf.ConvexDecomposition()->MaxConvexHulls();
+    return 16u;
+  }
+
+  return 0u;
+}
+
 /////////////////////////////////////////////////
 static ShapeAndTransform ConstructGeometry(
-    const ::sdf::Geometry &_geometry)
+    Base &_base, const ::sdf::Geometry &_geometry)
 {
   if (_geometry.BoxShape())
-    return ConstructBox(*_geometry.BoxShape());
+    return ConstructBox(_base, *_geometry.BoxShape());
   else if (_geometry.CapsuleShape())
   {
-    return ConstructCapsule(*_geometry.CapsuleShape());
+    return ConstructCapsule(_base, *_geometry.CapsuleShape());
   }
   else if (_geometry.CylinderShape())
-    return ConstructCylinder(*_geometry.CylinderShape());
+    return ConstructCylinder(_base, *_geometry.CylinderShape());
   else if (_geometry.EllipsoidShape())
   {
     // TODO(anyone): Replace this code when Ellipsoid is supported by DART
-    common::MeshManager *meshMgr = common::MeshManager::Instance();
-    std::string ellipsoidMeshName = std::string("ellipsoid_mesh")
-      + "_" + std::to_string(_geometry.EllipsoidShape()->Radii().X())
-      + "_" + std::to_string(_geometry.EllipsoidShape()->Radii().Y())
-      + "_" + std::to_string(_geometry.EllipsoidShape()->Radii().Z());
-    meshMgr->CreateEllipsoid(
-      ellipsoidMeshName,
-      _geometry.EllipsoidShape()->Radii(),
-      6, 12);
-    const gz::common::Mesh * _mesh =
-      meshMgr->MeshByName(ellipsoidMeshName);
-
-    auto mesh = std::make_shared<CustomMeshShape>(*_mesh, Vector3d(1, 1, 1));
-    auto mesh2 = std::dynamic_pointer_cast<dart::dynamics::MeshShape>(mesh);
-    return {mesh2};
+    const math::Vector3d radii = _geometry.EllipsoidShape()->Radii();
+    return {_base.InternShape(
+        ShapeKey("ellipsoid6x12", radii.X(), radii.Y(), radii.Z()), [&]
+        {
+          common::MeshManager *meshMgr = common::MeshManager::Instance();
+          std::string ellipsoidMeshName = std::string("ellipsoid_mesh")
+            + "_" + std::to_string(radii.X())
+            + "_" + std::to_string(radii.Y())
+            + "_" + std::to_string(radii.Z());
+          meshMgr->CreateEllipsoid(ellipsoidMeshName, radii, 6, 12);
+          const gz::common::Mesh * _mesh =
+            meshMgr->MeshByName(ellipsoidMeshName);
+
+          return std::make_shared<CustomMeshShape>(
+              *_mesh, Vector3d(1, 1, 1));
+        })};
   }
   else if (_geometry.SphereShape())
-    return ConstructSphere(*_geometry.SphereShape());
+    return ConstructSphere(_base, *_geometry.SphereShape());
   else if (_geometry.PlaneShape())
-    return ConstructPlane(*_geometry.PlaneShape());
+    return ConstructPlane(_base, *_geometry.PlaneShape());
   else if (_geometry.MeshShape())
     return ConstructMesh(*_geometry.MeshShape());
   else if (_geometry.HeightmapShape())
@@ -469,15 +613,10 @@ Identity SDFFeatures::ConstructSdfWorld(
     const Identity &_engine,
     const ::sdf::World &_sdfWorld)
 {
-  const Identity worldID = this->ConstructEmptyWorld(_engine, _sdfWorld.Name());
-
-  const dart::simulation::WorldPtr &world = this->worlds.at(worldID);
-
-  world->setGravity(math::eigen3::convert(_sdfWorld.Gravity()));
-
-  // TODO(MXG): Add a Physics class to the SDFormat DOM and then parse that
-  // information here. For now, we'll just use dartsim's default physics
-  // parameters.
+  const Identity worldID =
+      this->ConstructSdfWorldProperties(_engine, _sdfWorld);
+  sdf::LoadTimer::WorldScope worldScope(
+      this->loadTimer, this->loadReports[worldID]);
 
   for (std::size_t i = 0; i < _sdfWorld.ModelCount(); ++i)
   {
@@ -489,31 +628,118 @@ Identity SDFFeatures::ConstructSdfWorld(
     this->ConstructSdfNestedModel(worldID, *model);
   }
 
-  auto modelProxy = this->modelProxiesToWorld.MaybeAt(worldID);
-  if (modelProxy)
+  this->ConstructSdfWorldJoints(worldID, _sdfWorld);
+  return worldID;
+}
+
+/////////////////////////////////////////////////
+Identity SDFFeatures::StartConstructSdfWorld(
+    const Identity &_engine,
+    const ::sdf::World &_sdfWorld)
+{
+  const Identity worldID =
+      this->ConstructSdfWorldProperties(_engine, _sdfWorld);
+  this->pendingSdfWorlds[worldID] = {&_sdfWorld, 0u};
+  return worldID;
+}
+
+/////////////////////////////////////////////////
+bool SDFFeatures::ContinueSdfWorldConstruction(
+    const Identity &_worldID,
+    const std::chrono::steady_clock::duration _budget)
+{
+  auto it = this->pendingSdfWorlds.find(_worldID);
+  if (it == this->pendingSdfWorlds.end())
+    return true;
+
+  sdf::LoadTimer::WorldScope worldScope(
+      this->loadTimer, this->loadReports[_worldID]);
+  const auto deadline = std::chrono::steady_clock::now() + _budget;
+
+  PendingSdfWorld &pending = it->second;
+  const ::sdf::World &sdfWorld = *pending.sdfWorld;
+  while (pending.nextModel < sdfWorld.ModelCount())
   {
-    for (std::size_t i = 0; i < _sdfWorld.JointCount(); ++i)
+    const ::sdf::Model *model = sdfWorld.ModelByIndex(pending.nextModel++);
+    if (model)
+      this->ConstructSdfNestedModel(_worldID, *model);
+
+    if (pending.nextModel < sdfWorld.ModelCount() &&
+        std::chrono::steady_clock::now() >= deadline)
     {
-      const ::sdf::Joint *sdfJoint = _sdfWorld.JointByIndex(i);
-      if (!sdfJoint)
-      {
-        gzerr << "The joint with index [" << i << "] in world ["
-              << _sdfWorld.Name() << "] is a nullptr. It will be skipped.\n";
-        continue;
-      }
-      auto parentAndChild = this->FindParentAndChildOfJoint(
-          worldID, sdfJoint, _sdfWorld.Name(), "world");
-      if (parentAndChild)
-      {
-        auto [parent, child] = *parentAndChild;
-        this->ConstructSdfJoint(this->GetWorldModel(worldID), *sdfJoint, parent,
-                                child);
-      }
+      return false;
     }
   }
+
+  this->ConstructSdfWorldJoints(_worldID, sdfWorld);
+  this->pendingSdfWorlds.erase(it);
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::size_t SDFFeatures::GetPendingSdfModelCount(
+    const Identity &_worldID) const
+{
+  auto it = this->pendingSdfWorlds.find(_worldID);
+  if (it == this->pendingSdfWorlds.end())
+    return 0u;
+  return it->second.sdfWorld->ModelCount() - it->second.nextModel;
+}
+
+/////////////////////////////////////////////////
+Identity SDFFeatures::ConstructSdfWorldProperties(
+    const Identity &_engine,
+    const ::sdf::World &_sdfWorld)
+{
+  const Identity worldID = this->ConstructEmptyWorld(_engine, _sdfWorld.Name());
+  auto &loadReport = this->loadReports[worldID];
+  loadReport = {};
+  sdf::LoadTimer::WorldScope worldScope(this->loadTimer, loadReport);
+
+  const dart::simulation::WorldPtr &world = this->worlds.at(worldID);
+
+  world->setGravity(math::eigen3::convert(_sdfWorld.Gravity()));
+
+  // TODO(MXG): Add a Physics class to the SDFormat DOM and then parse that
+  // information here. For now, we'll just use dartsim's default physics
+  // parameters.
+
   return worldID;
 }
 
+/////////////////////////////////////////////////
+void SDFFeatures::ConstructSdfWorldJoints(
+    const Identity &_worldID,
+    const ::sdf::World &_sdfWorld)
+{
+  auto modelProxy = this->modelProxiesToWorld.MaybeAt(_worldID);
+  if (!modelProxy)
+    return;
+
+  for (std::size_t i = 0; i < _sdfWorld.JointCount(); ++i)
+  {
+    const ::sdf::Joint *sdfJoint = _sdfWorld.JointByIndex(i);
+    if (!sdfJoint)
+    {
+      gzerr << "The joint with index [" << i << "] in world ["
+            << _sdfWorld.Name() << "] is a nullptr. It will be skipped.\n";
+      continue;
+    }
+    auto parentAndChild = this->loadTimer.Measure(
+        sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+        {
+          return this->FindParentAndChildOfJoint(
+              _worldID, sdfJoint, _sdfWorld.Name(), "world");
+        });
+    if (parentAndChild)
+    {
+      auto [parent, child] = *parentAndChild;
+      this->ConstructSdfJoint(this->GetWorldModel(_worldID), *sdfJoint,
+                              parent, child);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 Identity SDFFeatures::ConstructSdfModel(
     const Identity &_parentID,
@@ -522,6 +748,26 @@ Identity SDFFeatures::ConstructSdfModel(
   return this->ConstructSdfModelImpl(_parentID, _sdfModel);
 }
 
+/////////////////////////////////////////////////
+std::vector<Identity> SDFFeatures::ConstructSdfModels(
+    const Identity &_worldID,
+    const std::vector<const ::sdf::Model *> &_sdfModels)
+{
+  // dart adds the shapes of a skeleton to the collision group of the world
+  // as the skeleton is added, and has no way to defer that, so the models
+  // are constructed one by one.
+  std::vector<Identity> result;
+  result.reserve(_sdfModels.size());
+  for (const ::sdf::Model *sdfModel : _sdfModels)
+  {
+    if (sdfModel)
+      result.push_back(this->ConstructSdfModelImpl(_worldID, *sdfModel));
+    else
+      result.push_back(this->GenerateInvalidId());
+  }
+  return result;
+}
+
 /////////////////////////////////////////////////
 Identity SDFFeatures::ConstructSdfNestedModel(const Identity &_parentID,
                                               const ::sdf::Model &_sdfModel)
@@ -560,6 +806,10 @@ Identity SDFFeatures::ConstructSdfModelImpl(
     }
   }
 
+  // Nested models are charged to the model they were constructed with.
+  sdf::LoadTimer::ModelScope modelScope(
+      this->loadTimer, this->loadReports[worldID], modelName);
+
   dart::dynamics::Frame *parentFrame = this->frames.at(_parentID);
 
   dart::dynamics::SkeletonPtr model =
@@ -568,7 +818,10 @@ Identity SDFFeatures::ConstructSdfModelImpl(
   dart::dynamics::SimpleFramePtr modelFrame =
       dart::dynamics::SimpleFrame::createShared(
           parentFrame, modelName + "::__model__",
-          ResolveSdfPose(_sdfModel.SemanticPose()));
+          this->loadTimer.Measure(sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+          {
+            return ResolveSdfPose(_sdfModel.SemanticPose());
+          }));
 
   // Set canonical link name
   // TODO(anyone) This may not work correctly with nested models and will need
@@ -599,11 +852,24 @@ Identity SDFFeatures::ConstructSdfModelImpl(
   {
     this->ConstructSdfModelImpl(modelID, *_sdfModel.ModelByIndex(i));
   }
+  const FixedJointMerge merge = this->mergeFixedJoints ?
+      this->loadTimer.Measure(sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+      {
+        return FindFixedJointMerge(_sdfModel);
+      }) : FixedJointMerge();
+
   // then, construct all links
   for (std::size_t i=0; i < _sdfModel.LinkCount(); ++i)
   {
-    this->FindOrConstructLink(
-          model, modelIdentity, _sdfModel, _sdfModel.LinkByIndex(i)->Name());
+    const std::string &linkName = _sdfModel.LinkByIndex(i)->Name();
+    if (merge.rootOf.count(linkName) == 0u)
+      this->FindOrConstructLink(model, modelIdentity, _sdfModel, linkName);
+  }
+
+  if (!merge.rootOf.empty())
+  {
+    this->ConstructMergedSdfLinks(
+        model, modelIdentity, _sdfModel, merge.rootOf);
   }
 
   // Next, join all links that have joints
@@ -616,8 +882,14 @@ Identity SDFFeatures::ConstructSdfModelImpl(
         << modelName << "] is a nullptr. It will be skipped.\n";
       continue;
     }
-    auto parentAndChild =
-        this->FindParentAndChildOfJoint(worldID, sdfJoint, modelName, "model");
+    if (merge.joints.count(sdfJoint->Name()) > 0u)
+      continue;
+    auto parentAndChild = this->loadTimer.Measure(
+        sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+        {
+          return this->FindParentAndChildOfJoint(
+              worldID, sdfJoint, modelName, "model");
+        });
     if (parentAndChild)
     {
       auto [parent, child] = *parentAndChild;
@@ -667,8 +939,11 @@ Identity SDFFeatures::ConstructSdfLink(
       dart::dynamics::FreeJoint>(nullptr, jointProperties, bodyProperties);
 
   dart::dynamics::FreeJoint * const joint = result.first;
-  const Eigen::Isometry3d tf =
-      GetParentModelFrame(modelInfo) * ResolveSdfPose(_sdfLink.SemanticPose());
+  const Eigen::Isometry3d tf = GetParentModelFrame(modelInfo) *
+      this->loadTimer.Measure(sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+      {
+        return ResolveSdfPose(_sdfLink.SemanticPose());
+      });
 
   joint->setTransform(tf);
 
@@ -821,6 +1096,44 @@ Identity SDFFeatures::ConstructSdfJoint(
   return ConstructSdfJoint(_modelID, _sdfJoint, parent, child);
 }
 
+/////////////////////////////////////////////////
+dart::dynamics::ShapePtr SDFFeatures::ConstructConvexMesh(
+    const ::sdf::Mesh &_meshSdf)
+{
+  auto &meshManager = *common::MeshManager::Instance();
+  const common::Mesh *mesh = this->loadTimer.Measure(
+      sdf::LoadTimer::Phase::MESH_LOADING,
+      [&]{ return meshManager.Load(_meshSdf.Uri()); });
+  if (nullptr == mesh)
+  {
+    gzwarn << "Failed to load mesh from [" << _meshSdf.Uri() << "]."
+           << std::endl;
+    return nullptr;
+  }
+
+  // The decomposition is shared with the other plugins through the
+  // MeshManager and the on-disk cache, so it is only computed once.
+  const std::size_t maxConvexHulls = MaxConvexHulls(_meshSdf);
+  const common::Mesh *convexMesh = this->loadTimer.Measure(
+      sdf::LoadTimer::Phase::CONVEX_DECOMPOSITION, [&]
+      {
+        return physics::mesh::CachedConvexMesh(
+            *mesh, maxConvexHulls, _meshSdf.OptimizationStr());
+      });
+  if (nullptr == convexMesh || convexMesh->SubMeshCount() == 0u)
+    return nullptr;
+
+  // Each hull is a small closed submesh, which collides much faster than the
+  // triangles of the original mesh.
+  const Eigen::Vector3d scale = math::eigen3::convert(_meshSdf.Scale());
+  return this->InternShape(
+      ShapeKey("convex_mesh", this->meshContentHashes.Hash(*mesh),
+               maxConvexHulls, scale.x(), scale.y(), scale.z()), [&]
+      {
+        return std::make_shared<CustomMeshShape>(*convexMesh, scale);
+      });
+}
+
 /////////////////////////////////////////////////
 Identity SDFFeatures::ConstructSdfCollision(
     const Identity &_linkID,
@@ -833,7 +1146,14 @@ Identity SDFFeatures::ConstructSdfCollision(
     return this->GenerateInvalidId();
   }
 
-  const ShapeAndTransform st = ConstructGeometry(*_collision.Geom());
+  const ::sdf::Mesh *meshSdf = _collision.Geom()->MeshShape();
+  const ShapeAndTransform st = this->loadTimer.Measure(
+      sdf::LoadTimer::Phase::SHAPE_CREATION, [&]
+      {
+        if (meshSdf && MaxConvexHulls(*meshSdf) > 0u)
+          return ShapeAndTransform{this->ConstructConvexMesh(*meshSdf)};
+        return ConstructGeometry(*this, *_collision.Geom());
+      });
   const dart::dynamics::ShapePtr shape = st.shape;
   const Eigen::Isometry3d tf_shape = st.tf;
 
@@ -845,13 +1165,20 @@ Identity SDFFeatures::ConstructSdfCollision(
     return this->GenerateInvalidId();
   }
 
-  dart::dynamics::BodyNode *const bn =
-      this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
+  const LinkInfo *linkInfo = this->ReferenceInterface<LinkInfo>(_linkID);
+  dart::dynamics::BodyNode *const bn = linkInfo->link.get();
+
+  // The collisions of a merged link are attached to the body node it was
+  // merged into.
+  const Eigen::Isometry3d tf_link = linkInfo->mergedFrame ?
+      linkInfo->mergedFrame->getRelativeTransform() :
+      Eigen::Isometry3d::Identity();
 
   // NOTE(MXG): Gazebo requires unique collision shape names per Link, but
   // dartsim requires unique ShapeNode names per Skeleton, so we decorate the
   // Collision name for uniqueness sake.
-  const std::string internalName =
+  const std::string internalName = linkInfo->mergedFrame ?
+      bn->getName() + ":" + linkInfo->name + ":" + _collision.Name() :
       bn->getName() + ":" + _collision.Name();
 
   dart::dynamics::ShapeNode * const node =
@@ -945,8 +1272,11 @@ Identity SDFFeatures::ConstructSdfCollision(
       collideBitmask = bitmaskElement->Get<int>("collide_bitmask");
   }
 
-  node->setRelativeTransform(ResolveSdfPose(_collision.SemanticPose()) *
-                             tf_shape);
+  node->setRelativeTransform(tf_link *
+      this->loadTimer.Measure(sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+      {
+        return ResolveSdfPose(_collision.SemanticPose());
+      }) * tf_shape);
 
   const std::size_t shapeID =
       this->AddShape({node, _collision.Name(), tf_shape});
@@ -968,7 +1298,7 @@ Identity SDFFeatures::ConstructSdfVisual(
     return this->GenerateInvalidId();
   }
 
-  const ShapeAndTransform st = ConstructGeometry(*_visual.Geom());
+  const ShapeAndTransform st = ConstructGeometry(*this, *_visual.Geom());
   const dart::dynamics::ShapePtr shape = st.shape;
   const Eigen::Isometry3d tf_shape = st.tf;
 
@@ -1008,6 +1338,16 @@ Identity SDFFeatures::ConstructSdfVisual(
   return this->GenerateIdentity(shapeID, this->shapes.at(shapeID));
 }
 
+/////////////////////////////////////////////////
+sdf::GetSdfLoadReport::LoadReport SDFFeatures::GetSdfWorldLoadReport(
+    const Identity &_worldID) const
+{
+  const auto it = this->loadReports.find(_worldID);
+  if (it == this->loadReports.end())
+    return {};
+  return it->second;
+}
+
 /////////////////////////////////////////////////
 dart::dynamics::BodyNode *SDFFeatures::FindOrConstructLink(
     const dart::dynamics::SkeletonPtr &_model,
@@ -1033,6 +1373,85 @@ dart::dynamics::BodyNode *SDFFeatures::FindOrConstructLink(
   return this->links.at(this->ConstructSdfLink(_modelID, *sdfLink))->link.get();
 }
 
+/////////////////////////////////////////////////
+void SDFFeatures::ConstructMergedSdfLinks(
+    const dart::dynamics::SkeletonPtr &_model,
+    const Identity &_modelID,
+    const ::sdf::Model &_sdfModel,
+    const std::unordered_map<std::string, std::string> &_rootOf)
+{
+  auto linkPose = [&](const ::sdf::Link &_sdfLink)
+  {
+    return this->loadTimer.Measure(sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+        {
+          return ResolveSdfPose(_sdfLink.SemanticPose());
+        });
+  };
+
+  // The inertia of each link that others are merged into, expressed in the
+  // frame of that link
+  std::unordered_map<std::string, math::Inertiald> rootInertials;
+  for (std::size_t i = 0; i < _sdfModel.LinkCount(); ++i)
+  {
+    const ::sdf::Link *sdfLink = _sdfModel.LinkByIndex(i);
+    const auto it = _rootOf.find(sdfLink->Name());
+    if (it == _rootOf.end())
+      continue;
+
+    const ::sdf::Link *rootLink = _sdfModel.LinkByName(it->second);
+    dart::dynamics::BodyNode *bn = _model->getBodyNode(it->second);
+    if (!rootLink || !bn)
+      continue;
+
+    const Eigen::Isometry3d tf =
+        linkPose(*rootLink).inverse() * linkPose(*sdfLink);
+    const std::size_t linkID = this->AddMergedLink(
+        bn, sdfLink->Name(), tf, _modelID, sdfLink->Inertial());
+    const auto linkIdentity =
+        this->GenerateIdentity(linkID, this->links.at(linkID));
+
+    math::Inertiald inertial = sdfLink->Inertial();
+    if (inertial.MassMatrix().Mass() > 0.0)
+    {
+      inertial.SetPose(math::eigen3::convert(tf) * inertial.Pose());
+      auto rootIt = rootInertials.try_emplace(
+          it->second, rootLink->Inertial()).first;
+      if (rootIt->second.MassMatrix().Mass() > 0.0)
+        rootIt->second += inertial;
+      else
+        rootIt->second = inertial;
+    }
+
+    for (std::size_t c = 0; c < sdfLink->CollisionCount(); ++c)
+    {
+      const auto collision = sdfLink->CollisionByIndex(c);
+      if (collision)
+        this->ConstructSdfCollision(linkIdentity, *collision);
+    }
+  }
+
+  for (const auto &[rootName, inertial] : rootInertials)
+  {
+    dart::dynamics::BodyNode *bn = _model->getBodyNode(rootName);
+    AssignInertialToBody(inertial, bn);
+    this->links.at(bn)->inertial = inertial;
+  }
+}
+
+/////////////////////////////////////////////////
+void SDFFeatures::SetEngineMergeFixedJoints(
+    const Identity &/*_engineID*/, const bool _merge)
+{
+  this->mergeFixedJoints = _merge;
+}
+
+/////////////////////////////////////////////////
+bool SDFFeatures::GetEngineMergeFixedJoints(
+    const Identity &/*_engineID*/) const
+{
+  return this->mergeFixedJoints;
+}
+
 /////////////////////////////////////////////////
 Identity SDFFeatures::ConstructSdfJoint(
     const Identity &_modelID,
@@ -1109,8 +1528,11 @@ Identity SDFFeatures::ConstructSdfJoint(
       _parent ? _parent->getWorldTransform() : Eigen::Isometry3d::Identity();
   const Eigen::Isometry3d T_child = _child->getWorldTransform();
 
-  const Eigen::Isometry3d T_joint =
-      _child->getWorldTransform() * ResolveSdfPose(_sdfJoint.SemanticPose());
+  const Eigen::Isometry3d T_joint = _child->getWorldTransform() *
+      this->loadTimer.Measure(sdf::LoadTimer::Phase::SDF_RESOLUTION, [&]
+      {
+        return ResolveSdfPose(_sdfJoint.SemanticPose());
+      });
 
   const ::sdf::JointType type = _sdfJoint.Type();
   dart::dynamics::Joint *joint = nullptr;
@@ -1179,10 +1601,7 @@ Identity SDFFeatures::ConstructSdfJoint(
   joint->setTransformFromParentBodyNode(parent_T_prejoint_init);
   joint->setTransformFromChildBodyNode(child_T_postjoint);
 
-  const std::string fullJointName =
-      this->FullyScopedJointName(_modelID, jointName);
-
-  const std::size_t jointID = this->AddJoint(joint, fullJointName, _modelID);
+  const std::size_t jointID = this->AddJoint(joint, jointName, _modelID);
   // Increment BodyNode version since the child could be moved to a new skeleton
   // when a joint is created.
   // TODO(azeey) Remove incrementVersion once DART has been updated to
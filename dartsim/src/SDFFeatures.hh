@@ -19,8 +19,12 @@
 #define GZ_PHYSICS_DARTSIM_SRC_SDFFEATURES_HH_
 
 #include <gz/math/Inertial.hh>
+#include <chrono>
+#include <cstddef>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <gz/physics/sdf/ConstructCollision.hh>
 #include <gz/physics/sdf/ConstructJoint.hh>
@@ -29,9 +33,12 @@
 #include <gz/physics/sdf/ConstructNestedModel.hh>
 #include <gz/physics/sdf/ConstructVisual.hh>
 #include <gz/physics/sdf/ConstructWorld.hh>
+#include <gz/physics/sdf/LoadReport.hh>
+#include <gz/physics/sdf/MergeFixedJoints.hh>
 
 #include <gz/physics/Implements.hh>
 #include <sdf/Joint.hh>
+#include <sdf/Mesh.hh>
 
 #include "Base.hh"
 #include "EntityManagementFeatures.hh"
@@ -42,12 +49,16 @@ namespace dartsim {
 
 struct SDFFeatureList : FeatureList<
   sdf::ConstructSdfWorld,
+  sdf::ConstructSdfWorldIncrementally,
   sdf::ConstructSdfModel,
+  sdf::ConstructSdfModels,
   sdf::ConstructSdfNestedModel,
   sdf::ConstructSdfLink,
   sdf::ConstructSdfJoint,
   sdf::ConstructSdfCollision,
-  sdf::ConstructSdfVisual
+  sdf::ConstructSdfVisual,
+  sdf::GetSdfLoadReport,
+  sdf::MergeFixedJoints
 > { };
 
 class SDFFeatures :
@@ -58,10 +69,25 @@ class SDFFeatures :
       const Identity &/*_engine*/,
       const ::sdf::World &_sdfWorld) override;
 
+  public: Identity StartConstructSdfWorld(
+      const Identity &_engine,
+      const ::sdf::World &_sdfWorld) override;
+
+  public: bool ContinueSdfWorldConstruction(
+      const Identity &_worldID,
+      std::chrono::steady_clock::duration _budget) override;
+
+  public: std::size_t GetPendingSdfModelCount(
+      const Identity &_worldID) const override;
+
   public: Identity ConstructSdfModel(
       const Identity &_parentID,
       const ::sdf::Model &_sdfModel) override;
 
+  public: std::vector<Identity> ConstructSdfModels(
+      const Identity &_worldID,
+      const std::vector<const ::sdf::Model *> &_sdfModels) override;
+
   public: Identity ConstructSdfNestedModel(
       const Identity &_parentID,
       const ::sdf::Model &_sdfModel) override;
@@ -82,12 +108,52 @@ class SDFFeatures :
       const Identity &_linkID,
       const ::sdf::Visual &_visual) override;
 
+  public: sdf::GetSdfLoadReport::LoadReport GetSdfWorldLoadReport(
+      const Identity &_worldID) const override;
+
+  public: void SetEngineMergeFixedJoints(
+      const Identity &_engineID, bool _merge) override;
+
+  public: bool GetEngineMergeFixedJoints(
+      const Identity &_engineID) const override;
+
+  /// \brief Create a world from its SDF without its models or joints.
+  /// \param[in] _engine Engine of the world
+  /// \param[in] _sdfWorld SDF of the world
+  /// \return The world
+  private: Identity ConstructSdfWorldProperties(
+      const Identity &_engine,
+      const ::sdf::World &_sdfWorld);
+
+  /// \brief Construct the joints of a world, whose models have all been
+  /// constructed.
+  /// \param[in] _worldID The world
+  /// \param[in] _sdfWorld SDF of the world
+  private: void ConstructSdfWorldJoints(
+      const Identity &_worldID,
+      const ::sdf::World &_sdfWorld);
+
   private: dart::dynamics::BodyNode *FindOrConstructLink(
       const dart::dynamics::SkeletonPtr &_model,
       const Identity &_modelID,
       const ::sdf::Model &_sdfModel,
       const std::string &_linkName);
 
+  /// \brief Construct the links of a model that are merged into other
+  /// links, with their collisions, and add their inertia to the body nodes
+  /// they are merged into. See sdf::MergeFixedJoints.
+  /// \param[in] _model Skeleton of the model, with the other links
+  /// constructed
+  /// \param[in] _modelID Model of the links
+  /// \param[in] _sdfModel SDF of the model
+  /// \param[in] _rootOf Name of the link that each merged link is merged
+  /// into, by the name of the merged link
+  private: void ConstructMergedSdfLinks(
+      const dart::dynamics::SkeletonPtr &_model,
+      const Identity &_modelID,
+      const ::sdf::Model &_sdfModel,
+      const std::unordered_map<std::string, std::string> &_rootOf);
+
   /// \brief Construct a joint between two input links.
   /// \param[in] _modelInfo Contains the joint's parent model
   /// \param[in] _sdfJoint Contains joint parameters
@@ -135,6 +201,39 @@ class SDFFeatures :
                                 const ::sdf::Joint *_sdfJoint,
                                 const std::string &_parentName,
                                 const std::string &_parentType) const;
+
+  /// \brief Construct the shape of a mesh collision whose optimization asks
+  /// for convex hulls. The hulls come from the shared convex decomposition
+  /// cache and make up a single mesh shape.
+  /// \param[in] _meshSdf Mesh of the collision
+  /// \return The shape, or nullptr if the mesh could not be loaded or
+  /// decomposed
+  private: dart::dynamics::ShapePtr ConstructConvexMesh(
+      const ::sdf::Mesh &_meshSdf);
+
+  /// \brief Charges the time spent constructing entities to loadReports.
+  private: sdf::LoadTimer loadTimer;
+
+  /// \brief Whether links connected by fixed joints are merged when models
+  /// are constructed, see sdf::MergeFixedJoints.
+  private: bool mergeFixedJoints = false;
+
+  /// \brief A world being constructed by ContinueSdfWorldConstruction.
+  private: struct PendingSdfWorld
+  {
+    /// \brief SDF of the world, which the caller keeps valid
+    const ::sdf::World *sdfWorld = nullptr;
+
+    /// \brief Index of the next model of sdfWorld to construct
+    std::size_t nextModel = 0u;
+  };
+
+  /// \brief Worlds whose construction is not complete, keyed by world ID.
+  private: std::unordered_map<std::size_t, PendingSdfWorld> pendingSdfWorlds;
+
+  /// \brief Load reports of the worlds, keyed by world ID.
+  private: std::unordered_map<std::size_t, sdf::GetSdfLoadReport::LoadReport>
+      loadReports;
 };
 
 }
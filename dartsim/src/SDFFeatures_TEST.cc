@@ -983,3 +983,44 @@ TEST_P(SDFFeatures_TEST, Shapes)
     ASSERT_EQ(1u, skeleton->getNumBodyNodes());
   }
 }
+
+/////////////////////////////////////////////////
+// Collisions with identical geometry share one DART shape, and only their
+// shape nodes hold per collision data.
+TEST(SDFFeatures_TEST, SharedShapes)
+{
+  auto engine = LoadEngine();
+  ASSERT_NE(nullptr, engine);
+
+  auto boxModel = [](const std::string &_name, const std::string &_size)
+  {
+    return "<model name='" + _name + "'>"
+           "  <link name='link'>"
+           "    <collision name='collision'>"
+           "      <geometry><box><size>" + _size + "</size></box></geometry>"
+           "    </collision>"
+           "  </link>"
+           "</model>";
+  };
+
+  sdf::Root root;
+  const sdf::Errors errors = root.LoadSdfString(
+      "<sdf version='1.11'><world name='default'>" +
+      boxModel("box0", "1 2 3") + boxModel("box1", "1 2 3") +
+      boxModel("box2", "1 2 4") + "</world></sdf>");
+  ASSERT_TRUE(errors.empty()) << errors;
+
+  auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+  ASSERT_NE(nullptr, world);
+  auto dartWorld = world->GetDartsimWorld();
+  ASSERT_NE(nullptr, dartWorld);
+
+  auto shapeNode = [&](const std::string &_model)
+  {
+    return dartWorld->getSkeleton(_model)->getBodyNode(0)->getShapeNode(0);
+  };
+
+  EXPECT_NE(shapeNode("box0"), shapeNode("box1"));
+  EXPECT_EQ(shapeNode("box0")->getShape(), shapeNode("box1")->getShape());
+  EXPECT_NE(shapeNode("box0")->getShape(), shapeNode("box2")->getShape());
+}
@@ -17,6 +17,7 @@
 
 #include "ShapeFeatures.hh"
 
+#include <cstdint>
 #include <memory>
 
 #include <dart/dynamics/BoxShape.hpp>
@@ -31,9 +32,16 @@
 
 #include <gz/common/Mesh.hh>
 #include <gz/common/MeshManager.hh>
+#include <gz/math/eigen3/Conversions.hh>
+
+#include <gz/physics/heightmap/HeightfieldCache.hh>
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
+#include <gz/physics/mesh/MeshSimplification.hh>
+#include <gz/physics/mesh/PrimitiveFitting.hh>
 
 #include "CustomHeightmapShape.hh"
 #include "CustomMeshShape.hh"
+#include "TiledHeightmap.hh"
 
 namespace gz {
 namespace physics {
@@ -52,6 +60,7 @@ Pose3d ShapeFeatures::GetShapeRelativeTransform(
 void ShapeFeatures::SetShapeRelativeTransform(
     const Identity &_shapeID, const Pose3d &_pose)
 {
+  this->frameDataCache.Invalidate();
   const auto *shapeInfo = this->ReferenceInterface<ShapeInfo>(_shapeID);
   shapeInfo->node->setRelativeTransform(_pose * shapeInfo->tf_offset);
 }
@@ -87,7 +96,11 @@ Identity ShapeFeatures::AttachBoxShape(
     const LinearVector3d &_size,
     const Pose3d &_pose)
 {
-  auto box = std::make_shared<dart::dynamics::BoxShape>(_size);
+  auto box = this->InternShape(
+      ShapeKey("box", _size.x(), _size.y(), _size.z()), [&]
+      {
+        return std::make_shared<dart::dynamics::BoxShape>(_size);
+      });
 
   DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
   dart::dynamics::ShapeNode *sn =
@@ -146,8 +159,12 @@ Identity ShapeFeatures::AttachCapsuleShape(
     const double _length,
     const Pose3d &_pose)
 {
-  auto capsule = std::make_shared<dart::dynamics::CapsuleShape>(
-        _radius, _length);
+  auto capsule = this->InternShape(
+      ShapeKey("capsule", _radius, _length), [&]
+      {
+        return std::make_shared<dart::dynamics::CapsuleShape>(
+            _radius, _length);
+      });
 
   auto bn = this->ReferenceInterface<LinkInfo>(_linkID)->link;
   dart::dynamics::ShapeNode *sn =
@@ -207,8 +224,12 @@ Identity ShapeFeatures::AttachCylinderShape(
     const double _height,
     const Pose3d &_pose)
 {
-  auto cylinder = std::make_shared<dart::dynamics::CylinderShape>(
-        _radius, _height);
+  auto cylinder = this->InternShape(
+      ShapeKey("cylinder", _radius, _height), [&]
+      {
+        return std::make_shared<dart::dynamics::CylinderShape>(
+            _radius, _height);
+      });
 
   auto bn = this->ReferenceInterface<LinkInfo>(_linkID)->link;
   dart::dynamics::ShapeNode *sn =
@@ -255,17 +276,23 @@ Identity ShapeFeatures::AttachEllipsoidShape(
     const Vector3d &_radii,
     const Pose3d &_pose)
 {
-  common::MeshManager *meshMgr = common::MeshManager::Instance();
-  std::string ellipsoidMeshName = _name + "_ellipsoid_mesh"
-    + "_" + std::to_string(_radii[0])
-    + "_" + std::to_string(_radii[1])
-    + "_" + std::to_string(_radii[2]);
-  meshMgr->CreateEllipsoid(ellipsoidMeshName,
-    gz::math::Vector3d(_radii[0], _radii[1], _radii[2]),
-    16, 16);
-  const gz::common::Mesh * _mesh = meshMgr->MeshByName(ellipsoidMeshName);
-
-  auto mesh = std::make_shared<CustomMeshShape>(*_mesh, Vector3d(1, 1, 1));
+  auto mesh = this->InternShape(
+      ShapeKey("ellipsoid16", _radii[0], _radii[1], _radii[2]), [&]
+      {
+        common::MeshManager *meshMgr = common::MeshManager::Instance();
+        std::string ellipsoidMeshName = _name + "_ellipsoid_mesh"
+          + "_" + std::to_string(_radii[0])
+          + "_" + std::to_string(_radii[1])
+          + "_" + std::to_string(_radii[2]);
+        meshMgr->CreateEllipsoid(ellipsoidMeshName,
+          gz::math::Vector3d(_radii[0], _radii[1], _radii[2]),
+          16, 16);
+        const gz::common::Mesh * _mesh =
+            meshMgr->MeshByName(ellipsoidMeshName);
+
+        return std::make_shared<CustomMeshShape>(
+            *_mesh, Vector3d(1, 1, 1));
+      });
 
   DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
   dart::dynamics::ShapeNode *sn =
@@ -312,7 +339,10 @@ Identity ShapeFeatures::AttachSphereShape(
     const double _radius,
     const Pose3d &_pose)
 {
-  auto sphere = std::make_shared<dart::dynamics::SphereShape>(_radius);
+  auto sphere = this->InternShape(ShapeKey("sphere", _radius), [&]
+      {
+        return std::make_shared<dart::dynamics::SphereShape>(_radius);
+      });
 
   DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
   dart::dynamics::ShapeNode *sn =
@@ -363,14 +393,50 @@ Identity ShapeFeatures::AttachHeightmapShape(
     const LinearVector3d &_size,
     int _subSampling)
 {
-  auto heightmap = std::make_shared<CustomHeightmapShape>(_heightmapData,
-      _size, _subSampling);
-
   DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
+
+  // Large heightmaps are split into tiles, which are only built near the
+  // bodies moving on them. See SimulationFeatures::UpdateHeightmapTiles.
+  const std::size_t vertSize = static_cast<std::size_t>(
+      _heightmapData.Width() * _subSampling - _subSampling + 1);
+  if (vertSize > kMaxUntiledHeightmapVertices)
+  {
+    auto tiled = std::make_shared<TiledHeightmap>(_heightmapData, _size,
+        _subSampling);
+
+    // The placeholder has no collision aspect, so only the tiles collide
+    dart::dynamics::ShapeNode *sn =
+        bn->createShapeNodeWith<dart::dynamics::DynamicsAspect>(
+            tiled->CreatePlaceholderShape(), bn->getName() + ":" + _name);
+    sn->setRelativeTransform(_pose);
+    tiled->SetPlaceholder(sn);
+
+    ShapeInfo info{sn, _name};
+    info.tiledHeightmap = tiled;
+    const std::size_t shapeID = this->AddShape(info);
+    return this->GenerateIdentity(shapeID, this->shapes.at(shapeID));
+  }
+
+  // Worlds that attach the same heightmap share its shape rather than each
+  // holding a copy of the heights, even across engines.
+  auto shape =
+      heightmap::SharedHeightfieldCache<CustomHeightmapShape>::Instance().Get(
+          heightmap::HeightfieldKey(_heightmapData,
+              math::eigen3::convert(_size), _subSampling), [&]
+          {
+            auto heightfield = std::make_shared<CustomHeightmapShape>(
+                _heightmapData, _size, _subSampling);
+            // Compute the lazily updated bounding box and volume now, so
+            // that worlds stepped on other threads only read the shape.
+            heightfield->getBoundingBox();
+            heightfield->getVolume();
+            return heightfield;
+          });
+
   dart::dynamics::ShapeNode *sn =
       bn->createShapeNodeWith<dart::dynamics::CollisionAspect,
                               dart::dynamics::DynamicsAspect>(
-          heightmap, bn->getName() + ":" + _name);
+          shape, bn->getName() + ":" + _name);
 
   sn->setRelativeTransform(_pose);
   const std::size_t shapeID = this->AddShape({sn, _name});
@@ -418,6 +484,48 @@ LinearVector3d ShapeFeatures::GetMeshShapeScale(
   return mesh->getScale();
 }
 
+/////////////////////////////////////////////////
+/// \brief Get the shape of a primitive fitted to a mesh.
+/// \param[in] _base Plugin that shares the shape, see Base::InternShape.
+/// \param[in] _fit Primitive, with the scale of the mesh applied.
+/// \return The shape, or nullptr if no primitive was fitted.
+static dart::dynamics::ShapePtr FittedPrimitiveShape(
+    Base &_base, const mesh::FittedPrimitive &_fit)
+{
+  using Type = mesh::FittedPrimitive::Type;
+  const double r = _fit.radius;
+  const double l = _fit.length;
+  switch (_fit.type)
+  {
+    case Type::kBox:
+    {
+      const Eigen::Vector3d size = math::eigen3::convert(_fit.size);
+      return _base.InternShape(
+          ShapeKey("box", size.x(), size.y(), size.z()), [&]
+          {
+            return std::make_shared<dart::dynamics::BoxShape>(size);
+          });
+    }
+    case Type::kSphere:
+      return _base.InternShape(ShapeKey("sphere", r), [&]
+          {
+            return std::make_shared<dart::dynamics::SphereShape>(r);
+          });
+    case Type::kCylinder:
+      return _base.InternShape(ShapeKey("cylinder", r, l), [&]
+          {
+            return std::make_shared<dart::dynamics::CylinderShape>(r, l);
+          });
+    case Type::kCapsule:
+      return _base.InternShape(ShapeKey("capsule", r, l), [&]
+          {
+            return std::make_shared<dart::dynamics::CapsuleShape>(r, l);
+          });
+    default:
+      return nullptr;
+  }
+}
+
 /////////////////////////////////////////////////
 Identity ShapeFeatures::AttachMeshShape(
     const Identity &_linkID,
@@ -426,7 +534,132 @@ Identity ShapeFeatures::AttachMeshShape(
     const Pose3d &_pose,
     const LinearVector3d &_scale)
 {
-  auto mesh = std::make_shared<CustomMeshShape>(_mesh, _scale);
+  // Meshes are keyed by their content rather than their name, so copies of
+  // the same file loaded under different names share their triangles too.
+  const std::uint64_t hash = this->meshContentHashes.Hash(_mesh);
+
+  // Meshes that are primitives in all but name collide as those primitives.
+  // The primitive is offset from the mesh frame, which tf_offset hides from
+  // GetShapeRelativeTransform.
+  const mesh::FittedPrimitive fit = mesh::ScaledPrimitive(
+      this->primitiveFits.Fit(
+          _mesh, hash, this->collisionMeshPrimitiveTolerance),
+      math::eigen3::convert(_scale));
+  if (auto primitive = FittedPrimitiveShape(*this, fit))
+  {
+    DartBodyNode *bn =
+        this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
+    dart::dynamics::ShapeNode *sn =
+        bn->createShapeNodeWith<dart::dynamics::CollisionAspect,
+                                dart::dynamics::DynamicsAspect>(
+            primitive, bn->getName() + ":" + _name);
+
+    ShapeInfo info{sn, _name};
+    info.tf_offset = math::eigen3::convert(fit.pose);
+    sn->setRelativeTransform(_pose * info.tf_offset);
+    const std::size_t shapeID = this->AddShape(info);
+    return this->GenerateIdentity(shapeID, this->shapes.at(shapeID));
+  }
+
+  const std::size_t budget = this->collisionMeshTriangleBudget;
+  auto mesh = this->InternShape(
+      ShapeKey("mesh", hash, budget, _scale.x(), _scale.y(), _scale.z()), [&]
+      {
+        return std::make_shared<CustomMeshShape>(
+            mesh::CachedSimplifiedMesh(_mesh, hash, budget), _scale);
+      });
+
+  DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
+  dart::dynamics::ShapeNode *sn =
+      bn->createShapeNodeWith<dart::dynamics::CollisionAspect,
+                              dart::dynamics::DynamicsAspect>(
+          mesh, bn->getName() + ":" + _name);
+
+  sn->setRelativeTransform(_pose);
+  const std::size_t shapeID = this->AddShape({sn, _name});
+  return this->GenerateIdentity(shapeID, this->shapes.at(shapeID));
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachMeshViewShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const mesh::TriangleMeshView &_view,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale)
+{
+  if (!mesh::ValidTriangleMeshView(_view))
+  {
+    gzerr << "Mesh view of shape [" << _name << "] has no triangles or an "
+          << "index out of range\n";
+    return this->GenerateInvalidId();
+  }
+
+  const std::string key = ShapeKey("mesh_view", mesh::MeshContentHash(_view),
+                                   _scale.x(), _scale.y(), _scale.z());
+  auto mesh = this->InternShape(key, [&]
+      {
+        return std::make_shared<CustomMeshShape>(_view, _scale);
+      });
+
+  DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
+  dart::dynamics::ShapeNode *sn =
+      bn->createShapeNodeWith<dart::dynamics::CollisionAspect,
+                              dart::dynamics::DynamicsAspect>(
+          mesh, bn->getName() + ":" + _name);
+
+  sn->setRelativeTransform(_pose);
+  const std::size_t shapeID = this->AddShape({sn, _name});
+  return this->GenerateIdentity(shapeID, this->shapes.at(shapeID));
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachConvexMeshShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const common::Mesh &_mesh,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale)
+{
+  return this->AttachConvexDecompositionShape(
+      _linkID, _name, _mesh, 1u, _pose, _scale);
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachConvexDecompositionShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const common::Mesh &_mesh,
+    std::size_t _maxConvexHulls,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale)
+{
+  if (_maxConvexHulls == 0u)
+  {
+    gzerr << "Convex decomposition of shape [" << _name << "] needs at "
+          << "least one hull\n";
+    return this->GenerateInvalidId();
+  }
+
+  // Same key as the convex meshes constructed from SDF, so that both share
+  // their hulls.
+  const std::uint64_t hash = this->meshContentHashes.Hash(_mesh);
+  const common::Mesh *convexMesh = mesh::CachedConvexMesh(
+      _mesh, hash, _maxConvexHulls,
+      _maxConvexHulls == 1u ? "convex_hull" : "convex_decomposition");
+  if (nullptr == convexMesh || convexMesh->SubMeshCount() == 0u)
+  {
+    gzerr << "Failed to compute the convex hulls of shape [" << _name
+          << "]\n";
+    return this->GenerateInvalidId();
+  }
+
+  auto mesh = this->InternShape(
+      ShapeKey("convex_mesh", hash, _maxConvexHulls,
+               _scale.x(), _scale.y(), _scale.z()), [&]
+      {
+        return std::make_shared<CustomMeshShape>(*convexMesh, _scale);
+      });
 
   DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
   dart::dynamics::ShapeNode *sn =
@@ -439,6 +672,34 @@ Identity ShapeFeatures::AttachMeshShape(
   return this->GenerateIdentity(shapeID, this->shapes.at(shapeID));
 }
 
+/////////////////////////////////////////////////
+void ShapeFeatures::SetEngineCollisionMeshTriangleBudget(
+    const Identity &/*_engineID*/, std::size_t _maxTriangles)
+{
+  this->collisionMeshTriangleBudget = _maxTriangles;
+}
+
+/////////////////////////////////////////////////
+std::size_t ShapeFeatures::GetEngineCollisionMeshTriangleBudget(
+    const Identity &/*_engineID*/) const
+{
+  return this->collisionMeshTriangleBudget;
+}
+
+/////////////////////////////////////////////////
+void ShapeFeatures::SetEngineCollisionMeshPrimitiveTolerance(
+    const Identity &/*_engineID*/, double _tolerance)
+{
+  this->collisionMeshPrimitiveTolerance = _tolerance;
+}
+
+/////////////////////////////////////////////////
+double ShapeFeatures::GetEngineCollisionMeshPrimitiveTolerance(
+    const Identity &/*_engineID*/) const
+{
+  return this->collisionMeshPrimitiveTolerance;
+}
+
 /////////////////////////////////////////////////
 Identity ShapeFeatures::CastToPlaneShape(const Identity &_shapeID) const
 {
@@ -486,7 +747,12 @@ Identity ShapeFeatures::AttachPlaneShape(
     const AngularVector3d &_normal,
     const LinearVector3d &_point)
 {
-  auto plane = std::make_shared<dart::dynamics::PlaneShape>(_normal, _point);
+  auto plane = this->InternShape(
+      ShapeKey("plane", _normal.x(), _normal.y(), _normal.z(),
+               _normal.dot(_point)), [&]
+      {
+        return std::make_shared<dart::dynamics::PlaneShape>(_normal, _point);
+      });
 
   DartBodyNode *bn = this->ReferenceInterface<LinkInfo>(_linkID)->link.get();
   dart::dynamics::ShapeNode *sn =
@@ -507,6 +773,123 @@ AlignedBox3d ShapeFeatures::GetShapeAxisAlignedBoundingBox(
   return AlignedBox3d(box.getMin(), box.getMax());
 }
 
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldShapeBoundingBoxes(
+    const Identity &_worldID) const -> ShapeBoundingBoxBatch
+{
+  this->shapeBoundingBoxes.Clear();
+
+  const auto &world = this->worlds.at(_worldID);
+  for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+  {
+    const auto skeleton = world->getSkeleton(i);
+    for (std::size_t b = 0; b < skeleton->getNumBodyNodes(); ++b)
+    {
+      const dart::dynamics::BodyNode *bn = skeleton->getBodyNode(b);
+      for (std::size_t n = 0; n < bn->getNumShapeNodes(); ++n)
+      {
+        // Skip the shape nodes that are not entities, such as the tiles of
+        // a tiled heightmap.
+        const DartShapeNode *node = bn->getShapeNode(n);
+        if (!this->shapes.HasEntity(node))
+          continue;
+
+        // dart keeps the bounding box of each shape until the shape changes
+        const dart::math::BoundingBox &box =
+            node->getShape()->getBoundingBox();
+        this->shapeBoundingBoxes.Add(this->shapes.IdentityOf(node),
+            node->getWorldTransform(),
+            AlignedBox3d(box.getMin(), box.getMax()));
+      }
+    }
+  }
+
+  return this->shapeBoundingBoxes.View();
+}
+
+/////////////////////////////////////////////////
+bool ShapeFeatures::LinkWorldBoundingBox(
+    const LinkInfo &_link, AlignedBox3d &_box) const
+{
+  // dart does not keep the bounding boxes of its broadphase, so the box of a
+  // link is merged from the boxes that dart keeps for its shapes. The shapes
+  // of a merged link are the shapes of the body node it was merged into.
+  _box.setEmpty();
+  const DartBodyNode *bn = _link.link.get();
+  for (std::size_t n = 0; n < bn->getNumShapeNodes(); ++n)
+  {
+    const DartShapeNode *node = bn->getShapeNode(n);
+    if (!this->shapes.HasEntity(node))
+      continue;
+
+    const dart::math::BoundingBox &box = node->getShape()->getBoundingBox();
+    _box.extend(detail::TransformAlignedBox(node->getWorldTransform(),
+        AlignedBox3d(box.getMin(), box.getMax())));
+  }
+
+  return !_box.isEmpty();
+}
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldLinkBoundingBoxes(
+    const Identity &_worldID) const -> BoundingBoxBatch
+{
+  this->linkBoundingBoxes.Clear();
+
+  AlignedBox3d box;
+  const auto &modelIds = this->models.Ids();
+  const auto &modelInfos = this->models.Objects();
+  for (std::size_t i = 0; i < modelIds.size(); ++i)
+  {
+    if (this->GetWorldOfModelImpl(modelIds[i]) != _worldID.id)
+      continue;
+
+    for (const auto &link : modelInfos[i]->links)
+    {
+      if (!link->mergedFrame && !this->links.HasEntity(link->link.get()))
+        continue;
+
+      if (this->LinkWorldBoundingBox(*link, box))
+      {
+        const std::size_t linkID = link->mergedFrame ?
+            link->mergedID : this->links.IdentityOf(link->link.get());
+        this->linkBoundingBoxes.Add(linkID, box);
+      }
+    }
+  }
+
+  return this->linkBoundingBoxes.View();
+}
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldModelBoundingBoxes(
+    const Identity &_worldID) const -> BoundingBoxBatch
+{
+  this->modelBoundingBoxes.Clear();
+
+  AlignedBox3d box;
+  AlignedBox3d modelBox;
+  const auto &modelIds = this->models.Ids();
+  const auto &modelInfos = this->models.Objects();
+  for (std::size_t i = 0; i < modelIds.size(); ++i)
+  {
+    if (this->GetWorldOfModelImpl(modelIds[i]) != _worldID.id)
+      continue;
+
+    modelBox.setEmpty();
+    for (const auto &link : modelInfos[i]->links)
+    {
+      if (this->LinkWorldBoundingBox(*link, box))
+        modelBox.extend(box);
+    }
+
+    if (!modelBox.isEmpty())
+      this->modelBoundingBoxes.Add(modelIds[i], modelBox);
+  }
+
+  return this->modelBoundingBoxes.View();
+}
+
 #if DART_VERSION_AT_LEAST(6, 10, 0)
 /////////////////////////////////////////////////
 double ShapeFeatures::GetShapeFrictionPyramidPrimarySlipCompliance(
@@ -560,6 +943,7 @@ bool ShapeFeatures::SetShapeFrictionPyramidPrimarySlipCompliance(
     return false;
   }
   aspect->setPrimarySlipCompliance(_value);
+  this->InvalidateContactMaterials();
   return true;
 }
 
@@ -579,6 +963,7 @@ bool ShapeFeatures::SetShapeFrictionPyramidSecondarySlipCompliance(
     return false;
   }
   aspect->setSecondarySlipCompliance(_value);
+  this->InvalidateContactMaterials();
   return true;
 }
 #endif
@@ -18,6 +18,7 @@
 #ifndef GZ_PHYSICS_DARTSIM_SRC_SHAPEFEATURES_HH_
 #define GZ_PHYSICS_DARTSIM_SRC_SHAPEFEATURES_HH_
 
+#include <cstddef>
 #include <string>
 
 #include <gz/physics/Shape.hh>
@@ -25,6 +26,7 @@
 #include <gz/physics/CapsuleShape.hh>
 #include <gz/physics/CylinderShape.hh>
 #include <gz/physics/EllipsoidShape.hh>
+#include <gz/physics/GetBoundingBox.hh>
 #include <gz/physics/heightmap/HeightmapShape.hh>
 #include <gz/physics/mesh/MeshShape.hh>
 #include <gz/physics/PlaneShape.hh>
@@ -44,6 +46,8 @@ struct ShapeFeatureList : FeatureList<
   SetShapeFrictionPyramidSlipCompliance,
 #endif
   GetShapeBoundingBox,
+  GetWorldShapeBoundingBoxes,
+  GetWorldLinkBoundingBoxes,
 
   GetBoxShapeProperties,
   // dartsim cannot yet update shape properties without reloading the model into
@@ -74,15 +78,33 @@ struct ShapeFeatureList : FeatureList<
   mesh::GetMeshShapeProperties,
 //  mesh::SetMeshShapeProperties,
   mesh::AttachMeshShapeFeature,
+  mesh::AttachMeshViewShapeFeature,
+  mesh::AttachConvexMeshShapeFeature,
+  mesh::AttachConvexDecompositionShapeFeature,
+  mesh::SimplifyCollisionMeshesFeature,
+  mesh::FitCollisionMeshPrimitivesFeature,
   GetPlaneShapeProperties,
 //  SetPlaneShapeProperties,
   AttachPlaneShapeFeature
 > { };
 
+/// \brief Heightmaps with more vertices than this along an edge are split
+/// into tiles, see TiledHeightmap.
+constexpr std::size_t kMaxUntiledHeightmapVertices = 4097u;
+
 class ShapeFeatures :
     public virtual Base,
     public virtual Implements3d<ShapeFeatureList>
 {
+  public: using ShapeBoundingBoxBatch =
+      GetWorldShapeBoundingBoxes::ShapeBoundingBoxBatchT<FeaturePolicy3d>;
+  public: using ShapeBoundingBoxStorage = GetWorldShapeBoundingBoxes::
+      Implementation<FeaturePolicy3d>::ShapeBoundingBoxStorage;
+  public: using BoundingBoxBatch =
+      GetWorldLinkBoundingBoxes::BoundingBoxBatchT<FeaturePolicy3d>;
+  public: using BoundingBoxStorage = GetWorldLinkBoundingBoxes::
+      Implementation<FeaturePolicy3d>::BoundingBoxStorage;
+
   // ----- Kinematic Properties -----
   public: Pose3d GetShapeRelativeTransform(
       const Identity &_shapeID) const override;
@@ -197,10 +219,53 @@ class ShapeFeatures :
       const Pose3d &_pose,
       const LinearVector3d &_scale) override;
 
+  public: Identity AttachMeshViewShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const mesh::TriangleMeshView &_view,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale) override;
+
+  public: Identity AttachConvexMeshShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const common::Mesh &_mesh,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale) override;
+
+  public: Identity AttachConvexDecompositionShape(
+      const Identity &_linkID,
+      const std::string &_name,
+      const common::Mesh &_mesh,
+      std::size_t _maxConvexHulls,
+      const Pose3d &_pose,
+      const LinearVector3d &_scale) override;
+
+  public: void SetEngineCollisionMeshTriangleBudget(
+      const Identity &_engineID, std::size_t _maxTriangles) override;
+
+  public: std::size_t GetEngineCollisionMeshTriangleBudget(
+      const Identity &_engineID) const override;
+
+  public: void SetEngineCollisionMeshPrimitiveTolerance(
+      const Identity &_engineID, double _tolerance) override;
+
+  public: double GetEngineCollisionMeshPrimitiveTolerance(
+      const Identity &_engineID) const override;
+
   // ----- Boundingbox Features -----
   public: AlignedBox3d GetShapeAxisAlignedBoundingBox(
               const Identity &_shapeID) const override;
 
+  public: ShapeBoundingBoxBatch GetWorldShapeBoundingBoxes(
+              const Identity &_worldID) const override;
+
+  public: BoundingBoxBatch GetWorldLinkBoundingBoxes(
+              const Identity &_worldID) const override;
+
+  public: BoundingBoxBatch GetWorldModelBoundingBoxes(
+              const Identity &_worldID) const override;
+
   // ----- Plane Features -----
   public: Identity CastToPlaneShape(
       const Identity &_shapeID) const override;
@@ -231,6 +296,24 @@ class ShapeFeatures :
   public: virtual bool SetShapeFrictionPyramidSecondarySlipCompliance(
             const Identity &_shapeID, double _value) override;
 #endif
+
+  /// \brief Buffers backing the views returned by
+  /// GetWorldShapeBoundingBoxes.
+  private: mutable ShapeBoundingBoxStorage shapeBoundingBoxes;
+
+  /// \brief Get the world bounding box of the shapes of a link.
+  /// \param[in] _link Link to get the box of.
+  /// \param[out] _box World bounding box of the link.
+  /// \return False if the link has no shapes.
+  private: bool LinkWorldBoundingBox(
+      const LinkInfo &_link, AlignedBox3d &_box) const;
+
+  /// \brief Buffers backing the views returned by GetWorldLinkBoundingBoxes.
+  private: mutable BoundingBoxStorage linkBoundingBoxes;
+
+  /// \brief Buffers backing the views returned by
+  /// GetWorldModelBoundingBoxes.
+  private: mutable BoundingBoxStorage modelBoundingBoxes;
 };
 
 }
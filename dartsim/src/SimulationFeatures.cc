@@ -17,14 +17,47 @@
 
 #include <memory>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include <ode/ode.h>
+
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
 
 #include <dart/collision/CollisionObject.hpp>
+#include <dart/collision/bullet/BulletCollisionDetector.hpp>
+#include <dart/collision/bullet/BulletCollisionGroup.hpp>
+#include <dart/collision/bullet/BulletCollisionObject.hpp>
+#include <dart/collision/DistanceOption.hpp>
+#include <dart/collision/DistanceResult.hpp>
+#include <dart/collision/fcl/FCLCollisionDetector.hpp>
 #include <dart/collision/CollisionResult.hpp>
+#include <dart/constraint/ConstrainedGroup.hpp>
 #include <dart/constraint/ConstraintSolver.hpp>
 #include <dart/constraint/ContactConstraint.hpp>
+#include <dart/dynamics/HeightmapShape.hpp>
+#include <dart/dynamics/BoxShape.hpp>
+#include <dart/dynamics/MeshShape.hpp>
+#include <dart/dynamics/PlaneShape.hpp>
+#include <dart/dynamics/SimpleFrame.hpp>
+#include <dart/dynamics/SphereShape.hpp>
+#include <dart/dynamics/ShapeNode.hpp>
+#include <dart/collision/ode/OdeCollisionDetector.hpp>
 #ifdef DART_HAS_CONTACT_SURFACE
 #include <dart/constraint/ContactSurface.hpp>
 #endif
@@ -34,173 +67,2908 @@
 #include <gz/math/Pose3.hh>
 #include <gz/math/eigen3/Conversions.hh>
 
-#include "gz/physics/GetContacts.hh"
+#include "gz/physics/AllocationCounter.hh"
+#include "gz/physics/GetBoundingBox.hh"
+#include "gz/physics/GetContacts.hh"
+#include "gz/physics/detail/WorldStateSnapshot.hh"
+
+#include "GzIslandConstraintSolver.hh"
+#include "GzOdeCollisionDetector.hh"
+#include "GzThreadedOdeCollisionDetector.hh"
+#include "SimulationFeatures.hh"
+#include "TiledHeightmap.hh"
+
+#if DART_VERSION_AT_LEAST(6, 13, 0)
+// The ContactSurfaceParams class was first added to version 6.10 of our fork
+// of dart, and then merged upstream and released in version 6.13.0 with
+// different public member variable names.
+// See https://github.com/dartsim/dart/pull/1626 and
+// https://github.com/gazebo-forks/dart/pull/22 for more info.
+#define DART_HAS_UPSTREAM_FRICTION_VARIABLE_NAMES
+// There's a sign difference between our fork and upstream dart in the
+// implementation of surface velocities. Here, we assume that 6.13 is the
+// upstream version. There's a potential that a user might update our fork to
+// version 6.13.0 or later. To support that case, we'll assume
+// DART_HAS_POSITIVE_CONTACT_SURFACE_MOTION_VELOCITY will be defined in the
+// fork. Note, if we simply check for
+// `DART_HAS_POSITIVE_CONTACT_SURFACE_MOTION_VELOCITY ` without the 6.13
+// condition above, we might break users that are building with our 6.10 fork
+// without updating or adding the
+// DART_HAS_POSITIVE_CONTACT_SURFACE_MOTION_VELOCITY define in their version of
+// dart.
+#ifndef DART_HAS_POSITIVE_CONTACT_SURFACE_MOTION_VELOCITY
+  #define DART_HAS_NEGATIVE_CONTACT_SURFACE_MOTION_VELOCITY
+#endif
+#endif
+
+namespace gz {
+namespace physics {
+namespace dartsim {
+
+/// \brief Identifies a dartsim world state snapshot.
+static constexpr std::uint32_t kSnapshotMagic = 0x44535753;  // "SWSD"
+
+/// \brief Version of the snapshot layout.
+static constexpr std::uint32_t kSnapshotVersion = 1;
+
+using detail::AppendToSnapshot;
+using detail::ReadFromSnapshot;
+using detail::SnapshotReader;
+
+/////////////////////////////////////////////////
+/// \brief Gives read access to the constrained groups that a constraint
+/// solver built during its last solve, which DART does not expose.
+class ConstrainedGroupAccess : public dart::constraint::ConstraintSolver
+{
+  /// \brief Get the number of constrained groups of the last solve.
+  /// \param[in] _solver Constraint solver of a world.
+  /// \return Number of constrained groups.
+  public: static std::size_t Count(
+      const dart::constraint::ConstraintSolver &_solver)
+  {
+    return (_solver.*&ConstrainedGroupAccess::mConstrainedGroups).size();
+  }
+
+  /// \brief Estimate the memory used by the constrained groups and contact
+  /// constraints of the last solve.
+  /// \param[in] _solver Constraint solver of a world.
+  /// \return Bytes used.
+  public: static std::size_t Bytes(
+      const dart::constraint::ConstraintSolver &_solver)
+  {
+    const auto &groups = _solver.*&ConstrainedGroupAccess::mConstrainedGroups;
+    std::size_t bytes = groups.capacity() * sizeof(groups[0]);
+    for (const auto &group : groups)
+    {
+      bytes += group.getNumConstraints() *
+          sizeof(dart::constraint::ConstraintBasePtr);
+    }
+    const auto &contacts =
+        _solver.*&ConstrainedGroupAccess::mContactConstraints;
+    bytes += contacts.size() * sizeof(dart::constraint::ContactConstraint);
+    return bytes;
+  }
+
+  /// \brief Visit the constraints of the constrained groups of the last
+  /// solve.
+  /// \param[in] _solver Constraint solver of a world.
+  /// \param[in] _func Function called with each constraint.
+  public: template <typename F>
+  static void ForEach(
+      const dart::constraint::ConstraintSolver &_solver, F &&_func)
+  {
+    const auto &groups = _solver.*&ConstrainedGroupAccess::mConstrainedGroups;
+    for (const auto &group : groups)
+    {
+      for (std::size_t i = 0; i < group.getNumConstraints(); ++i)
+        _func(*group.getConstraint(i));
+    }
+  }
+};
+
+/////////////////////////////////////////////////
+/// \brief Keep the joint forces commanded by the user for a step, which the
+/// forces of a joint PD controller are added to on every substep.
+/// The controller is not applied during the step if it does not match the
+/// joints of the model.
+/// \return Whether the controller is applied during the step.
+static bool StartJointPDControl(
+    const ModelInfo &_modelInfo, ModelJointPDControl &_control)
+{
+  std::size_t dofs = 0;
+  for (const auto &jointInfo : _modelInfo.joints)
+  {
+    if (jointInfo->joint)
+      dofs += jointInfo->joint->getNumDofs();
+  }
+
+  _control.active =
+      dofs == static_cast<std::size_t>(_control.positionGains.size());
+  if (!_control.active)
+    return false;
+
+  _control.commands.resize(static_cast<Eigen::Index>(dofs));
+  Eigen::Index k = 0;
+  for (const auto &jointInfo : _modelInfo.joints)
+  {
+    const auto *joint = jointInfo->joint.get();
+    if (!joint)
+      continue;
+
+    for (std::size_t i = 0; i < joint->getNumDofs(); ++i)
+      _control.commands[k++] = joint->getCommand(i);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Command the forces of a joint PD controller for the next substep.
+static void ApplyJointPDControl(
+    const ModelInfo &_modelInfo, const ModelJointPDControl &_control)
+{
+  Eigen::Index k = 0;
+  for (const auto &jointInfo : _modelInfo.joints)
+  {
+    auto *joint = jointInfo->joint.get();
+    if (!joint)
+      continue;
+
+    const std::size_t numDofs = joint->getNumDofs();
+    const Eigen::Index start = k;
+    k += static_cast<Eigen::Index>(numDofs);
+
+    // Joints that were given velocity commands follow those instead
+    if (numDofs == 0 ||
+        joint->getActuatorType() != dart::dynamics::Joint::FORCE)
+    {
+      continue;
+    }
+
+    const auto skeleton = joint->getSkeleton();
+    const Eigen::VectorXd &gravity = skeleton->getGravityForces();
+    for (std::size_t i = 0; i < numDofs; ++i)
+    {
+      const Eigen::Index d = start + static_cast<Eigen::Index>(i);
+
+      // The positions of joints with more than one DOF, like ball joints,
+      // can not be subtracted directly
+      const double positionError = numDofs == 1 ?
+          _control.targetPositions[d] - joint->getPosition(i) :
+          joint->getPositionDifferences(
+              _control.targetPositions.segment(
+                  start, static_cast<Eigen::Index>(numDofs)),
+              joint->getPositions())[static_cast<Eigen::Index>(i)];
+
+      double force = _control.commands[d]
+          + _control.positionGains[d] * positionError
+          + _control.velocityGains[d] *
+              (_control.targetVelocities[d] - joint->getVelocity(i));
+      if (_control.gravityCompensation)
+        force += gravity[static_cast<Eigen::Index>(
+            joint->getIndexInSkeleton(i))];
+
+      // Commands of force actuated joints are limited to their effort limits
+      joint->setCommand(i, force);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the generalized velocities of all skeletons of a world to
+/// _velocities, which only allocates if the world gained degrees of freedom.
+static void WorldVelocities(
+    const DartWorld &_world, Eigen::VectorXd &_velocities)
+{
+  std::size_t dofs = 0;
+  for (std::size_t i = 0; i < _world.getNumSkeletons(); ++i)
+    dofs += _world.getSkeleton(i)->getNumDofs();
+  _velocities.resize(static_cast<Eigen::Index>(dofs));
+
+  Eigen::Index k = 0;
+  for (std::size_t i = 0; i < _world.getNumSkeletons(); ++i)
+  {
+    const auto &skeleton = *_world.getSkeleton(i);
+    for (std::size_t j = 0; j < skeleton.getNumDofs(); ++j)
+      _velocities[k++] = skeleton.getVelocity(j);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the largest change of a generalized velocity of a world since
+/// WorldVelocities wrote _velocities.
+static double MaxVelocityChange(
+    const DartWorld &_world, const Eigen::VectorXd &_velocities)
+{
+  double change = 0.0;
+  Eigen::Index k = 0;
+  for (std::size_t i = 0; i < _world.getNumSkeletons(); ++i)
+  {
+    const auto &skeleton = *_world.getSkeleton(i);
+    for (std::size_t j = 0; j < skeleton.getNumDofs(); ++j)
+    {
+      if (k >= _velocities.size())
+        return change;
+      change = std::max(
+          change, std::fabs(skeleton.getVelocity(j) - _velocities[k++]));
+    }
+  }
+  return change;
+}
+
+/////////////////////////////////////////////////
+/// \brief ODE needs its per thread collision data to be allocated before it
+/// is used on a thread. Call this before stepping a world on a thread that
+/// may not have stepped an ODE world before. It is a no-op after the first
+/// time on each thread.
+static void AllocateOdeDataForThread(DartWorld &_world)
+{
+  const bool usesOde = nullptr != dynamic_cast<
+      dart::collision::OdeCollisionDetector *>(
+          _world.getConstraintSolver()->getCollisionDetector().get());
+  if (usesOde)
+    dAllocateODEDataForThread(dAllocateMaskAll);
+}
+
+/////////////////////////////////////////////////
+double SimulationFeatures::StepWorld(
+    DartWorld *_world, std::size_t _subSteps,
+    const std::vector<JointPDControlStep> &_controls,
+    AdaptiveStep *_adaptive, StepStatistics &_stats)
+{
+  auto *solver = _world->getConstraintSolver();
+  auto *detector = dynamic_cast<dart::collision::GzOdeCollisionDetector *>(
+      solver->getCollisionDetector().get());
+  if (detector)
+    detector->ResetCollideTime();
+
+  // The bodies that the filter ignores are read from its tables, which are
+  // only built again when the structure of the world changed
+  if (auto *filter = dynamic_cast<BitmaskContactFilter *>(
+          solver->getCollisionOption().collisionFilter.get()))
+  {
+    filter->UpdateIgnoredPairs(*_world);
+  }
+
+  // The solver statistics add up over the substeps of the step
+  if (auto *contactSolver =
+          dynamic_cast<dart::constraint::GzContactConstraintSolver *>(solver))
+  {
+    contactSolver->ResetStatistics();
+  }
+
+  // The time step of the world stays the one given by the caller, which is
+  // the shortest adaptive step, and is only changed for the step itself
+  const double timeStep = _world->getTimeStep();
+  double stepSize = timeStep;
+  if (_adaptive)
+  {
+    stepSize = _adaptive->controller.NextStepSize(timeStep);
+    WorldVelocities(*_world, _adaptive->velocities);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const std::size_t startAllocations = AllocationCount();
+
+  bool controlled = false;
+  for (const auto &control : _controls)
+    controlled |= StartJointPDControl(*control.first, *control.second);
+
+  auto applyControls = [&_controls, controlled]()
+  {
+    if (!controlled)
+      return;
+
+    for (const auto &control : _controls)
+    {
+      if (control.second->active)
+        ApplyJointPDControl(*control.first, *control.second);
+    }
+  };
+
+  if (_subSteps <= 1u)
+  {
+    applyControls();
+    if (stepSize != timeStep)
+      _world->setTimeStep(stepSize);
+    _world->step();
+  }
+  else
+  {
+    // Forces and commands are only reset after the last substep, so they act
+    // on the whole step. Controllers are evaluated again before every
+    // substep, from the commands that were given for the step.
+    _world->setTimeStep(stepSize / static_cast<double>(_subSteps));
+    for (std::size_t i = 1; i <= _subSteps; ++i)
+    {
+      applyControls();
+      _world->step(i == _subSteps);
+    }
+  }
+  if (_world->getTimeStep() != timeStep)
+    _world->setTimeStep(timeStep);
+  const double stepTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  const std::size_t stepAllocations = AllocationCount() - startAllocations;
+
+  // DART runs collision detection from within its constraint solver, and ODE
+  // tests the pairs in the same pass that finds them, so the whole collision
+  // query is reported as narrowphase. Forward dynamics and integration are
+  // not separated from the constraint solve either, so they are counted as
+  // solver time and allocations. ODE does not report the number of candidate
+  // pairs.
+  _stats = StepStatistics();
+  _stats.stepTime = stepTime;
+  if (detector)
+    _stats.narrowphaseTime = std::min(detector->GetCollideTime(), stepTime);
+  _stats.solverTime = stepTime - _stats.narrowphaseTime;
+  _stats.stepAllocations = stepAllocations;
+  if (detector)
+  {
+    _stats.narrowphaseAllocations =
+        std::min(detector->GetCollideAllocations(), stepAllocations);
+  }
+  _stats.solverAllocations = stepAllocations - _stats.narrowphaseAllocations;
+  _stats.contactCount = _world->getLastCollisionResult().getNumContacts();
+  _stats.collisionDetector = solver->getCollisionDetector()->getType();
+  _stats.islandCount = ConstrainedGroupAccess::Count(*solver);
+
+  if (_adaptive)
+  {
+    // DART detects collisions before it moves the bodies, so the deepest
+    // penetration is the one that the step started from and resolved
+    double penetration = 0.0;
+    for (const auto &contact : _world->getLastCollisionResult().getContacts())
+      penetration = std::max(penetration, contact.penetrationDepth);
+    _adaptive->controller.Update(stepSize, penetration,
+        MaxVelocityChange(*_world, _adaptive->velocities));
+  }
+  return stepSize;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WorldForwardStep(
+    const Identity &_worldID,
+    ForwardStep::Output & _h,
+    ForwardStep::State & _x,
+    const ForwardStep::Input & _u)
+{
+  GZ_PROFILE("SimulationFeatures::WorldForwardStep");
+
+  // Other worlds may be stepped at the same time, see
+  // ConcurrentWorldStepFeature, so only the integration of this world runs
+  // without stepMutex.
+  std::shared_lock<std::shared_mutex> changeLock(this->entityChangeMutex);
+  std::unique_lock<std::mutex> lock(this->stepMutex);
+
+  this->frameDataCache.Invalidate();
+  auto *world = this->ReferenceInterface<DartWorld>(_worldID);
+  this->UpdateTimeStep(world, _u);
+
+  auto *stateSnapshot = _x.Query<WorldStateSnapshot>();
+  Snapshot liveState;
+  if (!detail::BeginSnapshotStep(*this, _worldID, stateSnapshot, liveState))
+    return;
+
+  // Models are put to sleep first, so that no forces are applied to them
+  const std::unordered_set<std::size_t> stepWorldIDs = {_worldID.id};
+  this->UpdateSleepingModels(stepWorldIDs);
+  this->ApplyAddedMassGravity(stepWorldIDs);
+  this->ApplyForceFields(stepWorldIDs);
+  this->UpdateHeightmapTiles(world);
+  this->UpdateTaskScheduler(world);
+  if (!this->kinematicModels.empty())
+    this->IntegrateKinematicModels(stepWorldIDs);
+
+  // TODO(MXG): Parse input
+  auto &stats = this->stepStatistics[_worldID.id];
+  std::vector<JointPDControlStep> controls;
+  this->CollectJointPDControls(_worldID.id, controls);
+
+  // Contacts with heightmap tiles are looked up in heightmapTiles during
+  // the step, which the steps of other worlds update
+  if (this->heightmapTiles.empty())
+    lock.unlock();
+
+  // Steps may come from any thread, including the threads of other worlds
+  // and of AsyncForwardStepFeature
+  AllocateOdeDataForThread(*world);
+  const double stepSize = StepWorld(world, this->SubStepsOf(_worldID),
+      controls, this->AdaptiveStepOf(_worldID), stats);
+  if (!lock.owns_lock())
+    lock.lock();
+  this->worldLastStepSizes[_worldID.id] = stepSize;
+  if (!this->autoCollisionDetectors.empty())
+    this->UpdateAutoCollisionDetector(_worldID.id, stats.stepTime);
+
+  // Links of other worlds may be moving on other threads
+  this->filterWrittenLinks = this->worlds.size() > 1u;
+  if (this->filterWrittenLinks)
+  {
+    this->writeSkeletons.clear();
+    for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+      this->writeSkeletons.insert(world->getSkeleton(i).get());
+  }
+
+  const auto writeStart = std::chrono::steady_clock::now();
+  const std::size_t writeAllocations = AllocationCount();
+  this->WriteRequiredData(_h);
+  this->Write(_h.Get<ChangedWorldPoses>());
+  this->WriteTwists(_h);
+  this->WriteAccelerations(_h);
+  this->WriteJointStates(_h);
+  stats.poseWriteTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - writeStart).count();
+  stats.stepTime += stats.poseWriteTime;
+  stats.poseWriteAllocations = AllocationCount() - writeAllocations;
+  stats.stepAllocations += stats.poseWriteAllocations;
+  this->filterWrittenLinks = false;
+  if (!this->publishedStates.empty())
+    this->PublishWorldState(_worldID.id);
+  this->RecordInterpolationPoses(_worldID.id);
+  if (!this->sharedStateExports.empty())
+    this->ExportSharedState(_worldID.id);
+  if (!this->modelStepStatistics.empty())
+    this->CollectModelStepStatistics(_worldID.id);
+
+  detail::EndSnapshotStep(*this, _worldID, stateSnapshot, liveState);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::StepEngineWorlds(
+    const Identity &/*_engineID*/,
+    const std::size_t *_worldIDs,
+    std::size_t _count,
+    ForwardStep::Output &_h,
+    ForwardStep::State &/*_x*/,
+    const ForwardStep::Input &_u,
+    std::size_t _numThreads)
+{
+  GZ_PROFILE("SimulationFeatures::StepEngineWorlds");
+  this->frameDataCache.Invalidate();
+
+  std::vector<DartWorld *> stepWorlds;
+  std::vector<StepStatistics *> stepStats;
+  std::vector<std::size_t> stepSubSteps;
+  std::vector<std::vector<JointPDControlStep>> stepControls;
+  std::vector<AdaptiveStep *> stepAdaptive;
+  std::vector<std::size_t> stepIDs;
+  std::vector<double> stepSizes;
+  std::unordered_set<std::size_t> stepWorldIDs;
+  stepWorlds.reserve(_count);
+  stepStats.reserve(_count);
+  stepSubSteps.reserve(_count);
+  stepControls.reserve(_count);
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    auto *world = this->worlds.Find(_worldIDs[i]);
+    if (!world || !stepWorldIDs.insert(_worldIDs[i]).second)
+    {
+      gzerr << "Entity [" << _worldIDs[i] << "] is not a world, or is given "
+            << "more than once. It will not be stepped\n";
+      continue;
+    }
+    this->UpdateTimeStep(world->get(), _u);
+    this->UpdateHeightmapTiles(world->get());
+    this->UpdateTaskScheduler(world->get());
+    stepWorlds.push_back(world->get());
+    stepStats.push_back(&this->stepStatistics[_worldIDs[i]]);
+    stepSubSteps.push_back(this->SubStepsOf(_worldIDs[i]));
+    stepControls.emplace_back();
+    this->CollectJointPDControls(_worldIDs[i], stepControls.back());
+    stepAdaptive.push_back(this->AdaptiveStepOf(_worldIDs[i]));
+    stepIDs.push_back(_worldIDs[i]);
+  }
+  stepSizes.resize(stepWorlds.size());
+
+  this->UpdateSleepingModels(stepWorldIDs);
+  this->ApplyAddedMassGravity(stepWorldIDs);
+  this->ApplyForceFields(stepWorldIDs);
+  if (!this->kinematicModels.empty())
+    this->IntegrateKinematicModels(stepWorldIDs);
+
+  std::size_t numThreads = _numThreads;
+  if (numThreads == 0)
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  numThreads = std::min(numThreads, stepWorlds.size());
+
+  if (numThreads <= 1u)
+  {
+    for (std::size_t i = 0; i < stepWorlds.size(); ++i)
+    {
+      AllocateOdeDataForThread(*stepWorlds[i]);
+      stepSizes[i] = StepWorld(stepWorlds[i], stepSubSteps[i],
+          stepControls[i], stepAdaptive[i], *stepStats[i]);
+    }
+  }
+  else
+  {
+    // Every world owns its collision detector and constraint solver, so
+    // worlds can be stepped concurrently.
+    this->RunTasks(this->stepWorldsPool, this->stepWorldsPoolThreads,
+        numThreads, stepWorlds.size(), [&](std::size_t _i)
+    {
+      DartWorld *world = stepWorlds[_i];
+      AllocateOdeDataForThread(*world);
+      stepSizes[_i] = StepWorld(world, stepSubSteps[_i], stepControls[_i],
+          stepAdaptive[_i], *stepStats[_i]);
+    });
+  }
+  for (std::size_t i = 0; i < stepIDs.size(); ++i)
+  {
+    this->worldLastStepSizes[stepIDs[i]] = stepSizes[i];
+    if (!this->autoCollisionDetectors.empty())
+      this->UpdateAutoCollisionDetector(stepIDs[i], stepStats[i]->stepTime);
+  }
+
+  const auto writeStart = std::chrono::steady_clock::now();
+  const std::size_t writeAllocations = AllocationCount();
+  this->WriteRequiredData(_h);
+  this->Write(_h.Get<ChangedWorldPoses>());
+  this->WriteTwists(_h);
+  this->WriteAccelerations(_h);
+  this->WriteJointStates(_h);
+  const double poseWriteTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - writeStart).count();
+  const std::size_t poseWriteAllocations =
+      AllocationCount() - writeAllocations;
+  for (auto *stats : stepStats)
+  {
+    stats->poseWriteTime = poseWriteTime;
+    stats->stepTime += poseWriteTime;
+    stats->poseWriteAllocations = poseWriteAllocations;
+    stats->stepAllocations += poseWriteAllocations;
+  }
+
+  if (!this->publishedStates.empty())
+  {
+    for (const std::size_t worldID : stepWorldIDs)
+      this->PublishWorldState(worldID);
+  }
+  for (const std::size_t worldID : stepWorldIDs)
+    this->RecordInterpolationPoses(worldID);
+  if (!this->sharedStateExports.empty())
+  {
+    for (const std::size_t worldID : stepWorldIDs)
+      this->ExportSharedState(worldID);
+  }
+  if (!this->modelStepStatistics.empty())
+  {
+    for (const std::size_t worldID : stepWorldIDs)
+      this->CollectModelStepStatistics(worldID);
+  }
+}
+
+/////////////////////////////////////////////////
+std::shared_mutex &SimulationFeatures::EngineEntityChangeMutex(
+    const Identity &/*_engineID*/)
+{
+  return this->entityChangeMutex;
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::GetWorldPublishedStateBuffer(
+    const Identity &_worldID)
+    -> std::shared_ptr<const PublishedWorldStateBuffer>
+{
+  // Steps of other worlds look up their buffers at the same time
+  std::lock_guard<std::mutex> lock(this->stepMutex);
+  auto &buffer = this->publishedStates[_worldID.id];
+  if (!buffer)
+    buffer = std::make_shared<PublishedWorldStateBuffer>();
+  return buffer;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::GetWorldInterpolatedPoses(
+    const Identity &_worldID,
+    const double _fraction,
+    std::vector<WorldPose> &_poses) const
+{
+  std::lock_guard<std::mutex> lock(this->interpolationMutex);
+  // The first call only starts recording, since the kinematics of the world
+  // may be changing on another thread.
+  const auto &poses = this->interpolationPoses[_worldID.id];
+  PoseInterpolationFeature::Implementation<FeaturePolicy3d>::InterpolatePoses(
+      poses.previous, poses.current, _fraction, _poses);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldSharedStateExport(
+    const Identity &_worldID,
+    std::shared_ptr<SharedStateRingWriter> _writer)
+{
+  std::lock_guard<std::mutex> lock(this->stepMutex);
+  if (_writer)
+    this->sharedStateExports[_worldID.id] = std::move(_writer);
+  else
+    this->sharedStateExports.erase(_worldID.id);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::PublishWorldState(std::size_t _worldID)
+{
+  const auto it = this->publishedStates.find(_worldID);
+  if (it == this->publishedStates.end())
+    return;
+
+  const DartWorldPtr &world = this->worlds.at(_worldID);
+  this->publishSkeletons.clear();
+  for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+    this->publishSkeletons.insert(world->getSkeleton(i).get());
+
+  const auto state = it->second->Prepare();
+  state->time = world->getTime();
+  state->iteration = static_cast<std::size_t>(world->getSimFrames());
+  state->poses.clear();
+  state->twists.clear();
+
+  const auto &ids = this->links.Ids();
+  const auto &infos = this->links.Objects();
+  for (std::size_t i = 0; i < infos.size(); ++i)
+  {
+    const auto &info = infos[i];
+    if (!info || !info->link ||
+        this->publishSkeletons.count(info->link->getSkeleton().get()) == 0)
+    {
+      continue;
+    }
+
+    const auto *frame = info->Frame();
+    WorldPose pose;
+    pose.pose = gz::math::eigen3::convert(frame->getWorldTransform());
+    pose.body = ids[i];
+    state->poses.push_back(pose);
+
+    WorldTwist twist;
+    twist.linearVelocity =
+        gz::math::eigen3::convert(frame->getLinearVelocity());
+    twist.angularVelocity =
+        gz::math::eigen3::convert(frame->getAngularVelocity());
+    twist.body = ids[i];
+    state->twists.push_back(twist);
+  }
+
+  it->second->Publish(state);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::RecordInterpolationPoses(std::size_t _worldID)
+{
+  std::vector<WorldPose> poses;
+  {
+    std::lock_guard<std::mutex> lock(this->interpolationMutex);
+    const auto it = this->interpolationPoses.find(_worldID);
+    if (it == this->interpolationPoses.end())
+      return;
+    poses.swap(it->second.spare);
+  }
+
+  // The poses are read without holding the lock, so readers do not wait
+  // for the kinematics of the world.
+  const DartWorldPtr &world = this->worlds.at(_worldID);
+  this->publishSkeletons.clear();
+  for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+    this->publishSkeletons.insert(world->getSkeleton(i).get());
+
+  poses.clear();
+  const auto &ids = this->links.Ids();
+  const auto &infos = this->links.Objects();
+  for (std::size_t i = 0; i < infos.size(); ++i)
+  {
+    const auto &info = infos[i];
+    if (!info || !info->link ||
+        this->publishSkeletons.count(info->link->getSkeleton().get()) == 0)
+    {
+      continue;
+    }
+
+    WorldPose pose;
+    pose.pose = gz::math::eigen3::convert(info->Frame()->getWorldTransform());
+    pose.body = ids[i];
+    poses.push_back(pose);
+  }
+
+  std::lock_guard<std::mutex> lock(this->interpolationMutex);
+  auto &entry = this->interpolationPoses[_worldID];
+  entry.spare = std::move(entry.previous);
+  entry.previous = std::move(entry.current);
+  entry.current = std::move(poses);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::ExportSharedState(std::size_t _worldID)
+{
+  const auto it = this->sharedStateExports.find(_worldID);
+  if (it == this->sharedStateExports.end())
+    return;
+
+  SharedStateRingWriter &writer = *it->second;
+  const DartWorldPtr &world = this->worlds.at(_worldID);
+  if (!writer.BeginFrame(world->getTime()))
+    return;
+
+  this->publishSkeletons.clear();
+  for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+    this->publishSkeletons.insert(world->getSkeleton(i).get());
+
+  const auto &linkIds = this->links.Ids();
+  const auto &linkInfos = this->links.Objects();
+  for (std::size_t i = 0; i < linkInfos.size(); ++i)
+  {
+    const auto &info = linkInfos[i];
+    if (!info || !info->link ||
+        this->publishSkeletons.count(info->link->getSkeleton().get()) == 0)
+    {
+      continue;
+    }
+
+    writer.AddPose(linkIds[i], gz::math::eigen3::convert(
+        info->Frame()->getWorldTransform()));
+  }
+
+  const auto &jointIds = this->joints.Ids();
+  const auto &jointInfos = this->joints.Objects();
+  for (std::size_t i = 0; i < jointInfos.size(); ++i)
+  {
+    const auto &info = jointInfos[i];
+    if (!info || !info->joint ||
+        this->publishSkeletons.count(info->joint->getSkeleton().get()) == 0)
+    {
+      continue;
+    }
+
+    const auto *joint = info->joint.get();
+    for (std::size_t d = 0; d < joint->getNumDofs(); ++d)
+    {
+      writer.AddJointState(jointIds[i], d, joint->getPosition(d),
+          joint->getVelocity(d), joint->getAcceleration(d),
+          joint->getForce(d));
+    }
+  }
+
+  const auto contacts = this->GetContactBatchFromLastStep(
+      this->GenerateIdentity(_worldID, world));
+  for (std::size_t i = 0; i < contacts.size; ++i)
+  {
+    SharedStateContact contact;
+    contact.collision1 = contacts.collision1[i];
+    contact.collision2 = contacts.collision2[i];
+    contact.point = gz::math::eigen3::convert(contacts.point[i]);
+    contact.normal = gz::math::eigen3::convert(contacts.normal[i]);
+    contact.depth = contacts.depth[i];
+    contact.force = gz::math::eigen3::convert(contacts.force[i]);
+    writer.AddContact(contact);
+  }
+
+  writer.EndFrame();
+}
+
+/////////////////////////////////////////////////
+std::shared_future<void> SimulationFeatures::StartWorldStep(
+    const Identity &_worldID,
+    const ForwardStep::Input &_u)
+{
+  return this->asyncSteppers.Start(_worldID, _u);
+}
+
+/////////////////////////////////////////////////
+const ForwardStep::Output &SimulationFeatures::FinishWorldStep(
+    const Identity &_worldID)
+{
+  return this->asyncSteppers.Finish(_worldID);
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::StepStatistics SimulationFeatures::GetWorldStepStatistics(
+    const Identity &_worldID) const
+{
+  const auto it = this->stepStatistics.find(_worldID.id);
+  if (it == this->stepStatistics.end())
+    return StepStatistics();
+  return it->second;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldModelStepStatisticsEnabled(
+    const Identity &_worldID, bool _enable)
+{
+  std::lock_guard<std::mutex> lock(this->stepMutex);
+  if (_enable)
+    this->modelStepStatistics[_worldID.id];
+  else
+    this->modelStepStatistics.erase(_worldID.id);
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::GetWorldModelStepStatistics(
+    const Identity &_worldID) const -> std::vector<ModelStepStatistics>
+{
+  std::lock_guard<std::mutex> lock(this->stepMutex);
+  const auto it = this->modelStepStatistics.find(_worldID.id);
+  if (it == this->modelStepStatistics.end())
+    return {};
+  return it->second;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::CollectModelStepStatistics(std::size_t _worldID)
+{
+  const auto it = this->modelStepStatistics.find(_worldID);
+  if (it == this->modelStepStatistics.end())
+    return;
+
+  // ODE tests the pairs of objects in the same pass that finds them, and
+  // neither reports them nor times them one by one, so only contacts and
+  // constraint rows are attributed. The rows of a contact constraint are
+  // counted for both of its models, from the contacts of the step, since
+  // the constraint only knows the skeleton it is solved with.
+  std::map<std::size_t, ModelStepStatistics> models;
+  auto modelOf = [this, &models](
+      const dart::dynamics::ConstSkeletonPtr &_skeleton)
+      -> ModelStepStatistics *
+  {
+    if (!_skeleton || !this->models.HasEntity(_skeleton))
+      return nullptr;
+    const std::size_t id = this->models.IdentityOf(_skeleton);
+    ModelStepStatistics &stats = models[id];
+    stats.model = id;
+    return &stats;
+  };
+
+  const auto &world = this->worlds.at(_worldID);
+  const auto &result = world->getLastCollisionResult();
+  for (std::size_t i = 0; i < result.getNumContacts(); ++i)
+  {
+    const auto &contact = result.getContact(i);
+    const auto skeleton1 = contact.collisionObject1->getShapeFrame()
+        ->asShapeNode()->getSkeleton();
+    const auto skeleton2 = contact.collisionObject2->getShapeFrame()
+        ->asShapeNode()->getSkeleton();
+    for (const auto &skeleton :
+        {skeleton1, skeleton2 == skeleton1 ? nullptr : skeleton2})
+    {
+      if (auto *stats = modelOf(skeleton))
+      {
+        ++stats->contactCount;
+        stats->constraintRowCount += 3u;
+      }
+    }
+  }
+
+  ConstrainedGroupAccess::ForEach(*world->getConstraintSolver(),
+      [&modelOf](const dart::constraint::ConstraintBase &_constraint)
+      {
+        if (dynamic_cast<const dart::constraint::ContactConstraint *>(
+            &_constraint))
+        {
+          return;
+        }
+        if (auto *stats = modelOf(_constraint.getRootSkeleton()))
+          stats->constraintRowCount += _constraint.getDimension();
+      });
+
+  it->second.clear();
+  it->second.reserve(models.size());
+  for (const auto &entry : models)
+    it->second.push_back(entry.second);
+}
+
+/////////////////////////////////////////////////
+/// \brief Estimate the memory used by the data of a shape.
+/// \param[in] _shape Shape to measure.
+/// \return Bytes used.
+static std::size_t ShapeBytes(const dart::dynamics::Shape &_shape)
+{
+  if (const auto *mesh = dynamic_cast<const dart::dynamics::MeshShape *>(
+        &_shape))
+  {
+    std::size_t bytes = sizeof(*mesh);
+    const aiScene *scene = mesh->getMesh();
+    for (unsigned int i = 0; scene && i < scene->mNumMeshes; ++i)
+    {
+      const aiMesh *m = scene->mMeshes[i];
+      bytes += m->mNumVertices * sizeof(aiVector3D) *
+          (m->HasNormals() ? 2u : 1u);
+      for (unsigned int f = 0; f < m->mNumFaces; ++f)
+      {
+        bytes += sizeof(aiFace) +
+            m->mFaces[f].mNumIndices * sizeof(unsigned int);
+      }
+    }
+    return bytes;
+  }
+  if (const auto *heightmap =
+        dynamic_cast<const dart::dynamics::HeightmapShape<float> *>(&_shape))
+  {
+    return sizeof(*heightmap) +
+        heightmap->getHeightField().size() * sizeof(float);
+  }
+  if (const auto *heightmap =
+        dynamic_cast<const dart::dynamics::HeightmapShape<double> *>(&_shape))
+  {
+    return sizeof(*heightmap) +
+        heightmap->getHeightField().size() * sizeof(double);
+  }
+  return sizeof(dart::dynamics::Shape);
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::MemoryUsage SimulationFeatures::GetWorldMemoryUsage(
+    const Identity &_worldID) const
+{
+  const auto &world = this->worlds.at(_worldID);
+
+  // The ODE collision geometry mirrors the shapes of the world, and is not
+  // counted.
+  MemoryUsage usage;
+  usage.entityBytes = sizeof(dart::simulation::World) +
+      decltype(this->worlds)::EntryBytes();
+  std::unordered_set<const dart::dynamics::Shape *> shapesCounted;
+  for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+  {
+    const auto skeleton = world->getSkeleton(i);
+    usage.entityBytes += sizeof(dart::dynamics::Skeleton);
+    if (this->models.HasEntity(skeleton))
+    {
+      const auto &modelInfo = this->models.at(skeleton);
+      usage.entityBytes += decltype(this->models)::EntryBytes() +
+          sizeof(ModelInfo) +
+          modelInfo->links.size() * (sizeof(LinkInfo) +
+              decltype(this->links)::EntryBytes()) +
+          modelInfo->joints.size() * (sizeof(JointInfo) +
+              decltype(this->joints)::EntryBytes());
+    }
+
+    for (std::size_t j = 0; j < skeleton->getNumJoints(); ++j)
+    {
+      usage.entityBytes += sizeof(dart::dynamics::Joint) +
+          skeleton->getJoint(j)->getNumDofs() *
+              sizeof(dart::dynamics::DegreeOfFreedom);
+    }
+
+    for (std::size_t j = 0; j < skeleton->getNumBodyNodes(); ++j)
+    {
+      const auto *bn = skeleton->getBodyNode(j);
+      usage.entityBytes += sizeof(dart::dynamics::BodyNode);
+      for (std::size_t k = 0; k < bn->getNumShapeNodes(); ++k)
+      {
+        const auto *sn = bn->getShapeNode(k);
+        usage.entityBytes += sizeof(dart::dynamics::ShapeNode);
+        if (this->shapes.HasEntity(sn))
+        {
+          const auto &shapeInfo = this->shapes.at(sn);
+          usage.entityBytes += decltype(this->shapes)::EntryBytes() +
+              sizeof(ShapeInfo);
+          if (shapeInfo->tiledHeightmap)
+            usage.geometryBytes += shapeInfo->tiledHeightmap->MemoryBytes();
+        }
+
+        const auto *shape = sn->getShape().get();
+        if (shape && shapesCounted.insert(shape).second)
+          usage.geometryBytes += ShapeBytes(*shape);
+      }
+    }
+  }
+
+  const auto *solver = world->getConstraintSolver();
+  usage.solverBytes = ConstrainedGroupAccess::Bytes(*solver) +
+      world->getLastCollisionResult().getNumContacts() *
+          sizeof(dart::collision::Contact);
+  return usage;
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::SubStepsOf(std::size_t _worldID) const
+{
+  const auto it = this->worldSubSteps.find(_worldID);
+  return it == this->worldSubSteps.end() ? 1u : it->second;
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::AdaptiveStepOf(std::size_t _worldID)
+    -> AdaptiveStep *
+{
+  const auto it = this->worldAdaptiveSteps.find(_worldID);
+  return it == this->worldAdaptiveSteps.end() ? nullptr : &it->second;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::UpdateAutoCollisionDetector(
+    const std::size_t _worldID, const double _stepTime)
+{
+  const auto it = this->autoCollisionDetectors.find(_worldID);
+  if (it == this->autoCollisionDetectors.end() || !it->second.Benchmarking())
+    return;
+
+  if (this->deterministic)
+  {
+    this->StopAutoCollisionBenchmark(_worldID, it->second);
+    return;
+  }
+
+  if (it->second.Update(_stepTime))
+  {
+    SwitchCollisionDetector(
+        *this->worlds.at(_worldID), it->second.Current());
+  }
+  if (!it->second.Benchmarking())
+  {
+    gzmsg << "Selected [" << it->second.Current()
+          << "] collision detector after timing the first steps"
+          << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::StopAutoCollisionBenchmark(
+    const std::size_t _worldID, AutoCollisionDetector &_selection)
+{
+  if (_selection.StopBenchmarking())
+    SwitchCollisionDetector(*this->worlds.at(_worldID), _selection.Current());
+  gzmsg << "Selected [" << _selection.Current() << "] collision detector "
+        << "without timing steps, since steps are deterministic" << std::endl;
+}
+
+/////////////////////////////////////////////////
+double SimulationFeatures::NextStepSizeOf(std::size_t _worldID)
+{
+  const double timeStep = this->worlds.at(_worldID)->getTimeStep();
+  const auto *adaptive = this->AdaptiveStepOf(_worldID);
+  return adaptive ? adaptive->controller.NextStepSize(timeStep) : timeStep;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::CollectJointPDControls(
+    std::size_t _worldID, std::vector<JointPDControlStep> &_controls)
+{
+  _controls.clear();
+  for (auto &[modelID, control] : this->jointPDControls)
+  {
+    if (this->GetWorldOfModelImpl(modelID) == _worldID)
+      _controls.emplace_back(this->models.at(modelID).get(), &control);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::UpdateTimeStep(
+    DartWorld *_world, const ForwardStep::Input &_u) const
+{
+  auto *dtDur =
+      _u.Query<std::chrono::steady_clock::duration>();
+  const double tol = 1e-6;
+
+  if (dtDur)
+  {
+    std::chrono::duration<double> dt = *dtDur;
+    if (std::fabs(dt.count() - _world->getTimeStep()) > tol)
+    {
+      _world->setTimeStep(dt.count());
+      gzdbg << "Simulation timestep set to: " << _world->getTimeStep()
+             << std::endl;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+WorldStateSnapshotFeature::Snapshot SimulationFeatures::GetWorldStateSnapshot(
+    const Identity &_worldID) const
+{
+  const auto &world = this->worlds.at(_worldID);
+
+  // Every DOF is stored as its position, velocity and acceleration. dartsim
+  // solves the contacts from scratch on every step, so there is no solver
+  // data to carry over.
+  std::size_t numDofs = 0;
+  for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+    numDofs += world->getSkeleton(i)->getNumDofs();
+
+  Snapshot snapshot;
+  snapshot.reserve(2 * sizeof(std::uint32_t) + sizeof(double) +
+                   (1 + world->getNumSkeletons()) * sizeof(std::uint64_t) +
+                   3 * numDofs * sizeof(double));
+
+  AppendToSnapshot(snapshot, kSnapshotMagic);
+  AppendToSnapshot(snapshot, kSnapshotVersion);
+  AppendToSnapshot(snapshot, world->getTime());
+  AppendToSnapshot(
+      snapshot, static_cast<std::uint64_t>(world->getNumSkeletons()));
+  for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+  {
+    const auto &skel = world->getSkeleton(i);
+    const std::size_t skelDofs = skel->getNumDofs();
+    AppendToSnapshot(snapshot, static_cast<std::uint64_t>(skelDofs));
+    AppendToSnapshot(snapshot, skel->getPositions().data(), skelDofs);
+    AppendToSnapshot(snapshot, skel->getVelocities().data(), skelDofs);
+    AppendToSnapshot(snapshot, skel->getAccelerations().data(), skelDofs);
+  }
+
+  return snapshot;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::SetWorldStateSnapshot(
+    const Identity &_worldID, const Snapshot &_snapshot)
+{
+  const auto &world = this->worlds.at(_worldID);
+  SnapshotReader reader(_snapshot);
+
+  std::uint32_t magic = 0;
+  std::uint32_t version = 0;
+  double time = 0.0;
+  std::uint64_t numSkeletons = 0;
+  if (!ReadFromSnapshot(reader, magic) || magic != kSnapshotMagic ||
+      !ReadFromSnapshot(reader, version) || version != kSnapshotVersion ||
+      !ReadFromSnapshot(reader, time) ||
+      !ReadFromSnapshot(reader, numSkeletons) ||
+      numSkeletons != world->getNumSkeletons())
+  {
+    gzerr << "Snapshot does not match the state of world ["
+          << world->getName() << "]\n";
+    return false;
+  }
+
+  std::vector<Eigen::VectorXd> values(3 * numSkeletons);
+  for (std::size_t i = 0; i < numSkeletons; ++i)
+  {
+    const std::size_t skelDofs = world->getSkeleton(i)->getNumDofs();
+    std::uint64_t numDofs = 0;
+    bool ok = ReadFromSnapshot(reader, numDofs) && numDofs == skelDofs;
+    for (std::size_t j = 0; ok && j < 3; ++j)
+    {
+      values[3 * i + j].resize(static_cast<Eigen::Index>(skelDofs));
+      ok = ReadFromSnapshot(reader, values[3 * i + j].data(), skelDofs);
+    }
+
+    if (!ok)
+    {
+      gzerr << "Snapshot does not match the state of world ["
+            << world->getName() << "]\n";
+      return false;
+    }
+  }
+
+  if (!reader.AtEnd())
+  {
+    gzerr << "Snapshot does not match the state of world ["
+          << world->getName() << "]\n";
+    return false;
+  }
+
+  this->frameDataCache.Invalidate();
+  world->setTime(time);
+  for (std::size_t i = 0; i < numSkeletons; ++i)
+  {
+    const auto &skel = world->getSkeleton(i);
+    skel->setPositions(values[3 * i]);
+    skel->setVelocities(values[3 * i + 1]);
+    skel->setAccelerations(values[3 * i + 2]);
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(WorldPoses &_worldPoses) const
+{
+  // remove link poses from the previous iteration
+  _worldPoses.entries.clear();
+  _worldPoses.entries.reserve(this->links.size());
+
+  const auto &ids = this->links.Ids();
+  const auto &infos = this->links.Objects();
+  for (std::size_t i = 0; i < infos.size(); ++i)
+  {
+    const auto &info = infos[i];
+    if (!this->IsLinkWritten(*info))
+      continue;
+
+    WorldPose wp;
+    wp.pose = gz::math::eigen3::convert(
+        info->Frame()->getWorldTransform());
+    wp.body = ids[i];
+    _worldPoses.entries.push_back(wp);
+  }
+}
+
+void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
+{
+  // remove link poses from the previous iteration
+  _changedPoses.entries.clear();
+  _changedPoses.entries.reserve(this->links.size());
+
+  // Compare the raw transforms so that only links that actually moved pay for
+  // the conversion. The last reported transform lives in the LinkInfo, which
+  // also drops it when the link is removed.
+  const double tol = 1e-6;
+  const auto &ids = this->links.Ids();
+  const auto &infos = this->links.Objects();
+  auto writeRange = [&](std::size_t _begin, std::size_t _end,
+                        std::vector<WorldPose> &_entries)
+  {
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      const auto &info = infos[i];
+      // make sure the link exists
+      if (!info || !info->link || !this->IsLinkWritten(*info))
+        continue;
+
+      // Sleeping skeletons are not integrated, and were checked for set
+      // positions before stepping, so their links have not moved.
+      if (info->hasReportedWorldTransform &&
+          !this->sleepingSkeletons.empty() &&
+          this->sleepingSkeletons.count(info->link->getSkeleton().get()) > 0)
+      {
+        continue;
+      }
+
+      // If the link's pose is new or has changed, save this new pose and
+      // add it to the output poses. Otherwise, keep the existing link pose
+      const Eigen::Isometry3d &tf = info->Frame()->getWorldTransform();
+      if (info->hasReportedWorldTransform &&
+          ((tf.translation() - info->reportedWorldTransform.translation())
+              .cwiseAbs().maxCoeff() <= tol) &&
+          ((tf.linear() - info->reportedWorldTransform.linear())
+              .cwiseAbs().maxCoeff() <= tol))
+      {
+        continue;
+      }
+
+      WorldPose wp;
+      wp.pose = gz::math::eigen3::convert(tf);
+      wp.body = ids[i];
+      _entries.push_back(wp);
+
+      info->reportedWorldTransform = tf;
+      info->hasReportedWorldTransform = true;
+    }
+  };
+
+  if (!this->poseWriter.IsParallel(infos.size()))
+  {
+    writeRange(0u, infos.size(), _changedPoses.entries);
+    return;
+  }
+
+  GZ_PROFILE("SimulationFeatures::Write::Parallel");
+
+  // dartsim computes world transforms lazily and caches them in the body
+  // nodes, walking up to the root of the skeleton. Links of one skeleton
+  // may end up in different chunks, so bring every skeleton up to date
+  // first, with each skeleton handled by a single task.
+  std::vector<dart::dynamics::Skeleton *> skeletons;
+  for (const auto &world : this->worlds.Objects())
+  {
+    for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+    {
+      auto *skeleton = world->getSkeleton(i).get();
+      if (!this->filterWrittenLinks || this->writeSkeletons.count(skeleton) > 0)
+        skeletons.push_back(skeleton);
+    }
+  }
+  this->poseWriter.Write(skeletons.size(), this->taskScheduler.get(),
+      _changedPoses.entries,
+      [&skeletons](std::size_t _begin, std::size_t _end,
+                   std::vector<WorldPose> &)
+      {
+        for (std::size_t i = _begin; i < _end; ++i)
+        {
+          for (auto *bn : skeletons[i]->getBodyNodes())
+            bn->getWorldTransform();
+        }
+      });
+
+  this->poseWriter.Write(infos.size(), this->taskScheduler.get(),
+      _changedPoses.entries, writeRange);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(WorldTwists &_twists) const
+{
+  _twists.entries.clear();
+  _twists.entries.reserve(this->links.size());
+
+  const auto &ids = this->links.Ids();
+  const auto &infos = this->links.Objects();
+  for (std::size_t i = 0; i < infos.size(); ++i)
+  {
+    if (!this->IsLinkWritten(*infos[i]))
+      continue;
+
+    const auto *frame = infos[i]->Frame();
+    WorldTwist twist;
+    twist.linearVelocity =
+        gz::math::eigen3::convert(frame->getLinearVelocity());
+    twist.angularVelocity =
+        gz::math::eigen3::convert(frame->getAngularVelocity());
+    twist.body = ids[i];
+    _twists.entries.push_back(twist);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(ChangedWorldTwists &_changedTwists,
+    const ChangedWorldPoses &_changedPoses) const
+{
+  _changedTwists.entries.clear();
+  _changedTwists.entries.reserve(_changedPoses.entries.size());
+
+  for (const auto &wp : _changedPoses.entries)
+  {
+    WorldTwist twist;
+    twist.body = wp.body;
+    if (this->links.HasEntity(wp.body))
+    {
+      const auto *frame = this->links.at(wp.body)->Frame();
+      twist.linearVelocity =
+          gz::math::eigen3::convert(frame->getLinearVelocity());
+      twist.angularVelocity =
+          gz::math::eigen3::convert(frame->getAngularVelocity());
+    }
+    _changedTwists.entries.push_back(twist);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WriteTwists(ForwardStep::Output &_h) const
+{
+  if (auto *twists = _h.Query<WorldTwists>())
+    this->Write(*twists);
+  if (auto *changedTwists = _h.Query<ChangedWorldTwists>())
+    this->Write(*changedTwists, _h.Get<ChangedWorldPoses>());
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the world acceleration of a frame to _acceleration, as
+/// reported by FrameDataRelativeToWorld.
+static void FrameWorldAcceleration(const dart::dynamics::Frame &_frame,
+    WorldAcceleration &_acceleration)
+{
+  _acceleration.linearAcceleration =
+      gz::math::eigen3::convert(_frame.getLinearAcceleration());
+  _acceleration.angularAcceleration =
+      gz::math::eigen3::convert(_frame.getAngularAcceleration());
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(WorldAccelerations &_accelerations) const
+{
+  _accelerations.entries.clear();
+  _accelerations.entries.reserve(this->links.size());
+
+  const auto &ids = this->links.Ids();
+  const auto &infos = this->links.Objects();
+  for (std::size_t i = 0; i < infos.size(); ++i)
+  {
+    if (!this->IsLinkWritten(*infos[i]))
+      continue;
+
+    WorldAcceleration acceleration;
+    FrameWorldAcceleration(*infos[i]->Frame(), acceleration);
+    acceleration.body = ids[i];
+    _accelerations.entries.push_back(acceleration);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(
+    ChangedWorldAccelerations &_changedAccelerations,
+    const ChangedWorldPoses &_changedPoses) const
+{
+  _changedAccelerations.entries.clear();
+  _changedAccelerations.entries.reserve(_changedPoses.entries.size());
+
+  for (const auto &wp : _changedPoses.entries)
+  {
+    WorldAcceleration acceleration;
+    acceleration.body = wp.body;
+    if (this->links.HasEntity(wp.body))
+      FrameWorldAcceleration(*this->links.at(wp.body)->Frame(), acceleration);
+    _changedAccelerations.entries.push_back(acceleration);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WriteAccelerations(ForwardStep::Output &_h) const
+{
+  if (auto *accelerations = _h.Query<WorldAccelerations>())
+    this->Write(*accelerations);
+  if (auto *changedAccelerations = _h.Query<ChangedWorldAccelerations>())
+    this->Write(*changedAccelerations, _h.Get<ChangedWorldPoses>());
+}
+
+/////////////////////////////////////////////////
+/// \brief Clear the arrays of a JointStates or ChangedJointStates, keeping
+/// room for _size entries.
+template <typename StatesT>
+static void ClearJointStates(StatesT &_states, const std::size_t _size)
+{
+  for (auto *values : {&_states.joints, &_states.dofs})
+  {
+    values->clear();
+    values->reserve(_size);
+  }
+  for (auto *values : {&_states.positions, &_states.velocities,
+                       &_states.accelerations, &_states.efforts})
+  {
+    values->clear();
+    values->reserve(_size);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Append the state of every degree of freedom of a joint to a
+/// JointStates or ChangedJointStates.
+template <typename StatesT>
+static void AppendJointState(StatesT &_states, const std::size_t _id,
+    const dart::dynamics::Joint &_joint)
+{
+  for (std::size_t i = 0; i < _joint.getNumDofs(); ++i)
+  {
+    _states.joints.push_back(_id);
+    _states.dofs.push_back(i);
+    _states.positions.push_back(_joint.getPosition(i));
+    _states.velocities.push_back(_joint.getVelocity(i));
+    _states.accelerations.push_back(_joint.getAcceleration(i));
+    _states.efforts.push_back(_joint.getForce(i));
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(JointStates &_states) const
+{
+  ClearJointStates(_states, this->joints.size());
+
+  const auto &ids = this->joints.Ids();
+  const auto &infos = this->joints.Objects();
+  for (std::size_t i = 0; i < infos.size(); ++i)
+  {
+    if (!infos[i] || !infos[i]->joint || !this->IsJointWritten(*infos[i]))
+      continue;
+
+    AppendJointState(_states, ids[i], *infos[i]->joint);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(ChangedJointStates &_changedStates) const
+{
+  ClearJointStates(_changedStates, this->joints.size());
+
+  // Same tolerance as the one of ChangedWorldPoses
+  const double tol = 1e-6;
+  const auto &ids = this->joints.Ids();
+  const auto &infos = this->joints.Objects();
+  for (std::size_t i = 0; i < infos.size(); ++i)
+  {
+    const auto &info = infos[i];
+    if (!info || !info->joint || !this->IsJointWritten(*info))
+      continue;
+
+    const auto *joint = info->joint.get();
+    const std::size_t numDofs = joint->getNumDofs();
+    auto &reported = info->reportedState;
+    bool changed = reported.size() != 2 * numDofs;
+    for (std::size_t d = 0; !changed && d < numDofs; ++d)
+    {
+      changed = std::abs(joint->getPosition(d) - reported[d]) > tol ||
+          std::abs(joint->getVelocity(d) - reported[numDofs + d]) > tol;
+    }
+    if (!changed)
+      continue;
+
+    reported.resize(2 * numDofs);
+    for (std::size_t d = 0; d < numDofs; ++d)
+    {
+      reported[d] = joint->getPosition(d);
+      reported[numDofs + d] = joint->getVelocity(d);
+    }
+    AppendJointState(_changedStates, ids[i], *joint);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WriteJointStates(ForwardStep::Output &_h) const
+{
+  if (auto *states = _h.Query<JointStates>())
+    this->Write(*states);
+  if (auto *changedStates = _h.Query<ChangedJointStates>())
+    this->Write(*changedStates);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEnginePoseWriteThreads(
+    const Identity &/*_engineID*/,
+    std::size_t _numThreads,
+    std::size_t _minLinks)
+{
+  this->poseWriter.Set(_numThreads, _minLinks);
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::GetEnginePoseWriteThreads(
+    const Identity &/*_engineID*/) const
+{
+  return this->poseWriter.GetThreads();
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::GetEnginePoseWriteMinLinks(
+    const Identity &/*_engineID*/) const
+{
+  return this->poseWriter.GetMinLinks();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEngineDeterministic(
+    const Identity &/*_engineID*/, bool _deterministic)
+{
+  this->deterministic = _deterministic;
+  if (!this->deterministic)
+    return;
+
+  // Worlds whose detector is being timed keep the first one of the ranking,
+  // like "auto_static" would, from their next step on
+  for (auto &[worldID, selection] : this->autoCollisionDetectors)
+  {
+    if (selection.Benchmarking())
+      this->StopAutoCollisionBenchmark(worldID, selection);
+  }
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetEngineDeterministic(
+    const Identity &/*_engineID*/) const
+{
+  return this->deterministic;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEngineTaskScheduler(
+    const Identity &/*_engineID*/, std::shared_ptr<TaskScheduler> _scheduler)
+{
+  this->taskScheduler = std::move(_scheduler);
+
+  // The pools are not used while there is a scheduler. The solvers and
+  // detectors of the worlds pick it up before their next step.
+  if (this->taskScheduler)
+  {
+    this->stepWorldsPool.reset();
+    this->stepWorldsPoolThreads = 0u;
+    this->poseWriter.ReleasePool();
+    this->rayPool.reset();
+    this->rayPoolThreads = 0u;
+  }
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<TaskScheduler> SimulationFeatures::GetEngineTaskScheduler(
+    const Identity &/*_engineID*/) const
+{
+  return this->taskScheduler;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleepEnabled(
+    const Identity &_modelID, bool _enabled)
+{
+  if (_enabled)
+  {
+    this->sleepEnabledModels.insert(_modelID.id);
+  }
+  else
+  {
+    this->SetModelSleeping(_modelID, false);
+    this->sleepEnabledModels.erase(_modelID.id);
+  }
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelSleepEnabled(
+    const Identity &_modelID) const
+{
+  return this->sleepEnabledModels.count(_modelID.id) > 0;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleeping(
+    const Identity &_modelID, bool _sleeping)
+{
+  const auto &skel = this->ReferenceInterface<ModelInfo>(_modelID)->model;
+  auto it = this->sleepingModels.find(_modelID.id);
+  if (!_sleeping)
+  {
+    // The models of the island may be resting on this one
+    if (it != this->sleepingModels.end())
+      this->WakeSleepIsland(it->second.island);
+    return;
+  }
+
+  // Immobile skeletons, e.g. static models, are not integrated already
+  if (it != this->sleepingModels.end() ||
+      this->sleepEnabledModels.count(_modelID.id) == 0 || !skel->isMobile())
+  {
+    return;
+  }
+  this->PutModelToSleep(_modelID.id, this->nextSleepIsland++);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::PutModelToSleep(
+    std::size_t _modelID, std::size_t _island)
+{
+  const auto &skel = this->models.at(_modelID)->model;
+  skel->resetVelocities();
+  skel->setMobile(false);
+  auto &sleeping = this->sleepingModels[_modelID];
+  sleeping.positions = skel->getPositions();
+  sleeping.island = _island;
+
+  const auto timer = this->sleepThresholds.find(_modelID);
+  if (timer != this->sleepThresholds.end())
+    timer->second.restTime = 0.0;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WakeSleepIsland(std::size_t _island)
+{
+  for (auto it = this->sleepingModels.begin();
+       it != this->sleepingModels.end();)
+  {
+    if (it->second.island != _island)
+    {
+      ++it;
+      continue;
+    }
+
+    if (this->models.HasEntity(it->first))
+      this->models.at(it->first)->model->setMobile(true);
+    it = this->sleepingModels.erase(it);
+  }
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelSleeping(
+    const Identity &_modelID) const
+{
+  return this->sleepingModels.count(_modelID.id) > 0;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelSleepThresholds(
+    const Identity &_modelID, const SleepThresholds &_thresholds)
+{
+  if (_thresholds.linearSpeed <= 0.0 || _thresholds.angularSpeed <= 0.0)
+  {
+    this->sleepThresholds.erase(_modelID.id);
+    return;
+  }
+
+  auto &timer = this->sleepThresholds[_modelID.id];
+  timer.thresholds = _thresholds;
+  timer.restTime = 0.0;
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::GetModelSleepThresholds(
+    const Identity &_modelID) const -> SleepThresholds
+{
+  const auto it = this->sleepThresholds.find(_modelID.id);
+  if (it == this->sleepThresholds.end())
+    return SleepThresholds();
+  return it->second.thresholds;
+}
+
+/////////////////////////////////////////////////
+/// \brief Whether the state of a sleeping skeleton was set, or forces or
+/// commands were given to it, since it was put to sleep.
+/// \param[in] _skel The skeleton.
+/// \param[in] _positions Positions of the skeleton when it was put to
+/// sleep.
+/// \return True if the skeleton has to be woken up.
+static bool SleepingSkeletonChanged(
+    const dart::dynamics::Skeleton &_skel, const Eigen::VectorXd &_positions)
+{
+  if (static_cast<std::size_t>(_positions.size()) != _skel.getNumDofs())
+    return true;
+
+  // Immobile skeletons keep their forces and commands, since DART only
+  // clears them for the skeletons that it integrates
+  for (std::size_t i = 0; i < _skel.getNumDofs(); ++i)
+  {
+    if (_skel.getPosition(i) != _positions[static_cast<Eigen::Index>(i)] ||
+        _skel.getVelocity(i) != 0.0 || _skel.getCommand(i) != 0.0 ||
+        _skel.getForce(i) != 0.0)
+    {
+      return true;
+    }
+  }
+
+  for (std::size_t i = 0; i < _skel.getNumBodyNodes(); ++i)
+  {
+    if (!_skel.getBodyNode(i)->getExternalForceLocal().isZero())
+      return true;
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::UpdateSleepingModels(
+    const std::unordered_set<std::size_t> &_worldIDs)
+{
+  auto &data = this->sleepIslandData;
+  data.ready.clear();
+  data.wake.clear();
+  data.merge.clear();
+
+  for (auto it = this->sleepThresholds.begin();
+       it != this->sleepThresholds.end();)
+  {
+    if (!this->models.HasEntity(it->first))
+    {
+      it = this->sleepThresholds.erase(it);
+      continue;
+    }
+
+    auto &timer = it->second;
+    const std::size_t modelID = it->first;
+    ++it;
+
+    const std::size_t worldID = this->GetWorldOfModelImpl(modelID);
+    const auto &skel = this->models.at(modelID)->model;
+    if (_worldIDs.count(worldID) == 0 || !skel->isMobile() ||
+        this->sleepEnabledModels.count(modelID) == 0)
+    {
+      continue;
+    }
+
+    bool atRest = true;
+    for (std::size_t i = 0; atRest && i < skel->getNumBodyNodes(); ++i)
+    {
+      const auto *bn = skel->getBodyNode(i);
+      atRest =
+          bn->getLinearVelocity().norm() < timer.thresholds.linearSpeed &&
+          bn->getAngularVelocity().norm() < timer.thresholds.angularSpeed;
+    }
+
+    if (!atRest)
+    {
+      timer.restTime = 0.0;
+      continue;
+    }
+
+    // The model goes to sleep with the models it touches, once they are all
+    // ready, see below
+    timer.restTime += this->NextStepSizeOf(worldID);
+    if (timer.restTime >= timer.thresholds.timeout)
+      data.ready.insert(modelID);
+  }
+
+  this->sleepingSkeletons.clear();
+  if (data.ready.empty() && this->sleepingModels.empty())
+    return;
+
+  // Setting the state of a sleeping model wakes up its island
+  for (auto it = this->sleepingModels.begin();
+       it != this->sleepingModels.end();)
+  {
+    if (!this->models.HasEntity(it->first))
+    {
+      it = this->sleepingModels.erase(it);
+      continue;
+    }
+
+    if (_worldIDs.count(this->GetWorldOfModelImpl(it->first)) > 0 &&
+        SleepingSkeletonChanged(
+            *this->models.at(it->first)->model, it->second.positions))
+    {
+      data.wake.insert(it->second.island);
+    }
+    ++it;
+  }
+
+  // A group of touching models stays awake if any of them is moving, or
+  // belongs to an island that is woken up. Otherwise its awake models go to
+  // sleep, and it becomes one island with the islands it touches.
+  this->BuildSleepIslands(_worldIDs);
+  const auto root = [&data](std::size_t _node)
+  {
+    while (data.parents[_node] != _node)
+      _node = data.parents[_node] = data.parents[data.parents[_node]];
+    return _node;
+  };
+
+  const std::size_t numNodes = data.parents.size();
+  data.rootStates.assign(numNodes, 0);
+  data.rootIslands.assign(numNodes, SleepIslandData::kNoModel);
+  for (std::size_t n = 0; n < numNodes; ++n)
+  {
+    const std::size_t modelID = data.models[n];
+    if (modelID == SleepIslandData::kNoModel)
+    {
+      if (data.wake.count(data.islands[n]) > 0)
+        data.rootStates[root(n)] |= SleepIslandData::kBlocked;
+    }
+    else if (this->sleepingModels.count(modelID) == 0)
+    {
+      data.rootStates[root(n)] |= data.ready.count(modelID) > 0 ?
+          SleepIslandData::kFallingAsleep : SleepIslandData::kBlocked;
+    }
+  }
+
+  for (std::size_t n = 0; n < numNodes; ++n)
+  {
+    const std::size_t r = root(n);
+    const std::size_t modelID = data.models[n];
+    if (data.rootStates[r] & SleepIslandData::kBlocked)
+    {
+      if (modelID == SleepIslandData::kNoModel)
+        data.wake.insert(data.islands[n]);
+      else
+        data.ready.erase(modelID);
+      continue;
+    }
+
+    // Groups of sleeping models that no awake model touches stay as they
+    // are
+    if (!(data.rootStates[r] & SleepIslandData::kFallingAsleep) ||
+        (modelID != SleepIslandData::kNoModel &&
+         this->sleepingModels.count(modelID) > 0))
+    {
+      continue;
+    }
+
+    if (data.rootIslands[r] == SleepIslandData::kNoModel)
+      data.rootIslands[r] = this->nextSleepIsland++;
+    if (modelID == SleepIslandData::kNoModel)
+    {
+      data.merge[data.islands[n]] = data.rootIslands[r];
+    }
+    else
+    {
+      this->PutModelToSleep(modelID, data.rootIslands[r]);
+      data.ready.erase(modelID);
+    }
+  }
+
+  // Models that touch no other model sleep on their own
+  for (const std::size_t modelID : data.ready)
+    this->PutModelToSleep(modelID, this->nextSleepIsland++);
+
+  for (auto it = this->sleepingModels.begin();
+       it != this->sleepingModels.end();)
+  {
+    const auto merged = data.merge.find(it->second.island);
+    if (merged != data.merge.end())
+      it->second.island = merged->second;
+
+    const auto &skel = this->models.at(it->first)->model;
+    if (data.wake.count(it->second.island) > 0)
+    {
+      skel->setMobile(true);
+      it = this->sleepingModels.erase(it);
+      continue;
+    }
+
+    if (_worldIDs.count(this->GetWorldOfModelImpl(it->first)) > 0)
+      this->sleepingSkeletons.insert(skel.get());
+    ++it;
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::BuildSleepIslands(
+    const std::unordered_set<std::size_t> &_worldIDs)
+{
+  auto &data = this->sleepIslandData;
+  data.modelNodes.clear();
+  data.islandNodes.clear();
+  data.parents.clear();
+  data.models.clear();
+  data.islands.clear();
+
+  const auto addNode = [&data](std::size_t _model, std::size_t _island)
+  {
+    data.parents.push_back(data.parents.size());
+    data.models.push_back(_model);
+    data.islands.push_back(_island);
+    return data.parents.back();
+  };
+  const auto root = [&data](std::size_t _node)
+  {
+    while (data.parents[_node] != _node)
+      _node = data.parents[_node] = data.parents[data.parents[_node]];
+    return _node;
+  };
+
+  // Node of a model, joined with the node of its island if it is sleeping.
+  // Static and kinematic models, and links that are not in a model, have
+  // none.
+  const auto modelNode = [&](const dart::collision::CollisionObject *_object)
+  {
+    const auto *shapeNode = _object->getShapeFrame()->asShapeNode();
+    if (!shapeNode)
+      return SleepIslandData::kNoModel;
+
+    const auto skel = shapeNode->getSkeleton();
+    const auto id = this->models.objectToID.find(skel);
+    if (id == this->models.objectToID.end())
+      return SleepIslandData::kNoModel;
+
+    const auto sleeping = this->sleepingModels.find(id->second);
+    if (sleeping == this->sleepingModels.end() && !skel->isMobile())
+      return SleepIslandData::kNoModel;
+
+    const auto [it, inserted] =
+        data.modelNodes.emplace(id->second, data.parents.size());
+    if (!inserted)
+      return it->second;
+    addNode(id->second, 0u);
+
+    if (sleeping != this->sleepingModels.end())
+    {
+      const std::size_t island = sleeping->second.island;
+      const auto [islandIt, islandInserted] =
+          data.islandNodes.emplace(island, data.parents.size());
+      if (islandInserted)
+        addNode(SleepIslandData::kNoModel, island);
+      data.parents[root(it->second)] = root(islandIt->second);
+    }
+    return it->second;
+  };
+
+  for (const std::size_t worldID : _worldIDs)
+  {
+    const auto *world = this->worlds.Find(worldID);
+    if (!world)
+      continue;
+
+    for (const auto &contact :
+         (*world)->getLastCollisionResult().getContacts())
+    {
+      const std::size_t node1 = modelNode(contact.collisionObject1);
+      const std::size_t node2 = modelNode(contact.collisionObject2);
+      if (node1 != SleepIslandData::kNoModel &&
+          node2 != SleepIslandData::kNoModel)
+      {
+        data.parents[root(node1)] = root(node2);
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelKinematic(
+    const Identity &_modelID, bool _kinematic)
+{
+  const auto &skel = this->ReferenceInterface<ModelInfo>(_modelID)->model;
+  auto it = this->kinematicModels.find(_modelID.id);
+  if (!_kinematic)
+  {
+    if (it == this->kinematicModels.end())
+      return;
+    skel->setMobile(it->second);
+    this->kinematicModels.erase(it);
+    return;
+  }
+
+  if (it != this->kinematicModels.end())
+    return;
+
+  // A kinematic model keeps moving, so it can not sleep
+  this->SetModelSleeping(_modelID, false);
+  this->kinematicModels[_modelID.id] = skel->isMobile();
+  skel->setMobile(false);
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelKinematic(
+    const Identity &_modelID) const
+{
+  return this->kinematicModels.count(_modelID.id) > 0;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::ApplyAddedMassGravity(
+    const std::unordered_set<std::size_t> &_worldIDs)
+{
+  // Only for the links of the worlds being stepped, so the force is not
+  // accumulated on links of other worlds.
+  for (const auto &entry : this->addedMassLinks)
+  {
+    if (!this->links.HasContainer(entry.id))
+      continue;
+
+    const std::size_t worldID =
+        this->GetWorldOfModelImpl(this->links.ContainerIDOf(entry.id));
+    if (_worldIDs.count(worldID) == 0)
+      continue;
+
+    // DART keeps the forces of immobile links, e.g. of sleeping models,
+    // from step to step, so they are not added again
+    if (!entry.info->link->getSkeleton()->isMobile())
+      continue;
+
+    const Eigen::Vector3d g = this->worlds.at(worldID)->getGravity();
+    entry.info->link->addExtForce(entry.mass * g, entry.com, false, true);
+  }
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::AddWorldForceField(
+    const Identity &_worldID, const ForceField &_field)
+{
+  auto &worldFields = this->forceFields[_worldID.id];
+  const std::size_t id = worldFields.nextID++;
+  worldFields.fields.emplace(id, _field);
+  return id;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::SetWorldForceField(
+    const Identity &_worldID,
+    std::size_t _fieldID,
+    const ForceField &_field)
+{
+  const auto worldIt = this->forceFields.find(_worldID.id);
+  if (worldIt == this->forceFields.end())
+    return false;
+
+  const auto fieldIt = worldIt->second.fields.find(_fieldID);
+  if (fieldIt == worldIt->second.fields.end())
+    return false;
+
+  fieldIt->second = _field;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::RemoveWorldForceField(
+    const Identity &_worldID, std::size_t _fieldID)
+{
+  const auto worldIt = this->forceFields.find(_worldID.id);
+  return worldIt != this->forceFields.end() &&
+      worldIt->second.fields.erase(_fieldID) > 0;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::ApplyForceFields(
+    const std::unordered_set<std::size_t> &_worldIDs)
+{
+  for (const std::size_t worldID : _worldIDs)
+  {
+    const auto worldIt = this->forceFields.find(worldID);
+    if (worldIt == this->forceFields.end())
+      continue;
+
+    const Eigen::Vector3d g = this->worlds.at(worldID)->getGravity();
+    Eigen::Vector3d force;
+    Eigen::Vector3d torque;
+    for (const auto &[fieldID, field] : worldIt->second.fields)
+    {
+      for (const ForceFieldLink &fieldLink : field.links)
+      {
+        // Only for the links of this world, so the force is not accumulated
+        // on links of other worlds.
+        if (!this->links.HasContainer(fieldLink.link) ||
+            this->GetWorldOfModelImpl(
+                this->links.ContainerIDOf(fieldLink.link)) != worldID)
+        {
+          continue;
+        }
+
+        // See ApplyAddedMassGravity
+        auto *bn = this->links.at(fieldLink.link)->link.get();
+        if (!bn->getSkeleton()->isMobile())
+          continue;
+
+        ComputeForceFieldWrench(field, fieldLink, g,
+            bn->getCOMLinearVelocity(), bn->getAngularVelocity(),
+            force, torque);
+        bn->addExtForce(force, bn->getLocalCOM(), false, true);
+        bn->addExtTorque(torque, false);
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::IsLinkWritten(const LinkInfo &_info) const
+{
+  return !this->filterWrittenLinks ||
+      (_info.link && this->writeSkeletons.count(
+          _info.link->getSkeleton().get()) > 0);
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::IsJointWritten(const JointInfo &_info) const
+{
+  return !this->filterWrittenLinks ||
+      (_info.joint && this->writeSkeletons.count(
+          _info.joint->getSkeleton().get()) > 0);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::IntegrateKinematicModels(
+    const std::unordered_set<std::size_t> &_worldIDs)
+{
+  for (auto it = this->kinematicModels.begin();
+       it != this->kinematicModels.end();)
+  {
+    if (!this->models.HasEntity(it->first))
+    {
+      it = this->kinematicModels.erase(it);
+      continue;
+    }
+
+    const std::size_t worldID = this->GetWorldOfModelImpl(it->first);
+    if (_worldIDs.count(worldID) > 0)
+    {
+      // The step of the world spans all of its substeps
+      this->models.at(it->first)->model->integratePositions(
+          this->NextStepSizeOf(worldID));
+    }
+    ++it;
+  }
+}
+
+std::vector<SimulationFeatures::ContactInternal>
+SimulationFeatures::GetContactsFromLastStep(const Identity &_worldID) const
+{
+  std::vector<SimulationFeatures::ContactInternal> outContacts;
+  auto *const world = this->ReferenceInterface<DartWorld>(_worldID);
+  const auto &colResult = world->getLastCollisionResult();
+  const ContactFilter *filter = this->FindContactFilter(_worldID);
+
+  for (const auto &dtContact : colResult.getContacts())
+  {
+    if (filter && !this->PassesContactFilter(*filter, dtContact))
+      continue;
+
+    auto contact = this->convertContact(dtContact);
+    if (contact)
+      outContacts.push_back(contact.value());
+  }
+
+  if (this->deterministic)
+    SortContacts(outContacts);
+  return outContacts;
+}
+
+SimulationFeatures::ContactBatch
+SimulationFeatures::GetContactBatchFromLastStep(const Identity &_worldID) const
+{
+  this->contactBatch.Clear();
+  auto *const world = this->ReferenceInterface<DartWorld>(_worldID);
+  const auto &colResult = world->getLastCollisionResult();
+  const ContactFilter *filter = this->FindContactFilter(_worldID);
+
+  for (const auto &dtContact : colResult.getContacts())
+  {
+    if (filter && !this->PassesContactFilter(*filter, dtContact))
+      continue;
+
+    std::size_t shape1ID;
+    std::size_t shape2ID;
+    if (this->FindContactShapes(dtContact, shape1ID, shape2ID))
+    {
+      this->contactBatch.Add(shape1ID, shape2ID, dtContact.point,
+        dtContact.normal, dtContact.penetrationDepth, dtContact.force);
+    }
+  }
+
+  if (this->deterministic)
+    this->contactBatch.Sort();
+  return this->contactBatch.View();
+}
+
+SimulationFeatures::ContactPairBatch
+SimulationFeatures::GetContactPairsFromLastStep(const Identity &_worldID) const
+{
+  // Deterministic steps sort the batch already
+  this->GetContactBatchFromLastStep(_worldID);
+  if (!this->deterministic)
+    this->contactBatch.Sort();
+  this->contactPairs.Build(this->contactBatch.View());
+  return this->contactPairs.View();
+}
+
+SimulationFeatures::ContactEventBatch
+SimulationFeatures::GetContactEvents(const Identity &_worldID) const
+{
+  auto *const world = this->ReferenceInterface<DartWorld>(_worldID);
+  const auto &colResult = world->getLastCollisionResult();
+  const ContactFilter *filter = this->FindContactFilter(_worldID);
+  ContactEventTracker &tracker = this->contactEvents[_worldID.id];
+
+  // The collision result of the last step holds the contacts of each pair
+  // of shapes that the collision detector kept, so only their shapes are
+  // looked up here.
+  for (const auto &dtContact : colResult.getContacts())
+  {
+    if (filter && !this->PassesContactFilter(*filter, dtContact))
+      continue;
+
+    std::size_t shape1ID;
+    std::size_t shape2ID;
+    if (this->FindContactShapes(dtContact, shape1ID, shape2ID))
+      tracker.AddContact(shape1ID, shape2ID);
+  }
+  tracker.Update();
+  return tracker.View();
+}
+
+bool SimulationFeatures::FindContactShapes(
+  const dart::collision::Contact& _contact,
+  std::size_t &_shape1ID, std::size_t &_shape2ID) const
+{
+  auto *dtShapeNode1 =
+    _contact.collisionObject1->getShapeFrame()->asShapeNode();
+  auto *dtShapeNode2 =
+    _contact.collisionObject2->getShapeFrame()->asShapeNode();
+
+  return this->FindShapeOfNode(dtShapeNode1, _shape1ID) &&
+      this->FindShapeOfNode(dtShapeNode2, _shape2ID);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldContactFilter(
+    const Identity &_worldID, const std::vector<std::size_t> &_entities)
+{
+  if (_entities.empty())
+  {
+    this->contactFilters.erase(_worldID.id);
+  }
+  else
+  {
+    this->contactFilters.insert_or_assign(
+        _worldID.id, ContactFilter(_entities));
+  }
+}
+
+/////////////////////////////////////////////////
+std::vector<std::size_t> SimulationFeatures::GetWorldContactFilter(
+    const Identity &_worldID) const
+{
+  const auto *filter = this->FindContactFilter(_worldID);
+  if (!filter)
+    return {};
+  return filter->Entities();
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::FindContactFilter(const Identity &_worldID) const
+    -> const ContactFilter *
+{
+  const auto it = this->contactFilters.find(_worldID.id);
+  return it == this->contactFilters.end() ? nullptr : &it->second;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::PassesContactFilter(
+  const ContactFilter &_filter, const dart::collision::Contact &_contact) const
+{
+  auto nodePasses = [this, &_filter](const DartShapeNode *_node)
+  {
+    if (!_node)
+      return false;
+
+    std::size_t shapeID;
+    if (this->FindShapeOfNode(_node, shapeID) && _filter.Contains(shapeID))
+      return true;
+
+    const DartBodyNode *bn = _node->getBodyNodePtr().get();
+    if (this->links.HasEntity(bn) &&
+        _filter.Contains(this->links.IdentityOf(bn)))
+    {
+      return true;
+    }
+
+    const auto skeleton = bn->getSkeleton();
+    return this->models.HasEntity(skeleton) &&
+        _filter.Contains(this->models.IdentityOf(skeleton));
+  };
+
+  return nodePasses(_contact.collisionObject1->getShapeFrame()->asShapeNode())
+      || nodePasses(_contact.collisionObject2->getShapeFrame()->asShapeNode());
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::FindShapeOfNode(
+  const DartShapeNode *_node, std::size_t &_id) const
+{
+  if (!_node)
+    return false;
+
+  if (this->shapes.HasEntity(_node))
+  {
+    _id = this->shapes.IdentityOf(_node);
+    return true;
+  }
+
+  // Contacts with a heightmap tile are reported for the heightmap
+  auto it = this->heightmapTiles.find(_node);
+  if (it == this->heightmapTiles.end() || !this->shapes.HasEntity(it->second))
+    return false;
+  _id = it->second;
+  return true;
+}
+
+/////////////////////////////////////////////////
+dart::collision::CollisionGroup *SimulationFeatures::UpdateRayGroup(
+  std::size_t _worldID, DartWorld &_world) const
+{
+  const auto &solver = _world.getConstraintSolver();
+  dart::collision::CollisionGroup *group = nullptr;
+  if (std::dynamic_pointer_cast<dart::collision::BulletCollisionDetector>(
+        solver->getCollisionDetector()))
+  {
+    group = solver->getCollisionGroup().get();
+    this->rayGroups.erase(_worldID);
+  }
+  else
+  {
+    RayGroup &rayGroup = this->rayGroups[_worldID];
+    if (!rayGroup.group)
+    {
+      rayGroup.detector = dart::collision::BulletCollisionDetector::create();
+      rayGroup.group = rayGroup.detector->createCollisionGroupAsSharedPtr();
+    }
+    group = rayGroup.group.get();
+
+    // Subscribing again is a no-op, and removed skeletons unsubscribe
+    // themselves.
+    for (std::size_t i = 0; i < _world.getNumSkeletons(); ++i)
+      group->subscribeTo(_world.getSkeleton(i));
+  }
+
+  if (!group)
+    return nullptr;
+
+  // Let dartsim refresh the bullet objects of the group from the shape
+  // frames, as it does before each of its own ray casts. This is not thread
+  // safe, so it is done once here and the rays are then cast against the
+  // bullet world directly.
+  dart::collision::RaycastOption option;
+  dart::collision::RaycastResult result;
+  group->getCollisionDetector()->raycast(group,
+      Eigen::Vector3d::Zero(), Eigen::Vector3d::UnitZ(), option, &result);
+  return group;
+}
+
+namespace
+{
+/// \brief Collects the collision objects of the dbvt leaves visited by a
+/// query.
+struct LeafCollector : btDbvt::ICollide
+{
+  std::vector<const btCollisionObject *> *objects;
+
+  void Process(const btDbvtNode *_leaf)
+  {
+    const auto *proxy = static_cast<const btBroadphaseProxy *>(_leaf->data);
+    this->objects->push_back(
+        static_cast<const btCollisionObject *>(proxy->m_clientObject));
+  }
+};
+}  // namespace
+
+/////////////////////////////////////////////////
+SimulationFeatures::RayIntersectionBatch SimulationFeatures::CastWorldRays(
+  const Identity &_worldID,
+  const LinearVector3d *_from,
+  const LinearVector3d *_to,
+  std::size_t _count,
+  std::size_t _numThreads) const
+{
+  GZ_PROFILE("SimulationFeatures::CastWorldRays");
+  this->rayHits.Reset(_count);
+  const auto &world = this->worlds.at(_worldID);
+  auto *group = static_cast<dart::collision::BulletCollisionGroup *>(
+      this->UpdateRayGroup(_worldID, *world));
+  if (!group || _count == 0u)
+    return this->rayHits.View();
+
+  const btCollisionWorld *collisionWorld = group->getBulletCollisionWorld();
+  const auto *broadphase = dynamic_cast<const btDbvtBroadphase *>(
+      collisionWorld->getBroadphase());
+
+  auto castRange = [&](std::size_t _begin, std::size_t _end)
+  {
+    std::vector<const btCollisionObject *> candidates;
+    LeafCollector collector;
+    collector.objects = &candidates;
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      const btVector3 from(_from[i].x(), _from[i].y(), _from[i].z());
+      const btVector3 to(_to[i].x(), _to[i].y(), _to[i].z());
+
+      // btCollisionWorld::rayTest shares the traversal stack of the
+      // broadphase, so walk its trees with the static btDbvt::rayTest,
+      // which keeps its stack on the calling thread.
+      candidates.clear();
+      if (broadphase)
+      {
+        btDbvt::rayTest(broadphase->m_sets[0].m_root, from, to, collector);
+        btDbvt::rayTest(broadphase->m_sets[1].m_root, from, to, collector);
+      }
+      else
+      {
+        const auto &objects = collisionWorld->getCollisionObjectArray();
+        for (int j = 0; j < objects.size(); ++j)
+          candidates.push_back(objects[j]);
+      }
+
+      const btTransform fromTf(btMatrix3x3::getIdentity(), from);
+      const btTransform toTf(btMatrix3x3::getIdentity(), to);
+      btScalar closestFraction = 1;
+      for (const btCollisionObject *object : candidates)
+      {
+        // dartsim keeps its collision object in the user pointer
+        const auto *dtObject = static_cast<const dart::collision::
+            BulletCollisionObject *>(object->getUserPointer());
+        std::size_t shapeID = 0u;
+        if (!dtObject || !this->FindShapeOfNode(
+              dtObject->getShapeFrame()->asShapeNode(), shapeID))
+        {
+          continue;
+        }
+
+        btCollisionWorld::ClosestRayResultCallback callback(from, to);
+        callback.m_closestHitFraction = closestFraction;
+        btCollisionWorld::rayTestSingle(fromTf, toTf,
+            const_cast<btCollisionObject *>(object),
+            object->getCollisionShape(), object->getWorldTransform(),
+            callback);
+        if (!callback.hasHit() ||
+            callback.m_closestHitFraction >= closestFraction)
+        {
+          continue;
+        }
+
+        closestFraction = callback.m_closestHitFraction;
+        const btVector3 normal = callback.m_hitNormalWorld.normalized();
+        this->rayHits.Set(i, closestFraction * (_to[i] - _from[i]).norm(),
+            Eigen::Vector3d(normal.x(), normal.y(), normal.z()), shapeID);
+      }
+    }
+  };
+
+  this->RunQueries(_count, _numThreads, castRange);
+  return this->rayHits.View();
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::RayIntersectionBatch SimulationFeatures::CastWorldShapes(
+  const Identity &_worldID,
+  const QueryVolume *_volumes,
+  const LinearVector3d *_to,
+  std::size_t _count,
+  std::size_t _numThreads) const
+{
+  GZ_PROFILE("SimulationFeatures::CastWorldShapes");
+  this->rayHits.Reset(_count);
+  const auto &world = this->worlds.at(_worldID);
+  auto *group = static_cast<dart::collision::BulletCollisionGroup *>(
+      this->UpdateRayGroup(_worldID, *world));
+  if (!group || _count == 0u)
+    return this->rayHits.View();
+
+  // dartsim cannot sweep shapes, so they are swept through the bullet world
+  // of the ray group like the rays of CastWorldRays.
+  const btCollisionWorld *collisionWorld = group->getBulletCollisionWorld();
+  const auto *broadphase = dynamic_cast<const btDbvtBroadphase *>(
+      collisionWorld->getBroadphase());
+
+  auto castRange = [&](std::size_t _begin, std::size_t _end)
+  {
+    std::vector<const btCollisionObject *> candidates;
+    LeafCollector collector;
+    collector.objects = &candidates;
+    for (std::size_t i = _begin; i < _end; ++i)
+    {
+      const QueryVolume &volume = _volumes[i];
+      std::unique_ptr<btConvexShape> shape;
+      if (volume.type == QueryVolume::Type::BOX)
+      {
+        const Eigen::Vector3d half = 0.5 * volume.size;
+        shape = std::make_unique<btBoxShape>(
+            btVector3(half.x(), half.y(), half.z()));
+      }
+      else
+      {
+        shape = std::make_unique<btSphereShape>(
+            static_cast<btScalar>(volume.radius));
+      }
+      const Eigen::Quaterniond rot(volume.pose.linear());
+      const Eigen::Vector3d &start = volume.pose.translation();
+      const btQuaternion btRot(rot.x(), rot.y(), rot.z(), rot.w());
+      const btTransform fromTf(btRot, btVector3(start.x(), start.y(),
+          start.z()));
+      const btTransform toTf(btRot, btVector3(_to[i].x(), _to[i].y(),
+          _to[i].z()));
+
+      // Candidates are the objects near any part of the sweep
+      btVector3 sweepMin, sweepMax, endMin, endMax;
+      shape->getAabb(fromTf, sweepMin, sweepMax);
+      shape->getAabb(toTf, endMin, endMax);
+      sweepMin.setMin(endMin);
+      sweepMax.setMax(endMax);
+      candidates.clear();
+      if (broadphase)
+      {
+        const btDbvtVolume bounds = btDbvtVolume::FromMM(sweepMin, sweepMax);
+        for (const btDbvt &tree : broadphase->m_sets)
+          tree.collideTV(tree.m_root, bounds, collector);
+      }
+      else
+      {
+        const auto &objects = collisionWorld->getCollisionObjectArray();
+        for (int j = 0; j < objects.size(); ++j)
+          candidates.push_back(objects[j]);
+      }
+
+      btScalar closestFraction = 1;
+      for (const btCollisionObject *object : candidates)
+      {
+        const auto *dtObject = static_cast<const dart::collision::
+            BulletCollisionObject *>(object->getUserPointer());
+        std::size_t shapeID = 0u;
+        if (!dtObject || !this->FindShapeOfNode(
+              dtObject->getShapeFrame()->asShapeNode(), shapeID))
+        {
+          continue;
+        }
+
+        btCollisionWorld::ClosestConvexResultCallback callback(
+            fromTf.getOrigin(), toTf.getOrigin());
+        callback.m_closestHitFraction = closestFraction;
+        btCollisionWorld::objectQuerySingle(shape.get(), fromTf, toTf,
+            const_cast<btCollisionObject *>(object),
+            object->getCollisionShape(), object->getWorldTransform(),
+            callback, btScalar(0));
+        if (!callback.hasHit() ||
+            callback.m_closestHitFraction >= closestFraction)
+        {
+          continue;
+        }
+
+        closestFraction = callback.m_closestHitFraction;
+        const btVector3 normal = callback.m_hitNormalWorld.normalized();
+        this->rayHits.Set(i, closestFraction * (_to[i] - start).norm(),
+            Eigen::Vector3d(normal.x(), normal.y(), normal.z()), shapeID);
+      }
+    }
+  };
+
+  this->RunQueries(_count, _numThreads, castRange);
+  return this->rayHits.View();
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::OverlapBatch SimulationFeatures::FindWorldOverlaps(
+  const Identity &_worldID,
+  const QueryVolume *_volumes,
+  std::size_t _count,
+  std::size_t /*_numThreads*/) const
+{
+  GZ_PROFILE("SimulationFeatures::FindWorldOverlaps");
+  const auto &world = this->worlds.at(_worldID);
+  const auto &solver = world->getConstraintSolver();
+  const auto &detector = solver->getCollisionDetector();
+  auto *worldGroup = solver->getCollisionGroup().get();
+  this->volumeOverlaps.resize(_count);
+
+  // Collide each volume with the collision group of the world, using the
+  // collision detector of the world. dartsim refreshes the group on every
+  // call, which is not thread safe, so the volumes are tested in turn.
+  dart::collision::CollisionOption option;
+  option.maxNumContacts = 10000u;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    std::vector<std::size_t> &result = this->volumeOverlaps[i];
+    result.clear();
+
+    const QueryVolume &volume = _volumes[i];
+    auto frame = dart::dynamics::SimpleFrame::createShared(
+        dart::dynamics::Frame::World());
+    if (volume.type == QueryVolume::Type::BOX)
+      frame->setShape(std::make_shared<dart::dynamics::BoxShape>(volume.size));
+    else
+      frame->setShape(
+          std::make_shared<dart::dynamics::SphereShape>(volume.radius));
+    frame->setTransform(volume.pose);
 
-#include "SimulationFeatures.hh"
+    auto queryGroup = detector->createCollisionGroup(frame.get());
+    dart::collision::CollisionResult collision;
+    if (!worldGroup->collide(queryGroup.get(), option, &collision))
+      continue;
 
-#if DART_VERSION_AT_LEAST(6, 13, 0)
-// The ContactSurfaceParams class was first added to version 6.10 of our fork
-// of dart, and then merged upstream and released in version 6.13.0 with
-// different public member variable names.
-// See https://github.com/dartsim/dart/pull/1626 and
-// https://github.com/gazebo-forks/dart/pull/22 for more info.
-#define DART_HAS_UPSTREAM_FRICTION_VARIABLE_NAMES
-// There's a sign difference between our fork and upstream dart in the
-// implementation of surface velocities. Here, we assume that 6.13 is the
-// upstream version. There's a potential that a user might update our fork to
-// version 6.13.0 or later. To support that case, we'll assume
-// DART_HAS_POSITIVE_CONTACT_SURFACE_MOTION_VELOCITY will be defined in the
-// fork. Note, if we simply check for
-// `DART_HAS_POSITIVE_CONTACT_SURFACE_MOTION_VELOCITY ` without the 6.13
-// condition above, we might break users that are building with our 6.10 fork
-// without updating or adding the
-// DART_HAS_POSITIVE_CONTACT_SURFACE_MOTION_VELOCITY define in their version of
-// dart.
-#ifndef DART_HAS_POSITIVE_CONTACT_SURFACE_MOTION_VELOCITY
-  #define DART_HAS_NEGATIVE_CONTACT_SURFACE_MOTION_VELOCITY
-#endif
-#endif
+    for (const auto &contact : collision.getContacts())
+    {
+      const auto *object = contact.collisionObject1->getShapeFrame() ==
+          frame.get() ? contact.collisionObject2 : contact.collisionObject1;
+      std::size_t shapeID = 0u;
+      if (this->FindShapeOfNode(
+            object->getShapeFrame()->asShapeNode(), shapeID))
+      {
+        result.push_back(shapeID);
+      }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+  }
 
-namespace gz {
-namespace physics {
-namespace dartsim {
+  this->overlaps.Assign(this->volumeOverlaps);
+  return this->overlaps.View();
+}
 
-void SimulationFeatures::WorldForwardStep(
-    const Identity &_worldID,
-    ForwardStep::Output & _h,
-    ForwardStep::State & /*_x*/,
-    const ForwardStep::Input & _u)
+/////////////////////////////////////////////////
+void SimulationFeatures::ComputeWorldShapeDistances(
+  const Identity &_worldID,
+  const ShapePair *_pairs,
+  std::size_t _count,
+  double _cutoff,
+  ShapeDistance *_results) const
 {
-  GZ_PROFILE("SimulationFeatures::WorldForwardStep");
-  auto *world = this->ReferenceInterface<DartWorld>(_worldID);
-  auto *dtDur =
-      _u.Query<std::chrono::steady_clock::duration>();
-  const double tol = 1e-6;
+  GZ_PROFILE("SimulationFeatures::ComputeWorldShapeDistances");
+  this->UpdateDistanceGroups(_worldID);
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    ShapeDistance &result = _results[i];
+    result = ShapeDistance();
+    result.shape1 = _pairs[i].first;
+    result.shape2 = _pairs[i].second;
+    result.valid = this->ComputeShapeDistance(
+        _worldID, result.shape1, result.shape2, _cutoff, result);
+  }
+}
 
-  if (dtDur)
+/////////////////////////////////////////////////
+auto SimulationFeatures::ComputeWorldLinkDistances(
+  const Identity &_worldID,
+  const std::vector<std::size_t> &_links,
+  double _cutoff) const -> std::vector<ShapeDistance>
+{
+  GZ_PROFILE("SimulationFeatures::ComputeWorldLinkDistances");
+  this->UpdateDistanceGroups(_worldID);
+  const auto &world = this->worlds.at(_worldID);
+
+  // The shapes of a merged link are the shapes of the body node it was
+  // merged into, see ShapeFeatures::LinkWorldBoundingBox
+  std::unordered_set<const DartBodyNode *> bodies;
+  for (const std::size_t linkID : _links)
   {
-    std::chrono::duration<double> dt = *dtDur;
-    if (std::fabs(dt.count() - world->getTimeStep()) > tol)
+    const auto *linkInfo = this->links.Find(linkID);
+    if (linkInfo && *linkInfo && (*linkInfo)->link)
+      bodies.insert((*linkInfo)->link.get());
+  }
+
+  std::vector<std::size_t> linkShapes;
+  std::vector<std::size_t> otherShapes;
+  for (std::size_t i = 0; i < world->getNumSkeletons(); ++i)
+  {
+    const auto skeleton = world->getSkeleton(i);
+    for (std::size_t b = 0; b < skeleton->getNumBodyNodes(); ++b)
     {
-      world->setTimeStep(dt.count());
-      gzdbg << "Simulation timestep set to: " << world->getTimeStep()
-             << std::endl;
+      const DartBodyNode *bn = skeleton->getBodyNode(b);
+      const bool inSet = bodies.count(bn) > 0u;
+      for (std::size_t n = 0; n < bn->getNumShapeNodes(); ++n)
+      {
+        const DartShapeNode *node = bn->getShapeNode(n);
+        if (!this->shapes.HasEntity(node))
+          continue;
+        (inSet ? linkShapes : otherShapes).push_back(
+            this->shapes.IdentityOf(node));
+      }
     }
   }
 
-  for (const auto &[id, info] : this->links.idToObject)
+  std::vector<ShapeDistance> results;
+  std::sort(linkShapes.begin(), linkShapes.end());
+  std::sort(otherShapes.begin(), otherShapes.end());
+  for (const std::size_t shape1 : linkShapes)
   {
-    if (info && info->inertial->FluidAddedMass().has_value())
+    for (const std::size_t shape2 : otherShapes)
     {
-      auto com = Eigen::Vector3d(info->inertial->Pose().Pos().X(),
-                                 info->inertial->Pose().Pos().Y(),
-                                 info->inertial->Pose().Pos().Z());
-
-      auto mass = info->inertial->MassMatrix().Mass();
-      auto g = world->getGravity();
-
-      info->link->addExtForce(mass * g, com, false, true);
+      ShapeDistance result;
+      if (!this->ComputeShapeDistance(
+            _worldID, shape1, shape2, _cutoff, result))
+      {
+        continue;
+      }
+      result.valid = true;
+      result.shape1 = shape1;
+      result.shape2 = shape2;
+      results.push_back(result);
     }
   }
-
-  // TODO(MXG): Parse input
-  world->step();
-  this->WriteRequiredData(_h);
-  this->Write(_h.Get<ChangedWorldPoses>());
-  // TODO(MXG): Fill in state
+  return results;
 }
 
-void SimulationFeatures::Write(WorldPoses &_worldPoses) const
+/////////////////////////////////////////////////
+void SimulationFeatures::UpdateDistanceGroups(std::size_t _worldID) const
 {
-  // remove link poses from the previous iteration
-  _worldPoses.entries.clear();
-  _worldPoses.entries.reserve(this->links.size());
+  DistanceGroups &distance = this->distanceGroups[_worldID];
+  if (!distance.detector)
+    distance.detector = dart::collision::FCLCollisionDetector::create();
 
-  for (const auto &[id, info] : this->links.idToObject)
+  // Drop the groups of removed shapes
+  for (auto it = distance.groups.begin(); it != distance.groups.end();)
   {
-    WorldPose wp;
-    wp.pose = gz::math::eigen3::convert(
-        info->link->getWorldTransform());
-    wp.body = id;
-    _worldPoses.entries.push_back(wp);
+    if (this->shapes.HasEntity(it->first))
+      ++it;
+    else
+      it = distance.groups.erase(it);
   }
 }
 
-void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
+/////////////////////////////////////////////////
+bool SimulationFeatures::ComputeShapeDistance(
+  std::size_t _worldID,
+  std::size_t _shape1ID,
+  std::size_t _shape2ID,
+  double _cutoff,
+  ShapeDistance &_result) const
 {
-  // remove link poses from the previous iteration
-  _changedPoses.entries.clear();
-  _changedPoses.entries.reserve(this->links.size());
+  const auto &world = this->worlds.at(_worldID);
+  DistanceGroups &distance = this->distanceGroups[_worldID];
 
-  std::unordered_map<std::size_t, math::Pose3d> newPoses;
-
-  for (const auto &[id, info] : this->links.idToObject)
+  // Get the group of a shape of this world, or nullptr if its distance
+  // cannot be computed. FCL does not support dart heightmaps.
+  auto groupOf = [&](std::size_t _shapeID, const DartShapeNode *&_node)
+      -> dart::collision::CollisionGroup *
   {
-    // make sure the link exists
-    if (info && info->link)
+    const auto *info = this->shapes.Find(_shapeID);
+    if (!info || !*info || !(*info)->node || (*info)->tiledHeightmap)
+      return nullptr;
+
+    _node = (*info)->node.get();
+    const auto *shape = _node->getShape().get();
+    if (!world->hasSkeleton(_node->getSkeleton()) ||
+        dynamic_cast<const dart::dynamics::HeightmapShapef *>(shape) ||
+        dynamic_cast<const dart::dynamics::HeightmapShaped *>(shape))
     {
-      WorldPose wp;
-      wp.pose = gz::math::eigen3::convert(
-          info->link->getWorldTransform());
-      wp.body = id;
+      return nullptr;
+    }
 
-      // If the link's pose is new or has changed, save this new pose and
-      // add it to the output poses. Otherwise, keep the existing link pose
-      auto iter = this->prevLinkPoses.find(id);
-      if ((iter == this->prevLinkPoses.end()) ||
-          !iter->second.Pos().Equal(wp.pose.Pos(), 1e-6) ||
-          !iter->second.Rot().Equal(wp.pose.Rot(), 1e-6))
-      {
-        _changedPoses.entries.push_back(wp);
-        newPoses[id] = wp.pose;
-      }
-      else
-        newPoses[id] = iter->second;
+    auto &entry = distance.groups[_shapeID];
+    if (entry.first != _node || !entry.second)
+    {
+      entry.first = _node;
+      entry.second = distance.detector->createCollisionGroupAsSharedPtr(
+          _node);
+    }
+    return entry.second.get();
+  };
+
+  const DartShapeNode *node1 = nullptr;
+  const DartShapeNode *node2 = nullptr;
+  auto *group1 = groupOf(_shape1ID, node1);
+  auto *group2 = groupOf(_shape2ID, node2);
+  if (!group1 || !group2)
+    return false;
+
+  // dart keeps the bounding box of each shape until the shape changes.
+  // Planes are unbounded.
+  auto worldBox = [](const DartShapeNode *_node)
+  {
+    if (dynamic_cast<const dart::dynamics::PlaneShape *>(
+          _node->getShape().get()))
+    {
+      const double inf = std::numeric_limits<double>::infinity();
+      return AlignedBox3d(Eigen::Vector3d::Constant(-inf),
+                          Eigen::Vector3d::Constant(inf));
     }
+    const dart::math::BoundingBox &box = _node->getShape()->getBoundingBox();
+    return detail::TransformAlignedBox(_node->getWorldTransform(),
+        AlignedBox3d(box.getMin(), box.getMax()));
+  };
+  const AlignedBox3d box1 = worldBox(node1);
+  const AlignedBox3d box2 = worldBox(node2);
+  const Eigen::Vector3d gap = (box2.min() - box1.max()).cwiseMax(
+      box1.min() - box2.max()).cwiseMax(0.0);
+  if (gap.allFinite() && gap.norm() > _cutoff)
+    return false;
+
+  // Let FCL report penetrations as negative distances
+  dart::collision::DistanceOption option(
+      true, -std::numeric_limits<double>::max(), nullptr);
+  dart::collision::DistanceResult result;
+  group1->distance(group2, option, &result);
+  if (!result.found() || result.minDistance > _cutoff)
+    return false;
+
+  Eigen::Vector3d point1 = result.nearestPoint1;
+  Eigen::Vector3d point2 = result.nearestPoint2;
+  if (result.shapeFrame1 != node1)
+    std::swap(point1, point2);
+
+  _result.distance = result.minDistance;
+  _result.point1 = point1;
+  _result.point2 = point2;
+
+  // The closest points of penetrating shapes are the deepest points of
+  // each shape inside the other, so their direction is reversed.
+  const Eigen::Vector3d direction = result.minDistance < 0.0 ?
+      Eigen::Vector3d(point1 - point2) : Eigen::Vector3d(point2 - point1);
+  _result.normal = direction.norm() > 0.0 ?
+      Eigen::Vector3d(direction.normalized()) : Eigen::Vector3d::Zero();
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::RunQueries(
+  std::size_t _count, std::size_t _numThreads,
+  const std::function<void(std::size_t, std::size_t)> &_query) const
+{
+  if (_numThreads == 0u)
+    _numThreads = std::max(1u, std::thread::hardware_concurrency());
+  if (_numThreads <= 1u || _count < 2u)
+  {
+    _query(0u, _count);
+    return;
   }
 
-  // Save the new poses so that they can be used to check for updates in the
-  // next iteration. Re-setting this->prevLinkPoses with the contents of
-  // newPoses ensures that we aren't caching data for links that were removed
-  this->prevLinkPoses = std::move(newPoses);
+  // Queries only read the collision world and write their own result.
+  const auto tasks = RayChunkTasks(_count, _numThreads, _query);
+  this->RunTasks(this->rayPool, this->rayPoolThreads, _numThreads,
+      tasks.size(), [&tasks](std::size_t _i) { tasks[_i](); });
 }
 
-std::vector<SimulationFeatures::ContactInternal>
-SimulationFeatures::GetContactsFromLastStep(const Identity &_worldID) const
+/////////////////////////////////////////////////
+void SimulationFeatures::UpdateTaskScheduler(DartWorld *_world) const
 {
-  std::vector<SimulationFeatures::ContactInternal> outContacts;
-  auto *const world = this->ReferenceInterface<DartWorld>(_worldID);
-  const auto colResult = world->getLastCollisionResult();
+  auto *solver = _world->getConstraintSolver();
+  if (auto *island =
+          dynamic_cast<dart::constraint::GzIslandConstraintSolver *>(solver))
+  {
+    island->SetTaskScheduler(this->taskScheduler);
+  }
 
-  for (const auto &dtContact : colResult.getContacts())
+  if (auto *detector =
+          dynamic_cast<dart::collision::GzThreadedOdeCollisionDetector *>(
+              solver->getCollisionDetector().get()))
   {
-    auto contact = this->convertContact(dtContact);
-    if (contact)
-      outContacts.push_back(contact.value());
+    detector->SetTaskScheduler(this->taskScheduler);
   }
+}
 
-  return outContacts;
+/////////////////////////////////////////////////
+void SimulationFeatures::UpdateHeightmapTiles(const DartWorld *_world)
+{
+  std::vector<DartShapeNode *> added;
+  std::vector<const DartShapeNode *> removed;
+  const auto &shapeIDs = this->shapes.Ids();
+  const auto &shapeInfos = this->shapes.Objects();
+  for (std::size_t i = 0; i < shapeInfos.size(); ++i)
+  {
+    const auto &info = shapeInfos[i];
+    if (!info || !info->tiledHeightmap ||
+        !_world->hasSkeleton(info->node->getSkeleton()))
+    {
+      continue;
+    }
+
+    added.clear();
+    removed.clear();
+    info->tiledHeightmap->Update(*_world, added, removed);
+    for (const auto *node : removed)
+      this->heightmapTiles.erase(node);
+    for (const auto *node : added)
+      this->heightmapTiles[node] = shapeIDs[i];
+  }
 }
 
 std::optional<SimulationFeatures::ContactInternal>
 SimulationFeatures::convertContact(
   const dart::collision::Contact& _contact) const
 {
-  auto *dtCollObj1 = _contact.collisionObject1;
-  auto *dtCollObj2 = _contact.collisionObject2;
-
-  auto *dtShapeFrame1 = dtCollObj1->getShapeFrame();
-  auto *dtShapeFrame2 = dtCollObj2->getShapeFrame();
-
-  if (this->shapes.HasEntity(dtShapeFrame1->asShapeNode()) &&
-      this->shapes.HasEntity(dtShapeFrame2->asShapeNode()))
+  std::size_t shape1ID;
+  std::size_t shape2ID;
+  if (this->FindContactShapes(_contact, shape1ID, shape2ID))
   {
-    std::size_t shape1ID =
-      this->shapes.IdentityOf(dtShapeFrame1->asShapeNode());
-    std::size_t shape2ID =
-      this->shapes.IdentityOf(dtShapeFrame2->asShapeNode());
-
     CompositeData extraData;
+    extraData.SetQueryTracking(false);
 
     // Add normal, depth and wrench to extraData.
     auto& extraContactData =
@@ -257,107 +3025,148 @@ bool SimulationFeatures::RemoveContactPropertiesCallback(
   }
 }
 
-dart::constraint::ContactSurfaceParams GzContactSurfaceHandler::createParams(
-  const dart::collision::Contact& _contact,
-  const size_t _numContactsOnCollisionObject) const
+namespace
 {
-  auto pDart = ContactSurfaceHandler::createParams(
-    _contact, _numContactsOnCollisionObject);
+using GzContactSurfaceParams =
+  SetContactPropertiesCallbackFeature::ContactSurfaceParams<FeaturePolicy3d>;
 
-  if (!this->surfaceParamsCallback)
-    return pDart;
-
-  typedef SetContactPropertiesCallbackFeature F;
-  typedef FeaturePolicy3d P;
-  typename F::ContactSurfaceParams<P> pGz;
-
-  auto convertMotionVelocity = [](Eigen::Vector3d _input) {
+/////////////////////////////////////////////////
+Eigen::Vector3d ConvertMotionVelocity(Eigen::Vector3d _input)
+{
 #ifdef DART_HAS_NEGATIVE_CONTACT_SURFACE_MOTION_VELOCITY
-    // The y and z components correspond to the velocities in the first and
-    // second friction directions. These have to be inverted in the upstream
-    // version of DART. https://github.com/gazebo-forks/dart/pull/33
-    _input.y() = -_input.y();
-    _input.z() = -_input.z();
+  // The y and z components correspond to the velocities in the first and
+  // second friction directions. These have to be inverted in the upstream
+  // version of DART. https://github.com/gazebo-forks/dart/pull/33
+  _input.y() = -_input.y();
+  _input.z() = -_input.z();
 #endif
-    return _input;
-  };
+  return _input;
+}
 
+/////////////////////////////////////////////////
+/// \brief Fill the parameters passed to a callback from those of dart
+void FillGzParams(const dart::constraint::ContactSurfaceParams &_pDart,
+                  GzContactSurfaceParams &_pGz)
+{
 #ifdef DART_HAS_UPSTREAM_FRICTION_VARIABLE_NAMES
-  pGz.frictionCoeff = pDart.mPrimaryFrictionCoeff;
+  _pGz.frictionCoeff = _pDart.mPrimaryFrictionCoeff;
 #else
-  pGz.frictionCoeff = pDart.mFrictionCoeff;
+  _pGz.frictionCoeff = _pDart.mFrictionCoeff;
 #endif
-  pGz.secondaryFrictionCoeff = pDart.mSecondaryFrictionCoeff;
+  _pGz.secondaryFrictionCoeff = _pDart.mSecondaryFrictionCoeff;
 #ifdef DART_HAS_UPSTREAM_FRICTION_VARIABLE_NAMES
-  pGz.slipCompliance = pDart.mPrimarySlipCompliance;
+  _pGz.slipCompliance = _pDart.mPrimarySlipCompliance;
 #else
-  pGz.slipCompliance = pDart.mSlipCompliance;
+  _pGz.slipCompliance = _pDart.mSlipCompliance;
 #endif
-  pGz.secondarySlipCompliance = pDart.mSecondarySlipCompliance;
-  pGz.restitutionCoeff = pDart.mRestitutionCoeff;
-  pGz.firstFrictionalDirection = pDart.mFirstFrictionalDirection;
-  pGz.contactSurfaceMotionVelocity =
-      convertMotionVelocity(pDart.mContactSurfaceMotionVelocity);
+  _pGz.secondarySlipCompliance = _pDart.mSecondarySlipCompliance;
+  _pGz.restitutionCoeff = _pDart.mRestitutionCoeff;
+  _pGz.firstFrictionalDirection = _pDart.mFirstFrictionalDirection;
+  _pGz.contactSurfaceMotionVelocity =
+      ConvertMotionVelocity(_pDart.mContactSurfaceMotionVelocity);
+}
 
-  auto contactInternal = this->convertContact(_contact);
-  if (contactInternal)
+/////////////////////////////////////////////////
+/// \brief Copy the parameters set by a callback to those of dart
+void ApplyGzParams(const GzContactSurfaceParams &_pGz,
+                   dart::constraint::ContactSurfaceParams &_pDart)
+{
+  if (_pGz.frictionCoeff)
   {
-    this->surfaceParamsCallback(contactInternal.value(),
-                                _numContactsOnCollisionObject, pGz);
-
-    if (pGz.frictionCoeff)
-    {
 #ifdef DART_HAS_UPSTREAM_FRICTION_VARIABLE_NAMES
-      pDart.mPrimaryFrictionCoeff = pGz.frictionCoeff.value();
+    _pDart.mPrimaryFrictionCoeff = _pGz.frictionCoeff.value();
 #else
-      pDart.mFrictionCoeff = pGz.frictionCoeff.value();
+    _pDart.mFrictionCoeff = _pGz.frictionCoeff.value();
 #endif
-    }
-    if (pGz.secondaryFrictionCoeff)
-      pDart.mSecondaryFrictionCoeff = pGz.secondaryFrictionCoeff.value();
-    if (pGz.slipCompliance)
-    {
+  }
+  if (_pGz.secondaryFrictionCoeff)
+    _pDart.mSecondaryFrictionCoeff = _pGz.secondaryFrictionCoeff.value();
+  if (_pGz.slipCompliance)
+  {
 #ifdef DART_HAS_UPSTREAM_FRICTION_VARIABLE_NAMES
-      pDart.mPrimarySlipCompliance = pGz.slipCompliance.value();
+    _pDart.mPrimarySlipCompliance = _pGz.slipCompliance.value();
 #else
-      pDart.mSlipCompliance = pGz.slipCompliance.value();
+    _pDart.mSlipCompliance = _pGz.slipCompliance.value();
 #endif
-    }
-    if (pGz.secondarySlipCompliance)
-      pDart.mSecondarySlipCompliance = pGz.secondarySlipCompliance.value();
-    if (pGz.restitutionCoeff)
-      pDart.mRestitutionCoeff = pGz.restitutionCoeff.value();
-    if (pGz.firstFrictionalDirection)
-      pDart.mFirstFrictionalDirection = pGz.firstFrictionalDirection.value();
-    if (pGz.contactSurfaceMotionVelocity)
-    {
-      pDart.mContactSurfaceMotionVelocity =
-          convertMotionVelocity(pGz.contactSurfaceMotionVelocity.value());
-    }
+  }
+  if (_pGz.secondarySlipCompliance)
+    _pDart.mSecondarySlipCompliance = _pGz.secondarySlipCompliance.value();
+  if (_pGz.restitutionCoeff)
+    _pDart.mRestitutionCoeff = _pGz.restitutionCoeff.value();
+  if (_pGz.firstFrictionalDirection)
+    _pDart.mFirstFrictionalDirection = _pGz.firstFrictionalDirection.value();
+  if (_pGz.contactSurfaceMotionVelocity)
+  {
+    _pDart.mContactSurfaceMotionVelocity =
+        ConvertMotionVelocity(_pGz.contactSurfaceMotionVelocity.value());
+  }
 
-    static bool warnedRollingFrictionCoeff = false;
-    if (!warnedRollingFrictionCoeff && pGz.rollingFrictionCoeff)
-    {
-      gzwarn << "DART doesn't support rolling friction setting" << std::endl;
-      warnedRollingFrictionCoeff = true;
-    }
+  static bool warnedRollingFrictionCoeff = false;
+  if (!warnedRollingFrictionCoeff && _pGz.rollingFrictionCoeff)
+  {
+    gzwarn << "DART doesn't support rolling friction setting" << std::endl;
+    warnedRollingFrictionCoeff = true;
+  }
 
-    static bool warnedSecondaryRollingFrictionCoeff = false;
-    if (!warnedSecondaryRollingFrictionCoeff &&
-      pGz.secondaryRollingFrictionCoeff)
-    {
-      gzwarn << "DART doesn't support secondary rolling friction setting"
-              << std::endl;
-      warnedSecondaryRollingFrictionCoeff = true;
-    }
+  static bool warnedSecondaryRollingFrictionCoeff = false;
+  if (!warnedSecondaryRollingFrictionCoeff &&
+    _pGz.secondaryRollingFrictionCoeff)
+  {
+    gzwarn << "DART doesn't support secondary rolling friction setting"
+            << std::endl;
+    warnedSecondaryRollingFrictionCoeff = true;
+  }
 
-    static bool warnedTorsionalFrictionCoeff = false;
-    if (!warnedTorsionalFrictionCoeff && pGz.torsionalFrictionCoeff)
-    {
-      gzwarn << "DART doesn't support torsional friction setting"
-              << std::endl;
-      warnedTorsionalFrictionCoeff = true;
-    }
+  static bool warnedTorsionalFrictionCoeff = false;
+  if (!warnedTorsionalFrictionCoeff && _pGz.torsionalFrictionCoeff)
+  {
+    gzwarn << "DART doesn't support torsional friction setting"
+            << std::endl;
+    warnedTorsionalFrictionCoeff = true;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy the constraint parameters set by a callback to a constraint
+void ApplyGzConstraintParams(const GzContactSurfaceParams &_p,
+                             dart::constraint::ContactConstraint &_constraint)
+{
+  if (_p.errorReductionParameter)
+    _constraint.setErrorReductionParameter(_p.errorReductionParameter.value());
+
+  if (_p.maxErrorAllowance)
+    _constraint.setErrorAllowance(_p.maxErrorAllowance.value());
+
+  if (_p.maxErrorReductionVelocity)
+  {
+    _constraint.setMaxErrorReductionVelocity(
+      _p.maxErrorReductionVelocity.value());
+  }
+
+  if (_p.constraintForceMixing)
+    _constraint.setConstraintForceMixing(_p.constraintForceMixing.value());
+}
+}
+
+dart::constraint::ContactSurfaceParams GzContactSurfaceHandler::createParams(
+  const dart::collision::Contact& _contact,
+  const size_t _numContactsOnCollisionObject) const
+{
+  auto pDart = ContactSurfaceHandler::createParams(
+    _contact, _numContactsOnCollisionObject);
+
+  if (!this->surfaceParamsCallback)
+    return pDart;
+
+  GzContactSurfaceParams pGz;
+  FillGzParams(pDart, pGz);
+
+  auto contactInternal = this->convertContact(_contact);
+  if (contactInternal)
+  {
+    this->surfaceParamsCallback(contactInternal.value(),
+                                _numContactsOnCollisionObject, pGz);
+    ApplyGzParams(pGz, pDart);
   }
 
   this->lastGzParams = pGz;
@@ -375,25 +3184,174 @@ GzContactSurfaceHandler::createConstraint(
   auto constraint = dart::constraint::ContactSurfaceHandler::createConstraint(
     _contact, _numContactsOnCollisionObject, _timeStep);
 
-  typedef SetContactPropertiesCallbackFeature F;
-  typedef FeaturePolicy3d P;
-  typename F::ContactSurfaceParams<P>& p = this->lastGzParams;
+  ApplyGzConstraintParams(this->lastGzParams, *constraint);
+
+  return constraint;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::AddContactPropertiesBatchCallback(
+  const Identity& _worldID, const std::string& _callbackID,
+  SurfaceParamsBatchCallback _callback)
+{
+  auto *world = this->ReferenceInterface<DartWorld>(_worldID);
+
+  auto handler = std::make_shared<GzContactSurfaceBatchHandler>();
+  handler->surfaceParamsCallback = std::move(_callback);
+  handler->world = world;
+  handler->findContactShapes = [this](
+    const dart::collision::Contact &_contact,
+    std::size_t &_shape1ID, std::size_t &_shape2ID)
+  {
+    return this->FindContactShapes(_contact, _shape1ID, _shape2ID);
+  };
+
+  this->contactSurfaceBatchHandlers[_callbackID] = handler;
+  world->getConstraintSolver()->addContactSurfaceHandler(handler);
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::RemoveContactPropertiesBatchCallback(
+  const Identity& _worldID, const std::string& _callbackID)
+{
+  auto *world = this->ReferenceInterface<DartWorld>(_worldID);
+
+  const auto it = this->contactSurfaceBatchHandlers.find(_callbackID);
+  if (it == this->contactSurfaceBatchHandlers.end())
+  {
+    gzerr << "Could not find the contact surface handler to be removed"
+           << std::endl;
+    return false;
+  }
+
+  const auto handler = it->second;
+  this->contactSurfaceBatchHandlers.erase(it);
+  return world->getConstraintSolver()->removeContactSurfaceHandler(handler);
+}
+
+/////////////////////////////////////////////////
+dart::constraint::ContactSurfaceParams
+GzContactSurfaceBatchHandler::createParams(
+  const dart::collision::Contact& _contact,
+  const size_t _numContactsOnCollisionObject) const
+{
+  auto pDart = ContactSurfaceHandler::createParams(
+    _contact, _numContactsOnCollisionObject);
 
-  if (this->lastGzParams.errorReductionParameter)
-    constraint->setErrorReductionParameter(p.errorReductionParameter.value());
+  if (const Params *pGz = this->FindParams(_contact))
+    ApplyGzParams(*pGz, pDart);
 
-  if (this->lastGzParams.maxErrorAllowance)
-    constraint->setErrorAllowance(p.maxErrorAllowance.value());
+  return pDart;
+}
 
-  if (this->lastGzParams.maxErrorReductionVelocity)
-    constraint->setMaxErrorReductionVelocity(
-      p.maxErrorReductionVelocity.value());
+/////////////////////////////////////////////////
+dart::constraint::ContactConstraintPtr
+GzContactSurfaceBatchHandler::createConstraint(
+  dart::collision::Contact& _contact,
+  const size_t _numContactsOnCollisionObject,
+  const double _timeStep) const
+{
+  auto constraint = dart::constraint::ContactSurfaceHandler::createConstraint(
+    _contact, _numContactsOnCollisionObject, _timeStep);
 
-  if (this->lastGzParams.constraintForceMixing)
-    constraint->setConstraintForceMixing(p.constraintForceMixing.value());
+  if (const Params *pGz = this->FindParams(_contact))
+    ApplyGzConstraintParams(*pGz, *constraint);
 
   return constraint;
 }
+
+/////////////////////////////////////////////////
+auto GzContactSurfaceBatchHandler::FindParams(
+  const dart::collision::Contact &_contact) const -> const Params *
+{
+  if (!this->surfaceParamsCallback || !this->world)
+    return nullptr;
+
+  // dart creates the contact constraints of a step from the collision result
+  // of the step, which stays in place until the next step.
+  const auto &contacts =
+    this->world->getConstraintSolver()->getLastCollisionResult().getContacts();
+  const std::less<const dart::collision::Contact *> before;
+  if (contacts.empty() || before(&_contact, contacts.data()) ||
+      !before(&_contact, contacts.data() + contacts.size()))
+  {
+    return nullptr;
+  }
+  const auto index = static_cast<std::size_t>(&_contact - contacts.data());
+
+  if (this->batchFrame != this->world->getSimFrames() ||
+      this->batchIndices.size() != contacts.size())
+  {
+    this->batchFrame = this->world->getSimFrames();
+    this->batchIndices.assign(
+      contacts.size(), std::numeric_limits<std::size_t>::max());
+    this->collision1.clear();
+    this->collision2.clear();
+    this->point.clear();
+    this->normal.clear();
+    this->depth.clear();
+    this->numContacts.clear();
+
+    // Count the contacts between each pair of collision objects, like the
+    // constraint solver does for _numContactsOnCollisionObject
+    std::unordered_map<const dart::collision::CollisionObject *,
+      std::unordered_map<const dart::collision::CollisionObject *,
+        std::size_t>> pairCounts;
+    for (const auto &contact : contacts)
+    {
+      const auto *object1 = std::min(
+        contact.collisionObject1, contact.collisionObject2);
+      const auto *object2 = std::max(
+        contact.collisionObject1, contact.collisionObject2);
+      ++pairCounts[object1][object2];
+    }
+
+    for (std::size_t i = 0; i < contacts.size(); ++i)
+    {
+      const auto &contact = contacts[i];
+      std::size_t shape1ID;
+      std::size_t shape2ID;
+      if (!this->findContactShapes(contact, shape1ID, shape2ID))
+        continue;
+
+      this->batchIndices[i] = this->collision1.size();
+      this->collision1.push_back(shape1ID);
+      this->collision2.push_back(shape2ID);
+      this->point.push_back(contact.point);
+      this->normal.push_back(contact.normal);
+      this->depth.push_back(contact.penetrationDepth);
+      this->numContacts.push_back(pairCounts
+        [std::min(contact.collisionObject1, contact.collisionObject2)]
+        [std::max(contact.collisionObject1, contact.collisionObject2)]);
+    }
+
+    const std::size_t count = this->collision1.size();
+    this->params.assign(count, Params());
+    for (std::size_t i = 0; i < contacts.size(); ++i)
+    {
+      const std::size_t b = this->batchIndices[i];
+      if (b < count)
+      {
+        FillGzParams(ContactSurfaceHandler::createParams(
+          contacts[i], this->numContacts[b]), this->params[b]);
+      }
+    }
+
+    Impl::ContactSurfaceBatch batch;
+    batch.size = count;
+    batch.collision1 = this->collision1.data();
+    batch.collision2 = this->collision2.data();
+    batch.point = this->point.data();
+    batch.normal = this->normal.data();
+    batch.depth = this->depth.data();
+    batch.numContactsOnCollision = this->numContacts.data();
+    if (count > 0u)
+      this->surfaceParamsCallback(batch, this->params.data());
+  }
+
+  const std::size_t b = this->batchIndices[index];
+  return b < this->params.size() ? &this->params[b] : nullptr;
+}
 #endif
 
 }
@@ -18,9 +18,15 @@
 #ifndef GZ_PHYSICS_DARTSIM_SRC_SIMULATIONFEATURES_HH_
 #define GZ_PHYSICS_DARTSIM_SRC_SIMULATIONFEATURES_HH_
 
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <dart/config.hpp>
@@ -28,14 +34,23 @@
 #include <dart/constraint/ContactSurface.hpp>
 #endif
 
+#include <gz/common/WorkerPool.hh>
 #include <gz/math/Pose3.hh>
 
 #include <gz/physics/CanWriteData.hh>
 
+#include <gz/physics/ForceField.hh>
 #include <gz/physics/ForwardStep.hh>
 #include <gz/physics/GetContacts.hh>
+#include <gz/physics/KinematicModel.hh>
+#include <gz/physics/RayIntersection.hh>
+#include <gz/physics/ShapeQueries.hh>
+#include <gz/physics/SharedStateRing.hh>
+#include <gz/physics/Sleep.hh>
 #include <gz/physics/ContactProperties.hh>
 #include <gz/physics/SpecifyData.hh>
+#include <gz/physics/TaskScheduler.hh>
+#include <gz/physics/World.hh>
 
 #include "Base.hh"
 
@@ -43,6 +58,9 @@ namespace dart
 {
 namespace collision
 {
+class BulletCollisionDetector;
+class CollisionDetector;
+class CollisionGroup;
 class Contact;
 }
 }
@@ -53,10 +71,35 @@ namespace dartsim {
 
 struct SimulationFeatureList : FeatureList<
   ForwardStep,
+  StepWorldsFeature,
+  ConcurrentWorldStepFeature,
+  AsyncForwardStepFeature,
+  PublishedWorldStateFeature,
+  PoseInterpolationFeature,
+  SharedStateExportFeature,
 #ifdef DART_HAS_CONTACT_SURFACE
   SetContactPropertiesCallbackFeature,
+  SetContactPropertiesBatchCallbackFeature,
 #endif
-  GetContactsFromLastStepFeature
+  GetContactsFromLastStepFeature,
+  GetContactBatchFromLastStepFeature,
+  GetContactPairsFromLastStepFeature,
+  ContactFilterFeature,
+  ContactEventsFeature,
+  WorldStateSnapshotFeature,
+  GetStepStatisticsFeature,
+  GetModelStepStatisticsFeature,
+  GetMemoryUsageFeature,
+  ParallelPoseWriteFeature,
+  DeterministicStepFeature,
+  RayIntersectionFeature,
+  ShapeQueryFeature,
+  ShapeDistanceFeature,
+  SleepFeature,
+  SleepThresholdsFeature,
+  KinematicModelFeature,
+  ForceFieldFeature,
+  TaskSchedulerFeature
 > { };
 
 #ifdef DART_HAS_CONTACT_SURFACE
@@ -85,6 +128,67 @@ class GzContactSurfaceHandler : public dart::constraint::ContactSurfaceHandler
 };
 
 using GzContactSurfaceHandlerPtr = std::shared_ptr<GzContactSurfaceHandler>;
+
+/// \brief Contact surface handler of a SetContactPropertiesBatchCallbackFeature
+/// callback. It runs the callback for all the contacts of a step when dart
+/// asks for the parameters of the first of them, and hands out the results
+/// by contact index afterwards.
+class GzContactSurfaceBatchHandler
+    : public dart::constraint::ContactSurfaceHandler
+{
+  public: dart::constraint::ContactSurfaceParams createParams(
+    const dart::collision::Contact& _contact,
+    size_t _numContactsOnCollisionObject) const override;
+
+  public: dart::constraint::ContactConstraintPtr createConstraint(
+    dart::collision::Contact& _contact,
+    size_t _numContactsOnCollisionObject,
+    double _timeStep) const override;
+
+  public: typedef SetContactPropertiesBatchCallbackFeature Feature;
+  public: typedef Feature::Implementation<FeaturePolicy3d> Impl;
+  public: typedef Feature::ContactSurfaceParams<FeaturePolicy3d> Params;
+
+  public: Impl::SurfaceParamsBatchCallback surfaceParamsCallback;
+
+  /// \brief World whose contacts are handled
+  public: dart::simulation::World *world = nullptr;
+
+  /// \brief Find the shape entities of a contact, see
+  /// SimulationFeatures::FindContactShapes
+  public: std::function<bool(
+    const dart::collision::Contact&, std::size_t&, std::size_t&)>
+  findContactShapes;
+
+  /// \brief Get the parameters of a contact of the current step, running
+  /// the callback first if they were not computed for this step yet.
+  /// \param[in] _contact Contact of the last collision result of the world.
+  /// \return The parameters, or nullptr if the contact is not passed to the
+  /// callback.
+  private: const Params *FindParams(
+    const dart::collision::Contact &_contact) const;
+
+  /// \brief Frame of the world that the parameters were computed in
+  private: mutable int batchFrame = -1;
+
+  /// \brief Index into the batch of each contact of the collision result,
+  /// or the max value of std::size_t for contacts between unknown shapes
+  private: mutable std::vector<std::size_t> batchIndices;
+
+  /// \brief Buffers backing the batch passed to the callback
+  private: mutable std::vector<std::size_t> collision1;
+  private: mutable std::vector<std::size_t> collision2;
+  private: mutable std::vector<Eigen::Vector3d> point;
+  private: mutable std::vector<Eigen::Vector3d> normal;
+  private: mutable std::vector<double> depth;
+  private: mutable std::vector<std::size_t> numContacts;
+
+  /// \brief Parameters of each contact of the batch
+  private: mutable std::vector<Params> params;
+};
+
+using GzContactSurfaceBatchHandlerPtr =
+    std::shared_ptr<GzContactSurfaceBatchHandler>;
 #endif
 
 class SimulationFeatures :
@@ -96,6 +200,31 @@ class SimulationFeatures :
 {
   public: using GetContactsFromLastStepFeature::Implementation<FeaturePolicy3d>
     ::ContactInternal;
+  public: using GetContactBatchFromLastStepFeature::Implementation<
+    FeaturePolicy3d>::ContactBatch;
+  public: using ContactPairBatch =
+    GetContactPairsFromLastStepFeature::ContactPairBatchT<FeaturePolicy3d>;
+  public: using ContactFilter =
+    ContactFilterFeature::Implementation<FeaturePolicy3d>::ContactFilter;
+  public: using ContactEventBatch = ContactEventsFeature::ContactEventBatch;
+  public: using ContactEventTracker =
+    ContactEventsFeature::Implementation<FeaturePolicy3d>::ContactEventTracker;
+  public: using Snapshot = WorldStateSnapshotFeature::Snapshot;
+  public: using PublishedWorldStateBuffer =
+      PublishedWorldStateFeature::PublishedWorldStateBuffer;
+  public: using StepStatistics = GetStepStatisticsFeature::StepStatistics;
+  public: using ModelStepStatistics =
+      GetModelStepStatisticsFeature::ModelStepStatistics;
+  public: using MemoryUsage = GetMemoryUsageFeature::MemoryUsage;
+  public: using RayIntersectionBatch =
+      RayIntersectionFeature::RayIntersectionBatchT<FeaturePolicy3d>;
+  public: using QueryVolume =
+      ShapeQueryFeature::QueryVolumeT<FeaturePolicy3d>;
+  public: using OverlapBatch =
+      ShapeQueryFeature::OverlapBatchT<FeaturePolicy3d>;
+  public: using ShapeDistance =
+      ShapeDistanceFeature::ShapeDistanceT<FeaturePolicy3d>;
+  public: using ShapePair = std::pair<std::size_t, std::size_t>;
 
   public: SimulationFeatures() = default;
   public: ~SimulationFeatures() override = default;
@@ -106,20 +235,693 @@ class SimulationFeatures :
       ForwardStep::State &_x,
       const ForwardStep::Input &_u) override;
 
+  public: void StepEngineWorlds(
+      const Identity &_engineID,
+      const std::size_t *_worldIDs,
+      std::size_t _count,
+      ForwardStep::Output &_h,
+      ForwardStep::State &_x,
+      const ForwardStep::Input &_u,
+      std::size_t _numThreads) override;
+
+  public: std::shared_mutex &EngineEntityChangeMutex(
+      const Identity &_engineID) override;
+
+  public: std::shared_ptr<const PublishedWorldStateBuffer>
+  GetWorldPublishedStateBuffer(const Identity &_worldID) override;
+
+  public: void GetWorldInterpolatedPoses(
+      const Identity &_worldID,
+      double _fraction,
+      std::vector<WorldPose> &_poses) const override;
+
+  public: void SetWorldSharedStateExport(
+      const Identity &_worldID,
+      std::shared_ptr<SharedStateRingWriter> _writer) override;
+
+  public: std::shared_future<void> StartWorldStep(
+      const Identity &_worldID,
+      const ForwardStep::Input &_u) override;
+
+  public: const ForwardStep::Output &FinishWorldStep(
+      const Identity &_worldID) override;
+
   public: void Write(WorldPoses &_worldPoses) const;
 
   public: void Write(ChangedWorldPoses &_changedPoses) const;
 
+  public: void Write(WorldTwists &_twists) const;
+
+  public: void Write(ChangedWorldTwists &_changedTwists,
+      const ChangedWorldPoses &_changedPoses) const;
+
+  public: void Write(WorldAccelerations &_accelerations) const;
+
+  public: void Write(ChangedWorldAccelerations &_changedAccelerations,
+      const ChangedWorldPoses &_changedPoses) const;
+
+  public: void Write(JointStates &_states) const;
+
+  public: void Write(ChangedJointStates &_changedStates) const;
+
   public: std::vector<ContactInternal> GetContactsFromLastStep(
       const Identity &_worldID) const override;
 
-  /// \brief link poses from the most recent pose change/update.
-  /// The key is the link's ID, and the value is the link's pose
-  private: mutable std::unordered_map<std::size_t, math::Pose3d> prevLinkPoses;
+  public: ContactBatch GetContactBatchFromLastStep(
+      const Identity &_worldID) const override;
+
+  public: ContactPairBatch GetContactPairsFromLastStep(
+      const Identity &_worldID) const override;
+
+  public: void SetWorldContactFilter(
+      const Identity &_worldID,
+      const std::vector<std::size_t> &_entities) override;
+
+  public: std::vector<std::size_t> GetWorldContactFilter(
+      const Identity &_worldID) const override;
+
+  public: ContactEventBatch GetContactEvents(
+      const Identity &_worldID) const override;
+
+  public: Snapshot GetWorldStateSnapshot(
+      const Identity &_worldID) const override;
+
+  public: bool SetWorldStateSnapshot(
+      const Identity &_worldID, const Snapshot &_snapshot) override;
+
+  public: StepStatistics GetWorldStepStatistics(
+      const Identity &_worldID) const override;
+
+  public: void SetWorldModelStepStatisticsEnabled(
+      const Identity &_worldID, bool _enable) override;
+
+  public: std::vector<ModelStepStatistics> GetWorldModelStepStatistics(
+      const Identity &_worldID) const override;
+
+  public: MemoryUsage GetWorldMemoryUsage(
+      const Identity &_worldID) const override;
+
+  public: void SetEnginePoseWriteThreads(
+      const Identity &_engineID,
+      std::size_t _numThreads,
+      std::size_t _minLinks) override;
+
+  public: std::size_t GetEnginePoseWriteThreads(
+      const Identity &_engineID) const override;
+
+  public: std::size_t GetEnginePoseWriteMinLinks(
+      const Identity &_engineID) const override;
+
+  public: void SetEngineDeterministic(
+      const Identity &_engineID, bool _deterministic) override;
+
+  public: bool GetEngineDeterministic(
+      const Identity &_engineID) const override;
+
+  public: void SetEngineTaskScheduler(
+      const Identity &_engineID,
+      std::shared_ptr<TaskScheduler> _scheduler) override;
+
+  public: std::shared_ptr<TaskScheduler> GetEngineTaskScheduler(
+      const Identity &_engineID) const override;
+
+  public: void SetModelSleepEnabled(
+      const Identity &_modelID, bool _enabled) override;
+
+  public: bool GetModelSleepEnabled(
+      const Identity &_modelID) const override;
+
+  public: void SetModelSleeping(
+      const Identity &_modelID, bool _sleeping) override;
+
+  public: bool GetModelSleeping(
+      const Identity &_modelID) const override;
+
+  public: void SetModelSleepThresholds(
+      const Identity &_modelID,
+      const SleepThresholds &_thresholds) override;
+
+  public: SleepThresholds GetModelSleepThresholds(
+      const Identity &_modelID) const override;
+
+  public: void SetModelKinematic(
+      const Identity &_modelID, bool _kinematic) override;
+
+  public: bool GetModelKinematic(
+      const Identity &_modelID) const override;
+
+  public: std::size_t AddWorldForceField(
+      const Identity &_worldID, const ForceField &_field) override;
+
+  public: bool SetWorldForceField(
+      const Identity &_worldID,
+      std::size_t _fieldID,
+      const ForceField &_field) override;
+
+  public: bool RemoveWorldForceField(
+      const Identity &_worldID, std::size_t _fieldID) override;
+
+  public: RayIntersectionBatch CastWorldRays(
+      const Identity &_worldID,
+      const LinearVector3d *_from,
+      const LinearVector3d *_to,
+      std::size_t _count,
+      std::size_t _numThreads) const override;
+
+  public: RayIntersectionBatch CastWorldShapes(
+      const Identity &_worldID,
+      const QueryVolume *_volumes,
+      const LinearVector3d *_to,
+      std::size_t _count,
+      std::size_t _numThreads) const override;
+
+  public: OverlapBatch FindWorldOverlaps(
+      const Identity &_worldID,
+      const QueryVolume *_volumes,
+      std::size_t _count,
+      std::size_t _numThreads) const override;
+
+  public: void ComputeWorldShapeDistances(
+      const Identity &_worldID,
+      const ShapePair *_pairs,
+      std::size_t _count,
+      double _cutoff,
+      ShapeDistance *_results) const override;
+
+  public: std::vector<ShapeDistance> ComputeWorldLinkDistances(
+      const Identity &_worldID,
+      const std::vector<std::size_t> &_links,
+      double _cutoff) const override;
+
+  /// \brief Compute the distance between two shapes of a world with
+  /// the FCL detector of DistanceGroups, which dartsim uses for distances.
+  /// \param[in] _worldID World entity ID.
+  /// \param[in] _shape1ID Entity ID of the first shape.
+  /// \param[in] _shape2ID Entity ID of the second shape.
+  /// \param[in] _cutoff Pairs whose bounding boxes are farther apart than
+  /// this are not computed.
+  /// \param[out] _result Distance of the shapes. Only its distance, points
+  /// and normal are set, and only if the function returns true.
+  /// \return True if the distance was computed and is within _cutoff.
+  /// \brief Create the distance detector of a world and drop the distance
+  /// groups of the shapes that were removed. Called before the distance
+  /// queries of a world.
+  /// \param[in] _worldID World entity ID.
+  private: void UpdateDistanceGroups(std::size_t _worldID) const;
+
+  private: bool ComputeShapeDistance(
+      std::size_t _worldID,
+      std::size_t _shape1ID,
+      std::size_t _shape2ID,
+      double _cutoff,
+      ShapeDistance &_result) const;
 
   private: std::optional<ContactInternal> convertContact(
     const dart::collision::Contact& _contact) const;
 
+  /// \brief Find the shape entities of a contact.
+  /// \param[in] _contact Contact reported by dartsim.
+  /// \param[out] _shape1ID Entity ID of the first shape.
+  /// \param[out] _shape2ID Entity ID of the second shape.
+  /// \return True if both shapes are known entities.
+  private: bool FindContactShapes(
+    const dart::collision::Contact& _contact,
+    std::size_t &_shape1ID, std::size_t &_shape2ID) const;
+
+  /// \brief Find the contact filter of a world.
+  /// \param[in] _worldID World to get the filter of.
+  /// \return The filter, or nullptr if the world reports all contacts.
+  private: const ContactFilter *FindContactFilter(
+    const Identity &_worldID) const;
+
+  /// \brief Check whether a contact involves an entity of a filter, without
+  /// converting it.
+  /// \param[in] _filter Filter to check against.
+  /// \param[in] _contact Contact reported by dartsim.
+  /// \return True if either shape, its link or its model is in the filter.
+  private: bool PassesContactFilter(
+    const ContactFilter &_filter,
+    const dart::collision::Contact &_contact) const;
+
+  /// \brief Find the shape entity of a shape node. Heightmap tiles resolve
+  /// to their heightmap.
+  /// \param[in] _node Shape node reported by dartsim.
+  /// \param[out] _id Entity ID of the shape.
+  /// \return True if the shape is a known entity.
+  private: bool FindShapeOfNode(
+    const DartShapeNode *_node, std::size_t &_id) const;
+
+  /// \brief Get a bullet collision group holding the shapes of a world, for
+  /// casting rays. This is the group of the constraint solver if the world
+  /// collides with bullet, and a group of its own otherwise. The group is
+  /// brought up to date with the poses of the world.
+  /// \param[in] _worldID World entity ID.
+  /// \param[in] _world The world.
+  /// \return The group, or nullptr if bullet is not available.
+  private: dart::collision::CollisionGroup *UpdateRayGroup(
+    std::size_t _worldID, DartWorld &_world) const;
+
+  /// \brief Run the queries of CastWorldRays or CastWorldShapes, on rayPool
+  /// if more than one thread is requested.
+  /// \param[in] _count Number of queries.
+  /// \param[in] _numThreads Number of threads, 0 for one per core.
+  /// \param[in] _query Runs the queries of a range [_begin, _end). Ranges
+  /// run concurrently, so it must only write the results of its range.
+  private: void RunQueries(std::size_t _count, std::size_t _numThreads,
+      const std::function<void(std::size_t, std::size_t)> &_query) const;
+
+  /// \brief Put the models of the given worlds that have been at rest for
+  /// the timeout of their sleepThresholds to sleep, wake the sleeping models
+  /// whose state was set since they were put to sleep or that an awake model
+  /// touches, and collect the skeletons of the others into
+  /// sleepingSkeletons. Called before stepping.
+  ///
+  /// Models that touch each other form an island, which only goes to sleep
+  /// once all of its models are at rest, and wakes up as a whole. Static
+  /// and kinematic models do not join islands, so that models resting on
+  /// the same ground sleep independently.
+  /// \param[in] _worldIDs IDs of the worlds about to be stepped.
+  private: void UpdateSleepingModels(
+      const std::unordered_set<std::size_t> &_worldIDs);
+
+  /// \brief Join the models of the given worlds that touched each other in
+  /// their last step into groups, in sleepIslandData.
+  /// \param[in] _worldIDs IDs of the worlds about to be stepped.
+  private: void BuildSleepIslands(
+      const std::unordered_set<std::size_t> &_worldIDs);
+
+  /// \brief Put a model to sleep.
+  /// \param[in] _modelID ID of the model.
+  /// \param[in] _island Island of the model.
+  private: void PutModelToSleep(std::size_t _modelID, std::size_t _island);
+
+  /// \brief Wake up all sleeping models of an island.
+  /// \param[in] _island The island.
+  private: void WakeSleepIsland(std::size_t _island);
+
+  /// \brief Add the gravity of the links with fluid added mass of the given
+  /// worlds, see AddedMassLink. Called before stepping.
+  /// \param[in] _worldIDs IDs of the worlds about to be stepped.
+  private: void ApplyAddedMassGravity(
+      const std::unordered_set<std::size_t> &_worldIDs);
+
+  /// \brief Add the wrenches of the force fields of the given worlds to
+  /// their links, see ForceFieldFeature. Called before stepping.
+  /// \param[in] _worldIDs IDs of the worlds about to be stepped.
+  private: void ApplyForceFields(
+      const std::unordered_set<std::size_t> &_worldIDs);
+
+  /// \brief Publish the state of a world to its buffer, if it has one. See
+  /// PublishedWorldStateFeature. Called after stepping.
+  /// \param[in] _worldID ID of the world.
+  private: void PublishWorldState(std::size_t _worldID);
+
+  /// \brief Keep the link poses of the step a world just took, if poses
+  /// are interpolated for it. See PoseInterpolationFeature. Called after
+  /// stepping.
+  /// \param[in] _worldID ID of the world.
+  private: void RecordInterpolationPoses(std::size_t _worldID);
+
+  /// \brief Write the state of a world to its shared state ring, if it has
+  /// one. See SharedStateExportFeature. Called after stepping.
+  /// \param[in] _worldID ID of the world.
+  private: void ExportSharedState(std::size_t _worldID);
+
+  /// \brief Attribute the contacts and constraint rows of the last step of
+  /// a world to its models, if it collects them. See
+  /// GetModelStepStatisticsFeature. Called after stepping.
+  /// \param[in] _worldID ID of the world.
+  private: void CollectModelStepStatistics(std::size_t _worldID);
+
+  /// \brief Whether the pose write-out of the current step includes a link,
+  /// see writeSkeletons.
+  /// \param[in] _info The link
+  /// \return True if the link is written.
+  private: bool IsLinkWritten(const LinkInfo &_info) const;
+
+  /// \brief Move the kinematic models of the given worlds by their
+  /// velocities over one step. dartsim does not integrate them, since they
+  /// are immobile. Called before stepping.
+  /// \param[in] _worldIDs IDs of the worlds about to be stepped.
+  private: void IntegrateKinematicModels(
+      const std::unordered_set<std::size_t> &_worldIDs);
+
+  /// \brief Write the twists requested by the output of a step, if any.
+  /// Must be called after the changed poses of the step are written.
+  /// \param[in] _h Output of the step.
+  private: void WriteTwists(ForwardStep::Output &_h) const;
+
+  /// \brief Write the accelerations requested by the output of a step, if
+  /// any. Must be called after the changed poses of the step are written.
+  /// \param[in] _h Output of the step.
+  private: void WriteAccelerations(ForwardStep::Output &_h) const;
+
+  /// \brief Write the joint states requested by the output of a step, if
+  /// any.
+  /// \param[in] _h Output of the step.
+  private: void WriteJointStates(ForwardStep::Output &_h) const;
+
+  /// \brief Whether the state of a joint is written in the current step,
+  /// see writeSkeletons.
+  /// \param[in] _info The joint
+  /// \return True if the joint is written.
+  private: bool IsJointWritten(const JointInfo &_info) const;
+
+  /// \brief Set the time step of a world from the input of a step, if the
+  /// input has one.
+  /// \param[in] _world World to update.
+  /// \param[in] _u Input of the step.
+  private: void UpdateTimeStep(
+    DartWorld *_world, const ForwardStep::Input &_u) const;
+
+  /// \brief Joint PD controller of a model in a world being stepped, see
+  /// ModelJointPDControl.
+  private: using JointPDControlStep =
+      std::pair<const ModelInfo *, ModelJointPDControl *>;
+
+  /// \brief Step a world and record the statistics of the step, except for
+  /// the pose write-out.
+  /// \param[in] _world World to step.
+  /// \param[in] _subSteps Number of substeps to split the step into.
+  /// \param[in] _controls Joint PD controllers of the models of the world,
+  /// which are evaluated before every substep.
+  /// \param[in, out] _adaptive Adaptive stepping of the world, or nullptr
+  /// to step it by its time step.
+  /// \param[out] _stats Statistics of the step.
+  /// \return Length of the step, in seconds.
+  private: static double StepWorld(
+      DartWorld *_world, std::size_t _subSteps,
+      const std::vector<JointPDControlStep> &_controls,
+      AdaptiveStep *_adaptive, StepStatistics &_stats);
+
+  /// \brief Get the adaptive stepping of a world, see
+  /// AdaptiveTimeStepFeature.
+  /// \param[in] _worldID ID of the world.
+  /// \return Adaptive stepping of the world, or nullptr if it is disabled.
+  private: AdaptiveStep *AdaptiveStepOf(std::size_t _worldID);
+
+  /// \brief Get the length of the next step of a world, which is its time
+  /// step unless it has adaptive stepping enabled.
+  /// \param[in] _worldID ID of the world.
+  /// \return Length of the next step, in seconds.
+  private: double NextStepSizeOf(std::size_t _worldID);
+
+  /// \brief Collect the joint PD controllers of the models of a world.
+  /// \param[in] _worldID ID of the world.
+  /// \param[out] _controls Controllers of the world.
+  private: void CollectJointPDControls(
+      std::size_t _worldID, std::vector<JointPDControlStep> &_controls);
+
+  /// \brief Get the number of substeps of a world, see SubSteps.
+  /// \param[in] _worldID ID of the world.
+  /// \return Number of substeps, at least 1.
+  private: std::size_t SubStepsOf(std::size_t _worldID) const;
+
+  /// \brief Attach the heightmap tiles that the bodies of a world are near,
+  /// and detach the rest. See TiledHeightmap.
+  /// \param[in] _world World about to be stepped.
+  private: void UpdateHeightmapTiles(const DartWorld *_world);
+
+  /// \brief Hand taskScheduler to the island solver and the threaded ODE
+  /// detector of a world, if it uses them.
+  /// \param[in] _world World about to be stepped.
+  private: void UpdateTaskScheduler(DartWorld *_world) const;
+
+  /// \brief Time a step of a world that uses the "auto" collision detector
+  /// and switch its detector when the selection moves on, see
+  /// AutoCollisionDetector.
+  /// \param[in] _worldID ID of the world.
+  /// \param[in] _stepTime Time of the step, without the pose write-out.
+  private: void UpdateAutoCollisionDetector(
+      std::size_t _worldID, double _stepTime);
+
+  /// \brief Keep the first detector of the ranking of a world that uses the
+  /// "auto" collision detector instead of timing the candidates, since step
+  /// times make the selection differ from run to run. Used while stepping
+  /// deterministically.
+  /// \param[in] _worldID ID of the world.
+  /// \param[in,out] _selection Selection of the detector of the world.
+  private: void StopAutoCollisionBenchmark(
+      std::size_t _worldID, AutoCollisionDetector &_selection);
+
+  /// \brief Thread pool used by StepEngineWorlds without a task
+  /// scheduler. Created on first use.
+  private: std::unique_ptr<gz::common::WorkerPool> stepWorldsPool;
+
+  /// \brief Number of threads of stepWorldsPool.
+  private: std::size_t stepWorldsPoolThreads = 0;
+
+  /// \brief Settings, threads and buffers of the parallel pose write-out.
+  private: mutable ParallelPoseWriteFeature::Implementation<
+      FeaturePolicy3d>::PoseWriter poseWriter;
+
+  /// \brief Contact filters by world ID, for worlds that have one. See
+  /// ContactFilterFeature.
+  private: std::unordered_map<std::size_t, ContactFilter> contactFilters;
+
+  /// \brief Pairs in contact and events by world ID, for worlds whose
+  /// events were requested. See ContactEventsFeature.
+  private: mutable std::unordered_map<std::size_t, ContactEventTracker>
+      contactEvents;
+
+  /// \brief Whether worlds are stepped deterministically, see
+  /// DeterministicStepFeature. The island solver and the threaded collision
+  /// detector partition their work in a fixed way already, so this only
+  /// sorts the contacts.
+  private: bool deterministic = false;
+
+  /// \brief Models whose sleeping is enabled, see SleepFeature. dartsim only
+  /// puts the ones in sleepThresholds to sleep on its own.
+  private: std::unordered_set<std::size_t> sleepEnabledModels;
+
+  /// \brief Thresholds of a model given through SleepThresholdsFeature, and
+  /// the time that its links have been at rest for.
+  private: struct SleepTimer
+  {
+    SleepThresholds thresholds;
+    double restTime = 0.0;
+  };
+
+  /// \brief Models with sleep thresholds, by model ID.
+  private: std::unordered_map<std::size_t, SleepTimer> sleepThresholds;
+
+  /// \brief Force fields of a world, see ForceFieldFeature.
+  private: struct WorldForceFields
+  {
+    /// \brief ID of the next field that is added
+    std::size_t nextID = 0u;
+
+    /// \brief Fields of the world, by field ID
+    std::map<std::size_t, ForceField> fields;
+  };
+
+  /// \brief Force fields, by world ID.
+  private: std::unordered_map<std::size_t, WorldForceFields> forceFields;
+
+  /// \brief A sleeping model. Sleeping skeletons are made immobile, so
+  /// dartsim does not integrate them, and DART does not test their
+  /// collisions with other immobile skeletons.
+  private: struct SleepingModel
+  {
+    /// \brief Positions of the skeleton when it was put to sleep.
+    Eigen::VectorXd positions;
+
+    /// \brief Island of the model. The models that touched each other when
+    /// they were put to sleep share an island, and wake up together.
+    std::size_t island = 0u;
+  };
+
+  /// \brief Sleeping models, by model ID.
+  private: std::unordered_map<std::size_t, SleepingModel> sleepingModels;
+
+  /// \brief Island of the next models that are put to sleep.
+  private: std::size_t nextSleepIsland = 0u;
+
+  /// \brief Data of UpdateSleepingModels, kept from step to step so that
+  /// its memory is reused.
+  private: struct SleepIslandData
+  {
+    /// \brief Awake models that have been at rest for their timeout.
+    std::unordered_set<std::size_t> ready;
+
+    /// \brief Islands to wake up.
+    std::unordered_set<std::size_t> wake;
+
+    /// \brief Islands merged into a new island, by their old island.
+    std::unordered_map<std::size_t, std::size_t> merge;
+
+    /// \brief Node of a model in contact with another model, by model ID.
+    std::unordered_map<std::size_t, std::size_t> modelNodes;
+
+    /// \brief Node of a sleeping island, by island.
+    std::unordered_map<std::size_t, std::size_t> islandNodes;
+
+    /// \brief Parent of each node in the union-find of the contacts.
+    std::vector<std::size_t> parents;
+
+    /// \brief Model of each node, or kNoModel for the node of an island.
+    std::vector<std::size_t> models;
+
+    /// \brief Island of each node of an island.
+    std::vector<std::size_t> islands;
+
+    /// \brief New island of each root node, or kNoModel if it has none.
+    std::vector<std::size_t> rootIslands;
+
+    /// \brief State of the group of each root node, a combination of
+    /// kBlocked and kFallingAsleep.
+    std::vector<unsigned char> rootStates;
+
+    /// \brief The group has a moving model or an island that wakes up, so
+    /// it stays awake.
+    static constexpr unsigned char kBlocked = 1u;
+
+    /// \brief The group has awake models that are ready to sleep.
+    static constexpr unsigned char kFallingAsleep = 2u;
+
+    /// \brief Marks a node without a model.
+    static constexpr std::size_t kNoModel =
+        std::numeric_limits<std::size_t>::max();
+  };
+
+  /// \brief See SleepIslandData.
+  private: SleepIslandData sleepIslandData;
+
+  /// \brief Skeletons of the sleeping models that were not woken before the
+  /// current step. Their links are not compared when writing changed poses.
+  private: std::unordered_set<const dart::dynamics::Skeleton *>
+      sleepingSkeletons;
+
+  /// \brief Kinematic models, see KinematicModelFeature, by model ID. The
+  /// value is whether the skeleton of the model was mobile before it was
+  /// made kinematic. Kinematic skeletons are made immobile, which leaves
+  /// them out of the dynamics, while other skeletons still collide with
+  /// them.
+  private: std::unordered_map<std::size_t, bool> kinematicModels;
+
+  /// \brief Statistics of the last step of each world, by world ID.
+  private: std::unordered_map<std::size_t, StepStatistics> stepStatistics;
+
+  /// \brief Held shared by WorldForwardStep and by LockEntityState, and
+  /// exclusively by LockEntityChanges, so that entities do not change while
+  /// worlds are stepped or queried concurrently.
+  private: std::shared_mutex entityChangeMutex;
+
+  /// \brief Serializes the parts of concurrent calls to WorldForwardStep
+  /// that use the state shared by the worlds of the engine. The
+  /// integration of each world runs outside of it.
+  private: mutable std::mutex stepMutex;
+
+  /// \brief Whether the pose write-out of the current step only includes
+  /// the links of writeSkeletons. Set by WorldForwardStep when the engine
+  /// has more than one world, since other worlds may be stepped at the same
+  /// time.
+  private: bool filterWrittenLinks = false;
+
+  /// \brief Skeletons of the world whose poses are being written, see
+  /// filterWrittenLinks.
+  private: std::unordered_set<const dart::dynamics::Skeleton *>
+      writeSkeletons;
+
+  /// \brief Buffers of the worlds that publish their state, by world ID.
+  /// See PublishedWorldStateFeature.
+  private: std::unordered_map<std::size_t,
+      std::shared_ptr<PublishedWorldStateBuffer>> publishedStates;
+
+  /// \brief Skeletons of the world whose state is being published, exported
+  /// or recorded for interpolation. Kept
+  /// between steps to avoid reallocating.
+  private: std::unordered_set<const dart::dynamics::Skeleton *>
+      publishSkeletons;
+
+  /// \brief Link poses of the last two steps of a world whose poses are
+  /// interpolated. See PoseInterpolationFeature.
+  private: struct InterpolationPoses
+  {
+    /// \brief Poses of the step before the last one
+    std::vector<WorldPose> previous;
+
+    /// \brief Poses of the last step
+    std::vector<WorldPose> current;
+
+    /// \brief Storage that the poses of the next step are written to, so
+    /// recording them does not allocate.
+    std::vector<WorldPose> spare;
+  };
+
+  /// \brief Poses of the worlds whose poses are interpolated, by world ID.
+  /// They are read while other threads step the worlds, so they are
+  /// guarded by interpolationMutex.
+  private: mutable std::unordered_map<std::size_t, InterpolationPoses>
+      interpolationPoses;
+
+  /// \brief Guards interpolationPoses
+  private: mutable std::mutex interpolationMutex;
+
+  /// \brief Writers of the worlds that export their state, by world ID.
+  /// See SharedStateExportFeature.
+  private: std::unordered_map<std::size_t,
+      std::shared_ptr<SharedStateRingWriter>> sharedStateExports;
+
+  /// \brief Statistics of the models in the last step of each world that
+  /// collects them, by world ID. See GetModelStepStatisticsFeature.
+  private: std::unordered_map<std::size_t,
+      std::vector<ModelStepStatistics>> modelStepStatistics;
+
+  /// \brief Buffers backing the views returned by
+  /// GetContactBatchFromLastStep.
+  private: mutable GetContactBatchFromLastStepFeature::Implementation<
+    FeaturePolicy3d>::ContactBatchStorage contactBatch;
+
+  /// \brief Buffers backing the views returned by
+  /// GetContactPairsFromLastStep.
+  private: mutable GetContactPairsFromLastStepFeature::Implementation<
+    FeaturePolicy3d>::ContactPairStorage contactPairs;
+
+  /// \brief Bullet collision group of a world that does not collide with
+  /// bullet, used to cast rays.
+  private: struct RayGroup
+  {
+    std::shared_ptr<dart::collision::BulletCollisionDetector> detector;
+    std::shared_ptr<dart::collision::CollisionGroup> group;
+  };
+
+  /// \brief Ray collision groups by world ID. See UpdateRayGroup.
+  private: mutable std::unordered_map<std::size_t, RayGroup> rayGroups;
+
+  /// \brief FCL collision groups of single shapes, for the distance
+  /// queries of a world, since the default ODE detector does not compute
+  /// distances. Groups are made when a shape is first queried, and kept by
+  /// shape entity ID with the node they were made for.
+  private: struct DistanceGroups
+  {
+    std::shared_ptr<dart::collision::CollisionDetector> detector;
+    std::unordered_map<std::size_t, std::pair<const DartShapeNode *,
+        std::shared_ptr<dart::collision::CollisionGroup>>> groups;
+  };
+
+  /// \brief Distance groups by world ID. See ComputeShapeDistance.
+  private: mutable std::unordered_map<std::size_t, DistanceGroups>
+      distanceGroups;
+
+  /// \brief Buffers backing the views returned by CastWorldRays and
+  /// CastWorldShapes.
+  private: mutable RayIntersectionStorage rayHits;
+
+  /// \brief Buffers backing the views returned by FindWorldOverlaps.
+  private: mutable OverlapStorage overlaps;
+
+  /// \brief Overlapping shapes of each volume of the most recent
+  /// FindWorldOverlaps call.
+  private: mutable std::vector<std::vector<std::size_t>> volumeOverlaps;
+
+  /// \brief Thread pool used by CastWorldRays and CastWorldShapes. Created
+  /// when more than one thread is requested.
+  private: mutable std::unique_ptr<gz::common::WorkerPool> rayPool;
+
+  /// \brief Number of threads of rayPool.
+  private: mutable std::size_t rayPoolThreads = 0u;
+
 #ifdef DART_HAS_CONTACT_SURFACE
   public: void AddContactPropertiesCallback(
       const Identity &_worldID,
@@ -131,7 +933,29 @@ class SimulationFeatures :
 
   private: std::unordered_map<
     std::string, GzContactSurfaceHandlerPtr> contactSurfaceHandlers;
+
+  public: void AddContactPropertiesBatchCallback(
+      const Identity &_worldID,
+      const std::string &_callbackID,
+      SurfaceParamsBatchCallback _callback) override;
+
+  public: bool RemoveContactPropertiesBatchCallback(
+      const Identity &_worldID, const std::string &_callbackID) override;
+
+  private: std::unordered_map<
+    std::string, GzContactSurfaceBatchHandlerPtr> contactSurfaceBatchHandlers;
 #endif
+
+  /// \brief Steppers of the worlds stepped through AsyncForwardStepFeature.
+  /// Declared last, so the steps in flight finish before the other members
+  /// are destroyed.
+  private: AsyncForwardStepFeature::Implementation<FeaturePolicy3d>::
+      AsyncSteppers asyncSteppers{
+          [this](const Identity &_worldID, ForwardStep::Output &_h,
+                 ForwardStep::State &_x, const ForwardStep::Input &_u)
+          {
+            this->WorldForwardStep(_worldID, _h, _x, _u);
+          }};
 };
 
 }
@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "TiledHeightmap.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <dart/dynamics/BodyNode.hpp>
+#include <dart/dynamics/Skeleton.hpp>
+#include <gz/math/eigen3/Conversions.hh>
+#include <gz/math/Helpers.hh>
+#include <gz/physics/heightmap/HeightfieldCache.hh>
+
+namespace gz {
+namespace physics {
+namespace dartsim {
+
+/////////////////////////////////////////////////
+TiledHeightmap::TiledHeightmap(
+    const common::HeightmapData &_input,
+    const Eigen::Vector3d &_size,
+    int _subSampling,
+    std::size_t _tileVertices,
+    std::size_t _maxCachedTiles)
+  : sampleCount(_input.Width()),
+    subSampling(static_cast<std::size_t>(std::max(1, _subSampling))),
+    tileVertices(std::max<std::size_t>(2u, _tileVertices)),
+    maxCachedTiles(_maxCachedTiles)
+{
+  // Same scale as CustomHeightmapShape, so the surfaces match
+  this->vertexCount =
+      this->sampleCount * this->subSampling - this->subSampling + 1u;
+
+  const float heightmapSizeZ = _input.MaxElevation() - _input.MinElevation();
+  math::Vector3d scaleGz;
+  scaleGz.X(_size(0) / static_cast<double>(this->vertexCount));
+  scaleGz.Y(_size(1) / static_cast<double>(this->vertexCount));
+  if (math::equal(heightmapSizeZ, 0.0f))
+    scaleGz.Z(1.0);
+  else
+    scaleGz.Z(std::fabs(_size(2)) / heightmapSizeZ);
+  this->scale = Eigen::Vector3d(scaleGz.X(), scaleGz.Y(), 1.0);
+
+  // The subsampled vertices are interpolated from these samples on demand,
+  // instead of being filled in for the whole heightmap here. Terrains built
+  // from the same heightmap share them.
+  this->samples =
+      heightmap::SharedHeightfieldCache<const std::vector<float>>::Instance()
+          .Get(heightmap::HeightfieldKey(_input, math::eigen3::convert(_size),
+                   _subSampling), [&]
+          {
+            auto heights = std::make_shared<std::vector<float>>();
+            const bool flipY = false;
+            _input.FillHeightMap(1,
+                static_cast<unsigned int>(this->sampleCount),
+                math::eigen3::convert(_size), scaleGz, flipY, *heights);
+            return std::shared_ptr<const std::vector<float>>(
+                std::move(heights));
+          });
+
+  if (!this->samples->empty())
+  {
+    const auto [minIt, maxIt] =
+        std::minmax_element(this->samples->begin(), this->samples->end());
+    this->minHeight = *minIt;
+    this->maxHeight = *maxIt;
+  }
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<dart::dynamics::HeightmapShape<float>>
+TiledHeightmap::CreatePlaceholderShape() const
+{
+  auto shape = std::make_shared<dart::dynamics::HeightmapShape<float>>();
+  shape->setHeightField(2u, 2u,
+      {this->minHeight, this->maxHeight, this->minHeight, this->maxHeight});
+
+  // The bounding box of a heightmap spans width * scale, so this gives the
+  // placeholder the size of the full heightmap.
+  shape->setScale(Eigen::Vector3f(
+      static_cast<float>(this->scale.x() * this->vertexCount / 2.0),
+      static_cast<float>(this->scale.y() * this->vertexCount / 2.0),
+      1.0f));
+  return shape;
+}
+
+/////////////////////////////////////////////////
+void TiledHeightmap::SetPlaceholder(dart::dynamics::ShapeNode *_node)
+{
+  this->placeholder = _node;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<TiledHeightmap> TiledHeightmap::CloneFor(
+    dart::dynamics::ShapeNode *_node) const
+{
+  auto clone = std::make_shared<TiledHeightmap>(*this);
+  clone->activeTiles.clear();
+  clone->placeholder = _node;
+  return clone;
+}
+
+/////////////////////////////////////////////////
+std::size_t TiledHeightmap::VertexCount() const
+{
+  return this->vertexCount;
+}
+
+/////////////////////////////////////////////////
+std::size_t TiledHeightmap::TileCount() const
+{
+  const std::size_t edges = this->tileVertices - 1u;
+  return std::max<std::size_t>(
+      1u, (this->vertexCount - 1u + edges - 1u) / edges);
+}
+
+/////////////////////////////////////////////////
+float TiledHeightmap::Height(std::size_t _x, std::size_t _y) const
+{
+  const std::size_t n = this->sampleCount;
+  if (this->subSampling == 1u)
+    return (*this->samples)[_y * n + _x];
+
+  // Bilinear interpolation between the samples, like FillHeightMap
+  const std::size_t x0 = _x / this->subSampling;
+  const std::size_t y0 = _y / this->subSampling;
+  const std::size_t x1 = std::min(x0 + 1u, n - 1u);
+  const std::size_t y1 = std::min(y0 + 1u, n - 1u);
+  const float dx = static_cast<float>(_x % this->subSampling) /
+      static_cast<float>(this->subSampling);
+  const float dy = static_cast<float>(_y % this->subSampling) /
+      static_cast<float>(this->subSampling);
+
+  const auto &heights = *this->samples;
+  const float top = heights[y0 * n + x0] * (1.0f - dx) +
+      heights[y0 * n + x1] * dx;
+  const float bottom = heights[y1 * n + x0] * (1.0f - dx) +
+      heights[y1 * n + x1] * dx;
+  return top * (1.0f - dy) + bottom * dy;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<dart::dynamics::HeightmapShape<float>>
+TiledHeightmap::TileShape(const TileIndex &_tile)
+{
+  for (auto it = this->cache.begin(); it != this->cache.end(); ++it)
+  {
+    if (it->first == _tile)
+    {
+      this->cache.splice(this->cache.begin(), this->cache, it);
+      return it->second;
+    }
+  }
+
+  // Neighbouring tiles share their edge vertices
+  const std::size_t edges = this->tileVertices - 1u;
+  const std::size_t x0 = _tile.first * edges;
+  const std::size_t y0 = _tile.second * edges;
+  const std::size_t width =
+      std::min(this->tileVertices, this->vertexCount - x0);
+  const std::size_t depth =
+      std::min(this->tileVertices, this->vertexCount - y0);
+
+  std::vector<float> heights(width * depth);
+  for (std::size_t y = 0; y < depth; ++y)
+  {
+    for (std::size_t x = 0; x < width; ++x)
+      heights[y * width + x] = this->Height(x0 + x, y0 + y);
+  }
+
+  auto shape = std::make_shared<dart::dynamics::HeightmapShape<float>>();
+  shape->setHeightField(width, depth, heights);
+  shape->setScale(this->scale.cast<float>());
+  this->cache.emplace_front(_tile, shape);
+
+  // Drop the least recently used tiles that are not attached
+  std::size_t detached = 0u;
+  for (auto it = this->cache.begin(); it != this->cache.end();)
+  {
+    if (this->activeTiles.count(it->first) > 0u || it == this->cache.begin())
+    {
+      ++it;
+    }
+    else if (detached < this->maxCachedTiles)
+    {
+      ++detached;
+      ++it;
+    }
+    else
+    {
+      it = this->cache.erase(it);
+    }
+  }
+
+  return shape;
+}
+
+/////////////////////////////////////////////////
+Eigen::Vector3d TiledHeightmap::TileOffset(const TileIndex &_tile) const
+{
+  const std::size_t edges = this->tileVertices - 1u;
+  const double x0 = static_cast<double>(_tile.first * edges);
+  const double y0 = static_cast<double>(_tile.second * edges);
+  const double width = static_cast<double>(
+      std::min(this->tileVertices, this->vertexCount - _tile.first * edges));
+  const double depth = static_cast<double>(
+      std::min(this->tileVertices, this->vertexCount - _tile.second * edges));
+  const double half = (static_cast<double>(this->vertexCount) - 1.0) / 2.0;
+
+  // Heightmaps are centered on their frame, with the first row of heights
+  // on the +y side.
+  return Eigen::Vector3d(
+      (x0 + (width - 1.0) / 2.0 - half) * this->scale.x(),
+      (half - y0 - (depth - 1.0) / 2.0) * this->scale.y(),
+      0.0);
+}
+
+/////////////////////////////////////////////////
+void TiledHeightmap::Update(
+    const dart::simulation::World &_world,
+    std::vector<dart::dynamics::ShapeNode *> &_added,
+    std::vector<const dart::dynamics::ShapeNode *> &_removed)
+{
+  if (!this->placeholder)
+    return;
+
+  const Eigen::Isometry3d fromWorld =
+      this->placeholder->getWorldTransform().inverse();
+  const dart::dynamics::Skeleton *terrain =
+      this->placeholder->getSkeleton().get();
+  const double half = (static_cast<double>(this->vertexCount) - 1.0) / 2.0;
+  const double last = static_cast<double>(this->vertexCount - 1u);
+  const std::size_t edges = this->tileVertices - 1u;
+  const std::size_t lastTile = this->TileCount() - 1u;
+  const double margin = 2.0 * std::max(this->scale.x(), this->scale.y());
+
+  std::set<TileIndex> wanted;
+  for (std::size_t i = 0; i < _world.getNumSkeletons(); ++i)
+  {
+    const auto skeleton = _world.getSkeleton(i);
+    if (skeleton.get() == terrain || !skeleton->isMobile())
+      continue;
+
+    for (std::size_t b = 0; b < skeleton->getNumBodyNodes(); ++b)
+    {
+      const auto *bn = skeleton->getBodyNode(b);
+
+      // Cover the collision shapes of the body, and how far it can move in
+      // one step.
+      double radius = margin +
+          bn->getLinearVelocity().norm() * _world.getTimeStep();
+      for (const auto *sn :
+           bn->getShapeNodesWith<dart::dynamics::CollisionAspect>())
+      {
+        const auto &box = sn->getShape()->getBoundingBox();
+        radius = std::max(radius, margin +
+            sn->getRelativeTransform().translation().norm() +
+            0.5 * (box.getMax() - box.getMin()).norm());
+      }
+
+      const Eigen::Vector3d p =
+          fromWorld * bn->getWorldTransform().translation();
+      const double xMin = (p.x() - radius) / this->scale.x() + half;
+      const double xMax = (p.x() + radius) / this->scale.x() + half;
+      const double yMin = half - (p.y() + radius) / this->scale.y();
+      const double yMax = half - (p.y() - radius) / this->scale.y();
+      if (xMax < 0.0 || xMin > last || yMax < 0.0 || yMin > last)
+        continue;
+
+      auto tileOf = [&](double _v)
+      {
+        const auto v = static_cast<std::size_t>(std::clamp(_v, 0.0, last));
+        return std::min(v / edges, lastTile);
+      };
+      for (std::size_t ty = tileOf(yMin); ty <= tileOf(yMax); ++ty)
+      {
+        for (std::size_t tx = tileOf(xMin); tx <= tileOf(xMax); ++tx)
+          wanted.emplace(tx, ty);
+      }
+    }
+  }
+
+  const Eigen::Isometry3d &pose = this->placeholder->getRelativeTransform();
+  for (auto it = this->activeTiles.begin(); it != this->activeTiles.end();)
+  {
+    if (wanted.count(it->first) > 0u)
+    {
+      // Follow the placeholder if it was moved on the link
+      const Eigen::Isometry3d tilePose =
+          pose * Eigen::Translation3d(this->TileOffset(it->first));
+      if (!it->second->getRelativeTransform().isApprox(tilePose))
+        it->second->setRelativeTransform(tilePose);
+      ++it;
+      continue;
+    }
+    _removed.push_back(it->second);
+    it->second->remove();
+    it = this->activeTiles.erase(it);
+  }
+
+  dart::dynamics::BodyNode *bn = this->placeholder->getBodyNodePtr().get();
+  for (const auto &tile : wanted)
+  {
+    if (this->activeTiles.count(tile) > 0u)
+      continue;
+
+    auto *sn = bn->createShapeNodeWith<dart::dynamics::CollisionAspect,
+                                       dart::dynamics::DynamicsAspect>(
+        this->TileShape(tile), this->placeholder->getName() + ":tile_" +
+        std::to_string(tile.first) + "_" + std::to_string(tile.second));
+    sn->getDynamicsAspect()->setAspectProperties(
+        this->placeholder->getDynamicsAspect()->getAspectProperties());
+    sn->setRelativeTransform(
+        pose * Eigen::Translation3d(this->TileOffset(tile)));
+    this->activeTiles.emplace(tile, sn);
+    _added.push_back(sn);
+  }
+}
+
+/////////////////////////////////////////////////
+const std::map<TiledHeightmap::TileIndex, dart::dynamics::ShapeNode *> &
+TiledHeightmap::ActiveTiles() const
+{
+  return this->activeTiles;
+}
+
+/////////////////////////////////////////////////
+std::size_t TiledHeightmap::CachedTileCount() const
+{
+  return this->cache.size();
+}
+
+/////////////////////////////////////////////////
+std::size_t TiledHeightmap::MemoryBytes() const
+{
+  std::size_t bytes =
+      sizeof(*this) + this->samples->capacity() * sizeof(float);
+  for (const auto &[tile, shape] : this->cache)
+  {
+    if (this->activeTiles.count(tile) == 0u)
+      bytes += shape->getHeightField().size() * sizeof(float);
+  }
+  return bytes;
+}
+}
+}
+}
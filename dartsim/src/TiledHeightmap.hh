@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DARTSIM_SRC_TILEDHEIGHTMAP_HH_
+#define GZ_PHYSICS_DARTSIM_SRC_TILEDHEIGHTMAP_HH_
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <dart/dynamics/HeightmapShape.hpp>
+#include <dart/dynamics/ShapeNode.hpp>
+#include <dart/simulation/World.hpp>
+#include <gz/common/geospatial/HeightmapData.hh>
+
+namespace gz {
+namespace physics {
+namespace dartsim {
+
+/// \brief Collision geometry of a large heightmap, split into square tiles
+/// that are only built while a mobile body is near them.
+///
+/// The heightmap is sampled once at its native resolution, and the samples
+/// are shared by the terrains of every world that uses the same heightmap.
+/// The subsampled heights of a tile are interpolated from those samples when
+/// the tile is first needed, and the tile is then attached to the terrain
+/// link as its own HeightmapShape. Tiles that no body is near are detached
+/// again, and the heights of the least recently used detached tiles are
+/// dropped once more than a fixed number of tiles are cached. The tiles share
+/// their edge vertices, so together they match the surface of a
+/// CustomHeightmapShape built from the same data.
+///
+/// The terrain entity itself is a placeholder ShapeNode without a collision
+/// aspect, whose shape has the size of the full heightmap.
+class TiledHeightmap
+{
+  /// \brief Index of a tile, as (column, row).
+  public: using TileIndex = std::pair<std::size_t, std::size_t>;
+
+  /// \brief Constructor
+  /// \param[in] _input Holds heightmap data.
+  /// \param[in] _size Heightmap size in meters.
+  /// \param[in] _subSampling How much to subsample.
+  /// \param[in] _tileVertices Number of vertices along each edge of a tile.
+  /// \param[in] _maxCachedTiles Number of detached tiles whose heights are
+  /// kept for when a body comes back.
+  public: TiledHeightmap(
+      const common::HeightmapData &_input,
+      const Eigen::Vector3d &_size,
+      int _subSampling,
+      std::size_t _tileVertices = 257u,
+      std::size_t _maxCachedTiles = 16u);
+
+  /// \brief Create the placeholder shape of the terrain entity.
+  /// \return A 2x2 heightmap with the bounding box of the full heightmap.
+  public: std::shared_ptr<dart::dynamics::HeightmapShape<float>>
+      CreatePlaceholderShape() const;
+
+  /// \brief Set the placeholder ShapeNode the tiles are attached next to.
+  /// \param[in] _node Placeholder ShapeNode of the terrain entity.
+  public: void SetPlaceholder(dart::dynamics::ShapeNode *_node);
+
+  /// \brief Copy the heights and cached tiles for the placeholder of a
+  /// cloned terrain. No tiles are attached to the copy until it is updated.
+  /// \param[in] _node Placeholder ShapeNode of the cloned terrain entity.
+  /// \return The copy.
+  public: std::shared_ptr<TiledHeightmap> CloneFor(
+      dart::dynamics::ShapeNode *_node) const;
+
+  /// \brief Number of subsampled vertices along each edge of the heightmap.
+  public: std::size_t VertexCount() const;
+
+  /// \brief Number of tiles along each edge of the heightmap.
+  public: std::size_t TileCount() const;
+
+  /// \brief Height of a subsampled vertex.
+  /// \param[in] _x Column of the vertex.
+  /// \param[in] _y Row of the vertex.
+  /// \return Height of the vertex, before scaling.
+  public: float Height(std::size_t _x, std::size_t _y) const;
+
+  /// \brief Get the shape of a tile, building its heights if they are not
+  /// cached.
+  /// \param[in] _tile Index of the tile.
+  /// \return Shape of the tile.
+  public: std::shared_ptr<dart::dynamics::HeightmapShape<float>> TileShape(
+      const TileIndex &_tile);
+
+  /// \brief Offset of the center of a tile from the center of the heightmap,
+  /// in the frame of the placeholder.
+  /// \param[in] _tile Index of the tile.
+  /// \return Offset of the tile.
+  public: Eigen::Vector3d TileOffset(const TileIndex &_tile) const;
+
+  /// \brief Attach the tiles that mobile bodies of a world are near, and
+  /// detach the rest.
+  /// \param[in] _world World that the terrain belongs to.
+  /// \param[out] _added ShapeNodes of the tiles that were attached.
+  /// \param[out] _removed ShapeNodes of the tiles that were detached. They
+  /// are no longer valid, and can only be used as keys.
+  public: void Update(
+      const dart::simulation::World &_world,
+      std::vector<dart::dynamics::ShapeNode *> &_added,
+      std::vector<const dart::dynamics::ShapeNode *> &_removed);
+
+  /// \brief Get the tiles that are attached.
+  /// \return Map from tile index to the ShapeNode of the tile.
+  public: const std::map<TileIndex, dart::dynamics::ShapeNode *> &
+      ActiveTiles() const;
+
+  /// \brief Number of tiles whose heights are held in memory.
+  public: std::size_t CachedTileCount() const;
+
+  /// \brief Estimate the memory used by the samples and by the heights of
+  /// the detached cached tiles. Attached tiles are shapes of the world and
+  /// are not included.
+  /// \return Bytes used.
+  public: std::size_t MemoryBytes() const;
+
+  /// \brief Heights at the native resolution of the heightmap, row major.
+  /// They are shared with other terrains of the same heightmap, see
+  /// heightmap::SharedHeightfieldCache.
+  private: std::shared_ptr<const std::vector<float>> samples;
+
+  /// \brief Number of samples along each edge of the heightmap.
+  private: std::size_t sampleCount = 0u;
+
+  /// \brief How much the heightmap is subsampled.
+  private: std::size_t subSampling = 1u;
+
+  /// \brief Number of subsampled vertices along each edge of the heightmap.
+  private: std::size_t vertexCount = 0u;
+
+  /// \brief Number of vertices along each edge of a tile.
+  private: std::size_t tileVertices = 0u;
+
+  /// \brief Number of detached tiles kept in the cache.
+  private: std::size_t maxCachedTiles = 0u;
+
+  /// \brief Scale of the subsampled heightmap.
+  private: Eigen::Vector3d scale = Eigen::Vector3d::Ones();
+
+  /// \brief Lowest and highest sample.
+  private: float minHeight = 0.0f;
+  private: float maxHeight = 0.0f;
+
+  /// \brief Placeholder ShapeNode of the terrain entity.
+  private: dart::dynamics::ShapeNode *placeholder = nullptr;
+
+  /// \brief Cached tile shapes, most recently used first.
+  private: std::list<std::pair<TileIndex,
+      std::shared_ptr<dart::dynamics::HeightmapShape<float>>>> cache;
+
+  /// \brief Attached tiles.
+  private: std::map<TileIndex, dart::dynamics::ShapeNode *> activeTiles;
+};
+}
+}
+}
+
+#endif  // GZ_PHYSICS_DARTSIM_SRC_TILEDHEIGHTMAP_HH_
@@ -15,12 +15,11 @@
  *
  */
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
-#include <dart/collision/bullet/BulletCollisionDetector.hpp>
-#include <dart/collision/dart/DARTCollisionDetector.hpp>
-#include <dart/collision/fcl/FCLCollisionDetector.hpp>
 #include <dart/constraint/BoxedLcpConstraintSolver.hpp>
 #include <dart/constraint/ConstraintSolver.hpp>
 #include <dart/constraint/DantzigBoxedLcpSolver.hpp>
@@ -29,6 +28,9 @@
 
 #include <gz/common/Console.hh>
 
+#include "CollisionDetectorSelection.hh"
+#include "GzContactConstraintSolver.hh"
+#include "GzIslandConstraintSolver.hh"
 #include "GzOdeCollisionDetector.hh"
 #include "WorldFeatures.hh"
 
@@ -38,37 +40,106 @@ namespace physics {
 namespace dartsim {
 
 /////////////////////////////////////////////////
-void WorldFeatures::SetWorldCollisionDetector(
-    const Identity &_id, const std::string &_collisionDetector)
+/// \brief Get the PGS solvers of the constraint solver of a world, which
+/// hold the settings of SolverProfile. Dantzig is a direct solver, so it has
+/// no such settings, but it falls back to a secondary PGS solver.
+/// \param[in] _world The world.
+/// \return The primary and secondary PGS solvers, if any.
+static std::vector<std::shared_ptr<dart::constraint::PgsBoxedLcpSolver>>
+pgsSolvers(dart::simulation::World *_world)
 {
-  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
-  auto collisionDetector =
-       world->getConstraintSolver()->getCollisionDetector();
-  if (_collisionDetector == "bullet")
+  std::vector<std::shared_ptr<dart::constraint::PgsBoxedLcpSolver>> pgs;
+  auto solver = dynamic_cast<dart::constraint::BoxedLcpConstraintSolver *>(
+      _world->getConstraintSolver());
+  if (!solver)
+    return pgs;
+
+  for (const auto &lcpSolver :
+       {solver->getBoxedLcpSolver(), solver->getSecondaryBoxedLcpSolver()})
   {
-    collisionDetector = dart::collision::BulletCollisionDetector::create();
+    auto pgsSolver =
+        std::dynamic_pointer_cast<dart::constraint::PgsBoxedLcpSolver>(
+            lcpSolver);
+    if (pgsSolver)
+      pgs.push_back(pgsSolver);
   }
-  else if (_collisionDetector == "fcl")
+  return pgs;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the constraint solver of a world as a
+/// GzContactConstraintSolver, which holds the contact settings of
+/// SolverProfile and PenaltyContactFeature, and collects the statistics of
+/// GetSolverStatisticsFeature.
+/// \param[in] _world The world.
+/// \param[in] _create Whether to replace a plain boxed LCP constraint solver
+/// by a GzContactConstraintSolver.
+/// \return The solver, or nullptr if the world has none and _create is
+/// false or the solver can not be replaced.
+static dart::constraint::GzContactConstraintSolver *contactSolver(
+    dart::simulation::World *_world, bool _create)
+{
+  using dart::constraint::GzContactConstraintSolver;
+  auto *solver = dynamic_cast<GzContactConstraintSolver *>(
+      _world->getConstraintSolver());
+  if (solver || !_create)
+    return solver;
+
+  auto *boxedSolver =
+      dynamic_cast<dart::constraint::BoxedLcpConstraintSolver *>(
+      _world->getConstraintSolver());
+  if (!boxedSolver)
   {
-    collisionDetector = dart::collision::FCLCollisionDetector::create();
+    gzwarn << "Failed to cast constraint solver to [BoxedLcpConstraintSolver]"
+           << std::endl;
+    return nullptr;
   }
-  else if (_collisionDetector == "ode")
+
+  // The skeletons, constraints and collision settings are carried over from
+  // the previous solver, see WorldFeatures::SetWorldSolver.
+  auto newSolver = std::make_unique<GzContactConstraintSolver>();
+  newSolver->setBoxedLcpSolver(boxedSolver->getBoxedLcpSolver());
+  newSolver->setSecondaryBoxedLcpSolver(
+      boxedSolver->getSecondaryBoxedLcpSolver());
+  solver = newSolver.get();
+  _world->setConstraintSolver(std::move(newSolver));
+  return solver;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldCollisionDetector(
+    const Identity &_id, const std::string &_collisionDetector)
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  if (_collisionDetector == "auto" || _collisionDetector == "auto_static")
   {
-    collisionDetector = dart::collision::GzOdeCollisionDetector::create();
+    // The detector may change again after the first steps, which report
+    // the detector they used in their step statistics
+    const CollisionShapeCensus census = CountCollisionShapes(*world);
+    auto &selection = this->autoCollisionDetectors.insert_or_assign(
+        _id.id, AutoCollisionDetector(RankCollisionDetectors(census),
+            _collisionDetector == "auto")).first->second;
+    SwitchCollisionDetector(*world, selection.Current());
+    gzmsg << "Selected [" << selection.Current()
+          << "] collision detector for " << census.Count() << " shapes ("
+          << census.meshes << " meshes, " << census.heightmaps
+          << " heightmaps)" << (selection.Benchmarking() ?
+              ", timing the first steps" : "") << std::endl;
+    return;
   }
-  else if (_collisionDetector == "dart")
+
+  if (!SwitchCollisionDetector(*world, _collisionDetector))
   {
-    collisionDetector = dart::collision::DARTCollisionDetector::create();
+    gzerr << "Collision detector [" << _collisionDetector
+           << "] is not supported, defaulting to ["
+           << world->getConstraintSolver()->getCollisionDetector()->getType()
+           << "]." << std::endl;
   }
   else
   {
-    gzerr << "Collision detector [" << _collisionDetector
-           << "] is not supported, defaulting to ["
-           << collisionDetector->getType() << "]." << std::endl;
+    this->autoCollisionDetectors.erase(_id.id);
   }
 
-  world->getConstraintSolver()->setCollisionDetector(collisionDetector);
-
   gzmsg << "Using [" << world->getConstraintSolver()->getCollisionDetector()
       ->getType() << "] collision detector" << std::endl;
 }
@@ -137,6 +208,78 @@ std::size_t WorldFeatures::GetWorldCollisionPairMaxContacts(
   return 0u;
 }
 
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldCollisionPairContactSelection(
+    const Identity &_id, const std::string &_selection)
+{
+  using ContactSelection =
+      dart::collision::GzOdeCollisionDetector::ContactSelection;
+
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  auto odeCollisionDetector =
+    std::dynamic_pointer_cast<dart::collision::GzOdeCollisionDetector>(
+    world->getConstraintSolver()->getCollisionDetector());
+  if (!odeCollisionDetector)
+  {
+    gzwarn << "Currently contact selection is only supported by the "
+           << "ode collision detector in dartsim." << std::endl;
+    return;
+  }
+
+  if (_selection == "first")
+  {
+    odeCollisionDetector->SetCollisionPairContactSelection(
+        ContactSelection::FIRST);
+  }
+  else if (_selection == "deepest")
+  {
+    odeCollisionDetector->SetCollisionPairContactSelection(
+        ContactSelection::DEEPEST);
+  }
+  else if (_selection == "spread")
+  {
+    odeCollisionDetector->SetCollisionPairContactSelection(
+        ContactSelection::SPREAD);
+  }
+  else
+  {
+    gzerr << "Contact selection [" << _selection
+          << "] is not supported, keeping ["
+          << this->GetWorldCollisionPairContactSelection(_id) << "]."
+          << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+const std::string &WorldFeatures::GetWorldCollisionPairContactSelection(
+    const Identity &_id) const
+{
+  using ContactSelection =
+      dart::collision::GzOdeCollisionDetector::ContactSelection;
+  static const std::string kFirst{"first"};
+  static const std::string kDeepest{"deepest"};
+  static const std::string kSpread{"spread"};
+  static const std::string kEmpty{""};
+
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  auto odeCollisionDetector =
+    std::dynamic_pointer_cast<dart::collision::GzOdeCollisionDetector>(
+    world->getConstraintSolver()->getCollisionDetector());
+  if (!odeCollisionDetector)
+    return kEmpty;
+
+  switch (odeCollisionDetector->GetCollisionPairContactSelection())
+  {
+    case ContactSelection::DEEPEST:
+      return kDeepest;
+    case ContactSelection::SPREAD:
+      return kSpread;
+    case ContactSelection::FIRST:
+    default:
+      return kFirst;
+  }
+}
+
 /////////////////////////////////////////////////
 void WorldFeatures::SetWorldSolver(const Identity &_id,
     const std::string &_solver)
@@ -154,13 +297,21 @@ void WorldFeatures::SetWorldSolver(const Identity &_id,
     return;
   }
 
+  // A "threaded_" prefix selects the constraint solver that solves
+  // independent islands concurrently.
+  static const std::string kThreadedPrefix{"threaded_"};
+  const bool threaded = _solver.compare(
+      0, kThreadedPrefix.size(), kThreadedPrefix) == 0;
+  const std::string lcpSolver =
+      threaded ? _solver.substr(kThreadedPrefix.size()) : _solver;
+
   std::shared_ptr<dart::constraint::BoxedLcpSolver> boxedSolver;
-  if (_solver == "dantzig" || _solver == "DantzigBoxedLcpSolver")
+  if (lcpSolver == "dantzig" || lcpSolver == "DantzigBoxedLcpSolver")
   {
     boxedSolver =
         std::make_shared<dart::constraint::DantzigBoxedLcpSolver>();
   }
-  else if (_solver == "pgs" || _solver == "PgsBoxedLcpSolver")
+  else if (lcpSolver == "pgs" || lcpSolver == "PgsBoxedLcpSolver")
   {
     boxedSolver = std::make_shared<dart::constraint::PgsBoxedLcpSolver>();
   }
@@ -172,10 +323,47 @@ void WorldFeatures::SetWorldSolver(const Identity &_id,
   }
 
   if (boxedSolver != nullptr)
+  {
+    // Keep the settings of SolverProfile when switching to a new PGS solver.
+    const auto pgs = pgsSolvers(world);
+    auto newPgs =
+        std::dynamic_pointer_cast<dart::constraint::PgsBoxedLcpSolver>(
+            boxedSolver);
+    if (newPgs && !pgs.empty())
+      newPgs->setOption(pgs.front()->getOption());
+
+    const bool isThreaded = nullptr !=
+        dynamic_cast<dart::constraint::GzIslandConstraintSolver *>(solver);
+    if (threaded != isThreaded)
+    {
+      using dart::constraint::GzIslandConstraintSolver;
+      using dart::constraint::GzContactConstraintSolver;
+      std::unique_ptr<GzContactConstraintSolver> newSolver;
+      if (threaded)
+        newSolver = std::make_unique<GzIslandConstraintSolver>();
+      else
+        newSolver = std::make_unique<GzContactConstraintSolver>();
+      newSolver->setSecondaryBoxedLcpSolver(
+          solver->getSecondaryBoxedLcpSolver());
+      if (auto *contact = dynamic_cast<GzContactConstraintSolver *>(solver))
+      {
+        newSolver->SetWarmStarting(contact->GetWarmStarting());
+        newSolver->SetPenaltyContact(contact->GetPenaltyStiffness(),
+                                     contact->GetPenaltyDamping());
+        newSolver->SetStatisticsEnabled(contact->GetStatisticsEnabled());
+      }
+
+      // The skeletons, constraints and collision settings are carried over
+      // from the previous solver.
+      solver = newSolver.get();
+      world->setConstraintSolver(std::move(newSolver));
+    }
+
     solver->setBoxedLcpSolver(boxedSolver);
+  }
 
-  gzmsg << "Using [" << solver->getBoxedLcpSolver()->getType()
-         << "] solver." << std::endl;
+  gzmsg << "Using [" << this->GetWorldSolver(_id) << "] solver."
+         << std::endl;
 }
 
 /////////////////////////////////////////////////
@@ -193,9 +381,191 @@ const std::string &WorldFeatures::GetWorldSolver(const Identity &_id) const
     return empty;
   }
 
+  if (dynamic_cast<dart::constraint::GzIslandConstraintSolver *>(solver))
+  {
+    static const std::string kThreadedDantzig{
+        "threaded_" + dart::constraint::DantzigBoxedLcpSolver::getStaticType()};
+    static const std::string kThreadedPgs{
+        "threaded_" + dart::constraint::PgsBoxedLcpSolver::getStaticType()};
+    return solver->getBoxedLcpSolver()->getType() ==
+        dart::constraint::PgsBoxedLcpSolver::getStaticType() ?
+        kThreadedPgs : kThreadedDantzig;
+  }
+
   return solver->getBoxedLcpSolver()->getType();
 }
 
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverIterations(
+    const Identity &_id, std::size_t _iterations)
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  for (auto &pgs : pgsSolvers(world))
+  {
+    auto option = pgs->getOption();
+    option.mMaxIteration = static_cast<int>(_iterations);
+    pgs->setOption(option);
+  }
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldFeatures::GetWorldSolverIterations(const Identity &_id) const
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  const auto pgs = pgsSolvers(world);
+  if (pgs.empty())
+    return 0u;
+  return static_cast<std::size_t>(pgs.front()->getOption().mMaxIteration);
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverWarmStarting(
+    const Identity &_id, bool _warmStarting)
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  if (auto *solver = contactSolver(world, _warmStarting))
+    solver->SetWarmStarting(_warmStarting);
+}
+
+/////////////////////////////////////////////////
+bool WorldFeatures::GetWorldSolverWarmStarting(const Identity &_id) const
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  auto *solver =
+      dynamic_cast<const dart::constraint::GzContactConstraintSolver *>(
+      world->getConstraintSolver());
+  return solver && solver->GetWarmStarting();
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverSplitImpulse(
+    const Identity &, bool _splitImpulse)
+{
+  if (_splitImpulse)
+  {
+    gzwarn << "Solver split impulse is not supported by dartsim."
+           << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+bool WorldFeatures::GetWorldSolverSplitImpulse(const Identity &) const
+{
+  return false;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverTolerance(
+    const Identity &_id, double _tolerance)
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  for (auto &pgs : pgsSolvers(world))
+  {
+    auto option = pgs->getOption();
+    option.mRelativeDeltaXTolerance = std::max(0.0, _tolerance);
+    pgs->setOption(option);
+  }
+}
+
+/////////////////////////////////////////////////
+double WorldFeatures::GetWorldSolverTolerance(const Identity &_id) const
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  const auto pgs = pgsSolvers(world);
+  if (pgs.empty())
+    return 0.0;
+  return pgs.front()->getOption().mRelativeDeltaXTolerance;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSubSteps(
+    const Identity &_id, std::size_t _subSteps)
+{
+  if (_subSteps <= 1u)
+    this->worldSubSteps.erase(_id.id);
+  else
+    this->worldSubSteps[_id.id] = _subSteps;
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldFeatures::GetWorldSubSteps(const Identity &_id) const
+{
+  const auto it = this->worldSubSteps.find(_id.id);
+  return it == this->worldSubSteps.end() ? 1u : it->second;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldAdaptiveTimeStep(
+    const Identity &_id, const AdaptiveTimeStep::Parameters &_parameters)
+{
+  if (_parameters.maxStepSize <= 0.0)
+  {
+    this->worldAdaptiveSteps.erase(_id.id);
+    return;
+  }
+  this->worldAdaptiveSteps[_id.id].controller.SetParameters(_parameters);
+}
+
+/////////////////////////////////////////////////
+AdaptiveTimeStep::Parameters WorldFeatures::GetWorldAdaptiveTimeStep(
+    const Identity &_id) const
+{
+  const auto it = this->worldAdaptiveSteps.find(_id.id);
+  if (it == this->worldAdaptiveSteps.end())
+    return AdaptiveTimeStep::Parameters();
+  return it->second.controller.GetParameters();
+}
+
+/////////////////////////////////////////////////
+double WorldFeatures::GetWorldLastStepSize(const Identity &_id) const
+{
+  const auto it = this->worldLastStepSizes.find(_id.id);
+  return it == this->worldLastStepSizes.end() ? 0.0 : it->second;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldPenaltyContact(
+    const Identity &_id, const PenaltyContactFeature::Parameters &_parameters)
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  if (auto *solver = contactSolver(world, _parameters.stiffness > 0.0))
+    solver->SetPenaltyContact(_parameters.stiffness, _parameters.damping);
+}
+
+/////////////////////////////////////////////////
+PenaltyContactFeature::Parameters WorldFeatures::GetWorldPenaltyContact(
+    const Identity &_id) const
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  PenaltyContactFeature::Parameters parameters;
+  if (auto *solver = contactSolver(world, false))
+  {
+    parameters.stiffness = solver->GetPenaltyStiffness();
+    parameters.damping = solver->GetPenaltyDamping();
+  }
+  return parameters;
+}
+
+/////////////////////////////////////////////////
+void WorldFeatures::SetWorldSolverStatisticsEnabled(
+    const Identity &_id, bool _enable)
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  if (auto *solver = contactSolver(world, _enable))
+    solver->SetStatisticsEnabled(_enable);
+}
+
+/////////////////////////////////////////////////
+GetSolverStatisticsFeature::SolverStatistics
+WorldFeatures::GetWorldSolverStatistics(const Identity &_id) const
+{
+  auto world = this->ReferenceInterface<dart::simulation::World>(_id);
+  const auto *solver = contactSolver(world, false);
+  if (!solver || !solver->GetStatisticsEnabled())
+    return GetSolverStatisticsFeature::SolverStatistics();
+  return solver->GetStatistics();
+}
+
 }
 }
 }
@@ -31,8 +31,14 @@ namespace dartsim {
 struct WorldFeatureList : FeatureList<
   CollisionDetector,
   CollisionPairMaxContacts,
+  CollisionPairContactSelection,
   Gravity,
-  Solver
+  Solver,
+  SolverProfile,
+  SubSteps,
+  AdaptiveTimeStepFeature,
+  PenaltyContactFeature,
+  GetSolverStatisticsFeature
 > { };
 
 class WorldFeatures :
@@ -62,12 +68,85 @@ class WorldFeatures :
   public: std::size_t GetWorldCollisionPairMaxContacts(const Identity &_id)
       const override;
 
+  // Documentation inherited
+  public: void SetWorldCollisionPairContactSelection(
+      const Identity &_id, const std::string &_selection) override;
+
+  // Documentation inherited
+  public: const std::string &GetWorldCollisionPairContactSelection(
+      const Identity &_id) const override;
+
   // Documentation inherited
   public: void SetWorldSolver(const Identity &_id, const std::string &_solver)
       override;
 
   // Documentation inherited
   public: const std::string &GetWorldSolver(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverIterations(
+      const Identity &_id, std::size_t _iterations) override;
+
+  // Documentation inherited
+  public: std::size_t GetWorldSolverIterations(const Identity &_id)
+      const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverWarmStarting(
+      const Identity &_id, bool _warmStarting) override;
+
+  // Documentation inherited
+  public: bool GetWorldSolverWarmStarting(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverSplitImpulse(
+      const Identity &_id, bool _splitImpulse) override;
+
+  // Documentation inherited
+  public: bool GetWorldSolverSplitImpulse(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverTolerance(
+      const Identity &_id, double _tolerance) override;
+
+  // Documentation inherited
+  public: double GetWorldSolverTolerance(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSubSteps(
+      const Identity &_id, std::size_t _subSteps) override;
+
+  // Documentation inherited
+  public: std::size_t GetWorldSubSteps(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldAdaptiveTimeStep(
+      const Identity &_id, const AdaptiveTimeStep::Parameters &_parameters)
+      override;
+
+  // Documentation inherited
+  public: AdaptiveTimeStep::Parameters GetWorldAdaptiveTimeStep(
+      const Identity &_id) const override;
+
+  // Documentation inherited
+  public: double GetWorldLastStepSize(const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldPenaltyContact(
+      const Identity &_id,
+      const PenaltyContactFeature::Parameters &_parameters) override;
+
+  // Documentation inherited
+  public: PenaltyContactFeature::Parameters GetWorldPenaltyContact(
+      const Identity &_id) const override;
+
+  // Documentation inherited
+  public: void SetWorldSolverStatisticsEnabled(
+      const Identity &_id, bool _enable) override;
+
+  // Documentation inherited
+  public: GetSolverStatisticsFeature::SolverStatistics
+      GetWorldSolverStatistics(const Identity &_id) const override;
 };
 
 }
@@ -17,6 +17,21 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dart/collision/CollisionOption.hpp>
+#include <dart/collision/CollisionResult.hpp>
+#include <dart/dynamics/BoxShape.hpp>
+#include <dart/dynamics/FreeJoint.hpp>
+#include <dart/dynamics/Skeleton.hpp>
+#include <dart/dynamics/WeldJoint.hpp>
+
 #include <gz/common/Console.hh>
 #include <gz/physics/FindFeatures.hh>
 #include <gz/plugin/Loader.hh>
@@ -25,6 +40,7 @@
 #include <gz/physics/ForwardStep.hh>
 #include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/GetBoundingBox.hh>
+#include <gz/physics/TaskScheduler.hh>
 #include <gz/physics/World.hh>
 #include <gz/physics/sdf/ConstructWorld.hh>
 
@@ -34,14 +50,21 @@
 #include "test/Utils.hh"
 #include "test/common_test/Worlds.hh"
 
+#include "GzOdeCollisionDetector.hh"
+#include "GzThreadedOdeCollisionDetector.hh"
+
 struct TestFeatureList : gz::physics::FeatureList<
     gz::physics::CollisionDetector,
+    gz::physics::CollisionPairContactSelection,
     gz::physics::Gravity,
     gz::physics::LinkFrameSemantics,
     gz::physics::Solver,
+    gz::physics::SolverProfile,
     gz::physics::ForwardStep,
+    gz::physics::DeterministicStepFeature,
     gz::physics::sdf::ConstructSdfWorld,
-    gz::physics::GetEntities
+    gz::physics::GetEntities,
+    gz::physics::GetStepStatisticsFeature
 > { };
 
 using namespace gz;
@@ -100,6 +123,110 @@ TEST_F(WorldFeaturesFixture, CollisionDetector)
 
   world->SetCollisionDetector("dart");
   EXPECT_EQ("dart", world->GetCollisionDetector());
+
+  world->SetCollisionDetector("threaded_ode");
+  EXPECT_EQ("threaded_ode", world->GetCollisionDetector());
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldFeaturesFixture, AutoCollisionDetector)
+{
+  // A scene of primitives starts with ODE
+  const auto world = LoadWorld(this->engine, common_test::worlds::kShapesWorld);
+  world->SetCollisionDetector("auto_static");
+  EXPECT_EQ("ode", world->GetCollisionDetector());
+
+  physics::ForwardStep::Output output;
+  physics::ForwardStep::State state;
+  physics::ForwardStep::Input input;
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    world->Step(output, state, input);
+    EXPECT_EQ("ode", world->GetStepStatistics().collisionDetector);
+  }
+
+  // The candidates step the world in turn, each for a warm-up step and
+  // five timed steps, and the fastest one is kept
+  world->SetCollisionDetector("auto");
+  std::set<std::string> used;
+  for (std::size_t i = 0; i < 18; ++i)
+  {
+    world->Step(output, state, input);
+    used.insert(world->GetStepStatistics().collisionDetector);
+  }
+  EXPECT_EQ((std::set<std::string>{"bullet", "fcl", "ode"}), used);
+
+  const std::string selected = world->GetCollisionDetector();
+  EXPECT_EQ(1u, used.count(selected));
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    world->Step(output, state, input);
+    EXPECT_EQ(selected, world->GetStepStatistics().collisionDetector);
+  }
+
+  // Choosing a detector by name ends the selection
+  world->SetCollisionDetector("auto");
+  world->SetCollisionDetector("bullet");
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    world->Step(output, state, input);
+    EXPECT_EQ("bullet", world->GetStepStatistics().collisionDetector);
+  }
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldFeaturesFixture, AutoCollisionDetectorDeterministic)
+{
+  // Deterministic steps keep the first detector of the ranking, like
+  // "auto_static", since the timed selection differs from run to run
+  const auto world = LoadWorld(this->engine, common_test::worlds::kShapesWorld);
+  this->engine->SetDeterministic(true);
+  world->SetCollisionDetector("auto");
+  EXPECT_EQ("ode", world->GetCollisionDetector());
+
+  physics::ForwardStep::Output output;
+  physics::ForwardStep::State state;
+  physics::ForwardStep::Input input;
+  for (std::size_t i = 0; i < 20; ++i)
+  {
+    world->Step(output, state, input);
+    EXPECT_EQ("ode", world->GetStepStatistics().collisionDetector);
+  }
+
+  // Once the warm-up and timed steps of ODE are done, the next candidate is
+  // timed, until deterministic steps are enabled again
+  this->engine->SetDeterministic(false);
+  world->SetCollisionDetector("auto");
+  for (std::size_t i = 0; i < 6; ++i)
+    world->Step(output, state, input);
+  EXPECT_NE("ode", world->GetCollisionDetector());
+
+  this->engine->SetDeterministic(true);
+  EXPECT_EQ("ode", world->GetCollisionDetector());
+  for (std::size_t i = 0; i < 20; ++i)
+  {
+    world->Step(output, state, input);
+    EXPECT_EQ("ode", world->GetStepStatistics().collisionDetector);
+  }
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldFeaturesFixture, CollisionPairContactSelection)
+{
+  const auto world = LoadWorld(this->engine, common_test::worlds::kEmptySdf);
+  EXPECT_EQ("first", world->GetCollisionPairContactSelection());
+
+  world->SetCollisionPairContactSelection("deepest");
+  EXPECT_EQ("deepest", world->GetCollisionPairContactSelection());
+
+  world->SetCollisionPairContactSelection("banana");
+  EXPECT_EQ("deepest", world->GetCollisionPairContactSelection());
+
+  world->SetCollisionPairContactSelection("spread");
+  EXPECT_EQ("spread", world->GetCollisionPairContactSelection());
+
+  world->SetCollisionDetector("bullet");
+  EXPECT_EQ("", world->GetCollisionPairContactSelection());
 }
 
 //////////////////////////////////////////////////
@@ -117,4 +244,256 @@ TEST_F(WorldFeaturesFixture, Solver)
 
   world->SetSolver("pgs");
   EXPECT_EQ("PgsBoxedLcpSolver", world->GetSolver());
+
+  world->SetSolver("threaded_dantzig");
+  EXPECT_EQ("threaded_DantzigBoxedLcpSolver", world->GetSolver());
+
+  world->SetSolver("threaded_banana");
+  EXPECT_EQ("threaded_DantzigBoxedLcpSolver", world->GetSolver());
+
+  world->SetSolver("threaded_PgsBoxedLcpSolver");
+  EXPECT_EQ("threaded_PgsBoxedLcpSolver", world->GetSolver());
+
+  world->SetSolver("dantzig");
+  EXPECT_EQ("DantzigBoxedLcpSolver", world->GetSolver());
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldFeaturesFixture, WarmStartSolver)
+{
+  // A stack of boxes resting on the ground, solved by a few PGS iterations
+  const std::string sdfString =
+      "<sdf version='1.7'><world name='default'>"
+      "<model name='ground'><static>true</static>"
+      "<link name='link'><collision name='collision'><geometry>"
+      "<box><size>100 100 1</size></box></geometry>"
+      "<pose>0 0 -0.5 0 0 0</pose></collision></link></model>"
+      "<model name='bottom'><pose>0 0 0.5 0 0 0</pose>"
+      "<link name='link'><collision name='collision'><geometry>"
+      "<box><size>1 1 1</size></box></geometry></collision></link></model>"
+      "<model name='top'><pose>0 0 1.5 0 0 0</pose>"
+      "<link name='link'><collision name='collision'><geometry>"
+      "<box><size>1 1 1</size></box></geometry></collision></link></model>"
+      "</world></sdf>";
+
+  sdf::Root root;
+  ASSERT_TRUE(root.LoadSdfString(sdfString).empty());
+  const auto world = this->engine->ConstructWorld(*root.WorldByIndex(0));
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_FALSE(world->GetSolverWarmStarting());
+  world->SetSolverWarmStarting(true);
+  EXPECT_TRUE(world->GetSolverWarmStarting());
+  EXPECT_EQ("DantzigBoxedLcpSolver", world->GetSolver());
+
+  // Warm starting is kept when switching between solvers
+  world->SetSolver("threaded_pgs");
+  EXPECT_TRUE(world->GetSolverWarmStarting());
+  world->SetSolver("pgs");
+  EXPECT_EQ("PgsBoxedLcpSolver", world->GetSolver());
+  EXPECT_TRUE(world->GetSolverWarmStarting());
+  world->SetSolverIterations(5u);
+
+  physics::ForwardStep::Output output;
+  physics::ForwardStep::State state;
+  physics::ForwardStep::Input input;
+  for (std::size_t i = 0; i < 1000; ++i)
+    world->Step(output, state, input);
+
+  // The stack stays at rest when each step starts from the impulses of the
+  // previous one
+  const auto top = world->GetModel("top")->GetLink(0);
+  EXPECT_NEAR(1.5, top->FrameDataRelativeToWorld().pose.translation().z(),
+              0.01);
+
+  world->SetSolverWarmStarting(false);
+  EXPECT_FALSE(world->GetSolverWarmStarting());
+  EXPECT_EQ("PgsBoxedLcpSolver", world->GetSolver());
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldFeaturesFixture, ThreadedSolver)
+{
+  // Boxes dropped onto the ground far enough apart that each one forms its
+  // own island.
+  std::string boxes;
+  for (int i = 0; i < 8; ++i)
+  {
+    boxes += "<model name='box" + std::to_string(i) + "'>"
+        "<pose>" + std::to_string(2 * i) + " 0 1 0.1 0.2 0.3</pose>"
+        "<link name='link'><collision name='collision'><geometry>"
+        "<box><size>1 1 1</size></box></geometry></collision></link>"
+        "</model>";
+  }
+  const std::string sdfString =
+      "<sdf version='1.7'><world name='default'>"
+      "<model name='ground'><static>true</static>"
+      "<link name='link'><collision name='collision'><geometry>"
+      "<box><size>100 100 1</size></box></geometry>"
+      "<pose>0 0 -0.5 0 0 0</pose></collision></link></model>" + boxes +
+      "</world></sdf>";
+
+  auto loadWorld = [&]()
+  {
+    sdf::Root root;
+    EXPECT_TRUE(root.LoadSdfString(sdfString).empty());
+    return this->engine->ConstructWorld(*root.WorldByIndex(0));
+  };
+
+  const auto serialWorld = loadWorld();
+  const auto threadedWorld = loadWorld();
+  threadedWorld->SetSolver("threaded_dantzig");
+
+  physics::ForwardStep::Output output;
+  physics::ForwardStep::State state;
+  physics::ForwardStep::Input input;
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    serialWorld->Step(output, state, input);
+    threadedWorld->Step(output, state, input);
+  }
+
+  // The islands are solved independently of each other, so the result does
+  // not depend on how they are spread over the threads.
+  ASSERT_EQ(serialWorld->GetModelCount(), threadedWorld->GetModelCount());
+  for (std::size_t i = 0; i < serialWorld->GetModelCount(); ++i)
+  {
+    if (serialWorld->GetModel(i)->GetName() == "ground")
+      continue;
+
+    const auto serialLink = serialWorld->GetModel(i)->GetLink(0);
+    const auto threadedLink = threadedWorld->GetModel(i)->GetLink(0);
+    const Eigen::Vector3d serialPos =
+        serialLink->FrameDataRelativeToWorld().pose.translation();
+    const Eigen::Vector3d threadedPos =
+        threadedLink->FrameDataRelativeToWorld().pose.translation();
+    EXPECT_NEAR(0.0, (serialPos - threadedPos).norm(), 1e-9)
+        << serialWorld->GetModel(i)->GetName();
+    EXPECT_NEAR(0.5, serialPos.z(), 0.05);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief A contact between two named shape frames, with the shape frames
+/// in the order of their names.
+using NamedContact =
+    std::tuple<std::string, std::string, Eigen::Vector3d, Eigen::Vector3d,
+               double>;
+
+//////////////////////////////////////////////////
+/// \brief Contacts of a result, sorted so that results can be compared
+/// regardless of the order in which their contacts were found.
+static std::vector<NamedContact> SortedContacts(
+    const dart::collision::CollisionResult &_result)
+{
+  std::vector<NamedContact> contacts;
+  for (const auto &contact : _result.getContacts())
+  {
+    std::string name1 = contact.collisionObject1->getShapeFrame()->getName();
+    std::string name2 = contact.collisionObject2->getShapeFrame()->getName();
+    Eigen::Vector3d normal = contact.normal;
+    if (name2 < name1)
+    {
+      std::swap(name1, name2);
+      normal = -normal;
+    }
+    contacts.emplace_back(name1, name2, contact.point, normal,
+                          contact.penetrationDepth);
+  }
+  std::sort(contacts.begin(), contacts.end(),
+      [](const NamedContact &_a, const NamedContact &_b)
+      {
+        const Eigen::Vector3d &pa = std::get<2>(_a);
+        const Eigen::Vector3d &pb = std::get<2>(_b);
+        return std::make_tuple(std::get<0>(_a), std::get<1>(_a),
+                               pa.x(), pa.y(), pa.z()) <
+               std::make_tuple(std::get<0>(_b), std::get<1>(_b),
+                               pb.x(), pb.y(), pb.z());
+      });
+  return contacts;
+}
+
+//////////////////////////////////////////////////
+TEST(GzThreadedOdeCollisionDetector, MatchesSerialOde)
+{
+  // A grid of boxes that overlap their neighbours and sink into the ground,
+  // which are more shape frames than the threaded detector needs to split
+  // a query over 4 threads.
+  std::vector<dart::dynamics::SkeletonPtr> skeletons;
+  auto ground = dart::dynamics::Skeleton::create("ground");
+  auto groundBody =
+      ground->createJointAndBodyNodePair<dart::dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<dart::dynamics::CollisionAspect>(
+      std::make_shared<dart::dynamics::BoxShape>(
+          Eigen::Vector3d(20.0, 20.0, 1.0)), "ground");
+  Eigen::Isometry3d groundPose = Eigen::Isometry3d::Identity();
+  groundPose.translation().z() = -0.5;
+  groundBody->getParentJoint()->setTransformFromParentBodyNode(groundPose);
+  skeletons.push_back(ground);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    for (int j = 0; j < 4; ++j)
+    {
+      const std::string name =
+          "box_" + std::to_string(i) + "_" + std::to_string(j);
+      auto skeleton = dart::dynamics::Skeleton::create(name);
+      auto pair =
+          skeleton->createJointAndBodyNodePair<dart::dynamics::FreeJoint>();
+      pair.second->createShapeNodeWith<dart::dynamics::CollisionAspect>(
+          std::make_shared<dart::dynamics::BoxShape>(
+              Eigen::Vector3d(1.1, 1.1, 1.1)), name);
+      Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+      pose.translation() = Eigen::Vector3d(i, j, 0.5);
+      pose.rotate(Eigen::AngleAxisd(0.05 * (i + j), Eigen::Vector3d::UnitZ()));
+      pair.first->setPositions(
+          dart::dynamics::FreeJoint::convertToPositions(pose));
+      skeletons.push_back(skeleton);
+    }
+  }
+
+  const dart::collision::CollisionOption option(true, 100000u);
+  auto collide = [&](
+      const std::shared_ptr<dart::collision::CollisionDetector> &_detector)
+  {
+    auto group = _detector->createCollisionGroup();
+    for (const auto &skeleton : skeletons)
+      group->subscribeTo(skeleton);
+    dart::collision::CollisionResult result;
+    EXPECT_TRUE(_detector->collide(group.get(), option, &result));
+    return SortedContacts(result);
+  };
+
+  const auto serial =
+      collide(dart::collision::GzOdeCollisionDetector::create());
+  ASSERT_FALSE(serial.empty());
+
+  auto threaded = dart::collision::GzThreadedOdeCollisionDetector::create();
+  threaded->SetNumThreads(4u);
+  ASSERT_EQ(4u, threaded->GetNumThreads());
+  ASSERT_GE(skeletons.size(), 2u * threaded->GetNumThreads());
+
+  // Both the own thread pool of the detector and a task scheduler find the
+  // contacts of the serial query, each pair of shapes once
+  for (const bool useScheduler : {false, true})
+  {
+    if (useScheduler)
+    {
+      threaded->SetTaskScheduler(
+          std::make_shared<physics::ThreadPoolTaskScheduler>(4u));
+    }
+
+    const auto contacts = collide(threaded);
+    ASSERT_EQ(serial.size(), contacts.size()) << useScheduler;
+    for (std::size_t i = 0; i < serial.size(); ++i)
+    {
+      EXPECT_EQ(std::get<0>(serial[i]), std::get<0>(contacts[i]));
+      EXPECT_EQ(std::get<1>(serial[i]), std::get<1>(contacts[i]));
+      EXPECT_NEAR(0.0,
+          (std::get<2>(serial[i]) - std::get<2>(contacts[i])).norm(), 1e-6);
+      EXPECT_NEAR(0.0,
+          (std::get<3>(serial[i]) - std::get<3>(contacts[i])).norm(), 1e-6);
+      EXPECT_NEAR(std::get<4>(serial[i]), std::get<4>(contacts[i]), 1e-6);
+    }
+  }
 }
@@ -19,10 +19,13 @@
 
 #include "Base.hh"
 #include "AddedMassFeatures.hh"
+#include "CollisionCheckFeatures.hh"
+#include "CommandFeatures.hh"
 #include "CustomFeatures.hh"
 #include "JointFeatures.hh"
 #include "KinematicsFeatures.hh"
 #include "LinkFeatures.hh"
+#include "ModelDynamicsFeatures.hh"
 #include "SDFFeatures.hh"
 #include "ShapeFeatures.hh"
 #include "SimulationFeatures.hh"
@@ -36,12 +39,15 @@ namespace dartsim {
 
 struct DartsimFeatures : FeatureList<
   AddedMassFeatureList,
+  CollisionCheckFeatureList,
+  CommandFeatureList,
   CustomFeatureList,
   EntityManagementFeatureList,
   FreeGroupFeatureList,
   JointFeatureList,
   KinematicsFeatureList,
   LinkFeatureList,
+  ModelDynamicsFeatureList,
   SDFFeatureList,
   ShapeFeatureList,
   SimulationFeatureList,
@@ -51,12 +57,15 @@ struct DartsimFeatures : FeatureList<
 class Plugin :
     public virtual Base,
     public virtual AddedMassFeatures,
+    public virtual CollisionCheckFeatures,
+    public virtual CommandFeatures,
     public virtual CustomFeatures,
     public virtual EntityManagementFeatures,
     public virtual FreeGroupFeatures,
     public virtual JointFeatures,
     public virtual KinematicsFeatures,
     public virtual LinkFeatures,
+    public virtual ModelDynamicsFeatures,
     public virtual SDFFeatures,
     public virtual ShapeFeatures,
     public virtual SimulationFeatures,
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_HEIGHTMAP_HEIGHTFIELDCACHE_HH_
+#define GZ_PHYSICS_HEIGHTMAP_HEIGHTFIELDCACHE_HH_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <gz/common/geospatial/HeightmapData.hh>
+#include <gz/math/Vector3.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace heightmap
+{
+  /// \brief Key of the heightfield that an engine builds from heightmap
+  /// data: the file the data was loaded from, its resolution and elevation,
+  /// and the size and subsampling it is attached with.
+  /// \param[in] _data Heightmap data.
+  /// \param[in] _size Size of the heightmap, in meters.
+  /// \param[in] _subSampling How much the heightmap is subsampled.
+  /// \return The key, or an empty string if the data was not loaded from a
+  /// file, since nothing then tells its heights apart from other data.
+  std::string HeightfieldKey(const common::HeightmapData &_data,
+                             const math::Vector3d &_size,
+                             int _subSampling);
+
+  /// \brief Heightfields built from heightmap data, shared by every world
+  /// and engine of the process that attaches the same heightmap. Entries
+  /// are reference counted, so a heightfield is freed once no shape uses it.
+  ///
+  /// The cache only holds weak references. Heightfields must not be
+  /// modified once they are shared, since worlds may be stepped on several
+  /// threads at once.
+  ///
+  /// \tparam T Type of the heightfield, which depends on the engine.
+  template <typename T>
+  class SharedHeightfieldCache
+  {
+    /// \brief Get the cache of the process.
+    /// \return The cache.
+    public: static SharedHeightfieldCache &Instance();
+
+    /// \brief Get the heightfield of a key, building it if no shape uses it
+    /// anymore.
+    /// \param[in] _key Key of the heightfield, see HeightfieldKey. Empty
+    /// keys are never shared.
+    /// \param[in] _factory Builds the heightfield as a std::shared_ptr<T>.
+    /// It is called without the cache locked.
+    /// \return The shared heightfield.
+    public: template <typename FactoryT>
+    std::shared_ptr<T> Get(const std::string &_key, FactoryT &&_factory);
+
+    /// \brief Number of heightfields that are still used.
+    /// \return Number of heightfields.
+    public: std::size_t Size() const;
+
+    /// \brief Guards entries.
+    private: mutable std::mutex mutex;
+
+    /// \brief Heightfields by key.
+    private: std::unordered_map<std::string, std::weak_ptr<T>> entries;
+  };
+}
+}
+}
+
+#include <gz/physics/heightmap/detail/HeightfieldCache.hh>
+
+#endif
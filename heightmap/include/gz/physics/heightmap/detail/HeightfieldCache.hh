@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_HEIGHTMAP_DETAIL_HEIGHTFIELDCACHE_HH_
+#define GZ_PHYSICS_HEIGHTMAP_DETAIL_HEIGHTFIELDCACHE_HH_
+
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <gz/physics/heightmap/HeightfieldCache.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace heightmap
+{
+  /////////////////////////////////////////////////
+  inline std::string HeightfieldKey(const common::HeightmapData &_data,
+                                    const math::Vector3d &_size,
+                                    const int _subSampling)
+  {
+    const std::string filename = _data.Filename();
+    if (filename.empty())
+      return std::string();
+
+    std::ostringstream key;
+    key << std::setprecision(std::numeric_limits<double>::max_digits10)
+        << filename << "|" << _data.Width() << " " << _data.Height() << "|"
+        << _data.MinElevation() << " " << _data.MaxElevation() << "|"
+        << _size.X() << " " << _size.Y() << " " << _size.Z() << "|"
+        << _subSampling;
+    return key.str();
+  }
+
+  /////////////////////////////////////////////////
+  template <typename T>
+  SharedHeightfieldCache<T> &SharedHeightfieldCache<T>::Instance()
+  {
+    // Never destroyed, so that shapes freed during static destruction can
+    // still find it.
+    static auto *cache = new SharedHeightfieldCache;
+    return *cache;
+  }
+
+  /////////////////////////////////////////////////
+  template <typename T>
+  template <typename FactoryT>
+  std::shared_ptr<T> SharedHeightfieldCache<T>::Get(
+      const std::string &_key, FactoryT &&_factory)
+  {
+    if (_key.empty())
+      return _factory();
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      auto it = this->entries.find(_key);
+      if (it != this->entries.end())
+      {
+        if (auto heightfield = it->second.lock())
+          return heightfield;
+      }
+    }
+
+    // Heightfields can take long to build, so other heightmaps are not held
+    // up meanwhile. If two threads build the same one, the first is kept.
+    std::shared_ptr<T> built = _factory();
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto &entry = this->entries[_key];
+    if (auto heightfield = entry.lock())
+      return heightfield;
+    entry = built;
+
+    // Drop the keys of heightfields that are no longer used
+    for (auto it = this->entries.begin(); it != this->entries.end();)
+    {
+      if (it->second.expired())
+        it = this->entries.erase(it);
+      else
+        ++it;
+    }
+    return built;
+  }
+
+  /////////////////////////////////////////////////
+  template <typename T>
+  std::size_t SharedHeightfieldCache<T>::Size() const
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::size_t size = 0u;
+    for (const auto &entry : this->entries)
+    {
+      if (!entry.second.expired())
+        ++size;
+    }
+    return size;
+  }
+}
+}
+}
+
+#endif
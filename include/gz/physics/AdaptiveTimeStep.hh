@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_ADAPTIVETIMESTEP_HH_
+#define GZ_PHYSICS_ADAPTIVETIMESTEP_HH_
+
+#include <gz/physics/Export.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief Controller that picks the length of the next step of a world
+    /// from the error of the previous one, see AdaptiveTimeStepFeature.
+    ///
+    /// The error of a step is measured by the deepest penetration between
+    /// two bodies and the largest change of a velocity, each relative to its
+    /// target. Both grow about linearly with the length of the step, so the
+    /// next step is the last one scaled by the inverse of the larger ratio,
+    /// with a safety factor. Steps grow by at most kMaxGrowth at a time,
+    /// and shrink by at most kMaxShrink, which keeps the step from
+    /// oscillating. A step whose error is over the target is not repeated,
+    /// only the steps after it are shortened.
+    ///
+    /// Engines call NextStepSize before every step and Update after it.
+    class GZ_PHYSICS_VISIBLE AdaptiveTimeStep
+    {
+      /// \brief Parameters of the controller.
+      public: struct Parameters
+      {
+        /// \brief Longest step, in seconds. A value of 0 (default) disables
+        /// adaptive stepping and every step has the length given to the
+        /// engine. Otherwise the length given to the engine is the shortest
+        /// step.
+        double maxStepSize = 0.0;
+
+        /// \brief Target of the deepest penetration between two bodies at
+        /// the end of a step, in meters.
+        double targetPenetration = 1e-3;
+
+        /// \brief Target of the largest change of a velocity over a step,
+        /// in m/s for linear and rad/s for angular velocities.
+        double targetVelocityChange = 0.1;
+      };
+
+      /// \brief Largest factor that a step grows by over the previous one.
+      public: static constexpr double kMaxGrowth = 1.5;
+
+      /// \brief Smallest factor that a step shrinks to from the previous
+      /// one.
+      public: static constexpr double kMaxShrink = 0.25;
+
+      /// \brief Fraction of the targets that the controller aims for.
+      public: static constexpr double kSafety = 0.8;
+
+      /// \brief Set the parameters. The length of the next step starts over
+      /// from the shortest step.
+      /// \param[in] _parameters Parameters. Targets that are not positive
+      /// are ignored.
+      public: void SetParameters(const Parameters &_parameters);
+
+      /// \brief Get the parameters.
+      /// \return Parameters.
+      public: const Parameters &GetParameters() const;
+
+      /// \brief Get whether adaptive stepping is enabled.
+      /// \return True if the maximum step is positive.
+      public: bool Enabled() const;
+
+      /// \brief Get the length of the next step.
+      /// \param[in] _minStepSize Shortest step, the length given to the
+      /// engine, in seconds.
+      /// \return Length of the next step, between _minStepSize and the
+      /// maximum step, or _minStepSize if adaptive stepping is disabled.
+      public: double NextStepSize(double _minStepSize) const;
+
+      /// \brief Update the controller with the error of a step.
+      /// \param[in] _stepSize Length of the step, in seconds.
+      /// \param[in] _penetration Deepest penetration at the end of the step.
+      /// \param[in] _velocityChange Largest change of a velocity over the
+      /// step.
+      public: void Update(double _stepSize,
+                          double _penetration,
+                          double _velocityChange);
+
+      /// \brief Parameters of the controller.
+      private: Parameters parameters;
+
+      /// \brief Length of the next step before it is clamped, or 0 if it
+      /// starts from the shortest step.
+      private: double stepSize = 0.0;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_ALLOCATIONCOUNTER_HH_
+#define GZ_PHYSICS_ALLOCATIONCOUNTER_HH_
+
+#include <cstddef>
+
+#include <gz/physics/Export.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief Get the number of heap allocations made through the global
+    /// operator new by all threads of the process so far.
+    ///
+    /// Allocations are only counted when gz-physics is built with the
+    /// ENABLE_ALLOCATION_COUNTER option, which replaces the global operator
+    /// new and delete with versions that count their calls. This is meant
+    /// for debug and profiling builds, to find out which phases of a step
+    /// allocate, see GetStepStatisticsFeature. Memory that an engine gets
+    /// from malloc directly, or from its own allocators, is not counted.
+    /// \return Number of allocations, always 0 if they are not counted.
+    GZ_PHYSICS_VISIBLE
+    std::size_t AllocationCount();
+
+    /// \brief Get whether heap allocations are counted, see
+    /// AllocationCount.
+    /// \return True if gz-physics was built with ENABLE_ALLOCATION_COUNTER.
+    GZ_PHYSICS_VISIBLE
+    bool AllocationCountingEnabled();
+  }
+}
+
+#endif
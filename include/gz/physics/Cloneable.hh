@@ -18,12 +18,47 @@
 #ifndef GZ_PHYSICS_CLONEABLE_HH_
 #define GZ_PHYSICS_CLONEABLE_HH_
 
+#include <cstddef>
 #include <memory>
 
+#include "gz/physics/Export.hh"
+
 namespace gz
 {
   namespace physics
   {
+    namespace detail
+    {
+      /// \brief Allocate memory for a MakeCloneable object. Small objects are
+      /// taken from a free list of this thread, so the many short lived data
+      /// entries of CompositeData objects do not each go through the global
+      /// allocator.
+      /// \param[in] _size Size of the object
+      /// \param[in] _align Alignment of the object
+      /// \return Memory for the object
+      /// \private
+      GZ_PHYSICS_VISIBLE
+      void *AllocateCloneable(std::size_t _size, std::size_t _align);
+
+      /// \brief Return memory from AllocateCloneable. Small blocks are kept on
+      /// a free list of this thread for reuse.
+      /// \param[in] _ptr Memory to return
+      /// \param[in] _size Size that was passed to AllocateCloneable
+      /// \param[in] _align Alignment that was passed to AllocateCloneable
+      /// \private
+      GZ_PHYSICS_VISIBLE
+      void DeallocateCloneable(
+          void *_ptr, std::size_t _size, std::size_t _align);
+    }
+
+    /// \brief Free the memory of destroyed CompositeData entries which the
+    /// calling thread keeps for reuse. The amount kept is bounded, so calling
+    /// this is optional. It can be called, for example, after each simulation
+    /// step to hand memory back after a step that produced an unusually large
+    /// number of entries, such as the extra data of many contacts.
+    GZ_PHYSICS_VISIBLE
+    void ReleaseCloneableMemory();
+
     /// \brief This class allows us to effectively perform type erasure while
     /// still being able to copy, move, and clone the values of objects.
     /// \private
@@ -114,6 +149,16 @@ namespace gz
 
       // Documentation inherited
       public: void Copy(Cloneable &&_other) final;
+
+      /// \brief Allocate from the pools of detail::AllocateCloneable
+      /// \param[in] _size Size of the object
+      /// \return Memory for the object
+      public: static void *operator new(std::size_t _size);
+
+      /// \brief Return memory to the pools of detail::AllocateCloneable
+      /// \param[in] _ptr Memory of the object
+      /// \param[in] _size Size of the object
+      public: static void operator delete(void *_ptr, std::size_t _size);
     };
   }
 }
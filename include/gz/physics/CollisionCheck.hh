@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_COLLISIONCHECK_HH_
+#define GZ_PHYSICS_COLLISIONCHECK_HH_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <gz/physics/FeatureList.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief ModelCollisionCheckFeature checks whether a model collides at
+    /// joint configurations, without stepping its world, e.g. for the
+    /// validity checks of motion planners. Only the frames of the checked
+    /// model move, and no dynamics are computed.
+    ///
+    /// A configuration holds one generalized position per degree of freedom
+    /// of the model, in the coordinates described in ModelDynamicsFeature.
+    /// The model is checked against the collisions of the other models of
+    /// its world, at their current poses, and against itself if it has self
+    /// collisions enabled. Pairs of collisions that the world ignores, e.g.
+    /// through collide bitmasks, are ignored by the checks as well.
+    class GZ_PHYSICS_VISIBLE ModelCollisionCheckFeature
+      : public virtual Feature
+    {
+      /// \brief Result of checking one configuration.
+      public: template <typename PolicyT>
+      struct CollisionCheckT
+      {
+        using Scalar = typename PolicyT::Scalar;
+
+        /// \brief False if the configuration did not have one position per
+        /// coordinate of the model, in which case it was not checked.
+        bool valid = false;
+
+        /// \brief True if the model collides at the configuration.
+        bool inCollision = false;
+
+        /// \brief Entity ID of a collision of the model that is in
+        /// collision. Only set if inCollision is true.
+        std::size_t collision1 = 0u;
+
+        /// \brief Entity ID of the collision that collision1 collides with,
+        /// of another model or of the checked one. Only set if inCollision
+        /// is true.
+        std::size_t collision2 = 0u;
+
+        /// \brief Smallest distance between the collisions of the model and
+        /// those of the other models, if it was requested and the model is
+        /// not in collision. It is 0 if the model is in collision, and
+        /// infinity if it was not requested or the engine cannot compute it.
+        Scalar distance = std::numeric_limits<Scalar>::infinity();
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using CollisionCheck = CollisionCheckT<PolicyT>;
+        public: using GeneralizedVector =
+            Eigen::Matrix<typename PolicyT::Scalar, Eigen::Dynamic, 1>;
+
+        /// \brief Check whether this model collides at a configuration. The
+        /// state of the model is left unchanged.
+        /// \param[in] _positions One position per coordinate
+        /// \param[in] _computeDistance True to also compute the distance to
+        /// the other models when the model is not in collision, which costs
+        /// more than the collision check.
+        /// \return Result of the check
+        public: CollisionCheck CheckConfiguration(
+            const GeneralizedVector &_positions,
+            bool _computeDistance = false) const;
+
+        /// \brief Check whether this model collides at many configurations.
+        /// The state of the model is left unchanged.
+        /// \param[in] _positions Configurations to check
+        /// \param[in] _computeDistance True to also compute distances, as in
+        /// CheckConfiguration
+        /// \param[in] _numThreads Number of threads to check the
+        /// configurations with. A value of 0 uses one thread per core, 1
+        /// (default) checks them on the calling thread. Engines may use
+        /// fewer threads.
+        /// \return Result of each check, in the order of _positions
+        public: std::vector<CollisionCheck> CheckConfigurations(
+            const std::vector<GeneralizedVector> &_positions,
+            bool _computeDistance = false,
+            std::size_t _numThreads = 1u) const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using CollisionCheck = CollisionCheckT<PolicyT>;
+        public: using GeneralizedVector =
+            Eigen::Matrix<typename PolicyT::Scalar, Eigen::Dynamic, 1>;
+
+        /// \brief Implementation API for CheckConfiguration
+        /// \param[in] _modelID Identity of the model
+        /// \param[in] _positions One position per coordinate
+        /// \param[in] _computeDistance True to compute the distance
+        /// \return Result of the check
+        public: virtual CollisionCheck CheckModelConfiguration(
+            const Identity &_modelID,
+            const GeneralizedVector &_positions,
+            bool _computeDistance) const = 0;
+
+        /// \brief Implementation API for CheckConfigurations
+        /// \param[in] _modelID Identity of the model
+        /// \param[in] _positions Configurations to check
+        /// \param[in] _count Number of configurations
+        /// \param[in] _computeDistance True to compute the distances
+        /// \param[in] _numThreads Number of threads, 0 for one per core
+        /// \param[out] _results _count results, in the order of _positions
+        public: virtual void CheckModelConfigurations(
+            const Identity &_modelID,
+            const GeneralizedVector *_positions,
+            std::size_t _count,
+            bool _computeDistance,
+            std::size_t _numThreads,
+            CollisionCheck *_results) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief SelfCollisionSamplingFeature samples the joint configurations
+    /// of each model with self collisions enabled when it is constructed,
+    /// and ignores the pairs of its links that collided at none of them,
+    /// like the allowed collision matrix of motion planners. The collision
+    /// detection of a step then skips those pairs instead of testing them
+    /// in the narrowphase, which is most of the self collision work of
+    /// robots with many links.
+    ///
+    /// Pairs that never collided in the samples may still collide at other
+    /// configurations, so the sampling is disabled by default, and more
+    /// samples make such misses less likely. Engines may only sample models
+    /// whose joints all have finite ranges, and stop ignoring the pairs of
+    /// a model when collisions are added to it.
+    class GZ_PHYSICS_VISIBLE SelfCollisionSamplingFeature
+      : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Set the number of configurations that the models
+        /// constructed afterwards are sampled at.
+        /// \param[in] _numSamples Number of samples, e.g. 1000. 0 disables
+        /// the sampling, which is the default.
+        public: void SetSelfCollisionSampleCount(std::size_t _numSamples);
+
+        /// \brief Get the number of configurations that models are sampled
+        /// at.
+        /// \return Number of samples, 0 if models are not sampled.
+        public: std::size_t GetSelfCollisionSampleCount() const;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        /// \brief Get the number of pairs of links of this model that are
+        /// ignored because they never collided in the samples.
+        /// \return Number of ignored pairs, 0 if the model was not sampled.
+        public: std::size_t GetNeverCollidingLinkPairCount() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for SetSelfCollisionSampleCount
+        /// \param[in] _engineID Identity of the engine
+        /// \param[in] _numSamples Number of samples
+        public: virtual void SetEngineSelfCollisionSampleCount(
+            const Identity &_engineID, std::size_t _numSamples) = 0;
+
+        /// \brief Implementation API for GetSelfCollisionSampleCount
+        /// \param[in] _engineID Identity of the engine
+        /// \return Number of samples
+        public: virtual std::size_t GetEngineSelfCollisionSampleCount(
+            const Identity &_engineID) const = 0;
+
+        /// \brief Implementation API for GetNeverCollidingLinkPairCount
+        /// \param[in] _modelID Identity of the model
+        /// \return Number of ignored pairs
+        public: virtual std::size_t GetModelNeverCollidingLinkPairCount(
+            const Identity &_modelID) const = 0;
+      };
+    };
+  }
+}
+
+#include <gz/physics/detail/CollisionCheck.hh>
+
+#endif
@@ -21,6 +21,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <vector>
 
 #include <gz/utils/SuppressWarning.hh>
 
@@ -40,6 +41,14 @@ namespace gz
 
     /// \brief The CompositeData class allows arbitrary data structures to be
     /// composed together, copied, and moved with type erasure.
+    ///
+    /// Copies share the data objects that have never been accessed mutably,
+    /// i.e. through Get(), Insert(), InsertOrAssign(), MakeRequired() or the
+    /// non-const Query(), so copying a copy costs one reference count per
+    /// entry. A shared object is cloned the first time it is accessed mutably.
+    /// Objects that were accessed mutably are cloned when they are copied,
+    /// since a reference obtained earlier may still be written through. Each
+    /// copy therefore behaves as if it owned its own data.
     class GZ_PHYSICS_VISIBLE CompositeData
     {
       /// \brief Default constructor. Creates an empty CompositeData object.
@@ -769,6 +778,26 @@ namespace gz
       /// queries, even though it should not.
       public: void ResetQueries() const;
 
+      /// \brief Turn the tracking of queries on or off. Without it, Get,
+      /// Query, Insert and the other functions that would mark an entry as
+      /// queried leave the "queried" flags alone, so that reading an entry
+      /// does not write to this CompositeData. Use this for data that is
+      /// read in hot loops and never inspected with UnqueriedEntries(), such
+      /// as the output of ForwardStep or the extra data of contacts.
+      ///
+      /// While tracking is off, entries keep the flags they had when it was
+      /// turned off, and entries that are created are unqueried. Unquery()
+      /// and ResetQueries() still clear flags. Tracking is on by default.
+      /// Copy and move construction take the setting of the other
+      /// CompositeData, while Copy(), Merge() and assignment keep the setting
+      /// of this one.
+      /// \param[in] _enabled True to track queries.
+      public: void SetQueryTracking(bool _enabled);
+
+      /// \brief Check whether queries are tracked, see SetQueryTracking().
+      /// \return True if queries are tracked.
+      public: bool QueryTrackingEnabled() const;
+
       /// \brief Get an ordered set of all data entries in this CompositeData.
       /// Runs with O(N) complexity.
       ///
@@ -970,6 +999,41 @@ namespace gz
       protected: MapOfData dataMap;
       GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
 
+      /// \brief Entry of dataIndex.
+      /// \private
+      public: struct IndexEntry
+      {
+        /// \brief The address of detail::DataTypeKey<Data>() for the data
+        /// type. This is unique to the type within a single library.
+        const std::string *key;
+
+        /// \brief The entry of the data type in dataMap
+        MapOfData::value_type *entry;
+      };
+
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Flat index of the dataMap entries by type. Entries are
+      /// indexed by the functions which may create them, e.g. Get() and
+      /// Insert(), and when Copy() or Merge() takes them from a CompositeData
+      /// which indexed them. Lookups of an indexed type are a scan of this
+      /// small array with pointer comparisons, instead of string comparisons
+      /// down the map. Const lookups of other types search the map and leave
+      /// the index alone. Entries of dataMap are never erased, so the index
+      /// stays valid for the lifetime of this object.
+      protected: std::vector<IndexEntry> dataIndex;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief Find the entry of a data type.
+      /// \return The entry, or nullptr if dataMap has no entry for the type.
+      protected: template <typename Data>
+      MapOfData::value_type *FindEntry() const;
+
+      /// \brief Find the entry of a data type, creating an empty entry if
+      /// dataMap does not have one yet.
+      /// \return The entry.
+      protected: template <typename Data>
+      MapOfData::value_type &FindOrCreateEntry();
+
       /// \brief Total number of data entries currently in this CompositeData.
       /// Note that this may differ from the size of dataMap, because some
       /// entries in dataMap will be referring to nullptrs.
@@ -979,6 +1043,10 @@ namespace gz
       /// either construction or the last call to ResetQueries().
       protected: mutable std::size_t numQueries;
 
+      /// \brief Whether queries update the "queried" flags and numQueries,
+      /// see SetQueryTracking().
+      protected: bool queryTracking;
+
       // Declare friendship
       template <typename> friend class detail::PrivateExpectData;
       template <typename> friend class detail::PrivateRequireData;
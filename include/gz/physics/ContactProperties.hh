@@ -18,6 +18,8 @@
 #ifndef GZ_PHYSICS_CONTACTPROPERTIES_HH_
 #define GZ_PHYSICS_CONTACTPROPERTIES_HH_
 
+#include <cstddef>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -161,6 +163,92 @@ class GZ_PHYSICS_VISIBLE SetContactPropertiesCallbackFeature
   };
 };
 
+/// \brief SetContactPropertiesBatchCallbackFeature is a feature for setting
+/// the properties of many contacts at once, e.g. the surface velocity of the
+/// track of a vehicle. Its callbacks are called once per step with all the
+/// contacts of the step, after the contacts are created but before they
+/// affect the forward step, and without building a Contact for each of them.
+class GZ_PHYSICS_VISIBLE SetContactPropertiesBatchCallbackFeature
+    : public virtual FeatureWithRequirements<ForwardStep>
+{
+  /// \brief Contacts of a step as parallel arrays. Element i of each array
+  /// belongs to contact i. The arrays are only valid during the callback.
+  public: template <typename PolicyT>
+  struct ContactSurfaceBatchT
+  {
+    using Scalar = typename PolicyT::Scalar;
+    using VectorType = typename FromPolicy<PolicyT>::template Use<Vector>;
+
+    /// \brief Number of contacts
+    std::size_t size = 0u;
+    /// \brief Entity ID of the collision shape of the first body
+    const std::size_t *collision1 = nullptr;
+    /// \brief Entity ID of the collision shape of the second body
+    const std::size_t *collision2 = nullptr;
+    /// \brief The point of contact expressed in the world frame
+    const VectorType *point = nullptr;
+    /// \brief The normal of the contact expressed in the world frame
+    const VectorType *normal = nullptr;
+    /// \brief The penetration depth
+    const Scalar *depth = nullptr;
+    /// \brief Number of contact points between the same two collision
+    /// objects, see SetContactPropertiesCallbackFeature
+    const std::size_t *numContactsOnCollision = nullptr;
+  };
+
+  public: template <typename PolicyT>
+  using ContactSurfaceParams =
+      SetContactPropertiesCallbackFeature::ContactSurfaceParams<PolicyT>;
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using ContactSurfaceBatch = ContactSurfaceBatchT<PolicyT>;
+
+    /// \brief This callback is called once per step with all the contacts
+    /// of the step.
+    /// \param _contacts[in] The contacts of the step.
+    /// \param _surfaceParams[in,out] Parameters of the contact surface of
+    ///                               each contact, _contacts.size of them.
+    ///                               They are pre-filled by the physics
+    ///                               engine like those of
+    ///                               SetContactPropertiesCallbackFeature,
+    ///                               and the callback can alter them.
+    public: typedef std::function<
+        void(
+          const ContactSurfaceBatch & /*_contacts*/,
+          ContactSurfaceParams<PolicyT> * /*_surfaceParams*/)
+      > SurfaceParamsBatchCallback;
+
+    /// \brief Add the callback.
+    public: void AddContactPropertiesBatchCallback(
+      const std::string &_callbackID, SurfaceParamsBatchCallback _callback);
+
+    /// \brief Remove the callback.
+    public: bool RemoveContactPropertiesBatchCallback(
+      const std::string &_callbackID);
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using ContactSurfaceBatch = ContactSurfaceBatchT<PolicyT>;
+
+    public: typedef std::function<
+        void(const ContactSurfaceBatch &, ContactSurfaceParams<PolicyT> *)
+      > SurfaceParamsBatchCallback;
+
+    /// \brief Add the callback.
+    public: virtual void AddContactPropertiesBatchCallback(
+      const Identity &_worldID,
+      const std::string &_callbackID,
+      SurfaceParamsBatchCallback _callback) = 0;
+
+    /// \brief Remove the callback.
+    public: virtual bool RemoveContactPropertiesBatchCallback(
+      const Identity &_worldID, const std::string &_callbackID) = 0;
+  };
+};
 }
 }
 
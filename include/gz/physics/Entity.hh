@@ -32,6 +32,7 @@ namespace gz
     // Forward declaration
     namespace detail { template <typename, typename> struct DeterminePlugin; }
     template <typename> struct RequestFeatures;
+    template <typename> class EntityRef;
 
     /// \brief This constant-value should be used to indicate that an Entity ID
     /// is invalid (i.e. does not refer to a real entity).
@@ -200,6 +201,90 @@ namespace gz
       // Declare these friendships so we can cast between different Entity types
       template <typename> friend class EntityPtr;
       template <typename> friend struct RequestFeatures;
+      template <typename> friend class EntityRef;
+    };
+
+    /// \brief A non-owning handle to an Entity, meant for code that touches
+    /// many entities on every step, such as controllers.
+    ///
+    /// An EntityRef is trivially copyable. Copying one, or calling a feature
+    /// function through it, neither allocates memory nor touches a reference
+    /// count. In exchange, it does not keep anything alive. It stays valid as
+    /// long as the entity exists in the physics engine and the EntityPtr it
+    /// was created from is alive, or the engine that EntityPtr was obtained
+    /// from is.
+    ///
+    /// Entities returned by feature functions called through an EntityRef
+    /// share this restriction, even if they are held by an EntityPtr.
+    template <typename EntityT>
+    class EntityRef
+    {
+      /// \brief A temporary Entity that operator->() forwards calls to. It
+      /// only lives until the end of the expression that created it.
+      public: class Proxy
+      {
+        /// \brief Access members of the Entity.
+        /// \return Pointer to the temporary Entity.
+        public: EntityT *operator->();
+
+        /// \brief Constructor
+        /// \param[in] _ref Handle to the entity.
+        private: explicit Proxy(const EntityRef &_ref);
+
+        /// \brief The temporary Entity.
+        private: std::remove_const_t<EntityT> entity;
+
+        template <typename> friend class EntityRef;
+      };
+
+      /// \brief Create a handle that does not refer to any Entity.
+      public: EntityRef() = default;
+
+      /// \brief Create a handle to the Entity an EntityPtr points to.
+      /// \param[in] _ptr
+      ///   The EntityPtr. If it is not valid, neither is this handle.
+      public: explicit EntityRef(const EntityPtr<EntityT> &_ptr);
+
+      /// \brief Drill operator. Access members of the Entity being referred
+      /// to. This does NOT check whether the handle is valid.
+      /// \return The ability to call a member function on the Entity.
+      public: Proxy operator->() const;
+
+      /// \brief Check whether this refers to an Entity.
+      /// \return True if this refers to an Entity, otherwise false.
+      public: bool Valid() const;
+
+      /// \brief Implicitly cast this EntityRef to a boolean.
+      /// \return True if this refers to an Entity, otherwise false.
+      public: operator bool() const;
+
+      /// \brief Get the unique ID value of the Entity.
+      /// \return The ID, or INVALID_ENTITY_ID if this is not valid.
+      public: std::size_t EntityID() const;
+
+      /// \brief Comparison operator
+      /// \param[in] _other
+      ///   Handle to compare to.
+      /// \returns True if both refer to the same Entity ID.
+      public: template <typename OtherEntityT>
+      bool operator ==(const EntityRef<OtherEntityT> &_other) const;
+
+      /// \brief Comparison operator
+      /// \param[in] _other
+      ///   Handle to compare to.
+      /// \returns True if the handles refer to different Entity IDs.
+      public: template <typename OtherEntityT>
+      bool operator !=(const EntityRef<OtherEntityT> &_other) const;
+
+      /// \brief The implementation pointer shared by the entities of the
+      /// EntityPtr this was created from.
+      private: typename std::remove_const_t<EntityT>::Pimpl *pimpl = nullptr;
+
+      /// \brief The ID of the Entity.
+      private: std::size_t id = INVALID_ENTITY_ID;
+
+      /// \brief The reference field of the Identity of the Entity.
+      private: void *ref = nullptr;
     };
 
     /// \brief This is the base class of all "proxy objects". The "proxy
@@ -297,6 +382,7 @@ namespace gz
       // Allow EntityPtr to cast between EntityTypes
       template <typename> friend class EntityPtr;
       template <typename> friend struct RequestFeatures;
+      template <typename> friend class EntityRef;
     };
   }
 }
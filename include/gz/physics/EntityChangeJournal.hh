@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_ENTITYCHANGEJOURNAL_HH_
+#define GZ_PHYSICS_ENTITYCHANGEJOURNAL_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <gz/physics/Export.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief A change of the structure of a world, see
+    /// EntityChangeJournalFeature.
+    struct EntityChange
+    {
+      /// \brief What happened to the entity
+      enum class Type : uint8_t
+      {
+        /// \brief The entity was created. related is the entity that
+        /// contains it: the world of a model that is not nested, the parent
+        /// model of a nested model, or the model of a link or joint.
+        CREATED = 0,
+
+        /// \brief The entity was removed. related is the entity that
+        /// contained it, as for CREATED.
+        REMOVED = 1,
+
+        /// \brief The joint was attached. related is its child link.
+        ATTACHED = 2,
+
+        /// \brief The joint was detached. related is its child link.
+        DETACHED = 3
+      };
+
+      /// \brief Kind of entity that changed
+      enum class Kind : uint8_t
+      {
+        MODEL = 0,
+        LINK = 1,
+        JOINT = 2
+      };
+
+      /// \brief What happened to the entity
+      Type type = Type::CREATED;
+
+      /// \brief Kind of the entity
+      Kind kind = Kind::MODEL;
+
+      /// \brief Entity ID of the entity that changed
+      std::size_t entity = 0u;
+
+      /// \brief Entity ID of the entity the change relates to, see Type
+      std::size_t related = 0u;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Append-only log of the structural changes of a world, for
+    /// engines that implement EntityChangeJournalFeature.
+    ///
+    /// Each change gets the next sequence number. Clients keep the sequence
+    /// number after the last change they read as a cursor, so reading costs
+    /// as much as the changes since then, however many entities the world
+    /// has. Only the last changes are kept: once the journal holds twice its
+    /// capacity, the older half is dropped, and clients whose cursor points
+    /// into it are told to rescan the world.
+    class GZ_PHYSICS_VISIBLE EntityChangeJournal
+    {
+      /// \brief Default number of changes that are kept at least.
+      public: static constexpr std::size_t kDefaultCapacity = 1u << 16;
+
+      /// \brief Constructor
+      /// \param[in] _capacity Number of changes that are kept at least. A
+      /// capacity of 0 is raised to 1.
+      public: explicit EntityChangeJournal(
+          std::size_t _capacity = kDefaultCapacity);
+
+      /// \brief Append a change.
+      /// \param[in] _type What happened to the entity.
+      /// \param[in] _kind Kind of the entity.
+      /// \param[in] _entity Entity ID of the entity.
+      /// \param[in] _related Entity ID of the entity the change relates to,
+      /// see EntityChange::Type.
+      public: void Record(EntityChange::Type _type, EntityChange::Kind _kind,
+                          std::size_t _entity, std::size_t _related);
+
+      /// \brief Read the changes from a cursor on.
+      /// \param[in,out] _cursor Sequence number of the first change to read.
+      /// Set to End().
+      /// \param[out] _changes The changes from _cursor on, oldest first.
+      /// \return False if some of the changes from _cursor on were dropped.
+      /// _changes then holds the changes that are still kept.
+      public: bool Read(std::size_t &_cursor,
+                        std::vector<EntityChange> &_changes) const;
+
+      /// \brief Get the sequence number of the next change.
+      /// \return Number of changes recorded so far.
+      public: std::size_t End() const;
+
+      /// \brief Changes that are kept, oldest first.
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::vector<EntityChange> changes;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief Sequence number of the first change that is kept.
+      private: std::size_t begin = 0u;
+
+      /// \brief Number of changes that are kept at least.
+      private: std::size_t capacity;
+    };
+  }
+}
+
+#endif
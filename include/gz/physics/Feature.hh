@@ -24,6 +24,17 @@
 
 #include <gz/physics/Export.hh>
 #include <gz/physics/Entity.hh>
+#include <gz/physics/FeaturePolicy.hh>
+
+/// \private Declare that the implementation interface of a feature is
+/// explicitly instantiated for FeaturePolicy3d in the core library. Plugins
+/// that implement the feature then link to the vtable, type_info and
+/// destructor of the interface instead of emitting their own copy. This must
+/// be used in the gz::physics namespace, and must be paired with an
+/// explicit instantiation in src/ExplicitInstantiations.cc.
+#define DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(FeatureType) \
+  extern template class GZ_PHYSICS_VISIBLE \
+      FeatureType::Implementation<::gz::physics::FeaturePolicy3d>;
 
 namespace gz
 {
@@ -126,6 +137,15 @@ namespace gz
       /// it with a list of the Features that you require.
       using RequiredFeatures = void;
     };
+
+    extern template class GZ_PHYSICS_VISIBLE
+        Feature::Implementation<FeaturePolicy3d>;
+    extern template class GZ_PHYSICS_VISIBLE
+        Feature::Implementation<FeaturePolicy2d>;
+    extern template class GZ_PHYSICS_VISIBLE
+        Feature::Implementation<FeaturePolicy3f>;
+    extern template class GZ_PHYSICS_VISIBLE
+        Feature::Implementation<FeaturePolicy2f>;
   }
 }
 
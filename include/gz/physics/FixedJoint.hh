@@ -61,6 +61,51 @@ namespace gz
             const std::string &_name) = 0;
       };
     };
+
+    /////////////////////////////////////////////////
+    /// \brief AttachFixedJointAsConstraintFeature makes AttachFixedJoint
+    /// hold the links together with a constraint of the solver instead of
+    /// restructuring the kinematic tree of the engine. Attaching and
+    /// detaching such a joint then costs O(1), which suits workflows that
+    /// attach and detach links many times per second, like grasping.
+    ///
+    /// Like a fixed joint whose transforms are left at identity, the
+    /// constraint holds the origin of the child at the origin of the parent
+    /// until SetJointTransformFromParentFeature or
+    /// SetJointTransformToChildFeature sets the relative transform. The
+    /// constraint is enforced by the solver, so unlike a joint it may let
+    /// the links drift apart slightly under large loads. Joints attached
+    /// this way have no degrees of freedom and support Detach, the joint
+    /// transform features and the frame semantics of joints; other joint
+    /// features are not supported on them.
+    class GZ_PHYSICS_VISIBLE AttachFixedJointAsConstraintFeature
+        : public virtual FeatureWithRequirements<AttachFixedJointFeature>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Set whether AttachFixedJoint attaches links with a
+        /// constraint. Joints that are already attached are not changed.
+        /// \param[in] _asConstraint True to attach with a constraint. The
+        /// default is false.
+        public: void SetAttachFixedJointAsConstraint(bool _asConstraint);
+
+        /// \brief Get whether AttachFixedJoint attaches links with a
+        /// constraint.
+        /// \return True if it does.
+        public: bool GetAttachFixedJointAsConstraint() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual void SetEngineAttachFixedJointAsConstraint(
+            const Identity &_engineID, bool _asConstraint) = 0;
+
+        public: virtual bool GetEngineAttachFixedJointAsConstraint(
+            const Identity &_engineID) const = 0;
+      };
+    };
   }
 }
 
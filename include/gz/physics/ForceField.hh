@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GZ_PHYSICS_FORCEFIELD_HH_
+#define GZ_PHYSICS_FORCEFIELD_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/Geometry.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+/// \brief ForceFieldFeature applies parametric fluid forces, such as wind,
+/// drag and buoyancy, to many links of a world. The engine evaluates every
+/// field in a single pass at the start of each step of the world, instead of
+/// taking one AddExternalForce call per link and per step.
+///
+/// The force of a field on each of its links acts at the center of mass of
+/// the link:
+///
+///     F = -(linearDrag + quadraticDrag * |v|) * v - fluidDensity * volume * g
+///
+/// where v is the velocity of the center of mass relative to fluidVelocity
+/// and g is the gravity of the world. The torque on the link is
+/// T = -angularDrag * w, where w is its angular velocity. The wrenches of
+/// several fields on a link add up.
+class GZ_PHYSICS_VISIBLE ForceFieldFeature : public virtual Feature
+{
+  /// \brief Coefficients of one link in a force field.
+  public: template <typename PolicyT>
+  struct ForceFieldLinkT
+  {
+    using Scalar = typename PolicyT::Scalar;
+
+    /// \brief Entity ID of the link
+    std::size_t link = 0u;
+
+    /// \brief Volume of fluid that the link displaces, in m^3
+    Scalar volume = 0;
+
+    /// \brief Drag coefficient of the linear drag, in N s/m
+    Scalar linearDrag = 0;
+
+    /// \brief Drag coefficient of the quadratic drag, in N s^2/m^2
+    Scalar quadraticDrag = 0;
+
+    /// \brief Drag coefficient of the angular drag, in N m s/rad
+    Scalar angularDrag = 0;
+  };
+
+  /// \brief Parameters of a force field.
+  public: template <typename PolicyT>
+  struct ForceFieldT
+  {
+    using Scalar = typename PolicyT::Scalar;
+    using LinearVectorType =
+        typename FromPolicy<PolicyT>::template Use<LinearVector>;
+
+    /// \brief Velocity of the fluid in the world frame, e.g. the wind or the
+    /// current
+    LinearVectorType fluidVelocity = LinearVectorType::Zero();
+
+    /// \brief Density of the fluid, in kg/m^3. Zero disables buoyancy.
+    Scalar fluidDensity = 0;
+
+    /// \brief Links that the field acts on. Links that are not in the world,
+    /// or that are removed later, are skipped.
+    std::vector<ForceFieldLinkT<PolicyT>> links;
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using ForceField = ForceFieldT<PolicyT>;
+
+    /// \brief Add a force field to this world. It acts on every step of the
+    /// world until it is removed.
+    /// \param[in] _field Parameters of the field
+    /// \return ID of the field, which is unique within this world
+    public: std::size_t AddForceField(const ForceField &_field);
+
+    /// \brief Replace the parameters of a force field of this world, e.g.
+    /// to change the wind between steps.
+    /// \param[in] _fieldID ID returned by AddForceField
+    /// \param[in] _field New parameters of the field
+    /// \return False if this world has no such field
+    public: bool SetForceField(std::size_t _fieldID, const ForceField &_field);
+
+    /// \brief Remove a force field from this world.
+    /// \param[in] _fieldID ID returned by AddForceField
+    /// \return False if this world has no such field
+    public: bool RemoveForceField(std::size_t _fieldID);
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using Scalar = typename PolicyT::Scalar;
+    public: using ForceField = ForceFieldT<PolicyT>;
+    public: using ForceFieldLink = ForceFieldLinkT<PolicyT>;
+    public: using LinearVectorType =
+        typename FromPolicy<PolicyT>::template Use<LinearVector>;
+    public: using AngularVectorType =
+        typename FromPolicy<PolicyT>::template Use<AngularVector>;
+
+    /// \brief Implementation API for AddForceField
+    /// \param[in] _worldID Identity of the world
+    /// \param[in] _field Parameters of the field
+    /// \return ID of the field
+    public: virtual std::size_t AddWorldForceField(
+        const Identity &_worldID, const ForceField &_field) = 0;
+
+    /// \brief Implementation API for SetForceField
+    /// \param[in] _worldID Identity of the world
+    /// \param[in] _fieldID ID of the field
+    /// \param[in] _field New parameters of the field
+    /// \return False if the world has no such field
+    public: virtual bool SetWorldForceField(
+        const Identity &_worldID,
+        std::size_t _fieldID,
+        const ForceField &_field) = 0;
+
+    /// \brief Implementation API for RemoveForceField
+    /// \param[in] _worldID Identity of the world
+    /// \param[in] _fieldID ID of the field
+    /// \return False if the world has no such field
+    public: virtual bool RemoveWorldForceField(
+        const Identity &_worldID, std::size_t _fieldID) = 0;
+
+    /// \brief Compute the force and torque of a field on one of its links,
+    /// as described in ForceFieldFeature. Engines call this for each link
+    /// of their fields when they step.
+    /// \param[in] _field Field acting on the link
+    /// \param[in] _link Coefficients of the link in _field
+    /// \param[in] _gravity Gravity of the world
+    /// \param[in] _linearVelocity Velocity of the center of mass of the link
+    /// in the world frame
+    /// \param[in] _angularVelocity Angular velocity of the link in the world
+    /// frame
+    /// \param[out] _force Force at the center of mass of the link, in the
+    /// world frame
+    /// \param[out] _torque Torque on the link, in the world frame
+    public: static void ComputeForceFieldWrench(
+        const ForceField &_field,
+        const ForceFieldLink &_link,
+        const LinearVectorType &_gravity,
+        const LinearVectorType &_linearVelocity,
+        const AngularVectorType &_angularVelocity,
+        LinearVectorType &_force,
+        AngularVectorType &_torque);
+  };
+};
+}
+}
+
+#include <gz/physics/detail/ForceField.hh>
+
+#endif
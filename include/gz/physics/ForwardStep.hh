@@ -18,13 +18,28 @@
 #ifndef GZ_PHYSICS_FORWARDSTEP_HH_
 #define GZ_PHYSICS_FORWARDSTEP_HH_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <gz/math.hh>
 
 #include <gz/physics/SpecifyData.hh>
 #include <gz/physics/FeatureList.hh>
+#include <gz/physics/TaskScheduler.hh>
 
 namespace gz
 {
@@ -58,6 +73,60 @@ namespace gz
       std::string annotation;
     };
 
+    /// \brief Velocity of a link in the world frame, as reported by
+    /// FrameDataRelativeToWorld.
+    struct WorldTwist
+    {
+      gz::math::Vector3d linearVelocity;
+      gz::math::Vector3d angularVelocity;
+
+      std::size_t body;
+    };
+
+    /// \brief Velocities of all the links, written at the end of a step if
+    /// its output has them.
+    struct WorldTwists
+    {
+      std::vector<WorldTwist> entries;
+      std::string annotation;
+    };
+
+    /// \brief Velocities of the links of ChangedWorldPoses, in the same
+    /// order, written at the end of a step if its output has them.
+    struct ChangedWorldTwists
+    {
+      std::vector<WorldTwist> entries;
+      std::string annotation;
+    };
+
+    /// \brief Acceleration of a link in the world frame at the end of a step,
+    /// for accelerometers and IMUs. Engines which do not keep the
+    /// accelerations of the links give the change of their velocities over
+    /// the step, divided by its duration.
+    struct WorldAcceleration
+    {
+      gz::math::Vector3d linearAcceleration;
+      gz::math::Vector3d angularAcceleration;
+
+      std::size_t body;
+    };
+
+    /// \brief Accelerations of all the links, written at the end of a step
+    /// if its output has them.
+    struct WorldAccelerations
+    {
+      std::vector<WorldAcceleration> entries;
+      std::string annotation;
+    };
+
+    /// \brief Accelerations of the links of ChangedWorldPoses, in the same
+    /// order, written at the end of a step if its output has them.
+    struct ChangedWorldAccelerations
+    {
+      std::vector<WorldAcceleration> entries;
+      std::string annotation;
+    };
+
     struct Point
     {
       gz::math::Vector3d point;
@@ -80,6 +149,43 @@ namespace gz
       std::string annotation;
     };
 
+    /// \brief States of the degrees of freedom of all the joints, written at
+    /// the end of a step if its output has them. The arrays have one entry
+    /// per degree of freedom, with the entries of a joint next to each other
+    /// in the order of their degrees of freedom, so that the joints can be
+    /// read in one pass instead of through one feature call per value. The
+    /// values are those of GetPosition, GetVelocity, GetAcceleration and
+    /// GetForce of the joint, and are NaN where the engine does not have
+    /// them.
+    struct JointStates
+    {
+      /// \brief Entity ID of the joint of each entry
+      std::vector<std::size_t> joints;
+
+      /// \brief Index of the degree of freedom of each entry in its joint
+      std::vector<std::size_t> dofs;
+
+      std::vector<double> positions;
+      std::vector<double> velocities;
+      std::vector<double> accelerations;
+      std::vector<double> efforts;
+      std::string annotation;
+    };
+
+    /// \brief ChangedJointStates has the same definition as JointStates, but
+    /// only holds the joints which are new, or whose position or velocity
+    /// changed since they were last written to a ChangedJointStates.
+    struct ChangedJointStates
+    {
+      std::vector<std::size_t> joints;
+      std::vector<std::size_t> dofs;
+      std::vector<double> positions;
+      std::vector<double> velocities;
+      std::vector<double> accelerations;
+      std::vector<double> efforts;
+      std::string annotation;
+    };
+
     struct Contacts
     {
       std::vector<Point> entries;
@@ -146,23 +252,52 @@ namespace gz
       std::string annotation;
     };
 
+    // ---------------- State Data Structures -----------------
+
+    /// \brief Engine specific state of a world, in the format of
+    /// WorldStateSnapshotFeature::Snapshot. When this is part of the State of
+    /// a step, the step starts from the snapshot, unless it is empty, and the
+    /// snapshot is replaced by the state of the world after the step.
+    struct WorldStateSnapshot
+    {
+      /// \brief Snapshot of the state. An empty snapshot starts the step
+      /// from the current state of the world.
+      std::vector<std::uint8_t> snapshot;
+
+      /// \brief If true, the world is put back into the state it had before
+      /// the step once the step has been taken, so several steps can be
+      /// taken from one snapshot without changing the world. The outputs of
+      /// the step still describe the stepped state.
+      bool preserveWorld = false;
+    };
+
     /////////////////////////////////////////////////
     /// \brief ForwardStep is a feature that allows a simulation of a world to
     /// take one step forward in time.
     class ForwardStep : public virtual Feature
     {
+      /// \brief Every type that the plugins read from the input of a step is
+      /// expected, so their lookups do not search the CompositeData map.
       public: using Input = ExpectData<
               ApplyExternalForceTorques,
               ApplyGeneralizedForces,
               VelocityControlCommands,
               ServoControlCommands,
+              TimeStep,
               std::chrono::steady_clock::duration>;
 
+      /// \brief WorldPoses are always written, and the other outputs of a
+      /// step are expected so they can be accessed without a map search.
       public: using Output = SpecifyData<
           RequireData<WorldPoses>,
-          ExpectData<ChangedWorldPoses, Contacts, JointPositions> >;
+          ExpectData<ChangedWorldPoses, WorldTwists, ChangedWorldTwists,
+                     WorldAccelerations, ChangedWorldAccelerations,
+                     JointStates, ChangedJointStates,
+                     Contacts, JointPositions> >;
 
-      public: using State = CompositeData;
+      /// \brief The plugins read and write a WorldStateSnapshot if the
+      /// state of a step has one, see WorldStateSnapshot.
+      public: using State = ExpectData<WorldStateSnapshot>;
 
       public: template <typename PolicyT, typename FeaturesT>
       class World : public virtual Feature::World<PolicyT, FeaturesT>
@@ -185,6 +320,838 @@ namespace gz
       };
     };
 
+    /////////////////////////////////////////////////
+    /// \brief StepWorldsFeature steps several worlds of an engine forward in
+    /// time with one call. The worlds are independent of each other, so the
+    /// plugin may step them in parallel.
+    class StepWorldsFeature
+      : public virtual FeatureWithRequirements<ForwardStep>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Step a set of worlds forward in time, as if Step had been
+        /// called on each of them with the same input.
+        /// \param[in] _worldIDs Entity IDs of the worlds to step, as given by
+        /// Entity::EntityID(). IDs that are not worlds of this engine are
+        /// skipped.
+        /// \param[out] _h Output of the step, covering all of the worlds.
+        /// \param[in,out] _x State of the step. A WorldStateSnapshot only
+        /// describes one world, so it is ignored here.
+        /// \param[in] _u Input of the step, applied to every world.
+        /// \param[in] _numThreads Number of threads used to step the worlds.
+        /// A value of 0 uses one thread per core. Worlds that are placed
+        /// through WorldPlacementFeature are stepped on the threads of their
+        /// cores instead.
+        public: void StepWorlds(
+            const std::vector<std::size_t> &_worldIDs,
+            ForwardStep::Output &_h,
+            ForwardStep::State &_x,
+            const ForwardStep::Input &_u,
+            std::size_t _numThreads = 0)
+        {
+          if (_worldIDs.empty())
+            return;
+
+          this->template Interface<StepWorldsFeature>()->StepEngineWorlds(
+              this->identity, _worldIDs.data(), _worldIDs.size(),
+              _h, _x, _u, _numThreads);
+        }
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual void StepEngineWorlds(
+            const Identity &_engineID,
+            const std::size_t *_worldIDs,
+            std::size_t _count,
+            ForwardStep::Output &_h,
+            ForwardStep::State &_x,
+            const ForwardStep::Input &_u,
+            std::size_t _numThreads) = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief ConcurrentWorldStepFeature lets different worlds of one engine
+    /// be stepped from different threads at the same time, so that several
+    /// independent simulations can share an engine.
+    ///
+    /// The engine follows this contract:
+    /// - World::Step may be called for different worlds from different
+    ///   threads at the same time. Each step only writes the links of its own
+    ///   world to its output, if the engine has more than one world.
+    /// - Between the steps of a world, one thread at a time may get and set
+    ///   the state of the entities of that world, e.g. joint positions or
+    ///   the frame data of links, while other worlds are being stepped. This
+    ///   includes getting the entities themselves, e.g. World::GetModel. It
+    ///   must be done while holding the lock returned by LockEntityState, so
+    ///   it does not overlap with the changes made under LockEntityChanges.
+    /// - Everything else must be done while holding the lock returned by
+    ///   LockEntityChanges: constructing, removing, attaching or detaching
+    ///   entities, changing the properties of shapes, worlds or the engine,
+    ///   and stepping through StepWorldsFeature. The lock waits for the steps
+    ///   in flight and for the holders of LockEntityState, and new steps wait
+    ///   for it to be released.
+    /// - World::Step takes the lock of the steps itself, so it must not be
+    ///   called while holding either of these locks.
+    /// - AsyncForwardStepFeature must only be used while no other thread
+    ///   uses the engine.
+    ///
+    /// The cache of SetFrameDataCacheFeature is shared by the worlds of an
+    /// engine and locks itself, so it may stay enabled while worlds are
+    /// stepped concurrently. A step of any world invalidates the entries of
+    /// every world.
+    class ConcurrentWorldStepFeature
+      : public virtual FeatureWithRequirements<ForwardStep>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Lock the engine for changes that are not covered by the
+        /// concurrent stepping of worlds, see ConcurrentWorldStepFeature.
+        /// \return Lock that is held until it is destroyed or unlocked.
+        public: std::unique_lock<std::shared_mutex> LockEntityChanges()
+        {
+          return std::unique_lock<std::shared_mutex>(
+              this->template Interface<ConcurrentWorldStepFeature>()
+                  ->EngineEntityChangeMutex(this->identity));
+        }
+
+        /// \brief Lock the engine for getting and setting the state of the
+        /// entities of a world between its steps, see
+        /// ConcurrentWorldStepFeature. Several threads may hold this lock at
+        /// the same time, and it excludes LockEntityChanges.
+        /// \return Lock that is held until it is destroyed or unlocked.
+        public: std::shared_lock<std::shared_mutex> LockEntityState()
+        {
+          return std::shared_lock<std::shared_mutex>(
+              this->template Interface<ConcurrentWorldStepFeature>()
+                  ->EngineEntityChangeMutex(this->identity));
+        }
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Mutex that steps and LockEntityState hold shared, and
+        /// LockEntityChanges holds exclusively.
+        /// \param[in] _engineID Identity of the engine
+        /// \return The mutex of the engine
+        public: virtual std::shared_mutex &EngineEntityChangeMutex(
+            const Identity &_engineID) = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief AsyncForwardStepFeature steps a world on a thread owned by the
+    /// engine, so the caller can render and compute the controls of one step
+    /// while the next one is simulated. The outputs are double buffered: a
+    /// step writes to a back buffer, which becomes the front buffer when the
+    /// caller finishes the step.
+    ///
+    /// While a step is in flight, the entities of the engine must not be
+    /// used, and no other function of the engine may be called, except for
+    /// the functions of this feature. The front buffer may be read.
+    class AsyncForwardStepFeature
+      : public virtual FeatureWithRequirements<ForwardStep>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Start a step of this world on an engine thread, as if
+        /// Step had been called with the same input and an empty state. If
+        /// a step of this world is still in flight, it is finished first.
+        /// Steps in flight in other worlds of the engine are waited for.
+        /// \param[in] _u Input of the step. It is copied, so it can be
+        /// changed as soon as this returns.
+        /// \return Fence that becomes ready when the step completed. It
+        /// does not make the output of the step readable, see FinishStep.
+        public: std::shared_future<void> StepAsync(
+            const ForwardStep::Input &_u)
+        {
+          return this->template Interface<AsyncForwardStepFeature>()
+              ->StartWorldStep(this->identity, _u);
+        }
+
+        /// \brief Wait for the step in flight, if there is one, and swap
+        /// the output buffers.
+        /// \return Output of the last finished step. It stays valid until
+        /// the next step of this world is finished.
+        public: const ForwardStep::Output &FinishStep()
+        {
+          return this->template Interface<AsyncForwardStepFeature>()
+              ->FinishWorldStep(this->identity);
+        }
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual std::shared_future<void> StartWorldStep(
+            const Identity &_worldID,
+            const ForwardStep::Input &_u) = 0;
+
+        public: virtual const ForwardStep::Output &FinishWorldStep(
+            const Identity &_worldID) = 0;
+
+        /// \brief Helper for implementations. Runs the steps of one world
+        /// on a thread of its own and holds the double buffered output.
+        public: class AsyncStepper
+        {
+          /// \brief Takes a step of the world, like WorldForwardStep.
+          public: using StepFunction = std::function<void(
+              ForwardStep::Output &, ForwardStep::State &,
+              const ForwardStep::Input &)>;
+
+          /// \brief Constructor. The thread is started by the first step.
+          /// \param[in] _step Takes a step of the world.
+          public: explicit AsyncStepper(StepFunction _step)
+            : step(std::move(_step))
+          {
+          }
+
+          /// \brief Destructor. Waits for the step in flight.
+          public: ~AsyncStepper()
+          {
+            {
+              std::unique_lock<std::mutex> lock(this->mutex);
+              this->idle.wait(lock, [this]() { return !this->running; });
+              this->stop = true;
+            }
+            this->wake.notify_one();
+            if (this->worker.joinable())
+              this->worker.join();
+          }
+
+          public: AsyncStepper(const AsyncStepper &) = delete;
+          public: AsyncStepper &operator=(const AsyncStepper &) = delete;
+
+          /// \brief Start a step, finishing the one in flight first.
+          /// \param[in] _u Input of the step.
+          /// \return Fence of the step.
+          public: std::shared_future<void> Start(
+              const ForwardStep::Input &_u)
+          {
+            this->Finish();
+            this->input = _u;
+            this->done = std::promise<void>();
+            this->fence = this->done.get_future().share();
+            if (!this->worker.joinable())
+              this->worker = std::thread([this]() { this->Run(); });
+            {
+              std::lock_guard<std::mutex> lock(this->mutex);
+              this->running = true;
+              this->unfinished = true;
+            }
+            this->wake.notify_one();
+            return this->fence;
+          }
+
+          /// \brief Wait for the step in flight without swapping buffers.
+          public: void Wait()
+          {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->idle.wait(lock, [this]() { return !this->running; });
+          }
+
+          /// \brief Wait for the step in flight and swap the buffers.
+          /// \return The front buffer.
+          public: const ForwardStep::Output &Finish()
+          {
+            this->Wait();
+            if (this->unfinished)
+            {
+              std::swap(this->front, this->back);
+              this->unfinished = false;
+            }
+            return this->front;
+          }
+
+          /// \brief Loop of the thread
+          private: void Run()
+          {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            while (true)
+            {
+              this->wake.wait(lock,
+                  [this]() { return this->running || this->stop; });
+              if (this->stop)
+                return;
+
+              lock.unlock();
+              this->state = ForwardStep::State();
+              this->step(this->back, this->state, this->input);
+              this->done.set_value();
+              lock.lock();
+              this->running = false;
+              this->idle.notify_all();
+            }
+          }
+
+          private: StepFunction step;
+          private: ForwardStep::Input input;
+          private: ForwardStep::State state;
+          private: ForwardStep::Output front;
+          private: ForwardStep::Output back;
+          private: std::promise<void> done;
+          private: std::shared_future<void> fence;
+          private: std::mutex mutex;
+          private: std::condition_variable wake;
+          private: std::condition_variable idle;
+          /// \brief True while the thread takes a step
+          private: bool running = false;
+          /// \brief True if back holds a step that was not finished yet
+          private: bool unfinished = false;
+          private: bool stop = false;
+          private: std::thread worker;
+        };
+
+        /// \brief Helper for implementations. Holds the AsyncStepper of
+        /// every world stepped through this feature, so StartWorldStep and
+        /// FinishWorldStep only need to forward to Start and Finish. It
+        /// should be declared after the other members of the plugin, so the
+        /// steps in flight finish before those members are destroyed.
+        public: class AsyncSteppers
+        {
+          /// \brief Takes a step of a world, like WorldForwardStep.
+          public: using WorldStepFunction = std::function<void(
+              const Identity &, ForwardStep::Output &, ForwardStep::State &,
+              const ForwardStep::Input &)>;
+
+          /// \brief Constructor
+          /// \param[in] _step Takes a step of a world.
+          public: explicit AsyncSteppers(WorldStepFunction _step)
+            : step(std::move(_step))
+          {
+          }
+
+          /// \brief Start a step of a world, like StartWorldStep.
+          /// \param[in] _worldID Identity of the world.
+          /// \param[in] _u Input of the step.
+          /// \return Fence of the step.
+          public: std::shared_future<void> Start(
+              const Identity &_worldID, const ForwardStep::Input &_u)
+          {
+            // Steps of different worlds share the state of the plugin, so
+            // only one of them runs at a time.
+            for (auto &stepper : this->steppers)
+              stepper.second->Wait();
+
+            auto &stepper = this->steppers[_worldID.id];
+            if (!stepper)
+            {
+              stepper = std::make_unique<AsyncStepper>(
+                  [this, _worldID](ForwardStep::Output &_h,
+                                   ForwardStep::State &_x,
+                                   const ForwardStep::Input &_input)
+                  {
+                    this->step(_worldID, _h, _x, _input);
+                  });
+            }
+            return stepper->Start(_u);
+          }
+
+          /// \brief Finish the step of a world, like FinishWorldStep.
+          /// \param[in] _worldID Identity of the world.
+          /// \return Output of the last finished step of the world, or an
+          /// empty output if the world was never stepped asynchronously.
+          public: const ForwardStep::Output &Finish(const Identity &_worldID)
+          {
+            const auto it = this->steppers.find(_worldID.id);
+            if (it == this->steppers.end())
+              return this->empty;
+            return it->second->Finish();
+          }
+
+          private: WorldStepFunction step;
+          private: ForwardStep::Output empty;
+          private: std::unordered_map<
+              std::size_t, std::unique_ptr<AsyncStepper>> steppers;
+        };
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief PublishedWorldStateFeature publishes the poses and twists of
+    /// the links of a world at the end of every step, so that visualization,
+    /// logging or sensor threads can read them while the next step runs,
+    /// without waiting for it or calling into the engine.
+    class PublishedWorldStateFeature
+      : public virtual FeatureWithRequirements<ForwardStep>
+    {
+      /// \brief State of a world at the end of a step.
+      public: struct PublishedWorldState
+      {
+        /// \brief Simulation time of the world, in seconds
+        double time = 0.0;
+
+        /// \brief Number of steps the world has taken
+        std::size_t iteration = 0u;
+
+        /// \brief Poses of the links of the world
+        std::vector<WorldPose> poses;
+
+        /// \brief Velocities of the links of the world, in the same order
+        /// as poses
+        std::vector<WorldTwist> twists;
+      };
+
+      /// \brief Buffer that a world publishes its state to. It can be read
+      /// from any number of threads, at any time. A reader keeps the state
+      /// it read for as long as it holds it, and never makes the step that
+      /// publishes the next state wait.
+      public: class PublishedWorldStateBuffer
+      {
+        /// \brief Get the last published state.
+        /// \return The state, or nullptr if none was published yet.
+        public: std::shared_ptr<const PublishedWorldState> Read() const
+        {
+          return std::atomic_load(&this->latest);
+        }
+
+        /// \brief Get a state for the engine to fill in and publish. States
+        /// that readers do not hold any more are reused.
+        /// \return State to pass to Publish.
+        public: std::shared_ptr<PublishedWorldState> Prepare()
+        {
+          // Readers can only take new references through latest, so a state
+          // that is only referenced by free stays unused.
+          for (auto &state : this->free)
+          {
+            if (state.use_count() == 1)
+            {
+              // Order the reads of the last reader before the writes of the
+              // engine
+              std::atomic_thread_fence(std::memory_order_acquire);
+              return state;
+            }
+          }
+          return this->free.emplace_back(
+              std::make_shared<PublishedWorldState>());
+        }
+
+        /// \brief Publish a state returned by Prepare.
+        /// \param[in] _state The state
+        public: void Publish(
+            const std::shared_ptr<PublishedWorldState> &_state)
+        {
+          std::atomic_store(&this->latest,
+              std::shared_ptr<const PublishedWorldState>(_state));
+        }
+
+        /// \brief Last published state
+        private: std::shared_ptr<const PublishedWorldState> latest;
+
+        /// \brief States that were prepared. Only used by the engine.
+        private: std::vector<std::shared_ptr<PublishedWorldState>> free;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Get the buffer that this world publishes its state to at
+        /// the end of every step, and start publishing if it did not yet.
+        /// Call this between steps of the world, then read the buffer from
+        /// any thread.
+        /// \return The buffer. It stays valid after the world is removed.
+        public: std::shared_ptr<const PublishedWorldStateBuffer>
+        GetPublishedStateBuffer()
+        {
+          return this->template Interface<PublishedWorldStateFeature>()
+              ->GetWorldPublishedStateBuffer(this->identity);
+        }
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual std::shared_ptr<const PublishedWorldStateBuffer>
+        GetWorldPublishedStateBuffer(const Identity &_worldID) = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief PoseInterpolationFeature gives the poses of the links of a
+    /// world at times between and after its steps, so renderers can run at a
+    /// higher rate than the physics without stutter. Once it is used, the
+    /// engine keeps the link poses of the last two steps of the world as
+    /// they are written out, and computes the poses from them, without
+    /// reading the kinematics of the world.
+    class PoseInterpolationFeature
+      : public virtual FeatureWithRequirements<ForwardStep>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Get the poses of the links of this world at a time
+        /// relative to its last step, and start keeping the poses of its
+        /// steps if it did not yet. The first call gives no poses until the
+        /// world finished a step, and links without a pose at the step
+        /// before the last one keep their pose of the last step. This may be
+        /// called from any thread, also while the world is stepped, e.g.
+        /// through AsyncForwardStepFeature.
+        /// \param[in] _fraction Time since the last step, as a fraction of
+        /// the duration of that step. 0 gives the poses of the last step and
+        /// -1 those of the step before it, values in between interpolate
+        /// them, and positive values extrapolate the motion of the last
+        /// step. Values below -1 are clamped to -1.
+        /// \param[out] _poses Poses of the links of the world, in the order
+        /// they were written at the last step.
+        public: void GetInterpolatedPoses(
+            double _fraction, std::vector<WorldPose> &_poses) const
+        {
+          this->template Interface<PoseInterpolationFeature>()
+              ->GetWorldInterpolatedPoses(this->identity, _fraction, _poses);
+        }
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual void GetWorldInterpolatedPoses(
+            const Identity &_worldID,
+            double _fraction,
+            std::vector<WorldPose> &_poses) const = 0;
+
+        /// \brief Helper for implementations. Interpolate or extrapolate the
+        /// poses of two consecutive steps, with the positions moving along a
+        /// line and the rotations along a great arc.
+        /// \param[in] _previous Poses of the step before the last one. Links
+        /// that are missing from it keep their pose of the last step.
+        /// \param[in] _current Poses of the last step.
+        /// \param[in] _fraction See World::GetInterpolatedPoses.
+        /// \param[out] _poses Interpolated poses, in the order of _current.
+        public: static void InterpolatePoses(
+            const std::vector<WorldPose> &_previous,
+            const std::vector<WorldPose> &_current,
+            double _fraction,
+            std::vector<WorldPose> &_poses)
+        {
+          const double t = 1.0 + std::max(_fraction, -1.0);
+          _poses.resize(_current.size());
+
+          // Links are usually written in the same order at every step, so
+          // the previous pose of a link is looked for at its index first.
+          std::size_t hint = 0u;
+          for (std::size_t i = 0; i < _current.size(); ++i)
+          {
+            const WorldPose &current = _current[i];
+            _poses[i] = current;
+
+            if (hint >= _previous.size() ||
+                _previous[hint].body != current.body)
+            {
+              hint = static_cast<std::size_t>(std::find_if(
+                  _previous.begin(), _previous.end(),
+                  [&current](const WorldPose &_p)
+                  {
+                    return _p.body == current.body;
+                  }) - _previous.begin());
+              if (hint == _previous.size())
+                continue;
+            }
+
+            const gz::math::Pose3d &p0 = _previous[hint].pose;
+            const gz::math::Pose3d &p1 = current.pose;
+            _poses[i].pose.Set(
+                p0.Pos() + (p1.Pos() - p0.Pos()) * t,
+                gz::math::Quaterniond::Slerp(t, p0.Rot(), p1.Rot(), true));
+            ++hint;
+          }
+        }
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief ParallelPoseWriteFeature lets the plugin compare and convert
+    /// the link poses written to ChangedWorldPoses after a step on several
+    /// threads. Each thread writes the poses of a contiguous range of links
+    /// to its own buffer, and the buffers are appended in order, so the
+    /// output is the same as with a single thread.
+    class ParallelPoseWriteFeature
+      : public virtual FeatureWithRequirements<ForwardStep>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Set the number of threads used to write the changed link
+        /// poses of a step.
+        /// \param[in] _numThreads Number of threads. A value of 0 uses one
+        /// thread per core, 1 (default) writes the poses on the calling
+        /// thread.
+        /// \param[in] _minLinks The poses are only written in parallel when
+        /// the engine has at least this many links, below which starting
+        /// the threads costs more than it saves.
+        public: void SetPoseWriteThreads(
+            std::size_t _numThreads, std::size_t _minLinks = 4096u)
+        {
+          this->template Interface<ParallelPoseWriteFeature>()
+              ->SetEnginePoseWriteThreads(
+                  this->identity, _numThreads, _minLinks);
+        }
+
+        /// \brief Get the number of threads used to write the changed link
+        /// poses of a step.
+        /// \return Number of threads, 0 for one thread per core.
+        public: std::size_t GetPoseWriteThreads() const
+        {
+          return this->template Interface<ParallelPoseWriteFeature>()
+              ->GetEnginePoseWriteThreads(this->identity);
+        }
+
+        /// \brief Get the number of links from which the poses are written
+        /// in parallel.
+        /// \return Minimum number of links.
+        public: std::size_t GetPoseWriteMinLinks() const
+        {
+          return this->template Interface<ParallelPoseWriteFeature>()
+              ->GetEnginePoseWriteMinLinks(this->identity);
+        }
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual void SetEnginePoseWriteThreads(
+            const Identity &_engineID,
+            std::size_t _numThreads,
+            std::size_t _minLinks) = 0;
+
+        public: virtual std::size_t GetEnginePoseWriteThreads(
+            const Identity &_engineID) const = 0;
+
+        public: virtual std::size_t GetEnginePoseWriteMinLinks(
+            const Identity &_engineID) const = 0;
+
+        /// \brief Helper for implementations. Split [0, _count) into
+        /// _chunks contiguous ranges and call _write(_begin, _end, _buffer)
+        /// for each of them with a buffer of its own, then append the
+        /// buffers to _entries in the order of the ranges.
+        /// \param[in] _count Number of items to write.
+        /// \param[in] _chunks Number of ranges.
+        /// \param[in,out] _buffers Buffers reused across calls.
+        /// \param[out] _entries Output that the buffers are appended to.
+        /// \param[in] _run Called with one task per range. It must run all
+        /// of them, possibly in parallel, and return once they finished.
+        /// \param[in] _write Writes the poses of a range to a buffer. Calls
+        /// for different ranges must not share mutable state.
+        public: template <typename RunT, typename WriteT>
+        static void WritePosesInChunks(
+            std::size_t _count,
+            std::size_t _chunks,
+            std::vector<std::vector<WorldPose>> &_buffers,
+            std::vector<WorldPose> &_entries,
+            RunT &&_run,
+            WriteT &&_write)
+        {
+          std::vector<std::function<void()>> tasks;
+          WritePosesInChunks(_count, _chunks, _buffers, tasks, _entries,
+              std::forward<RunT>(_run), std::forward<WriteT>(_write));
+        }
+
+        /// \brief Same as above, but the tasks handed to _run are kept in
+        /// _tasks, which are reused across calls. Once the buffers and
+        /// _tasks have grown to the number of ranges, and _entries has the
+        /// capacity for all the poses, this does not allocate.
+        /// \param[in] _count Number of items to write.
+        /// \param[in] _chunks Number of ranges.
+        /// \param[in,out] _buffers Buffers reused across calls.
+        /// \param[in,out] _tasks Tasks reused across calls.
+        /// \param[out] _entries Output that the buffers are appended to.
+        /// \param[in] _run Called with one task per range. It must run all
+        /// of them, possibly in parallel, and return once they finished.
+        /// \param[in] _write Writes the poses of a range to a buffer. Calls
+        /// for different ranges must not share mutable state.
+        public: template <typename RunT, typename WriteT>
+        static void WritePosesInChunks(
+            std::size_t _count,
+            std::size_t _chunks,
+            std::vector<std::vector<WorldPose>> &_buffers,
+            std::vector<std::function<void()>> &_tasks,
+            std::vector<WorldPose> &_entries,
+            RunT &&_run,
+            WriteT &&_write)
+        {
+          _chunks = std::max<std::size_t>(1u, std::min(_chunks, _count));
+          _buffers.resize(_chunks);
+
+          // The tasks only capture a pointer and an index, which
+          // std::function stores without allocating.
+          struct Ranges
+          {
+            std::remove_reference_t<WriteT> *write;
+            std::vector<std::vector<WorldPose>> *buffers;
+            std::size_t count;
+            std::size_t chunkSize;
+          };
+          const Ranges ranges{&_write, &_buffers, _count,
+                              (_count + _chunks - 1u) / _chunks};
+
+          _tasks.clear();
+          for (std::size_t i = 0; i < _chunks; ++i)
+          {
+            _buffers[i].clear();
+            _tasks.emplace_back([r = &ranges, i]()
+            {
+              const std::size_t begin = std::min(i * r->chunkSize, r->count);
+              const std::size_t end = std::min(begin + r->chunkSize, r->count);
+              (*r->write)(begin, end, (*r->buffers)[i]);
+            });
+          }
+          _run(_tasks);
+          _tasks.clear();
+
+          for (const auto &buffer : _buffers)
+            _entries.insert(_entries.end(), buffer.begin(), buffer.end());
+        }
+
+        /// \brief Helper for implementations. Holds the settings given to
+        /// SetEnginePoseWriteThreads along with the threads, buffers and
+        /// tasks of the parallel write-out, so the functions of the feature
+        /// only need to forward to Set, GetThreads and GetMinLinks.
+        public: class PoseWriter
+        {
+          /// \brief Apply the settings of SetEnginePoseWriteThreads.
+          /// \param[in] _numThreads Number of threads, 0 for one per core.
+          /// \param[in] _minLinks Number of links from which the poses are
+          /// written in parallel.
+          public: void Set(std::size_t _numThreads, std::size_t _minLinks)
+          {
+            this->threads = _numThreads;
+            this->minLinks = _minLinks;
+            this->chunks = _numThreads == 0u ?
+                std::max(1u, std::thread::hardware_concurrency()) :
+                _numThreads;
+
+            // The pool is created, or replaced, on the first parallel write
+            // without a task scheduler
+            this->pool.reset();
+          }
+
+          /// \brief Get the number of threads given to Set.
+          /// \return Number of threads, 0 for one per core.
+          public: std::size_t GetThreads() const
+          {
+            return this->threads;
+          }
+
+          /// \brief Get the number of links given to Set.
+          /// \return Number of links from which the poses are written in
+          /// parallel.
+          public: std::size_t GetMinLinks() const
+          {
+            return this->minLinks;
+          }
+
+          /// \brief Get whether the poses of a number of links are written
+          /// in parallel.
+          /// \param[in] _count Number of links.
+          /// \return True if Write should be used for them.
+          public: bool IsParallel(std::size_t _count) const
+          {
+            return this->chunks > 1u && _count >= this->minLinks;
+          }
+
+          /// \brief Release the threads of the write-out, e.g. once the
+          /// engine is given a task scheduler.
+          public: void ReleasePool()
+          {
+            this->pool.reset();
+          }
+
+          /// \brief Write the poses of [0, _count) in chunks, one per
+          /// thread, like WritePosesInChunks.
+          /// \param[in] _count Number of items to write.
+          /// \param[in] _scheduler Scheduler to run the chunks on. If it is
+          /// null they run on threads of the writer.
+          /// \param[out] _entries Output that the poses are appended to.
+          /// \param[in] _write Writes the poses of a range to a buffer.
+          public: template <typename WriteT>
+          void Write(
+              std::size_t _count,
+              TaskScheduler *_scheduler,
+              std::vector<WorldPose> &_entries,
+              WriteT &&_write)
+          {
+            WritePosesInChunks(_count, this->chunks, this->buffers,
+                this->tasks, _entries,
+                [this, _scheduler](std::vector<std::function<void()>> &_tasks)
+                {
+                  TaskScheduler *scheduler = _scheduler;
+                  if (!scheduler)
+                  {
+                    if (!this->pool)
+                    {
+                      this->pool =
+                          std::make_unique<ThreadPoolTaskScheduler>(
+                              this->chunks);
+                    }
+                    scheduler = this->pool.get();
+                  }
+                  scheduler->Run(_tasks.size(),
+                      [&_tasks](std::size_t _i) { _tasks[_i](); });
+                },
+                std::forward<WriteT>(_write));
+          }
+
+          private: std::size_t threads = 1u;
+          private: std::size_t minLinks = 4096u;
+          private: std::size_t chunks = 1u;
+          private: std::unique_ptr<ThreadPoolTaskScheduler> pool;
+          private: std::vector<std::vector<WorldPose>> buffers;
+          private: std::vector<std::function<void()>> tasks;
+        };
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief DeterministicStepFeature makes repeated runs of the same build
+    /// with the same inputs produce bit identical results, whatever the
+    /// number of threads the engine and its worlds are set to use. Parallel
+    /// work is split into fixed partitions whose results are combined in a
+    /// fixed order, links are visited in a fixed order, and the contacts of
+    /// the last step are sorted by the entity IDs of their collisions, then
+    /// by point. An engine may run parts of a step that it can not partition
+    /// this way on a single thread while the feature is enabled.
+    class DeterministicStepFeature
+      : public virtual FeatureWithRequirements<ForwardStep>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Set whether the worlds of the engine are stepped
+        /// deterministically.
+        /// \param[in] _deterministic True to step deterministically. The
+        /// default is false.
+        public: void SetDeterministic(bool _deterministic)
+        {
+          this->template Interface<DeterministicStepFeature>()
+              ->SetEngineDeterministic(this->identity, _deterministic);
+        }
+
+        /// \brief Get whether the worlds of the engine are stepped
+        /// deterministically.
+        /// \return True if they are.
+        public: bool GetDeterministic() const
+        {
+          return this->template Interface<DeterministicStepFeature>()
+              ->GetEngineDeterministic(this->identity);
+        }
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual void SetEngineDeterministic(
+            const Identity &_engineID, bool _deterministic) = 0;
+
+        public: virtual bool GetEngineDeterministic(
+            const Identity &_engineID) const = 0;
+      };
+    };
+
     // ---------------- SetState Interface -----------------
     // class SetState
     // {
@@ -194,6 +1161,8 @@ namespace gz
 
     //   public: virtual ~SetState() = default;
     // };
+
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(ForwardStep)
   }
 }
 
@@ -70,6 +70,42 @@ namespace gz
     };
     GZ_PHYSICS_MAKE_ALL_TYPE_COMBOS(FrameData)
 
+    /// \brief Flags which select the components of a FrameData that a query
+    /// needs, so an engine can skip computing the others. Flags can be
+    /// combined with the | operator.
+    enum FrameDataComponents : unsigned int
+    {
+      /// \brief FrameData::pose
+      FRAME_DATA_POSE = 1u << 0,
+
+      /// \brief FrameData::linearVelocity and FrameData::angularVelocity
+      FRAME_DATA_VELOCITY = 1u << 1,
+
+      /// \brief FrameData::linearAcceleration and
+      /// FrameData::angularAcceleration
+      FRAME_DATA_ACCELERATION = 1u << 2,
+
+      /// \brief Every component of FrameData
+      FRAME_DATA_ALL =
+          FRAME_DATA_POSE | FRAME_DATA_VELOCITY | FRAME_DATA_ACCELERATION
+    };
+
+    /// \brief Combine the flags of two sets of FrameData components.
+    constexpr FrameDataComponents operator|(
+        const FrameDataComponents _a, const FrameDataComponents _b)
+    {
+      return static_cast<FrameDataComponents>(
+          static_cast<unsigned int>(_a) | static_cast<unsigned int>(_b));
+    }
+
+    /// \brief Convert FrameData to another scalar type, e.g. from
+    /// FrameData3d to FrameData3f.
+    /// \param[in] _data FrameData to convert
+    /// \return _data with each of its values cast to ToScalar
+    template <typename ToScalar, typename FromScalar, std::size_t Dim>
+    FrameData<ToScalar, Dim> CastFrameData(
+        const FrameData<FromScalar, Dim> &_data);
+
     template <typename Scalar, std::size_t Dim>
     std::ostream& operator <<(std::ostream& stream,
                               const FrameData<Scalar, Dim> &_frame)
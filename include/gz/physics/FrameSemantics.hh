@@ -18,9 +18,14 @@
 #ifndef GZ_PHYSICS_FRAMESEMANTICS_HH_
 #define GZ_PHYSICS_FRAMESEMANTICS_HH_
 
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <gz/physics/Feature.hh>
+#include <gz/physics/FeatureList.hh>
 #include <gz/physics/Entity.hh>
 #include <gz/physics/FrameID.hh>
 #include <gz/physics/FrameData.hh>
@@ -83,6 +88,36 @@ namespace gz
           const RQ &_quantity,
           const FrameID &_relativeTo = FrameID::World()) const;
 
+        /// \brief Resolve many quantities at once. This gives the same values
+        /// as resolving each quantity on its own, but the frames are only
+        /// looked up once for each run of consecutive quantities which share a
+        /// parent frame, and the points or free vectors of such a run are
+        /// transformed together, as the columns of one matrix.
+        /// \param[in] _quantities Quantities to resolve
+        /// \param[in] _count Number of quantities
+        /// \param[out] _resolved Array of _count values to write the resolved
+        /// quantities to
+        /// \param[in] _relativeTo Frame to resolve the quantities relative to
+        /// \param[in] _inCoordinatesOf Frame whose coordinates the resolved
+        /// quantities are expressed in
+        public: template <typename RQ>
+        void Resolve(
+          const RQ *_quantities,
+          std::size_t _count,
+          typename RQ::Quantity *_resolved,
+          const FrameID &_relativeTo,
+          const FrameID &_inCoordinatesOf) const;
+
+        /// \brief Same as the overload above, using the frame specified for
+        /// relativeTo, the World Frame by default, as the frame for
+        /// inCoordinatesOf.
+        public: template <typename RQ>
+        void Resolve(
+          const RQ *_quantities,
+          std::size_t _count,
+          typename RQ::Quantity *_resolved,
+          const FrameID &_relativeTo = FrameID::World()) const;
+
         /// \brief Create a new RelativeQuantity which expresses the input
         /// quantity in terms of a new parent frame. Note that the returned
         /// RelativeQuantity will behave as though it has a constant value
@@ -108,6 +143,17 @@ namespace gz
         /// \brief Get the FrameData of this object with respect to the world.
         public: FrameData FrameDataRelativeToWorld() const;
 
+        /// \brief Get some components of the FrameData of this object with
+        /// respect to the world. This is cheaper than the overload above when
+        /// only a pose is needed, since the engine may skip computing the
+        /// velocities and accelerations.
+        /// \param[in] _components
+        ///   Components to compute. The others are left with unspecified
+        ///   values.
+        /// \return The FrameData of this object.
+        public: FrameData FrameDataRelativeToWorld(
+          FrameDataComponents _components) const;
+
         /// \brief Get the FrameData of this object with respect to another
         /// frame. The data will also be expressed in the coordinates of the
         /// _relativeTo frame.
@@ -144,6 +190,22 @@ namespace gz
         public: virtual FrameData FrameDataRelativeToWorld(
           const FrameID &_id) const = 0;
 
+        /// \brief Get some components of the FrameData of the specified frame
+        /// with respect to the WorldFrame. Resolve only asks for the
+        /// components that its quantity needs, e.g. the pose alone for
+        /// points, vectors and poses.
+        ///
+        /// The default implementation returns FrameDataRelativeToWorld(_id).
+        /// Engines can override it to skip computing the components that are
+        /// not requested.
+        /// \param[in] _id
+        ///   The frame to read.
+        /// \param[in] _components
+        ///   Components to compute. The others may be left with any value.
+        /// \return The FrameData of the frame.
+        public: virtual FrameData PartialFrameDataRelativeToWorld(
+          const FrameID &_id, FrameDataComponents _components) const;
+
         /// \brief Physics engines can use this function to generate a FrameID
         /// using an existing Identity.
         ///
@@ -215,6 +277,259 @@ namespace gz
       public: template <typename Policy, typename Features>
       using Engine = FrameSemantics::Engine<Policy, Features>;
     };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature reads the FrameData of many frames relative to the
+    /// world in a single call. Engines can resolve each frame once and share
+    /// the kinematic traversal of a model between all of its frames, which is
+    /// much cheaper than calling FrameDataRelativeToWorld once per frame.
+    class GZ_PHYSICS_VISIBLE BatchFrameSemantics
+        : public virtual FeatureWithRequirements<FrameSemantics>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        public: using FrameData =
+          gz::physics::FrameData<typename PolicyT::Scalar, PolicyT::Dim>;
+
+        /// \brief Get the FrameData of several frames with respect to the
+        /// world.
+        /// \param[in] _ids
+        ///   Pointer to the first of _count frame IDs.
+        /// \param[in] _count
+        ///   Number of frames to read.
+        /// \param[out] _output
+        ///   Pointer to the first of _count FrameData. Element i receives the
+        ///   FrameData of _ids[i].
+        public: void BatchFrameDataRelativeToWorld(
+          const FrameID *_ids,
+          std::size_t _count,
+          FrameData *_output) const;
+
+        /// \brief Get the FrameData of several frames with respect to the
+        /// world.
+        /// \param[in] _ids
+        ///   IDs of the frames to read.
+        /// \param[out] _output
+        ///   Resized to the size of _ids. Element i receives the FrameData
+        ///   of _ids[i].
+        public: void BatchFrameDataRelativeToWorld(
+          const std::vector<FrameID> &_ids,
+          std::vector<FrameData> &_output) const;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using FrameData =
+          gz::physics::FrameData<typename PolicyT::Scalar, PolicyT::Dim>;
+
+        /// \brief Get the FrameData of every link of this model with respect
+        /// to the world.
+        /// \param[out] _output
+        ///   Resized to the number of links in this model. Element i receives
+        ///   the FrameData of the link with index i.
+        public: void LinkFrameDataRelativeToWorld(
+          std::vector<FrameData> &_output) const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using FrameData =
+          gz::physics::FrameData<typename PolicyT::Scalar, PolicyT::Dim>;
+
+        /// \brief Fill _output[i] with the FrameData of _ids[i] with respect
+        /// to the world, for every i less than _count.
+        public: virtual void BatchFrameDataRelativeToWorld(
+          const FrameID *_ids,
+          std::size_t _count,
+          FrameData *_output) const = 0;
+
+        /// \brief Resize _output to the number of links in the model and
+        /// fill it with the FrameData of each link with respect to the world,
+        /// in link index order.
+        public: virtual void LinkFrameDataRelativeToWorld(
+          const Identity &_modelID,
+          std::vector<FrameData> &_output) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature reads the FrameData of many frames relative to the
+    /// world in single precision, whatever the precision of the engine. The
+    /// engine converts each value while it reads it, so clients that store
+    /// poses and velocities as float, e.g. as observations for learning,
+    /// neither need a FeaturePolicy3f plugin nor a conversion pass over a
+    /// double precision batch.
+    class GZ_PHYSICS_VISIBLE BatchFloatFrameSemantics
+        : public virtual FeatureWithRequirements<BatchFrameSemantics>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        public: using FloatFrameData =
+          gz::physics::FrameData<float, PolicyT::Dim>;
+
+        /// \brief Get the FrameData of several frames with respect to the
+        /// world, in single precision.
+        /// \param[in] _ids
+        ///   Pointer to the first of _count frame IDs.
+        /// \param[in] _count
+        ///   Number of frames to read.
+        /// \param[out] _output
+        ///   Pointer to the first of _count FloatFrameData. Element i
+        ///   receives the FrameData of _ids[i].
+        public: void BatchFloatFrameDataRelativeToWorld(
+          const FrameID *_ids,
+          std::size_t _count,
+          FloatFrameData *_output) const;
+
+        /// \brief Get the FrameData of several frames with respect to the
+        /// world, in single precision.
+        /// \param[in] _ids
+        ///   IDs of the frames to read.
+        /// \param[out] _output
+        ///   Resized to the size of _ids. Element i receives the FrameData
+        ///   of _ids[i].
+        public: void BatchFloatFrameDataRelativeToWorld(
+          const std::vector<FrameID> &_ids,
+          std::vector<FloatFrameData> &_output) const;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using FloatFrameData =
+          gz::physics::FrameData<float, PolicyT::Dim>;
+
+        /// \brief Get the FrameData of every link of this model with respect
+        /// to the world, in single precision.
+        /// \param[out] _output
+        ///   Resized to the number of links in this model. Element i receives
+        ///   the FrameData of the link with index i.
+        public: void LinkFloatFrameDataRelativeToWorld(
+          std::vector<FloatFrameData> &_output) const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using FloatFrameData =
+          gz::physics::FrameData<float, PolicyT::Dim>;
+
+        /// \brief Fill _output[i] with the FrameData of _ids[i] with respect
+        /// to the world, for every i less than _count.
+        public: virtual void BatchFloatFrameDataRelativeToWorld(
+          const FrameID *_ids,
+          std::size_t _count,
+          FloatFrameData *_output) const = 0;
+
+        /// \brief Resize _output to the number of links in the model and
+        /// fill it with the FrameData of each link with respect to the world,
+        /// in link index order.
+        public: virtual void LinkFloatFrameDataRelativeToWorld(
+          const Identity &_modelID,
+          std::vector<FloatFrameData> &_output) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature lets the user turn on a cache for the FrameData
+    /// that an engine computes relative to the world. While the cache is
+    /// enabled, repeated queries of the same frame, including the ones made
+    /// by each call to Resolve, are answered from memory until the engine
+    /// state changes, e.g. when the world is stepped or a joint position or
+    /// free group pose is set.
+    ///
+    /// The cache is disabled by default.
+    class GZ_PHYSICS_VISIBLE SetFrameDataCacheFeature
+        : public virtual FeatureWithRequirements<FrameSemantics>
+    {
+      /// \brief Storage for cached FrameData that an implementation can use.
+      /// Invalidating the cache is constant time, so it can be done every
+      /// time the engine state changes. Every member function is guarded by
+      /// a mutex, so the worlds of an engine can share one cache while they
+      /// are stepped concurrently.
+      public: template <typename PolicyT>
+      class FrameDataCache
+      {
+        public: using FrameData =
+          gz::physics::FrameData<typename PolicyT::Scalar, PolicyT::Dim>;
+
+        /// \brief Enable or disable the cache. Disabling it drops every
+        /// cached entry.
+        /// \param[in] _enabled True to enable the cache.
+        public: void SetEnabled(bool _enabled);
+
+        /// \brief Check whether the cache is enabled.
+        /// \return True if the cache is enabled.
+        public: bool Enabled() const;
+
+        /// \brief Mark every cached entry as stale. This does not touch the
+        /// cache if it is disabled, since it holds no entries then.
+        public: void Invalidate();
+
+        /// \brief Find the cached FrameData of a frame. The entry is copied
+        /// out while the cache is locked, since another thread may overwrite
+        /// it as soon as the lock is released.
+        /// \param[in] _frameID ID of the frame.
+        /// \param[out] _data Set to the cached data if an entry was found.
+        /// \return True if the cache is enabled and the frame has a valid
+        /// entry.
+        public: bool Find(std::size_t _frameID, FrameData &_data) const;
+
+        /// \brief Store the FrameData of a frame. This does nothing if the
+        /// cache is disabled.
+        /// \param[in] _frameID ID of the frame.
+        /// \param[in] _data FrameData of the frame relative to the world.
+        public: void Insert(std::size_t _frameID, const FrameData &_data);
+
+        /// \brief A cached FrameData and the generation it was stored in.
+        private: struct Entry
+        {
+          std::size_t generation;
+          FrameData data;
+        };
+
+        /// \brief Whether the cache is enabled.
+        private: bool enabled = false;
+
+        /// \brief Entries stored before the last increment are stale.
+        private: std::size_t generation = 0u;
+
+        /// \brief Cached entries, keyed by frame ID.
+        private: std::unordered_map<std::size_t, Entry> entries;
+
+        /// \brief Guards every other member.
+        private: mutable std::mutex mutex;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Enable or disable the FrameData cache of this engine.
+        /// \param[in] _enabled True to enable the cache.
+        public: void SetFrameDataCacheEnabled(bool _enabled);
+
+        /// \brief Check whether the FrameData cache of this engine is
+        /// enabled.
+        /// \return True if the cache is enabled.
+        public: bool GetFrameDataCacheEnabled() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual void SetFrameDataCacheEnabled(
+          const Identity &_engineID, bool _enabled) = 0;
+
+        public: virtual bool GetFrameDataCacheEnabled(
+          const Identity &_engineID) const = 0;
+      };
+    };
+
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(FrameSemantics)
   }
 }
 
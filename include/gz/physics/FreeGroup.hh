@@ -18,6 +18,9 @@
 #ifndef GZ_PHYSICS_FREEGROUP_HH_
 #define GZ_PHYSICS_FREEGROUP_HH_
 
+#include <cstddef>
+#include <vector>
+
 #include <gz/physics/FeatureList.hh>
 #include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/Geometry.hh>
@@ -208,6 +211,79 @@ namespace gz
             const AngularVelocity &_angularVelocity) = 0;
       };
     };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature sets the poses and velocities of many FreeGroups
+    /// of a world in one call, e.g. to reset the objects of a scene between
+    /// episodes. Engines apply all of the states before they update their
+    /// kinematics and collision data, once, instead of after each FreeGroup.
+    class GZ_PHYSICS_VISIBLE SetFreeGroupWorldStates
+        : public virtual FeatureWithRequirements<FindFreeGroupFeature>
+    {
+      /// \brief State to give a FreeGroup.
+      public: template <typename PolicyT>
+      struct FreeGroupStateT
+      {
+        using PoseType = typename FromPolicy<PolicyT>::template Use<Pose>;
+        using LinearVelocity =
+            typename FromPolicy<PolicyT>::template Use<LinearVector>;
+        using AngularVelocity =
+            typename FromPolicy<PolicyT>::template Use<AngularVector>;
+
+        /// \brief Entity ID of the FreeGroup, see Entity::EntityID
+        std::size_t freeGroup = 0u;
+
+        /// \brief Pose of the root link of the FreeGroup in world frame
+        PoseType pose = PoseType::Identity();
+
+        /// \brief Linear velocity of the root link in world frame
+        LinearVelocity linearVelocity = LinearVelocity::Zero();
+
+        /// \brief Angular velocity of the FreeGroup in world frame
+        AngularVelocity angularVelocity = AngularVelocity::Zero();
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        public: using FreeGroupState = FreeGroupStateT<PolicyT>;
+
+        /// \brief Set the states of FreeGroups of this world. Each FreeGroup
+        /// moves rigidly with its root link, as if SetWorldPose,
+        /// SetWorldLinearVelocity and SetWorldAngularVelocity were called on
+        /// it in turn, except that the links of the FreeGroup are all given
+        /// the velocities of a rigid body moving with the root link.
+        /// FreeGroups that are not in this world are skipped.
+        /// \param[in] _states State of each FreeGroup
+        /// \param[in] _count Number of states
+        public: void SetFreeGroupStates(
+            const FreeGroupState *_states, std::size_t _count);
+
+        /// \brief Set the states of FreeGroups of this world.
+        /// \param[in] _states State of each FreeGroup
+        public: void SetFreeGroupStates(
+            const std::vector<FreeGroupState> &_states);
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using FreeGroupState = FreeGroupStateT<PolicyT>;
+
+        /// \brief Implementation API for SetFreeGroupStates
+        /// \param[in] _worldID Identity of the world
+        /// \param[in] _states State of each FreeGroup
+        /// \param[in] _count Number of states
+        public: virtual void SetWorldFreeGroupStates(
+            const Identity &_worldID,
+            const FreeGroupState *_states,
+            std::size_t _count) = 0;
+      };
+    };
+
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(FindFreeGroupFeature)
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(SetFreeGroupWorldPose)
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(SetFreeGroupWorldVelocity)
   }
 }
 
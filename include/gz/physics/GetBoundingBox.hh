@@ -18,6 +18,9 @@
 #ifndef GZ_PHYSICS_GETBOUNDINGBOX_HH_
 #define GZ_PHYSICS_GETBOUNDINGBOX_HH_
 
+#include <cstddef>
+#include <vector>
+
 #include <gz/physics/FeatureList.hh>
 #include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/GetEntities.hh>
@@ -96,6 +99,177 @@ namespace gz
       };
     };
 
+    /////////////////////////////////////////////////
+    /// \brief This feature retrieves the world frame axis aligned bounding
+    /// boxes of all the shapes in a world in one call. Plugins keep the
+    /// bounding box of each shape in its own frame, so a call only transforms
+    /// those boxes by the current poses of the shapes.
+    class GZ_PHYSICS_VISIBLE GetWorldShapeBoundingBoxes
+        : public virtual FeatureWithRequirements<GetShapeBoundingBox>
+    {
+      /// \brief Bounding boxes as parallel arrays. Element i of each array
+      /// belongs to shape i. The arrays are views into buffers owned by the
+      /// physics engine. They stay valid until the world is stepped or the
+      /// bounding boxes are requested again.
+      public: template <typename PolicyT>
+      struct ShapeBoundingBoxBatchT
+      {
+        using AlignedBoxType =
+            typename FromPolicy<PolicyT>::template Use<AlignedBox>;
+
+        /// \brief Number of shapes
+        std::size_t size = 0u;
+        /// \brief Entity ID of each shape
+        const std::size_t *shape = nullptr;
+        /// \brief Axis aligned bounding box of each shape in the world frame
+        const AlignedBoxType *box = nullptr;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        public: using ShapeBoundingBoxBatch = ShapeBoundingBoxBatchT<PolicyT>;
+
+        /// \brief Get the bounding boxes of all the shapes in this world,
+        /// expressed in the world frame.
+        /// \return Views of the bounding boxes.
+        public: ShapeBoundingBoxBatch GetShapeBoundingBoxes() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using AlignedBoxType =
+            typename FromPolicy<PolicyT>::template Use<AlignedBox>;
+        public: using PoseType =
+            typename FromPolicy<PolicyT>::template Use<Pose>;
+        public: using ShapeBoundingBoxBatch = ShapeBoundingBoxBatchT<PolicyT>;
+
+        /// \brief Buffers that an implementation can fill and return views
+        /// of.
+        public: struct ShapeBoundingBoxStorage
+        {
+          std::vector<std::size_t> shape;
+          std::vector<AlignedBoxType> box;
+
+          /// \brief Remove all boxes, keeping the allocated memory
+          void Clear();
+
+          /// \brief Add the bounding box of a shape.
+          /// \param[in] _shape Entity ID of the shape.
+          /// \param[in] _pose Pose of the shape in the world frame.
+          /// \param[in] _localBox Bounding box of the shape in its own frame.
+          void Add(std::size_t _shape, const PoseType &_pose,
+                   const AlignedBoxType &_localBox);
+
+          /// \brief Views of the buffers
+          ShapeBoundingBoxBatch View() const;
+        };
+
+        /// \brief Implementation API for getting the bounding boxes of all the
+        /// shapes in a world.
+        /// \param[in] _worldID Identity of the world.
+        /// \return Views of the bounding boxes in the world frame.
+        public: virtual ShapeBoundingBoxBatch GetWorldShapeBoundingBoxes(
+            const Identity &_worldID) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature retrieves the world frame axis aligned bounding
+    /// boxes of all the links, or all the models, of a world in one call.
+    /// The box of a link covers its shapes, and the box of a model covers
+    /// its links, like GetLinkBoundingBox and GetModelBoundingBox. Plugins
+    /// may take them from the boxes that their broadphase keeps, which can
+    /// be slightly larger than the shapes.
+    class GZ_PHYSICS_VISIBLE GetWorldLinkBoundingBoxes
+        : public virtual Feature
+    {
+      /// \brief Bounding boxes as parallel arrays. Element i of each array
+      /// belongs to entity i. The arrays are views into buffers owned by the
+      /// physics engine. They stay valid until the world is stepped or
+      /// bounding boxes are requested again.
+      public: template <typename PolicyT>
+      struct BoundingBoxBatchT
+      {
+        using AlignedBoxType =
+            typename FromPolicy<PolicyT>::template Use<AlignedBox>;
+
+        /// \brief Number of entities
+        std::size_t size = 0u;
+        /// \brief Entity ID of each link or model
+        const std::size_t *entity = nullptr;
+        /// \brief Axis aligned bounding box of each entity in the world frame
+        const AlignedBoxType *box = nullptr;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        public: using BoundingBoxBatch = BoundingBoxBatchT<PolicyT>;
+
+        /// \brief Get the bounding boxes of all the links in this world,
+        /// expressed in the world frame. Links without shapes are skipped.
+        /// \return Views of the bounding boxes.
+        public: BoundingBoxBatch GetLinkBoundingBoxes() const;
+
+        /// \brief Get the bounding boxes of all the models in this world,
+        /// expressed in the world frame. Models without shapes are skipped.
+        /// \return Views of the bounding boxes.
+        public: BoundingBoxBatch GetModelBoundingBoxes() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using AlignedBoxType =
+            typename FromPolicy<PolicyT>::template Use<AlignedBox>;
+        public: using PoseType =
+            typename FromPolicy<PolicyT>::template Use<Pose>;
+        public: using BoundingBoxBatch = BoundingBoxBatchT<PolicyT>;
+
+        /// \brief Buffers that an implementation can fill and return views
+        /// of.
+        public: struct BoundingBoxStorage
+        {
+          std::vector<std::size_t> entity;
+          std::vector<AlignedBoxType> box;
+
+          /// \brief Remove all boxes, keeping the allocated memory
+          void Clear();
+
+          /// \brief Add the bounding box of an entity.
+          /// \param[in] _entity Entity ID.
+          /// \param[in] _box Bounding box in the world frame.
+          void Add(std::size_t _entity, const AlignedBoxType &_box);
+
+          /// \brief Add the bounding box of an entity.
+          /// \param[in] _entity Entity ID.
+          /// \param[in] _pose Pose of the entity in the world frame.
+          /// \param[in] _localBox Bounding box in the frame of the entity.
+          void Add(std::size_t _entity, const PoseType &_pose,
+                   const AlignedBoxType &_localBox);
+
+          /// \brief Views of the buffers
+          BoundingBoxBatch View() const;
+        };
+
+        /// \brief Implementation API for getting the bounding boxes of all the
+        /// links in a world.
+        /// \param[in] _worldID Identity of the world.
+        /// \return Views of the bounding boxes in the world frame.
+        public: virtual BoundingBoxBatch GetWorldLinkBoundingBoxes(
+            const Identity &_worldID) const = 0;
+
+        /// \brief Implementation API for getting the bounding boxes of all the
+        /// models in a world.
+        /// \param[in] _worldID Identity of the world.
+        /// \return Views of the bounding boxes in the world frame.
+        public: virtual BoundingBoxBatch GetWorldModelBoundingBoxes(
+            const Identity &_worldID) const = 0;
+      };
+    };
+
     // see Shape.hh for GetShapeBoundingBox
   }
 }
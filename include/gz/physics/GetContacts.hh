@@ -18,6 +18,9 @@
 #ifndef GZ_PHYSICS_GETCONTACTS_HH_
 #define GZ_PHYSICS_GETCONTACTS_HH_
 
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 #include <gz/physics/FeatureList.hh>
 #include <gz/physics/ForwardStep.hh>
@@ -98,6 +101,360 @@ class GZ_PHYSICS_VISIBLE GetContactsFromLastStepFeature
 
     public: virtual std::vector<ContactInternal> GetContactsFromLastStep(
         const Identity &_worldID) const = 0;
+
+    /// \brief Helper for implementations. Sort contacts by the entity IDs
+    /// of their collisions, then by point, so that their order does not
+    /// depend on the order in which the engine found them. See
+    /// DeterministicStepFeature.
+    /// \param[in,out] _contacts Contacts to sort.
+    public: static void SortContacts(std::vector<ContactInternal> &_contacts);
+  };
+};
+
+/// \brief GetContactBatchFromLastStepFeature is a feature for retrieving the
+/// contacts generated in the previous simulation step as parallel arrays,
+/// without creating a CompositeData for each contact.
+class GZ_PHYSICS_VISIBLE GetContactBatchFromLastStepFeature
+    : public virtual FeatureWithRequirements<ForwardStep>
+{
+  /// \brief Contacts as parallel arrays. Element i of each array belongs to
+  /// contact i. The arrays are views into buffers owned by the physics
+  /// engine. They stay valid until the world is stepped or contacts are
+  /// requested again.
+  public: template <typename PolicyT>
+  struct ContactBatchT
+  {
+    using Scalar = typename PolicyT::Scalar;
+    using VectorType = typename FromPolicy<PolicyT>::template Use<Vector>;
+
+    /// \brief Number of contacts
+    std::size_t size = 0u;
+    /// \brief Entity ID of the collision shape of the first body
+    const std::size_t *collision1 = nullptr;
+    /// \brief Entity ID of the collision shape of the second body
+    const std::size_t *collision2 = nullptr;
+    /// \brief The point of contact expressed in the world frame
+    const VectorType *point = nullptr;
+    /// \brief The normal of the force acting on the first body expressed
+    /// in the world frame
+    const VectorType *normal = nullptr;
+    /// \brief The penetration depth
+    const Scalar *depth = nullptr;
+    /// \brief The contact force acting on the first body expressed in the
+    /// world frame
+    const VectorType *force = nullptr;
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using ContactBatch = ContactBatchT<PolicyT>;
+
+    /// \brief Get contacts generated in the previous simulation step
+    public: ContactBatch GetContactBatchFromLastStep() const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using Scalar = typename PolicyT::Scalar;
+    public: using VectorType =
+        typename FromPolicy<PolicyT>::template Use<Vector>;
+    public: using ContactBatch = ContactBatchT<PolicyT>;
+
+    /// \brief Buffers that an implementation can fill and return views of.
+    public: struct ContactBatchStorage
+    {
+      std::vector<std::size_t> collision1;
+      std::vector<std::size_t> collision2;
+      std::vector<VectorType> point;
+      std::vector<VectorType> normal;
+      std::vector<Scalar> depth;
+      std::vector<VectorType> force;
+
+      /// \brief Scratch buffer of Sort, kept to reuse its memory
+      std::vector<std::size_t> order;
+
+      /// \brief Remove all contacts, keeping the allocated memory
+      void Clear();
+
+      /// \brief Add a contact
+      void Add(std::size_t _collision1, std::size_t _collision2,
+               const VectorType &_point, const VectorType &_normal,
+               Scalar _depth, const VectorType &_force);
+
+      /// \brief Sort the contacts like
+      /// GetContactsFromLastStepFeature::Implementation::SortContacts. The
+      /// contacts are permuted in place, so this does not allocate once the
+      /// buffers have grown to the number of contacts.
+      void Sort();
+
+      /// \brief Views of the buffers
+      ContactBatch View() const;
+    };
+
+    public: virtual ContactBatch GetContactBatchFromLastStep(
+        const Identity &_worldID) const = 0;
+  };
+};
+
+/// \brief GetContactPairsFromLastStepFeature is a feature for retrieving the
+/// contacts generated in the previous simulation step grouped by the pair of
+/// collision shapes they are between, with a summary of each pair. Pairs and
+/// the contacts within them come sorted by the entity IDs of their
+/// collisions, then by point.
+class GZ_PHYSICS_VISIBLE GetContactPairsFromLastStepFeature
+    : public virtual FeatureWithRequirements<GetContactBatchFromLastStepFeature>
+{
+  /// \brief Contact pairs as parallel arrays. Element i of each array
+  /// belongs to pair i. The arrays are views into buffers owned by the
+  /// physics engine, with the same lifetime as a ContactBatch.
+  public: template <typename PolicyT>
+  struct ContactPairBatchT
+  {
+    using Scalar = typename PolicyT::Scalar;
+    using VectorType = typename FromPolicy<PolicyT>::template Use<Vector>;
+
+    /// \brief Number of pairs
+    std::size_t size = 0u;
+    /// \brief Entity ID of the collision shape of the first body
+    const std::size_t *collision1 = nullptr;
+    /// \brief Entity ID of the collision shape of the second body
+    const std::size_t *collision2 = nullptr;
+    /// \brief size + 1 offsets into contacts. The contacts of pair i are
+    /// [offset[i], offset[i+1]).
+    const std::size_t *offset = nullptr;
+    /// \brief Number of contacts of each pair
+    const std::size_t *count = nullptr;
+    /// \brief Sum of the contact forces acting on the first body, each
+    /// projected on the normal of its contact
+    const Scalar *normalForce = nullptr;
+    /// \brief Point of the deepest contact of each pair, expressed in the
+    /// world frame
+    const VectorType *deepestPoint = nullptr;
+    /// \brief Penetration depth of the deepest contact of each pair
+    const Scalar *maxDepth = nullptr;
+    /// \brief The contacts of all pairs, sorted
+    GetContactBatchFromLastStepFeature::ContactBatchT<PolicyT> contacts;
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using ContactPairBatch = ContactPairBatchT<PolicyT>;
+
+    /// \brief Get the contacts generated in the previous simulation step,
+    /// grouped by pair of collision shapes. This requests the contacts
+    /// again, so views returned by GetContactBatchFromLastStep before it
+    /// are no longer valid.
+    public: ContactPairBatch GetContactPairsFromLastStep() const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using Scalar = typename PolicyT::Scalar;
+    public: using VectorType =
+        typename FromPolicy<PolicyT>::template Use<Vector>;
+    public: using ContactBatch =
+        GetContactBatchFromLastStepFeature::ContactBatchT<PolicyT>;
+    public: using ContactPairBatch = ContactPairBatchT<PolicyT>;
+
+    /// \brief Buffers that an implementation can fill and return views of.
+    public: struct ContactPairStorage
+    {
+      std::vector<std::size_t> collision1;
+      std::vector<std::size_t> collision2;
+      std::vector<std::size_t> offset;
+      std::vector<std::size_t> count;
+      std::vector<Scalar> normalForce;
+      std::vector<VectorType> deepestPoint;
+      std::vector<Scalar> maxDepth;
+
+      /// \brief Group sorted contacts into pairs, replacing the pairs held
+      /// before and keeping the allocated memory.
+      /// \param[in] _sorted Contacts sorted by
+      /// GetContactBatchFromLastStepFeature's ContactBatchStorage::Sort. The
+      /// view returned by View refers to them.
+      void Build(const ContactBatch &_sorted);
+
+      /// \brief Views of the buffers
+      ContactPairBatch View() const;
+
+      /// \brief Contacts passed to the last call to Build
+      ContactBatch contacts;
+    };
+
+    public: virtual ContactPairBatch GetContactPairsFromLastStep(
+        const Identity &_worldID) const = 0;
+  };
+};
+
+/// \brief ContactFilterFeature limits the contacts that a world reports to
+/// those involving some entities, for callers that only watch a few sensor
+/// links. The engine drops the other contacts before converting them, so
+/// they cost little. The filter applies to GetContactsFromLastStep,
+/// GetContactBatchFromLastStep, GetContactPairsFromLastStep and
+/// GetContactEvents, for the features that the engine has.
+class GZ_PHYSICS_VISIBLE ContactFilterFeature
+    : public virtual FeatureWithRequirements<GetContactsFromLastStepFeature>
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    /// \brief Only report the contacts involving some entities. A contact
+    /// is reported if either of its collision shapes is one of them, or
+    /// belongs to a link or model that is one of them.
+    /// \param[in] _entities Entity IDs of collision shapes, links and
+    /// models. An empty list removes the filter.
+    public: void SetContactFilter(const std::vector<std::size_t> &_entities);
+
+    /// \brief Report all contacts again.
+    public: void ClearContactFilter();
+
+    /// \brief Get the entities that contacts are filtered by.
+    /// \return Entity IDs, sorted. Empty if contacts are not filtered.
+    public: std::vector<std::size_t> GetContactFilter() const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual void SetWorldContactFilter(
+        const Identity &_worldID,
+        const std::vector<std::size_t> &_entities) = 0;
+
+    public: virtual std::vector<std::size_t> GetWorldContactFilter(
+        const Identity &_worldID) const = 0;
+
+    /// \brief Helper for implementations. A set of entity IDs that can be
+    /// tested quickly.
+    public: class ContactFilter
+    {
+      /// \brief Constructor
+      /// \param[in] _entities Entity IDs, in any order.
+      public: explicit ContactFilter(std::vector<std::size_t> _entities);
+
+      /// \brief Check whether an entity is in the filter.
+      /// \param[in] _entity Entity ID.
+      /// \return True if it is.
+      public: bool Contains(std::size_t _entity) const;
+
+      /// \brief Get the entities of the filter.
+      /// \return Entity IDs, sorted and unique.
+      public: const std::vector<std::size_t> &Entities() const;
+
+      private: std::vector<std::size_t> entities;
+    };
+  };
+};
+/// \brief ContactEventsFeature reports the pairs of collision shapes that
+/// came into or went out of contact, instead of all the contacts of a step.
+/// Each pair in contact keeps the same ID from the event that begins it to
+/// the one that ends it, so callers such as bumpers or grasp detectors can
+/// keep their state by pair ID without comparing contact lists themselves.
+class GZ_PHYSICS_VISIBLE ContactEventsFeature
+    : public virtual FeatureWithRequirements<ForwardStep>
+{
+  /// \brief Transition of a pair of collision shapes
+  public: enum class EventType : uint8_t
+  {
+    /// \brief The shapes came into contact
+    BEGIN = 0,
+
+    /// \brief The shapes are no longer in contact
+    END = 1
+  };
+
+  /// \brief Contact events and the pairs in contact as parallel arrays.
+  /// Element i of each array belongs to event or pair i. Pairs are listed
+  /// with the smaller entity ID first, sorted by entity IDs. The arrays are
+  /// views into buffers owned by the physics engine. They stay valid until
+  /// events are requested again.
+  public: struct ContactEventBatch
+  {
+    /// \brief Number of events
+    std::size_t size = 0u;
+    /// \brief Entity ID of the first collision shape of each event
+    const std::size_t *collision1 = nullptr;
+    /// \brief Entity ID of the second collision shape of each event
+    const std::size_t *collision2 = nullptr;
+    /// \brief ID of the pair of each event
+    const std::size_t *pairId = nullptr;
+    /// \brief Whether each event begins or ends its pair
+    const EventType *type = nullptr;
+
+    /// \brief Number of pairs in contact, including the pairs that began
+    std::size_t activeSize = 0u;
+    /// \brief Entity ID of the first collision shape of each pair in contact
+    const std::size_t *activeCollision1 = nullptr;
+    /// \brief Entity ID of the second collision shape of each pair in
+    /// contact
+    const std::size_t *activeCollision2 = nullptr;
+    /// \brief ID of each pair in contact
+    const std::size_t *activePairId = nullptr;
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    /// \brief Get the pairs of collision shapes that came into or went out
+    /// of contact since the previous call for this world, or since the
+    /// world was created for the first call. A pair that both begins and
+    /// ends between two calls is not reported, so call this after each step
+    /// to see every transition.
+    /// \return Events and the pairs in contact after the last step
+    public: ContactEventBatch GetContactEvents() const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual ContactEventBatch GetContactEvents(
+        const Identity &_worldID) const = 0;
+
+    /// \brief Helper for implementations. Finds the events of a world from
+    /// the pairs of collision shapes in contact each time it is updated.
+    public: class ContactEventTracker
+    {
+      /// \brief Add a contact between two collision shapes. Contacts can be
+      /// added in any order, and more than once for the same pair.
+      /// \param[in] _collision1 Entity ID of the first collision shape
+      /// \param[in] _collision2 Entity ID of the second collision shape
+      public: void AddContact(std::size_t _collision1,
+                              std::size_t _collision2);
+
+      /// \brief Compare the pairs of the contacts added since the last
+      /// update with the pairs in contact before, and replace the events
+      /// with the transitions between them. The pairs are sorted once, so
+      /// this costs about as much as sorting the contacts.
+      public: void Update();
+
+      /// \brief Views of the events of the last update
+      public: ContactEventBatch View() const;
+
+      /// \brief Pairs of the contacts added since the last update
+      private: std::vector<std::pair<std::size_t, std::size_t>> added;
+
+      /// \brief Pairs in contact, sorted, as parallel arrays
+      private: std::vector<std::size_t> activeCollision1;
+      private: std::vector<std::size_t> activeCollision2;
+      private: std::vector<std::size_t> activePairId;
+
+      /// \brief Buffers of Update, swapped with the active pairs
+      private: std::vector<std::size_t> nextCollision1;
+      private: std::vector<std::size_t> nextCollision2;
+      private: std::vector<std::size_t> nextPairId;
+
+      /// \brief Events of the last update, as parallel arrays
+      private: std::vector<std::size_t> eventCollision1;
+      private: std::vector<std::size_t> eventCollision2;
+      private: std::vector<std::size_t> eventPairId;
+      private: std::vector<EventType> eventType;
+
+      /// \brief ID given to the next pair that comes into contact
+      private: std::size_t nextId = 0u;
+    };
   };
 };
 }
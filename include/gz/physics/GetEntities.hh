@@ -19,7 +19,9 @@
 #define GZ_PHYSICS_GETENTITIES_HH_
 
 #include <string>
+#include <vector>
 
+#include <gz/physics/EntityChangeJournal.hh>
 #include <gz/physics/FeatureList.hh>
 
 namespace gz
@@ -544,6 +546,125 @@ namespace gz
       };
     };
 
+    /////////////////////////////////////////////////
+    /// \brief This feature retrieves all the models of a world, or all the
+    /// links or joints of a model, in one call. Use it instead of calling
+    /// GetModel, GetLink or GetJoint with each index when enumerating the
+    /// entities of a simulation, e.g., to publish the state of a world.
+    class GZ_PHYSICS_VISIBLE GetEntityBatchFeature
+        : public virtual FeatureWithRequirements<
+            GetModelFromWorld, GetLinkFromModel, GetJointFromModel>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        public: using ModelPtrType = ModelPtr<PolicyT, FeaturesT>;
+        public: using ConstModelPtrType = ConstModelPtr<PolicyT, FeaturesT>;
+
+        /// \brief Get all the Models of this World.
+        /// \return The models, ordered by their index within this World.
+        public: std::vector<ModelPtrType> GetModels();
+
+        /// \sa GetModels()
+        public: std::vector<ConstModelPtrType> GetModels() const;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using LinkPtrType = LinkPtr<PolicyT, FeaturesT>;
+        public: using ConstLinkPtrType = ConstLinkPtr<PolicyT, FeaturesT>;
+        public: using JointPtrType = JointPtr<PolicyT, FeaturesT>;
+        public: using ConstJointPtrType = ConstJointPtr<PolicyT, FeaturesT>;
+
+        /// \brief Get all the Links of this Model.
+        /// \return The links, ordered by their index within this Model.
+        public: std::vector<LinkPtrType> GetLinks();
+
+        /// \sa GetLinks()
+        public: std::vector<ConstLinkPtrType> GetLinks() const;
+
+        /// \brief Get all the Joints of this Model.
+        /// \return The joints, ordered by their index within this Model.
+        public: std::vector<JointPtrType> GetJoints();
+
+        /// \sa GetJoints()
+        public: std::vector<ConstJointPtrType> GetJoints() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for getting all the models of a world.
+        /// \param[in] _worldID Identity of the world.
+        /// \return Identities of the models, ordered by index.
+        public: virtual std::vector<Identity> GetWorldModels(
+            const Identity &_worldID) const = 0;
+
+        /// \brief Implementation API for getting all the links of a model.
+        /// \param[in] _modelID Identity of the model.
+        /// \return Identities of the links, ordered by index.
+        public: virtual std::vector<Identity> GetModelLinks(
+            const Identity &_modelID) const = 0;
+
+        /// \brief Implementation API for getting all the joints of a model.
+        /// \param[in] _modelID Identity of the model.
+        /// \return Identities of the joints, ordered by index.
+        public: virtual std::vector<Identity> GetModelJoints(
+            const Identity &_modelID) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature reports the models, links and joints that were
+    /// created, removed, attached or detached in a world, so a client can
+    /// keep its view of the world up to date at the cost of the changes,
+    /// instead of enumerating every entity each step to compare them. See
+    /// EntityChange for the changes that are reported.
+    class GZ_PHYSICS_VISIBLE EntityChangeJournalFeature
+        : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Get the changes of this world since a cursor. Clients
+        /// keep their own cursor, starting from 0 to get every change since
+        /// the world was created, or from GetEntityChangeCursor() after
+        /// they enumerated the entities of the world.
+        /// \param[in,out] _cursor Cursor of the client, advanced past the
+        /// changes that are returned.
+        /// \param[out] _changes Changes since _cursor, oldest first.
+        /// \return False if the engine no longer keeps some of the changes
+        /// since _cursor. The client should then enumerate the entities of
+        /// the world again.
+        public: bool GetEntityChanges(
+            std::size_t &_cursor, std::vector<EntityChange> &_changes) const;
+
+        /// \brief Get the cursor that follows the last change of this world.
+        /// \return Cursor from which only later changes are returned.
+        public: std::size_t GetEntityChangeCursor() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for GetEntityChanges.
+        /// \param[in] _worldID Identity of the world.
+        /// \param[in,out] _cursor Cursor of the client.
+        /// \param[out] _changes Changes since _cursor.
+        /// \return False if some of the changes since _cursor were dropped.
+        public: virtual bool GetWorldEntityChanges(
+            const Identity &_worldID, std::size_t &_cursor,
+            std::vector<EntityChange> &_changes) const = 0;
+
+        /// \brief Implementation API for GetEntityChangeCursor.
+        /// \param[in] _worldID Identity of the world.
+        /// \return Cursor that follows the last change of the world.
+        public: virtual std::size_t GetWorldEntityChangeCursor(
+            const Identity &_worldID) const = 0;
+      };
+    };
+
     struct GetEntities : FeatureList<
       GetEngineInfo,
       GetWorldFromEngine,
@@ -553,6 +674,14 @@ namespace gz
       GetJointFromModel,
       GetShapeFromLink
     > { };
+
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(GetEngineInfo)
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(GetWorldFromEngine)
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(GetModelFromWorld)
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(GetNestedModelFromModel)
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(GetLinkFromModel)
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(GetJointFromModel)
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(GetShapeFromLink)
   }
 }
 
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_HYBRIDWORLD_HH_
+#define GZ_PHYSICS_HYBRIDWORLD_HH_
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/ForwardStep.hh>
+#include <gz/physics/FrameSemantics.hh>
+#include <gz/physics/FreeGroup.hh>
+#include <gz/physics/GetContacts.hh>
+#include <gz/physics/GetEntities.hh>
+#include <gz/physics/KinematicModel.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief Features that HybridWorld needs from the dynamic world.
+    struct HybridDynamicWorldFeatureList : FeatureList<
+      ForwardStep,
+      GetContactBatchFromLastStepFeature,
+      GetModelFromWorld,
+      GetLinkFromModel,
+      GetShapeFromLink,
+      FindFreeGroupFeature,
+      SetFreeGroupWorldPose,
+      SetFreeGroupWorldVelocity,
+      KinematicModelFeature
+    > { };
+
+    /////////////////////////////////////////////////
+    /// \brief Features that HybridWorld needs from the kinematic world.
+    struct HybridKinematicWorldFeatureList : FeatureList<
+      ForwardStep,
+      GetModelFromWorld,
+      GetLinkFromModel,
+      LinkFrameSemantics
+    > { };
+
+    /////////////////////////////////////////////////
+    /// \brief Steps a world of a kinematic engine, such as TPE, alongside a
+    /// 3d world of a dynamics engine, e.g. a crowd of people around a few
+    /// robots.
+    ///
+    /// Each model of the crowd is loaded into both worlds. The kinematic
+    /// world owns it: the application moves it there and pays only for the
+    /// collision checks of the kinematic engine. In the dynamic world the
+    /// model is a proxy, made kinematic with KinematicModelFeature, that
+    /// follows the first link of the model in the kinematic world. Before
+    /// every step the pose and velocity of that link are copied into the
+    /// proxy, so bodies of the dynamic world are pushed by the crowd as by
+    /// bodies of infinite mass. Engines do not solve contacts between two
+    /// kinematic models, so the proxies cost the dynamic engine little more
+    /// than their collision shapes.
+    ///
+    /// The worlds exchange nothing else. The contacts between proxies and
+    /// the other bodies of the dynamic world are collected after every step,
+    /// see GetProxyContacts, so that the application can make the crowd
+    /// react to the robots.
+    ///
+    /// \tparam DynamicWorldPtrT Pointer to a world with
+    /// HybridDynamicWorldFeatureList.
+    /// \tparam KinematicWorldPtrT Pointer to a world with
+    /// HybridKinematicWorldFeatureList.
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    class HybridWorld
+    {
+      /// \brief A contact between a proxy and a body of the dynamic world.
+      public: struct ProxyContact
+      {
+        /// \brief Name of the model of the proxy.
+        std::string proxy;
+
+        /// \brief Entity ID of the collision shape of the proxy.
+        std::size_t proxyShape = 0u;
+
+        /// \brief Entity ID of the collision shape of the other body.
+        std::size_t otherShape = 0u;
+
+        /// \brief Point of contact, expressed in the world frame.
+        Eigen::Vector3d point = Eigen::Vector3d::Zero();
+
+        /// \brief Force of the other body on the proxy, expressed in the
+        /// world frame. Zero if the engine does not report contact forces.
+        Eigen::Vector3d force = Eigen::Vector3d::Zero();
+      };
+
+      /// \brief Constructor.
+      /// \param[in] _dynamic World of the dynamics engine.
+      /// \param[in] _kinematic World of the kinematic engine.
+      public: HybridWorld(DynamicWorldPtrT _dynamic,
+                          KinematicWorldPtrT _kinematic);
+
+      /// \brief Make a model a proxy of the model with the same name in the
+      /// kinematic world. The proxy is made kinematic and moved to the pose
+      /// of the kinematic model right away.
+      /// \param[in] _name Name of the model in both worlds.
+      /// \return True if the model was made a proxy, false if either world
+      /// has no such model, the model has no free group in the dynamic world
+      /// or it is a proxy already.
+      public: bool AddProxy(const std::string &_name);
+
+      /// \brief Stop following the kinematic world with a proxy. The model
+      /// of the dynamic world is simulated again from its last pose and
+      /// velocity.
+      /// \param[in] _name Name of the model.
+      /// \return True if the model was a proxy.
+      public: bool RemoveProxy(const std::string &_name);
+
+      /// \brief Get the number of proxies.
+      /// \return Number of proxies.
+      public: std::size_t GetProxyCount() const;
+
+      /// \brief Copy the kinematic world into the proxies, then step both
+      /// worlds with the same input, the kinematic one first.
+      /// \param[out] _dynamicOutput Output of the dynamic world.
+      /// \param[out] _kinematicOutput Output of the kinematic world.
+      /// \param[in] _input Input of the step, e.g. its length.
+      public: void Step(ForwardStep::Output &_dynamicOutput,
+                        ForwardStep::Output &_kinematicOutput,
+                        const ForwardStep::Input &_input);
+
+      /// \brief Get the contacts between proxies and the other bodies of the
+      /// dynamic world in the last step.
+      /// \return Contacts of the proxies.
+      public: const std::vector<ProxyContact> &GetProxyContacts() const;
+
+      /// \brief Copy the pose and velocity of the kinematic model into a
+      /// proxy.
+      /// \param[in] _index Index of the proxy.
+      private: void Sync(std::size_t _index);
+
+      /// \brief Collect the contacts of the proxies from the last step of
+      /// the dynamic world.
+      private: void CollectContacts();
+
+      /// \brief Rebuild the map from collision shapes to proxies.
+      private: void IndexShapes();
+
+      private: using DynamicModelPtr = decltype(
+          std::declval<DynamicWorldPtrT&>()->GetModel(std::string()));
+
+      private: using FreeGroupPtr = decltype(
+          std::declval<DynamicModelPtr&>()->FindFreeGroup());
+
+      private: using KinematicLinkPtr = decltype(
+          std::declval<KinematicWorldPtrT&>()->GetModel(
+            std::string())->GetLink(std::size_t()));
+
+      /// \brief A model of the dynamic world that follows the kinematic one.
+      private: struct Proxy
+      {
+        /// \brief Name of the model in both worlds.
+        std::string name;
+
+        /// \brief Model in the dynamic world.
+        DynamicModelPtr model;
+
+        /// \brief Free group of the model in the dynamic world.
+        FreeGroupPtr freeGroup;
+
+        /// \brief First link of the model in the kinematic world.
+        KinematicLinkPtr link;
+      };
+
+      /// \brief World of the dynamics engine.
+      private: DynamicWorldPtrT dynamic;
+
+      /// \brief World of the kinematic engine.
+      private: KinematicWorldPtrT kinematic;
+
+      /// \brief State of the dynamic world, unused by current engines.
+      private: ForwardStep::State dynamicState;
+
+      /// \brief State of the kinematic world, unused by current engines.
+      private: ForwardStep::State kinematicState;
+
+      /// \brief Proxies, in the order they were added.
+      private: std::vector<Proxy> proxies;
+
+      /// \brief Index of the proxy of each collision shape of the proxies.
+      private: std::unordered_map<std::size_t, std::size_t> shapeProxy;
+
+      /// \brief Contacts of the proxies in the last step.
+      private: std::vector<ProxyContact> contacts;
+    };
+  }
+}
+
+#include <gz/physics/detail/HybridWorld.hh>
+
+#endif
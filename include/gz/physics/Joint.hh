@@ -18,11 +18,14 @@
 #ifndef GZ_PHYSICS_JOINT_HH_
 #define GZ_PHYSICS_JOINT_HH_
 
+#include <Eigen/Core>
+
 #include <gz/physics/FeatureList.hh>
 #include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/Geometry.hh>
 
 #include <string>
+#include <vector>
 
 namespace gz
 {
@@ -586,6 +589,48 @@ namespace gz
       };
     };
 
+    /////////////////////////////////////////////////
+    /// \brief This feature gets the transmitted wrench of every joint in a
+    /// model with one call, in one pass over the model.
+    ///
+    /// The wrenches are those that GetJointTransmittedWrench::Joint::
+    /// GetTransmittedWrench() returns, i.e. expressed in the frame of each
+    /// joint, in joint index order. Joints that transmit no wrench, e.g.
+    /// because they have no child link, get a zero wrench.
+    class GZ_PHYSICS_VISIBLE GetModelJointTransmittedWrenches
+        : public virtual Feature
+    {
+      /// \brief The Model API for getting the transmitted wrenches of a
+      /// whole model
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using Wrench = typename FromPolicy<
+                    PolicyT>::template Use<Wrench>;
+
+        /// \brief Get the transmitted wrench of every joint.
+        /// \param[out] _wrenches
+        ///   Resized to the number of joints in this model and filled.
+        ///   Reuse the same vector across calls to avoid allocating.
+        public: void GetJointTransmittedWrenches(
+                    std::vector<Wrench> &_wrenches) const;
+      };
+
+      /// \private The implementation API for getting the transmitted
+      /// wrenches of a whole model
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using Wrench = typename FromPolicy<
+                    PolicyT>::template Use<Wrench>;
+
+        // see Model::GetJointTransmittedWrenches above
+        public: virtual void GetModelJointTransmittedWrenches(
+                    const Identity &_modelID,
+                    std::vector<Wrench> &_wrenches) const = 0;
+      };
+    };
+
     /////////////////////////////////////////////////
     /// \brief This feature applies a Mimic constraint to an axis of this Joint.
     /// This constraint encodes a linear relationship between the output
@@ -652,6 +697,294 @@ namespace gz
             Scalar _reference) = 0;
       };
     };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature applies many mimic constraints with one call, e.g.
+    /// for controllers that retune the constraints of a whole mechanism every
+    /// step. See SetMimicConstraintFeature for the meaning of each parameter.
+    /// Engines may update the constraints that already exist between the
+    /// same axes in place instead of replacing them.
+    class GZ_PHYSICS_VISIBLE SetMimicConstraintsFeature
+        : public virtual FeatureWithRequirements<SetMimicConstraintFeature>
+    {
+      /// \brief A mimic constraint between an axis of a follower joint and
+      /// an axis of a leader joint.
+      public: template <typename PolicyT>
+      struct MimicConstraintT
+      {
+        using Scalar = typename PolicyT::Scalar;
+
+        /// \brief Joint containing the follower axis
+        BaseJointPtr<PolicyT> follower;
+        /// \brief Generalized coordinate of the follower axis
+        std::size_t followerDof = 0u;
+        /// \brief Joint containing the leader axis
+        BaseJointPtr<PolicyT> leader;
+        /// \brief Generalized coordinate of the leader axis
+        std::size_t leaderDof = 0u;
+        /// \brief Multiplier applied to the position of the leader axis
+        Scalar multiplier = Scalar(1);
+        /// \brief Offset added after the multiplier is applied
+        Scalar offset = Scalar(0);
+        /// \brief Reference for the leader position
+        Scalar reference = Scalar(0);
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        public: using MimicConstraint = MimicConstraintT<PolicyT>;
+
+        /// \brief Apply mimic constraints to joints of this world.
+        /// \param[in] _constraints Constraints to apply. A constraint on an
+        /// axis that already has one replaces it.
+        /// \return Number of constraints that were set successfully.
+        public: std::size_t SetMimicConstraints(
+                    const std::vector<MimicConstraint> &_constraints);
+      };
+
+      /// \private The implementation API for setting many mimic constraints.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using MimicConstraint = MimicConstraintT<PolicyT>;
+
+        // See World::SetMimicConstraints above
+        public: virtual std::size_t SetWorldMimicConstraints(
+            const Identity &_worldID,
+            const MimicConstraint *_constraints,
+            std::size_t _count) = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature retrieves the generalized positions, velocities,
+    /// accelerations and forces of every joint in a model with one call each.
+    ///
+    /// Each vector holds the joints of the model in joint index order, with
+    /// joint i contributing Joint::GetDegreesOfFreedom() consecutive values.
+    /// Element k of the block of joint i is the value that
+    /// GetBasicJointState would return for DOF k of joint i.
+    class GZ_PHYSICS_VISIBLE GetModelJointState : public virtual Feature
+    {
+      /// \brief The Model API for getting the joint state of a whole model
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+        public: using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        /// \brief Get the generalized positions of every joint.
+        /// \param[out] _positions
+        ///   Resized to the number of joint DOFs in this model and filled.
+        public: void GetJointPositions(VectorX &_positions) const;
+
+        /// \brief Get the generalized velocities of every joint.
+        /// \param[out] _velocities
+        ///   Resized to the number of joint DOFs in this model and filled.
+        public: void GetJointVelocities(VectorX &_velocities) const;
+
+        /// \brief Get the generalized accelerations of every joint.
+        /// \param[out] _accelerations
+        ///   Resized to the number of joint DOFs in this model and filled.
+        public: void GetJointAccelerations(VectorX &_accelerations) const;
+
+        /// \brief Get the generalized forces of every joint.
+        /// \param[out] _forces
+        ///   Resized to the number of joint DOFs in this model and filled.
+        public: void GetJointForces(VectorX &_forces) const;
+      };
+
+      /// \private The implementation API for getting the joint state of a
+      /// whole model
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+        public: using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        // see Model::GetJointPositions above
+        public: virtual void GetModelJointPositions(
+            const Identity &_modelID, VectorX &_positions) const = 0;
+
+        // see Model::GetJointVelocities above
+        public: virtual void GetModelJointVelocities(
+            const Identity &_modelID, VectorX &_velocities) const = 0;
+
+        // see Model::GetJointAccelerations above
+        public: virtual void GetModelJointAccelerations(
+            const Identity &_modelID, VectorX &_accelerations) const = 0;
+
+        // see Model::GetJointForces above
+        public: virtual void GetModelJointForces(
+            const Identity &_modelID, VectorX &_forces) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature sets the generalized positions, velocities,
+    /// accelerations and forces of every joint in a model with one call each.
+    ///
+    /// The vectors use the layout described in GetModelJointState. A vector
+    /// whose size does not match the number of joint DOFs in the model, or
+    /// that holds a non-finite value, is ignored.
+    class GZ_PHYSICS_VISIBLE SetModelJointState : public virtual Feature
+    {
+      /// \brief The Model API for setting the joint state of a whole model
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+        public: using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        /// \brief Set the generalized positions of every joint.
+        /// \param[in] _positions
+        ///   One value per joint DOF of this model.
+        public: void SetJointPositions(const VectorX &_positions);
+
+        /// \brief Set the generalized velocities of every joint.
+        /// \param[in] _velocities
+        ///   One value per joint DOF of this model.
+        public: void SetJointVelocities(const VectorX &_velocities);
+
+        /// \brief Set the generalized accelerations of every joint.
+        /// \param[in] _accelerations
+        ///   One value per joint DOF of this model.
+        public: void SetJointAccelerations(const VectorX &_accelerations);
+
+        /// \brief Set the generalized forces of every joint. Like
+        /// SetBasicJointState::Joint::SetForce, these are applied only during
+        /// the next simulation step.
+        /// \param[in] _forces
+        ///   One value per joint DOF of this model.
+        public: void SetJointForces(const VectorX &_forces);
+      };
+
+      /// \private The implementation API for setting the joint state of a
+      /// whole model
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+        public: using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        // see Model::SetJointPositions above
+        public: virtual void SetModelJointPositions(
+            const Identity &_modelID, const VectorX &_positions) = 0;
+
+        // see Model::SetJointVelocities above
+        public: virtual void SetModelJointVelocities(
+            const Identity &_modelID, const VectorX &_velocities) = 0;
+
+        // see Model::SetJointAccelerations above
+        public: virtual void SetModelJointAccelerations(
+            const Identity &_modelID, const VectorX &_accelerations) = 0;
+
+        // see Model::SetJointForces above
+        public: virtual void SetModelJointForces(
+            const Identity &_modelID, const VectorX &_forces) = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature runs a PD controller with gravity compensation on
+    /// the joints of a model inside the engine, so a control loop does not
+    /// need to read the joint state and set joint forces on every step.
+    ///
+    /// Before every substep of the world (see SubSteps), the engine sets the
+    /// force of DOF k to
+    ///
+    ///   positionGains[k] * (targetPositions[k] - position[k])
+    ///     + velocityGains[k] * (targetVelocities[k] - velocity[k])
+    ///     + gravity[k]
+    ///
+    /// where gravity[k] is the force that holds the model still against
+    /// gravity, if gravityCompensation is set, and 0 otherwise. The force
+    /// is added to the one given by SetBasicJointState::Joint::SetForce for
+    /// the step, and is limited by the effort limits of the joint. Joints
+    /// that are given a velocity command for a step are not controlled
+    /// during that step.
+    ///
+    /// The vectors use the layout described in GetModelJointState.
+    class GZ_PHYSICS_VISIBLE ModelJointPDControlFeature
+      : public virtual Feature
+    {
+      /// \brief Gains and targets of the controller of a model.
+      public: template <typename PolicyT>
+      struct JointPDControlT
+      {
+        using Scalar = typename PolicyT::Scalar;
+        using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        /// \brief Gain on the position error of each joint DOF
+        VectorX positionGains;
+
+        /// \brief Gain on the velocity error of each joint DOF
+        VectorX velocityGains;
+
+        /// \brief Target position of each joint DOF
+        VectorX targetPositions;
+
+        /// \brief Target velocity of each joint DOF
+        VectorX targetVelocities;
+
+        /// \brief Whether to add the forces that hold the model against
+        /// gravity
+        bool gravityCompensation = true;
+      };
+
+      /// \brief The Model API for the joint PD controller
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using JointPDControl = JointPDControlT<PolicyT>;
+        public: using VectorX = typename JointPDControl::VectorX;
+
+        /// \brief Control the joints of this model from now on, replacing
+        /// a previous controller.
+        /// \param[in] _control
+        ///   Gains and targets, with one value per joint DOF of this model in
+        ///   every vector.
+        /// \return False, without changing the controller, if a vector has
+        /// the wrong size or holds a non-finite value.
+        public: bool SetJointPDControl(const JointPDControl &_control);
+
+        /// \brief Change the targets of the controller of this model,
+        /// keeping its gains.
+        /// \param[in] _positions One target position per joint DOF
+        /// \param[in] _velocities One target velocity per joint DOF
+        /// \return False, without changing the targets, if this model has no
+        /// controller, or if a vector has the wrong size or holds a
+        /// non-finite value.
+        public: bool SetJointPDControlTargets(
+            const VectorX &_positions, const VectorX &_velocities);
+
+        /// \brief Stop controlling the joints of this model.
+        public: void RemoveJointPDControl();
+      };
+
+      /// \private The implementation API for the joint PD controller
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using JointPDControl = JointPDControlT<PolicyT>;
+        public: using VectorX = typename JointPDControl::VectorX;
+
+        // see Model::SetJointPDControl above
+        public: virtual bool SetModelJointPDControl(
+            const Identity &_modelID, const JointPDControl &_control) = 0;
+
+        // see Model::SetJointPDControlTargets above
+        public: virtual bool SetModelJointPDControlTargets(
+            const Identity &_modelID,
+            const VectorX &_positions,
+            const VectorX &_velocities) = 0;
+
+        // see Model::RemoveJointPDControl above
+        public: virtual void RemoveModelJointPDControl(
+            const Identity &_modelID) = 0;
+      };
+    };
   }
 }
 
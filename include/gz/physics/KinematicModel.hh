@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_KINEMATICMODEL_HH_
+#define GZ_PHYSICS_KINEMATICMODEL_HH_
+
+#include <gz/physics/FeatureList.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief KinematicModelFeature marks models as kinematic, i.e. driven
+    /// by the caller instead of simulated. A kinematic model moves only as
+    /// set through the FreeGroup features: to the pose set with
+    /// SetWorldPose and, in engines that support the free group velocity
+    /// features, at the velocity set with SetWorldLinearVelocity and
+    /// SetWorldAngularVelocity, which it keeps until it is changed. Gravity,
+    /// forces and contacts do not move it, and it is left out of the
+    /// dynamics solved for the other models, so driving a model this way
+    /// does not fight the solver or add to its cost. Other models still
+    /// collide with a kinematic model, as with a model of infinite mass.
+    /// Whether the joints within a kinematic model still move depends on
+    /// the engine. Use it for conveyors, doors or actors driven by motion
+    /// capture.
+    class GZ_PHYSICS_VISIBLE KinematicModelFeature : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        /// \brief Set whether the model is kinematic.
+        /// \param[in] _kinematic True to drive the model, false to simulate
+        /// it again, starting from its current pose and velocity.
+        public: void SetKinematic(bool _kinematic);
+
+        /// \brief Get whether the model is kinematic.
+        /// \return True if the model is kinematic.
+        public: bool GetKinematic() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for SetKinematic
+        /// \param[in] _modelID Identity of the model
+        /// \param[in] _kinematic True to drive the model
+        public: virtual void SetModelKinematic(
+            const Identity &_modelID, bool _kinematic) = 0;
+
+        /// \brief Implementation API for GetKinematic
+        /// \param[in] _modelID Identity of the model
+        /// \return True if the model is kinematic
+        public: virtual bool GetModelKinematic(
+            const Identity &_modelID) const = 0;
+      };
+    };
+  }
+}
+
+#include <gz/physics/detail/KinematicModel.hh>
+
+#endif
@@ -129,6 +129,78 @@ namespace gz
             const Identity &_id, const AngularVectorType &_torque) = 0;
       };
     };
+
+    /////////////////////////////////////////////////
+    /// \brief Enable continuous collision detection (CCD) for individual
+    /// links, so that small and fast links do not tunnel through other
+    /// objects without shrinking the time step of the whole world. Only the
+    /// links that enable it pay for the extra collision checks.
+    ///
+    /// A link is swept as a sphere of the given radius over any step in
+    /// which it moves further than the motion threshold. A motion threshold
+    /// of 0 disables CCD for the link, which is the default.
+    class GZ_PHYSICS_VISIBLE LinkContinuousCollisionFeature
+      : public virtual Feature
+    {
+      /// \brief The Link API for continuous collision detection
+      public: template <typename PolicyT, typename FeaturesT>
+      class Link : public virtual Feature::Link<PolicyT, FeaturesT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+
+        /// \brief Set the continuous collision detection parameters of this
+        /// link.
+        /// \param[in] _motionThreshold Distance the link must move in a step
+        /// for the step to be swept. 0 disables continuous collision
+        /// detection.
+        /// \param[in] _sweptSphereRadius Radius of the sphere swept along the
+        /// motion of the link. It should fit inside the collision shapes of
+        /// the link.
+        public: void SetContinuousCollision(
+            Scalar _motionThreshold, Scalar _sweptSphereRadius);
+
+        /// \brief Get the motion threshold of continuous collision detection
+        /// \return The motion threshold, 0 if it is disabled
+        public: Scalar GetContinuousCollisionMotionThreshold() const;
+
+        /// \brief Get the radius of the sphere swept by continuous collision
+        /// detection
+        /// \return The swept sphere radius
+        public: Scalar GetContinuousCollisionSweptSphereRadius() const;
+      };
+
+      /// \private The implementation API for continuous collision detection
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using Scalar = typename PolicyT::Scalar;
+
+        /// \brief Implementation API for setting the continuous collision
+        /// detection parameters of a link
+        /// \param[in] _id Identity of the link
+        /// \param[in] _motionThreshold See
+        /// LinkContinuousCollisionFeature::Link::SetContinuousCollision
+        /// \param[in] _sweptSphereRadius See
+        /// LinkContinuousCollisionFeature::Link::SetContinuousCollision
+        public: virtual void SetLinkContinuousCollision(
+            const Identity &_id, Scalar _motionThreshold,
+            Scalar _sweptSphereRadius) = 0;
+
+        /// \brief Implementation API for getting the motion threshold of
+        /// continuous collision detection of a link
+        /// \param[in] _id Identity of the link
+        /// \return The motion threshold
+        public: virtual Scalar GetLinkContinuousCollisionMotionThreshold(
+            const Identity &_id) const = 0;
+
+        /// \brief Implementation API for getting the swept sphere radius of
+        /// continuous collision detection of a link
+        /// \param[in] _id Identity of the link
+        /// \return The swept sphere radius
+        public: virtual Scalar GetLinkContinuousCollisionSweptSphereRadius(
+            const Identity &_id) const = 0;
+      };
+    };
   }
 }
 
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MEMORYRESOURCE_HH_
+#define GZ_PHYSICS_MEMORYRESOURCE_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <gz/physics/Export.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    // Forward declaration
+    class ArenaMemoryResourcePrivate;
+
+    /////////////////////////////////////////////////
+    /// \brief Interface to the memory that physics engines allocate the
+    /// many small objects of their worlds from, e.g. entities and the
+    /// bookkeeping structs of the plugins. An application that runs many
+    /// worlds for a long time can give each engine a resource of its own,
+    /// which keeps their objects together instead of spread over the global
+    /// heap. See MemoryResourceFeature.
+    class GZ_PHYSICS_VISIBLE MemoryResource
+    {
+      /// \brief Destructor
+      public: virtual ~MemoryResource();
+
+      /// \brief Allocate memory. Several threads may allocate at once.
+      /// \param[in] _bytes Size of the memory, in bytes.
+      /// \param[in] _alignment Alignment of the memory, a power of 2.
+      /// \return Pointer to the memory. Throws std::bad_alloc on failure.
+      public: virtual void *Allocate(
+          std::size_t _bytes, std::size_t _alignment) = 0;
+
+      /// \brief Free memory returned by Allocate.
+      /// \param[in] _ptr Pointer returned by Allocate.
+      /// \param[in] _bytes Size given to Allocate.
+      /// \param[in] _alignment Alignment given to Allocate.
+      public: virtual void Deallocate(
+          void *_ptr, std::size_t _bytes, std::size_t _alignment) = 0;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Memory resource that carves small allocations out of large
+    /// blocks, with a free list for each size class, so objects of
+    /// similar size share pages and freed memory is reused without going
+    /// through the global heap. Larger allocations are passed through to
+    /// the global heap.
+    ///
+    /// Blocks are only returned when the resource is destroyed, which
+    /// frees all of them, and any allocation that was not freed, at once.
+    class GZ_PHYSICS_VISIBLE ArenaMemoryResource : public MemoryResource
+    {
+      /// \brief Options of the arena.
+      public: struct Options
+      {
+        /// \brief Size of the blocks that small allocations are carved
+        /// from, in bytes.
+        std::size_t blockSize = std::size_t(1u) << 21;
+
+        /// \brief Largest allocation carved from the blocks, in bytes, at
+        /// most 4096.
+        std::size_t maxPooledSize = 1024u;
+
+        /// \brief Whether to ask the operating system to back the blocks
+        /// with huge pages, which saves TLB misses when the objects of a
+        /// world are spread over many blocks. Blocks are then aligned to,
+        /// and rounded up to, 2 MiB. Only supported on Linux, where it
+        /// needs transparent huge pages to be enabled; ignored elsewhere.
+        bool hugePages = false;
+
+        /// \brief Function that each new block is given to before it is
+        /// used, with its address and size, or empty. Operating systems
+        /// place a page on the memory node of the thread that first writes
+        /// it, so writing the block from threads pinned to a node, see
+        /// ThreadPoolTaskScheduler, places the block on that node. It is
+        /// called while the arena is locked.
+        std::function<void(void *, std::size_t)> firstTouch;
+      };
+
+      /// \brief Constructor with the default options.
+      public: ArenaMemoryResource();
+
+      /// \brief Constructor
+      /// \param[in] _options Options of the arena.
+      public: explicit ArenaMemoryResource(const Options &_options);
+
+      /// \brief Destructor. Frees all memory, so nothing allocated from the
+      /// arena may be used afterwards.
+      public: ~ArenaMemoryResource() override;
+
+      // Documentation inherited
+      public: void *Allocate(
+          std::size_t _bytes, std::size_t _alignment) override;
+
+      // Documentation inherited
+      public: void Deallocate(
+          void *_ptr, std::size_t _bytes, std::size_t _alignment) override;
+
+      /// \brief Get the options of the arena.
+      /// \return Options, with the block size rounded as it is used.
+      public: const Options &GetOptions() const;
+
+      /// \brief Get the memory that the arena holds.
+      /// \return Size of the blocks and of the passed through allocations,
+      /// in bytes.
+      public: std::size_t GetBytesReserved() const;
+
+      /// \brief Get the memory that is allocated from the arena.
+      /// \return Size of the allocations that were not freed, rounded up to
+      /// their size classes, in bytes.
+      public: std::size_t GetBytesInUse() const;
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<ArenaMemoryResourcePrivate> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Allocator for standard containers and std::allocate_shared
+    /// that allocates from a MemoryResource, or from the global heap
+    /// without one. Every copy keeps the resource alive, so objects that
+    /// are shared with an application can outlive the engine that made
+    /// them.
+    template <typename T>
+    class ResourceAllocator
+    {
+      public: using value_type = T;
+
+      /// \brief Constructor
+      /// \param[in] _resource Resource, or nullptr for the global heap.
+      public: explicit ResourceAllocator(
+          std::shared_ptr<MemoryResource> _resource = nullptr);
+
+      /// \brief Copy an allocator of another type.
+      /// \param[in] _other Allocator to copy.
+      public: template <typename U>
+      ResourceAllocator(const ResourceAllocator<U> &_other);
+
+      /// \brief Allocate memory for objects.
+      /// \param[in] _count Number of objects.
+      /// \return Pointer to the memory.
+      public: T *allocate(std::size_t _count);
+
+      /// \brief Free memory returned by allocate.
+      /// \param[in] _ptr Pointer returned by allocate.
+      /// \param[in] _count Number of objects given to allocate.
+      public: void deallocate(T *_ptr, std::size_t _count);
+
+      /// \brief Get the resource.
+      /// \return Resource, or nullptr for the global heap.
+      public: const std::shared_ptr<MemoryResource> &GetResource() const;
+
+      /// \brief Resource, or nullptr for the global heap.
+      private: std::shared_ptr<MemoryResource> resource;
+    };
+
+    /// \brief Allocators are equal if they use the same resource.
+    template <typename T, typename U>
+    bool operator==(const ResourceAllocator<T> &_a,
+                    const ResourceAllocator<U> &_b);
+
+    /// \brief Allocators are equal if they use the same resource.
+    template <typename T, typename U>
+    bool operator!=(const ResourceAllocator<T> &_a,
+                    const ResourceAllocator<U> &_b);
+
+    /////////////////////////////////////////////////
+    /// \brief Make a shared object, with its control block, from a
+    /// resource.
+    /// \param[in] _resource Resource, or nullptr for std::make_shared.
+    /// \param[in] _args Arguments of the constructor of the object.
+    /// \return The object.
+    template <typename T, typename... Args>
+    std::shared_ptr<T> MakeShared(
+        const std::shared_ptr<MemoryResource> &_resource, Args &&..._args);
+  }
+}
+
+#include <gz/physics/detail/MemoryResource.hh>
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MEMORYRESOURCEFEATURE_HH_
+#define GZ_PHYSICS_MEMORYRESOURCEFEATURE_HH_
+
+#include <memory>
+
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/MemoryResource.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief MemoryResourceFeature lets an engine allocate the objects of
+    /// its worlds from a MemoryResource, e.g. an ArenaMemoryResource.
+    ///
+    /// Objects that are created after the resource is set are allocated
+    /// from it, and keep it alive until they are destroyed. Objects created
+    /// before keep their memory. Without a resource (default) the engine
+    /// uses the global heap.
+    ///
+    /// Engines decide which of their objects the resource covers. TPE
+    /// allocates its entities and the structs that the plugin keeps for
+    /// them from it. Engines that can not route their allocations, such as
+    /// bullet, whose allocator hooks are process-wide, do not provide this
+    /// feature.
+    class GZ_PHYSICS_VISIBLE MemoryResourceFeature : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Set the memory resource of the engine.
+        /// \param[in] _resource Resource, or nullptr for the global heap.
+        public: void SetMemoryResource(
+            std::shared_ptr<MemoryResource> _resource);
+
+        /// \brief Get the memory resource of the engine.
+        /// \return Resource, or nullptr for the global heap.
+        public: std::shared_ptr<MemoryResource> GetMemoryResource() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for SetMemoryResource
+        /// \param[in] _engineID Identity of the engine
+        /// \param[in] _resource Resource, or nullptr
+        public: virtual void SetEngineMemoryResource(
+            const Identity &_engineID,
+            std::shared_ptr<MemoryResource> _resource) = 0;
+
+        /// \brief Implementation API for GetMemoryResource
+        /// \param[in] _engineID Identity of the engine
+        /// \return Resource, or nullptr
+        public: virtual std::shared_ptr<MemoryResource>
+        GetEngineMemoryResource(const Identity &_engineID) const = 0;
+      };
+    };
+  }
+}
+
+#include <gz/physics/detail/MemoryResourceFeature.hh>
+
+#endif
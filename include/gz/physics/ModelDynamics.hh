@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MODELDYNAMICS_HH_
+#define GZ_PHYSICS_MODELDYNAMICS_HH_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <gz/physics/FeatureList.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief ModelDynamicsFeature gives the rigid body dynamics that the
+    /// engine computes for a model, so that controllers do not need to build
+    /// a second model of the robot to get them: the mass matrix, the Coriolis
+    /// and gravity forces, the Jacobians of the links, and its inverse
+    /// dynamics.
+    ///
+    /// The quantities are expressed in the generalized coordinates of the
+    /// engine, i.e. one coordinate per degree of freedom of the model, in the
+    /// order that the engine keeps them. If the model floats, the coordinates
+    /// of its floating base come first, in the convention of the engine. Use
+    /// ModelDynamicsT::jointCoordinates to find the coordinates of each
+    /// joint. Contacts, joint damping and springs are not included.
+    class GZ_PHYSICS_VISIBLE ModelDynamicsFeature : public virtual Feature
+    {
+      /// \brief Dynamics of a model at its current state.
+      public: template <typename PolicyT>
+      struct ModelDynamicsT
+      {
+        using Scalar = typename PolicyT::Scalar;
+        using GeneralizedMatrix =
+            Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+        using GeneralizedVector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+        /// \brief Number of rows of the Jacobian of a link: its linear
+        /// velocity followed by its angular velocity.
+        static constexpr std::size_t LinkJacobianRows =
+            PolicyT::Dim + (PolicyT::Dim == 3 ? 3 : 1);
+
+        /// \brief Value of jointCoordinates for the joints without degrees of
+        /// freedom in the model.
+        static constexpr std::size_t kNoCoordinate =
+            std::numeric_limits<std::size_t>::max();
+
+        /// \brief Mass matrix, one row and column per coordinate
+        GeneralizedMatrix massMatrix;
+
+        /// \brief Coriolis, centrifugal and gravity forces, one entry per
+        /// coordinate. The generalized forces of the joints are
+        /// massMatrix * accelerations + coriolisAndGravity.
+        GeneralizedVector coriolisAndGravity;
+
+        /// \brief Jacobians of the links in the world frame, at the origin of
+        /// each link. Link i, in the order of Model::GetLink(i), has the
+        /// LinkJacobianRows rows starting at LinkJacobianRows * i, and one
+        /// column per coordinate. Links which do not move with the
+        /// coordinates of the model have zero rows.
+        GeneralizedMatrix linkJacobians;
+
+        /// \brief Index of the first coordinate of each joint, in the order of
+        /// Model::GetJoint(i), or kNoCoordinate if the joint has no degrees of
+        /// freedom in the model. The coordinates of a joint are contiguous.
+        std::vector<std::size_t> jointCoordinates;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using ModelDynamics = ModelDynamicsT<PolicyT>;
+        public: using GeneralizedVector =
+            typename ModelDynamics::GeneralizedVector;
+
+        /// \brief Get the dynamics of this model at its current state, in one
+        /// call. The buffers of _dynamics are reused, so keep it around to
+        /// avoid allocating them for each call.
+        /// \param[out] _dynamics Dynamics of the model
+        public: void GetDynamics(ModelDynamics &_dynamics) const;
+
+        /// \brief Get the dynamics of this model at its current state.
+        /// \return Dynamics of the model
+        public: ModelDynamics GetDynamics() const;
+
+        /// \brief Compute the generalized forces which give this model the
+        /// generalized accelerations _accelerations at its current state.
+        /// \param[in] _accelerations One acceleration per coordinate
+        /// \return One force per coordinate, or an empty vector if
+        /// _accelerations does not have one entry per coordinate.
+        public: GeneralizedVector ComputeInverseDynamics(
+            const GeneralizedVector &_accelerations) const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using ModelDynamics = ModelDynamicsT<PolicyT>;
+        public: using GeneralizedVector =
+            typename ModelDynamics::GeneralizedVector;
+
+        /// \brief Implementation API for GetDynamics
+        /// \param[in] _modelID Identity of the model
+        /// \param[out] _dynamics Dynamics of the model
+        public: virtual void GetModelDynamics(
+            const Identity &_modelID, ModelDynamics &_dynamics) const = 0;
+
+        /// \brief Implementation API for ComputeInverseDynamics
+        /// \param[in] _modelID Identity of the model
+        /// \param[in] _accelerations One acceleration per coordinate
+        /// \return One force per coordinate, or an empty vector
+        public: virtual GeneralizedVector ComputeModelInverseDynamics(
+            const Identity &_modelID,
+            const GeneralizedVector &_accelerations) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief ModelStepDerivativesFeature gives the derivatives of the next
+    /// state of a model after one step of its world, with respect to its
+    /// current state and to the generalized forces applied during the step.
+    /// Trajectory optimizers can use them instead of estimating them by
+    /// stepping the world from perturbed states.
+    ///
+    /// The state x holds the generalized positions of the model followed by
+    /// its generalized velocities, in the coordinates described in
+    /// ModelDynamicsFeature, and the forces u have one entry per coordinate.
+    /// The derivatives linearize a single integration step of the current
+    /// time step of the world, without substeps, and without contacts, joint
+    /// limits, damping or springs. The forces commanded for the next step
+    /// are held fixed.
+    class GZ_PHYSICS_VISIBLE ModelStepDerivativesFeature
+      : public virtual Feature
+    {
+      /// \brief Derivatives of one step of a model.
+      public: template <typename PolicyT>
+      struct StepDerivativesT
+      {
+        using Scalar = typename PolicyT::Scalar;
+        using GeneralizedMatrix =
+            Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+        /// \brief Derivative of the next state with respect to the current
+        /// state, with two rows and two columns per coordinate.
+        GeneralizedMatrix stateJacobian;
+
+        /// \brief Derivative of the next state with respect to the forces,
+        /// with two rows and one column per coordinate.
+        GeneralizedMatrix forceJacobian;
+
+        /// \brief Time step that the derivatives were computed for, in
+        /// seconds
+        Scalar timeStep = 0;
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using StepDerivatives = StepDerivativesT<PolicyT>;
+
+        /// \brief Get the derivatives of the next step of this model at its
+        /// current state. The state of the model is left unchanged, and the
+        /// buffers of _derivatives are reused.
+        /// \param[out] _derivatives Derivatives of the step
+        public: void GetStepDerivatives(StepDerivatives &_derivatives) const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using StepDerivatives = StepDerivativesT<PolicyT>;
+
+        /// \brief Implementation API for GetStepDerivatives
+        /// \param[in] _modelID Identity of the model
+        /// \param[out] _derivatives Derivatives of the step
+        public: virtual void GetModelStepDerivatives(
+            const Identity &_modelID, StepDerivatives &_derivatives) const = 0;
+      };
+    };
+  }
+}
+
+#include <gz/physics/detail/ModelDynamics.hh>
+
+#endif
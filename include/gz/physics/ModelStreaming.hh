@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+
+#ifndef GZ_PHYSICS_MODELSTREAMING_HH_
+#define GZ_PHYSICS_MODELSTREAMING_HH_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <gz/physics/Export.hh>
+#include <gz/physics/Geometry.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    // Forward declaration
+    class ModelStreamingPrivate;
+
+    /////////////////////////////////////////////////
+    /// \brief Bookkeeping to page the models of a world that is too large
+    /// to keep constructed, e.g. a city, in and out around tracked points
+    /// such as the poses of robots.
+    ///
+    /// Each model that can be paged is a placement: a sphere in the world
+    /// frame, kept in a grid so that an update only visits the placements
+    /// near the tracked points and the ones that are loaded. A placement is
+    /// loaded once its sphere comes within the load radius of a tracked
+    /// point, and unloaded once it is a further hysteresis away from all of
+    /// them. Each update loads and unloads at most a budget of placements,
+    /// nearest first for loads and furthest first for unloads, so a
+    /// tracked point that jumps into a dense area spreads the construction
+    /// of its models over several steps instead of stalling one.
+    ///
+    /// This class only decides which placements are loaded. The application
+    /// constructs and removes the models, and hands the state of each
+    /// unloaded model back with SaveState so that it can be restored when
+    /// the model is constructed again. For the models of an sdf::World,
+    /// sdf::StreamSdfModels does all of that. A typical step looks like
+    /// this:
+    /// 1. Move the tracked points with SetTrackedPoints().
+    /// 2. Move the placements of the loaded models that moved with
+    ///    MovePlacement().
+    /// 3. Call Update(), and save the state of the models to unload.
+    /// 4. Remove the models to unload and construct the models to load.
+    /// 5. Step the world.
+    class GZ_PHYSICS_VISIBLE ModelStreaming
+    {
+      /// \brief Parameters of the paging.
+      public: struct Parameters
+      {
+        /// \brief Distance from a tracked point within which placements are
+        /// loaded, in meters.
+        double loadRadius = 100.0;
+
+        /// \brief Distance beyond the load radius that a placement has to
+        /// be from every tracked point before it is unloaded, in meters.
+        double hysteresis = 10.0;
+
+        /// \brief Size of the cells of the grid of placements, in meters.
+        /// Cells about the size of the load radius keep the number of cells
+        /// visited by an update small.
+        double cellSize = 50.0;
+
+        /// \brief Largest number of placements loaded by an update, or 0
+        /// for no limit.
+        std::size_t maxLoadsPerUpdate = 16u;
+
+        /// \brief Largest number of placements unloaded by an update, or 0
+        /// for no limit.
+        std::size_t maxUnloadsPerUpdate = 16u;
+      };
+
+      /// \brief State of a model captured when it was unloaded.
+      public: struct State
+      {
+        /// \brief Pose of the model, e.g. of its free group, in the world
+        /// frame.
+        Pose3d pose = Pose3d::Identity();
+
+        /// \brief Linear velocity in the world frame.
+        LinearVector3d linearVelocity = LinearVector3d::Zero();
+
+        /// \brief Angular velocity in the world frame.
+        AngularVector3d angularVelocity = AngularVector3d::Zero();
+      };
+
+      /// \brief Changes found by the most recent call to Update().
+      public: struct Changes
+      {
+        /// \brief Placements to load, nearest first.
+        std::vector<std::size_t> loads;
+        /// \brief Placements to unload, furthest first.
+        std::vector<std::size_t> unloads;
+      };
+
+      /// \brief Constructor with the default parameters.
+      public: ModelStreaming();
+
+      /// \brief Constructor
+      /// \param[in] _parameters Parameters of the paging. A cell size that
+      /// is not positive is replaced by the default.
+      public: explicit ModelStreaming(const Parameters &_parameters);
+
+      /// \brief Destructor
+      public: ~ModelStreaming();
+
+      /// \brief Get the parameters.
+      /// \return Parameters of the paging.
+      public: const Parameters &GetParameters() const;
+
+      /// \brief Add a placement. Placements start out unloaded.
+      /// \param[in] _position Center of the placement in the world frame.
+      /// \param[in] _radius Radius of the placement, e.g. of the bounding
+      /// sphere of its model, in meters.
+      /// \return Index of the placement. Placements are numbered in the
+      /// order they are added.
+      public: std::size_t AddPlacement(const LinearVector3d &_position,
+                                       double _radius = 0.0);
+
+      /// \brief Get the number of placements.
+      /// \return Number of placements.
+      public: std::size_t PlacementCount() const;
+
+      /// \brief Move a placement, e.g. because its model moved while it was
+      /// loaded.
+      /// \param[in] _placement Index of the placement.
+      /// \param[in] _position New center in the world frame.
+      public: void MovePlacement(std::size_t _placement,
+                                 const LinearVector3d &_position);
+
+      /// \brief Get the center of a placement.
+      /// \param[in] _placement Index of the placement.
+      /// \return Center in the world frame, or zero if the index is
+      /// invalid.
+      public: LinearVector3d PlacementPosition(std::size_t _placement) const;
+
+      /// \brief Set the points around which placements are loaded. Without
+      /// points every placement is unloaded.
+      /// \param[in] _points Points in the world frame.
+      public: void SetTrackedPoints(
+          const std::vector<LinearVector3d> &_points);
+
+      /// \brief Get the points around which placements are loaded.
+      /// \return Points in the world frame.
+      public: const std::vector<LinearVector3d> &GetTrackedPoints() const;
+
+      /// \brief Decide which placements to load and unload. The placements
+      /// that are returned are marked as loaded or unloaded, so the
+      /// application is expected to apply every change.
+      /// \return Changes of this update. The reference stays valid until
+      /// the next call.
+      public: const Changes &Update();
+
+      /// \brief Get the number of placements that are within the load
+      /// radius but were left unloaded by the last update because of its
+      /// budget.
+      /// \return Number of placements still to load.
+      public: std::size_t PendingLoadCount() const;
+
+      /// \brief Get whether a placement is loaded.
+      /// \param[in] _placement Index of the placement.
+      /// \return True if it is loaded.
+      public: bool IsLoaded(std::size_t _placement) const;
+
+      /// \brief Get the loaded placements.
+      /// \return Indices of the loaded placements, in no particular order.
+      public: const std::vector<std::size_t> &LoadedPlacements() const;
+
+      /// \brief Save the state of the model of a placement, typically right
+      /// before it is unloaded. The placement is moved to the position of
+      /// the state.
+      /// \param[in] _placement Index of the placement.
+      /// \param[in] _state State of its model.
+      public: void SaveState(std::size_t _placement, const State &_state);
+
+      /// \brief Get the state saved for a placement.
+      /// \param[in] _placement Index of the placement.
+      /// \return The state, or nullptr if none was saved. The pointer stays
+      /// valid as long as this object.
+      public: const State *SavedState(std::size_t _placement) const;
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<ModelStreamingPrivate> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+  }
+}
+
+#endif
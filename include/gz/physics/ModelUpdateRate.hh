@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MODELUPDATERATE_HH_
+#define GZ_PHYSICS_MODELUPDATERATE_HH_
+
+#include <gz/physics/FeatureList.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief ModelUpdateRateFeature lets a model be updated less often
+    /// than its world is stepped, e.g. a slow conveyor or distant traffic
+    /// at 50 Hz in a world stepped at 1 kHz. In the steps between two
+    /// updates the model is skipped, so it holds its pose, is not reported
+    /// in ChangedWorldPoses, and costs nothing to integrate. An update
+    /// integrates the whole time since the previous one. Collision checks
+    /// reuse the bounding boxes of models that were not updated. Models
+    /// with the same rate are spread over the steps of their period, so
+    /// that the work of each step stays even.
+    class GZ_PHYSICS_VISIBLE ModelUpdateRateFeature : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        /// \brief Set the update rate of the model.
+        /// \param[in] _rate Updates per second. A value of 0 (default), or a
+        /// rate at or above the step rate of the world, updates the model in
+        /// every step.
+        public: void SetUpdateRate(double _rate);
+
+        /// \brief Get the update rate of the model.
+        /// \return Updates per second, 0 if the model is updated in every
+        /// step.
+        public: double GetUpdateRate() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for SetUpdateRate
+        /// \param[in] _modelID Identity of the model
+        /// \param[in] _rate Updates per second
+        public: virtual void SetModelUpdateRate(
+            const Identity &_modelID, double _rate) = 0;
+
+        /// \brief Implementation API for GetUpdateRate
+        /// \param[in] _modelID Identity of the model
+        /// \return Updates per second
+        public: virtual double GetModelUpdateRate(
+            const Identity &_modelID) const = 0;
+      };
+    };
+  }
+}
+
+#include <gz/physics/detail/ModelUpdateRate.hh>
+
+#endif
@@ -18,9 +18,6 @@
 #ifndef GZ_PHYISCS_OPERATEONSPECIFIEDDATA_HH_
 #define GZ_PHYISCS_OPERATEONSPECIFIEDDATA_HH_
 
-#include <string>
-#include <unordered_set>
-
 #include "gz/physics/SpecifyData.hh"
 #include "gz/physics/DataStatusMask.hh"
 
@@ -28,6 +25,12 @@ namespace gz
 {
   namespace physics
   {
+    // Forward declarations
+    namespace detail
+    {
+      template <typename...> struct SpecifiedDataList;
+    }
+
     /// \brief OperateOnSpecifiedData allows us to statically analyze
     /// whether a class (Performer) can perform an operation on all the
     /// relevant types within a CompositeData Specification. It also provides
@@ -63,6 +66,9 @@ namespace gz
       /// information is used to tune the behavior to only perform the
       /// operations on components of _data that meet the criteria.
       ///
+      /// The data types of Specification are collected at compile time, so
+      /// this is a flat loop over a table with one entry per distinct type.
+      ///
       /// Setting onlyCompile to true will short-circuit the entire operation.
       /// This can be useful for static analysis. The function will cost very
       /// nearly nothing during run-time, but it will prevent code from
@@ -87,38 +93,19 @@ namespace gz
 
       // -------------------- Private API -----------------------
 
-      /// The data structure that will be used to ensure that the same data does
-      /// not get operated on twice, even if it is listed twice (redundantly) in
-      /// the specification.
-      private: using History = std::unordered_set<std::string>;
-
-      /// \brief When SubSpecification is able to provide one of the desired
-      /// data specifications, this overload gets called.
-      private: template <typename Data, typename SubSpecification,
-                        typename CompositeType>
-      static void SubOperate(
-          detail::type<Data>, detail::type<SubSpecification>,
+      /// \brief Perform Operation on the Data type of _data if it satisfies
+      /// _mask. This is the type-erased entry of the dispatch table of
+      /// Operate.
+      private: template <typename Data, typename CompositeType>
+      static void OperateIfSatisfied(
           Performer *_performer, CompositeType &_data,
-          const DataStatusMask &_mask,
-          History &_history);
-
-      /// \brief When SubSpecification could not provide one of the desired data
-      /// specifications, we will instead search it for sub-specifications.
-      private: template <typename SubSpecification, typename CompositeType>
-      static void SubOperate(
-          detail::type<void>, detail::type<SubSpecification>,
-          Performer *_performer, CompositeType &_data,
-          const DataStatusMask &_mask,
-          History &_history);
+          const DataStatusMask &_mask);
 
-      /// \brief When SubSpecification does not have the desired data
-      /// specifications, nor has any sub-specifications, we terminate here.
-      private: template <typename CompositeType>
-      static void SubOperate(
-          detail::type<void>, detail::type<void>,
-          Performer*, CompositeType&,
-          const DataStatusMask&,
-          History&);
+      /// \brief Dispatch table of the specified data types, listing each type
+      /// once in the order in which the specification declares it, even if it
+      /// is listed twice (redundantly) in the specification.
+      private: template <typename CompositeType, typename... Data>
+      static constexpr auto Operations(detail::SpecifiedDataList<Data...>);
     };
   }
 }
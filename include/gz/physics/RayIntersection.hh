@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GZ_PHYSICS_RAYINTERSECTION_HH_
+#define GZ_PHYSICS_RAYINTERSECTION_HH_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <gz/physics/Entity.hh>
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/Geometry.hh>
+
+namespace gz
+{
+namespace physics
+{
+/// \brief RayIntersectionFeature casts batches of rays against the collision
+/// shapes of a world and reports the closest hit of each ray, e.g. for range
+/// sensors that would otherwise need a collision scene of their own.
+class GZ_PHYSICS_VISIBLE RayIntersectionFeature : public virtual Feature
+{
+  /// \brief Closest hits of a batch of rays as parallel arrays. Element i of
+  /// each array belongs to ray i. The arrays are views into buffers owned by
+  /// the physics engine. They stay valid until rays are cast again in the
+  /// same world.
+  public: template <typename PolicyT>
+  struct RayIntersectionBatchT
+  {
+    using Scalar = typename PolicyT::Scalar;
+    using VectorType = typename FromPolicy<PolicyT>::template Use<Vector>;
+
+    /// \brief Number of rays
+    std::size_t size = 0u;
+    /// \brief Distance from the start of the ray to the hit, or infinity if
+    /// the ray hit nothing
+    const Scalar *distance = nullptr;
+    /// \brief Surface normal at the hit expressed in the world frame, or NaN
+    /// if the ray hit nothing
+    const VectorType *normal = nullptr;
+    /// \brief Entity ID of the collision shape that was hit, or
+    /// INVALID_ENTITY_ID if the ray hit nothing
+    const std::size_t *shape = nullptr;
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using VectorType =
+        typename FromPolicy<PolicyT>::template Use<Vector>;
+    public: using RayIntersectionBatch = RayIntersectionBatchT<PolicyT>;
+
+    /// \brief Cast rays against the collision shapes of this world, at the
+    /// poses of the last step. Ray i starts at _from[i] and ends at _to[i],
+    /// both expressed in the world frame. Rays that start inside a solid
+    /// shape may not hit it.
+    /// \param[in] _from Start of each ray
+    /// \param[in] _to End of each ray
+    /// \param[in] _count Number of rays
+    /// \param[in] _numThreads Number of threads to cast the rays with. A
+    /// value of 0 uses one thread per core, 1 (default) casts them on the
+    /// calling thread. The hits do not depend on it.
+    /// \return Closest hit of each ray
+    public: RayIntersectionBatch CastRays(
+        const VectorType *_from, const VectorType *_to, std::size_t _count,
+        std::size_t _numThreads = 1u) const;
+
+    /// \brief Cast rays against the collision shapes of this world. Same as
+    /// the function above, for as many rays as the shorter of _from and _to
+    /// holds.
+    /// \param[in] _from Start of each ray
+    /// \param[in] _to End of each ray
+    /// \param[in] _numThreads Number of threads to cast the rays with
+    /// \return Closest hit of each ray
+    public: RayIntersectionBatch CastRays(
+        const std::vector<VectorType> &_from,
+        const std::vector<VectorType> &_to,
+        std::size_t _numThreads = 1u) const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using Scalar = typename PolicyT::Scalar;
+    public: using VectorType =
+        typename FromPolicy<PolicyT>::template Use<Vector>;
+    public: using RayIntersectionBatch = RayIntersectionBatchT<PolicyT>;
+
+    /// \brief Buffers that an implementation can fill and return views of.
+    public: struct RayIntersectionStorage
+    {
+      std::vector<Scalar> distance;
+      std::vector<VectorType> normal;
+      std::vector<std::size_t> shape;
+
+      /// \brief Resize the buffers to a number of rays and mark all of them
+      /// as misses, keeping the allocated memory
+      void Reset(std::size_t _count);
+
+      /// \brief Record the hit of a ray
+      void Set(std::size_t _index, Scalar _distance,
+               const VectorType &_normal, std::size_t _shape);
+
+      /// \brief Views of the buffers
+      RayIntersectionBatch View() const;
+    };
+
+    /// \brief Helper for implementations. Split [0, _count) into _chunks
+    /// contiguous ranges and get one task per range that calls
+    /// _cast(_begin, _end) for it.
+    /// \param[in] _count Number of rays.
+    /// \param[in] _chunks Number of ranges.
+    /// \param[in] _cast Casts the rays of a range. Calls for different
+    /// ranges must not share mutable state. It must outlive the tasks.
+    /// \return Tasks to run, possibly in parallel.
+    public: template <typename CastT>
+    static std::vector<std::function<void()>> RayChunkTasks(
+        std::size_t _count, std::size_t _chunks, const CastT &_cast);
+
+    public: virtual RayIntersectionBatch CastWorldRays(
+        const Identity &_worldID,
+        const VectorType *_from,
+        const VectorType *_to,
+        std::size_t _count,
+        std::size_t _numThreads) const = 0;
+  };
+};
+}
+}
+
+#include "gz/physics/detail/RayIntersection.hh"
+
+#endif /* end of include guard: GZ_PHYSICS_RAYINTERSECTION_HH_ */
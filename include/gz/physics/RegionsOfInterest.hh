@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_REGIONSOFINTEREST_HH_
+#define GZ_PHYSICS_REGIONSOFINTEREST_HH_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <gz/physics/Export.hh>
+#include <gz/physics/Geometry.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    // Forward declaration
+    class RegionsOfInterestPrivate;
+
+    /////////////////////////////////////////////////
+    /// \brief Level of detail of the simulation of a model.
+    enum class SimulationFidelity
+    {
+      /// \brief The model is simulated as usual.
+      kFull = 0,
+
+      /// \brief The model is put to sleep. Engines that wake models on
+      /// contact with awake ones wake it when something pushes it.
+      kSleeping = 1,
+
+      /// \brief The model is made kinematic, so it holds its pose and costs
+      /// nothing to integrate, whatever touches it.
+      kKinematic = 2
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Bookkeeping to simulate a large world at a cost proportional
+    /// to the parts of it that matter, e.g. the surroundings of a robot and
+    /// the view of a camera.
+    ///
+    /// The regions of interest are boxes in the world frame. Models whose
+    /// bounding boxes are within the full margin of a region are simulated
+    /// at full fidelity, models within the sleep margin are put to sleep,
+    /// and models further away are made kinematic. Models are only
+    /// downgraded once they are a further hysteresis away, which keeps
+    /// models at a margin from switching back and forth.
+    ///
+    /// This class only decides the fidelity of each model, and reports a
+    /// change only when the fidelity does, so a model that the application
+    /// wakes stays awake until it crosses a margin again. A typical step
+    /// looks like this:
+    /// 1. Move the regions, e.g. to the pose of the robot, with SetRegions().
+    /// 2. Collect the boxes of the models, e.g. with GetModelBoundingBoxes,
+    ///    and pass them to Update().
+    /// 3. Apply each change with ApplySimulationFidelity.
+    /// 4. Step the world.
+    class GZ_PHYSICS_VISIBLE RegionsOfInterest
+    {
+      /// \brief Parameters of the levels of detail.
+      public: struct Parameters
+      {
+        /// \brief Distance from a region within which models are simulated
+        /// at full fidelity, in meters.
+        double fullMargin = 1.0;
+
+        /// \brief Distance from a region within which models are put to
+        /// sleep, in meters. Models further away are made kinematic. A
+        /// margin below the full margin leaves out the sleeping level.
+        double sleepMargin = 10.0;
+
+        /// \brief Distance beyond a margin that a model has to move before
+        /// it is downgraded, in meters.
+        double hysteresis = 0.5;
+      };
+
+      /// \brief A change of the fidelity of a model.
+      public: struct Change
+      {
+        /// \brief ID of the model.
+        std::size_t model;
+        /// \brief Previous fidelity.
+        SimulationFidelity from;
+        /// \brief New fidelity.
+        SimulationFidelity to;
+      };
+
+      /// \brief Constructor with the default parameters.
+      public: RegionsOfInterest();
+
+      /// \brief Constructor
+      /// \param[in] _parameters Parameters of the levels of detail.
+      public: explicit RegionsOfInterest(const Parameters &_parameters);
+
+      /// \brief Destructor
+      public: ~RegionsOfInterest();
+
+      /// \brief Get the parameters.
+      /// \return Parameters of the levels of detail.
+      public: const Parameters &GetParameters() const;
+
+      /// \brief Set the regions of interest. Without regions every model is
+      /// simulated at full fidelity.
+      /// \param[in] _regions Boxes of the regions in the world frame, e.g.
+      /// the box of a camera frustum.
+      public: void SetRegions(const std::vector<AlignedBox3d> &_regions);
+
+      /// \brief Get the regions of interest.
+      /// \return Boxes of the regions in the world frame.
+      public: const std::vector<AlignedBox3d> &GetRegions() const;
+
+      /// \brief Update the fidelity of the models. Models start at full
+      /// fidelity. Models that were passed to the previous call but not to
+      /// this one are forgotten without a change.
+      /// \param[in] _models ID of each model. IDs must be unique.
+      /// \param[in] _boxes Bounding box of each model in the world frame.
+      /// Models with an empty box are treated as removed.
+      /// \param[in] _count Number of models.
+      /// \return Changes since the previous call, ordered by model ID. The
+      /// reference stays valid until the next call.
+      public: const std::vector<Change> &Update(const std::size_t *_models,
+                                                const AlignedBox3d *_boxes,
+                                                std::size_t _count);
+
+      /// \brief Get the fidelity of a model.
+      /// \param[in] _model ID of the model.
+      /// \return Fidelity of the model, kFull if it is unknown.
+      public: SimulationFidelity FidelityOf(std::size_t _model) const;
+
+      /// \brief Get the number of models at a fidelity.
+      /// \param[in] _fidelity Fidelity to count.
+      /// \return Number of models at the fidelity.
+      public: std::size_t CountOf(SimulationFidelity _fidelity) const;
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<RegionsOfInterestPrivate> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Make a model match a change of its fidelity.
+    /// \param[in] _model Model with SleepFeature and KinematicModelFeature.
+    /// The model must not be kinematic for other reasons, since restoring
+    /// full fidelity makes it dynamic again.
+    /// \param[in] _change Change reported by RegionsOfInterest::Update.
+    template <typename ModelPtrT>
+    void ApplySimulationFidelity(const ModelPtrT &_model,
+                                 const RegionsOfInterest::Change &_change)
+    {
+      if (_change.from == SimulationFidelity::kKinematic)
+        _model->SetKinematic(false);
+
+      switch (_change.to)
+      {
+        case SimulationFidelity::kFull:
+          _model->SetSleeping(false);
+          break;
+        case SimulationFidelity::kSleeping:
+          _model->SetSleeping(true);
+          break;
+        case SimulationFidelity::kKinematic:
+          _model->SetSleeping(false);
+          _model->SetKinematic(true);
+          break;
+      }
+    }
+  }
+}
+
+#endif
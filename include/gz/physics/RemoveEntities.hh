@@ -18,7 +18,9 @@
 #ifndef GZ_PHYSICS_REMOVEENTITIES_HH_
 #define GZ_PHYSICS_REMOVEENTITIES_HH_
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include <gz/physics/FeatureList.hh>
 
@@ -109,10 +111,41 @@ namespace gz
       };
     };
 
+    /////////////////////////////////////////////////
+    /// \brief This feature removes many Model entities from a World at once.
+    /// Engines can update their bookkeeping once for the whole batch, which
+    /// is much faster than removing the models one by one when models are
+    /// spawned and despawned at a high rate.
+    class GZ_PHYSICS_VISIBLE RemoveModelsFromWorld
+        : public virtual FeatureWithRequirements<RemoveModelFromWorld>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Remove Models that exist within this World.
+        /// \param[in] _names
+        ///   Names of the models within this world.
+        /// \return Number of models that were found and removed.
+        public: std::size_t RemoveModels(
+            const std::vector<std::string> &_names);
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: virtual std::size_t RemoveModelsByName(
+            const Identity &_worldID,
+            const std::vector<std::string> &_modelNames) = 0;
+      };
+    };
+
     using RemoveEntities = FeatureList<
       RemoveModelFromWorld,
       RemoveNestedModelFromModel
     >;
+
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(RemoveModelFromWorld)
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(RemoveNestedModelFromModel)
   }
 }
 
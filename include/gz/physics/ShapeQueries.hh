@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GZ_PHYSICS_SHAPEQUERIES_HH_
+#define GZ_PHYSICS_SHAPEQUERIES_HH_
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/Geometry.hh>
+#include <gz/physics/RayIntersection.hh>
+
+namespace gz
+{
+namespace physics
+{
+/// \brief ShapeQueryFeature sweeps spheres and boxes through a world and
+/// finds the collision shapes that overlap them, e.g. to plan grasps or to
+/// check that a spawn location is free. Queries are answered from the
+/// broadphase and shapes of the engine at the poses of the last step, and do
+/// not change the world.
+class GZ_PHYSICS_VISIBLE ShapeQueryFeature : public virtual Feature
+{
+  /// \brief A sphere or box to query a world with.
+  public: template <typename PolicyT>
+  struct QueryVolumeT
+  {
+    using Scalar = typename PolicyT::Scalar;
+    using VectorType = typename FromPolicy<PolicyT>::template Use<Vector>;
+    using PoseType = typename FromPolicy<PolicyT>::template Use<Pose>;
+
+    enum class Type
+    {
+      SPHERE,
+      BOX
+    };
+
+    /// \brief Make a sphere
+    /// \param[in] _center Center of the sphere in the world frame
+    /// \param[in] _radius Radius of the sphere
+    static QueryVolumeT Sphere(const VectorType &_center, Scalar _radius);
+
+    /// \brief Make a box
+    /// \param[in] _pose Pose of the center of the box in the world frame
+    /// \param[in] _size Size of the box along its axes
+    static QueryVolumeT Box(const PoseType &_pose, const VectorType &_size);
+
+    /// \brief Kind of volume
+    Type type = Type::SPHERE;
+    /// \brief Pose of the center of the volume in the world frame. Only the
+    /// position matters for spheres.
+    PoseType pose = PoseType::Identity();
+    /// \brief Radius of a sphere
+    Scalar radius = Scalar(0);
+    /// \brief Size of a box along its axes
+    VectorType size = VectorType::Zero();
+  };
+
+  /// \brief Closest hits of a batch of sweeps. Element i of each array
+  /// belongs to volume i, see RayIntersectionFeature::RayIntersectionBatchT.
+  /// The distance is how far the volume travelled before touching the shape.
+  public: template <typename PolicyT>
+  using ShapeCastBatchT =
+      RayIntersectionFeature::RayIntersectionBatchT<PolicyT>;
+
+  /// \brief Shapes overlapping each volume of a batch, in compressed rows.
+  /// The shapes overlapping volume i are shape[offset[i]] up to, but not
+  /// including, shape[offset[i + 1]], sorted by entity ID. The arrays are
+  /// views into buffers owned by the physics engine. They stay valid until
+  /// overlaps are queried again in the same world.
+  public: template <typename PolicyT>
+  struct OverlapBatchT
+  {
+    /// \brief Number of volumes
+    std::size_t size = 0u;
+    /// \brief size + 1 offsets into shape
+    const std::size_t *offset = nullptr;
+    /// \brief Entity IDs of the overlapping collision shapes
+    const std::size_t *shape = nullptr;
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using VectorType =
+        typename FromPolicy<PolicyT>::template Use<Vector>;
+    public: using QueryVolume = QueryVolumeT<PolicyT>;
+    public: using ShapeCastBatch = ShapeCastBatchT<PolicyT>;
+    public: using OverlapBatch = OverlapBatchT<PolicyT>;
+
+    /// \brief Sweep volumes through this world without rotating them. Volume
+    /// i moves from the position in _volumes[i].pose to _to[i], both in the
+    /// world frame. Volumes that already overlap a shape at the start of
+    /// their sweep may report it at distance 0 or not at all, query overlaps
+    /// first where that matters.
+    /// \param[in] _volumes Volumes at the start of their sweep
+    /// \param[in] _to End of the sweep of the center of each volume
+    /// \param[in] _count Number of volumes
+    /// \param[in] _numThreads Number of threads to sweep the volumes with. A
+    /// value of 0 uses one thread per core, 1 (default) sweeps them on the
+    /// calling thread. Engines may use fewer threads.
+    /// \return Closest hit of each sweep
+    public: ShapeCastBatch CastShapes(
+        const QueryVolume *_volumes, const VectorType *_to,
+        std::size_t _count, std::size_t _numThreads = 1u) const;
+
+    /// \brief Sweep volumes through this world. Same as the function above,
+    /// for as many volumes as the shorter of _volumes and _to holds.
+    /// \param[in] _volumes Volumes at the start of their sweep
+    /// \param[in] _to End of the sweep of the center of each volume
+    /// \param[in] _numThreads Number of threads to sweep the volumes with
+    /// \return Closest hit of each sweep
+    public: ShapeCastBatch CastShapes(
+        const std::vector<QueryVolume> &_volumes,
+        const std::vector<VectorType> &_to,
+        std::size_t _numThreads = 1u) const;
+
+    /// \brief Find the collision shapes of this world that overlap volumes.
+    /// \param[in] _volumes Volumes to test
+    /// \param[in] _count Number of volumes
+    /// \param[in] _numThreads Number of threads to test the volumes with, as
+    /// in CastShapes
+    /// \return Overlapping shapes of each volume
+    public: OverlapBatch FindOverlaps(
+        const QueryVolume *_volumes, std::size_t _count,
+        std::size_t _numThreads = 1u) const;
+
+    /// \brief Find the collision shapes of this world that overlap volumes.
+    /// \param[in] _volumes Volumes to test
+    /// \param[in] _numThreads Number of threads to test the volumes with
+    /// \return Overlapping shapes of each volume
+    public: OverlapBatch FindOverlaps(
+        const std::vector<QueryVolume> &_volumes,
+        std::size_t _numThreads = 1u) const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using VectorType =
+        typename FromPolicy<PolicyT>::template Use<Vector>;
+    public: using QueryVolume = QueryVolumeT<PolicyT>;
+    public: using ShapeCastBatch = ShapeCastBatchT<PolicyT>;
+    public: using OverlapBatch = OverlapBatchT<PolicyT>;
+
+    /// \brief Buffers that an implementation can fill and return views of.
+    public: struct OverlapStorage
+    {
+      std::vector<std::size_t> offset;
+      std::vector<std::size_t> shape;
+
+      /// \brief Fill the buffers from the overlapping shapes of each volume,
+      /// keeping the allocated memory. Each list is sorted.
+      /// \param[in,out] _overlaps Overlapping shapes of each volume
+      void Assign(std::vector<std::vector<std::size_t>> &_overlaps);
+
+      /// \brief Views of the buffers
+      OverlapBatch View() const;
+    };
+
+    public: virtual ShapeCastBatch CastWorldShapes(
+        const Identity &_worldID,
+        const QueryVolume *_volumes,
+        const VectorType *_to,
+        std::size_t _count,
+        std::size_t _numThreads) const = 0;
+
+    public: virtual OverlapBatch FindWorldOverlaps(
+        const Identity &_worldID,
+        const QueryVolume *_volumes,
+        std::size_t _count,
+        std::size_t _numThreads) const = 0;
+  };
+};
+
+/// \brief ShapeDistanceFeature computes the distances between collision
+/// shapes, with the points of each shape that are closest to the other, e.g.
+/// for the constraints of a model predictive controller or for safety
+/// monitors that must act before shapes touch. Distances are computed at
+/// the poses of the last step, and do not change the world.
+///
+/// Distances are signed: they are negative when the shapes penetrate, by as
+/// much as the engine can resolve. Pairs whose bounding boxes are farther
+/// apart than a cutoff are skipped without computing their distance.
+class GZ_PHYSICS_VISIBLE ShapeDistanceFeature : public virtual Feature
+{
+  /// \brief Distance between two collision shapes.
+  public: template <typename PolicyT>
+  struct ShapeDistanceT
+  {
+    using Scalar = typename PolicyT::Scalar;
+    using VectorType = typename FromPolicy<PolicyT>::template Use<Vector>;
+
+    /// \brief False if the distance was not computed, because a shape is not
+    /// in the world, the engine cannot compute distances to one of the
+    /// shapes, or the shapes are farther apart than the cutoff.
+    bool valid = false;
+
+    /// \brief Entity ID of the first shape
+    std::size_t shape1 = 0u;
+
+    /// \brief Entity ID of the second shape
+    std::size_t shape2 = 0u;
+
+    /// \brief Signed distance between the shapes
+    Scalar distance = std::numeric_limits<Scalar>::infinity();
+
+    /// \brief Point of the first shape closest to the second shape, in the
+    /// world frame
+    VectorType point1 = VectorType::Zero();
+
+    /// \brief Point of the second shape closest to the first shape, in the
+    /// world frame
+    VectorType point2 = VectorType::Zero();
+
+    /// \brief Unit vector along which moving the second shape away from the
+    /// first one increases their distance, in the world frame. It is zero
+    /// if the engine cannot tell, e.g. for shapes that just touch.
+    VectorType normal = VectorType::Zero();
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using Scalar = typename PolicyT::Scalar;
+    public: using ShapeDistance = ShapeDistanceT<PolicyT>;
+    public: using ShapePair = std::pair<std::size_t, std::size_t>;
+
+    /// \brief Compute the distances between pairs of collision shapes of
+    /// this world.
+    /// \param[in] _pairs Entity IDs of the shapes of each pair
+    /// \param[in] _cutoff Pairs farther apart than this are not computed
+    /// \return Distance of each pair, in the order of _pairs
+    public: std::vector<ShapeDistance> ComputeShapeDistances(
+        const std::vector<ShapePair> &_pairs,
+        Scalar _cutoff = std::numeric_limits<Scalar>::infinity()) const;
+
+    /// \brief Compute the distances between the collision shapes of a set
+    /// of links and the other collision shapes of this world, such as those
+    /// of the obstacles around a robot. Pairs of shapes that both belong to
+    /// the set are not computed.
+    /// \param[in] _links Entity IDs of the links. Links that are not in this
+    /// world are skipped.
+    /// \param[in] _cutoff Largest distance to report
+    /// \return Distances of the pairs within _cutoff of each other, with
+    /// shape1 a shape of the links, sorted by shape1 and then shape2
+    public: std::vector<ShapeDistance> ComputeLinkDistances(
+        const std::vector<std::size_t> &_links, Scalar _cutoff) const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using Scalar = typename PolicyT::Scalar;
+    public: using ShapeDistance = ShapeDistanceT<PolicyT>;
+    public: using ShapePair = std::pair<std::size_t, std::size_t>;
+
+    /// \brief Implementation API for ComputeShapeDistances
+    /// \param[in] _worldID Identity of the world
+    /// \param[in] _pairs Entity IDs of the shapes of each pair
+    /// \param[in] _count Number of pairs
+    /// \param[in] _cutoff Pairs farther apart than this are not computed
+    /// \param[out] _results _count distances, in the order of _pairs
+    public: virtual void ComputeWorldShapeDistances(
+        const Identity &_worldID,
+        const ShapePair *_pairs,
+        std::size_t _count,
+        Scalar _cutoff,
+        ShapeDistance *_results) const = 0;
+
+    /// \brief Implementation API for ComputeLinkDistances
+    /// \param[in] _worldID Identity of the world
+    /// \param[in] _links Entity IDs of the links
+    /// \param[in] _cutoff Largest distance to report
+    /// \return Distances of the pairs within _cutoff of each other
+    public: virtual std::vector<ShapeDistance> ComputeWorldLinkDistances(
+        const Identity &_worldID,
+        const std::vector<std::size_t> &_links,
+        Scalar _cutoff) const = 0;
+  };
+};
+}
+}
+
+#include "gz/physics/detail/ShapeQueries.hh"
+
+#endif /* end of include guard: GZ_PHYSICS_SHAPEQUERIES_HH_ */
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_SHAREDSTATERING_HH_
+#define GZ_PHYSICS_SHAREDSTATERING_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gz/math/Pose3.hh>
+#include <gz/math/Vector3.hh>
+
+#include <gz/physics/Export.hh>
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/ForwardStep.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    // Forward declarations
+    class SharedStateRingWriterPrivate;
+    class SharedStateRingReaderPrivate;
+
+    /////////////////////////////////////////////////
+    /// \brief Capacities of a shared state ring, fixed when it is created.
+    struct SharedStateRingLayout
+    {
+      /// \brief Number of frames kept in the ring. A reader that falls
+      /// behind by more frames than this misses frames.
+      std::size_t slotCount = 4u;
+
+      /// \brief Maximum number of link poses of a frame
+      std::size_t maxPoses = 0u;
+
+      /// \brief Maximum number of joint degrees of freedom of a frame
+      std::size_t maxJointStates = 0u;
+
+      /// \brief Maximum number of contacts of a frame
+      std::size_t maxContacts = 0u;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Contact of a frame of a shared state ring, in the world frame.
+    struct SharedStateContact
+    {
+      /// \brief Entity ID of the collision shape of the first body
+      std::size_t collision1 = 0u;
+
+      /// \brief Entity ID of the collision shape of the second body
+      std::size_t collision2 = 0u;
+
+      /// \brief Position of the contact in the world frame, in meters
+      gz::math::Vector3d point;
+
+      /// \brief Normal of the force acting on the first body
+      gz::math::Vector3d normal;
+
+      /// \brief Penetration depth of the two bodies along the normal, in
+      /// meters
+      double depth = 0.0;
+
+      /// \brief Force acting on the first body
+      gz::math::Vector3d force;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief One frame read from a shared state ring.
+    struct SharedStateFrame
+    {
+      /// \brief Number of the frame, counted from 0 when the ring was
+      /// created.
+      uint64_t frame = 0u;
+
+      /// \brief Simulation time of the frame, in seconds
+      double time = 0.0;
+
+      /// \brief Whether the writer had more entries than the capacities of
+      /// the ring, in which case the entries that did not fit are missing.
+      bool truncated = false;
+
+      /// \brief Poses of the links in the world frame, by link entity ID
+      std::vector<WorldPose> poses;
+
+      /// \brief Joint states, without the annotation
+      JointStates joints;
+
+      /// \brief Contacts of the frame
+      std::vector<SharedStateContact> contacts;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Writes the state of a world into a ring of frames laid out in
+    /// memory that the caller provides, typically shared memory that other
+    /// processes map, so that they can follow the simulation without the
+    /// state being serialized for them.
+    ///
+    /// The memory starts with a 64 byte header followed by slotCount slots
+    /// of fixed size, each with capacity for the entries of one frame, see
+    /// SharedStateRingLayout. Every slot is guarded by a sequence lock: its
+    /// sequence number is odd while the slot is written, so readers never
+    /// wait for the writer, and retry when a slot changed while they read
+    /// it. The header has a format version, which SharedStateRingReader
+    /// checks. Values are stored in the byte order of the machine, so the
+    /// writer and readers have to run on the same machine.
+    ///
+    /// There is one writer per ring. A frame is written with BeginFrame,
+    /// any number of AddPose, AddJointState and AddContact calls, and
+    /// EndFrame, which publishes it.
+    class GZ_PHYSICS_VISIBLE SharedStateRingWriter
+    {
+      /// \brief Constructor
+      public: SharedStateRingWriter();
+
+      /// \brief Destructor. The memory is left as it is.
+      public: ~SharedStateRingWriter();
+
+      /// \brief Get the number of bytes of a ring.
+      /// \param[in] _layout Capacities of the ring.
+      /// \return Number of bytes to provide to Create.
+      public: static std::size_t RequiredBytes(
+          const SharedStateRingLayout &_layout);
+
+      /// \brief Lay out an empty ring in memory. The memory has to stay
+      /// valid until the writer is closed or destroyed, and be aligned to
+      /// 8 bytes.
+      /// \param[in] _memory Start of the memory.
+      /// \param[in] _bytes Number of bytes of the memory.
+      /// \param[in] _layout Capacities of the ring.
+      /// \return False if the memory is too small or misaligned, or if the
+      /// layout has no slots.
+      public: bool Create(void *_memory, std::size_t _bytes,
+                          const SharedStateRingLayout &_layout);
+
+      /// \brief Stop writing to the memory.
+      public: void Close();
+
+      /// \brief Get whether the writer has a ring.
+      /// \return True if Create succeeded and Close was not called.
+      public: bool IsOpen() const;
+
+      /// \brief Get the capacities of the ring.
+      /// \return The layout given to Create.
+      public: const SharedStateRingLayout &Layout() const;
+
+      /// \brief Start a frame in the next slot. Readers stop seeing the
+      /// frame that the slot held. A frame that was started before is ended.
+      /// \param[in] _time Simulation time of the frame.
+      /// \return False if the writer has no ring.
+      public: bool BeginFrame(double _time);
+
+      /// \brief Add the pose of a link to the current frame.
+      /// \param[in] _body Entity ID of the link.
+      /// \param[in] _pose Pose of the link in the world frame.
+      /// \return False if no frame was started or the frame is full.
+      public: bool AddPose(std::size_t _body, const gz::math::Pose3d &_pose);
+
+      /// \brief Add the state of a degree of freedom of a joint to the
+      /// current frame.
+      /// \param[in] _joint Entity ID of the joint.
+      /// \param[in] _dof Index of the degree of freedom in the joint.
+      /// \param[in] _position Position of the degree of freedom.
+      /// \param[in] _velocity Velocity of the degree of freedom.
+      /// \param[in] _acceleration Acceleration of the degree of freedom.
+      /// \param[in] _effort Effort of the degree of freedom.
+      /// \return False if no frame was started or the frame is full.
+      public: bool AddJointState(std::size_t _joint, std::size_t _dof,
+          double _position, double _velocity, double _acceleration,
+          double _effort);
+
+      /// \brief Add a contact to the current frame.
+      /// \param[in] _contact The contact
+      /// \return False if no frame was started or the frame is full.
+      public: bool AddContact(const SharedStateContact &_contact);
+
+      /// \brief Publish the current frame.
+      /// \return False if no frame was started.
+      public: bool EndFrame();
+
+      /// \brief Get the number of frames published since the ring was
+      /// created.
+      /// \return Number of frames.
+      public: uint64_t FrameCount() const;
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<SharedStateRingWriterPrivate> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Reads the frames of a ring written by SharedStateRingWriter,
+    /// possibly from another process. Any number of readers can read a ring
+    /// at the same time.
+    class GZ_PHYSICS_VISIBLE SharedStateRingReader
+    {
+      /// \brief Constructor
+      public: SharedStateRingReader();
+
+      /// \brief Destructor
+      public: ~SharedStateRingReader();
+
+      /// \brief Start reading a ring. The memory has to stay valid until
+      /// the reader is closed or destroyed.
+      /// \param[in] _memory Start of the memory of the ring.
+      /// \param[in] _bytes Number of bytes of the memory.
+      /// \return False if the memory does not hold a ring of this version
+      /// of the format.
+      public: bool Open(const void *_memory, std::size_t _bytes);
+
+      /// \brief Stop reading the memory.
+      public: void Close();
+
+      /// \brief Get whether the reader has a ring.
+      /// \return True if Open succeeded and Close was not called.
+      public: bool IsOpen() const;
+
+      /// \brief Get the capacities of the ring.
+      /// \return The layout that the ring was created with.
+      public: const SharedStateRingLayout &Layout() const;
+
+      /// \brief Get the number of frames the writer has published.
+      /// \return Number of frames.
+      public: uint64_t FrameCount() const;
+
+      /// \brief Read the last published frame. The buffers of _frame are
+      /// reused.
+      /// \param[out] _frame The frame
+      /// \return False if no frame was published yet.
+      public: bool ReadLatest(SharedStateFrame &_frame) const;
+
+      /// \brief Read a frame by its number, e.g. to read every frame in
+      /// order. The buffers of _frame are reused.
+      /// \param[in] _number Number of the frame.
+      /// \param[out] _frame The frame
+      /// \return False if the frame was not published yet, or was already
+      /// overwritten by a later frame.
+      public: bool Read(uint64_t _number, SharedStateFrame &_frame) const;
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<SharedStateRingReaderPrivate> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief SharedStateExportFeature makes a world write its state to a
+    /// SharedStateRingWriter at the end of each of its steps: the poses of
+    /// its links, the states of its joints and its contacts, as far as the
+    /// capacities of the ring allow. Plugins write the poses in the order of
+    /// WorldPoses and the joint states in the order of JointStates.
+    class GZ_PHYSICS_VISIBLE SharedStateExportFeature
+      : public virtual FeatureWithRequirements<ForwardStep>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Write the state of this world to a ring after each step.
+        /// \param[in] _writer Writer of a ring that was created, or nullptr
+        /// to stop writing. The world keeps a reference to it.
+        public: void SetSharedStateExport(
+            std::shared_ptr<SharedStateRingWriter> _writer)
+        {
+          this->template Interface<SharedStateExportFeature>()
+              ->SetWorldSharedStateExport(this->identity, std::move(_writer));
+        }
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for SetSharedStateExport
+        /// \param[in] _worldID Identity of the world
+        /// \param[in] _writer Writer of the ring, or nullptr
+        public: virtual void SetWorldSharedStateExport(
+            const Identity &_worldID,
+            std::shared_ptr<SharedStateRingWriter> _writer) = 0;
+      };
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_SLEEP_HH_
+#define GZ_PHYSICS_SLEEP_HH_
+
+#include <limits>
+
+#include <gz/physics/FeatureList.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief SleepFeature controls the sleep state of models. A sleeping
+    /// model is neither integrated nor checked for pose changes when a step
+    /// writes ChangedWorldPoses, so models at rest cost nothing per step. A
+    /// model is woken by SetSleeping(false), by setting its pose or velocity,
+    /// and, in engines that support it, by contact with an awake model.
+    class GZ_PHYSICS_VISIBLE SleepFeature : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        /// \brief Set whether the model may be put to sleep. Engines that put
+        /// models at rest to sleep on their own do so only for models whose
+        /// sleeping is enabled.
+        /// \param[in] _enabled True to allow the model to sleep. Disabling
+        /// sleeping wakes the model.
+        public: void SetSleepEnabled(bool _enabled);
+
+        /// \brief Get whether the model may be put to sleep.
+        /// \return True if the model may sleep.
+        public: bool GetSleepEnabled() const;
+
+        /// \brief Put the model to sleep or wake it up.
+        /// \param[in] _sleeping True to put the model to sleep, false to wake
+        /// it up. Putting a model to sleep has no effect if its sleeping is
+        /// disabled.
+        public: void SetSleeping(bool _sleeping);
+
+        /// \brief Get whether the model is sleeping.
+        /// \return True if the model is sleeping.
+        public: bool GetSleeping() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for SetSleepEnabled
+        /// \param[in] _modelID Identity of the model
+        /// \param[in] _enabled True to allow the model to sleep
+        public: virtual void SetModelSleepEnabled(
+            const Identity &_modelID, bool _enabled) = 0;
+
+        /// \brief Implementation API for GetSleepEnabled
+        /// \param[in] _modelID Identity of the model
+        /// \return True if the model may sleep
+        public: virtual bool GetModelSleepEnabled(
+            const Identity &_modelID) const = 0;
+
+        /// \brief Implementation API for SetSleeping
+        /// \param[in] _modelID Identity of the model
+        /// \param[in] _sleeping True to put the model to sleep
+        public: virtual void SetModelSleeping(
+            const Identity &_modelID, bool _sleeping) = 0;
+
+        /// \brief Implementation API for GetSleeping
+        /// \param[in] _modelID Identity of the model
+        /// \return True if the model is sleeping
+        public: virtual bool GetModelSleeping(
+            const Identity &_modelID) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief SleepThresholdsFeature sets when an engine puts a model at rest
+    /// to sleep on its own: a model whose sleeping is enabled goes to sleep
+    /// once its links have moved slower than the thresholds for the timeout.
+    ///
+    /// Engines measure the motion of a model in their own way, so the
+    /// thresholds are only roughly comparable between them. Engines that
+    /// bound a single measure of the motion of a whole model bound the sum of
+    /// the squares of the two thresholds, and engines that share one timeout
+    /// between all of their models use the last one that was set.
+    class GZ_PHYSICS_VISIBLE SleepThresholdsFeature
+      : public virtual FeatureWithRequirements<SleepFeature>
+    {
+      /// \brief Thresholds used to put a model to sleep.
+      public: template <typename PolicyT>
+      struct SleepThresholdsT
+      {
+        using Scalar = typename PolicyT::Scalar;
+
+        /// \brief Linear speed below which a link is at rest, in m/s
+        Scalar linearSpeed = 0;
+
+        /// \brief Angular speed below which a link is at rest, in rad/s
+        Scalar angularSpeed = 0;
+
+        /// \brief Time that all the links of the model must be at rest for
+        /// before it is put to sleep, in seconds
+        Scalar timeout = std::numeric_limits<Scalar>::infinity();
+      };
+
+      public: template <typename PolicyT, typename FeaturesT>
+      class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+      {
+        public: using SleepThresholds = SleepThresholdsT<PolicyT>;
+
+        /// \brief Set the thresholds used to put this model to sleep.
+        /// \param[in] _thresholds Thresholds of the model. Speeds of zero
+        /// keep the model from going to sleep on its own.
+        public: void SetSleepThresholds(const SleepThresholds &_thresholds);
+
+        /// \brief Get the thresholds used to put this model to sleep.
+        /// \return Thresholds of the model
+        public: SleepThresholds GetSleepThresholds() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        public: using SleepThresholds = SleepThresholdsT<PolicyT>;
+
+        /// \brief Implementation API for SetSleepThresholds
+        /// \param[in] _modelID Identity of the model
+        /// \param[in] _thresholds Thresholds of the model
+        public: virtual void SetModelSleepThresholds(
+            const Identity &_modelID, const SleepThresholds &_thresholds) = 0;
+
+        /// \brief Implementation API for GetSleepThresholds
+        /// \param[in] _modelID Identity of the model
+        /// \return Thresholds of the model
+        public: virtual SleepThresholds GetModelSleepThresholds(
+            const Identity &_modelID) const = 0;
+      };
+    };
+  }
+}
+
+#include <gz/physics/detail/Sleep.hh>
+
+#endif
@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_STATELOG_HH_
+#define GZ_PHYSICS_STATELOG_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gz/physics/Export.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    // Forward declarations
+    class StateLogWriterPrivate;
+    class StateLogReaderPrivate;
+
+    /// \brief Channels of a state log frame that gz-physics knows the
+    /// contents of. Applications can add their own channels from kUser on.
+    namespace StateLogChannel
+    {
+      /// \brief A snapshot from WorldStateSnapshotFeature::World::SaveState.
+      constexpr uint32_t kSnapshot = 0;
+
+      /// \brief A frame of WorldPoseEncoder.
+      constexpr uint32_t kPoses = 1;
+
+      /// \brief Joint positions, in a format chosen by the application.
+      constexpr uint32_t kJointPositions = 2;
+
+      /// \brief Contacts, in a format chosen by the application.
+      constexpr uint32_t kContacts = 3;
+
+      /// \brief First channel that is free for applications.
+      constexpr uint32_t kUser = 1024;
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Appends the state of a world to a log file, one frame per step.
+    ///
+    /// Each frame holds the time and iteration of a step and any number of
+    /// channels of bytes, such as a world snapshot and encoded poses.
+    /// Frames are collected in memory and written in chunks, so recording
+    /// takes one write per chunk instead of one per step. A chunk that was
+    /// not completely written, e.g. because the process stopped, is skipped
+    /// by StateLogReader.
+    class GZ_PHYSICS_VISIBLE StateLogWriter
+    {
+      /// \brief Constructor
+      public: StateLogWriter();
+
+      /// \brief Destructor. Writes the frames that are still in memory.
+      public: ~StateLogWriter();
+
+      /// \brief Create a log file, replacing any existing file.
+      /// \param[in] _path Path of the file.
+      /// \param[in] _chunkBytes Size from which a chunk is written.
+      /// \return True if the file was created.
+      public: bool Open(const std::string &_path,
+                        std::size_t _chunkBytes = 1u << 20);
+
+      /// \brief Write the frames that are still in memory and close the
+      /// file.
+      public: void Close();
+
+      /// \brief Get whether a file is open.
+      /// \return True if a file is open.
+      public: bool IsOpen() const;
+
+      /// \brief Start a frame. A frame that was started before is ended.
+      /// \param[in] _time Simulation time of the frame.
+      /// \param[in] _iteration Step number of the frame.
+      /// \return False if no file is open.
+      public: bool BeginFrame(double _time, uint64_t _iteration);
+
+      /// \brief Add a channel to the current frame.
+      /// \param[in] _channel Channel ID, see StateLogChannel.
+      /// \param[in] _data Data of the channel.
+      /// \param[in] _size Number of bytes of _data.
+      /// \return False if no frame was started.
+      public: bool AddChannel(uint32_t _channel, const uint8_t *_data,
+                              std::size_t _size);
+
+      /// \brief Add a channel to the current frame, see AddChannel.
+      public: bool AddChannel(uint32_t _channel,
+                              const std::vector<uint8_t> &_data);
+
+      /// \brief End the current frame.
+      /// \return False if no frame was started, or if a chunk could not be
+      /// written.
+      public: bool EndFrame();
+
+      /// \brief Write the frames that are in memory as a chunk.
+      /// \return False if the chunk could not be written.
+      public: bool Flush();
+
+      /// \brief Get the number of frames ended since the file was opened.
+      /// \return Number of frames.
+      public: std::size_t FrameCount() const;
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<StateLogWriterPrivate> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Bytes of one channel of a frame, viewed in place.
+    struct StateLogChannelView
+    {
+      /// \brief Start of the bytes, or nullptr if the frame has no such
+      /// channel.
+      const uint8_t *data = nullptr;
+
+      /// \brief Number of bytes.
+      std::size_t size = 0;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Reads a log written by StateLogWriter with random access.
+    ///
+    /// The file is memory mapped where the platform supports it, so opening
+    /// a log only reads the headers of its frames, and channels are viewed
+    /// in place without copying.
+    class GZ_PHYSICS_VISIBLE StateLogReader
+    {
+      /// \brief Constructor
+      public: StateLogReader();
+
+      /// \brief Destructor
+      public: ~StateLogReader();
+
+      /// \brief Open a log file and index its frames.
+      /// \param[in] _path Path of the file.
+      /// \return True if the file is a state log.
+      public: bool Open(const std::string &_path);
+
+      /// \brief Close the file. Views of its channels become invalid.
+      public: void Close();
+
+      /// \brief Get whether a file is open.
+      /// \return True if a file is open.
+      public: bool IsOpen() const;
+
+      /// \brief Get whether the file ends with a chunk that was not
+      /// completely written. The frames of that chunk are skipped.
+      /// \return True if the end of the file was skipped.
+      public: bool Truncated() const;
+
+      /// \brief Get the number of frames.
+      /// \return Number of frames.
+      public: std::size_t FrameCount() const;
+
+      /// \brief Get the simulation time of a frame.
+      /// \param[in] _frame Index of the frame.
+      /// \return Time of the frame, or NaN if the index is invalid.
+      public: double FrameTime(std::size_t _frame) const;
+
+      /// \brief Get the step number of a frame.
+      /// \param[in] _frame Index of the frame.
+      /// \return Step number of the frame, or 0 if the index is invalid.
+      public: uint64_t FrameIteration(std::size_t _frame) const;
+
+      /// \brief Find the last frame at or before a time. Frames are expected
+      /// to be recorded in time order.
+      /// \param[in] _time Time to find.
+      /// \return Index of the frame, or FrameCount() if every frame is
+      /// later than _time.
+      public: std::size_t FindFrame(double _time) const;
+
+      /// \brief Get the channels of a frame.
+      /// \param[in] _frame Index of the frame.
+      /// \return IDs of the channels, in the order they were added.
+      public: std::vector<uint32_t> Channels(std::size_t _frame) const;
+
+      /// \brief View a channel of a frame. The view stays valid until the
+      /// file is closed.
+      /// \param[in] _frame Index of the frame.
+      /// \param[in] _channel Channel ID.
+      /// \return View of the channel, with a null data pointer if the frame
+      /// has no such channel.
+      public: StateLogChannelView Channel(std::size_t _frame,
+                                          uint32_t _channel) const;
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<StateLogReaderPrivate> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Record a snapshot of a world as a frame of a log.
+    /// \param[in] _writer Log to append the frame to.
+    /// \param[in] _world World with WorldStateSnapshotFeature.
+    /// \param[in] _time Simulation time of the frame.
+    /// \param[in] _iteration Step number of the frame.
+    /// \return True if the frame was appended.
+    template <typename WorldPtrT>
+    bool RecordWorldState(StateLogWriter &_writer, const WorldPtrT &_world,
+                          const double _time, const uint64_t _iteration)
+    {
+      return _writer.BeginFrame(_time, _iteration) &&
+          _writer.AddChannel(StateLogChannel::kSnapshot,
+                             _world->SaveState()) &&
+          _writer.EndFrame();
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Restore the snapshot of a frame of a log into a world.
+    /// \param[in] _reader Log to read the frame from.
+    /// \param[in] _frame Index of the frame.
+    /// \param[in] _world World with WorldStateSnapshotFeature.
+    /// \return True if the frame has a snapshot and it was restored.
+    template <typename WorldPtrT>
+    bool RestoreWorldState(const StateLogReader &_reader,
+                           const std::size_t _frame, const WorldPtrT &_world)
+    {
+      const StateLogChannelView view =
+          _reader.Channel(_frame, StateLogChannel::kSnapshot);
+      if (!view.data)
+        return false;
+      return _world->RestoreState(
+          std::vector<uint8_t>(view.data, view.data + view.size));
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_STATICENGINE_HH_
+#define GZ_PHYSICS_STATICENGINE_HH_
+
+#include <cstddef>
+
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/FeaturePolicy.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /// \brief An engine whose implementation class is linked into the
+    /// application and bound to a FeatureList at compile time, instead of
+    /// being loaded as a plugin and requested with RequestEngine.
+    ///
+    /// The StaticEngine owns an instance of ImplementationT, the class that
+    /// implements the features, e.g. the class passed to
+    /// GZ_PHYSICS_ADD_PLUGIN. Whether ImplementationT provides every feature
+    /// of FeatureListT is checked by the compiler, and the implementation of
+    /// a feature is found with a static cast rather than by querying a
+    /// plugin. Calls are made directly on the implementation, with the
+    /// Identity of the entity they apply to:
+    ///
+    /// \code
+    /// using MyFeatures = FeatureList<ConstructEmptyWorldFeature, ForwardStep>;
+    /// StaticEngine3d<MyEngine, MyFeatures> engine;
+    /// const Identity world = engine.Interface<ConstructEmptyWorldFeature>()
+    ///     .ConstructEmptyWorld(engine.EngineIdentity(), "default");
+    /// engine.Interface<ForwardStep>().WorldForwardStep(
+    ///     world, output, state, input);
+    /// \endcode
+    ///
+    /// If ImplementationT is declared final, calls made through Get() are not
+    /// virtual and can be inlined.
+    ///
+    /// The entity classes, e.g. World and Model, need a plugin pointer, so
+    /// they are not available for a StaticEngine.
+    ///
+    /// \tparam FeaturePolicyT
+    ///   The feature policy of the implementation, e.g. FeaturePolicy3d.
+    /// \tparam ImplementationT
+    ///   The class that implements the features.
+    /// \tparam FeatureListT
+    ///   The features that are used through this engine.
+    template <typename FeaturePolicyT, typename ImplementationT,
+              typename FeatureListT>
+    class StaticEngine
+    {
+      public: using Policy = FeaturePolicyT;
+      public: using Implementation = ImplementationT;
+      public: using Features = FeatureListT;
+
+      /// \brief The implementation interface of FeatureT.
+      public: template <typename FeatureT>
+      using InterfaceType =
+          typename FeatureT::template Implementation<FeaturePolicyT>;
+
+      /// \brief Constructor. Creates the implementation and initiates one of
+      /// its engines.
+      /// \param[in] _engineID
+      ///   The ID of the engine to initiate. Usually this will be 0.
+      public: explicit StaticEngine(std::size_t _engineID = 0);
+
+      /// \brief The implementation is owned by this object, so it can not be
+      /// copied.
+      public: StaticEngine(const StaticEngine &) = delete;
+
+      /// \brief The implementation is owned by this object, so it can not be
+      /// copied.
+      public: StaticEngine &operator=(const StaticEngine &) = delete;
+
+      /// \brief Get the Identity of the engine, to pass to the engine
+      /// functions of the implementation.
+      /// \return The Identity returned by InitiateEngine.
+      public: const Identity &EngineIdentity() const;
+
+      /// \brief Get the implementation of a feature of FeatureListT.
+      /// \tparam FeatureT
+      ///   The feature. Using a feature that is not in FeatureListT is a
+      ///   compilation error.
+      /// \return The implementation of FeatureT.
+      public: template <typename FeatureT>
+      InterfaceType<FeatureT> &Interface();
+
+      /// \brief Const version of Interface().
+      /// \return The implementation of FeatureT.
+      public: template <typename FeatureT>
+      const InterfaceType<FeatureT> &Interface() const;
+
+      /// \brief Get the implementation itself.
+      /// \return The implementation.
+      public: ImplementationT &Get();
+
+      /// \brief Const version of Get().
+      /// \return The implementation.
+      public: const ImplementationT &Get() const;
+
+      /// \brief The implementation of the features.
+      private: ImplementationT implementation;
+
+      /// \brief The Identity of the engine.
+      private: const Identity engine;
+    };
+
+#define GZ_PHYSICS_STATIC_ENGINE_MACRO(X) \
+  template <typename ImplementationT, typename FeatureListT> \
+  using StaticEngine ## X = \
+      StaticEngine<FeaturePolicy ## X, ImplementationT, FeatureListT>;
+
+    GZ_PHYSICS_STATIC_ENGINE_MACRO(3d)
+    GZ_PHYSICS_STATIC_ENGINE_MACRO(2d)
+    GZ_PHYSICS_STATIC_ENGINE_MACRO(3f)
+    GZ_PHYSICS_STATIC_ENGINE_MACRO(2f)
+  }
+}
+
+#include <gz/physics/detail/StaticEngine.hh>
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_TASKSCHEDULER_HH_
+#define GZ_PHYSICS_TASKSCHEDULER_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <gz/physics/Export.hh>
+#include <gz/physics/FeatureList.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    // Forward declaration
+    class ThreadPoolTaskSchedulerPrivate;
+
+    /////////////////////////////////////////////////
+    /// \brief Interface to the threads that physics engines run their
+    /// internal parallel work on, e.g. the integration and narrowphase of
+    /// TPE, the islands of dartsim, the multithreaded worlds of bullet, and
+    /// batches of worlds and of ray casts. An application that shares its
+    /// cores with rendering and sensors can give all engines one scheduler,
+    /// e.g. an adapter of its own work stealing pool or TBB arena, instead
+    /// of each of them starting threads of its own. See
+    /// TaskSchedulerFeature.
+    class GZ_PHYSICS_VISIBLE TaskScheduler
+    {
+      /// \brief Destructor
+      public: virtual ~TaskScheduler();
+
+      /// \brief Get the number of threads that tasks run on, including the
+      /// thread that calls Run.
+      /// \return Number of threads, at least 1.
+      public: virtual std::size_t GetNumThreads() const = 0;
+
+      /// \brief Call _task(i) for each i in [0, _count), possibly
+      /// concurrently, and return once all of the calls returned. Tasks
+      /// may call Run themselves, and several threads may call Run at once,
+      /// so a thread that waits for its tasks has to run other tasks in the
+      /// meantime. Tasks must not throw.
+      /// \param[in] _count Number of tasks.
+      /// \param[in] _task Task to call with the index of each task.
+      public: virtual void Run(
+          std::size_t _count,
+          const std::function<void(std::size_t)> &_task) = 0;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Task scheduler with a fixed pool of threads. The thread that
+    /// calls Run runs tasks too, its own ones first, so a scheduler of N
+    /// threads starts N - 1 workers.
+    class GZ_PHYSICS_VISIBLE ThreadPoolTaskScheduler : public TaskScheduler
+    {
+      /// \brief Constructor
+      /// \param[in] _numThreads Number of threads, including the thread
+      /// that calls Run. A value of 0 uses one thread per core, 1 runs the
+      /// tasks in order on the calling thread.
+      public: explicit ThreadPoolTaskScheduler(std::size_t _numThreads = 0u);
+
+      /// \brief Constructor of a scheduler whose threads are pinned to a set
+      /// of cores, e.g. the cores of a NUMA node, see NumaNodeCores. One
+      /// worker is started for each core. The thread that calls Run only
+      /// waits for its tasks, unless it is a worker itself, so all tasks
+      /// run on the cores. Pinning is only supported on Linux; elsewhere the
+      /// workers are not pinned.
+      /// \param[in] _cores Indices of the cores. An empty set is the same as
+      /// one thread per core, without pinning.
+      public: explicit ThreadPoolTaskScheduler(
+          const std::vector<std::size_t> &_cores);
+
+      /// \brief Destructor. Waits for the workers to exit, which must not
+      /// happen while Run is in progress.
+      public: ~ThreadPoolTaskScheduler() override;
+
+      // Documentation inherited
+      public: std::size_t GetNumThreads() const override;
+
+      /// \brief Get the cores that the threads are pinned to.
+      /// \return Indices of the cores given to the constructor, empty if
+      /// none were.
+      public: const std::vector<std::size_t> &GetCores() const;
+
+      // Documentation inherited
+      public: void Run(
+          std::size_t _count,
+          const std::function<void(std::size_t)> &_task) override;
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<ThreadPoolTaskSchedulerPrivate> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Get the default task scheduler of the process, a
+    /// ThreadPoolTaskScheduler with one thread per core that is created on
+    /// first use. Engines do not use it unless it is given to them.
+    /// \return The default scheduler.
+    GZ_PHYSICS_VISIBLE
+    std::shared_ptr<TaskScheduler> DefaultTaskScheduler();
+
+    /////////////////////////////////////////////////
+    /// \brief TaskSchedulerFeature lets an engine run its internal parallel
+    /// work on a TaskScheduler.
+    ///
+    /// Without a scheduler (default) an engine starts threads of its own
+    /// for each kind of parallel work, as many as it is asked for. With
+    /// one, the work is split into as many tasks as before, so the results
+    /// do not change, but the tasks run on the scheduler. Thread counts
+    /// such as the one given to StepWorldsFeature::StepWorlds still choose
+    /// the number of tasks, whatever the number of threads of the
+    /// scheduler. The bullet plugins bridge bullet's btITaskScheduler to
+    /// the scheduler while they step multithreaded worlds.
+    class GZ_PHYSICS_VISIBLE TaskSchedulerFeature : public virtual Feature
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+      {
+        /// \brief Set the task scheduler of the engine.
+        /// \param[in] _scheduler Scheduler, e.g. DefaultTaskScheduler() to
+        /// share a pool between engines, or nullptr for the engine to start
+        /// threads of its own. The engine keeps a reference to it.
+        public: void SetTaskScheduler(
+            std::shared_ptr<TaskScheduler> _scheduler);
+
+        /// \brief Get the task scheduler of the engine.
+        /// \return Scheduler, or nullptr if the engine starts threads of its
+        /// own.
+        public: std::shared_ptr<TaskScheduler> GetTaskScheduler() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for SetTaskScheduler
+        /// \param[in] _engineID Identity of the engine
+        /// \param[in] _scheduler Scheduler, or nullptr
+        public: virtual void SetEngineTaskScheduler(
+            const Identity &_engineID,
+            std::shared_ptr<TaskScheduler> _scheduler) = 0;
+
+        /// \brief Implementation API for GetTaskScheduler
+        /// \param[in] _engineID Identity of the engine
+        /// \return Scheduler, or nullptr
+        public: virtual std::shared_ptr<TaskScheduler> GetEngineTaskScheduler(
+            const Identity &_engineID) const = 0;
+      };
+    };
+  }
+}
+
+#include <gz/physics/detail/TaskScheduler.hh>
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_TRAJECTORY_HH_
+#define GZ_PHYSICS_TRAJECTORY_HH_
+
+#include <vector>
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/Geometry.hh>
+
+namespace gz
+{
+namespace physics
+{
+/// \brief ModelTrajectoryFeature makes models follow timed paths of poses
+/// that the engine evaluates while stepping, e.g. for traffic or crowd
+/// agents whose routes are planned ahead. Controllers then only touch the
+/// models whose plans change, instead of setting velocities and reading
+/// poses back for every model in every step.
+///
+/// From the time of the first waypoint, each step moves the model to the
+/// pose of its trajectory at the end of the step, and sets the velocities
+/// of the model to those that reach the pose. At the last waypoint the
+/// model stops and the trajectory is cleared.
+class GZ_PHYSICS_VISIBLE ModelTrajectoryFeature : public virtual Feature
+{
+  /// \brief How positions are interpolated between waypoints. Orientations
+  /// are always interpolated spherically.
+  public: enum class Interpolation
+  {
+    /// \brief Straight segments between waypoints
+    LINEAR,
+
+    /// \brief Catmull-Rom spline through the waypoints, whose velocity is
+    /// continuous at the waypoints
+    CUBIC
+  };
+
+  /// \brief A pose for a model to reach at a time
+  public: template <typename PolicyT>
+  struct WaypointT
+  {
+    using Scalar = typename PolicyT::Scalar;
+    using PoseType = typename FromPolicy<PolicyT>::template Use<Pose>;
+
+    /// \brief Simulation time of the waypoint, in seconds
+    Scalar time = Scalar(0);
+    /// \brief Pose of the model in the world frame
+    PoseType pose = PoseType::Identity();
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class Model : public virtual Feature::Model<PolicyT, FeaturesT>
+  {
+    public: using Waypoint = WaypointT<PolicyT>;
+
+    /// \brief Make this model follow a trajectory, replacing the one it
+    /// follows, if any. Wakes the model up.
+    /// \param[in] _waypoints Waypoints in strictly increasing order of time
+    /// \param[in] _interpolation How positions are interpolated
+    /// \return False if the waypoints are empty or out of order, or the
+    /// engine cannot move this model along a trajectory. The current
+    /// trajectory is then kept.
+    public: bool SetTrajectory(const std::vector<Waypoint> &_waypoints,
+        Interpolation _interpolation = Interpolation::LINEAR);
+
+    /// \brief Stop following the trajectory, if any. The model stops.
+    public: void ClearTrajectory();
+
+    /// \brief Get whether this model follows a trajectory that has not
+    /// ended yet.
+    /// \return True if the model has a trajectory
+    public: bool HasTrajectory() const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: using Waypoint = WaypointT<PolicyT>;
+
+    /// \brief Implementation API for SetTrajectory
+    /// \param[in] _modelID Identity of the model
+    /// \param[in] _waypoints Waypoints in increasing order of time
+    /// \param[in] _interpolation How positions are interpolated
+    /// \return True if the trajectory was set
+    public: virtual bool SetModelTrajectory(
+        const Identity &_modelID, const std::vector<Waypoint> &_waypoints,
+        Interpolation _interpolation) = 0;
+
+    /// \brief Implementation API for ClearTrajectory
+    /// \param[in] _modelID Identity of the model
+    public: virtual void ClearModelTrajectory(const Identity &_modelID) = 0;
+
+    /// \brief Implementation API for HasTrajectory
+    /// \param[in] _modelID Identity of the model
+    /// \return True if the model has a trajectory
+    public: virtual bool GetModelHasTrajectory(
+        const Identity &_modelID) const = 0;
+  };
+};
+}
+}
+
+#include <gz/physics/detail/Trajectory.hh>
+
+#endif
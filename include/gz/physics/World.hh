@@ -18,8 +18,12 @@
 #ifndef GZ_PHYSICS_WORLD_HH_
 #define GZ_PHYSICS_WORLD_HH_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
+#include <gz/physics/AdaptiveTimeStep.hh>
 #include <gz/physics/FeatureList.hh>
 #include <gz/physics/FrameSemantics.hh>
 
@@ -34,7 +38,12 @@ namespace gz
       public: template <typename PolicyT, typename FeaturesT>
       class World : public virtual Feature::World<PolicyT, FeaturesT>
       {
-        /// \brief Set the name of the collision detector to use.
+        /// \brief Set the name of the collision detector to use. Engines
+        /// may accept "auto", which selects a detector by the shapes of the
+        /// world and then times the top candidates over the first steps,
+        /// or "auto_static", which only selects by the shapes. The
+        /// selection is made from the shapes at the time of the call, and
+        /// GetStepStatisticsFeature reports the detector of each step.
         /// \param[in] _collisionDetector Name of collision detector.
         public: void SetCollisionDetector(
             const std::string &_collisionDetector);
@@ -65,6 +74,41 @@ namespace gz
     /////////////////////////////////////////////////
     using GravityRequiredFeatures = FeatureList<FrameSemantics>;
 
+    /////////////////////////////////////////////////
+    class GZ_PHYSICS_VISIBLE Broadphase : public virtual Feature
+    {
+      /// \brief The World API for setting the collision broadphase.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set the name of the broadphase algorithm used to find
+        /// potentially colliding pairs.
+        /// \param[in] _broadphase Name of the broadphase.
+        public: void SetBroadphase(const std::string &_broadphase);
+
+        /// \brief Get the name of the broadphase algorithm in use.
+        /// \return Name of the broadphase.
+        public: const std::string &GetBroadphase() const;
+      };
+
+      /// \private The implementation API for the broadphase.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for setting the broadphase.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _broadphase Name of the broadphase.
+        public: virtual void SetWorldBroadphase(
+            const Identity &_id, const std::string &_broadphase) = 0;
+
+        /// \brief Implementation API for getting the broadphase.
+        /// \param[in] _id Identity of the world.
+        /// \return Name of the broadphase.
+        public: virtual const std::string &GetWorldBroadphase(
+            const Identity &_id) const = 0;
+      };
+    };
+
     /////////////////////////////////////////////////
     /// \brief Get and set the World's gravity vector in a specified frame.
     class GZ_PHYSICS_VISIBLE Gravity
@@ -170,6 +214,87 @@ namespace gz
       };
     };
 
+    /////////////////////////////////////////////////
+    class GZ_PHYSICS_VISIBLE CollisionPairContactSelection:
+        public virtual Feature
+    {
+      /// \brief The World API for choosing which contacts are kept when two
+      /// entities have more contacts than the CollisionPairMaxContacts limit.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set the strategy used to choose which contacts are kept
+        /// between two entities.
+        /// \param[in] _selection Name of the strategy. Engines may support
+        /// "first" (the first contacts found), "deepest" (the contacts with
+        /// the largest penetration depth) and "spread" (contacts spread out
+        /// over the contact region).
+        public: void SetCollisionPairContactSelection(
+            const std::string &_selection);
+
+        /// \brief Get the strategy used to choose which contacts are kept
+        /// between two entities.
+        /// \return Name of the strategy.
+        public: const std::string &GetCollisionPairContactSelection() const;
+      };
+
+      /// \private The implementation API for the contact selection.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for setting the contact selection
+        /// strategy.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _selection Name of the strategy.
+        public: virtual void SetWorldCollisionPairContactSelection(
+            const Identity &_id, const std::string &_selection) = 0;
+
+        /// \brief Implementation API for getting the contact selection
+        /// strategy.
+        /// \param[in] _id Identity of the world.
+        /// \return Name of the strategy.
+        public: virtual const std::string &
+            GetWorldCollisionPairContactSelection(const Identity &_id)
+            const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    class GZ_PHYSICS_VISIBLE NumThreads : public virtual Feature
+    {
+      /// \brief The World API for setting the number of threads used to
+      /// step the world.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set the number of threads used to step the world.
+        /// \param[in] _numThreads Number of threads. A value of 0 or 1 steps
+        /// the world on the calling thread only.
+        public: void SetNumThreads(std::size_t _numThreads);
+
+        /// \brief Get the number of threads used to step the world.
+        /// \return Number of threads.
+        public: std::size_t GetNumThreads() const;
+      };
+
+      /// \private The implementation API for the number of threads.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for setting the number of threads.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _numThreads Number of threads.
+        public: virtual void SetWorldNumThreads(
+            const Identity &_id, std::size_t _numThreads) = 0;
+
+        /// \brief Implementation API for getting the number of threads.
+        /// \param[in] _id Identity of the world.
+        /// \return Number of threads.
+        public: virtual std::size_t GetWorldNumThreads(
+            const Identity &_id) const = 0;
+      };
+    };
+
     /////////////////////////////////////////////////
     class GZ_PHYSICS_VISIBLE Solver : public virtual Feature
     {
@@ -203,6 +328,741 @@ namespace gz
             const Identity &_id) const = 0;
       };
     };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature exposes the settings of the constraint solver
+    /// that trade accuracy for step time, so they can be tuned per world at
+    /// runtime. Engines that do not support a setting ignore it, and report
+    /// the value they actually use.
+    class GZ_PHYSICS_VISIBLE SolverProfile : public virtual Feature
+    {
+      /// \brief The World API for the solver settings.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set the maximum number of iterations of the iterative
+        /// constraint solver.
+        /// \param[in] _iterations Maximum number of iterations.
+        public: void SetSolverIterations(std::size_t _iterations);
+
+        /// \brief Get the maximum number of iterations of the iterative
+        /// constraint solver.
+        /// \return Maximum number of iterations, or 0 if the world has no
+        /// iterative solver.
+        public: std::size_t GetSolverIterations() const;
+
+        /// \brief Set whether the solver starts from the impulses of the
+        /// previous step.
+        /// \param[in] _warmStarting True to warm start the solver.
+        public: void SetSolverWarmStarting(bool _warmStarting);
+
+        /// \brief Get whether the solver starts from the impulses of the
+        /// previous step.
+        /// \return True if the solver is warm started.
+        public: bool GetSolverWarmStarting() const;
+
+        /// \brief Set whether penetration is resolved by a separate
+        /// position correction, which does not add energy to the velocity.
+        /// \param[in] _splitImpulse True to use split impulses.
+        public: void SetSolverSplitImpulse(bool _splitImpulse);
+
+        /// \brief Get whether penetration is resolved by a separate position
+        /// correction.
+        /// \return True if split impulses are used.
+        public: bool GetSolverSplitImpulse() const;
+
+        /// \brief Set the residual below which the iterative solver stops
+        /// before reaching its maximum number of iterations.
+        /// \param[in] _tolerance Tolerance. A value of 0 always runs the
+        /// maximum number of iterations.
+        public: void SetSolverTolerance(double _tolerance);
+
+        /// \brief Get the residual below which the iterative solver stops
+        /// early.
+        /// \return Tolerance.
+        public: double GetSolverTolerance() const;
+      };
+
+      /// \private The implementation API for the solver settings.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for setting the maximum number of
+        /// solver iterations.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _iterations Maximum number of iterations.
+        public: virtual void SetWorldSolverIterations(
+            const Identity &_id, std::size_t _iterations) = 0;
+
+        /// \brief Implementation API for getting the maximum number of
+        /// solver iterations.
+        /// \param[in] _id Identity of the world.
+        /// \return Maximum number of iterations.
+        public: virtual std::size_t GetWorldSolverIterations(
+            const Identity &_id) const = 0;
+
+        /// \brief Implementation API for setting solver warm starting.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _warmStarting True to warm start the solver.
+        public: virtual void SetWorldSolverWarmStarting(
+            const Identity &_id, bool _warmStarting) = 0;
+
+        /// \brief Implementation API for getting solver warm starting.
+        /// \param[in] _id Identity of the world.
+        /// \return True if the solver is warm started.
+        public: virtual bool GetWorldSolverWarmStarting(
+            const Identity &_id) const = 0;
+
+        /// \brief Implementation API for setting split impulses.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _splitImpulse True to use split impulses.
+        public: virtual void SetWorldSolverSplitImpulse(
+            const Identity &_id, bool _splitImpulse) = 0;
+
+        /// \brief Implementation API for getting split impulses.
+        /// \param[in] _id Identity of the world.
+        /// \return True if split impulses are used.
+        public: virtual bool GetWorldSolverSplitImpulse(
+            const Identity &_id) const = 0;
+
+        /// \brief Implementation API for setting the solver tolerance.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _tolerance Tolerance.
+        public: virtual void SetWorldSolverTolerance(
+            const Identity &_id, double _tolerance) = 0;
+
+        /// \brief Implementation API for getting the solver tolerance.
+        /// \param[in] _id Identity of the world.
+        /// \return Tolerance.
+        public: virtual double GetWorldSolverTolerance(
+            const Identity &_id) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature splits each step of a world into a number of
+    /// substeps of equal length, e.g. to solve contacts at 4 kHz while
+    /// reading the state at 1 kHz. The substeps run inside the engine, and
+    /// poses and contacts are reported once per step, after the last one.
+    /// Forces and commands set before a step apply to all of its substeps.
+    class GZ_PHYSICS_VISIBLE SubSteps : public virtual Feature
+    {
+      /// \brief The World API for setting the number of substeps.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set the number of substeps of each step of the world.
+        /// \param[in] _subSteps Number of substeps. A value of 0 or 1
+        /// (default) steps the world once per step.
+        public: void SetSubSteps(std::size_t _subSteps);
+
+        /// \brief Get the number of substeps of each step of the world.
+        /// \return Number of substeps.
+        public: std::size_t GetSubSteps() const;
+      };
+
+      /// \private The implementation API for the number of substeps.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for setting the number of substeps.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _subSteps Number of substeps.
+        public: virtual void SetWorldSubSteps(
+            const Identity &_id, std::size_t _subSteps) = 0;
+
+        /// \brief Implementation API for getting the number of substeps.
+        /// \param[in] _id Identity of the world.
+        /// \return Number of substeps.
+        public: virtual std::size_t GetWorldSubSteps(
+            const Identity &_id) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature lets the engine pick the length of each step of a
+    /// world, see AdaptiveTimeStep. Steps grow up to a maximum while the
+    /// world is quiet, and shrink back towards the step size given to the
+    /// engine when bodies penetrate deeply or velocities change quickly.
+    /// Each step simulates one step of the picked length, which may be more
+    /// time than was given, so callers that keep a simulation clock advance
+    /// it by GetLastStepSize.
+    class GZ_PHYSICS_VISIBLE AdaptiveTimeStepFeature : public virtual Feature
+    {
+      /// \brief Parameters of adaptive stepping.
+      public: using Parameters = AdaptiveTimeStep::Parameters;
+
+      /// \brief The World API for adaptive stepping.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set the parameters of adaptive stepping of the world.
+        /// \param[in] _parameters Parameters. A maximum step of 0 disables
+        /// adaptive stepping.
+        public: void SetAdaptiveTimeStep(const Parameters &_parameters);
+
+        /// \brief Get the parameters of adaptive stepping of the world.
+        /// \return Parameters.
+        public: Parameters GetAdaptiveTimeStep() const;
+
+        /// \brief Get the time simulated by the last step of the world.
+        /// \return Length of the last step in seconds, or 0 if the world
+        /// has not been stepped.
+        public: double GetLastStepSize() const;
+      };
+
+      /// \private The implementation API for adaptive stepping.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for setting the parameters of adaptive
+        /// stepping.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _parameters Parameters.
+        public: virtual void SetWorldAdaptiveTimeStep(
+            const Identity &_id, const Parameters &_parameters) = 0;
+
+        /// \brief Implementation API for getting the parameters of adaptive
+        /// stepping.
+        /// \param[in] _id Identity of the world.
+        /// \return Parameters.
+        public: virtual Parameters GetWorldAdaptiveTimeStep(
+            const Identity &_id) const = 0;
+
+        /// \brief Implementation API for getting the length of the last
+        /// step.
+        /// \param[in] _id Identity of the world.
+        /// \return Length of the last step in seconds.
+        public: virtual double GetWorldLastStepSize(
+            const Identity &_id) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature replaces the rigid contact constraints of a world
+    /// by compliant ones. Each contact pushes the bodies apart with a
+    /// spring-damper force along its normal and a Coulomb friction force
+    /// that stops sliding within a step, which are integrated explicitly
+    /// instead of being found by a constraint solve. This is approximate,
+    /// bodies sink into each other by the weight they carry over the
+    /// stiffness, but the contacts of an island no longer couple into one
+    /// system, which makes scenes with many contacts, such as granular
+    /// piles, much cheaper to step. Joints and other constraints are still
+    /// solved as before.
+    class GZ_PHYSICS_VISIBLE PenaltyContactFeature : public virtual Feature
+    {
+      /// \brief Parameters of penalty contacts.
+      public: struct Parameters
+      {
+        /// \brief Stiffness of the contact springs, in N/m. A value of 0
+        /// (default) keeps rigid contacts.
+        double stiffness = 0.0;
+
+        /// \brief Damping of the contact springs, in N s/m.
+        double damping = 0.0;
+      };
+
+      /// \brief The World API for penalty contacts.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set the parameters of the penalty contacts of the world.
+        /// \param[in] _parameters Parameters. A stiffness of 0 switches
+        /// back to rigid contacts.
+        public: void SetPenaltyContact(const Parameters &_parameters);
+
+        /// \brief Get the parameters of the penalty contacts of the world.
+        /// \return Parameters.
+        public: Parameters GetPenaltyContact() const;
+      };
+
+      /// \private The implementation API for penalty contacts.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for setting the parameters of penalty
+        /// contacts.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _parameters Parameters.
+        public: virtual void SetWorldPenaltyContact(
+            const Identity &_id, const Parameters &_parameters) = 0;
+
+        /// \brief Implementation API for getting the parameters of penalty
+        /// contacts.
+        /// \param[in] _id Identity of the world.
+        /// \return Parameters.
+        public: virtual Parameters GetWorldPenaltyContact(
+            const Identity &_id) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature reports counters and timings of the last step of
+    /// a world. They are collected on every step, independent of the
+    /// profiler, at the cost of a few clock reads per step.
+    class GZ_PHYSICS_VISIBLE GetStepStatisticsFeature : public virtual Feature
+    {
+      /// \brief Counters and timings of a step. Times are wall clock
+      /// seconds. A phase that an engine does not have, or cannot separate
+      /// from another phase, is reported as 0 and its time is included in
+      /// the phase it is part of. Counters that an engine cannot provide are
+      /// reported as 0.
+      public: struct StepStatistics
+      {
+        /// \brief Time of the whole step, including pose write-out.
+        double stepTime = 0.0;
+
+        /// \brief Time spent finding the pairs of objects whose bounding
+        /// volumes overlap.
+        double broadphaseTime = 0.0;
+
+        /// \brief Time spent testing the candidate pairs and generating
+        /// contacts.
+        double narrowphaseTime = 0.0;
+
+        /// \brief Time spent solving constraints and contacts.
+        double solverTime = 0.0;
+
+        /// \brief Time spent computing dynamics and integrating velocities
+        /// and positions.
+        double integrationTime = 0.0;
+
+        /// \brief Time spent writing the poses of the step output. When
+        /// several worlds are stepped together this is the time of writing
+        /// the poses of all of them.
+        double poseWriteTime = 0.0;
+
+        /// \brief Number of pairs tested by the narrowphase.
+        std::size_t candidatePairCount = 0u;
+
+        /// \brief Number of contact points found.
+        std::size_t contactCount = 0u;
+
+        /// \brief Number of groups of bodies that were simulated
+        /// independently of each other.
+        std::size_t islandCount = 0u;
+
+        /// \brief Name of the collision detector that the step used, see
+        /// CollisionDetector, or empty if the engine does not report it.
+        std::string collisionDetector;
+
+        /// \brief Heap allocations of the whole step, including pose
+        /// write-out. The allocation counters are only collected when
+        /// gz-physics is built with ENABLE_ALLOCATION_COUNTER, see
+        /// AllocationCount, and are 0 otherwise. They count the allocations
+        /// of all threads of the process, and follow the same phases as the
+        /// times.
+        std::size_t stepAllocations = 0u;
+
+        /// \brief Heap allocations of the broadphase.
+        std::size_t broadphaseAllocations = 0u;
+
+        /// \brief Heap allocations of the narrowphase.
+        std::size_t narrowphaseAllocations = 0u;
+
+        /// \brief Heap allocations of the constraint and contact solve.
+        std::size_t solverAllocations = 0u;
+
+        /// \brief Heap allocations of computing dynamics and integrating.
+        std::size_t integrationAllocations = 0u;
+
+        /// \brief Heap allocations of writing the poses of the step output.
+        std::size_t poseWriteAllocations = 0u;
+      };
+
+      /// \brief The World API for getting the step statistics.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Get counters and timings of the last step of this world.
+        /// \return Statistics of the last step, all 0 before the first step.
+        public: StepStatistics GetStepStatistics() const;
+      };
+
+      /// \private The implementation API for getting the step statistics.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for getting the step statistics.
+        /// \param[in] _id Identity of the world.
+        /// \return Statistics of the last step.
+        public: virtual StepStatistics GetWorldStepStatistics(
+            const Identity &_id) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature attributes the cost of the last step of a world
+    /// to its models, to find the models responsible for a slow step. The
+    /// counters are only collected while they are enabled, since timing
+    /// each pair of bodies reads the clock for every pair.
+    class GZ_PHYSICS_VISIBLE GetModelStepStatisticsFeature
+      : public virtual Feature
+    {
+      /// \brief Counters and timings of a model in a step. A pair of
+      /// bodies of different models counts for both models, so the counters
+      /// of all models add up to more than those of the step. Counters that
+      /// an engine cannot provide are reported as 0.
+      public: struct ModelStepStatistics
+      {
+        /// \brief Entity ID of the model.
+        std::size_t model = 0u;
+
+        /// \brief Number of pairs of the model tested by the narrowphase.
+        std::size_t candidatePairCount = 0u;
+
+        /// \brief Wall clock seconds spent testing the pairs of the model
+        /// and generating their contacts.
+        double narrowphaseTime = 0.0;
+
+        /// \brief Number of contact points of the model.
+        std::size_t contactCount = 0u;
+
+        /// \brief Number of rows that the constraints of the model, its
+        /// joints, limits, motors and contacts, added to the constraint
+        /// solver.
+        std::size_t constraintRowCount = 0u;
+      };
+
+      /// \brief The World API for getting the statistics of the models.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set whether the steps of this world collect the
+        /// statistics of each model. Disabled by default.
+        /// \param[in] _enable True to collect the statistics.
+        public: void SetModelStepStatisticsEnabled(bool _enable);
+
+        /// \brief Get counters and timings of the models of the last step
+        /// of this world.
+        /// \return Statistics of the models that were in a pair or had
+        /// constraint rows in the last step, sorted by model ID. Empty if
+        /// they were not collected.
+        public: std::vector<ModelStepStatistics> GetModelStepStatistics()
+            const;
+      };
+
+      /// \private The implementation API for getting the statistics of the
+      /// models.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for enabling the statistics of the
+        /// models.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _enable True to collect the statistics.
+        public: virtual void SetWorldModelStepStatisticsEnabled(
+            const Identity &_id, bool _enable) = 0;
+
+        /// \brief Implementation API for getting the statistics of the
+        /// models.
+        /// \param[in] _id Identity of the world.
+        /// \return Statistics of the models in the last step.
+        public: virtual std::vector<ModelStepStatistics>
+            GetWorldModelStepStatistics(const Identity &_id) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature reports how hard the constraint solver of a world
+    /// worked in the last step, to tune SolverProfile per world, e.g. to the
+    /// fewest iterations that still converge. The statistics are only
+    /// collected while they are enabled, since measuring the residual of a
+    /// solve costs about as much as one iteration of it.
+    class GZ_PHYSICS_VISIBLE GetSolverStatisticsFeature
+      : public virtual Feature
+    {
+      /// \brief Counters of the constraint solves of a step. A step is
+      /// solved as one problem per island, or per batch of islands, so the
+      /// counters add up over the solves and the iterations and residual
+      /// are those of the worst solve. A step with several substeps, see
+      /// SubSteps, adds up over them. Counters that an engine cannot
+      /// provide are reported as 0.
+      public: struct SolverStatistics
+      {
+        /// \brief Number of problems solved.
+        std::size_t solveCount = 0u;
+
+        /// \brief Most iterations that the iterative solver ran for one
+        /// problem. 0 for solvers that are not iterative, or that do not
+        /// report their iterations.
+        std::size_t iterations = 0u;
+
+        /// \brief Largest residual that a solve ended with, as measured by
+        /// the engine. Compare it with the tolerance of SolverProfile.
+        double residual = 0.0;
+
+        /// \brief Number of rows that contacts, their normal and friction
+        /// directions, added to the problems.
+        std::size_t contactRowCount = 0u;
+
+        /// \brief Number of rows that the other constraints, such as
+        /// joints, joint limits and motors, added to the problems.
+        std::size_t jointRowCount = 0u;
+
+        /// \brief Number of problems that the solver failed on and that
+        /// were solved again by a fallback solver.
+        std::size_t fallbackCount = 0u;
+
+        /// \brief Number of problems that no solver found a usable
+        /// solution for, whose constraint impulses were dropped.
+        std::size_t failureCount = 0u;
+      };
+
+      /// \brief The World API for getting the solver statistics.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set whether the steps of this world collect the solver
+        /// statistics. Disabled by default.
+        /// \param[in] _enable True to collect the statistics.
+        public: void SetSolverStatisticsEnabled(bool _enable);
+
+        /// \brief Get the solver statistics of the last step of this world.
+        /// \return Statistics of the last step, all 0 if they were not
+        /// collected.
+        public: SolverStatistics GetSolverStatistics() const;
+      };
+
+      /// \private The implementation API for getting the solver
+      /// statistics.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for enabling the solver statistics.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _enable True to collect the statistics.
+        public: virtual void SetWorldSolverStatisticsEnabled(
+            const Identity &_id, bool _enable) = 0;
+
+        /// \brief Implementation API for getting the solver statistics.
+        /// \param[in] _id Identity of the world.
+        /// \return Statistics of the last step.
+        public: virtual SolverStatistics GetWorldSolverStatistics(
+            const Identity &_id) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature estimates the memory used by a world, split by
+    /// what it is used for. The estimate covers the data structures held by
+    /// the engine and the plugin, counted from their sizes and capacities.
+    /// Memory held by allocators or by data that is shared between worlds,
+    /// such as a mesh used in several of them, is counted once per world.
+    class GZ_PHYSICS_VISIBLE GetMemoryUsageFeature : public virtual Feature
+    {
+      /// \brief Bytes used by a world. Memory that an engine cannot
+      /// attribute is reported as 0.
+      public: struct MemoryUsage
+      {
+        /// \brief Collision geometry, such as triangle meshes, their
+        /// bounding volume hierarchies and heightfield arrays.
+        std::size_t geometryBytes = 0u;
+
+        /// \brief Entity bookkeeping, such as the bodies and joints of the
+        /// engine, the Info structs of the plugin and the maps that store
+        /// them.
+        std::size_t entityBytes = 0u;
+
+        /// \brief Scratch memory that is kept between steps, such as
+        /// broadphase structures, contact caches and solver pools.
+        std::size_t solverBytes = 0u;
+
+        /// \brief Get the bytes of all categories.
+        /// \return Total bytes.
+        public: std::size_t TotalBytes() const
+        {
+          return this->geometryBytes + this->entityBytes + this->solverBytes;
+        }
+      };
+
+      /// \brief The World API for getting the memory usage.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Estimate the memory used by this world.
+        /// \return Bytes used by this world, per category.
+        public: MemoryUsage GetMemoryUsage() const;
+      };
+
+      /// \private The implementation API for getting the memory usage.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for getting the memory usage.
+        /// \param[in] _id Identity of the world.
+        /// \return Bytes used by the world, per category.
+        public: virtual MemoryUsage GetWorldMemoryUsage(
+            const Identity &_id) const = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature applies a packed buffer of joint and link
+    /// commands to a world in a single call, instead of one call per command
+    /// through each joint or link entity.
+    class GZ_PHYSICS_VISIBLE WorldCommandBufferFeature : public virtual Feature
+    {
+      /// \brief What a Command does with its value.
+      public: enum class CommandType : std::uint8_t
+      {
+        /// \brief Set the force of a joint DOF for the next step, like
+        /// SetBasicJointState::Joint::SetForce.
+        JOINT_FORCE = 0,
+
+        /// \brief Command the velocity of a joint DOF for the next step,
+        /// like SetJointVelocityCommandFeature::Joint::SetVelocityCommand.
+        JOINT_VELOCITY_COMMAND,
+
+        /// \brief Add one world frame component of a force applied at the
+        /// center of mass of a link for the next step. The DOF selects the
+        /// component: 0 for x, 1 for y and 2 for z.
+        LINK_FORCE,
+
+        /// \brief Add one world frame component of a torque on a link for
+        /// the next step. The DOF selects the component as for LINK_FORCE.
+        LINK_TORQUE
+      };
+
+      /// \brief A single command. Laid out so that a buffer of commands can
+      /// be filled directly by the caller.
+      public: struct Command
+      {
+        /// \brief Entity ID of the joint or link, as given by
+        /// Entity::EntityID().
+        std::size_t entity;
+
+        /// \brief Joint DOF, or force/torque component for link commands.
+        std::size_t dof;
+
+        /// \brief What to do with the value.
+        CommandType type;
+
+        /// \brief Value of the command.
+        double value;
+      };
+
+      /// \brief The World API for applying a command buffer.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Apply a buffer of commands to entities of this world. The
+        /// commands are sorted by model internally, so they may be given in
+        /// any order. Commands that refer to an unknown entity, an invalid
+        /// DOF or a non-finite value are skipped.
+        /// \param[in] _commands Pointer to the first command.
+        /// \param[in] _count Number of commands.
+        public: void ApplyCommands(
+            const Command *_commands, std::size_t _count);
+
+        /// \brief Apply a buffer of commands to entities of this world.
+        /// \param[in] _commands Commands to apply.
+        public: void ApplyCommands(const std::vector<Command> &_commands);
+      };
+
+      /// \private The implementation API for applying a command buffer.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for applying a command buffer.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _commands Pointer to the first command.
+        /// \param[in] _count Number of commands.
+        public: virtual void ApplyWorldCommands(
+            const Identity &_id, const Command *_commands,
+            std::size_t _count) = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature creates a copy of an existing world, including
+    /// its models and their current state. Immutable data such as collision
+    /// shapes and meshes is shared between the source world and its clones
+    /// instead of being copied, so cloning a prepared template world is much
+    /// cheaper than loading it again.
+    class GZ_PHYSICS_VISIBLE CloneWorldFeature : public virtual Feature
+    {
+      /// \brief The World API for cloning a world.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        public: using WorldPtrType = WorldPtr<PolicyT, FeaturesT>;
+
+        /// \brief Create a copy of this world with a new name. The clone is
+        /// added to the same engine and evolves independently of this
+        /// world afterwards.
+        /// \param[in] _name Name of the new world. It must not be used by
+        /// another world of the engine.
+        /// \return The new world, or a null pointer if it could not be
+        /// created.
+        public: WorldPtrType Clone(const std::string &_name);
+      };
+
+      /// \private The implementation API for cloning a world.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for cloning a world.
+        /// \param[in] _worldID Identity of the world to clone.
+        /// \param[in] _name Name of the new world.
+        /// \return Identity of the new world, or an invalid identity if it
+        /// could not be created.
+        public: virtual Identity CloneWorld(
+            const Identity &_worldID, const std::string &_name) = 0;
+      };
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief This feature saves the dynamic state of a world into a binary
+    /// snapshot and restores it later, e.g. to roll back a world or to reset
+    /// an episode without rebuilding the world.
+    ///
+    /// A snapshot holds the positions and velocities of every body, the
+    /// simulation time and any solver data the engine carries from one step
+    /// to the next, such as contact warm start caches. The format is engine
+    /// specific. A snapshot can only be restored into the world it was taken
+    /// from, or into a world with the same structure such as one created by
+    /// CloneWorldFeature, and only by the same build of the engine.
+    class GZ_PHYSICS_VISIBLE WorldStateSnapshotFeature : public virtual Feature
+    {
+      /// \brief Binary snapshot of the state of a world.
+      public: using Snapshot = std::vector<std::uint8_t>;
+
+      /// \brief The World API for saving and restoring the state.
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Save the current state of this world.
+        /// \return Snapshot of the state.
+        public: Snapshot SaveState() const;
+
+        /// \brief Restore a state saved by SaveState. The world is left
+        /// unchanged if the snapshot does not match it.
+        /// \param[in] _snapshot Snapshot to restore.
+        /// \return True if the state was restored.
+        public: bool RestoreState(const Snapshot &_snapshot);
+      };
+
+      /// \private The implementation API for saving and restoring the state.
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for saving the state of a world.
+        /// \param[in] _id Identity of the world.
+        /// \return Snapshot of the state.
+        public: virtual Snapshot GetWorldStateSnapshot(
+            const Identity &_id) const = 0;
+
+        /// \brief Implementation API for restoring the state of a world.
+        /// \param[in] _id Identity of the world.
+        /// \param[in] _snapshot Snapshot to restore.
+        /// \return True if the state was restored.
+        public: virtual bool SetWorldStateSnapshot(
+            const Identity &_id, const Snapshot &_snapshot) = 0;
+      };
+    };
+
+    DETAIL_GZ_PHYSICS_EXTERN_FEATURE_IMPLEMENTATION(Gravity)
   }
 }
 
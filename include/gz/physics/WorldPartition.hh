@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_WORLDPARTITION_HH_
+#define GZ_PHYSICS_WORLDPARTITION_HH_
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <gz/physics/Export.hh>
+#include <gz/physics/Geometry.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    // Forward declaration
+    class WorldPartitionPrivate;
+
+    /////////////////////////////////////////////////
+    /// \brief Bookkeeping to simulate one large world as several smaller
+    /// worlds, one per spatial region. Each region could be stepped by its
+    /// own engine instance, possibly in another process.
+    ///
+    /// The regions are the cells of a regular grid over the bounds of the
+    /// world. Each body is owned by the region that contains the center of
+    /// its bounding box. A body is ghosted into every other region that its
+    /// bounding box comes within the ghost margin of. The owner region steps
+    /// the body, and other regions keep a proxy of it so that their bodies
+    /// can collide with it.
+    ///
+    /// This class only decides which region owns and ghosts each body. The
+    /// application moves the bodies between the engine instances. A typical
+    /// step looks like this:
+    /// 1. Step the world of every region.
+    /// 2. Collect the boxes of the bodies that each region owns, e.g. with
+    ///    GetWorldLinkBoundingBoxes, and pass them all to Update().
+    /// 3. For each handover, construct the body in the world of its new
+    ///    owner with the pose and velocity it had in its old owner, and
+    ///    remove it from the old owner, or turn it into a ghost there.
+    /// 4. Create or remove the ghosts that were added or removed, and set
+    ///    the pose of every ghost from the ChangedWorldPoses of its owner.
+    class GZ_PHYSICS_VISIBLE WorldPartition
+    {
+      /// \brief Region of a body that is not in the partition.
+      public: static constexpr std::size_t kNoRegion =
+          std::numeric_limits<std::size_t>::max();
+
+      /// \brief A change of the owner region of a body.
+      public: struct Handover
+      {
+        /// \brief ID of the body.
+        std::size_t body;
+        /// \brief Previous owner, or kNoRegion if the body is new.
+        std::size_t from;
+        /// \brief New owner, or kNoRegion if the body was removed.
+        std::size_t to;
+      };
+
+      /// \brief A ghost of a body in a region that does not own it.
+      public: struct Ghost
+      {
+        /// \brief ID of the body.
+        std::size_t body;
+        /// \brief Region that keeps the ghost.
+        std::size_t region;
+      };
+
+      /// \brief Changes found by the most recent call to Update().
+      public: struct Changes
+      {
+        /// \brief Bodies that changed owner, ordered by body ID.
+        std::vector<Handover> handovers;
+        /// \brief Ghosts that have to be created, ordered by body ID.
+        std::vector<Ghost> addedGhosts;
+        /// \brief Ghosts that have to be removed, ordered by body ID.
+        std::vector<Ghost> removedGhosts;
+      };
+
+      /// \brief Constructor
+      /// \param[in] _bounds Region of the world to partition. Bodies outside
+      /// of it belong to the nearest region.
+      /// \param[in] _cells Number of regions along each axis. Each component
+      /// is clamped to at least 1.
+      /// \param[in] _ghostMargin Distance from a region within which bodies
+      /// of other regions are ghosted into it.
+      /// \param[in] _handoverMargin Distance that the center of a body has
+      /// to move past the border of its owner before it is handed over. This
+      /// keeps bodies that move along a border from being handed back and
+      /// forth.
+      public: WorldPartition(const AlignedBox3d &_bounds,
+                             const Eigen::Vector3i &_cells,
+                             double _ghostMargin,
+                             double _handoverMargin = 0.0);
+
+      /// \brief Destructor
+      public: ~WorldPartition();
+
+      /// \brief Get the number of regions.
+      /// \return Number of regions.
+      public: std::size_t RegionCount() const;
+
+      /// \brief Get the box of a region. The regions at the edge of the grid
+      /// also own the bodies beyond the bounds of the partition.
+      /// \param[in] _region Index of the region.
+      /// \return Box of the region, or an empty box if the index is invalid.
+      public: AlignedBox3d RegionBox(std::size_t _region) const;
+
+      /// \brief Get the region that contains a point.
+      /// \param[in] _point Point in the world frame.
+      /// \return Index of the region, which is the nearest region if the
+      /// point is beyond the bounds of the partition.
+      public: std::size_t RegionOf(const LinearVector3d &_point) const;
+
+      /// \brief Update the owners and ghosts of the bodies. Bodies that were
+      /// passed to the previous call but not to this one are removed from
+      /// the partition.
+      /// \param[in] _bodies ID of each body. IDs must be unique.
+      /// \param[in] _boxes Bounding box of each body in the world frame.
+      /// Bodies with an empty box are treated as removed.
+      /// \param[in] _count Number of bodies.
+      /// \return Changes since the previous call. The reference stays valid
+      /// until the next call.
+      public: const Changes &Update(const std::size_t *_bodies,
+                                    const AlignedBox3d *_boxes,
+                                    std::size_t _count);
+
+      /// \brief Get the region that owns a body.
+      /// \param[in] _body ID of the body.
+      /// \return Index of the region, or kNoRegion if the body is not in the
+      /// partition.
+      public: std::size_t OwnerOf(std::size_t _body) const;
+
+      /// \brief Get the regions that keep a ghost of a body.
+      /// \param[in] _body ID of the body.
+      /// \return Indices of the regions in increasing order.
+      public: std::vector<std::size_t> GhostRegionsOf(std::size_t _body) const;
+
+      /// \brief Get the bodies owned by a region.
+      /// \param[in] _region Index of the region.
+      /// \return IDs of the bodies in increasing order.
+      public: std::vector<std::size_t> BodiesOf(std::size_t _region) const;
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<WorldPartitionPrivate> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+  }
+}
+
+#endif
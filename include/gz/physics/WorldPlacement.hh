@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_WORLDPLACEMENT_HH_
+#define GZ_PHYSICS_WORLDPLACEMENT_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include <gz/physics/Export.hh>
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/ForwardStep.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief Get the number of NUMA nodes of the machine.
+    /// \return Number of nodes, 1 where it can not be told, e.g. on
+    /// platforms other than Linux.
+    GZ_PHYSICS_VISIBLE
+    std::size_t NumaNodeCount();
+
+    /////////////////////////////////////////////////
+    /// \brief Get the cores of a NUMA node.
+    /// \param[in] _node Index of the node.
+    /// \return Indices of the cores of the node, in increasing order, empty
+    /// if there is no such node. Where nodes can not be told, node 0 has
+    /// all cores.
+    GZ_PHYSICS_VISIBLE
+    std::vector<std::size_t> NumaNodeCores(std::size_t _node);
+
+    /////////////////////////////////////////////////
+    /// \brief Cores that a world is stepped on, and whose memory node it is
+    /// allocated from, see WorldPlacementFeature.
+    struct GZ_PHYSICS_VISIBLE WorldPlacement
+    {
+      /// \brief NUMA node of the world, or -1 for none. Used when cores is
+      /// empty.
+      int numaNode = -1;
+
+      /// \brief Indices of the cores of the world. Takes precedence over
+      /// numaNode.
+      std::vector<std::size_t> cores;
+
+      /// \brief Get the cores that the placement resolves to.
+      /// \return Indices of the cores, in increasing order, empty if the
+      /// world is not placed.
+      std::vector<std::size_t> Cores() const;
+
+      /// \brief Placements are equal if their fields are.
+      bool operator==(const WorldPlacement &_other) const;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief WorldPlacementFeature places worlds on cores or NUMA nodes,
+    /// so that a machine with several sockets can step many worlds of one
+    /// engine without moving their memory across sockets.
+    ///
+    /// StepWorldsFeature::StepWorlds steps each placed world on threads
+    /// pinned to its cores, which the worlds with the same cores share, and
+    /// steps the worlds that are not placed as before. Engines allocate the
+    /// memory that a placed world needs from then on on the memory node of
+    /// its cores, by first writing it from those threads. Memory that the
+    /// world holds already stays where it is, so a world should be placed
+    /// right after it is constructed. Pinning is only supported on Linux.
+    ///
+    /// TPE allocates the entities of a placed world from an arena whose
+    /// blocks are first written on its node, unless the engine has a
+    /// MemoryResource of its own, and grows its step buffers while it is
+    /// stepped on its cores.
+    class GZ_PHYSICS_VISIBLE WorldPlacementFeature
+      : public virtual FeatureWithRequirements<StepWorldsFeature>
+    {
+      public: template <typename PolicyT, typename FeaturesT>
+      class World : public virtual Feature::World<PolicyT, FeaturesT>
+      {
+        /// \brief Set the placement of this world.
+        /// \param[in] _placement Placement, or a default constructed one to
+        /// no longer place the world.
+        public: void SetPlacement(const WorldPlacement &_placement);
+
+        /// \brief Get the placement of this world.
+        /// \return Placement, default constructed if the world is not
+        /// placed.
+        public: WorldPlacement GetPlacement() const;
+      };
+
+      public: template <typename PolicyT>
+      class Implementation : public virtual Feature::Implementation<PolicyT>
+      {
+        /// \brief Implementation API for SetPlacement
+        /// \param[in] _worldID Identity of the world
+        /// \param[in] _placement Placement of the world
+        public: virtual void SetWorldPlacement(
+            const Identity &_worldID, const WorldPlacement &_placement) = 0;
+
+        /// \brief Implementation API for GetPlacement
+        /// \param[in] _worldID Identity of the world
+        /// \return Placement of the world
+        public: virtual WorldPlacement GetWorldPlacement(
+            const Identity &_worldID) const = 0;
+      };
+    };
+  }
+}
+
+#include <gz/physics/detail/WorldPlacement.hh>
+
+#endif
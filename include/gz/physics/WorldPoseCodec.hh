@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_WORLDPOSECODEC_HH_
+#define GZ_PHYSICS_WORLDPOSECODEC_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gz/physics/Export.hh>
+#include <gz/physics/ForwardStep.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    // Forward declarations
+    class WorldPoseCodecState;
+    class WorldPoseDecoder;
+
+    /////////////////////////////////////////////////
+    /// \brief Encodes the poses of a step, such as WorldPoses or
+    /// ChangedWorldPoses, into a compact binary frame for streaming or
+    /// recording.
+    ///
+    /// Positions are quantized to a fixed resolution. Rotations are sent as
+    /// the three smallest components of the quaternion. Bodies that were in a
+    /// previous frame are coded as the difference to their last quantized
+    /// pose, and all numbers are written as variable length integers, so a
+    /// body that moved a little takes a few bytes. Keyframes code every pose
+    /// on its own, so that a decoder can start from them.
+    ///
+    /// The encoder and the decoder keep the last pose of every body. The
+    /// frames must be decoded in the order they were encoded, starting at a
+    /// keyframe. Bodies that are removed from the world can be forgotten with
+    /// Reset() or a keyframe.
+    class GZ_PHYSICS_VISIBLE WorldPoseEncoder
+    {
+      /// \brief Constructor
+      /// \param[in] _positionResolution Quantization step of the positions,
+      /// in meters.
+      /// \param[in] _rotationBits Number of bits of each quantized
+      /// quaternion component, between 8 and 30. 16 bits give an error below
+      /// 1e-4 rad.
+      /// \param[in] _keyframeInterval Encode every n-th frame as a keyframe.
+      /// 0 only makes the first frame a keyframe.
+      public: explicit WorldPoseEncoder(double _positionResolution = 1e-4,
+                                        unsigned int _rotationBits = 16,
+                                        std::size_t _keyframeInterval = 0);
+
+      /// \brief Destructor
+      public: ~WorldPoseEncoder();
+
+      /// \brief Encode poses into a frame.
+      /// \param[in] _poses Poses to encode.
+      /// \param[out] _buffer Buffer to append the frame to.
+      /// \return Number of bytes appended.
+      public: std::size_t Encode(const std::vector<WorldPose> &_poses,
+                                 std::vector<uint8_t> &_buffer);
+
+      /// \brief Encode the entries of WorldPoses, see Encode().
+      public: std::size_t Encode(const WorldPoses &_poses,
+                                 std::vector<uint8_t> &_buffer);
+
+      /// \brief Encode the entries of ChangedWorldPoses, see Encode().
+      public: std::size_t Encode(const ChangedWorldPoses &_poses,
+                                 std::vector<uint8_t> &_buffer);
+
+      /// \brief Forget the poses of all bodies and make the next frame a
+      /// keyframe.
+      public: void Reset();
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<WorldPoseCodecState> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Reads the poses of one frame in place, without copying the
+    /// frame or allocating memory for its entries. Use
+    /// WorldPoseDecoder::Read to get a reader.
+    class GZ_PHYSICS_VISIBLE WorldPoseReader
+    {
+      /// \brief Read the next pose of the frame.
+      /// \param[out] _pose Pose that was read.
+      /// \return False at the end of the frame, or if the frame is invalid.
+      public: bool Next(WorldPose &_pose);
+
+      /// \brief Get the number of poses in the frame.
+      /// \return Number of poses.
+      public: std::size_t Size() const;
+
+      /// \brief Get whether the frame is a keyframe.
+      /// \return True if the frame is a keyframe.
+      public: bool IsKeyframe() const;
+
+      /// \brief Get whether the frame is invalid. A frame is invalid if it is
+      /// truncated or malformed, or if it codes a body as a difference to a
+      /// pose that the decoder does not have.
+      /// \return True if an error was found so far.
+      public: bool Error() const;
+
+      /// \brief Get the number of bytes read so far. Once every pose was
+      /// read, this is the size of the frame, which is where the next frame
+      /// of a buffer starts.
+      /// \return Number of bytes read.
+      public: std::size_t BytesRead() const;
+
+      /// \brief Constructor, see WorldPoseDecoder::Read
+      private: WorldPoseReader(WorldPoseCodecState &_state,
+                               const uint8_t *_data, std::size_t _size);
+
+      /// \brief Read a variable length integer.
+      /// \param[out] _value Value that was read.
+      /// \return False if the frame ended before the integer.
+      private: bool ReadVarint(uint64_t &_value);
+
+      /// \brief State of the decoder that the poses are read with.
+      private: WorldPoseCodecState *state;
+
+      /// \brief Start of the frame.
+      private: const uint8_t *begin;
+
+      /// \brief Next byte to read.
+      private: const uint8_t *cursor;
+
+      /// \brief End of the buffer.
+      private: const uint8_t *end;
+
+      /// \brief Number of poses in the frame.
+      private: std::size_t size = 0;
+
+      /// \brief Number of poses left to read.
+      private: std::size_t remaining = 0;
+
+      /// \brief Body of the previous pose in the frame.
+      private: uint64_t previousBody = 0;
+
+      /// \brief Quantization step of the positions of the frame.
+      private: double positionResolution = 1.0;
+
+      /// \brief Number of bits of the quaternion components of the frame.
+      private: unsigned int rotationBits = 0;
+
+      /// \brief Whether the frame is a keyframe.
+      private: bool keyframe = false;
+
+      /// \brief Whether an error was found.
+      private: bool error = false;
+
+      friend class WorldPoseDecoder;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Decodes the frames of a WorldPoseEncoder.
+    class GZ_PHYSICS_VISIBLE WorldPoseDecoder
+    {
+      /// \brief Constructor
+      public: WorldPoseDecoder();
+
+      /// \brief Destructor
+      public: ~WorldPoseDecoder();
+
+      /// \brief Get a reader for the poses of a frame. The frame is only
+      /// read as the poses are requested, and the buffer must stay valid
+      /// until then. Each pose that is read updates the last pose of its
+      /// body, so the poses of a frame must all be read before the next
+      /// frame.
+      /// \param[in] _data Start of the frame.
+      /// \param[in] _size Number of bytes from _data to the end of the
+      /// buffer. The buffer may hold more frames after this one.
+      /// \return Reader for the frame.
+      public: WorldPoseReader Read(const uint8_t *_data, std::size_t _size);
+
+      /// \brief Decode a frame.
+      /// \param[in] _data Start of the frame.
+      /// \param[in] _size Number of bytes from _data to the end of the
+      /// buffer.
+      /// \param[out] _poses Poses of the frame. Previous entries are removed.
+      /// \return Size of the frame in bytes, or 0 if the frame is invalid.
+      public: std::size_t Decode(const uint8_t *_data, std::size_t _size,
+                                 std::vector<WorldPose> &_poses);
+
+      /// \brief Forget the poses of all bodies. The next frame to decode
+      /// must be a keyframe.
+      public: void Reset();
+
+      /// \brief Pointer to the private data
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<WorldPoseCodecState> dataPtr;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+  }
+}
+
+#endif
@@ -74,6 +74,20 @@ namespace gz
       return *this;
     }
 
+    /////////////////////////////////////////////////
+    template <typename T>
+    void *MakeCloneable<T>::operator new(std::size_t _size)
+    {
+      return detail::AllocateCloneable(_size, alignof(MakeCloneable<T>));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename T>
+    void MakeCloneable<T>::operator delete(void *_ptr, std::size_t _size)
+    {
+      detail::DeallocateCloneable(_ptr, _size, alignof(MakeCloneable<T>));
+    }
+
     /////////////////////////////////////////////////
     template <typename T>
     std::unique_ptr<Cloneable> MakeCloneable<T>::Clone() const
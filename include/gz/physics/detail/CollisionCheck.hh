@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_COLLISIONCHECK_HH_
+#define GZ_PHYSICS_DETAIL_COLLISIONCHECK_HH_
+
+#include <vector>
+
+#include <gz/physics/CollisionCheck.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto ModelCollisionCheckFeature::Model<PolicyT, FeaturesT>::
+    CheckConfiguration(const GeneralizedVector &_positions,
+                       const bool _computeDistance) const -> CollisionCheck
+    {
+      return this->template Interface<ModelCollisionCheckFeature>()
+          ->CheckModelConfiguration(
+              this->identity, _positions, _computeDistance);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto ModelCollisionCheckFeature::Model<PolicyT, FeaturesT>::
+    CheckConfigurations(const std::vector<GeneralizedVector> &_positions,
+                        const bool _computeDistance,
+                        const std::size_t _numThreads) const
+        -> std::vector<CollisionCheck>
+    {
+      std::vector<CollisionCheck> results(_positions.size());
+      if (!_positions.empty())
+      {
+        this->template Interface<ModelCollisionCheckFeature>()
+            ->CheckModelConfigurations(
+                this->identity, _positions.data(), _positions.size(),
+                _computeDistance, _numThreads, results.data());
+      }
+      return results;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void SelfCollisionSamplingFeature::Engine<PolicyT, FeaturesT>::
+    SetSelfCollisionSampleCount(const std::size_t _numSamples)
+    {
+      this->template Interface<SelfCollisionSamplingFeature>()
+          ->SetEngineSelfCollisionSampleCount(this->identity, _numSamples);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    std::size_t SelfCollisionSamplingFeature::Engine<PolicyT, FeaturesT>::
+    GetSelfCollisionSampleCount() const
+    {
+      return this->template Interface<SelfCollisionSamplingFeature>()
+          ->GetEngineSelfCollisionSampleCount(this->identity);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    std::size_t SelfCollisionSamplingFeature::Model<PolicyT, FeaturesT>::
+    GetNeverCollidingLinkPairCount() const
+    {
+      return this->template Interface<SelfCollisionSamplingFeature>()
+          ->GetModelNeverCollidingLinkPairCount(this->identity);
+    }
+  }
+}
+
+#endif
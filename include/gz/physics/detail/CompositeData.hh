@@ -19,6 +19,8 @@
 #define GZ_PHYSICS_DETAIL_COMPOSITEDATA_HH_
 
 #include <memory>
+#include <string>
+#include <typeinfo>
 #include <utility>
 
 #include <gz/utils/SuppressWarning.hh>
@@ -37,16 +39,18 @@ namespace gz
       /// \brief Default constructor
       public: DataEntry();
 
-      /// \brief Constructor that accepts an rvalue reference and a
-      /// requirement setting
+      /// \brief Constructor that accepts the data of the entry, which may be
+      /// shared with other entries, and a requirement setting
       public: DataEntry(
-        std::unique_ptr<Cloneable> &&_data,
+        std::shared_ptr<Cloneable> _data,
         bool _required);
 
       GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
       /// \brief Data that is being held at this entry. nullptr means the
-      /// CompositeData does not have data for this entry
-      public: std::unique_ptr<Cloneable> data;
+      /// CompositeData does not have data for this entry. The data is shared
+      /// by the copies of the CompositeData until one of them modifies it, see
+      /// detail::LendData.
+      public: std::shared_ptr<Cloneable> data;
       GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
 
       /// \brief Flag for whether the type of data at this entry is considered
@@ -60,25 +64,57 @@ namespace gz
       /// whichever was more recent. Functions that can mark an entry as
       /// queried include Get(), InsertOrAssign(), Insert(), Query(), and Has().
       public: mutable bool queried;
+
+      /// \brief Flag for whether a mutable reference to the data of this
+      /// entry has been handed out. Such a reference may still be written
+      /// through, so the data of a lent entry is cloned instead of shared
+      /// when the entry is copied.
+      public: bool lent;
     };
 
     namespace detail
     {
+      /////////////////////////////////////////////////
+      /// \brief The key of a data type in CompositeData::dataMap. The string
+      /// is created once per type, so lookups do not allocate, and its address
+      /// identifies the type in CompositeData::dataIndex.
+      template <typename Data>
+      const std::string &DataTypeKey()
+      {
+        static const std::string key = typeid(Data).name();
+        return key;
+      }
+
       /////////////////////////////////////////////////
       /// \brief Helper function to set the query flag of previously unqueried
       /// data entries. The template argument is to support both iterator&
       /// and const_iterator& argument types. This helper functions lets us
-      /// avoid hard-to-spot typos on this frequently performed task.
+      /// avoid hard-to-spot typos on this frequently performed task. Nothing
+      /// is written if _tracking is false, see
+      /// CompositeData::SetQueryTracking.
       template <typename IteratorType>
-      void SetToQueried(const IteratorType &_it, std::size_t &_numQueries)
+      void SetToQueried(const IteratorType &_it, std::size_t &_numQueries,
+                        const bool _tracking)
       {
-        if (!_it->second.queried)
+        if (_tracking && !_it->second.queried)
         {
           ++_numQueries;
           _it->second.queried = true;
         }
       }
 
+      /////////////////////////////////////////////////
+      /// \brief Give an entry its own instance of its data if the instance is
+      /// shared with other entries, and mark the entry as lent so that its
+      /// instance is never shared again. Call this before handing out a
+      /// mutable reference to the data of an entry.
+      inline void LendData(CompositeData::DataEntry &_entry)
+      {
+        if (_entry.data && _entry.data.use_count() > 1)
+          _entry.data = _entry.data->Clone();
+        _entry.lent = true;
+      }
+
       /////////////////////////////////////////////////
       /// \internal Helper function used to implement CompositeData::Insert(...)
       /// and CompositeData::InsertOrAssign(...).
@@ -87,13 +123,12 @@ namespace gz
           const bool _assign,
           std::size_t &_numEntries,
           std::size_t &_numQueries,
-          CompositeData::MapOfData &_dataMap,
+          const bool _tracking,
+          CompositeData::MapOfData::value_type &_entry,
           Args &&..._args)
       {
         bool inserted = false;
-        const CompositeData::MapOfData::iterator it = _dataMap.insert(
-              std::make_pair(typeid(Data).name(),
-                             CompositeData::DataEntry())).first;
+        CompositeData::MapOfData::value_type *const it = &_entry;
 
         if (!it->second.data)
         {
@@ -102,13 +137,22 @@ namespace gz
                 new MakeCloneable<Data>(std::forward<Args>(_args)...));
           inserted = true;
         }
+        else if (_assign && it->second.data.use_count() > 1)
+        {
+          // There is no need to clone a shared instance which is about to be
+          // overwritten.
+          it->second.data = std::unique_ptr<Cloneable>(
+                new MakeCloneable<Data>(std::forward<Args>(_args)...));
+        }
         else if (_assign)
         {
           static_cast<MakeCloneable<Data>&>(*it->second.data) =
               MakeCloneable<Data>(std::forward<Args>(_args)...);
         }
 
-        detail::SetToQueried(it, _numQueries);
+        detail::LendData(it->second);
+
+        detail::SetToQueried(it, _numQueries, _tracking);
 
         return CompositeData::InsertResult<Data>{
           static_cast<MakeCloneable<Data>&>(*it->second.data),
@@ -116,12 +160,47 @@ namespace gz
       }
     }
 
+    /////////////////////////////////////////////////
+    template <typename Data>
+    auto CompositeData::FindEntry() const -> MapOfData::value_type *
+    {
+      const std::string &key = detail::DataTypeKey<Data>();
+      for (const IndexEntry &indexed : this->dataIndex)
+      {
+        if (indexed.key == &key)
+          return indexed.entry;
+      }
+
+      const MapOfData::const_iterator it = this->dataMap.find(key);
+      if (this->dataMap.end() == it)
+        return nullptr;
+
+      // The map is only const here because this function is. The const
+      // callers only read from the entry, apart from its mutable flags.
+      return const_cast<MapOfData::value_type*>(&*it);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename Data>
+    auto CompositeData::FindOrCreateEntry() -> MapOfData::value_type &
+    {
+      const std::string &key = detail::DataTypeKey<Data>();
+      for (const IndexEntry &indexed : this->dataIndex)
+      {
+        if (indexed.key == &key)
+          return *indexed.entry;
+      }
+
+      auto *entry = &*this->dataMap.try_emplace(key).first;
+      this->dataIndex.push_back(IndexEntry{&key, entry});
+      return *entry;
+    }
+
     /////////////////////////////////////////////////
     template <typename Data>
     Data &CompositeData::Get()
     {
-      const MapOfData::iterator it = this->dataMap.insert(
-            std::make_pair(typeid(Data).name(), DataEntry())).first;
+      MapOfData::value_type *const it = &this->FindOrCreateEntry<Data>();
 
       if (!it->second.data)
       {
@@ -129,7 +208,9 @@ namespace gz
         it->second.data = std::unique_ptr<Cloneable>(new MakeCloneable<Data>());
       }
 
-      detail::SetToQueried(it, this->numQueries);
+      detail::LendData(it->second);
+
+      detail::SetToQueried(it, this->numQueries, this->queryTracking);
 
       return static_cast<MakeCloneable<Data>&>(*it->second.data);
     }
@@ -139,7 +220,8 @@ namespace gz
     auto CompositeData::Insert(Args &&..._args) -> InsertResult<Data>
     {
       return detail::InsertHelper<Data>(
-            false, this->numEntries, this->numQueries, this->dataMap,
+            false, this->numEntries, this->numQueries, this->queryTracking,
+            this->FindOrCreateEntry<Data>(),
             std::forward<Args>(_args)...);
     }
 
@@ -148,7 +230,8 @@ namespace gz
     auto CompositeData::InsertOrAssign(Args &&..._args) -> InsertResult<Data>
     {
       return detail::InsertHelper<Data>(
-            true, this->numEntries, this->numQueries, this->dataMap,
+            true, this->numEntries, this->numQueries, this->queryTracking,
+            this->FindOrCreateEntry<Data>(),
             std::forward<Args>(_args)...);
     }
 
@@ -156,10 +239,9 @@ namespace gz
     template <typename Data>
     bool CompositeData::Remove()
     {
-      const MapOfData::iterator it =
-          this->dataMap.find(typeid(Data).name());
+      MapOfData::value_type *const it = this->FindEntry<Data>();
 
-      if (this->dataMap.end() == it || !it->second.data)
+      if (nullptr == it || !it->second.data)
         return true;
 
       // Do not remove it if it's required
@@ -182,17 +264,18 @@ namespace gz
     template <typename Data>
     Data *CompositeData::Query(const QueryMode _mode)
     {
-      const MapOfData::const_iterator it =
-          this->dataMap.find(typeid(Data).name());
+      MapOfData::value_type *const it = this->FindEntry<Data>();
 
-      if (this->dataMap.end() == it)
+      if (nullptr == it)
         return nullptr;
 
       if (!it->second.data)
         return nullptr;
 
+      detail::LendData(it->second);
+
       if (QueryMode::NORMAL == _mode)
-        detail::SetToQueried(it, this->numQueries);
+        detail::SetToQueried(it, this->numQueries, this->queryTracking);
 
       return static_cast<MakeCloneable<Data>*>(it->second.data.get());
     }
@@ -201,17 +284,16 @@ namespace gz
     template <typename Data>
     const Data *CompositeData::Query(const QueryMode _mode) const
     {
-      const MapOfData::const_iterator it =
-          this->dataMap.find(typeid(Data).name());
+      const MapOfData::value_type *const it = this->FindEntry<Data>();
 
-      if (this->dataMap.end() == it)
+      if (nullptr == it)
         return nullptr;
 
       if (!it->second.data)
         return nullptr;
 
       if (QueryMode::NORMAL == _mode)
-        detail::SetToQueried(it, this->numQueries);
+        detail::SetToQueried(it, this->numQueries, this->queryTracking);
 
       return static_cast<const MakeCloneable<Data>*>(it->second.data.get());
     }
@@ -230,10 +312,9 @@ namespace gz
       // status is initialized to everything being false
       DataStatus status;
 
-      const MapOfData::const_iterator it =
-          this->dataMap.find(typeid(Data).name());
+      const MapOfData::value_type *const it = this->FindEntry<Data>();
 
-      if (this->dataMap.end() == it)
+      if (nullptr == it)
         return status;
 
       if (!it->second.data)
@@ -250,10 +331,9 @@ namespace gz
     template <typename Data>
     bool CompositeData::Unquery() const
     {
-      const MapOfData::const_iterator it =
-          this->dataMap.find(typeid(Data).name());
+      const MapOfData::value_type *const it = this->FindEntry<Data>();
 
-      if (this->dataMap.end() == it)
+      if (nullptr == it)
         return false;
 
       if (!it->second.data)
@@ -272,8 +352,7 @@ namespace gz
     template <typename Data, typename... Args>
     Data &CompositeData::MakeRequired(Args &&..._args)
     {
-      const MapOfData::iterator it = this->dataMap.insert(
-            std::make_pair(typeid(Data).name(), DataEntry())).first;
+      MapOfData::value_type *const it = &this->FindOrCreateEntry<Data>();
 
       it->second.required = true;
       if (!it->second.data)
@@ -283,7 +362,9 @@ namespace gz
               new MakeCloneable<Data>(std::forward<Args>(_args)...));
       }
 
-      detail::SetToQueried(it, this->numQueries);
+      detail::LendData(it->second);
+
+      detail::SetToQueried(it, this->numQueries, this->queryTracking);
 
       return static_cast<MakeCloneable<Data>&>(*it->second.data);
     }
@@ -292,10 +373,9 @@ namespace gz
     template <typename Data>
     bool CompositeData::Requires() const
     {
-      const MapOfData::const_iterator it =
-          this->dataMap.find(typeid(Data).name());
+      const MapOfData::value_type *const it = this->FindEntry<Data>();
 
-      if (this->dataMap.end() == it)
+      if (nullptr == it)
         return false;
 
       return it->second.required;
@@ -97,6 +97,27 @@ bool SetContactPropertiesCallbackFeature::World<PolicyT, FeaturesT>::
     RemoveContactPropertiesCallback(this->identity, _callbackID);
 }
 
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SetContactPropertiesBatchCallbackFeature::World<PolicyT, FeaturesT>::
+  AddContactPropertiesBatchCallback(
+    const std::string &_callbackID,
+    SurfaceParamsBatchCallback _callback)
+{
+  this->template Interface<SetContactPropertiesBatchCallbackFeature>()
+    ->AddContactPropertiesBatchCallback(
+      this->identity, _callbackID, std::move(_callback));
+}
+
+/////////////////////////////////////////////////
+template<typename PolicyT, typename FeaturesT>
+bool SetContactPropertiesBatchCallbackFeature::World<PolicyT, FeaturesT>::
+  RemoveContactPropertiesBatchCallback(const std::string& _callbackID)
+{
+  return this->template Interface<SetContactPropertiesBatchCallbackFeature>()
+    ->RemoveContactPropertiesBatchCallback(this->identity, _callbackID);
+}
+
 }  // namespace physics
 }  // namespace gz
 
@@ -312,6 +312,84 @@ namespace gz
       return std::hash<std::size_t>()(this->entity->EntityID());
     }
 
+    /////////////////////////////////////////////////
+    template <typename EntityT>
+    EntityT *EntityRef<EntityT>::Proxy::operator->()
+    {
+      return &this->entity;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename EntityT>
+    EntityRef<EntityT>::Proxy::Proxy(const EntityRef &_ref)
+      // The aliasing constructors give pointers without a control block, so
+      // copying them never touches a reference count.
+      : entity(std::shared_ptr<typename std::remove_const_t<EntityT>::Pimpl>(
+                   std::shared_ptr<void>(), _ref.pimpl),
+               Identity(_ref.id,
+                   std::shared_ptr<void>(std::shared_ptr<void>(), _ref.ref)))
+    {
+      // Do nothing
+    }
+
+    /////////////////////////////////////////////////
+    template <typename EntityT>
+    EntityRef<EntityT>::EntityRef(const EntityPtr<EntityT> &_ptr)
+    {
+      if (_ptr)
+      {
+        this->pimpl = _ptr.entity->pimpl.get();
+        this->id = _ptr.entity->identity.id;
+        this->ref = _ptr.entity->identity.ref.get();
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <typename EntityT>
+    auto EntityRef<EntityT>::operator->() const -> Proxy
+    {
+      return Proxy(*this);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename EntityT>
+    bool EntityRef<EntityT>::Valid() const
+    {
+      return nullptr != this->pimpl;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename EntityT>
+    EntityRef<EntityT>::operator bool() const
+    {
+      return this->Valid();
+    }
+
+    /////////////////////////////////////////////////
+    template <typename EntityT>
+    std::size_t EntityRef<EntityT>::EntityID() const
+    {
+      return this->id;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename EntityT>
+    template <typename OtherEntityT>
+    bool EntityRef<EntityT>::operator==(
+        const EntityRef<OtherEntityT> &_other) const
+    {
+      return this->id == _other.EntityID();
+    }
+
+    /////////////////////////////////////////////////
+    template <typename EntityT>
+    template <typename OtherEntityT>
+    bool EntityRef<EntityT>::operator!=(
+        const EntityRef<OtherEntityT> &_other) const
+    {
+      return !(*this == _other);
+    }
+
     /////////////////////////////////////////////////
     template <typename Policy, typename Features>
     const Identity &Entity<Policy, Features>::FullIdentity() const
@@ -362,8 +440,11 @@ namespace gz
     typename FeatureT::template Implementation<Policy>*
     Entity<Policy, Features>::Interface()
     {
-      return (*this->pimpl)->template QueryInterface<
-          typename FeatureT::template Implementation<Policy>>();
+      if constexpr (Pimpl::template CachesInterface<FeatureT>())
+        return this->pimpl->template CachedInterface<FeatureT>();
+      else
+        return (*this->pimpl)->template QueryInterface<
+            typename FeatureT::template Implementation<Policy>>();
     }
 
     /////////////////////////////////////////////////
@@ -372,8 +453,11 @@ namespace gz
     const typename FeatureT::template Implementation<Policy>*
     Entity<Policy, Features>::Interface() const
     {
-      return (*this->pimpl)->template QueryInterface<
-          typename FeatureT::template Implementation<Policy>>();
+      if constexpr (Pimpl::template CachesInterface<FeatureT>())
+        return this->pimpl->template CachedInterface<FeatureT>();
+      else
+        return (*this->pimpl)->template QueryInterface<
+            typename FeatureT::template Implementation<Policy>>();
     }
 
     /////////////////////////////////////////////////
@@ -117,6 +117,131 @@ namespace gz
         struct type { };
       };
 
+      /////////////////////////////////////////////////
+      /// \private This class provides a static constexpr member named `value`
+      /// which is the index of the first entry of Tuple that is exactly T, or
+      /// the size of Tuple if T is not one of its entries.
+      template <typename T, typename Tuple>
+      struct TupleIndex;
+
+      template <typename T>
+      struct TupleIndex<T, std::tuple<>>
+          : std::integral_constant<std::size_t, 0> { };
+
+      template <typename T, typename... Others>
+      struct TupleIndex<T, std::tuple<T, Others...>>
+          : std::integral_constant<std::size_t, 0> { };
+
+      template <typename T, typename U, typename... Others>
+      struct TupleIndex<T, std::tuple<U, Others...>>
+          : std::integral_constant<std::size_t,
+              1 + TupleIndex<T, std::tuple<Others...>>::value> { };
+
+      /////////////////////////////////////////////////
+      /// \private The plugin pointer held by entities. It looks up the
+      /// implementation of every feature in FeatureTuple once, whenever it is
+      /// constructed or assigned, so that Entity::Interface() can return them
+      /// without querying the plugin on every call.
+      template <typename Policy, typename Specializer, typename FeatureTuple>
+      class InterfaceCachingPluginPtr;
+
+      template <typename Policy, typename Specializer, typename... Features>
+      class InterfaceCachingPluginPtr<
+          Policy, Specializer, std::tuple<Features...>>
+        : public ::gz::plugin::TemplatePluginPtr<Specializer>
+      {
+        private: using Base = ::gz::plugin::TemplatePluginPtr<Specializer>;
+
+        public: InterfaceCachingPluginPtr() = default;
+
+        public: InterfaceCachingPluginPtr(
+            const InterfaceCachingPluginPtr &) = default;
+
+        public: InterfaceCachingPluginPtr(
+            InterfaceCachingPluginPtr &&) = default;
+
+        public: InterfaceCachingPluginPtr &operator=(
+            const InterfaceCachingPluginPtr &) = default;
+
+        public: InterfaceCachingPluginPtr &operator=(
+            InterfaceCachingPluginPtr &&) = default;
+
+        /// \brief Construct from a pointer to the same plugin with any other
+        /// set of specializations.
+        /// \param[in] _other Plugin pointer to copy.
+        public: template <typename OtherSpecializer>
+        // cppcheck-suppress noExplicitConstructor
+        InterfaceCachingPluginPtr(
+            const ::gz::plugin::TemplatePluginPtr<OtherSpecializer> &_other)
+          : Base(_other)
+        {
+          this->UpdateInterfaces();
+        }
+
+        /// \brief Assign from a pointer to the same plugin with any other set
+        /// of specializations.
+        /// \param[in] _other Plugin pointer to copy.
+        /// \return Reference to this object.
+        public: template <typename OtherSpecializer>
+        InterfaceCachingPluginPtr &operator=(
+            const ::gz::plugin::TemplatePluginPtr<OtherSpecializer> &_other)
+        {
+          Base::operator=(_other);
+          this->UpdateInterfaces();
+          return *this;
+        }
+
+        /// \brief Release the plugin.
+        /// \return Reference to this object.
+        public: InterfaceCachingPluginPtr &operator=(std::nullptr_t)
+        {
+          Base::operator=(nullptr);
+          this->UpdateInterfaces();
+          return *this;
+        }
+
+        /// \brief Whether the implementation of FeatureT is cached.
+        /// \return True if FeatureT is one of the features of the list.
+        public: template <typename FeatureT>
+        static constexpr bool CachesInterface()
+        {
+          return TupleIndex<FeatureT, std::tuple<Features...>>::value
+              < sizeof...(Features);
+        }
+
+        /// \brief Get the cached implementation of FeatureT.
+        /// \return The implementation, or nullptr if the plugin does not
+        /// provide it.
+        public: template <typename FeatureT>
+        typename FeatureT::template Implementation<Policy> *CachedInterface()
+            const
+        {
+          static_assert(CachesInterface<FeatureT>(),
+              "THE IMPLEMENTATION OF THIS FEATURE IS NOT CACHED");
+          return std::get<TupleIndex<FeatureT, std::tuple<Features...>>::value>(
+              this->interfaces);
+        }
+
+        /// \brief Look up the implementation of every feature.
+        private: void UpdateInterfaces()
+        {
+          if (this->IsEmpty())
+          {
+            this->interfaces = {};
+            return;
+          }
+
+          this->interfaces = std::make_tuple(
+              (*this)->template QueryInterface<
+                  typename Features::template Implementation<Policy>>()...);
+        }
+
+        /// \brief Implementation of each feature, in the order of the list.
+        private: std::tuple<
+            typename Features::template Implementation<Policy>*...>
+                interfaces{};
+      };
+
       /////////////////////////////////////////////////
       /// \private This class is used to determine what type of
       /// SpecializedPluginPtr should be used by the entities provided by a
@@ -128,7 +253,8 @@ namespace gz
             : ::gz::plugin::detail::SelectSpecializers<
               typename ComposePlugin<Policy, FeaturesT>::type> { };
 
-        using type = ::gz::plugin::TemplatePluginPtr<Specializer>;
+        using type = InterfaceCachingPluginPtr<
+            Policy, Specializer, typename FeaturesT::Features>;
       };
 
       /////////////////////////////////////////////////
@@ -629,7 +755,10 @@ namespace gz
   using Base ## X ## P ## Ptr = Base ## X ## Ptr < \
     ::gz::physics::FeaturePolicy ## P>; \
   using ConstBase ## X ## P ## Ptr = ConstBase ## X ## Ptr <\
-    ::gz::physics::FeaturePolicy ## P>;
+    ::gz::physics::FeaturePolicy ## P>; \
+  template <typename List> \
+  using X ## P ## Ref = X ## Ref < \
+    ::gz::physics::FeaturePolicy ## P, List>;
 
 
 #define DETAIL_GZ_PHYSICS_DEFINE_ENTITY(X) \
@@ -663,6 +792,9 @@ namespace gz
   template <typename PolicyT, typename FeaturesT> \
   using Const ## X ## Ptr = ::gz::physics::EntityPtr< \
     const X <PolicyT, FeaturesT> >; \
+  template <typename PolicyT, typename FeaturesT> \
+  using X ## Ref = ::gz::physics::EntityRef< \
+    X <PolicyT, FeaturesT> >; \
   template <typename PolicyT> \
   using Base ## X ## Ptr = ::gz::physics::EntityPtr< \
     X <PolicyT, ::gz::physics::FeatureList< \
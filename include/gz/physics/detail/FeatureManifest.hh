@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_FEATUREMANIFEST_HH_
+#define GZ_PHYSICS_DETAIL_FEATUREMANIFEST_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <vector>
+
+#include <gz/utils/SuppressWarning.hh>
+
+#include <gz/physics/Export.hh>
+#include <gz/physics/Feature.hh>
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/detail/InspectFeatures.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    namespace detail
+    {
+      /////////////////////////////////////////////////
+      /// \private A set of feature implementation interfaces, with one bit
+      /// per interface. The bit of each interface is assigned by
+      /// FeatureManifests::InterfaceBit.
+      class GZ_PHYSICS_VISIBLE FeatureSet
+      {
+        /// \brief Add an interface to the set.
+        /// \param[in] _bit Bit of the interface.
+        public: void Insert(std::size_t _bit);
+
+        /// \brief Add all the interfaces of another set to this one.
+        /// \param[in] _other Set to add.
+        public: void Insert(const FeatureSet &_other);
+
+        /// \brief Check whether the set contains an interface.
+        /// \param[in] _bit Bit of the interface.
+        /// \return True if the interface is in the set.
+        public: bool Contains(std::size_t _bit) const;
+
+        /// \brief Check whether the set contains all the interfaces of
+        /// another set.
+        /// \param[in] _other Set to check.
+        /// \return True if every interface of _other is in this set.
+        public: bool Contains(const FeatureSet &_other) const;
+
+        GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Bits of the set, 64 per word.
+        private: std::vector<std::uint64_t> words;
+        GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+
+      /////////////////////////////////////////////////
+      /// \private The feature manifests of the plugins registered with
+      /// GZ_PHYSICS_ADD_PLUGIN in this process. A manifest is the set of
+      /// feature implementations that a plugin provides. It is recorded when
+      /// the library of the plugin is loaded, so checking whether a plugin
+      /// provides a list of features compares two sets instead of looking up
+      /// each feature by name in the plugin.
+      class GZ_PHYSICS_VISIBLE FeatureManifests
+      {
+        /// \brief Get the bit of a feature implementation interface. A free
+        /// bit is assigned the first time an interface is seen.
+        /// \param[in] _interface Type of the interface.
+        /// \return The bit of the interface.
+        public: static std::size_t InterfaceBit(
+            const std::type_info &_interface);
+
+        /// \brief Record the features that a plugin provides. Features that
+        /// are registered again for the same plugin type are added to its
+        /// manifest.
+        /// \param[in] _plugin Type of the plugin class.
+        /// \param[in] _features Feature implementations of the plugin.
+        public: static void Register(
+            const std::type_info &_plugin, const FeatureSet &_features);
+
+        /// \brief Record the features that a plugin provides, given the types
+        /// of their implementation interfaces. This lets a plugin register
+        /// its manifest with a static table instead of instantiating a
+        /// FeatureSetOf for its feature list.
+        /// \param[in] _plugin Type of the plugin class.
+        /// \param[in] _interfaces Array of the implementation interfaces.
+        /// \param[in] _count Number of entries in _interfaces.
+        public: static void Register(
+            const std::type_info &_plugin,
+            const std::type_info *const *_interfaces,
+            std::size_t _count);
+
+        /// \brief Find the manifest of a plugin by its type.
+        /// \param[in] _plugin Type of the plugin class.
+        /// \return The manifest, or nullptr if the plugin was not registered.
+        public: static std::shared_ptr<const FeatureSet> Find(
+            const std::type_info &_plugin);
+
+        /// \brief Find the manifest of a plugin by its name, as reported by
+        /// gz::plugin::Loader.
+        /// \param[in] _pluginName Demangled name of the plugin class.
+        /// \return The manifest, or nullptr if the plugin was not registered.
+        public: static std::shared_ptr<const FeatureSet> Find(
+            const std::string &_pluginName);
+      };
+
+      /////////////////////////////////////////////////
+      /// \private The set of the implementation interfaces of a tuple of
+      /// features, computed once per tuple.
+      template <typename PolicyT, typename FeatureTuple>
+      struct FeatureSetOf;
+
+      template <typename PolicyT, typename... Features>
+      struct FeatureSetOf<PolicyT, std::tuple<Features...>>
+      {
+        static const FeatureSet &Get()
+        {
+          static const FeatureSet features = []()
+          {
+            FeatureSet result;
+            (result.Insert(FeatureManifests::InterfaceBit(
+                typeid(typename Features::template Implementation<PolicyT>))),
+             ...);
+            return result;
+          }();
+          return features;
+        }
+      };
+
+      /////////////////////////////////////////////////
+      /// \private Check that a plugin provides every feature of a list. The
+      /// manifest of the plugin is used if it has one, otherwise each
+      /// feature is looked up in the plugin.
+      /// \param[in] _pimpl Pointer to the plugin.
+      /// \return True if the plugin provides all the features.
+      template <typename PolicyT, typename FeatureListT, typename PtrT>
+      bool ProvidesFeatures(const PtrT &_pimpl)
+      {
+        if (_pimpl)
+        {
+          const auto *implementation = _pimpl->template QueryInterface<
+              Feature::Implementation<PolicyT>>();
+          if (implementation)
+          {
+            const auto manifest = FeatureManifests::Find(
+                typeid(*implementation));
+            if (manifest)
+            {
+              return manifest->Contains(FeatureSetOf<
+                  PolicyT, typename ExpandFeatures<FeatureListT>::type>::Get());
+            }
+          }
+        }
+
+        return InspectFeatures<PolicyT, FeatureListT>::Verify(_pimpl);
+      }
+    }
+  }
+}
+
+#endif
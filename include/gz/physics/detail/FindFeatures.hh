@@ -22,6 +22,7 @@
 #include <string>
 
 #include <gz/physics/FindFeatures.hh>
+#include <gz/physics/detail/FeatureManifest.hh>
 #include <gz/physics/detail/InspectFeatures.hh>
 
 namespace gz
@@ -33,13 +34,30 @@ namespace gz
     std::set<std::string> FindFeatures<FeaturePolicyT, FeatureListT>::From(
         const LoaderT &_loader)
     {
-      auto plugins = _loader.AllPlugins();
-      detail::InspectFeatures<FeaturePolicyT, Features>::EraseIfMissing(
-            _loader, plugins);
+      const auto &required = detail::FeatureSetOf<
+          FeaturePolicyT,
+          typename detail::ExpandFeatures<Features>::type>::Get();
 
+      // Plugins registered with GZ_PHYSICS_ADD_PLUGIN have a manifest of
+      // their features. Only the plugins without one need to be looked up
+      // feature by feature.
       std::set<std::string> result;
-      for (const std::string &p : plugins)
-        result.insert(result.end(), p);
+      std::set<std::string> unknown;
+      for (const std::string &p : _loader.AllPlugins())
+      {
+        const auto manifest = detail::FeatureManifests::Find(p);
+        if (!manifest)
+          unknown.insert(unknown.end(), p);
+        else if (manifest->Contains(required))
+          result.insert(result.end(), p);
+      }
+
+      if (!unknown.empty())
+      {
+        detail::InspectFeatures<FeaturePolicyT, Features>::EraseIfMissing(
+              _loader, unknown);
+        result.insert(unknown.begin(), unknown.end());
+      }
 
       return result;
     }
@@ -36,6 +36,25 @@ namespace gz
             this->template Interface<AttachFixedJointFeature>()
                 ->AttachFixedJoint(this->identity, _parent, _name));
     }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void AttachFixedJointAsConstraintFeature::Engine<PolicyT, FeaturesT>::
+    SetAttachFixedJointAsConstraint(bool _asConstraint)
+    {
+      this->template Interface<AttachFixedJointAsConstraintFeature>()
+          ->SetEngineAttachFixedJointAsConstraint(
+              this->identity, _asConstraint);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    bool AttachFixedJointAsConstraintFeature::Engine<PolicyT, FeaturesT>::
+    GetAttachFixedJointAsConstraint() const
+    {
+      return this->template Interface<AttachFixedJointAsConstraintFeature>()
+          ->GetEngineAttachFixedJointAsConstraint(this->identity);
+    }
   }
 }
 
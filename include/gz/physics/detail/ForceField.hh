@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GZ_PHYSICS_DETAIL_FORCEFIELD_HH_
+#define GZ_PHYSICS_DETAIL_FORCEFIELD_HH_
+
+#include <gz/physics/ForceField.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+std::size_t ForceFieldFeature::World<PolicyT, FeaturesT>::AddForceField(
+    const ForceField &_field)
+{
+  return this->template Interface<ForceFieldFeature>()
+      ->AddWorldForceField(this->identity, _field);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool ForceFieldFeature::World<PolicyT, FeaturesT>::SetForceField(
+    std::size_t _fieldID, const ForceField &_field)
+{
+  return this->template Interface<ForceFieldFeature>()
+      ->SetWorldForceField(this->identity, _fieldID, _field);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool ForceFieldFeature::World<PolicyT, FeaturesT>::RemoveForceField(
+    std::size_t _fieldID)
+{
+  return this->template Interface<ForceFieldFeature>()
+      ->RemoveWorldForceField(this->identity, _fieldID);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void ForceFieldFeature::Implementation<PolicyT>::ComputeForceFieldWrench(
+    const ForceField &_field,
+    const ForceFieldLink &_link,
+    const LinearVectorType &_gravity,
+    const LinearVectorType &_linearVelocity,
+    const AngularVectorType &_angularVelocity,
+    LinearVectorType &_force,
+    AngularVectorType &_torque)
+{
+  const LinearVectorType relative = _linearVelocity - _field.fluidVelocity;
+  const Scalar drag =
+      _link.linearDrag + _link.quadraticDrag * relative.norm();
+  _force = -drag * relative
+      - _field.fluidDensity * _link.volume * _gravity;
+  _torque = -_link.angularDrag * _angularVelocity;
+}
+
+}
+}
+
+#endif
@@ -18,6 +18,7 @@
 #ifndef GZ_PHYSICS_DETAIL_FRAMEDATA_HH_
 #define GZ_PHYSICS_DETAIL_FRAMEDATA_HH_
 
+#include <gz/physics/Export.hh>
 #include <gz/physics/FrameData.hh>
 
 namespace gz
@@ -45,6 +46,27 @@ namespace gz
       this->linearAcceleration = LinearVector::Zero();
       this->angularAcceleration = AngularVector::Zero();
     }
+
+    /////////////////////////////////////////////////
+    template <typename ToScalar, typename FromScalar, std::size_t Dim>
+    FrameData<ToScalar, Dim> CastFrameData(
+        const FrameData<FromScalar, Dim> &_data)
+    {
+      FrameData<ToScalar, Dim> data;
+      data.pose = _data.pose.template cast<ToScalar>();
+      data.linearVelocity = _data.linearVelocity.template cast<ToScalar>();
+      data.angularVelocity = _data.angularVelocity.template cast<ToScalar>();
+      data.linearAcceleration =
+          _data.linearAcceleration.template cast<ToScalar>();
+      data.angularAcceleration =
+          _data.angularAcceleration.template cast<ToScalar>();
+      return data;
+    }
+
+    extern template struct GZ_PHYSICS_VISIBLE FrameData<double, 3>;
+    extern template struct GZ_PHYSICS_VISIBLE FrameData<double, 2>;
+    extern template struct GZ_PHYSICS_VISIBLE FrameData<float, 3>;
+    extern template struct GZ_PHYSICS_VISIBLE FrameData<float, 2>;
   }
 }
 
@@ -19,6 +19,10 @@
 #define GZ_PHYSICS_DETAIL_FRAMESEMANTICS_HH_
 
 #include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <Eigen/Core>
 
 #include <gz/physics/FrameSemantics.hh>
 
@@ -28,98 +32,276 @@ namespace gz
   {
     namespace detail
     {
+      /////////////////////////////////////////////////
+      /// \brief The FrameData components that the quantities of a space need
+      /// from the frames they are resolved with. Spaces which are not listed
+      /// here, including the ones defined by users, need all of them.
+      template <typename Space>
+      struct RequiredFrameDataComponents
+          : std::integral_constant<FrameDataComponents, FRAME_DATA_ALL> { };
+
+      template <typename Scalar, std::size_t Dim>
+      struct RequiredFrameDataComponents<SESpace<Scalar, Dim>>
+          : std::integral_constant<FrameDataComponents, FRAME_DATA_POSE> { };
+
+      template <typename Scalar, std::size_t Dim, typename Quantity>
+      struct RequiredFrameDataComponents<SOSpace<Scalar, Dim, Quantity>>
+          : std::integral_constant<FrameDataComponents, FRAME_DATA_POSE> { };
+
+      template <typename Scalar, std::size_t Dim>
+      struct RequiredFrameDataComponents<EuclideanSpace<Scalar, Dim>>
+          : std::integral_constant<FrameDataComponents, FRAME_DATA_POSE> { };
+
+      template <typename Scalar, std::size_t Dim>
+      struct RequiredFrameDataComponents<VectorSpace<Scalar, Dim>>
+          : std::integral_constant<FrameDataComponents, FRAME_DATA_POSE> { };
+
+      template <typename Scalar, std::size_t Dim>
+      struct RequiredFrameDataComponents<AABBSpace<Scalar, Dim>>
+          : std::integral_constant<FrameDataComponents, FRAME_DATA_POSE> { };
+
+      template <typename Scalar, std::size_t Dim>
+      struct RequiredFrameDataComponents<WrenchSpace<Scalar, Dim>>
+          : std::integral_constant<FrameDataComponents, FRAME_DATA_POSE> { };
+
+      /////////////////////////////////////////////////
+      /// \brief The frame data needed to resolve quantities of one parent
+      /// frame in terms of other frames. The frames are looked up once, when
+      /// this is constructed, and can then be applied to any number of values.
       template <typename PolicyT, typename RQ>
-      static typename RQ::Quantity Resolve(
-          const FrameSemantics::Implementation<PolicyT> &_impl,
-          const RQ &_quantity,
-          const FrameID &_relativeTo,
-          const FrameID &_inCoordinatesOf)
+      class ResolveFrames
       {
-        using Quantity = typename RQ::Quantity;
-        using Space = typename RQ::Space;
-        using FrameDataType = typename Space::FrameDataType;
-        using RotationType = typename Space::RotationType;
-
-        const FrameID &parentFrameID = _quantity.ParentFrame();
+        public: using Space = typename RQ::Space;
+        public: using FrameDataType = typename Space::FrameDataType;
+        public: using RotationType = typename Space::RotationType;
 
-        Quantity q;
-        RotationType currentCoordinates;
+        /// \brief Components of the frames that Apply reads.
+        public: static constexpr FrameDataComponents kComponents =
+            RequiredFrameDataComponents<Space>::value;
 
-        if (parentFrameID == _relativeTo)
+        public: ResolveFrames(
+            const FrameSemantics::Implementation<PolicyT> &_impl,
+            const FrameID &_parentFrameID,
+            const FrameID &_relativeTo,
+            const FrameID &_inCoordinatesOf)
         {
-          // The quantity is already expressed relative to the _relativeTo frame
+          if (_parentFrameID == _relativeTo)
+          {
+            // The quantity is already expressed relative to the _relativeTo
+            // frame
+            this->frameStep = FrameStep::NONE;
+
+            if (_relativeTo.ID() == _inCoordinatesOf.ID())
+            {
+              // The quantity is already expressed in coordinates of the
+              // _inCoordinatesOf frame
+              this->coordinatesStep = CoordinatesStep::NONE;
+              return;
+            }
 
-          if (_relativeTo.ID() == _inCoordinatesOf.ID())
+            if (_relativeTo.IsWorld())
+            {
+              // The World Frame has all zero fields
+              this->currentCoordinates = RotationType::Identity();
+            }
+            else
+            {
+              this->currentCoordinates =
+                  _impl.PartialFrameDataRelativeToWorld(
+                    _relativeTo, FRAME_DATA_POSE).pose.linear();
+            }
+          }
+          else
           {
-            // The quantity is already expressed in coordinates of the
-            // _inCoordinatesOf frame
-            return _quantity.RelativeToParent();
+            // We should only ask for the FrameData if the parent frame is not
+            // the world frame.
+            if (!_parentFrameID.IsWorld())
+            {
+              this->parentFrameData = _impl.PartialFrameDataRelativeToWorld(
+                    _parentFrameID, kComponents);
+            }
+
+            if (_relativeTo.IsWorld())
+            {
+              // Resolving quantities to the world frame requires fewer
+              // operations than resolving to an arbitrary frame, so we use a
+              // special function for that.
+              this->frameStep = FrameStep::WORLD;
+
+              // The World Frame has all zero fields
+              this->currentCoordinates = RotationType::Identity();
+            }
+            else
+            {
+              this->frameStep = FrameStep::TARGET;
+              this->relativeToData = _impl.PartialFrameDataRelativeToWorld(
+                    _relativeTo, kComponents);
+              this->currentCoordinates = this->relativeToData.pose.linear();
+            }
           }
 
-          q = _quantity.RelativeToParent();
-          if (_relativeTo.IsWorld())
+          if (_relativeTo == _inCoordinatesOf)
+          {
+            this->coordinatesStep = CoordinatesStep::NONE;
+          }
+          else if (_inCoordinatesOf.IsWorld())
           {
-            // The World Frame has all zero fields
-            currentCoordinates = RotationType::Identity();
+            // Resolving quantities to the world coordinates requires fewer
+            // operations than resolving to an arbitrary frame.
+            this->coordinatesStep = CoordinatesStep::WORLD;
           }
           else
           {
-            currentCoordinates = _impl.FrameDataRelativeToWorld(
-                  _relativeTo).pose.linear();
+            this->coordinatesStep = CoordinatesStep::TARGET;
+            this->inCoordinatesOfRotation =
+                _impl.PartialFrameDataRelativeToWorld(
+                  _inCoordinatesOf, FRAME_DATA_POSE).pose.linear();
           }
         }
-        else
-        {
-          // We should only ask for the FrameData if the parent frame is not the
-          // world frame.
-          const FrameDataType parentFrameData = parentFrameID.IsWorld() ?
-                FrameDataType() : _impl.FrameDataRelativeToWorld(parentFrameID);
 
-          if (_relativeTo.IsWorld())
+        /// \brief Resolve a value given relative to the parent frame. S may be
+        /// another space sharing the frame data type of Space, e.g. the
+        /// VectorSpace of a EuclideanSpace.
+        public: template <typename S = Space>
+        typename S::Quantity Apply(const typename S::Quantity &_value) const
+        {
+          typename S::Quantity q;
+          switch (this->frameStep)
           {
-            // Resolving quantities to the world frame requires fewer operations
-            // than resolving to an arbitrary frame, so we use a special
-            // function for that.
-            q = Space::ResolveToWorldFrame(
-                  _quantity.RelativeToParent(),
-                  parentFrameData);
-
-            // The World Frame has all zero fields
-            currentCoordinates = RotationType::Identity();
+            case FrameStep::NONE:
+              q = _value;
+              break;
+            case FrameStep::WORLD:
+              q = S::ResolveToWorldFrame(_value, this->parentFrameData);
+              break;
+            case FrameStep::TARGET:
+              q = S::ResolveToTargetFrame(
+                    _value, this->parentFrameData, this->relativeToData);
+              break;
           }
-          else
-          {
-            const FrameDataType relativeToData =
-                _impl.FrameDataRelativeToWorld(_relativeTo);
 
-            q = Space::ResolveToTargetFrame(
-                  _quantity.RelativeToParent(),
-                  parentFrameData,
-                  relativeToData);
-
-            currentCoordinates = relativeToData.pose.linear();
+          switch (this->coordinatesStep)
+          {
+            case CoordinatesStep::NONE:
+              break;
+            case CoordinatesStep::WORLD:
+              return S::ResolveToWorldCoordinates(q, this->currentCoordinates);
+            case CoordinatesStep::TARGET:
+              return S::ResolveToTargetCoordinates(
+                    q, this->currentCoordinates, this->inCoordinatesOfRotation);
           }
+
+          return q;
         }
 
-        if (_relativeTo != _inCoordinatesOf)
+        private: enum class FrameStep { NONE, WORLD, TARGET };
+        private: enum class CoordinatesStep { NONE, WORLD, TARGET };
+
+        private: FrameStep frameStep = FrameStep::NONE;
+        private: CoordinatesStep coordinatesStep = CoordinatesStep::NONE;
+
+        /// \brief The World Frame has all zero fields, so this is left
+        /// default constructed when the parent frame is the world.
+        private: FrameDataType parentFrameData;
+        private: FrameDataType relativeToData;
+        private: RotationType currentCoordinates;
+        private: RotationType inCoordinatesOfRotation;
+      };
+
+      /////////////////////////////////////////////////
+      /// \brief Whether the quantities of a space are vectors transformed by
+      /// an affine map, i.e. points and free vectors of at least two
+      /// dimensions.
+      template <typename Space>
+      struct IsAffineSpace : std::false_type { };
+
+      template <typename Scalar, std::size_t Dim>
+      struct IsAffineSpace<EuclideanSpace<Scalar, Dim>>
+          : std::integral_constant<bool, (Dim >= 2)> { };
+
+      template <typename Scalar, std::size_t Dim>
+      struct IsAffineSpace<VectorSpace<Scalar, Dim>>
+          : std::integral_constant<bool, (Dim >= 2)> { };
+
+      /////////////////////////////////////////////////
+      template <typename PolicyT, typename RQ>
+      static typename RQ::Quantity Resolve(
+          const FrameSemantics::Implementation<PolicyT> &_impl,
+          const RQ &_quantity,
+          const FrameID &_relativeTo,
+          const FrameID &_inCoordinatesOf)
+      {
+        return ResolveFrames<PolicyT, RQ>(
+              _impl, _quantity.ParentFrame(), _relativeTo, _inCoordinatesOf)
+            .Apply(_quantity.RelativeToParent());
+      }
+
+      /////////////////////////////////////////////////
+      template <typename PolicyT, typename RQ>
+      static void Resolve(
+          const FrameSemantics::Implementation<PolicyT> &_impl,
+          const RQ *_quantities,
+          const std::size_t _count,
+          typename RQ::Quantity *_resolved,
+          const FrameID &_relativeTo,
+          const FrameID &_inCoordinatesOf)
+      {
+        using Space = typename RQ::Space;
+        using Quantity = typename RQ::Quantity;
+
+        std::size_t begin = 0;
+        while (begin < _count)
         {
-          if (_inCoordinatesOf.IsWorld())
+          // Find the run of quantities which share the parent frame of the
+          // first one, so their frames are only looked up once.
+          const FrameID &parentFrameID = _quantities[begin].ParentFrame();
+          std::size_t end = begin + 1;
+          while (end < _count
+                 && _quantities[end].ParentFrame() == parentFrameID)
           {
-            // Resolving quantities to the world coordinates requires fewer
-            // operations than resolving to an arbitrary frame.
-            return Space::ResolveToWorldCoordinates(q, currentCoordinates);
+            ++end;
           }
-          else
+
+          const ResolveFrames<PolicyT, RQ> frames(
+                _impl, parentFrameID, _relativeTo, _inCoordinatesOf);
+
+          if constexpr (IsAffineSpace<Space>::value)
           {
-            const RotationType inCoordinatesOfRotation =
-                _impl.FrameDataRelativeToWorld(_inCoordinatesOf).pose.linear();
+            using Scalar = typename Quantity::Scalar;
+            constexpr int Dim = Quantity::RowsAtCompileTime;
+            using Matrix = Eigen::Matrix<Scalar, Dim, Eigen::Dynamic>;
+            using Linear = Eigen::Matrix<Scalar, Dim, Dim>;
+            using FreeVectorSpace = VectorSpace<Scalar, Dim>;
+
+            static_assert(sizeof(Quantity) == Dim * sizeof(Scalar),
+                          "Quantities must be stored without padding");
+
+            // Resolve the origin and the axes once, then transform all the
+            // values of the run as the columns of one matrix.
+            const Quantity offset = frames.Apply(Quantity::Zero());
+            Linear linear;
+            for (int c = 0; c < Dim; ++c)
+            {
+              linear.col(c) = frames.template Apply<FreeVectorSpace>(
+                    Quantity::Unit(c));
+            }
 
-            return Space::ResolveToTargetCoordinates(
-                  q, currentCoordinates, inCoordinatesOfRotation);
+            for (std::size_t i = begin; i < end; ++i)
+              _resolved[i] = _quantities[i].RelativeToParent();
+
+            Eigen::Map<Matrix> values(
+                  _resolved[begin].data(), Dim,
+                  static_cast<Eigen::Index>(end - begin));
+            values = (linear * values).colwise() + offset;
+          }
+          else
+          {
+            for (std::size_t i = begin; i < end; ++i)
+              _resolved[i] = frames.Apply(_quantities[i].RelativeToParent());
           }
-        }
 
-        return q;
+          begin = end;
+        }
       }
     }
 
@@ -145,6 +327,33 @@ namespace gz
       return this->Resolve(_quantity, _relativeTo, _relativeTo);
     }
 
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    template <typename RQ>
+    void FrameSemantics::Engine<PolicyT, FeaturesT>::Resolve(
+        const RQ *_quantities,
+        const std::size_t _count,
+        typename RQ::Quantity *_resolved,
+        const FrameID &_relativeTo,
+        const FrameID &_inCoordinatesOf) const
+    {
+      detail::Resolve<PolicyT>(
+            *this->template Interface<FrameSemantics>(),
+            _quantities, _count, _resolved, _relativeTo, _inCoordinatesOf);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    template <typename RQ>
+    void FrameSemantics::Engine<PolicyT, FeaturesT>::Resolve(
+        const RQ *_quantities,
+        const std::size_t _count,
+        typename RQ::Quantity *_resolved,
+        const FrameID &_relativeTo) const
+    {
+      this->Resolve(_quantities, _count, _resolved, _relativeTo, _relativeTo);
+    }
+
     /////////////////////////////////////////////////
     template <typename PolicyT, typename FeaturesT>
     template <typename RQ>
@@ -171,6 +380,16 @@ namespace gz
                  ->FrameDataRelativeToWorld(FrameID(this->identity));
     }
 
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto FrameSemantics::Frame<PolicyT, FeaturesT>::FrameDataRelativeToWorld(
+        const FrameDataComponents _components) const -> FrameData
+    {
+      return this->template Interface<FrameSemantics>()
+                 ->PartialFrameDataRelativeToWorld(
+                   FrameID(this->identity), _components);
+    }
+
     /////////////////////////////////////////////////
     template <typename PolicyT, typename FeaturesT>
     auto FrameSemantics::Frame<PolicyT, FeaturesT>::FrameDataRelativeTo(
@@ -208,6 +427,15 @@ namespace gz
       return this->GetFrameID();
     }
 
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    auto FrameSemantics::Implementation<PolicyT>::
+    PartialFrameDataRelativeToWorld(
+        const FrameID &_id, FrameDataComponents) const -> FrameData
+    {
+      return this->FrameDataRelativeToWorld(_id);
+    }
+
     /////////////////////////////////////////////////
     template <typename PolicyT>
     FrameID FrameSemantics::Implementation<PolicyT>::GenerateFrameID(
@@ -224,6 +452,161 @@ namespace gz
     {
       return static_cast<T *>(_frameID.ref.get());
     }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void BatchFrameSemantics::Engine<PolicyT, FeaturesT>::
+    BatchFrameDataRelativeToWorld(
+        const FrameID *_ids,
+        const std::size_t _count,
+        FrameData *_output) const
+    {
+      if (0u == _count)
+        return;
+
+      this->template Interface<BatchFrameSemantics>()
+          ->BatchFrameDataRelativeToWorld(_ids, _count, _output);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void BatchFrameSemantics::Engine<PolicyT, FeaturesT>::
+    BatchFrameDataRelativeToWorld(
+        const std::vector<FrameID> &_ids,
+        std::vector<FrameData> &_output) const
+    {
+      _output.resize(_ids.size());
+      this->BatchFrameDataRelativeToWorld(
+            _ids.data(), _ids.size(), _output.data());
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void BatchFrameSemantics::Model<PolicyT, FeaturesT>::
+    LinkFrameDataRelativeToWorld(std::vector<FrameData> &_output) const
+    {
+      this->template Interface<BatchFrameSemantics>()
+          ->LinkFrameDataRelativeToWorld(this->identity, _output);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void BatchFloatFrameSemantics::Engine<PolicyT, FeaturesT>::
+    BatchFloatFrameDataRelativeToWorld(
+        const FrameID *_ids,
+        const std::size_t _count,
+        FloatFrameData *_output) const
+    {
+      if (0u == _count)
+        return;
+
+      this->template Interface<BatchFloatFrameSemantics>()
+          ->BatchFloatFrameDataRelativeToWorld(_ids, _count, _output);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void BatchFloatFrameSemantics::Engine<PolicyT, FeaturesT>::
+    BatchFloatFrameDataRelativeToWorld(
+        const std::vector<FrameID> &_ids,
+        std::vector<FloatFrameData> &_output) const
+    {
+      _output.resize(_ids.size());
+      this->BatchFloatFrameDataRelativeToWorld(
+            _ids.data(), _ids.size(), _output.data());
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void BatchFloatFrameSemantics::Model<PolicyT, FeaturesT>::
+    LinkFloatFrameDataRelativeToWorld(
+        std::vector<FloatFrameData> &_output) const
+    {
+      this->template Interface<BatchFloatFrameSemantics>()
+          ->LinkFloatFrameDataRelativeToWorld(this->identity, _output);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    void SetFrameDataCacheFeature::FrameDataCache<PolicyT>::SetEnabled(
+        const bool _enabled)
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->enabled = _enabled;
+      if (!_enabled)
+        this->entries.clear();
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    bool SetFrameDataCacheFeature::FrameDataCache<PolicyT>::Enabled() const
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      return this->enabled;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    void SetFrameDataCacheFeature::FrameDataCache<PolicyT>::Invalidate()
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->enabled)
+        ++this->generation;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    bool SetFrameDataCacheFeature::FrameDataCache<PolicyT>::Find(
+        const std::size_t _frameID, FrameData &_data) const
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (!this->enabled)
+        return false;
+
+      const auto it = this->entries.find(_frameID);
+      if (it == this->entries.end() ||
+          it->second.generation != this->generation)
+      {
+        return false;
+      }
+
+      _data = it->second.data;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    void SetFrameDataCacheFeature::FrameDataCache<PolicyT>::Insert(
+        const std::size_t _frameID, const FrameData &_data)
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (!this->enabled)
+        return;
+
+      // Stale entries are overwritten in place, so the map stops allocating
+      // once every queried frame has an entry.
+      Entry &entry = this->entries[_frameID];
+      entry.generation = this->generation;
+      entry.data = _data;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void SetFrameDataCacheFeature::Engine<PolicyT, FeaturesT>::
+    SetFrameDataCacheEnabled(const bool _enabled)
+    {
+      this->template Interface<SetFrameDataCacheFeature>()
+          ->SetFrameDataCacheEnabled(this->identity, _enabled);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    bool SetFrameDataCacheFeature::Engine<PolicyT, FeaturesT>::
+    GetFrameDataCacheEnabled() const
+    {
+      return this->template Interface<SetFrameDataCacheFeature>()
+          ->GetFrameDataCacheEnabled(this->identity);
+    }
   }
 }
 
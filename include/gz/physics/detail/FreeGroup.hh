@@ -18,6 +18,8 @@
 #ifndef GZ_PHYSICS_DETAIL_FREEGROUP_HH_
 #define GZ_PHYSICS_DETAIL_FREEGROUP_HH_
 
+#include <vector>
+
 #include <gz/physics/FreeGroup.hh>
 
 namespace gz
@@ -126,6 +128,23 @@ namespace gz
       this->template Interface<SetFreeGroupWorldVelocity>()
         ->SetFreeGroupWorldAngularVelocity(this->identity, _angularVelocity);
     }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void SetFreeGroupWorldStates::World<PolicyT, FeaturesT>::
+    SetFreeGroupStates(const FreeGroupState *_states, std::size_t _count)
+    {
+      this->template Interface<SetFreeGroupWorldStates>()
+        ->SetWorldFreeGroupStates(this->identity, _states, _count);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void SetFreeGroupWorldStates::World<PolicyT, FeaturesT>::
+    SetFreeGroupStates(const std::vector<FreeGroupState> &_states)
+    {
+      this->SetFreeGroupStates(_states.data(), _states.size());
+    }
   }
 }
 
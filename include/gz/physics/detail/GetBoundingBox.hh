@@ -18,6 +18,8 @@
 #ifndef GZ_PHYSICS_DETAIL_GETBOUNDINGBOX_HH_
 #define GZ_PHYSICS_DETAIL_GETBOUNDINGBOX_HH_
 
+#include <limits>
+
 #include <gz/physics/GetBoundingBox.hh>
 
 namespace gz
@@ -57,6 +59,137 @@ namespace gz
       }
       return result;
     }
+
+    namespace detail
+    {
+      /// \private Get the axis aligned bounding box of a box after it is
+      /// transformed by a pose.
+      template <typename PoseT, typename AlignedBoxT>
+      AlignedBoxT TransformAlignedBox(
+          const PoseT &_pose, const AlignedBoxT &_box)
+      {
+        if (_box.isEmpty())
+          return _box;
+
+        // Unbounded shapes, such as planes, stay unbounded
+        using Scalar = typename AlignedBoxT::Scalar;
+        using VectorType = typename AlignedBoxT::VectorType;
+        if (!_box.sizes().allFinite())
+        {
+          const Scalar inf = std::numeric_limits<Scalar>::infinity();
+          return AlignedBoxT(VectorType::Constant(-inf),
+                             VectorType::Constant(inf));
+        }
+
+        // The extent of the rotated box along each world axis is the sum of
+        // the extents of the box projected onto that axis.
+        const VectorType halfSize = _box.sizes() / 2;
+        const VectorType center = _pose * _box.center();
+        const VectorType worldHalfSize = _pose.linear().cwiseAbs() * halfSize;
+        return AlignedBoxT(center - worldHalfSize, center + worldHalfSize);
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto GetWorldShapeBoundingBoxes::World<PolicyT, FeaturesT>
+    ::GetShapeBoundingBoxes() const -> ShapeBoundingBoxBatch
+    {
+      return this->template Interface<GetWorldShapeBoundingBoxes>()
+          ->GetWorldShapeBoundingBoxes(this->identity);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    void GetWorldShapeBoundingBoxes::Implementation<
+        PolicyT>::ShapeBoundingBoxStorage::Clear()
+    {
+      this->shape.clear();
+      this->box.clear();
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    void GetWorldShapeBoundingBoxes::Implementation<
+        PolicyT>::ShapeBoundingBoxStorage::Add(
+        const std::size_t _shape, const PoseType &_pose,
+        const AlignedBoxType &_localBox)
+    {
+      this->shape.push_back(_shape);
+      this->box.push_back(detail::TransformAlignedBox(_pose, _localBox));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    auto GetWorldShapeBoundingBoxes::Implementation<
+        PolicyT>::ShapeBoundingBoxStorage::View() const
+        -> ShapeBoundingBoxBatch
+    {
+      ShapeBoundingBoxBatch batch;
+      batch.size = this->shape.size();
+      batch.shape = this->shape.data();
+      batch.box = this->box.data();
+      return batch;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto GetWorldLinkBoundingBoxes::World<PolicyT, FeaturesT>
+    ::GetLinkBoundingBoxes() const -> BoundingBoxBatch
+    {
+      return this->template Interface<GetWorldLinkBoundingBoxes>()
+          ->GetWorldLinkBoundingBoxes(this->identity);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto GetWorldLinkBoundingBoxes::World<PolicyT, FeaturesT>
+    ::GetModelBoundingBoxes() const -> BoundingBoxBatch
+    {
+      return this->template Interface<GetWorldLinkBoundingBoxes>()
+          ->GetWorldModelBoundingBoxes(this->identity);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    void GetWorldLinkBoundingBoxes::Implementation<
+        PolicyT>::BoundingBoxStorage::Clear()
+    {
+      this->entity.clear();
+      this->box.clear();
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    void GetWorldLinkBoundingBoxes::Implementation<
+        PolicyT>::BoundingBoxStorage::Add(
+        const std::size_t _entity, const AlignedBoxType &_box)
+    {
+      this->entity.push_back(_entity);
+      this->box.push_back(_box);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    void GetWorldLinkBoundingBoxes::Implementation<
+        PolicyT>::BoundingBoxStorage::Add(
+        const std::size_t _entity, const PoseType &_pose,
+        const AlignedBoxType &_localBox)
+    {
+      this->Add(_entity, detail::TransformAlignedBox(_pose, _localBox));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT>
+    auto GetWorldLinkBoundingBoxes::Implementation<
+        PolicyT>::BoundingBoxStorage::View() const -> BoundingBoxBatch
+    {
+      BoundingBoxBatch batch;
+      batch.size = this->entity.size();
+      batch.entity = this->entity.data();
+      batch.box = this->box.data();
+      return batch;
+    }
   }
 }
 
@@ -18,6 +18,9 @@
 #ifndef GZ_PHYSICS_DETAIL_GETCONTACTS_HH_
 #define GZ_PHYSICS_DETAIL_GETCONTACTS_HH_
 
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
 #include <utility>
 #include <vector>
 #include <gz/physics/GetContacts.hh>
@@ -67,6 +70,377 @@ auto GetContactsFromLastStepFeature::World<
   return output;
 }
 
+/////////////////////////////////////////////////
+namespace detail
+{
+/// \brief Order of contacts used when they are sorted: by the entity IDs of
+/// their collisions, then by the coordinates of their point.
+template <typename VectorType>
+bool ContactPrecedes(std::size_t _aCollision1, std::size_t _aCollision2,
+                     const VectorType &_aPoint,
+                     std::size_t _bCollision1, std::size_t _bCollision2,
+                     const VectorType &_bPoint)
+{
+  if (_aCollision1 != _bCollision1)
+    return _aCollision1 < _bCollision1;
+  if (_aCollision2 != _bCollision2)
+    return _aCollision2 < _bCollision2;
+  for (int i = 0; i < static_cast<int>(_aPoint.size()); ++i)
+  {
+    if (_aPoint[i] != _bPoint[i])
+      return _aPoint[i] < _bPoint[i];
+  }
+  return false;
+}
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void GetContactsFromLastStepFeature::Implementation<PolicyT>::SortContacts(
+    std::vector<ContactInternal> &_contacts)
+{
+  // Identities can not be assigned, so the contacts are moved into a new
+  // vector in sorted order instead of being sorted in place.
+  std::vector<std::size_t> order(_contacts.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+      [&_contacts](std::size_t _a, std::size_t _b)
+      {
+        const ContactInternal &a = _contacts[_a];
+        const ContactInternal &b = _contacts[_b];
+        return detail::ContactPrecedes(
+            a.collision1.id, a.collision2.id, a.point,
+            b.collision1.id, b.collision2.id, b.point);
+      });
+
+  std::vector<ContactInternal> sorted;
+  sorted.reserve(_contacts.size());
+  for (const std::size_t i : order)
+    sorted.push_back(std::move(_contacts[i]));
+  _contacts.swap(sorted);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto GetContactBatchFromLastStepFeature::World<
+    PolicyT, FeaturesT>::GetContactBatchFromLastStep() const -> ContactBatch
+{
+  return this->template Interface<GetContactBatchFromLastStepFeature>()
+      ->GetContactBatchFromLastStep(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void GetContactBatchFromLastStepFeature::Implementation<
+    PolicyT>::ContactBatchStorage::Clear()
+{
+  this->collision1.clear();
+  this->collision2.clear();
+  this->point.clear();
+  this->normal.clear();
+  this->depth.clear();
+  this->force.clear();
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void GetContactBatchFromLastStepFeature::Implementation<
+    PolicyT>::ContactBatchStorage::Add(
+        std::size_t _collision1, std::size_t _collision2,
+        const VectorType &_point, const VectorType &_normal,
+        Scalar _depth, const VectorType &_force)
+{
+  this->collision1.push_back(_collision1);
+  this->collision2.push_back(_collision2);
+  this->point.push_back(_point);
+  this->normal.push_back(_normal);
+  this->depth.push_back(_depth);
+  this->force.push_back(_force);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void GetContactBatchFromLastStepFeature::Implementation<
+    PolicyT>::ContactBatchStorage::Sort()
+{
+  auto &order = this->order;
+  order.resize(this->collision1.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+      [this](std::size_t _a, std::size_t _b)
+      {
+        return detail::ContactPrecedes(
+            this->collision1[_a], this->collision2[_a], this->point[_a],
+            this->collision1[_b], this->collision2[_b], this->point[_b]);
+      });
+
+  // Contact j takes the place of contact order[j]. Follow each cycle of the
+  // permutation, swapping contacts into place and marking the entries that
+  // are done.
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    std::size_t j = i;
+    while (order[j] != i)
+    {
+      const std::size_t k = order[j];
+      std::swap(this->collision1[j], this->collision1[k]);
+      std::swap(this->collision2[j], this->collision2[k]);
+      std::swap(this->point[j], this->point[k]);
+      std::swap(this->normal[j], this->normal[k]);
+      std::swap(this->depth[j], this->depth[k]);
+      std::swap(this->force[j], this->force[k]);
+      order[j] = j;
+      j = k;
+    }
+    order[j] = j;
+  }
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+auto GetContactBatchFromLastStepFeature::Implementation<
+    PolicyT>::ContactBatchStorage::View() const -> ContactBatch
+{
+  ContactBatch batch;
+  batch.size = this->collision1.size();
+  batch.collision1 = this->collision1.data();
+  batch.collision2 = this->collision2.data();
+  batch.point = this->point.data();
+  batch.normal = this->normal.data();
+  batch.depth = this->depth.data();
+  batch.force = this->force.data();
+  return batch;
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto GetContactPairsFromLastStepFeature::World<
+    PolicyT, FeaturesT>::GetContactPairsFromLastStep() const
+    -> ContactPairBatch
+{
+  return this->template Interface<GetContactPairsFromLastStepFeature>()
+      ->GetContactPairsFromLastStep(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void GetContactPairsFromLastStepFeature::Implementation<
+    PolicyT>::ContactPairStorage::Build(const ContactBatch &_sorted)
+{
+  this->collision1.clear();
+  this->collision2.clear();
+  this->offset.clear();
+  this->count.clear();
+  this->normalForce.clear();
+  this->deepestPoint.clear();
+  this->maxDepth.clear();
+  this->contacts = _sorted;
+
+  for (std::size_t i = 0; i < _sorted.size; ++i)
+  {
+    const Scalar normalForce = _sorted.force[i].dot(_sorted.normal[i]);
+    if (this->collision1.empty() ||
+        this->collision1.back() != _sorted.collision1[i] ||
+        this->collision2.back() != _sorted.collision2[i])
+    {
+      this->collision1.push_back(_sorted.collision1[i]);
+      this->collision2.push_back(_sorted.collision2[i]);
+      this->offset.push_back(i);
+      this->count.push_back(1u);
+      this->normalForce.push_back(normalForce);
+      this->deepestPoint.push_back(_sorted.point[i]);
+      this->maxDepth.push_back(_sorted.depth[i]);
+      continue;
+    }
+
+    ++this->count.back();
+    this->normalForce.back() += normalForce;
+    if (_sorted.depth[i] > this->maxDepth.back())
+    {
+      this->deepestPoint.back() = _sorted.point[i];
+      this->maxDepth.back() = _sorted.depth[i];
+    }
+  }
+  this->offset.push_back(_sorted.size);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+auto GetContactPairsFromLastStepFeature::Implementation<
+    PolicyT>::ContactPairStorage::View() const -> ContactPairBatch
+{
+  ContactPairBatch batch;
+  batch.size = this->collision1.size();
+  batch.collision1 = this->collision1.data();
+  batch.collision2 = this->collision2.data();
+  batch.offset = this->offset.data();
+  batch.count = this->count.data();
+  batch.normalForce = this->normalForce.data();
+  batch.deepestPoint = this->deepestPoint.data();
+  batch.maxDepth = this->maxDepth.data();
+  batch.contacts = this->contacts;
+  return batch;
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void ContactFilterFeature::World<PolicyT, FeaturesT>::SetContactFilter(
+    const std::vector<std::size_t> &_entities)
+{
+  this->template Interface<ContactFilterFeature>()
+      ->SetWorldContactFilter(this->identity, _entities);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void ContactFilterFeature::World<PolicyT, FeaturesT>::ClearContactFilter()
+{
+  this->template Interface<ContactFilterFeature>()
+      ->SetWorldContactFilter(this->identity, {});
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+std::vector<std::size_t>
+ContactFilterFeature::World<PolicyT, FeaturesT>::GetContactFilter() const
+{
+  return this->template Interface<ContactFilterFeature>()
+      ->GetWorldContactFilter(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+ContactFilterFeature::Implementation<PolicyT>::ContactFilter::ContactFilter(
+    std::vector<std::size_t> _entities)
+  : entities(std::move(_entities))
+{
+  std::sort(this->entities.begin(), this->entities.end());
+  this->entities.erase(
+      std::unique(this->entities.begin(), this->entities.end()),
+      this->entities.end());
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+bool ContactFilterFeature::Implementation<PolicyT>::ContactFilter::Contains(
+    std::size_t _entity) const
+{
+  return std::binary_search(
+      this->entities.begin(), this->entities.end(), _entity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+auto ContactFilterFeature::Implementation<PolicyT>::ContactFilter::Entities()
+    const -> const std::vector<std::size_t> &
+{
+  return this->entities;
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ContactEventsFeature::World<PolicyT, FeaturesT>::GetContactEvents() const
+    -> ContactEventBatch
+{
+  return this->template Interface<ContactEventsFeature>()
+      ->GetContactEvents(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void ContactEventsFeature::Implementation<
+    PolicyT>::ContactEventTracker::AddContact(
+        std::size_t _collision1, std::size_t _collision2)
+{
+  this->added.emplace_back(std::min(_collision1, _collision2),
+                           std::max(_collision1, _collision2));
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void ContactEventsFeature::Implementation<
+    PolicyT>::ContactEventTracker::Update()
+{
+  std::sort(this->added.begin(), this->added.end());
+  this->added.erase(std::unique(this->added.begin(), this->added.end()),
+                    this->added.end());
+
+  this->nextCollision1.clear();
+  this->nextCollision2.clear();
+  this->nextPairId.clear();
+  this->eventCollision1.clear();
+  this->eventCollision2.clear();
+  this->eventPairId.clear();
+  this->eventType.clear();
+  auto addEvent = [this](std::size_t _collision1, std::size_t _collision2,
+                         std::size_t _pairId, EventType _type)
+  {
+    this->eventCollision1.push_back(_collision1);
+    this->eventCollision2.push_back(_collision2);
+    this->eventPairId.push_back(_pairId);
+    this->eventType.push_back(_type);
+  };
+
+  // Both lists of pairs are sorted, so they are merged in one pass. Pairs
+  // in both keep their ID, the others begin or end.
+  std::size_t i = 0u;
+  std::size_t j = 0u;
+  while (i < this->activeCollision1.size() || j < this->added.size())
+  {
+    const bool ended = j == this->added.size() ||
+        (i < this->activeCollision1.size() &&
+         std::make_pair(this->activeCollision1[i], this->activeCollision2[i]) <
+            this->added[j]);
+    if (ended)
+    {
+      addEvent(this->activeCollision1[i], this->activeCollision2[i],
+               this->activePairId[i], EventType::END);
+      ++i;
+      continue;
+    }
+
+    const auto &pair = this->added[j++];
+    std::size_t id = 0u;
+    if (i < this->activeCollision1.size() &&
+        this->activeCollision1[i] == pair.first &&
+        this->activeCollision2[i] == pair.second)
+    {
+      id = this->activePairId[i++];
+    }
+    else
+    {
+      id = this->nextId++;
+      addEvent(pair.first, pair.second, id, EventType::BEGIN);
+    }
+    this->nextCollision1.push_back(pair.first);
+    this->nextCollision2.push_back(pair.second);
+    this->nextPairId.push_back(id);
+  }
+
+  this->activeCollision1.swap(this->nextCollision1);
+  this->activeCollision2.swap(this->nextCollision2);
+  this->activePairId.swap(this->nextPairId);
+  this->added.clear();
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+auto ContactEventsFeature::Implementation<
+    PolicyT>::ContactEventTracker::View() const -> ContactEventBatch
+{
+  ContactEventBatch batch;
+  batch.size = this->eventCollision1.size();
+  batch.collision1 = this->eventCollision1.data();
+  batch.collision2 = this->eventCollision2.data();
+  batch.pairId = this->eventPairId.data();
+  batch.type = this->eventType.data();
+  batch.activeSize = this->activeCollision1.size();
+  batch.activeCollision1 = this->activeCollision1.data();
+  batch.activeCollision2 = this->activeCollision2.data();
+  batch.activePairId = this->activePairId.data();
+  return batch;
+}
+
 }  // namespace physics
 }  // namespace gz
 
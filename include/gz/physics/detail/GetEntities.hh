@@ -19,6 +19,7 @@
 #define GZ_PHYSICS_DETAIL_GETENTITIES_HH_
 
 #include <string>
+#include <vector>
 #include <gz/physics/GetEntities.hh>
 
 namespace gz
@@ -541,6 +542,101 @@ namespace gz
             this->template Interface<WorldModelFeature>()
               ->GetWorldModel(this->identity));
     }
+
+    namespace detail
+    {
+      /// \private Wrap the identities of a batch of entities in entity
+      /// pointers.
+      template <typename EntityPtrT, typename PimplPtrT>
+      std::vector<EntityPtrT> MakeEntityPtrs(
+          const PimplPtrT &_pimpl, const std::vector<Identity> &_ids)
+      {
+        std::vector<EntityPtrT> entities;
+        entities.reserve(_ids.size());
+        for (const Identity &id : _ids)
+          entities.emplace_back(_pimpl, id);
+        return entities;
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto GetEntityBatchFeature::World<PolicyT, FeaturesT>::GetModels()
+        -> std::vector<ModelPtrType>
+    {
+      return detail::MakeEntityPtrs<ModelPtrType>(this->pimpl,
+            this->template Interface<GetEntityBatchFeature>()
+              ->GetWorldModels(this->identity));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto GetEntityBatchFeature::World<PolicyT, FeaturesT>::GetModels() const
+        -> std::vector<ConstModelPtrType>
+    {
+      return detail::MakeEntityPtrs<ConstModelPtrType>(this->pimpl,
+            this->template Interface<GetEntityBatchFeature>()
+              ->GetWorldModels(this->identity));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto GetEntityBatchFeature::Model<PolicyT, FeaturesT>::GetLinks()
+        -> std::vector<LinkPtrType>
+    {
+      return detail::MakeEntityPtrs<LinkPtrType>(this->pimpl,
+            this->template Interface<GetEntityBatchFeature>()
+              ->GetModelLinks(this->identity));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto GetEntityBatchFeature::Model<PolicyT, FeaturesT>::GetLinks() const
+        -> std::vector<ConstLinkPtrType>
+    {
+      return detail::MakeEntityPtrs<ConstLinkPtrType>(this->pimpl,
+            this->template Interface<GetEntityBatchFeature>()
+              ->GetModelLinks(this->identity));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto GetEntityBatchFeature::Model<PolicyT, FeaturesT>::GetJoints()
+        -> std::vector<JointPtrType>
+    {
+      return detail::MakeEntityPtrs<JointPtrType>(this->pimpl,
+            this->template Interface<GetEntityBatchFeature>()
+              ->GetModelJoints(this->identity));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto GetEntityBatchFeature::Model<PolicyT, FeaturesT>::GetJoints() const
+        -> std::vector<ConstJointPtrType>
+    {
+      return detail::MakeEntityPtrs<ConstJointPtrType>(this->pimpl,
+            this->template Interface<GetEntityBatchFeature>()
+              ->GetModelJoints(this->identity));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    bool EntityChangeJournalFeature::World<PolicyT, FeaturesT>::
+    GetEntityChanges(std::size_t &_cursor,
+                     std::vector<EntityChange> &_changes) const
+    {
+      return this->template Interface<EntityChangeJournalFeature>()
+          ->GetWorldEntityChanges(this->identity, _cursor, _changes);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    std::size_t EntityChangeJournalFeature::World<PolicyT, FeaturesT>::
+    GetEntityChangeCursor() const
+    {
+      return this->template Interface<EntityChangeJournalFeature>()
+          ->GetWorldEntityChangeCursor(this->identity);
+    }
   }
 }
 
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_HYBRIDWORLD_HH_
+#define GZ_PHYSICS_DETAIL_HYBRIDWORLD_HH_
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gz/physics/HybridWorld.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    HybridWorld<DynamicWorldPtrT, KinematicWorldPtrT>::HybridWorld(
+        DynamicWorldPtrT _dynamic, KinematicWorldPtrT _kinematic)
+      : dynamic(std::move(_dynamic)),
+        kinematic(std::move(_kinematic))
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    bool HybridWorld<DynamicWorldPtrT, KinematicWorldPtrT>::AddProxy(
+        const std::string &_name)
+    {
+      for (const Proxy &proxy : this->proxies)
+      {
+        if (proxy.name == _name)
+          return false;
+      }
+
+      auto kinematicModel = this->kinematic->GetModel(_name);
+      DynamicModelPtr model = this->dynamic->GetModel(_name);
+      if (!kinematicModel || !model)
+        return false;
+
+      Proxy proxy;
+      proxy.name = _name;
+      proxy.link = kinematicModel->GetLink(0u);
+      proxy.freeGroup = model->FindFreeGroup();
+      if (!proxy.link || !proxy.freeGroup)
+        return false;
+
+      model->SetKinematic(true);
+      proxy.model = std::move(model);
+      this->proxies.push_back(std::move(proxy));
+      this->IndexShapes();
+      this->Sync(this->proxies.size() - 1u);
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    bool HybridWorld<DynamicWorldPtrT, KinematicWorldPtrT>::RemoveProxy(
+        const std::string &_name)
+    {
+      auto it = std::find_if(this->proxies.begin(), this->proxies.end(),
+          [&](const Proxy &_proxy) { return _proxy.name == _name; });
+      if (it == this->proxies.end())
+        return false;
+
+      it->model->SetKinematic(false);
+      this->proxies.erase(it);
+      this->IndexShapes();
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    std::size_t
+    HybridWorld<DynamicWorldPtrT, KinematicWorldPtrT>::GetProxyCount() const
+    {
+      return this->proxies.size();
+    }
+
+    /////////////////////////////////////////////////
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    void HybridWorld<DynamicWorldPtrT, KinematicWorldPtrT>::Step(
+        ForwardStep::Output &_dynamicOutput,
+        ForwardStep::Output &_kinematicOutput,
+        const ForwardStep::Input &_input)
+    {
+      // The proxies take the state of the kinematic world at the start of
+      // the step, so both worlds integrate over the same interval
+      for (std::size_t i = 0; i < this->proxies.size(); ++i)
+        this->Sync(i);
+
+      this->kinematic->Step(_kinematicOutput, this->kinematicState, _input);
+      this->dynamic->Step(_dynamicOutput, this->dynamicState, _input);
+      this->CollectContacts();
+    }
+
+    /////////////////////////////////////////////////
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    auto HybridWorld<DynamicWorldPtrT, KinematicWorldPtrT>::GetProxyContacts()
+        const -> const std::vector<ProxyContact> &
+    {
+      return this->contacts;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    void HybridWorld<DynamicWorldPtrT, KinematicWorldPtrT>::Sync(
+        const std::size_t _index)
+    {
+      const Proxy &proxy = this->proxies[_index];
+      const auto data = proxy.link->FrameDataRelativeToWorld();
+      proxy.freeGroup->SetWorldPose(data.pose);
+      proxy.freeGroup->SetWorldLinearVelocity(data.linearVelocity);
+      proxy.freeGroup->SetWorldAngularVelocity(data.angularVelocity);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    void HybridWorld<DynamicWorldPtrT, KinematicWorldPtrT>::CollectContacts()
+    {
+      this->contacts.clear();
+      if (this->proxies.empty())
+        return;
+
+      const auto batch = this->dynamic->GetContactBatchFromLastStep();
+      for (std::size_t i = 0; i < batch.size; ++i)
+      {
+        const auto it1 = this->shapeProxy.find(batch.collision1[i]);
+        const auto it2 = this->shapeProxy.find(batch.collision2[i]);
+        const bool first = it1 != this->shapeProxy.end();
+        const bool second = it2 != this->shapeProxy.end();
+
+        // Contacts within the crowd belong to the kinematic world
+        if (first == second)
+          continue;
+
+        ProxyContact contact;
+        contact.point = batch.point[i];
+        if (batch.force)
+          contact.force = batch.force[i];
+        if (first)
+        {
+          contact.proxy = this->proxies[it1->second].name;
+          contact.proxyShape = batch.collision1[i];
+          contact.otherShape = batch.collision2[i];
+        }
+        else
+        {
+          contact.proxy = this->proxies[it2->second].name;
+          contact.proxyShape = batch.collision2[i];
+          contact.otherShape = batch.collision1[i];
+          contact.force = -contact.force;
+        }
+        this->contacts.push_back(std::move(contact));
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <typename DynamicWorldPtrT, typename KinematicWorldPtrT>
+    void HybridWorld<DynamicWorldPtrT, KinematicWorldPtrT>::IndexShapes()
+    {
+      this->shapeProxy.clear();
+      for (std::size_t i = 0; i < this->proxies.size(); ++i)
+      {
+        const auto &model = this->proxies[i].model;
+        for (std::size_t l = 0; l < model->GetLinkCount(); ++l)
+        {
+          const auto link = model->GetLink(l);
+          for (std::size_t s = 0; s < link->GetShapeCount(); ++s)
+            this->shapeProxy[link->GetShape(s)->EntityID()] = i;
+        }
+      }
+    }
+  }
+}
+
+#endif
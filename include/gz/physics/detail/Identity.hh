@@ -30,6 +30,7 @@ namespace gz
   {
     // Forward declare
     template <typename, typename> class Entity;
+    template <typename> class EntityRef;
     class Identity;
 
     namespace detail
@@ -45,6 +46,14 @@ namespace gz
             std::size_t _id,
             const std::shared_ptr<void> &_ref = nullptr) const;
 
+        /// \brief Same as GenerateIdentity(std::size_t, const
+        /// std::shared_ptr<void>&), but moves _ref into the identity. This is
+        /// chosen when _ref is converted from a pointer to the type of the
+        /// entity, so the converted pointer is not copied a second time.
+        protected: Identity GenerateIdentity(
+            std::size_t _id,
+            std::shared_ptr<void> &&_ref) const;
+
         protected: Identity GenerateInvalidId() const;
 
         /// \brief An implementation class can use this function to get the
@@ -108,8 +117,14 @@ namespace gz
           std::size_t _id,
           const std::shared_ptr<void> &_ref);
 
+      /// \brief This is called by Feature::Implementation
+      private: Identity(
+          std::size_t _id,
+          std::shared_ptr<void> &&_ref);
+
       // These friends are the only classes allowed to create an identity
       template <typename, typename> friend class ::gz::physics::Entity;
+      template <typename> friend class ::gz::physics::EntityRef;
       friend class ::gz::physics::detail::Implementation;
     };
   }
@@ -22,6 +22,7 @@
 #include "gz/physics/detail/FrameSemantics.hh"
 
 #include <string>
+#include <vector>
 
 namespace gz
 {
@@ -232,6 +233,16 @@ namespace gz
           _leaderAxisDof, _multiplier, _offset, _reference);
     }
 
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    std::size_t SetMimicConstraintsFeature::World<PolicyT, FeaturesT>::
+    SetMimicConstraints(const std::vector<MimicConstraint> &_constraints)
+    {
+      return this->template Interface<SetMimicConstraintsFeature>()
+        ->SetWorldMimicConstraints(this->identity, _constraints.data(),
+          _constraints.size());
+    }
+
     /////////////////////////////////////////////////
     template <typename PolicyT, typename FeaturesT>
     void DetachJointFeature::Joint<PolicyT, FeaturesT>::Detach()
@@ -263,6 +274,116 @@ namespace gz
           RelativeWrench(this->GetFrameID(), this->GetTransmittedWrench()),
           _relativeTo, _inCoordinatesOf);
     }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void GetModelJointTransmittedWrenches::Model<PolicyT, FeaturesT>::
+    GetJointTransmittedWrenches(std::vector<Wrench> &_wrenches) const
+    {
+      this->template Interface<GetModelJointTransmittedWrenches>()
+          ->GetModelJointTransmittedWrenches(this->identity, _wrenches);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void GetModelJointState::Model<PolicyT, FeaturesT>::GetJointPositions(
+        VectorX &_positions) const
+    {
+      this->template Interface<GetModelJointState>()
+          ->GetModelJointPositions(this->identity, _positions);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void GetModelJointState::Model<PolicyT, FeaturesT>::GetJointVelocities(
+        VectorX &_velocities) const
+    {
+      this->template Interface<GetModelJointState>()
+          ->GetModelJointVelocities(this->identity, _velocities);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void GetModelJointState::Model<PolicyT, FeaturesT>::GetJointAccelerations(
+        VectorX &_accelerations) const
+    {
+      this->template Interface<GetModelJointState>()
+          ->GetModelJointAccelerations(this->identity, _accelerations);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void GetModelJointState::Model<PolicyT, FeaturesT>::GetJointForces(
+        VectorX &_forces) const
+    {
+      this->template Interface<GetModelJointState>()
+          ->GetModelJointForces(this->identity, _forces);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void SetModelJointState::Model<PolicyT, FeaturesT>::SetJointPositions(
+        const VectorX &_positions)
+    {
+      this->template Interface<SetModelJointState>()
+          ->SetModelJointPositions(this->identity, _positions);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void SetModelJointState::Model<PolicyT, FeaturesT>::SetJointVelocities(
+        const VectorX &_velocities)
+    {
+      this->template Interface<SetModelJointState>()
+          ->SetModelJointVelocities(this->identity, _velocities);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void SetModelJointState::Model<PolicyT, FeaturesT>::SetJointAccelerations(
+        const VectorX &_accelerations)
+    {
+      this->template Interface<SetModelJointState>()
+          ->SetModelJointAccelerations(this->identity, _accelerations);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void SetModelJointState::Model<PolicyT, FeaturesT>::SetJointForces(
+        const VectorX &_forces)
+    {
+      this->template Interface<SetModelJointState>()
+          ->SetModelJointForces(this->identity, _forces);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    bool ModelJointPDControlFeature::Model<PolicyT, FeaturesT>::
+    SetJointPDControl(const JointPDControl &_control)
+    {
+      return this->template Interface<ModelJointPDControlFeature>()
+          ->SetModelJointPDControl(this->identity, _control);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    bool ModelJointPDControlFeature::Model<PolicyT, FeaturesT>::
+    SetJointPDControlTargets(
+        const VectorX &_positions, const VectorX &_velocities)
+    {
+      return this->template Interface<ModelJointPDControlFeature>()
+          ->SetModelJointPDControlTargets(
+              this->identity, _positions, _velocities);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void ModelJointPDControlFeature::Model<PolicyT, FeaturesT>::
+    RemoveJointPDControl()
+    {
+      this->template Interface<ModelJointPDControlFeature>()
+          ->RemoveModelJointPDControl(this->identity);
+    }
   }
 }
 
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_KINEMATICMODEL_HH_
+#define GZ_PHYSICS_DETAIL_KINEMATICMODEL_HH_
+
+#include <gz/physics/KinematicModel.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void KinematicModelFeature::Model<PolicyT, FeaturesT>::SetKinematic(
+    bool _kinematic)
+{
+  this->template Interface<KinematicModelFeature>()
+      ->SetModelKinematic(this->identity, _kinematic);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool KinematicModelFeature::Model<PolicyT, FeaturesT>::GetKinematic() const
+{
+  return this->template Interface<KinematicModelFeature>()
+      ->GetModelKinematic(this->identity);
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
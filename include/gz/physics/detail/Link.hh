@@ -96,6 +96,34 @@ void AddLinkExternalForceTorque::Link<PolicyT, FeaturesT>::AddExternalTorque(
       ->AddLinkExternalTorqueInWorld(this->identity, torqueWorld);
 }
 
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void LinkContinuousCollisionFeature::Link<PolicyT, FeaturesT>::
+SetContinuousCollision(Scalar _motionThreshold, Scalar _sweptSphereRadius)
+{
+  this->template Interface<LinkContinuousCollisionFeature>()
+      ->SetLinkContinuousCollision(
+          this->identity, _motionThreshold, _sweptSphereRadius);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto LinkContinuousCollisionFeature::Link<PolicyT, FeaturesT>::
+GetContinuousCollisionMotionThreshold() const -> Scalar
+{
+  return this->template Interface<LinkContinuousCollisionFeature>()
+      ->GetLinkContinuousCollisionMotionThreshold(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto LinkContinuousCollisionFeature::Link<PolicyT, FeaturesT>::
+GetContinuousCollisionSweptSphereRadius() const -> Scalar
+{
+  return this->template Interface<LinkContinuousCollisionFeature>()
+      ->GetLinkContinuousCollisionSweptSphereRadius(this->identity);
+}
+
 }  // namespace physics
 }  // namespace gz
 
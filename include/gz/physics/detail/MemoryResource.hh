@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_MEMORYRESOURCE_HH_
+#define GZ_PHYSICS_DETAIL_MEMORYRESOURCE_HH_
+
+#include <memory>
+#include <utility>
+
+#include <gz/physics/MemoryResource.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename T>
+ResourceAllocator<T>::ResourceAllocator(
+    std::shared_ptr<MemoryResource> _resource)
+  : resource(std::move(_resource))
+{
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+template <typename U>
+ResourceAllocator<T>::ResourceAllocator(const ResourceAllocator<U> &_other)
+  : resource(_other.GetResource())
+{
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+T *ResourceAllocator<T>::allocate(std::size_t _count)
+{
+  if (!this->resource)
+    return std::allocator<T>().allocate(_count);
+  return static_cast<T *>(
+      this->resource->Allocate(_count * sizeof(T), alignof(T)));
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+void ResourceAllocator<T>::deallocate(T *_ptr, std::size_t _count)
+{
+  if (!this->resource)
+  {
+    std::allocator<T>().deallocate(_ptr, _count);
+    return;
+  }
+  this->resource->Deallocate(_ptr, _count * sizeof(T), alignof(T));
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+const std::shared_ptr<MemoryResource> &
+ResourceAllocator<T>::GetResource() const
+{
+  return this->resource;
+}
+
+/////////////////////////////////////////////////
+template <typename T, typename U>
+bool operator==(const ResourceAllocator<T> &_a,
+                const ResourceAllocator<U> &_b)
+{
+  return _a.GetResource() == _b.GetResource();
+}
+
+/////////////////////////////////////////////////
+template <typename T, typename U>
+bool operator!=(const ResourceAllocator<T> &_a,
+                const ResourceAllocator<U> &_b)
+{
+  return !(_a == _b);
+}
+
+/////////////////////////////////////////////////
+template <typename T, typename... Args>
+std::shared_ptr<T> MakeShared(
+    const std::shared_ptr<MemoryResource> &_resource, Args &&..._args)
+{
+  if (!_resource)
+    return std::make_shared<T>(std::forward<Args>(_args)...);
+  return std::allocate_shared<T>(
+      ResourceAllocator<T>(_resource), std::forward<Args>(_args)...);
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_MEMORYRESOURCEFEATURE_HH_
+#define GZ_PHYSICS_DETAIL_MEMORYRESOURCEFEATURE_HH_
+
+#include <memory>
+#include <utility>
+
+#include <gz/physics/MemoryResourceFeature.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void MemoryResourceFeature::Engine<PolicyT, FeaturesT>::SetMemoryResource(
+    std::shared_ptr<MemoryResource> _resource)
+{
+  this->template Interface<MemoryResourceFeature>()
+      ->SetEngineMemoryResource(this->identity, std::move(_resource));
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+std::shared_ptr<MemoryResource>
+MemoryResourceFeature::Engine<PolicyT, FeaturesT>::GetMemoryResource() const
+{
+  return this->template Interface<MemoryResourceFeature>()
+      ->GetEngineMemoryResource(this->identity);
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_MODELDYNAMICS_HH_
+#define GZ_PHYSICS_DETAIL_MODELDYNAMICS_HH_
+
+#include <gz/physics/ModelDynamics.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void ModelDynamicsFeature::Model<PolicyT, FeaturesT>::GetDynamics(
+        ModelDynamics &_dynamics) const
+    {
+      this->template Interface<ModelDynamicsFeature>()
+          ->GetModelDynamics(this->identity, _dynamics);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto ModelDynamicsFeature::Model<PolicyT, FeaturesT>::GetDynamics() const
+        -> ModelDynamics
+    {
+      ModelDynamics dynamics;
+      this->GetDynamics(dynamics);
+      return dynamics;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    auto ModelDynamicsFeature::Model<PolicyT, FeaturesT>::
+    ComputeInverseDynamics(const GeneralizedVector &_accelerations) const
+        -> GeneralizedVector
+    {
+      return this->template Interface<ModelDynamicsFeature>()
+          ->ComputeModelInverseDynamics(this->identity, _accelerations);
+    }
+
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    void ModelStepDerivativesFeature::Model<PolicyT, FeaturesT>::
+    GetStepDerivatives(StepDerivatives &_derivatives) const
+    {
+      this->template Interface<ModelStepDerivativesFeature>()
+          ->GetModelStepDerivatives(this->identity, _derivatives);
+    }
+  }
+}
+
+#endif
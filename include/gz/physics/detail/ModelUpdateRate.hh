@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_MODELUPDATERATE_HH_
+#define GZ_PHYSICS_DETAIL_MODELUPDATERATE_HH_
+
+#include <gz/physics/ModelUpdateRate.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void ModelUpdateRateFeature::Model<PolicyT, FeaturesT>::SetUpdateRate(
+    double _rate)
+{
+  this->template Interface<ModelUpdateRateFeature>()
+      ->SetModelUpdateRate(this->identity, _rate);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+double ModelUpdateRateFeature::Model<PolicyT, FeaturesT>::GetUpdateRate() const
+{
+  return this->template Interface<ModelUpdateRateFeature>()
+      ->GetModelUpdateRate(this->identity);
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
@@ -18,12 +18,64 @@
 #ifndef GZ_PHYSICS_DETAIL_OPERATEONSPECIFIEDDATA_HH_
 #define GZ_PHYSICS_DETAIL_OPERATEONSPECIFIEDDATA_HH_
 
+#include <array>
+#include <type_traits>
+
 #include "gz/physics/OperateOnSpecifiedData.hh"
 
 namespace gz
 {
   namespace physics
   {
+    namespace detail
+    {
+      /////////////////////////////////////////////////
+      /// \brief A list of the distinct data types of a specification.
+      template <typename... Data>
+      struct SpecifiedDataList { };
+
+      /////////////////////////////////////////////////
+      /// \brief Append Data to a SpecifiedDataList, unless it is void or
+      /// already in the list.
+      template <typename List, typename Data>
+      struct AppendSpecifiedData;
+
+      template <typename... Listed, typename Data>
+      struct AppendSpecifiedData<SpecifiedDataList<Listed...>, Data>
+      {
+        using List = typename std::conditional<
+            std::is_void<Data>::value
+              || (std::is_same<Listed, Data>::value || ...),
+            SpecifiedDataList<Listed...>,
+            SpecifiedDataList<Listed..., Data>>::type;
+      };
+
+      /////////////////////////////////////////////////
+      /// \brief Append the data types found by SpecFinder in Specification
+      /// and its sub-specifications to Collected, depth first.
+      template <typename Collected, typename Specification,
+                template <typename> class SpecFinder>
+      struct CollectSpecifiedData
+      {
+        using WithData = typename AppendSpecifiedData<
+            Collected, typename SpecFinder<Specification>::Data>::List;
+
+        using WithSub1 = typename CollectSpecifiedData<
+            WithData, typename Specification::SubSpecification1,
+            SpecFinder>::List;
+
+        using List = typename CollectSpecifiedData<
+            WithSub1, typename Specification::SubSpecification2,
+            SpecFinder>::List;
+      };
+
+      template <typename Collected, template <typename> class SpecFinder>
+      struct CollectSpecifiedData<Collected, void, SpecFinder>
+      {
+        using List = Collected;
+      };
+    }
+
     /////////////////////////////////////////////////
     #define GZ_PHYSICS_OPERATEONSPECIFIEDDATA_TEMPLATES \
     template <typename Specification, \
@@ -36,93 +88,47 @@ namespace gz
 
     /////////////////////////////////////////////////
     GZ_PHYSICS_OPERATEONSPECIFIEDDATA_TEMPLATES
-    template <typename CompositeType>
-    GZ_PHYSICS_OPERATEONSPECIFIEDDATA_PREFIX::Operate(
+    template <typename Data, typename CompositeType>
+    GZ_PHYSICS_OPERATEONSPECIFIEDDATA_PREFIX::OperateIfSatisfied(
         Performer *_performer, CompositeType &_data,
-        const DataStatusMask &_mask, const bool _onlyCompile)
+        const DataStatusMask &_mask)
     {
-      if (_onlyCompile)
-        return;
-
-      History history;
-      history.reserve(CountUpperLimitOfSpecifiedData<
-                      Specification, SpecFinder>());
-
-      SubOperate(detail::type<typename SpecFinder<Specification>::Data>(),
-          detail::type<Specification>(), _performer, _data, _mask, history);
+      if (_mask.Satisfied(_data.template StatusOf<Data>()))
+        Operation<Data, Performer, CompositeType>::Operate(_performer, _data);
     }
 
     /////////////////////////////////////////////////
     GZ_PHYSICS_OPERATEONSPECIFIEDDATA_TEMPLATES
-    template <typename Data, typename SubSpecification, typename CompositeType>
-    GZ_PHYSICS_OPERATEONSPECIFIEDDATA_PREFIX::SubOperate(
-        detail::type<Data>, detail::type<SubSpecification>,
-        Performer *_performer, CompositeType &_data,
-        const DataStatusMask &_mask,
-        History &_history)
+    template <typename CompositeType, typename... Data>
+    constexpr auto
+    OperateOnSpecifiedData<Specification, SpecFinder, Operation, Performer>::
+    Operations(detail::SpecifiedDataList<Data...>)
     {
-      // This gets called when SubSpecification is able to provide one of the
-      // desired data type specifications.
+      using OperationFnc =
+          void(*)(Performer*, CompositeType&, const DataStatusMask&);
 
-      if (_mask.Satisfied(_data.template StatusOf<Data>()))
-      {
-        const bool inserted = _history.insert(typeid(Data).name()).second;
-
-        if (inserted)
-        {
-          // We have found a specified type that matches what we want, so we
-          // will call operate on it.
-          Operation<Data, Performer, CompositeType>::Operate(_performer, _data);
-        }
-      }
-
-      // Here we call the version of this function that performs branching,
-      // just in case this SubSpecification also contains SubSpecifications
-      // of its own.
-      //
-      // It's worth noting that in our current implementation, this will not
-      // do anything, because every node in a specification will only (a)
-      // specify a data type, or (b) provide two sub-specifications, but it
-      // will never do both (a) and (b). Calling this function here is a
-      // good idea just in case (1) we decide to change the way we structure
-      // the specification classes, or (2) a user/developer wants to
-      // leverage this class for their own custom specification framework
-      // which does not make all the same assumptions as ours. It also
-      // doesn't affect performance, because it will simply compile to a
-      // no-op.
-      SubOperate(detail::type<void>(), detail::type<SubSpecification>(),
-                 _performer, _data, _mask, _history);
+      return std::array<OperationFnc, sizeof...(Data)>{
+        {&OperateIfSatisfied<Data, CompositeType>...}};
     }
 
     /////////////////////////////////////////////////
     GZ_PHYSICS_OPERATEONSPECIFIEDDATA_TEMPLATES
-    template <typename SubSpecification, typename CompositeType>
-    GZ_PHYSICS_OPERATEONSPECIFIEDDATA_PREFIX::SubOperate(
-        detail::type<void>, detail::type<SubSpecification>,
+    template <typename CompositeType>
+    GZ_PHYSICS_OPERATEONSPECIFIEDDATA_PREFIX::Operate(
         Performer *_performer, CompositeType &_data,
-        const DataStatusMask &_mask, History &_history)
+        const DataStatusMask &_mask, const bool _onlyCompile)
     {
-      // SubSpecification did not specify a type that matches what we want,
-      // so we will search it to see if it has its own sub-specifications.
+      // The table is instantiated even if we only compile, so that each
+      // Operation is checked.
+      static constexpr auto operations = Operations<CompositeType>(
+          typename detail::CollectSpecifiedData<
+            detail::SpecifiedDataList<>, Specification, SpecFinder>::List());
 
-      using Sub1 =  typename SubSpecification::SubSpecification1;
-      SubOperate(detail::type<typename SpecFinder<Sub1>::Data>(),
-                 detail::type<Sub1>(), _performer, _data, _mask, _history);
-
-      using Sub2 = typename SubSpecification::SubSpecification2;
-      SubOperate(detail::type<typename SpecFinder<Sub2>::Data>(),
-                 detail::type<Sub2>(), _performer, _data, _mask, _history);
-    }
+      if (_onlyCompile)
+        return;
 
-    /////////////////////////////////////////////////
-    GZ_PHYSICS_OPERATEONSPECIFIEDDATA_TEMPLATES
-    template <typename CompositeType>
-    GZ_PHYSICS_OPERATEONSPECIFIEDDATA_PREFIX::SubOperate(
-        detail::type<void>, detail::type<void>, Performer*,
-        CompositeType&, const DataStatusMask&, History&)
-    {
-      // We reached a leaf in the specification, so we are done with this
-      // branch. Do nothing.
+      for (const auto operation : operations)
+        operation(_performer, _data, _mask);
     }
   }
 }
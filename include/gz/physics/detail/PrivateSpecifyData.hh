@@ -78,8 +78,11 @@ namespace gz
                 std::unique_ptr<Cloneable>(new MakeCloneable<Expected>());
           }
 
+          LendData(this->expectedIterator->second);
+
           SetToQueried(this->expectedIterator,
-                       _data->CompositeData::numQueries);
+                       _data->CompositeData::numQueries,
+                       _data->CompositeData::queryTracking);
 
           return static_cast<MakeCloneable<Expected>&>(
                 *this->expectedIterator->second.data);
@@ -111,9 +114,11 @@ namespace gz
           this->expectedIterator->second.data =
               std::unique_ptr<Cloneable>(new MakeCloneable<Expected>(
                                            std::forward<Args>(args)...));
+          LendData(this->expectedIterator->second);
 
           SetToQueried(this->expectedIterator,
-                       _data->CompositeData::numQueries);
+                       _data->CompositeData::numQueries,
+                       _data->CompositeData::queryTracking);
 
           return CompositeData::InsertResult<Expected>{
                 static_cast<MakeCloneable<Expected>&>(
@@ -149,8 +154,11 @@ namespace gz
             inserted = true;
           }
 
+          LendData(this->expectedIterator->second);
+
           SetToQueried(this->expectedIterator,
-                       _data->CompositeData::numQueries);
+                       _data->CompositeData::numQueries,
+                       _data->CompositeData::queryTracking);
 
           return CompositeData::InsertResult<Expected>{
                 static_cast<MakeCloneable<Expected>&>(
@@ -208,10 +216,13 @@ namespace gz
           if (!this->expectedIterator->second.data)
             return nullptr;
 
+          LendData(this->expectedIterator->second);
+
           if (CompositeData::QueryMode::NORMAL == _mode)
           {
             SetToQueried(this->expectedIterator,
-                               _data->CompositeData::numQueries);
+                               _data->CompositeData::numQueries,
+                               _data->CompositeData::queryTracking);
           }
 
           return static_cast<MakeCloneable<Expected>*>(
@@ -241,7 +252,8 @@ namespace gz
           if (CompositeData::QueryMode::NORMAL == _mode)
           {
             SetToQueried(this->expectedIterator,
-                               _data->CompositeData::numQueries);
+                               _data->CompositeData::numQueries,
+                               _data->CompositeData::queryTracking);
           }
 
           return static_cast<const MakeCloneable<Expected>*>(
@@ -339,8 +351,11 @@ namespace gz
                   new MakeCloneable<Expected>(std::forward<Args>(_args)...));
           }
 
+          LendData(this->expectedIterator->second);
+
           SetToQueried(this->expectedIterator,
-              _data->CompositeData::numQueries);
+              _data->CompositeData::numQueries,
+              _data->CompositeData::queryTracking);
 
           return static_cast<MakeCloneable<Expected>&>(
                 *this->expectedIterator->second.data);
@@ -419,7 +434,8 @@ namespace gz
           static_assert(std::is_same<Data, Required>::type,
                         GZ_PHYSICS_CONST_GET_ERROR);
 
-          SetToQueried(_it, _data->CompositeData::numQueries);
+          SetToQueried(_it, _data->CompositeData::numQueries,
+                       _data->CompositeData::queryTracking);
 
           return static_cast<const MakeCloneable<Required>&>(*_it->second.data);
         }
@@ -434,7 +450,8 @@ namespace gz
           usedExpectedDataAccess = true;
           #endif
 
-          SetToQueried(_it, _data->CompositeData::numQueries);
+          SetToQueried(_it, _data->CompositeData::numQueries,
+                       _data->CompositeData::queryTracking);
 
           return static_cast<const MakeCloneable<Required>&>(*_it->second.data);
         }
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GZ_PHYSICS_DETAIL_RAYINTERSECTION_HH_
+#define GZ_PHYSICS_DETAIL_RAYINTERSECTION_HH_
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <vector>
+#include <gz/physics/RayIntersection.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto RayIntersectionFeature::World<PolicyT, FeaturesT>::CastRays(
+    const VectorType *_from, const VectorType *_to, std::size_t _count,
+    std::size_t _numThreads) const -> RayIntersectionBatch
+{
+  return this->template Interface<RayIntersectionFeature>()
+      ->CastWorldRays(this->identity, _from, _to, _count, _numThreads);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto RayIntersectionFeature::World<PolicyT, FeaturesT>::CastRays(
+    const std::vector<VectorType> &_from,
+    const std::vector<VectorType> &_to,
+    std::size_t _numThreads) const -> RayIntersectionBatch
+{
+  return this->CastRays(_from.data(), _to.data(),
+      std::min(_from.size(), _to.size()), _numThreads);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void RayIntersectionFeature::Implementation<
+    PolicyT>::RayIntersectionStorage::Reset(std::size_t _count)
+{
+  this->distance.assign(_count, std::numeric_limits<Scalar>::infinity());
+  this->normal.assign(_count,
+      VectorType::Constant(std::numeric_limits<Scalar>::quiet_NaN()));
+  this->shape.assign(_count, INVALID_ENTITY_ID);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void RayIntersectionFeature::Implementation<
+    PolicyT>::RayIntersectionStorage::Set(
+        std::size_t _index, Scalar _distance,
+        const VectorType &_normal, std::size_t _shape)
+{
+  this->distance[_index] = _distance;
+  this->normal[_index] = _normal;
+  this->shape[_index] = _shape;
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+auto RayIntersectionFeature::Implementation<
+    PolicyT>::RayIntersectionStorage::View() const -> RayIntersectionBatch
+{
+  RayIntersectionBatch batch;
+  batch.size = this->shape.size();
+  batch.distance = this->distance.data();
+  batch.normal = this->normal.data();
+  batch.shape = this->shape.data();
+  return batch;
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+template <typename CastT>
+std::vector<std::function<void()>> RayIntersectionFeature::Implementation<
+    PolicyT>::RayChunkTasks(
+        std::size_t _count, std::size_t _chunks, const CastT &_cast)
+{
+  std::vector<std::function<void()>> tasks;
+  if (_count == 0u)
+    return tasks;
+
+  _chunks = std::max<std::size_t>(1u, std::min(_chunks, _count));
+  const std::size_t chunkSize = (_count + _chunks - 1u) / _chunks;
+  tasks.reserve(_chunks);
+  for (std::size_t begin = 0u; begin < _count; begin += chunkSize)
+  {
+    const std::size_t end = std::min(begin + chunkSize, _count);
+    tasks.push_back([&_cast, begin, end]() { _cast(begin, end); });
+  }
+  return tasks;
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
@@ -19,9 +19,11 @@
 #define GZ_PHYSICS_DETAIL_REGISTER_HH_
 
 #include <tuple>
+#include <typeinfo>
 
 #include <gz/plugin/Register.hh>
 #include <gz/physics/Feature.hh>
+#include <gz/physics/detail/FeatureManifest.hh>
 
 namespace gz
 {
@@ -54,6 +56,18 @@ namespace gz
                 PluginT, Feature::Implementation<FeaturePolicyT>,
                 typename Features::template Implementation<FeaturePolicyT>...>::
               Register();
+
+          // A constant table of the interfaces keeps the manifest of each
+          // plugin from instantiating its own FeatureSetOf. The trailing
+          // nullptr keeps the array valid for an empty feature list.
+          static const std::type_info *const interfaces[] = {
+            &typeid(typename Features::template Implementation<
+                FeaturePolicyT>)...,
+            nullptr
+          };
+
+          FeatureManifests::Register(
+                typeid(PluginT), interfaces, sizeof...(Features));
         }
       };
     }
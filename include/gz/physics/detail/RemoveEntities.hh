@@ -18,7 +18,9 @@
 #ifndef GZ_PHYSICS_DETAIL_REMOVEENTITIES_HH_
 #define GZ_PHYSICS_DETAIL_REMOVEENTITIES_HH_
 
+#include <cstddef>
 #include <string>
+#include <vector>
 #include <gz/physics/RemoveEntities.hh>
 
 namespace gz
@@ -60,6 +62,15 @@ namespace gz
               ->ModelRemoved(this->identity);
     }
 
+    /////////////////////////////////////////////////
+    template <typename PolicyT, typename FeaturesT>
+    std::size_t RemoveModelsFromWorld::World<PolicyT, FeaturesT>::RemoveModels(
+        const std::vector<std::string> &_names)
+    {
+      return this->template Interface<RemoveModelsFromWorld>()
+          ->RemoveModelsByName(this->identity, _names);
+    }
+
     /////////////////////////////////////////////////
     template <typename PolicyT, typename FeaturesT>
     bool
@@ -23,6 +23,7 @@
 #include <string>
 
 #include <gz/physics/RequestEngine.hh>
+#include <gz/physics/detail/FeatureManifest.hh>
 #include <gz/physics/detail/InspectFeatures.hh>
 
 namespace gz
@@ -35,7 +36,7 @@ namespace gz
     bool RequestEngine<FeaturePolicyT, FeatureListT>::
     Verify(const PtrT &_pimpl)
     {
-      return detail::InspectFeatures<FeaturePolicyT, Features>::Verify(_pimpl);
+      return detail::ProvidesFeatures<FeaturePolicyT, Features>(_pimpl);
     }
 
     /////////////////////////////////////////////////
@@ -59,7 +60,7 @@ namespace gz
     {
       using Pimpl = typename Engine<FeaturePolicyT, FeatureListT>::Pimpl;
 
-      if (!detail::InspectFeatures<FeaturePolicyT, Features>::Verify(_pimpl))
+      if (!detail::ProvidesFeatures<FeaturePolicyT, Features>(_pimpl))
         return nullptr;
 
       std::shared_ptr<Pimpl> pimpl = std::make_shared<Pimpl>(_pimpl);
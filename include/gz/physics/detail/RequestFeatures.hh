@@ -24,6 +24,7 @@
 #include <utility>
 
 #include <gz/physics/RequestFeatures.hh>
+#include <gz/physics/detail/FeatureManifest.hh>
 #include <gz/physics/detail/InspectFeatures.hh>
 
 namespace gz
@@ -54,10 +55,7 @@ namespace gz
         return nullptr;
 
       ToPluginType toPlugin(*_from.entity->pimpl);
-      if (!detail::InspectFeatures<
-              PolicyT,
-              FeatureListT
-          >::Verify(toPlugin))
+      if (!detail::ProvidesFeatures<PolicyT, FeatureListT>(toPlugin))
       {
         // The physics plugin does not implement all of the features that were
         // requested, so we will return a nullptr.
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GZ_PHYSICS_DETAIL_SHAPEQUERIES_HH_
+#define GZ_PHYSICS_DETAIL_SHAPEQUERIES_HH_
+
+#include <algorithm>
+#include <vector>
+#include <gz/physics/ShapeQueries.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT>
+auto ShapeQueryFeature::QueryVolumeT<PolicyT>::Sphere(
+    const VectorType &_center, Scalar _radius) -> QueryVolumeT
+{
+  QueryVolumeT volume;
+  volume.type = Type::SPHERE;
+  volume.pose.translation() = _center;
+  volume.radius = _radius;
+  return volume;
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+auto ShapeQueryFeature::QueryVolumeT<PolicyT>::Box(
+    const PoseType &_pose, const VectorType &_size) -> QueryVolumeT
+{
+  QueryVolumeT volume;
+  volume.type = Type::BOX;
+  volume.pose = _pose;
+  volume.size = _size;
+  return volume;
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ShapeQueryFeature::World<PolicyT, FeaturesT>::CastShapes(
+    const QueryVolume *_volumes, const VectorType *_to,
+    std::size_t _count, std::size_t _numThreads) const -> ShapeCastBatch
+{
+  return this->template Interface<ShapeQueryFeature>()
+      ->CastWorldShapes(this->identity, _volumes, _to, _count, _numThreads);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ShapeQueryFeature::World<PolicyT, FeaturesT>::CastShapes(
+    const std::vector<QueryVolume> &_volumes,
+    const std::vector<VectorType> &_to,
+    std::size_t _numThreads) const -> ShapeCastBatch
+{
+  return this->CastShapes(_volumes.data(), _to.data(),
+      std::min(_volumes.size(), _to.size()), _numThreads);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ShapeQueryFeature::World<PolicyT, FeaturesT>::FindOverlaps(
+    const QueryVolume *_volumes, std::size_t _count,
+    std::size_t _numThreads) const -> OverlapBatch
+{
+  return this->template Interface<ShapeQueryFeature>()
+      ->FindWorldOverlaps(this->identity, _volumes, _count, _numThreads);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ShapeQueryFeature::World<PolicyT, FeaturesT>::FindOverlaps(
+    const std::vector<QueryVolume> &_volumes,
+    std::size_t _numThreads) const -> OverlapBatch
+{
+  return this->FindOverlaps(_volumes.data(), _volumes.size(), _numThreads);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void ShapeQueryFeature::Implementation<PolicyT>::OverlapStorage::Assign(
+    std::vector<std::vector<std::size_t>> &_overlaps)
+{
+  this->offset.clear();
+  this->shape.clear();
+  this->offset.reserve(_overlaps.size() + 1u);
+  this->offset.push_back(0u);
+  for (auto &shapes : _overlaps)
+  {
+    std::sort(shapes.begin(), shapes.end());
+    this->shape.insert(this->shape.end(), shapes.begin(), shapes.end());
+    this->offset.push_back(this->shape.size());
+  }
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+auto ShapeQueryFeature::Implementation<PolicyT>::OverlapStorage::View() const
+    -> OverlapBatch
+{
+  OverlapBatch batch;
+  batch.size = this->offset.empty() ? 0u : this->offset.size() - 1u;
+  batch.offset = this->offset.data();
+  batch.shape = this->shape.data();
+  return batch;
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ShapeDistanceFeature::World<PolicyT, FeaturesT>::ComputeShapeDistances(
+    const std::vector<ShapePair> &_pairs, Scalar _cutoff) const
+    -> std::vector<ShapeDistance>
+{
+  std::vector<ShapeDistance> results(_pairs.size());
+  if (!_pairs.empty())
+  {
+    this->template Interface<ShapeDistanceFeature>()
+        ->ComputeWorldShapeDistances(this->identity, _pairs.data(),
+            _pairs.size(), _cutoff, results.data());
+  }
+  return results;
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ShapeDistanceFeature::World<PolicyT, FeaturesT>::ComputeLinkDistances(
+    const std::vector<std::size_t> &_links, Scalar _cutoff) const
+    -> std::vector<ShapeDistance>
+{
+  return this->template Interface<ShapeDistanceFeature>()
+      ->ComputeWorldLinkDistances(this->identity, _links, _cutoff);
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
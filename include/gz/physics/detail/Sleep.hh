@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_SLEEP_HH_
+#define GZ_PHYSICS_DETAIL_SLEEP_HH_
+
+#include <gz/physics/Sleep.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SleepFeature::Model<PolicyT, FeaturesT>::SetSleepEnabled(bool _enabled)
+{
+  this->template Interface<SleepFeature>()
+      ->SetModelSleepEnabled(this->identity, _enabled);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool SleepFeature::Model<PolicyT, FeaturesT>::GetSleepEnabled() const
+{
+  return this->template Interface<SleepFeature>()
+      ->GetModelSleepEnabled(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SleepFeature::Model<PolicyT, FeaturesT>::SetSleeping(bool _sleeping)
+{
+  this->template Interface<SleepFeature>()
+      ->SetModelSleeping(this->identity, _sleeping);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool SleepFeature::Model<PolicyT, FeaturesT>::GetSleeping() const
+{
+  return this->template Interface<SleepFeature>()
+      ->GetModelSleeping(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SleepThresholdsFeature::Model<PolicyT, FeaturesT>::SetSleepThresholds(
+    const SleepThresholds &_thresholds)
+{
+  this->template Interface<SleepThresholdsFeature>()
+      ->SetModelSleepThresholds(this->identity, _thresholds);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto SleepThresholdsFeature::Model<PolicyT, FeaturesT>::GetSleepThresholds()
+    const -> SleepThresholds
+{
+  return this->template Interface<SleepThresholdsFeature>()
+      ->GetModelSleepThresholds(this->identity);
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
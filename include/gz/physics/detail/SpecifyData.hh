@@ -34,7 +34,7 @@ namespace gz
       : CompositeData(),
         privateExpectData(
           this->dataMap.insert(
-            std::make_pair(typeid(Expected).name(),
+            std::make_pair(detail::DataTypeKey<Expected>(),
                            CompositeData::DataEntry())).first)
     {
       // Do nothing
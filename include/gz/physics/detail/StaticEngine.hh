@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_STATICENGINE_HH_
+#define GZ_PHYSICS_DETAIL_STATICENGINE_HH_
+
+#include <tuple>
+#include <type_traits>
+
+#include <gz/physics/StaticEngine.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    namespace detail
+    {
+      /////////////////////////////////////////////////
+      /// \private This class provides a static constexpr member named `value`
+      /// which is true if ImplementationT derives from the implementation
+      /// interface of every feature in FeatureTuple.
+      template <typename Policy, typename ImplementationT,
+                typename FeatureTuple>
+      struct ImplementsAllFeatures;
+
+      template <typename Policy, typename ImplementationT,
+                typename... Features>
+      struct ImplementsAllFeatures<
+          Policy, ImplementationT, std::tuple<Features...>>
+        : std::conjunction<std::is_base_of<
+              typename Features::template Implementation<Policy>,
+              ImplementationT>...> { };
+    }
+
+    /////////////////////////////////////////////////
+    template <typename FeaturePolicyT, typename ImplementationT,
+              typename FeatureListT>
+    StaticEngine<FeaturePolicyT, ImplementationT, FeatureListT>::StaticEngine(
+        const std::size_t _engineID)
+      : engine(this->implementation.InitiateEngine(_engineID))
+    {
+      static_assert(detail::ImplementsAllFeatures<FeaturePolicyT,
+          ImplementationT, typename FeatureListT::Features>::value,
+          "THE IMPLEMENTATION DOES NOT PROVIDE ALL THE FEATURES OF THE LIST");
+    }
+
+    /////////////////////////////////////////////////
+    template <typename FeaturePolicyT, typename ImplementationT,
+              typename FeatureListT>
+    const Identity &
+    StaticEngine<FeaturePolicyT, ImplementationT, FeatureListT>::
+    EngineIdentity() const
+    {
+      return this->engine;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename FeaturePolicyT, typename ImplementationT,
+              typename FeatureListT>
+    template <typename FeatureT>
+    auto StaticEngine<FeaturePolicyT, ImplementationT, FeatureListT>::
+    Interface() -> InterfaceType<FeatureT> &
+    {
+      static_assert(FeatureListT::template HasFeature<FeatureT>(),
+          "THE FEATURE IS NOT IN THE FEATURE LIST OF THIS ENGINE");
+      return this->implementation;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename FeaturePolicyT, typename ImplementationT,
+              typename FeatureListT>
+    template <typename FeatureT>
+    auto StaticEngine<FeaturePolicyT, ImplementationT, FeatureListT>::
+    Interface() const -> const InterfaceType<FeatureT> &
+    {
+      static_assert(FeatureListT::template HasFeature<FeatureT>(),
+          "THE FEATURE IS NOT IN THE FEATURE LIST OF THIS ENGINE");
+      return this->implementation;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename FeaturePolicyT, typename ImplementationT,
+              typename FeatureListT>
+    ImplementationT &
+    StaticEngine<FeaturePolicyT, ImplementationT, FeatureListT>::Get()
+    {
+      return this->implementation;
+    }
+
+    /////////////////////////////////////////////////
+    template <typename FeaturePolicyT, typename ImplementationT,
+              typename FeatureListT>
+    const ImplementationT &
+    StaticEngine<FeaturePolicyT, ImplementationT, FeatureListT>::Get() const
+    {
+      return this->implementation;
+    }
+  }
+}
+
+#endif
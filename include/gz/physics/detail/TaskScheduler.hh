@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_TASKSCHEDULER_HH_
+#define GZ_PHYSICS_DETAIL_TASKSCHEDULER_HH_
+
+#include <memory>
+#include <utility>
+
+#include <gz/physics/TaskScheduler.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void TaskSchedulerFeature::Engine<PolicyT, FeaturesT>::SetTaskScheduler(
+    std::shared_ptr<TaskScheduler> _scheduler)
+{
+  this->template Interface<TaskSchedulerFeature>()
+      ->SetEngineTaskScheduler(this->identity, std::move(_scheduler));
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+std::shared_ptr<TaskScheduler>
+TaskSchedulerFeature::Engine<PolicyT, FeaturesT>::GetTaskScheduler() const
+{
+  return this->template Interface<TaskSchedulerFeature>()
+      ->GetEngineTaskScheduler(this->identity);
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
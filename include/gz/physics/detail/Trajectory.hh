@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_TRAJECTORY_HH_
+#define GZ_PHYSICS_DETAIL_TRAJECTORY_HH_
+
+#include <vector>
+#include <gz/physics/Trajectory.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool ModelTrajectoryFeature::Model<PolicyT, FeaturesT>::SetTrajectory(
+    const std::vector<Waypoint> &_waypoints, Interpolation _interpolation)
+{
+  return this->template Interface<ModelTrajectoryFeature>()
+      ->SetModelTrajectory(this->identity, _waypoints, _interpolation);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void ModelTrajectoryFeature::Model<PolicyT, FeaturesT>::ClearTrajectory()
+{
+  this->template Interface<ModelTrajectoryFeature>()
+      ->ClearModelTrajectory(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool ModelTrajectoryFeature::Model<PolicyT, FeaturesT>::HasTrajectory() const
+{
+  return this->template Interface<ModelTrajectoryFeature>()
+      ->GetModelHasTrajectory(this->identity);
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
@@ -44,6 +44,24 @@ const std::string &CollisionDetector::World<PolicyT, FeaturesT>::
       ->GetWorldCollisionDetector(this->identity);
 }
 
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void Broadphase::World<PolicyT, FeaturesT>::SetBroadphase(
+    const std::string &_broadphase)
+{
+  this->template Interface<Broadphase>()
+      ->SetWorldBroadphase(this->identity, _broadphase);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+const std::string &Broadphase::World<PolicyT, FeaturesT>::
+    GetBroadphase() const
+{
+  return this->template Interface<Broadphase>()
+      ->GetWorldBroadphase(this->identity);
+}
+
 /////////////////////////////////////////////////
 template <typename PolicyT, typename FeaturesT>
 void Gravity::World<PolicyT, FeaturesT>::SetGravity(
@@ -117,6 +135,41 @@ std::size_t CollisionPairMaxContacts::World<PolicyT, FeaturesT>::
       ->GetWorldCollisionPairMaxContacts(this->identity);
 }
 
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void CollisionPairContactSelection::World<PolicyT, FeaturesT>::
+    SetCollisionPairContactSelection(const std::string &_selection)
+{
+  this->template Interface<CollisionPairContactSelection>()
+      ->SetWorldCollisionPairContactSelection(this->identity, _selection);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+const std::string &CollisionPairContactSelection::World<PolicyT, FeaturesT>::
+    GetCollisionPairContactSelection() const
+{
+  return this->template Interface<CollisionPairContactSelection>()
+      ->GetWorldCollisionPairContactSelection(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void NumThreads::World<PolicyT, FeaturesT>::SetNumThreads(
+    std::size_t _numThreads)
+{
+  this->template Interface<NumThreads>()
+      ->SetWorldNumThreads(this->identity, _numThreads);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+std::size_t NumThreads::World<PolicyT, FeaturesT>::GetNumThreads() const
+{
+  return this->template Interface<NumThreads>()
+      ->GetWorldNumThreads(this->identity);
+}
+
 /////////////////////////////////////////////////
 template <typename PolicyT, typename FeaturesT>
 void Solver::World<PolicyT, FeaturesT>::SetSolver(
@@ -135,6 +188,238 @@ const std::string &Solver::World<PolicyT, FeaturesT>::
       ->GetWorldSolver(this->identity);
 }
 
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SolverProfile::World<PolicyT, FeaturesT>::SetSolverIterations(
+    std::size_t _iterations)
+{
+  this->template Interface<SolverProfile>()
+      ->SetWorldSolverIterations(this->identity, _iterations);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+std::size_t SolverProfile::World<PolicyT, FeaturesT>::
+    GetSolverIterations() const
+{
+  return this->template Interface<SolverProfile>()
+      ->GetWorldSolverIterations(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SolverProfile::World<PolicyT, FeaturesT>::SetSolverWarmStarting(
+    bool _warmStarting)
+{
+  this->template Interface<SolverProfile>()
+      ->SetWorldSolverWarmStarting(this->identity, _warmStarting);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool SolverProfile::World<PolicyT, FeaturesT>::GetSolverWarmStarting() const
+{
+  return this->template Interface<SolverProfile>()
+      ->GetWorldSolverWarmStarting(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SolverProfile::World<PolicyT, FeaturesT>::SetSolverSplitImpulse(
+    bool _splitImpulse)
+{
+  this->template Interface<SolverProfile>()
+      ->SetWorldSolverSplitImpulse(this->identity, _splitImpulse);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool SolverProfile::World<PolicyT, FeaturesT>::GetSolverSplitImpulse() const
+{
+  return this->template Interface<SolverProfile>()
+      ->GetWorldSolverSplitImpulse(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SolverProfile::World<PolicyT, FeaturesT>::SetSolverTolerance(
+    double _tolerance)
+{
+  this->template Interface<SolverProfile>()
+      ->SetWorldSolverTolerance(this->identity, _tolerance);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+double SolverProfile::World<PolicyT, FeaturesT>::GetSolverTolerance() const
+{
+  return this->template Interface<SolverProfile>()
+      ->GetWorldSolverTolerance(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void SubSteps::World<PolicyT, FeaturesT>::SetSubSteps(std::size_t _subSteps)
+{
+  this->template Interface<SubSteps>()
+      ->SetWorldSubSteps(this->identity, _subSteps);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+std::size_t SubSteps::World<PolicyT, FeaturesT>::GetSubSteps() const
+{
+  return this->template Interface<SubSteps>()
+      ->GetWorldSubSteps(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void AdaptiveTimeStepFeature::World<PolicyT, FeaturesT>::SetAdaptiveTimeStep(
+    const Parameters &_parameters)
+{
+  this->template Interface<AdaptiveTimeStepFeature>()
+      ->SetWorldAdaptiveTimeStep(this->identity, _parameters);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto AdaptiveTimeStepFeature::World<PolicyT, FeaturesT>::GetAdaptiveTimeStep()
+    const -> Parameters
+{
+  return this->template Interface<AdaptiveTimeStepFeature>()
+      ->GetWorldAdaptiveTimeStep(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+double AdaptiveTimeStepFeature::World<PolicyT, FeaturesT>::GetLastStepSize()
+    const
+{
+  return this->template Interface<AdaptiveTimeStepFeature>()
+      ->GetWorldLastStepSize(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void PenaltyContactFeature::World<PolicyT, FeaturesT>::SetPenaltyContact(
+    const Parameters &_parameters)
+{
+  this->template Interface<PenaltyContactFeature>()
+      ->SetWorldPenaltyContact(this->identity, _parameters);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto PenaltyContactFeature::World<PolicyT, FeaturesT>::GetPenaltyContact()
+    const -> Parameters
+{
+  return this->template Interface<PenaltyContactFeature>()
+      ->GetWorldPenaltyContact(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto GetStepStatisticsFeature::World<PolicyT, FeaturesT>::GetStepStatistics()
+    const -> StepStatistics
+{
+  return this->template Interface<GetStepStatisticsFeature>()
+      ->GetWorldStepStatistics(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void GetModelStepStatisticsFeature::World<PolicyT, FeaturesT>::
+SetModelStepStatisticsEnabled(bool _enable)
+{
+  this->template Interface<GetModelStepStatisticsFeature>()
+      ->SetWorldModelStepStatisticsEnabled(this->identity, _enable);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto GetModelStepStatisticsFeature::World<PolicyT, FeaturesT>::
+GetModelStepStatistics() const -> std::vector<ModelStepStatistics>
+{
+  return this->template Interface<GetModelStepStatisticsFeature>()
+      ->GetWorldModelStepStatistics(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void GetSolverStatisticsFeature::World<PolicyT, FeaturesT>::
+SetSolverStatisticsEnabled(bool _enable)
+{
+  this->template Interface<GetSolverStatisticsFeature>()
+      ->SetWorldSolverStatisticsEnabled(this->identity, _enable);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto GetSolverStatisticsFeature::World<PolicyT, FeaturesT>::
+GetSolverStatistics() const -> SolverStatistics
+{
+  return this->template Interface<GetSolverStatisticsFeature>()
+      ->GetWorldSolverStatistics(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto GetMemoryUsageFeature::World<PolicyT, FeaturesT>::GetMemoryUsage()
+    const -> MemoryUsage
+{
+  return this->template Interface<GetMemoryUsageFeature>()
+      ->GetWorldMemoryUsage(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void WorldCommandBufferFeature::World<PolicyT, FeaturesT>::ApplyCommands(
+    const Command *_commands, std::size_t _count)
+{
+  if (_count == 0)
+    return;
+
+  this->template Interface<WorldCommandBufferFeature>()
+      ->ApplyWorldCommands(this->identity, _commands, _count);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void WorldCommandBufferFeature::World<PolicyT, FeaturesT>::ApplyCommands(
+    const std::vector<Command> &_commands)
+{
+  this->ApplyCommands(_commands.data(), _commands.size());
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto CloneWorldFeature::World<PolicyT, FeaturesT>::Clone(
+    const std::string &_name) -> WorldPtrType
+{
+  return WorldPtrType(this->pimpl,
+      this->template Interface<CloneWorldFeature>()
+          ->CloneWorld(this->identity, _name));
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto WorldStateSnapshotFeature::World<PolicyT, FeaturesT>::SaveState() const
+    -> Snapshot
+{
+  return this->template Interface<WorldStateSnapshotFeature>()
+      ->GetWorldStateSnapshot(this->identity);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool WorldStateSnapshotFeature::World<PolicyT, FeaturesT>::RestoreState(
+    const Snapshot &_snapshot)
+{
+  return this->template Interface<WorldStateSnapshotFeature>()
+      ->SetWorldStateSnapshot(this->identity, _snapshot);
+}
+
 }  // namespace physics
 }  // namespace gz
 
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_WORLDPLACEMENT_HH_
+#define GZ_PHYSICS_DETAIL_WORLDPLACEMENT_HH_
+
+#include <gz/physics/WorldPlacement.hh>
+
+namespace gz
+{
+namespace physics
+{
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void WorldPlacementFeature::World<PolicyT, FeaturesT>::SetPlacement(
+    const WorldPlacement &_placement)
+{
+  this->template Interface<WorldPlacementFeature>()
+      ->SetWorldPlacement(this->identity, _placement);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+WorldPlacement
+WorldPlacementFeature::World<PolicyT, FeaturesT>::GetPlacement() const
+{
+  return this->template Interface<WorldPlacementFeature>()
+      ->GetWorldPlacement(this->identity);
+}
+
+}  // namespace physics
+}  // namespace gz
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_DETAIL_WORLDSTATESNAPSHOT_HH_
+#define GZ_PHYSICS_DETAIL_WORLDSTATESNAPSHOT_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <gz/physics/ForwardStep.hh>
+#include <gz/physics/World.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace detail
+{
+/////////////////////////////////////////////////
+/// \brief Append the bytes of a value to a world state snapshot. The plugins
+/// use this to write the engine specific layout of their snapshots, see
+/// WorldStateSnapshotFeature.
+/// \param[in,out] _snapshot Snapshot to append to.
+/// \param[in] _value Value to append.
+template <typename T>
+void AppendToSnapshot(
+    WorldStateSnapshotFeature::Snapshot &_snapshot, const T &_value)
+{
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable values can be stored in a snapshot");
+  const auto *bytes = reinterpret_cast<const std::uint8_t *>(&_value);
+  _snapshot.insert(_snapshot.end(), bytes, bytes + sizeof(T));
+}
+
+/////////////////////////////////////////////////
+/// \brief Append the bytes of an array of values to a world state snapshot.
+/// \param[in,out] _snapshot Snapshot to append to.
+/// \param[in] _values Values to append.
+/// \param[in] _count Number of values.
+template <typename T>
+void AppendToSnapshot(
+    WorldStateSnapshotFeature::Snapshot &_snapshot,
+    const T *_values, std::size_t _count)
+{
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable values can be stored in a snapshot");
+  const auto *bytes = reinterpret_cast<const std::uint8_t *>(_values);
+  _snapshot.insert(_snapshot.end(), bytes, bytes + sizeof(T) * _count);
+}
+
+/////////////////////////////////////////////////
+/// \brief Reads the values of a world state snapshot in order, without
+/// reading past its end. The plugins read and check a whole snapshot before
+/// they apply any of it, so a snapshot that does not match a world leaves
+/// the world unchanged.
+class SnapshotReader
+{
+  /// \brief Constructor.
+  /// \param[in] _snapshot Snapshot to read. It must outlive the reader.
+  public: explicit SnapshotReader(
+      const WorldStateSnapshotFeature::Snapshot &_snapshot)
+    : snapshot(_snapshot)
+  {
+  }
+
+  /// \brief Copy the next bytes of the snapshot.
+  /// \param[out] _data Destination of the bytes.
+  /// \param[in] _size Number of bytes to copy.
+  /// \return False if fewer than _size bytes are left, in which case nothing
+  /// is read.
+  public: bool ReadBytes(void *_data, std::size_t _size)
+  {
+    if (this->snapshot.size() - this->offset < _size)
+      return false;
+    if (_size > 0)
+      std::memcpy(_data, this->snapshot.data() + this->offset, _size);
+    this->offset += _size;
+    return true;
+  }
+
+  /// \brief Check whether every byte of the snapshot has been read. A
+  /// snapshot with bytes left over does not match the world it is applied
+  /// to.
+  /// \return True if the whole snapshot has been read.
+  public: bool AtEnd() const
+  {
+    return this->offset == this->snapshot.size();
+  }
+
+  /// \brief Snapshot being read.
+  private: const WorldStateSnapshotFeature::Snapshot &snapshot;
+
+  /// \brief Number of bytes read so far.
+  private: std::size_t offset = 0;
+};
+
+/////////////////////////////////////////////////
+/// \brief Read a value written by AppendToSnapshot.
+/// \param[in,out] _reader Reader of the snapshot.
+/// \param[out] _value Value that is read.
+/// \return False if the snapshot ends before the value.
+template <typename T>
+bool ReadFromSnapshot(SnapshotReader &_reader, T &_value)
+{
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable values can be read from a snapshot");
+  return _reader.ReadBytes(&_value, sizeof(T));
+}
+
+/////////////////////////////////////////////////
+/// \brief Read an array of values written by AppendToSnapshot.
+/// \param[in,out] _reader Reader of the snapshot.
+/// \param[out] _values Values that are read.
+/// \param[in] _count Number of values.
+/// \return False if the snapshot ends before the last value.
+template <typename T>
+bool ReadFromSnapshot(SnapshotReader &_reader, T *_values, std::size_t _count)
+{
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable values can be read from a snapshot");
+  return _reader.ReadBytes(_values, sizeof(T) * _count);
+}
+
+/////////////////////////////////////////////////
+/// \brief Start a step of a world from the WorldStateSnapshot of its
+/// state, see ForwardStep::State. Call EndSnapshotStep once the step has
+/// been taken.
+/// \param[in] _impl Plugin that implements WorldStateSnapshotFeature.
+/// \param[in] _worldID World that is stepped.
+/// \param[in] _state Snapshot of the step, or nullptr if it has none.
+/// \param[out] _liveState State of the world before the step, if the world
+/// is preserved.
+/// \return False if the snapshot does not match the world, in which case
+/// the step must not be taken.
+template <typename ImplT>
+bool BeginSnapshotStep(ImplT &_impl, const Identity &_worldID,
+                       const WorldStateSnapshot *_state,
+                       WorldStateSnapshotFeature::Snapshot &_liveState)
+{
+  if (!_state)
+    return true;
+  if (_state->preserveWorld)
+    _liveState = _impl.GetWorldStateSnapshot(_worldID);
+  return _state->snapshot.empty() ||
+         _impl.SetWorldStateSnapshot(_worldID, _state->snapshot);
+}
+
+/////////////////////////////////////////////////
+/// \brief Finish a step started by BeginSnapshotStep. The snapshot of the
+/// step is replaced by the stepped state, and a preserved world is put back
+/// into the state it had before the step.
+/// \param[in] _impl Plugin that implements WorldStateSnapshotFeature.
+/// \param[in] _worldID World that is stepped.
+/// \param[in,out] _state Snapshot of the step, or nullptr if it has none.
+/// \param[in] _liveState State filled by BeginSnapshotStep.
+template <typename ImplT>
+void EndSnapshotStep(ImplT &_impl, const Identity &_worldID,
+                     WorldStateSnapshot *_state,
+                     const WorldStateSnapshotFeature::Snapshot &_liveState)
+{
+  if (!_state)
+    return;
+  _state->snapshot = _impl.GetWorldStateSnapshot(_worldID);
+  if (_state->preserveWorld)
+    _impl.SetWorldStateSnapshot(_worldID, _liveState);
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_CONVEXDECOMPOSITIONCACHE_HH_
+#define GZ_PHYSICS_MESH_CONVEXDECOMPOSITIONCACHE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gz/common/Mesh.hh>
+#include <gz/common/SubMesh.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  /// \brief Name of the environment variable holding the directory of the
+  /// on-disk convex decomposition cache. The cache is disabled when the
+  /// variable is unset or empty.
+  constexpr const char *kConvexDecompositionCachePathEnv =
+      "GZ_PHYSICS_CONVEX_DECOMPOSITION_CACHE_PATH";
+
+  /// \brief Decompose a submesh into convex hulls, reusing the result of an
+  /// earlier decomposition of the same geometry from the on-disk cache if
+  /// one is available. New decompositions are added to the cache.
+  /// \param[in] _subMesh Submesh to decompose.
+  /// \param[in] _maxConvexHulls Maximum number of convex hulls to generate.
+  /// \return The convex hulls, or an empty vector if the decomposition
+  /// failed.
+  /// \sa kConvexDecompositionCachePathEnv
+  std::vector<common::SubMesh> CachedConvexDecomposition(
+      const common::SubMesh &_subMesh,
+      std::size_t _maxConvexHulls);
+
+  /// \brief Name under which the convex decomposition of a mesh is added
+  /// to the MeshManager.
+  /// \param[in] _meshName Name of the decomposed mesh.
+  /// \param[in] _maxConvexHulls Maximum number of convex hulls to generate.
+  /// \return The name of the decomposition.
+  std::string ConvexMeshName(
+      const std::string &_meshName,
+      std::size_t _maxConvexHulls);
+
+  /// \brief Merge the submeshes of a mesh and decompose the result into
+  /// convex hulls with CachedConvexDecomposition. This does not use the
+  /// MeshManager, so meshes can be decomposed concurrently.
+  /// \param[in] _mesh Mesh to decompose.
+  /// \param[in] _maxConvexHulls Maximum number of convex hulls to generate.
+  /// \param[in] _optimizationStr Name of the optimization, for logging.
+  /// \return A mesh named by ConvexMeshName with one submesh per hull, or
+  /// nullptr if the submeshes of _mesh could not be merged.
+  std::unique_ptr<common::Mesh> ConvexDecomposeMesh(
+      const common::Mesh &_mesh,
+      std::size_t _maxConvexHulls,
+      const std::string &_optimizationStr);
+
+  /// \brief Get the convex decomposition of a mesh from the MeshManager.
+  /// The first request of a decomposition runs ConvexDecomposeMesh and adds
+  /// the result to the MeshManager, which owns it from then on.
+  /// \param[in] _mesh Mesh to decompose.
+  /// \param[in] _maxConvexHulls Maximum number of convex hulls to generate.
+  /// \param[in] _optimizationStr Name of the optimization, for logging.
+  /// \return The decomposition, or nullptr if _mesh could not be
+  /// decomposed.
+  const common::Mesh *CachedConvexMesh(
+      const common::Mesh &_mesh,
+      std::size_t _maxConvexHulls,
+      const std::string &_optimizationStr);
+
+  /// \brief Name under which the convex decomposition of a mesh that is
+  /// identified by its content is added to the MeshManager.
+  /// \param[in] _contentHash Content hash of the mesh, see MeshContentHash.
+  /// \param[in] _maxConvexHulls Maximum number of convex hulls to generate.
+  /// \return The name of the decomposition.
+  std::string ConvexMeshName(
+      std::uint64_t _contentHash,
+      std::size_t _maxConvexHulls);
+
+  /// \brief Get the convex decomposition of a mesh from the MeshManager,
+  /// like CachedConvexMesh, but keyed by the content of the mesh rather
+  /// than its name. Meshes that are built by an application rather than
+  /// loaded from a file often have no name, or share one.
+  /// \param[in] _mesh Mesh to decompose.
+  /// \param[in] _contentHash Content hash of _mesh, see MeshContentHash.
+  /// \param[in] _maxConvexHulls Maximum number of convex hulls to generate.
+  /// \param[in] _optimizationStr Name of the optimization, for logging.
+  /// \return The decomposition, or nullptr if _mesh could not be
+  /// decomposed.
+  const common::Mesh *CachedConvexMesh(
+      const common::Mesh &_mesh,
+      std::uint64_t _contentHash,
+      std::size_t _maxConvexHulls,
+      const std::string &_optimizationStr);
+
+  /// \brief Hash of the vertices and indices of a submesh and the
+  /// decomposition parameters. This names the cache file of a decomposition.
+  /// \param[in] _subMesh Submesh to decompose.
+  /// \param[in] _maxConvexHulls Maximum number of convex hulls to generate.
+  /// \return The cache key.
+  std::uint64_t ConvexDecompositionCacheKey(
+      const common::SubMesh &_subMesh,
+      std::size_t _maxConvexHulls);
+
+  /// \brief Read convex hulls from a cache file.
+  /// \param[in] _path Path of the cache file.
+  /// \param[in] _key Key the file is expected to have been written with.
+  /// \param[out] _hulls The hulls read from the file.
+  /// \return True if the file exists, is valid and matches _key.
+  bool ReadConvexDecomposition(
+      const std::string &_path,
+      std::uint64_t _key,
+      std::vector<common::SubMesh> &_hulls);
+
+  /// \brief Write convex hulls to a cache file. The file is written under a
+  /// temporary name and then renamed, so concurrent readers never see a
+  /// partial file.
+  /// \param[in] _path Path of the cache file.
+  /// \param[in] _key Key of the decomposition.
+  /// \param[in] _hulls Hulls to write.
+  /// \return True if the file was written.
+  bool WriteConvexDecomposition(
+      const std::string &_path,
+      std::uint64_t _key,
+      const std::vector<common::SubMesh> &_hulls);
+}
+}
+}
+
+#include <gz/physics/mesh/detail/ConvexDecompositionCache.hh>
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_MESHCONTENTHASH_HH_
+#define GZ_PHYSICS_MESH_MESHCONTENTHASH_HH_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <gz/common/Mesh.hh>
+
+#include <gz/physics/mesh/TriangleMeshView.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  /// \brief Hash of the geometry of a mesh: the primitive type, vertices and
+  /// indices of each of its submeshes. Meshes with equal hashes can share
+  /// their collision shapes, whatever their names or file paths.
+  /// \param[in] _mesh Mesh to hash.
+  /// \return The hash.
+  std::uint64_t MeshContentHash(const common::Mesh &_mesh);
+
+  /// \brief Hash of the vertices and indices of a triangle mesh view.
+  /// \param[in] _view View to hash.
+  /// \return The hash.
+  std::uint64_t MeshContentHash(const TriangleMeshView &_view);
+
+  /// \brief Remembers the content hashes of meshes, so that a mesh that is
+  /// attached many times, such as one held by common::MeshManager, is only
+  /// hashed once.
+  class MeshContentHashCache
+  {
+    /// \brief Get the content hash of a mesh.
+    /// \param[in] _mesh Mesh to hash.
+    /// \return The hash.
+    public: std::uint64_t Hash(const common::Mesh &_mesh);
+
+    /// \brief Hashes by mesh address. The name and vertex count are checked
+    /// too, in case a mesh was freed and another one took its address.
+    private: struct Entry
+    {
+      std::string name;
+      unsigned int vertexCount = 0u;
+      std::uint64_t hash = 0u;
+    };
+    private: std::unordered_map<const common::Mesh *, Entry> entries;
+  };
+}
+}
+}
+
+#include <gz/physics/mesh/detail/MeshContentHash.hh>
+
+#endif
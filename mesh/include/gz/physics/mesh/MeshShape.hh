@@ -24,6 +24,7 @@
 
 #include <gz/physics/DeclareShapeType.hh>
 #include <gz/physics/Geometry.hh>
+#include <gz/physics/mesh/TriangleMeshView.hh>
 
 namespace gz
 {
@@ -130,6 +131,237 @@ namespace mesh
           const Dimensions &_scale) = 0;
     };
   };
+
+  /////////////////////////////////////////////////
+  /// \brief Attach a mesh shape from vertex and index arrays, without
+  /// building a common::Mesh. Engines that can collide with arrays they do
+  /// not own use the arrays of the view in place.
+  class AttachMeshViewShapeFeature
+      : public virtual FeatureWithRequirements<MeshShapeCast>
+  {
+    public: template <typename PolicyT, typename FeaturesT>
+    class Link : public virtual Feature::Link<PolicyT, FeaturesT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: using Dimensions =
+          typename FromPolicy<PolicyT>::template Use<LinearVector>;
+
+      public: using ShapePtrType = MeshShapePtr<PolicyT, FeaturesT>;
+
+      /// \brief Attach a triangle mesh shape to this link.
+      /// \param[in] _name Name of the shape.
+      /// \param[in] _view Vertices and indices of the mesh. The arrays must
+      /// stay valid for as long as the shape exists, unless the view's owner
+      /// keeps them alive.
+      /// \param[in] _pose Pose of the shape relative to the link.
+      /// \param[in] _scale Scale applied to the vertices.
+      /// \return The shape, or an invalid pointer if the view is not valid.
+      public: ShapePtrType AttachMeshViewShape(
+          const std::string &_name,
+          const TriangleMeshView &_view,
+          const PoseType &_pose = PoseType::Identity(),
+          const Dimensions &_scale = Dimensions::Ones());
+    };
+
+    public: template <typename PolicyT>
+    class Implementation : public virtual Feature::Implementation<PolicyT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: using Dimensions =
+          typename FromPolicy<PolicyT>::template Use<LinearVector>;
+
+      public: virtual Identity AttachMeshViewShape(
+          const Identity &_linkID,
+          const std::string &_name,
+          const TriangleMeshView &_view,
+          const PoseType &_pose,
+          const Dimensions &_scale) = 0;
+    };
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Attach the convex hull of a mesh, which engines collide with
+  /// their convex algorithms rather than with the triangles of the mesh.
+  /// This is what sdf::MeshOptimization::CONVEX_HULL does for meshes
+  /// constructed from SDF.
+  class AttachConvexMeshShapeFeature
+      : public virtual FeatureWithRequirements<MeshShapeCast>
+  {
+    public: template <typename PolicyT, typename FeaturesT>
+    class Link : public virtual Feature::Link<PolicyT, FeaturesT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: using Dimensions =
+          typename FromPolicy<PolicyT>::template Use<LinearVector>;
+
+      public: using ShapePtrType = MeshShapePtr<PolicyT, FeaturesT>;
+
+      /// \brief Attach the convex hull of a mesh to this link.
+      /// \param[in] _name Name of the shape.
+      /// \param[in] _mesh Mesh to take the hull of. Its submeshes are merged
+      /// into one hull.
+      /// \param[in] _pose Pose of the shape relative to the link.
+      /// \param[in] _scale Scale applied to the vertices.
+      /// \return The shape, or an invalid pointer if no hull could be
+      /// computed.
+      public: ShapePtrType AttachConvexMeshShape(
+          const std::string &_name,
+          const gz::common::Mesh &_mesh,
+          const PoseType &_pose = PoseType::Identity(),
+          const Dimensions &_scale = Dimensions::Ones());
+    };
+
+    public: template <typename PolicyT>
+    class Implementation : public virtual Feature::Implementation<PolicyT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: using Dimensions =
+          typename FromPolicy<PolicyT>::template Use<LinearVector>;
+
+      public: virtual Identity AttachConvexMeshShape(
+          const Identity &_linkID,
+          const std::string &_name,
+          const gz::common::Mesh &_mesh,
+          const PoseType &_pose,
+          const Dimensions &_scale) = 0;
+    };
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Attach the convex decomposition of a mesh, a set of convex
+  /// hulls that engines collide with their convex algorithms. This is what
+  /// sdf::MeshOptimization::CONVEX_DECOMPOSITION does for meshes constructed
+  /// from SDF, and shares its on-disk cache, see
+  /// kConvexDecompositionCachePathEnv.
+  class AttachConvexDecompositionShapeFeature
+      : public virtual FeatureWithRequirements<MeshShapeCast>
+  {
+    public: template <typename PolicyT, typename FeaturesT>
+    class Link : public virtual Feature::Link<PolicyT, FeaturesT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: using Dimensions =
+          typename FromPolicy<PolicyT>::template Use<LinearVector>;
+
+      public: using ShapePtrType = MeshShapePtr<PolicyT, FeaturesT>;
+
+      /// \brief Attach the convex decomposition of a mesh to this link.
+      /// \param[in] _name Name of the shape.
+      /// \param[in] _mesh Mesh to decompose. Its submeshes are merged
+      /// before it is decomposed.
+      /// \param[in] _maxConvexHulls Maximum number of convex hulls to
+      /// generate. The default is the one of SDF.
+      /// \param[in] _pose Pose of the shape relative to the link.
+      /// \param[in] _scale Scale applied to the vertices.
+      /// \return The shape, or an invalid pointer if the mesh could not be
+      /// decomposed.
+      public: ShapePtrType AttachConvexDecompositionShape(
+          const std::string &_name,
+          const gz::common::Mesh &_mesh,
+          std::size_t _maxConvexHulls = 16u,
+          const PoseType &_pose = PoseType::Identity(),
+          const Dimensions &_scale = Dimensions::Ones());
+    };
+
+    public: template <typename PolicyT>
+    class Implementation : public virtual Feature::Implementation<PolicyT>
+    {
+      public: using PoseType =
+          typename FromPolicy<PolicyT>::template Use<Pose>;
+
+      public: using Dimensions =
+          typename FromPolicy<PolicyT>::template Use<LinearVector>;
+
+      public: virtual Identity AttachConvexDecompositionShape(
+          const Identity &_linkID,
+          const std::string &_name,
+          const gz::common::Mesh &_mesh,
+          std::size_t _maxConvexHulls,
+          const PoseType &_pose,
+          const Dimensions &_scale) = 0;
+    };
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Simplify collision meshes that have more triangles than a
+  /// budget when they are constructed, so that visual-grade meshes used for
+  /// collision do not pay for triangles that collision does not need. The
+  /// simplifications are cached by mesh content, see CachedSimplifiedMesh,
+  /// so each mesh is only simplified once. The budget applies to the mesh
+  /// shapes constructed after it is changed.
+  class SimplifyCollisionMeshesFeature : public virtual Feature
+  {
+    public: template <typename PolicyT, typename FeaturesT>
+    class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+    {
+      /// \brief Set the maximum number of triangles of collision meshes.
+      /// \param[in] _maxTriangles Triangle budget of each mesh. 0 disables
+      /// the simplification, which is the default.
+      public: void SetCollisionMeshTriangleBudget(std::size_t _maxTriangles);
+
+      /// \brief Get the maximum number of triangles of collision meshes.
+      /// \return The triangle budget, 0 if meshes are not simplified.
+      public: std::size_t GetCollisionMeshTriangleBudget() const;
+    };
+
+    public: template <typename PolicyT>
+    class Implementation : public virtual Feature::Implementation<PolicyT>
+    {
+      public: virtual void SetEngineCollisionMeshTriangleBudget(
+          const Identity &_engineID, std::size_t _maxTriangles) = 0;
+
+      public: virtual std::size_t GetEngineCollisionMeshTriangleBudget(
+          const Identity &_engineID) const = 0;
+    };
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Replace collision meshes that are boxes, spheres, cylinders or
+  /// capsules, e.g. primitives exported from a modelling tool, by those
+  /// primitives when they are constructed, so that they collide with the
+  /// primitive algorithms of the engine instead of triangle by triangle.
+  /// The fits are cached by mesh content, see PrimitiveFitCache, so each
+  /// mesh is only fitted once. The tolerance applies to the mesh shapes
+  /// constructed after it is changed. Replaced meshes are not mesh shapes,
+  /// so they cast to their primitive rather than to MeshShape.
+  class FitCollisionMeshPrimitivesFeature : public virtual Feature
+  {
+    public: template <typename PolicyT, typename FeaturesT>
+    class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+    {
+      /// \brief Set the largest error of the primitives that replace
+      /// collision meshes.
+      /// \param[in] _tolerance Largest error, relative to the extent of the
+      /// mesh, see BestFittingPrimitive, e.g. 0.01. 0 disables the fitting,
+      /// which is the default.
+      public: void SetCollisionMeshPrimitiveTolerance(double _tolerance);
+
+      /// \brief Get the largest error of the primitives that replace
+      /// collision meshes.
+      /// \return The tolerance, 0 if meshes are not replaced.
+      public: double GetCollisionMeshPrimitiveTolerance() const;
+    };
+
+    public: template <typename PolicyT>
+    class Implementation : public virtual Feature::Implementation<PolicyT>
+    {
+      public: virtual void SetEngineCollisionMeshPrimitiveTolerance(
+          const Identity &_engineID, double _tolerance) = 0;
+
+      public: virtual double GetEngineCollisionMeshPrimitiveTolerance(
+          const Identity &_engineID) const = 0;
+    };
+  };
 }
 }
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_MESHSIMPLIFICATION_HH_
+#define GZ_PHYSICS_MESH_MESHSIMPLIFICATION_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gz/common/Mesh.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  /// \brief Count the triangles of the triangle submeshes of a mesh.
+  /// \param[in] _mesh Mesh to count the triangles of.
+  /// \return The number of triangles.
+  std::size_t MeshTriangleCount(const common::Mesh &_mesh);
+
+  /// \brief Simplify the triangle submeshes of a mesh to at most a given
+  /// number of triangles by vertex clustering: the vertices are snapped to
+  /// the cells of a uniform grid, the vertices of each cell are merged into
+  /// their mean, and the triangles that collapse are dropped. The finest
+  /// grid that fits the budget is used. The result keeps the overall shape
+  /// of the mesh, which is what collision needs, but not its details.
+  /// \param[in] _mesh Mesh to simplify.
+  /// \param[in] _maxTriangles Maximum number of triangles of the result.
+  /// \return A mesh with a single triangle submesh, or nullptr if _mesh
+  /// already fits the budget or no grid fits it.
+  std::unique_ptr<common::Mesh> SimplifyMesh(
+      const common::Mesh &_mesh,
+      std::size_t _maxTriangles);
+
+  /// \brief Name under which the simplification of a mesh is added to the
+  /// MeshManager. It is derived from the content of the mesh, so copies of
+  /// the same mesh loaded under different names share their simplification.
+  /// \param[in] _contentHash Content hash of the mesh, see MeshContentHash.
+  /// \param[in] _maxTriangles Triangle budget of the simplification.
+  /// \return The name of the simplification.
+  std::string SimplifiedMeshName(
+      std::uint64_t _contentHash,
+      std::size_t _maxTriangles);
+
+  /// \brief Get the mesh to collide with in place of a mesh, given a
+  /// triangle budget. The first request of a simplification runs
+  /// SimplifyMesh and adds the result to the MeshManager, which owns it from
+  /// then on. Not thread safe, since it uses the MeshManager.
+  /// \param[in] _mesh Mesh to simplify.
+  /// \param[in] _contentHash Content hash of _mesh, see MeshContentHash.
+  /// \param[in] _maxTriangles Triangle budget. 0 disables simplification.
+  /// \return The simplification, or _mesh itself if it fits the budget or
+  /// could not be simplified.
+  const common::Mesh &CachedSimplifiedMesh(
+      const common::Mesh &_mesh,
+      std::uint64_t _contentHash,
+      std::size_t _maxTriangles);
+}
+}
+}
+
+#include <gz/physics/mesh/detail/MeshSimplification.hh>
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_PRIMITIVEFITTING_HH_
+#define GZ_PHYSICS_MESH_PRIMITIVEFITTING_HH_
+
+#include <cstdint>
+#include <unordered_map>
+
+#include <gz/common/Mesh.hh>
+#include <gz/math/Pose3.hh>
+#include <gz/math/Vector3.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  /// \brief Primitive shape fitted to a mesh, see FitPrimitive.
+  struct FittedPrimitive
+  {
+    /// \brief Type of the primitive.
+    enum class Type
+    {
+      /// \brief No primitive fits the mesh.
+      kNone = 0,
+      kBox,
+      kSphere,
+      kCylinder,
+      kCapsule
+    };
+
+    /// \brief Type of the primitive.
+    Type type = Type::kNone;
+
+    /// \brief Pose of the primitive in the frame of the mesh. Cylinders and
+    /// capsules are along the Z axis of the pose.
+    math::Pose3d pose;
+
+    /// \brief Size of a box.
+    math::Vector3d size;
+
+    /// \brief Radius of a sphere, cylinder or capsule.
+    double radius = 0.0;
+
+    /// \brief Length of a cylinder, or of the cylinder between the caps of a
+    /// capsule.
+    double length = 0.0;
+
+    /// \brief Distance between the surfaces of the mesh and the primitive,
+    /// relative to the largest extent of the mesh, see FitPrimitive.
+    double error = 0.0;
+  };
+
+  /// \brief Find the box, sphere, cylinder or capsule that is closest to a
+  /// mesh. The primitives are aligned with the axes of the mesh and fill its
+  /// bounding box, which is how primitives exported as meshes are usually
+  /// laid out. The error of a primitive is the larger of the largest
+  /// distance of a vertex or triangle centroid of the mesh from the surface
+  /// of the primitive, and the difference of their volumes spread over the
+  /// surface of the primitive, both relative to the largest extent of the
+  /// mesh. The volume catches meshes, such as wedges, whose vertices all lie
+  /// on the surface of a primitive they do not fill.
+  /// \param[in] _mesh Mesh to fit. Only its triangle submeshes are used.
+  /// \return The primitive with the smallest error, whatever the error, or
+  /// a primitive of type kNone if the mesh has no triangles or is flat.
+  FittedPrimitive BestFittingPrimitive(const common::Mesh &_mesh);
+
+  /// \brief Find the primitive that can replace a mesh for collision.
+  /// \param[in] _mesh Mesh to fit.
+  /// \param[in] _tolerance Largest error of the primitive, see
+  /// BestFittingPrimitive, e.g. 0.01 for 1% of the extent of the mesh.
+  /// \return The primitive, or a primitive of type kNone if none fits
+  /// within the tolerance.
+  FittedPrimitive FitPrimitive(const common::Mesh &_mesh, double _tolerance);
+
+  /// \brief Scale a fitted primitive along with its mesh.
+  /// \param[in] _primitive Primitive fitted to the unscaled mesh.
+  /// \param[in] _scale Scale applied to the vertices of the mesh.
+  /// \return The primitive of the scaled mesh, or a primitive of type kNone
+  /// if the scale deforms the primitive into another shape, e.g. a sphere
+  /// into an ellipsoid.
+  FittedPrimitive ScaledPrimitive(
+      const FittedPrimitive &_primitive,
+      const math::Vector3d &_scale);
+
+  /// \brief Remembers the primitives fitted to meshes by content hash, so
+  /// that a mesh that is attached many times is only fitted once.
+  class PrimitiveFitCache
+  {
+    /// \brief Find the primitive that can replace a mesh for collision.
+    /// \param[in] _mesh Mesh to fit.
+    /// \param[in] _contentHash Content hash of _mesh, see MeshContentHash.
+    /// \param[in] _tolerance Largest error of the primitive.
+    /// \return The primitive, see FitPrimitive.
+    public: FittedPrimitive Fit(
+        const common::Mesh &_mesh,
+        std::uint64_t _contentHash,
+        double _tolerance);
+
+    /// \brief Best fitting primitives by content hash, whatever their error.
+    private: std::unordered_map<std::uint64_t, FittedPrimitive> fits;
+  };
+}
+}
+}
+
+#include <gz/physics/mesh/detail/PrimitiveFitting.hh>
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_TRIANGLEMESHVIEW_HH_
+#define GZ_PHYSICS_MESH_TRIANGLEMESHVIEW_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  /// \brief A triangle mesh that refers to vertex and index arrays owned by
+  /// someone else, such as a memory mapped mesh file. Physics engines that
+  /// can collide with arrays they do not own use them in place, and the rest
+  /// copy them once into their own structures, without going through a
+  /// common::Mesh.
+  struct TriangleMeshView
+  {
+    /// \brief Vertex positions, as x, y, z triples.
+    const float *vertices = nullptr;
+
+    /// \brief Number of vertices, which is a third of the number of floats
+    /// in vertices.
+    std::size_t vertexCount = 0u;
+
+    /// \brief Vertex indices, three per triangle.
+    const std::uint32_t *indices = nullptr;
+
+    /// \brief Number of indices.
+    std::size_t indexCount = 0u;
+
+    /// \brief Keeps the arrays alive. Engines that use the arrays in place
+    /// hold a copy of this for as long as the shape exists. It may be empty
+    /// when the caller guarantees the arrays outlive the shape.
+    std::shared_ptr<const void> owner;
+  };
+
+  /// \brief Check that a view describes a non-empty triangle mesh whose
+  /// indices are all in range.
+  /// \param[in] _view View to check.
+  /// \return True if the view can be attached as a mesh shape.
+  bool ValidTriangleMeshView(const TriangleMeshView &_view);
+
+  /// \brief Map a triangle mesh file written by WriteTriangleMeshFile into
+  /// memory. The returned view points into the mapping, which stays alive
+  /// for as long as a copy of the view's owner does. On platforms without
+  /// mmap the file is read into a buffer instead.
+  /// \param[in] _path Path of the mesh file.
+  /// \return A view of the mesh, or an empty view if the file could not be
+  /// read or is not a valid mesh file.
+  TriangleMeshView MapTriangleMeshFile(const std::string &_path);
+
+  /// \brief Write a triangle mesh in the binary layout read by
+  /// MapTriangleMeshFile. The file holds a header followed by the vertex and
+  /// index arrays exactly as they are laid out in memory.
+  /// \param[in] _path Path of the mesh file.
+  /// \param[in] _view Mesh to write.
+  /// \return True if the file was written.
+  bool WriteTriangleMeshFile(
+      const std::string &_path,
+      const TriangleMeshView &_view);
+}
+}
+}
+
+#include <gz/physics/mesh/detail/TriangleMeshView.hh>
+
+#endif
@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_DETAIL_CONVEXDECOMPOSITIONCACHE_HH_
+#define GZ_PHYSICS_MESH_DETAIL_CONVEXDECOMPOSITIONCACHE_HH_
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gz/common/Console.hh>
+#include <gz/common/Mesh.hh>
+#include <gz/common/MeshManager.hh>
+#include <gz/common/SubMesh.hh>
+#include <gz/common/Util.hh>
+
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  namespace detail
+  {
+    /// \brief Identifies a convex decomposition cache file.
+    constexpr char kConvexDecompositionMagic[4] = {'G', 'Z', 'C', 'D'};
+
+    /// \brief Version of the cache file layout. Bump this to invalidate
+    /// existing files when the layout or the decomposition changes.
+    constexpr std::uint32_t kConvexDecompositionVersion = 1u;
+
+    /////////////////////////////////////////////////
+    /// \brief 64 bit FNV-1a hash.
+    class Fnv1a
+    {
+      public: void Add(const void *_data, std::size_t _size)
+      {
+        const auto *bytes = static_cast<const unsigned char *>(_data);
+        for (std::size_t i = 0; i < _size; ++i)
+        {
+          this->hash ^= bytes[i];
+          this->hash *= 1099511628211ull;
+        }
+      }
+
+      public: template <typename T>
+      void Add(const T &_value)
+      {
+        this->Add(&_value, sizeof(T));
+      }
+
+      public: std::uint64_t hash = 14695981039346656037ull;
+    };
+
+    /////////////////////////////////////////////////
+    template <typename T>
+    void WritePod(std::ostream &_out, const T &_value)
+    {
+      _out.write(reinterpret_cast<const char *>(&_value), sizeof(T));
+    }
+
+    /////////////////////////////////////////////////
+    template <typename T>
+    bool ReadPod(std::istream &_in, T &_value)
+    {
+      _in.read(reinterpret_cast<char *>(&_value), sizeof(T));
+      return static_cast<bool>(_in);
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Path of the cache file of a key, or an empty string if the
+    /// cache is disabled.
+    inline std::string ConvexDecompositionCachePath(std::uint64_t _key)
+    {
+      std::string dir;
+      if (!common::env(kConvexDecompositionCachePathEnv, dir) || dir.empty())
+        return std::string();
+
+      std::ostringstream name;
+      name << std::hex << std::setw(16) << std::setfill('0') << _key
+           << ".gzcd";
+      return (std::filesystem::path(dir) / name.str()).string();
+    }
+  }
+
+  /////////////////////////////////////////////////
+  inline std::uint64_t ConvexDecompositionCacheKey(
+      const common::SubMesh &_subMesh,
+      std::size_t _maxConvexHulls)
+  {
+    detail::Fnv1a fnv;
+    fnv.Add(detail::kConvexDecompositionVersion);
+    fnv.Add(static_cast<std::uint64_t>(_maxConvexHulls));
+    fnv.Add(static_cast<std::uint64_t>(_subMesh.VertexCount()));
+    for (std::size_t i = 0; i < _subMesh.VertexCount(); ++i)
+    {
+      const auto &v = _subMesh.Vertex(i);
+      fnv.Add(v.X());
+      fnv.Add(v.Y());
+      fnv.Add(v.Z());
+    }
+    fnv.Add(static_cast<std::uint64_t>(_subMesh.IndexCount()));
+    for (std::size_t i = 0; i < _subMesh.IndexCount(); ++i)
+      fnv.Add(static_cast<std::int32_t>(_subMesh.Index(i)));
+    return fnv.hash;
+  }
+
+  /////////////////////////////////////////////////
+  inline bool ReadConvexDecomposition(
+      const std::string &_path,
+      std::uint64_t _key,
+      std::vector<common::SubMesh> &_hulls)
+  {
+    std::ifstream in(_path, std::ios::binary);
+    if (!in)
+      return false;
+
+    char magic[4];
+    std::uint32_t version = 0u;
+    std::uint64_t key = 0u;
+    std::uint32_t hullCount = 0u;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, detail::kConvexDecompositionMagic,
+                           sizeof(magic)) != 0 ||
+        !detail::ReadPod(in, version) ||
+        version != detail::kConvexDecompositionVersion ||
+        !detail::ReadPod(in, key) || key != _key ||
+        !detail::ReadPod(in, hullCount))
+    {
+      return false;
+    }
+
+    std::vector<common::SubMesh> hulls(hullCount);
+    for (auto &hull : hulls)
+    {
+      std::uint32_t vertexCount = 0u;
+      std::uint32_t indexCount = 0u;
+      if (!detail::ReadPod(in, vertexCount) ||
+          !detail::ReadPod(in, indexCount))
+      {
+        return false;
+      }
+
+      hull.SetPrimitiveType(common::SubMesh::TRIANGLES);
+      for (std::uint32_t i = 0u; i < vertexCount; ++i)
+      {
+        double xyz[3];
+        if (!detail::ReadPod(in, xyz))
+          return false;
+        hull.AddVertex(xyz[0], xyz[1], xyz[2]);
+      }
+      for (std::uint32_t i = 0u; i < indexCount; ++i)
+      {
+        std::uint32_t index = 0u;
+        if (!detail::ReadPod(in, index) || index >= vertexCount)
+          return false;
+        hull.AddIndex(index);
+      }
+    }
+
+    _hulls = std::move(hulls);
+    return true;
+  }
+
+  /////////////////////////////////////////////////
+  inline bool WriteConvexDecomposition(
+      const std::string &_path,
+      std::uint64_t _key,
+      const std::vector<common::SubMesh> &_hulls)
+  {
+    const std::filesystem::path path(_path);
+    std::error_code ec;
+    if (path.has_parent_path())
+      std::filesystem::create_directories(path.parent_path(), ec);
+
+    // Give each writer its own temporary file, so processes sharing the
+    // cache do not interleave their writes.
+    std::ostringstream tmpName;
+    tmpName << _path << ".tmp." << std::hex
+            << std::random_device()() << std::random_device()();
+    const std::string tmpPath = tmpName.str();
+    {
+      std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+      if (!out)
+        return false;
+
+      out.write(detail::kConvexDecompositionMagic,
+                sizeof(detail::kConvexDecompositionMagic));
+      detail::WritePod(out, detail::kConvexDecompositionVersion);
+      detail::WritePod(out, _key);
+      detail::WritePod(out, static_cast<std::uint32_t>(_hulls.size()));
+      for (const auto &hull : _hulls)
+      {
+        detail::WritePod(out, static_cast<std::uint32_t>(hull.VertexCount()));
+        detail::WritePod(out, static_cast<std::uint32_t>(hull.IndexCount()));
+        for (std::size_t i = 0; i < hull.VertexCount(); ++i)
+        {
+          const auto &v = hull.Vertex(i);
+          const double xyz[3] = {v.X(), v.Y(), v.Z()};
+          detail::WritePod(out, xyz);
+        }
+        for (std::size_t i = 0; i < hull.IndexCount(); ++i)
+          detail::WritePod(out, static_cast<std::uint32_t>(hull.Index(i)));
+      }
+
+      if (!out)
+      {
+        out.close();
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+      }
+    }
+
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+      std::filesystem::remove(tmpPath, ec);
+      return false;
+    }
+    return true;
+  }
+
+  /////////////////////////////////////////////////
+  inline std::vector<common::SubMesh> CachedConvexDecomposition(
+      const common::SubMesh &_subMesh,
+      std::size_t _maxConvexHulls)
+  {
+    const std::uint64_t key =
+        ConvexDecompositionCacheKey(_subMesh, _maxConvexHulls);
+    const std::string path = detail::ConvexDecompositionCachePath(key);
+
+    std::vector<common::SubMesh> hulls;
+    if (!path.empty() && ReadConvexDecomposition(path, key, hulls))
+      return hulls;
+
+    hulls = common::MeshManager::ConvexDecomposition(
+        _subMesh, _maxConvexHulls);
+
+    // Empty results are cached too, so a mesh that cannot be decomposed does
+    // not go through the expensive decomposition again.
+    if (!path.empty() && !WriteConvexDecomposition(path, key, hulls))
+    {
+      gzwarn << "Failed to write convex decomposition cache file ["
+             << path << "]." << std::endl;
+    }
+    return hulls;
+  }
+
+  /////////////////////////////////////////////////
+  inline std::string ConvexMeshName(
+      const std::string &_meshName,
+      std::size_t _maxConvexHulls)
+  {
+    return _meshName + "_CONVEX_" + std::to_string(_maxConvexHulls);
+  }
+
+  /////////////////////////////////////////////////
+  inline std::unique_ptr<common::Mesh> ConvexDecomposeMesh(
+      const common::Mesh &_mesh,
+      std::size_t _maxConvexHulls,
+      const std::string &_optimizationStr)
+  {
+    // Merge meshes before convex decomposition
+    auto mergedMesh = common::MeshManager::MergeSubMeshes(_mesh);
+    if (!mergedMesh || mergedMesh->SubMeshCount() != 1u)
+      return nullptr;
+
+    auto mergedSubmesh = mergedMesh->SubMeshByIndex(0u).lock();
+    std::vector<common::SubMesh> decomposed =
+        CachedConvexDecomposition(*mergedSubmesh, _maxConvexHulls);
+    gzdbg << "Optimizing mesh (" << _optimizationStr << "): "
+          <<  _mesh.Name() << std::endl;
+
+    auto convexMesh = std::make_unique<common::Mesh>();
+    convexMesh->SetName(ConvexMeshName(_mesh.Name(), _maxConvexHulls));
+    for (auto &submesh : decomposed)
+    {
+      // Hulls read back from the cache have no normals, which shapes built
+      // from the hulls, e.g. dartsim's CustomMeshShape, require.
+      if (submesh.NormalCount() != submesh.VertexCount())
+        submesh.RecalculateNormals();
+      convexMesh->AddSubMesh(submesh);
+    }
+    if (decomposed.empty())
+    {
+      // Print an error if convex decomposition returned empty submeshes
+      // but the caller still adds it to MeshManager to avoid going through
+      // the expensive convex decomposition process for the same mesh again
+      gzerr << "Convex decomposition generated zero meshes: "
+            << _mesh.Name() << std::endl;
+    }
+    return convexMesh;
+  }
+
+  namespace detail
+  {
+    /////////////////////////////////////////////////
+    /// \brief Get a convex decomposition from the MeshManager under a
+    /// name, decomposing the mesh and adding it under that name first if
+    /// the MeshManager does not have it.
+    inline const common::Mesh *CachedConvexMeshByName(
+        const std::string &_convexMeshName,
+        const common::Mesh &_mesh,
+        std::size_t _maxConvexHulls,
+        const std::string &_optimizationStr)
+    {
+      auto &meshManager = *common::MeshManager::Instance();
+      if (const auto *decomposed = meshManager.MeshByName(_convexMeshName))
+        return decomposed;
+
+      auto convexMesh =
+          ConvexDecomposeMesh(_mesh, _maxConvexHulls, _optimizationStr);
+      if (!convexMesh)
+        return nullptr;
+
+      convexMesh->SetName(_convexMeshName);
+      // Note: MeshManager will call delete on this mesh in its destructor
+      meshManager.AddMesh(convexMesh.release());
+      return meshManager.MeshByName(_convexMeshName);
+    }
+  }
+
+  /////////////////////////////////////////////////
+  inline const common::Mesh *CachedConvexMesh(
+      const common::Mesh &_mesh,
+      std::size_t _maxConvexHulls,
+      const std::string &_optimizationStr)
+  {
+    return detail::CachedConvexMeshByName(
+        ConvexMeshName(_mesh.Name(), _maxConvexHulls),
+        _mesh, _maxConvexHulls, _optimizationStr);
+  }
+
+  /////////////////////////////////////////////////
+  inline std::string ConvexMeshName(
+      std::uint64_t _contentHash,
+      std::size_t _maxConvexHulls)
+  {
+    std::ostringstream name;
+    name << "gz_physics_convex_" << std::hex << std::setw(16)
+         << std::setfill('0') << _contentHash << std::dec << "_"
+         << _maxConvexHulls;
+    return name.str();
+  }
+
+  /////////////////////////////////////////////////
+  inline const common::Mesh *CachedConvexMesh(
+      const common::Mesh &_mesh,
+      std::uint64_t _contentHash,
+      std::size_t _maxConvexHulls,
+      const std::string &_optimizationStr)
+  {
+    return detail::CachedConvexMeshByName(
+        ConvexMeshName(_contentHash, _maxConvexHulls),
+        _mesh, _maxConvexHulls, _optimizationStr);
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_DETAIL_MESHCONTENTHASH_HH_
+#define GZ_PHYSICS_MESH_DETAIL_MESHCONTENTHASH_HH_
+
+#include <cstdint>
+#include <memory>
+
+#include <gz/common/SubMesh.hh>
+
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
+#include <gz/physics/mesh/MeshContentHash.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  /////////////////////////////////////////////////
+  inline std::uint64_t MeshContentHash(const common::Mesh &_mesh)
+  {
+    detail::Fnv1a fnv;
+    fnv.Add(static_cast<std::uint64_t>(_mesh.SubMeshCount()));
+    for (unsigned int i = 0; i < _mesh.SubMeshCount(); ++i)
+    {
+      const auto subMesh = _mesh.SubMeshByIndex(i).lock();
+      if (!subMesh)
+      {
+        fnv.Add(std::int32_t(-1));
+        continue;
+      }
+
+      fnv.Add(static_cast<std::int32_t>(subMesh->SubMeshPrimitiveType()));
+      fnv.Add(static_cast<std::uint64_t>(subMesh->VertexCount()));
+      for (std::size_t j = 0; j < subMesh->VertexCount(); ++j)
+      {
+        const auto &v = subMesh->Vertex(j);
+        fnv.Add(v.X());
+        fnv.Add(v.Y());
+        fnv.Add(v.Z());
+      }
+      fnv.Add(static_cast<std::uint64_t>(subMesh->IndexCount()));
+      for (std::size_t j = 0; j < subMesh->IndexCount(); ++j)
+        fnv.Add(static_cast<std::int32_t>(subMesh->Index(j)));
+    }
+    return fnv.hash;
+  }
+
+  /////////////////////////////////////////////////
+  inline std::uint64_t MeshContentHash(const TriangleMeshView &_view)
+  {
+    detail::Fnv1a fnv;
+    fnv.Add(static_cast<std::uint64_t>(_view.vertexCount));
+    if (_view.vertices)
+      fnv.Add(_view.vertices, _view.vertexCount * 3u * sizeof(float));
+    fnv.Add(static_cast<std::uint64_t>(_view.indexCount));
+    if (_view.indices)
+      fnv.Add(_view.indices, _view.indexCount * sizeof(std::uint32_t));
+    return fnv.hash;
+  }
+
+  /////////////////////////////////////////////////
+  inline std::uint64_t MeshContentHashCache::Hash(const common::Mesh &_mesh)
+  {
+    auto it = this->entries.find(&_mesh);
+    if (it != this->entries.end() && it->second.name == _mesh.Name() &&
+        it->second.vertexCount == _mesh.VertexCount())
+    {
+      return it->second.hash;
+    }
+
+    Entry entry{_mesh.Name(), _mesh.VertexCount(), MeshContentHash(_mesh)};
+    const std::uint64_t hash = entry.hash;
+    this->entries[&_mesh] = std::move(entry);
+    return hash;
+  }
+}
+}
+}
+
+#endif
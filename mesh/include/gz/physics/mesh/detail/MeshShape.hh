@@ -67,6 +67,89 @@ namespace mesh
           this->template Interface<AttachMeshShapeFeature>()
               ->AttachMeshShape(this->identity, _name, _mesh, _pose, _scale));
   }
+
+  /////////////////////////////////////////////////
+  template <typename PolicyT, typename FeaturesT>
+  auto AttachMeshViewShapeFeature::Link<PolicyT, FeaturesT>::
+  AttachMeshViewShape(
+      const std::string &_name,
+      const TriangleMeshView &_view,
+      const PoseType &_pose,
+      const Dimensions &_scale) -> ShapePtrType
+  {
+    return ShapePtrType(this->pimpl,
+          this->template Interface<AttachMeshViewShapeFeature>()
+              ->AttachMeshViewShape(
+                  this->identity, _name, _view, _pose, _scale));
+  }
+
+  /////////////////////////////////////////////////
+  template <typename PolicyT, typename FeaturesT>
+  auto AttachConvexMeshShapeFeature::Link<PolicyT, FeaturesT>::
+  AttachConvexMeshShape(
+      const std::string &_name,
+      const gz::common::Mesh &_mesh,
+      const PoseType &_pose,
+      const Dimensions &_scale) -> ShapePtrType
+  {
+    return ShapePtrType(this->pimpl,
+          this->template Interface<AttachConvexMeshShapeFeature>()
+              ->AttachConvexMeshShape(
+                  this->identity, _name, _mesh, _pose, _scale));
+  }
+
+  /////////////////////////////////////////////////
+  template <typename PolicyT, typename FeaturesT>
+  auto AttachConvexDecompositionShapeFeature::Link<PolicyT, FeaturesT>::
+  AttachConvexDecompositionShape(
+      const std::string &_name,
+      const gz::common::Mesh &_mesh,
+      std::size_t _maxConvexHulls,
+      const PoseType &_pose,
+      const Dimensions &_scale) -> ShapePtrType
+  {
+    return ShapePtrType(this->pimpl,
+          this->template Interface<AttachConvexDecompositionShapeFeature>()
+              ->AttachConvexDecompositionShape(
+                  this->identity, _name, _mesh, _maxConvexHulls,
+                  _pose, _scale));
+  }
+
+  /////////////////////////////////////////////////
+  template <typename PolicyT, typename FeaturesT>
+  void SimplifyCollisionMeshesFeature::Engine<PolicyT, FeaturesT>::
+  SetCollisionMeshTriangleBudget(std::size_t _maxTriangles)
+  {
+    this->template Interface<SimplifyCollisionMeshesFeature>()
+        ->SetEngineCollisionMeshTriangleBudget(this->identity, _maxTriangles);
+  }
+
+  /////////////////////////////////////////////////
+  template <typename PolicyT, typename FeaturesT>
+  std::size_t SimplifyCollisionMeshesFeature::Engine<PolicyT, FeaturesT>::
+  GetCollisionMeshTriangleBudget() const
+  {
+    return this->template Interface<SimplifyCollisionMeshesFeature>()
+        ->GetEngineCollisionMeshTriangleBudget(this->identity);
+  }
+
+  /////////////////////////////////////////////////
+  template <typename PolicyT, typename FeaturesT>
+  void FitCollisionMeshPrimitivesFeature::Engine<PolicyT, FeaturesT>::
+  SetCollisionMeshPrimitiveTolerance(double _tolerance)
+  {
+    this->template Interface<FitCollisionMeshPrimitivesFeature>()
+        ->SetEngineCollisionMeshPrimitiveTolerance(this->identity, _tolerance);
+  }
+
+  /////////////////////////////////////////////////
+  template <typename PolicyT, typename FeaturesT>
+  double FitCollisionMeshPrimitivesFeature::Engine<PolicyT, FeaturesT>::
+  GetCollisionMeshPrimitiveTolerance() const
+  {
+    return this->template Interface<FitCollisionMeshPrimitivesFeature>()
+        ->GetEngineCollisionMeshPrimitiveTolerance(this->identity);
+  }
 }
 }
 }
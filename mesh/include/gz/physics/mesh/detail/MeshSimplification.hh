@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_DETAIL_MESHSIMPLIFICATION_HH_
+#define GZ_PHYSICS_MESH_DETAIL_MESHSIMPLIFICATION_HH_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <gz/common/Console.hh>
+#include <gz/common/MeshManager.hh>
+#include <gz/common/SubMesh.hh>
+#include <gz/math/Vector3.hh>
+
+#include <gz/physics/mesh/MeshSimplification.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  namespace detail
+  {
+    using Triangle = std::array<std::uint32_t, 3>;
+
+    /// \brief Vertices and triangles of a mesh being simplified.
+    struct TriangleSoup
+    {
+      std::vector<math::Vector3d> vertices;
+      std::vector<Triangle> triangles;
+    };
+
+    /// \brief Number of bits of each cell coordinate in a cell key.
+    constexpr int kCellBits = 21;
+
+    /// \brief Cluster the vertices of a mesh on a grid, see SimplifyMesh.
+    /// \param[in] _input Mesh to cluster.
+    /// \param[in] _min Corner of the grid.
+    /// \param[in] _cellSize Edge length of the cells.
+    /// \param[out] _output The clustered mesh.
+    inline void ClusterVertices(
+        const TriangleSoup &_input,
+        const math::Vector3d &_min,
+        double _cellSize,
+        TriangleSoup &_output)
+    {
+      _output.vertices.clear();
+      _output.triangles.clear();
+
+      const auto cellCoordinate = [&](double _value, double _minValue)
+      {
+        const double cell = std::floor((_value - _minValue) / _cellSize);
+        return static_cast<std::uint64_t>(std::clamp(
+            cell, 0.0, static_cast<double>((1u << kCellBits) - 1u)));
+      };
+
+      std::unordered_map<std::uint64_t, std::uint32_t> cells;
+      std::vector<std::uint32_t> clusterOf(_input.vertices.size());
+      std::vector<double> clusterSizes;
+      for (std::size_t i = 0; i < _input.vertices.size(); ++i)
+      {
+        const auto &v = _input.vertices[i];
+        const std::uint64_t key =
+            cellCoordinate(v.X(), _min.X()) |
+            (cellCoordinate(v.Y(), _min.Y()) << kCellBits) |
+            (cellCoordinate(v.Z(), _min.Z()) << (2 * kCellBits));
+        const auto [it, inserted] = cells.emplace(
+            key, static_cast<std::uint32_t>(_output.vertices.size()));
+        if (inserted)
+        {
+          _output.vertices.push_back(math::Vector3d::Zero);
+          clusterSizes.push_back(0.0);
+        }
+        _output.vertices[it->second] += v;
+        clusterSizes[it->second] += 1.0;
+        clusterOf[i] = it->second;
+      }
+
+      for (std::size_t i = 0; i < _output.vertices.size(); ++i)
+        _output.vertices[i] /= clusterSizes[i];
+
+      for (const auto &triangle : _input.triangles)
+      {
+        Triangle clustered = {clusterOf[triangle[0]],
+                              clusterOf[triangle[1]],
+                              clusterOf[triangle[2]]};
+        if (clustered[0] == clustered[1] || clustered[1] == clustered[2] ||
+            clustered[0] == clustered[2])
+        {
+          continue;
+        }
+
+        // Rotate the smallest index first, keeping the winding, so that
+        // copies of a triangle compare equal
+        std::rotate(clustered.begin(),
+            std::min_element(clustered.begin(), clustered.end()),
+            clustered.end());
+        _output.triangles.push_back(clustered);
+      }
+
+      std::sort(_output.triangles.begin(), _output.triangles.end());
+      _output.triangles.erase(
+          std::unique(_output.triangles.begin(), _output.triangles.end()),
+          _output.triangles.end());
+    }
+  }
+
+  /////////////////////////////////////////////////
+  inline std::size_t MeshTriangleCount(const common::Mesh &_mesh)
+  {
+    std::size_t count = 0u;
+    for (unsigned int i = 0; i < _mesh.SubMeshCount(); ++i)
+    {
+      const auto subMesh = _mesh.SubMeshByIndex(i).lock();
+      if (subMesh &&
+          subMesh->SubMeshPrimitiveType() == common::SubMesh::TRIANGLES)
+      {
+        count += subMesh->IndexCount() / 3u;
+      }
+    }
+    return count;
+  }
+
+  /////////////////////////////////////////////////
+  inline std::unique_ptr<common::Mesh> SimplifyMesh(
+      const common::Mesh &_mesh,
+      std::size_t _maxTriangles)
+  {
+    detail::TriangleSoup input;
+    for (unsigned int i = 0; i < _mesh.SubMeshCount(); ++i)
+    {
+      const auto subMesh = _mesh.SubMeshByIndex(i).lock();
+      if (!subMesh ||
+          subMesh->SubMeshPrimitiveType() != common::SubMesh::TRIANGLES)
+      {
+        continue;
+      }
+
+      const auto offset = static_cast<std::uint32_t>(input.vertices.size());
+      const std::size_t vertexCount = subMesh->VertexCount();
+      for (std::size_t j = 0; j < vertexCount; ++j)
+        input.vertices.push_back(subMesh->Vertex(j));
+      for (std::size_t j = 0; j + 2 < subMesh->IndexCount(); j += 3)
+      {
+        detail::Triangle triangle;
+        bool valid = true;
+        for (std::size_t k = 0; k < 3u; ++k)
+        {
+          const int index = subMesh->Index(j + k);
+          valid = valid && index >= 0 &&
+              static_cast<std::size_t>(index) < vertexCount;
+          triangle[k] = offset + static_cast<std::uint32_t>(index);
+        }
+        if (valid)
+          input.triangles.push_back(triangle);
+      }
+    }
+
+    if (_maxTriangles == 0u || input.triangles.size() <= _maxTriangles)
+      return nullptr;
+
+    math::Vector3d min = input.vertices.front();
+    math::Vector3d max = min;
+    for (const auto &v : input.vertices)
+    {
+      min.Min(v);
+      max.Max(v);
+    }
+    const double extent = (max - min).Max();
+    if (!(extent > 0.0))
+      return nullptr;
+
+    // The triangle count grows with the resolution of the grid, so search
+    // for the finest grid that fits the budget.
+    detail::TriangleSoup candidate;
+    detail::TriangleSoup result;
+    std::size_t low = 1u;
+    std::size_t high = 1024u;
+    bool found = false;
+    while (low <= high)
+    {
+      const std::size_t resolution = low + (high - low) / 2u;
+      detail::ClusterVertices(input, min,
+          extent / static_cast<double>(resolution), candidate);
+      if (candidate.triangles.size() <= _maxTriangles)
+      {
+        std::swap(result, candidate);
+        found = true;
+        low = resolution + 1u;
+      }
+      else
+      {
+        high = resolution - 1u;
+      }
+    }
+
+    if (!found || result.triangles.empty())
+      return nullptr;
+
+    // Mesh shapes of some engines need a normal per vertex
+    std::vector<math::Vector3d> normals(
+        result.vertices.size(), math::Vector3d::Zero);
+    for (const auto &triangle : result.triangles)
+    {
+      const auto &a = result.vertices[triangle[0]];
+      const math::Vector3d n =
+          (result.vertices[triangle[1]] - a).Cross(
+              result.vertices[triangle[2]] - a);
+      for (const auto index : triangle)
+        normals[index] += n;
+    }
+
+    common::SubMesh subMesh;
+    subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+    for (std::size_t i = 0; i < result.vertices.size(); ++i)
+    {
+      subMesh.AddVertex(result.vertices[i]);
+      subMesh.AddNormal(normals[i].Normalized());
+    }
+    for (const auto &triangle : result.triangles)
+    {
+      for (const auto index : triangle)
+        subMesh.AddIndex(index);
+    }
+
+    auto simplified = std::make_unique<common::Mesh>();
+    simplified->SetName(_mesh.Name());
+    simplified->AddSubMesh(subMesh);
+    return simplified;
+  }
+
+  /////////////////////////////////////////////////
+  inline std::string SimplifiedMeshName(
+      std::uint64_t _contentHash,
+      std::size_t _maxTriangles)
+  {
+    std::ostringstream name;
+    name << "gz_physics_simplified_" << std::hex << std::setw(16)
+         << std::setfill('0') << _contentHash << std::dec << "_"
+         << _maxTriangles;
+    return name.str();
+  }
+
+  /////////////////////////////////////////////////
+  inline const common::Mesh &CachedSimplifiedMesh(
+      const common::Mesh &_mesh,
+      std::uint64_t _contentHash,
+      std::size_t _maxTriangles)
+  {
+    if (_maxTriangles == 0u || MeshTriangleCount(_mesh) <= _maxTriangles)
+      return _mesh;
+
+    auto &meshManager = *common::MeshManager::Instance();
+    const std::string name = SimplifiedMeshName(_contentHash, _maxTriangles);
+    if (const auto *simplified = meshManager.MeshByName(name))
+      return *simplified;
+
+    auto simplified = SimplifyMesh(_mesh, _maxTriangles);
+    if (!simplified)
+      return _mesh;
+
+    gzdbg << "Simplified collision mesh [" << _mesh.Name() << "] from ["
+          << MeshTriangleCount(_mesh) << "] to ["
+          << MeshTriangleCount(*simplified) << "] triangles\n";
+    simplified->SetName(name);
+    // Note: MeshManager will call delete on this mesh in its destructor
+    meshManager.AddMesh(simplified.release());
+    const auto *added = meshManager.MeshByName(name);
+    return added ? *added : _mesh;
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_DETAIL_PRIMITIVEFITTING_HH_
+#define GZ_PHYSICS_MESH_DETAIL_PRIMITIVEFITTING_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gz/common/SubMesh.hh>
+#include <gz/math/Helpers.hh>
+#include <gz/math/Quaternion.hh>
+
+#include <gz/physics/mesh/PrimitiveFitting.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  namespace detail
+  {
+    /// \brief Primitive being fitted, in the frame of the mesh, relative to
+    /// the center of its bounding box.
+    struct PrimitiveCandidate
+    {
+      FittedPrimitive::Type type = FittedPrimitive::Type::kNone;
+
+      /// \brief Axis of a cylinder or capsule: 0, 1 or 2 for X, Y or Z.
+      int axis = 2;
+
+      /// \brief Half of the size of a box.
+      math::Vector3d halfSize;
+
+      double radius = 0.0;
+
+      /// \brief Half of the length of a cylinder, or of the cylinder of a
+      /// capsule.
+      double halfLength = 0.0;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Distance of a point from the surface of a box, given the
+    /// offsets of the point from the faces of each axis, |p_i| - h_i, which
+    /// are positive outside of the faces.
+    /// \param[in] _q Offsets.
+    /// \param[in] _n Number of axes.
+    /// \return The unsigned distance.
+    inline double BoxSurfaceDistance(const double *_q, std::size_t _n)
+    {
+      double outside = 0.0;
+      double inside = -std::numeric_limits<double>::infinity();
+      for (std::size_t i = 0; i < _n; ++i)
+      {
+        outside += std::pow(std::max(_q[i], 0.0), 2);
+        inside = std::max(inside, _q[i]);
+      }
+      return outside > 0.0 ? std::sqrt(outside) : -inside;
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Distance of a point from the surface of a primitive.
+    /// \param[in] _candidate Primitive.
+    /// \param[in] _p Point, relative to the center of the primitive.
+    /// \return The unsigned distance.
+    inline double SurfaceDistance(
+        const PrimitiveCandidate &_candidate, const math::Vector3d &_p)
+    {
+      using Type = FittedPrimitive::Type;
+      const int a = _candidate.axis;
+      const double axial = _p[a];
+      const double radial = std::hypot(_p[(a + 1) % 3], _p[(a + 2) % 3]);
+      switch (_candidate.type)
+      {
+        case Type::kBox:
+        {
+          const double q[3] = {
+            std::abs(_p.X()) - _candidate.halfSize.X(),
+            std::abs(_p.Y()) - _candidate.halfSize.Y(),
+            std::abs(_p.Z()) - _candidate.halfSize.Z()};
+          return BoxSurfaceDistance(q, 3u);
+        }
+        case Type::kSphere:
+          return std::abs(_p.Length() - _candidate.radius);
+        case Type::kCylinder:
+        {
+          const double q[2] = {
+            radial - _candidate.radius,
+            std::abs(axial) - _candidate.halfLength};
+          return BoxSurfaceDistance(q, 2u);
+        }
+        case Type::kCapsule:
+        {
+          const double t = std::clamp(
+              axial, -_candidate.halfLength, _candidate.halfLength);
+          return std::abs(
+              std::hypot(axial - t, radial) - _candidate.radius);
+        }
+        default:
+          return std::numeric_limits<double>::infinity();
+      }
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Volume and surface area of a primitive.
+    /// \param[in] _candidate Primitive.
+    /// \param[out] _volume Volume.
+    /// \param[out] _area Surface area.
+    inline void VolumeAndArea(
+        const PrimitiveCandidate &_candidate, double &_volume, double &_area)
+    {
+      using Type = FittedPrimitive::Type;
+      const double r = _candidate.radius;
+      const double l = 2.0 * _candidate.halfLength;
+      switch (_candidate.type)
+      {
+        case Type::kBox:
+        {
+          const math::Vector3d s = 2.0 * _candidate.halfSize;
+          _volume = s.X() * s.Y() * s.Z();
+          _area = 2.0 * (s.X() * s.Y() + s.Y() * s.Z() + s.Z() * s.X());
+          return;
+        }
+        case Type::kSphere:
+          _volume = 4.0 / 3.0 * GZ_PI * r * r * r;
+          _area = 4.0 * GZ_PI * r * r;
+          return;
+        case Type::kCylinder:
+          _volume = GZ_PI * r * r * l;
+          _area = 2.0 * GZ_PI * r * (r + l);
+          return;
+        case Type::kCapsule:
+          _volume = GZ_PI * r * r * (l + 4.0 / 3.0 * r);
+          _area = 2.0 * GZ_PI * r * (l + 2.0 * r);
+          return;
+        default:
+          _volume = 0.0;
+          _area = 0.0;
+          return;
+      }
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Rotation that takes the Z axis to an axis of the mesh.
+    /// \param[in] _axis 0, 1 or 2 for X, Y or Z.
+    /// \return The rotation.
+    inline math::Quaterniond AxisRotation(int _axis)
+    {
+      if (_axis == 0)
+        return math::Quaterniond(0.0, GZ_PI / 2.0, 0.0);
+      if (_axis == 1)
+        return math::Quaterniond(-GZ_PI / 2.0, 0.0, 0.0);
+      return math::Quaterniond::Identity;
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Axis of the mesh that the Z axis of a primitive is along.
+    /// \param[in] _primitive Primitive.
+    /// \return 0, 1 or 2 for X, Y or Z.
+    inline int PrimitiveAxis(const FittedPrimitive &_primitive)
+    {
+      const math::Vector3d z =
+          _primitive.pose.Rot().RotateVector(math::Vector3d::UnitZ);
+      int axis = 0;
+      for (int i = 1; i < 3; ++i)
+      {
+        if (std::abs(z[i]) > std::abs(z[axis]))
+          axis = i;
+      }
+      return axis;
+    }
+  }
+
+  /////////////////////////////////////////////////
+  inline FittedPrimitive BestFittingPrimitive(const common::Mesh &_mesh)
+  {
+    using Type = FittedPrimitive::Type;
+
+    std::vector<math::Vector3d> vertices;
+    std::vector<std::uint32_t> triangles;
+    for (unsigned int i = 0; i < _mesh.SubMeshCount(); ++i)
+    {
+      const auto subMesh = _mesh.SubMeshByIndex(i).lock();
+      if (!subMesh ||
+          subMesh->SubMeshPrimitiveType() != common::SubMesh::TRIANGLES)
+      {
+        continue;
+      }
+
+      const auto offset = static_cast<std::uint32_t>(vertices.size());
+      const std::size_t vertexCount = subMesh->VertexCount();
+      for (std::size_t j = 0; j < vertexCount; ++j)
+        vertices.push_back(subMesh->Vertex(j));
+      for (std::size_t j = 0; j + 2 < subMesh->IndexCount(); j += 3)
+      {
+        bool valid = true;
+        for (std::size_t k = 0; k < 3u; ++k)
+        {
+          const int index = subMesh->Index(j + k);
+          valid = valid && index >= 0 &&
+              static_cast<std::size_t>(index) < vertexCount;
+        }
+        if (!valid)
+          continue;
+        for (std::size_t k = 0; k < 3u; ++k)
+        {
+          triangles.push_back(
+              offset + static_cast<std::uint32_t>(subMesh->Index(j + k)));
+        }
+      }
+    }
+
+    FittedPrimitive best;
+    if (triangles.empty())
+      return best;
+
+    math::Vector3d min = vertices.front();
+    math::Vector3d max = min;
+    for (const auto &v : vertices)
+    {
+      min.Min(v);
+      max.Max(v);
+    }
+    const math::Vector3d extent = max - min;
+    const double scale = extent.Max();
+    if (!(extent.Min() > 0.0))
+      return best;
+    const math::Vector3d center = 0.5 * (min + max);
+
+    // The vertices and triangle centroids are compared with the surface of
+    // the primitives, and the volume enclosed by the triangles with theirs.
+    std::vector<math::Vector3d> samples;
+    samples.reserve(vertices.size() + triangles.size() / 3u);
+    for (const auto &v : vertices)
+      samples.push_back(v - center);
+    double volume = 0.0;
+    for (std::size_t i = 0; i < triangles.size(); i += 3)
+    {
+      const math::Vector3d a = vertices[triangles[i]] - center;
+      const math::Vector3d b = vertices[triangles[i + 1]] - center;
+      const math::Vector3d c = vertices[triangles[i + 2]] - center;
+      samples.push_back((a + b + c) / 3.0);
+      volume += a.Dot(b.Cross(c)) / 6.0;
+    }
+    volume = std::abs(volume);
+
+    std::vector<detail::PrimitiveCandidate> candidates;
+    detail::PrimitiveCandidate box;
+    box.type = Type::kBox;
+    box.halfSize = 0.5 * extent;
+    candidates.push_back(box);
+
+    detail::PrimitiveCandidate sphere;
+    sphere.type = Type::kSphere;
+    sphere.radius = (extent.X() + extent.Y() + extent.Z()) / 6.0;
+    candidates.push_back(sphere);
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      detail::PrimitiveCandidate round;
+      round.axis = axis;
+      round.radius =
+          0.25 * (extent[(axis + 1) % 3] + extent[(axis + 2) % 3]);
+
+      round.type = Type::kCylinder;
+      round.halfLength = 0.5 * extent[axis];
+      candidates.push_back(round);
+
+      round.type = Type::kCapsule;
+      round.halfLength = 0.5 * extent[axis] - round.radius;
+      if (round.halfLength > 0.0)
+        candidates.push_back(round);
+    }
+
+    best.error = std::numeric_limits<double>::infinity();
+    for (const auto &candidate : candidates)
+    {
+      double primitiveVolume = 0.0;
+      double primitiveArea = 0.0;
+      detail::VolumeAndArea(candidate, primitiveVolume, primitiveArea);
+      double error =
+          std::abs(volume - primitiveVolume) / (primitiveArea * scale);
+      for (const auto &p : samples)
+      {
+        if (error >= best.error)
+          break;
+        error = std::max(error,
+            detail::SurfaceDistance(candidate, p) / scale);
+      }
+      if (error >= best.error)
+        continue;
+
+      best.type = candidate.type;
+      best.pose = math::Pose3d(center, detail::AxisRotation(
+          candidate.type == Type::kCylinder ||
+          candidate.type == Type::kCapsule ? candidate.axis : 2));
+      best.size = 2.0 * candidate.halfSize;
+      best.radius = candidate.radius;
+      best.length = 2.0 * candidate.halfLength;
+      best.error = error;
+    }
+    return best;
+  }
+
+  /////////////////////////////////////////////////
+  inline FittedPrimitive FitPrimitive(
+      const common::Mesh &_mesh, double _tolerance)
+  {
+    FittedPrimitive fit = BestFittingPrimitive(_mesh);
+    if (fit.type == FittedPrimitive::Type::kNone || !(fit.error <= _tolerance))
+      return FittedPrimitive();
+    return fit;
+  }
+
+  /////////////////////////////////////////////////
+  inline FittedPrimitive ScaledPrimitive(
+      const FittedPrimitive &_primitive,
+      const math::Vector3d &_scale)
+  {
+    using Type = FittedPrimitive::Type;
+    const math::Vector3d s = _scale.Abs();
+    const auto equal = [](double _a, double _b)
+    {
+      return std::abs(_a - _b) <= 1e-9 * std::max(_a, _b);
+    };
+
+    FittedPrimitive scaled = _primitive;
+    scaled.pose.Pos() = _primitive.pose.Pos() * _scale;
+    const int a = detail::PrimitiveAxis(_primitive);
+    const double radial = s[(a + 1) % 3];
+    switch (_primitive.type)
+    {
+      case Type::kBox:
+        scaled.size = _primitive.size * s;
+        return scaled;
+      case Type::kSphere:
+        if (!equal(s.X(), s.Y()) || !equal(s.Y(), s.Z()))
+          return FittedPrimitive();
+        scaled.radius *= s.X();
+        return scaled;
+      case Type::kCylinder:
+        if (!equal(radial, s[(a + 2) % 3]))
+          return FittedPrimitive();
+        scaled.radius *= radial;
+        scaled.length *= s[a];
+        return scaled;
+      case Type::kCapsule:
+        // Scaling the axis apart from the radius would stretch the caps
+        if (!equal(s.X(), s.Y()) || !equal(s.Y(), s.Z()))
+          return FittedPrimitive();
+        scaled.radius *= s.X();
+        scaled.length *= s.X();
+        return scaled;
+      default:
+        return FittedPrimitive();
+    }
+  }
+
+  /////////////////////////////////////////////////
+  inline FittedPrimitive PrimitiveFitCache::Fit(
+      const common::Mesh &_mesh,
+      std::uint64_t _contentHash,
+      double _tolerance)
+  {
+    if (!(_tolerance > 0.0))
+      return FittedPrimitive();
+
+    auto it = this->fits.find(_contentHash);
+    if (it == this->fits.end())
+      it = this->fits.emplace(_contentHash, BestFittingPrimitive(_mesh)).first;
+
+    if (it->second.type == FittedPrimitive::Type::kNone ||
+        !(it->second.error <= _tolerance))
+    {
+      return FittedPrimitive();
+    }
+    return it->second;
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_MESH_DETAIL_TRIANGLEMESHVIEW_HH_
+#define GZ_PHYSICS_MESH_DETAIL_TRIANGLEMESHVIEW_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <gz/physics/mesh/TriangleMeshView.hh>
+
+namespace gz
+{
+namespace physics
+{
+namespace mesh
+{
+  namespace detail
+  {
+    /// \brief Identifies a triangle mesh file.
+    constexpr char kTriangleMeshMagic[4] = {'G', 'Z', 'T', 'M'};
+
+    /// \brief Version of the triangle mesh file layout.
+    constexpr std::uint32_t kTriangleMeshVersion = 1u;
+
+    /// \brief Header of a triangle mesh file. The vertex and index arrays
+    /// follow it in native byte order, and stay 4 byte aligned in the file.
+    struct TriangleMeshHeader
+    {
+      char magic[4];
+      std::uint32_t version;
+      std::uint64_t vertexCount;
+      std::uint64_t indexCount;
+    };
+
+    /////////////////////////////////////////////////
+    /// \brief Point a view at the arrays of a mesh file held in memory.
+    /// \param[in] _data Contents of the file.
+    /// \param[in] _size Size of the file in bytes.
+    /// \param[in] _owner Keeps _data alive.
+    /// \return The view, or an empty view if the contents are not a valid
+    /// mesh file.
+    inline TriangleMeshView ViewTriangleMeshData(
+        const void *_data, std::size_t _size,
+        std::shared_ptr<const void> _owner)
+    {
+      TriangleMeshHeader header;
+      if (_size < sizeof(header))
+        return TriangleMeshView();
+
+      std::memcpy(&header, _data, sizeof(header));
+      if (std::memcmp(header.magic, kTriangleMeshMagic,
+                      sizeof(header.magic)) != 0 ||
+          header.version != kTriangleMeshVersion)
+      {
+        return TriangleMeshView();
+      }
+
+      // Check the counts against the file size before multiplying them, so
+      // a corrupt header cannot overflow the expected size.
+      const std::size_t payload = _size - sizeof(header);
+      if (header.vertexCount > payload / (3u * sizeof(float)) ||
+          header.indexCount > payload / sizeof(std::uint32_t) ||
+          header.vertexCount * 3u * sizeof(float) +
+              header.indexCount * sizeof(std::uint32_t) != payload)
+      {
+        return TriangleMeshView();
+      }
+
+      const auto *bytes = static_cast<const unsigned char *>(_data);
+      TriangleMeshView view;
+      view.vertices =
+          reinterpret_cast<const float *>(bytes + sizeof(header));
+      view.vertexCount = static_cast<std::size_t>(header.vertexCount);
+      view.indices = reinterpret_cast<const std::uint32_t *>(
+          bytes + sizeof(header) + view.vertexCount * 3u * sizeof(float));
+      view.indexCount = static_cast<std::size_t>(header.indexCount);
+      view.owner = std::move(_owner);
+
+      if (!ValidTriangleMeshView(view))
+        return TriangleMeshView();
+      return view;
+    }
+  }
+
+  /////////////////////////////////////////////////
+  inline bool ValidTriangleMeshView(const TriangleMeshView &_view)
+  {
+    if (nullptr == _view.vertices || nullptr == _view.indices ||
+        0u == _view.vertexCount || 0u == _view.indexCount ||
+        _view.indexCount % 3u != 0u)
+    {
+      return false;
+    }
+
+    for (std::size_t i = 0; i < _view.indexCount; ++i)
+    {
+      if (_view.indices[i] >= _view.vertexCount)
+        return false;
+    }
+    return true;
+  }
+
+  /////////////////////////////////////////////////
+  inline TriangleMeshView MapTriangleMeshFile(const std::string &_path)
+  {
+#ifndef _WIN32
+    const int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return TriangleMeshView();
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+      ::close(fd);
+      return TriangleMeshView();
+    }
+
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (MAP_FAILED == data)
+      return TriangleMeshView();
+
+    std::shared_ptr<const void> mapping(data, [size](const void *_data)
+    {
+      ::munmap(const_cast<void *>(_data), size);
+    });
+    return detail::ViewTriangleMeshData(data, size, std::move(mapping));
+#else
+    std::ifstream in(_path, std::ios::binary | std::ios::ate);
+    if (!in)
+      return TriangleMeshView();
+
+    const std::streamoff size = in.tellg();
+    if (size <= 0)
+      return TriangleMeshView();
+    in.seekg(0);
+
+    // Words rather than bytes, so the arrays in the buffer are aligned
+    auto buffer = std::make_shared<std::vector<std::uint32_t>>(
+        (static_cast<std::size_t>(size) + 3u) / 4u);
+    if (!in.read(reinterpret_cast<char *>(buffer->data()), size))
+      return TriangleMeshView();
+
+    const void *data = buffer->data();
+    return detail::ViewTriangleMeshData(
+        data, static_cast<std::size_t>(size), std::move(buffer));
+#endif
+  }
+
+  /////////////////////////////////////////////////
+  inline bool WriteTriangleMeshFile(
+      const std::string &_path,
+      const TriangleMeshView &_view)
+  {
+    if (!ValidTriangleMeshView(_view))
+      return false;
+
+    std::ofstream out(_path, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+
+    detail::TriangleMeshHeader header;
+    std::memcpy(header.magic, detail::kTriangleMeshMagic,
+                sizeof(header.magic));
+    header.version = detail::kTriangleMeshVersion;
+    header.vertexCount = _view.vertexCount;
+    header.indexCount = _view.indexCount;
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(_view.vertices),
+              static_cast<std::streamsize>(
+                  _view.vertexCount * 3u * sizeof(float)));
+    out.write(reinterpret_cast<const char *>(_view.indices),
+              static_cast<std::streamsize>(
+                  _view.indexCount * sizeof(std::uint32_t)));
+    return static_cast<bool>(out);
+  }
+}
+}
+}
+
+#endif
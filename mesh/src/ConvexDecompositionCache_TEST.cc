@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gz/common/SubMesh.hh>
+#include <gz/common/Util.hh>
+
+#include <gz/physics/mesh/ConvexDecompositionCache.hh>
+
+using namespace gz;
+using namespace gz::physics;
+
+/////////////////////////////////////////////////
+/// \brief A box of a given size centered at a point.
+static common::SubMesh Box(double _x, double _size)
+{
+  common::SubMesh box;
+  box.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  const double h = 0.5 * _size;
+  for (int i = 0; i < 8; ++i)
+  {
+    box.AddVertex(_x + ((i & 1) ? h : -h), (i & 2) ? h : -h,
+                  (i & 4) ? h : -h);
+  }
+  const unsigned int indices[] = {
+    0, 2, 1,  1, 2, 3,  4, 5, 6,  5, 7, 6,
+    0, 1, 4,  1, 5, 4,  2, 6, 3,  3, 6, 7,
+    0, 4, 2,  2, 4, 6,  1, 3, 5,  3, 7, 5};
+  for (const unsigned int index : indices)
+    box.AddIndex(index);
+  return box;
+}
+
+/////////////////////////////////////////////////
+/// \brief Expect two sets of hulls to have the same vertices and indices.
+static void ExpectEqualHulls(const std::vector<common::SubMesh> &_expected,
+                             const std::vector<common::SubMesh> &_actual)
+{
+  ASSERT_EQ(_expected.size(), _actual.size());
+  for (std::size_t h = 0; h < _expected.size(); ++h)
+  {
+    ASSERT_EQ(_expected[h].VertexCount(), _actual[h].VertexCount());
+    ASSERT_EQ(_expected[h].IndexCount(), _actual[h].IndexCount());
+    for (std::size_t i = 0; i < _expected[h].VertexCount(); ++i)
+      EXPECT_EQ(_expected[h].Vertex(i), _actual[h].Vertex(i));
+    for (std::size_t i = 0; i < _expected[h].IndexCount(); ++i)
+      EXPECT_EQ(_expected[h].Index(i), _actual[h].Index(i));
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Gives each test an empty cache directory, and disables the cache
+/// before and after it.
+class ConvexDecompositionCache : public testing::Test
+{
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    common::unsetenv(mesh::kConvexDecompositionCachePathEnv);
+    this->dir = std::filesystem::temp_directory_path() /
+        ("gz_physics_convex_cache_" +
+         std::string(testing::UnitTest::GetInstance()->current_test_info()
+             ->name()));
+    std::filesystem::remove_all(this->dir);
+    this->path = (this->dir / "hulls.gzcd").string();
+    this->hulls = {Box(0.0, 1.0), Box(2.0, 0.5)};
+  }
+
+  // Documentation inherited
+  protected: void TearDown() override
+  {
+    common::unsetenv(mesh::kConvexDecompositionCachePathEnv);
+    std::filesystem::remove_all(this->dir);
+  }
+
+  /// \brief Cache directory of the test.
+  protected: std::filesystem::path dir;
+
+  /// \brief Path of a cache file in dir.
+  protected: std::string path;
+
+  /// \brief Hulls to write.
+  protected: std::vector<common::SubMesh> hulls;
+};
+
+/////////////////////////////////////////////////
+TEST_F(ConvexDecompositionCache, RoundTrip)
+{
+  ASSERT_TRUE(mesh::WriteConvexDecomposition(this->path, 42u, this->hulls));
+  EXPECT_TRUE(std::filesystem::exists(this->path));
+
+  std::vector<common::SubMesh> read;
+  ASSERT_TRUE(mesh::ReadConvexDecomposition(this->path, 42u, read));
+  ExpectEqualHulls(this->hulls, read);
+
+  // No temporary files are left behind
+  std::size_t files = 0u;
+  for (const auto &entry : std::filesystem::directory_iterator(this->dir))
+  {
+    EXPECT_EQ(this->path, entry.path().string());
+    ++files;
+  }
+  EXPECT_EQ(1u, files);
+
+  // Empty decompositions are cached too
+  ASSERT_TRUE(mesh::WriteConvexDecomposition(this->path, 43u, {}));
+  EXPECT_TRUE(mesh::ReadConvexDecomposition(this->path, 43u, read));
+  EXPECT_TRUE(read.empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ConvexDecompositionCache, CorruptFile)
+{
+  std::vector<common::SubMesh> read = {Box(5.0, 1.0)};
+
+  // A missing file
+  EXPECT_FALSE(mesh::ReadConvexDecomposition(this->path, 42u, read));
+
+  // Truncated files, in the header and in the hulls
+  ASSERT_TRUE(mesh::WriteConvexDecomposition(this->path, 42u, this->hulls));
+  const auto size = std::filesystem::file_size(this->path);
+  for (const auto truncated : {size - 1u, size / 2u, std::uintmax_t{10u}})
+  {
+    ASSERT_TRUE(mesh::WriteConvexDecomposition(this->path, 42u, this->hulls));
+    std::filesystem::resize_file(this->path, truncated);
+    EXPECT_FALSE(mesh::ReadConvexDecomposition(this->path, 42u, read))
+        << truncated;
+  }
+
+  // A file of another format
+  {
+    std::ofstream out(this->path, std::ios::binary | std::ios::trunc);
+    out << "solid cube\nendsolid cube\n";
+  }
+  EXPECT_FALSE(mesh::ReadConvexDecomposition(this->path, 42u, read));
+
+  // A hull with an index out of the range of its vertices
+  common::SubMesh broken = Box(0.0, 1.0);
+  broken.AddIndex(8u);
+  ASSERT_TRUE(mesh::WriteConvexDecomposition(this->path, 42u, {broken}));
+  EXPECT_FALSE(mesh::ReadConvexDecomposition(this->path, 42u, read));
+
+  // Failed reads leave the output alone
+  ASSERT_EQ(1u, read.size());
+  EXPECT_EQ(Box(5.0, 1.0).Vertex(0), read[0].Vertex(0));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ConvexDecompositionCache, KeyAndVersionMismatch)
+{
+  ASSERT_TRUE(mesh::WriteConvexDecomposition(this->path, 42u, this->hulls));
+  std::vector<common::SubMesh> read;
+  EXPECT_FALSE(mesh::ReadConvexDecomposition(this->path, 43u, read));
+  EXPECT_TRUE(read.empty());
+
+  // The version follows the four bytes of the magic
+  {
+    std::fstream file(this->path,
+        std::ios::binary | std::ios::in | std::ios::out);
+    const std::uint32_t version =
+        mesh::detail::kConvexDecompositionVersion + 1u;
+    file.seekp(4);
+    file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+  }
+  EXPECT_FALSE(mesh::ReadConvexDecomposition(this->path, 42u, read));
+  EXPECT_TRUE(read.empty());
+
+  // The key covers the geometry and the decomposition parameters
+  const common::SubMesh box = Box(0.0, 1.0);
+  const std::uint64_t key = mesh::ConvexDecompositionCacheKey(box, 8u);
+  EXPECT_EQ(key, mesh::ConvexDecompositionCacheKey(Box(0.0, 1.0), 8u));
+  EXPECT_NE(key, mesh::ConvexDecompositionCacheKey(box, 4u));
+  EXPECT_NE(key, mesh::ConvexDecompositionCacheKey(Box(0.0, 2.0), 8u));
+  EXPECT_NE(key, mesh::ConvexDecompositionCacheKey(Box(1.0, 1.0), 8u));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ConvexDecompositionCache, CachedDecomposition)
+{
+  const common::SubMesh box = Box(0.0, 1.0);
+  const std::uint64_t key = mesh::ConvexDecompositionCacheKey(box, 4u);
+
+  // The cache is disabled without a directory, and nothing is written
+  EXPECT_TRUE(mesh::detail::ConvexDecompositionCachePath(key).empty());
+  const auto uncached = mesh::CachedConvexDecomposition(box, 4u);
+  EXPECT_FALSE(uncached.empty());
+  EXPECT_FALSE(std::filesystem::exists(this->dir));
+
+  ASSERT_TRUE(common::setenv(mesh::kConvexDecompositionCachePathEnv, ""));
+  EXPECT_TRUE(mesh::detail::ConvexDecompositionCachePath(key).empty());
+
+  // The first decomposition of the cache writes its file
+  ASSERT_TRUE(common::setenv(mesh::kConvexDecompositionCachePathEnv,
+      this->dir.string()));
+  const std::string cachePath =
+      mesh::detail::ConvexDecompositionCachePath(key);
+  ASSERT_FALSE(cachePath.empty());
+  EXPECT_EQ(this->dir, std::filesystem::path(cachePath).parent_path());
+
+  const auto decomposed = mesh::CachedConvexDecomposition(box, 4u);
+  EXPECT_EQ(uncached.size(), decomposed.size());
+  ASSERT_TRUE(std::filesystem::exists(cachePath));
+  std::vector<common::SubMesh> read;
+  EXPECT_TRUE(mesh::ReadConvexDecomposition(cachePath, key, read));
+  ExpectEqualHulls(decomposed, read);
+
+  // Later decompositions read the file rather than decompose again, which
+  // shows as the hulls of the file being returned
+  ASSERT_TRUE(mesh::WriteConvexDecomposition(cachePath, key, this->hulls));
+  ExpectEqualHulls(this->hulls, mesh::CachedConvexDecomposition(box, 4u));
+
+  // A file that cannot be read is replaced by a new decomposition
+  std::filesystem::resize_file(cachePath, 10u);
+  const auto redecomposed = mesh::CachedConvexDecomposition(box, 4u);
+  EXPECT_EQ(uncached.size(), redecomposed.size());
+  EXPECT_TRUE(mesh::ReadConvexDecomposition(cachePath, key, read));
+  ExpectEqualHulls(redecomposed, read);
+}
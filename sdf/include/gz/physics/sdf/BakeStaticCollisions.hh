@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_SDF_BAKESTATICCOLLISIONS_HH_
+#define GZ_PHYSICS_SDF_BAKESTATICCOLLISIONS_HH_
+
+#include <gz/physics/FeatureList.hh>
+
+namespace gz {
+namespace physics {
+namespace sdf {
+
+/// \brief Merge the collisions of static models into a single static
+/// collider per world when the models are constructed from SDF. Worlds with
+/// many static models, e.g. the shelves and walls of a warehouse, then have
+/// one collision object in the broadphase for all of them, and the engine
+/// finds the shapes near a body with a tree over the merged shapes.
+///
+/// The merged collisions remain collision entities of their links, and
+/// contacts and spatial queries report them as usual. They are placed where
+/// their models are constructed and do not follow later changes of the
+/// poses of the static models. Engines may give all merged collisions the
+/// surface properties of the first one.
+///
+/// The setting applies to the models constructed after it is changed.
+class BakeStaticCollisions : public virtual Feature
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+  {
+    /// \brief Set whether the collisions of static models are merged.
+    /// \param[in] _bake True to merge them. The default is false.
+    public: void SetBakeStaticCollisions(bool _bake);
+
+    /// \brief Get whether the collisions of static models are merged.
+    /// \return True if they are merged.
+    public: bool GetBakeStaticCollisions() const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual void SetEngineBakeStaticCollisions(
+        const Identity &_engineID, bool _bake) = 0;
+
+    public: virtual bool GetEngineBakeStaticCollisions(
+        const Identity &_engineID) const = 0;
+  };
+};
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void BakeStaticCollisions::Engine<PolicyT, FeaturesT>::SetBakeStaticCollisions(
+    const bool _bake)
+{
+  this->template Interface<BakeStaticCollisions>()
+      ->SetEngineBakeStaticCollisions(this->identity, _bake);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool BakeStaticCollisions::Engine<PolicyT, FeaturesT>::
+GetBakeStaticCollisions() const
+{
+  return this->template Interface<BakeStaticCollisions>()
+      ->GetEngineBakeStaticCollisions(this->identity);
+}
+
+}
+}
+}
+
+#endif
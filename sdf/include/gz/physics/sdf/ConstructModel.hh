@@ -18,6 +18,8 @@
 #ifndef GZ_PHYSICS_SDF_CONSTRUCTMODEL_HH_
 #define GZ_PHYSICS_SDF_CONSTRUCTMODEL_HH_
 
+#include <vector>
+
 #include <sdf/Model.hh>
 
 #include <gz/physics/FeatureList.hh>
@@ -55,6 +57,58 @@ auto ConstructSdfModel::World<PolicyT, FeaturesT>::ConstructModel(
         this->template Interface<ConstructSdfModel>()
               ->ConstructSdfModel(this->identity, _model));
 }
+
+/// \brief Construct many model entities from sdf::Model DOM objects in one
+/// call. Engines can defer work that they would otherwise repeat for every
+/// model, such as rebalancing their broadphase, to the end of the batch,
+/// which makes spawning many models at once much faster. Like
+/// ConstructSdfModel, this feature is limited to constructing models that
+/// have no nested models.
+class ConstructSdfModels
+    : public virtual FeatureWithRequirements<ConstructSdfModel>
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    public: using ModelPtrType = ModelPtr<PolicyT, FeaturesT>;
+
+    /// \brief Construct models.
+    /// \param[in] _models Models to construct. The objects have to stay
+    /// valid during the call only.
+    /// \return The new models, in the order of _models. Entries of models
+    /// that could not be constructed, or of null entries of _models, are
+    /// null.
+    public: std::vector<ModelPtrType> ConstructModels(
+        const std::vector<const ::sdf::Model *> &_models);
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    /// \brief Construct models, see World::ConstructModels.
+    /// \return Identities of the new models, in the order of _models.
+    public: virtual std::vector<Identity> ConstructSdfModels(
+        const Identity &_world,
+        const std::vector<const ::sdf::Model *> &_models) = 0;
+  };
+};
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ConstructSdfModels::World<PolicyT, FeaturesT>::ConstructModels(
+    const std::vector<const ::sdf::Model *> &_models)
+    -> std::vector<ModelPtrType>
+{
+  const std::vector<Identity> ids =
+      this->template Interface<ConstructSdfModels>()
+          ->ConstructSdfModels(this->identity, _models);
+
+  std::vector<ModelPtrType> result;
+  result.reserve(ids.size());
+  for (const Identity &id : ids)
+    result.emplace_back(this->pimpl, id);
+  return result;
+}
 }
 }
 }
@@ -18,6 +18,9 @@
 #ifndef GZ_PHYSICS_SDF_CONSTRUCTWORLD_HH_
 #define GZ_PHYSICS_SDF_CONSTRUCTWORLD_HH_
 
+#include <chrono>
+#include <cstddef>
+
 #include <sdf/World.hh>
 
 #include <gz/physics/FeatureList.hh>
@@ -54,6 +57,94 @@ auto ConstructSdfWorld::Engine<PolicyT, FeaturesT>::ConstructWorld(
             ->ConstructSdfWorld(this->identity, _world));
 }
 
+/// \brief Construct a world from an sdf::World DOM object across several
+/// calls, so that a real time loop can keep stepping other worlds while a
+/// large world is built.
+///
+/// StartConstructWorld creates the world without its models. Each call to
+/// ContinueConstruction then constructs models in the order of the
+/// sdf::World until its time budget runs out. At least one model is
+/// constructed per call, so construction always progresses. The joints of
+/// the world are constructed once all of its models are. Models are part of
+/// the world as soon as they are constructed, so the world can be stepped
+/// while it is being built.
+class ConstructSdfWorldIncrementally
+    : public virtual FeatureWithRequirements<ConstructSdfWorld>
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+  {
+    public: using WorldPtrType = WorldPtr<PolicyT, FeaturesT>;
+
+    /// \brief Create a world to construct incrementally.
+    /// \param[in] _world World to construct. It has to stay valid until
+    /// the construction of the world is complete.
+    /// \return The world, without any models.
+    public: WorldPtrType StartConstructWorld(const ::sdf::World &_world);
+  };
+
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    /// \brief Construct more models of this world.
+    /// \param[in] _budget Time after which no more models are started.
+    /// \return True if the construction of this world is complete, or if
+    /// the world was not created by StartConstructWorld.
+    public: bool ContinueConstruction(
+        std::chrono::steady_clock::duration _budget);
+
+    /// \brief Get the number of models of the sdf::World of this world that
+    /// remain to be constructed.
+    /// \return Number of models, or 0 if the construction is complete.
+    public: std::size_t GetPendingModelCount() const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    /// \brief Implementation API for StartConstructWorld
+    public: virtual Identity StartConstructSdfWorld(
+        const Identity &_engine, const ::sdf::World &_world) = 0;
+
+    /// \brief Implementation API for ContinueConstruction
+    public: virtual bool ContinueSdfWorldConstruction(
+        const Identity &_world,
+        std::chrono::steady_clock::duration _budget) = 0;
+
+    /// \brief Implementation API for GetPendingModelCount
+    public: virtual std::size_t GetPendingSdfModelCount(
+        const Identity &_world) const = 0;
+  };
+};
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto ConstructSdfWorldIncrementally::Engine<PolicyT, FeaturesT>::
+StartConstructWorld(const ::sdf::World &_world) -> WorldPtrType
+{
+  return WorldPtrType(this->pimpl,
+        this->template Interface<ConstructSdfWorldIncrementally>()
+            ->StartConstructSdfWorld(this->identity, _world));
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool ConstructSdfWorldIncrementally::World<PolicyT, FeaturesT>::
+ContinueConstruction(std::chrono::steady_clock::duration _budget)
+{
+  return this->template Interface<ConstructSdfWorldIncrementally>()
+      ->ContinueSdfWorldConstruction(this->identity, _budget);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+std::size_t ConstructSdfWorldIncrementally::World<PolicyT, FeaturesT>::
+GetPendingModelCount() const
+{
+  return this->template Interface<ConstructSdfWorldIncrementally>()
+      ->GetPendingSdfModelCount(this->identity);
+}
+
 }
 }
 }
@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_SDF_LOADREPORT_HH_
+#define GZ_PHYSICS_SDF_LOADREPORT_HH_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gz/physics/FeatureList.hh>
+
+namespace gz {
+namespace physics {
+namespace sdf {
+
+/// \brief Get a breakdown of the time an engine spent constructing the
+/// entities of a world from SDF, per model. Each model constructed with
+/// ConstructSdfWorld, ConstructSdfModel or ConstructSdfNestedModel is listed
+/// once, and the time spent on its nested models is included in it.
+class GetSdfLoadReport : public virtual Feature
+{
+  /// \brief Time spent in each step of constructing entities from SDF, in
+  /// seconds. Each step excludes the time of the others.
+  public: struct LoadTimes
+  {
+    /// \brief Resolving poses, frames and links of the SDF DOM.
+    double sdfResolutionTime = 0.0;
+
+    /// \brief Loading meshes through the MeshManager.
+    double meshLoadTime = 0.0;
+
+    /// \brief Decomposing meshes into convex hulls.
+    double convexDecompositionTime = 0.0;
+
+    /// \brief Creating the collision shapes of the engine.
+    double shapeCreationTime = 0.0;
+
+    /// \brief Creating bodies and joints and adding them to the engine, and
+    /// any other time not covered by the steps above.
+    double engineInsertionTime = 0.0;
+
+    /// \brief Get the time spent in all of the steps.
+    /// \return Total time in seconds.
+    public: double TotalTime() const
+    {
+      return this->sdfResolutionTime + this->meshLoadTime +
+          this->convexDecompositionTime + this->shapeCreationTime +
+          this->engineInsertionTime;
+    }
+  };
+
+  /// \brief Time spent constructing one model.
+  public: struct ModelLoadTimes
+  {
+    /// \brief Name of the model.
+    std::string name;
+
+    /// \brief Time spent constructing the model and its nested models.
+    LoadTimes times;
+  };
+
+  /// \brief Time spent constructing the entities of a world.
+  public: struct LoadReport
+  {
+    /// \brief Time spent on the world itself, outside of any model, such as
+    /// work an engine does for all models up front.
+    LoadTimes worldTimes;
+
+    /// \brief Time spent on each model, in the order they were constructed.
+    std::vector<ModelLoadTimes> models;
+  };
+
+  /// \brief The World API for getting the load report.
+  public: template <typename PolicyT, typename FeaturesT>
+  class World : public virtual Feature::World<PolicyT, FeaturesT>
+  {
+    /// \brief Get the load report of this world.
+    /// \return Time spent constructing the world and its models from SDF.
+    public: LoadReport GetLoadReport() const;
+  };
+
+  /// \private The implementation API for getting the load report.
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    /// \brief Implementation API for getting the load report.
+    /// \param[in] _worldID Identity of the world.
+    /// \return Time spent constructing the world and its models from SDF.
+    public: virtual LoadReport GetSdfWorldLoadReport(
+        const Identity &_worldID) const = 0;
+  };
+};
+
+/// \brief Helper for plugins implementing GetSdfLoadReport, which charges
+/// the time between calls to the step of the innermost open scope.
+///
+/// A ModelScope opens a model entry in a report, and time inside it is
+/// charged to engine insertion unless a PhaseScope says otherwise. Nested
+/// ModelScopes are folded into the outermost one. A WorldScope charges time
+/// outside of any model to the world entry of a report. Time outside of a
+/// WorldScope or ModelScope is not recorded.
+class LoadTimer
+{
+  /// \brief A step of constructing entities from SDF.
+  public: enum class Phase
+  {
+    SDF_RESOLUTION,
+    MESH_LOADING,
+    CONVEX_DECOMPOSITION,
+    SHAPE_CREATION,
+    ENGINE_INSERTION
+  };
+
+  /// \brief Charge the time spent in a scope to the world entry of a
+  /// report.
+  public: class WorldScope
+  {
+    /// \brief Constructor
+    /// \param[in] _timer Timer to charge.
+    /// \param[in] _report Report of the world.
+    public: WorldScope(LoadTimer &_timer, GetSdfLoadReport::LoadReport &_report)
+      : timer(_timer)
+    {
+      this->timer.Push(&_report.worldTimes, Phase::ENGINE_INSERTION, false);
+    }
+
+    /// \brief Destructor
+    public: ~WorldScope()
+    {
+      this->timer.Pop();
+    }
+
+    private: LoadTimer &timer;
+  };
+
+  /// \brief Charge the time spent in a scope to a new model entry of a
+  /// report, or to the enclosing model if there is one.
+  public: class ModelScope
+  {
+    /// \brief Constructor
+    /// \param[in] _timer Timer to charge.
+    /// \param[in] _report Report of the world the model belongs to.
+    /// \param[in] _name Name of the model.
+    public: ModelScope(LoadTimer &_timer,
+        GetSdfLoadReport::LoadReport &_report, const std::string &_name)
+      : timer(_timer)
+    {
+      if (this->timer.InModel())
+      {
+        this->timer.Push(this->timer.frames.back().times,
+            Phase::ENGINE_INSERTION, true);
+        return;
+      }
+
+      _report.models.push_back({_name, {}});
+      this->timer.Push(&_report.models.back().times,
+          Phase::ENGINE_INSERTION, true);
+    }
+
+    /// \brief Destructor
+    public: ~ModelScope()
+    {
+      this->timer.Pop();
+    }
+
+    private: LoadTimer &timer;
+  };
+
+  /// \brief Charge the time spent in a scope to a step of the enclosing
+  /// world or model.
+  public: class PhaseScope
+  {
+    /// \brief Constructor
+    /// \param[in] _timer Timer to charge.
+    /// \param[in] _phase Step to charge the time to.
+    public: PhaseScope(LoadTimer &_timer, Phase _phase)
+      : timer(_timer)
+    {
+      this->timer.Push(
+          this->timer.frames.empty() ? nullptr :
+              this->timer.frames.back().times,
+          _phase, !this->timer.frames.empty() &&
+              this->timer.frames.back().inModel);
+    }
+
+    /// \brief Destructor
+    public: ~PhaseScope()
+    {
+      this->timer.Pop();
+    }
+
+    private: LoadTimer &timer;
+  };
+
+  /// \brief Call a function, charging the time it takes to a step of the
+  /// enclosing world or model.
+  /// \param[in] _phase Step to charge the time to.
+  /// \param[in] _function Function to call.
+  /// \return The return value of _function.
+  public: template <typename FunctionT>
+  auto Measure(Phase _phase, FunctionT &&_function) -> decltype(_function())
+  {
+    PhaseScope scope(*this, _phase);
+    return _function();
+  }
+
+  /// \brief Whether a ModelScope is open.
+  private: bool InModel() const
+  {
+    return !this->frames.empty() && this->frames.back().inModel;
+  }
+
+  /// \brief Charge the time since the last mark and open a scope.
+  private: void Push(GetSdfLoadReport::LoadTimes *_times, Phase _phase,
+      bool _inModel)
+  {
+    this->Charge();
+    this->frames.push_back({_times, _phase, _inModel});
+  }
+
+  /// \brief Charge the time since the last mark and close a scope.
+  private: void Pop()
+  {
+    this->Charge();
+    this->frames.pop_back();
+  }
+
+  /// \brief Add the time since the last mark to the innermost scope.
+  private: void Charge()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    if (!this->frames.empty() && nullptr != this->frames.back().times)
+    {
+      const double elapsed =
+          std::chrono::duration<double>(now - this->mark).count();
+      auto &times = *this->frames.back().times;
+      switch (this->frames.back().phase)
+      {
+        case Phase::SDF_RESOLUTION:
+          times.sdfResolutionTime += elapsed;
+          break;
+        case Phase::MESH_LOADING:
+          times.meshLoadTime += elapsed;
+          break;
+        case Phase::CONVEX_DECOMPOSITION:
+          times.convexDecompositionTime += elapsed;
+          break;
+        case Phase::SHAPE_CREATION:
+          times.shapeCreationTime += elapsed;
+          break;
+        case Phase::ENGINE_INSERTION:
+        default:
+          times.engineInsertionTime += elapsed;
+          break;
+      }
+    }
+    this->mark = now;
+  }
+
+  /// \brief An open scope.
+  private: struct Frame
+  {
+    /// \brief Times to charge, or nullptr if the time is not recorded.
+    GetSdfLoadReport::LoadTimes *times;
+
+    /// \brief Step to charge.
+    Phase phase;
+
+    /// \brief Whether the scope is inside a ModelScope.
+    bool inModel;
+  };
+
+  /// \brief Open scopes, innermost last.
+  private: std::vector<Frame> frames;
+
+  /// \brief Time up to which the innermost scope has been charged.
+  private: std::chrono::steady_clock::time_point mark;
+};
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+auto GetSdfLoadReport::World<PolicyT, FeaturesT>::GetLoadReport() const
+    -> LoadReport
+{
+  return this->template Interface<GetSdfLoadReport>()
+      ->GetSdfWorldLoadReport(this->identity);
+}
+
+}
+}
+}
+
+#endif
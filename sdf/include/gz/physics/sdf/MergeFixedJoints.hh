@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_SDF_MERGEFIXEDJOINTS_HH_
+#define GZ_PHYSICS_SDF_MERGEFIXEDJOINTS_HH_
+
+#include <gz/physics/FeatureList.hh>
+
+namespace gz {
+namespace physics {
+namespace sdf {
+
+/// \brief Merge the links of a model that are connected by fixed joints
+/// into a single rigid body when the model is constructed from SDF. The
+/// merged body has the combined inertia and the collisions of all of its
+/// links, so models with many fixed joints, e.g. for sensor mounts, cost
+/// less to simulate.
+///
+/// A link is merged into the parent link of its fixed joint if it is not
+/// the canonical link of its model, is the child of no other joint and is
+/// the parent of fixed joints only. The merged links remain link entities
+/// of the model: they can be found by name and their frames follow the
+/// body they were merged into. Their fixed joints are not constructed.
+/// Other link features of a merged link act on the body it was merged into.
+///
+/// The setting applies to the models constructed after it is changed.
+class MergeFixedJoints : public virtual Feature
+{
+  public: template <typename PolicyT, typename FeaturesT>
+  class Engine : public virtual Feature::Engine<PolicyT, FeaturesT>
+  {
+    /// \brief Set whether links connected by fixed joints are merged.
+    /// \param[in] _merge True to merge them. The default is false.
+    public: void SetMergeFixedJoints(bool _merge);
+
+    /// \brief Get whether links connected by fixed joints are merged.
+    /// \return True if they are merged.
+    public: bool GetMergeFixedJoints() const;
+  };
+
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual void SetEngineMergeFixedJoints(
+        const Identity &_engineID, bool _merge) = 0;
+
+    public: virtual bool GetEngineMergeFixedJoints(
+        const Identity &_engineID) const = 0;
+  };
+};
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+void MergeFixedJoints::Engine<PolicyT, FeaturesT>::SetMergeFixedJoints(
+    const bool _merge)
+{
+  this->template Interface<MergeFixedJoints>()
+      ->SetEngineMergeFixedJoints(this->identity, _merge);
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT, typename FeaturesT>
+bool MergeFixedJoints::Engine<PolicyT, FeaturesT>::GetMergeFixedJoints() const
+{
+  return this->template Interface<MergeFixedJoints>()
+      ->GetEngineMergeFixedJoints(this->identity);
+}
+
+}
+}
+}
+
+#endif
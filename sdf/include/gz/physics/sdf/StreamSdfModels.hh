@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+
+#ifndef GZ_PHYSICS_SDF_STREAMSDFMODELS_HH_
+#define GZ_PHYSICS_SDF_STREAMSDFMODELS_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include <gz/math/Pose3.hh>
+#include <sdf/Model.hh>
+#include <sdf/World.hh>
+
+#include <gz/physics/FeatureList.hh>
+#include <gz/physics/FreeGroup.hh>
+#include <gz/physics/ModelStreaming.hh>
+#include <gz/physics/RemoveEntities.hh>
+#include <gz/physics/sdf/ConstructModel.hh>
+
+namespace gz {
+namespace physics {
+namespace sdf {
+
+/// \brief Features that StreamSdfModels needs from a world with the
+/// FeaturePolicy3d policy.
+using StreamSdfModelsFeatures = FeatureList<
+  ConstructSdfModels,
+  RemoveModelFromWorld,
+  FindFreeGroupFeature,
+  FreeGroupFrameSemantics,
+  SetFreeGroupWorldPose,
+  SetFreeGroupWorldVelocity
+>;
+
+/////////////////////////////////////////////////
+/// \brief Add the models of an sdf::World to a ModelStreaming as
+/// placements, centered on the poses of the models. Placement i is the
+/// i-th model of the world, so the models have to be added before any other
+/// placement.
+/// \param[in] _world World whose models are streamed. These models should
+/// not be part of the world that was given to ConstructWorld, which could
+/// e.g. hold the terrain and the robots only.
+/// \param[in,out] _streaming Streaming to add the placements to.
+/// \param[in] _radius Radius of every placement, e.g. of the largest model.
+inline void AddSdfModelPlacements(const ::sdf::World &_world,
+                                  ModelStreaming &_streaming,
+                                  const double _radius = 0.0)
+{
+  for (uint64_t i = 0; i < _world.ModelCount(); ++i)
+  {
+    const ::sdf::Model *model = _world.ModelByIndex(i);
+    math::Pose3d pose;
+    if (!model->SemanticPose().Resolve(pose).empty())
+      pose = model->RawPose();
+    _streaming.AddPlacement(
+        LinearVector3d(pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z()),
+        _radius);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Page the models of an sdf::World in and out of a physics world
+/// around the tracked points of a ModelStreaming, see
+/// AddSdfModelPlacements. Call this before each step, after moving the
+/// tracked points.
+///
+/// The placements of the loaded models that have a free group follow the
+/// models. The models that leave the load radius are removed after their
+/// pose and velocity are saved in the ModelStreaming. The models that come
+/// within it are constructed in one batch with ConstructModels, and get back
+/// the pose and velocity they were removed with. The budget of the
+/// ModelStreaming bounds the number of models constructed and removed per
+/// call, so paging in a dense area is spread over several steps.
+/// \param[in] _world World with StreamSdfModelsFeatures.
+/// \param[in] _sdfWorld World the placements were added from.
+/// \param[in,out] _streaming Streaming of the models.
+/// \param[in,out] _models The model of each loaded placement, by placement
+/// index. It is resized to the number of placements, and entries of
+/// placements that are not loaded are null.
+/// \return Changes applied by this call.
+template <typename WorldPtrT, typename ModelPtrT>
+const ModelStreaming::Changes &StreamSdfModels(
+    const WorldPtrT &_world, const ::sdf::World &_sdfWorld,
+    ModelStreaming &_streaming, std::vector<ModelPtrT> &_models)
+{
+  _models.resize(_streaming.PlacementCount());
+  for (const std::size_t placement : _streaming.LoadedPlacements())
+  {
+    if (!_models[placement])
+      continue;
+    if (auto freeGroup = _models[placement]->FindFreeGroup())
+    {
+      _streaming.MovePlacement(placement,
+          freeGroup->FrameDataRelativeToWorld().pose.translation());
+    }
+  }
+
+  const auto &changes = _streaming.Update();
+  for (const std::size_t placement : changes.unloads)
+  {
+    auto &model = _models[placement];
+    if (!model)
+      continue;
+
+    if (auto freeGroup = model->FindFreeGroup())
+    {
+      const auto data = freeGroup->FrameDataRelativeToWorld();
+      ModelStreaming::State state;
+      state.pose = data.pose;
+      state.linearVelocity = data.linearVelocity;
+      state.angularVelocity = data.angularVelocity;
+      _streaming.SaveState(placement, state);
+    }
+    model->Remove();
+    model = nullptr;
+  }
+
+  if (changes.loads.empty())
+    return changes;
+
+  std::vector<const ::sdf::Model *> sdfModels;
+  sdfModels.reserve(changes.loads.size());
+  for (const std::size_t placement : changes.loads)
+    sdfModels.push_back(_sdfWorld.ModelByIndex(placement));
+
+  auto models = _world->ConstructModels(sdfModels);
+  for (std::size_t i = 0; i < models.size(); ++i)
+  {
+    const std::size_t placement = changes.loads[i];
+    _models[placement] = models[i];
+    const ModelStreaming::State *state = _streaming.SavedState(placement);
+    if (!models[i] || !state)
+      continue;
+
+    if (auto freeGroup = models[i]->FindFreeGroup())
+    {
+      freeGroup->SetWorldPose(state->pose);
+      freeGroup->SetWorldLinearVelocity(state->linearVelocity);
+      freeGroup->SetWorldAngularVelocity(state->angularVelocity);
+    }
+  }
+  return changes;
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+
+#include "gz/physics/AdaptiveTimeStep.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    void AdaptiveTimeStep::SetParameters(const Parameters &_parameters)
+    {
+      this->parameters = _parameters;
+      this->stepSize = 0.0;
+    }
+
+    /////////////////////////////////////////////////
+    auto AdaptiveTimeStep::GetParameters() const -> const Parameters &
+    {
+      return this->parameters;
+    }
+
+    /////////////////////////////////////////////////
+    bool AdaptiveTimeStep::Enabled() const
+    {
+      return this->parameters.maxStepSize > 0.0;
+    }
+
+    /////////////////////////////////////////////////
+    double AdaptiveTimeStep::NextStepSize(const double _minStepSize) const
+    {
+      if (!this->Enabled() || this->parameters.maxStepSize <= _minStepSize)
+        return _minStepSize;
+
+      return std::clamp(this->stepSize, _minStepSize,
+                        this->parameters.maxStepSize);
+    }
+
+    /////////////////////////////////////////////////
+    void AdaptiveTimeStep::Update(const double _stepSize,
+                                  const double _penetration,
+                                  const double _velocityChange)
+    {
+      if (!this->Enabled() || _stepSize <= 0.0)
+        return;
+
+      double ratio = 0.0;
+      if (this->parameters.targetPenetration > 0.0)
+      {
+        ratio = std::max(ratio,
+            _penetration / this->parameters.targetPenetration);
+      }
+      if (this->parameters.targetVelocityChange > 0.0)
+      {
+        ratio = std::max(ratio,
+            _velocityChange / this->parameters.targetVelocityChange);
+      }
+
+      // A quiet step, e.g. of bodies at rest, says nothing about how long
+      // the next one can be, so the step grows as fast as it may
+      double factor = kMaxGrowth;
+      if (ratio * kMaxGrowth > kSafety)
+        factor = std::max(kSafety / ratio, kMaxShrink);
+
+      this->stepSize = std::min(
+          _stepSize * factor, this->parameters.maxStepSize);
+    }
+  }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gz/physics/AdaptiveTimeStep.hh"
+
+using gz::physics::AdaptiveTimeStep;
+
+/////////////////////////////////////////////////
+TEST(AdaptiveTimeStep_TEST, Disabled)
+{
+  AdaptiveTimeStep controller;
+  EXPECT_FALSE(controller.Enabled());
+  EXPECT_DOUBLE_EQ(0.001, controller.NextStepSize(0.001));
+
+  controller.Update(0.001, 0.0, 0.0);
+  EXPECT_DOUBLE_EQ(0.001, controller.NextStepSize(0.001));
+}
+
+/////////////////////////////////////////////////
+TEST(AdaptiveTimeStep_TEST, GrowWhenQuiet)
+{
+  AdaptiveTimeStep controller;
+  AdaptiveTimeStep::Parameters parameters;
+  parameters.maxStepSize = 0.01;
+  controller.SetParameters(parameters);
+  EXPECT_TRUE(controller.Enabled());
+
+  // The first step is the shortest one, and each quiet step grows the next
+  // one until it reaches the maximum
+  double step = controller.NextStepSize(0.001);
+  EXPECT_DOUBLE_EQ(0.001, step);
+  for (int i = 0; i < 3; ++i)
+  {
+    controller.Update(step, 0.0, 0.0);
+    const double next = controller.NextStepSize(0.001);
+    EXPECT_DOUBLE_EQ(step * AdaptiveTimeStep::kMaxGrowth, next);
+    step = next;
+  }
+
+  for (int i = 0; i < 20; ++i)
+  {
+    controller.Update(step, 0.0, 0.0);
+    step = controller.NextStepSize(0.001);
+  }
+  EXPECT_DOUBLE_EQ(parameters.maxStepSize, step);
+
+  // Changing the parameters starts over from the shortest step
+  controller.SetParameters(parameters);
+  EXPECT_DOUBLE_EQ(0.001, controller.NextStepSize(0.001));
+
+  // A maximum that is shorter than the shortest step is ignored
+  EXPECT_DOUBLE_EQ(0.02, controller.NextStepSize(0.02));
+}
+
+/////////////////////////////////////////////////
+TEST(AdaptiveTimeStep_TEST, ShrinkOnError)
+{
+  AdaptiveTimeStep controller;
+  AdaptiveTimeStep::Parameters parameters;
+  parameters.maxStepSize = 0.01;
+  parameters.targetPenetration = 1e-3;
+  parameters.targetVelocityChange = 0.1;
+  controller.SetParameters(parameters);
+
+  // An error on target aims for the safety fraction of it
+  controller.Update(0.008, 1e-3, 0.0);
+  EXPECT_DOUBLE_EQ(0.008 * AdaptiveTimeStep::kSafety,
+                   controller.NextStepSize(0.001));
+
+  // The larger of the two ratios decides
+  controller.Update(0.008, 0.5e-3, 0.2);
+  EXPECT_DOUBLE_EQ(0.008 * AdaptiveTimeStep::kSafety / 2.0,
+                   controller.NextStepSize(0.001));
+
+  // Steps shrink by a bounded factor and never below the shortest step
+  controller.Update(0.008, 1.0, 0.0);
+  EXPECT_DOUBLE_EQ(0.008 * AdaptiveTimeStep::kMaxShrink,
+                   controller.NextStepSize(0.001));
+  controller.Update(0.002, 1.0, 0.0);
+  EXPECT_DOUBLE_EQ(0.001, controller.NextStepSize(0.001));
+
+  // An error well below the target grows the step by a bounded factor
+  controller.Update(0.004, 1e-5, 1e-3);
+  EXPECT_DOUBLE_EQ(0.004 * AdaptiveTimeStep::kMaxGrowth,
+                   controller.NextStepSize(0.001));
+
+  // Targets that are not positive do not limit the step
+  parameters.targetPenetration = 0.0;
+  controller.SetParameters(parameters);
+  controller.Update(0.004, 1.0, 0.0);
+  EXPECT_DOUBLE_EQ(0.004 * AdaptiveTimeStep::kMaxGrowth,
+                   controller.NextStepSize(0.001));
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gz/physics/AllocationCounter.hh"
+
+#if GZ_PHYSICS_COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+  /// \brief Number of allocations made through operator new. The order of
+  /// the increments does not matter, so they are relaxed.
+  std::atomic<std::size_t> gAllocations{0u};
+
+  /// \brief Allocate memory and count the allocation.
+  /// \param[in] _size Bytes to allocate.
+  /// \param[in] _alignment Alignment of the memory, 0 for the default one.
+  /// \return The memory, nullptr if it could not be allocated.
+  void *CountedAlloc(std::size_t _size, std::size_t _alignment)
+  {
+    gAllocations.fetch_add(1u, std::memory_order_relaxed);
+    if (_size == 0u)
+      _size = 1u;
+    if (_alignment == 0u)
+      return std::malloc(_size);
+
+    // aligned_alloc wants a size that is a multiple of the alignment
+    return std::aligned_alloc(
+        _alignment, (_size + _alignment - 1u) / _alignment * _alignment);
+  }
+}
+
+// The replacements override the ones of the C++ runtime for the whole
+// process, as long as this library is loaded before it, which is the order
+// in which the linker lists them. The array and nothrow versions of the
+// runtime call these ones.
+
+/////////////////////////////////////////////////
+void *operator new(std::size_t _size)
+{
+  if (void *ptr = CountedAlloc(_size, 0u))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+/////////////////////////////////////////////////
+void *operator new(std::size_t _size, std::align_val_t _alignment)
+{
+  if (void *ptr = CountedAlloc(_size, static_cast<std::size_t>(_alignment)))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr) noexcept
+{
+  std::free(_ptr);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr, std::size_t) noexcept
+{
+  std::free(_ptr);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr, std::align_val_t) noexcept
+{
+  std::free(_ptr);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr, std::size_t, std::align_val_t) noexcept
+{
+  std::free(_ptr);
+}
+
+#endif
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    std::size_t AllocationCount()
+    {
+#if GZ_PHYSICS_COUNT_ALLOCATIONS
+      return gAllocations.load(std::memory_order_relaxed);
+#else
+      return 0u;
+#endif
+    }
+
+    /////////////////////////////////////////////////
+    bool AllocationCountingEnabled()
+    {
+#if GZ_PHYSICS_COUNT_ALLOCATIONS
+      return true;
+#else
+      return false;
+#endif
+    }
+  }
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "gz/physics/AllocationCounter.hh"
+
+/////////////////////////////////////////////////
+TEST(AllocationCounter_TEST, CountAllocations)
+{
+  const std::size_t before = gz::physics::AllocationCount();
+  auto value = std::make_unique<int>(1);
+  std::vector<double> values(16);
+  const std::size_t after = gz::physics::AllocationCount();
+
+  if (!gz::physics::AllocationCountingEnabled())
+  {
+    EXPECT_EQ(0u, before);
+    EXPECT_EQ(0u, after);
+    return;
+  }
+
+  EXPECT_GE(after - before, 2u);
+
+  // Freeing memory and reusing capacity does not allocate
+  const std::size_t reused = gz::physics::AllocationCount();
+  value.reset();
+  values.clear();
+  values.resize(8);
+  EXPECT_EQ(reused, gz::physics::AllocationCount());
+}
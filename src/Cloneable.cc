@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstddef>
+#include <new>
+
+#include "gz/physics/Cloneable.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    namespace
+    {
+      /// \brief Block sizes are multiples of this
+      constexpr std::size_t kGranularity = 16u;
+
+      /// \brief Number of block sizes which are pooled. Larger objects go
+      /// straight to the global allocator.
+      constexpr std::size_t kNumSizeClasses = 16u;
+
+      /// \brief Maximum number of free blocks kept per size and thread
+      constexpr std::size_t kMaxFreeBlocks = 1024u;
+
+      /// \brief A free block, linked to the next free block of its size
+      struct FreeBlock
+      {
+        FreeBlock *next;
+      };
+
+      /// \brief Free blocks of one thread. This is trivially destructible so
+      /// that it stays usable while the other thread locals and the statics
+      /// of the main thread are being destroyed.
+      struct FreeLists
+      {
+        FreeBlock *heads[kNumSizeClasses];
+        std::size_t counts[kNumSizeClasses];
+
+        /// \brief True once the thread has started exiting. Blocks returned
+        /// after that are freed instead of kept.
+        bool exiting;
+      };
+
+      thread_local FreeLists tFreeLists = {};
+
+      /////////////////////////////////////////////////
+      void ReleaseFreeLists(FreeLists &_lists)
+      {
+        for (std::size_t c = 0; c < kNumSizeClasses; ++c)
+        {
+          while (_lists.heads[c])
+          {
+            FreeBlock *block = _lists.heads[c];
+            _lists.heads[c] = block->next;
+            ::operator delete(block);
+          }
+          _lists.counts[c] = 0u;
+        }
+      }
+
+      /// \brief Frees the blocks of a thread when it exits
+      struct FreeListsReaper
+      {
+        ~FreeListsReaper()
+        {
+          ReleaseFreeLists(tFreeLists);
+          tFreeLists.exiting = true;
+        }
+      };
+
+      thread_local FreeListsReaper tFreeListsReaper;
+
+      /////////////////////////////////////////////////
+      /// \brief Size class of an object, or kNumSizeClasses if it is not
+      /// pooled
+      std::size_t SizeClass(std::size_t _size)
+      {
+        if (_size > kGranularity * kNumSizeClasses)
+          return kNumSizeClasses;
+
+        return (_size + kGranularity - 1u) / kGranularity - 1u;
+      }
+    }
+
+    namespace detail
+    {
+      /////////////////////////////////////////////////
+      void *AllocateCloneable(std::size_t _size, std::size_t _align)
+      {
+        if (_align > alignof(std::max_align_t))
+          return ::operator new(_size, std::align_val_t(_align));
+
+        const std::size_t c = SizeClass(_size);
+        if (c == kNumSizeClasses)
+          return ::operator new(_size);
+
+        FreeLists &lists = tFreeLists;
+        if (FreeBlock *block = lists.heads[c])
+        {
+          lists.heads[c] = block->next;
+          --lists.counts[c];
+          return block;
+        }
+
+        // Make sure this thread frees its free lists when it exits
+        (void)(&tFreeListsReaper);
+        return ::operator new((c + 1u) * kGranularity);
+      }
+
+      /////////////////////////////////////////////////
+      void DeallocateCloneable(
+          void *_ptr, std::size_t _size, std::size_t _align)
+      {
+        if (nullptr == _ptr)
+          return;
+
+        if (_align > alignof(std::max_align_t))
+        {
+          ::operator delete(_ptr, std::align_val_t(_align));
+          return;
+        }
+
+        const std::size_t c = SizeClass(_size);
+        FreeLists &lists = tFreeLists;
+        if (c == kNumSizeClasses || lists.exiting ||
+            lists.counts[c] >= kMaxFreeBlocks)
+        {
+          ::operator delete(_ptr);
+          return;
+        }
+
+        // Blocks of another thread are adopted by this one
+        (void)(&tFreeListsReaper);
+        auto *block = static_cast<FreeBlock*>(_ptr);
+        block->next = lists.heads[c];
+        lists.heads[c] = block;
+        ++lists.counts[c];
+      }
+    }
+
+    /////////////////////////////////////////////////
+    void ReleaseCloneableMemory()
+    {
+      ReleaseFreeLists(tFreeLists);
+    }
+  }
+}
@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <memory>
+
 #include "gz/physics/Cloneable.hh"
 #include "test/TestDataTypes.hh"
 
@@ -172,3 +175,45 @@ TEST(Cloneable_TEST, Copy)
   copyTo->Copy(std::move(*moveFrom));
   EXPECT_EQ("movingFrom", copyToCasted->myString);
 }
+
+/////////////////////////////////////////////////
+struct alignas(64) OverAlignedData
+{
+  double value = 1.0;
+};
+
+/////////////////////////////////////////////////
+TEST(Cloneable_TEST, PooledMemory)
+{
+  // Memory of destroyed objects is reused for objects of the same size
+  void *first = nullptr;
+  {
+    std::unique_ptr<Cloneable> data(new MakeCloneable<StringData>("pooled"));
+    first = data.get();
+  }
+  {
+    std::unique_ptr<Cloneable> data(new MakeCloneable<StringData>("again"));
+    EXPECT_EQ(first, data.get());
+    EXPECT_EQ("again", static_cast<StringData&>(
+      static_cast<MakeCloneable<StringData>&>(*data)).myString);
+
+    std::unique_ptr<Cloneable> clone = data->Clone();
+    EXPECT_NE(data.get(), clone.get());
+    EXPECT_EQ("again", static_cast<StringData&>(
+      static_cast<MakeCloneable<StringData>&>(*clone)).myString);
+  }
+
+  // Over-aligned types bypass the pools but keep their alignment
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    auto aligned = std::make_unique<MakeCloneable<OverAlignedData>>();
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(aligned.get()) % 64u);
+    EXPECT_DOUBLE_EQ(1.0, aligned->value);
+  }
+
+  // Allocation still works after the free lists are released
+  physics::ReleaseCloneableMemory();
+  std::unique_ptr<Cloneable> data(new MakeCloneable<StringData>());
+  EXPECT_EQ("default", static_cast<StringData&>(
+    static_cast<MakeCloneable<StringData>&>(*data)).myString);
+}
@@ -15,8 +15,10 @@
  *
 */
 
+#include <algorithm>
 #include <cassert>
 #include <utility>
+#include <vector>
 
 #include "gz/physics/CompositeData.hh"
 
@@ -44,18 +46,37 @@ namespace gz
         const CompositeData::MapOfData::iterator &_receiver,
         std::size_t &_numEntries, std::size_t &_numQueries)
     {
-      if (!_receiver->second.required)
+      // Entries without data, such as the expected entries of a SpecifyData,
+      // are not counted, so there is nothing to remove.
+      if (!_receiver->second.required && _receiver->second.data)
       {
         // If the data isn't required, delete it
         _receiver->second.data.reset();
+        _receiver->second.lent = false;
         --_numEntries;
         RemoveQuery(_receiver, _numQueries);
       }
     }
 
+    /////////////////////////////////////////////////
+    /// \brief Get the instance that a copy of an entry should hold. The
+    /// instance of an entry which has been lent out may still be modified
+    /// through a reference obtained earlier, so it is cloned instead of shared.
+    static std::shared_ptr<Cloneable> ShareData(
+        const CompositeData::DataEntry &_sender)
+    {
+      if (_sender.lent)
+        return _sender.data->Clone();
+
+      return _sender.data;
+    }
+
     /////////////////////////////////////////////////
     /// \brief Use this to copy data efficiently from one existing data instance
-    /// to another existing data instance
+    /// to another existing data instance. An instance which only the receiver
+    /// holds is copied into, so references to it stay valid. An instance which
+    /// is shared with other entries must not be modified, so the receiver
+    /// shares the instance of the sender instead.
     template <typename SenderType>
     static void StandardDataCopy(
         const CompositeData::MapOfData::iterator &_receiver,
@@ -64,14 +85,19 @@ namespace gz
         std::size_t &/*_numEntries*/,
         std::size_t &/*_numQueries*/)
     {
-      _receiver->second.data->Copy(*_sender->second.data);
+      if (_receiver->second.data.use_count() > 1)
+        _receiver->second.data = ShareData(_sender->second);
+      else
+        _receiver->second.data->Copy(*_sender->second.data);
+
       if (_mergeRequirements && _sender->second.required)
         _receiver->second.required = true;
     }
 
     /////////////////////////////////////////////////
-    /// \brief Use this to clone data into a map entry which has an entry for
-    /// the data type but does not currently have an instance
+    /// \brief Use this to share data with a map entry which has an entry for
+    /// the data type but does not currently have an instance. The instance is
+    /// cloned when either entry modifies it.
     template <typename SenderType>
     static void StandardDataClone(
         const CompositeData::MapOfData::iterator &_receiver,
@@ -85,15 +111,16 @@ namespace gz
              "This should not be possible! Please report this bug!");
 
       _receiver->second = CompositeData::DataEntry(
-            _sender->second.data->Clone(),
+            ShareData(_sender->second),
             _mergeRequirements && _sender->second.required);
 
       ++_numEntries;
     }
 
     /////////////////////////////////////////////////
-    /// \brief Use this to create a new data entry and instance for a map which
-    /// did not previously contain an entry for the data type
+    /// \brief Use this to create a new data entry, sharing the instance of the
+    /// sender, for a map which did not previously contain an entry for the
+    /// data type
     template <typename SenderType>
     static void StandardDataCreate(
         CompositeData::MapOfData &_toMap,
@@ -105,7 +132,7 @@ namespace gz
             std::make_pair(
               _sender->first,
               CompositeData::DataEntry(
-                _sender->second.data->Clone(),
+                ShareData(_sender->second),
                 _mergeRequirements && _sender->second.required))).second;
 
       (void)(inserted);
@@ -133,6 +160,7 @@ namespace gz
       _receiver->second.data = std::move(_sender->second.data);
       _receiver->second.required =
           _mergeRequirements && _sender->second.required;
+      _receiver->second.lent = _sender->second.lent;
     }
 
     /////////////////////////////////////////////////
@@ -145,13 +173,15 @@ namespace gz
         const bool _mergeRequirements,
         std::size_t &_numEntries)
     {
-      const bool inserted = _toMap.insert(
+      const auto result = _toMap.insert(
             std::make_pair(
               _sender->first,
               CompositeData::DataEntry(
-                std::unique_ptr<Cloneable>(_sender->second.data.release()),
-                _mergeRequirements && _sender->second.required))).second;
+                std::move(_sender->second.data),
+                _mergeRequirements && _sender->second.required)));
+      result.first->second.lent = _sender->second.lent;
 
+      const bool inserted = result.second;
       (void)(inserted);
       assert(inserted &&
              "Calling MoveDataCreate on a data entry that already exists. This "
@@ -281,10 +311,38 @@ namespace gz
       }
     }
 
+    /////////////////////////////////////////////////
+    /// \brief Index the entries that a copy or merge took from another
+    /// CompositeData by the keys that the sender indexed them by, so that
+    /// const lookups of their types find them without searching the map.
+    static void IndexCopiedEntries(
+        std::vector<CompositeData::IndexEntry> &_index,
+        CompositeData::MapOfData &_toMap,
+        const std::vector<CompositeData::IndexEntry> &_fromIndex)
+    {
+      for (const CompositeData::IndexEntry &indexed : _fromIndex)
+      {
+        const bool known = std::any_of(_index.begin(), _index.end(),
+            [&indexed](const CompositeData::IndexEntry &_entry)
+            {
+              return _entry.key == indexed.key;
+            });
+        if (known)
+          continue;
+
+        // The name is taken from the entry of the sender, since the key may
+        // belong to a library which has been unloaded since.
+        const auto it = _toMap.find(indexed.entry->first);
+        if (_toMap.end() != it)
+          _index.push_back(CompositeData::IndexEntry{indexed.key, &*it});
+      }
+    }
+
     /////////////////////////////////////////////////
     CompositeData::CompositeData()
       : numEntries(0),
-        numQueries(0)
+        numQueries(0),
+        queryTracking(true)
     {
       // Do nothing
     }
@@ -325,6 +383,18 @@ namespace gz
         entry.second.queried = false;
     }
 
+    /////////////////////////////////////////////////
+    void CompositeData::SetQueryTracking(const bool _enabled)
+    {
+      this->queryTracking = _enabled;
+    }
+
+    /////////////////////////////////////////////////
+    bool CompositeData::QueryTrackingEnabled() const
+    {
+      return this->queryTracking;
+    }
+
     /////////////////////////////////////////////////
     std::set<std::string> CompositeData::AllEntries() const
     {
@@ -373,6 +443,8 @@ namespace gz
             &StandardDataClone<SenderType>,
             &StandardDataCreate<SenderType>);
 
+      IndexCopiedEntries(this->dataIndex, this->dataMap, _other.dataIndex);
+
       return *this;
     }
 
@@ -390,6 +462,8 @@ namespace gz
             &MoveData<SenderType>,
             &MoveDataCreate<SenderType>);
 
+      IndexCopiedEntries(this->dataIndex, this->dataMap, _other.dataIndex);
+
       return *this;
     }
 
@@ -407,6 +481,8 @@ namespace gz
             &StandardDataClone<SenderType>,
             &StandardDataCreate<SenderType>);
 
+      IndexCopiedEntries(this->dataIndex, this->dataMap, _other.dataIndex);
+
       return *this;
     }
 
@@ -424,6 +500,8 @@ namespace gz
             &MoveData<SenderType>,
             &MoveDataCreate<SenderType>);
 
+      IndexCopiedEntries(this->dataIndex, this->dataMap, _other.dataIndex);
+
       return *this;
     }
 
@@ -431,6 +509,7 @@ namespace gz
     CompositeData::CompositeData(const CompositeData &_other)
       : CompositeData()
     {
+      this->queryTracking = _other.queryTracking;
       this->Copy(_other);
     }
 
@@ -438,6 +517,7 @@ namespace gz
     CompositeData::CompositeData(CompositeData &&_other)
       : CompositeData()
     {
+      this->queryTracking = _other.queryTracking;
       this->Copy(std::move(_other));
     }
 
@@ -456,18 +536,20 @@ namespace gz
     /////////////////////////////////////////////////
     CompositeData::DataEntry::DataEntry()
       : required(false),
-        queried(false)
+        queried(false),
+        lent(false)
     {
       // Do nothing
     }
 
     /////////////////////////////////////////////////
     CompositeData::DataEntry::DataEntry(
-        std::unique_ptr<Cloneable> &&_data,
+        std::shared_ptr<Cloneable> _data,
         bool _required)
       : data(std::move(_data)),
         required(_required),
-        queried(false)
+        queried(false),
+        lent(false)
     {
       // Do nothing
     }
@@ -581,3 +581,230 @@ TEST(CompositeData_TEST, Queries)
   EXPECT_NE(0u, all.count(typeid(IntData).name()));
   EXPECT_NE(0u, all.count(typeid(BoolData).name()));
 }
+
+/////////////////////////////////////////////////
+TEST(CompositeData_TEST, RepeatedLookups)
+{
+  physics::CompositeData data;
+  data.Get<StringData>().myString = "first";
+  EXPECT_EQ(nullptr, data.Query<DoubleData>());
+
+  // Lookups of types that were seen before, including types that had no
+  // entry at the time, must still see later changes.
+  data.Get<DoubleData>().myDouble = 1.5;
+  ASSERT_NE(nullptr, data.Query<DoubleData>());
+  EXPECT_DOUBLE_EQ(1.5, data.Query<DoubleData>()->myDouble);
+  EXPECT_EQ("first", data.Get<StringData>().myString);
+
+  // Copies and moves must refer to their own entries
+  physics::CompositeData copy(data);
+  copy.Get<StringData>().myString = "copy";
+  EXPECT_EQ("first", data.Get<StringData>().myString);
+  EXPECT_EQ("copy", copy.Get<StringData>().myString);
+
+  physics::CompositeData assigned;
+  assigned.Get<IntData>().myInt = 3;
+  assigned = copy;
+  EXPECT_FALSE(assigned.Has<IntData>());
+  EXPECT_EQ("copy", assigned.Get<StringData>().myString);
+  assigned.InsertOrAssign<IntData>().data.myInt = 4;
+  EXPECT_EQ(4, assigned.Get<IntData>().myInt);
+
+  physics::CompositeData moved(std::move(copy));
+  EXPECT_EQ("copy", moved.Get<StringData>().myString);
+  EXPECT_TRUE(data.Remove<StringData>());
+  EXPECT_FALSE(data.Has<StringData>());
+  EXPECT_TRUE(moved.Has<StringData>());
+}
+
+/////////////////////////////////////////////////
+TEST(CompositeData_TEST, CopyOnWrite)
+{
+  physics::CompositeData source;
+  source.Get<StringData>().myString = "shared";
+  source.Get<IntData>().myInt = 1;
+
+  // The entries of source were lent out through Get, so a copy of it clones
+  // them
+  physics::CompositeData data(source);
+  const physics::CompositeData &constSource = source;
+  EXPECT_NE(constSource.Query<StringData>(),
+            static_cast<const physics::CompositeData&>(data)
+              .Query<StringData>());
+
+  // Copies share the data which was not lent out until it is modified
+  physics::CompositeData copy(data);
+  const physics::CompositeData &constData = data;
+  const physics::CompositeData &constCopy = copy;
+  EXPECT_EQ(constData.Query<StringData>(), constCopy.Query<StringData>());
+  EXPECT_EQ(constData.Query<IntData>(), constCopy.Query<IntData>());
+
+  copy.Get<StringData>().myString = "copy";
+  EXPECT_NE(constData.Query<StringData>(), constCopy.Query<StringData>());
+  EXPECT_EQ("shared", constData.Query<StringData>()->myString);
+  EXPECT_EQ("copy", constCopy.Query<StringData>()->myString);
+
+  // The entries which were not modified are still shared
+  EXPECT_EQ(constData.Query<IntData>(), constCopy.Query<IntData>());
+
+  // Every mutable access gives the entry its own instance
+  physics::CompositeData inserted(data);
+  EXPECT_FALSE(inserted.Insert<IntData>(5).inserted);
+  EXPECT_NE(constData.Query<IntData>(), inserted.Query<IntData>());
+  EXPECT_EQ(1, inserted.Get<IntData>().myInt);
+
+  physics::CompositeData assigned(data);
+  assigned.InsertOrAssign<IntData>(2);
+  EXPECT_EQ(1, data.Get<IntData>().myInt);
+  EXPECT_EQ(2, assigned.Get<IntData>().myInt);
+
+  physics::CompositeData queried(data);
+  queried.Query<IntData>()->myInt = 3;
+  EXPECT_EQ(1, data.Get<IntData>().myInt);
+
+  physics::CompositeData required(data);
+  required.MakeRequired<IntData>().myInt = 4;
+  EXPECT_EQ(1, data.Get<IntData>().myInt);
+
+  // Copying into an instance which is not shared copies the values, so
+  // references to it stay valid
+  StringData &copyString = copy.Get<StringData>();
+  copy = data;
+  EXPECT_EQ("shared", copyString.myString);
+  EXPECT_EQ(&copyString, copy.Query<StringData>());
+
+  // Merging shares the instances that the receiver does not have yet
+  physics::CompositeData merged;
+  merged.Merge(data);
+  EXPECT_EQ(constData.Query<StringData>(),
+            static_cast<const physics::CompositeData&>(merged)
+              .Query<StringData>());
+  merged.Get<StringData>().myString = "merged";
+  EXPECT_EQ("shared", data.Get<StringData>().myString);
+}
+
+/////////////////////////////////////////////////
+TEST(CompositeData_TEST, QueryTracking)
+{
+  physics::CompositeData data;
+  EXPECT_TRUE(data.QueryTrackingEnabled());
+  data.Get<StringData>();
+  data.ResetQueries();
+
+  // Without tracking, reads and writes leave the flags alone
+  data.SetQueryTracking(false);
+  EXPECT_FALSE(data.QueryTrackingEnabled());
+  data.Get<StringData>().myString = "untracked";
+  data.Insert<IntData>(3);
+  data.InsertOrAssign<DoubleData>(1.0);
+  EXPECT_NE(nullptr, data.Query<IntData>());
+  EXPECT_EQ(3u, data.EntryCount());
+  EXPECT_EQ(3u, data.UnqueriedEntryCount());
+  EXPECT_FALSE(data.StatusOf<StringData>().queried);
+
+  // Copy and move construction take the setting, assignment does not
+  physics::CompositeData copy(data);
+  EXPECT_FALSE(copy.QueryTrackingEnabled());
+  EXPECT_EQ("untracked", copy.Get<StringData>().myString);
+  physics::CompositeData moved(std::move(copy));
+  EXPECT_FALSE(moved.QueryTrackingEnabled());
+  physics::CompositeData assigned;
+  assigned = data;
+  EXPECT_TRUE(assigned.QueryTrackingEnabled());
+  assigned.Get<StringData>();
+  EXPECT_EQ(2u, assigned.UnqueriedEntryCount());
+
+  // Tracking resumes with the flags as they were
+  data.SetQueryTracking(true);
+  data.Get<StringData>();
+  EXPECT_EQ(2u, data.UnqueriedEntryCount());
+  EXPECT_TRUE(data.StatusOf<StringData>().queried);
+}
+
+/////////////////////////////////////////////////
+/// \brief Exposes the size of the type index of a CompositeData
+class IndexedData : public physics::CompositeData
+{
+  public: std::size_t IndexSize() const
+  {
+    return this->dataIndex.size();
+  }
+};
+
+/////////////////////////////////////////////////
+TEST(CompositeData_TEST, ConstLookupsLeaveIndex)
+{
+  IndexedData data;
+  data.Get<StringData>().myString = "indexed";
+  data.Insert<IntData>(3);
+  EXPECT_EQ(2u, data.IndexSize());
+
+  // Copies index the entries that the sender indexed
+  IndexedData copy;
+  copy.Copy(data);
+  EXPECT_EQ(2u, copy.IndexSize());
+  IndexedData merged;
+  merged.Get<DoubleData>();
+  merged.Merge(data);
+  EXPECT_EQ(3u, merged.IndexSize());
+
+  // Const lookups find the entries without writing to the index
+  const IndexedData &constCopy = copy;
+  ASSERT_NE(nullptr, constCopy.Query<StringData>());
+  EXPECT_EQ("indexed", constCopy.Query<StringData>()->myString);
+  EXPECT_TRUE(constCopy.Has<IntData>());
+  EXPECT_FALSE(constCopy.Has<DoubleData>());
+  EXPECT_EQ(2u, copy.IndexSize());
+
+  // Entries that a merge adds are indexed as well
+  physics::CompositeData plain;
+  plain.Get<CharData>().myChar = 'c';
+  static_cast<physics::CompositeData &>(copy).Merge(plain);
+  EXPECT_EQ(3u, copy.IndexSize());
+  EXPECT_EQ('c', constCopy.Query<CharData>()->myChar);
+  EXPECT_EQ(3u, copy.IndexSize());
+}
+
+/////////////////////////////////////////////////
+TEST(CompositeData_TEST, CopyAfterReference)
+{
+  // A reference obtained before a copy may still be written through, so the
+  // copy must not see the change
+  physics::CompositeData data;
+  IntData &i = data.Get<IntData>();
+  i.myInt = 1;
+  physics::CompositeData copy(data);
+  i.myInt = 5;
+  EXPECT_EQ(1, copy.Get<IntData>().myInt);
+  EXPECT_EQ(5, data.Get<IntData>().myInt);
+
+  // The same holds for the other mutable accessors
+  StringData &s = data.Insert<StringData>("original").data;
+  physics::CompositeData inserted(data);
+  s.myString = "changed";
+  EXPECT_EQ("original", inserted.Get<StringData>().myString);
+
+  physics::CompositeData queried(data);
+  data.Query<IntData>()->myInt = 6;
+  EXPECT_EQ(5, queried.Get<IntData>().myInt);
+
+  // A copy of a copy can share its data, since nothing was lent out yet,
+  // and references taken from either of them after the copy stay separate
+  physics::CompositeData first(data);
+  physics::CompositeData second(first);
+  IntData &firstInt = first.Get<IntData>();
+  firstInt.myInt = 7;
+  EXPECT_EQ(6, second.Get<IntData>().myInt);
+  physics::CompositeData third(first);
+  firstInt.myInt = 8;
+  EXPECT_EQ(7, third.Get<IntData>().myInt);
+
+  // Merging and assigning follow the same rules
+  physics::CompositeData merged;
+  merged.Merge(data);
+  physics::CompositeData assigned;
+  assigned = data;
+  i.myInt = 9;
+  EXPECT_EQ(6, merged.Get<IntData>().myInt);
+  EXPECT_EQ(6, assigned.Get<IntData>().myInt);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+
+#include <algorithm>
+
+#include "gz/physics/EntityChangeJournal.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    EntityChangeJournal::EntityChangeJournal(const std::size_t _capacity)
+      : capacity(std::max<std::size_t>(_capacity, 1u))
+    {
+    }
+
+    /////////////////////////////////////////////////
+    void EntityChangeJournal::Record(
+        const EntityChange::Type _type, const EntityChange::Kind _kind,
+        const std::size_t _entity, const std::size_t _related)
+    {
+      // Dropping half of the changes at once keeps the cost of a record
+      // constant on average.
+      if (this->changes.size() >= 2u * this->capacity)
+      {
+        this->changes.erase(this->changes.begin(),
+            this->changes.begin() + static_cast<std::ptrdiff_t>(
+                this->capacity));
+        this->begin += this->capacity;
+      }
+
+      this->changes.push_back({_type, _kind, _entity, _related});
+    }
+
+    /////////////////////////////////////////////////
+    bool EntityChangeJournal::Read(
+        std::size_t &_cursor, std::vector<EntityChange> &_changes) const
+    {
+      const bool complete = _cursor >= this->begin;
+      const std::size_t first =
+          std::min(std::max(_cursor, this->begin), this->End()) - this->begin;
+
+      _changes.assign(
+          this->changes.begin() + static_cast<std::ptrdiff_t>(first),
+          this->changes.end());
+      _cursor = this->End();
+      return complete;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t EntityChangeJournal::End() const
+    {
+      return this->begin + this->changes.size();
+    }
+  }
+}
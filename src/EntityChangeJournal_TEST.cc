@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "gz/physics/EntityChangeJournal.hh"
+
+using gz::physics::EntityChange;
+using gz::physics::EntityChangeJournal;
+
+/////////////////////////////////////////////////
+TEST(EntityChangeJournal_TEST, ReadFromCursor)
+{
+  EntityChangeJournal journal;
+  EXPECT_EQ(0u, journal.End());
+
+  std::size_t cursor = 0u;
+  std::vector<EntityChange> changes;
+  EXPECT_TRUE(journal.Read(cursor, changes));
+  EXPECT_TRUE(changes.empty());
+  EXPECT_EQ(0u, cursor);
+
+  journal.Record(EntityChange::Type::CREATED, EntityChange::Kind::MODEL,
+                 5u, 1u);
+  journal.Record(EntityChange::Type::CREATED, EntityChange::Kind::LINK,
+                 6u, 5u);
+  EXPECT_EQ(2u, journal.End());
+
+  EXPECT_TRUE(journal.Read(cursor, changes));
+  ASSERT_EQ(2u, changes.size());
+  EXPECT_EQ(2u, cursor);
+  EXPECT_EQ(EntityChange::Type::CREATED, changes[0].type);
+  EXPECT_EQ(EntityChange::Kind::MODEL, changes[0].kind);
+  EXPECT_EQ(5u, changes[0].entity);
+  EXPECT_EQ(1u, changes[0].related);
+  EXPECT_EQ(EntityChange::Kind::LINK, changes[1].kind);
+  EXPECT_EQ(6u, changes[1].entity);
+  EXPECT_EQ(5u, changes[1].related);
+
+  // Nothing new since the last read
+  EXPECT_TRUE(journal.Read(cursor, changes));
+  EXPECT_TRUE(changes.empty());
+  EXPECT_EQ(2u, cursor);
+
+  journal.Record(EntityChange::Type::REMOVED, EntityChange::Kind::MODEL,
+                 5u, 1u);
+  EXPECT_TRUE(journal.Read(cursor, changes));
+  ASSERT_EQ(1u, changes.size());
+  EXPECT_EQ(EntityChange::Type::REMOVED, changes[0].type);
+  EXPECT_EQ(3u, cursor);
+
+  // A second client with its own cursor sees every change
+  std::size_t otherCursor = 0u;
+  EXPECT_TRUE(journal.Read(otherCursor, changes));
+  EXPECT_EQ(3u, changes.size());
+  EXPECT_EQ(3u, otherCursor);
+}
+
+/////////////////////////////////////////////////
+TEST(EntityChangeJournal_TEST, DropOldChanges)
+{
+  EntityChangeJournal journal(4u);
+  std::size_t cursor = 0u;
+  std::vector<EntityChange> changes;
+
+  for (std::size_t i = 0u; i < 8u; ++i)
+  {
+    journal.Record(EntityChange::Type::CREATED, EntityChange::Kind::JOINT,
+                   i, 100u);
+  }
+
+  // Twice the capacity is still kept
+  EXPECT_TRUE(journal.Read(cursor, changes));
+  EXPECT_EQ(8u, changes.size());
+  EXPECT_EQ(8u, cursor);
+
+  std::size_t lateCursor = 2u;
+  journal.Record(EntityChange::Type::ATTACHED, EntityChange::Kind::JOINT,
+                 8u, 101u);
+  EXPECT_EQ(9u, journal.End());
+
+  // The client that kept up misses nothing
+  EXPECT_TRUE(journal.Read(cursor, changes));
+  ASSERT_EQ(1u, changes.size());
+  EXPECT_EQ(EntityChange::Type::ATTACHED, changes[0].type);
+  EXPECT_EQ(9u, cursor);
+
+  // Changes 2 and 3 were dropped, so the late client has to rescan
+  EXPECT_FALSE(journal.Read(lateCursor, changes));
+  ASSERT_EQ(5u, changes.size());
+  EXPECT_EQ(4u, changes.front().entity);
+  EXPECT_EQ(8u, changes.back().entity);
+  EXPECT_EQ(9u, lateCursor);
+
+  // A cursor past the end reads nothing
+  std::size_t futureCursor = 20u;
+  EXPECT_TRUE(journal.Read(futureCursor, changes));
+  EXPECT_TRUE(changes.empty());
+  EXPECT_EQ(9u, futureCursor);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+
+// The explicit instantiations that are declared extern in the headers of the
+// core library. Engine plugins all link to these, so the common interfaces
+// are compiled once here instead of once in every plugin.
+
+#include <gz/physics/Feature.hh>
+#include <gz/physics/ForwardStep.hh>
+#include <gz/physics/FrameData.hh>
+#include <gz/physics/FrameSemantics.hh>
+#include <gz/physics/FreeGroup.hh>
+#include <gz/physics/GetEntities.hh>
+#include <gz/physics/RemoveEntities.hh>
+#include <gz/physics/World.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    template struct FrameData<double, 3>;
+    template struct FrameData<double, 2>;
+    template struct FrameData<float, 3>;
+    template struct FrameData<float, 2>;
+
+    template class Feature::Implementation<FeaturePolicy3d>;
+    template class Feature::Implementation<FeaturePolicy2d>;
+    template class Feature::Implementation<FeaturePolicy3f>;
+    template class Feature::Implementation<FeaturePolicy2f>;
+
+    template class GetEngineInfo::Implementation<FeaturePolicy3d>;
+    template class GetWorldFromEngine::Implementation<FeaturePolicy3d>;
+    template class GetModelFromWorld::Implementation<FeaturePolicy3d>;
+    template class GetNestedModelFromModel::Implementation<FeaturePolicy3d>;
+    template class GetLinkFromModel::Implementation<FeaturePolicy3d>;
+    template class GetJointFromModel::Implementation<FeaturePolicy3d>;
+    template class GetShapeFromLink::Implementation<FeaturePolicy3d>;
+
+    template class FrameSemantics::Implementation<FeaturePolicy3d>;
+    template class ForwardStep::Implementation<FeaturePolicy3d>;
+    template class Gravity::Implementation<FeaturePolicy3d>;
+
+    template class FindFreeGroupFeature::Implementation<FeaturePolicy3d>;
+    template class SetFreeGroupWorldPose::Implementation<FeaturePolicy3d>;
+    template class SetFreeGroupWorldVelocity::Implementation<FeaturePolicy3d>;
+
+    template class RemoveModelFromWorld::Implementation<FeaturePolicy3d>;
+    template class RemoveNestedModelFromModel::Implementation<
+        FeaturePolicy3d>;
+  }
+}
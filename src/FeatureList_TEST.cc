@@ -239,3 +239,17 @@ TEST(FeatureList_TEST, Hierarchy)
   EXPECT_TRUE((detail::TupleContainsBase<Conflict1, Level3Tuple>::value));
   EXPECT_TRUE((detail::TupleContainsBase<Conflict2, Level3Tuple>::value));
 }
+
+TEST(FeatureList_TEST, TupleIndex)
+{
+  // Entities use these indices to find the cached implementation of a feature
+  using List = FeatureList<RequiresFeatureA, FeatureB>;
+  using Features = List::Features;
+  EXPECT_EQ(0u, (detail::TupleIndex<RequiresFeatureA, Features>::value));
+  EXPECT_EQ(1u, (detail::TupleIndex<FeatureA, Features>::value));
+  EXPECT_EQ(2u, (detail::TupleIndex<FeatureB, Features>::value));
+
+  // Features that are not in the list map to the size of the tuple
+  EXPECT_EQ(std::tuple_size_v<Features>,
+            (detail::TupleIndex<FeatureC, Features>::value));
+}
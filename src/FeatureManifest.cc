@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+#include <gz/physics/detail/FeatureManifest.hh>
+
+namespace gz
+{
+  namespace physics
+  {
+    namespace detail
+    {
+      namespace
+      {
+        /////////////////////////////////////////////////
+        /// \brief Get the name that gz::plugin::Loader reports for a type.
+        std::string DemangledName(const std::type_info &_type)
+        {
+#ifdef __GNUG__
+          int status = 0;
+          char *demangled = abi::__cxa_demangle(
+                _type.name(), nullptr, nullptr, &status);
+          if (status == 0 && demangled)
+          {
+            std::string name(demangled);
+            std::free(demangled);
+            return name;
+          }
+          std::free(demangled);
+          return _type.name();
+#else
+          std::string name = _type.name();
+          for (const std::string prefix : {"class ", "struct "})
+          {
+            if (name.compare(0, prefix.size(), prefix) == 0)
+              return name.substr(prefix.size());
+          }
+          return name;
+#endif
+        }
+
+        /////////////////////////////////////////////////
+        /// \brief Process-wide registry of the feature manifests. Types are
+        /// keyed by their name rather than by their std::type_info, since
+        /// each plugin library may have its own copy of the type_info.
+        struct Manifests
+        {
+          std::mutex mutex;
+
+          /// \brief Bit of each implementation interface, by mangled name.
+          std::unordered_map<std::string, std::size_t> interfaceBits;
+
+          /// \brief Manifest of each plugin, by mangled name.
+          std::unordered_map<std::string, std::shared_ptr<const FeatureSet>>
+              byType;
+
+          /// \brief Manifest of each plugin, by demangled name.
+          std::unordered_map<std::string, std::shared_ptr<const FeatureSet>>
+              byName;
+        };
+
+        /////////////////////////////////////////////////
+        Manifests &GetManifests()
+        {
+          // Never destroyed, so that plugin libraries may still use it while
+          // they are unloaded during static destruction.
+          static Manifests *manifests = new Manifests;
+          return *manifests;
+        }
+      }
+
+      /////////////////////////////////////////////////
+      void FeatureSet::Insert(const std::size_t _bit)
+      {
+        const std::size_t word = _bit / 64u;
+        if (this->words.size() <= word)
+          this->words.resize(word + 1u, 0u);
+
+        this->words[word] |= std::uint64_t(1u) << (_bit % 64u);
+      }
+
+      /////////////////////////////////////////////////
+      void FeatureSet::Insert(const FeatureSet &_other)
+      {
+        if (this->words.size() < _other.words.size())
+          this->words.resize(_other.words.size(), 0u);
+
+        for (std::size_t i = 0; i < _other.words.size(); ++i)
+          this->words[i] |= _other.words[i];
+      }
+
+      /////////////////////////////////////////////////
+      bool FeatureSet::Contains(const std::size_t _bit) const
+      {
+        const std::size_t word = _bit / 64u;
+        if (this->words.size() <= word)
+          return false;
+
+        return (this->words[word] >> (_bit % 64u)) & 1u;
+      }
+
+      /////////////////////////////////////////////////
+      bool FeatureSet::Contains(const FeatureSet &_other) const
+      {
+        for (std::size_t i = 0; i < _other.words.size(); ++i)
+        {
+          const std::uint64_t mine =
+              i < this->words.size() ? this->words[i] : 0u;
+          if ((_other.words[i] & ~mine) != 0u)
+            return false;
+        }
+
+        return true;
+      }
+
+      /////////////////////////////////////////////////
+      std::size_t FeatureManifests::InterfaceBit(
+          const std::type_info &_interface)
+      {
+        Manifests &manifests = GetManifests();
+        std::lock_guard<std::mutex> lock(manifests.mutex);
+        return manifests.interfaceBits.emplace(
+              _interface.name(), manifests.interfaceBits.size())
+            .first->second;
+      }
+
+      /////////////////////////////////////////////////
+      void FeatureManifests::Register(
+          const std::type_info &_plugin, const FeatureSet &_features)
+      {
+        const std::string name = DemangledName(_plugin);
+
+        Manifests &manifests = GetManifests();
+        std::lock_guard<std::mutex> lock(manifests.mutex);
+
+        auto manifest = std::make_shared<FeatureSet>(_features);
+        const auto existing = manifests.byType.find(_plugin.name());
+        if (existing != manifests.byType.end())
+          manifest->Insert(*existing->second);
+
+        manifests.byType[_plugin.name()] = manifest;
+        manifests.byName[name] = manifest;
+      }
+
+      /////////////////////////////////////////////////
+      void FeatureManifests::Register(
+          const std::type_info &_plugin,
+          const std::type_info *const *_interfaces,
+          const std::size_t _count)
+      {
+        FeatureSet features;
+        for (std::size_t i = 0; i < _count; ++i)
+          features.Insert(InterfaceBit(*_interfaces[i]));
+
+        Register(_plugin, features);
+      }
+
+      /////////////////////////////////////////////////
+      std::shared_ptr<const FeatureSet> FeatureManifests::Find(
+          const std::type_info &_plugin)
+      {
+        Manifests &manifests = GetManifests();
+        std::lock_guard<std::mutex> lock(manifests.mutex);
+        const auto it = manifests.byType.find(_plugin.name());
+        if (it == manifests.byType.end())
+          return nullptr;
+
+        return it->second;
+      }
+
+      /////////////////////////////////////////////////
+      std::shared_ptr<const FeatureSet> FeatureManifests::Find(
+          const std::string &_pluginName)
+      {
+        Manifests &manifests = GetManifests();
+        std::lock_guard<std::mutex> lock(manifests.mutex);
+        const auto it = manifests.byName.find(_pluginName);
+        if (it == manifests.byName.end())
+          return nullptr;
+
+        return it->second;
+      }
+    }
+  }
+}
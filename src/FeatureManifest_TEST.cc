@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <gz/physics/GetEntities.hh>
+#include <gz/physics/Implements.hh>
+#include <gz/physics/detail/FeatureManifest.hh>
+
+using namespace gz;
+using namespace physics;
+
+/////////////////////////////////////////////////
+class FeatureA : public virtual Feature
+{
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual void A() = 0;
+  };
+};
+
+/////////////////////////////////////////////////
+class FeatureB : public virtual Feature
+{
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual void B() = 0;
+  };
+};
+
+/////////////////////////////////////////////////
+/// \brief Plugin types are only used for their names
+class ManifestPlugin { };
+class OtherManifestPlugin { };
+
+using ListA = FeatureList<GetEngineInfo, FeatureA>;
+using ListAB = FeatureList<ListA, FeatureB>;
+
+/////////////////////////////////////////////////
+template <typename FeatureListT>
+const detail::FeatureSet &SetOf()
+{
+  return detail::FeatureSetOf<FeaturePolicy3d,
+      typename detail::ExpandFeatures<FeatureListT>::type>::Get();
+}
+
+/////////////////////////////////////////////////
+TEST(FeatureManifest_TEST, FeatureSet)
+{
+  detail::FeatureSet empty;
+  EXPECT_TRUE(empty.Contains(empty));
+  EXPECT_FALSE(empty.Contains(0u));
+
+  detail::FeatureSet low;
+  low.Insert(3u);
+  EXPECT_TRUE(low.Contains(3u));
+  EXPECT_FALSE(low.Contains(4u));
+  EXPECT_TRUE(low.Contains(empty));
+  EXPECT_FALSE(empty.Contains(low));
+
+  // Bits past the first word
+  detail::FeatureSet high;
+  high.Insert(130u);
+  EXPECT_TRUE(high.Contains(130u));
+  EXPECT_FALSE(high.Contains(66u));
+  EXPECT_FALSE(low.Contains(high));
+  EXPECT_FALSE(high.Contains(low));
+
+  detail::FeatureSet both = low;
+  both.Insert(high);
+  EXPECT_TRUE(both.Contains(low));
+  EXPECT_TRUE(both.Contains(high));
+  EXPECT_FALSE(low.Contains(both));
+}
+
+/////////////////////////////////////////////////
+TEST(FeatureManifest_TEST, InterfaceBits)
+{
+  const std::size_t a = detail::FeatureManifests::InterfaceBit(
+      typeid(FeatureA::Implementation<FeaturePolicy3d>));
+  const std::size_t b = detail::FeatureManifests::InterfaceBit(
+      typeid(FeatureB::Implementation<FeaturePolicy3d>));
+  EXPECT_NE(a, b);
+  EXPECT_EQ(a, detail::FeatureManifests::InterfaceBit(
+      typeid(FeatureA::Implementation<FeaturePolicy3d>)));
+
+  // Each policy has its own implementation interface
+  EXPECT_NE(a, detail::FeatureManifests::InterfaceBit(
+      typeid(FeatureA::Implementation<FeaturePolicy3f>)));
+
+  EXPECT_TRUE(SetOf<FeatureA>().Contains(a));
+  EXPECT_FALSE(SetOf<FeatureA>().Contains(b));
+
+  // Nested lists are flattened
+  EXPECT_TRUE(SetOf<ListAB>().Contains(SetOf<ListA>()));
+  EXPECT_TRUE(SetOf<ListAB>().Contains(SetOf<FeatureB>()));
+  EXPECT_FALSE(SetOf<ListA>().Contains(SetOf<ListAB>()));
+}
+
+/////////////////////////////////////////////////
+TEST(FeatureManifest_TEST, Register)
+{
+  using Manifests = detail::FeatureManifests;
+
+  EXPECT_EQ(nullptr, Manifests::Find(typeid(OtherManifestPlugin)));
+  EXPECT_EQ(nullptr, Manifests::Find(std::string("OtherManifestPlugin")));
+
+  Manifests::Register(typeid(ManifestPlugin), SetOf<ListA>());
+
+  auto manifest = Manifests::Find(typeid(ManifestPlugin));
+  ASSERT_NE(nullptr, manifest);
+  EXPECT_EQ(manifest, Manifests::Find(std::string("ManifestPlugin")));
+  EXPECT_TRUE(manifest->Contains(SetOf<ListA>()));
+  EXPECT_FALSE(manifest->Contains(SetOf<FeatureB>()));
+
+  // Registering the same plugin again adds to its manifest
+  Manifests::Register(typeid(ManifestPlugin), SetOf<FeatureB>());
+  manifest = Manifests::Find(typeid(ManifestPlugin));
+  ASSERT_NE(nullptr, manifest);
+  EXPECT_TRUE(manifest->Contains(SetOf<ListAB>()));
+
+  EXPECT_EQ(nullptr, Manifests::Find(typeid(OtherManifestPlugin)));
+}
+
+/////////////////////////////////////////////////
+TEST(FeatureManifest_TEST, RegisterInterfaces)
+{
+  using Manifests = detail::FeatureManifests;
+
+  class InterfacePlugin { };
+  const std::type_info *const interfaces[] = {
+    &typeid(FeatureA::Implementation<FeaturePolicy3d>),
+    &typeid(FeatureB::Implementation<FeaturePolicy3d>)
+  };
+
+  // Only the first _count interfaces are registered
+  Manifests::Register(typeid(InterfacePlugin), interfaces, 1u);
+  auto manifest = Manifests::Find(typeid(InterfacePlugin));
+  ASSERT_NE(nullptr, manifest);
+  EXPECT_TRUE(manifest->Contains(SetOf<FeatureA>()));
+  EXPECT_FALSE(manifest->Contains(SetOf<FeatureB>()));
+
+  Manifests::Register(typeid(InterfacePlugin), interfaces, 2u);
+  manifest = Manifests::Find(typeid(InterfacePlugin));
+  ASSERT_NE(nullptr, manifest);
+  EXPECT_TRUE(manifest->Contains(SetOf<FeatureB>()));
+  EXPECT_FALSE(manifest->Contains(SetOf<ListA>()));
+}
@@ -115,3 +115,38 @@ TEST(Feature_TEST, SimpleMock)
 
   EXPECT_EQ(3u, missing.size());
 }
+
+/////////////////////////////////////////////////
+TEST(Feature_TEST, GenerateIdentityReference)
+{
+  class RefImplementation : detail::Implementation
+  {
+    public: Identity Generate(
+        std::size_t _id, const std::shared_ptr<int> &_ref) const
+    {
+      return this->Implementation::GenerateIdentity(_id, _ref);
+    }
+
+    public: Identity Generate(
+        std::size_t _id, std::shared_ptr<void> &&_ref) const
+    {
+      return this->Implementation::GenerateIdentity(_id, std::move(_ref));
+    }
+  };
+
+  RefImplementation impl;
+  const auto value = std::make_shared<int>(5);
+
+  // The converted reference is moved into the identity, so only the identity
+  // holds a reference besides value.
+  const Identity converted = impl.Generate(1, value);
+  EXPECT_EQ(1u, converted.id);
+  EXPECT_EQ(value.get(), converted.ref.get());
+  EXPECT_EQ(2, value.use_count());
+
+  std::shared_ptr<void> ref = value;
+  const Identity moved = impl.Generate(2, std::move(ref));
+  EXPECT_EQ(nullptr, ref);
+  EXPECT_EQ(value.get(), moved.ref.get());
+  EXPECT_EQ(3, value.use_count());
+}
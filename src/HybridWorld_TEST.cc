@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gz/physics/HybridWorld.hh"
+
+using gz::physics::ForwardStep;
+using gz::physics::FrameData3d;
+using gz::physics::Pose3d;
+
+// The worlds below stand in for the entities of physics engines, with only
+// the functions that HybridWorld calls.
+
+/////////////////////////////////////////////////
+struct MockShape
+{
+  std::size_t id;
+  std::size_t EntityID() const { return this->id; }
+};
+
+/////////////////////////////////////////////////
+struct MockLink
+{
+  FrameData3d data;
+  std::vector<std::shared_ptr<MockShape>> shapes;
+
+  FrameData3d FrameDataRelativeToWorld() const { return this->data; }
+  std::size_t GetShapeCount() const { return this->shapes.size(); }
+  std::shared_ptr<MockShape> GetShape(std::size_t _index) const
+  {
+    return this->shapes[_index];
+  }
+};
+
+/////////////////////////////////////////////////
+struct MockFreeGroup
+{
+  Pose3d pose = Pose3d::Identity();
+  Eigen::Vector3d linearVelocity = Eigen::Vector3d::Zero();
+  Eigen::Vector3d angularVelocity = Eigen::Vector3d::Zero();
+
+  void SetWorldPose(const Pose3d &_pose) { this->pose = _pose; }
+  void SetWorldLinearVelocity(const Eigen::Vector3d &_velocity)
+  {
+    this->linearVelocity = _velocity;
+  }
+  void SetWorldAngularVelocity(const Eigen::Vector3d &_velocity)
+  {
+    this->angularVelocity = _velocity;
+  }
+};
+
+/////////////////////////////////////////////////
+struct MockModel
+{
+  bool kinematic = false;
+  std::vector<std::shared_ptr<MockLink>> links;
+  std::shared_ptr<MockFreeGroup> freeGroup =
+      std::make_shared<MockFreeGroup>();
+
+  void SetKinematic(bool _kinematic) { this->kinematic = _kinematic; }
+  std::size_t GetLinkCount() const { return this->links.size(); }
+  std::shared_ptr<MockLink> GetLink(std::size_t _index) const
+  {
+    return _index < this->links.size() ? this->links[_index] : nullptr;
+  }
+  std::shared_ptr<MockFreeGroup> FindFreeGroup() const
+  {
+    return this->freeGroup;
+  }
+};
+
+/////////////////////////////////////////////////
+struct MockContactBatch
+{
+  std::size_t size = 0u;
+  const std::size_t *collision1 = nullptr;
+  const std::size_t *collision2 = nullptr;
+  const Eigen::Vector3d *point = nullptr;
+  const Eigen::Vector3d *force = nullptr;
+};
+
+/////////////////////////////////////////////////
+struct MockWorld
+{
+  std::map<std::string, std::shared_ptr<MockModel>> models;
+  std::vector<std::size_t> collision1;
+  std::vector<std::size_t> collision2;
+  std::vector<Eigen::Vector3d> point;
+  std::vector<Eigen::Vector3d> force;
+
+  /// \brief Pose of the first proxy when the world was stepped.
+  std::vector<Pose3d> steppedPoses;
+
+  std::shared_ptr<MockModel> GetModel(const std::string &_name) const
+  {
+    auto it = this->models.find(_name);
+    return it == this->models.end() ? nullptr : it->second;
+  }
+
+  void Step(ForwardStep::Output &, ForwardStep::State &,
+            const ForwardStep::Input &)
+  {
+    auto it = this->models.find("person");
+    if (it != this->models.end())
+      this->steppedPoses.push_back(it->second->freeGroup->pose);
+  }
+
+  MockContactBatch GetContactBatchFromLastStep() const
+  {
+    MockContactBatch batch;
+    batch.size = this->collision1.size();
+    batch.collision1 = this->collision1.data();
+    batch.collision2 = this->collision2.data();
+    batch.point = this->point.data();
+    batch.force = this->force.data();
+    return batch;
+  }
+
+  void AddContact(std::size_t _shape1, std::size_t _shape2,
+                  const Eigen::Vector3d &_force)
+  {
+    this->collision1.push_back(_shape1);
+    this->collision2.push_back(_shape2);
+    this->point.push_back(Eigen::Vector3d(1, 2, 3));
+    this->force.push_back(_force);
+  }
+};
+
+/////////////////////////////////////////////////
+std::shared_ptr<MockModel> Model(const std::vector<std::size_t> &_shapes)
+{
+  auto model = std::make_shared<MockModel>();
+  auto link = std::make_shared<MockLink>();
+  for (const std::size_t id : _shapes)
+    link->shapes.push_back(std::make_shared<MockShape>(MockShape{id}));
+  model->links.push_back(link);
+  return model;
+}
+
+using Hybrid = gz::physics::HybridWorld<
+    std::shared_ptr<MockWorld>, std::shared_ptr<MockWorld>>;
+
+/////////////////////////////////////////////////
+TEST(HybridWorld_TEST, Proxies)
+{
+  auto dynamic = std::make_shared<MockWorld>();
+  auto kinematic = std::make_shared<MockWorld>();
+  dynamic->models["person"] = Model({10, 11});
+  dynamic->models["robot"] = Model({20});
+  kinematic->models["person"] = Model({100});
+
+  FrameData3d &data = kinematic->models["person"]->links[0]->data;
+  data.pose.translation() = Eigen::Vector3d(1, 0, 0);
+  data.linearVelocity = Eigen::Vector3d(0.5, 0, 0);
+  data.angularVelocity = Eigen::Vector3d(0, 0, 0.1);
+
+  Hybrid hybrid(dynamic, kinematic);
+  EXPECT_FALSE(hybrid.AddProxy("robot"));
+  EXPECT_FALSE(hybrid.AddProxy("missing"));
+  ASSERT_TRUE(hybrid.AddProxy("person"));
+  EXPECT_FALSE(hybrid.AddProxy("person"));
+  EXPECT_EQ(1u, hybrid.GetProxyCount());
+
+  // The proxy is kinematic and at the pose of the kinematic model
+  const auto &person = dynamic->models["person"];
+  EXPECT_TRUE(person->kinematic);
+  EXPECT_FALSE(dynamic->models["robot"]->kinematic);
+  EXPECT_TRUE(person->freeGroup->pose.isApprox(data.pose));
+  EXPECT_TRUE(person->freeGroup->linearVelocity.isApprox(
+      data.linearVelocity));
+  EXPECT_TRUE(person->freeGroup->angularVelocity.isApprox(
+      data.angularVelocity));
+
+  // The proxy follows the kinematic model before each step
+  data.pose.translation() = Eigen::Vector3d(2, 0, 0);
+  ForwardStep::Output dynamicOutput;
+  ForwardStep::Output kinematicOutput;
+  ForwardStep::Input input;
+  hybrid.Step(dynamicOutput, kinematicOutput, input);
+  ASSERT_EQ(1u, dynamic->steppedPoses.size());
+  EXPECT_TRUE(dynamic->steppedPoses[0].isApprox(data.pose));
+  EXPECT_EQ(1u, kinematic->steppedPoses.size());
+
+  EXPECT_TRUE(hybrid.RemoveProxy("person"));
+  EXPECT_FALSE(hybrid.RemoveProxy("person"));
+  EXPECT_FALSE(person->kinematic);
+  EXPECT_EQ(0u, hybrid.GetProxyCount());
+}
+
+/////////////////////////////////////////////////
+TEST(HybridWorld_TEST, ProxyContacts)
+{
+  auto dynamic = std::make_shared<MockWorld>();
+  auto kinematic = std::make_shared<MockWorld>();
+  dynamic->models["person"] = Model({10, 11});
+  dynamic->models["friend"] = Model({12});
+  dynamic->models["robot"] = Model({20});
+  kinematic->models["person"] = Model({100});
+  kinematic->models["friend"] = Model({101});
+
+  Hybrid hybrid(dynamic, kinematic);
+  ASSERT_TRUE(hybrid.AddProxy("person"));
+  ASSERT_TRUE(hybrid.AddProxy("friend"));
+
+  // Only contacts between a proxy and another body are exchanged
+  dynamic->AddContact(10, 20, Eigen::Vector3d(0, 0, 1));
+  dynamic->AddContact(20, 12, Eigen::Vector3d(1, 0, 0));
+  dynamic->AddContact(11, 12, Eigen::Vector3d(0, 1, 0));
+  dynamic->AddContact(20, 20, Eigen::Vector3d(0, 1, 0));
+
+  ForwardStep::Output dynamicOutput;
+  ForwardStep::Output kinematicOutput;
+  ForwardStep::Input input;
+  hybrid.Step(dynamicOutput, kinematicOutput, input);
+
+  const auto &contacts = hybrid.GetProxyContacts();
+  ASSERT_EQ(2u, contacts.size());
+  EXPECT_EQ("person", contacts[0].proxy);
+  EXPECT_EQ(10u, contacts[0].proxyShape);
+  EXPECT_EQ(20u, contacts[0].otherShape);
+  EXPECT_TRUE(contacts[0].point.isApprox(Eigen::Vector3d(1, 2, 3)));
+  EXPECT_TRUE(contacts[0].force.isApprox(Eigen::Vector3d(0, 0, 1)));
+
+  // The force is the one acting on the proxy
+  EXPECT_EQ("friend", contacts[1].proxy);
+  EXPECT_EQ(12u, contacts[1].proxyShape);
+  EXPECT_EQ(20u, contacts[1].otherShape);
+  EXPECT_TRUE(contacts[1].force.isApprox(Eigen::Vector3d(-1, 0, 0)));
+
+  // Shapes of removed proxies are ordinary bodies again
+  ASSERT_TRUE(hybrid.RemoveProxy("person"));
+  hybrid.Step(dynamicOutput, kinematicOutput, input);
+  ASSERT_EQ(2u, hybrid.GetProxyContacts().size());
+  EXPECT_EQ("friend", hybrid.GetProxyContacts()[0].proxy);
+  EXPECT_EQ(11u, hybrid.GetProxyContacts()[1].otherShape);
+}
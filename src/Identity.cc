@@ -15,6 +15,8 @@
  *
 */
 
+#include <utility>
+
 #include <gz/physics/Entity.hh>
 
 namespace gz
@@ -31,6 +33,14 @@ namespace gz
         return Identity(_id, _ref);
       }
 
+      /////////////////////////////////////////////////
+      Identity Implementation::GenerateIdentity(
+          std::size_t _id,
+          std::shared_ptr<void> &&_ref) const
+      {
+        return Identity(_id, std::move(_ref));
+      }
+
       /////////////////////////////////////////////////
       Identity Implementation::GenerateInvalidId() const
       {
@@ -74,5 +84,15 @@ namespace gz
     {
       // Do nothing
     }
+
+    /////////////////////////////////////////////////
+    Identity::Identity(
+        std::size_t _id,
+        std::shared_ptr<void> &&_ref)
+      : id(_id),
+        ref(std::move(_ref))
+    {
+      // Do nothing
+    }
   }
 }
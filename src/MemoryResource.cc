@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "gz/physics/MemoryResource.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    MemoryResource::~MemoryResource() = default;
+
+    /// \brief Smallest size class, in bytes.
+    static constexpr std::size_t kMinClassSize = 16u;
+
+    /// \brief Largest size class, in bytes.
+    static constexpr std::size_t kMaxClassSize = 4096u;
+
+    /// \brief Size of a huge page, in bytes.
+    static constexpr std::size_t kHugePageSize = std::size_t(1u) << 21;
+
+    /////////////////////////////////////////////////
+    /// \brief Round a size up to a power of 2.
+    static std::size_t RoundUpToPowerOf2(std::size_t _size)
+    {
+      std::size_t power = 1u;
+      while (power < _size)
+        power <<= 1u;
+      return power;
+    }
+
+    /////////////////////////////////////////////////
+    class ArenaMemoryResourcePrivate
+    {
+      /// \brief Get the size class of an allocation.
+      /// \param[in] _bytes Size of the allocation.
+      /// \param[in] _alignment Alignment of the allocation.
+      /// \return Index of the size class, or classes.size() if the
+      /// allocation is passed through.
+      public: std::size_t ClassOf(std::size_t _bytes,
+                                  std::size_t _alignment) const;
+
+      /// \brief Carve a slot of a size class out of the current block,
+      /// starting a new block if it is full.
+      /// \param[in] _size Size of the class.
+      /// \return Slot.
+      public: void *Carve(std::size_t _size);
+
+      /// \brief See ArenaMemoryResource::GetOptions.
+      public: ArenaMemoryResource::Options options;
+
+      /// \brief Alignment of the blocks.
+      public: std::size_t blockAlignment = kMaxClassSize;
+
+      /// \brief Guards everything below.
+      public: mutable std::mutex mutex;
+
+      /// \brief Freed slots of each size class, linked through their first
+      /// bytes. Class i holds slots of kMinClassSize << i bytes.
+      public: std::vector<void *> freeLists;
+
+      /// \brief Blocks, in the order they were allocated.
+      public: std::vector<void *> blocks;
+
+      /// \brief Bytes carved out of the last block.
+      public: std::size_t blockUsed = 0u;
+
+      /// \brief Passed through allocations that were not freed, with their
+      /// size and alignment.
+      public: std::unordered_map<void *, std::pair<std::size_t, std::size_t>>
+          large;
+
+      /// \brief Bytes of the passed through allocations.
+      public: std::size_t largeBytes = 0u;
+
+      /// \brief See ArenaMemoryResource::GetBytesInUse.
+      public: std::size_t bytesInUse = 0u;
+    };
+
+    /////////////////////////////////////////////////
+    std::size_t ArenaMemoryResourcePrivate::ClassOf(
+        const std::size_t _bytes, const std::size_t _alignment) const
+    {
+      const std::size_t size = std::max({_bytes, _alignment, kMinClassSize});
+      if (size > this->options.maxPooledSize)
+        return this->freeLists.size();
+
+      std::size_t index = 0u;
+      while ((kMinClassSize << index) < size)
+        ++index;
+      return index;
+    }
+
+    /////////////////////////////////////////////////
+    void *ArenaMemoryResourcePrivate::Carve(const std::size_t _size)
+    {
+      // Slots are aligned to their size, which the blocks are aligned to
+      std::size_t offset = (this->blockUsed + _size - 1u) & ~(_size - 1u);
+      if (this->blocks.empty() || offset + _size > this->options.blockSize)
+      {
+        void *block = ::operator new(this->options.blockSize,
+            std::align_val_t(this->blockAlignment));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (this->options.hugePages)
+          madvise(block, this->options.blockSize, MADV_HUGEPAGE);
+#endif
+        if (this->options.firstTouch)
+          this->options.firstTouch(block, this->options.blockSize);
+        this->blocks.push_back(block);
+        offset = 0u;
+      }
+
+      this->blockUsed = offset + _size;
+      return static_cast<char *>(this->blocks.back()) + offset;
+    }
+
+    /////////////////////////////////////////////////
+    ArenaMemoryResource::ArenaMemoryResource()
+      : ArenaMemoryResource(Options())
+    {
+    }
+
+    /////////////////////////////////////////////////
+    ArenaMemoryResource::ArenaMemoryResource(const Options &_options)
+      : dataPtr(new ArenaMemoryResourcePrivate)
+    {
+      auto &d = *this->dataPtr;
+      d.options = _options;
+      d.options.maxPooledSize = RoundUpToPowerOf2(std::clamp(
+          _options.maxPooledSize, kMinClassSize, kMaxClassSize));
+      d.options.blockSize =
+          std::max(_options.blockSize, d.options.maxPooledSize);
+#ifdef __linux__
+      if (d.options.hugePages)
+      {
+        d.blockAlignment = kHugePageSize;
+        d.options.blockSize = (d.options.blockSize + kHugePageSize - 1u) &
+            ~(kHugePageSize - 1u);
+      }
+#else
+      d.options.hugePages = false;
+#endif
+
+      std::size_t classes = 0u;
+      while ((kMinClassSize << classes) <= d.options.maxPooledSize)
+        ++classes;
+      d.freeLists.assign(classes, nullptr);
+    }
+
+    /////////////////////////////////////////////////
+    ArenaMemoryResource::~ArenaMemoryResource()
+    {
+      auto &d = *this->dataPtr;
+      for (void *block : d.blocks)
+        ::operator delete(block, std::align_val_t(d.blockAlignment));
+      for (const auto &[ptr, layout] : d.large)
+        ::operator delete(ptr, std::align_val_t(layout.second));
+    }
+
+    /////////////////////////////////////////////////
+    void *ArenaMemoryResource::Allocate(
+        const std::size_t _bytes, const std::size_t _alignment)
+    {
+      auto &d = *this->dataPtr;
+      const std::size_t index = d.ClassOf(_bytes, _alignment);
+      if (index == d.freeLists.size())
+      {
+        void *ptr = ::operator new(_bytes, std::align_val_t(_alignment));
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.large.emplace(ptr, std::make_pair(_bytes, _alignment));
+        d.largeBytes += _bytes;
+        d.bytesInUse += _bytes;
+        return ptr;
+      }
+
+      const std::size_t size = kMinClassSize << index;
+      std::lock_guard<std::mutex> lock(d.mutex);
+      d.bytesInUse += size;
+      if (void *slot = d.freeLists[index])
+      {
+        d.freeLists[index] = *static_cast<void **>(slot);
+        return slot;
+      }
+      return d.Carve(size);
+    }
+
+    /////////////////////////////////////////////////
+    void ArenaMemoryResource::Deallocate(
+        void *_ptr, const std::size_t _bytes, const std::size_t _alignment)
+    {
+      if (!_ptr)
+        return;
+
+      auto &d = *this->dataPtr;
+      const std::size_t index = d.ClassOf(_bytes, _alignment);
+      if (index == d.freeLists.size())
+      {
+        {
+          std::lock_guard<std::mutex> lock(d.mutex);
+          d.large.erase(_ptr);
+          d.largeBytes -= _bytes;
+          d.bytesInUse -= _bytes;
+        }
+        ::operator delete(_ptr, std::align_val_t(_alignment));
+        return;
+      }
+
+      std::lock_guard<std::mutex> lock(d.mutex);
+      d.bytesInUse -= kMinClassSize << index;
+      *static_cast<void **>(_ptr) = d.freeLists[index];
+      d.freeLists[index] = _ptr;
+    }
+
+    /////////////////////////////////////////////////
+    auto ArenaMemoryResource::GetOptions() const -> const Options &
+    {
+      return this->dataPtr->options;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t ArenaMemoryResource::GetBytesReserved() const
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      return this->dataPtr->blocks.size() * this->dataPtr->options.blockSize +
+          this->dataPtr->largeBytes;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t ArenaMemoryResource::GetBytesInUse() const
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      return this->dataPtr->bytesInUse;
+    }
+  }
+}
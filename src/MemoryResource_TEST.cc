@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gz/physics/MemoryResource.hh"
+
+using gz::physics::ArenaMemoryResource;
+using gz::physics::ResourceAllocator;
+
+/////////////////////////////////////////////////
+TEST(MemoryResource_TEST, Arena)
+{
+  ArenaMemoryResource::Options options;
+  options.blockSize = 4096u;
+  options.maxPooledSize = 300u;
+  ArenaMemoryResource arena(options);
+  EXPECT_EQ(512u, arena.GetOptions().maxPooledSize);
+  EXPECT_EQ(0u, arena.GetBytesReserved());
+
+  // Small allocations are rounded up to their size class and aligned to it
+  void *a = arena.Allocate(24u, 8u);
+  void *b = arena.Allocate(24u, 8u);
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(a) % 32u);
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(b) % 32u);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(64u, arena.GetBytesInUse());
+  EXPECT_EQ(4096u, arena.GetBytesReserved());
+
+  void *aligned = arena.Allocate(8u, 256u);
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(aligned) % 256u);
+
+  // Freed slots are reused by their size class
+  arena.Deallocate(a, 24u, 8u);
+  EXPECT_EQ(a, arena.Allocate(20u, 4u));
+  arena.Deallocate(aligned, 8u, 256u);
+  EXPECT_EQ(64u, arena.GetBytesInUse());
+
+  // Full blocks are followed by new ones
+  std::vector<void *> slots;
+  for (std::size_t i = 0; i < 16u; ++i)
+    slots.push_back(arena.Allocate(512u, 8u));
+  EXPECT_EQ(3u * 4096u, arena.GetBytesReserved());
+
+  // Large allocations are passed through
+  void *large = arena.Allocate(10000u, 64u);
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(large) % 64u);
+  EXPECT_EQ(3u * 4096u + 10000u, arena.GetBytesReserved());
+  arena.Deallocate(large, 10000u, 64u);
+  EXPECT_EQ(3u * 4096u, arena.GetBytesReserved());
+
+  // The rest is freed with the arena
+  arena.Allocate(10000u, 16u);
+}
+
+/////////////////////////////////////////////////
+TEST(MemoryResource_TEST, HugePages)
+{
+  ArenaMemoryResource::Options options;
+  options.blockSize = 1000u;
+  options.hugePages = true;
+  ArenaMemoryResource arena(options);
+
+#ifdef __linux__
+  EXPECT_TRUE(arena.GetOptions().hugePages);
+  EXPECT_EQ(std::size_t(1u) << 21, arena.GetOptions().blockSize);
+#else
+  EXPECT_FALSE(arena.GetOptions().hugePages);
+#endif
+
+  void *ptr = arena.Allocate(64u, 8u);
+  ASSERT_NE(nullptr, ptr);
+  arena.Deallocate(ptr, 64u, 8u);
+}
+
+/////////////////////////////////////////////////
+TEST(MemoryResource_TEST, FirstTouch)
+{
+  std::vector<void *> touched;
+  ArenaMemoryResource::Options options;
+  options.blockSize = 4096u;
+  options.firstTouch = [&touched](void *_block, std::size_t _size)
+  {
+    EXPECT_EQ(4096u, _size);
+    touched.push_back(_block);
+  };
+  ArenaMemoryResource arena(options);
+  EXPECT_TRUE(touched.empty());
+
+  // Each block is touched once, before the first slot is carved from it
+  void *first = arena.Allocate(1024u, 8u);
+  ASSERT_EQ(1u, touched.size());
+  EXPECT_EQ(touched[0], first);
+  for (std::size_t i = 0; i < 3u; ++i)
+    arena.Allocate(1024u, 8u);
+  EXPECT_EQ(1u, touched.size());
+  arena.Allocate(1024u, 8u);
+  EXPECT_EQ(2u, touched.size());
+
+  // Passed through allocations are not touched
+  arena.Allocate(10000u, 8u);
+  EXPECT_EQ(2u, touched.size());
+}
+
+/////////////////////////////////////////////////
+TEST(MemoryResource_TEST, ConcurrentAllocations)
+{
+  ArenaMemoryResource arena;
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < 4u; ++t)
+  {
+    threads.emplace_back([&arena]()
+    {
+      std::vector<void *> ptrs;
+      for (std::size_t i = 0; i < 1000u; ++i)
+        ptrs.push_back(arena.Allocate(16u + i % 200u, 8u));
+      for (std::size_t i = 0; i < ptrs.size(); ++i)
+        arena.Deallocate(ptrs[i], 16u + i % 200u, 8u);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  EXPECT_EQ(0u, arena.GetBytesInUse());
+}
+
+/////////////////////////////////////////////////
+TEST(MemoryResource_TEST, Allocator)
+{
+  auto arena = std::make_shared<ArenaMemoryResource>();
+
+  // Containers allocate their nodes from the resource
+  {
+    std::map<int, double, std::less<int>,
+        ResourceAllocator<std::pair<const int, double>>> map(
+            ResourceAllocator<std::pair<const int, double>>{arena});
+    for (int i = 0; i < 100; ++i)
+      map[i] = i;
+    EXPECT_LT(0u, arena->GetBytesInUse());
+  }
+  EXPECT_EQ(0u, arena->GetBytesInUse());
+
+  // Shared objects keep the resource alive
+  std::weak_ptr<ArenaMemoryResource> weak = arena;
+  auto value = gz::physics::MakeShared<std::vector<int>>(arena, 3u, 7);
+  EXPECT_LT(0u, arena->GetBytesInUse());
+  arena.reset();
+  EXPECT_FALSE(weak.expired());
+  EXPECT_EQ(7, value->at(2));
+  value.reset();
+  EXPECT_TRUE(weak.expired());
+
+  // Without a resource the global heap is used
+  auto plain = gz::physics::MakeShared<int>(nullptr, 5);
+  EXPECT_EQ(5, *plain);
+  EXPECT_EQ(ResourceAllocator<int>(), ResourceAllocator<double>());
+}
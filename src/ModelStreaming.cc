@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+#include "gz/physics/ModelStreaming.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    class ModelStreamingPrivate
+    {
+      /// \brief Coordinates of a cell of the grid.
+      public: using Cell = std::array<int64_t, 3>;
+
+      /// \brief Hash of the coordinates of a cell.
+      public: struct CellHash
+      {
+        std::size_t operator()(const Cell &_cell) const
+        {
+          std::size_t hash = 0u;
+          for (const int64_t coordinate : _cell)
+          {
+            hash ^= std::hash<int64_t>()(coordinate) + 0x9e3779b9u +
+                (hash << 6) + (hash >> 2);
+          }
+          return hash;
+        }
+      };
+
+      /// \brief A placement of a model.
+      public: struct Placement
+      {
+        /// \brief Center in the world frame.
+        LinearVector3d position;
+
+        /// \brief Radius.
+        double radius;
+
+        /// \brief Cell of the grid that holds the placement.
+        Cell cell;
+
+        /// \brief Whether the placement is loaded.
+        bool loaded = false;
+
+        /// \brief Index of the placement in loaded, if it is loaded.
+        std::size_t loadedIndex = 0u;
+
+        /// \brief Number of the last update that visited the placement.
+        std::size_t lastUpdate = 0u;
+      };
+
+      /// \brief Get the cell that contains a point.
+      /// \param[in] _point Point in the world frame.
+      /// \return Coordinates of the cell.
+      public: Cell CellOf(const LinearVector3d &_point) const;
+
+      /// \brief Get the distance from a placement to the nearest tracked
+      /// point.
+      /// \param[in] _placement The placement.
+      /// \return Distance from the sphere of the placement, infinite if
+      /// there are no tracked points.
+      public: double Distance(const Placement &_placement) const;
+
+      /// \brief Mark a placement as loaded or unloaded.
+      /// \param[in] _placement Index of the placement.
+      /// \param[in] _loaded True to mark it as loaded.
+      public: void SetLoaded(std::size_t _placement, bool _loaded);
+
+      /// \brief See ModelStreaming::ModelStreaming.
+      public: ModelStreaming::Parameters parameters;
+
+      /// \brief All placements, by index.
+      public: std::vector<Placement> placements;
+
+      /// \brief Indices of the placements in each cell that holds any.
+      public: std::unordered_map<Cell, std::vector<std::size_t>, CellHash>
+          grid;
+
+      /// \brief Largest radius of the placements.
+      public: double maxRadius = 0.0;
+
+      /// \brief Saved states by placement index.
+      public: std::unordered_map<std::size_t, ModelStreaming::State> states;
+
+      /// \brief Points around which placements are loaded.
+      public: std::vector<LinearVector3d> points;
+
+      /// \brief Indices of the loaded placements.
+      public: std::vector<std::size_t> loaded;
+
+      /// \brief Number of calls to Update so far.
+      public: std::size_t updates = 0u;
+
+      /// \brief Placements left unloaded by the budget of the last update.
+      public: std::size_t pendingLoads = 0u;
+
+      /// \brief Changes found by the last update.
+      public: ModelStreaming::Changes changes;
+
+      /// \brief Placements to load or unload with their distance, reused
+      /// from update to update.
+      public: std::vector<std::pair<double, std::size_t>> candidates;
+    };
+
+    /////////////////////////////////////////////////
+    auto ModelStreamingPrivate::CellOf(const LinearVector3d &_point) const
+        -> Cell
+    {
+      Cell cell;
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        cell[i] = static_cast<int64_t>(
+            std::floor(_point[i] / this->parameters.cellSize));
+      }
+      return cell;
+    }
+
+    /////////////////////////////////////////////////
+    double ModelStreamingPrivate::Distance(const Placement &_placement) const
+    {
+      double distance = std::numeric_limits<double>::infinity();
+      for (const LinearVector3d &point : this->points)
+      {
+        distance = std::min(distance,
+            (point - _placement.position).norm() - _placement.radius);
+      }
+      return distance;
+    }
+
+    /////////////////////////////////////////////////
+    void ModelStreamingPrivate::SetLoaded(
+        const std::size_t _placement, const bool _loaded)
+    {
+      Placement &placement = this->placements[_placement];
+      if (_loaded)
+      {
+        placement.loadedIndex = this->loaded.size();
+        this->loaded.push_back(_placement);
+      }
+      else
+      {
+        const std::size_t last = this->loaded.back();
+        this->loaded[placement.loadedIndex] = last;
+        this->placements[last].loadedIndex = placement.loadedIndex;
+        this->loaded.pop_back();
+      }
+      placement.loaded = _loaded;
+    }
+
+    /////////////////////////////////////////////////
+    ModelStreaming::ModelStreaming()
+      : ModelStreaming(Parameters())
+    {
+    }
+
+    /////////////////////////////////////////////////
+    ModelStreaming::ModelStreaming(const Parameters &_parameters)
+      : dataPtr(new ModelStreamingPrivate)
+    {
+      this->dataPtr->parameters = _parameters;
+      if (!(_parameters.cellSize > 0.0))
+        this->dataPtr->parameters.cellSize = Parameters().cellSize;
+    }
+
+    /////////////////////////////////////////////////
+    ModelStreaming::~ModelStreaming() = default;
+
+    /////////////////////////////////////////////////
+    auto ModelStreaming::GetParameters() const -> const Parameters &
+    {
+      return this->dataPtr->parameters;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t ModelStreaming::AddPlacement(
+        const LinearVector3d &_position, const double _radius)
+    {
+      auto &d = *this->dataPtr;
+      const std::size_t index = d.placements.size();
+
+      ModelStreamingPrivate::Placement placement;
+      placement.position = _position;
+      placement.radius = std::max(_radius, 0.0);
+      placement.cell = d.CellOf(_position);
+      d.placements.push_back(placement);
+      d.grid[placement.cell].push_back(index);
+      d.maxRadius = std::max(d.maxRadius, placement.radius);
+      return index;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t ModelStreaming::PlacementCount() const
+    {
+      return this->dataPtr->placements.size();
+    }
+
+    /////////////////////////////////////////////////
+    void ModelStreaming::MovePlacement(
+        const std::size_t _placement, const LinearVector3d &_position)
+    {
+      auto &d = *this->dataPtr;
+      if (_placement >= d.placements.size())
+        return;
+
+      auto &placement = d.placements[_placement];
+      placement.position = _position;
+      const auto cell = d.CellOf(_position);
+      if (cell == placement.cell)
+        return;
+
+      auto it = d.grid.find(placement.cell);
+      auto &indices = it->second;
+      indices.erase(std::find(indices.begin(), indices.end(), _placement));
+      if (indices.empty())
+        d.grid.erase(it);
+
+      placement.cell = cell;
+      d.grid[cell].push_back(_placement);
+    }
+
+    /////////////////////////////////////////////////
+    LinearVector3d ModelStreaming::PlacementPosition(
+        const std::size_t _placement) const
+    {
+      if (_placement >= this->dataPtr->placements.size())
+        return LinearVector3d::Zero();
+      return this->dataPtr->placements[_placement].position;
+    }
+
+    /////////////////////////////////////////////////
+    void ModelStreaming::SetTrackedPoints(
+        const std::vector<LinearVector3d> &_points)
+    {
+      this->dataPtr->points = _points;
+    }
+
+    /////////////////////////////////////////////////
+    const std::vector<LinearVector3d> &ModelStreaming::GetTrackedPoints()
+        const
+    {
+      return this->dataPtr->points;
+    }
+
+    /////////////////////////////////////////////////
+    auto ModelStreaming::Update() -> const Changes &
+    {
+      auto &d = *this->dataPtr;
+      const auto &p = d.parameters;
+      const std::size_t update = ++d.updates;
+      d.changes.loads.clear();
+      d.changes.unloads.clear();
+
+      auto takeCandidates = [&d](std::size_t _budget,
+                                 std::vector<std::size_t> &_taken)
+      {
+        const std::size_t count = _budget == 0u ?
+            d.candidates.size() : std::min(_budget, d.candidates.size());
+        std::partial_sort(d.candidates.begin(), d.candidates.begin() +
+            static_cast<std::ptrdiff_t>(count), d.candidates.end());
+        for (std::size_t i = 0; i < count; ++i)
+          _taken.push_back(d.candidates[i].second);
+        return count;
+      };
+
+      // Loaded placements that are beyond the hysteresis from every point.
+      // The distance is negated to unload the furthest first.
+      d.candidates.clear();
+      for (const std::size_t index : d.loaded)
+      {
+        const double distance = d.Distance(d.placements[index]);
+        if (distance > p.loadRadius + p.hysteresis)
+          d.candidates.emplace_back(-distance, index);
+      }
+      takeCandidates(p.maxUnloadsPerUpdate, d.changes.unloads);
+
+      // Unloaded placements within the load radius of a point, found from
+      // the cells around each point. Visiting every cell that holds a
+      // placement is cheaper when the cells around a point outnumber them.
+      d.candidates.clear();
+      auto visit = [&](const std::vector<std::size_t> &_indices)
+      {
+        for (const std::size_t index : _indices)
+        {
+          auto &placement = d.placements[index];
+          if (placement.loaded || placement.lastUpdate == update)
+            continue;
+          placement.lastUpdate = update;
+
+          const double distance = d.Distance(placement);
+          if (distance <= p.loadRadius)
+            d.candidates.emplace_back(distance, index);
+        }
+      };
+
+      const double reach = p.loadRadius + d.maxRadius;
+      const double span = std::ceil(reach / p.cellSize);
+      const double cellsPerPoint = std::pow(2.0 * span + 1.0, 3.0);
+      if (cellsPerPoint * static_cast<double>(d.points.size()) >=
+          static_cast<double>(d.grid.size()))
+      {
+        if (!d.points.empty())
+        {
+          for (const auto &cell : d.grid)
+            visit(cell.second);
+        }
+      }
+      else
+      {
+        const auto s = static_cast<int64_t>(span);
+        for (const LinearVector3d &point : d.points)
+        {
+          const auto center = d.CellOf(point);
+          for (int64_t x = center[0] - s; x <= center[0] + s; ++x)
+          {
+            for (int64_t y = center[1] - s; y <= center[1] + s; ++y)
+            {
+              for (int64_t z = center[2] - s; z <= center[2] + s; ++z)
+              {
+                const auto it = d.grid.find({x, y, z});
+                if (it != d.grid.end())
+                  visit(it->second);
+              }
+            }
+          }
+        }
+      }
+      const std::size_t loads =
+          takeCandidates(p.maxLoadsPerUpdate, d.changes.loads);
+      d.pendingLoads = d.candidates.size() - loads;
+
+      for (const std::size_t index : d.changes.unloads)
+        d.SetLoaded(index, false);
+      for (const std::size_t index : d.changes.loads)
+        d.SetLoaded(index, true);
+      return d.changes;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t ModelStreaming::PendingLoadCount() const
+    {
+      return this->dataPtr->pendingLoads;
+    }
+
+    /////////////////////////////////////////////////
+    bool ModelStreaming::IsLoaded(const std::size_t _placement) const
+    {
+      return _placement < this->dataPtr->placements.size() &&
+          this->dataPtr->placements[_placement].loaded;
+    }
+
+    /////////////////////////////////////////////////
+    const std::vector<std::size_t> &ModelStreaming::LoadedPlacements() const
+    {
+      return this->dataPtr->loaded;
+    }
+
+    /////////////////////////////////////////////////
+    void ModelStreaming::SaveState(
+        const std::size_t _placement, const State &_state)
+    {
+      if (_placement >= this->dataPtr->placements.size())
+        return;
+
+      this->dataPtr->states[_placement] = _state;
+      this->MovePlacement(_placement, _state.pose.translation());
+    }
+
+    /////////////////////////////////////////////////
+    auto ModelStreaming::SavedState(const std::size_t _placement) const
+        -> const State *
+    {
+      const auto it = this->dataPtr->states.find(_placement);
+      if (it == this->dataPtr->states.end())
+        return nullptr;
+      return &it->second;
+    }
+  }
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "gz/physics/ModelStreaming.hh"
+
+using gz::physics::LinearVector3d;
+using gz::physics::ModelStreaming;
+
+/////////////////////////////////////////////////
+ModelStreaming::Parameters SmallParameters()
+{
+  ModelStreaming::Parameters parameters;
+  parameters.loadRadius = 10.0;
+  parameters.hysteresis = 2.0;
+  parameters.cellSize = 5.0;
+  parameters.maxLoadsPerUpdate = 0u;
+  parameters.maxUnloadsPerUpdate = 0u;
+  return parameters;
+}
+
+/////////////////////////////////////////////////
+TEST(ModelStreaming_TEST, LoadAndUnload)
+{
+  ModelStreaming streaming(SmallParameters());
+  EXPECT_EQ(0u, streaming.AddPlacement(LinearVector3d(4, 0, 0)));
+  EXPECT_EQ(1u, streaming.AddPlacement(LinearVector3d(30, 0, 0)));
+  EXPECT_EQ(2u, streaming.AddPlacement(LinearVector3d(-8, 0, 0), 3.0));
+  EXPECT_EQ(3u, streaming.PlacementCount());
+
+  // Without tracked points nothing is loaded
+  EXPECT_TRUE(streaming.Update().loads.empty());
+  EXPECT_TRUE(streaming.LoadedPlacements().empty());
+
+  // Placements whose sphere is within the load radius are loaded, nearest
+  // first
+  streaming.SetTrackedPoints({LinearVector3d::Zero()});
+  const auto &changes = streaming.Update();
+  ASSERT_EQ(2u, changes.loads.size());
+  EXPECT_EQ(0u, changes.loads[0]);
+  EXPECT_EQ(2u, changes.loads[1]);
+  EXPECT_TRUE(changes.unloads.empty());
+  EXPECT_TRUE(streaming.IsLoaded(0u));
+  EXPECT_FALSE(streaming.IsLoaded(1u));
+  EXPECT_TRUE(streaming.IsLoaded(2u));
+  EXPECT_EQ(0u, streaming.PendingLoadCount());
+
+  // Nothing changes while the point stays where it is
+  streaming.Update();
+  EXPECT_TRUE(changes.loads.empty());
+  EXPECT_TRUE(changes.unloads.empty());
+
+  // Placement 0 is 11 m away, within the hysteresis
+  streaming.SetTrackedPoints({LinearVector3d(-7, 0, 0)});
+  streaming.Update();
+  EXPECT_TRUE(changes.loads.empty());
+  EXPECT_TRUE(changes.unloads.empty());
+
+  // Beyond the hysteresis it is unloaded
+  streaming.SetTrackedPoints({LinearVector3d(-9, 0, 0)});
+  streaming.Update();
+  EXPECT_TRUE(changes.loads.empty());
+  ASSERT_EQ(1u, changes.unloads.size());
+  EXPECT_EQ(0u, changes.unloads[0]);
+  EXPECT_FALSE(streaming.IsLoaded(0u));
+
+  // A second point loads the placements around it as well
+  streaming.SetTrackedPoints({LinearVector3d(-9, 0, 0),
+                              LinearVector3d(25, 0, 0)});
+  streaming.Update();
+  ASSERT_EQ(1u, changes.loads.size());
+  EXPECT_EQ(1u, changes.loads[0]);
+
+  // Without points every placement is unloaded
+  streaming.SetTrackedPoints({});
+  streaming.Update();
+  EXPECT_EQ(2u, changes.unloads.size());
+  EXPECT_TRUE(streaming.LoadedPlacements().empty());
+}
+
+/////////////////////////////////////////////////
+TEST(ModelStreaming_TEST, Budget)
+{
+  auto parameters = SmallParameters();
+  parameters.maxLoadsPerUpdate = 2u;
+  parameters.maxUnloadsPerUpdate = 3u;
+  ModelStreaming streaming(parameters);
+  for (int i = 0; i < 5; ++i)
+    streaming.AddPlacement(LinearVector3d(i, 0, 0));
+
+  // The nearest placements are loaded first, the others wait for later
+  // updates
+  streaming.SetTrackedPoints({LinearVector3d(4.2, 0, 0)});
+  const auto &changes = streaming.Update();
+  EXPECT_EQ((std::vector<std::size_t>{4u, 3u}), changes.loads);
+  EXPECT_EQ(3u, streaming.PendingLoadCount());
+
+  streaming.Update();
+  EXPECT_EQ((std::vector<std::size_t>{2u, 1u}), changes.loads);
+  EXPECT_EQ(1u, streaming.PendingLoadCount());
+
+  streaming.Update();
+  EXPECT_EQ((std::vector<std::size_t>{0u}), changes.loads);
+  EXPECT_EQ(0u, streaming.PendingLoadCount());
+  EXPECT_EQ(5u, streaming.LoadedPlacements().size());
+
+  // Unloads are spread in the same way, furthest first
+  streaming.SetTrackedPoints({LinearVector3d(100, 0, 0)});
+  streaming.Update();
+  EXPECT_EQ((std::vector<std::size_t>{0u, 1u, 2u}), changes.unloads);
+  streaming.Update();
+  EXPECT_EQ((std::vector<std::size_t>{3u, 4u}), changes.unloads);
+  EXPECT_TRUE(streaming.LoadedPlacements().empty());
+}
+
+/////////////////////////////////////////////////
+TEST(ModelStreaming_TEST, SaveState)
+{
+  ModelStreaming streaming(SmallParameters());
+  const std::size_t placement = streaming.AddPlacement(LinearVector3d::Zero());
+  EXPECT_EQ(nullptr, streaming.SavedState(placement));
+
+  streaming.SetTrackedPoints({LinearVector3d::Zero()});
+  ASSERT_EQ(1u, streaming.Update().loads.size());
+
+  // The model drove away from where it was placed, and was unloaded there
+  ModelStreaming::State state;
+  state.pose.translation() = LinearVector3d(40, 0, 0);
+  state.linearVelocity = LinearVector3d(1, 0, 0);
+  streaming.SaveState(placement, state);
+  EXPECT_TRUE(streaming.PlacementPosition(placement).isApprox(
+      state.pose.translation()));
+  ASSERT_EQ(1u, streaming.Update().unloads.size());
+
+  const auto *saved = streaming.SavedState(placement);
+  ASSERT_NE(nullptr, saved);
+  EXPECT_TRUE(saved->pose.isApprox(state.pose));
+  EXPECT_TRUE(saved->linearVelocity.isApprox(state.linearVelocity));
+
+  // It is loaded again where it was left, not where it was placed
+  streaming.SetTrackedPoints({LinearVector3d(35, 0, 0)});
+  ASSERT_EQ(1u, streaming.Update().loads.size());
+  EXPECT_TRUE(streaming.IsLoaded(placement));
+
+  // Moving a loaded placement keeps it loaded while it is in range
+  streaming.MovePlacement(placement, LinearVector3d(38, 3, 0));
+  EXPECT_TRUE(streaming.Update().unloads.empty());
+  EXPECT_TRUE(streaming.IsLoaded(placement));
+}
+
+/////////////////////////////////////////////////
+TEST(ModelStreaming_TEST, ManyPlacements)
+{
+  // A grid of placements much larger than the load radius. The cells
+  // around the point are visited instead of every placement.
+  auto parameters = SmallParameters();
+  ModelStreaming streaming(parameters);
+  for (int x = -100; x < 100; ++x)
+  {
+    for (int y = -100; y < 100; ++y)
+      streaming.AddPlacement(LinearVector3d(x, y, 0));
+  }
+
+  streaming.SetTrackedPoints({LinearVector3d(0.5, 0.5, 0)});
+  const auto &changes = streaming.Update();
+  for (const std::size_t index : changes.loads)
+  {
+    EXPECT_LE((streaming.PlacementPosition(index) -
+               LinearVector3d(0.5, 0.5, 0)).norm(), parameters.loadRadius);
+  }
+
+  // Every placement within the radius, and no other, is loaded
+  std::size_t inRange = 0u;
+  for (std::size_t i = 0; i < streaming.PlacementCount(); ++i)
+  {
+    const bool near = (streaming.PlacementPosition(i) -
+        LinearVector3d(0.5, 0.5, 0)).norm() <= parameters.loadRadius;
+    EXPECT_EQ(near, streaming.IsLoaded(i));
+    if (near)
+      ++inRange;
+  }
+  EXPECT_EQ(inRange, changes.loads.size());
+  EXPECT_LT(300u, inRange);
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "gz/physics/RegionsOfInterest.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    class RegionsOfInterestPrivate
+    {
+      /// \brief A model of the regions of interest.
+      public: struct Model
+      {
+        /// \brief Current fidelity of the model.
+        SimulationFidelity fidelity = SimulationFidelity::kFull;
+
+        /// \brief Number of the last update that the model was passed to.
+        std::size_t lastUpdate = 0;
+      };
+
+      /// \brief Get the distance from a box to the nearest region.
+      /// \param[in] _box Box in the world frame.
+      /// \return Distance, 0 if the box overlaps a region, infinite if there
+      /// are no regions.
+      public: double Distance(const AlignedBox3d &_box) const;
+
+      /// \brief Get the fidelity of a model at a distance from the regions.
+      /// \param[in] _distance Distance to the nearest region.
+      /// \return Fidelity, without hysteresis.
+      public: SimulationFidelity FidelityAt(double _distance) const;
+
+      /// \brief See RegionsOfInterest::RegionsOfInterest.
+      public: RegionsOfInterest::Parameters parameters;
+
+      /// \brief Boxes of the regions.
+      public: std::vector<AlignedBox3d> regions;
+
+      /// \brief Models by ID.
+      public: std::map<std::size_t, Model> models;
+
+      /// \brief Number of calls to Update so far.
+      public: std::size_t updates = 0;
+
+      /// \brief Changes found by the last update.
+      public: std::vector<RegionsOfInterest::Change> changes;
+    };
+
+    /////////////////////////////////////////////////
+    double RegionsOfInterestPrivate::Distance(const AlignedBox3d &_box) const
+    {
+      double distance = std::numeric_limits<double>::infinity();
+      for (const AlignedBox3d &region : this->regions)
+        distance = std::min(distance, region.exteriorDistance(_box));
+      return distance;
+    }
+
+    /////////////////////////////////////////////////
+    SimulationFidelity RegionsOfInterestPrivate::FidelityAt(
+        const double _distance) const
+    {
+      if (_distance <= this->parameters.fullMargin)
+        return SimulationFidelity::kFull;
+      if (_distance <= this->parameters.sleepMargin)
+        return SimulationFidelity::kSleeping;
+      return SimulationFidelity::kKinematic;
+    }
+
+    /////////////////////////////////////////////////
+    RegionsOfInterest::RegionsOfInterest()
+      : RegionsOfInterest(Parameters())
+    {
+    }
+
+    /////////////////////////////////////////////////
+    RegionsOfInterest::RegionsOfInterest(const Parameters &_parameters)
+      : dataPtr(new RegionsOfInterestPrivate)
+    {
+      this->dataPtr->parameters = _parameters;
+    }
+
+    /////////////////////////////////////////////////
+    RegionsOfInterest::~RegionsOfInterest() = default;
+
+    /////////////////////////////////////////////////
+    auto RegionsOfInterest::GetParameters() const -> const Parameters &
+    {
+      return this->dataPtr->parameters;
+    }
+
+    /////////////////////////////////////////////////
+    void RegionsOfInterest::SetRegions(
+        const std::vector<AlignedBox3d> &_regions)
+    {
+      this->dataPtr->regions = _regions;
+    }
+
+    /////////////////////////////////////////////////
+    const std::vector<AlignedBox3d> &RegionsOfInterest::GetRegions() const
+    {
+      return this->dataPtr->regions;
+    }
+
+    /////////////////////////////////////////////////
+    auto RegionsOfInterest::Update(const std::size_t *_models,
+                                   const AlignedBox3d *_boxes,
+                                   const std::size_t _count)
+        -> const std::vector<Change> &
+    {
+      auto &d = *this->dataPtr;
+      const std::size_t update = ++d.updates;
+      d.changes.clear();
+
+      for (std::size_t i = 0; i < _count; ++i)
+      {
+        if (_boxes[i].isEmpty())
+          continue;
+
+        auto &model = d.models[_models[i]];
+        const bool added = model.lastUpdate == 0;
+        model.lastUpdate = update;
+
+        SimulationFidelity fidelity = SimulationFidelity::kFull;
+        if (!d.regions.empty())
+        {
+          // Upgrades happen at the margins, downgrades a hysteresis beyond
+          // them, except for new models
+          const double distance = d.Distance(_boxes[i]);
+          fidelity = d.FidelityAt(distance);
+          if (!added && fidelity > model.fidelity)
+          {
+            fidelity = std::max(model.fidelity,
+                d.FidelityAt(distance - d.parameters.hysteresis));
+          }
+        }
+
+        if (fidelity != model.fidelity)
+        {
+          d.changes.push_back({_models[i], model.fidelity, fidelity});
+          model.fidelity = fidelity;
+        }
+      }
+
+      for (auto it = d.models.begin(); it != d.models.end();)
+      {
+        if (it->second.lastUpdate != update)
+          it = d.models.erase(it);
+        else
+          ++it;
+      }
+
+      std::sort(d.changes.begin(), d.changes.end(),
+                [](const Change &_a, const Change &_b)
+                { return _a.model < _b.model; });
+      return d.changes;
+    }
+
+    /////////////////////////////////////////////////
+    SimulationFidelity RegionsOfInterest::FidelityOf(
+        const std::size_t _model) const
+    {
+      const auto it = this->dataPtr->models.find(_model);
+      if (it == this->dataPtr->models.end())
+        return SimulationFidelity::kFull;
+      return it->second.fidelity;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t RegionsOfInterest::CountOf(
+        const SimulationFidelity _fidelity) const
+    {
+      std::size_t count = 0;
+      for (const auto &model : this->dataPtr->models)
+      {
+        if (model.second.fidelity == _fidelity)
+          ++count;
+      }
+      return count;
+    }
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "gz/physics/RegionsOfInterest.hh"
+
+using gz::physics::AlignedBox3d;
+using gz::physics::LinearVector3d;
+using gz::physics::RegionsOfInterest;
+using gz::physics::SimulationFidelity;
+
+/////////////////////////////////////////////////
+AlignedBox3d Box(const double _x)
+{
+  const LinearVector3d half = LinearVector3d::Constant(0.5);
+  return AlignedBox3d(LinearVector3d(_x, 0, 0) - half,
+                      LinearVector3d(_x, 0, 0) + half);
+}
+
+/////////////////////////////////////////////////
+TEST(RegionsOfInterest_TEST, Fidelity)
+{
+  RegionsOfInterest regions;
+  const std::size_t models[] = {7, 3, 5};
+  AlignedBox3d boxes[] = {Box(0.0), Box(20.0), Box(5.0)};
+
+  // Without regions everything is simulated at full fidelity
+  EXPECT_TRUE(regions.Update(models, boxes, 3).empty());
+  EXPECT_EQ(3u, regions.CountOf(SimulationFidelity::kFull));
+
+  // A region around the origin, 1 m on a side
+  regions.SetRegions({Box(0.0)});
+  const auto &changes = regions.Update(models, boxes, 3);
+  ASSERT_EQ(2u, changes.size());
+  EXPECT_EQ(3u, changes[0].model);
+  EXPECT_EQ(SimulationFidelity::kFull, changes[0].from);
+  EXPECT_EQ(SimulationFidelity::kKinematic, changes[0].to);
+  EXPECT_EQ(5u, changes[1].model);
+  EXPECT_EQ(SimulationFidelity::kSleeping, changes[1].to);
+  EXPECT_EQ(SimulationFidelity::kFull, regions.FidelityOf(7));
+  EXPECT_EQ(SimulationFidelity::kKinematic, regions.FidelityOf(3));
+  EXPECT_EQ(SimulationFidelity::kSleeping, regions.FidelityOf(5));
+
+  // Nothing changes while the models stay where they are
+  EXPECT_TRUE(regions.Update(models, boxes, 3).empty());
+
+  // Entering a margin upgrades at once
+  boxes[1] = Box(1.5);
+  ASSERT_EQ(1u, regions.Update(models, boxes, 3).size());
+  EXPECT_EQ(SimulationFidelity::kKinematic, changes[0].from);
+  EXPECT_EQ(SimulationFidelity::kFull, changes[0].to);
+
+  // Leaving it downgrades only beyond the hysteresis. The box is 1 m from
+  // the region at x = 2.0
+  boxes[1] = Box(2.3);
+  EXPECT_TRUE(regions.Update(models, boxes, 3).empty());
+  boxes[1] = Box(2.6);
+  ASSERT_EQ(1u, regions.Update(models, boxes, 3).size());
+  EXPECT_EQ(SimulationFidelity::kSleeping, changes[0].to);
+
+  // Moving the region moves the levels with it
+  regions.SetRegions({Box(20.0)});
+  regions.Update(models, boxes, 3);
+  EXPECT_EQ(SimulationFidelity::kKinematic, regions.FidelityOf(7));
+  EXPECT_EQ(SimulationFidelity::kKinematic, regions.FidelityOf(3));
+  EXPECT_EQ(SimulationFidelity::kKinematic, regions.FidelityOf(5));
+  EXPECT_EQ(3u, regions.CountOf(SimulationFidelity::kKinematic));
+
+  // Models that are not passed, or have empty boxes, are forgotten
+  boxes[2] = AlignedBox3d();
+  EXPECT_TRUE(regions.Update(models, boxes, 3).empty());
+  EXPECT_EQ(SimulationFidelity::kFull, regions.FidelityOf(5));
+  EXPECT_TRUE(regions.Update(models, boxes, 1).empty());
+  EXPECT_EQ(SimulationFidelity::kFull, regions.FidelityOf(3));
+  EXPECT_EQ(1u, regions.CountOf(SimulationFidelity::kKinematic));
+}
+
+/////////////////////////////////////////////////
+struct MockModel
+{
+  bool sleeping = false;
+  bool kinematic = false;
+  void SetSleeping(bool _sleeping) { this->sleeping = _sleeping; }
+  void SetKinematic(bool _kinematic) { this->kinematic = _kinematic; }
+};
+
+/////////////////////////////////////////////////
+TEST(RegionsOfInterest_TEST, Apply)
+{
+  MockModel model;
+  MockModel *ptr = &model;
+
+  gz::physics::ApplySimulationFidelity(ptr,
+      {0, SimulationFidelity::kFull, SimulationFidelity::kSleeping});
+  EXPECT_TRUE(model.sleeping);
+  EXPECT_FALSE(model.kinematic);
+
+  gz::physics::ApplySimulationFidelity(ptr,
+      {0, SimulationFidelity::kSleeping, SimulationFidelity::kKinematic});
+  EXPECT_FALSE(model.sleeping);
+  EXPECT_TRUE(model.kinematic);
+
+  gz::physics::ApplySimulationFidelity(ptr,
+      {0, SimulationFidelity::kKinematic, SimulationFidelity::kFull});
+  EXPECT_FALSE(model.sleeping);
+  EXPECT_FALSE(model.kinematic);
+}
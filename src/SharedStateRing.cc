@@ -0,0 +1,614 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <thread>
+
+#include "gz/physics/SharedStateRing.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    namespace
+    {
+      using Sequence = std::atomic<uint64_t>;
+      static_assert(sizeof(Sequence) == sizeof(uint64_t),
+                    "Sequence numbers must have the size of an integer");
+
+      /// \brief First bytes of a ring, "GZSR" in little endian byte order.
+      constexpr uint32_t kRingMagic = 0x52535A47;
+
+      /// \brief Version of the memory layout of a ring.
+      constexpr uint32_t kRingVersion = 1;
+
+      /// \brief Size of the ring header: the magic, the version, the
+      /// capacities, the size of a slot, the number of published frames and
+      /// room for later versions.
+      constexpr std::size_t kRingHeaderSize = 64;
+
+      /// \brief Offsets in the ring header.
+      constexpr std::size_t kSlotCountOffset = 8;
+      constexpr std::size_t kMaxPosesOffset = 16;
+      constexpr std::size_t kMaxJointStatesOffset = 24;
+      constexpr std::size_t kMaxContactsOffset = 32;
+      constexpr std::size_t kSlotBytesOffset = 40;
+      constexpr std::size_t kFrameCountOffset = 48;
+
+      /// \brief Size of a slot header: the sequence number, the frame
+      /// number, the time, the number of poses, joint states and contacts,
+      /// and the flags.
+      constexpr std::size_t kSlotHeaderSize = 8 + 8 + 8 + 4 * 4;
+
+      /// \brief Offsets in a slot header.
+      constexpr std::size_t kFrameOffset = 8;
+      constexpr std::size_t kTimeOffset = 16;
+      constexpr std::size_t kNumPosesOffset = 24;
+      constexpr std::size_t kNumJointStatesOffset = 28;
+      constexpr std::size_t kNumContactsOffset = 32;
+      constexpr std::size_t kFlagsOffset = 36;
+
+      /// \brief Flag of a frame that had more entries than its slot.
+      constexpr uint32_t kTruncatedFlag = 1u;
+
+      /// \brief Size of a pose: the link ID, the position and the
+      /// quaternion, w first.
+      constexpr std::size_t kPoseSize = 8 + 7 * 8;
+
+      /// \brief Size of a joint state: the joint ID, the index of the degree
+      /// of freedom, and its position, velocity, acceleration and effort.
+      constexpr std::size_t kJointStateSize = 8 + 8 + 4 * 8;
+
+      /// \brief Size of a contact: the two collision IDs, the point, the
+      /// normal, the depth and the force.
+      constexpr std::size_t kContactSize = 2 * 8 + 10 * 8;
+
+      /////////////////////////////////////////////////
+      template <typename T>
+      void Put(uint8_t *_data, const T _value)
+      {
+        std::memcpy(_data, &_value, sizeof(T));
+      }
+
+      /////////////////////////////////////////////////
+      template <typename T>
+      T Get(const uint8_t *_data)
+      {
+        T value;
+        std::memcpy(&value, _data, sizeof(T));
+        return value;
+      }
+
+      /////////////////////////////////////////////////
+      void PutVector(uint8_t *_data, const gz::math::Vector3d &_vec)
+      {
+        Put(_data, _vec.X());
+        Put(_data + 8, _vec.Y());
+        Put(_data + 16, _vec.Z());
+      }
+
+      /////////////////////////////////////////////////
+      gz::math::Vector3d GetVector(const uint8_t *_data)
+      {
+        return {Get<double>(_data), Get<double>(_data + 8),
+                Get<double>(_data + 16)};
+      }
+
+      /////////////////////////////////////////////////
+      std::size_t SlotBytes(const SharedStateRingLayout &_layout)
+      {
+        return kSlotHeaderSize + _layout.maxPoses * kPoseSize +
+            _layout.maxJointStates * kJointStateSize +
+            _layout.maxContacts * kContactSize;
+      }
+
+      /////////////////////////////////////////////////
+      /// \brief Whether the counts of a slot fit in its header.
+      bool FitsSlotHeader(const SharedStateRingLayout &_layout)
+      {
+        const std::size_t max = std::numeric_limits<uint32_t>::max();
+        return _layout.maxPoses <= max && _layout.maxJointStates <= max &&
+            _layout.maxContacts <= max;
+      }
+
+      /////////////////////////////////////////////////
+      /// \brief Whether a ring with a layout fits in memory of a size. The
+      /// layout of a ring that is opened comes from memory that another
+      /// process controls, so this divides instead of multiplying, which could
+      /// wrap around.
+      bool FitsInBytes(const SharedStateRingLayout &_layout,
+                       const std::size_t _bytes)
+      {
+        if (_bytes < kRingHeaderSize + kSlotHeaderSize)
+          return false;
+
+        const std::size_t slotsBytes = _bytes - kRingHeaderSize;
+        std::size_t left = slotsBytes - kSlotHeaderSize;
+        if (_layout.maxPoses > left / kPoseSize)
+          return false;
+        left -= _layout.maxPoses * kPoseSize;
+        if (_layout.maxJointStates > left / kJointStateSize)
+          return false;
+        left -= _layout.maxJointStates * kJointStateSize;
+        if (_layout.maxContacts > left / kContactSize)
+          return false;
+
+        // SlotBytes cannot wrap around now, since it is at most slotsBytes
+        return _layout.slotCount <= slotsBytes / SlotBytes(_layout);
+      }
+
+      /////////////////////////////////////////////////
+      /// \brief Pointers to the parts of a ring.
+      struct RingView
+      {
+        SharedStateRingLayout layout;
+        std::size_t slotBytes = 0;
+        uint8_t *memory = nullptr;
+
+        Sequence *FrameCount() const
+        {
+          return reinterpret_cast<Sequence *>(
+              this->memory + kFrameCountOffset);
+        }
+
+        uint8_t *Slot(const uint64_t _frame) const
+        {
+          return this->memory + kRingHeaderSize +
+              static_cast<std::size_t>(_frame % this->layout.slotCount) *
+              this->slotBytes;
+        }
+
+        uint8_t *Poses(uint8_t *_slot) const
+        {
+          return _slot + kSlotHeaderSize;
+        }
+
+        uint8_t *JointStates(uint8_t *_slot) const
+        {
+          return this->Poses(_slot) + this->layout.maxPoses * kPoseSize;
+        }
+
+        uint8_t *Contacts(uint8_t *_slot) const
+        {
+          return this->JointStates(_slot) +
+              this->layout.maxJointStates * kJointStateSize;
+        }
+      };
+    }
+
+    /////////////////////////////////////////////////
+    class SharedStateRingWriterPrivate
+    {
+      /// \brief The ring, with a null memory if there is none.
+      public: RingView ring;
+
+      /// \brief Slot of the current frame, or nullptr if no frame was
+      /// started.
+      public: uint8_t *slot = nullptr;
+
+      /// \brief Sequence number of the slot before the current frame.
+      public: uint64_t sequence = 0;
+
+      /// \brief Number of poses of the current frame.
+      public: uint32_t numPoses = 0;
+
+      /// \brief Number of joint states of the current frame.
+      public: uint32_t numJointStates = 0;
+
+      /// \brief Number of contacts of the current frame.
+      public: uint32_t numContacts = 0;
+
+      /// \brief Whether entries of the current frame did not fit.
+      public: bool truncated = false;
+
+      /// \brief Number of published frames.
+      public: uint64_t frameCount = 0;
+    };
+
+    /////////////////////////////////////////////////
+    SharedStateRingWriter::SharedStateRingWriter()
+      : dataPtr(new SharedStateRingWriterPrivate)
+    {
+    }
+
+    /////////////////////////////////////////////////
+    SharedStateRingWriter::~SharedStateRingWriter()
+    {
+      this->Close();
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t SharedStateRingWriter::RequiredBytes(
+        const SharedStateRingLayout &_layout)
+    {
+      return kRingHeaderSize + _layout.slotCount * SlotBytes(_layout);
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingWriter::Create(void *_memory, const std::size_t _bytes,
+        const SharedStateRingLayout &_layout)
+    {
+      this->Close();
+      if (!_memory || _layout.slotCount == 0 || !FitsSlotHeader(_layout) ||
+          reinterpret_cast<std::uintptr_t>(_memory) % alignof(Sequence) != 0 ||
+          !FitsInBytes(_layout, _bytes))
+      {
+        return false;
+      }
+
+      auto *memory = static_cast<uint8_t *>(_memory);
+      std::memset(memory, 0, kRingHeaderSize);
+      auto &ring = this->dataPtr->ring;
+      ring.layout = _layout;
+      ring.slotBytes = SlotBytes(_layout);
+      ring.memory = memory;
+
+      Put(memory, kRingMagic);
+      Put(memory + 4, kRingVersion);
+      Put<uint64_t>(memory + kSlotCountOffset, _layout.slotCount);
+      Put<uint64_t>(memory + kMaxPosesOffset, _layout.maxPoses);
+      Put<uint64_t>(memory + kMaxJointStatesOffset, _layout.maxJointStates);
+      Put<uint64_t>(memory + kMaxContactsOffset, _layout.maxContacts);
+      Put<uint64_t>(memory + kSlotBytesOffset, ring.slotBytes);
+      new (memory + kFrameCountOffset) Sequence(0u);
+      for (std::size_t i = 0; i < _layout.slotCount; ++i)
+      {
+        uint8_t *slot = ring.Slot(i);
+        std::memset(slot, 0, kSlotHeaderSize);
+        new (slot) Sequence(0u);
+      }
+
+      this->dataPtr->frameCount = 0;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    void SharedStateRingWriter::Close()
+    {
+      this->EndFrame();
+      this->dataPtr->ring = RingView();
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingWriter::IsOpen() const
+    {
+      return this->dataPtr->ring.memory != nullptr;
+    }
+
+    /////////////////////////////////////////////////
+    const SharedStateRingLayout &SharedStateRingWriter::Layout() const
+    {
+      return this->dataPtr->ring.layout;
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingWriter::BeginFrame(const double _time)
+    {
+      if (!this->IsOpen())
+        return false;
+      this->EndFrame();
+
+      auto &d = *this->dataPtr;
+      d.slot = d.ring.Slot(d.frameCount);
+      auto *sequence = reinterpret_cast<Sequence *>(d.slot);
+      d.sequence = sequence->load(std::memory_order_relaxed);
+      sequence->store(d.sequence + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+
+      Put(d.slot + kFrameOffset, d.frameCount);
+      Put(d.slot + kTimeOffset, _time);
+      d.numPoses = 0;
+      d.numJointStates = 0;
+      d.numContacts = 0;
+      d.truncated = false;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingWriter::AddPose(
+        const std::size_t _body, const gz::math::Pose3d &_pose)
+    {
+      auto &d = *this->dataPtr;
+      if (!d.slot)
+        return false;
+      if (d.numPoses >= d.ring.layout.maxPoses)
+      {
+        d.truncated = true;
+        return false;
+      }
+
+      uint8_t *data = d.ring.Poses(d.slot) + d.numPoses * kPoseSize;
+      Put<uint64_t>(data, _body);
+      PutVector(data + 8, _pose.Pos());
+      Put(data + 32, _pose.Rot().W());
+      Put(data + 40, _pose.Rot().X());
+      Put(data + 48, _pose.Rot().Y());
+      Put(data + 56, _pose.Rot().Z());
+      ++d.numPoses;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingWriter::AddJointState(
+        const std::size_t _joint, const std::size_t _dof,
+        const double _position, const double _velocity,
+        const double _acceleration, const double _effort)
+    {
+      auto &d = *this->dataPtr;
+      if (!d.slot)
+        return false;
+      if (d.numJointStates >= d.ring.layout.maxJointStates)
+      {
+        d.truncated = true;
+        return false;
+      }
+
+      uint8_t *data =
+          d.ring.JointStates(d.slot) + d.numJointStates * kJointStateSize;
+      Put<uint64_t>(data, _joint);
+      Put<uint64_t>(data + 8, _dof);
+      Put(data + 16, _position);
+      Put(data + 24, _velocity);
+      Put(data + 32, _acceleration);
+      Put(data + 40, _effort);
+      ++d.numJointStates;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingWriter::AddContact(const SharedStateContact &_contact)
+    {
+      auto &d = *this->dataPtr;
+      if (!d.slot)
+        return false;
+      if (d.numContacts >= d.ring.layout.maxContacts)
+      {
+        d.truncated = true;
+        return false;
+      }
+
+      uint8_t *data = d.ring.Contacts(d.slot) + d.numContacts * kContactSize;
+      Put<uint64_t>(data, _contact.collision1);
+      Put<uint64_t>(data + 8, _contact.collision2);
+      PutVector(data + 16, _contact.point);
+      PutVector(data + 40, _contact.normal);
+      Put(data + 64, _contact.depth);
+      PutVector(data + 72, _contact.force);
+      ++d.numContacts;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingWriter::EndFrame()
+    {
+      auto &d = *this->dataPtr;
+      if (!d.slot)
+        return false;
+
+      Put(d.slot + kNumPosesOffset, d.numPoses);
+      Put(d.slot + kNumJointStatesOffset, d.numJointStates);
+      Put(d.slot + kNumContactsOffset, d.numContacts);
+      Put(d.slot + kFlagsOffset, d.truncated ? kTruncatedFlag : 0u);
+      reinterpret_cast<Sequence *>(d.slot)->store(
+          d.sequence + 2, std::memory_order_release);
+
+      ++d.frameCount;
+      d.ring.FrameCount()->store(d.frameCount, std::memory_order_release);
+      d.slot = nullptr;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    uint64_t SharedStateRingWriter::FrameCount() const
+    {
+      return this->dataPtr->frameCount;
+    }
+
+    /////////////////////////////////////////////////
+    class SharedStateRingReaderPrivate
+    {
+      /// \brief The ring, with a null memory if there is none. The reader
+      /// never writes to it.
+      public: RingView ring;
+    };
+
+    /////////////////////////////////////////////////
+    SharedStateRingReader::SharedStateRingReader()
+      : dataPtr(new SharedStateRingReaderPrivate)
+    {
+    }
+
+    /////////////////////////////////////////////////
+    SharedStateRingReader::~SharedStateRingReader() = default;
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingReader::Open(
+        const void *_memory, const std::size_t _bytes)
+    {
+      this->Close();
+      if (!_memory || _bytes < kRingHeaderSize ||
+          reinterpret_cast<std::uintptr_t>(_memory) % alignof(Sequence) != 0)
+      {
+        return false;
+      }
+
+      const auto *memory = static_cast<const uint8_t *>(_memory);
+      if (Get<uint32_t>(memory) != kRingMagic ||
+          Get<uint32_t>(memory + 4) != kRingVersion)
+      {
+        return false;
+      }
+
+      SharedStateRingLayout layout;
+      layout.slotCount = Get<uint64_t>(memory + kSlotCountOffset);
+      layout.maxPoses = Get<uint64_t>(memory + kMaxPosesOffset);
+      layout.maxJointStates = Get<uint64_t>(memory + kMaxJointStatesOffset);
+      layout.maxContacts = Get<uint64_t>(memory + kMaxContactsOffset);
+      if (layout.slotCount == 0 || !FitsSlotHeader(layout) ||
+          !FitsInBytes(layout, _bytes) ||
+          Get<uint64_t>(memory + kSlotBytesOffset) != SlotBytes(layout))
+      {
+        return false;
+      }
+
+      auto &ring = this->dataPtr->ring;
+      ring.layout = layout;
+      ring.slotBytes = SlotBytes(layout);
+      ring.memory = const_cast<uint8_t *>(memory);
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    void SharedStateRingReader::Close()
+    {
+      this->dataPtr->ring = RingView();
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingReader::IsOpen() const
+    {
+      return this->dataPtr->ring.memory != nullptr;
+    }
+
+    /////////////////////////////////////////////////
+    const SharedStateRingLayout &SharedStateRingReader::Layout() const
+    {
+      return this->dataPtr->ring.layout;
+    }
+
+    /////////////////////////////////////////////////
+    uint64_t SharedStateRingReader::FrameCount() const
+    {
+      if (!this->IsOpen())
+        return 0u;
+      return this->dataPtr->ring.FrameCount()->load(std::memory_order_acquire);
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingReader::ReadLatest(SharedStateFrame &_frame) const
+    {
+      while (true)
+      {
+        const uint64_t count = this->FrameCount();
+        if (count == 0)
+          return false;
+
+        // The frame can only be lost if the writer overwrote it meanwhile,
+        // in which case there is a later one.
+        if (this->Read(count - 1, _frame))
+          return true;
+      }
+    }
+
+    /////////////////////////////////////////////////
+    bool SharedStateRingReader::Read(
+        const uint64_t _number, SharedStateFrame &_frame) const
+    {
+      const auto &ring = this->dataPtr->ring;
+      while (true)
+      {
+        const uint64_t count = this->FrameCount();
+        if (_number >= count || count - _number > ring.layout.slotCount)
+          return false;
+
+        uint8_t *slot = ring.Slot(_number);
+        const auto *sequence = reinterpret_cast<const Sequence *>(slot);
+        const uint64_t before = sequence->load(std::memory_order_acquire);
+        if (before % 2 != 0)
+        {
+          // The writer is in the middle of this slot
+          std::this_thread::yield();
+          continue;
+        }
+
+        if (Get<uint64_t>(slot + kFrameOffset) != _number)
+          return false;
+
+        // Counts are clamped so that a slot that changes while it is read
+        // does not make the reader leave it.
+        const std::size_t numPoses = std::min<std::size_t>(
+            Get<uint32_t>(slot + kNumPosesOffset), ring.layout.maxPoses);
+        const std::size_t numJointStates = std::min<std::size_t>(
+            Get<uint32_t>(slot + kNumJointStatesOffset),
+            ring.layout.maxJointStates);
+        const std::size_t numContacts = std::min<std::size_t>(
+            Get<uint32_t>(slot + kNumContactsOffset), ring.layout.maxContacts);
+
+        _frame.frame = _number;
+        _frame.time = Get<double>(slot + kTimeOffset);
+        _frame.truncated =
+            (Get<uint32_t>(slot + kFlagsOffset) & kTruncatedFlag) != 0;
+
+        _frame.poses.resize(numPoses);
+        const uint8_t *poses = ring.Poses(slot);
+        for (std::size_t i = 0; i < numPoses; ++i)
+        {
+          const uint8_t *data = poses + i * kPoseSize;
+          auto &pose = _frame.poses[i];
+          pose.body = static_cast<std::size_t>(Get<uint64_t>(data));
+          pose.pose.Pos() = GetVector(data + 8);
+          pose.pose.Rot() = gz::math::Quaterniond(
+              Get<double>(data + 32), Get<double>(data + 40),
+              Get<double>(data + 48), Get<double>(data + 56));
+        }
+
+        auto &joints = _frame.joints;
+        joints.joints.resize(numJointStates);
+        joints.dofs.resize(numJointStates);
+        joints.positions.resize(numJointStates);
+        joints.velocities.resize(numJointStates);
+        joints.accelerations.resize(numJointStates);
+        joints.efforts.resize(numJointStates);
+        const uint8_t *jointStates = ring.JointStates(slot);
+        for (std::size_t i = 0; i < numJointStates; ++i)
+        {
+          const uint8_t *data = jointStates + i * kJointStateSize;
+          joints.joints[i] = static_cast<std::size_t>(Get<uint64_t>(data));
+          joints.dofs[i] = static_cast<std::size_t>(Get<uint64_t>(data + 8));
+          joints.positions[i] = Get<double>(data + 16);
+          joints.velocities[i] = Get<double>(data + 24);
+          joints.accelerations[i] = Get<double>(data + 32);
+          joints.efforts[i] = Get<double>(data + 40);
+        }
+
+        _frame.contacts.resize(numContacts);
+        const uint8_t *contacts = ring.Contacts(slot);
+        for (std::size_t i = 0; i < numContacts; ++i)
+        {
+          const uint8_t *data = contacts + i * kContactSize;
+          auto &contact = _frame.contacts[i];
+          contact.collision1 = static_cast<std::size_t>(Get<uint64_t>(data));
+          contact.collision2 =
+              static_cast<std::size_t>(Get<uint64_t>(data + 8));
+          contact.point = GetVector(data + 16);
+          contact.normal = GetVector(data + 40);
+          contact.depth = Get<double>(data + 64);
+          contact.force = GetVector(data + 72);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence->load(std::memory_order_relaxed) == before)
+          return true;
+      }
+    }
+  }
+}
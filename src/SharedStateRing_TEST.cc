@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gz/physics/SharedStateRing.hh"
+
+using gz::physics::SharedStateContact;
+using gz::physics::SharedStateFrame;
+using gz::physics::SharedStateRingLayout;
+using gz::physics::SharedStateRingReader;
+using gz::physics::SharedStateRingWriter;
+
+/////////////////////////////////////////////////
+/// \brief Memory of a ring, aligned to 8 bytes.
+static std::vector<uint64_t> RingMemory(const SharedStateRingLayout &_layout)
+{
+  return std::vector<uint64_t>(
+      (SharedStateRingWriter::RequiredBytes(_layout) + 7) / 8);
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a frame whose values are all derived from its number.
+static void WriteFrame(SharedStateRingWriter &_writer, const uint64_t _number)
+{
+  const double value = static_cast<double>(_number);
+  ASSERT_TRUE(_writer.BeginFrame(0.001 * value));
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    _writer.AddPose(i, gz::math::Pose3d(value, 1, 2, 0, 0, 0.1 * value));
+    _writer.AddJointState(10 + i, i, value, 2 * value, 3 * value, 4 * value);
+  }
+  SharedStateContact contact;
+  contact.collision1 = 20;
+  contact.collision2 = 21;
+  contact.point = {value, 0, 0};
+  contact.normal = {0, 0, 1};
+  contact.depth = 0.01;
+  contact.force = {0, 0, value};
+  _writer.AddContact(contact);
+  ASSERT_TRUE(_writer.EndFrame());
+}
+
+/////////////////////////////////////////////////
+/// \brief Check that a frame holds the values written by WriteFrame.
+static void ExpectFrame(const SharedStateFrame &_frame,
+                        const uint64_t _number,
+                        const std::size_t _numEntries)
+{
+  const double value = static_cast<double>(_number);
+  EXPECT_EQ(_number, _frame.frame);
+  EXPECT_DOUBLE_EQ(0.001 * value, _frame.time);
+  ASSERT_EQ(_numEntries, _frame.poses.size());
+  ASSERT_EQ(_numEntries, _frame.joints.joints.size());
+  for (std::size_t i = 0; i < _numEntries; ++i)
+  {
+    EXPECT_EQ(i, _frame.poses[i].body);
+    EXPECT_EQ(gz::math::Pose3d(value, 1, 2, 0, 0, 0.1 * value),
+              _frame.poses[i].pose);
+    EXPECT_EQ(10 + i, _frame.joints.joints[i]);
+    EXPECT_EQ(i, _frame.joints.dofs[i]);
+    EXPECT_DOUBLE_EQ(value, _frame.joints.positions[i]);
+    EXPECT_DOUBLE_EQ(2 * value, _frame.joints.velocities[i]);
+    EXPECT_DOUBLE_EQ(3 * value, _frame.joints.accelerations[i]);
+    EXPECT_DOUBLE_EQ(4 * value, _frame.joints.efforts[i]);
+  }
+  ASSERT_EQ(1u, _frame.contacts.size());
+  EXPECT_EQ(20u, _frame.contacts[0].collision1);
+  EXPECT_EQ(21u, _frame.contacts[0].collision2);
+  EXPECT_EQ(gz::math::Vector3d(value, 0, 0), _frame.contacts[0].point);
+  EXPECT_EQ(gz::math::Vector3d(0, 0, 1), _frame.contacts[0].normal);
+  EXPECT_DOUBLE_EQ(0.01, _frame.contacts[0].depth);
+  EXPECT_EQ(gz::math::Vector3d(0, 0, value), _frame.contacts[0].force);
+}
+
+/////////////////////////////////////////////////
+TEST(SharedStateRing_TEST, WriteAndRead)
+{
+  SharedStateRingLayout layout;
+  layout.slotCount = 3;
+  layout.maxPoses = 3;
+  layout.maxJointStates = 3;
+  layout.maxContacts = 1;
+  auto memory = RingMemory(layout);
+  const std::size_t bytes = memory.size() * sizeof(uint64_t);
+
+  SharedStateRingWriter writer;
+  EXPECT_FALSE(writer.BeginFrame(0.0));
+  EXPECT_FALSE(writer.Create(memory.data(), bytes - 8, layout));
+  ASSERT_TRUE(writer.Create(memory.data(), bytes, layout));
+
+  SharedStateRingReader reader;
+  ASSERT_TRUE(reader.Open(memory.data(), bytes));
+  EXPECT_EQ(3u, reader.Layout().slotCount);
+  EXPECT_EQ(0u, reader.FrameCount());
+
+  SharedStateFrame frame;
+  EXPECT_FALSE(reader.ReadLatest(frame));
+
+  for (uint64_t i = 0; i < 5; ++i)
+    WriteFrame(writer, i);
+  EXPECT_EQ(5u, writer.FrameCount());
+  EXPECT_EQ(5u, reader.FrameCount());
+
+  ASSERT_TRUE(reader.ReadLatest(frame));
+  ExpectFrame(frame, 4, 3);
+  EXPECT_FALSE(frame.truncated);
+
+  // The ring keeps the last three frames
+  EXPECT_FALSE(reader.Read(1, frame));
+  for (uint64_t i = 2; i < 5; ++i)
+  {
+    ASSERT_TRUE(reader.Read(i, frame));
+    ExpectFrame(frame, i, 3);
+  }
+  EXPECT_FALSE(reader.Read(5, frame));
+}
+
+/////////////////////////////////////////////////
+TEST(SharedStateRing_TEST, Truncated)
+{
+  SharedStateRingLayout layout;
+  layout.slotCount = 2;
+  layout.maxPoses = 2;
+  layout.maxJointStates = 2;
+  layout.maxContacts = 1;
+  auto memory = RingMemory(layout);
+  const std::size_t bytes = memory.size() * sizeof(uint64_t);
+
+  SharedStateRingWriter writer;
+  ASSERT_TRUE(writer.Create(memory.data(), bytes, layout));
+  WriteFrame(writer, 0);
+
+  SharedStateRingReader reader;
+  ASSERT_TRUE(reader.Open(memory.data(), bytes));
+  SharedStateFrame frame;
+  ASSERT_TRUE(reader.ReadLatest(frame));
+  ExpectFrame(frame, 0, 2);
+  EXPECT_TRUE(frame.truncated);
+}
+
+/////////////////////////////////////////////////
+TEST(SharedStateRing_TEST, InvalidMemory)
+{
+  SharedStateRingLayout layout;
+  layout.maxPoses = 1;
+  auto memory = RingMemory(layout);
+  const std::size_t bytes = memory.size() * sizeof(uint64_t);
+
+  // Nothing was laid out yet
+  SharedStateRingReader reader;
+  EXPECT_FALSE(reader.Open(memory.data(), bytes));
+
+  SharedStateRingWriter writer;
+  layout.slotCount = 0;
+  EXPECT_FALSE(writer.Create(memory.data(), bytes, layout));
+  layout.slotCount = 4;
+  ASSERT_TRUE(writer.Create(memory.data(), bytes, layout));
+  EXPECT_FALSE(reader.Open(memory.data(), bytes - 8));
+  EXPECT_TRUE(reader.Open(memory.data(), bytes));
+
+  // A slot count whose size wraps around is refused. The slots of this
+  // layout are 104 bytes, so 2^61 of them take 13 * 2^64 bytes.
+  memory[1] = uint64_t{1} << 61;
+  EXPECT_FALSE(reader.Open(memory.data(), bytes));
+  memory[1] = 5;
+  EXPECT_FALSE(reader.Open(memory.data(), bytes));
+  memory[1] = 4;
+  EXPECT_TRUE(reader.Open(memory.data(), bytes));
+
+  // A later version of the format is refused
+  reinterpret_cast<uint32_t *>(memory.data())[1] = 2;
+  EXPECT_FALSE(reader.Open(memory.data(), bytes));
+  EXPECT_FALSE(reader.IsOpen());
+}
+
+/////////////////////////////////////////////////
+TEST(SharedStateRing_TEST, ConcurrentReader)
+{
+  SharedStateRingLayout layout;
+  layout.slotCount = 2;
+  layout.maxPoses = 3;
+  layout.maxJointStates = 3;
+  layout.maxContacts = 1;
+  auto memory = RingMemory(layout);
+  const std::size_t bytes = memory.size() * sizeof(uint64_t);
+
+  SharedStateRingWriter writer;
+  ASSERT_TRUE(writer.Create(memory.data(), bytes, layout));
+  SharedStateRingReader reader;
+  ASSERT_TRUE(reader.Open(memory.data(), bytes));
+
+  // Every frame that the reader gets is consistent, even though the writer
+  // keeps overwriting the slots.
+  std::atomic<bool> done{false};
+  std::thread readerThread([&]()
+  {
+    SharedStateFrame frame;
+    uint64_t last = 0;
+    while (!done)
+    {
+      if (!reader.ReadLatest(frame))
+        continue;
+      EXPECT_GE(frame.frame, last);
+      last = frame.frame;
+      ExpectFrame(frame, frame.frame, 3);
+    }
+  });
+
+  for (uint64_t i = 0; i < 20000; ++i)
+    WriteFrame(writer, i);
+  done = true;
+  readerThread.join();
+}
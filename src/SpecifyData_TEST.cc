@@ -579,6 +579,29 @@ TEST(SpecifyData, ConstQueryCounting)
   EXPECT_EQ(2u, data.UnqueriedEntryCount());
 }
 
+/////////////////////////////////////////////////
+TEST(SpecifyData, QueryTracking)
+{
+  RequireStringBoolChar data;
+  data.SetQueryTracking(false);
+
+  // Expected and required data are read without marking them as queried
+  usedExpectedDataAccess = false;
+  data.Get<StringData>().myString = "untracked";
+  EXPECT_NE(nullptr, data.Query<BoolData>());
+  EXPECT_TRUE(usedExpectedDataAccess);
+  usedExpectedDataAccess = false;
+  EXPECT_EQ("untracked",
+            static_cast<const RequireStringBoolChar&>(data)
+              .Get<StringData>().myString);
+  EXPECT_TRUE(usedExpectedDataAccess);
+  EXPECT_EQ(3u, data.UnqueriedEntryCount());
+
+  data.SetQueryTracking(true);
+  data.Get<StringData>();
+  EXPECT_EQ(2u, data.UnqueriedEntryCount());
+}
+
 /////////////////////////////////////////////////
 TEST(SpecifyData, Remove)
 {
@@ -702,6 +725,24 @@ TEST(SpecifyData, CopyExpectData)
   EXPECT_EQ("old_string", copyCtor.Get<StringData>().myString);
 }
 
+/////////////////////////////////////////////////
+TEST(SpecifyData, AssignEmptyExpectData)
+{
+  // Assigning data whose expected entries are empty must keep the entry
+  // count consistent, so the result can still be copied.
+  physics::ExpectData<StringData, BoolData, CharData> empty;
+  physics::ExpectData<StringData, BoolData, CharData> data;
+  data = empty;
+  EXPECT_EQ(0u, data.EntryCount());
+
+  data.Get<StringData>().myString = "string";
+  EXPECT_EQ(1u, data.EntryCount());
+
+  physics::ExpectData<StringData, BoolData, CharData> copyCtor(data);
+  EXPECT_EQ(1u, copyCtor.EntryCount());
+  EXPECT_EQ("string", copyCtor.Get<StringData>().myString);
+}
+
 class ExpectString : public virtual physics::ExpectData<StringData>
 {
 };
@@ -0,0 +1,598 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "gz/physics/StateLog.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    namespace
+    {
+      /// \brief First bytes of a state log file.
+      constexpr char kFileMagic[8] = {'G', 'Z', 'P', 'H', 'L', 'O', 'G', '1'};
+
+      /// \brief First bytes of a chunk.
+      constexpr char kChunkMagic[4] = {'C', 'H', 'N', 'K'};
+
+      /// \brief Size of a chunk header: the magic, the number of frames and
+      /// the number of bytes of the frames.
+      constexpr std::size_t kChunkHeaderSize = 4 + 4 + 8;
+
+      /// \brief Size of a frame header after its size: the time, the
+      /// iteration and the number of channels.
+      constexpr std::size_t kFrameHeaderSize = 8 + 8 + 4;
+
+      /// \brief Size of a channel header: the ID and the number of bytes.
+      constexpr std::size_t kChannelHeaderSize = 4 + 8;
+
+      /////////////////////////////////////////////////
+      /// \brief Append an integer in little endian byte order.
+      template <typename T>
+      void Put(const T _value, std::vector<uint8_t> &_buffer)
+      {
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+          _buffer.push_back(static_cast<uint8_t>(_value >> (8 * i)));
+      }
+
+      /////////////////////////////////////////////////
+      /// \brief Overwrite an integer in little endian byte order.
+      template <typename T>
+      void PutAt(const T _value, uint8_t *_data)
+      {
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+          _data[i] = static_cast<uint8_t>(_value >> (8 * i));
+      }
+
+      /////////////////////////////////////////////////
+      /// \brief Read an integer in little endian byte order.
+      template <typename T>
+      T Get(const uint8_t *_data)
+      {
+        T value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+          value |= static_cast<T>(static_cast<T>(_data[i]) << (8 * i));
+        return value;
+      }
+
+      /////////////////////////////////////////////////
+      uint64_t DoubleBits(const double _value)
+      {
+        uint64_t bits;
+        std::memcpy(&bits, &_value, sizeof(double));
+        return bits;
+      }
+
+      /////////////////////////////////////////////////
+      double BitsDouble(const uint64_t _bits)
+      {
+        double value;
+        std::memcpy(&value, &_bits, sizeof(double));
+        return value;
+      }
+    }
+
+    /////////////////////////////////////////////////
+    class StateLogWriterPrivate
+    {
+      /// \brief Write the frames of the current chunk.
+      /// \return False if the chunk could not be written.
+      public: bool WriteChunk();
+
+      /// \brief Open file, or nullptr.
+      public: std::FILE *file = nullptr;
+
+      /// \brief Size from which a chunk is written.
+      public: std::size_t chunkBytes = 0;
+
+      /// \brief Header and frames of the current chunk.
+      public: std::vector<uint8_t> chunk;
+
+      /// \brief Number of frames of the current chunk.
+      public: uint32_t chunkFrames = 0;
+
+      /// \brief Offset in chunk of the current frame, if one was started.
+      public: std::size_t frameStart = 0;
+
+      /// \brief Whether a frame was started.
+      public: bool inFrame = false;
+
+      /// \brief Number of channels of the current frame.
+      public: uint32_t frameChannels = 0;
+
+      /// \brief Number of frames ended since the file was opened.
+      public: std::size_t frameCount = 0;
+    };
+
+    /////////////////////////////////////////////////
+    bool StateLogWriterPrivate::WriteChunk()
+    {
+      if (this->chunkFrames == 0)
+        return true;
+
+      PutAt<uint32_t>(this->chunkFrames, this->chunk.data() + 4);
+      PutAt<uint64_t>(this->chunk.size() - kChunkHeaderSize,
+                      this->chunk.data() + 8);
+      const bool written = std::fwrite(this->chunk.data(), 1,
+          this->chunk.size(), this->file) == this->chunk.size() &&
+          std::fflush(this->file) == 0;
+
+      this->chunk.resize(kChunkHeaderSize);
+      this->chunkFrames = 0;
+      return written;
+    }
+
+    /////////////////////////////////////////////////
+    StateLogWriter::StateLogWriter()
+      : dataPtr(new StateLogWriterPrivate)
+    {
+    }
+
+    /////////////////////////////////////////////////
+    StateLogWriter::~StateLogWriter()
+    {
+      this->Close();
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogWriter::Open(const std::string &_path,
+                              const std::size_t _chunkBytes)
+    {
+      this->Close();
+
+      auto &d = *this->dataPtr;
+      d.file = std::fopen(_path.c_str(), "wb");
+      if (!d.file)
+        return false;
+
+      if (std::fwrite(kFileMagic, 1, sizeof(kFileMagic), d.file) !=
+          sizeof(kFileMagic))
+      {
+        this->Close();
+        return false;
+      }
+
+      d.chunkBytes = _chunkBytes;
+      d.chunk.clear();
+      d.chunk.insert(d.chunk.end(), kChunkMagic,
+                     kChunkMagic + sizeof(kChunkMagic));
+      d.chunk.resize(kChunkHeaderSize);
+      d.chunkFrames = 0;
+      d.inFrame = false;
+      d.frameCount = 0;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    void StateLogWriter::Close()
+    {
+      auto &d = *this->dataPtr;
+      if (!d.file)
+        return;
+
+      if (d.inFrame)
+        this->EndFrame();
+      d.WriteChunk();
+      std::fclose(d.file);
+      d.file = nullptr;
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogWriter::IsOpen() const
+    {
+      return this->dataPtr->file != nullptr;
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogWriter::BeginFrame(const double _time,
+                                    const uint64_t _iteration)
+    {
+      auto &d = *this->dataPtr;
+      if (!d.file)
+        return false;
+
+      if (d.inFrame && !this->EndFrame())
+        return false;
+
+      d.frameStart = d.chunk.size();
+      Put<uint64_t>(0, d.chunk);
+      Put<uint64_t>(DoubleBits(_time), d.chunk);
+      Put<uint64_t>(_iteration, d.chunk);
+      Put<uint32_t>(0, d.chunk);
+      d.frameChannels = 0;
+      d.inFrame = true;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogWriter::AddChannel(const uint32_t _channel,
+                                    const uint8_t *_data,
+                                    const std::size_t _size)
+    {
+      auto &d = *this->dataPtr;
+      if (!d.inFrame || (!_data && _size > 0))
+        return false;
+
+      Put<uint32_t>(_channel, d.chunk);
+      Put<uint64_t>(_size, d.chunk);
+      if (_size > 0)
+        d.chunk.insert(d.chunk.end(), _data, _data + _size);
+      ++d.frameChannels;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogWriter::AddChannel(const uint32_t _channel,
+                                    const std::vector<uint8_t> &_data)
+    {
+      return this->AddChannel(_channel, _data.data(), _data.size());
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogWriter::EndFrame()
+    {
+      auto &d = *this->dataPtr;
+      if (!d.inFrame)
+        return false;
+
+      uint8_t *frame = d.chunk.data() + d.frameStart;
+      PutAt<uint64_t>(d.chunk.size() - d.frameStart - 8, frame);
+      PutAt<uint32_t>(d.frameChannels, frame + 8 + kFrameHeaderSize - 4);
+      d.inFrame = false;
+      ++d.chunkFrames;
+      ++d.frameCount;
+
+      if (d.chunk.size() >= d.chunkBytes)
+        return d.WriteChunk();
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogWriter::Flush()
+    {
+      if (!this->dataPtr->file)
+        return false;
+      return this->dataPtr->WriteChunk();
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t StateLogWriter::FrameCount() const
+    {
+      return this->dataPtr->frameCount;
+    }
+
+    /////////////////////////////////////////////////
+    class StateLogReaderPrivate
+    {
+      /// \brief A frame of the log.
+      public: struct Frame
+      {
+        /// \brief Offset of the first channel header.
+        std::size_t channels;
+        /// \brief Offset of the end of the frame.
+        std::size_t end;
+        /// \brief Number of channels.
+        uint32_t channelCount;
+        /// \brief Simulation time.
+        double time;
+        /// \brief Step number.
+        uint64_t iteration;
+      };
+
+      /// \brief Index the frames of the file.
+      /// \return False if the file is not a state log.
+      public: bool Index();
+
+      /// \brief Start of the file.
+      public: const uint8_t *data = nullptr;
+
+      /// \brief Size of the file.
+      public: std::size_t size = 0;
+
+#ifdef _WIN32
+      /// \brief Contents of the file, where it is not memory mapped.
+      public: std::vector<uint8_t> contents;
+#endif
+
+      /// \brief Frames of the file.
+      public: std::vector<Frame> frames;
+
+      /// \brief See StateLogReader::Truncated.
+      public: bool truncated = false;
+    };
+
+    /////////////////////////////////////////////////
+    bool StateLogReaderPrivate::Index()
+    {
+      if (this->size < sizeof(kFileMagic) ||
+          std::memcmp(this->data, kFileMagic, sizeof(kFileMagic)) != 0)
+      {
+        return false;
+      }
+
+      std::size_t offset = sizeof(kFileMagic);
+      while (offset < this->size)
+      {
+        // Stop at the first chunk that was not completely written
+        if (this->size - offset < kChunkHeaderSize ||
+            std::memcmp(this->data + offset, kChunkMagic,
+                        sizeof(kChunkMagic)) != 0)
+        {
+          this->truncated = true;
+          break;
+        }
+
+        const uint32_t frameCount = Get<uint32_t>(this->data + offset + 4);
+        const uint64_t chunkSize = Get<uint64_t>(this->data + offset + 8);
+        const std::size_t chunkStart = offset + kChunkHeaderSize;
+        if (chunkSize > this->size - chunkStart)
+        {
+          this->truncated = true;
+          break;
+        }
+        const std::size_t chunkEnd =
+            chunkStart + static_cast<std::size_t>(chunkSize);
+
+        // Only keep the frames of a chunk if all of them are valid
+        const std::size_t firstFrame = this->frames.size();
+        std::size_t frameOffset = chunkStart;
+        bool valid = true;
+        for (uint32_t i = 0; i < frameCount && valid; ++i)
+        {
+          if (chunkEnd - frameOffset < 8 + kFrameHeaderSize)
+          {
+            valid = false;
+            break;
+          }
+
+          const uint64_t frameSize = Get<uint64_t>(this->data + frameOffset);
+          const std::size_t frameStart = frameOffset + 8;
+          if (frameSize < kFrameHeaderSize ||
+              frameSize > chunkEnd - frameStart)
+          {
+            valid = false;
+            break;
+          }
+
+          Frame frame;
+          frame.time = BitsDouble(Get<uint64_t>(this->data + frameStart));
+          frame.iteration = Get<uint64_t>(this->data + frameStart + 8);
+          frame.channelCount = Get<uint32_t>(this->data + frameStart + 16);
+          frame.channels = frameStart + kFrameHeaderSize;
+          frame.end = frameStart + static_cast<std::size_t>(frameSize);
+
+          // Check that the channels fit in the frame
+          std::size_t channel = frame.channels;
+          for (uint32_t c = 0; c < frame.channelCount; ++c)
+          {
+            if (frame.end - channel < kChannelHeaderSize)
+            {
+              valid = false;
+              break;
+            }
+            const uint64_t channelSize =
+                Get<uint64_t>(this->data + channel + 4);
+            channel += kChannelHeaderSize;
+            if (channelSize > frame.end - channel)
+            {
+              valid = false;
+              break;
+            }
+            channel += static_cast<std::size_t>(channelSize);
+          }
+
+          this->frames.push_back(frame);
+          frameOffset = frame.end;
+        }
+
+        if (!valid)
+        {
+          this->frames.resize(firstFrame);
+          this->truncated = true;
+          break;
+        }
+
+        offset = chunkEnd;
+      }
+
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    StateLogReader::StateLogReader()
+      : dataPtr(new StateLogReaderPrivate)
+    {
+    }
+
+    /////////////////////////////////////////////////
+    StateLogReader::~StateLogReader()
+    {
+      this->Close();
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogReader::Open(const std::string &_path)
+    {
+      this->Close();
+      auto &d = *this->dataPtr;
+
+#ifdef _WIN32
+      std::ifstream file(_path, std::ios::binary);
+      if (!file)
+        return false;
+      d.contents.assign(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>());
+      d.data = d.contents.data();
+      d.size = d.contents.size();
+#else
+      const int fd = ::open(_path.c_str(), O_RDONLY);
+      if (fd < 0)
+        return false;
+
+      struct stat info;
+      if (::fstat(fd, &info) != 0 || info.st_size <= 0)
+      {
+        ::close(fd);
+        return false;
+      }
+
+      void *mapped = ::mmap(nullptr, static_cast<std::size_t>(info.st_size),
+                            PROT_READ, MAP_PRIVATE, fd, 0);
+      // The mapping stays valid after the file is closed
+      ::close(fd);
+      if (mapped == MAP_FAILED)
+        return false;
+
+      d.data = static_cast<const uint8_t *>(mapped);
+      d.size = static_cast<std::size_t>(info.st_size);
+#endif
+
+      if (!d.Index())
+      {
+        this->Close();
+        return false;
+      }
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    void StateLogReader::Close()
+    {
+      auto &d = *this->dataPtr;
+#ifdef _WIN32
+      d.contents.clear();
+      d.contents.shrink_to_fit();
+#else
+      if (d.data)
+        ::munmap(const_cast<uint8_t *>(d.data), d.size);
+#endif
+      d.data = nullptr;
+      d.size = 0;
+      d.frames.clear();
+      d.truncated = false;
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogReader::IsOpen() const
+    {
+      return this->dataPtr->data != nullptr;
+    }
+
+    /////////////////////////////////////////////////
+    bool StateLogReader::Truncated() const
+    {
+      return this->dataPtr->truncated;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t StateLogReader::FrameCount() const
+    {
+      return this->dataPtr->frames.size();
+    }
+
+    /////////////////////////////////////////////////
+    double StateLogReader::FrameTime(const std::size_t _frame) const
+    {
+      if (_frame >= this->dataPtr->frames.size())
+        return std::numeric_limits<double>::quiet_NaN();
+      return this->dataPtr->frames[_frame].time;
+    }
+
+    /////////////////////////////////////////////////
+    uint64_t StateLogReader::FrameIteration(const std::size_t _frame) const
+    {
+      if (_frame >= this->dataPtr->frames.size())
+        return 0;
+      return this->dataPtr->frames[_frame].iteration;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t StateLogReader::FindFrame(const double _time) const
+    {
+      const auto &frames = this->dataPtr->frames;
+      const auto it = std::upper_bound(frames.begin(), frames.end(), _time,
+          [](const double _t, const StateLogReaderPrivate::Frame &_frame)
+          {
+            return _t < _frame.time;
+          });
+      if (it == frames.begin())
+        return frames.size();
+      return static_cast<std::size_t>(std::distance(frames.begin(), it)) - 1;
+    }
+
+    /////////////////////////////////////////////////
+    std::vector<uint32_t> StateLogReader::Channels(
+        const std::size_t _frame) const
+    {
+      std::vector<uint32_t> channels;
+      const auto &d = *this->dataPtr;
+      if (_frame >= d.frames.size())
+        return channels;
+
+      const auto &frame = d.frames[_frame];
+      std::size_t offset = frame.channels;
+      for (uint32_t c = 0; c < frame.channelCount; ++c)
+      {
+        channels.push_back(Get<uint32_t>(d.data + offset));
+        offset += kChannelHeaderSize + static_cast<std::size_t>(
+            Get<uint64_t>(d.data + offset + 4));
+      }
+      return channels;
+    }
+
+    /////////////////////////////////////////////////
+    StateLogChannelView StateLogReader::Channel(
+        const std::size_t _frame, const uint32_t _channel) const
+    {
+      StateLogChannelView view;
+      const auto &d = *this->dataPtr;
+      if (_frame >= d.frames.size())
+        return view;
+
+      const auto &frame = d.frames[_frame];
+      std::size_t offset = frame.channels;
+      for (uint32_t c = 0; c < frame.channelCount; ++c)
+      {
+        const std::size_t size = static_cast<std::size_t>(
+            Get<uint64_t>(d.data + offset + 4));
+        if (Get<uint32_t>(d.data + offset) == _channel)
+        {
+          view.data = d.data + offset + kChannelHeaderSize;
+          view.size = size;
+          return view;
+        }
+        offset += kChannelHeaderSize + size;
+      }
+      return view;
+    }
+  }
+}
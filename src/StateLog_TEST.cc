@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gz/physics/StateLog.hh"
+
+using gz::physics::StateLogChannelView;
+using gz::physics::StateLogReader;
+using gz::physics::StateLogWriter;
+namespace StateLogChannel = gz::physics::StateLogChannel;
+
+/////////////////////////////////////////////////
+class StateLog_TEST : public ::testing::Test
+{
+  protected: void SetUp() override
+  {
+    this->path = (std::filesystem::temp_directory_path() /
+        ("state_log_" + std::string(::testing::UnitTest::GetInstance()
+            ->current_test_info()->name()) + ".log")).string();
+  }
+
+  protected: void TearDown() override
+  {
+    std::filesystem::remove(this->path);
+  }
+
+  /// \brief Bytes of the snapshot channel of a frame.
+  protected: static std::vector<uint8_t> Snapshot(std::size_t _frame)
+  {
+    return std::vector<uint8_t>(_frame % 7 + 1,
+                                static_cast<uint8_t>(_frame));
+  }
+
+  protected: std::string path;
+};
+
+/////////////////////////////////////////////////
+TEST_F(StateLog_TEST, WriteAndSeek)
+{
+  {
+    StateLogWriter writer;
+    ASSERT_TRUE(writer.Open(this->path, 64));
+    EXPECT_FALSE(writer.AddChannel(StateLogChannel::kSnapshot, Snapshot(0)));
+
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      ASSERT_TRUE(writer.BeginFrame(0.001 * static_cast<double>(i), 10 + i));
+      ASSERT_TRUE(writer.AddChannel(StateLogChannel::kSnapshot, Snapshot(i)));
+      if (i % 10 == 0)
+      {
+        const std::vector<uint8_t> user = {1, 2, 3};
+        ASSERT_TRUE(writer.AddChannel(StateLogChannel::kUser, user));
+      }
+      ASSERT_TRUE(writer.EndFrame());
+    }
+    EXPECT_EQ(100u, writer.FrameCount());
+  }
+
+  StateLogReader reader;
+  ASSERT_TRUE(reader.Open(this->path));
+  EXPECT_FALSE(reader.Truncated());
+  ASSERT_EQ(100u, reader.FrameCount());
+
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    EXPECT_DOUBLE_EQ(0.001 * static_cast<double>(i), reader.FrameTime(i));
+    EXPECT_EQ(10 + i, reader.FrameIteration(i));
+
+    const StateLogChannelView view =
+        reader.Channel(i, StateLogChannel::kSnapshot);
+    ASSERT_NE(nullptr, view.data);
+    EXPECT_EQ(Snapshot(i), std::vector<uint8_t>(
+        view.data, view.data + view.size));
+
+    if (i % 10 == 0)
+    {
+      EXPECT_EQ(std::vector<uint32_t>(
+          {StateLogChannel::kSnapshot, StateLogChannel::kUser}),
+          reader.Channels(i));
+      EXPECT_EQ(3u, reader.Channel(i, StateLogChannel::kUser).size);
+    }
+    else
+    {
+      EXPECT_EQ(nullptr, reader.Channel(i, StateLogChannel::kUser).data);
+    }
+  }
+
+  EXPECT_EQ(42u, reader.FindFrame(0.0425));
+  EXPECT_EQ(99u, reader.FindFrame(10.0));
+  EXPECT_EQ(reader.FrameCount(), reader.FindFrame(-1.0));
+  EXPECT_TRUE(std::isnan(reader.FrameTime(100)));
+  EXPECT_EQ(nullptr, reader.Channel(100, StateLogChannel::kSnapshot).data);
+}
+
+/////////////////////////////////////////////////
+TEST_F(StateLog_TEST, TruncatedChunk)
+{
+  {
+    StateLogWriter writer;
+    ASSERT_TRUE(writer.Open(this->path, 1u << 20));
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+      ASSERT_TRUE(writer.BeginFrame(static_cast<double>(i), i));
+      ASSERT_TRUE(writer.AddChannel(StateLogChannel::kSnapshot, Snapshot(i)));
+      ASSERT_TRUE(writer.EndFrame());
+      if (i == 3)
+      {
+        ASSERT_TRUE(writer.Flush());
+      }
+    }
+  }
+
+  // Cut the last chunk short, as if the recording process had stopped
+  const auto size = std::filesystem::file_size(this->path);
+  std::filesystem::resize_file(this->path, size - 5);
+
+  StateLogReader reader;
+  ASSERT_TRUE(reader.Open(this->path));
+  EXPECT_TRUE(reader.Truncated());
+  EXPECT_EQ(4u, reader.FrameCount());
+  EXPECT_EQ(3u, reader.FrameIteration(3));
+}
+
+/////////////////////////////////////////////////
+TEST_F(StateLog_TEST, InvalidFile)
+{
+  StateLogReader reader;
+  EXPECT_FALSE(reader.Open(this->path));
+
+  {
+    std::ofstream file(this->path, std::ios::binary);
+    file << "not a state log";
+  }
+  EXPECT_FALSE(reader.Open(this->path));
+  EXPECT_FALSE(reader.IsOpen());
+  EXPECT_EQ(0u, reader.FrameCount());
+}
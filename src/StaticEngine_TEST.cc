@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <gz/physics/GetEntities.hh>
+#include <gz/physics/Implements.hh>
+#include <gz/physics/StaticEngine.hh>
+
+using namespace gz;
+using namespace physics;
+
+/////////////////////////////////////////////////
+class CounterFeature : public virtual Feature
+{
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual std::size_t Increment(const Identity &_engineID) = 0;
+
+    public: virtual std::size_t Count(const Identity &_engineID) const = 0;
+  };
+};
+
+/////////////////////////////////////////////////
+class UnimplementedFeature : public virtual Feature
+{
+  public: template <typename PolicyT>
+  class Implementation : public virtual Feature::Implementation<PolicyT>
+  {
+    public: virtual void Unimplemented() = 0;
+  };
+};
+
+using StaticFeatures = FeatureList<GetEngineInfo, CounterFeature>;
+
+/////////////////////////////////////////////////
+class StaticImplementation final
+  : public virtual Implements3d<StaticFeatures>
+{
+  public: Identity InitiateEngine(std::size_t _engineID) override
+  {
+    return this->GenerateIdentity(_engineID);
+  }
+
+  public: const std::string &GetEngineName(const Identity &) const override
+  {
+    return this->name;
+  }
+
+  public: std::size_t GetEngineIndex(const Identity &_engineID) const override
+  {
+    return _engineID.id;
+  }
+
+  public: std::size_t Increment(const Identity &) override
+  {
+    return ++this->count;
+  }
+
+  public: std::size_t Count(const Identity &) const override
+  {
+    return this->count;
+  }
+
+  private: std::string name = "static";
+
+  private: std::size_t count = 0u;
+};
+
+static_assert(detail::ImplementsAllFeatures<FeaturePolicy3d,
+    StaticImplementation, StaticFeatures::Features>::value);
+static_assert(!detail::ImplementsAllFeatures<FeaturePolicy3d,
+    StaticImplementation,
+    FeatureList<CounterFeature, UnimplementedFeature>::Features>::value);
+
+/////////////////////////////////////////////////
+TEST(StaticEngine_TEST, Dispatch)
+{
+  StaticEngine3d<StaticImplementation, StaticFeatures> engine(2u);
+  EXPECT_EQ(2u, engine.EngineIdentity().id);
+
+  const auto &info = engine.Interface<GetEngineInfo>();
+  EXPECT_EQ("static", info.GetEngineName(engine.EngineIdentity()));
+  EXPECT_EQ(2u, info.GetEngineIndex(engine.EngineIdentity()));
+
+  // Interfaces are the implementation itself.
+  auto &counter = engine.Interface<CounterFeature>();
+  EXPECT_EQ(static_cast<CounterFeature::Implementation<FeaturePolicy3d> *>(
+      &engine.Get()), &counter);
+
+  EXPECT_EQ(1u, counter.Increment(engine.EngineIdentity()));
+  EXPECT_EQ(2u, engine.Get().Increment(engine.EngineIdentity()));
+
+  const auto &constEngine = engine;
+  EXPECT_EQ(2u, constEngine.Interface<CounterFeature>().Count(
+      constEngine.EngineIdentity()));
+  EXPECT_EQ(2u, constEngine.Get().Count(constEngine.EngineIdentity()));
+}
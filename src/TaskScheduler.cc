@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "gz/physics/TaskScheduler.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    TaskScheduler::~TaskScheduler() = default;
+
+    /////////////////////////////////////////////////
+    class ThreadPoolTaskSchedulerPrivate
+    {
+      /// \brief Tasks of a call to Run.
+      public: struct Batch
+      {
+        /// \brief Task to call with the index of each task.
+        const std::function<void(std::size_t)> *task;
+
+        /// \brief Number of tasks.
+        std::size_t count;
+
+        /// \brief Index of the next task to start.
+        std::size_t next;
+
+        /// \brief Number of tasks that returned.
+        std::size_t done;
+      };
+
+      /// \brief Start a queued task and wait for it to return. The mutex
+      /// must be locked, and is unlocked while the task runs.
+      /// \param[in,out] _lock Lock of the mutex.
+      /// \param[in] _preferred Batch to take the task from if it has tasks
+      /// left to start, or nullptr to take it from the oldest batch.
+      /// \return False if no task was queued.
+      public: bool RunQueuedTask(
+          std::unique_lock<std::mutex> &_lock, Batch *_preferred);
+
+      /// \brief Run queued tasks until the scheduler is destroyed.
+      public: void Work();
+
+      /// \brief Start the workers.
+      /// \param[in] _count Number of workers.
+      public: void StartWorkers(std::size_t _count);
+
+      /// \brief Guards the batches and stop.
+      public: std::mutex mutex;
+
+      /// \brief Signaled when a batch is queued or finished.
+      public: std::condition_variable changed;
+
+      /// \brief Batches with tasks left to start, oldest first.
+      public: std::deque<Batch *> batches;
+
+      /// \brief True when the workers should exit.
+      public: bool stop = false;
+
+      /// \brief Number of threads, including the calling thread.
+      public: std::size_t numThreads = 1u;
+
+      /// \brief Worker threads.
+      public: std::vector<std::thread> workers;
+
+      /// \brief Cores that the workers are pinned to, empty if they are not.
+      /// Threads that are not workers then only wait in Run.
+      public: std::vector<std::size_t> cores;
+    };
+
+    /// \brief Scheduler whose worker the current thread is, if any.
+    static thread_local const ThreadPoolTaskSchedulerPrivate *tlsScheduler =
+        nullptr;
+
+    /////////////////////////////////////////////////
+    /// \brief Pin a thread to a set of cores.
+    /// \param[in] _thread Thread to pin.
+    /// \param[in] _cores Indices of the cores.
+    static void PinThread(std::thread &_thread,
+                          const std::vector<std::size_t> &_cores)
+    {
+#ifdef __linux__
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (const std::size_t core : _cores)
+      {
+        if (core < CPU_SETSIZE)
+          CPU_SET(core, &set);
+      }
+      pthread_setaffinity_np(_thread.native_handle(), sizeof(set), &set);
+#else
+      (void)_thread;
+      (void)_cores;
+#endif
+    }
+
+    /////////////////////////////////////////////////
+    bool ThreadPoolTaskSchedulerPrivate::RunQueuedTask(
+        std::unique_lock<std::mutex> &_lock, Batch *_preferred)
+    {
+      Batch *batch = _preferred;
+      if (!batch || batch->next == batch->count)
+      {
+        if (this->batches.empty())
+          return false;
+        batch = this->batches.front();
+      }
+
+      const std::size_t index = batch->next++;
+      if (batch->next == batch->count)
+      {
+        this->batches.erase(
+            std::find(this->batches.begin(), this->batches.end(), batch));
+      }
+
+      _lock.unlock();
+      (*batch->task)(index);
+      _lock.lock();
+
+      if (++batch->done == batch->count)
+        this->changed.notify_all();
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    void ThreadPoolTaskSchedulerPrivate::StartWorkers(const std::size_t _count)
+    {
+      this->workers.reserve(_count);
+      for (std::size_t i = 0u; i < _count; ++i)
+        this->workers.emplace_back([this]() { this->Work(); });
+    }
+
+    /////////////////////////////////////////////////
+    void ThreadPoolTaskSchedulerPrivate::Work()
+    {
+      tlsScheduler = this;
+      std::unique_lock<std::mutex> lock(this->mutex);
+      while (!this->stop)
+      {
+        if (!this->RunQueuedTask(lock, nullptr))
+          this->changed.wait(lock);
+      }
+    }
+
+    /////////////////////////////////////////////////
+    ThreadPoolTaskScheduler::ThreadPoolTaskScheduler(
+        const std::size_t _numThreads)
+      : dataPtr(new ThreadPoolTaskSchedulerPrivate)
+    {
+      auto &d = *this->dataPtr;
+      d.numThreads = _numThreads;
+      if (d.numThreads == 0u)
+        d.numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+      d.StartWorkers(d.numThreads - 1u);
+    }
+
+    /////////////////////////////////////////////////
+    ThreadPoolTaskScheduler::ThreadPoolTaskScheduler(
+        const std::vector<std::size_t> &_cores)
+      : ThreadPoolTaskScheduler(_cores.empty() ? 0u : 1u)
+    {
+      if (_cores.empty())
+        return;
+
+      auto &d = *this->dataPtr;
+      d.cores = _cores;
+      d.numThreads = _cores.size();
+      d.StartWorkers(d.numThreads);
+      for (std::thread &worker : d.workers)
+        PinThread(worker, d.cores);
+    }
+
+    /////////////////////////////////////////////////
+    ThreadPoolTaskScheduler::~ThreadPoolTaskScheduler()
+    {
+      auto &d = *this->dataPtr;
+      {
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.stop = true;
+      }
+      d.changed.notify_all();
+      for (std::thread &worker : d.workers)
+        worker.join();
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t ThreadPoolTaskScheduler::GetNumThreads() const
+    {
+      return this->dataPtr->numThreads;
+    }
+
+    /////////////////////////////////////////////////
+    const std::vector<std::size_t> &ThreadPoolTaskScheduler::GetCores() const
+    {
+      return this->dataPtr->cores;
+    }
+
+    /////////////////////////////////////////////////
+    void ThreadPoolTaskScheduler::Run(
+        const std::size_t _count,
+        const std::function<void(std::size_t)> &_task)
+    {
+      auto &d = *this->dataPtr;
+      const bool runsTasks = d.cores.empty() || tlsScheduler == &d;
+      if (_count == 0u || d.workers.empty() || (_count == 1u && runsTasks))
+      {
+        for (std::size_t i = 0u; i < _count; ++i)
+          _task(i);
+        return;
+      }
+
+      ThreadPoolTaskSchedulerPrivate::Batch batch{&_task, _count, 0u, 0u};
+      std::unique_lock<std::mutex> lock(d.mutex);
+      d.batches.push_back(&batch);
+      d.changed.notify_all();
+
+      // Waiting runs other tasks, including those of other callers once
+      // the tasks of this one have all started, so nested calls make
+      // progress even when every worker is waiting
+      while (batch.done != batch.count)
+      {
+        if (!runsTasks || !d.RunQueuedTask(lock, &batch))
+          d.changed.wait(lock);
+      }
+    }
+
+    /////////////////////////////////////////////////
+    std::shared_ptr<TaskScheduler> DefaultTaskScheduler()
+    {
+      static const std::shared_ptr<TaskScheduler> scheduler =
+          std::make_shared<ThreadPoolTaskScheduler>();
+      return scheduler;
+    }
+  }
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "gz/physics/TaskScheduler.hh"
+
+using gz::physics::TaskScheduler;
+using gz::physics::ThreadPoolTaskScheduler;
+
+/////////////////////////////////////////////////
+TEST(TaskScheduler_TEST, Run)
+{
+  ThreadPoolTaskScheduler scheduler(4u);
+  EXPECT_EQ(4u, scheduler.GetNumThreads());
+
+  // Each task runs exactly once
+  std::vector<std::atomic<int>> calls(1000u);
+  scheduler.Run(calls.size(), [&](std::size_t _i) { ++calls[_i]; });
+  for (const auto &count : calls)
+    EXPECT_EQ(1, count.load());
+
+  scheduler.Run(0u, [&](std::size_t) { ADD_FAILURE(); });
+}
+
+/////////////////////////////////////////////////
+TEST(TaskScheduler_TEST, SingleThread)
+{
+  ThreadPoolTaskScheduler scheduler(1u);
+  EXPECT_EQ(1u, scheduler.GetNumThreads());
+
+  // The tasks run in order on the calling thread
+  std::vector<std::size_t> order;
+  const auto caller = std::this_thread::get_id();
+  scheduler.Run(5u, [&](std::size_t _i)
+  {
+    EXPECT_EQ(caller, std::this_thread::get_id());
+    order.push_back(_i);
+  });
+  EXPECT_EQ(std::vector<std::size_t>({0, 1, 2, 3, 4}), order);
+}
+
+/////////////////////////////////////////////////
+TEST(TaskScheduler_TEST, Nested)
+{
+  // More nested calls than threads, which only finish if waiting threads
+  // run the tasks of others
+  ThreadPoolTaskScheduler scheduler(2u);
+  std::atomic<std::size_t> total{0u};
+  scheduler.Run(8u, [&](std::size_t)
+  {
+    scheduler.Run(8u, [&](std::size_t)
+    {
+      scheduler.Run(4u, [&](std::size_t) { ++total; });
+    });
+  });
+  EXPECT_EQ(256u, total.load());
+}
+
+/////////////////////////////////////////////////
+TEST(TaskScheduler_TEST, ConcurrentCallers)
+{
+  ThreadPoolTaskScheduler scheduler(3u);
+  std::atomic<std::size_t> total{0u};
+  std::vector<std::thread> callers;
+  for (int i = 0; i < 4; ++i)
+  {
+    callers.emplace_back([&]()
+    {
+      for (int j = 0; j < 50; ++j)
+        scheduler.Run(10u, [&](std::size_t) { ++total; });
+    });
+  }
+  for (auto &caller : callers)
+    caller.join();
+  EXPECT_EQ(2000u, total.load());
+}
+
+/////////////////////////////////////////////////
+TEST(TaskScheduler_TEST, Pinned)
+{
+  ThreadPoolTaskScheduler scheduler(std::vector<std::size_t>{0u});
+  EXPECT_EQ(1u, scheduler.GetNumThreads());
+  ASSERT_EQ(1u, scheduler.GetCores().size());
+
+  // Tasks run on the workers, never on the calling thread, also when
+  // there is only one, and nested calls run on the worker that makes them
+  const std::thread::id caller = std::this_thread::get_id();
+  std::atomic<std::size_t> onCaller{0u};
+  std::atomic<std::size_t> total{0u};
+  scheduler.Run(1u, [&](std::size_t)
+  {
+    onCaller += std::this_thread::get_id() == caller;
+    scheduler.Run(4u, [&](std::size_t)
+    {
+      onCaller += std::this_thread::get_id() == caller;
+      ++total;
+    });
+  });
+  EXPECT_EQ(0u, onCaller.load());
+  EXPECT_EQ(4u, total.load());
+
+  ThreadPoolTaskScheduler unpinned(std::vector<std::size_t>{});
+  EXPECT_TRUE(unpinned.GetCores().empty());
+  EXPECT_LE(1u, unpinned.GetNumThreads());
+}
+
+/////////////////////////////////////////////////
+TEST(TaskScheduler_TEST, Default)
+{
+  const auto scheduler = gz::physics::DefaultTaskScheduler();
+  ASSERT_NE(nullptr, scheduler);
+  EXPECT_EQ(scheduler, gz::physics::DefaultTaskScheduler());
+  EXPECT_LE(1u, scheduler->GetNumThreads());
+}
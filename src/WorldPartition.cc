@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <map>
+
+#include "gz/physics/WorldPartition.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    class WorldPartitionPrivate
+    {
+      /// \brief A body of the partition.
+      public: struct Body
+      {
+        /// \brief Region that owns the body.
+        std::size_t owner = WorldPartition::kNoRegion;
+
+        /// \brief Regions that keep a ghost of the body, in increasing
+        /// order.
+        std::vector<std::size_t> ghosts;
+
+        /// \brief Number of the last update that the body was passed to.
+        std::size_t lastUpdate = 0;
+      };
+
+      /// \brief Get the cell of a coordinate along one axis.
+      /// \param[in] _axis Axis of the coordinate.
+      /// \param[in] _value Coordinate.
+      /// \return Index of the cell along the axis, clamped to the grid.
+      public: int Cell(int _axis, double _value) const;
+
+      /// \brief Get the index of a region from its cell.
+      /// \param[in] _cell Index of the cell along each axis.
+      /// \return Index of the region.
+      public: std::size_t Region(const Eigen::Vector3i &_cell) const;
+
+      /// \brief Get the cell of a region.
+      /// \param[in] _region Index of the region.
+      /// \return Index of the cell along each axis.
+      public: Eigen::Vector3i CellOfRegion(std::size_t _region) const;
+
+      /// \brief Whether a point is within a margin of a region. The regions
+      /// at the edge of the grid extend to infinity beyond the bounds.
+      /// \param[in] _region Index of the region.
+      /// \param[in] _point Point to test.
+      /// \param[in] _margin Distance that the region is grown by.
+      /// \return True if the point is within the margin of the region.
+      public: bool Contains(std::size_t _region,
+                            const LinearVector3d &_point,
+                            double _margin) const;
+
+      /// \brief Bounds of the partition.
+      public: AlignedBox3d bounds;
+
+      /// \brief Number of cells along each axis.
+      public: Eigen::Vector3i cells;
+
+      /// \brief Size of a cell along each axis.
+      public: LinearVector3d cellSize;
+
+      /// \brief See WorldPartition::WorldPartition.
+      public: double ghostMargin;
+
+      /// \brief See WorldPartition::WorldPartition.
+      public: double handoverMargin;
+
+      /// \brief Bodies of the partition, by ID.
+      public: std::map<std::size_t, Body> bodies;
+
+      /// \brief Number of calls to Update().
+      public: std::size_t updateCount = 0;
+
+      /// \brief Changes found by the most recent update.
+      public: WorldPartition::Changes changes;
+
+      /// \brief Ghost regions of the body being updated.
+      public: std::vector<std::size_t> newGhosts;
+    };
+
+    /////////////////////////////////////////////////
+    int WorldPartitionPrivate::Cell(const int _axis, const double _value) const
+    {
+      const double offset =
+          (_value - this->bounds.min()[_axis]) / this->cellSize[_axis];
+      if (!(offset > 0.0))
+        return 0;
+      if (offset >= static_cast<double>(this->cells[_axis]))
+        return this->cells[_axis] - 1;
+      return static_cast<int>(offset);
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPartitionPrivate::Region(
+        const Eigen::Vector3i &_cell) const
+    {
+      return static_cast<std::size_t>(_cell[0]) +
+          static_cast<std::size_t>(this->cells[0]) *
+          (static_cast<std::size_t>(_cell[1]) +
+           static_cast<std::size_t>(this->cells[1]) *
+           static_cast<std::size_t>(_cell[2]));
+    }
+
+    /////////////////////////////////////////////////
+    Eigen::Vector3i WorldPartitionPrivate::CellOfRegion(
+        const std::size_t _region) const
+    {
+      const std::size_t nx = static_cast<std::size_t>(this->cells[0]);
+      const std::size_t ny = static_cast<std::size_t>(this->cells[1]);
+      return Eigen::Vector3i(
+          static_cast<int>(_region % nx),
+          static_cast<int>((_region / nx) % ny),
+          static_cast<int>(_region / (nx * ny)));
+    }
+
+    /////////////////////////////////////////////////
+    bool WorldPartitionPrivate::Contains(const std::size_t _region,
+        const LinearVector3d &_point, const double _margin) const
+    {
+      const Eigen::Vector3i cell = this->CellOfRegion(_region);
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        const double min =
+            this->bounds.min()[axis] + cell[axis] * this->cellSize[axis];
+        if (cell[axis] > 0 && _point[axis] < min - _margin)
+          return false;
+        if (cell[axis] < this->cells[axis] - 1 &&
+            _point[axis] > min + this->cellSize[axis] + _margin)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    WorldPartition::WorldPartition(const AlignedBox3d &_bounds,
+                                   const Eigen::Vector3i &_cells,
+                                   const double _ghostMargin,
+                                   const double _handoverMargin)
+      : dataPtr(new WorldPartitionPrivate)
+    {
+      this->dataPtr->bounds = _bounds;
+      this->dataPtr->cells = _cells.cwiseMax(1);
+      this->dataPtr->cellSize = _bounds.sizes().cwiseQuotient(
+          this->dataPtr->cells.cast<double>());
+      // Degenerate bounds give a single cell along that axis
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        if (!(this->dataPtr->cellSize[axis] > 0.0))
+        {
+          this->dataPtr->cells[axis] = 1;
+          this->dataPtr->cellSize[axis] = 1.0;
+        }
+      }
+      this->dataPtr->ghostMargin = std::max(0.0, _ghostMargin);
+      this->dataPtr->handoverMargin = std::max(0.0, _handoverMargin);
+    }
+
+    /////////////////////////////////////////////////
+    WorldPartition::~WorldPartition() = default;
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPartition::RegionCount() const
+    {
+      return static_cast<std::size_t>(this->dataPtr->cells.prod());
+    }
+
+    /////////////////////////////////////////////////
+    AlignedBox3d WorldPartition::RegionBox(const std::size_t _region) const
+    {
+      if (_region >= this->RegionCount())
+        return AlignedBox3d();
+
+      const Eigen::Vector3i cell = this->dataPtr->CellOfRegion(_region);
+      const LinearVector3d min = this->dataPtr->bounds.min() +
+          cell.cast<double>().cwiseProduct(this->dataPtr->cellSize);
+      return AlignedBox3d(min, min + this->dataPtr->cellSize);
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPartition::RegionOf(const LinearVector3d &_point) const
+    {
+      return this->dataPtr->Region(Eigen::Vector3i(
+          this->dataPtr->Cell(0, _point[0]),
+          this->dataPtr->Cell(1, _point[1]),
+          this->dataPtr->Cell(2, _point[2])));
+    }
+
+    /////////////////////////////////////////////////
+    auto WorldPartition::Update(const std::size_t *_bodies,
+                                const AlignedBox3d *_boxes,
+                                const std::size_t _count) -> const Changes &
+    {
+      auto &d = *this->dataPtr;
+      ++d.updateCount;
+      d.changes.handovers.clear();
+      d.changes.addedGhosts.clear();
+      d.changes.removedGhosts.clear();
+
+      for (std::size_t i = 0; i < _count; ++i)
+      {
+        const AlignedBox3d &box = _boxes[i];
+        if (box.isEmpty())
+          continue;
+
+        const std::size_t id = _bodies[i];
+        auto &body = d.bodies[id];
+        body.lastUpdate = d.updateCount;
+
+        // Keep the owner until the center moves past the handover margin
+        const LinearVector3d center = box.center();
+        if (body.owner == kNoRegion ||
+            !d.Contains(body.owner, center, d.handoverMargin))
+        {
+          const std::size_t owner = this->RegionOf(center);
+          d.changes.handovers.push_back({id, body.owner, owner});
+          body.owner = owner;
+        }
+
+        // Ghost the body into every other region that is within the ghost
+        // margin of its box. Regions are visited in increasing order.
+        d.newGhosts.clear();
+        const LinearVector3d margin =
+            LinearVector3d::Constant(d.ghostMargin);
+        const LinearVector3d min = box.min() - margin;
+        const LinearVector3d max = box.max() + margin;
+        Eigen::Vector3i cell;
+        for (cell[2] = d.Cell(2, min[2]); cell[2] <= d.Cell(2, max[2]);
+             ++cell[2])
+        {
+          for (cell[1] = d.Cell(1, min[1]); cell[1] <= d.Cell(1, max[1]);
+               ++cell[1])
+          {
+            for (cell[0] = d.Cell(0, min[0]); cell[0] <= d.Cell(0, max[0]);
+                 ++cell[0])
+            {
+              const std::size_t region = d.Region(cell);
+              if (region != body.owner)
+                d.newGhosts.push_back(region);
+            }
+          }
+        }
+
+        // Both lists are sorted, so they are compared in one pass
+        auto newIt = d.newGhosts.begin();
+        auto oldIt = body.ghosts.begin();
+        while (newIt != d.newGhosts.end() || oldIt != body.ghosts.end())
+        {
+          if (oldIt == body.ghosts.end() ||
+              (newIt != d.newGhosts.end() && *newIt < *oldIt))
+          {
+            d.changes.addedGhosts.push_back({id, *newIt++});
+          }
+          else if (newIt == d.newGhosts.end() || *oldIt < *newIt)
+          {
+            d.changes.removedGhosts.push_back({id, *oldIt++});
+          }
+          else
+          {
+            ++newIt;
+            ++oldIt;
+          }
+        }
+        body.ghosts.swap(d.newGhosts);
+      }
+
+      // Remove the bodies that were not passed to this update
+      for (auto it = d.bodies.begin(); it != d.bodies.end();)
+      {
+        if (it->second.lastUpdate == d.updateCount)
+        {
+          ++it;
+          continue;
+        }
+
+        d.changes.handovers.push_back({it->first, it->second.owner,
+                                       kNoRegion});
+        for (const std::size_t region : it->second.ghosts)
+          d.changes.removedGhosts.push_back({it->first, region});
+        it = d.bodies.erase(it);
+      }
+
+      const auto byBody = [](const auto &_a, const auto &_b)
+      {
+        return _a.body < _b.body;
+      };
+      std::stable_sort(d.changes.handovers.begin(),
+                       d.changes.handovers.end(), byBody);
+      std::stable_sort(d.changes.addedGhosts.begin(),
+                       d.changes.addedGhosts.end(), byBody);
+      std::stable_sort(d.changes.removedGhosts.begin(),
+                       d.changes.removedGhosts.end(), byBody);
+
+      return d.changes;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPartition::OwnerOf(const std::size_t _body) const
+    {
+      const auto it = this->dataPtr->bodies.find(_body);
+      if (it == this->dataPtr->bodies.end())
+        return kNoRegion;
+      return it->second.owner;
+    }
+
+    /////////////////////////////////////////////////
+    std::vector<std::size_t> WorldPartition::GhostRegionsOf(
+        const std::size_t _body) const
+    {
+      const auto it = this->dataPtr->bodies.find(_body);
+      if (it == this->dataPtr->bodies.end())
+        return {};
+      return it->second.ghosts;
+    }
+
+    /////////////////////////////////////////////////
+    std::vector<std::size_t> WorldPartition::BodiesOf(
+        const std::size_t _region) const
+    {
+      std::vector<std::size_t> result;
+      for (const auto &[id, body] : this->dataPtr->bodies)
+      {
+        if (body.owner == _region)
+          result.push_back(id);
+      }
+      return result;
+    }
+  }
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "gz/physics/WorldPartition.hh"
+
+using gz::physics::AlignedBox3d;
+using gz::physics::LinearVector3d;
+using gz::physics::WorldPartition;
+
+/////////////////////////////////////////////////
+AlignedBox3d Box(const LinearVector3d &_center, const double _halfSize)
+{
+  const LinearVector3d half = LinearVector3d::Constant(_halfSize);
+  return AlignedBox3d(_center - half, _center + half);
+}
+
+/////////////////////////////////////////////////
+TEST(WorldPartition_TEST, Regions)
+{
+  // Two by two regions of 10 x 10 m in the xy plane
+  WorldPartition partition(
+      AlignedBox3d(LinearVector3d(0, 0, 0), LinearVector3d(20, 20, 10)),
+      Eigen::Vector3i(2, 2, 0), 1.0);
+  ASSERT_EQ(4u, partition.RegionCount());
+
+  EXPECT_EQ(0u, partition.RegionOf(LinearVector3d(5, 5, 5)));
+  EXPECT_EQ(1u, partition.RegionOf(LinearVector3d(15, 5, 5)));
+  EXPECT_EQ(2u, partition.RegionOf(LinearVector3d(5, 15, 5)));
+  EXPECT_EQ(3u, partition.RegionOf(LinearVector3d(15, 15, 5)));
+
+  // Points beyond the bounds belong to the nearest region
+  EXPECT_EQ(0u, partition.RegionOf(LinearVector3d(-100, -100, -100)));
+  EXPECT_EQ(3u, partition.RegionOf(LinearVector3d(100, 100, 100)));
+
+  const AlignedBox3d box = partition.RegionBox(1);
+  EXPECT_TRUE(box.min().isApprox(LinearVector3d(10, 0, 0)));
+  EXPECT_TRUE(box.max().isApprox(LinearVector3d(20, 10, 10)));
+  EXPECT_TRUE(partition.RegionBox(4).isEmpty());
+}
+
+/////////////////////////////////////////////////
+TEST(WorldPartition_TEST, HandoverAndGhosts)
+{
+  WorldPartition partition(
+      AlignedBox3d(LinearVector3d(0, 0, 0), LinearVector3d(20, 10, 10)),
+      Eigen::Vector3i(2, 1, 1), 1.0, 0.5);
+
+  // A body in the middle of region 0 and one on its border with region 1
+  std::vector<std::size_t> bodies = {3, 7};
+  std::vector<AlignedBox3d> boxes = {
+      Box(LinearVector3d(5, 5, 5), 0.5),
+      Box(LinearVector3d(9.8, 5, 5), 0.5)};
+
+  auto changes = partition.Update(bodies.data(), boxes.data(), 2);
+  ASSERT_EQ(2u, changes.handovers.size());
+  EXPECT_EQ(3u, changes.handovers[0].body);
+  EXPECT_EQ(WorldPartition::kNoRegion, changes.handovers[0].from);
+  EXPECT_EQ(0u, changes.handovers[0].to);
+  EXPECT_EQ(7u, changes.handovers[1].body);
+  EXPECT_EQ(0u, changes.handovers[1].to);
+  ASSERT_EQ(1u, changes.addedGhosts.size());
+  EXPECT_EQ(7u, changes.addedGhosts[0].body);
+  EXPECT_EQ(1u, changes.addedGhosts[0].region);
+  EXPECT_TRUE(changes.removedGhosts.empty());
+  EXPECT_EQ(std::vector<std::size_t>({3, 7}), partition.BodiesOf(0));
+  EXPECT_EQ(std::vector<std::size_t>({1}), partition.GhostRegionsOf(7));
+
+  // The center of body 7 crosses the border, but not the handover margin
+  boxes[1] = Box(LinearVector3d(10.3, 5, 5), 0.5);
+  changes = partition.Update(bodies.data(), boxes.data(), 2);
+  EXPECT_TRUE(changes.handovers.empty());
+  EXPECT_TRUE(changes.addedGhosts.empty());
+  EXPECT_TRUE(changes.removedGhosts.empty());
+  EXPECT_EQ(0u, partition.OwnerOf(7));
+
+  // Past the margin, region 1 takes over and region 0 keeps a ghost
+  boxes[1] = Box(LinearVector3d(10.8, 5, 5), 0.5);
+  changes = partition.Update(bodies.data(), boxes.data(), 2);
+  ASSERT_EQ(1u, changes.handovers.size());
+  EXPECT_EQ(7u, changes.handovers[0].body);
+  EXPECT_EQ(0u, changes.handovers[0].from);
+  EXPECT_EQ(1u, changes.handovers[0].to);
+  ASSERT_EQ(1u, changes.addedGhosts.size());
+  EXPECT_EQ(0u, changes.addedGhosts[0].region);
+  ASSERT_EQ(1u, changes.removedGhosts.size());
+  EXPECT_EQ(1u, changes.removedGhosts[0].region);
+  EXPECT_EQ(std::vector<std::size_t>({7}), partition.BodiesOf(1));
+
+  // Far from the border the ghost is removed
+  boxes[1] = Box(LinearVector3d(15, 5, 5), 0.5);
+  changes = partition.Update(bodies.data(), boxes.data(), 2);
+  EXPECT_TRUE(changes.handovers.empty());
+  ASSERT_EQ(1u, changes.removedGhosts.size());
+  EXPECT_EQ(7u, changes.removedGhosts[0].body);
+  EXPECT_EQ(0u, changes.removedGhosts[0].region);
+  EXPECT_TRUE(partition.GhostRegionsOf(7).empty());
+
+  // Bodies that are not passed again leave the partition
+  changes = partition.Update(bodies.data(), boxes.data(), 1);
+  ASSERT_EQ(1u, changes.handovers.size());
+  EXPECT_EQ(7u, changes.handovers[0].body);
+  EXPECT_EQ(1u, changes.handovers[0].from);
+  EXPECT_EQ(WorldPartition::kNoRegion, changes.handovers[0].to);
+  EXPECT_EQ(WorldPartition::kNoRegion, partition.OwnerOf(7));
+}
+
+/////////////////////////////////////////////////
+TEST(WorldPartition_TEST, LargeBodyGhostedIntoManyRegions)
+{
+  WorldPartition partition(
+      AlignedBox3d(LinearVector3d(0, 0, 0), LinearVector3d(30, 30, 30)),
+      Eigen::Vector3i(3, 3, 3), 0.0);
+  ASSERT_EQ(27u, partition.RegionCount());
+
+  const std::size_t body = 1;
+  const AlignedBox3d box = Box(LinearVector3d(15, 15, 15), 7.0);
+  const auto &changes = partition.Update(&body, &box, 1);
+  EXPECT_EQ(13u, partition.OwnerOf(body));
+  EXPECT_EQ(26u, changes.addedGhosts.size());
+
+  const auto ghosts = partition.GhostRegionsOf(body);
+  ASSERT_EQ(26u, ghosts.size());
+  for (std::size_t i = 1; i < ghosts.size(); ++i)
+    EXPECT_LT(ghosts[i - 1], ghosts[i]);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gz/physics/WorldPlacement.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    /////////////////////////////////////////////////
+    /// \brief Parse a list of cores as written by Linux, e.g. "0-3,8,10-11".
+    /// \param[in] _list List of cores.
+    /// \return Indices of the cores.
+    static std::vector<std::size_t> ParseCoreList(const std::string &_list)
+    {
+      std::vector<std::size_t> cores;
+      std::stringstream stream(_list);
+      std::string range;
+      while (std::getline(stream, range, ','))
+      {
+        const std::size_t dash = range.find('-');
+        try
+        {
+          const std::size_t first = std::stoul(range.substr(0, dash));
+          const std::size_t last = dash == std::string::npos ?
+              first : std::stoul(range.substr(dash + 1));
+          for (std::size_t core = first; core <= last; ++core)
+            cores.push_back(core);
+        }
+        catch (const std::exception &)
+        {
+          // Blank lines and trailing whitespace
+        }
+      }
+      return cores;
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Read the list of cores of a NUMA node.
+    /// \param[in] _node Index of the node.
+    /// \param[out] _list List of cores.
+    /// \return True if the node exists.
+    static bool ReadNodeCoreList(std::size_t _node, std::string &_list)
+    {
+#ifdef __linux__
+      std::ifstream file("/sys/devices/system/node/node" +
+                         std::to_string(_node) + "/cpulist");
+      return static_cast<bool>(std::getline(file, _list));
+#else
+      (void)_node;
+      (void)_list;
+      return false;
+#endif
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t NumaNodeCount()
+    {
+      std::size_t count = 0u;
+      std::string list;
+      while (ReadNodeCoreList(count, list))
+        ++count;
+      return std::max<std::size_t>(count, 1u);
+    }
+
+    /////////////////////////////////////////////////
+    std::vector<std::size_t> NumaNodeCores(const std::size_t _node)
+    {
+      std::string list;
+      if (ReadNodeCoreList(_node, list))
+        return ParseCoreList(list);
+
+      std::vector<std::size_t> cores;
+      if (_node == 0u)
+      {
+        const std::size_t count =
+            std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t core = 0u; core < count; ++core)
+          cores.push_back(core);
+      }
+      return cores;
+    }
+
+    /////////////////////////////////////////////////
+    std::vector<std::size_t> WorldPlacement::Cores() const
+    {
+      std::vector<std::size_t> result = this->cores;
+      if (result.empty() && this->numaNode >= 0)
+        result = NumaNodeCores(static_cast<std::size_t>(this->numaNode));
+
+      std::sort(result.begin(), result.end());
+      result.erase(std::unique(result.begin(), result.end()), result.end());
+      return result;
+    }
+
+    /////////////////////////////////////////////////
+    bool WorldPlacement::operator==(const WorldPlacement &_other) const
+    {
+      return this->numaNode == _other.numaNode && this->cores == _other.cores;
+    }
+  }
+}
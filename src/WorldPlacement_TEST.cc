@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "gz/physics/WorldPlacement.hh"
+
+using gz::physics::WorldPlacement;
+
+/////////////////////////////////////////////////
+TEST(WorldPlacement_TEST, NumaNodes)
+{
+  const std::size_t nodes = gz::physics::NumaNodeCount();
+  ASSERT_LE(1u, nodes);
+
+  // Every node has cores, and no core is on two nodes
+  std::vector<std::size_t> all;
+  for (std::size_t node = 0u; node < nodes; ++node)
+  {
+    const auto cores = gz::physics::NumaNodeCores(node);
+    EXPECT_FALSE(cores.empty());
+    for (const std::size_t core : cores)
+    {
+      EXPECT_EQ(all.end(), std::find(all.begin(), all.end(), core));
+      all.push_back(core);
+    }
+  }
+  EXPECT_TRUE(gz::physics::NumaNodeCores(nodes).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(WorldPlacement_TEST, Cores)
+{
+  WorldPlacement placement;
+  EXPECT_TRUE(placement.Cores().empty());
+  EXPECT_EQ(WorldPlacement(), placement);
+
+  placement.numaNode = 0;
+  EXPECT_EQ(gz::physics::NumaNodeCores(0u), placement.Cores());
+
+  // Cores take precedence over the node, and are sorted without duplicates
+  placement.cores = {3u, 1u, 3u};
+  EXPECT_EQ((std::vector<std::size_t>{1u, 3u}), placement.Cores());
+  EXPECT_FALSE(WorldPlacement() == placement);
+
+  placement = WorldPlacement();
+  placement.numaNode = 1 << 20;
+  EXPECT_TRUE(placement.Cores().empty());
+}
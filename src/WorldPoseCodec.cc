@@ -0,0 +1,483 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include "gz/physics/WorldPoseCodec.hh"
+
+namespace gz
+{
+  namespace physics
+  {
+    namespace
+    {
+      /// \brief Version of the frame format.
+      constexpr uint8_t kFormatVersion = 1;
+
+      /// \brief Flag of a keyframe in the frame header.
+      constexpr uint8_t kKeyframeFlag = 0x01;
+
+      /// \brief Size of the frame header before the number of poses: the
+      /// version, the flags, the rotation bits and the position resolution.
+      constexpr std::size_t kHeaderSize = 3 + sizeof(uint64_t);
+
+      /// \brief Smallest number of bytes of a pose in a frame: its header
+      /// and seven varints of one byte each.
+      constexpr std::size_t kMinPoseSize = 8;
+
+      /// \brief Mask of the index of the largest quaternion component in the
+      /// header of a pose.
+      constexpr uint8_t kLargestMask = 0x03;
+
+      /// \brief Flag of a position coded as a difference.
+      constexpr uint8_t kPositionDeltaFlag = 0x04;
+
+      /// \brief Flag of a rotation coded as a difference.
+      constexpr uint8_t kRotationDeltaFlag = 0x08;
+
+      /// \brief Largest magnitude of a quantized position, so that
+      /// differences of positions do not overflow.
+      constexpr double kMaxPosition = 4.0e18;
+
+      /////////////////////////////////////////////////
+      uint64_t ZigZag(const int64_t _value)
+      {
+        return (static_cast<uint64_t>(_value) << 1) ^
+            static_cast<uint64_t>(_value >> 63);
+      }
+
+      /////////////////////////////////////////////////
+      int64_t UnZigZag(const uint64_t _value)
+      {
+        return static_cast<int64_t>(_value >> 1) ^
+            -static_cast<int64_t>(_value & 1);
+      }
+
+      /////////////////////////////////////////////////
+      void WriteVarint(uint64_t _value, std::vector<uint8_t> &_buffer)
+      {
+        while (_value >= 0x80)
+        {
+          _buffer.push_back(static_cast<uint8_t>(_value | 0x80));
+          _value >>= 7;
+        }
+        _buffer.push_back(static_cast<uint8_t>(_value));
+      }
+
+      /////////////////////////////////////////////////
+      /// \brief Scale from a quaternion component to its quantized value.
+      double RotationScale(const unsigned int _bits)
+      {
+        // The three smallest components are within +-1/sqrt(2)
+        return static_cast<double>((int64_t{1} << (_bits - 1)) - 1) *
+            std::sqrt(2.0);
+      }
+    }
+
+    /////////////////////////////////////////////////
+    /// \brief Last quantized pose of a body.
+    struct QuantizedPose
+    {
+      int64_t position[3];
+      int64_t rotation[3];
+      uint8_t largest;
+    };
+
+    /////////////////////////////////////////////////
+    class WorldPoseCodecState
+    {
+      /// \brief Quantization step of the positions.
+      public: double positionResolution = 1e-4;
+
+      /// \brief Number of bits of the quaternion components.
+      public: unsigned int rotationBits = 16;
+
+      /// \brief See WorldPoseEncoder::WorldPoseEncoder.
+      public: std::size_t keyframeInterval = 0;
+
+      /// \brief Number of frames since the last keyframe, or 0 if the next
+      /// frame has to be a keyframe.
+      public: std::size_t framesSinceKeyframe = 0;
+
+      /// \brief Whether the decoder has read a keyframe since it was reset.
+      public: bool hasKeyframe = false;
+
+      /// \brief Last quantized pose of each body.
+      public: std::unordered_map<uint64_t, QuantizedPose> poses;
+    };
+
+    /////////////////////////////////////////////////
+    WorldPoseEncoder::WorldPoseEncoder(const double _positionResolution,
+                                       const unsigned int _rotationBits,
+                                       const std::size_t _keyframeInterval)
+      : dataPtr(new WorldPoseCodecState)
+    {
+      if (_positionResolution > 0.0 && std::isfinite(_positionResolution))
+        this->dataPtr->positionResolution = _positionResolution;
+      this->dataPtr->rotationBits = std::clamp(_rotationBits, 8u, 30u);
+      this->dataPtr->keyframeInterval = _keyframeInterval;
+    }
+
+    /////////////////////////////////////////////////
+    WorldPoseEncoder::~WorldPoseEncoder() = default;
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPoseEncoder::Encode(
+        const std::vector<WorldPose> &_poses, std::vector<uint8_t> &_buffer)
+    {
+      auto &d = *this->dataPtr;
+      const std::size_t start = _buffer.size();
+
+      const bool keyframe = d.framesSinceKeyframe == 0 ||
+          (d.keyframeInterval > 0 &&
+           d.framesSinceKeyframe >= d.keyframeInterval);
+      if (keyframe)
+      {
+        d.poses.clear();
+        d.framesSinceKeyframe = 0;
+      }
+      ++d.framesSinceKeyframe;
+
+      _buffer.push_back(kFormatVersion);
+      _buffer.push_back(keyframe ? kKeyframeFlag : 0);
+      _buffer.push_back(static_cast<uint8_t>(d.rotationBits));
+      uint64_t resolutionBits;
+      std::memcpy(&resolutionBits, &d.positionResolution, sizeof(double));
+      for (std::size_t i = 0; i < sizeof(uint64_t); ++i)
+        _buffer.push_back(static_cast<uint8_t>(resolutionBits >> (8 * i)));
+      WriteVarint(_poses.size(), _buffer);
+
+      const double rotationScale = RotationScale(d.rotationBits);
+      uint64_t previousBody = 0;
+      for (const WorldPose &worldPose : _poses)
+      {
+        QuantizedPose q;
+        const math::Vector3d &p = worldPose.pose.Pos();
+        for (int i = 0; i < 3; ++i)
+        {
+          const double value = p[i] / d.positionResolution;
+          q.position[i] = std::isfinite(value) ?
+              std::llround(std::clamp(value, -kMaxPosition, kMaxPosition)) :
+              0;
+        }
+
+        // Send the three smallest components, with the largest one made
+        // positive so that it can be recovered from them
+        math::Quaterniond rot = worldPose.pose.Rot();
+        rot.Normalize();
+        double c[4] = {rot.W(), rot.X(), rot.Y(), rot.Z()};
+        q.largest = 0;
+        for (uint8_t i = 1; i < 4; ++i)
+        {
+          if (std::abs(c[i]) > std::abs(c[q.largest]))
+            q.largest = i;
+        }
+        const double sign = c[q.largest] < 0.0 ? -1.0 : 1.0;
+        for (int i = 0, j = 0; i < 4; ++i)
+        {
+          if (i != q.largest)
+            q.rotation[j++] = std::llround(sign * c[i] * rotationScale);
+        }
+
+        uint8_t header = q.largest;
+        const auto last = d.poses.find(worldPose.body);
+        const bool hasLast = last != d.poses.end();
+        if (hasLast)
+        {
+          header |= kPositionDeltaFlag;
+          if (last->second.largest == q.largest)
+            header |= kRotationDeltaFlag;
+        }
+
+        _buffer.push_back(header);
+        WriteVarint(ZigZag(static_cast<int64_t>(
+            static_cast<uint64_t>(worldPose.body) - previousBody)), _buffer);
+        previousBody = worldPose.body;
+        for (int i = 0; i < 3; ++i)
+        {
+          WriteVarint(ZigZag((header & kPositionDeltaFlag) ?
+              q.position[i] - last->second.position[i] : q.position[i]),
+              _buffer);
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+          WriteVarint(ZigZag((header & kRotationDeltaFlag) ?
+              q.rotation[i] - last->second.rotation[i] : q.rotation[i]),
+              _buffer);
+        }
+
+        if (hasLast)
+          last->second = q;
+        else
+          d.poses.emplace(worldPose.body, q);
+      }
+
+      return _buffer.size() - start;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPoseEncoder::Encode(
+        const WorldPoses &_poses, std::vector<uint8_t> &_buffer)
+    {
+      return this->Encode(_poses.entries, _buffer);
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPoseEncoder::Encode(
+        const ChangedWorldPoses &_poses, std::vector<uint8_t> &_buffer)
+    {
+      return this->Encode(_poses.entries, _buffer);
+    }
+
+    /////////////////////////////////////////////////
+    void WorldPoseEncoder::Reset()
+    {
+      this->dataPtr->poses.clear();
+      this->dataPtr->framesSinceKeyframe = 0;
+    }
+
+    /////////////////////////////////////////////////
+    WorldPoseReader::WorldPoseReader(WorldPoseCodecState &_state,
+                                     const uint8_t *_data,
+                                     const std::size_t _size)
+      : state(&_state), begin(_data), cursor(_data), end(_data + _size)
+    {
+      if (!_data || _size < kHeaderSize || _data[0] != kFormatVersion)
+      {
+        this->error = true;
+        return;
+      }
+
+      this->keyframe = (_data[1] & kKeyframeFlag) != 0;
+      this->rotationBits = _data[2];
+      uint64_t resolutionBits = 0;
+      for (std::size_t i = 0; i < sizeof(uint64_t); ++i)
+        resolutionBits |= static_cast<uint64_t>(_data[3 + i]) << (8 * i);
+      std::memcpy(&this->positionResolution, &resolutionBits, sizeof(double));
+      this->cursor += kHeaderSize;
+
+      uint64_t count = 0;
+      if (this->rotationBits < 8 || this->rotationBits > 30 ||
+          !(this->positionResolution > 0.0) || !this->ReadVarint(count))
+      {
+        this->error = true;
+        return;
+      }
+
+      // Reject counts that cannot fit in the rest of the frame, so that a
+      // malformed count is reported before anything is sized by it.
+      const auto bytesLeft = static_cast<std::size_t>(this->end - this->cursor);
+      if (count > bytesLeft / kMinPoseSize)
+      {
+        this->error = true;
+        return;
+      }
+
+      if (this->keyframe)
+      {
+        this->state->poses.clear();
+        this->state->hasKeyframe = true;
+        this->state->positionResolution = this->positionResolution;
+        this->state->rotationBits = this->rotationBits;
+      }
+      else if (!this->state->hasKeyframe ||
+               this->state->positionResolution != this->positionResolution ||
+               this->state->rotationBits != this->rotationBits)
+      {
+        this->error = true;
+        return;
+      }
+
+      this->size = static_cast<std::size_t>(count);
+      this->remaining = this->size;
+    }
+
+    /////////////////////////////////////////////////
+    bool WorldPoseReader::ReadVarint(uint64_t &_value)
+    {
+      _value = 0;
+      for (unsigned int shift = 0; shift < 64; shift += 7)
+      {
+        if (this->cursor == this->end)
+          return false;
+
+        const uint8_t byte = *this->cursor++;
+        _value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+          return true;
+      }
+      return false;
+    }
+
+    /////////////////////////////////////////////////
+    bool WorldPoseReader::Next(WorldPose &_pose)
+    {
+      if (this->error || this->remaining == 0)
+        return false;
+
+      if (this->cursor == this->end)
+      {
+        this->error = true;
+        return false;
+      }
+      const uint8_t header = *this->cursor++;
+
+      uint64_t values[7];
+      for (uint64_t &value : values)
+      {
+        if (!this->ReadVarint(value))
+        {
+          this->error = true;
+          return false;
+        }
+      }
+
+      const uint64_t body = this->previousBody +
+          static_cast<uint64_t>(UnZigZag(values[0]));
+      this->previousBody = body;
+
+      QuantizedPose q;
+      q.largest = header & kLargestMask;
+      for (int i = 0; i < 3; ++i)
+      {
+        q.position[i] = UnZigZag(values[1 + i]);
+        q.rotation[i] = UnZigZag(values[4 + i]);
+      }
+
+      auto last = this->state->poses.find(body);
+      if (header & (kPositionDeltaFlag | kRotationDeltaFlag))
+      {
+        const bool largestChanged = (header & kRotationDeltaFlag) &&
+            last != this->state->poses.end() &&
+            last->second.largest != q.largest;
+        if (last == this->state->poses.end() || largestChanged)
+        {
+          this->error = true;
+          return false;
+        }
+
+        for (int i = 0; i < 3; ++i)
+        {
+          if (header & kPositionDeltaFlag)
+            q.position[i] += last->second.position[i];
+          if (header & kRotationDeltaFlag)
+            q.rotation[i] += last->second.rotation[i];
+        }
+      }
+
+      if (last != this->state->poses.end())
+        last->second = q;
+      else
+        this->state->poses.emplace(body, q);
+
+      const double rotationScale = RotationScale(this->rotationBits);
+      double c[4];
+      double sum = 0.0;
+      for (int i = 0, j = 0; i < 4; ++i)
+      {
+        if (i == q.largest)
+          continue;
+        c[i] = static_cast<double>(q.rotation[j++]) / rotationScale;
+        sum += c[i] * c[i];
+      }
+      c[q.largest] = std::sqrt(std::max(0.0, 1.0 - sum));
+
+      _pose.body = static_cast<std::size_t>(body);
+      _pose.pose.Set(
+          math::Vector3d(
+              static_cast<double>(q.position[0]) * this->positionResolution,
+              static_cast<double>(q.position[1]) * this->positionResolution,
+              static_cast<double>(q.position[2]) * this->positionResolution),
+          math::Quaterniond(c[0], c[1], c[2], c[3]));
+
+      --this->remaining;
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPoseReader::Size() const
+    {
+      return this->size;
+    }
+
+    /////////////////////////////////////////////////
+    bool WorldPoseReader::IsKeyframe() const
+    {
+      return this->keyframe;
+    }
+
+    /////////////////////////////////////////////////
+    bool WorldPoseReader::Error() const
+    {
+      return this->error;
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPoseReader::BytesRead() const
+    {
+      return static_cast<std::size_t>(this->cursor - this->begin);
+    }
+
+    /////////////////////////////////////////////////
+    WorldPoseDecoder::WorldPoseDecoder()
+      : dataPtr(new WorldPoseCodecState)
+    {
+    }
+
+    /////////////////////////////////////////////////
+    WorldPoseDecoder::~WorldPoseDecoder() = default;
+
+    /////////////////////////////////////////////////
+    WorldPoseReader WorldPoseDecoder::Read(
+        const uint8_t *_data, const std::size_t _size)
+    {
+      return WorldPoseReader(*this->dataPtr, _data, _size);
+    }
+
+    /////////////////////////////////////////////////
+    std::size_t WorldPoseDecoder::Decode(const uint8_t *_data,
+        const std::size_t _size, std::vector<WorldPose> &_poses)
+    {
+      _poses.clear();
+      WorldPoseReader reader = this->Read(_data, _size);
+      if (reader.Error())
+        return 0;
+
+      _poses.reserve(reader.Size());
+      WorldPose pose;
+      while (reader.Next(pose))
+        _poses.push_back(pose);
+
+      if (reader.Error())
+      {
+        _poses.clear();
+        return 0;
+      }
+      return reader.BytesRead();
+    }
+
+    /////////////////////////////////////////////////
+    void WorldPoseDecoder::Reset()
+    {
+      this->dataPtr->poses.clear();
+      this->dataPtr->hasKeyframe = false;
+    }
+  }
+}
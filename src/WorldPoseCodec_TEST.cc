@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <gz/math/Pose3.hh>
+
+#include "gz/physics/WorldPoseCodec.hh"
+
+using gz::physics::WorldPose;
+using gz::physics::WorldPoseDecoder;
+using gz::physics::WorldPoseEncoder;
+
+/////////////////////////////////////////////////
+void ExpectPosesNear(const std::vector<WorldPose> &_expected,
+                     const std::vector<WorldPose> &_actual)
+{
+  ASSERT_EQ(_expected.size(), _actual.size());
+  for (std::size_t i = 0; i < _expected.size(); ++i)
+  {
+    EXPECT_EQ(_expected[i].body, _actual[i].body);
+    const auto &p = _expected[i].pose;
+    const auto &q = _actual[i].pose;
+    EXPECT_NEAR(p.Pos().X(), q.Pos().X(), 1e-4);
+    EXPECT_NEAR(p.Pos().Y(), q.Pos().Y(), 1e-4);
+    EXPECT_NEAR(p.Pos().Z(), q.Pos().Z(), 1e-4);
+
+    // q and -q are the same rotation
+    const double dot = p.Rot().W() * q.Rot().W() + p.Rot().X() * q.Rot().X() +
+        p.Rot().Y() * q.Rot().Y() + p.Rot().Z() * q.Rot().Z();
+    EXPECT_NEAR(1.0, std::abs(dot), 1e-8);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(WorldPoseCodec_TEST, RoundTrip)
+{
+  std::vector<WorldPose> poses;
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    const double t = static_cast<double>(i);
+    poses.push_back({gz::math::Pose3d(
+        t, -2.0 * t, 0.5, 0.1 * t, -0.05 * t, 0.3 * t), 10 + 3 * i});
+  }
+
+  WorldPoseEncoder encoder;
+  WorldPoseDecoder decoder;
+  std::vector<uint8_t> buffer;
+  std::vector<WorldPose> decoded;
+
+  const std::size_t keyframeSize = encoder.Encode(poses, buffer);
+  EXPECT_EQ(buffer.size(), keyframeSize);
+  EXPECT_EQ(keyframeSize, decoder.Decode(buffer.data(), buffer.size(),
+                                         decoded));
+  ExpectPosesNear(poses, decoded);
+
+  // Small motions are coded as differences, which take far less space
+  for (auto &pose : poses)
+    pose.pose.Pos() = pose.pose.Pos() + gz::math::Vector3d(0.001, 0, -0.002);
+
+  buffer.clear();
+  const std::size_t deltaSize = encoder.Encode(poses, buffer);
+  EXPECT_LT(deltaSize * 2, keyframeSize);
+  EXPECT_LT(deltaSize * 5, poses.size() * sizeof(WorldPose));
+
+  auto reader = decoder.Read(buffer.data(), buffer.size());
+  EXPECT_FALSE(reader.IsKeyframe());
+  EXPECT_EQ(poses.size(), reader.Size());
+  decoded.clear();
+  WorldPose pose;
+  while (reader.Next(pose))
+    decoded.push_back(pose);
+  EXPECT_FALSE(reader.Error());
+  EXPECT_EQ(deltaSize, reader.BytesRead());
+  ExpectPosesNear(poses, decoded);
+}
+
+/////////////////////////////////////////////////
+TEST(WorldPoseCodec_TEST, ChangedPosesAndFrameSequence)
+{
+  WorldPoseEncoder encoder(1e-4, 16, 3);
+  WorldPoseDecoder decoder;
+  std::vector<uint8_t> buffer;
+
+  // Several frames of a stream, each with a subset of the bodies
+  std::vector<std::vector<WorldPose>> frames;
+  for (std::size_t f = 0; f < 7; ++f)
+  {
+    std::vector<WorldPose> frame;
+    for (std::size_t body = f % 2; body < 20; body += 2)
+    {
+      const double t = 0.01 * static_cast<double>(f);
+      frame.push_back({gz::math::Pose3d(
+          static_cast<double>(body) + t, t, -t, t, 2.0 * t, -3.0 - t), body});
+    }
+    encoder.Encode(frame, buffer);
+    frames.push_back(frame);
+  }
+
+  // The frames are read back one after the other from the same buffer
+  std::size_t offset = 0;
+  std::vector<WorldPose> decoded;
+  for (std::size_t f = 0; f < frames.size(); ++f)
+  {
+    const std::size_t size = decoder.Decode(
+        buffer.data() + offset, buffer.size() - offset, decoded);
+    ASSERT_NE(0u, size) << f;
+    ExpectPosesNear(frames[f], decoded);
+    offset += size;
+  }
+  EXPECT_EQ(buffer.size(), offset);
+}
+
+/////////////////////////////////////////////////
+TEST(WorldPoseCodec_TEST, InvalidFrames)
+{
+  WorldPoseEncoder encoder;
+  std::vector<uint8_t> keyframe;
+  std::vector<WorldPose> poses = {
+    {gz::math::Pose3d(1, 2, 3, 0.1, 0.2, 0.3), 4}};
+  encoder.Encode(poses, keyframe);
+  poses[0].pose.Pos() = gz::math::Vector3d(1.5, 2, 3);
+  std::vector<uint8_t> delta;
+  encoder.Encode(poses, delta);
+
+  std::vector<WorldPose> decoded;
+
+  // A difference frame cannot be decoded without its keyframe
+  WorldPoseDecoder decoder;
+  EXPECT_EQ(0u, decoder.Decode(delta.data(), delta.size(), decoded));
+
+  // Truncated frames are reported
+  EXPECT_EQ(0u, decoder.Decode(keyframe.data(), keyframe.size() - 1,
+                               decoded));
+  EXPECT_EQ(0u, decoder.Decode(keyframe.data(), 2, decoded));
+  EXPECT_EQ(0u, decoder.Decode(nullptr, 0, decoded));
+
+  // A count of poses that cannot fit in the frame is reported instead of
+  // being used to size the output. The count follows the 11 byte header.
+  std::vector<uint8_t> forged(keyframe.begin(), keyframe.begin() + 11);
+  for (int i = 0; i < 8; ++i)
+    forged.push_back(0x80);
+  forged.push_back(0x40);
+  forged.insert(forged.end(), keyframe.begin() + 12, keyframe.end());
+  EXPECT_TRUE(decoder.Read(forged.data(), forged.size()).Error());
+  EXPECT_EQ(0u, decoder.Decode(forged.data(), forged.size(), decoded));
+  EXPECT_TRUE(decoded.empty());
+
+  EXPECT_NE(0u, decoder.Decode(keyframe.data(), keyframe.size(), decoded));
+  EXPECT_NE(0u, decoder.Decode(delta.data(), delta.size(), decoded));
+  ExpectPosesNear(poses, decoded);
+
+  // After a reset the encoder sends a keyframe again
+  encoder.Reset();
+  std::vector<uint8_t> buffer;
+  encoder.Encode(poses, buffer);
+  decoder.Reset();
+  EXPECT_TRUE(decoder.Read(buffer.data(), buffer.size()).IsKeyframe());
+}
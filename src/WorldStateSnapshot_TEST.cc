@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "gz/physics/detail/WorldStateSnapshot.hh"
+
+using namespace gz::physics;
+
+/////////////////////////////////////////////////
+TEST(WorldStateSnapshot_TEST, RoundTrip)
+{
+  WorldStateSnapshotFeature::Snapshot snapshot;
+  const double values[3] = {1.5, -2.0, 3.25};
+  detail::AppendToSnapshot(snapshot, std::uint32_t{42});
+  detail::AppendToSnapshot(snapshot, values, 3);
+  detail::AppendToSnapshot(snapshot, std::uint8_t{1});
+  EXPECT_EQ(sizeof(std::uint32_t) + 3 * sizeof(double) + 1, snapshot.size());
+
+  detail::SnapshotReader reader(snapshot);
+  std::uint32_t id = 0;
+  double read[3] = {0.0, 0.0, 0.0};
+  std::uint8_t flag = 0;
+  ASSERT_TRUE(detail::ReadFromSnapshot(reader, id));
+  EXPECT_EQ(42u, id);
+  EXPECT_FALSE(reader.AtEnd());
+  ASSERT_TRUE(detail::ReadFromSnapshot(reader, read, 3));
+  EXPECT_DOUBLE_EQ(1.5, read[0]);
+  EXPECT_DOUBLE_EQ(-2.0, read[1]);
+  EXPECT_DOUBLE_EQ(3.25, read[2]);
+  ASSERT_TRUE(detail::ReadFromSnapshot(reader, flag));
+  EXPECT_EQ(1u, flag);
+  EXPECT_TRUE(reader.AtEnd());
+}
+
+/////////////////////////////////////////////////
+TEST(WorldStateSnapshot_TEST, ReadPastEnd)
+{
+  WorldStateSnapshotFeature::Snapshot snapshot;
+  detail::AppendToSnapshot(snapshot, std::uint32_t{7});
+
+  // A value that does not fit in what is left is not read, and the values
+  // after it can still be read
+  detail::SnapshotReader reader(snapshot);
+  std::uint64_t tooLarge = 0;
+  EXPECT_FALSE(detail::ReadFromSnapshot(reader, tooLarge));
+  EXPECT_EQ(0u, tooLarge);
+
+  std::uint32_t value = 0;
+  EXPECT_TRUE(detail::ReadFromSnapshot(reader, value));
+  EXPECT_EQ(7u, value);
+  EXPECT_TRUE(reader.AtEnd());
+  EXPECT_FALSE(detail::ReadFromSnapshot(reader, value));
+
+  // An empty snapshot is read to its end from the start
+  WorldStateSnapshotFeature::Snapshot empty;
+  detail::SnapshotReader emptyReader(empty);
+  EXPECT_TRUE(emptyReader.AtEnd());
+  EXPECT_TRUE(detail::ReadFromSnapshot(emptyReader, &value, 0));
+}
+
+/////////////////////////////////////////////////
+/// \brief Stands in for a plugin whose world state is a single byte.
+class SnapshotWorld : public detail::Implementation
+{
+  public: Identity Generate() const
+  {
+    return this->Implementation::GenerateIdentity(0, nullptr);
+  }
+
+  public: WorldStateSnapshotFeature::Snapshot GetWorldStateSnapshot(
+      const Identity &) const
+  {
+    return {this->state};
+  }
+
+  public: bool SetWorldStateSnapshot(const Identity &,
+      const WorldStateSnapshotFeature::Snapshot &_snapshot)
+  {
+    if (_snapshot.size() != 1u)
+      return false;
+    this->state = _snapshot[0];
+    return true;
+  }
+
+  public: std::uint8_t state = 0;
+};
+
+/////////////////////////////////////////////////
+TEST(WorldStateSnapshot_TEST, SnapshotStep)
+{
+  SnapshotWorld world;
+  const Identity id = world.Generate();
+  WorldStateSnapshotFeature::Snapshot liveState;
+
+  // Without a snapshot the world steps from its current state
+  world.state = 1;
+  EXPECT_TRUE(detail::BeginSnapshotStep(world, id, nullptr, liveState));
+  detail::EndSnapshotStep(world, id, nullptr, liveState);
+  EXPECT_EQ(1u, world.state);
+
+  // The step starts from the snapshot, which is replaced by the stepped state
+  WorldStateSnapshot step;
+  step.snapshot = {5};
+  EXPECT_TRUE(detail::BeginSnapshotStep(world, id, &step, liveState));
+  EXPECT_EQ(5u, world.state);
+  world.state = 6;
+  detail::EndSnapshotStep(world, id, &step, liveState);
+  EXPECT_EQ(WorldStateSnapshotFeature::Snapshot({6}), step.snapshot);
+  EXPECT_EQ(6u, world.state);
+
+  // A preserved world goes back to its state from before the step
+  step.preserveWorld = true;
+  EXPECT_TRUE(detail::BeginSnapshotStep(world, id, &step, liveState));
+  world.state = 7;
+  detail::EndSnapshotStep(world, id, &step, liveState);
+  EXPECT_EQ(WorldStateSnapshotFeature::Snapshot({7}), step.snapshot);
+  EXPECT_EQ(6u, world.state);
+
+  // A snapshot that does not match stops the step
+  step.snapshot = {1, 2};
+  EXPECT_FALSE(detail::BeginSnapshotStep(world, id, &step, liveState));
+  EXPECT_EQ(6u, world.state);
+}
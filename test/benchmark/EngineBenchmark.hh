@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_TEST_BENCHMARK_ENGINEBENCHMARK_HH_
+#define GZ_PHYSICS_TEST_BENCHMARK_ENGINEBENCHMARK_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <gz/math/Vector3.hh>
+
+// Helpers shared by the benchmarks that step worlds with the physics engine
+// plugins. The paths of the plugins are compiled in by CMake.
+
+using gz::math::Vector3d;
+
+/////////////////////////////////////////////////
+/// \brief Get the engine plugins that were built.
+/// \return Pairs of engine name and path to the plugin library.
+inline std::vector<std::pair<std::string, std::string>> EnginePlugins()
+{
+  return {
+#ifdef dartsim_plugin_LIB
+    {"dartsim", dartsim_plugin_LIB},
+#endif
+#ifdef bullet_featherstone_plugin_LIB
+    {"bullet-featherstone", bullet_featherstone_plugin_LIB},
+#endif
+#ifdef tpe_plugin_LIB
+    {"tpe", tpe_plugin_LIB},
+#endif
+  };
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the resident memory of this process.
+/// \return Resident memory in bytes, or 0 if it is not known.
+inline std::size_t ResidentMemory()
+{
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  std::size_t size = 0;
+  std::size_t resident = 0;
+  if (statm >> size >> resident)
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+  return 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the inertial of a solid box.
+inline void Inertial(std::ostream &_out, const Vector3d &_size, double _mass)
+{
+  const double x2 = _size.X() * _size.X();
+  const double y2 = _size.Y() * _size.Y();
+  const double z2 = _size.Z() * _size.Z();
+  _out << "<inertial><mass>" << _mass << "</mass><inertia>"
+       << "<ixx>" << _mass / 12.0 * (y2 + z2) << "</ixx>"
+       << "<iyy>" << _mass / 12.0 * (x2 + z2) << "</iyy>"
+       << "<izz>" << _mass / 12.0 * (x2 + y2) << "</izz>"
+       << "<ixy>0</ixy><ixz>0</ixz><iyz>0</iyz>"
+       << "</inertia></inertial>";
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a link with a single box collision.
+inline void BoxLink(std::ostream &_out, const std::string &_name,
+    const std::string &_pose, const Vector3d &_size, double _mass)
+{
+  _out << "<link name='" << _name << "'><pose>" << _pose << "</pose>";
+  Inertial(_out, _size, _mass);
+  _out << "<collision name='collision'><geometry><box><size>" << _size
+       << "</size></box></geometry></collision></link>";
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a free model made of a single box.
+inline void BoxModel(std::ostream &_out, const std::string &_name,
+    const Vector3d &_pos, const Vector3d &_size)
+{
+  _out << "<model name='" << _name << "'><pose>" << _pos
+       << " 0 0 0</pose>";
+  BoxLink(_out, "link", "0 0 0 0 0 0", _size, 1.0);
+  _out << "</model>";
+}
+
+/////////////////////////////////////////////////
+/// \brief Wrap models into a world with a static ground box.
+/// \param[in] _models SDF of the models.
+/// \param[in] _groundSize Length of the edges of the ground in x and y.
+inline std::string World(const std::string &_models, double _groundSize = 100)
+{
+  std::ostringstream out;
+  out << "<?xml version='1.0'?><sdf version='1.11'><world name='benchmark'>"
+      << "<model name='ground'><static>true</static>"
+      << "<pose>0 0 -0.5 0 0 0</pose><link name='link'>"
+      << "<collision name='collision'><geometry><box><size>"
+      << _groundSize << " " << _groundSize << " 1</size>"
+      << "</box></geometry></collision></link></model>"
+      << _models << "</world></sdf>";
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Number of columns of a square grid holding a number of items.
+inline std::size_t GridColumns(std::size_t _count)
+{
+  return std::max<std::size_t>(1u, static_cast<std::size_t>(
+      std::ceil(std::sqrt(static_cast<double>(_count)))));
+}
+
+#endif
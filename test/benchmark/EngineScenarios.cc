@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <gz/common/MeshManager.hh>
+#include <gz/plugin/Loader.hh>
+
+#include <gz/physics/FindFeatures.hh>
+#include <gz/physics/ForwardStep.hh>
+#include <gz/physics/RequestEngine.hh>
+#include <gz/physics/World.hh>
+#include <gz/physics/sdf/ConstructWorld.hh>
+
+#include <sdf/Root.hh>
+
+#include "test/Resources.hh"
+
+#include "EngineBenchmark.hh"
+
+// Each scenario is stepped by every physics engine plugin that was built,
+// for a fixed number of steps so that all engines simulate the same time and
+// the numbers can be compared between runs. Besides the time per step, each
+// benchmark reports:
+// - steps_per_sec: Steps simulated per second of wall clock time.
+// - contacts: Average number of contact points per step.
+// - ns_per_contact: Wall clock time per contact point.
+// - memory_bytes: Growth of the resident memory of the process from before
+//   the engine was created until the last step, 0 where it is not known.
+
+using Features = gz::physics::FeatureList<
+  gz::physics::ForwardStep,
+  gz::physics::GetStepStatisticsFeature,
+  gz::physics::sdf::ConstructSdfWorld
+>;
+
+/// \brief Step size of all scenarios.
+static constexpr std::chrono::milliseconds kStepSize{1};
+
+/// \brief Steps taken before measuring, so the first contacts of falling
+/// bodies do not dominate the numbers.
+static constexpr std::size_t kWarmupSteps = 100;
+
+/// \brief Steps measured by each benchmark.
+static constexpr std::size_t kMeasuredSteps = 500;
+
+/////////////////////////////////////////////////
+/// \brief A scenario to step.
+struct Scenario
+{
+  /// \brief Name of the scenario.
+  std::string name;
+
+  /// \brief Create the SDF of the scenario world.
+  std::function<std::string(std::size_t)> sdf;
+
+  /// \brief Sizes to run the scenario with.
+  std::vector<std::size_t> sizes;
+
+  /// \brief Engines that cannot simulate the scenario, such as tpe for
+  /// scenarios with joints.
+  std::unordered_set<std::string> unsupportedEngines;
+};
+
+/////////////////////////////////////////////////
+/// \brief Write a revolute joint.
+static void RevoluteJoint(std::ostream &_out, const std::string &_name,
+    const std::string &_parent, const std::string &_child,
+    const std::string &_pose, const std::string &_axis)
+{
+  _out << "<joint name='" << _name << "' type='revolute'>"
+       << "<parent>" << _parent << "</parent><child>" << _child << "</child>"
+       << "<pose>" << _pose << "</pose><axis><xyz>" << _axis << "</xyz>"
+       << "</axis></joint>";
+}
+
+/////////////////////////////////////////////////
+/// \brief Boxes dropped in layers with every other layer offset, so they
+/// tumble into a pile.
+static std::string BoxPile(std::size_t _count)
+{
+  const std::size_t side = std::max<std::size_t>(1u, static_cast<std::size_t>(
+      std::ceil(std::cbrt(static_cast<double>(_count)))));
+  std::ostringstream out;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const std::size_t layer = i / (side * side);
+    const double offset = (layer % 2u) * 0.25;
+    const Vector3d pos(
+        0.6 * static_cast<double>(i % side) + offset,
+        0.6 * static_cast<double>((i / side) % side) + offset,
+        0.5 + 0.6 * static_cast<double>(layer));
+    BoxModel(out, "box_" + std::to_string(i), pos, Vector3d(0.5, 0.5, 0.5));
+  }
+  return World(out.str());
+}
+
+/////////////////////////////////////////////////
+/// \brief Independent pendulums hanging from the world, released from an
+/// angle.
+static std::string Pendulums(std::size_t _count)
+{
+  const std::size_t columns = GridColumns(_count);
+  const double angle = 0.5;
+  std::ostringstream arm;
+  arm << -0.5 * std::sin(angle) << " 0 " << -0.5 * std::cos(angle)
+      << " 0 " << angle << " 0";
+
+  std::ostringstream out;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    out << "<model name='pendulum_" << i << "'><pose>"
+        << static_cast<double>(i % columns) << " "
+        << static_cast<double>(i / columns) << " 2 0 0 0</pose>";
+    BoxLink(out, "arm", arm.str(), Vector3d(0.05, 0.05, 1.0), 1.0);
+    RevoluteJoint(out, "pivot", "world", "arm", "0 0 0.5 0 0 0", "0 1 0");
+    out << "</model>";
+  }
+  return World(out.str());
+}
+
+/////////////////////////////////////////////////
+/// \brief Unactuated humanoids collapsing onto uneven terrain made of
+/// static boxes.
+static std::string HumanoidsOnTerrain(std::size_t _count)
+{
+  const std::size_t columns = GridColumns(_count);
+  const std::size_t terrainSide = std::max<std::size_t>(8u, 2u * columns + 4u);
+
+  std::ostringstream out;
+  out << "<model name='terrain'><static>true</static><link name='link'>";
+  for (std::size_t i = 0; i < terrainSide; ++i)
+  {
+    for (std::size_t j = 0; j < terrainSide; ++j)
+    {
+      const double height = 0.2 + 0.15 * std::sin(0.7 * static_cast<double>(i))
+          * std::cos(0.9 * static_cast<double>(j));
+      out << "<collision name='tile_" << i << "_" << j << "'><pose>"
+          << static_cast<double>(i) - 2.0 << " "
+          << static_cast<double>(j) - 2.0 << " " << height / 2.0
+          << " 0 0 0</pose><geometry><box><size>1 1 " << height
+          << "</size></box></geometry></collision>";
+    }
+  }
+  out << "</link></model>";
+
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    out << "<model name='humanoid_" << i << "'><pose>"
+        << 2.0 * static_cast<double>(i % columns) << " "
+        << 2.0 * static_cast<double>(i / columns) << " 1.4 0 0 0</pose>";
+    BoxLink(out, "pelvis", "0 0 0 0 0 0", Vector3d(0.3, 0.2, 0.15), 8.0);
+    BoxLink(out, "torso", "0 0 0.35 0 0 0", Vector3d(0.35, 0.2, 0.5), 20.0);
+    BoxLink(out, "head", "0 0 0.72 0 0 0", Vector3d(0.2, 0.2, 0.2), 4.0);
+    RevoluteJoint(out, "waist", "pelvis", "torso", "0 0 -0.25 0 0 0",
+        "0 1 0");
+    RevoluteJoint(out, "neck", "torso", "head", "0 0 -0.1 0 0 0", "0 0 1");
+    for (const auto &[side, y] : {std::make_pair("l", 0.1),
+                                  std::make_pair("r", -0.1)})
+    {
+      const std::string s(side);
+      BoxLink(out, "thigh_" + s, "0 " + std::to_string(y) + " -0.3 0 0 0",
+          Vector3d(0.1, 0.1, 0.45), 6.0);
+      BoxLink(out, "shin_" + s, "0 " + std::to_string(y) + " -0.75 0 0 0",
+          Vector3d(0.08, 0.08, 0.45), 3.0);
+      BoxLink(out, "arm_" + s,
+          "0 " + std::to_string(2.5 * y) + " 0.35 0 0 0",
+          Vector3d(0.08, 0.08, 0.5), 2.0);
+      RevoluteJoint(out, "hip_" + s, "pelvis", "thigh_" + s,
+          "0 0 0.225 0 0 0", "0 1 0");
+      RevoluteJoint(out, "knee_" + s, "thigh_" + s, "shin_" + s,
+          "0 0 0.225 0 0 0", "0 1 0");
+      RevoluteJoint(out, "shoulder_" + s, "torso", "arm_" + s,
+          "0 0 0.25 0 0 0", "0 1 0");
+    }
+    out << "</model>";
+  }
+  return World(out.str());
+}
+
+/////////////////////////////////////////////////
+/// \brief Triangle meshes dropped in layers onto the ground.
+static std::string MeshClutter(std::size_t _count)
+{
+  const std::string &mesh = gz::physics::test::resources::kChassisDae;
+  // Some engines only construct meshes that are already loaded.
+  gz::common::MeshManager::Instance()->Load(mesh);
+
+  const std::size_t columns = GridColumns(_count);
+  std::ostringstream out;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const std::size_t layer = i / (columns * columns);
+    out << "<model name='mesh_" << i << "'><pose>"
+        << static_cast<double>(i % columns) << " "
+        << static_cast<double>((i / columns) % columns) << " "
+        << 0.5 + 0.5 * static_cast<double>(layer) << " 0 0 "
+        << 0.3 * static_cast<double>(i) << "</pose><link name='link'>";
+    Inertial(out, Vector3d(0.3, 0.3, 0.1), 1.0);
+    out << "<collision name='collision'><geometry><mesh><uri>" << mesh
+        << "</uri></mesh></geometry></collision></link></model>";
+  }
+  return World(out.str());
+}
+
+/////////////////////////////////////////////////
+/// \brief Columns of boxes that touch the boxes above, below and next to
+/// them, so every box is part of several resting contacts.
+static std::string ContactStacks(std::size_t _count)
+{
+  const std::size_t height = 8u;
+  const std::size_t columns = GridColumns(_count);
+  std::ostringstream out;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    for (std::size_t j = 0; j < height; ++j)
+    {
+      const Vector3d pos(
+          0.5 * static_cast<double>(i % columns),
+          0.5 * static_cast<double>(i / columns),
+          0.25 + 0.5 * static_cast<double>(j));
+      BoxModel(out, "stack_" + std::to_string(i) + "_" + std::to_string(j),
+          pos, Vector3d(0.5, 0.5, 0.5));
+    }
+  }
+  return World(out.str());
+}
+
+/////////////////////////////////////////////////
+/// \brief Step a scenario with one engine.
+/// \param[in] _st Benchmark state. Its first argument is the scenario size.
+/// \param[in] _pluginLib Path to the engine plugin library.
+/// \param[in] _sdf Function creating the scenario world.
+// NOLINTNEXTLINE
+static void BM_Scenario(benchmark::State &_st, const std::string &_pluginLib,
+    const std::function<std::string(std::size_t)> &_sdf)
+{
+  sdf::Root root;
+  const sdf::Errors errors = root.LoadSdfString(
+      _sdf(static_cast<std::size_t>(_st.range(0))));
+  if (!errors.empty() || nullptr == root.WorldByIndex(0))
+  {
+    _st.SkipWithError("Failed to load the scenario world");
+    return;
+  }
+
+  gz::plugin::Loader loader;
+  loader.LoadLib(_pluginLib);
+  const auto pluginNames = gz::physics::FindFeatures3d<Features>::From(loader);
+  if (pluginNames.empty())
+  {
+    _st.SkipWithError("The plugin does not provide the required features");
+    return;
+  }
+
+  const std::size_t memoryBefore = ResidentMemory();
+  auto engine = gz::physics::RequestEngine3d<Features>::From(
+      loader.Instantiate(*pluginNames.begin()));
+  auto world = engine ? engine->ConstructWorld(*root.WorldByIndex(0)) :
+      nullptr;
+  if (nullptr == world)
+  {
+    _st.SkipWithError("Failed to construct the scenario world");
+    return;
+  }
+
+  gz::physics::ForwardStep::Output output;
+  gz::physics::ForwardStep::State state;
+  gz::physics::ForwardStep::Input input;
+  input.Get<std::chrono::steady_clock::duration>() = kStepSize;
+
+  for (std::size_t i = 0; i < kWarmupSteps; ++i)
+    world->Step(output, state, input);
+
+  std::size_t contacts = 0u;
+  const auto start = std::chrono::steady_clock::now();
+  for (auto _ : _st)
+  {
+    world->Step(output, state, input);
+    contacts += world->GetStepStatistics().contactCount;
+  }
+  const double elapsed = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count();
+  const std::size_t memoryAfter = ResidentMemory();
+
+  const auto steps = static_cast<double>(_st.iterations());
+  _st.counters["steps_per_sec"] =
+      benchmark::Counter(steps, benchmark::Counter::kIsRate);
+  _st.counters["contacts"] = static_cast<double>(contacts) / steps;
+  _st.counters["ns_per_contact"] = contacts > 0u ?
+      elapsed / static_cast<double>(contacts) : 0.0;
+  _st.counters["memory_bytes"] = static_cast<double>(
+      memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0u);
+}
+
+/////////////////////////////////////////////////
+/// \brief Register a benchmark for every scenario and every engine plugin
+/// that was built.
+static const bool kRegistered = []()
+{
+  const auto plugins = EnginePlugins();
+
+  const std::vector<Scenario> scenarios = {
+    {"BoxPile", BoxPile, {64, 512}, {}},
+    {"Pendulums", Pendulums, {16, 256}, {"tpe"}},
+    {"HumanoidsOnTerrain", HumanoidsOnTerrain, {1, 8}, {"tpe"}},
+    {"MeshClutter", MeshClutter, {16, 64}, {}},
+    {"ContactStacks", ContactStacks, {4, 16}, {}},
+  };
+
+  for (const auto &scenario : scenarios)
+  {
+    for (const auto &[engine, lib] : plugins)
+    {
+      if (scenario.unsupportedEngines.count(engine) > 0)
+        continue;
+
+      const std::string name = scenario.name + "/" + engine;
+      auto *bench = benchmark::RegisterBenchmark(name.c_str(),
+          [lib = lib, sdf = scenario.sdf](benchmark::State &_st)
+          {
+            BM_Scenario(_st, lib, sdf);
+          });
+      for (const std::size_t size : scenario.sizes)
+        bench->Arg(static_cast<int64_t>(size));
+      bench->Iterations(kMeasuredSteps)->Unit(benchmark::kMillisecond);
+    }
+  }
+  return true;
+}();
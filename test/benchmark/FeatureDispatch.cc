@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gz/plugin/Loader.hh>
+
+#include <gz/physics/FindFeatures.hh>
+#include <gz/physics/RequestEngine.hh>
+#include <gz/physics/RequestFeatures.hh>
+
+#include "mock/MockFeatures.hh"
+#include "mock/MockFrameSemantics.hh"
+
+// Measures the overhead of the API layer that sits between an application
+// and a physics engine plugin, using the mock plugins so that the cost of
+// the engine itself is negligible:
+// - EntityPtr creation from an engine and copies of it.
+// - Calls that are dispatched through Entity::Interface.
+// - Casts of plugins and entities with RequestEngine and RequestFeatures.
+// - FrameSemantics::Resolve with 1, 2 and 3 frames.
+// - Checks of the features of a library with FindFeatures.
+// - Identities generated by a plugin with GenerateIdentity.
+
+std::int64_t gNumTests = 100000;
+
+using GetByNameList = gz::physics::FeatureList<mock::MockGetByName>;
+
+/////////////////////////////////////////////////
+/// \brief Loader with the mock plugins, shared by all benchmarks.
+gz::plugin::Loader &MockLoader()
+{
+  static gz::plugin::Loader loader;
+  static const bool loaded =
+      !loader.LoadLib(MockEntities_LIB).empty() &&
+      !loader.LoadLib(MockFrames_LIB).empty();
+  (void)loaded;
+  return loader;
+}
+
+/////////////////////////////////////////////////
+mock::MockEngine3dPtr MockEngine()
+{
+  return gz::physics::RequestEngine3d<mock::MockFeatureList>::From(
+      MockLoader().Instantiate("mock::EntitiesPlugin3d"));
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_EntityPtrCreate(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  auto engine = MockEngine();
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      benchmark::DoNotOptimize(engine->GetWorld("Some world"));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_EntityPtrCopy(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  auto engine = MockEngine();
+  const mock::MockWorld3dPtr world = engine->GetWorld("Some world");
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      mock::MockWorld3dPtr copy = world;
+      benchmark::DoNotOptimize(copy);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_InterfaceDispatch(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  auto engine = MockEngine();
+  const mock::MockWorld3dPtr world = engine->GetWorld("Some world");
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      benchmark::DoNotOptimize(world->Name());
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_RequestEngine(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  const gz::plugin::PluginPtr plugin =
+      MockLoader().Instantiate("mock::EntitiesPlugin3d");
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      benchmark::DoNotOptimize(
+          gz::physics::RequestEngine3d<mock::MockFeatureList>::From(plugin));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_RequestFeatures(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  auto engine =
+      gz::physics::RequestEngine3d<GetByNameList>::From(MockLoader()
+          .Instantiate("mock::EntitiesPlugin3d"));
+  const auto world = engine->GetWorld("Some world");
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      benchmark::DoNotOptimize(
+          gz::physics::RequestFeatures<mock::MockFeatureList>::From(world));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+// The argument is the number of frames that are involved: the parent frame
+// of the quantity, then the frame it is resolved relative to, then the frame
+// whose coordinates it is expressed in.
+// NOLINTNEXTLINE
+void BM_Resolve(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  const int numFrames = static_cast<int>(_st.range(1));
+
+  auto engine =
+      gz::physics::RequestEngine3d<mock::MockFrameSemanticsList>::From(
+          MockLoader().Instantiate("mock::MockFrameSemanticsPlugin3d"));
+
+  gz::physics::FrameData3d data;
+  data.pose.translation() = gz::physics::LinearVector3d(1.0, 2.0, 3.0);
+  data.linearVelocity = gz::physics::LinearVector3d(0.5, 0.0, 0.0);
+  const gz::physics::FrameID A = engine->CreateLink("A", data)->GetFrameID();
+  data.pose.rotate(Eigen::AngleAxisd(0.5, Eigen::Vector3d::UnitZ()));
+  const gz::physics::FrameID B = engine->CreateLink("B", data)->GetFrameID();
+  data.angularVelocity = gz::physics::AngularVector3d(0.0, 0.0, 0.2);
+  const gz::physics::FrameID C = engine->CreateLink("C", data)->GetFrameID();
+
+  const gz::physics::RelativeFrameData3d quantity(A, data);
+  const gz::physics::FrameID relativeTo =
+      numFrames > 1 ? B : gz::physics::FrameID::World();
+  const gz::physics::FrameID inCoordinatesOf = numFrames > 2 ? C : relativeTo;
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      benchmark::DoNotOptimize(
+          engine->Resolve(quantity, relativeTo, inCoordinatesOf));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_FindFeatures(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  const gz::plugin::Loader &loader = MockLoader();
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      benchmark::DoNotOptimize(
+          gz::physics::FindFeatures3d<mock::MockFeatureList>::From(loader));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Gives access to the identities that plugins generate.
+class IdentityGenerator : public gz::physics::detail::Implementation
+{
+  public: gz::physics::Identity Generate(
+      const std::size_t _id, const std::shared_ptr<void> &_ref) const
+  {
+    return this->GenerateIdentity(_id, _ref);
+  }
+};
+
+/////////////////////////////////////////////////
+// The argument is 1 for identities that hold a reference, 0 otherwise.
+// NOLINTNEXTLINE
+void BM_GenerateIdentity(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  const std::shared_ptr<void> ref =
+      _st.range(1) ? std::make_shared<int>(0) : nullptr;
+  const IdentityGenerator generator;
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      benchmark::DoNotOptimize(generator.Generate(i, ref));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_EntityPtrCreate)->Arg(gNumTests);
+// NOLINTNEXTLINE
+BENCHMARK(BM_EntityPtrCopy)->Arg(gNumTests);
+// NOLINTNEXTLINE
+BENCHMARK(BM_InterfaceDispatch)->Arg(gNumTests);
+// NOLINTNEXTLINE
+BENCHMARK(BM_RequestEngine)->Arg(gNumTests);
+// NOLINTNEXTLINE
+BENCHMARK(BM_RequestFeatures)->Arg(gNumTests);
+// NOLINTNEXTLINE
+BENCHMARK(BM_Resolve)->Args({gNumTests, 1})->Args({gNumTests, 2})
+    ->Args({gNumTests, 3});
+// NOLINTNEXTLINE
+BENCHMARK(BM_FindFeatures)->Arg(gNumTests / 100);
+// NOLINTNEXTLINE
+BENCHMARK(BM_GenerateIdentity)->Args({gNumTests, 0})->Args({gNumTests, 1});
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+#include <gz/physics/ForwardStep.hh>
+
+std::size_t gNumTests = 100000;
+
+using gz::physics::ChangedWorldPoses;
+using gz::physics::CompositeData;
+using gz::physics::Contacts;
+using gz::physics::ForwardStep;
+using gz::physics::WorldPoses;
+
+using Duration = std::chrono::steady_clock::duration;
+
+// Each benchmark runs the lookups a plugin performs in WorldForwardStep,
+// once with the ForwardStep data types and once through a plain
+// CompositeData, which always takes the map based lookup.
+
+template <class Output>
+// NOLINTNEXTLINE
+void BM_OutputGet(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  Output output;
+  output.template Get<WorldPoses>();
+  output.template Get<Contacts>();
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      benchmark::DoNotOptimize(&output.template Get<ChangedWorldPoses>());
+    }
+  }
+}
+
+template <class Input>
+// NOLINTNEXTLINE
+void BM_InputQuery(benchmark::State& _st)
+{
+  const std::size_t numTests = _st.range(0);
+  Input input;
+  input.template Get<Duration>() = std::chrono::milliseconds(1);
+  const Input &constInput = input;
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < numTests; ++i)
+    {
+      benchmark::DoNotOptimize(constInput.template Query<Duration>());
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_OutputGet, ForwardStep::Output)->Arg(gNumTests);
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_OutputGet, CompositeData)->Arg(gNumTests);
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_InputQuery, ForwardStep::Input)->Arg(gNumTests);
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(BM_InputQuery, CompositeData)->Arg(gNumTests);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gz/plugin/Loader.hh>
+
+#include <gz/physics/FindFeatures.hh>
+#include <gz/physics/RequestEngine.hh>
+#include <gz/physics/sdf/ConstructWorld.hh>
+#include <gz/physics/sdf/LoadReport.hh>
+
+#include <sdf/Root.hh>
+
+#include "test/Resources.hh"
+
+#include "EngineBenchmark.hh"
+
+// Constructs worlds from SDF with every engine plugin that provides a load
+// report, and breaks the time down into the steps of the report, summed over
+// the world and all of its models:
+// - sdf_parse_sec: Parsing the SDF string, before the engine is involved.
+// - sdf_resolution_sec, mesh_load_sec, convex_decomposition_sec,
+//   shape_creation_sec, engine_insertion_sec: The steps of the load report.
+// - slowest_model_sec: Time of the model that took longest.
+// The MeshManager keeps the meshes and their decompositions, so the mesh and
+// decomposition times of the first iteration dominate their averages.
+
+using Features = gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::sdf::GetSdfLoadReport
+>;
+
+/// \brief Worlds constructed by each benchmark.
+static constexpr std::size_t kIterations = 5;
+
+/////////////////////////////////////////////////
+/// \brief Free boxes, each in its own model.
+static std::string Boxes(std::size_t _count)
+{
+  const std::size_t columns = GridColumns(_count);
+  std::ostringstream out;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const Vector3d pos(static_cast<double>(i % columns),
+        static_cast<double>(i / columns), 0.5);
+    BoxModel(out, "box_" + std::to_string(i), pos, Vector3d(0.5, 0.5, 0.5));
+  }
+  return World(out.str());
+}
+
+/////////////////////////////////////////////////
+/// \brief Models of a mesh with an optimization.
+static std::string Meshes(std::size_t _count, const std::string &_optimization)
+{
+  const std::size_t columns = GridColumns(_count);
+  std::ostringstream out;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    out << "<model name='mesh_" << i << "'><pose>"
+        << 2.0 * static_cast<double>(i % columns) << " "
+        << 2.0 * static_cast<double>(i / columns)
+        << " 1 0 0 0</pose><link name='link'>";
+    Inertial(out, Vector3d(0.3, 0.3, 0.1), 1.0);
+    out << "<collision name='collision'><geometry><mesh optimization='"
+        << _optimization << "'><uri>"
+        << gz::physics::test::resources::kChassisDae
+        << "</uri></mesh></geometry></collision></link></model>";
+  }
+  return World(out.str());
+}
+
+/////////////////////////////////////////////////
+/// \brief Construct a world with one engine.
+/// \param[in] _st Benchmark state. Its first argument is the number of
+/// models.
+/// \param[in] _pluginLib Path to the engine plugin library.
+/// \param[in] _sdf Function creating the world.
+// NOLINTNEXTLINE
+static void BM_Load(benchmark::State &_st, const std::string &_pluginLib,
+    const std::function<std::string(std::size_t)> &_sdf)
+{
+  gz::plugin::Loader loader;
+  loader.LoadLib(_pluginLib);
+  const auto pluginNames = gz::physics::FindFeatures3d<Features>::From(loader);
+  if (pluginNames.empty())
+  {
+    _st.SkipWithError("The plugin does not provide the required features");
+    return;
+  }
+
+  const std::string sdfString = _sdf(static_cast<std::size_t>(_st.range(0)));
+  gz::physics::sdf::GetSdfLoadReport::LoadTimes total;
+  double parseTime = 0.0;
+  double slowestModelTime = 0.0;
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    auto engine = gz::physics::RequestEngine3d<Features>::From(
+        loader.Instantiate(*pluginNames.begin()));
+    _st.ResumeTiming();
+
+    const auto parseStart = std::chrono::steady_clock::now();
+    sdf::Root root;
+    const sdf::Errors errors = root.LoadSdfString(sdfString);
+    parseTime += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - parseStart).count();
+    if (!errors.empty() || nullptr == root.WorldByIndex(0))
+    {
+      _st.SkipWithError("Failed to load the world");
+      return;
+    }
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    if (nullptr == world)
+    {
+      _st.SkipWithError("Failed to construct the world");
+      return;
+    }
+
+    _st.PauseTiming();
+    const auto report = world->GetLoadReport();
+    std::vector<gz::physics::sdf::GetSdfLoadReport::LoadTimes> times = {
+        report.worldTimes};
+    for (const auto &model : report.models)
+    {
+      times.push_back(model.times);
+      slowestModelTime = std::max(slowestModelTime, model.times.TotalTime());
+    }
+    for (const auto &t : times)
+    {
+      total.sdfResolutionTime += t.sdfResolutionTime;
+      total.meshLoadTime += t.meshLoadTime;
+      total.convexDecompositionTime += t.convexDecompositionTime;
+      total.shapeCreationTime += t.shapeCreationTime;
+      total.engineInsertionTime += t.engineInsertionTime;
+    }
+    world = nullptr;
+    engine = nullptr;
+    _st.ResumeTiming();
+  }
+
+  const auto avg = benchmark::Counter::kAvgIterations;
+  _st.counters["sdf_parse_sec"] = benchmark::Counter(parseTime, avg);
+  _st.counters["sdf_resolution_sec"] =
+      benchmark::Counter(total.sdfResolutionTime, avg);
+  _st.counters["mesh_load_sec"] = benchmark::Counter(total.meshLoadTime, avg);
+  _st.counters["convex_decomposition_sec"] =
+      benchmark::Counter(total.convexDecompositionTime, avg);
+  _st.counters["shape_creation_sec"] =
+      benchmark::Counter(total.shapeCreationTime, avg);
+  _st.counters["engine_insertion_sec"] =
+      benchmark::Counter(total.engineInsertionTime, avg);
+  _st.counters["slowest_model_sec"] = slowestModelTime;
+}
+
+/////////////////////////////////////////////////
+/// \brief Register a benchmark for every world and every engine plugin that
+/// was built.
+static const bool kRegistered = []()
+{
+  const std::vector<std::pair<std::string,
+      std::function<std::string(std::size_t)>>> worlds = {
+    {"Boxes", Boxes},
+    {"Meshes", [](std::size_t _n) { return Meshes(_n, ""); }},
+    {"ConvexHullMeshes",
+        [](std::size_t _n) { return Meshes(_n, "convex_hull"); }},
+    {"ConvexDecomposedMeshes",
+        [](std::size_t _n) { return Meshes(_n, "convex_decomposition"); }},
+  };
+
+  for (const auto &[worldName, sdf] : worlds)
+  {
+    for (const auto &[engine, lib] : EnginePlugins())
+    {
+      const std::string name = "Load/" + worldName + "/" + engine;
+      benchmark::RegisterBenchmark(name.c_str(),
+          [lib = lib, sdf = sdf](benchmark::State &_st)
+          {
+            BM_Load(_st, lib, sdf);
+          })
+          ->RangeMultiplier(10)
+          ->Range(10, 1000)
+          ->Iterations(kIterations)
+          ->Unit(benchmark::kMillisecond);
+    }
+  }
+  return true;
+}();
@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gz/plugin/Loader.hh>
+
+#include <gz/physics/FindFeatures.hh>
+#include <gz/physics/ForwardStep.hh>
+#include <gz/physics/RequestEngine.hh>
+#include <gz/physics/World.hh>
+#include <gz/physics/sdf/ConstructWorld.hh>
+
+#include <sdf/Root.hh>
+
+#include "EngineBenchmark.hh"
+
+// Steps procedurally generated worlds of 10 to 100k boxes with every engine
+// plugin that was built, once with the defaults of the engine and once for
+// every thread count, collision detector and broadphase the engine lets us
+// choose. Each benchmark reports:
+// - build_sec: Time taken to construct the world.
+// - broadphase_pairs: Average number of pairs found by the broadphase per
+//   step, 0 where the engine does not report it.
+// - contacts: Average number of contact points per step.
+// - rss_bytes: Resident memory of the process after the last step.
+// - memory_bytes: Growth of the resident memory from before the engine was
+//   created until the last step.
+// Run with --benchmark_out=<file> --benchmark_out_format=csv (or json) to
+// record the results, and --benchmark_filter to pick engines or options.
+
+using BaseFeatures = gz::physics::FeatureList<
+  gz::physics::ForwardStep,
+  gz::physics::GetStepStatisticsFeature,
+  gz::physics::sdf::ConstructSdfWorld
+>;
+
+using ThreadFeatures = gz::physics::FeatureList<
+  BaseFeatures,
+  gz::physics::NumThreads
+>;
+
+using DetectorFeatures = gz::physics::FeatureList<
+  BaseFeatures,
+  gz::physics::CollisionDetector
+>;
+
+using BroadphaseFeatures = gz::physics::FeatureList<
+  BaseFeatures,
+  gz::physics::Broadphase
+>;
+
+/// \brief Step size of the worlds.
+static constexpr std::chrono::milliseconds kStepSize{1};
+
+/// \brief Steps taken before measuring, so the bodies have settled onto the
+/// ground.
+static constexpr std::size_t kWarmupSteps = 5;
+
+/// \brief Steps measured by each benchmark.
+static constexpr std::size_t kMeasuredSteps = 20;
+
+/// \brief Smallest and largest number of bodies.
+static constexpr int64_t kMinBodies = 10;
+static constexpr int64_t kMaxBodies = 100000;
+
+/// \brief Largest number of bodies for options whose broadphase tests every
+/// pair of bodies.
+static constexpr int64_t kMaxBodiesAllPairs = 1000;
+
+/////////////////////////////////////////////////
+/// \brief A grid of boxes resting on the ground, one meter apart, so that
+/// every body touches the ground but none touch each other.
+static std::string BoxGrid(std::size_t _count)
+{
+  const std::size_t columns = GridColumns(_count);
+  const double offset = -0.5 * static_cast<double>(columns);
+  std::ostringstream out;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const Vector3d pos(
+        offset + static_cast<double>(i % columns),
+        offset + static_cast<double>(i / columns),
+        0.26);
+    BoxModel(out, "box_" + std::to_string(i), pos, Vector3d(0.5, 0.5, 0.5));
+  }
+  return World(out.str(), static_cast<double>(columns) + 10.0);
+}
+
+/////////////////////////////////////////////////
+/// \brief Step a procedurally generated world with one engine.
+/// \param[in] _st Benchmark state. Its first argument is the number of
+/// bodies.
+/// \param[in] _pluginLib Path to the engine plugin library.
+/// \param[in] _configure Applies the option being benchmarked to the world.
+/// Returns false if the engine rejected the option.
+template <typename FeatureListT>
+// NOLINTNEXTLINE
+void BM_Scaling(benchmark::State &_st, const std::string &_pluginLib,
+    const std::function<bool(gz::physics::World3dPtr<FeatureListT> &)>
+        &_configure)
+{
+  sdf::Root root;
+  const sdf::Errors errors = root.LoadSdfString(
+      BoxGrid(static_cast<std::size_t>(_st.range(0))));
+  if (!errors.empty() || nullptr == root.WorldByIndex(0))
+  {
+    _st.SkipWithError("Failed to load the world");
+    return;
+  }
+
+  gz::plugin::Loader loader;
+  loader.LoadLib(_pluginLib);
+  const auto pluginNames =
+      gz::physics::FindFeatures3d<FeatureListT>::From(loader);
+  if (pluginNames.empty())
+  {
+    _st.SkipWithError("The plugin does not provide the required features");
+    return;
+  }
+
+  const std::size_t memoryBefore = ResidentMemory();
+  auto engine = gz::physics::RequestEngine3d<FeatureListT>::From(
+      loader.Instantiate(*pluginNames.begin()));
+  const auto buildStart = std::chrono::steady_clock::now();
+  auto world = engine ? engine->ConstructWorld(*root.WorldByIndex(0)) :
+      nullptr;
+  const double buildTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - buildStart).count();
+  if (nullptr == world)
+  {
+    _st.SkipWithError("Failed to construct the world");
+    return;
+  }
+
+  if (!_configure(world))
+  {
+    _st.SkipWithError("The engine does not support the option");
+    return;
+  }
+
+  gz::physics::ForwardStep::Output output;
+  gz::physics::ForwardStep::State state;
+  gz::physics::ForwardStep::Input input;
+  input.Get<std::chrono::steady_clock::duration>() = kStepSize;
+
+  for (std::size_t i = 0; i < kWarmupSteps; ++i)
+    world->Step(output, state, input);
+
+  std::size_t pairs = 0u;
+  std::size_t contacts = 0u;
+  for (auto _ : _st)
+  {
+    world->Step(output, state, input);
+    const auto stats = world->GetStepStatistics();
+    pairs += stats.candidatePairCount;
+    contacts += stats.contactCount;
+  }
+  const std::size_t memoryAfter = ResidentMemory();
+
+  const auto steps = static_cast<double>(_st.iterations());
+  _st.counters["build_sec"] = buildTime;
+  _st.counters["broadphase_pairs"] = static_cast<double>(pairs) / steps;
+  _st.counters["contacts"] = static_cast<double>(contacts) / steps;
+  _st.counters["rss_bytes"] = static_cast<double>(memoryAfter);
+  _st.counters["memory_bytes"] = static_cast<double>(
+      memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0u);
+}
+
+/////////////////////////////////////////////////
+/// \brief Register a benchmark of one engine and option.
+/// \param[in] _name Name of the benchmark.
+/// \param[in] _pluginLib Path to the engine plugin library.
+/// \param[in] _maxBodies Largest number of bodies to benchmark.
+/// \param[in] _configure Applies the option to the world.
+template <typename FeatureListT>
+void Register(const std::string &_name, const std::string &_pluginLib,
+    int64_t _maxBodies,
+    std::function<bool(gz::physics::World3dPtr<FeatureListT> &)> _configure)
+{
+  benchmark::RegisterBenchmark(_name.c_str(),
+      [_pluginLib, _configure](benchmark::State &_st)
+      {
+        BM_Scaling<FeatureListT>(_st, _pluginLib, _configure);
+      })
+      ->RangeMultiplier(10)
+      ->Range(kMinBodies, _maxBodies)
+      ->Iterations(kMeasuredSteps)
+      ->Unit(benchmark::kMillisecond);
+}
+
+/////////////////////////////////////////////////
+/// \brief Whether a plugin provides a list of features.
+template <typename FeatureListT>
+bool Provides(const std::string &_pluginLib)
+{
+  gz::plugin::Loader loader;
+  loader.LoadLib(_pluginLib);
+  return !gz::physics::FindFeatures3d<FeatureListT>::From(loader).empty();
+}
+
+/////////////////////////////////////////////////
+/// \brief Register a benchmark for the defaults and for every option of every
+/// engine plugin that was built.
+static const bool kRegistered = []()
+{
+  std::vector<std::size_t> threadCounts = {1u, 2u, 4u};
+  const std::size_t cores = std::thread::hardware_concurrency();
+  if (cores > threadCounts.back())
+    threadCounts.push_back(cores);
+
+  // Detectors and broadphases that are only benchmarked with small worlds.
+  const auto maxBodies = [](const std::string &_option)
+  {
+    return (_option == "dart" || _option == "simple") ?
+        kMaxBodiesAllPairs : kMaxBodies;
+  };
+
+  for (const auto &[engine, lib] : EnginePlugins())
+  {
+    const std::string prefix = "Scaling/" + engine + "/";
+    Register<BaseFeatures>(prefix + "default", lib, kMaxBodies,
+        [](auto &) { return true; });
+
+    if (Provides<ThreadFeatures>(lib))
+    {
+      for (const std::size_t threads : threadCounts)
+      {
+        Register<ThreadFeatures>(
+            prefix + "threads:" + std::to_string(threads), lib, kMaxBodies,
+            [threads](auto &_world)
+            {
+              _world->SetNumThreads(threads);
+              return _world->GetNumThreads() == threads;
+            });
+      }
+    }
+
+    if (Provides<DetectorFeatures>(lib))
+    {
+      for (const std::string detector :
+           {"ode", "threaded_ode", "bullet", "fcl", "dart"})
+      {
+        Register<DetectorFeatures>(
+            prefix + "detector:" + detector, lib, maxBodies(detector),
+            [detector](auto &_world)
+            {
+              _world->SetCollisionDetector(detector);
+              return _world->GetCollisionDetector() == detector;
+            });
+      }
+    }
+
+    if (Provides<BroadphaseFeatures>(lib))
+    {
+      for (const std::string broadphase : {"dbvt", "axis_sweep", "simple"})
+      {
+        Register<BroadphaseFeatures>(
+            prefix + "broadphase:" + broadphase, lib, maxBodies(broadphase),
+            [broadphase](auto &_world)
+            {
+              _world->SetBroadphase(broadphase);
+              return _world->GetBroadphase() == broadphase;
+            });
+      }
+    }
+  }
+  return true;
+}();
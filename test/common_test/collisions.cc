@@ -16,9 +16,15 @@
 */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <set>
 #include <sstream>
 #include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <gz/common/Console.hh>
 #include <gz/common/MeshManager.hh>
@@ -29,17 +35,23 @@
 #include "test/TestLibLoader.hh"
 #include "Worlds.hh"
 
+#include <gz/physics/BoxShape.hh>
+#include <gz/physics/CollisionCheck.hh>
 #include <gz/physics/FindFeatures.hh>
 #include <gz/physics/RequestEngine.hh>
+#include <gz/physics/ShapeQueries.hh>
 #include <gz/physics/ConstructEmpty.hh>
 #include <gz/physics/ForwardStep.hh>
 #include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/FreeJoint.hh>
 #include <gz/physics/GetContacts.hh>
 #include <gz/physics/GetEntities.hh>
+#include <gz/physics/Joint.hh>
 #include <gz/physics/mesh/MeshShape.hh>
+#include <gz/physics/mesh/TriangleMeshView.hh>
 #include <gz/physics/PlaneShape.hh>
 #include <gz/physics/FixedJoint.hh>
+#include <gz/physics/sdf/BakeStaticCollisions.hh>
 #include <gz/physics/sdf/ConstructModel.hh>
 #include <gz/physics/sdf/ConstructWorld.hh>
 
@@ -149,6 +161,65 @@ TYPED_TEST(CollisionTest, MeshAndPlane)
   }
 }
 
+using SimplifiedMeshFeaturesList = gz::physics::FeatureList<
+  CollisionFeaturesList,
+  gz::physics::mesh::SimplifyCollisionMeshesFeature
+>;
+
+using SimplifiedMeshTestFeaturesList =
+    CollisionTest<SimplifiedMeshFeaturesList>;
+
+TEST_F(SimplifiedMeshTestFeaturesList, MeshAndPlane)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+        gz::physics::RequestEngine3d<SimplifiedMeshFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    EXPECT_EQ(0u, engine->GetCollisionMeshTriangleBudget());
+    engine->SetCollisionMeshTriangleBudget(200u);
+    EXPECT_EQ(200u, engine->GetCollisionMeshTriangleBudget());
+
+    auto world = engine->ConstructEmptyWorld("world");
+    Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+    tf.translation()[2] = 2.0;
+
+    auto model = world->ConstructEmptyModel("mesh");
+    auto link = model->ConstructEmptyLink("link");
+
+    const std::string meshFilename = gz::physics::test::resources::kChassisDae;
+    auto &meshManager = *gz::common::MeshManager::Instance();
+    auto *mesh = meshManager.Load(meshFilename);
+    ASSERT_NE(nullptr, mesh);
+    link->AttachMeshShape("mesh", *mesh, tf);
+
+    model = world->ConstructEmptyModel("plane");
+    link = model->ConstructEmptyLink("link");
+    link->AttachPlaneShape("plane", gz::physics::LinearVector3d::UnitZ());
+    link->AttachFixedJoint(nullptr);
+
+    const auto link2 = world->GetModel(0)->GetLink(0);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+      world->Step(output, state, input);
+    }
+
+    // The simplified mesh keeps the overall shape of the chassis, so it is
+    // stopped by the plane about where the full mesh is in the test above.
+    // Clustering moves the outer vertices inwards by up to a grid cell.
+    EXPECT_NEAR(
+          -1.91, link2->FrameDataRelativeToWorld().pose.translation()[2], 0.25);
+  }
+}
+
 using CollisionMeshFeaturesList = gz::physics::FeatureList<
   gz::physics::sdf::ConstructSdfModel,
   gz::physics::sdf::ConstructSdfWorld,
@@ -196,8 +267,10 @@ TEST_F(CollisionMeshTestFeaturesList, MeshOptimization)
 
   for (const std::string &name : this->pluginNames)
   {
-    // currently only bullet-featherstone supports mesh decomposition
-    if (this->PhysicsEngineName(name) != "bullet-featherstone")
+    // currently only bullet-featherstone and dartsim support mesh
+    // decomposition
+    const std::string engineName = this->PhysicsEngineName(name);
+    if (engineName != "bullet-featherstone" && engineName != "dartsim")
       continue;
     std::cout << "Testing plugin: " << name << std::endl;
     gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
@@ -229,6 +302,11 @@ TEST_F(CollisionMeshTestFeaturesList, MeshOptimization)
     // Test all optimization methods
     for (const auto &optimizationStr : optimizations)
     {
+      // dartsim only constructs mesh collisions from SDF when they are
+      // optimized, other meshes are attached with AttachMeshShapeFeature
+      if (engineName == "dartsim" && optimizationStr.empty())
+        continue;
+
       // create the chassis model
       const std::string modelOptimizedName = "model_optimized_" + optimizationStr;
       sdf::Root root;
@@ -509,6 +587,873 @@ TEST_F(CollisionStaticTestFeaturesList, StaticCollisions)
   }
 }
 
+using CollisionBulkFeaturesList = gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfModels,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetContactsFromLastStepFeature,
+  gz::physics::ForwardStep
+>;
+
+using CollisionBulkTestFeaturesList =
+  CollisionTest<CollisionBulkFeaturesList>;
+
+TEST_F(CollisionBulkTestFeaturesList, ConstructModels)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    sdf::Root rootWorld;
+    const sdf::Errors errorsWorld =
+        rootWorld.Load(common_test::worlds::kGroundSdf);
+    ASSERT_TRUE(errorsWorld.empty()) << errorsWorld.front();
+
+    auto engine =
+        gz::physics::RequestEngine3d<CollisionBulkFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    auto world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+    const std::size_t initialModelCount = world->GetModelCount();
+
+    // pairs of overlapping boxes above the ground plane, with a null entry
+    // in the middle
+    const std::size_t count = 100u;
+    std::vector<sdf::Root> roots(count);
+    std::vector<const sdf::Model *> models;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      std::stringstream modelStr;
+      modelStr << R"(
+      <sdf version="1.11">
+        <model name="box_)" << i << R"(">
+          <pose>)" << 3.0 * (i / 2) + 0.5 * (i % 2) << R"( 0 2 0 0 0</pose>
+          <link name="body">
+            <collision name="collision">
+              <geometry>
+                <box><size>1 1 1</size></box>
+              </geometry>
+            </collision>
+          </link>
+        </model>
+      </sdf>)";
+      const sdf::Errors errors = roots[i].LoadSdfString(modelStr.str());
+      ASSERT_TRUE(errors.empty()) << errors.front();
+      ASSERT_NE(nullptr, roots[i].Model());
+      models.push_back(roots[i].Model());
+      if (i == count / 2)
+        models.push_back(nullptr);
+    }
+
+    auto newModels = world->ConstructModels(models);
+    ASSERT_EQ(models.size(), newModels.size());
+    EXPECT_EQ(initialModelCount + count, world->GetModelCount());
+    for (std::size_t i = 0; i < models.size(); ++i)
+    {
+      if (!models[i])
+      {
+        EXPECT_EQ(nullptr, newModels[i]);
+        continue;
+      }
+      ASSERT_NE(nullptr, newModels[i]);
+      EXPECT_EQ(models[i]->Name(), newModels[i]->GetName());
+      EXPECT_EQ(newModels[i], world->GetModel(models[i]->Name()));
+    }
+
+    // the boxes of each pair collide with each other
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    world->Step(output, state, input);
+    auto contacts = world->GetContactsFromLastStep();
+    EXPECT_LE(count / 2, contacts.size());
+  }
+}
+
+using CollisionBakeStaticFeaturesList = gz::physics::FeatureList<
+  gz::physics::sdf::BakeStaticCollisions,
+  gz::physics::sdf::ConstructSdfModel,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetEntities,
+  gz::physics::GetContactsFromLastStepFeature,
+  gz::physics::ForwardStep
+>;
+
+using CollisionBakeStaticTestFeaturesList =
+  CollisionTest<CollisionBakeStaticFeaturesList>;
+
+TEST_F(CollisionBakeStaticTestFeaturesList, BakeStaticCollisions)
+{
+  auto getModelStr = [](const std::string &_name,
+                        const gz::math::Pose3d &_pose,
+                        const std::string &_geometry, bool _static)
+  {
+    std::stringstream modelStr;
+    modelStr << R"(
+    <sdf version="1.11">
+      <model name=")" << _name << R"(">
+        <pose>)" << _pose << R"(</pose>
+        <static>)" << (_static ? "true" : "false") << R"(</static>
+        <link name="body">
+          <collision name="collision">
+            <geometry>)" << _geometry << R"(</geometry>
+          </collision>
+        </link>
+      </model>
+    </sdf>)";
+    return modelStr.str();
+  };
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        CollisionBakeStaticFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+    EXPECT_FALSE(engine->GetBakeStaticCollisions());
+    engine->SetBakeStaticCollisions(true);
+    EXPECT_TRUE(engine->GetBakeStaticCollisions());
+
+    // The ground plane is static, so it is baked as well
+    sdf::Root rootWorld;
+    const sdf::Errors errorsWorld =
+        rootWorld.Load(common_test::worlds::kGroundSdf);
+    ASSERT_TRUE(errorsWorld.empty()) << errorsWorld.front();
+    auto world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    const std::string box = "<box><size>1 1 1</size></box>";
+    const std::string sphere = "<sphere><radius>0.5</radius></sphere>";
+    std::vector<std::pair<std::string, std::string>> modelStrs = {
+      {"box_static", getModelStr("box_static",
+          gz::math::Pose3d(0, 0, 0.5, 0, 0, 0), box, true)},
+      {"sphere_on_box", getModelStr("sphere_on_box",
+          gz::math::Pose3d(0, 0, 2, 0, 0, 0), sphere, false)},
+      {"sphere_on_ground", getModelStr("sphere_on_ground",
+          gz::math::Pose3d(3, 0, 1, 0, 0, 0), sphere, false)},
+    };
+    for (const auto &[modelName, modelStr] : modelStrs)
+    {
+      sdf::Root root;
+      const sdf::Errors errors = root.LoadSdfString(modelStr);
+      ASSERT_TRUE(errors.empty()) << errors.front();
+      ASSERT_NE(nullptr, root.Model());
+      ASSERT_NE(nullptr, world->ConstructModel(*root.Model())) << modelName;
+    }
+
+    auto shapeID = [&](const std::string &_model)
+    {
+      auto model = world->GetModel(_model);
+      EXPECT_NE(nullptr, model);
+      return model->GetLink(0)->GetShape(0)->EntityID();
+    };
+    const std::size_t groundID = shapeID("ground_plane");
+    const std::size_t boxID = shapeID("box_static");
+    const std::size_t sphereOnBoxID = shapeID("sphere_on_box");
+    const std::size_t sphereOnGroundID = shapeID("sphere_on_ground");
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 1000; ++i)
+      world->Step(output, state, input);
+
+    // Contacts with the baked collider report the baked collisions, and the
+    // static box and ground, which overlap, do not collide.
+    using ContactPoint =
+        gz::physics::World3d<CollisionBakeStaticFeaturesList>::ContactPoint;
+    const auto contacts = world->GetContactsFromLastStep();
+    std::set<std::pair<std::size_t, std::size_t>> pairs;
+    for (const auto &contact : contacts)
+    {
+      const auto &point = contact.Get<ContactPoint>();
+      const std::size_t id1 = point.collision1->EntityID();
+      const std::size_t id2 = point.collision2->EntityID();
+      pairs.insert({std::min(id1, id2), std::max(id1, id2)});
+    }
+    const std::set<std::pair<std::size_t, std::size_t>> expectedPairs = {
+      {std::min(boxID, sphereOnBoxID), std::max(boxID, sphereOnBoxID)},
+      {std::min(groundID, sphereOnGroundID),
+       std::max(groundID, sphereOnGroundID)},
+    };
+    EXPECT_EQ(expectedPairs, pairs);
+  }
+}
+
+using CollisionCheckFeaturesList = gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfModel,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetEntities,
+  gz::physics::GetBasicJointState,
+  gz::physics::ModelCollisionCheckFeature
+>;
+
+using CollisionCheckTestFeaturesList =
+  CollisionTest<CollisionCheckFeaturesList>;
+
+TEST_F(CollisionCheckTestFeaturesList, CheckConfigurations)
+{
+  // A sphere that slides along x towards a static box, above the ground
+  const std::string sliderStr = R"(
+    <sdf version="1.11">
+      <model name="slider">
+        <pose>0 0 2 0 0 0</pose>
+        <link name="body">
+          <collision name="collision">
+            <geometry>
+              <sphere><radius>0.25</radius></sphere>
+            </geometry>
+          </collision>
+        </link>
+        <joint name="slide" type="prismatic">
+          <parent>world</parent>
+          <child>body</child>
+          <axis>
+            <xyz>1 0 0</xyz>
+          </axis>
+        </joint>
+      </model>
+    </sdf>)";
+  const std::string boxStr = R"(
+    <sdf version="1.11">
+      <model name="box">
+        <pose>2 0 2 0 0 0</pose>
+        <static>true</static>
+        <link name="body">
+          <collision name="collision">
+            <geometry>
+              <box><size>1 1 1</size></box>
+            </geometry>
+          </collision>
+        </link>
+      </model>
+    </sdf>)";
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        CollisionCheckFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root rootWorld;
+    const sdf::Errors errorsWorld =
+        rootWorld.Load(common_test::worlds::kGroundSdf);
+    ASSERT_TRUE(errorsWorld.empty()) << errorsWorld.front();
+    auto world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    for (const std::string &modelStr : {sliderStr, boxStr})
+    {
+      sdf::Root root;
+      const sdf::Errors errors = root.LoadSdfString(modelStr);
+      ASSERT_TRUE(errors.empty()) << errors.front();
+      ASSERT_NE(nullptr, root.Model());
+      ASSERT_NE(nullptr, world->ConstructModel(*root.Model()));
+    }
+
+    auto slider = world->GetModel("slider");
+    ASSERT_NE(nullptr, slider);
+    auto joint = slider->GetJoint("slide");
+    ASSERT_NE(nullptr, joint);
+    const std::size_t sphereID = slider->GetLink(0)->GetShape(0)->EntityID();
+    const std::size_t boxID =
+        world->GetModel("box")->GetLink(0)->GetShape(0)->EntityID();
+
+    using GeneralizedVector = Eigen::VectorXd;
+    auto free = slider->CheckConfiguration(
+        GeneralizedVector::Constant(1, 0.0), true);
+    EXPECT_TRUE(free.valid);
+    EXPECT_FALSE(free.inCollision);
+    EXPECT_NEAR(1.25, free.distance, 1e-3);
+
+    auto hit = slider->CheckConfiguration(GeneralizedVector::Constant(1, 2.0));
+    EXPECT_TRUE(hit.valid);
+    EXPECT_TRUE(hit.inCollision);
+    EXPECT_EQ(sphereID, hit.collision1);
+    EXPECT_EQ(boxID, hit.collision2);
+    EXPECT_DOUBLE_EQ(0.0, hit.distance);
+
+    auto wrongSize = slider->CheckConfiguration(GeneralizedVector::Zero(2));
+    EXPECT_FALSE(wrongSize.valid);
+
+    // Batches give the same results on any number of threads, and leave the
+    // model where it was.
+    std::vector<GeneralizedVector> configurations;
+    for (int i = 0; i < 48; ++i)
+    {
+      configurations.push_back(
+          GeneralizedVector::Constant(1, 0.025 + 0.05 * i));
+    }
+    const auto serial = slider->CheckConfigurations(configurations);
+    const auto threaded = slider->CheckConfigurations(configurations, true, 4);
+    ASSERT_EQ(configurations.size(), serial.size());
+    ASSERT_EQ(configurations.size(), threaded.size());
+    for (std::size_t i = 0; i < configurations.size(); ++i)
+    {
+      // The sphere is inside the box from 1.25 to 2.75
+      const double x = configurations[i][0];
+      EXPECT_TRUE(serial[i].valid);
+      EXPECT_EQ(x > 1.25, serial[i].inCollision) << x;
+      EXPECT_EQ(serial[i].inCollision, threaded[i].inCollision) << x;
+      EXPECT_EQ(serial[i].collision1, threaded[i].collision1) << x;
+      EXPECT_EQ(serial[i].collision2, threaded[i].collision2) << x;
+      if (!threaded[i].inCollision)
+        EXPECT_NEAR(1.25 - x, threaded[i].distance, 1e-3);
+    }
+    EXPECT_DOUBLE_EQ(0.0, joint->GetPosition(0));
+  }
+}
+
+using CollisionDistanceFeaturesList = gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfModel,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetEntities,
+  gz::physics::ShapeDistanceFeature
+>;
+
+using CollisionDistanceTestFeaturesList =
+  CollisionTest<CollisionDistanceFeaturesList>;
+
+TEST_F(CollisionDistanceTestFeaturesList, ShapeDistances)
+{
+  auto getModelStr = [](const std::string &_name,
+                        const gz::math::Pose3d &_pose,
+                        const std::string &_geometry)
+  {
+    std::stringstream modelStr;
+    modelStr << R"(
+    <sdf version="1.11">
+      <model name=")" << _name << R"(">
+        <pose>)" << _pose << R"(</pose>
+        <static>true</static>
+        <link name="body">
+          <collision name="collision">
+            <geometry>)" << _geometry << R"(</geometry>
+          </collision>
+        </link>
+      </model>
+    </sdf>)";
+    return modelStr.str();
+  };
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        CollisionDistanceFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root rootWorld;
+    const sdf::Errors errorsWorld =
+        rootWorld.Load(common_test::worlds::kGroundSdf);
+    ASSERT_TRUE(errorsWorld.empty()) << errorsWorld.front();
+    auto world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    // Spheres of radius 0.5 one meter apart, and a box two meters from the
+    // first sphere, all far above the ground
+    const std::string sphere = "<sphere><radius>0.5</radius></sphere>";
+    const std::string box = "<box><size>1 1 1</size></box>";
+    for (const std::string &modelStr : {
+          getModelStr("sphere_a", gz::math::Pose3d(0, 0, 5, 0, 0, 0), sphere),
+          getModelStr("sphere_b", gz::math::Pose3d(2, 0, 5, 0, 0, 0), sphere),
+          getModelStr("box", gz::math::Pose3d(0, 3, 5, 0, 0, 0), box)})
+    {
+      sdf::Root root;
+      const sdf::Errors errors = root.LoadSdfString(modelStr);
+      ASSERT_TRUE(errors.empty()) << errors.front();
+      ASSERT_NE(nullptr, root.Model());
+      ASSERT_NE(nullptr, world->ConstructModel(*root.Model()));
+    }
+
+    auto shapeID = [&](const std::string &_model)
+    {
+      auto model = world->GetModel(_model);
+      EXPECT_NE(nullptr, model);
+      return model->GetLink(0)->GetShape(0)->EntityID();
+    };
+    const std::size_t sphereA = shapeID("sphere_a");
+    const std::size_t sphereB = shapeID("sphere_b");
+    const std::size_t boxID = shapeID("box");
+
+    const auto distances = world->ComputeShapeDistances(
+        {{sphereA, sphereB}, {sphereA, boxID}, {sphereA, sphereA + 1000u}});
+    ASSERT_EQ(3u, distances.size());
+
+    EXPECT_TRUE(distances[0].valid);
+    EXPECT_EQ(sphereA, distances[0].shape1);
+    EXPECT_EQ(sphereB, distances[0].shape2);
+    EXPECT_NEAR(1.0, distances[0].distance, 1e-3);
+    EXPECT_TRUE(distances[0].point1.isApprox(
+        Eigen::Vector3d(0.5, 0, 5), 1e-3));
+    EXPECT_TRUE(distances[0].point2.isApprox(
+        Eigen::Vector3d(1.5, 0, 5), 1e-3));
+    EXPECT_TRUE(distances[0].normal.isApprox(Eigen::Vector3d::UnitX(), 1e-3));
+
+    EXPECT_TRUE(distances[1].valid);
+    EXPECT_NEAR(2.0, distances[1].distance, 1e-3);
+    EXPECT_TRUE(distances[1].normal.isApprox(Eigen::Vector3d::UnitY(), 1e-3));
+
+    // The second shape does not exist
+    EXPECT_FALSE(distances[2].valid);
+
+    // The box is beyond the cutoff
+    const auto cut = world->ComputeShapeDistances({{sphereA, boxID}}, 1.5);
+    ASSERT_EQ(1u, cut.size());
+    EXPECT_FALSE(cut[0].valid);
+
+    // Only the other sphere is within the cutoff of the first one
+    const std::size_t linkA =
+        world->GetModel("sphere_a")->GetLink(0)->EntityID();
+    const auto near = world->ComputeLinkDistances({linkA}, 1.5);
+    ASSERT_EQ(1u, near.size());
+    EXPECT_TRUE(near[0].valid);
+    EXPECT_EQ(sphereA, near[0].shape1);
+    EXPECT_EQ(sphereB, near[0].shape2);
+    EXPECT_NEAR(1.0, near[0].distance, 1e-3);
+
+    const auto all = world->ComputeLinkDistances({linkA}, 2.5);
+    ASSERT_EQ(2u, all.size());
+    EXPECT_EQ(std::min(sphereB, boxID), all[0].shape2);
+    EXPECT_EQ(std::max(sphereB, boxID), all[1].shape2);
+  }
+}
+
+using CollisionMeshViewFeaturesList = gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfModel,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::GetEntities,
+  gz::physics::mesh::AttachMeshViewShapeFeature
+>;
+
+using CollisionMeshViewTestFeaturesList =
+  CollisionTest<CollisionMeshViewFeaturesList>;
+
+TEST_F(CollisionMeshViewTestFeaturesList, MappedMeshFile)
+{
+  // A unit cube centered on its origin, with outward facing triangles
+  const std::vector<float> vertices = {
+    -0.5f, -0.5f, -0.5f,   0.5f, -0.5f, -0.5f,
+     0.5f,  0.5f, -0.5f,  -0.5f,  0.5f, -0.5f,
+    -0.5f, -0.5f,  0.5f,   0.5f, -0.5f,  0.5f,
+     0.5f,  0.5f,  0.5f,  -0.5f,  0.5f,  0.5f};
+  const std::vector<std::uint32_t> indices = {
+    0, 2, 1,  0, 3, 2,  4, 5, 6,  4, 6, 7,
+    0, 1, 5,  0, 5, 4,  1, 2, 6,  1, 6, 5,
+    2, 3, 7,  2, 7, 6,  3, 0, 4,  3, 4, 7};
+
+  gz::physics::mesh::TriangleMeshView cube;
+  cube.vertices = vertices.data();
+  cube.vertexCount = vertices.size() / 3u;
+  cube.indices = indices.data();
+  cube.indexCount = indices.size();
+
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "collisions_cube.gztm")
+          .string();
+  ASSERT_TRUE(gz::physics::mesh::WriteTriangleMeshFile(path, cube));
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    sdf::Root rootWorld;
+    const sdf::Errors errorsWorld =
+        rootWorld.Load(common_test::worlds::kGroundSdf);
+    ASSERT_TRUE(errorsWorld.empty()) << errorsWorld.front();
+
+    auto engine = gz::physics::RequestEngine3d<
+        CollisionMeshViewFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    auto world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.LoadSdfString(R"(
+    <sdf version="1.11">
+      <model name="cube">
+        <pose>0 0 2 0 0 0</pose>
+        <link name="body"/>
+      </model>
+    </sdf>)");
+    ASSERT_TRUE(errors.empty()) << errors.front();
+    auto model = world->ConstructModel(*root.Model());
+    ASSERT_NE(nullptr, model);
+    auto link = model->GetLink(0);
+    ASSERT_NE(nullptr, link);
+
+    // The view keeps the mapping alive after it goes out of scope here
+    {
+      const auto mapped = gz::physics::mesh::MapTriangleMeshFile(path);
+      ASSERT_TRUE(gz::physics::mesh::ValidTriangleMeshView(mapped));
+      EXPECT_EQ(cube.vertexCount, mapped.vertexCount);
+      EXPECT_EQ(cube.indexCount, mapped.indexCount);
+      EXPECT_NE(nullptr, link->AttachMeshViewShape("mesh", mapped));
+    }
+
+    // Views with indices out of range are rejected
+    gz::physics::mesh::TriangleMeshView broken = cube;
+    broken.vertexCount = 4u;
+    EXPECT_EQ(nullptr, link->AttachMeshViewShape("broken", broken));
+
+    // tpe does not simulate gravity
+    if (this->PhysicsEngineName(name) == "tpe")
+      continue;
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+      world->Step(output, state, input);
+    }
+
+    // The cube comes to rest on the ground plane
+    EXPECT_NEAR(
+        0.5, link->FrameDataRelativeToWorld().pose.translation()[2], 0.05);
+  }
+
+  std::filesystem::remove(path);
+}
+
+using CollisionConvexMeshFeaturesList = gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfModel,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::GetEntities,
+  gz::physics::mesh::AttachConvexMeshShapeFeature,
+  gz::physics::mesh::AttachConvexDecompositionShapeFeature
+>;
+
+using CollisionConvexMeshTestFeaturesList =
+  CollisionTest<CollisionConvexMeshFeaturesList>;
+
+TEST_F(CollisionConvexMeshTestFeaturesList, AttachConvexShapes)
+{
+  // Attach the convex hull and the convex decomposition of a mesh to links
+  // built without SDF collisions, drop them from some height, and verify
+  // they collide with the ground plane like the optimized SDF meshes
+
+  const std::string meshFilename = gz::physics::test::resources::kChassisDae;
+  auto &meshManager = *gz::common::MeshManager::Instance();
+  const auto *mesh = meshManager.Load(meshFilename);
+  ASSERT_NE(nullptr, mesh);
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    sdf::Root rootWorld;
+    const sdf::Errors errorsWorld =
+        rootWorld.Load(common_test::worlds::kGroundSdf);
+    ASSERT_TRUE(errorsWorld.empty()) << errorsWorld.front();
+
+    auto engine = gz::physics::RequestEngine3d<
+        CollisionConvexMeshFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    auto world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    auto constructLink = [&](const std::string &_name, double _y)
+    {
+      std::stringstream modelStr;
+      modelStr << R"(
+      <sdf version="1.11">
+        <model name=")" << _name << R"(">
+          <pose>0 )" << _y << R"( 2 0 0 0</pose>
+          <link name="body"/>
+        </model>
+      </sdf>)";
+      sdf::Root root;
+      const sdf::Errors errors = root.LoadSdfString(modelStr.str());
+      EXPECT_TRUE(errors.empty()) << errors;
+      return world->ConstructModel(*root.Model())->GetLink(0);
+    };
+
+    auto hullLink = constructLink("convex_hull", 0.0);
+    ASSERT_NE(nullptr, hullLink);
+    EXPECT_NE(nullptr, hullLink->AttachConvexMeshShape("hull", *mesh));
+
+    auto decompositionLink = constructLink("convex_decomposition", 2.0);
+    ASSERT_NE(nullptr, decompositionLink);
+    EXPECT_NE(nullptr, decompositionLink->AttachConvexDecompositionShape(
+        "decomposition", *mesh, 8u));
+
+    // A decomposition needs at least one hull
+    EXPECT_EQ(nullptr, decompositionLink->AttachConvexDecompositionShape(
+        "empty", *mesh, 0u));
+
+    // The resting poses are those of the MeshOptimization test, which only
+    // covers bullet-featherstone and dartsim
+    const std::string engineName = this->PhysicsEngineName(name);
+    if (engineName != "bullet-featherstone" && engineName != "dartsim")
+      continue;
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 3000u; ++i)
+      world->Step(output, state, input);
+
+    for (const auto &link : {hullLink, decompositionLink})
+    {
+      const auto frameData = link->FrameDataRelativeToWorld();
+      EXPECT_NEAR(0.1, frameData.pose.translation().z(), 1e-2);
+      EXPECT_NEAR(0.0, frameData.linearVelocity.z(), 1e-2);
+    }
+  }
+}
+
+using CollisionFittedPrimitiveFeaturesList = gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfModel,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetEntities,
+  gz::physics::GetBoxShapeProperties,
+  gz::physics::mesh::FitCollisionMeshPrimitivesFeature
+>;
+
+using CollisionFittedPrimitiveTestFeaturesList =
+  CollisionTest<CollisionFittedPrimitiveFeaturesList>;
+
+TEST_F(CollisionFittedPrimitiveTestFeaturesList, SdfMeshes)
+{
+  // A mesh that is a box in all but name collides as a box once fitting is
+  // enabled, and as a mesh otherwise
+  auto &meshManager = *gz::common::MeshManager::Instance();
+  const std::string meshName = "collisions_fitted_box";
+  if (!meshManager.HasMesh(meshName))
+    meshManager.CreateBox(meshName, {1.0, 0.5, 0.2}, {1.0, 1.0});
+
+  auto modelStr = [&](const std::string &_name)
+  {
+    std::stringstream str;
+    str << R"(
+    <sdf version="1.11">
+      <model name=")" << _name << R"(">
+        <link name="body">
+          <collision name="collision">
+            <geometry>
+              <mesh>
+                <uri>)" << meshName << R"(</uri>
+                <scale>2 2 2</scale>
+              </mesh>
+            </geometry>
+          </collision>
+        </link>
+      </model>
+    </sdf>)";
+    return str.str();
+  };
+
+  for (const std::string &name : this->pluginNames)
+  {
+    // dartsim only constructs mesh collisions from SDF when they are
+    // optimized, see the AttachedMeshes test
+    if (this->PhysicsEngineName(name) != "bullet-featherstone")
+      continue;
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        CollisionFittedPrimitiveFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+    EXPECT_DOUBLE_EQ(0.0, engine->GetCollisionMeshPrimitiveTolerance());
+
+    sdf::Root rootWorld;
+    const sdf::Errors errorsWorld =
+        rootWorld.Load(common_test::worlds::kGroundSdf);
+    ASSERT_TRUE(errorsWorld.empty()) << errorsWorld.front();
+    auto world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    auto constructShape = [&](const std::string &_name)
+    {
+      sdf::Root root;
+      const sdf::Errors errors = root.LoadSdfString(modelStr(_name));
+      EXPECT_TRUE(errors.empty()) << errors;
+      return world->ConstructModel(*root.Model())->GetLink(0)->GetShape(0);
+    };
+
+    auto mesh = constructShape("mesh");
+    ASSERT_NE(nullptr, mesh);
+    EXPECT_EQ(nullptr, mesh->CastToBoxShape());
+
+    engine->SetCollisionMeshPrimitiveTolerance(0.01);
+    EXPECT_DOUBLE_EQ(0.01, engine->GetCollisionMeshPrimitiveTolerance());
+    auto fitted = constructShape("fitted");
+    ASSERT_NE(nullptr, fitted);
+    auto box = fitted->CastToBoxShape();
+    ASSERT_NE(nullptr, box);
+    EXPECT_TRUE(gz::physics::Vector3d(2.0, 1.0, 0.4).isApprox(
+        box->GetSize(), 1e-6));
+  }
+}
+
+using CollisionAttachedPrimitiveFeaturesList = gz::physics::FeatureList<
+  CollisionFeaturesList,
+  gz::physics::GetBoxShapeProperties,
+  gz::physics::mesh::FitCollisionMeshPrimitivesFeature
+>;
+
+using CollisionAttachedPrimitiveTestFeaturesList =
+  CollisionTest<CollisionAttachedPrimitiveFeaturesList>;
+
+TEST_F(CollisionAttachedPrimitiveTestFeaturesList, AttachedMeshes)
+{
+  auto &meshManager = *gz::common::MeshManager::Instance();
+  const std::string meshName = "collisions_fitted_box";
+  if (!meshManager.HasMesh(meshName))
+    meshManager.CreateBox(meshName, {1.0, 0.5, 0.2}, {1.0, 1.0});
+  const auto *mesh = meshManager.MeshByName(meshName);
+  ASSERT_NE(nullptr, mesh);
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        CollisionAttachedPrimitiveFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    auto world = engine->ConstructEmptyWorld("world");
+    auto link = world->ConstructEmptyModel("model")->ConstructEmptyLink("link");
+    Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+    tf.translation() = Eigen::Vector3d(1.0, 2.0, 3.0);
+
+    auto shape = link->AttachMeshShape("mesh", *mesh, tf);
+    ASSERT_NE(nullptr, shape);
+    EXPECT_EQ(nullptr, shape->CastToBoxShape());
+
+    // A scale that keeps the box a box is applied to the fitted box
+    engine->SetCollisionMeshPrimitiveTolerance(0.01);
+    shape = link->AttachMeshShape(
+        "fitted", *mesh, tf, Eigen::Vector3d(2.0, 1.0, 1.0));
+    ASSERT_NE(nullptr, shape);
+    auto box = shape->CastToBoxShape();
+    ASSERT_NE(nullptr, box);
+    EXPECT_TRUE(gz::physics::Vector3d(2.0, 0.5, 0.2).isApprox(
+        box->GetSize(), 1e-6));
+  }
+}
+
+using CollisionSelfSamplingFeaturesList = gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfModel,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetEntities,
+  gz::physics::ForwardStep,
+  gz::physics::SelfCollisionSamplingFeature
+>;
+
+using CollisionSelfSamplingTestFeaturesList =
+  CollisionTest<CollisionSelfSamplingFeaturesList>;
+
+TEST_F(CollisionSelfSamplingTestFeaturesList, NeverCollidingLinkPairs)
+{
+  // An arm fixed to the world whose joints barely turn, so that only its
+  // first and last links, which overlap, collide
+  auto linkStr = [](const std::string &_name, const std::string &_pose)
+  {
+    return R"(
+        <link name=")" + _name + R"(">
+          <pose>)" + _pose + R"(</pose>
+          <collision name="collision">
+            <geometry>
+              <box><size>0.5 0.5 0.5</size></box>
+            </geometry>
+          </collision>
+        </link>)";
+  };
+  auto jointStr = [](const std::string &_parent, const std::string &_child)
+  {
+    return R"(
+        <joint name=")" + _child + R"(_joint" type="revolute">
+          <parent>)" + _parent + R"(</parent>
+          <child>)" + _child + R"(</child>
+          <axis>
+            <xyz>0 0 1</xyz>
+            <limit><lower>-0.05</lower><upper>0.05</upper></limit>
+          </axis>
+        </joint>)";
+  };
+  const std::string armStr = R"(
+    <sdf version="1.11">
+      <model name="arm">
+        <self_collide>true</self_collide>)" +
+        linkStr("base", "0 0 1 0 0 0") +
+        linkStr("a", "1 0 1 0 0 0") +
+        linkStr("b", "3 0 1 0 0 0") +
+        linkStr("c", "0.1 0 1 0 0 0") + R"(
+        <joint name="fix" type="fixed">
+          <parent>world</parent>
+          <child>base</child>
+        </joint>)" +
+        jointStr("base", "a") + jointStr("a", "b") + jointStr("b", "c") + R"(
+      </model>
+    </sdf>)";
+
+  sdf::Root root;
+  const sdf::Errors errors = root.LoadSdfString(armStr);
+  ASSERT_TRUE(errors.empty()) << errors.front();
+  ASSERT_NE(nullptr, root.Model());
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        CollisionSelfSamplingFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+    EXPECT_EQ(0u, engine->GetSelfCollisionSampleCount());
+
+    sdf::Root rootWorld;
+    const sdf::Errors errorsWorld =
+        rootWorld.Load(common_test::worlds::kGroundSdf);
+    ASSERT_TRUE(errorsWorld.empty()) << errorsWorld.front();
+    auto world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    // Models are not sampled by default
+    auto unsampled = world->ConstructModel(*root.Model());
+    ASSERT_NE(nullptr, unsampled);
+    EXPECT_EQ(0u, unsampled->GetNeverCollidingLinkPairCount());
+
+    // Of the 6 pairs of links, the first and last link always collide
+    engine->SetSelfCollisionSampleCount(200u);
+    EXPECT_EQ(200u, engine->GetSelfCollisionSampleCount());
+    world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+    auto arm = world->ConstructModel(*root.Model());
+    ASSERT_NE(nullptr, arm);
+    const std::size_t ignored = arm->GetNeverCollidingLinkPairCount();
+    EXPECT_LE(1u, ignored);
+    EXPECT_GE(5u, ignored);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    world->Step(output, state, input);
+    EXPECT_EQ(ignored, arm->GetNeverCollidingLinkPairCount());
+  }
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -16,6 +16,10 @@
 */
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <gz/common/Console.hh>
 #include <gz/plugin/Loader.hh>
 
@@ -24,6 +28,7 @@
 #include <gz/physics/ConstructEmpty.hh>
 #include <gz/physics/FindFeatures.hh>
 #include <gz/physics/GetEntities.hh>
+#include <gz/physics/MemoryResourceFeature.hh>
 #include <gz/physics/RequestEngine.hh>
 #include <gz/physics/RemoveEntities.hh>
 
@@ -415,6 +420,110 @@ TYPED_TEST(ConstructEmptyWorldTestUpToEmptyNestedModelFeature2,
   }
 }
 
+using FeaturesRemoveModels = gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::ConstructEmptyWorldFeature,
+  gz::physics::GetWorldFromEngine,
+  gz::physics::ConstructEmptyModelFeature,
+  gz::physics::GetModelFromWorld,
+  gz::physics::ConstructEmptyNestedModelFeature,
+  gz::physics::GetNestedModelFromModel,
+  gz::physics::RemoveEntities,
+  gz::physics::RemoveModelsFromWorld
+>;
+
+template <class T>
+class ConstructEmptyWorldTestRemoveModels :
+  public ConstructEmptyWorldTest<T>{};
+using ConstructEmptyWorldTestRemoveModelsTypes =
+  ::testing::Types<FeaturesRemoveModels>;
+TYPED_TEST_SUITE(ConstructEmptyWorldTestRemoveModels,
+                 ConstructEmptyWorldTestRemoveModelsTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(ConstructEmptyWorldTestRemoveModels, RemoveModels)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    gz::physics::EnginePtr<FeaturePolicy3d, TypeParam> engine;
+    gz::physics::WorldPtr<FeaturePolicy3d, TypeParam> world;
+    this->MakeEmptyWorld(name, engine, world);
+
+    std::vector<gz::physics::ModelPtr<FeaturePolicy3d, TypeParam>> models;
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+      models.push_back(world->ConstructEmptyModel("model" + std::to_string(i)));
+      ASSERT_NE(nullptr, models.back());
+    }
+    auto nestedModel = models[4]->ConstructEmptyNestedModel("nested");
+    ASSERT_NE(nullptr, nestedModel);
+
+    // Unknown and repeated names are skipped
+    EXPECT_EQ(3u, world->RemoveModels(
+        {"model1", "model4", "unknown", "model1", "model5"}));
+    EXPECT_EQ(3u, world->GetModelCount());
+    EXPECT_TRUE(models[1]->Removed());
+    EXPECT_TRUE(models[4]->Removed());
+    EXPECT_TRUE(models[5]->Removed());
+    EXPECT_TRUE(nestedModel->Removed());
+
+    // The remaining models keep their order
+    EXPECT_EQ(models[0], world->GetModel(0));
+    EXPECT_EQ(models[2], world->GetModel(1));
+    EXPECT_EQ(models[3], world->GetModel(2));
+    EXPECT_EQ(2u, models[3]->GetIndex());
+
+    EXPECT_EQ(0u, world->RemoveModels({}));
+    EXPECT_EQ(3u, world->RemoveModels({"model0", "model2", "model3"}));
+    EXPECT_EQ(0u, world->GetModelCount());
+  }
+}
+
+using FeaturesMemoryResource = gz::physics::FeatureList<
+  FeaturesUpToEmptyLink,
+  gz::physics::RemoveEntities,
+  gz::physics::MemoryResourceFeature
+>;
+
+template <class T>
+class ConstructEmptyWorldTestMemoryResource :
+  public ConstructEmptyWorldTest<T>{};
+using ConstructEmptyWorldTestMemoryResourceTypes =
+  ::testing::Types<FeaturesMemoryResource>;
+TYPED_TEST_SUITE(ConstructEmptyWorldTestMemoryResource,
+                 ConstructEmptyWorldTestMemoryResourceTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(ConstructEmptyWorldTestMemoryResource, MemoryResource)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+    auto engine = gz::physics::RequestEngine3d<TypeParam>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+    EXPECT_EQ(nullptr, engine->GetMemoryResource());
+
+    auto arena = std::make_shared<gz::physics::ArenaMemoryResource>();
+    engine->SetMemoryResource(arena);
+    EXPECT_EQ(arena, engine->GetMemoryResource());
+
+    // Entities constructed afterwards are allocated from the arena
+    auto world = engine->ConstructEmptyWorld("empty world");
+    auto model = world->ConstructEmptyModel("empty model");
+    auto link = model->ConstructEmptyLink("empty link");
+    ASSERT_NE(nullptr, link);
+    const std::size_t inUse = arena->GetBytesInUse();
+    EXPECT_LT(0u, inUse);
+
+    EXPECT_TRUE(model->Remove());
+    EXPECT_GT(inUse, arena->GetBytesInUse());
+
+    engine->SetMemoryResource(nullptr);
+    EXPECT_EQ(nullptr, engine->GetMemoryResource());
+  }
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -16,7 +16,9 @@
 */
 #include <gtest/gtest.h>
 
+#include <string>
 #include <tuple>
+#include <vector>
 
 #include "test/TestLibLoader.hh"
 #include "Worlds.hh"
@@ -26,6 +28,7 @@
 #include <gz/math/Vector3.hh>
 #include <gz/math/eigen3/Conversions.hh>
 #include <gz/plugin/Loader.hh>
+#include <sdf/Model.hh>
 #include <sdf/Root.hh>
 #include <sdf/World.hh>
 
@@ -316,6 +319,96 @@ TEST_F(FreeGroupFeaturesTest, FreeGroupSetWorldPosePrincipalAxesOffset)
   }
 }
 
+struct StatesFeatureList : gz::physics::FeatureList<
+    TestFeatureList,
+    gz::physics::SetFreeGroupWorldStates > { };
+
+TEST_F(FreeGroupFeaturesTest, SetFreeGroupStates)
+{
+  const std::string modelStr = R"(
+    <sdf version="1.11">
+      <model name="sphere">
+        <pose>0 0 5 0 0 0</pose>
+        <link name="link">
+          <collision name="coll_sphere">
+            <geometry>
+              <sphere>
+                <radius>0.1</radius>
+              </sphere>
+            </geometry>
+          </collision>
+        </link>
+      </model>
+    </sdf>)";
+
+  for (const std::string &name : pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = loader.Instantiate(name);
+
+    auto engine =
+        gz::physics::RequestEngine3d<StatesFeatureList>::From(plugin);
+    if (nullptr == engine)
+    {
+      std::cerr << "Plugin " << name << " does not support "
+                << "SetFreeGroupWorldStates" << std::endl;
+      continue;
+    }
+
+    sdf::Root root;
+    sdf::Errors errors = root.Load(common_test::worlds::kGroundSdf);
+    EXPECT_EQ(0u, errors.size()) << errors;
+    const sdf::World *sdfWorld = root.WorldByIndex(0);
+    ASSERT_NE(nullptr, sdfWorld);
+
+    auto world = engine->ConstructWorld(*sdfWorld);
+    ASSERT_NE(nullptr, world);
+
+    errors = root.LoadSdfString(modelStr);
+    ASSERT_TRUE(errors.empty()) << errors;
+    ASSERT_NE(nullptr, root.Model());
+
+    // Construct two copies of the sphere and move both in one call
+    sdf::Model sdfModel = *root.Model();
+    auto model1 = world->ConstructModel(sdfModel);
+    sdfModel.SetName("sphere2");
+    auto model2 = world->ConstructModel(sdfModel);
+    ASSERT_NE(nullptr, model1);
+    ASSERT_NE(nullptr, model2);
+
+    auto freeGroup1 = model1->FindFreeGroup();
+    auto freeGroup2 = model2->FindFreeGroup();
+    ASSERT_NE(nullptr, freeGroup1);
+    ASSERT_NE(nullptr, freeGroup2);
+
+    using FreeGroupState =
+        gz::physics::SetFreeGroupWorldStates::FreeGroupStateT<
+            gz::physics::FeaturePolicy3d>;
+    std::vector<FreeGroupState> states(2);
+    const gz::math::Pose3d pose1(1, 2, 3, 0, 0, 0);
+    const gz::math::Pose3d pose2(-1, -2, 4, 0, 0, GZ_PI_2);
+    states[0].freeGroup = freeGroup1->EntityID();
+    states[0].pose = gz::math::eigen3::convert(pose1);
+    states[0].linearVelocity = Eigen::Vector3d(0.5, 0, 0);
+    states[1].freeGroup = freeGroup2->EntityID();
+    states[1].pose = gz::math::eigen3::convert(pose2);
+    states[1].angularVelocity = Eigen::Vector3d(0, 0, 1);
+    world->SetFreeGroupStates(states);
+
+    auto frameData1 = model1->GetLink(0)->FrameDataRelativeToWorld();
+    EXPECT_EQ(pose1, gz::math::eigen3::convert(frameData1.pose));
+    EXPECT_TRUE(frameData1.linearVelocity.isApprox(
+        Eigen::Vector3d(0.5, 0, 0), 1e-6));
+    EXPECT_NEAR(0.0, frameData1.angularVelocity.norm(), 1e-6);
+
+    auto frameData2 = model2->GetLink(0)->FrameDataRelativeToWorld();
+    EXPECT_EQ(pose2, gz::math::eigen3::convert(frameData2.pose));
+    EXPECT_NEAR(0.0, frameData2.linearVelocity.norm(), 1e-6);
+    EXPECT_TRUE(frameData2.angularVelocity.isApprox(
+        Eigen::Vector3d(0, 0, 1), 1e-6));
+  }
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
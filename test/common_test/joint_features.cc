@@ -17,6 +17,9 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <cmath>
+#include <sstream>
+#include <string>
 
 #include <gz/common/Console.hh>
 #include <gz/plugin/Loader.hh>
@@ -99,6 +102,102 @@ using JointFeaturesTestTypes =
 TYPED_TEST_SUITE(JointFeaturesTest,
                  JointFeaturesTestTypes);
 
+/////////////////////////////////////////////////
+// The joint states written to the output of a step match the state of each
+// joint, and the changed joint states are a subset of them.
+TYPED_TEST(JointFeaturesTest, JointStatesOutput)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    // bullet does not write joint states
+    if(this->PhysicsEngineName(name) == "bullet")
+    {
+      GTEST_SKIP();
+    }
+
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<JointFeatureList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kTestWorld);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    auto model = world->GetModel("double_pendulum_with_base");
+    ASSERT_NE(nullptr, model);
+    model->GetJoint("upper_joint")->SetPosition(0, 0.5);
+
+    auto expectNear = [](double _expected, double _actual)
+    {
+      if (std::isnan(_expected))
+        EXPECT_TRUE(std::isnan(_actual));
+      else
+        EXPECT_DOUBLE_EQ(_expected, _actual);
+    };
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    output.Get<gz::physics::JointStates>();
+    output.Get<gz::physics::ChangedJointStates>();
+    for (std::size_t step = 0; step < 10; ++step)
+    {
+      world->Step(output, state, input);
+
+      const auto &states = output.Get<gz::physics::JointStates>();
+      const auto &changed = output.Get<gz::physics::ChangedJointStates>();
+      ASSERT_EQ(states.joints.size(), states.dofs.size());
+      ASSERT_EQ(states.joints.size(), states.positions.size());
+      ASSERT_EQ(states.joints.size(), states.velocities.size());
+      ASSERT_EQ(states.joints.size(), states.accelerations.size());
+      ASSERT_EQ(states.joints.size(), states.efforts.size());
+      ASSERT_EQ(changed.joints.size(), changed.efforts.size());
+      ASSERT_LE(changed.joints.size(), states.joints.size());
+
+      // Every joint starts out changed
+      if (step == 0)
+        EXPECT_EQ(states.joints.size(), changed.joints.size());
+
+      for (std::size_t i = 0; i < model->GetJointCount(); ++i)
+      {
+        auto joint = model->GetJoint(i);
+        std::size_t numEntries = 0;
+        for (std::size_t j = 0; j < states.joints.size(); ++j)
+        {
+          if (states.joints[j] != joint->EntityID())
+            continue;
+
+          const std::size_t dof = states.dofs[j];
+          EXPECT_EQ(numEntries, dof);
+          ++numEntries;
+          expectNear(joint->GetPosition(dof), states.positions[j]);
+          expectNear(joint->GetVelocity(dof), states.velocities[j]);
+          expectNear(joint->GetAcceleration(dof), states.accelerations[j]);
+          expectNear(joint->GetForce(dof), states.efforts[j]);
+        }
+        EXPECT_EQ(joint->GetDegreesOfFreedom(), numEntries);
+      }
+
+      for (std::size_t j = 0; j < changed.joints.size(); ++j)
+      {
+        std::size_t k = 0;
+        while (k < states.joints.size() &&
+               (states.joints[k] != changed.joints[j] ||
+                states.dofs[k] != changed.dofs[j]))
+        {
+          ++k;
+        }
+        ASSERT_LT(k, states.joints.size());
+        expectNear(states.positions[k], changed.positions[j]);
+        expectNear(states.velocities[k], changed.velocities[j]);
+      }
+    }
+  }
+}
+
 TYPED_TEST(JointFeaturesTest, JointSetCommand)
 {
   for (const std::string &name : this->pluginNames)
@@ -194,6 +293,195 @@ TYPED_TEST(JointFeaturesTest, JointSetCommand)
   }
 }
 
+struct JointFeatureModelStateList : gz::physics::FeatureList<
+    gz::physics::GetBasicJointProperties,
+    gz::physics::GetBasicJointState,
+    gz::physics::GetJointFromModel,
+    gz::physics::GetModelFromWorld,
+    gz::physics::GetModelJointState,
+    gz::physics::SetBasicJointState,
+    gz::physics::SetModelJointState,
+    gz::physics::sdf::ConstructSdfWorld
+> { };
+
+template <class T>
+class JointFeaturesModelStateTest :
+  public JointFeaturesTest<T>{};
+using JointFeaturesModelStateTestTypes =
+  ::testing::Types<JointFeatureModelStateList>;
+TYPED_TEST_SUITE(JointFeaturesModelStateTest,
+                 JointFeaturesModelStateTestTypes);
+
+TYPED_TEST(JointFeaturesModelStateTest, ModelJointState)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<JointFeatureModelStateList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors =
+      root.Load(common_test::worlds::kPendulumJointWrenchSdf);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    auto model = world->GetModel("pendulum");
+    ASSERT_NE(nullptr, model);
+
+    std::size_t dofs = 0;
+    for (std::size_t i = 0; i < model->GetJointCount(); ++i)
+      dofs += model->GetJoint(i)->GetDegreesOfFreedom();
+    ASSERT_GT(dofs, 0u);
+
+    Eigen::VectorXd values;
+    model->GetJointPositions(values);
+    ASSERT_EQ(static_cast<Eigen::Index>(dofs), values.size());
+
+    // Every DOF gets a distinct value, so a wrong layout is detected.
+    Eigen::VectorXd positions(static_cast<Eigen::Index>(dofs));
+    Eigen::VectorXd velocities(static_cast<Eigen::Index>(dofs));
+    for (Eigen::Index k = 0; k < positions.size(); ++k)
+    {
+      positions[k] = 0.1 * static_cast<double>(k + 1);
+      velocities[k] = -0.2 * static_cast<double>(k + 1);
+    }
+    model->SetJointPositions(positions);
+    model->SetJointVelocities(velocities);
+
+    model->GetJointPositions(values);
+    EXPECT_TRUE(positions.isApprox(values, 1e-6));
+    model->GetJointVelocities(values);
+    EXPECT_TRUE(velocities.isApprox(values, 1e-6));
+
+    // The vectors match the per joint accessors.
+    Eigen::Index k = 0;
+    for (std::size_t i = 0; i < model->GetJointCount(); ++i)
+    {
+      auto joint = model->GetJoint(i);
+      for (std::size_t dof = 0; dof < joint->GetDegreesOfFreedom(); ++dof, ++k)
+      {
+        EXPECT_NEAR(positions[k], joint->GetPosition(dof), 1e-6);
+        EXPECT_NEAR(velocities[k], joint->GetVelocity(dof), 1e-6);
+      }
+    }
+
+    // Vectors of the wrong size or with non-finite values are ignored.
+    gz::common::Console::SetVerbosity(0);
+    model->SetJointPositions(Eigen::VectorXd::Zero(positions.size() + 1));
+    Eigen::VectorXd nanPositions = positions;
+    nanPositions[0] = std::numeric_limits<double>::quiet_NaN();
+    model->SetJointPositions(nanPositions);
+    gz::common::Console::SetVerbosity(4);
+    model->GetJointPositions(values);
+    EXPECT_TRUE(positions.isApprox(values, 1e-6));
+  }
+}
+
+struct JointFeaturePDControlList : gz::physics::FeatureList<
+    gz::physics::ForwardStep,
+    gz::physics::GetBasicJointState,
+    gz::physics::GetJointFromModel,
+    gz::physics::GetModelFromWorld,
+    gz::physics::ModelJointPDControlFeature,
+    gz::physics::sdf::ConstructSdfWorld
+> { };
+
+template <class T>
+class JointFeaturesPDControlTest :
+  public JointFeaturesTest<T>{};
+using JointFeaturesPDControlTestTypes =
+  ::testing::Types<JointFeaturePDControlList>;
+TYPED_TEST_SUITE(JointFeaturesPDControlTest,
+                 JointFeaturesPDControlTestTypes);
+
+TYPED_TEST(JointFeaturesPDControlTest, ModelJointPDControl)
+{
+  using JointPDControl =
+    gz::physics::ModelJointPDControlFeature::JointPDControlT<
+      gz::physics::FeaturePolicy3d>;
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<JointFeaturePDControlList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors =
+      root.Load(common_test::worlds::kStringPendulumSdf);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    auto model = world->GetModel("pendulum");
+    ASSERT_NE(nullptr, model);
+    auto pivot = model->GetJoint("pivot");
+    ASSERT_NE(nullptr, pivot);
+
+    // The pivot is the only joint DOF of the model
+    const Eigen::VectorXd zero = Eigen::VectorXd::Zero(1);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    auto step = [&](std::size_t _steps)
+    {
+      for (std::size_t i = 0; i < _steps; ++i)
+        world->Step(output, state, input);
+    };
+
+    // Targets can not be set before there is a controller, and vectors of
+    // the wrong size are rejected.
+    gz::common::Console::SetVerbosity(0);
+    EXPECT_FALSE(model->SetJointPDControlTargets(zero, zero));
+    JointPDControl control;
+    control.positionGains = Eigen::VectorXd::Zero(2);
+    control.velocityGains = zero;
+    control.targetPositions = zero;
+    control.targetVelocities = zero;
+    EXPECT_FALSE(model->SetJointPDControl(control));
+    gz::common::Console::SetVerbosity(4);
+
+    // The pendulum starts at rest away from the vertical, so gravity
+    // compensation alone holds it where it is.
+    control.positionGains = zero;
+    ASSERT_TRUE(model->SetJointPDControl(control));
+    step(200);
+    EXPECT_NEAR(0.0, pivot->GetPosition(0), 1e-6);
+    EXPECT_NEAR(0.0, pivot->GetVelocity(0), 1e-6);
+
+    // Critically damped gains bring the pendulum to its targets
+    control.positionGains = Eigen::VectorXd::Constant(1, 600.0);
+    control.velocityGains = Eigen::VectorXd::Constant(1, 120.0);
+    control.targetPositions = Eigen::VectorXd::Constant(1, 0.5);
+    ASSERT_TRUE(model->SetJointPDControl(control));
+    step(2000);
+    EXPECT_NEAR(0.5, pivot->GetPosition(0), 1e-3);
+    EXPECT_NEAR(0.0, pivot->GetVelocity(0), 1e-3);
+
+    EXPECT_TRUE(model->SetJointPDControlTargets(
+        Eigen::VectorXd::Constant(1, -0.3), zero));
+    step(2000);
+    EXPECT_NEAR(-0.3, pivot->GetPosition(0), 1e-3);
+    EXPECT_NEAR(0.0, pivot->GetVelocity(0), 1e-3);
+
+    // Without its controller, the pendulum swings down again
+    model->RemoveJointPDControl();
+    step(200);
+    EXPECT_GT(std::abs(pivot->GetPosition(0) + 0.3), 0.01);
+
+    gz::common::Console::SetVerbosity(0);
+    EXPECT_FALSE(model->SetJointPDControlTargets(zero, zero));
+    gz::common::Console::SetVerbosity(4);
+  }
+}
+
 struct JointFeaturePositionLimitsList : gz::physics::FeatureList<
     gz::physics::ForwardStep,
     gz::physics::GetBasicJointProperties,
@@ -1638,6 +1926,236 @@ TEST_F(WorldModelTest, JointSetCommand)
   }
 }
 
+struct JointFeatureAttachAsConstraintList : gz::physics::FeatureList<
+    JointFeatureAttachDetachList,
+    gz::physics::AttachFixedJointAsConstraintFeature
+> { };
+
+template <class T>
+class JointFeaturesAttachAsConstraintTest :
+  public JointFeaturesTest<T>{};
+using JointFeaturesAttachAsConstraintTestTypes =
+  ::testing::Types<JointFeatureAttachAsConstraintList>;
+TYPED_TEST_SUITE(JointFeaturesAttachAsConstraintTest,
+                 JointFeaturesAttachAsConstraintTestTypes);
+
+/////////////////////////////////////////////////
+// Repeatedly attach and detach links of different models with fixed joints
+// that are held by a constraint
+TYPED_TEST(JointFeaturesAttachAsConstraintTest, JointAttachDetach)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        JointFeatureAttachAsConstraintList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+    EXPECT_FALSE(engine->GetAttachFixedJointAsConstraint());
+    engine->SetAttachFixedJointAsConstraint(true);
+    EXPECT_TRUE(engine->GetAttachFixedJointAsConstraint());
+
+    sdf::Root root;
+    const sdf::Errors errors =
+      root.Load(common_test::worlds::kJointAcrossModelsSdf);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+
+    auto model1 = world->GetModel("M1");
+    auto model2 = world->GetModel("M2");
+    auto model1Body = model1->GetLink("body");
+    auto model2Body = model2->GetLink("body");
+    const std::size_t model2JointCount = model2->GetJointCount();
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+
+    const std::size_t numSteps = 100;
+    for (int cycle = 0; cycle < 3; ++cycle)
+    {
+      // Let model2 fall for a while
+      for (std::size_t i = 0; i < numSteps; ++i)
+        world->Step(output, state, input);
+      EXPECT_GT(0.0, model2Body->FrameDataRelativeToWorld().linearVelocity.z());
+
+      const auto poseParentChild =
+          model1Body->FrameDataRelativeToWorld().pose.inverse() *
+          model2Body->FrameDataRelativeToWorld().pose;
+      auto fixedJoint = model2Body->AttachFixedJoint(model1Body);
+      ASSERT_NE(nullptr, fixedJoint);
+      fixedJoint->SetTransformFromParent(poseParentChild);
+      EXPECT_EQ(0u, fixedJoint->GetDegreesOfFreedom());
+
+      // The joint does not restructure the models
+      EXPECT_EQ(model2JointCount, model2->GetJointCount());
+      EXPECT_EQ("body", model2Body->GetName());
+
+      // model2 is held in place by model1, which rests on the ground
+      for (std::size_t i = 0; i < 2 * numSteps; ++i)
+        world->Step(output, state, input);
+      const auto frameData1 = model1Body->FrameDataRelativeToWorld();
+      const auto frameData2 = model2Body->FrameDataRelativeToWorld();
+      EXPECT_NEAR(0.0, frameData1.linearVelocity.z(), 1e-3);
+      EXPECT_NEAR(0.0, frameData2.linearVelocity.z(), 1e-3);
+      EXPECT_TRUE((frameData1.pose.inverse() * frameData2.pose).isApprox(
+          poseParentChild, 1e-3));
+
+      fixedJoint->Detach();
+      // Detaching twice does nothing
+      fixedJoint->Detach();
+    }
+  }
+}
+
+struct JointFeatureModelConstraintList : gz::physics::FeatureList<
+    gz::physics::ForwardStep,
+    gz::physics::GetBasicJointProperties,
+    gz::physics::GetBasicJointState,
+    gz::physics::GetEngineInfo,
+    gz::physics::GetJointFromModel,
+    gz::physics::GetModelFromWorld,
+    gz::physics::RemoveModelFromWorld,
+    gz::physics::SetBasicJointState,
+    gz::physics::SetJointPositionLimitsFeature,
+    gz::physics::SetJointVelocityCommandFeature,
+    gz::physics::SetMimicConstraintFeature,
+    gz::physics::sdf::ConstructSdfWorld
+> { };
+
+template <class T>
+class JointFeaturesModelConstraintTest :
+  public JointFeaturesTest<T>{};
+using JointFeaturesModelConstraintTestTypes =
+  ::testing::Types<JointFeatureModelConstraintList>;
+TYPED_TEST_SUITE(JointFeaturesModelConstraintTest,
+                 JointFeaturesModelConstraintTestTypes);
+
+/////////////////////////////////////////////////
+/// \brief SDF of a model whose base is fixed to the world, with three links
+/// that turn about the vertical axis of the base, so that gravity does not
+/// move them. j2 is limited to [-0.3, 0.3].
+/// \param[in] _name Name of the model.
+/// \param[in] _y Position of the model along y.
+static std::string ConstrainedArm(const std::string &_name, double _y)
+{
+  std::ostringstream out;
+  out << "<model name='" << _name << "'>"
+      << "<pose>0 " << _y << " 1 0 0 0</pose>"
+      << "<joint name='fix' type='fixed'><parent>world</parent>"
+      << "<child>base</child></joint>"
+      << "<link name='base'><inertial><mass>10</mass><inertia>"
+      << "<ixx>1</ixx><iyy>1</iyy><izz>1</izz></inertia></inertial></link>";
+  for (int i = 1; i <= 3; ++i)
+  {
+    out << "<link name='l" << i << "'><pose>" << i << " 0 0 0 0 0</pose>"
+        << "<inertial><mass>1</mass><inertia><ixx>0.1</ixx><iyy>0.1</iyy>"
+        << "<izz>0.1</izz></inertia></inertial></link>"
+        << "<joint name='j" << i << "' type='revolute'><parent>base</parent>"
+        << "<child>l" << i << "</child><axis><xyz>0 0 1</xyz><limit>"
+        << (i == 2 ? "<lower>-0.3</lower><upper>0.3</upper>" :
+                     "<lower>-1e16</lower><upper>1e16</upper>")
+        << "</limit></axis></joint>";
+  }
+  out << "</model>";
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+// The motors, limits and gears of the joints of a model act together, also
+// after another model and its constraints are removed.
+TYPED_TEST(JointFeaturesModelConstraintTest, MotorsLimitsAndGears)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    // The joints of bullet-featherstone models share one constraint, whose
+    // rows are checked here
+    if (this->PhysicsEngineName(name) != "bullet-featherstone")
+    {
+      GTEST_SKIP();
+    }
+
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        JointFeatureModelConstraintList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.LoadSdfString(
+        "<sdf version='1.11'><world name='arms'>" +
+        ConstrainedArm("arm_a", 0.0) + ConstrainedArm("arm_b", 5.0) +
+        "</world></sdf>");
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+    auto armA = world->GetModel("arm_a");
+    auto armB = world->GetModel("arm_b");
+    ASSERT_NE(nullptr, armA);
+    ASSERT_NE(nullptr, armB);
+
+    // j3 turns at twice the angle of j1
+    for (const auto &model : {armA, armB})
+    {
+      EXPECT_TRUE(model->GetJoint("j3")->SetMimicConstraint(
+          0, model->GetJoint("j1"), 0, 2.0, 0.0, 0.0));
+    }
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+
+    // j1 tracks its velocity command, j2 is driven into its upper limit
+    auto command = [&](
+        const gz::physics::Model3dPtr<JointFeatureModelConstraintList> &_model,
+        double _velocity)
+    {
+      _model->GetJoint("j1")->SetVelocityCommand(0, _velocity);
+      _model->GetJoint("j2")->SetVelocityCommand(0, 1.0);
+    };
+    auto expectConstrained = [&](
+        const gz::physics::Model3dPtr<JointFeatureModelConstraintList> &_model,
+        double _velocity, double _limit)
+    {
+      const auto j1 = _model->GetJoint("j1");
+      EXPECT_NEAR(_velocity, j1->GetVelocity(0), 1e-2) << _model->GetName();
+      EXPECT_NEAR(_limit, _model->GetJoint("j2")->GetPosition(0), 1e-2)
+          << _model->GetName();
+      EXPECT_NEAR(2.0 * j1->GetPosition(0),
+                  _model->GetJoint("j3")->GetPosition(0), 5e-3)
+          << _model->GetName();
+    };
+
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+      command(armA, 0.5);
+      command(armB, -0.5);
+      world->Step(output, state, input);
+    }
+    expectConstrained(armA, 0.5, 0.3);
+    expectConstrained(armB, -0.5, 0.3);
+    EXPECT_NEAR(0.5, armA->GetJoint("j1")->GetPosition(0), 2e-2);
+    EXPECT_NEAR(-0.5, armB->GetJoint("j1")->GetPosition(0), 2e-2);
+
+    // The constraints of arm_a go with it, those of arm_b keep acting, and
+    // its limits can be changed
+    EXPECT_TRUE(world->RemoveModel("arm_a"));
+    EXPECT_TRUE(armA->Removed());
+    armB->GetJoint("j2")->SetMinPosition(0, -0.1);
+    armB->GetJoint("j2")->SetMaxPosition(0, 0.1);
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+      command(armB, 0.25);
+      world->Step(output, state, input);
+    }
+    expectConstrained(armB, 0.25, 0.1);
+  }
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -527,3 +527,89 @@ int main(int argc, char *argv[])
     return -1;
   return RUN_ALL_TESTS();
 }
+
+struct JointMimicBatchFeatureList : gz::physics::FeatureList<
+    JointMimicFeatureList,
+    gz::physics::SetMimicConstraintsFeature>{};
+
+using JointMimicBatchFeatureTest =
+    JointMimicFeaturesTest<JointMimicBatchFeatureList>;
+
+// Set all the mimic constraints of the pendulum world with one call, and
+// retune them repeatedly, as a controller would.
+TEST_F(JointMimicBatchFeatureTest, PendulumMimicBatchTest)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+        gz::physics::RequestEngine3d<JointMimicBatchFeatureList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors =
+      root.Load(common_test::worlds::kMimicPendulumWorld);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+
+    auto model = world->GetModel("pendulum_with_base");
+    auto leaderJoint = model->GetJoint("upper_joint_1");
+    auto followerJoint = model->GetJoint("upper_joint_2");
+
+    using MimicConstraint = gz::physics::SetMimicConstraintsFeature::
+        MimicConstraintT<gz::physics::FeaturePolicy3d>;
+
+    // Constraints without joints are skipped.
+    EXPECT_EQ(0u, world->SetMimicConstraints({MimicConstraint()}));
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+
+    auto testMimicFcn = [&](double multiplier, double offset, double reference)
+      {
+        MimicConstraint constraint;
+        constraint.follower = followerJoint;
+        constraint.leader = leaderJoint;
+        constraint.multiplier = multiplier;
+        constraint.offset = offset;
+        constraint.reference = reference;
+        EXPECT_EQ(1u, world->SetMimicConstraints({constraint}));
+
+        leaderJoint->SetPosition(0, 0);
+        followerJoint->SetPosition(0, 0);
+        for (int _ = 0; _ < 75; _++)
+          world->Step(output, state, input);
+
+        const double positionTolerance = 5e-3;
+        for (int _ = 0; _ < 10; _++)
+        {
+          world->Step(output, state, input);
+          EXPECT_NEAR(
+              multiplier * (leaderJoint->GetPosition(0) - reference) + offset,
+              followerJoint->GetPosition(0),
+              positionTolerance);
+        }
+      };
+
+    // The first call creates the constraint and the others update it.
+    testMimicFcn(1, 0, 0);
+    testMimicFcn(-1, 0.2, 0);
+    testMimicFcn(2, 0.3, -0.1);
+
+    // A multi-axis constraint is rejected without affecting the others.
+    MimicConstraint multiAxis;
+    multiAxis.follower = followerJoint;
+    multiAxis.followerDof = 1;
+    multiAxis.leader = leaderJoint;
+    MimicConstraint valid;
+    valid.follower = followerJoint;
+    valid.leader = leaderJoint;
+    EXPECT_EQ(1u, world->SetMimicConstraints({multiAxis, valid}));
+
+    std::cout << "Finished testing plugin: " << name << std::endl;
+  }
+}
@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <vector>
 
 #include <gz/common/Console.hh>
 #include <gz/plugin/Loader.hh>
@@ -156,6 +157,7 @@ struct JointTransmittedWrenchFeatureList : gz::physics::FeatureList<
     gz::physics::GetJointTransmittedWrench,
     gz::physics::GetLinkFromModel,
     gz::physics::GetModelFromWorld,
+    gz::physics::GetModelJointTransmittedWrenches,
     gz::physics::LinkFrameSemantics,
     gz::physics::SetBasicJointState,
     gz::physics::SetFreeGroupWorldPose,
@@ -469,6 +471,30 @@ TYPED_TEST(JointTransmittedWrenchFixture, ContactForces)
                                        wrenchAtMotorJointInJoint, 1e-4));
 }
 
+TYPED_TEST(JointTransmittedWrenchFixture, ModelJointTransmittedWrenches)
+{
+  this->motorJoint->SetPosition(0, GZ_DTOR(90.0));
+  this->Step(100);
+
+  // The batched wrenches match the per joint wrenches, in joint index order.
+  std::vector<gz::physics::Wrench3d> wrenches;
+  this->model->GetJointTransmittedWrenches(wrenches);
+  ASSERT_EQ(this->model->GetJointCount(), wrenches.size());
+  for (std::size_t i = 0; i < wrenches.size(); ++i)
+  {
+    EXPECT_TRUE(gz::physics::test::Equal(
+        this->model->GetJoint(i)->GetTransmittedWrench(), wrenches[i], 1e-9));
+  }
+
+  // The vector is overwritten, not appended to.
+  this->Step(1);
+  this->model->GetJointTransmittedWrenches(wrenches);
+  ASSERT_EQ(this->model->GetJointCount(), wrenches.size());
+  EXPECT_TRUE(gz::physics::test::Equal(
+      this->motorJoint->GetTransmittedWrench(),
+      wrenches[this->motorJoint->GetIndex()], 1e-9));
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
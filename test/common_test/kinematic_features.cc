@@ -16,6 +16,8 @@
  */
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include <gz/common/Console.hh>
 #include <gz/plugin/Loader.hh>
 
@@ -29,6 +31,7 @@
 #include <gz/physics/FindFeatures.hh>
 #include <gz/physics/ForwardStep.hh>
 #include <gz/physics/GetEntities.hh>
+#include <gz/physics/ModelDynamics.hh>
 #include <gz/physics/RequestEngine.hh>
 #include <gz/physics/sdf/ConstructWorld.hh>
 
@@ -166,6 +169,476 @@ TYPED_TEST(KinematicFeaturesTest, JointFrameSemantics)
   }
 }
 
+template <class T>
+class KinematicFeaturesBatchTest : public KinematicFeaturesTest<T>{};
+
+struct KinematicFeaturesBatchList : gz::physics::FeatureList<
+    gz::physics::GetEngineInfo,
+    gz::physics::ForwardStep,
+    gz::physics::sdf::ConstructSdfWorld,
+    gz::physics::GetModelFromWorld,
+    gz::physics::GetLinkFromModel,
+    gz::physics::LinkFrameSemantics,
+    gz::physics::BatchFrameSemantics
+> { };
+
+using KinematicFeaturesBatchTestTypes =
+  ::testing::Types<KinematicFeaturesBatchList>;
+TYPED_TEST_SUITE(KinematicFeaturesBatchTest,
+                 KinematicFeaturesBatchTestTypes);
+
+TYPED_TEST(KinematicFeaturesBatchTest, BatchFrameSemantics)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+        gz::physics::RequestEngine3d<KinematicFeaturesBatchList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(
+       common_test::worlds::kPendulumJointWrenchSdf);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    auto pendulum = world->GetModel("pendulum");
+    ASSERT_NE(nullptr, pendulum);
+    auto box = world->GetModel("box");
+    ASSERT_NE(nullptr, box);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+    }
+
+    // Reading a whole model matches reading each of its links.
+    std::vector<gz::physics::FrameData3d> modelData;
+    pendulum->LinkFrameDataRelativeToWorld(modelData);
+    ASSERT_EQ(pendulum->GetLinkCount(), modelData.size());
+    for (std::size_t i = 0; i < modelData.size(); ++i)
+    {
+      EXPECT_TRUE(gz::physics::test::Equal(
+          pendulum->GetLink(i)->FrameDataRelativeToWorld(),
+          modelData[i], 1e-6));
+    }
+
+    // Frames from several models can be mixed in any order.
+    using LinkPtrType = decltype(pendulum->GetLink(0));
+    std::vector<LinkPtrType> links;
+    for (std::size_t i = pendulum->GetLinkCount(); i > 0; --i)
+      links.push_back(pendulum->GetLink(i - 1));
+    links.push_back(box->GetLink(0));
+    links.push_back(pendulum->GetLink(0));
+
+    std::vector<gz::physics::FrameID> ids;
+    for (const auto &link : links)
+      ids.push_back(link->GetFrameID());
+
+    std::vector<gz::physics::FrameData3d> batchData;
+    engine->BatchFrameDataRelativeToWorld(ids, batchData);
+    ASSERT_EQ(ids.size(), batchData.size());
+    for (std::size_t i = 0; i < links.size(); ++i)
+    {
+      EXPECT_TRUE(gz::physics::test::Equal(
+          links[i]->FrameDataRelativeToWorld(), batchData[i], 1e-6));
+    }
+  }
+}
+
+template <class T>
+class KinematicFeaturesFloatBatchTest : public KinematicFeaturesTest<T>{};
+
+struct KinematicFeaturesFloatBatchList : gz::physics::FeatureList<
+    gz::physics::GetEngineInfo,
+    gz::physics::ForwardStep,
+    gz::physics::sdf::ConstructSdfWorld,
+    gz::physics::GetModelFromWorld,
+    gz::physics::GetLinkFromModel,
+    gz::physics::LinkFrameSemantics,
+    gz::physics::BatchFloatFrameSemantics
+> { };
+
+using KinematicFeaturesFloatBatchTestTypes =
+  ::testing::Types<KinematicFeaturesFloatBatchList>;
+TYPED_TEST_SUITE(KinematicFeaturesFloatBatchTest,
+                 KinematicFeaturesFloatBatchTestTypes);
+
+TYPED_TEST(KinematicFeaturesFloatBatchTest, BatchFloatFrameSemantics)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        KinematicFeaturesFloatBatchList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(
+       common_test::worlds::kPendulumJointWrenchSdf);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    auto pendulum = world->GetModel("pendulum");
+    ASSERT_NE(nullptr, pendulum);
+    auto box = world->GetModel("box");
+    ASSERT_NE(nullptr, box);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+    }
+
+    // The float data is the double data rounded to float.
+    std::vector<gz::physics::FrameData3f> modelData;
+    pendulum->LinkFloatFrameDataRelativeToWorld(modelData);
+    ASSERT_EQ(pendulum->GetLinkCount(), modelData.size());
+    for (std::size_t i = 0; i < modelData.size(); ++i)
+    {
+      EXPECT_TRUE(gz::physics::test::Equal(
+          gz::physics::CastFrameData<float>(
+              pendulum->GetLink(i)->FrameDataRelativeToWorld()),
+          modelData[i], 1e-5));
+    }
+
+    std::vector<gz::physics::FrameID> ids;
+    ids.push_back(box->GetLink(0)->GetFrameID());
+    for (std::size_t i = pendulum->GetLinkCount(); i > 0; --i)
+      ids.push_back(pendulum->GetLink(i - 1)->GetFrameID());
+
+    std::vector<gz::physics::FrameData3d> expected;
+    engine->BatchFrameDataRelativeToWorld(ids, expected);
+    std::vector<gz::physics::FrameData3f> batchData;
+    engine->BatchFloatFrameDataRelativeToWorld(ids, batchData);
+    ASSERT_EQ(ids.size(), batchData.size());
+    for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+      EXPECT_TRUE(gz::physics::test::Equal(
+          gz::physics::CastFrameData<float>(expected[i]),
+          batchData[i], 1e-5));
+    }
+  }
+}
+
+template <class T>
+class KinematicFeaturesCacheTest : public KinematicFeaturesTest<T>{};
+
+struct KinematicFeaturesCacheList : gz::physics::FeatureList<
+    gz::physics::GetEngineInfo,
+    gz::physics::ForwardStep,
+    gz::physics::sdf::ConstructSdfWorld,
+    gz::physics::GetModelFromWorld,
+    gz::physics::GetLinkFromModel,
+    gz::physics::LinkFrameSemantics,
+    gz::physics::SetFrameDataCacheFeature
+> { };
+
+using KinematicFeaturesCacheTestTypes =
+  ::testing::Types<KinematicFeaturesCacheList>;
+TYPED_TEST_SUITE(KinematicFeaturesCacheTest,
+                 KinematicFeaturesCacheTestTypes);
+
+TYPED_TEST(KinematicFeaturesCacheTest, FrameDataCache)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+        gz::physics::RequestEngine3d<KinematicFeaturesCacheList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(
+       common_test::worlds::kStringPendulumSdf);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    auto bob = world->GetModel("pendulum")->GetLink("bob");
+    ASSERT_NE(nullptr, bob);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+
+    EXPECT_FALSE(engine->GetFrameDataCacheEnabled());
+    engine->SetFrameDataCacheEnabled(true);
+    EXPECT_TRUE(engine->GetFrameDataCacheEnabled());
+
+    world->Step(output, state, input);
+    const auto before = bob->FrameDataRelativeToWorld();
+    EXPECT_TRUE(gz::physics::test::Equal(
+        before, bob->FrameDataRelativeToWorld(), 0.0));
+
+    // Stepping invalidates the cached data.
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+    }
+    const auto cached = bob->FrameDataRelativeToWorld();
+    EXPECT_FALSE(gz::physics::test::Equal(
+        gz::physics::Vector3d(before.pose.translation()),
+        gz::physics::Vector3d(cached.pose.translation()), 1e-6));
+
+    engine->SetFrameDataCacheEnabled(false);
+    EXPECT_FALSE(engine->GetFrameDataCacheEnabled());
+    EXPECT_TRUE(gz::physics::test::Equal(
+        cached, bob->FrameDataRelativeToWorld(), 0.0));
+  }
+}
+
+template <class T>
+class KinematicFeaturesModelDynamicsTest : public KinematicFeaturesTest<T>{};
+
+struct KinematicFeaturesModelDynamicsList : gz::physics::FeatureList<
+    gz::physics::GetEngineInfo,
+    gz::physics::ForwardStep,
+    gz::physics::sdf::ConstructSdfWorld,
+    gz::physics::GetModelFromWorld,
+    gz::physics::GetLinkFromModel,
+    gz::physics::GetJointFromModel,
+    gz::physics::GetBasicJointState,
+    gz::physics::LinkFrameSemantics,
+    gz::physics::ModelDynamicsFeature
+> { };
+
+using KinematicFeaturesModelDynamicsTestTypes =
+  ::testing::Types<KinematicFeaturesModelDynamicsList>;
+TYPED_TEST_SUITE(KinematicFeaturesModelDynamicsTest,
+                 KinematicFeaturesModelDynamicsTestTypes);
+
+TYPED_TEST(KinematicFeaturesModelDynamicsTest, ModelDynamics)
+{
+  using ModelDynamics = gz::physics::ModelDynamicsFeature::ModelDynamicsT<
+      gz::physics::FeaturePolicy3d>;
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        KinematicFeaturesModelDynamicsList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(
+       common_test::worlds::kStringPendulumSdf);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    auto model = world->GetModel("pendulum");
+    ASSERT_NE(nullptr, model);
+    auto pivot = model->GetJoint("pivot");
+    ASSERT_NE(nullptr, pivot);
+    auto bob = model->GetLink("bob");
+    ASSERT_NE(nullptr, bob);
+
+    // The pendulum is welded to the world, so the pivot is its only degree
+    // of freedom.
+    ModelDynamics dynamics = model->GetDynamics();
+    ASSERT_EQ(1, dynamics.massMatrix.rows());
+    ASSERT_EQ(1, dynamics.massMatrix.cols());
+    ASSERT_EQ(1, dynamics.coriolisAndGravity.size());
+    ASSERT_EQ(model->GetJointCount(), dynamics.jointCoordinates.size());
+    ASSERT_EQ(static_cast<Eigen::Index>(
+                ModelDynamics::LinkJacobianRows * model->GetLinkCount()),
+              dynamics.linkJacobians.rows());
+    ASSERT_EQ(1, dynamics.linkJacobians.cols());
+
+    std::size_t bobIndex = 0;
+    for (std::size_t i = 0; i < model->GetLinkCount(); ++i)
+    {
+      if (model->GetLink(i)->GetName() == "bob")
+        bobIndex = i;
+    }
+
+    for (std::size_t i = 0; i < model->GetJointCount(); ++i)
+    {
+      if (model->GetJoint(i)->GetName() == "pivot")
+        EXPECT_EQ(0u, dynamics.jointCoordinates[i]);
+      else
+        EXPECT_EQ(ModelDynamics::kNoCoordinate, dynamics.jointCoordinates[i]);
+    }
+
+    // The bob is a point mass at 1 m from the pivot, plus its own inertia
+    const double mass = 6.0;
+    const double length = 1.0;
+    EXPECT_NEAR(mass * length * length + 0.01, dynamics.massMatrix(0, 0),
+                1e-6);
+
+    // The pendulum starts at rest at 0.7 rad from the vertical, so the
+    // force which holds it there balances gravity.
+    const double angle = 0.7;
+    EXPECT_NEAR(mass * 9.8 * length * std::sin(angle),
+                dynamics.coriolisAndGravity[0], 1e-6);
+
+    // The bob rotates about the x axis, which is normal to its arm
+    const Eigen::Index row = static_cast<Eigen::Index>(
+        ModelDynamics::LinkJacobianRows * bobIndex);
+    const Eigen::Vector3d linearJacobian =
+        dynamics.linkJacobians.block<3, 1>(row, 0);
+    const Eigen::Vector3d angularJacobian =
+        dynamics.linkJacobians.block<3, 1>(row + 3, 0);
+    EXPECT_TRUE(gz::physics::test::Equal(
+        Eigen::Vector3d(Eigen::Vector3d::UnitX()), angularJacobian, 1e-6));
+    EXPECT_NEAR(length, linearJacobian.norm(), 1e-6);
+    EXPECT_NEAR(0.0, linearJacobian.x(), 1e-6);
+
+    // The links which do not move with the pivot have zero Jacobians
+    EXPECT_NEAR(std::sqrt(2.0), dynamics.linkJacobians.norm(), 1e-6);
+
+    // Inverse dynamics follows the equations of motion
+    const Eigen::VectorXd accelerations = Eigen::VectorXd::Constant(1, 2.0);
+    const Eigen::VectorXd forces =
+        model->ComputeInverseDynamics(accelerations);
+    ASSERT_EQ(1, forces.size());
+    EXPECT_NEAR(dynamics.massMatrix(0, 0) * 2.0
+                + dynamics.coriolisAndGravity[0], forces[0], 1e-6);
+    EXPECT_EQ(0, model->ComputeInverseDynamics(Eigen::VectorXd(3)).size());
+
+    // Once the pendulum swings, the Jacobian maps the velocity of the pivot
+    // to the velocity of the bob.
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+    }
+
+    model->GetDynamics(dynamics);
+    const double velocity = pivot->GetVelocity(0);
+    EXPECT_GT(std::abs(velocity), 0.1);
+
+    const auto bobData = bob->FrameDataRelativeToWorld();
+    EXPECT_TRUE(gz::physics::test::Equal(
+        Eigen::Vector3d(bobData.linearVelocity),
+        Eigen::Vector3d(dynamics.linkJacobians.block<3, 1>(row, 0) * velocity),
+        1e-6));
+    EXPECT_TRUE(gz::physics::test::Equal(
+        Eigen::Vector3d(bobData.angularVelocity),
+        Eigen::Vector3d(
+          dynamics.linkJacobians.block<3, 1>(row + 3, 0) * velocity),
+        1e-6));
+  }
+}
+
+template <class T>
+class KinematicFeaturesStepDerivativesTest : public KinematicFeaturesTest<T>{};
+
+struct KinematicFeaturesStepDerivativesList : gz::physics::FeatureList<
+    gz::physics::GetEngineInfo,
+    gz::physics::ForwardStep,
+    gz::physics::sdf::ConstructSdfWorld,
+    gz::physics::GetModelFromWorld,
+    gz::physics::GetJointFromModel,
+    gz::physics::GetBasicJointState,
+    gz::physics::SetBasicJointState,
+    gz::physics::ModelStepDerivativesFeature
+> { };
+
+using KinematicFeaturesStepDerivativesTestTypes =
+  ::testing::Types<KinematicFeaturesStepDerivativesList>;
+TYPED_TEST_SUITE(KinematicFeaturesStepDerivativesTest,
+                 KinematicFeaturesStepDerivativesTestTypes);
+
+TYPED_TEST(KinematicFeaturesStepDerivativesTest, StepDerivatives)
+{
+  using StepDerivatives =
+      gz::physics::ModelStepDerivativesFeature::StepDerivativesT<
+          gz::physics::FeaturePolicy3d>;
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        KinematicFeaturesStepDerivativesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(
+       common_test::worlds::kStringPendulumSdf);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    auto model = world->GetModel("pendulum");
+    ASSERT_NE(nullptr, model);
+    auto pivot = model->GetJoint("pivot");
+    ASSERT_NE(nullptr, pivot);
+
+    StepDerivatives derivatives;
+    model->GetStepDerivatives(derivatives);
+    ASSERT_EQ(2, derivatives.stateJacobian.rows());
+    ASSERT_EQ(2, derivatives.stateJacobian.cols());
+    ASSERT_EQ(2, derivatives.forceJacobian.rows());
+    ASSERT_EQ(1, derivatives.forceJacobian.cols());
+    const double dt = derivatives.timeStep;
+    ASSERT_GT(dt, 0.0);
+
+    // The state of the model is left unchanged
+    EXPECT_DOUBLE_EQ(0.0, pivot->GetPosition(0));
+    EXPECT_DOUBLE_EQ(0.0, pivot->GetVelocity(0));
+
+    // The bob is a point mass at 1 m from the pivot, plus its own inertia,
+    // which gravity pulls back towards the vertical from 0.7 rad.
+    const double mass = 6.0;
+    const double inertia = mass + 0.01;
+    const double angle = 0.7;
+    EXPECT_NEAR(dt / inertia, derivatives.forceJacobian(1, 0), 1e-9);
+    EXPECT_NEAR(dt * dt / inertia, derivatives.forceJacobian(0, 0), 1e-12);
+    EXPECT_NEAR(-dt * mass * 9.8 * std::cos(angle) / inertia,
+                derivatives.stateJacobian(1, 0), 1e-6);
+    EXPECT_NEAR(1.0, derivatives.stateJacobian(1, 1), 1e-6);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    auto stepFrom = [&](double _position, double _velocity, double _force)
+    {
+      pivot->SetPosition(0, _position);
+      pivot->SetVelocity(0, _velocity);
+      pivot->SetForce(0, _force);
+      world->Step(output, state, input);
+      return Eigen::Vector2d(pivot->GetPosition(0), pivot->GetVelocity(0));
+    };
+
+    // The derivatives predict the step from a perturbed state and force
+    const Eigen::Vector2d nominal = stepFrom(0.0, 0.0, 0.0);
+    const double delta = 1e-4;
+    const Eigen::Vector2d perturbed = stepFrom(delta, -delta, 2.0 * delta);
+    const Eigen::Vector2d predicted = nominal
+        + derivatives.stateJacobian * Eigen::Vector2d(delta, -delta)
+        + derivatives.forceJacobian * Eigen::VectorXd::Constant(1, 2 * delta);
+    EXPECT_TRUE(gz::physics::test::Equal(predicted, perturbed, 1e-8));
+  }
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
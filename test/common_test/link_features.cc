@@ -386,6 +386,51 @@ TYPED_TEST(LinkFeaturesTest, ModelAxisAlignedBoundingBox)
   }
 }
 
+struct LinkContinuousCollisionFeaturesList : gz::physics::FeatureList<
+    gz::physics::sdf::ConstructSdfWorld,
+    gz::physics::GetEntities,
+    gz::physics::LinkContinuousCollisionFeature
+> { };
+
+template <class T>
+class LinkContinuousCollisionTest : public LinkFeaturesTest<T>{};
+using LinkContinuousCollisionTestTypes =
+  ::testing::Types<LinkContinuousCollisionFeaturesList>;
+TYPED_TEST_SUITE(LinkContinuousCollisionTest,
+                 LinkContinuousCollisionTestTypes);
+
+TYPED_TEST(LinkContinuousCollisionTest, SetContinuousCollision)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<
+        LinkContinuousCollisionFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kFallingWorld);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+
+    // Disabled by default
+    EXPECT_DOUBLE_EQ(0.0, link->GetContinuousCollisionMotionThreshold());
+
+    link->SetContinuousCollision(0.05, 0.02);
+    EXPECT_NEAR(0.05, link->GetContinuousCollisionMotionThreshold(), 1e-6);
+    EXPECT_NEAR(0.02, link->GetContinuousCollisionSweptSphereRadius(), 1e-6);
+
+    link->SetContinuousCollision(0.0, 0.0);
+    EXPECT_DOUBLE_EQ(0.0, link->GetContinuousCollisionMotionThreshold());
+  }
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
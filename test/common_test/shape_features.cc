@@ -16,9 +16,14 @@
 */
 #include <gtest/gtest.h>
 
+#include <map>
+
 #include <gz/common/Console.hh>
+#include <gz/common/geospatial/ImageHeightmap.hh>
+#include <gz/math/eigen3/Conversions.hh>
 #include <gz/plugin/Loader.hh>
 
+#include "test/Resources.hh"
 #include "test/TestLibLoader.hh"
 #include "test/Utils.hh"
 #include "Worlds.hh"
@@ -30,10 +35,12 @@
 #include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/FreeJoint.hh>
 #include <gz/physics/FixedJoint.hh>
+#include <gz/physics/GetBoundingBox.hh>
 #include <gz/physics/GetEntities.hh>
 #include <gz/physics/Joint.hh>
 #include <gz/physics/Link.hh>
 #include <gz/physics/Shape.hh>
+#include <gz/physics/heightmap/HeightmapShape.hh>
 #include <gz/physics/RevoluteJoint.hh>
 #include <gz/physics/sdf/ConstructModel.hh>
 #include <gz/physics/sdf/ConstructWorld.hh>
@@ -165,6 +172,63 @@ TYPED_TEST(ShapeFeaturesTest, PrimarySlipCompliance)
   }
 }
 
+/////////////////////////////////////////////////
+// Changing the slip compliance of a shape that is already in contact has to
+// take effect, even if the engine caches the surface parameters of contacts.
+TYPED_TEST(ShapeFeaturesTest, PrimarySlipComplianceWhileInContact)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine = gz::physics::RequestEngine3d<ShapeFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(
+      common_test::worlds::kSlipComplianceSdf);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+
+    auto model = world->GetModel("box");
+    auto boxLink = model->GetLink("box_link");
+    auto boxShape = boxLink->GetShape("box_collision");
+
+    AssertVectorApprox vectorPredicate(1e-4);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+
+    const Eigen::Vector3d cmdForce{1, 0, 0};
+    auto step = [&](std::size_t _numSteps)
+    {
+      for (std::size_t i = 0; i < _numSteps; ++i)
+      {
+        world->Step(output, state, input);
+        boxLink->AddExternalForce(
+          gz::physics::RelativeForce3d(gz::physics::FrameID::World(), cmdForce),
+          gz::physics::RelativePosition3d(*boxLink, Eigen::Vector3d::Zero()));
+      }
+    };
+
+    // Without slip, friction holds the box in place
+    step(1000);
+    EXPECT_PRED_FORMAT2(vectorPredicate, Eigen::Vector3d::Zero(),
+                        boxLink->FrameDataRelativeToWorld().linearVelocity);
+
+    const double primarySlip = 0.5;
+    boxShape->SetPrimarySlipCompliance(primarySlip);
+    step(10000);
+
+    // velocity = slip * applied force
+    EXPECT_PRED_FORMAT2(vectorPredicate, primarySlip * cmdForce,
+                        boxLink->FrameDataRelativeToWorld().linearVelocity);
+  }
+}
+
 /////////////////////////////////////////////////
 TYPED_TEST(ShapeFeaturesTest, SecondarySlipCompliance)
 {
@@ -238,6 +302,249 @@ TYPED_TEST(ShapeFeaturesTest, SecondarySlipCompliance)
   }
 }
 
+struct HeightmapFeaturesList : gz::physics::FeatureList<
+  gz::physics::ForwardStep,
+  gz::physics::GetEntities,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::heightmap::AttachHeightmapShapeFeature,
+  gz::physics::heightmap::GetHeightmapShapeProperties,
+  gz::physics::sdf::ConstructSdfModel,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+template <class T>
+class ShapeFeaturesHeightmapTest : public ShapeFeaturesTest<T>{};
+using ShapeFeaturesHeightmapTestTypes =
+  ::testing::Types<HeightmapFeaturesList>;
+TYPED_TEST_SUITE(ShapeFeaturesHeightmapTest,
+                 ShapeFeaturesHeightmapTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(ShapeFeaturesHeightmapTest, SphereRestsOnHeightmap)
+{
+  const std::string terrainStr = R"(
+    <sdf version="1.11">
+      <model name="terrain">
+        <static>true</static>
+        <link name="link"/>
+      </model>
+    </sdf>)";
+
+  const std::string sphereStr = R"(
+    <sdf version="1.11">
+      <model name="sphere">
+        <pose>0 0 12 0 0 0</pose>
+        <link name="link">
+          <collision name="collision">
+            <geometry>
+              <sphere>
+                <radius>0.5</radius>
+              </sphere>
+            </geometry>
+          </collision>
+        </link>
+      </model>
+    </sdf>)";
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+        gz::physics::RequestEngine3d<HeightmapFeaturesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root rootWorld;
+    const sdf::Errors errorsWorld =
+        rootWorld.Load(common_test::worlds::kEmptySdf);
+    ASSERT_TRUE(errorsWorld.empty()) << errorsWorld.front();
+    auto world = engine->ConstructWorld(*rootWorld.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    sdf::Root root;
+    sdf::Errors errors = root.LoadSdfString(terrainStr);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+    world->ConstructModel(*root.Model());
+    auto terrainLink = world->GetModel("terrain")->GetLink("link");
+    ASSERT_NE(nullptr, terrainLink);
+
+    gz::common::ImageHeightmap data;
+    ASSERT_EQ(0, data.Load(gz::physics::test::resources::kHeightmapBowlPng));
+    const gz::math::Vector3d size(129, 129, 10);
+    auto heightmap = terrainLink->AttachHeightmapShape("heightmap", data,
+        Eigen::Isometry3d::Identity(), gz::math::eigen3::convert(size));
+    ASSERT_NE(nullptr, heightmap);
+    EXPECT_NEAR(size.X(), heightmap->GetSize()[0], 1e-3);
+    EXPECT_NEAR(size.Y(), heightmap->GetSize()[1], 1e-3);
+    EXPECT_NEAR(size.Z(), heightmap->GetSize()[2], 1e-3);
+
+    errors = root.LoadSdfString(sphereStr);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+    world->ConstructModel(*root.Model());
+    auto sphereLink = world->GetModel("sphere")->GetLink("link");
+    ASSERT_NE(nullptr, sphereLink);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    for (std::size_t i = 0; i < 3000; ++i)
+      world->Step(output, state, input);
+
+    // The sphere fell into the bottom of the bowl and stopped there
+    const auto frameData = sphereLink->FrameDataRelativeToWorld();
+    EXPECT_GT(frameData.pose.translation().z(), 0.0);
+    EXPECT_LT(frameData.pose.translation().z(), size.Z());
+    EXPECT_NEAR(0.0, frameData.linearVelocity.norm(), 0.1);
+  }
+}
+
+struct WorldShapeBoundingBoxesList : gz::physics::FeatureList<
+  gz::physics::GetEntities,
+  gz::physics::GetWorldShapeBoundingBoxes,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+template <class T>
+class ShapeFeaturesWorldBoundingBoxesTest : public ShapeFeaturesTest<T>{};
+using ShapeFeaturesWorldBoundingBoxesTestTypes =
+  ::testing::Types<WorldShapeBoundingBoxesList>;
+TYPED_TEST_SUITE(ShapeFeaturesWorldBoundingBoxesTest,
+                 ShapeFeaturesWorldBoundingBoxesTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(ShapeFeaturesWorldBoundingBoxesTest, MatchShapeBoundingBoxes)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<WorldShapeBoundingBoxesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kShapesWorld);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    const auto batch = world->GetShapeBoundingBoxes();
+    std::map<std::size_t, Eigen::AlignedBox3d> boxes;
+    for (std::size_t i = 0; i < batch.size; ++i)
+      boxes[batch.shape[i]] = batch.box[i];
+    EXPECT_EQ(batch.size, boxes.size());
+
+    AssertVectorApprox vectorPredicate(1e-6);
+    std::size_t shapeCount = 0u;
+    for (std::size_t m = 0; m < world->GetModelCount(); ++m)
+    {
+      const auto model = world->GetModel(m);
+      for (std::size_t l = 0; l < model->GetLinkCount(); ++l)
+      {
+        const auto link = model->GetLink(l);
+        for (std::size_t s = 0; s < link->GetShapeCount(); ++s)
+        {
+          const auto shape = link->GetShape(s);
+          ++shapeCount;
+
+          const auto it = boxes.find(shape->EntityID());
+          ASSERT_NE(boxes.end(), it) << shape->GetName();
+          const auto expected = shape->GetAxisAlignedBoundingBox();
+          EXPECT_PRED_FORMAT2(vectorPredicate, expected.min(),
+                              it->second.min());
+          EXPECT_PRED_FORMAT2(vectorPredicate, expected.max(),
+                              it->second.max());
+        }
+      }
+    }
+    EXPECT_EQ(shapeCount, batch.size);
+  }
+}
+
+struct WorldLinkBoundingBoxesList : gz::physics::FeatureList<
+  gz::physics::GetEntities,
+  gz::physics::GetLinkBoundingBox,
+  gz::physics::GetModelBoundingBox,
+  gz::physics::GetWorldLinkBoundingBoxes,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+template <class T>
+class ShapeFeaturesWorldLinkBoundingBoxesTest : public ShapeFeaturesTest<T>{};
+using ShapeFeaturesWorldLinkBoundingBoxesTestTypes =
+  ::testing::Types<WorldLinkBoundingBoxesList>;
+TYPED_TEST_SUITE(ShapeFeaturesWorldLinkBoundingBoxesTest,
+                 ShapeFeaturesWorldLinkBoundingBoxesTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(ShapeFeaturesWorldLinkBoundingBoxesTest, MatchEntityBoundingBoxes)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<WorldLinkBoundingBoxesList>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kShapesWorld);
+    ASSERT_TRUE(errors.empty()) << errors.front();
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    const auto linkBatch = world->GetLinkBoundingBoxes();
+    std::map<std::size_t, Eigen::AlignedBox3d> linkBoxes;
+    for (std::size_t i = 0; i < linkBatch.size; ++i)
+      linkBoxes[linkBatch.entity[i]] = linkBatch.box[i];
+    EXPECT_EQ(linkBatch.size, linkBoxes.size());
+
+    const auto modelBatch = world->GetModelBoundingBoxes();
+    std::map<std::size_t, Eigen::AlignedBox3d> modelBoxes;
+    for (std::size_t i = 0; i < modelBatch.size; ++i)
+      modelBoxes[modelBatch.entity[i]] = modelBatch.box[i];
+    EXPECT_EQ(modelBatch.size, modelBoxes.size());
+    EXPECT_EQ(world->GetModelCount(), modelBatch.size);
+
+    // Engines may take the boxes from their broadphase, which are computed
+    // from the same shape boxes
+    AssertVectorApprox vectorPredicate(1e-4);
+    std::size_t linkCount = 0u;
+    for (std::size_t m = 0; m < world->GetModelCount(); ++m)
+    {
+      const auto model = world->GetModel(m);
+      const auto modelIt = modelBoxes.find(model->EntityID());
+      ASSERT_NE(modelBoxes.end(), modelIt) << model->GetName();
+      const auto expectedModelBox = model->GetAxisAlignedBoundingBox();
+      EXPECT_PRED_FORMAT2(vectorPredicate, expectedModelBox.min(),
+                          modelIt->second.min());
+      EXPECT_PRED_FORMAT2(vectorPredicate, expectedModelBox.max(),
+                          modelIt->second.max());
+
+      for (std::size_t l = 0; l < model->GetLinkCount(); ++l)
+      {
+        const auto link = model->GetLink(l);
+        ++linkCount;
+
+        const auto it = linkBoxes.find(link->EntityID());
+        ASSERT_NE(linkBoxes.end(), it) << link->GetName();
+        const auto expected = link->GetAxisAlignedBoundingBox();
+        EXPECT_PRED_FORMAT2(vectorPredicate, expected.min(),
+                            it->second.min());
+        EXPECT_PRED_FORMAT2(vectorPredicate, expected.max(),
+                            it->second.max());
+      }
+    }
+    EXPECT_EQ(linkCount, linkBatch.size);
+  }
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -16,9 +16,18 @@
 */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include <gz/common/Console.hh>
 #include <gz/plugin/Loader.hh>
@@ -47,9 +56,18 @@
 
 #include <gz/physics/ConstructEmpty.hh>
 #include <gz/physics/FindFeatures.hh>
+#include <gz/physics/ForceField.hh>
 #include <gz/physics/ForwardStep.hh>
 #include <gz/physics/GetEntities.hh>
+#include <gz/physics/KinematicModel.hh>
+#include <gz/physics/ModelUpdateRate.hh>
+#include <gz/physics/RayIntersection.hh>
+#include <gz/physics/ShapeQueries.hh>
+#include <gz/physics/SharedStateRing.hh>
+#include <gz/physics/Sleep.hh>
 #include <gz/physics/RequestEngine.hh>
+#include <gz/physics/TaskScheduler.hh>
+#include <gz/physics/WorldPlacement.hh>
 #include <gz/physics/World.hh>
 
 #include <sdf/Root.hh>
@@ -221,146 +239,2116 @@ TYPED_TEST(SimulationFeaturesContactsTest, Contacts)
   }
 }
 
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesContactBatch : gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetContactsFromLastStepFeature,
+  gz::physics::GetContactBatchFromLastStepFeature,
+  gz::physics::ForwardStep
+> {};
+
+template <class T>
+class SimulationFeaturesContactBatchTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesContactBatchTestTypes =
+  ::testing::Types<FeaturesContactBatch>;
+TYPED_TEST_SUITE(SimulationFeaturesContactBatchTest,
+                 SimulationFeaturesContactBatchTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesContactBatchTest, ContactBatch)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesContactBatch>(
+      this->loader,
+      name,
+      common_test::worlds::kShapesWorld);
+    StepWorld<FeaturesContactBatch>(world, true, 1);
+
+    auto contacts = world->GetContactsFromLastStep();
+    const auto batch = world->GetContactBatchFromLastStep();
+    ASSERT_EQ(contacts.size(), batch.size);
+    EXPECT_NE(0u, batch.size);
+
+    using ContactPoint =
+        gz::physics::World3d<FeaturesContactBatch>::ContactPoint;
+    using ExtraContactData =
+        gz::physics::World3d<FeaturesContactBatch>::ExtraContactData;
+    for (std::size_t i = 0; i < batch.size; ++i)
+    {
+      const auto &point = contacts[i].template Get<ContactPoint>();
+      EXPECT_EQ(point.collision1->EntityID(), batch.collision1[i]);
+      EXPECT_EQ(point.collision2->EntityID(), batch.collision2[i]);
+      AssertVectorApprox vectorPredicate(1e-9);
+      EXPECT_PRED_FORMAT2(vectorPredicate, point.point, batch.point[i]);
+
+      const auto *extra =
+          contacts[i].template Query<ExtraContactData>();
+      ASSERT_NE(nullptr, extra);
+      EXPECT_PRED_FORMAT2(vectorPredicate, extra->normal, batch.normal[i]);
+      EXPECT_PRED_FORMAT2(vectorPredicate, extra->force, batch.force[i]);
+      EXPECT_DOUBLE_EQ(extra->depth, batch.depth[i]);
+    }
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesContactPairs : gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetContactBatchFromLastStepFeature,
+  gz::physics::GetContactPairsFromLastStepFeature,
+  gz::physics::ForwardStep
+> {};
+
+template <class T>
+class SimulationFeaturesContactPairsTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesContactPairsTestTypes =
+  ::testing::Types<FeaturesContactPairs>;
+TYPED_TEST_SUITE(SimulationFeaturesContactPairsTest,
+                 SimulationFeaturesContactPairsTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesContactPairsTest, ContactPairs)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesContactPairs>(
+      this->loader,
+      name,
+      common_test::worlds::kShapesWorld);
+    StepWorld<FeaturesContactPairs>(world, true, 1);
+
+    const std::size_t contactCount =
+        world->GetContactBatchFromLastStep().size;
+    const auto pairs = world->GetContactPairsFromLastStep();
+    const auto &contacts = pairs.contacts;
+    ASSERT_EQ(contactCount, contacts.size);
+    EXPECT_NE(0u, pairs.size);
+    EXPECT_EQ(0u, pairs.offset[0]);
+    EXPECT_EQ(contacts.size, pairs.offset[pairs.size]);
+
+    for (std::size_t i = 0; i < pairs.size; ++i)
+    {
+      // Pairs are sorted and each of them is listed once
+      if (i > 0)
+      {
+        EXPECT_TRUE(pairs.collision1[i - 1] < pairs.collision1[i] ||
+            (pairs.collision1[i - 1] == pairs.collision1[i] &&
+             pairs.collision2[i - 1] < pairs.collision2[i]));
+      }
+
+      const std::size_t begin = pairs.offset[i];
+      const std::size_t end = pairs.offset[i + 1];
+      ASSERT_LT(begin, end);
+      EXPECT_EQ(end - begin, pairs.count[i]);
+
+      double normalForce = 0.0;
+      double maxDepth = -std::numeric_limits<double>::infinity();
+      for (std::size_t j = begin; j < end; ++j)
+      {
+        EXPECT_EQ(pairs.collision1[i], contacts.collision1[j]);
+        EXPECT_EQ(pairs.collision2[i], contacts.collision2[j]);
+        normalForce += contacts.force[j].dot(contacts.normal[j]);
+        maxDepth = std::max(maxDepth, contacts.depth[j]);
+      }
+      EXPECT_NEAR(normalForce, pairs.normalForce[i], 1e-9);
+      EXPECT_DOUBLE_EQ(maxDepth, pairs.maxDepth[i]);
+    }
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesContactFilter : gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetContactsFromLastStepFeature,
+  gz::physics::ContactFilterFeature,
+  gz::physics::ForwardStep
+> {};
+
+template <class T>
+class SimulationFeaturesContactFilterTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesContactFilterTestTypes =
+  ::testing::Types<FeaturesContactFilter>;
+TYPED_TEST_SUITE(SimulationFeaturesContactFilterTest,
+                 SimulationFeaturesContactFilterTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesContactFilterTest, ContactFilter)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesContactFilter>(
+      this->loader,
+      name,
+      common_test::worlds::kShapesWorld);
+    StepWorld<FeaturesContactFilter>(world, true, 1);
+    EXPECT_TRUE(world->GetContactFilter().empty());
+
+    using ContactPoint =
+        gz::physics::World3d<FeaturesContactFilter>::ContactPoint;
+    const auto allContacts = world->GetContactsFromLastStep();
+    ASSERT_FALSE(allContacts.empty());
+
+    // Only keep the contacts of one of the shapes
+    const std::size_t shapeID =
+        allContacts[0].template Get<ContactPoint>().collision1->EntityID();
+    std::size_t expectedCount = 0u;
+    for (const auto &contact : allContacts)
+    {
+      const auto &point = contact.template Get<ContactPoint>();
+      if (point.collision1->EntityID() == shapeID ||
+          point.collision2->EntityID() == shapeID)
+      {
+        ++expectedCount;
+      }
+    }
+
+    world->SetContactFilter({shapeID, shapeID});
+    EXPECT_EQ(std::vector<std::size_t>{shapeID}, world->GetContactFilter());
+    const auto filtered = world->GetContactsFromLastStep();
+    EXPECT_EQ(expectedCount, filtered.size());
+    for (const auto &contact : filtered)
+    {
+      const auto &point = contact.template Get<ContactPoint>();
+      EXPECT_TRUE(point.collision1->EntityID() == shapeID ||
+                  point.collision2->EntityID() == shapeID);
+    }
+
+    // An entity that is not part of any contact filters out everything
+    world->SetContactFilter({gz::physics::INVALID_ENTITY_ID - 1});
+    EXPECT_TRUE(world->GetContactsFromLastStep().empty());
+
+    world->ClearContactFilter();
+    EXPECT_TRUE(world->GetContactFilter().empty());
+    EXPECT_EQ(allContacts.size(), world->GetContactsFromLastStep().size());
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesContactEvents : gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetContactsFromLastStepFeature,
+  gz::physics::ContactEventsFeature,
+  gz::physics::ForwardStep
+> {};
+
+template <class T>
+class SimulationFeaturesContactEventsTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesContactEventsTestTypes =
+  ::testing::Types<FeaturesContactEvents>;
+TYPED_TEST_SUITE(SimulationFeaturesContactEventsTest,
+                 SimulationFeaturesContactEventsTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesContactEventsTest, ContactEvents)
+{
+  using EventType = gz::physics::ContactEventsFeature::EventType;
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesContactEvents>(
+      this->loader,
+      name,
+      common_test::worlds::kShapesWorld);
+    StepWorld<FeaturesContactEvents>(world, true, 1);
+
+    // Each pair of shapes in contact begins once
+    using ContactPoint =
+        gz::physics::World3d<FeaturesContactEvents>::ContactPoint;
+    std::set<std::pair<std::size_t, std::size_t>> pairs;
+    for (const auto &contact : world->GetContactsFromLastStep())
+    {
+      const auto &point = contact.template Get<ContactPoint>();
+      const std::size_t id1 = point.collision1->EntityID();
+      const std::size_t id2 = point.collision2->EntityID();
+      pairs.emplace(std::min(id1, id2), std::max(id1, id2));
+    }
+    ASSERT_FALSE(pairs.empty());
+
+    auto events = world->GetContactEvents();
+    ASSERT_EQ(pairs.size(), events.size);
+    ASSERT_EQ(pairs.size(), events.activeSize);
+    std::size_t i = 0u;
+    for (const auto &pair : pairs)
+    {
+      EXPECT_EQ(pair.first, events.collision1[i]);
+      EXPECT_EQ(pair.second, events.collision2[i]);
+      EXPECT_EQ(EventType::BEGIN, events.type[i]);
+      EXPECT_EQ(events.pairId[i], events.activePairId[i]);
+      ++i;
+    }
+    const std::vector<std::size_t> ids(
+        events.activePairId, events.activePairId + events.activeSize);
+    EXPECT_EQ(ids.size(), std::set<std::size_t>(ids.begin(), ids.end()).size());
+
+    // Nothing changed since the previous call, and the pairs persist with
+    // the same IDs
+    events = world->GetContactEvents();
+    EXPECT_EQ(0u, events.size);
+    ASSERT_EQ(ids.size(), events.activeSize);
+    EXPECT_EQ(ids, std::vector<std::size_t>(
+        events.activePairId, events.activePairId + events.activeSize));
+  }
+}
+
 // The features that an engine must have to be loaded by this loader.
 struct FeaturesCollisionPairMaxContacts : gz::physics::FeatureList<
   gz::physics::sdf::ConstructSdfWorld,
   gz::physics::GetContactsFromLastStepFeature,
   gz::physics::ForwardStep,
-  gz::physics::CollisionPairMaxContacts
+  gz::physics::CollisionPairMaxContacts
+> {};
+
+template <class T>
+class SimulationFeaturesCollisionPairMaxContactsTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesCollisionPairMaxContactsTestTypes =
+  ::testing::Types<FeaturesCollisionPairMaxContacts>;
+TYPED_TEST_SUITE(SimulationFeaturesCollisionPairMaxContactsTest,
+                 SimulationFeaturesCollisionPairMaxContactsTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesCollisionPairMaxContactsTest,
+    CollisionPairMaxContacts)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesCollisionPairMaxContacts>(
+      this->loader,
+      name,
+      common_test::worlds::kShapesWorld);
+    auto checkedOutput = StepWorld<FeaturesCollisionPairMaxContacts>(
+        world, true, 1).first;
+    EXPECT_TRUE(checkedOutput);
+
+    // TPE creates a single contact per pair unless asked for more
+    auto contacts = world->GetContactsFromLastStep();
+    if (this->PhysicsEngineName(name) == "tpe")
+    {
+      EXPECT_EQ(1u, world->GetCollisionPairMaxContacts());
+    }
+    else
+    {
+      EXPECT_EQ(std::numeric_limits<std::size_t>::max(),
+                world->GetCollisionPairMaxContacts());
+    }
+    // Large box collides with other shapes
+    EXPECT_GE(contacts.size(), 4u);
+    if (this->PhysicsEngineName(name) == "dartsim")
+    {
+      EXPECT_GT(contacts.size(), 30u);
+    }
+
+    world->SetCollisionPairMaxContacts(1u);
+    EXPECT_EQ(1u, world->GetCollisionPairMaxContacts());
+    checkedOutput = StepWorld<FeaturesCollisionPairMaxContacts>(
+        world, true, 1).first;
+    EXPECT_TRUE(checkedOutput);
+
+    contacts = world->GetContactsFromLastStep();
+    EXPECT_EQ(4u, contacts.size());
+
+    world->SetCollisionPairMaxContacts(0u);
+    EXPECT_EQ(0u, world->GetCollisionPairMaxContacts());
+    checkedOutput = StepWorld<FeaturesCollisionPairMaxContacts>(
+        world, true, 1).first;
+    EXPECT_TRUE(checkedOutput);
+
+    contacts = world->GetContactsFromLastStep();
+    EXPECT_EQ(0u, contacts.size());
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesStep : gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::ForwardStep
+> {};
+
+template <class T>
+class SimulationFeaturesStepTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesStepTestTypes =
+  ::testing::Types<FeaturesStep>;
+TYPED_TEST_SUITE(SimulationFeaturesStepTest,
+                 SimulationFeaturesStepTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesStepTest, StepWorld)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+#ifdef _WIN32
+    // See https://github.com/gazebosim/gz-physics/issues/483
+    CHECK_UNSUPPORTED_ENGINE(name, "bullet")
+#endif
+    auto world = LoadPluginAndWorld<FeaturesStep>(
+      this->loader,
+      name,
+      common_test::worlds::kShapesWorld);
+    auto checkedOutput = StepWorld<FeaturesStep>(world, true, 1000).first;
+    EXPECT_TRUE(checkedOutput);
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesFalling : public  gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::ForwardStep
+> {};
+
+template <class T>
+class SimulationFeaturesFallingTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesFallingTestTypes =
+  ::testing::Types<FeaturesFalling>;
+TYPED_TEST_SUITE(SimulationFeaturesFallingTest,
+                 SimulationFeaturesFallingTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesFallingTest, Falling)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    CHECK_UNSUPPORTED_ENGINE(name, "tpe")
+
+#ifdef _WIN32
+    // See https://github.com/gazebosim/gz-physics/issues/483
+    CHECK_UNSUPPORTED_ENGINE(name, "bullet")
+#endif
+    auto world = LoadPluginAndWorld<FeaturesFalling>(
+        this->loader, name,
+        common_test::worlds::kFallingWorld);
+
+    auto [checkedOutput, output] =
+      StepWorld<FeaturesFalling>(world, true, 1000);
+    EXPECT_TRUE(checkedOutput);
+
+    const std::vector<gz::physics::WorldPose> worldPoses =
+      output.template Get<gz::physics::WorldPoses>().entries;
+
+    ASSERT_GE(worldPoses.size(), 1);
+    const auto link = world->GetModel(0)->GetLink("sphere_link");
+
+    // get the pose of the link from the list of worldPoses
+    auto poseIt = std::find_if(worldPoses.begin(), worldPoses.end(),
+        [&](const auto &_wPose)
+        { return _wPose.body == link->EntityID(); });
+    ASSERT_NE(poseIt, worldPoses.end());
+    auto pos = poseIt->pose.Pos();
+    EXPECT_NEAR(pos.Z(), 1.0, 5e-2);
+  }
+}
+
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesStepWorlds : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::StepWorldsFeature
+> {};
+
+template <class T>
+class SimulationFeaturesStepWorldsTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesStepWorldsTestTypes =
+  ::testing::Types<FeaturesStepWorlds>;
+TYPED_TEST_SUITE(SimulationFeaturesStepWorldsTest,
+                 SimulationFeaturesStepWorldsTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesStepWorldsTest, StepWorlds)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    // The reference world is stepped on its own, in a separate engine.
+    auto reference = LoadPluginAndWorld<FeaturesStepWorlds>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, reference);
+
+    auto engine = gz::physics::RequestEngine3d<FeaturesStepWorlds>::From(
+        this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    ASSERT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+
+    const std::size_t numWorlds = 4;
+    std::vector<gz::physics::World3dPtr<FeaturesStepWorlds>> worlds;
+    std::vector<std::size_t> worldIDs;
+    for (std::size_t i = 0; i < numWorlds; ++i)
+    {
+      // World names must be unique within an engine.
+      sdf::World sdfWorld = *root.WorldByIndex(0);
+      sdfWorld.SetName("world_" + std::to_string(i));
+      worlds.push_back(engine->ConstructWorld(sdfWorld));
+      ASSERT_NE(nullptr, worlds.back());
+      worldIDs.push_back(worlds.back()->EntityID());
+    }
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+      reference->Step(output, state, input);
+      engine->StepWorlds(worldIDs, output, state, input, 2u);
+    }
+
+    const auto expected = reference->GetModel("sphere")->GetLink(0)
+      ->FrameDataRelativeToWorld().pose;
+    // TPE does not simulate gravity.
+    if (this->PhysicsEngineName(name) != "tpe")
+      EXPECT_NEAR(1.0, expected.translation().z(), 5e-2);
+    for (const auto &world : worlds)
+    {
+      const auto pose = world->GetModel("sphere")->GetLink(0)
+        ->FrameDataRelativeToWorld().pose;
+      EXPECT_TRUE(expected.isApprox(pose, 1e-6));
+    }
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesWorldPlacement : public gz::physics::FeatureList<
+  FeaturesStepWorlds,
+  gz::physics::WorldPlacementFeature
+> {};
+
+template <class T>
+class SimulationFeaturesWorldPlacementTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesWorldPlacementTestTypes =
+  ::testing::Types<FeaturesWorldPlacement>;
+TYPED_TEST_SUITE(SimulationFeaturesWorldPlacementTest,
+                 SimulationFeaturesWorldPlacementTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesWorldPlacementTest, WorldPlacement)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto reference = LoadPluginAndWorld<FeaturesWorldPlacement>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, reference);
+
+    auto engine = gz::physics::RequestEngine3d<FeaturesWorldPlacement>::From(
+        this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    ASSERT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+
+    // Two worlds on the first node, one on the first core, and one that is
+    // not placed
+    gz::physics::WorldPlacement onNode;
+    onNode.numaNode = 0;
+    gz::physics::WorldPlacement onCore;
+    onCore.cores = {0u};
+    const std::vector<gz::physics::WorldPlacement> placements =
+        {onNode, onNode, onCore, gz::physics::WorldPlacement()};
+
+    std::vector<gz::physics::World3dPtr<FeaturesWorldPlacement>> worlds;
+    std::vector<std::size_t> worldIDs;
+    for (std::size_t i = 0; i < placements.size(); ++i)
+    {
+      sdf::World sdfWorld = *root.WorldByIndex(0);
+      sdfWorld.SetName("world_" + std::to_string(i));
+      worlds.push_back(engine->ConstructWorld(sdfWorld));
+      ASSERT_NE(nullptr, worlds.back());
+      EXPECT_EQ(gz::physics::WorldPlacement(), worlds.back()->GetPlacement());
+      worlds.back()->SetPlacement(placements[i]);
+      EXPECT_EQ(placements[i], worlds.back()->GetPlacement());
+      worldIDs.push_back(worlds.back()->EntityID());
+    }
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    for (std::size_t i = 0; i < 500; ++i)
+    {
+      reference->Step(output, state, input);
+      engine->StepWorlds(worldIDs, output, state, input, 2u);
+
+      // Placements may change between steps
+      if (i == 250)
+        worlds[1]->SetPlacement(gz::physics::WorldPlacement());
+    }
+
+    // Placed worlds are stepped like the others
+    const auto expected = reference->GetModel("sphere")->GetLink(0)
+      ->FrameDataRelativeToWorld().pose;
+    for (const auto &world : worlds)
+    {
+      const auto pose = world->GetModel("sphere")->GetLink(0)
+        ->FrameDataRelativeToWorld().pose;
+      EXPECT_TRUE(expected.isApprox(pose, 1e-6));
+    }
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesConcurrentWorldStep : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::ConcurrentWorldStepFeature
+> {};
+
+template <class T>
+class SimulationFeaturesConcurrentWorldStepTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesConcurrentWorldStepTestTypes =
+  ::testing::Types<FeaturesConcurrentWorldStep>;
+TYPED_TEST_SUITE(SimulationFeaturesConcurrentWorldStepTest,
+                 SimulationFeaturesConcurrentWorldStepTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesConcurrentWorldStepTest, ConcurrentWorldStep)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    // The reference world is stepped on its own, in a separate engine.
+    auto reference = LoadPluginAndWorld<FeaturesConcurrentWorldStep>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, reference);
+
+    auto engine =
+      gz::physics::RequestEngine3d<FeaturesConcurrentWorldStep>::From(
+        this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    ASSERT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+
+    auto constructWorld = [&](const std::string &_name)
+    {
+      // World names must be unique within an engine.
+      sdf::World sdfWorld = *root.WorldByIndex(0);
+      sdfWorld.SetName(_name);
+      return engine->ConstructWorld(sdfWorld);
+    };
+
+    const std::size_t numWorlds = 4;
+    const std::size_t numSteps = 1000;
+    std::vector<gz::physics::World3dPtr<FeaturesConcurrentWorldStep>> worlds;
+    for (std::size_t i = 0; i < numWorlds; ++i)
+    {
+      worlds.push_back(constructWorld("world_" + std::to_string(i)));
+      ASSERT_NE(nullptr, worlds.back());
+    }
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    for (std::size_t i = 0; i < numSteps; ++i)
+      reference->Step(output, state, input);
+
+    // Each world is stepped and queried by a thread of its own, while
+    // another world is added to the engine.
+    std::vector<std::size_t> writtenLinks(numWorlds, 0u);
+    std::vector<std::thread> threads;
+    for (std::size_t w = 0; w < numWorlds; ++w)
+    {
+      threads.emplace_back([&, w]()
+      {
+        gz::physics::ForwardStep::Input threadInput;
+        gz::physics::ForwardStep::State threadState;
+        gz::physics::ForwardStep::Output threadOutput;
+        for (std::size_t i = 0; i < numSteps; ++i)
+        {
+          worlds[w]->Step(threadOutput, threadState, threadInput);
+          {
+            // The world is queried between steps, which must not overlap
+            // with the construction of the added world
+            auto stateLock = engine->LockEntityState();
+            worlds[w]->GetModel("sphere")->GetLink(0)
+              ->FrameDataRelativeToWorld();
+          }
+
+          // This is needed so Step populates WorldPoses
+          if (i == numSteps - 2)
+            threadOutput.ResetQueries();
+        }
+        writtenLinks[w] = threadOutput.Get<gz::physics::WorldPoses>()
+          .entries.size();
+      });
+    }
+
+    {
+      auto lock = engine->LockEntityChanges();
+      EXPECT_NE(nullptr, constructWorld("world_added"));
+    }
+
+    for (auto &thread : threads)
+      thread.join();
+
+    const auto expected = reference->GetModel("sphere")->GetLink(0)
+      ->FrameDataRelativeToWorld().pose;
+    for (std::size_t w = 0; w < numWorlds; ++w)
+    {
+      const auto pose = worlds[w]->GetModel("sphere")->GetLink(0)
+        ->FrameDataRelativeToWorld().pose;
+      EXPECT_TRUE(expected.isApprox(pose, 1e-6));
+
+      // Steps only write the links of their own world
+      std::size_t numLinks = 0u;
+      for (std::size_t m = 0; m < worlds[w]->GetModelCount(); ++m)
+        numLinks += worlds[w]->GetModel(m)->GetLinkCount();
+      EXPECT_EQ(numLinks, writtenLinks[w]);
+    }
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesConcurrentFrameDataCache : public gz::physics::FeatureList<
+  FeaturesConcurrentWorldStep,
+  gz::physics::SetFrameDataCacheFeature
+> {};
+
+template <class T>
+class SimulationFeaturesConcurrentFrameDataCacheTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesConcurrentFrameDataCacheTestTypes =
+  ::testing::Types<FeaturesConcurrentFrameDataCache>;
+TYPED_TEST_SUITE(SimulationFeaturesConcurrentFrameDataCacheTest,
+                 SimulationFeaturesConcurrentFrameDataCacheTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesConcurrentFrameDataCacheTest,
+           ConcurrentWorldStepWithCache)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    // The reference world is stepped on its own, in a separate engine, and
+    // its pose after every step is recorded.
+    auto reference = LoadPluginAndWorld<FeaturesConcurrentFrameDataCache>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, reference);
+
+    const std::size_t numWorlds = 4;
+    const std::size_t numSteps = 500;
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    std::vector<Eigen::Isometry3d> expected;
+    for (std::size_t i = 0; i < numSteps; ++i)
+    {
+      reference->Step(output, state, input);
+      expected.push_back(reference->GetModel("sphere")->GetLink(0)
+        ->FrameDataRelativeToWorld().pose);
+    }
+
+    auto engine =
+      gz::physics::RequestEngine3d<FeaturesConcurrentFrameDataCache>::From(
+        this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+    engine->SetFrameDataCacheEnabled(true);
+    ASSERT_TRUE(engine->GetFrameDataCacheEnabled());
+
+    sdf::Root root;
+    ASSERT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+
+    std::vector<gz::physics::World3dPtr<FeaturesConcurrentFrameDataCache>>
+      worlds;
+    for (std::size_t i = 0; i < numWorlds; ++i)
+    {
+      // World names must be unique within an engine.
+      sdf::World sdfWorld = *root.WorldByIndex(0);
+      sdfWorld.SetName("world_" + std::to_string(i));
+      worlds.push_back(engine->ConstructWorld(sdfWorld));
+      ASSERT_NE(nullptr, worlds.back());
+    }
+
+    // Every world queries the shared cache twice after each of its steps,
+    // while the other worlds invalidate and refill it. Neither query may
+    // return a pose from before the step.
+    std::vector<std::size_t> mismatches(numWorlds, 0u);
+    std::vector<std::thread> threads;
+    for (std::size_t w = 0; w < numWorlds; ++w)
+    {
+      threads.emplace_back([&, w]()
+      {
+        gz::physics::ForwardStep::Input threadInput;
+        gz::physics::ForwardStep::State threadState;
+        gz::physics::ForwardStep::Output threadOutput;
+        for (std::size_t i = 0; i < numSteps; ++i)
+        {
+          worlds[w]->Step(threadOutput, threadState, threadInput);
+
+          auto stateLock = engine->LockEntityState();
+          const auto link = worlds[w]->GetModel("sphere")->GetLink(0);
+          for (std::size_t q = 0; q < 2; ++q)
+          {
+            if (!expected[i].isApprox(
+                  link->FrameDataRelativeToWorld().pose, 1e-6))
+            {
+              ++mismatches[w];
+            }
+          }
+        }
+      });
+    }
+
+    for (auto &thread : threads)
+      thread.join();
+
+    for (std::size_t w = 0; w < numWorlds; ++w)
+      EXPECT_EQ(0u, mismatches[w]) << "world_" << w;
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesPublishedWorldState : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::PublishedWorldStateFeature
+> {};
+
+template <class T>
+class SimulationFeaturesPublishedWorldStateTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesPublishedWorldStateTestTypes =
+  ::testing::Types<FeaturesPublishedWorldState>;
+TYPED_TEST_SUITE(SimulationFeaturesPublishedWorldStateTest,
+                 SimulationFeaturesPublishedWorldStateTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesPublishedWorldStateTest, PublishedWorldState)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesPublishedWorldState>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+
+    const auto buffer = world->GetPublishedStateBuffer();
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(nullptr, buffer->Read());
+
+    const std::size_t numSteps = 500;
+    std::atomic<bool> done = false;
+    std::atomic<bool> consistent = true;
+    std::thread reader([&]()
+    {
+      // States are read while the world is being stepped, and only ever
+      // move forward.
+      std::size_t lastIteration = 0u;
+      while (!done)
+      {
+        const auto state = buffer->Read();
+        if (!state)
+          continue;
+
+        if (state->iteration < lastIteration ||
+            state->poses.size() != state->twists.size())
+        {
+          consistent = false;
+        }
+        for (std::size_t i = 0; i < state->poses.size(); ++i)
+        {
+          if (state->poses[i].body != state->twists[i].body)
+            consistent = false;
+        }
+        lastIteration = state->iteration;
+      }
+    });
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    for (std::size_t i = 0; i < numSteps; ++i)
+      world->Step(output, state, input);
+
+    done = true;
+    reader.join();
+    EXPECT_TRUE(consistent);
+
+    const auto published = buffer->Read();
+    ASSERT_NE(nullptr, published);
+    EXPECT_EQ(numSteps, published->iteration);
+    EXPECT_GT(published->time, 0.0);
+
+    const auto link = world->GetModel("sphere")->GetLink(0);
+    const auto poseIt = std::find_if(
+        published->poses.begin(), published->poses.end(),
+        [&](const auto &_pose) { return _pose.body == link->EntityID(); });
+    ASSERT_NE(published->poses.end(), poseIt);
+    const auto &twist =
+        published->twists[static_cast<std::size_t>(
+            poseIt - published->poses.begin())];
+
+    const auto frameData = link->FrameDataRelativeToWorld();
+    EXPECT_TRUE(gz::math::eigen3::convert(frameData.pose).Equal(
+        poseIt->pose, 1e-9));
+    EXPECT_TRUE(gz::math::eigen3::convert(frameData.linearVelocity).Equal(
+        twist.linearVelocity, 1e-9));
+
+    // A state that is held by a reader is not changed by later steps
+    world->Step(output, state, input);
+    EXPECT_EQ(numSteps, published->iteration);
+    EXPECT_EQ(numSteps + 1, buffer->Read()->iteration);
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesPoseInterpolation : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::PoseInterpolationFeature
+> {};
+
+template <class T>
+class SimulationFeaturesPoseInterpolationTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesPoseInterpolationTestTypes =
+  ::testing::Types<FeaturesPoseInterpolation>;
+TYPED_TEST_SUITE(SimulationFeaturesPoseInterpolationTest,
+                 SimulationFeaturesPoseInterpolationTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesPoseInterpolationTest, PoseInterpolation)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesPoseInterpolation>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+
+    const auto link = world->GetModel("sphere")->GetLink(0);
+    auto poseOf = [&](const std::vector<gz::physics::WorldPose> &_poses)
+    {
+      const auto it = std::find_if(_poses.begin(), _poses.end(),
+          [&](const auto &_pose) { return _pose.body == link->EntityID(); });
+      EXPECT_NE(_poses.end(), it);
+      return it == _poses.end() ? gz::math::Pose3d() : it->pose;
+    };
+
+    // The first call starts recording the poses
+    std::vector<gz::physics::WorldPose> poses;
+    world->GetInterpolatedPoses(0.0, poses);
+    EXPECT_TRUE(poses.empty());
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    for (std::size_t i = 0; i < 10; ++i)
+      world->Step(output, state, input);
+    const gz::math::Pose3d previous =
+        gz::math::eigen3::convert(link->FrameDataRelativeToWorld().pose);
+    world->Step(output, state, input);
+    const gz::math::Pose3d current =
+        gz::math::eigen3::convert(link->FrameDataRelativeToWorld().pose);
+    ASSERT_LT(current.Pos().Z(), previous.Pos().Z());
+
+    world->GetInterpolatedPoses(0.0, poses);
+    EXPECT_TRUE(current.Equal(poseOf(poses), 1e-9));
+    world->GetInterpolatedPoses(-1.0, poses);
+    EXPECT_TRUE(previous.Equal(poseOf(poses), 1e-9));
+    world->GetInterpolatedPoses(-3.0, poses);
+    EXPECT_TRUE(previous.Equal(poseOf(poses), 1e-9));
+
+    // Between the steps, and after the last one, the sphere keeps falling
+    const double dz = current.Pos().Z() - previous.Pos().Z();
+    world->GetInterpolatedPoses(-0.5, poses);
+    EXPECT_NEAR(previous.Pos().Z() + 0.5 * dz, poseOf(poses).Pos().Z(), 1e-9);
+    world->GetInterpolatedPoses(0.5, poses);
+    EXPECT_NEAR(current.Pos().Z() + 0.5 * dz, poseOf(poses).Pos().Z(), 1e-9);
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesParallelPoseWrite : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::ForwardStep,
+  gz::physics::ParallelPoseWriteFeature
+> {};
+
+template <class T>
+class SimulationFeaturesParallelPoseWriteTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesParallelPoseWriteTestTypes =
+  ::testing::Types<FeaturesParallelPoseWrite>;
+TYPED_TEST_SUITE(SimulationFeaturesParallelPoseWriteTest,
+                 SimulationFeaturesParallelPoseWriteTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesParallelPoseWriteTest, ParallelPoseWrite)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    // Both worlds are loaded into fresh engines in the same order, so their
+    // entities get the same IDs.
+    auto serial = LoadPluginAndWorld<FeaturesParallelPoseWrite>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, serial);
+    auto parallel = LoadPluginAndWorld<FeaturesParallelPoseWrite>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, parallel);
+
+    auto engine = parallel->GetEngine();
+    EXPECT_EQ(1u, engine->GetPoseWriteThreads());
+    engine->SetPoseWriteThreads(4u, 0u);
+    EXPECT_EQ(4u, engine->GetPoseWriteThreads());
+    EXPECT_EQ(0u, engine->GetPoseWriteMinLinks());
+
+    auto sortedChanges = [](gz::physics::ForwardStep::Output &_output)
+    {
+      auto entries = _output.Get<gz::physics::ChangedWorldPoses>().entries;
+      std::sort(entries.begin(), entries.end(),
+          [](const auto &_a, const auto &_b) { return _a.body < _b.body; });
+      return entries;
+    };
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output serialOutput;
+    gz::physics::ForwardStep::Output parallelOutput;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      serial->Step(serialOutput, state, input);
+      parallel->Step(parallelOutput, state, input);
+
+      const auto expected = sortedChanges(serialOutput);
+      const auto actual = sortedChanges(parallelOutput);
+      ASSERT_EQ(expected.size(), actual.size());
+      for (std::size_t j = 0; j < expected.size(); ++j)
+      {
+        EXPECT_EQ(expected[j].body, actual[j].body);
+        EXPECT_EQ(expected[j].pose, actual[j].pose);
+      }
+    }
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesTaskScheduler : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::ForwardStep,
+  gz::physics::ParallelPoseWriteFeature,
+  gz::physics::TaskSchedulerFeature
+> {};
+
+template <class T>
+class SimulationFeaturesTaskSchedulerTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesTaskSchedulerTestTypes =
+  ::testing::Types<FeaturesTaskScheduler>;
+TYPED_TEST_SUITE(SimulationFeaturesTaskSchedulerTest,
+                 SimulationFeaturesTaskSchedulerTestTypes);
+
+/// \brief A scheduler that counts the tasks it runs on a thread pool.
+class CountingTaskScheduler : public gz::physics::ThreadPoolTaskScheduler
+{
+  public: CountingTaskScheduler() : ThreadPoolTaskScheduler(4u) {}
+
+  public: void Run(std::size_t _count,
+                   const std::function<void(std::size_t)> &_task) override
+  {
+    this->tasks += _count;
+    ThreadPoolTaskScheduler::Run(_count, _task);
+  }
+
+  public: std::atomic<std::size_t> tasks{0u};
+};
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesTaskSchedulerTest, TaskScheduler)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto serial = LoadPluginAndWorld<FeaturesTaskScheduler>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, serial);
+    auto scheduled = LoadPluginAndWorld<FeaturesTaskScheduler>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, scheduled);
+
+    auto engine = scheduled->GetEngine();
+    EXPECT_EQ(nullptr, engine->GetTaskScheduler());
+    auto scheduler = std::make_shared<CountingTaskScheduler>();
+    engine->SetTaskScheduler(scheduler);
+    EXPECT_EQ(scheduler, engine->GetTaskScheduler());
+
+    // The parallel pose write-out runs on the scheduler
+    engine->SetPoseWriteThreads(4u, 0u);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output serialOutput;
+    gz::physics::ForwardStep::Output scheduledOutput;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      serial->Step(serialOutput, state, input);
+      scheduled->Step(scheduledOutput, state, input);
+
+      auto expected =
+          serialOutput.Get<gz::physics::ChangedWorldPoses>().entries;
+      auto actual =
+          scheduledOutput.Get<gz::physics::ChangedWorldPoses>().entries;
+      auto byBody = [](const auto &_a, const auto &_b)
+      {
+        return _a.body < _b.body;
+      };
+      std::sort(expected.begin(), expected.end(), byBody);
+      std::sort(actual.begin(), actual.end(), byBody);
+      ASSERT_EQ(expected.size(), actual.size());
+      for (std::size_t j = 0; j < expected.size(); ++j)
+      {
+        EXPECT_EQ(expected[j].body, actual[j].body);
+        EXPECT_EQ(expected[j].pose, actual[j].pose);
+      }
+    }
+    EXPECT_LT(0u, scheduler->tasks.load());
+
+    // Without a scheduler the engine uses threads of its own again
+    engine->SetTaskScheduler(nullptr);
+    EXPECT_EQ(nullptr, engine->GetTaskScheduler());
+    const std::size_t tasks = scheduler->tasks;
+    scheduled->Step(scheduledOutput, state, input);
+    EXPECT_EQ(tasks, scheduler->tasks.load());
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesWorldTwists : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep
+> {};
+
+template <class T>
+class SimulationFeaturesWorldTwistsTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesWorldTwistsTestTypes =
+  ::testing::Types<FeaturesWorldTwists>;
+TYPED_TEST_SUITE(SimulationFeaturesWorldTwistsTest,
+                 SimulationFeaturesWorldTwistsTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesWorldTwistsTest, WorldTwists)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesWorldTwists>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    output.Get<gz::physics::WorldTwists>();
+    output.Get<gz::physics::ChangedWorldTwists>();
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+
+      const auto data = link->FrameDataRelativeToWorld();
+      const auto &twists =
+          output.Get<gz::physics::WorldTwists>().entries;
+      auto twistIt = std::find_if(twists.begin(), twists.end(),
+          [&](const auto &_t) { return _t.body == link->EntityID(); });
+      ASSERT_NE(twists.end(), twistIt);
+      EXPECT_TRUE(data.linearVelocity.isApprox(
+          gz::math::eigen3::convert(twistIt->linearVelocity), 1e-9));
+      EXPECT_TRUE(data.angularVelocity.isApprox(
+          gz::math::eigen3::convert(twistIt->angularVelocity), 1e-9));
+
+      // Changed twists follow the changed poses
+      const auto &changedPoses =
+          output.Get<gz::physics::ChangedWorldPoses>().entries;
+      const auto &changedTwists =
+          output.Get<gz::physics::ChangedWorldTwists>().entries;
+      ASSERT_EQ(changedPoses.size(), changedTwists.size());
+      for (std::size_t j = 0; j < changedPoses.size(); ++j)
+      {
+        EXPECT_EQ(changedPoses[j].body, changedTwists[j].body);
+        if (changedTwists[j].body != link->EntityID())
+          continue;
+        EXPECT_EQ(twistIt->linearVelocity, changedTwists[j].linearVelocity);
+        EXPECT_EQ(twistIt->angularVelocity,
+                  changedTwists[j].angularVelocity);
+      }
+    }
+
+    // TPE does not simulate gravity.
+    if (this->PhysicsEngineName(name) != "tpe")
+    {
+      EXPECT_GT(0.0,
+          link->FrameDataRelativeToWorld().linearVelocity.z());
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesWorldTwistsTest, WorldAccelerations)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    // bullet and tpe do not write the accelerations of the links
+    if (this->PhysicsEngineName(name) == "bullet" ||
+        this->PhysicsEngineName(name) == "tpe")
+    {
+      GTEST_SKIP();
+    }
+
+    auto world = LoadPluginAndWorld<FeaturesWorldTwists>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    output.Get<gz::physics::WorldAccelerations>();
+    output.Get<gz::physics::ChangedWorldAccelerations>();
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+
+      // The sphere is falling freely
+      const auto &accelerations =
+          output.Get<gz::physics::WorldAccelerations>().entries;
+      auto accelerationIt = std::find_if(
+          accelerations.begin(), accelerations.end(),
+          [&](const auto &_a) { return _a.body == link->EntityID(); });
+      ASSERT_NE(accelerations.end(), accelerationIt);
+      EXPECT_NEAR(-9.8, accelerationIt->linearAcceleration.Z(), 1e-3);
+      EXPECT_NEAR(0.0, accelerationIt->linearAcceleration.X(), 1e-3);
+      EXPECT_NEAR(0.0, accelerationIt->linearAcceleration.Y(), 1e-3);
+      EXPECT_NEAR(0.0, accelerationIt->angularAcceleration.Length(), 1e-3);
+
+      // Changed accelerations follow the changed poses
+      const auto &changedPoses =
+          output.Get<gz::physics::ChangedWorldPoses>().entries;
+      const auto &changedAccelerations =
+          output.Get<gz::physics::ChangedWorldAccelerations>().entries;
+      ASSERT_EQ(changedPoses.size(), changedAccelerations.size());
+      for (std::size_t j = 0; j < changedPoses.size(); ++j)
+      {
+        EXPECT_EQ(changedPoses[j].body, changedAccelerations[j].body);
+        if (changedAccelerations[j].body != link->EntityID())
+          continue;
+        EXPECT_EQ(accelerationIt->linearAcceleration,
+                  changedAccelerations[j].linearAcceleration);
+      }
+    }
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesSharedStateExport : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::ForwardStep,
+  gz::physics::SharedStateExportFeature
+> {};
+
+template <class T>
+class SimulationFeaturesSharedStateExportTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesSharedStateExportTestTypes =
+  ::testing::Types<FeaturesSharedStateExport>;
+TYPED_TEST_SUITE(SimulationFeaturesSharedStateExportTest,
+                 SimulationFeaturesSharedStateExportTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesSharedStateExportTest, SharedStateExport)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesSharedStateExport>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+
+    gz::physics::SharedStateRingLayout layout;
+    layout.slotCount = 4;
+    layout.maxPoses = 16;
+    layout.maxJointStates = 16;
+    layout.maxContacts = 64;
+    std::vector<uint64_t> memory(
+        (gz::physics::SharedStateRingWriter::RequiredBytes(layout) + 7) / 8);
+    const std::size_t bytes = memory.size() * sizeof(uint64_t);
+    auto writer = std::make_shared<gz::physics::SharedStateRingWriter>();
+    ASSERT_TRUE(writer->Create(memory.data(), bytes, layout));
+    world->SetSharedStateExport(writer);
+
+    gz::physics::SharedStateRingReader reader;
+    ASSERT_TRUE(reader.Open(memory.data(), bytes));
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    gz::physics::SharedStateFrame frame;
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+      world->Step(output, state, input);
+      EXPECT_EQ(i + 1, reader.FrameCount());
+      ASSERT_TRUE(reader.ReadLatest(frame));
+      EXPECT_EQ(i, frame.frame);
+      EXPECT_FALSE(frame.truncated);
+
+      // The frame has the poses that the step wrote
+      const auto &poses = output.Get<gz::physics::WorldPoses>().entries;
+      ASSERT_EQ(poses.size(), frame.poses.size());
+      for (const auto &pose : frame.poses)
+      {
+        auto poseIt = std::find_if(poses.begin(), poses.end(),
+            [&](const auto &_p) { return _p.body == pose.body; });
+        ASSERT_NE(poses.end(), poseIt);
+        EXPECT_EQ(poseIt->pose, pose.pose);
+      }
+    }
+    EXPECT_NEAR(0.01, frame.time, 1e-6);
+
+    // Stop exporting
+    world->SetSharedStateExport(nullptr);
+    world->Step(output, state, input);
+    EXPECT_EQ(10u, reader.FrameCount());
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesSleep : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::SleepFeature
+> {};
+
+template <class T>
+class SimulationFeaturesSleepTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesSleepTestTypes =
+  ::testing::Types<FeaturesSleep>;
+TYPED_TEST_SUITE(SimulationFeaturesSleepTest,
+                 SimulationFeaturesSleepTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesSleepTest, Sleep)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesSleep>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+    auto model = world->GetModel("sphere");
+    ASSERT_NE(nullptr, model);
+    auto link = model->GetLink(0);
+    ASSERT_NE(nullptr, link);
+    const std::size_t linkID = link->EntityID();
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    auto reported = [&output, linkID]()
+    {
+      const auto &entries =
+          output.Get<gz::physics::ChangedWorldPoses>().entries;
+      return std::any_of(entries.begin(), entries.end(),
+          [linkID](const auto &_wp) { return _wp.body == linkID; });
+    };
+    world->Step(output, state, input);
+    EXPECT_TRUE(reported());
+
+    // A model whose sleeping is disabled can not be put to sleep
+    model->SetSleepEnabled(false);
+    EXPECT_FALSE(model->GetSleepEnabled());
+    model->SetSleeping(true);
+    EXPECT_FALSE(model->GetSleeping());
+
+    model->SetSleepEnabled(true);
+    EXPECT_TRUE(model->GetSleepEnabled());
+    model->SetSleeping(true);
+    EXPECT_TRUE(model->GetSleeping());
+
+    // Sleeping models do not move, and their links are not reported
+    const auto sleepPose = link->FrameDataRelativeToWorld().pose;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+      EXPECT_FALSE(reported());
+    }
+    EXPECT_TRUE(model->GetSleeping());
+    EXPECT_TRUE(
+        sleepPose.isApprox(link->FrameDataRelativeToWorld().pose, 1e-9));
+
+    // Once woken up, the model falls again
+    model->SetSleeping(false);
+    EXPECT_FALSE(model->GetSleeping());
+    for (std::size_t i = 0; i < 100; ++i)
+      world->Step(output, state, input);
+    EXPECT_TRUE(reported());
+    EXPECT_GT(sleepPose.translation().z(),
+        link->FrameDataRelativeToWorld().pose.translation().z());
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesSleepThresholds : public gz::physics::FeatureList<
+  FeaturesSleep,
+  gz::physics::SleepThresholdsFeature
+> {};
+
+template <class T>
+class SimulationFeaturesSleepThresholdsTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesSleepThresholdsTestTypes =
+  ::testing::Types<FeaturesSleepThresholds>;
+TYPED_TEST_SUITE(SimulationFeaturesSleepThresholdsTest,
+                 SimulationFeaturesSleepThresholdsTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesSleepThresholdsTest, SleepThresholds)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesSleepThresholds>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+    auto model = world->GetModel("sphere");
+    ASSERT_NE(nullptr, model);
+
+    using SleepThresholds = gz::physics::SleepThresholdsFeature::
+        SleepThresholdsT<gz::physics::FeaturePolicy3d>;
+    const SleepThresholds original = model->GetSleepThresholds();
+
+    // Thresholds that the falling sphere stays below go to sleep after the
+    // timeout
+    SleepThresholds thresholds;
+    thresholds.linearSpeed = 100.0;
+    thresholds.angularSpeed = 100.0;
+    thresholds.timeout = 0.01;
+    model->SetSleepThresholds(thresholds);
+    const SleepThresholds set = model->GetSleepThresholds();
+    EXPECT_DOUBLE_EQ(thresholds.linearSpeed, set.linearSpeed);
+    EXPECT_DOUBLE_EQ(thresholds.angularSpeed, set.angularSpeed);
+    EXPECT_NEAR(thresholds.timeout, set.timeout, 1e-6);
+
+    model->SetSleepEnabled(true);
+    EXPECT_FALSE(model->GetSleeping());
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    for (std::size_t i = 0; i < 100 && !model->GetSleeping(); ++i)
+      world->Step(output, state, input);
+    EXPECT_TRUE(model->GetSleeping());
+
+    // Some engines share the timeout between all of their models
+    model->SetSleepThresholds(original);
+  }
+}
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesSleepThresholdsTest, SleepIslands)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesSleepThresholds>(
+        this->loader, name, common_test::worlds::kStackedBoxesSdf);
+    ASSERT_NE(nullptr, world);
+    auto bottom = world->GetModel("bottom");
+    auto top = world->GetModel("top");
+    auto ball = world->GetModel("ball");
+    ASSERT_NE(nullptr, bottom);
+    ASSERT_NE(nullptr, top);
+    ASSERT_NE(nullptr, ball);
+
+    using SleepThresholds = gz::physics::SleepThresholdsFeature::
+        SleepThresholdsT<gz::physics::FeaturePolicy3d>;
+    const SleepThresholds original = bottom->GetSleepThresholds();
+    SleepThresholds thresholds;
+    thresholds.linearSpeed = 0.1;
+    thresholds.angularSpeed = 0.1;
+    thresholds.timeout = 0.2;
+    for (auto &model : {bottom, top})
+    {
+      model->SetSleepThresholds(thresholds);
+      model->SetSleepEnabled(true);
+    }
+    ball->SetSleepEnabled(false);
+
+    // The two boxes touch each other, so they go to sleep together, well
+    // before the ball reaches them
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    std::size_t steps = 0;
+    for (; steps < 1500 && !bottom->GetSleeping(); ++steps)
+    {
+      world->Step(output, state, input);
+      EXPECT_EQ(bottom->GetSleeping(), top->GetSleeping());
+    }
+    EXPECT_TRUE(bottom->GetSleeping());
+    EXPECT_TRUE(top->GetSleeping());
+
+    // The falling ball wakes up the top box when it hits it, and with it the
+    // bottom box that the top box rests on
+    bool topWoke = false;
+    bool bottomWoke = false;
+    for (; steps < 4000 && !(topWoke && bottomWoke); ++steps)
+    {
+      world->Step(output, state, input);
+      topWoke |= !top->GetSleeping();
+      bottomWoke |= !bottom->GetSleeping();
+    }
+    EXPECT_TRUE(topWoke);
+    EXPECT_TRUE(bottomWoke);
+
+    // Some engines share the timeout between all of their models
+    for (auto &model : {bottom, top})
+      model->SetSleepThresholds(original);
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesForceField : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::ForceFieldFeature
+> {};
+
+template <class T>
+class SimulationFeaturesForceFieldTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesForceFieldTestTypes =
+  ::testing::Types<FeaturesForceField>;
+TYPED_TEST_SUITE(SimulationFeaturesForceFieldTest,
+                 SimulationFeaturesForceFieldTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesForceFieldTest, ForceField)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesForceField>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+    const Eigen::Vector3d initialPosition =
+        link->FrameDataRelativeToWorld().pose.translation();
+
+    // The sphere weighs 1 kg, so it floats in 1 liter of water
+    using ForceField = gz::physics::ForceFieldFeature::ForceFieldT<
+        gz::physics::FeaturePolicy3d>;
+    ForceField field;
+    field.fluidDensity = 1000.0;
+    field.links.emplace_back();
+    field.links.back().link = link->EntityID();
+    field.links.back().volume = 0.001;
+    const std::size_t fieldID = world->AddForceField(field);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+    for (std::size_t i = 0; i < 100; ++i)
+      world->Step(output, state, input);
+
+    auto frameData = link->FrameDataRelativeToWorld();
+    EXPECT_NEAR(initialPosition.z(), frameData.pose.translation().z(), 1e-6);
+    EXPECT_NEAR(0.0, frameData.linearVelocity.norm(), 1e-6);
+
+    // A current along x drags the sphere with it
+    field.fluidVelocity = Eigen::Vector3d(1.0, 0.0, 0.0);
+    field.links.back().linearDrag = 1.0;
+    EXPECT_TRUE(world->SetForceField(fieldID, field));
+    for (std::size_t i = 0; i < 100; ++i)
+      world->Step(output, state, input);
+
+    frameData = link->FrameDataRelativeToWorld();
+    EXPECT_GT(frameData.linearVelocity.x(), 0.05);
+    EXPECT_LT(frameData.linearVelocity.x(), 1.0);
+    EXPECT_NEAR(0.0, frameData.linearVelocity.z(), 1e-6);
+
+    // Without the field, the sphere falls
+    EXPECT_TRUE(world->RemoveForceField(fieldID));
+    EXPECT_FALSE(world->RemoveForceField(fieldID));
+    EXPECT_FALSE(world->SetForceField(fieldID, field));
+    for (std::size_t i = 0; i < 100; ++i)
+      world->Step(output, state, input);
+    EXPECT_LT(link->FrameDataRelativeToWorld().linearVelocity.z(), -0.5);
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesKinematicModel : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::FindFreeGroupFeature,
+  gz::physics::SetFreeGroupWorldVelocity,
+  gz::physics::KinematicModelFeature
+> {};
+
+template <class T>
+class SimulationFeaturesKinematicModelTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesKinematicModelTestTypes =
+  ::testing::Types<FeaturesKinematicModel>;
+TYPED_TEST_SUITE(SimulationFeaturesKinematicModelTest,
+                 SimulationFeaturesKinematicModelTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesKinematicModelTest, KinematicModel)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesKinematicModel>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+    auto model = world->GetModel("sphere");
+    ASSERT_NE(nullptr, model);
+    auto link = model->GetLink(0);
+    ASSERT_NE(nullptr, link);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+
+    EXPECT_FALSE(model->GetKinematic());
+    model->SetKinematic(true);
+    EXPECT_TRUE(model->GetKinematic());
+
+    // Kinematic models are not moved by gravity
+    const Eigen::Vector3d startPos =
+        link->FrameDataRelativeToWorld().pose.translation();
+    for (std::size_t i = 0; i < 100; ++i)
+      world->Step(output, state, input);
+    EXPECT_TRUE(startPos.isApprox(
+        link->FrameDataRelativeToWorld().pose.translation(), 1e-9));
+
+    // They still move at the velocity they are given, 1 m/s for 0.1 s
+    auto freeGroup = model->FindFreeGroup();
+    ASSERT_NE(nullptr, freeGroup);
+    freeGroup->SetWorldLinearVelocity(Eigen::Vector3d(1, 0, 0));
+    for (std::size_t i = 0; i < 100; ++i)
+      world->Step(output, state, input);
+    const Eigen::Vector3d movedPos =
+        link->FrameDataRelativeToWorld().pose.translation();
+    EXPECT_NEAR(startPos.x() + 0.1, movedPos.x(), 1e-6);
+    EXPECT_NEAR(startPos.z(), movedPos.z(), 1e-9);
+
+    // Once dynamic again, the model falls
+    model->SetKinematic(false);
+    EXPECT_FALSE(model->GetKinematic());
+    for (std::size_t i = 0; i < 100; ++i)
+      world->Step(output, state, input);
+    EXPECT_GT(movedPos.z(),
+        link->FrameDataRelativeToWorld().pose.translation().z());
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesModelUpdateRate : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::FindFreeGroupFeature,
+  gz::physics::SetFreeGroupWorldVelocity,
+  gz::physics::ModelUpdateRateFeature
+> {};
+
+template <class T>
+class SimulationFeaturesModelUpdateRateTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesModelUpdateRateTestTypes =
+  ::testing::Types<FeaturesModelUpdateRate>;
+TYPED_TEST_SUITE(SimulationFeaturesModelUpdateRateTest,
+                 SimulationFeaturesModelUpdateRateTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesModelUpdateRateTest, ModelUpdateRate)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesModelUpdateRate>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+    auto model = world->GetModel("sphere");
+    ASSERT_NE(nullptr, model);
+    auto link = model->GetLink(0);
+    ASSERT_NE(nullptr, link);
+    auto freeGroup = model->FindFreeGroup();
+    ASSERT_NE(nullptr, freeGroup);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output output;
+
+    EXPECT_DOUBLE_EQ(0.0, model->GetUpdateRate());
+    model->SetUpdateRate(100.0);
+    EXPECT_DOUBLE_EQ(100.0, model->GetUpdateRate());
+
+    // At 100 Hz in a world stepped at 1 kHz, the model moves in one step of
+    // ten, and catches up with the time it skipped
+    freeGroup->SetWorldLinearVelocity(Eigen::Vector3d(1, 0, 0));
+    const double startX =
+        link->FrameDataRelativeToWorld().pose.translation().x();
+    double x = startX;
+    std::size_t updates = 0;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+      const double newX =
+          link->FrameDataRelativeToWorld().pose.translation().x();
+      if (std::abs(newX - x) > 1e-9)
+        ++updates;
+      x = newX;
+    }
+    EXPECT_EQ(10u, updates);
+    EXPECT_LE(x - startX, 0.1 + 1e-6);
+    EXPECT_GE(x - startX, 0.09 - 1e-6);
+
+    // Without a rate the model is updated in the next step, catching up
+    // with the steps it skipped
+    model->SetUpdateRate(0.0);
+    world->Step(output, state, input);
+    EXPECT_NEAR(startX + 0.101,
+        link->FrameDataRelativeToWorld().pose.translation().x(), 1e-6);
+  }
+}
+
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesDeterministicStep : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetContactsFromLastStepFeature,
+  gz::physics::ForwardStep,
+  gz::physics::DeterministicStepFeature
 > {};
 
 template <class T>
-class SimulationFeaturesCollisionPairMaxContactsTest :
+class SimulationFeaturesDeterministicStepTest :
   public SimulationFeaturesTest<T>{};
-using SimulationFeaturesCollisionPairMaxContactsTestTypes =
-  ::testing::Types<FeaturesCollisionPairMaxContacts>;
-TYPED_TEST_SUITE(SimulationFeaturesCollisionPairMaxContactsTest,
-                 SimulationFeaturesCollisionPairMaxContactsTestTypes);
+using SimulationFeaturesDeterministicStepTestTypes =
+  ::testing::Types<FeaturesDeterministicStep>;
+TYPED_TEST_SUITE(SimulationFeaturesDeterministicStepTest,
+                 SimulationFeaturesDeterministicStepTestTypes);
 
 /////////////////////////////////////////////////
-TYPED_TEST(SimulationFeaturesCollisionPairMaxContactsTest,
-    CollisionPairMaxContacts)
+TYPED_TEST(SimulationFeaturesDeterministicStepTest, DeterministicStep)
 {
   for (const std::string &name : this->pluginNames)
   {
-    auto world = LoadPluginAndWorld<FeaturesCollisionPairMaxContacts>(
-      this->loader,
-      name,
-      common_test::worlds::kShapesWorld);
-    auto checkedOutput = StepWorld<FeaturesCollisionPairMaxContacts>(
-        world, true, 1).first;
-    EXPECT_TRUE(checkedOutput);
+    // Both worlds are loaded into fresh engines in the same order, so their
+    // entities get the same IDs.
+    auto first = LoadPluginAndWorld<FeaturesDeterministicStep>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, first);
+    auto second = LoadPluginAndWorld<FeaturesDeterministicStep>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, second);
+
+    auto firstEngine = first->GetEngine();
+    EXPECT_FALSE(firstEngine->GetDeterministic());
+    firstEngine->SetDeterministic(true);
+    EXPECT_TRUE(firstEngine->GetDeterministic());
+    second->GetEngine()->SetDeterministic(true);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output firstOutput;
+    gz::physics::ForwardStep::Output secondOutput;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      first->Step(firstOutput, state, input);
+      second->Step(secondOutput, state, input);
+
+      // Poses are reported in the same order, and are bit identical
+      const auto &firstPoses =
+          firstOutput.Get<gz::physics::ChangedWorldPoses>().entries;
+      const auto &secondPoses =
+          secondOutput.Get<gz::physics::ChangedWorldPoses>().entries;
+      ASSERT_EQ(firstPoses.size(), secondPoses.size());
+      for (std::size_t j = 0; j < firstPoses.size(); ++j)
+      {
+        EXPECT_EQ(firstPoses[j].body, secondPoses[j].body);
+        EXPECT_EQ(firstPoses[j].pose, secondPoses[j].pose);
+      }
 
-    auto contacts = world->GetContactsFromLastStep();
-    EXPECT_EQ(std::numeric_limits<std::size_t>::max(),
-              world->GetCollisionPairMaxContacts());
-    // Large box collides with other shapes
-    EXPECT_GT(contacts.size(), 30u);
+      const auto firstContacts = first->GetContactsFromLastStep();
+      const auto secondContacts = second->GetContactsFromLastStep();
+      ASSERT_EQ(firstContacts.size(), secondContacts.size());
+      using ContactPoint =
+          gz::physics::World3d<FeaturesDeterministicStep>::ContactPoint;
+      std::size_t lastCollision1 = 0u;
+      for (std::size_t j = 0; j < firstContacts.size(); ++j)
+      {
+        const auto &a = firstContacts[j].template Get<ContactPoint>();
+        const auto &b = secondContacts[j].template Get<ContactPoint>();
+        EXPECT_EQ(a.collision1->EntityID(), b.collision1->EntityID());
+        EXPECT_EQ(a.collision2->EntityID(), b.collision2->EntityID());
+        EXPECT_EQ(a.point, b.point);
+
+        // Contacts are sorted by their collisions
+        EXPECT_LE(lastCollision1, a.collision1->EntityID());
+        lastCollision1 = a.collision1->EntityID();
+      }
+    }
+  }
+}
 
-    world->SetCollisionPairMaxContacts(1u);
-    EXPECT_EQ(1u, world->GetCollisionPairMaxContacts());
-    checkedOutput = StepWorld<FeaturesCollisionPairMaxContacts>(
-        world, true, 1).first;
-    EXPECT_TRUE(checkedOutput);
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesDeterministicThreads : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::ForwardStep,
+  gz::physics::DeterministicStepFeature,
+  gz::physics::NumThreads
+> {};
 
-    contacts = world->GetContactsFromLastStep();
-    EXPECT_EQ(4u, contacts.size());
+template <class T>
+class SimulationFeaturesDeterministicThreadsTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesDeterministicThreadsTestTypes =
+  ::testing::Types<FeaturesDeterministicThreads>;
+TYPED_TEST_SUITE(SimulationFeaturesDeterministicThreadsTest,
+                 SimulationFeaturesDeterministicThreadsTestTypes);
 
-    world->SetCollisionPairMaxContacts(0u);
-    EXPECT_EQ(0u, world->GetCollisionPairMaxContacts());
-    checkedOutput = StepWorld<FeaturesCollisionPairMaxContacts>(
-        world, true, 1).first;
-    EXPECT_TRUE(checkedOutput);
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesDeterministicThreadsTest, DeterministicThreads)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto first = LoadPluginAndWorld<FeaturesDeterministicThreads>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, first);
+    auto second = LoadPluginAndWorld<FeaturesDeterministicThreads>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, second);
+
+    // The worlds ask for several threads, which deterministic steps may
+    // not use, but their thread counts are kept.
+    first->SetNumThreads(4u);
+    second->SetNumThreads(4u);
+    first->GetEngine()->SetDeterministic(true);
+    second->GetEngine()->SetDeterministic(true);
+    EXPECT_EQ(4u, first->GetNumThreads());
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Output firstOutput;
+    gz::physics::ForwardStep::Output secondOutput;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      first->Step(firstOutput, state, input);
+      second->Step(secondOutput, state, input);
+
+      const auto &firstPoses =
+          firstOutput.Get<gz::physics::ChangedWorldPoses>().entries;
+      const auto &secondPoses =
+          secondOutput.Get<gz::physics::ChangedWorldPoses>().entries;
+      ASSERT_EQ(firstPoses.size(), secondPoses.size());
+      for (std::size_t j = 0; j < firstPoses.size(); ++j)
+      {
+        EXPECT_EQ(firstPoses[j].body, secondPoses[j].body);
+        EXPECT_EQ(firstPoses[j].pose, secondPoses[j].pose);
+      }
+    }
+  }
+}
 
-    contacts = world->GetContactsFromLastStep();
-    EXPECT_EQ(0u, contacts.size());
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesRayIntersection : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::GetShapeFromLink,
+  gz::physics::RayIntersectionFeature
+> {};
+
+template <class T>
+class SimulationFeaturesRayIntersectionTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesRayIntersectionTestTypes =
+  ::testing::Types<FeaturesRayIntersection>;
+TYPED_TEST_SUITE(SimulationFeaturesRayIntersectionTest,
+                 SimulationFeaturesRayIntersectionTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesRayIntersectionTest, CastRays)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesRayIntersection>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, world);
+
+    const std::size_t sphereID = world->GetModel("sphere")->GetLink(0)
+        ->GetShape(0)->EntityID();
+    const std::size_t boxID = world->GetModel("box")->GetLink(0)
+        ->GetShape(0)->EntityID();
+
+    // Straight down onto the sphere, onto the ground box, and past the box
+    const std::vector<Eigen::Vector3d> from = {
+      {0, 1.5, 10}, {10, 10, 10}, {60, 0, 10}};
+    const std::vector<Eigen::Vector3d> to = {
+      {0, 1.5, -10}, {10, 10, -10}, {60, 0, -10}};
+
+    for (std::size_t numThreads : {1u, 0u, 2u})
+    {
+      const auto hits = world->CastRays(from, to, numThreads);
+      ASSERT_EQ(3u, hits.size);
+
+      EXPECT_EQ(sphereID, hits.shape[0]);
+      EXPECT_NEAR(8.5, hits.distance[0], 1e-3);
+      EXPECT_NEAR(1.0, hits.normal[0].z(), 1e-3);
+
+      EXPECT_EQ(boxID, hits.shape[1]);
+      EXPECT_NEAR(9.0, hits.distance[1], 1e-3);
+      EXPECT_NEAR(1.0, hits.normal[1].z(), 1e-3);
+
+      EXPECT_EQ(gz::physics::INVALID_ENTITY_ID, hits.shape[2]);
+      EXPECT_TRUE(std::isinf(hits.distance[2]));
+    }
   }
 }
 
 // The features that an engine must have to be loaded by this loader.
-struct FeaturesStep : gz::physics::FeatureList<
+struct FeaturesShapeQueries : public gz::physics::FeatureList<
   gz::physics::sdf::ConstructSdfWorld,
-  gz::physics::ForwardStep
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::GetShapeFromLink,
+  gz::physics::ShapeQueryFeature
 > {};
 
 template <class T>
-class SimulationFeaturesStepTest :
+class SimulationFeaturesShapeQueriesTest :
   public SimulationFeaturesTest<T>{};
-using SimulationFeaturesStepTestTypes =
-  ::testing::Types<FeaturesStep>;
-TYPED_TEST_SUITE(SimulationFeaturesStepTest,
-                 SimulationFeaturesStepTestTypes);
+using SimulationFeaturesShapeQueriesTestTypes =
+  ::testing::Types<FeaturesShapeQueries>;
+TYPED_TEST_SUITE(SimulationFeaturesShapeQueriesTest,
+                 SimulationFeaturesShapeQueriesTestTypes);
 
 /////////////////////////////////////////////////
-TYPED_TEST(SimulationFeaturesStepTest, StepWorld)
+TYPED_TEST(SimulationFeaturesShapeQueriesTest, CastShapesAndFindOverlaps)
 {
+  using QueryVolume = gz::physics::ShapeQueryFeature::QueryVolumeT<
+      gz::physics::FeaturePolicy3d>;
+
   for (const std::string &name : this->pluginNames)
   {
-#ifdef _WIN32
-    // See https://github.com/gazebosim/gz-physics/issues/483
-    CHECK_UNSUPPORTED_ENGINE(name, "bullet")
-#endif
-    auto world = LoadPluginAndWorld<FeaturesStep>(
-      this->loader,
-      name,
-      common_test::worlds::kShapesWorld);
-    auto checkedOutput = StepWorld<FeaturesStep>(world, true, 1000).first;
-    EXPECT_TRUE(checkedOutput);
+    auto world = LoadPluginAndWorld<FeaturesShapeQueries>(
+        this->loader, name, common_test::worlds::kShapesWorld);
+    ASSERT_NE(nullptr, world);
+
+    const std::size_t sphereID = world->GetModel("sphere")->GetLink(0)
+        ->GetShape(0)->EntityID();
+    const std::size_t boxID = world->GetModel("box")->GetLink(0)
+        ->GetShape(0)->EntityID();
+
+    // Drop a sphere onto the sphere model and a box past the ground box
+    const std::vector<QueryVolume> volumes = {
+      QueryVolume::Sphere({0, 1.5, 10}, 0.5),
+      QueryVolume::Box(Eigen::Isometry3d(Eigen::Translation3d(60, 0, 10)),
+                       {1, 1, 1})};
+    const std::vector<Eigen::Vector3d> to = {{0, 1.5, -10}, {60, 0, -10}};
+
+    for (std::size_t numThreads : {1u, 2u})
+    {
+      const auto hits = world->CastShapes(volumes, to, numThreads);
+      ASSERT_EQ(2u, hits.size);
+
+      EXPECT_EQ(sphereID, hits.shape[0]);
+      EXPECT_NEAR(7.5, hits.distance[0], 1e-2);
+      EXPECT_NEAR(1.0, hits.normal[0].z(), 1e-2);
+
+      EXPECT_EQ(gz::physics::INVALID_ENTITY_ID, hits.shape[1]);
+      EXPECT_TRUE(std::isinf(hits.distance[1]));
+    }
+
+    // A sphere resting on the ground box, and one above the sphere model
+    const std::vector<QueryVolume> tests = {
+      QueryVolume::Sphere({10, 10, 1.25}, 0.5),
+      QueryVolume::Sphere({0, 1.5, 3}, 0.5)};
+    const auto overlaps = world->FindOverlaps(tests);
+    ASSERT_EQ(2u, overlaps.size);
+    ASSERT_EQ(1u, overlaps.offset[1] - overlaps.offset[0]);
+    EXPECT_EQ(boxID, overlaps.shape[overlaps.offset[0]]);
+    EXPECT_EQ(overlaps.offset[1], overlaps.offset[2]);
   }
 }
 
 // The features that an engine must have to be loaded by this loader.
-struct FeaturesFalling : public  gz::physics::FeatureList<
+struct FeaturesAsyncStep : public gz::physics::FeatureList<
   gz::physics::sdf::ConstructSdfWorld,
   gz::physics::GetModelFromWorld,
   gz::physics::GetLinkFromModel,
-  gz::physics::ForwardStep
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::AsyncForwardStepFeature
 > {};
 
 template <class T>
-class SimulationFeaturesFallingTest :
+class SimulationFeaturesAsyncStepTest :
   public SimulationFeaturesTest<T>{};
-using SimulationFeaturesFallingTestTypes =
-  ::testing::Types<FeaturesFalling>;
-TYPED_TEST_SUITE(SimulationFeaturesFallingTest,
-                 SimulationFeaturesFallingTestTypes);
+using SimulationFeaturesAsyncStepTestTypes =
+  ::testing::Types<FeaturesAsyncStep>;
+TYPED_TEST_SUITE(SimulationFeaturesAsyncStepTest,
+                 SimulationFeaturesAsyncStepTestTypes);
 
 /////////////////////////////////////////////////
-TYPED_TEST(SimulationFeaturesFallingTest, Falling)
+TYPED_TEST(SimulationFeaturesAsyncStepTest, StepAsync)
 {
   for (const std::string &name : this->pluginNames)
   {
-    CHECK_UNSUPPORTED_ENGINE(name, "tpe")
+    auto world = LoadPluginAndWorld<FeaturesAsyncStep>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+    const std::size_t linkID = link->EntityID();
+
+    auto sphereZ = [linkID](const gz::physics::ForwardStep::Output &_h)
+    {
+      for (const auto &entry : _h.Get<gz::physics::WorldPoses>().entries)
+      {
+        if (entry.body == linkID)
+          return entry.pose.Pos().Z();
+      }
+      return std::numeric_limits<double>::quiet_NaN();
+    };
 
-#ifdef _WIN32
-    // See https://github.com/gazebosim/gz-physics/issues/483
-    CHECK_UNSUPPORTED_ENGINE(name, "bullet")
-#endif
-    auto world = LoadPluginAndWorld<FeaturesFalling>(
-        this->loader, name,
-        common_test::worlds::kFallingWorld);
+    // Nothing was stepped yet
+    EXPECT_TRUE(world->FinishStep().Get<gz::physics::WorldPoses>()
+        .entries.empty());
 
-    auto [checkedOutput, output] =
-      StepWorld<FeaturesFalling>(world, true, 1000);
-    EXPECT_TRUE(checkedOutput);
+    gz::physics::ForwardStep::Input input;
+    world->StepAsync(input).wait();
+    double lastZ = link->FrameDataRelativeToWorld().pose.translation().z();
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      // The output of a step stays readable while the next one runs
+      const auto &output = world->FinishStep();
+      world->StepAsync(input);
+      // TPE has no gravity, the other engines let the sphere fall
+      const double z = sphereZ(output);
+      EXPECT_LE(z, lastZ);
+      lastZ = z;
+    }
 
-    const std::vector<gz::physics::WorldPose> worldPoses =
-      output.template Get<gz::physics::WorldPoses>().entries;
+    const double z = sphereZ(world->FinishStep());
+    EXPECT_LE(z, lastZ);
+    EXPECT_NEAR(z, link->FrameDataRelativeToWorld().pose.translation().z(),
+                1e-9);
+  }
+}
 
-    ASSERT_GE(worldPoses.size(), 1);
-    const auto link = world->GetModel(0)->GetLink("sphere_link");
+// The features that an engine must have to be loaded by this loader.
+struct FeaturesStepFromState : public gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::ForwardStep,
+  gz::physics::WorldStateSnapshotFeature
+> {};
 
-    // get the pose of the link from the list of worldPoses
+template <class T>
+class SimulationFeaturesStepFromStateTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesStepFromStateTestTypes =
+  ::testing::Types<FeaturesStepFromState>;
+TYPED_TEST_SUITE(SimulationFeaturesStepFromStateTest,
+                 SimulationFeaturesStepFromStateTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesStepFromStateTest, StepFromState)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesStepFromState>(
+        this->loader, name, common_test::worlds::kFallingWorld);
+    ASSERT_NE(nullptr, world);
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+
+    gz::physics::ForwardStep::Input input;
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State liveState;
+    for (std::size_t i = 0; i < 200; ++i)
+      world->Step(output, liveState, input);
+    const auto startPose = link->FrameDataRelativeToWorld().pose;
+
+    // Step ahead from a snapshot of the current state without changing the
+    // world.
+    gz::physics::ForwardStep::State state;
+    auto &snapshot = state.Get<gz::physics::WorldStateSnapshot>();
+    snapshot.snapshot = world->SaveState();
+    snapshot.preserveWorld = true;
+    for (std::size_t i = 0; i < 300; ++i)
+      world->Step(output, state, input);
+    EXPECT_FALSE(snapshot.snapshot.empty());
+    EXPECT_TRUE(startPose.isApprox(
+        link->FrameDataRelativeToWorld().pose, 1e-9));
+
+    // The outputs describe the stepped state.
+    const auto &worldPoses = output.Get<gz::physics::WorldPoses>().entries;
     auto poseIt = std::find_if(worldPoses.begin(), worldPoses.end(),
         [&](const auto &_wPose)
         { return _wPose.body == link->EntityID(); });
     ASSERT_NE(poseIt, worldPoses.end());
-    auto pos = poseIt->pose.Pos();
-    EXPECT_NEAR(pos.Z(), 1.0, 5e-2);
+    const auto aheadPose = gz::math::eigen3::convert(poseIt->pose);
+
+    // Stepping the world itself reaches the same state.
+    for (std::size_t i = 0; i < 300; ++i)
+      world->Step(output, liveState, input);
+    const auto endPose = link->FrameDataRelativeToWorld().pose;
+    EXPECT_TRUE(endPose.isApprox(aheadPose, 1e-6));
+    // TPE does not simulate gravity.
+    if (this->PhysicsEngineName(name) != "tpe")
+      EXPECT_FALSE(endPose.isApprox(startPose, 1e-3));
+
+    // Without preserveWorld, the world rewinds to the given state and steps
+    // on from there.
+    const auto rewindTo = world->SaveState();
+    for (std::size_t i = 0; i < 50; ++i)
+      world->Step(output, liveState, input);
+    snapshot.snapshot = rewindTo;
+    snapshot.preserveWorld = false;
+    world->Step(output, state, input);
+    const auto rewoundPose = link->FrameDataRelativeToWorld().pose;
+
+    EXPECT_TRUE(world->RestoreState(rewindTo));
+    world->Step(output, liveState, input);
+    EXPECT_TRUE(rewoundPose.isApprox(
+        link->FrameDataRelativeToWorld().pose, 1e-9));
   }
 }
 
-
 // The features that an engine must have to be loaded by this loader.
 struct FeaturesShapeFeatures : gz::physics::FeatureList<
   gz::physics::sdf::ConstructSdfWorld,
@@ -1195,6 +3183,116 @@ TYPED_TEST(SimulationFeaturesTestFeaturesContactPropertiesCallback, ContactPrope
   }
 }
 
+#ifdef DART_HAS_CONTACT_SURFACE
+struct FeaturesContactPropertiesBatchCallback : gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::GetShapeFromLink,
+  gz::physics::GetContactsFromLastStepFeature,
+  gz::physics::SetContactPropertiesBatchCallbackFeature,
+  gz::physics::ForwardStep
+> {};
+
+template <class T>
+class SimulationFeaturesContactPropertiesBatchCallbackTest :
+  public SimulationFeaturesTest<T>{};
+using SimulationFeaturesContactPropertiesBatchCallbackTestTypes =
+  ::testing::Types<FeaturesContactPropertiesBatchCallback>;
+TYPED_TEST_SUITE(SimulationFeaturesContactPropertiesBatchCallbackTest,
+                 SimulationFeaturesContactPropertiesBatchCallbackTestTypes);
+
+/////////////////////////////////////////////////
+TYPED_TEST(SimulationFeaturesContactPropertiesBatchCallbackTest,
+           ContactPropertiesBatchCallback)
+{
+  using World =
+    gz::physics::World3d<FeaturesContactPropertiesBatchCallback>;
+  using BatchParams = gz::physics::SetContactPropertiesBatchCallbackFeature::
+    ContactSurfaceParams<World::Policy>;
+
+  for (const std::string &name : this->pluginNames)
+  {
+    auto world = LoadPluginAndWorld<FeaturesContactPropertiesBatchCallback>(
+      this->loader,
+      name,
+      common_test::worlds::kContactSdf);
+
+    auto groundPlane = world->GetModel("ground_plane");
+    const std::size_t groundPlaneID =
+      groundPlane->GetLink(0)->GetShape(0)->EntityID();
+
+    std::size_t numBatchCalls = 0u;
+    std::size_t numContacts = 0u;
+    auto batchCallback = [&](
+        const World::ContactSurfaceBatch &_contacts,
+        BatchParams *_surfaceParams)
+    {
+      ++numBatchCalls;
+      numContacts = _contacts.size;
+      for (std::size_t i = 0; i < _contacts.size; ++i)
+      {
+        EXPECT_TRUE(_contacts.collision1[i] == groundPlaneID ||
+                    _contacts.collision2[i] == groundPlaneID);
+        EXPECT_NE(_contacts.collision1[i], _contacts.collision2[i]);
+        EXPECT_EQ(1u, _contacts.numContactsOnCollision[i]);
+        EXPECT_NEAR(1.0, std::abs(_contacts.normal[i].z()), 1e-3);
+
+        // The parameters are pre-filled like those of the per-contact
+        // callback
+        ASSERT_TRUE(_surfaceParams[i].frictionCoeff.has_value());
+        EXPECT_NEAR(_surfaceParams[i].frictionCoeff.value(), 1.0, 1e-6);
+        ASSERT_TRUE(
+          _surfaceParams[i].contactSurfaceMotionVelocity.has_value());
+        _surfaceParams[i].contactSurfaceMotionVelocity->x() = 1.0;
+      }
+    };
+    world->AddContactPropertiesBatchCallback("batch", batchCallback);
+
+    // The callback is called once per step with the 4 contacts of the links
+    // of the sphere model on the ground plane
+    StepWorld<FeaturesContactPropertiesBatchCallback>(world, true);
+    EXPECT_EQ(1u, numBatchCalls);
+    EXPECT_EQ(4u, numContacts);
+
+    StepWorld<FeaturesContactPropertiesBatchCallback>(world, false);
+    EXPECT_EQ(2u, numBatchCalls);
+    EXPECT_EQ(4u, numContacts);
+
+    // The altered surface velocity accelerates the contacts along Z, so the
+    // contact forces exceed the weight of the links, see
+    // ContactPropertiesCallback
+    const double gravity = 9.8;
+    const std::map<std::string, double> weights
+    {
+      {"link0", 0.1 * gravity},
+      {"link1", 1.0 * gravity},
+      {"link2", 2.0 * gravity},
+      {"link3", 3.0 * gravity},
+    };
+    const auto contacts = world->GetContactsFromLastStep();
+    EXPECT_EQ(4u, contacts.size());
+    for (const auto &contact : contacts)
+    {
+      const auto &contactPoint = contact.Get<World::ContactPoint>();
+      const auto *extraContactData = contact.Query<World::ExtraContactData>();
+      ASSERT_NE(nullptr, extraContactData);
+      auto collision = contactPoint.collision1;
+      if (collision->EntityID() == groundPlaneID)
+        collision = contactPoint.collision2;
+      EXPECT_GT(extraContactData->force.z(),
+                weights.at(collision->GetLink()->GetName()) + 50.0);
+    }
+
+    EXPECT_FALSE(world->RemoveContactPropertiesBatchCallback("foo"));
+    EXPECT_TRUE(world->RemoveContactPropertiesBatchCallback("batch"));
+
+    StepWorld<FeaturesContactPropertiesBatchCallback>(world, false);
+    EXPECT_EQ(2u, numBatchCalls);
+  }
+}
+#endif
+
 TYPED_TEST(SimulationFeaturesTestBasic, MultipleCollisions)
 {
   for (const std::string &name : this->pluginNames)
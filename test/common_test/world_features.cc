@@ -16,6 +16,13 @@
 */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
 #include <gz/common/Console.hh>
 #include <gz/plugin/Loader.hh>
 
@@ -23,11 +30,16 @@
 #include "test/Utils.hh"
 #include "Worlds.hh"
 
+#include <gz/physics/AllocationCounter.hh>
 #include <gz/physics/ConstructEmpty.hh>
 #include <gz/physics/FindFeatures.hh>
+#include <gz/physics/FixedJoint.hh>
+#include <gz/physics/FreeGroup.hh>
 #include <gz/physics/ForwardStep.hh>
 #include <gz/physics/FrameSemantics.hh>
 #include <gz/physics/GetEntities.hh>
+#include <gz/physics/Joint.hh>
+#include <gz/physics/Link.hh>
 #include <gz/physics/RemoveEntities.hh>
 #include <gz/physics/RequestEngine.hh>
 
@@ -37,6 +49,8 @@
 #include <gz/physics/sdf/ConstructModel.hh>
 #include <gz/physics/sdf/ConstructNestedModel.hh>
 #include <gz/physics/sdf/ConstructWorld.hh>
+#include <gz/physics/sdf/LoadReport.hh>
+#include <gz/physics/sdf/StreamSdfModels.hh>
 
 #include <sdf/Root.hh>
 
@@ -457,6 +471,1335 @@ TEST_F(WorldNestedModelTest, WorldConstructNestedModel)
   }
 }
 
+struct BroadphaseFeatures : gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::Broadphase,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::ForwardStep
+> { };
+
+using WorldFeaturesTestBroadphase = WorldFeaturesTest<BroadphaseFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestBroadphase, Broadphase)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<BroadphaseFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    for (const std::string broadphase : {"dbvt", "axis_sweep", "simple"})
+    {
+      sdf::Root root;
+      const sdf::Errors errors =
+        root.Load(common_test::worlds::kFallingWorld);
+      EXPECT_TRUE(errors.empty()) << errors;
+
+      auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+      ASSERT_NE(nullptr, world);
+      EXPECT_EQ("dbvt", world->GetBroadphase());
+
+      world->SetBroadphase("banana");
+      EXPECT_EQ("dbvt", world->GetBroadphase());
+
+      // The broadphase is replaced after the models were added, so the
+      // existing objects have to keep colliding.
+      world->SetBroadphase(broadphase);
+      EXPECT_EQ(broadphase, world->GetBroadphase());
+
+      auto link = world->GetModel("sphere")->GetLink(0);
+      ASSERT_NE(nullptr, link);
+
+      gz::physics::ForwardStep::Output output;
+      gz::physics::ForwardStep::State state;
+      gz::physics::ForwardStep::Input input;
+      for (std::size_t i = 0; i < 2000; ++i)
+      {
+        world->Step(output, state, input);
+      }
+
+      // The sphere of radius 1 comes to rest on top of the ground box
+      EXPECT_NEAR(1.0,
+        link->FrameDataRelativeToWorld().pose.translation().z(), 0.1)
+        << broadphase;
+    }
+  }
+}
+
+struct NumThreadsFeatures : gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::NumThreads,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::ForwardStep
+> { };
+
+using WorldFeaturesTestNumThreads = WorldFeaturesTest<NumThreadsFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestNumThreads, NumThreads)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<NumThreadsFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kFallingWorld);
+    EXPECT_TRUE(errors.empty()) << errors;
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+    EXPECT_EQ(1u, world->GetNumThreads());
+
+    world->SetNumThreads(4u);
+    EXPECT_EQ(4u, world->GetNumThreads());
+
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+    const double initialZ =
+      link->FrameDataRelativeToWorld().pose.translation().z();
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+    }
+    EXPECT_LT(link->FrameDataRelativeToWorld().pose.translation().z(),
+              initialZ);
+
+    world->SetNumThreads(0u);
+    EXPECT_EQ(1u, world->GetNumThreads());
+    world->Step(output, state, input);
+  }
+}
+
+struct SolverProfileFeatures : gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::SolverProfile,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::ForwardStep
+> { };
+
+using WorldFeaturesTestSolverProfile =
+  WorldFeaturesTest<SolverProfileFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestSolverProfile, SolverProfile)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<SolverProfileFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kFallingWorld);
+    EXPECT_TRUE(errors.empty()) << errors;
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    world->SetSolverIterations(20u);
+    EXPECT_EQ(20u, world->GetSolverIterations());
+
+    world->SetSolverTolerance(1e-4);
+    EXPECT_NEAR(1e-4, world->GetSolverTolerance(), 1e-9);
+    world->SetSolverTolerance(-1.0);
+    EXPECT_DOUBLE_EQ(0.0, world->GetSolverTolerance());
+
+    world->SetSolverWarmStarting(false);
+    EXPECT_FALSE(world->GetSolverWarmStarting());
+    world->SetSolverSplitImpulse(false);
+    EXPECT_FALSE(world->GetSolverSplitImpulse());
+
+    // Only bullet-featherstone supports split impulses, and only it and
+    // dartsim support warm starting
+    const bool supported =
+      this->PhysicsEngineName(name) == "bullet-featherstone";
+    world->SetSolverWarmStarting(true);
+    EXPECT_EQ(supported || this->PhysicsEngineName(name) == "dartsim",
+              world->GetSolverWarmStarting());
+    world->SetSolverSplitImpulse(true);
+    EXPECT_EQ(supported, world->GetSolverSplitImpulse());
+
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 2000; ++i)
+    {
+      world->Step(output, state, input);
+    }
+
+    // The sphere of radius 1 comes to rest on top of the ground box
+    EXPECT_NEAR(1.0,
+      link->FrameDataRelativeToWorld().pose.translation().z(), 0.1);
+  }
+}
+
+struct PenaltyContactFeatures : gz::physics::FeatureList<
+  gz::physics::PenaltyContactFeature,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::ForwardStep
+> { };
+
+using WorldFeaturesTestPenaltyContact =
+  WorldFeaturesTest<PenaltyContactFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestPenaltyContact, PenaltyContact)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<PenaltyContactFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kFallingWorld);
+    EXPECT_TRUE(errors.empty()) << errors;
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+    EXPECT_DOUBLE_EQ(0.0, world->GetPenaltyContact().stiffness);
+
+    // A critically damped spring for the sphere of 1 kg
+    gz::physics::PenaltyContactFeature::Parameters parameters;
+    parameters.stiffness = 1e4;
+    parameters.damping = 200.0;
+    world->SetPenaltyContact(parameters);
+    EXPECT_DOUBLE_EQ(parameters.stiffness,
+                     world->GetPenaltyContact().stiffness);
+    EXPECT_DOUBLE_EQ(parameters.damping, world->GetPenaltyContact().damping);
+
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 3000; ++i)
+    {
+      world->Step(output, state, input);
+    }
+
+    // The sphere of radius 1 rests on the ground box, sunk into it until
+    // the spring carries its weight
+    const double sink = 9.8 / parameters.stiffness;
+    EXPECT_NEAR(1.0 - sink,
+      link->FrameDataRelativeToWorld().pose.translation().z(), 0.2 * sink);
+
+    parameters.stiffness = 0.0;
+    world->SetPenaltyContact(parameters);
+    EXPECT_DOUBLE_EQ(0.0, world->GetPenaltyContact().stiffness);
+  }
+}
+
+struct SubStepsFeatures : gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::SubSteps,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::ForwardStep
+> { };
+
+using WorldFeaturesTestSubSteps = WorldFeaturesTest<SubStepsFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestSubSteps, SubSteps)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<SubStepsFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kFallingWorld);
+    EXPECT_TRUE(errors.empty()) << errors;
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    EXPECT_EQ(1u, world->GetSubSteps());
+    world->SetSubSteps(0u);
+    EXPECT_EQ(1u, world->GetSubSteps());
+    world->SetSubSteps(4u);
+    EXPECT_EQ(4u, world->GetSubSteps());
+
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+    const double z0 = link->FrameDataRelativeToWorld().pose.translation().z();
+
+    // Each step still advances the world by the step size, so the sphere
+    // falls freely for 0.1 s before it reaches the ground.
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    input.Get<std::chrono::steady_clock::duration>() =
+        std::chrono::milliseconds(1);
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+    }
+
+    const double t = 0.1;
+    EXPECT_NEAR(z0 - 0.5 * 9.8 * t * t,
+      link->FrameDataRelativeToWorld().pose.translation().z(), 1e-3);
+  }
+}
+
+struct AdaptiveTimeStepFeatures : gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::AdaptiveTimeStepFeature,
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetLinkFromModel,
+  gz::physics::ForwardStep
+> { };
+
+using WorldFeaturesTestAdaptiveTimeStep =
+  WorldFeaturesTest<AdaptiveTimeStepFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestAdaptiveTimeStep, AdaptiveTimeStep)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<AdaptiveTimeStepFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kFallingWorld);
+    EXPECT_TRUE(errors.empty()) << errors;
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+    EXPECT_DOUBLE_EQ(0.0, world->GetLastStepSize());
+    EXPECT_DOUBLE_EQ(0.0, world->GetAdaptiveTimeStep().maxStepSize);
+
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+    const double z0 = link->FrameDataRelativeToWorld().pose.translation().z();
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    input.Get<std::chrono::steady_clock::duration>() =
+        std::chrono::milliseconds(1);
+
+    // Without adaptive stepping every step has the given length
+    world->Step(output, state, input);
+    EXPECT_DOUBLE_EQ(0.001, world->GetLastStepSize());
+
+    gz::physics::AdaptiveTimeStepFeature::Parameters parameters;
+    parameters.maxStepSize = 0.01;
+    parameters.targetVelocityChange = 0.1;
+    world->SetAdaptiveTimeStep(parameters);
+    EXPECT_DOUBLE_EQ(0.01, world->GetAdaptiveTimeStep().maxStepSize);
+
+    // Free fall changes the velocity by 9.8 m/s^2 times the step, so the
+    // steps grow to about 8 ms, which is much fewer steps to reach the
+    // ground than the 1 ms steps that were given.
+    double t = 0.001;
+    std::size_t steps = 0;
+    double longest = 0.0;
+    while (t < 0.08)
+    {
+      world->Step(output, state, input);
+      const double stepSize = world->GetLastStepSize();
+      EXPECT_LE(0.001 - 1e-9, stepSize);
+      EXPECT_GE(0.01 + 1e-9, stepSize);
+      longest = std::max(longest, stepSize);
+      t += stepSize;
+      ++steps;
+    }
+    EXPECT_LT(steps, 40u);
+    EXPECT_LT(0.005, longest);
+
+    // The reported step lengths add up to the simulated time
+    EXPECT_NEAR(z0 - 0.5 * 9.8 * t * t,
+      link->FrameDataRelativeToWorld().pose.translation().z(), 1e-2);
+
+    // The impact shortens the steps, and the sphere comes to rest on top of
+    // the ground box
+    double shortest = longest;
+    while (t < 2.0)
+    {
+      world->Step(output, state, input);
+      shortest = std::min(shortest, world->GetLastStepSize());
+      t += world->GetLastStepSize();
+    }
+    EXPECT_GT(longest, shortest);
+    EXPECT_NEAR(1.0,
+      link->FrameDataRelativeToWorld().pose.translation().z(), 0.1);
+
+    // Disabling adaptive stepping goes back to the given step
+    world->SetAdaptiveTimeStep(
+        gz::physics::AdaptiveTimeStepFeature::Parameters());
+    world->Step(output, state, input);
+    EXPECT_DOUBLE_EQ(0.001, world->GetLastStepSize());
+  }
+}
+
+struct CommandBufferFeatures : gz::physics::FeatureList<
+  gz::physics::AddLinkExternalForceTorque,
+  gz::physics::ForwardStep,
+  gz::physics::GetBasicJointState,
+  gz::physics::GetJointFromModel,
+  gz::physics::GetLinkFromModel,
+  gz::physics::GetModelFromWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::SetBasicJointState,
+  gz::physics::WorldCommandBufferFeature,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestCommandBuffer =
+  WorldFeaturesTest<CommandBufferFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestCommandBuffer, ApplyCommands)
+{
+  using Command = gz::physics::WorldCommandBufferFeature::Command;
+  using CommandType = gz::physics::WorldCommandBufferFeature::CommandType;
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+
+    // One world is driven through the entities and the other through the
+    // command buffer. Both must end up in the same state.
+    auto engineEntity = gz::physics::RequestEngine3d<CommandBufferFeatures>::
+      From(this->loader.Instantiate(name));
+    auto engineBuffer = gz::physics::RequestEngine3d<CommandBufferFeatures>::
+      From(this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engineEntity);
+    ASSERT_NE(nullptr, engineBuffer);
+
+    sdf::Root pendulumRoot;
+    EXPECT_TRUE(pendulumRoot.Load(
+      common_test::worlds::kPendulumJointWrenchSdf).empty());
+    sdf::Root fallingRoot;
+    EXPECT_TRUE(fallingRoot.Load(common_test::worlds::kFallingWorld).empty());
+
+    auto pendulumEntity =
+      engineEntity->ConstructWorld(*pendulumRoot.WorldByIndex(0));
+    auto pendulumBuffer =
+      engineBuffer->ConstructWorld(*pendulumRoot.WorldByIndex(0));
+    auto fallingEntity =
+      engineEntity->ConstructWorld(*fallingRoot.WorldByIndex(0));
+    auto fallingBuffer =
+      engineBuffer->ConstructWorld(*fallingRoot.WorldByIndex(0));
+    ASSERT_NE(nullptr, pendulumEntity);
+    ASSERT_NE(nullptr, pendulumBuffer);
+    ASSERT_NE(nullptr, fallingEntity);
+    ASSERT_NE(nullptr, fallingBuffer);
+
+    auto jointEntity =
+      pendulumEntity->GetModel("pendulum")->GetJoint("motor_joint");
+    auto jointBuffer =
+      pendulumBuffer->GetModel("pendulum")->GetJoint("motor_joint");
+    // The center of mass of the sphere is at its link origin.
+    auto linkEntity = fallingEntity->GetModel("sphere")->GetLink(0);
+    auto linkBuffer = fallingBuffer->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, jointEntity);
+    ASSERT_NE(nullptr, jointBuffer);
+    ASSERT_NE(nullptr, linkEntity);
+    ASSERT_NE(nullptr, linkBuffer);
+
+    // Joint commands are given out of order and mixed with a link of another
+    // world and an unknown entity, which must be skipped. The last force
+    // given to a DOF wins.
+    const std::vector<Command> jointCommands = {
+      {jointBuffer->EntityID(), 0u, CommandType::JOINT_FORCE, 1.0},
+      {linkBuffer->EntityID(), 0u, CommandType::LINK_FORCE, 10.0},
+      {std::numeric_limits<std::size_t>::max(), 0u,
+       CommandType::JOINT_FORCE, 1.0},
+      {jointBuffer->EntityID(), 0u, CommandType::JOINT_FORCE, 2.0}
+    };
+    const std::vector<Command> linkCommands = {
+      {linkBuffer->EntityID(), 1u, CommandType::LINK_FORCE, 20.0},
+      {linkBuffer->EntityID(), 0u, CommandType::LINK_FORCE, 10.0},
+      {linkBuffer->EntityID(), 3u, CommandType::LINK_FORCE, 10.0}
+    };
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      jointEntity->SetForce(0, 2.0);
+      linkEntity->AddExternalForce(Eigen::Vector3d(10.0, 20.0, 0.0));
+      pendulumEntity->Step(output, state, input);
+      fallingEntity->Step(output, state, input);
+
+      gz::common::Console::SetVerbosity(0);
+      pendulumBuffer->ApplyCommands(jointCommands);
+      fallingBuffer->ApplyCommands(linkCommands);
+      gz::common::Console::SetVerbosity(4);
+      pendulumBuffer->Step(output, state, input);
+      fallingBuffer->Step(output, state, input);
+    }
+
+    EXPECT_GT(std::abs(jointEntity->GetVelocity(0)), 1e-3);
+    EXPECT_NEAR(jointEntity->GetPosition(0), jointBuffer->GetPosition(0),
+                1e-6);
+    EXPECT_NEAR(jointEntity->GetVelocity(0), jointBuffer->GetVelocity(0),
+                1e-6);
+
+    const auto poseEntity = linkEntity->FrameDataRelativeToWorld().pose;
+    const auto poseBuffer = linkBuffer->FrameDataRelativeToWorld().pose;
+    EXPECT_GT(poseEntity.translation().y(), 0.1);
+    EXPECT_TRUE(poseEntity.isApprox(poseBuffer, 1e-6));
+  }
+}
+
+struct CloneWorldFeatures : gz::physics::FeatureList<
+  gz::physics::CloneWorldFeature,
+  gz::physics::ForwardStep,
+  gz::physics::GetLinkFromModel,
+  gz::physics::GetModelFromWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestCloneWorld = WorldFeaturesTest<CloneWorldFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestCloneWorld, Clone)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+
+    auto engine = gz::physics::RequestEngine3d<CloneWorldFeatures>::From(
+      this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 50; ++i)
+      world->Step(output, state, input);
+
+    // The name of the clone must be unique.
+    EXPECT_EQ(nullptr, world->Clone(world->GetName()));
+
+    auto clone = world->Clone("falling_clone");
+    ASSERT_NE(nullptr, clone);
+    EXPECT_EQ("falling_clone", clone->GetName());
+    ASSERT_EQ(world->GetModelCount(), clone->GetModelCount());
+    for (std::size_t i = 0; i < world->GetModelCount(); ++i)
+    {
+      auto model = world->GetModel(i);
+      auto modelClone = clone->GetModel(model->GetName());
+      ASSERT_NE(nullptr, modelClone);
+      EXPECT_EQ(model->GetLinkCount(), modelClone->GetLinkCount());
+    }
+
+    auto link = world->GetModel("sphere")->GetLink(0);
+    auto linkClone = clone->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+    ASSERT_NE(nullptr, linkClone);
+    EXPECT_NE(link->EntityID(), linkClone->EntityID());
+
+    // The clone starts from the state of the source world, and both evolve
+    // in the same way afterwards.
+    EXPECT_TRUE(link->FrameDataRelativeToWorld().pose.isApprox(
+      linkClone->FrameDataRelativeToWorld().pose, 1e-9));
+    for (std::size_t i = 0; i < 500; ++i)
+    {
+      world->Step(output, state, input);
+      clone->Step(output, state, input);
+    }
+
+    const auto pose = link->FrameDataRelativeToWorld().pose;
+    EXPECT_TRUE(pose.isApprox(
+      linkClone->FrameDataRelativeToWorld().pose, 1e-6));
+    EXPECT_LT(pose.translation().z(), 1.9);
+  }
+}
+
+struct StepStatisticsFeatures : gz::physics::FeatureList<
+  gz::physics::ForwardStep,
+  gz::physics::GetStepStatisticsFeature,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestStepStatistics =
+  WorldFeaturesTest<StepStatisticsFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestStepStatistics, GetStepStatistics)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+
+    auto engine = gz::physics::RequestEngine3d<StepStatisticsFeatures>::From(
+      this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    auto stats = world->GetStepStatistics();
+    EXPECT_DOUBLE_EQ(0.0, stats.stepTime);
+    EXPECT_EQ(0u, stats.contactCount);
+
+    // Step until the sphere rests on the ground.
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 1000; ++i)
+      world->Step(output, state, input);
+
+    stats = world->GetStepStatistics();
+    EXPECT_GT(stats.stepTime, 0.0);
+    for (const double time : {stats.broadphaseTime, stats.narrowphaseTime,
+      stats.solverTime, stats.integrationTime, stats.poseWriteTime})
+    {
+      EXPECT_GE(time, 0.0);
+    }
+    EXPECT_LE(stats.broadphaseTime + stats.narrowphaseTime +
+      stats.solverTime + stats.integrationTime + stats.poseWriteTime,
+      stats.stepTime + 1e-6);
+
+    // tpe does not simulate gravity, so the sphere never lands there.
+    if (this->PhysicsEngineName(name) != "tpe")
+    {
+      EXPECT_GT(stats.contactCount, 0u);
+      EXPECT_GE(stats.islandCount, 1u);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestStepStatistics, SteadyStateAllocations)
+{
+  if (!gz::physics::AllocationCountingEnabled())
+    GTEST_SKIP() << "Built without ENABLE_ALLOCATION_COUNTER";
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+
+    auto engine = gz::physics::RequestEngine3d<StepStatisticsFeatures>::From(
+      this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    // Step until the sphere rests on the ground, which also sizes the
+    // buffers that are reused by later steps.
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 1000; ++i)
+      world->Step(output, state, input);
+
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      world->Step(output, state, input);
+      const auto stats = world->GetStepStatistics();
+      EXPECT_LE(stats.broadphaseAllocations + stats.narrowphaseAllocations +
+        stats.solverAllocations + stats.integrationAllocations +
+        stats.poseWriteAllocations, stats.stepAllocations);
+
+      // The poses are written into the buffers of the output. The whole
+      // step of tpe does not allocate, while the contacts and constraints of
+      // dartsim and bullet-featherstone are managed by the engines.
+      EXPECT_EQ(0u, stats.poseWriteAllocations) << i;
+      if (this->PhysicsEngineName(name) == "tpe")
+        EXPECT_EQ(0u, stats.stepAllocations) << i;
+    }
+  }
+}
+
+struct ModelStepStatisticsFeatures : gz::physics::FeatureList<
+  gz::physics::ForwardStep,
+  gz::physics::GetStepStatisticsFeature,
+  gz::physics::GetModelStepStatisticsFeature,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestModelStepStatistics =
+  WorldFeaturesTest<ModelStepStatisticsFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestModelStepStatistics, GetModelStepStatistics)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+
+    auto engine =
+      gz::physics::RequestEngine3d<ModelStepStatisticsFeatures>::From(
+        this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    // Nothing is collected until it is enabled
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    world->Step(output, state, input);
+    EXPECT_TRUE(world->GetModelStepStatistics().empty());
+
+    // Step until the sphere rests on the ground.
+    world->SetModelStepStatisticsEnabled(true);
+    for (std::size_t i = 0; i < 1000; ++i)
+      world->Step(output, state, input);
+
+    const auto models = world->GetModelStepStatistics();
+    std::size_t contactCount = 0u;
+    std::size_t constraintRowCount = 0u;
+    for (std::size_t i = 0; i < models.size(); ++i)
+    {
+      if (i > 0)
+        EXPECT_LT(models[i - 1].model, models[i].model);
+      EXPECT_GE(models[i].narrowphaseTime, 0.0);
+      contactCount += models[i].contactCount;
+      constraintRowCount += models[i].constraintRowCount;
+    }
+
+    // tpe does not simulate gravity, so the sphere never lands there.
+    if (this->PhysicsEngineName(name) != "tpe")
+    {
+      EXPECT_FALSE(models.empty());
+      EXPECT_GE(contactCount, world->GetStepStatistics().contactCount);
+      EXPECT_GT(constraintRowCount, 0u);
+    }
+
+    world->SetModelStepStatisticsEnabled(false);
+    world->Step(output, state, input);
+    EXPECT_TRUE(world->GetModelStepStatistics().empty());
+  }
+}
+
+struct SolverStatisticsFeatures : gz::physics::FeatureList<
+  gz::physics::ForwardStep,
+  gz::physics::GetSolverStatisticsFeature,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestSolverStatistics =
+  WorldFeaturesTest<SolverStatisticsFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestSolverStatistics, GetSolverStatistics)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+
+    auto engine =
+      gz::physics::RequestEngine3d<SolverStatisticsFeatures>::From(
+        this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    // Nothing is collected until it is enabled
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    world->Step(output, state, input);
+    EXPECT_EQ(0u, world->GetSolverStatistics().solveCount);
+
+    // Step until the sphere rests on the ground, which adds contact rows
+    world->SetSolverStatisticsEnabled(true);
+    for (std::size_t i = 0; i < 1000; ++i)
+      world->Step(output, state, input);
+
+    auto stats = world->GetSolverStatistics();
+    EXPECT_GT(stats.solveCount, 0u);
+    EXPECT_GT(stats.contactRowCount, 0u);
+    EXPECT_GE(stats.residual, 0.0);
+    EXPECT_EQ(0u, stats.failureCount);
+
+    // dartsim solves the LCP directly, bullet-featherstone iterates
+    if (this->PhysicsEngineName(name) == "dartsim")
+      EXPECT_LT(stats.residual, 1e-6);
+    if (this->PhysicsEngineName(name) == "bullet-featherstone")
+      EXPECT_GT(stats.iterations, 0u);
+
+    // Only the last step is reported, which solves the one island
+    world->Step(output, state, input);
+    EXPECT_EQ(1u, world->GetSolverStatistics().solveCount);
+
+    world->SetSolverStatisticsEnabled(false);
+    world->Step(output, state, input);
+    stats = world->GetSolverStatistics();
+    EXPECT_EQ(0u, stats.solveCount);
+    EXPECT_EQ(0u, stats.contactRowCount);
+  }
+}
+
+struct LoadReportFeatures : gz::physics::FeatureList<
+  gz::physics::sdf::ConstructSdfWorld,
+  gz::physics::sdf::GetSdfLoadReport
+> { };
+
+using WorldFeaturesTestLoadReport =
+  WorldFeaturesTest<LoadReportFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestLoadReport, GetLoadReport)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+
+    auto engine = gz::physics::RequestEngine3d<LoadReportFeatures>::From(
+      this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(common_test::worlds::kShapesWorld).empty());
+    const sdf::World *sdfWorld = root.WorldByIndex(0);
+    ASSERT_NE(nullptr, sdfWorld);
+    auto world = engine->ConstructWorld(*sdfWorld);
+    ASSERT_NE(nullptr, world);
+
+    // Every model of the world is listed once, in order.
+    const auto report = world->GetLoadReport();
+    ASSERT_EQ(sdfWorld->ModelCount(), report.models.size());
+    double shapeCreationTime = 0.0;
+    for (std::size_t i = 0; i < report.models.size(); ++i)
+    {
+      const auto &model = report.models[i];
+      EXPECT_EQ(sdfWorld->ModelByIndex(i)->Name(), model.name);
+      for (const double time : {model.times.sdfResolutionTime,
+        model.times.meshLoadTime, model.times.convexDecompositionTime,
+        model.times.shapeCreationTime, model.times.engineInsertionTime})
+      {
+        EXPECT_GE(time, 0.0);
+      }
+      EXPECT_GT(model.times.TotalTime(), 0.0);
+      shapeCreationTime += model.times.shapeCreationTime;
+    }
+    EXPECT_GT(shapeCreationTime, 0.0);
+    EXPECT_GE(report.worldTimes.TotalTime(), 0.0);
+  }
+}
+
+struct MemoryUsageFeatures : gz::physics::FeatureList<
+  gz::physics::ForwardStep,
+  gz::physics::GetMemoryUsageFeature,
+  gz::physics::sdf::ConstructSdfModel,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestMemoryUsage =
+  WorldFeaturesTest<MemoryUsageFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestMemoryUsage, GetMemoryUsage)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+
+    auto engine = gz::physics::RequestEngine3d<MemoryUsageFeatures>::From(
+      this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(common_test::worlds::kShapesWorld).empty());
+    const sdf::World *sdfWorld = root.WorldByIndex(0);
+    ASSERT_NE(nullptr, sdfWorld);
+    auto world = engine->ConstructWorld(*sdfWorld);
+    ASSERT_NE(nullptr, world);
+
+    const auto usage = world->GetMemoryUsage();
+    EXPECT_GT(usage.geometryBytes, 0u);
+    EXPECT_GT(usage.entityBytes, 0u);
+    EXPECT_EQ(usage.geometryBytes + usage.entityBytes + usage.solverBytes,
+      usage.TotalBytes());
+
+    // A copy of a model adds its bookkeeping
+    sdf::Model sdfModel = *sdfWorld->ModelByIndex(1);
+    sdfModel.SetName("memory_usage_copy");
+    ASSERT_NE(nullptr, world->ConstructModel(sdfModel));
+    const auto grown = world->GetMemoryUsage();
+    EXPECT_GT(grown.entityBytes, usage.entityBytes);
+    EXPECT_GE(grown.geometryBytes, usage.geometryBytes);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+    for (std::size_t i = 0; i < 10; ++i)
+      world->Step(output, state, input);
+    EXPECT_GT(world->GetMemoryUsage().TotalBytes(), 0u);
+  }
+}
+
+struct StateSnapshotFeatures : gz::physics::FeatureList<
+  gz::physics::ForwardStep,
+  gz::physics::GetLinkFromModel,
+  gz::physics::GetModelFromWorld,
+  gz::physics::LinkFrameSemantics,
+  gz::physics::WorldStateSnapshotFeature,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestStateSnapshot =
+  WorldFeaturesTest<StateSnapshotFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestStateSnapshot, SaveRestore)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+
+    auto engine = gz::physics::RequestEngine3d<StateSnapshotFeatures>::From(
+      this->loader.Instantiate(name));
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(common_test::worlds::kFallingWorld).empty());
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+    auto link = world->GetModel("sphere")->GetLink(0);
+    ASSERT_NE(nullptr, link);
+
+    gz::physics::ForwardStep::Output output;
+    gz::physics::ForwardStep::State state;
+    gz::physics::ForwardStep::Input input;
+
+    // Save the state just before the sphere lands, so contacts are part of
+    // what is restored.
+    for (std::size_t i = 0; i < 400; ++i)
+      world->Step(output, state, input);
+    const auto snapshot = world->SaveState();
+    EXPECT_FALSE(snapshot.empty());
+    const auto savedPose = link->FrameDataRelativeToWorld().pose;
+
+    for (std::size_t i = 0; i < 500; ++i)
+      world->Step(output, state, input);
+    const auto firstPose = link->FrameDataRelativeToWorld().pose;
+    // tpe does not simulate gravity, so the sphere does not move there.
+    if (this->PhysicsEngineName(name) != "tpe")
+      EXPECT_FALSE(firstPose.isApprox(savedPose, 1e-3));
+
+    EXPECT_TRUE(world->RestoreState(snapshot));
+    EXPECT_TRUE(link->FrameDataRelativeToWorld().pose.isApprox(
+      savedPose, 1e-9));
+
+    // Stepping again from the restored state gives the same result.
+    for (std::size_t i = 0; i < 500; ++i)
+      world->Step(output, state, input);
+    EXPECT_TRUE(link->FrameDataRelativeToWorld().pose.isApprox(
+      firstPose, 1e-4));
+
+    // A snapshot that does not match is rejected and leaves the world as it
+    // was.
+    const auto pose = link->FrameDataRelativeToWorld().pose;
+    gz::common::Console::SetVerbosity(0);
+    EXPECT_FALSE(world->RestoreState({}));
+    EXPECT_FALSE(world->RestoreState(
+      {snapshot.begin(), snapshot.end() - 1}));
+    gz::common::Console::SetVerbosity(4);
+    EXPECT_TRUE(link->FrameDataRelativeToWorld().pose.isApprox(pose));
+  }
+}
+
+struct EntityBatchFeatures : gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::GetEntityBatchFeature,
+  gz::physics::RemoveModelFromWorld,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestEntityBatch = WorldFeaturesTest<EntityBatchFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestEntityBatch, GetEntityBatch)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<EntityBatchFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kShapesWorld);
+    EXPECT_TRUE(errors.empty()) << errors;
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    auto models = world->GetModels();
+    ASSERT_EQ(world->GetModelCount(), models.size());
+    ASSERT_LT(2u, models.size());
+    for (std::size_t i = 0; i < models.size(); ++i)
+    {
+      ASSERT_NE(nullptr, models[i]);
+      EXPECT_EQ(i, models[i]->GetIndex());
+      EXPECT_EQ(world->GetModel(i)->EntityID(), models[i]->EntityID());
+
+      const auto links = models[i]->GetLinks();
+      ASSERT_EQ(models[i]->GetLinkCount(), links.size());
+      for (std::size_t j = 0; j < links.size(); ++j)
+      {
+        ASSERT_NE(nullptr, links[j]);
+        EXPECT_EQ(j, links[j]->GetIndex());
+        EXPECT_EQ(models[i]->GetLink(j)->EntityID(), links[j]->EntityID());
+      }
+      EXPECT_EQ(models[i]->GetJointCount(), models[i]->GetJoints().size());
+    }
+
+    // Removing a model shifts the indices of the models after it
+    const std::size_t nextID = models[2]->EntityID();
+    EXPECT_TRUE(models[1]->Remove());
+
+    const auto remaining = world->GetModels();
+    ASSERT_EQ(models.size() - 1u, remaining.size());
+    EXPECT_EQ(remaining.size(), world->GetModelCount());
+    EXPECT_EQ(nextID, remaining[1]->EntityID());
+    for (std::size_t i = 0; i < remaining.size(); ++i)
+      EXPECT_EQ(i, remaining[i]->GetIndex());
+  }
+}
+
+struct EntityChangeJournalFeatures : gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::EntityChangeJournalFeature,
+  gz::physics::GetModelFromWorld,
+  gz::physics::ConstructEmptyModelFeature,
+  gz::physics::ConstructEmptyLinkFeature,
+  gz::physics::AttachFixedJointFeature,
+  gz::physics::DetachJointFeature,
+  gz::physics::RemoveModelFromWorld,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestEntityChangeJournal =
+    WorldFeaturesTest<EntityChangeJournalFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestEntityChangeJournal, EntityChanges)
+{
+  using gz::physics::EntityChange;
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<EntityChangeJournalFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors = root.Load(common_test::worlds::kShapesWorld);
+    EXPECT_TRUE(errors.empty()) << errors;
+
+    auto world = engine->ConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    // Reading from 0 reports the models the world was constructed with
+    std::size_t cursor = 0u;
+    std::vector<EntityChange> changes;
+    EXPECT_TRUE(world->GetEntityChanges(cursor, changes));
+    std::size_t createdModels = 0u;
+    for (const EntityChange &change : changes)
+    {
+      EXPECT_EQ(EntityChange::Type::CREATED, change.type);
+      if (change.kind == EntityChange::Kind::MODEL)
+        ++createdModels;
+    }
+    EXPECT_EQ(world->GetModelCount(), createdModels);
+    EXPECT_EQ(world->GetEntityChangeCursor(), cursor);
+
+    // Nothing changes while nothing is constructed or removed
+    EXPECT_TRUE(world->GetEntityChanges(cursor, changes));
+    EXPECT_TRUE(changes.empty());
+
+    auto model = world->ConstructEmptyModel("journal_model");
+    ASSERT_NE(nullptr, model);
+    auto parent = model->ConstructEmptyLink("parent");
+    auto child = model->ConstructEmptyLink("child");
+    ASSERT_NE(nullptr, parent);
+    ASSERT_NE(nullptr, child);
+
+    EXPECT_TRUE(world->GetEntityChanges(cursor, changes));
+    ASSERT_EQ(3u, changes.size());
+    EXPECT_EQ(EntityChange::Type::CREATED, changes[0].type);
+    EXPECT_EQ(EntityChange::Kind::MODEL, changes[0].kind);
+    EXPECT_EQ(model->EntityID(), changes[0].entity);
+    EXPECT_EQ(world->EntityID(), changes[0].related);
+    EXPECT_EQ(EntityChange::Kind::LINK, changes[1].kind);
+    EXPECT_EQ(parent->EntityID(), changes[1].entity);
+    EXPECT_EQ(model->EntityID(), changes[1].related);
+    EXPECT_EQ(EntityChange::Kind::LINK, changes[2].kind);
+    EXPECT_EQ(child->EntityID(), changes[2].entity);
+
+    auto joint = child->AttachFixedJoint(parent, "fixed");
+    ASSERT_NE(nullptr, joint);
+    EXPECT_TRUE(world->GetEntityChanges(cursor, changes));
+    ASSERT_FALSE(changes.empty());
+    EXPECT_EQ(EntityChange::Type::ATTACHED, changes.back().type);
+    EXPECT_EQ(EntityChange::Kind::JOINT, changes.back().kind);
+    EXPECT_EQ(joint->EntityID(), changes.back().entity);
+    EXPECT_EQ(child->EntityID(), changes.back().related);
+
+    joint->Detach();
+    EXPECT_TRUE(world->GetEntityChanges(cursor, changes));
+    ASSERT_EQ(1u, changes.size());
+    EXPECT_EQ(EntityChange::Type::DETACHED, changes[0].type);
+    EXPECT_EQ(joint->EntityID(), changes[0].entity);
+    EXPECT_EQ(child->EntityID(), changes[0].related);
+
+    // The parts of a removed model are reported before the model
+    const std::size_t modelID = model->EntityID();
+    EXPECT_TRUE(model->Remove());
+    EXPECT_TRUE(world->GetEntityChanges(cursor, changes));
+    ASSERT_FALSE(changes.empty());
+    for (const EntityChange &change : changes)
+      EXPECT_EQ(EntityChange::Type::REMOVED, change.type);
+    EXPECT_EQ(EntityChange::Kind::MODEL, changes.back().kind);
+    EXPECT_EQ(modelID, changes.back().entity);
+    EXPECT_EQ(world->EntityID(), changes.back().related);
+    EXPECT_EQ(2, std::count_if(changes.begin(), changes.end(),
+        [](const EntityChange &_change)
+        {
+          return _change.kind == EntityChange::Kind::LINK;
+        }));
+  }
+}
+
+struct ModelStreamingFeatures : gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::GetModelFromWorld,
+  gz::physics::sdf::StreamSdfModelsFeatures,
+  gz::physics::sdf::ConstructSdfWorld
+> { };
+
+using WorldFeaturesTestModelStreaming =
+    WorldFeaturesTest<ModelStreamingFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestModelStreaming, StreamSdfModels)
+{
+  using gz::physics::LinearVector3d;
+  using gz::physics::ModelStreaming;
+
+  // Five spheres 10 m apart along x, in a world of their own
+  std::stringstream modelsStr;
+  modelsStr << R"(<sdf version="1.11"><world name="streamed">)";
+  for (int i = 0; i < 5; ++i)
+  {
+    modelsStr << "<model name=\"sphere_" << i << "\">"
+              << "<pose>" << 10 * i << " 0 0 0 0 0</pose>"
+              << R"(<link name="link"><collision name="collision">)"
+              << R"(<geometry><sphere><radius>0.5</radius></sphere>)"
+              << R"(</geometry></collision></link></model>)";
+  }
+  modelsStr << "</world></sdf>";
+
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<ModelStreamingFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root emptyRoot;
+    sdf::Errors errors = emptyRoot.LoadSdfString(
+        R"(<sdf version="1.11"><world name="empty"/></sdf>)");
+    ASSERT_TRUE(errors.empty()) << errors;
+    auto world = engine->ConstructWorld(*emptyRoot.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+
+    sdf::Root modelsRoot;
+    errors = modelsRoot.LoadSdfString(modelsStr.str());
+    ASSERT_TRUE(errors.empty()) << errors;
+    const sdf::World &sdfWorld = *modelsRoot.WorldByIndex(0);
+
+    ModelStreaming::Parameters parameters;
+    parameters.loadRadius = 15.0;
+    parameters.hysteresis = 2.0;
+    parameters.cellSize = 10.0;
+    parameters.maxLoadsPerUpdate = 2u;
+    ModelStreaming streaming(parameters);
+    gz::physics::sdf::AddSdfModelPlacements(sdfWorld, streaming);
+    ASSERT_EQ(5u, streaming.PlacementCount());
+
+    using ModelPtrType =
+        decltype(world->ConstructModels({}))::value_type;
+    std::vector<ModelPtrType> models;
+
+    // Only the spheres near the tracked point are constructed
+    streaming.SetTrackedPoints({LinearVector3d::Zero()});
+    gz::physics::sdf::StreamSdfModels(world, sdfWorld, streaming, models);
+    EXPECT_EQ(2u, world->GetModelCount());
+    ASSERT_NE(nullptr, models[0]);
+    ASSERT_NE(nullptr, models[1]);
+    EXPECT_EQ(nullptr, models[2]);
+    EXPECT_NE(nullptr, world->GetModel("sphere_1"));
+
+    // Move a sphere, which then keeps its new pose while it is paged out
+    auto freeGroup = models[1]->FindFreeGroup();
+    ASSERT_NE(nullptr, freeGroup);
+    gz::physics::Pose3d pose = gz::physics::Pose3d::Identity();
+    pose.translation() = LinearVector3d(12, 0, 5);
+    freeGroup->SetWorldPose(pose);
+
+    // Far away, the spheres near the start are removed and the ones at the
+    // other end are constructed
+    streaming.SetTrackedPoints({LinearVector3d(40, 0, 0)});
+    const auto &changes = gz::physics::sdf::StreamSdfModels(
+        world, sdfWorld, streaming, models);
+    EXPECT_EQ(2u, changes.unloads.size());
+    EXPECT_EQ(2u, changes.loads.size());
+    EXPECT_EQ(2u, world->GetModelCount());
+    EXPECT_EQ(nullptr, world->GetModel("sphere_1"));
+    EXPECT_NE(nullptr, world->GetModel("sphere_4"));
+    EXPECT_EQ(nullptr, models[1]);
+    ASSERT_NE(nullptr, streaming.SavedState(1u));
+
+    // The sphere that was moved comes back where it was left
+    streaming.SetTrackedPoints({LinearVector3d::Zero()});
+    gz::physics::sdf::StreamSdfModels(world, sdfWorld, streaming, models);
+    EXPECT_EQ(2u, world->GetModelCount());
+    ASSERT_NE(nullptr, models[1]);
+    freeGroup = models[1]->FindFreeGroup();
+    ASSERT_NE(nullptr, freeGroup);
+    EXPECT_TRUE(freeGroup->FrameDataRelativeToWorld().pose.translation()
+        .isApprox(LinearVector3d(12, 0, 5), 1e-6));
+  }
+}
+
+struct IncrementalWorldFeatures : gz::physics::FeatureList<
+  gz::physics::GetEngineInfo,
+  gz::physics::GetModelFromWorld,
+  gz::physics::GetJointFromModel,
+  gz::physics::WorldModelFeature,
+  gz::physics::sdf::ConstructSdfWorldIncrementally
+> { };
+
+using WorldFeaturesTestIncremental =
+    WorldFeaturesTest<IncrementalWorldFeatures>;
+
+/////////////////////////////////////////////////
+TEST_F(WorldFeaturesTestIncremental, ConstructWorldIncrementally)
+{
+  for (const std::string &name : this->pluginNames)
+  {
+    std::cout << "Testing plugin: " << name << std::endl;
+    gz::plugin::PluginPtr plugin = this->loader.Instantiate(name);
+
+    auto engine =
+      gz::physics::RequestEngine3d<IncrementalWorldFeatures>::From(plugin);
+    ASSERT_NE(nullptr, engine);
+
+    sdf::Root root;
+    const sdf::Errors errors =
+        root.Load(common_test::worlds::kWorldJointTestSdf);
+    ASSERT_TRUE(errors.empty()) << errors;
+
+    auto world = engine->StartConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world);
+    EXPECT_EQ(0u, world->GetModelCount());
+    EXPECT_EQ(2u, world->GetPendingModelCount());
+
+    // Each call constructs at least one model, even without any budget
+    EXPECT_FALSE(world->ContinueConstruction(
+        std::chrono::steady_clock::duration::zero()));
+    EXPECT_EQ(1u, world->GetModelCount());
+    EXPECT_NE(nullptr, world->GetModel("m1"));
+    EXPECT_EQ(1u, world->GetPendingModelCount());
+    EXPECT_EQ(0u, world->GetWorldModel()->GetJointCount());
+
+    // The joints of the world are constructed with its last model
+    EXPECT_TRUE(world->ContinueConstruction(
+        std::chrono::steady_clock::duration::zero()));
+    EXPECT_EQ(2u, world->GetModelCount());
+    EXPECT_EQ(0u, world->GetPendingModelCount());
+    EXPECT_EQ(2u, world->GetWorldModel()->GetJointCount());
+
+    EXPECT_TRUE(world->ContinueConstruction(std::chrono::seconds(1)));
+    EXPECT_EQ(2u, world->GetModelCount());
+
+    // A generous budget constructs the whole world in one call
+    gz::plugin::PluginPtr plugin2 = this->loader.Instantiate(name);
+    auto engine2 =
+      gz::physics::RequestEngine3d<IncrementalWorldFeatures>::From(plugin2);
+    ASSERT_NE(nullptr, engine2);
+    auto world2 = engine2->StartConstructWorld(*root.WorldByIndex(0));
+    ASSERT_NE(nullptr, world2);
+    EXPECT_TRUE(world2->ContinueConstruction(std::chrono::seconds(10)));
+    EXPECT_EQ(2u, world2->GetModelCount());
+    EXPECT_EQ(2u, world2->GetWorldModel()->GetJointCount());
+  }
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <type_traits>
+
 #include <gz/plugin/Loader.hh>
 
 #include <gz/physics/RequestEngine.hh>
@@ -112,6 +114,46 @@ TEST(FeatureSystem, MockPlugin)
   EXPECT_EQ("Another joint", joint2->Name());
 }
 
+/////////////////////////////////////////////////
+TEST(FeatureSystem, MockEntityRef)
+{
+  using MockModel3dRef = Model3dRef<mock::MockFeatureList>;
+  static_assert(std::is_trivially_copyable_v<MockModel3dRef>,
+                "EntityRef must be trivially copyable");
+
+  mock::MockEngine3dPtr engine =
+      RequestEngine3d<mock::MockFeatureList>::From(
+         LoadMockPlugin("mock::EntitiesPlugin3d"));
+  ASSERT_NE(nullptr, engine);
+
+  mock::MockWorld3dPtr world = engine->GetWorld("Some world");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_FALSE(MockModel3dRef());
+  EXPECT_FALSE(MockModel3dRef(mock::MockModel3dPtr()));
+
+  mock::MockModel3dPtr model = world->GetModel("First model");
+  ASSERT_NE(nullptr, model);
+
+  const MockModel3dRef ref(model);
+  ASSERT_TRUE(ref);
+  EXPECT_EQ(model->EntityID(), ref.EntityID());
+  EXPECT_EQ("First model", ref->Name());
+
+  const MockModel3dRef copy = ref;
+  EXPECT_TRUE(copy == ref);
+  EXPECT_FALSE(copy != ref);
+
+  // Feature functions called through the handle act on the same entity
+  EXPECT_TRUE(copy->SetName("Renamed model"));
+  EXPECT_EQ("Renamed model", model->Name());
+  EXPECT_EQ(model->GetLink("First link")->EntityID(),
+            ref->GetLink("First link")->EntityID());
+
+  const MockModel3dRef other(world->GetModel("Second model"));
+  EXPECT_TRUE(other != ref);
+}
+
 /////////////////////////////////////////////////
 TEST(FeatureSystem, MockCenterOfMass3d)
 {
@@ -21,6 +21,7 @@
 #include <gtest/gtest.h>
 #include <cmath>
 #include <string>
+#include <vector>
 
 #include <gz/plugin/Loader.hh>
 #include <gz/plugin/PluginPtr.hh>
@@ -877,4 +878,147 @@ void TestRelativeFrameData(const double _tolerance, const std::string &_suffix)
   EXPECT_NEAR(C_O.angularAcceleration[2], 0.0, _tolerance);
 }
 
+/////////////////////////////////////////////////
+template <typename RQ, typename EngineT>
+void CheckBatchResolve(const EngineT &_fs, const std::vector<RQ> &_quantities,
+                       const FrameID &_relativeTo,
+                       const FrameID &_inCoordinatesOf,
+                       const double _tolerance)
+{
+  std::vector<typename RQ::Quantity> resolved(_quantities.size());
+  _fs->Resolve(_quantities.data(), _quantities.size(), resolved.data(),
+               _relativeTo, _inCoordinatesOf);
+
+  for (std::size_t i = 0; i < _quantities.size(); ++i)
+  {
+    EXPECT_TRUE(Equal(
+        _fs->Resolve(_quantities[i], _relativeTo, _inCoordinatesOf),
+        resolved[i], _tolerance)) << "quantity " << i;
+  }
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void TestBatchResolve(const double _tolerance, const std::string &_suffix)
+{
+  using Scalar = typename PolicyT::Scalar;
+  constexpr std::size_t Dim = PolicyT::Dim;
+
+  auto fs =
+      gz::physics::RequestEngine<PolicyT, mock::MockFrameSemanticsList>
+        ::From(LoadMockFrameSemanticsPlugin(_suffix));
+
+  using RelativeFrameData = RelativeFrameData<Scalar, Dim>;
+  using LinearVector = LinearVector<Scalar, Dim>;
+  using AngularVector = AngularVector<Scalar, Dim>;
+  using RelativePose = gz::physics::RelativePose<Scalar, Dim>;
+  using RelativePosition = gz::physics::RelativePosition<Scalar, Dim>;
+  using RelativeForce = gz::physics::RelativeForce<Scalar, Dim>;
+  using RelativeTorque = gz::physics::RelativeTorque<Scalar, Dim>;
+
+  const FrameID World = FrameID::World();
+
+  const RelativeFrameData O_T_A(World, RandomFrameData<Scalar, Dim>());
+  const FrameID A = *fs->CreateLink("A", fs->Resolve(O_T_A, World));
+
+  const RelativeFrameData A_T_B(A, RandomFrameData<Scalar, Dim>());
+  const FrameID B = *fs->CreateLink("B", fs->Resolve(A_T_B, World));
+
+  const RelativeFrameData O_T_C(World, RandomFrameData<Scalar, Dim>());
+  const FrameID C = *fs->CreateLink("C", fs->Resolve(O_T_C, World));
+
+  // Runs of quantities sharing a parent frame, and parents that come back
+  // after a run of another parent.
+  const std::vector<FrameID> parents = {World, A, A, A, B, A, World, C, C};
+
+  std::vector<RelativePosition> positions;
+  std::vector<RelativeForce> forces;
+  std::vector<RelativeTorque> torques;
+  std::vector<RelativePose> poses;
+  for (const FrameID &parent : parents)
+  {
+    positions.emplace_back(parent, RandomVector<LinearVector>(10.0));
+    forces.emplace_back(parent, RandomVector<LinearVector>(10.0));
+    torques.emplace_back(parent, RandomVector<AngularVector>(10.0));
+    poses.emplace_back(parent, RandomFrameData<Scalar, Dim>().pose);
+  }
+
+  for (const FrameID &relativeTo : {World, A, C})
+  {
+    for (const FrameID &inCoordinatesOf : {World, A, B})
+    {
+      CheckBatchResolve(fs, positions, relativeTo, inCoordinatesOf,
+                        _tolerance);
+      CheckBatchResolve(fs, forces, relativeTo, inCoordinatesOf, _tolerance);
+      CheckBatchResolve(fs, torques, relativeTo, inCoordinatesOf, _tolerance);
+      CheckBatchResolve(fs, poses, relativeTo, inCoordinatesOf, _tolerance);
+    }
+  }
+
+  // The default frames are the World Frame, and the frame given for
+  // relativeTo.
+  std::vector<LinearVector> resolved(positions.size());
+  fs->Resolve(positions.data(), positions.size(), resolved.data());
+  for (std::size_t i = 0; i < positions.size(); ++i)
+    EXPECT_TRUE(Equal(fs->Resolve(positions[i]), resolved[i], _tolerance));
+
+  fs->Resolve(positions.data(), positions.size(), resolved.data(), B);
+  for (std::size_t i = 0; i < positions.size(); ++i)
+    EXPECT_TRUE(Equal(fs->Resolve(positions[i], B), resolved[i], _tolerance));
+
+  // Nothing is written for an empty batch
+  fs->Resolve(positions.data(), 0u, static_cast<LinearVector*>(nullptr));
+}
+
+/////////////////////////////////////////////////
+template <typename PolicyT>
+void TestPartialFrameData(const double _tolerance, const std::string &_suffix)
+{
+  using Scalar = typename PolicyT::Scalar;
+  constexpr std::size_t Dim = PolicyT::Dim;
+
+  auto fs =
+      gz::physics::RequestEngine<PolicyT, mock::MockFrameSemanticsList>
+        ::From(LoadMockFrameSemanticsPlugin(_suffix));
+
+  using FrameData = FrameData<Scalar, Dim>;
+  using LinearVector = LinearVector<Scalar, Dim>;
+  using RelativeFrameData = RelativeFrameData<Scalar, Dim>;
+  using RelativePosition = gz::physics::RelativePosition<Scalar, Dim>;
+
+  const FrameID World = FrameID::World();
+  const FrameData T_A = RandomFrameData<Scalar, Dim>();
+  auto linkA = fs->CreateLink("A", T_A);
+  const FrameID A = linkA->GetFrameID();
+  const FrameData T_B = RandomFrameData<Scalar, Dim>();
+  const FrameID B = *fs->CreateLink("B", T_B);
+
+  // The mock engine leaves the components which were not requested as NaN
+  const FrameData poseOnly =
+      linkA->FrameDataRelativeToWorld(gz::physics::FRAME_DATA_POSE);
+  EXPECT_TRUE(Equal(T_A.pose, poseOnly.pose, _tolerance));
+  EXPECT_TRUE(std::isnan(poseOnly.linearVelocity[0]));
+  EXPECT_TRUE(std::isnan(poseOnly.angularAcceleration[0]));
+
+  const FrameData withVelocity = linkA->FrameDataRelativeToWorld(
+      gz::physics::FRAME_DATA_POSE | gz::physics::FRAME_DATA_VELOCITY);
+  EXPECT_TRUE(Equal(T_A.linearVelocity, withVelocity.linearVelocity,
+                    _tolerance));
+  EXPECT_TRUE(std::isnan(withVelocity.linearAcceleration[0]));
+
+  EXPECT_TRUE(Equal(T_A, linkA->FrameDataRelativeToWorld(), _tolerance));
+
+  // Points only need the poses of the frames, so they resolve to the same
+  // values as they do from complete frame data.
+  const LinearVector p = RandomVector<LinearVector>(10.0);
+  const LinearVector A_p_B = T_B.pose.inverse() * T_A.pose * p;
+  EXPECT_TRUE(Equal(A_p_B, fs->Resolve(RelativePosition(A, p), B),
+                    _tolerance));
+
+  // Frame data still requests every component
+  EXPECT_TRUE(Equal(fs->Resolve(RelativeFrameData(A), World),
+                    T_A, _tolerance));
+  EXPECT_FALSE(std::isnan(linkA->FrameDataRelativeTo(B).linearVelocity[0]));
+}
+
 #endif
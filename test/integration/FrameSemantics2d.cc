@@ -41,6 +41,18 @@ TEST(FrameSemantics_TEST, RelativeQuantities2d)
   TestRelativeQuantities<gz::physics::FeaturePolicy2d>(1e-11, "2d");
 }
 
+/////////////////////////////////////////////////
+TEST(FrameSemantics_TEST, BatchResolve2d)
+{
+  TestBatchResolve<gz::physics::FeaturePolicy2d>(1e-11, "2d");
+}
+
+/////////////////////////////////////////////////
+TEST(FrameSemantics_TEST, PartialFrameData2d)
+{
+  TestPartialFrameData<gz::physics::FeaturePolicy2d>(1e-11, "2d");
+}
+
 int main(int argc, char **argv)
 {
   // This seed is arbitrary, but we always use the same seed value to ensure
@@ -41,6 +41,18 @@ TEST(FrameSemantics_TEST, RelativeQuantities2f)
   TestRelativeQuantities<gz::physics::FeaturePolicy2f>(1e-4, "2f");
 }
 
+/////////////////////////////////////////////////
+TEST(FrameSemantics_TEST, BatchResolve2f)
+{
+  TestBatchResolve<gz::physics::FeaturePolicy2f>(1e-4, "2f");
+}
+
+/////////////////////////////////////////////////
+TEST(FrameSemantics_TEST, PartialFrameData2f)
+{
+  TestPartialFrameData<gz::physics::FeaturePolicy2f>(1e-4, "2f");
+}
+
 int main(int argc, char **argv)
 {
   // This seed is arbitrary, but we always use the same seed value to ensure
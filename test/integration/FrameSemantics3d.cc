@@ -47,6 +47,18 @@ TEST(FrameSemantics_TEST, RelativeFrameData3d)
   TestRelativeFrameData<gz::physics::FeaturePolicy3d>(1e-11, "3d");
 }
 
+/////////////////////////////////////////////////
+TEST(FrameSemantics_TEST, BatchResolve3d)
+{
+  TestBatchResolve<gz::physics::FeaturePolicy3d>(1e-11, "3d");
+}
+
+/////////////////////////////////////////////////
+TEST(FrameSemantics_TEST, PartialFrameData3d)
+{
+  TestPartialFrameData<gz::physics::FeaturePolicy3d>(1e-11, "3d");
+}
+
 int main(int argc, char **argv)
 {
   // This seed is arbitrary, but we always use the same seed value to ensure
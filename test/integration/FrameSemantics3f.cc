@@ -47,6 +47,18 @@ TEST(FrameSemantics_TEST, RelativeFrameData3f)
   TestRelativeFrameData<gz::physics::FeaturePolicy3f>(1e-2, "3f");
 }
 
+/////////////////////////////////////////////////
+TEST(FrameSemantics_TEST, BatchResolve3f)
+{
+  TestBatchResolve<gz::physics::FeaturePolicy3f>(1e-2, "3f");
+}
+
+/////////////////////////////////////////////////
+TEST(FrameSemantics_TEST, PartialFrameData3f)
+{
+  TestPartialFrameData<gz::physics::FeaturePolicy3f>(1e-2, "3f");
+}
+
 int main(int argc, char **argv)
 {
   // This seed is arbitrary, but we always use the same seed value to ensure
@@ -0,0 +1,512 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gz/plugin/Loader.hh>
+
+#include <gz/physics/ForwardStep.hh>
+#include <gz/physics/GetContacts.hh>
+#include <gz/physics/RequestEngine.hh>
+#include <gz/physics/World.hh>
+#include <gz/physics/sdf/ConstructWorld.hh>
+
+#include <sdf/Root.hh>
+
+#include "Worlds.hh"
+
+// Guards the hot paths of the engine plugins against regressions. Every case
+// loads a world of test/common_test/worlds with each engine plugin that was
+// built and measures the wall time and the heap allocations of one of:
+// - construct: Constructing the world from SDF.
+// - step: WorldForwardStep, per step.
+// - pose_write: Writing the ChangedWorldPoses of a step, from the step
+//   statistics of the world. Its allocations are counted in step.
+// - contacts: GetContactsFromLastStep, per call, once the models rest.
+//
+// The measurements are checked against the budgets of a baseline file, given
+// by GZ_PHYSICS_PERFORMANCE_BASELINE or else step_budgets.txt next to this
+// file. A measurement may take GZ_PHYSICS_PERFORMANCE_TIME_FACTOR (3 by
+// default) times the time of its baseline and 10% more allocations, and is
+// only reported if the baseline has no entry for it. Times depend on the
+// machine, so a baseline may give - instead to only check the allocations. Setting
+// GZ_PHYSICS_PERFORMANCE_RECORD to a path writes the measurements of the run
+// to that file in the same format, to record a baseline on the machine that
+// runs the suite.
+//
+// Some checks need no baseline: steady stepping must not allocate more and
+// more, and the time of GetContactsFromLastStep per contact must not grow
+// with the size of the world.
+
+/// \brief Number of allocations made through operator new.
+static std::atomic<std::size_t> gAllocations{0u};
+
+/////////////////////////////////////////////////
+void *operator new(std::size_t _size)
+{
+  ++gAllocations;
+  if (void *ptr = std::malloc(_size > 0u ? _size : 1u))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr) noexcept
+{
+  std::free(_ptr);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr, std::size_t) noexcept
+{
+  std::free(_ptr);
+}
+
+using Features = gz::physics::FeatureList<
+  gz::physics::ForwardStep,
+  gz::physics::GetContactsFromLastStepFeature,
+  gz::physics::GetStepStatisticsFeature,
+  gz::physics::sdf::ConstructSdfWorld
+>;
+
+using WorldPtr = gz::physics::World3dPtr<Features>;
+
+/////////////////////////////////////////////////
+/// \brief Time and allocations of one measured operation.
+struct Measurement
+{
+  /// \brief Wall clock seconds.
+  double seconds = 0.0;
+
+  /// \brief Allocations made through operator new.
+  double allocations = 0.0;
+
+  /// \brief False if the allocations of the operation cannot be told apart
+  /// from those of another one.
+  bool countsAllocations = true;
+};
+
+/////////////////////////////////////////////////
+/// \brief Run a function and measure it.
+/// \param[in] _repeat Number of times to run it.
+/// \param[in] _func Function to run.
+/// \return Time and allocations per run.
+template <typename F>
+static Measurement Measure(std::size_t _repeat, F &&_func)
+{
+  const std::size_t allocations = gAllocations;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < _repeat; ++i)
+    _func();
+  Measurement result;
+  result.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count() /
+      static_cast<double>(_repeat);
+  result.allocations = static_cast<double>(gAllocations - allocations) /
+      static_cast<double>(_repeat);
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get a factor from the environment.
+/// \param[in] _name Name of the variable.
+/// \param[in] _default Factor if it is not set or not a positive number.
+static double EnvFactor(const char *_name, double _default)
+{
+  const char *value = std::getenv(_name);
+  if (!value)
+    return _default;
+  const double factor = std::atof(value);
+  return factor > 0.0 ? factor : _default;
+}
+
+/////////////////////////////////////////////////
+/// \brief Budgets of the measurements, and the measurements of the run to
+/// record. Lines of a baseline are
+///   <engine> <case> <seconds or -> <allocations or ->
+/// where - leaves the value unchecked, and lines starting with # are
+/// comments.
+class Baseline : public testing::Environment
+{
+  /// \brief Get the baseline of the run.
+  public: static Baseline &Instance()
+  {
+    static Baseline *instance = static_cast<Baseline *>(
+        testing::AddGlobalTestEnvironment(new Baseline));
+    return *instance;
+  }
+
+  /// \brief Constructor. Reads the baseline file.
+  private: Baseline()
+  {
+    const char *path = std::getenv("GZ_PHYSICS_PERFORMANCE_BASELINE");
+    std::ifstream in(path ? std::string(path) :
+        std::string(TESTING_PROJECT_SOURCE_DIR) +
+            "/test/performance/step_budgets.txt");
+    std::string line;
+    while (std::getline(in, line))
+    {
+      if (line.empty() || line[0] == '#')
+        continue;
+      std::istringstream fields(line);
+      std::string engine, name, seconds, allocations;
+      Measurement m;
+      if (!(fields >> engine >> name >> seconds >> allocations))
+        continue;
+      m.seconds = seconds == "-" ?
+          std::numeric_limits<double>::infinity() :
+          std::atof(seconds.c_str());
+      m.countsAllocations = allocations != "-";
+      if (m.countsAllocations)
+        m.allocations = std::atof(allocations.c_str());
+      this->budgets[{engine, name}] = m;
+    }
+  }
+
+  /// \brief Check a measurement against its budget, and keep it to record.
+  /// \param[in] _engine Name of the engine.
+  /// \param[in] _name Name of the case.
+  /// \param[in] _m The measurement.
+  public: void Check(const std::string &_engine, const std::string &_name,
+                     const Measurement &_m)
+  {
+    this->measured[{_engine, _name}] = _m;
+    testing::Test::RecordProperty(_engine + "/" + _name + "/seconds",
+        std::to_string(_m.seconds));
+    if (_m.countsAllocations)
+    {
+      testing::Test::RecordProperty(_engine + "/" + _name + "/allocations",
+          std::to_string(_m.allocations));
+    }
+
+    const auto it = this->budgets.find({_engine, _name});
+    if (it == this->budgets.end())
+    {
+      std::cout << "No budget for [" << _engine << " " << _name
+                << "]: " << _m.seconds << " s, " << _m.allocations
+                << " allocations" << std::endl;
+      return;
+    }
+
+    const Measurement &budget = it->second;
+    const double timeFactor =
+        EnvFactor("GZ_PHYSICS_PERFORMANCE_TIME_FACTOR", 3.0);
+    EXPECT_LE(_m.seconds, budget.seconds * timeFactor)
+        << _engine << " " << _name << " took " << _m.seconds
+        << " s, its baseline is " << budget.seconds << " s";
+    if (_m.countsAllocations && budget.countsAllocations)
+    {
+      EXPECT_LE(_m.allocations, std::ceil(budget.allocations * 1.1))
+          << _engine << " " << _name << " made " << _m.allocations
+          << " allocations, its baseline is " << budget.allocations;
+    }
+  }
+
+  // Documentation inherited
+  public: void TearDown() override
+  {
+    const char *path = std::getenv("GZ_PHYSICS_PERFORMANCE_RECORD");
+    if (!path)
+      return;
+
+    std::ofstream out(path);
+    out << "# <engine> <case> <seconds> <allocations or ->\n";
+    for (const auto &[key, m] : this->measured)
+    {
+      out << key.first << " " << key.second << " " << m.seconds << " ";
+      if (m.countsAllocations)
+        out << m.allocations << "\n";
+      else
+        out << "-\n";
+    }
+  }
+
+  /// \brief Budgets by engine and case.
+  private: std::map<std::pair<std::string, std::string>, Measurement>
+      budgets;
+
+  /// \brief Measurements of the run by engine and case.
+  private: std::map<std::pair<std::string, std::string>, Measurement>
+      measured;
+};
+
+/// \brief Make sure the baseline is registered before the tests run.
+static Baseline &gBaseline = Baseline::Instance();
+
+/////////////////////////////////////////////////
+/// \brief Get the engine plugins that were built.
+/// \return Pairs of engine name and path to the plugin library.
+static std::vector<std::pair<std::string, std::string>> EnginePlugins()
+{
+  return {
+#ifdef dartsim_plugin_LIB
+    {"dartsim", dartsim_plugin_LIB},
+#endif
+#ifdef bullet_featherstone_plugin_LIB
+    {"bullet-featherstone", bullet_featherstone_plugin_LIB},
+#endif
+#ifdef tpe_plugin_LIB
+    {"tpe", tpe_plugin_LIB},
+#endif
+  };
+}
+
+/////////////////////////////////////////////////
+/// \brief Loads each engine plugin that was built.
+class StepBudgets : public testing::Test
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    for (const auto &[engine, path] : EnginePlugins())
+    {
+      for (const std::string &name : this->loader.LoadLib(path))
+        this->plugins.emplace_back(engine, name);
+    }
+    if (this->plugins.empty())
+      GTEST_SKIP() << "No engine plugins were built";
+  }
+
+  /// \brief Get an engine of a plugin.
+  /// \param[in] _name Name of the plugin.
+  /// \return The engine, or nullptr if the plugin lacks the features.
+  public: gz::physics::Engine3dPtr<Features> Engine(const std::string &_name)
+  {
+    return gz::physics::RequestEngine3d<Features>::From(
+        this->loader.Instantiate(_name));
+  }
+
+  /// \brief Pairs of engine name and plugin name.
+  public: std::vector<std::pair<std::string, std::string>> plugins;
+
+  /// \brief Plugin loader
+  public: gz::plugin::Loader loader;
+};
+
+/////////////////////////////////////////////////
+/// \brief Step a world a number of times.
+static void Step(const WorldPtr &_world, std::size_t _count)
+{
+  gz::physics::ForwardStep::Output output;
+  gz::physics::ForwardStep::State state;
+  gz::physics::ForwardStep::Input input;
+  for (std::size_t i = 0; i < _count; ++i)
+    _world->Step(output, state, input);
+}
+
+/// \brief Shared worlds run by the budget tests.
+static const std::vector<std::pair<std::string, std::string>> kWorlds = {
+  {"falling", common_test::worlds::kFallingWorld},
+  {"shapes", common_test::worlds::kShapesWorld},
+  {"contact", common_test::worlds::kContactSdf},
+  {"multiple_collisions", common_test::worlds::kMultipleCollisionsSdf},
+};
+
+/////////////////////////////////////////////////
+TEST_F(StepBudgets, Construct)
+{
+  for (const auto &[engine, name] : this->plugins)
+  {
+    auto physics = this->Engine(name);
+    ASSERT_NE(nullptr, physics);
+
+    for (const auto &[worldName, path] : kWorlds)
+    {
+      sdf::Root root;
+      ASSERT_TRUE(root.Load(path).empty()) << path;
+
+      // The first construction loads resources that later ones reuse
+      physics->ConstructWorld(*root.WorldByIndex(0));
+      const Measurement m = Measure(5u, [&]()
+      {
+        physics->ConstructWorld(*root.WorldByIndex(0));
+      });
+      gBaseline.Check(engine, "construct/" + worldName, m);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(StepBudgets, ForwardStep)
+{
+  for (const auto &[engine, name] : this->plugins)
+  {
+    auto physics = this->Engine(name);
+    ASSERT_NE(nullptr, physics);
+
+    for (const auto &[worldName, path] : kWorlds)
+    {
+      sdf::Root root;
+      ASSERT_TRUE(root.Load(path).empty()) << path;
+      auto world = physics->ConstructWorld(*root.WorldByIndex(0));
+      ASSERT_NE(nullptr, world);
+
+      // Buffers grow during the first steps, contacts appear as models land
+      gz::physics::ForwardStep::Output output;
+      gz::physics::ForwardStep::State state;
+      gz::physics::ForwardStep::Input input;
+      for (std::size_t i = 0; i < 200u; ++i)
+        world->Step(output, state, input);
+      const Measurement first = Measure(500u, [&]()
+      {
+        world->Step(output, state, input);
+      });
+      double poseWriteTime = 0.0;
+      const Measurement second = Measure(500u, [&]()
+      {
+        world->Step(output, state, input);
+        poseWriteTime += world->GetStepStatistics().poseWriteTime;
+      });
+
+      // A steady world does not allocate more the longer it runs
+      EXPECT_LE(second.allocations, first.allocations + 1.0)
+          << engine << " " << worldName;
+
+      gBaseline.Check(engine, "step/" + worldName, first);
+
+      Measurement poseWrite;
+      poseWrite.seconds = poseWriteTime / 500.0;
+      poseWrite.countsAllocations = false;
+      gBaseline.Check(engine, "pose_write/" + worldName, poseWrite);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(StepBudgets, GetContactsFromLastStep)
+{
+  for (const auto &[engine, name] : this->plugins)
+  {
+    auto physics = this->Engine(name);
+    ASSERT_NE(nullptr, physics);
+
+    for (const auto &[worldName, path] : kWorlds)
+    {
+      sdf::Root root;
+      ASSERT_TRUE(root.Load(path).empty()) << path;
+      auto world = physics->ConstructWorld(*root.WorldByIndex(0));
+      ASSERT_NE(nullptr, world);
+      Step(world, 1000u);
+
+      const Measurement m = Measure(200u, [&]()
+      {
+        world->GetContactsFromLastStep();
+      });
+      gBaseline.Check(engine, "contacts/" + worldName, m);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief A world of spheres resting on a ground box, in a square grid.
+/// \param[in] _count Number of spheres.
+/// \return SDF of the world.
+static std::string RestingSpheres(std::size_t _count)
+{
+  const auto columns = static_cast<std::size_t>(
+      std::ceil(std::sqrt(static_cast<double>(_count))));
+  std::ostringstream out;
+  out << "<?xml version='1.0'?><sdf version='1.11'><world name='spheres'>"
+      << "<model name='ground'><static>true</static>"
+      << "<pose>0 0 -0.5 0 0 0</pose><link name='link'>"
+      << "<collision name='collision'><geometry><box>"
+      << "<size>1000 1000 1</size></box></geometry></collision>"
+      << "</link></model>";
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    // Slightly sunk into the ground, so that engines without gravity report
+    // the contacts too
+    out << "<model name='sphere_" << i << "'><pose>"
+        << 2.0 * static_cast<double>(i % columns) << " "
+        << 2.0 * static_cast<double>(i / columns) << " 0.49 0 0 0</pose>"
+        << "<link name='link'><inertial><mass>1</mass><inertia>"
+        << "<ixx>0.1</ixx><iyy>0.1</iyy><izz>0.1</izz></inertia></inertial>"
+        << "<collision name='collision'><geometry><sphere>"
+        << "<radius>0.5</radius></sphere></geometry></collision>"
+        << "</link></model>";
+  }
+  out << "</world></sdf>";
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+TEST_F(StepBudgets, ContactLookupScaling)
+{
+  // The time to get a contact does not depend on the number of links of the
+  // world. Of several runs the fastest one is kept, which is the least
+  // disturbed by the rest of the machine.
+  for (const auto &[engine, name] : this->plugins)
+  {
+    auto physics = this->Engine(name);
+    ASSERT_NE(nullptr, physics);
+
+    std::vector<double> perContact;
+    for (const std::size_t count : {16u, 256u})
+    {
+      sdf::Root root;
+      ASSERT_TRUE(root.LoadSdfString(RestingSpheres(count)).empty());
+      auto world = physics->ConstructWorld(*root.WorldByIndex(0));
+      ASSERT_NE(nullptr, world);
+      Step(world, 10u);
+
+      const std::size_t contactCount =
+          world->GetContactsFromLastStep().size();
+      if (contactCount == 0u)
+        break;
+
+      double fastest = std::numeric_limits<double>::max();
+      for (std::size_t run = 0; run < 10u; ++run)
+      {
+        const Measurement m = Measure(20u, [&]()
+        {
+          world->GetContactsFromLastStep();
+        });
+        fastest = std::min(fastest, m.seconds);
+      }
+      perContact.push_back(fastest / static_cast<double>(contactCount));
+    }
+
+    if (perContact.size() != 2u)
+    {
+      std::cout << "Skipping " << engine << ", it reports no contacts"
+                << std::endl;
+      continue;
+    }
+
+    // A lookup that visits every link for each contact is 16 times slower
+    // per contact in the larger world
+    EXPECT_LE(perContact[1], 4.0 * perContact[0])
+        << engine << ": " << perContact[0] << " s per contact with 16 "
+        << "spheres, " << perContact[1] << " s with 256";
+  }
+}
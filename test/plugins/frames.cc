@@ -17,6 +17,7 @@
 
 #include "mock/MockFrameSemantics.hh"
 
+#include <limits>
 #include <map>
 #include <vector>
 
@@ -114,6 +115,30 @@ namespace mock
       return frames[_id.ID()];
     }
 
+    public: FrameData PartialFrameDataRelativeToWorld(
+        const gz::physics::FrameID &_id,
+        const gz::physics::FrameDataComponents _components) const override
+    {
+      // Components that were not requested are filled with NaN, so tests
+      // notice if a caller reads them.
+      using Scalar = typename PolicyT::Scalar;
+      const Scalar nan = std::numeric_limits<Scalar>::quiet_NaN();
+      FrameData data = frames[_id.ID()];
+      if (!(_components & gz::physics::FRAME_DATA_POSE))
+        data.pose.matrix().setConstant(nan);
+      if (!(_components & gz::physics::FRAME_DATA_VELOCITY))
+      {
+        data.linearVelocity.setConstant(nan);
+        data.angularVelocity.setConstant(nan);
+      }
+      if (!(_components & gz::physics::FRAME_DATA_ACCELERATION))
+      {
+        data.linearAcceleration.setConstant(nan);
+        data.angularAcceleration.setConstant(nan);
+      }
+      return data;
+    }
+
     std::map<std::string, std::size_t> linkIds;
     std::map<std::string, std::size_t> jointIds;
     std::vector<FrameData> frames;
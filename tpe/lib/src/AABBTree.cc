@@ -15,13 +15,20 @@
  *
 */
 
+#include <cmath>
 #include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <gz/common/Console.hh>
 
 #include "aabb_tree/AABB.h"
 
 #include "AABBTree.hh"
+#include "Entity.hh"
+#include "HashGrid.hh"
+#include "Utils.hh"
 
 namespace gz {
 namespace physics {
@@ -30,12 +37,125 @@ namespace tpelib {
 /// \brief Private data class for AABBTree
 class AABBTreePrivate
 {
-  /// \brief Pointer to the AABB tree
+  /// \brief Create an empty tree of the given precision, or an empty grid
+  /// if gridCellSize is set
+  /// \param[in] _singlePrecision True to store the boxes as float
+  public: void Reset(bool _singlePrecision)
+  {
+    this->aabbTree.reset();
+    this->floatTree.reset();
+    this->grid.reset();
+    this->singlePrecision = _singlePrecision;
+    if (this->gridCellSize > 0.0)
+      this->grid = std::make_unique<HashGrid>(this->gridCellSize);
+    else if (_singlePrecision)
+      this->floatTree = std::make_unique<aabb::TreeT<float>>(3, 0.0, 100000);
+    else
+      this->aabbTree = std::make_unique<aabb::Tree>(3, 0.0, 100000);
+  }
+
+  /// \brief Call a function with the tree in use, whichever its precision,
+  /// or with the grid
+  /// \param[in] _f Function taking the tree or the grid
+  /// \return Result of _f
+  public: template <typename F>
+  decltype(auto) Visit(F &&_f) const
+  {
+    if (this->grid)
+      return _f(*this->grid);
+    if (this->floatTree)
+      return _f(*this->floatTree);
+    return _f(*this->aabbTree);
+  }
+
+  /// \brief Whether the tree has a node
+  /// \param[in] _id Node id
+  /// \return True if the node is in the tree
+  public: bool Has(std::size_t _id) const
+  {
+    if (!this->InSpace(_id))
+      return false;
+    const unsigned int particle = this->Particle(_id);
+    return this->Visit([particle](const auto &_tree)
+        {
+          return _tree.hasParticle(particle);
+        });
+  }
+
+  /// \brief Whether a node id is in the id space of the nodes of the tree.
+  /// The space is that of the first node added to an empty tree.
+  /// \param[in] _id Node id
+  /// \return True if the id is in the space of the tree
+  public: bool InSpace(std::size_t _id) const
+  {
+    return (_id >> Entity::kLocalIdBits) ==
+        (this->idSpace >> Entity::kLocalIdBits);
+  }
+
+  /// \brief Take the id space of a node if the tree is empty
+  /// \param[in] _id Node id
+  /// \return True if the id is in the space of the tree
+  public: bool ClaimSpace(std::size_t _id)
+  {
+    const bool empty = this->Visit([](auto &_tree)
+        {
+          return _tree.nParticles() == 0u;
+        });
+    if (empty)
+      this->idSpace = _id - Entity::GetLocalIndex(_id);
+    return this->InSpace(_id);
+  }
+
+  /// \brief Get the particle of a node. The trees store 32 bit particles,
+  /// so a node keeps only its index within the id space of its world, see
+  /// Entity::GetLocalIndex, and the space is added back by Node.
+  /// \param[in] _id Node id
+  /// \return Particle of the node
+  public: static unsigned int Particle(std::size_t _id)
+  {
+    return static_cast<unsigned int>(Entity::GetLocalIndex(_id));
+  }
+
+  /// \brief Get the node of a particle
+  /// \param[in] _particle Particle
+  /// \return Node id
+  public: std::size_t Node(unsigned int _particle) const
+  {
+    return this->idSpace | static_cast<std::size_t>(_particle);
+  }
+
+  /// \brief First id of the id space of the nodes
+  public: std::size_t idSpace = 0u;
+
+  /// \brief Pointer to the AABB tree, when the boxes are stored as double
   public: std::unique_ptr<aabb::Tree> aabbTree;
 
-  /// \brief A map of node id and its AABB object in the tree
-  // public: std::unordered_map<std::size_t, unsigned int> nodeIds;
-  public: std::set<std::size_t> nodeIds;
+  /// \brief Pointer to the AABB tree, when the boxes are stored as float
+  public: std::unique_ptr<aabb::TreeT<float>> floatTree;
+
+  /// \brief Pointer to the hash grid, used instead of a tree when
+  /// gridCellSize is greater than 0
+  public: std::unique_ptr<HashGrid> grid;
+
+  /// \brief Whether the tree stores its boxes as float, kept while the grid
+  /// is in use
+  public: bool singlePrecision = false;
+
+  /// \brief Cell size of the grid, 0 to use a tree
+  public: double gridCellSize = 0.0;
+
+  /// \brief Scratch buffer for single node queries, reused across calls
+  public: std::vector<unsigned int> queryResult;
+
+  /// \brief Scratch buffer for pair queries, reused across calls
+  public: std::vector<std::pair<unsigned int, unsigned int>> pairResult;
+
+  /// \brief Scratch buffers for the bounds of UpdateNode, reused across
+  /// calls
+  public: std::vector<double> lowerBound = std::vector<double>(3);
+
+  /// \brief See lowerBound
+  public: std::vector<double> upperBound = std::vector<double>(3);
 };
 }
 }
@@ -49,7 +169,39 @@ using namespace tpelib;
 AABBTree::AABBTree()
   : dataPtr(new ::tpelib::AABBTreePrivate)
 {
-  this->dataPtr->aabbTree = std::make_unique<aabb::Tree>(3, 0.0, 100000);
+  this->dataPtr->Reset(false);
+}
+
+//////////////////////////////////////////////////
+void AABBTree::SetSinglePrecision(bool _singlePrecision)
+{
+  this->dataPtr->Reset(_singlePrecision);
+}
+
+//////////////////////////////////////////////////
+bool AABBTree::GetSinglePrecision() const
+{
+  return this->dataPtr->singlePrecision;
+}
+
+//////////////////////////////////////////////////
+void AABBTree::SetGridCellSize(double _cellSize)
+{
+  if (!(_cellSize >= 0.0) || std::isinf(_cellSize))
+  {
+    gzerr << "Invalid grid cell size [" << _cellSize << "]. "
+           << "The cell size must be finite and not negative." << std::endl;
+    return;
+  }
+
+  this->dataPtr->gridCellSize = _cellSize;
+  this->dataPtr->Reset(this->dataPtr->singlePrecision);
+}
+
+//////////////////////////////////////////////////
+double AABBTree::GetGridCellSize() const
+{
+  return this->dataPtr->gridCellSize;
 }
 
 //////////////////////////////////////////////////
@@ -58,6 +210,13 @@ AABBTree::~AABBTree() = default;
 //////////////////////////////////////////////////
 void AABBTree::AddNode(std::size_t _id, const math::AxisAlignedBox &_aabb)
 {
+  if (!this->dataPtr->ClaimSpace(_id))
+  {
+    gzerr << "Unable to add node '" << _id << "'. "
+           << "Nodes must belong to the same world." << std::endl;
+    return;
+  }
+
   std::vector<double> lowerBound(3);
   lowerBound[0] = _aabb.Min().X();
   lowerBound[1] = _aabb.Min().Y();
@@ -68,23 +227,67 @@ void AABBTree::AddNode(std::size_t _id, const math::AxisAlignedBox &_aabb)
   upperBound[1] = _aabb.Max().Y();
   upperBound[2] = _aabb.Max().Z();
 
-  this->dataPtr->aabbTree->insertParticle(_id, lowerBound, upperBound);
-  this->dataPtr->nodeIds.insert(_id);
+  this->dataPtr->Visit([&](auto &_tree)
+      {
+        _tree.insertParticle(this->dataPtr->Particle(_id), lowerBound,
+            upperBound);
+      });
+}
+
+//////////////////////////////////////////////////
+bool AABBTree::AddNodes(
+    const std::vector<std::pair<std::size_t, math::AxisAlignedBox>> &_nodes)
+{
+  std::vector<unsigned int> particles;
+  std::vector<std::vector<double>> lowerBounds;
+  std::vector<std::vector<double>> upperBounds;
+  particles.reserve(_nodes.size());
+  lowerBounds.reserve(_nodes.size());
+  upperBounds.reserve(_nodes.size());
+
+  std::set<std::size_t> ids;
+  for (const auto &[id, aabb] : _nodes)
+  {
+    if (this->dataPtr->Has(id) || !ids.insert(id).second)
+    {
+      gzerr << "Unable to add node '" << id << "'. "
+             << "Node already exists." << std::endl;
+      return false;
+    }
+    if (!(ids.size() == 1u ? this->dataPtr->ClaimSpace(id) :
+          this->dataPtr->InSpace(id)))
+    {
+      gzerr << "Unable to add node '" << id << "'. "
+             << "Nodes must belong to the same world." << std::endl;
+      return false;
+    }
+
+    particles.push_back(this->dataPtr->Particle(id));
+    lowerBounds.push_back({aabb.Min().X(), aabb.Min().Y(), aabb.Min().Z()});
+    upperBounds.push_back({aabb.Max().X(), aabb.Max().Y(), aabb.Max().Z()});
+  }
+
+  this->dataPtr->Visit([&](auto &_tree)
+      {
+        _tree.insertParticles(particles, lowerBounds, upperBounds);
+      });
+  return true;
 }
 
 //////////////////////////////////////////////////
 bool AABBTree::RemoveNode(std::size_t _id)
 {
-  auto it = this->dataPtr->nodeIds.find(_id);
-  if (it == this->dataPtr->nodeIds.end())
+  if (!this->dataPtr->Has(_id))
   {
     gzerr << "Unable to remove node '" << _id << "'. "
            << "Node not found." << std::endl;
     return false;
   }
 
-  this->dataPtr->aabbTree->removeParticle(_id);
-  this->dataPtr->nodeIds.erase(it);
+  this->dataPtr->Visit([_id](auto &_tree)
+      {
+        _tree.removeParticle(AABBTreePrivate::Particle(_id));
+      });
   return true;
 }
 
@@ -92,75 +295,261 @@ bool AABBTree::RemoveNode(std::size_t _id)
 bool AABBTree::UpdateNode(std::size_t _id,
     const math::AxisAlignedBox &_aabb)
 {
-  auto it = this->dataPtr->nodeIds.find(_id);
-  if (it == this->dataPtr->nodeIds.end())
+  if (!this->dataPtr->Has(_id))
   {
     gzerr << "Unable to update node '" << _id << "'. "
            << "Node not found." << std::endl;
     return false;
   }
 
-  std::vector<double> lowerBound(3);
+  // nodes are updated every step while they move, so the bounds are kept
+  // in buffers of the tree
+  std::vector<double> &lowerBound = this->dataPtr->lowerBound;
   lowerBound[0] = _aabb.Min().X();
   lowerBound[1] = _aabb.Min().Y();
   lowerBound[2] = _aabb.Min().Z();
 
-  std::vector<double> upperBound(3);
+  std::vector<double> &upperBound = this->dataPtr->upperBound;
   upperBound[0] = _aabb.Max().X();
   upperBound[1] = _aabb.Max().Y();
   upperBound[2] = _aabb.Max().Z();
 
+  this->dataPtr->Visit([&](auto &_tree)
+      {
+        _tree.updateParticle(AABBTreePrivate::Particle(_id), lowerBound,
+            upperBound);
+      });
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool AABBTree::SetNodeMask(std::size_t _id, uint16_t _mask)
+{
+  if (!this->dataPtr->Has(_id))
+  {
+    gzerr << "Unable to set the mask of node '" << _id << "'. "
+           << "Node not found." << std::endl;
+    return false;
+  }
 
-  this->dataPtr->aabbTree->updateParticle(_id, lowerBound, upperBound);
+  this->dataPtr->Visit([_id, _mask](auto &_tree)
+      {
+        _tree.setParticleMask(AABBTreePrivate::Particle(_id), _mask);
+      });
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool AABBTree::UpdateNodes(
+    const std::vector<std::pair<std::size_t, math::AxisAlignedBox>> &_nodes)
+{
+  std::vector<unsigned int> particles;
+  std::vector<std::vector<double>> lowerBounds;
+  std::vector<std::vector<double>> upperBounds;
+  particles.reserve(_nodes.size());
+  lowerBounds.reserve(_nodes.size());
+  upperBounds.reserve(_nodes.size());
+
+  for (const auto &[id, aabb] : _nodes)
+  {
+    if (!this->dataPtr->Has(id))
+    {
+      gzerr << "Unable to update node '" << id << "'. "
+             << "Node not found." << std::endl;
+      return false;
+    }
+
+    particles.push_back(this->dataPtr->Particle(id));
+    lowerBounds.push_back({aabb.Min().X(), aabb.Min().Y(), aabb.Min().Z()});
+    upperBounds.push_back({aabb.Max().X(), aabb.Max().Y(), aabb.Max().Z()});
+  }
+
+  this->dataPtr->Visit([&](auto &_tree)
+      {
+        _tree.refitParticles(particles, lowerBounds, upperBounds);
+      });
   return true;
 }
 
 //////////////////////////////////////////////////
 unsigned int AABBTree::NodeCount() const
 {
-  return this->dataPtr->nodeIds.size();
+  return this->dataPtr->Visit([](auto &_tree)
+      {
+        return _tree.nParticles();
+      });
+}
+
+//////////////////////////////////////////////////
+void AABBTree::Rebuild()
+{
+  this->dataPtr->Visit([](auto &_tree)
+      {
+        _tree.rebuild();
+      });
+}
+
+//////////////////////////////////////////////////
+double AABBTree::SurfaceAreaRatio() const
+{
+  return this->dataPtr->Visit([](const auto &_tree)
+      {
+        return _tree.computeSurfaceAreaRatio();
+      });
+}
+
+//////////////////////////////////////////////////
+std::size_t AABBTree::GetMemoryBytes() const
+{
+  // Nodes store their boxes inline. Each particle also has an entry of the
+  // hash map from particle to node, with a link and the hash bucket.
+  const std::size_t particleBytes =
+      2u * sizeof(unsigned int) + 2u * sizeof(void *);
+  const std::size_t treeBytes = this->dataPtr->Visit([&](auto &_tree)
+      {
+        using TreeType = std::decay_t<decltype(_tree)>;
+        if constexpr (std::is_same_v<TreeType, HashGrid>)
+        {
+          return _tree.GetMemoryBytes();
+        }
+        else
+        {
+          return sizeof(TreeType) +
+              _tree.getNodeCount() * sizeof(typename TreeType::Node) +
+              _tree.nParticles() * particleBytes;
+        }
+      });
+  return sizeof(AABBTreePrivate) + treeBytes +
+      vectorBytes(this->dataPtr->queryResult) +
+      vectorBytes(this->dataPtr->pairResult);
 }
 
 //////////////////////////////////////////////////
 std::set<std::size_t> AABBTree::Collisions(std::size_t _id) const
 {
   std::set<std::size_t> result;
-  auto it = this->dataPtr->nodeIds.find(_id);
-  if (it == this->dataPtr->nodeIds.end())
+  if (!this->dataPtr->Has(_id))
   {
     gzerr << "Unable to compute collisions for node '" << _id << "'. "
            << "Node not found." << std::endl;
     return result;
   }
 
-  auto collisions  = this->dataPtr->aabbTree->query(_id);
-  result = std::set<std::size_t>(collisions.begin(), collisions.end());
+  auto collisions = this->dataPtr->Visit([_id](auto &_tree)
+      {
+        return _tree.query(AABBTreePrivate::Particle(_id));
+      });
+  for (const unsigned int particle : collisions)
+    result.insert(this->dataPtr->Node(particle));
   return result;
 }
 
+//////////////////////////////////////////////////
+bool AABBTree::Collisions(std::size_t _id,
+    std::vector<std::size_t> &_result) const
+{
+  if (!this->dataPtr->Has(_id))
+  {
+    gzerr << "Unable to compute collisions for node '" << _id << "'. "
+           << "Node not found." << std::endl;
+    return false;
+  }
+
+  this->dataPtr->queryResult.clear();
+  this->dataPtr->Visit([&](auto &_tree)
+      {
+        _tree.query(AABBTreePrivate::Particle(_id),
+            this->dataPtr->queryResult);
+      });
+  for (const unsigned int particle : this->dataPtr->queryResult)
+    _result.push_back(this->dataPtr->Node(particle));
+  return true;
+}
+
+//////////////////////////////////////////////////
+void AABBTree::RayCast(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    const std::function<double(std::size_t, double)> &_visit) const
+{
+  const std::vector<double> origin{_origin.X(), _origin.Y(), _origin.Z()};
+  const std::vector<double> direction{
+      _direction.X(), _direction.Y(), _direction.Z()};
+  this->dataPtr->Visit([&](const auto &_tree)
+      {
+        _tree.queryRay(origin, direction, _maxDistance,
+            [this, &_visit](unsigned int _node, double _distance)
+            {
+              return _visit(this->dataPtr->Node(_node), _distance);
+            });
+      });
+}
+
+//////////////////////////////////////////////////
+void AABBTree::Overlaps(const math::AxisAlignedBox &_region,
+    std::vector<std::size_t> &_result) const
+{
+  if (_region.Min().X() > _region.Max().X() ||
+      _region.Min().Y() > _region.Max().Y() ||
+      _region.Min().Z() > _region.Max().Z())
+  {
+    return;
+  }
+
+  const std::vector<double> lowerBound{
+      _region.Min().X(), _region.Min().Y(), _region.Min().Z()};
+  const std::vector<double> upperBound{
+      _region.Max().X(), _region.Max().Y(), _region.Max().Z()};
+  std::vector<unsigned int> nodes;
+  this->dataPtr->Visit([&](const auto &_tree)
+      {
+        // The region is rounded outwards to the precision of the tree.
+        const typename std::decay_t<decltype(_tree)>::AABB region(
+            lowerBound, upperBound);
+        _tree.queryRegion(region, nodes);
+      });
+  for (const unsigned int particle : nodes)
+    _result.push_back(this->dataPtr->Node(particle));
+}
+
+//////////////////////////////////////////////////
+void AABBTree::CollisionPairs(
+    std::vector<std::pair<std::size_t, std::size_t>> &_pairs) const
+{
+  this->dataPtr->pairResult.clear();
+  this->dataPtr->Visit([&](auto &_tree)
+      {
+        _tree.queryPairs(this->dataPtr->pairResult);
+      });
+  for (const auto &[first, second] : this->dataPtr->pairResult)
+  {
+    _pairs.emplace_back(this->dataPtr->Node(first),
+        this->dataPtr->Node(second));
+  }
+}
+
 //////////////////////////////////////////////////
 math::AxisAlignedBox AABBTree::AABB(std::size_t _id) const
 {
-  auto it = this->dataPtr->nodeIds.find(_id);
-  if (it == this->dataPtr->nodeIds.end())
+  if (!this->dataPtr->Has(_id))
   {
     gzerr << "Unable to get AABB for node '" << _id << "'. "
            << "Node not found." << std::endl;
     return math::AxisAlignedBox();
   }
 
-  auto aabb = this->dataPtr->aabbTree->getAABB(_id);
-
-  return math::AxisAlignedBox(
-      math::Vector3d(
-      aabb.lowerBound[0], aabb.lowerBound[1], aabb.lowerBound[2]),
-      math::Vector3d(
-      aabb.upperBound[0], aabb.upperBound[1], aabb.upperBound[2]));
+  return this->dataPtr->Visit([_id](auto &_tree)
+      {
+        const auto &aabb = _tree.getAABB(AABBTreePrivate::Particle(_id));
+        return math::AxisAlignedBox(
+            math::Vector3d(
+            aabb.lowerBound[0], aabb.lowerBound[1], aabb.lowerBound[2]),
+            math::Vector3d(
+            aabb.upperBound[0], aabb.upperBound[1], aabb.upperBound[2]));
+      });
 }
 
 //////////////////////////////////////////////////
 bool AABBTree::HasNode(std::size_t _id) const
 {
-  auto it = this->dataPtr->nodeIds.find(_id);
-  return it != this->dataPtr->nodeIds.end();
+  return this->dataPtr->Has(_id);
 }
@@ -18,10 +18,15 @@
 #ifndef GZ_PHYSICS_TPE_LIB_SRC_AABBTREE_HH_
 #define GZ_PHYSICS_TPE_LIB_SRC_AABBTREE_HH_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include <gz/math/AxisAlignedBox.hh>
+#include <gz/math/Vector3.hh>
 #include <gz/utils/SuppressWarning.hh>
 
 #include "gz/physics/tpelib/Export.hh"
@@ -41,11 +46,46 @@ class GZ_PHYSICS_TPELIB_VISIBLE AABBTree
   /// \brief Destructor
   public: ~AABBTree();
 
+  /// \brief Set whether the tree stores the boxes of its nodes as float
+  /// instead of double. This halves the size of the boxes, which makes
+  /// traversals of large trees cheaper. Boxes are rounded outwards, so a
+  /// node's box still contains the box it was given, and queries never miss
+  /// an overlap, but AABB() returns the rounded box. Changing the precision
+  /// removes all nodes from the tree.
+  /// \param[in] _singlePrecision True to store the boxes as float
+  public: void SetSinglePrecision(bool _singlePrecision);
+
+  /// \brief Get whether the tree stores the boxes of its nodes as float
+  /// \return True if the boxes are stored as float, false if as double
+  public: bool GetSinglePrecision() const;
+
+  /// \brief Keep the nodes in a uniform grid of hashed cells instead of a
+  /// tree. Nodes that move within the cells they cover are updated in
+  /// place, which makes updates cheaper than in the tree when many nodes of
+  /// about one cell each move every step. Nodes covering many cells, e.g.
+  /// the ground, are tested against all others. Changing the cell size
+  /// removes all nodes.
+  /// \param[in] _cellSize Edge length of the cells, 0 to use a tree
+  public: void SetGridCellSize(double _cellSize);
+
+  /// \brief Get the edge length of the cells of the grid
+  /// \return Cell size, 0 if the nodes are kept in a tree
+  public: double GetGridCellSize() const;
+
   /// \brief Add a node to the tree
   /// \param[in] _aabb Axis aligned bounding box of the node
   /// \param[in] _id Unique id of this node
   public: void AddNode(std::size_t _id, const math::AxisAlignedBox &_aabb);
 
+  /// \brief Add many nodes to the tree in one pass. The new nodes are built
+  /// into a balanced subtree which is then inserted into the tree at once,
+  /// instead of searching the tree for the place of each node.
+  /// \param[in] _nodes Pairs of unique node id and axis aligned bounding box
+  /// \return True if all nodes were added, false otherwise. No node is added
+  /// if any of the ids is already in the tree or repeated.
+  public: bool AddNodes(
+      const std::vector<std::pair<std::size_t, math::AxisAlignedBox>> &_nodes);
+
   /// \brief Remove a node from the tree
   /// \param[in] _id Node id
   /// \return True if the node was successfully removed, false otherwise
@@ -57,6 +97,24 @@ class GZ_PHYSICS_TPELIB_VISIBLE AABBTree
   /// \return True if the update was successful, false otherwise
   public: bool UpdateNode(std::size_t _id, const math::AxisAlignedBox &_aabb);
 
+  /// \brief Set the collide bitmask of a node. Nodes are added with all
+  /// bits set. Two nodes are only reported as colliding if their bitmasks
+  /// share a bit, and queries skip the subtrees whose nodes share no bit
+  /// with the queried node.
+  /// \param[in] _id Node id
+  /// \param[in] _mask Collide bitmask
+  /// \return True if the node was found, false otherwise
+  public: bool SetNodeMask(std::size_t _id, uint16_t _mask);
+
+  /// \brief Update the axis aligned bounding boxes of many nodes in one
+  /// pass. The leaves are refit in place and the bounds of their ancestors
+  /// are recomputed bottom-up, without removing and reinserting each leaf.
+  /// \param[in] _nodes Pairs of node id and new axis aligned bounding box
+  /// \return True if all nodes were found and updated, false otherwise. No
+  /// node is updated if any of the ids is not found.
+  public: bool UpdateNodes(
+      const std::vector<std::pair<std::size_t, math::AxisAlignedBox>> &_nodes);
+
   /// \brief Get the number of nodes in the tree
   /// \return Number of nodes
   public: unsigned int NodeCount() const;
@@ -66,6 +124,59 @@ class GZ_PHYSICS_TPELIB_VISIBLE AABBTree
   /// \return A set of node ids that collide with the input node
   public: std::set<std::size_t> Collisions(std::size_t _id) const;
 
+  /// \brief Rebuild the tree from its nodes with the binned surface area
+  /// heuristic. Use this to restore the quality of the tree after many
+  /// nodes moved, which leaves their ancestors with loose boxes.
+  public: void Rebuild();
+
+  /// \brief Get the surface area ratio of the tree, a measure of its
+  /// quality: the sum of the surface areas of all boxes of the tree divided
+  /// by the surface area of the root box. Lower is better. Computed over all
+  /// nodes of the tree.
+  /// \return Surface area ratio, 0 if the tree is empty
+  public: double SurfaceAreaRatio() const;
+
+  /// \brief Estimate the memory used by the tree
+  /// \return Bytes used by the nodes of the tree and the query buffers
+  public: std::size_t GetMemoryBytes() const;
+
+  /// \brief Get all the nodes that collide / intersect with input node.
+  /// Same as Collisions(std::size_t) but appends to a caller-provided vector
+  /// instead of allocating a set.
+  /// \param[in] _id Input node id
+  /// \param[out] _result Vector to append colliding node ids to
+  /// \return True if the node was found, false otherwise
+  public: bool Collisions(std::size_t _id,
+      std::vector<std::size_t> &_result) const;
+
+  /// \brief Get all pairs of nodes that collide / intersect with each
+  /// other by traversing the tree against itself. Each pair is appended
+  /// once, with the smaller node id first.
+  /// \param[out] _pairs Vector to append colliding node id pairs to
+  public: void CollisionPairs(
+      std::vector<std::pair<std::size_t, std::size_t>> &_pairs) const;
+
+  /// \brief Visit the nodes whose axis aligned bounding box is crossed by a
+  /// ray. The tree is only read, so rays can be cast concurrently.
+  /// \param[in] _origin Start of the ray
+  /// \param[in] _direction Direction of the ray. Distances are measured in
+  /// multiples of it.
+  /// \param[in] _maxDistance Length of the ray
+  /// \param[in] _visit Called with the id of each node crossed by the ray
+  /// within the current maximum distance. Returns the new maximum distance,
+  /// e.g. the distance to the closest hit found so far, which prunes the
+  /// rest of the traversal.
+  public: void RayCast(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      const std::function<double(std::size_t, double)> &_visit) const;
+
+  /// \brief Get the nodes whose axis aligned bounding box overlaps a region.
+  /// The tree is only read, so regions can be queried concurrently.
+  /// \param[in] _region Region to test
+  /// \param[out] _result Vector to append overlapping node ids to
+  public: void Overlaps(const math::AxisAlignedBox &_region,
+      std::vector<std::size_t> &_result) const;
+
   /// \brief Get the AABB for a node
   /// \param[in] _id Node id
   /// \return Node's AABB
@@ -17,6 +17,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
 #include "AABBTree.hh"
 
 using namespace gz;
@@ -163,3 +168,535 @@ TEST(AABBTree, AABBTree)
   result = tree.Collisions(eId);
   EXPECT_EQ(0u, result.size());
 }
+
+/////////////////////////////////////////////////
+TEST(AABBTree, BatchQueries)
+{
+  AABBTree tree;
+
+  // empty tree has no pairs
+  std::vector<std::pair<std::size_t, std::size_t>> pairs;
+  tree.CollisionPairs(pairs);
+  EXPECT_TRUE(pairs.empty());
+
+  // a row of unit boxes spaced 1.5 apart so that no boxes overlap
+  const std::size_t count = 20u;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    math::Vector3d center(1.5 * i, 0, 0);
+    tree.AddNode(i, math::AxisAlignedBox(center - 0.5 * math::Vector3d::One,
+        center + 0.5 * math::Vector3d::One));
+  }
+  tree.CollisionPairs(pairs);
+  EXPECT_TRUE(pairs.empty());
+
+  // single node query into a vector
+  std::vector<std::size_t> result;
+  EXPECT_TRUE(tree.Collisions(0u, result));
+  EXPECT_TRUE(result.empty());
+  EXPECT_FALSE(tree.Collisions(count + 10u, result));
+
+  // refit every other box so that it doubles in size and overlaps with its
+  // neighbors
+  std::vector<std::pair<std::size_t, math::AxisAlignedBox>> updates;
+  for (std::size_t i = 0; i < count; i += 2u)
+  {
+    math::Vector3d center(1.5 * i, 0, 0);
+    updates.push_back({i, math::AxisAlignedBox(center - math::Vector3d::One,
+        center + math::Vector3d::One)});
+  }
+  EXPECT_TRUE(tree.UpdateNodes(updates));
+  EXPECT_EQ(updates[1].second, tree.AABB(2u));
+
+  // each refit box overlaps with the previous and next box
+  tree.CollisionPairs(pairs);
+  EXPECT_EQ(count - 1u, pairs.size());
+  std::set<std::pair<std::size_t, std::size_t>> uniquePairs(
+      pairs.begin(), pairs.end());
+  EXPECT_EQ(pairs.size(), uniquePairs.size());
+  for (std::size_t i = 0; i + 1u < count; ++i)
+    EXPECT_EQ(1u, uniquePairs.count({i, i + 1u}));
+
+  // the pairs agree with per node queries
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    result.clear();
+    EXPECT_TRUE(tree.Collisions(i, result));
+    std::set<std::size_t> expected = tree.Collisions(i);
+    EXPECT_EQ(expected, std::set<std::size_t>(result.begin(), result.end()));
+  }
+
+  // updating an unknown node fails without modifying the tree
+  updates.push_back({count + 10u, math::AxisAlignedBox()});
+  EXPECT_FALSE(tree.UpdateNodes(updates));
+}
+
+/////////////////////////////////////////////////
+TEST(AABBTree, AddNodes)
+{
+  AABBTree tree;
+  math::Vector3d size(0.5, 0.5, 0.5);
+  tree.AddNode(0u, math::AxisAlignedBox(-size, size));
+
+  // a row of boxes, each overlapping with the previous and the next one
+  const std::size_t count = 100u;
+  std::vector<std::pair<std::size_t, math::AxisAlignedBox>> nodes;
+  for (std::size_t i = 1u; i < count; ++i)
+  {
+    math::Vector3d center(0.75 * i, 0, 0);
+    nodes.push_back({i, math::AxisAlignedBox(center - size, center + size)});
+  }
+  EXPECT_TRUE(tree.AddNodes(nodes));
+  EXPECT_EQ(count, tree.NodeCount());
+  for (const auto &node : nodes)
+  {
+    EXPECT_TRUE(tree.HasNode(node.first));
+    EXPECT_EQ(node.second, tree.AABB(node.first));
+  }
+
+  std::vector<std::pair<std::size_t, std::size_t>> pairs;
+  tree.CollisionPairs(pairs);
+  std::set<std::pair<std::size_t, std::size_t>> uniquePairs(
+      pairs.begin(), pairs.end());
+  EXPECT_EQ(count - 1u, uniquePairs.size());
+  for (std::size_t i = 0; i + 1u < count; ++i)
+    EXPECT_EQ(1u, uniquePairs.count({i, i + 1u}));
+
+  // ids already in the tree or repeated are rejected without adding any
+  // node
+  EXPECT_FALSE(tree.AddNodes({{count, math::AxisAlignedBox()},
+      {0u, math::AxisAlignedBox()}}));
+  EXPECT_FALSE(tree.AddNodes({{count, math::AxisAlignedBox()},
+      {count, math::AxisAlignedBox()}}));
+  EXPECT_EQ(count, tree.NodeCount());
+  EXPECT_FALSE(tree.HasNode(count));
+
+  // adding nothing is a no-op
+  EXPECT_TRUE(tree.AddNodes({}));
+  EXPECT_EQ(count, tree.NodeCount());
+
+  // the bulk added nodes can be removed again
+  for (std::size_t i = 1u; i < count; ++i)
+    EXPECT_TRUE(tree.RemoveNode(i));
+  EXPECT_EQ(1u, tree.NodeCount());
+  pairs.clear();
+  tree.CollisionPairs(pairs);
+  EXPECT_TRUE(pairs.empty());
+}
+
+/////////////////////////////////////////////////
+TEST(AABBTree, Rebuild)
+{
+  AABBTree tree;
+  EXPECT_DOUBLE_EQ(0.0, tree.SurfaceAreaRatio());
+  tree.Rebuild();
+  EXPECT_EQ(0u, tree.NodeCount());
+
+  // a row of boxes added one by one, each overlapping with the next one
+  const std::size_t count = 64u;
+  math::Vector3d size(0.5, 0.5, 0.5);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    math::Vector3d center(0.75 * i, 0, 0);
+    tree.AddNode(i, math::AxisAlignedBox(center - size, center + size));
+  }
+
+  // scatter the boxes with refits, which keep the structure of the tree
+  std::vector<std::pair<std::size_t, math::AxisAlignedBox>> updates;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    std::size_t j = (i * 37u) % count;
+    math::Vector3d center(0.75 * j, 0, 0);
+    updates.push_back({i, math::AxisAlignedBox(center - size, center + size)});
+  }
+  EXPECT_TRUE(tree.UpdateNodes(updates));
+
+  std::vector<std::pair<std::size_t, std::size_t>> pairs;
+  tree.CollisionPairs(pairs);
+  std::set<std::pair<std::size_t, std::size_t>> expected(
+      pairs.begin(), pairs.end());
+  EXPECT_EQ(count - 1u, expected.size());
+
+  // rebuilding restores the quality of the tree without changing the
+  // boxes or the pairs they form
+  const double ratio = tree.SurfaceAreaRatio();
+  tree.Rebuild();
+  EXPECT_LT(tree.SurfaceAreaRatio(), ratio);
+  EXPECT_EQ(count, tree.NodeCount());
+  for (const auto &update : updates)
+    EXPECT_EQ(update.second, tree.AABB(update.first));
+
+  pairs.clear();
+  tree.CollisionPairs(pairs);
+  std::set<std::pair<std::size_t, std::size_t>> rebuiltPairs(
+      pairs.begin(), pairs.end());
+  EXPECT_EQ(expected, rebuiltPairs);
+
+  // the rebuilt tree can still be modified
+  EXPECT_TRUE(tree.RemoveNode(0u));
+  tree.AddNode(0u, updates[0].second);
+  EXPECT_EQ(count, tree.NodeCount());
+}
+
+/////////////////////////////////////////////////
+TEST(AABBTree, SinglePrecision)
+{
+  AABBTree tree;
+  EXPECT_FALSE(tree.GetSinglePrecision());
+  tree.AddNode(0u, math::AxisAlignedBox(math::Vector3d::Zero,
+      math::Vector3d::One));
+
+  // changing the precision empties the tree
+  tree.SetSinglePrecision(true);
+  EXPECT_TRUE(tree.GetSinglePrecision());
+  EXPECT_EQ(0u, tree.NodeCount());
+  EXPECT_FALSE(tree.HasNode(0u));
+
+  // a grid of boxes whose bounds are not representable as float, half of
+  // them overlapping their neighbours along x
+  AABBTree reference;
+  const std::size_t count = 64u;
+  std::vector<std::pair<std::size_t, math::AxisAlignedBox>> nodes;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const double spacing = (i % 2u == 0u) ? 0.9 : 1.1;
+    math::Vector3d min(0.1 + spacing * (i / 8u), 0.3 + 2.1 * (i % 8u),
+        -0.7);
+    nodes.push_back({i, math::AxisAlignedBox(min, min + math::Vector3d(
+        1.0 / 3.0 + 0.7, 1.0 / 7.0, 0.1))});
+  }
+  EXPECT_TRUE(tree.AddNodes(nodes));
+  EXPECT_TRUE(reference.AddNodes(nodes));
+  EXPECT_EQ(count, tree.NodeCount());
+
+  // the stored boxes are rounded outwards by at most a float rounding step
+  for (const auto &[id, box] : nodes)
+  {
+    math::AxisAlignedBox rounded = tree.AABB(id);
+    for (std::size_t j = 0; j < 3u; ++j)
+    {
+      EXPECT_LE(rounded.Min()[j], box.Min()[j]);
+      EXPECT_GE(rounded.Max()[j], box.Max()[j]);
+      EXPECT_NEAR(box.Min()[j], rounded.Min()[j], 1e-6);
+      EXPECT_NEAR(box.Max()[j], rounded.Max()[j], 1e-6);
+    }
+  }
+
+  // queries find the same nodes as with double precision
+  std::vector<std::pair<std::size_t, std::size_t>> pairs;
+  std::vector<std::pair<std::size_t, std::size_t>> expectedPairs;
+  tree.CollisionPairs(pairs);
+  reference.CollisionPairs(expectedPairs);
+  EXPECT_FALSE(expectedPairs.empty());
+  std::set<std::pair<std::size_t, std::size_t>> expectedPairSet(
+      expectedPairs.begin(), expectedPairs.end());
+  std::set<std::pair<std::size_t, std::size_t>> pairSet(
+      pairs.begin(), pairs.end());
+  EXPECT_EQ(expectedPairSet, pairSet);
+
+  std::vector<std::size_t> overlaps;
+  std::vector<std::size_t> expectedOverlaps;
+  const math::AxisAlignedBox region(math::Vector3d(1.2, 0.4, -1),
+      math::Vector3d(3.3, 4.5, 1));
+  tree.Overlaps(region, overlaps);
+  reference.Overlaps(region, expectedOverlaps);
+  EXPECT_FALSE(expectedOverlaps.empty());
+  EXPECT_EQ(std::set<std::size_t>(
+      expectedOverlaps.begin(), expectedOverlaps.end()),
+      std::set<std::size_t>(overlaps.begin(), overlaps.end()));
+
+  // the tree can still be modified and rebuilt
+  math::AxisAlignedBox moved(math::Vector3d(100.1, 0, 0),
+      math::Vector3d(100.2, 1, 1));
+  EXPECT_TRUE(tree.UpdateNode(0u, moved));
+  EXPECT_TRUE(tree.UpdateNodes({{1u, moved}}));
+  tree.Rebuild();
+  EXPECT_TRUE(tree.RemoveNode(2u));
+  EXPECT_EQ(count - 1u, tree.NodeCount());
+  std::set<std::size_t> collisions = tree.Collisions(0u);
+  EXPECT_EQ(std::set<std::size_t>({1u}), collisions);
+
+  // and the precision restored
+  tree.SetSinglePrecision(false);
+  EXPECT_FALSE(tree.GetSinglePrecision());
+  EXPECT_EQ(0u, tree.NodeCount());
+}
+
+/////////////////////////////////////////////////
+TEST(AABBTree, GridCellSize)
+{
+  AABBTree tree;
+  EXPECT_DOUBLE_EQ(0.0, tree.GetGridCellSize());
+  tree.AddNode(0u, math::AxisAlignedBox(math::Vector3d::Zero,
+      math::Vector3d::One));
+
+  // invalid cell sizes are ignored
+  tree.SetGridCellSize(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, tree.GetGridCellSize());
+  EXPECT_EQ(1u, tree.NodeCount());
+
+  // changing the cell size empties the tree
+  tree.SetGridCellSize(1.5);
+  EXPECT_DOUBLE_EQ(1.5, tree.GetGridCellSize());
+  EXPECT_EQ(0u, tree.NodeCount());
+  EXPECT_FALSE(tree.HasNode(0u));
+
+  // pseudo random unit boxes, some of them on negative cells, a ground box
+  // covering all of them and a box too long for the cell coordinates.
+  // Every query finds the same nodes as the tree.
+  unsigned int seed = 3u;
+  auto next = [&seed]()
+  {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<double>((seed >> 16) % 1000u) / 1000.0;
+  };
+  AABBTree reference;
+  const std::size_t count = 200u;
+  std::vector<std::pair<std::size_t, math::AxisAlignedBox>> nodes;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    math::Vector3d min(-10.0 + 20.0 * next(), -10.0 + 20.0 * next(),
+        2.0 * next());
+    nodes.push_back({i, math::AxisAlignedBox(min, min + math::Vector3d(
+        0.5 + next(), 0.5 + next(), 0.5 + next()))});
+  }
+  nodes.push_back({count, math::AxisAlignedBox(
+      math::Vector3d(-20, -20, -1), math::Vector3d(20, 20, 0.3))});
+  nodes.push_back({count + 1u, math::AxisAlignedBox(
+      math::Vector3d(-1, -1, -1),
+      math::Vector3d(1e20, 1, 1))});
+  EXPECT_TRUE(tree.AddNodes(nodes));
+  EXPECT_TRUE(reference.AddNodes(nodes));
+  EXPECT_EQ(count + 2u, tree.NodeCount());
+  EXPECT_EQ(nodes[5].second, tree.AABB(5u));
+
+  for (std::size_t i = 0; i < count; i += 3u)
+  {
+    EXPECT_TRUE(tree.SetNodeMask(i, 0x02));
+    EXPECT_TRUE(reference.SetNodeMask(i, 0x02));
+  }
+
+  auto comparePairs = [&]()
+  {
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    std::vector<std::pair<std::size_t, std::size_t>> expected;
+    tree.CollisionPairs(pairs);
+    reference.CollisionPairs(expected);
+    EXPECT_FALSE(expected.empty());
+    std::sort(pairs.begin(), pairs.end());
+    std::sort(expected.begin(), expected.end());
+    // each pair is reported once, smaller id first
+    EXPECT_EQ(expected, pairs);
+
+    for (const auto &node : nodes)
+    {
+      EXPECT_EQ(reference.Collisions(node.first),
+          tree.Collisions(node.first));
+    }
+  };
+  comparePairs();
+
+  // small regions walk the cells, large ones test every node
+  for (const auto &region : {
+      math::AxisAlignedBox(math::Vector3d(1.2, 0.4, 0.5),
+          math::Vector3d(3.3, 4.5, 1)),
+      math::AxisAlignedBox(math::Vector3d(-100, -100, -100),
+          math::Vector3d(100, 100, 100))})
+  {
+    std::vector<std::size_t> overlaps;
+    std::vector<std::size_t> expected;
+    tree.Overlaps(region, overlaps);
+    reference.Overlaps(region, expected);
+    EXPECT_EQ(std::set<std::size_t>(expected.begin(), expected.end()),
+        std::set<std::size_t>(overlaps.begin(), overlaps.end()));
+    EXPECT_EQ(expected.size(), overlaps.size());
+  }
+
+  // rays in a few directions, from inside and outside the boxes
+  const std::vector<std::pair<math::Vector3d, math::Vector3d>> rays{
+      {math::Vector3d(-30, 0.2, 0.4), math::Vector3d::UnitX},
+      {math::Vector3d(5, 5, 10), -math::Vector3d::UnitZ},
+      {math::Vector3d(0.3, -0.2, 1.1), math::Vector3d(-1, 0.7, 0.05)},
+      {math::Vector3d(9, 9, 0.8), math::Vector3d(-0.5, -0.5, 0)}};
+  for (const auto &[origin, direction] : rays)
+  {
+    std::set<std::size_t> visited;
+    std::set<std::size_t> expected;
+    tree.RayCast(origin, direction, 40.0,
+        [&](std::size_t _id, double _maxDistance)
+        {
+          EXPECT_TRUE(visited.insert(_id).second);
+          return _maxDistance;
+        });
+    reference.RayCast(origin, direction, 40.0,
+        [&](std::size_t _id, double _maxDistance)
+        {
+          expected.insert(_id);
+          return _maxDistance;
+        });
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, visited);
+  }
+
+  // move some boxes within their cells and others far away
+  std::vector<std::pair<std::size_t, math::AxisAlignedBox>> updates;
+  for (std::size_t i = 0; i < count; i += 2u)
+  {
+    const math::Vector3d offset = (i % 4u == 0u) ?
+        math::Vector3d(0.01, 0, 0) : math::Vector3d(7.3 * next(), 0, 0);
+    nodes[i].second = math::AxisAlignedBox(nodes[i].second.Min() + offset,
+        nodes[i].second.Max() + offset);
+    updates.push_back(nodes[i]);
+  }
+  EXPECT_TRUE(tree.UpdateNode(updates[0].first, updates[0].second));
+  EXPECT_TRUE(reference.UpdateNode(updates[0].first, updates[0].second));
+  EXPECT_TRUE(tree.UpdateNodes(updates));
+  EXPECT_TRUE(reference.UpdateNodes(updates));
+  EXPECT_TRUE(tree.RemoveNode(1u));
+  EXPECT_TRUE(reference.RemoveNode(1u));
+  nodes.erase(nodes.begin() + 1);
+  comparePairs();
+
+  tree.Rebuild();
+  EXPECT_DOUBLE_EQ(1.0, tree.SurfaceAreaRatio());
+  EXPECT_GT(tree.GetMemoryBytes(), 0u);
+  comparePairs();
+
+  // and the tree restored
+  tree.SetGridCellSize(0.0);
+  EXPECT_DOUBLE_EQ(0.0, tree.GetGridCellSize());
+  EXPECT_EQ(0u, tree.NodeCount());
+}
+
+/////////////////////////////////////////////////
+TEST(AABBTree, NodeMasks)
+{
+  AABBTree tree;
+
+  // a pile of overlapping unit boxes on two layers
+  const std::size_t count = 16u;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    math::Vector3d center(0.05 * i, 0, 0);
+    tree.AddNode(i, math::AxisAlignedBox(center - 0.5 * math::Vector3d::One,
+        center + 0.5 * math::Vector3d::One));
+    EXPECT_TRUE(tree.SetNodeMask(i, i % 2u == 0u ? 0x01 : 0x02));
+  }
+  EXPECT_FALSE(tree.SetNodeMask(count + 10u, 0x01));
+
+  // only boxes on the same layer are paired
+  std::vector<std::pair<std::size_t, std::size_t>> pairs;
+  tree.CollisionPairs(pairs);
+  const std::size_t perLayer = count / 2u;
+  EXPECT_EQ(2u * perLayer * (perLayer - 1u) / 2u, pairs.size());
+  for (const auto &[a, b] : pairs)
+    EXPECT_EQ(a % 2u, b % 2u);
+
+  std::vector<std::size_t> result;
+  EXPECT_TRUE(tree.Collisions(0u, result));
+  EXPECT_EQ(perLayer - 1u, result.size());
+  for (const auto id : result)
+    EXPECT_EQ(0u, id % 2u);
+
+  // a node on both layers collides with every other node. Its mask is kept
+  // when the node is moved.
+  EXPECT_TRUE(tree.SetNodeMask(0u, 0x03));
+  EXPECT_TRUE(tree.UpdateNode(0u, math::AxisAlignedBox(
+      -0.4 * math::Vector3d::One, 0.6 * math::Vector3d::One)));
+  result.clear();
+  EXPECT_TRUE(tree.Collisions(0u, result));
+  EXPECT_EQ(count - 1u, result.size());
+  pairs.clear();
+  tree.CollisionPairs(pairs);
+  EXPECT_EQ(2u * perLayer * (perLayer - 1u) / 2u + perLayer, pairs.size());
+}
+
+/////////////////////////////////////////////////
+TEST(AABBTree, RayCast)
+{
+  // unit boxes centered at x = 0, 2, 4, ...
+  AABBTree tree;
+  for (std::size_t i = 0; i < 8u; ++i)
+  {
+    const math::Vector3d center(2.0 * static_cast<double>(i), 0, 0);
+    tree.AddNode(i, math::AxisAlignedBox(
+        center - 0.5 * math::Vector3d::One,
+        center + 0.5 * math::Vector3d::One));
+  }
+
+  // all boxes crossed by the ray
+  std::set<std::size_t> visited;
+  tree.RayCast(math::Vector3d(-1, 0, 0), math::Vector3d::UnitX, 100.0,
+      [&](std::size_t _id, double _maxDistance)
+      {
+        visited.insert(_id);
+        return _maxDistance;
+      });
+  EXPECT_EQ(8u, visited.size());
+
+  // the length of the ray limits the boxes
+  visited.clear();
+  tree.RayCast(math::Vector3d(-1, 0, 0), math::Vector3d::UnitX, 4.0,
+      [&](std::size_t _id, double _maxDistance)
+      {
+        visited.insert(_id);
+        return _maxDistance;
+      });
+  EXPECT_EQ((std::set<std::size_t>{0u, 1u}), visited);
+
+  // shortening the ray in the callback prunes the boxes behind it. Only
+  // the first box visited and the box in front of the new end remain.
+  visited.clear();
+  tree.RayCast(math::Vector3d(-1, 0, 0), math::Vector3d::UnitX, 100.0,
+      [&](std::size_t _id, double _maxDistance)
+      {
+        visited.insert(_id);
+        return std::min(_maxDistance, 1.0);
+      });
+  EXPECT_LE(visited.size(), 2u);
+  EXPECT_EQ(1u, visited.count(0u));
+
+  // a ray that misses every box
+  visited.clear();
+  tree.RayCast(math::Vector3d(-1, 2, 0), math::Vector3d::UnitX, 100.0,
+      [&](std::size_t _id, double _maxDistance)
+      {
+        visited.insert(_id);
+        return _maxDistance;
+      });
+  EXPECT_TRUE(visited.empty());
+}
+
+/////////////////////////////////////////////////
+TEST(AABBTree, Overlaps)
+{
+  // unit boxes centered at x = 0, 2, 4, ...
+  AABBTree tree;
+  for (std::size_t i = 0; i < 8u; ++i)
+  {
+    const math::Vector3d center(2.0 * static_cast<double>(i), 0, 0);
+    tree.AddNode(i, math::AxisAlignedBox(
+        center - 0.5 * math::Vector3d::One,
+        center + 0.5 * math::Vector3d::One));
+  }
+
+  // a region spanning the second to the fourth box
+  std::vector<std::size_t> result;
+  tree.Overlaps(math::AxisAlignedBox(
+      math::Vector3d(1.8, -1, -1), math::Vector3d(6.2, 1, 1)), result);
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ((std::vector<std::size_t>{1u, 2u, 3u}), result);
+
+  // results are appended
+  tree.Overlaps(math::AxisAlignedBox(
+      math::Vector3d(-1, -1, -1), math::Vector3d(0, 1, 1)), result);
+  EXPECT_EQ(4u, result.size());
+  EXPECT_EQ(0u, result.back());
+
+  // a region between boxes, and an empty region
+  result.clear();
+  tree.Overlaps(math::AxisAlignedBox(
+      math::Vector3d(0.7, -1, -1), math::Vector3d(1.3, 1, 1)), result);
+  tree.Overlaps(math::AxisAlignedBox(), result);
+  EXPECT_TRUE(result.empty());
+}
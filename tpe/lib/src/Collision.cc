@@ -93,6 +93,11 @@ void Collision::SetShape(const Shape &_shape)
       static_cast<const EllipsoidShape *>(&_shape);
     this->dataPtr->shape.reset(new EllipsoidShape(*typedShape));
   }
+  else if (_shape.GetType() == ShapeType::PLANE)
+  {
+    const PlaneShape *typedShape = static_cast<const PlaneShape *>(&_shape);
+    this->dataPtr->shape.reset(new PlaneShape(*typedShape));
+  }
   else if (_shape.GetType() == ShapeType::SPHERE)
   {
     const SphereShape *typedShape = dynamic_cast<const SphereShape *>(&_shape);
@@ -103,10 +108,20 @@ void Collision::SetShape(const Shape &_shape)
     const MeshShape *typedShape = dynamic_cast<const MeshShape *>(&_shape);
     this->dataPtr->shape.reset(new MeshShape(*typedShape));
   }
+  else if (_shape.GetType() == ShapeType::HEIGHTMAP)
+  {
+    const HeightmapShape *typedShape =
+      static_cast<const HeightmapShape *>(&_shape);
+    this->dataPtr->shape.reset(new HeightmapShape(*typedShape));
+  }
   else
   {
     gzwarn << "Failed to set shape." << std::endl;
+    return;
   }
+
+  if (this->GetParent())
+    this->GetParent()->ChildrenChanged();
 }
 
 //////////////////////////////////////////////////
@@ -136,3 +151,10 @@ uint16_t Collision::GetCollideBitmask() const
 {
   return this->dataPtr->collideBitmask;
 }
+
+//////////////////////////////////////////////////
+std::size_t Collision::GetMemoryBytes() const
+{
+  return Entity::GetMemoryBytes() + sizeof(Collision) - sizeof(Entity) +
+      sizeof(CollisionPrivate);
+}
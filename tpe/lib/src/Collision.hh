@@ -72,6 +72,10 @@ class GZ_PHYSICS_TPELIB_VISIBLE Collision : public Entity
   // Documentation inherited
   public: math::AxisAlignedBox GetBoundingBox(bool _force) override;
 
+  /// \brief Estimate the memory used by this collision, without its shape
+  /// \return Bytes used by the collision and its private data
+  public: std::size_t GetMemoryBytes() const override;
+
   /// \brief Private data pointer class
   private: CollisionPrivate *dataPtr = nullptr;
 };
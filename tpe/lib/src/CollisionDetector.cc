@@ -15,259 +15,2026 @@
  *
 */
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <map>
 #include <set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <gz/common/Profiler.hh>
+#include <gz/common/WorkerPool.hh>
+#include <gz/math/Helpers.hh>
 
+#include "Collision.hh"
 #include "CollisionDetector.hh"
+#include "Shape.hh"
 #include "Utils.hh"
 
 #include "AABBTree.hh"
 
+/// \brief A collision found below a model, with its world pose and world
+/// axis aligned bounding box
+struct CollisionShape
+{
+  /// \brief Shape of the collision
+  gz::physics::tpelib::Shape *shape;
+
+  /// \brief World pose of the collision
+  gz::math::Pose3d pose;
+
+  /// \brief World axis aligned bounding box of the collision
+  gz::math::AxisAlignedBox box;
+
+  /// \brief Id of the collision entity
+  std::size_t id;
+};
+
+/// \brief An infinite plane below a model, in the world frame
+struct WorldPlane
+{
+  /// \brief Unit normal, pointing out of the solid side
+  gz::math::Vector3d normal;
+
+  /// \brief Height of the plane along its normal
+  double offset;
+
+  /// \brief Id of the collision entity
+  std::size_t id;
+};
+
+/// \brief A collision prepared for queries, with its world pose and
+/// bounding boxes
+struct QueryShape
+{
+  /// \brief Shape of the collision
+  const gz::physics::tpelib::Shape *shape;
+
+  /// \brief World pose of the collision
+  gz::math::Pose3d pose;
+
+  /// \brief Bounding box of the shape in the frame of the collision
+  gz::math::AxisAlignedBox localBox;
+
+  /// \brief World axis aligned bounding box of the collision
+  gz::math::AxisAlignedBox box;
+
+  /// \brief Id of the collision entity
+  std::size_t id;
+};
+
+
+/// \brief Counters and timings of a candidate pair whose boxes intersect
+struct PairStatistics
+{
+  /// \brief Index of the pair in the candidate pairs
+  std::size_t index = 0u;
+
+  /// \brief Number of contacts created for the pair
+  std::size_t contactCount = 0u;
+
+  /// \brief Time spent testing the pair, in seconds
+  double time = 0.0;
+};
+
+/// \brief Contacts created for a candidate pair by the narrowphase, to be
+/// cached once all ranges of pairs are tested
+struct CreatedContacts
+{
+  /// \brief Index of the pair in the candidate pairs
+  std::size_t index = 0u;
+
+  /// \brief First contact of the pair in the contacts of its range
+  std::size_t begin = 0u;
+
+  /// \brief One past the last contact of the pair
+  std::size_t end = 0u;
+};
+
+/// \brief Contacts of a pair of nodes from a previous call, reused while
+/// neither node moves
+struct CachedContacts
+{
+  /// \brief Contacts of the pair
+  std::vector<gz::physics::tpelib::Contact> contacts;
+
+  /// \brief Number of the last call to CheckCollisions that the pair was a
+  /// candidate with intersecting boxes in
+  std::size_t call = 0u;
+};
+
+/// \brief Buffers of the narrowphase of one range of candidate pairs
+struct NarrowphaseScratch
+{
+  /// \brief Collisions of the first and second model of a pair
+  std::vector<CollisionShape> shapes1;
+  std::vector<CollisionShape> shapes2;
+
+  /// \brief Contacts of the range, when it is tested in a worker thread
+  std::vector<gz::physics::tpelib::Contact> contacts;
+
+  /// \brief Counters and timings of the tested pairs of the range, when
+  /// the statistics of each entity are collected
+  std::vector<PairStatistics> pairStatistics;
+
+  /// \brief Pairs of the range whose contacts were created rather than
+  /// reused
+  std::vector<CreatedContacts> created;
+};
+
 /// \brief Private data class for CollisionDetector
 class gz::physics::tpelib::CollisionDetectorPrivate
 {
-  /// \brief Helper function to check if collisions for a pair of nodes have
-  /// already been recorded or not
-  /// \param[in] _a Node A Id
-  /// \param[in] _b Node B Id
-  /// \return True if this is a duplicate collision
-  public: bool CheckDuplicateCollisionPair(std::size_t _a, std::size_t _b);
+  /// \brief Remove the nodes of entities that no longer exist, and add or
+  /// refit the nodes of entities that were added or moved. Nodes that were
+  /// added or refit are appended to movedNodeIds.
+  /// \param[in] _entities List of entities
+  public: void UpdateTree(
+      const std::map<std::size_t, std::shared_ptr<Entity>> &_entities);
+
+  /// \brief Rebuild the AABB tree if its quality degraded by more than
+  /// treeRebuildFactor since it was last built
+  public: void RebuildTreeIfDegraded();
+
+  /// \brief Find the part of the region of intersection of two models where
+  /// their collisions overlap as oriented boxes, spheres or capsules
+  /// \param[in] _e1 First model
+  /// \param[in] _e2 Second model
+  /// \param[in] _region Region where the world boxes of the models intersect
+  /// \param[in,out] _scratch Buffers to collect the collisions into
+  /// \return Part of _region covered by the world boxes of the overlapping
+  /// collision pairs, or an empty box if no pair overlaps
+  public: math::AxisAlignedBox OrientedOverlap(const Entity &_e1,
+      const Entity &_e2, const math::AxisAlignedBox &_region,
+      NarrowphaseScratch &_scratch) const;
+
+  /// \brief Create a contact for each pair of collisions of two models
+  /// that overlap within the region of intersection of the models
+  /// \param[in] _e1 First model
+  /// \param[in] _e2 Second model
+  /// \param[in] _region Region where the world boxes of the models intersect
+  /// \param[in] _singleContact Create a single contact per collision pair
+  /// \param[in,out] _scratch Buffers to collect the collisions into
+  /// \param[out] _contacts Contacts are appended to this vector
+  public: void ShapeContacts(const Entity &_e1, const Entity &_e2,
+      const math::AxisAlignedBox &_region, bool _singleContact,
+      NarrowphaseScratch &_scratch, std::vector<Contact> &_contacts) const;
+
+  /// \brief Create the contacts of a region of intersection, at most
+  /// maxPairContacts of them
+  /// \param[in] _contact Contact with the entities and collisions set
+  /// \param[in] _min Minimum corner of the region
+  /// \param[in] _max Maximum corner of the region
+  /// \param[in] _singleContact Create a single contact at the center of
+  /// the region rather than at its corners
+  /// \param[out] _contacts Contacts are appended to this vector
+  public: void PushContacts(Contact _contact, const math::Vector3d &_min,
+      const math::Vector3d &_max, bool _singleContact,
+      std::vector<Contact> &_contacts) const;
+
+  /// \brief Create the contacts of a range of candidate pairs. Only reads
+  /// the detector, so ranges can be tested concurrently once the bounding
+  /// boxes of the shapes involved are up to date.
+  /// \param[in] _entities List of entities
+  /// \param[in] _begin First candidate pair of the range
+  /// \param[in] _end One past the last candidate pair of the range
+  /// \param[in] _singleContact Create a single contact per pair
+  /// \param[in,out] _scratch Buffers to test the pairs with
+  /// \param[out] _contacts Contacts are appended to this vector
+  public: void PairContacts(
+      const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
+      std::size_t _begin, std::size_t _end, bool _singleContact,
+      NarrowphaseScratch &_scratch, std::vector<Contact> &_contacts) const;
+
+  /// \brief Create the contacts of a candidate pair whose boxes intersect
+  /// \param[in] _entities List of entities
+  /// \param[in] _index Index of the candidate pair
+  /// \param[in] _singleContact Create a single contact for the pair
+  /// \param[in,out] _scratch Buffers to test the pair with
+  /// \param[out] _contacts Contacts are appended to this vector
+  public: void PairContact(
+      const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
+      std::size_t _index, bool _singleContact,
+      NarrowphaseScratch &_scratch, std::vector<Contact> &_contacts) const;
+
+  /// \brief Create the contacts of the entities in the tree with the
+  /// infinite planes of other entities. Planes are kept out of the tree,
+  /// so each entity is tested against each plane by the corner of its box
+  /// that is deepest along the normal of the plane.
+  /// \param[in] _entities List of entities
+  /// \param[in] _singleContact Create a single contact per pair
+  /// \param[in,out] _scratch Buffers to collect the collisions into
+  /// \param[out] _contacts Contacts are appended to this vector
+  public: void PlaneContacts(
+      const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
+      bool _singleContact, NarrowphaseScratch &_scratch,
+      std::vector<Contact> &_contacts) const;
+
+  /// \brief Collect the infinite planes below an entity into planes
+  /// \param[in] _id Id of the entity
+  /// \param[in] _entity Entity whose planes are collected
+  public: void UpdatePlanes(std::size_t _id, const Entity &_entity);
+
+  /// \brief Mark the candidate pairs whose cached contacts are still valid
+  /// because neither node moved since they were created, and drop the
+  /// cache if the contacts would be created differently
+  /// \param[in] _singleContact Create a single contact per pair
+  public: void FindReusableContacts(bool _singleContact);
+
+  /// \brief Cache the contacts created by the first _chunks scratch
+  /// buffers and drop the pairs that were not candidates in this call
+  /// \param[in] _chunks Number of scratch buffers that were used
+  /// \param[in] _contacts Contacts of the call, the ranges concatenated
+  public: void CacheContacts(std::size_t _chunks,
+      const std::vector<Contact> &_contacts);
+
+  /// \brief Fill the statistics of each entity from the candidate pairs
+  /// and the pair statistics of the first _chunks scratch buffers
+  /// \param[in] _chunks Number of scratch buffers that were used
+  public: void CollectEntityStatistics(std::size_t _chunks);
+
+  /// \brief Remove all cached overlapping pairs that involve a node
+  /// \param[in] _id Node id
+  public: void RemoveOverlaps(std::size_t _id);
+
+  /// \brief Query the AABB tree for a node and replace its cached
+  /// overlapping pairs by the ones found. The cache is left as is if the
+  /// pairs did not change.
+  /// \param[in] _id Node id
+  public: void UpdateOverlaps(std::size_t _id);
+
+  /// \brief Check whether the cache of overlaps holds exactly some pairs
+  /// \param[in] _pairs Pairs with the smaller node id first, sorted
+  /// \return True if the cache holds these pairs and no other
+  public: bool OverlapsMatch(
+      const std::vector<std::pair<std::size_t, std::size_t>> &_pairs) const;
 
   /// \brief AABB tree
   public: AABBTree aabbTree;
 
-  /// \brief Set of entity id
-  public: std::set<std::size_t> nodeIds;
+  /// \brief Set of entity id
+  public: std::set<std::size_t> nodeIds;
+
+  /// \brief Infinite planes of the entities that have any, by entity id.
+  /// They are not in the tree.
+  public: std::map<std::size_t, std::vector<WorldPlane>> planes;
+
+  /// \brief Planes collected by UpdatePlanes. Kept as a member to reuse its
+  /// storage.
+  public: std::vector<WorldPlane> collectedPlanes;
+
+  /// \brief Persistent cache of nodes whose AABBs overlap in the tree. The
+  /// cache is symmetric: if b is in overlaps[a] then a is in overlaps[b].
+  /// Only nodes that were added or moved since the last call re-query the
+  /// tree, pairs between nodes at rest are reused as-is.
+  public: std::map<std::size_t, std::set<std::size_t>> overlaps;
+
+  /// \brief Nodes that were added or moved since the overlaps were last
+  /// refreshed, by CheckCollisions or PrepareQueries
+  public: std::vector<std::size_t> movedNodeIds;
+
+  /// \brief Nodes found by UpdateTree that are not yet in the tree, added
+  /// to it in one pass. Kept as a member to reuse its storage.
+  public: std::vector<std::pair<std::size_t, math::AxisAlignedBox>>
+      addedNodes;
+
+  /// \brief Scratch buffer for tree queries, reused across calls
+  public: std::vector<std::size_t> queryResult;
+
+  /// \brief Scratch buffer for tree self-queries, reused across calls
+  public: std::vector<std::pair<std::size_t, std::size_t>> pairs;
+
+  /// \brief Candidate pairs for the narrowphase in the current call
+  public: std::vector<std::pair<std::size_t, std::size_t>> candidates;
+
+  /// \brief World AABB of the first entity of each candidate pair
+  public: AxisAlignedBoxBatch boxes1;
+
+  /// \brief World AABB of the second entity of each candidate pair
+  public: AxisAlignedBoxBatch boxes2;
+
+  /// \brief Region of intersection of each candidate pair
+  public: AxisAlignedBoxBatch intersections;
+
+  /// \brief Whether each candidate pair intersects
+  public: std::vector<uint8_t> hits;
+
+  /// \brief True to test oriented bounding boxes in the narrowphase
+  public: bool orientedBoxes = false;
+
+  /// \brief See CollisionDetector::SetShapeContacts
+  public: bool shapeContacts = false;
+
+  /// \brief Contacts of the candidate pairs with intersecting boxes of the
+  /// last call, by pair of node ids with the smaller id first
+  public: std::map<std::pair<std::size_t, std::size_t>, CachedContacts>
+      contactCache;
+
+  /// \brief See CollisionDetector::SetMaxContactsPerPair
+  public: std::size_t maxPairContacts =
+      std::numeric_limits<std::size_t>::max();
+
+  /// \brief Whether the cached contacts were created with a single contact
+  /// per pair
+  public: bool cachedSingleContact = false;
+
+  /// \brief Number of calls to CheckCollisions so far
+  public: std::size_t callCount = 0u;
+
+  /// \brief Whether each candidate pair reuses its cached contacts
+  public: std::vector<uint8_t> reuseContacts;
+
+  /// \brief See CollisionDetector::SetTreeRebuildFactor
+  public: double treeRebuildFactor = 0.0;
+
+  /// \brief Surface area ratio of the AABB tree after it was last built, 0
+  /// if it has to be measured again
+  public: double builtTreeRatio = 0.0;
+
+  /// \brief Narrowphase buffers of each range of candidate pairs, reused
+  /// across calls. The first one is used when testing in the calling
+  /// thread.
+  public: std::vector<NarrowphaseScratch> scratch;
+
+  /// \brief See CollisionDetector::SetNumThreads
+  public: std::size_t numThreads = 1u;
+
+  /// \brief Worker pool of the narrowphase. Created lazily on the first
+  /// parallel call, and recreated when the number of threads changes.
+  public: std::unique_ptr<common::WorkerPool> workerPool;
+
+  /// \brief Number of threads of workerPool
+  public: std::size_t workerPoolThreads = 0u;
+
+  /// \brief See CollisionDetector::SetTaskRunner
+  public: TaskRunner taskRunner;
+
+  /// \brief Counters and timings of the last call to CheckCollisions
+  public: CollisionStatistics statistics;
+
+  /// \brief See CollisionDetector::SetEntityStatistics
+  public: bool entityStatistics = false;
+
+  /// \brief See CollisionDetector::SetAllocationCounter
+  public: AllocationCounter allocationCounter = nullptr;
+
+  /// \brief Collisions prepared for queries. The collisions of a node are
+  /// contiguous.
+  public: std::vector<QueryShape> queryShapes;
+
+  /// \brief Range of queryShapes holding the collisions of each node
+  public: std::unordered_map<std::size_t, std::pair<std::size_t, std::size_t>>
+      queryShapeRanges;
+};
+
+using namespace gz;
+using namespace physics;
+using namespace tpelib;
+
+//////////////////////////////////////////////////
+/// \brief Get all corners of the region of intersection between two boxes
+/// \param[in] _min Minimum corner of the intersection region
+/// \param[in] _max Maximum corner of the intersection region
+/// \return The 8 corners of the intersection region
+static std::array<math::Vector3d, 8> intersectionCorners(
+    const math::Vector3d &_min, const math::Vector3d &_max)
+{
+  return {
+    // min min min
+    math::Vector3d(_min.X(), _min.Y(), _min.Z()),
+    // min min max
+    math::Vector3d(_min.X(), _min.Y(), _max.Z()),
+    // min max max
+    math::Vector3d(_min.X(), _max.Y(), _max.Z()),
+    // min max min
+    math::Vector3d(_min.X(), _max.Y(), _min.Z()),
+    // max max min
+    math::Vector3d(_max.X(), _max.Y(), _min.Z()),
+    // max max max
+    math::Vector3d(_max.X(), _max.Y(), _max.Z()),
+    // max min max
+    math::Vector3d(_max.X(), _min.Y(), _max.Z()),
+    // max min min
+    math::Vector3d(_max.X(), _min.Y(), _min.Z())};
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the region where two boxes intersect
+/// \param[in] _b1 First box
+/// \param[in] _b2 Second box
+/// \return Region of the intersection, or an empty box if the boxes do not
+/// intersect
+static math::AxisAlignedBox clipAxisAlignedBox(
+    const math::AxisAlignedBox &_b1, const math::AxisAlignedBox &_b2)
+{
+  if (!_b1.Intersects(_b2))
+    return math::AxisAlignedBox();
+
+  math::Vector3d min = _b1.Min();
+  math::Vector3d max = _b1.Max();
+  min.Max(_b2.Min());
+  max.Min(_b2.Max());
+  return math::AxisAlignedBox(min, max);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether a shape limits contacts to a part of its bounding
+/// box: a mesh with a triangle hierarchy, or a heightmap
+/// \param[in] _shape Shape to check
+/// \return True if the shape refines the region of contacts
+static bool refinesContacts(const Shape &_shape)
+{
+  if (_shape.GetType() == ShapeType::HEIGHTMAP)
+    return true;
+  return _shape.GetType() == ShapeType::MESH &&
+      static_cast<const MeshShape &>(_shape).GetTriangleBvh();
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether any collision below an entity refines the region of
+/// contacts, see refinesContacts
+/// \param[in] _entity Entity to check
+/// \return True if a collision refines the region of contacts
+static bool hasRefinedShape(const Entity &_entity)
+{
+  for (const auto &it : _entity.GetChildren())
+  {
+    auto *collision = dynamic_cast<const Collision *>(it.second.get());
+    if (!collision)
+    {
+      if (hasRefinedShape(*it.second))
+        return true;
+      continue;
+    }
+
+    const Shape *shape = collision->GetShape();
+    if (shape && refinesContacts(*shape))
+      return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+/// \brief Bring the cached bounding boxes of the shapes of the collisions
+/// below an entity up to date, so that they can be read concurrently
+/// \param[in] _entity Entity whose collisions are updated
+static void updateShapeBoxes(const Entity &_entity)
+{
+  for (const auto &it : _entity.GetChildren())
+  {
+    auto *collision = dynamic_cast<const Collision *>(it.second.get());
+    if (!collision)
+    {
+      updateShapeBoxes(*it.second);
+      continue;
+    }
+
+    if (Shape *shape = collision->GetShape())
+      shape->GetBoundingBox();
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Limit a region that a shape reaches into to where its triangles
+/// do, for meshes with a triangle hierarchy, or to where it is below the
+/// terrain, for heightmaps
+/// \param[in] _shape Shape to refine the region with
+/// \param[in] _pose World pose of the shape
+/// \param[in] _region Region in the world frame within the world box of
+/// the shape
+/// \return Part of _region, _region itself for other shapes
+static math::AxisAlignedBox refineRegion(Shape &_shape,
+    const math::Pose3d &_pose, const math::AxisAlignedBox &_region)
+{
+  if (_region == math::AxisAlignedBox() || !refinesContacts(_shape))
+    return _region;
+
+  // the shape is queried with the region in its own frame, and its part of
+  // it is brought back to the world frame
+  const math::AxisAlignedBox box =
+      transformAxisAlignedBox(_region, _pose.Inverse());
+  const math::AxisAlignedBox local =
+      _shape.GetType() == ShapeType::HEIGHTMAP ?
+      static_cast<HeightmapShape &>(_shape).GetHeightOverlap(box) :
+      static_cast<MeshShape &>(_shape).GetTriangleOverlap(box);
+  return clipAxisAlignedBox(transformAxisAlignedBox(local, _pose), _region);
+}
+
+//////////////////////////////////////////////////
+/// \brief Find the part of a region that the collisions below an entity
+/// reach into. Meshes with a triangle hierarchy reach into the region where
+/// their triangles do, heightmaps where the region is below their terrain,
+/// every other collision where its bounding box does.
+/// \param[in] _entity Entity whose collisions are checked
+/// \param[in] _pose World pose of _entity
+/// \param[in] _region Region in the world frame
+/// \param[in,out] _touched Merged with the part of _region that each
+/// collision reaches into
+static void touchedRegion(const Entity &_entity, const math::Pose3d &_pose,
+    const math::AxisAlignedBox &_region, math::AxisAlignedBox &_touched)
+{
+  for (const auto &it : _entity.GetChildren())
+  {
+    const math::Pose3d pose = _pose * it.second->GetPose();
+    auto *collision = dynamic_cast<const Collision *>(it.second.get());
+    if (!collision)
+    {
+      touchedRegion(*it.second, pose, _region, _touched);
+      continue;
+    }
+
+    Shape *shape = collision->GetShape();
+    if (!shape)
+      continue;
+
+    const math::AxisAlignedBox overlap = refineRegion(*shape, pose,
+        clipAxisAlignedBox(
+            transformAxisAlignedBox(shape->GetBoundingBox(), pose), _region));
+    if (overlap != math::AxisAlignedBox())
+      _touched.Merge(overlap);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the collisions below an entity whose world boxes reach
+/// into a region
+/// \param[in] _entity Entity whose collisions are collected
+/// \param[in] _pose World pose of _entity
+/// \param[in] _region Region in the world frame
+/// \param[out] _shapes Collisions are appended to this vector
+static void collectShapes(const Entity &_entity, const math::Pose3d &_pose,
+    const math::AxisAlignedBox &_region, std::vector<CollisionShape> &_shapes)
+{
+  for (const auto &it : _entity.GetChildren())
+  {
+    const math::Pose3d pose = _pose * it.second->GetPose();
+    auto *collision = dynamic_cast<const Collision *>(it.second.get());
+    if (!collision)
+    {
+      collectShapes(*it.second, pose, _region, _shapes);
+      continue;
+    }
+
+    Shape *shape = collision->GetShape();
+    if (!shape)
+      continue;
+
+    math::AxisAlignedBox box =
+        transformAxisAlignedBox(shape->GetBoundingBox(), pose);
+    if (box.Intersects(_region))
+      _shapes.push_back({shape, pose, box, collision->GetId()});
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the infinite planes below an entity
+/// \param[in] _entity Entity whose collisions are collected
+/// \param[in] _pose World pose of _entity
+/// \param[out] _planes Planes are appended to this vector
+static void collectPlanes(const Entity &_entity, const math::Pose3d &_pose,
+    std::vector<WorldPlane> &_planes)
+{
+  for (const auto &it : _entity.GetChildren())
+  {
+    const math::Pose3d pose = _pose * it.second->GetPose();
+    auto *collision = dynamic_cast<const Collision *>(it.second.get());
+    if (!collision)
+    {
+      collectPlanes(*it.second, pose, _planes);
+      continue;
+    }
+
+    const Shape *shape = collision->GetShape();
+    if (!shape || shape->GetType() != ShapeType::PLANE)
+      continue;
+
+    const math::Vector3d normal = pose.Rot().RotateVector(
+        static_cast<const PlaneShape *>(shape)->GetNormal());
+    _planes.push_back({normal, normal.Dot(pose.Pos()), collision->GetId()});
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the region of a box that is below a plane
+/// \param[in] _box Box in the world frame
+/// \param[in] _plane Plane in the world frame
+/// \return Box around the part of _box below _plane, or an empty box if
+/// _box is above it
+static math::AxisAlignedBox clipBelowPlane(
+    const math::AxisAlignedBox &_box, const WorldPlane &_plane)
+{
+  if (_box == math::AxisAlignedBox())
+    return _box;
+
+  // the corner deepest along the normal is the only one that needs to be
+  // checked to know whether the box reaches below the plane
+  const math::Vector3d &n = _plane.normal;
+  const math::Vector3d &min = _box.Min();
+  const math::Vector3d &max = _box.Max();
+  const math::Vector3d deepest(n.X() > 0.0 ? min.X() : max.X(),
+                               n.Y() > 0.0 ? min.Y() : max.Y(),
+                               n.Z() > 0.0 ? min.Z() : max.Z());
+  if (n.Dot(deepest) > _plane.offset)
+    return math::AxisAlignedBox();
+
+  // the part below is bounded by the corners below the plane and by the
+  // points where the edges of the box cross it. Bit k of a corner index
+  // picks the maximum along axis k.
+  std::array<math::Vector3d, 8> corners;
+  std::array<double, 8> heights;
+  for (std::size_t i = 0u; i < corners.size(); ++i)
+  {
+    corners[i].Set((i & 1u) ? max.X() : min.X(), (i & 2u) ? max.Y() : min.Y(),
+        (i & 4u) ? max.Z() : min.Z());
+    heights[i] = n.Dot(corners[i]) - _plane.offset;
+  }
+
+  math::AxisAlignedBox region;
+  for (std::size_t i = 0u; i < corners.size(); ++i)
+  {
+    if (heights[i] <= 0.0)
+      region.Merge(math::AxisAlignedBox(corners[i], corners[i]));
+    for (std::size_t bit = 1u; bit < corners.size(); bit <<= 1u)
+    {
+      const std::size_t j = i | bit;
+      if (j == i || (heights[i] <= 0.0) == (heights[j] <= 0.0))
+        continue;
+      const math::Vector3d p = corners[i] +
+          (corners[j] - corners[i]) * (heights[i] / (heights[i] - heights[j]));
+      region.Merge(math::AxisAlignedBox(p, p));
+    }
+  }
+  return region;
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the collisions below an entity for queries, and bring the
+/// cached bounding boxes of their shapes up to date
+/// \param[in] _entity Entity whose collisions are collected
+/// \param[in] _pose World pose of _entity
+/// \param[out] _shapes Collisions are appended to this vector
+static void collectQueryShapes(const Entity &_entity,
+    const math::Pose3d &_pose, std::vector<QueryShape> &_shapes)
+{
+  for (const auto &it : _entity.GetChildren())
+  {
+    const math::Pose3d pose = _pose * it.second->GetPose();
+    auto *collision = dynamic_cast<const Collision *>(it.second.get());
+    if (!collision)
+    {
+      collectQueryShapes(*it.second, pose, _shapes);
+      continue;
+    }
+
+    Shape *shape = collision->GetShape();
+    if (!shape)
+      continue;
+
+    const math::AxisAlignedBox localBox = shape->GetBoundingBox();
+    _shapes.push_back({shape, pose, localBox,
+        transformAxisAlignedBox(localBox, pose), collision->GetId()});
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the axis segment of a sphere or capsule
+/// \param[in] _shape Sphere or capsule
+/// \param[in] _pose World pose of the shape
+/// \param[out] _p Start of the segment in the world frame
+/// \param[out] _q End of the segment in the world frame
+/// \param[out] _radius Radius around the segment
+/// \return False if the shape is neither a sphere nor a capsule
+static bool roundSegment(const Shape &_shape, const math::Pose3d &_pose,
+    math::Vector3d &_p, math::Vector3d &_q, double &_radius)
+{
+  if (_shape.GetType() == ShapeType::SPHERE)
+  {
+    _p = _pose.Pos();
+    _q = _p;
+    _radius = static_cast<const SphereShape &>(_shape).GetRadius();
+    return true;
+  }
+  if (_shape.GetType() == ShapeType::CAPSULE)
+  {
+    auto &capsule = static_cast<const CapsuleShape &>(_shape);
+    const math::Vector3d halfAxis =
+        _pose.Rot() * math::Vector3d(0, 0, 0.5 * capsule.GetLength());
+    _p = _pose.Pos() - halfAxis;
+    _q = _pose.Pos() + halfAxis;
+    _radius = capsule.GetRadius();
+    return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether two collisions overlap. Pairs of spheres and
+/// capsules are tested by the distance between their axes, a sphere against
+/// any other shape by its distance to the oriented bounding box of that
+/// shape, and every other pair by their oriented bounding boxes.
+/// \param[in] _a First collision
+/// \param[in] _b Second collision
+/// \return True if the collisions overlap
+static bool shapesOverlap(const CollisionShape &_a, const CollisionShape &_b)
+{
+  math::Vector3d pa, qa, pb, qb;
+  double ra = 0.0;
+  double rb = 0.0;
+  const bool roundA = roundSegment(*_a.shape, _a.pose, pa, qa, ra);
+  const bool roundB = roundSegment(*_b.shape, _b.pose, pb, qb, rb);
+  if (roundA && roundB)
+    return squaredSegmentDistance(pa, qa, pb, qb) <= (ra + rb) * (ra + rb);
+
+  if (roundA && _a.shape->GetType() == ShapeType::SPHERE)
+  {
+    return squaredDistanceToOrientedBox(
+        pa, _b.shape->GetBoundingBox(), _b.pose) <= ra * ra;
+  }
+  if (roundB && _b.shape->GetType() == ShapeType::SPHERE)
+  {
+    return squaredDistanceToOrientedBox(
+        pb, _a.shape->GetBoundingBox(), _a.pose) <= rb * rb;
+  }
+
+  return orientedBoxesIntersect(_a.shape->GetBoundingBox(), _a.pose,
+      _b.shape->GetBoundingBox(), _b.pose);
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the bounding box of a query volume in its own frame
+/// \param[in] _volume Sphere or box
+/// \return Box centered on the origin
+static math::AxisAlignedBox volumeBox(const QueryVolume &_volume)
+{
+  const math::Vector3d half = _volume.type == ShapeType::SPHERE ?
+      math::Vector3d(_volume.radius, _volume.radius, _volume.radius) :
+      _volume.size * 0.5;
+  return math::AxisAlignedBox(-half, half);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether a query volume overlaps a collision, with the same
+/// tests as shapesOverlap
+/// \param[in] _volume Sphere or box
+/// \param[in] _shape Collision prepared for queries
+/// \return True if they overlap
+static bool volumeOverlaps(const QueryVolume &_volume,
+    const QueryShape &_shape)
+{
+  math::Vector3d p, q;
+  double radius = 0.0;
+  const bool round = roundSegment(*_shape.shape, _shape.pose, p, q, radius);
+  if (_volume.type == ShapeType::SPHERE)
+  {
+    const math::Vector3d &center = _volume.pose.Pos();
+    const double r = _volume.radius;
+    if (round)
+    {
+      return squaredSegmentDistance(center, center, p, q) <=
+          (r + radius) * (r + radius);
+    }
+    return squaredDistanceToOrientedBox(
+        center, _shape.localBox, _shape.pose) <= r * r;
+  }
+
+  if (round && _shape.shape->GetType() == ShapeType::SPHERE)
+  {
+    return squaredDistanceToOrientedBox(
+        p, volumeBox(_volume), _volume.pose) <= radius * radius;
+  }
+  return orientedBoxesIntersect(
+      volumeBox(_volume), _volume.pose, _shape.localBox, _shape.pose);
+}
+
+//////////////////////////////////////////////////
+CollisionDetector::CollisionDetector()
+  : dataPtr(new CollisionDetectorPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+CollisionDetector::~CollisionDetector() = default;
+
+//////////////////////////////////////////////////
+std::vector<Contact> CollisionDetector::CheckCollisions(
+    const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
+    bool _singleContact)
+{
+  std::vector<Contact> contacts;
+  this->CheckCollisions(_entities, contacts, _singleContact);
+  return contacts;
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::CheckCollisions(
+    const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
+    std::vector<Contact> &_contacts,
+    bool _singleContact)
+{
+  GZ_PROFILE("tpelib::CollisionDetector::CheckCollisions");
+  const auto start = std::chrono::steady_clock::now();
+  const AllocationCounter allocations = this->dataPtr->allocationCounter;
+  const std::size_t startAllocations = allocations ? allocations() : 0u;
+
+  // contacts to be filled
+  std::vector<Contact> &contacts = _contacts;
+  contacts.clear();
+
+  // update AABB tree
+  this->dataPtr->UpdateTree(_entities);
+
+  // nodes refit by PrepareQueries since the last call are also in the list
+  // of moved nodes, possibly more than once or after they were removed
+  auto &moved = this->dataPtr->movedNodeIds;
+  std::sort(moved.begin(), moved.end());
+  moved.erase(std::unique(moved.begin(), moved.end()), moved.end());
+  moved.erase(std::remove_if(moved.begin(), moved.end(),
+      [this](std::size_t _id)
+      {
+        return this->dataPtr->nodeIds.find(_id) ==
+            this->dataPtr->nodeIds.end();
+      }), moved.end());
+
+  // refresh cached overlapping pairs of nodes that moved. Pairs between
+  // two nodes that did not move are still valid. If most of the nodes moved
+  // it is cheaper to rebuild the whole cache with a single tree self-query.
+  if (2u * this->dataPtr->movedNodeIds.size() >= this->dataPtr->nodeIds.size())
+  {
+    // Bodies that move together keep their pairs, in which case the cache
+    // and the memory of its nodes are kept as they are.
+    this->dataPtr->pairs.clear();
+    this->dataPtr->aabbTree.CollisionPairs(this->dataPtr->pairs);
+    auto &pairs = this->dataPtr->pairs;
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    if (!this->dataPtr->OverlapsMatch(pairs))
+    {
+      this->dataPtr->overlaps.clear();
+      for (const auto &[a, b] : pairs)
+      {
+        this->dataPtr->overlaps[a].insert(b);
+        this->dataPtr->overlaps[b].insert(a);
+      }
+    }
+  }
+  else
+  {
+    for (auto id : this->dataPtr->movedNodeIds)
+      this->dataPtr->UpdateOverlaps(id);
+  }
+
+  // gather candidate pairs from the cache
+  this->dataPtr->candidates.clear();
+  this->dataPtr->boxes1.Clear();
+  this->dataPtr->boxes2.Clear();
+  for (const auto &[id, result] : this->dataPtr->overlaps)
+  {
+    const std::shared_ptr<Entity> &e = _entities.at(id);
+    // Skip if the entity is static or sleeping. Its pairs with awake
+    // entities are checked from their side.
+    if (e->GetStatic() || e->GetSleeping())
+      continue;
+
+    // only entities with a bounding box are in the tree, so there is no
+    // need to check for empty boxes here
+    math::AxisAlignedBox wb1 = this->dataPtr->aabbTree.AABB(id);
+
+    // the tree only pairs entities whose collide bitmasks share a bit, so
+    // the cache holds no pairs that are filtered out
+    for (const auto &nId : result)
+    {
+      const std::shared_ptr<Entity> &e2 = _entities.at(nId);
+
+      // skip if this pair has already been checked from the other node
+      if (nId < id && !e2->GetStatic() && !e2->GetSleeping())
+        continue;
+
+      this->dataPtr->candidates.emplace_back(id, nId);
+      this->dataPtr->boxes1.PushBack(wb1);
+      this->dataPtr->boxes2.PushBack(this->dataPtr->aabbTree.AABB(nId));
+    }
+  }
+
+  const auto broadphaseEnd = std::chrono::steady_clock::now();
+  const std::size_t broadphaseAllocations = allocations ? allocations() : 0u;
+
+  // check intersection of all candidate pairs at once
+  std::size_t hitCount = intersectAxisAlignedBoxes(
+      this->dataPtr->boxes1, this->dataPtr->boxes2,
+      this->dataPtr->intersections, this->dataPtr->hits);
+  contacts.reserve(hitCount * (_singleContact ? 1u : 8u));
+
+  // pairs between nodes that did not move keep the contacts of the last
+  // call, so resting contacts are not created again
+  this->dataPtr->FindReusableContacts(_singleContact);
+  this->dataPtr->movedNodeIds.clear();
+
+  const std::size_t count = this->dataPtr->candidates.size();
+  const std::size_t numThreads = this->dataPtr->numThreads;
+  std::size_t usedScratch = 1u;
+  if (numThreads <= 1u || hitCount < 2u)
+  {
+    this->dataPtr->scratch.resize(
+        std::max<std::size_t>(this->dataPtr->scratch.size(), 1u));
+    this->dataPtr->scratch.front().pairStatistics.clear();
+    this->dataPtr->scratch.front().created.clear();
+    this->dataPtr->PairContacts(_entities, 0u, count, _singleContact,
+        this->dataPtr->scratch.front(), contacts);
+  }
+  else
+  {
+    GZ_PROFILE("tpelib::CollisionDetector::ParallelNarrowphase");
+    // shapes compute their bounding boxes on first use after a change, so
+    // this is done here rather than concurrently by the workers
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      if (!this->dataPtr->hits[i])
+        continue;
+      updateShapeBoxes(*_entities.at(this->dataPtr->candidates[i].first));
+      updateShapeBoxes(*_entities.at(this->dataPtr->candidates[i].second));
+    }
+
+    // Each range of pairs writes its own contacts, which are concatenated
+    // in order, so the result does not depend on scheduling.
+    const std::size_t chunks = std::min(numThreads, count);
+    const std::size_t chunkSize = (count + chunks - 1u) / chunks;
+    const std::size_t ranges = (count + chunkSize - 1u) / chunkSize;
+    if (this->dataPtr->scratch.size() < ranges)
+      this->dataPtr->scratch.resize(ranges);
+    runTasks(this->dataPtr->taskRunner, this->dataPtr->workerPool,
+        this->dataPtr->workerPoolThreads, numThreads, ranges,
+        [this, &_entities, chunkSize, count, _singleContact](
+            std::size_t _chunk)
+        {
+          const std::size_t begin = _chunk * chunkSize;
+          const std::size_t end = std::min(begin + chunkSize, count);
+          NarrowphaseScratch &scratch = this->dataPtr->scratch[_chunk];
+          scratch.contacts.clear();
+          scratch.pairStatistics.clear();
+          scratch.created.clear();
+          this->dataPtr->PairContacts(_entities, begin, end,
+              _singleContact, scratch, scratch.contacts);
+        });
+    usedScratch = ranges;
+
+    for (std::size_t c = 0u; c < ranges; ++c)
+    {
+      NarrowphaseScratch &scratch = this->dataPtr->scratch[c];
+      for (CreatedContacts &created : scratch.created)
+      {
+        created.begin += contacts.size();
+        created.end += contacts.size();
+      }
+      contacts.insert(contacts.end(), scratch.contacts.begin(),
+          scratch.contacts.end());
+    }
+  }
+  this->dataPtr->CacheContacts(usedScratch, contacts);
+
+  // the contacts with planes are not cached, they are found without
+  // candidate pairs
+  if (!this->dataPtr->planes.empty())
+  {
+    this->dataPtr->PlaneContacts(_entities, _singleContact,
+        this->dataPtr->scratch.front(), contacts);
+  }
+
+  auto &stats = this->dataPtr->statistics;
+  stats.broadphaseTime =
+      std::chrono::duration<double>(broadphaseEnd - start).count();
+  stats.narrowphaseTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - broadphaseEnd).count();
+  stats.candidatePairCount = this->dataPtr->candidates.size();
+  stats.reusedPairCount = static_cast<std::size_t>(std::count(
+      this->dataPtr->reuseContacts.begin(),
+      this->dataPtr->reuseContacts.end(), 1u));
+  stats.broadphaseAllocations = broadphaseAllocations - startAllocations;
+  stats.narrowphaseAllocations = allocations ?
+      allocations() - broadphaseAllocations : 0u;
+  stats.entities.clear();
+  if (this->dataPtr->entityStatistics)
+    this->dataPtr->CollectEntityStatistics(usedScratch);
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::PrepareQueries(
+    const std::map<std::size_t, std::shared_ptr<Entity>> &_entities)
+{
+  GZ_PROFILE("tpelib::CollisionDetector::PrepareQueries");
+  this->dataPtr->UpdateTree(_entities);
+
+  this->dataPtr->queryShapes.clear();
+  this->dataPtr->queryShapeRanges.clear();
+  for (auto id : this->dataPtr->nodeIds)
+  {
+    const std::shared_ptr<Entity> &e = _entities.at(id);
+    const std::size_t begin = this->dataPtr->queryShapes.size();
+    collectQueryShapes(*e, e->GetPose(), this->dataPtr->queryShapes);
+    this->dataPtr->queryShapeRanges[id] =
+        std::make_pair(begin, this->dataPtr->queryShapes.size());
+  }
+}
+
+//////////////////////////////////////////////////
+RayHit CollisionDetector::CastRay(
+    const math::Vector3d &_from, const math::Vector3d &_to) const
+{
+  RayHit hit;
+  math::Vector3d direction = _to - _from;
+  const double length = direction.Length();
+  if (length <= 0.0)
+    return hit;
+  direction /= length;
+
+  this->dataPtr->aabbTree.RayCast(_from, direction, length,
+      [&](std::size_t _id, double _maxDistance)
+      {
+        auto it = this->dataPtr->queryShapeRanges.find(_id);
+        if (it == this->dataPtr->queryShapeRanges.end())
+          return _maxDistance;
+
+        for (std::size_t i = it->second.first; i < it->second.second; ++i)
+        {
+          const QueryShape &s = this->dataPtr->queryShapes[i];
+          double distance = 0.0;
+          math::Vector3d normal;
+          if (!s.shape->RayIntersection(
+              s.pose.Rot().RotateVectorReverse(_from - s.pose.Pos()),
+              s.pose.Rot().RotateVectorReverse(direction), _maxDistance,
+              distance, normal))
+          {
+            continue;
+          }
+
+          _maxDistance = distance;
+          hit.entity = s.id;
+          hit.distance = distance;
+          hit.normal = s.pose.Rot().RotateVector(normal);
+        }
+        return _maxDistance;
+      });
+
+  // planes are solid below, so rays that start there do not hit them
+  for (const auto &entityPlanes : this->dataPtr->planes)
+  {
+    for (const WorldPlane &plane : entityPlanes.second)
+    {
+      const double height = plane.normal.Dot(_from) - plane.offset;
+      const double speed = plane.normal.Dot(direction);
+      if (height < 0.0 || speed >= 0.0)
+        continue;
+
+      const double distance = -height / speed;
+      if (distance > length || distance >= hit.distance)
+        continue;
+      hit.entity = plane.id;
+      hit.distance = distance;
+      hit.normal = plane.normal;
+    }
+  }
+  return hit;
+}
+
+//////////////////////////////////////////////////
+RayHit CollisionDetector::CastVolume(
+    const QueryVolume &_volume, const math::Vector3d &_to) const
+{
+  RayHit hit;
+  const math::Vector3d &from = _volume.pose.Pos();
+  math::Vector3d direction = _to - from;
+  const double length = direction.Length();
+  if (length > 0.0)
+    direction /= length;
+
+  // Candidates are the nodes that the box around the whole sweep overlaps
+  const math::AxisAlignedBox start =
+      transformAxisAlignedBox(volumeBox(_volume), _volume.pose);
+  math::AxisAlignedBox sweep = start;
+  sweep.Merge(start + (_to - from));
+  std::vector<std::size_t> nodes;
+  this->dataPtr->aabbTree.Overlaps(sweep, nodes);
+
+  double maxDistance = length;
+  for (std::size_t id : nodes)
+  {
+    auto it = this->dataPtr->queryShapeRanges.find(id);
+    if (it == this->dataPtr->queryShapeRanges.end())
+      continue;
+
+    for (std::size_t i = it->second.first; i < it->second.second; ++i)
+    {
+      const QueryShape &s = this->dataPtr->queryShapes[i];
+      if (!s.box.Intersects(sweep))
+        continue;
+
+      if (volumeOverlaps(_volume, s))
+      {
+        if (hit.entity == kNullEntityId || hit.distance > 0.0 ||
+            s.id < hit.entity)
+        {
+          hit.entity = s.id;
+          hit.distance = 0.0;
+          hit.normal = -direction;
+        }
+        maxDistance = 0.0;
+        continue;
+      }
+      if (length <= 0.0 || maxDistance <= 0.0)
+        continue;
+
+      // Sweep the center of the volume in the frame of the collision
+      const math::Vector3d origin =
+          s.pose.Rot().RotateVectorReverse(from - s.pose.Pos());
+      const math::Vector3d localDirection =
+          s.pose.Rot().RotateVectorReverse(direction);
+      double distance = 0.0;
+      math::Vector3d normal;
+      bool found = false;
+      if (_volume.type == ShapeType::SPHERE &&
+          s.shape->GetType() == ShapeType::SPHERE)
+      {
+        const double radius = _volume.radius +
+            static_cast<const SphereShape *>(s.shape)->GetRadius();
+        found = rayIntersectsSphere(origin, localDirection, math::Vector3d(),
+            radius, maxDistance, distance, normal);
+      }
+      else
+      {
+        // Extent of the volume along the axes of the collision
+        const math::Quaterniond rot =
+            s.pose.Rot().Inverse() * _volume.pose.Rot();
+        math::Vector3d extent = volumeBox(_volume).Max();
+        if (_volume.type == ShapeType::BOX)
+        {
+          const math::Vector3d x = rot * math::Vector3d(extent.X(), 0, 0);
+          const math::Vector3d y = rot * math::Vector3d(0, extent.Y(), 0);
+          const math::Vector3d z = rot * math::Vector3d(0, 0, extent.Z());
+          extent = x.Abs() + y.Abs() + z.Abs();
+        }
+        const math::AxisAlignedBox grown(
+            s.localBox.Min() - extent, s.localBox.Max() + extent);
+        if (grown.Contains(origin))
+        {
+          // Within the margin of the grown box, e.g. next to a corner
+          normal = -localDirection;
+          found = true;
+        }
+        else
+        {
+          found = rayIntersectsAxisAlignedBox(origin, localDirection, grown,
+              maxDistance, distance, normal);
+        }
+      }
+      if (!found)
+        continue;
+
+      maxDistance = distance;
+      hit.entity = s.id;
+      hit.distance = distance;
+      hit.normal = s.pose.Rot().RotateVector(normal);
+    }
+  }
+  return hit;
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::Overlaps(
+    const QueryVolume &_volume, std::vector<std::size_t> &_ids) const
+{
+  const math::AxisAlignedBox box =
+      transformAxisAlignedBox(volumeBox(_volume), _volume.pose);
+  std::vector<std::size_t> nodes;
+  this->dataPtr->aabbTree.Overlaps(box, nodes);
+  for (std::size_t id : nodes)
+  {
+    auto it = this->dataPtr->queryShapeRanges.find(id);
+    if (it == this->dataPtr->queryShapeRanges.end())
+      continue;
+
+    for (std::size_t i = it->second.first; i < it->second.second; ++i)
+    {
+      const QueryShape &s = this->dataPtr->queryShapes[i];
+      if (s.box.Intersects(box) && volumeOverlaps(_volume, s))
+        _ids.push_back(s.id);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetMaxContactsPerPair(std::size_t _maxContacts)
+{
+  if (this->dataPtr->maxPairContacts != _maxContacts)
+    this->dataPtr->contactCache.clear();
+  this->dataPtr->maxPairContacts = _maxContacts;
+}
+
+//////////////////////////////////////////////////
+std::size_t CollisionDetector::GetMaxContactsPerPair() const
+{
+  return this->dataPtr->maxPairContacts;
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetOrientedBoundingBoxes(bool _enable)
+{
+  if (this->dataPtr->orientedBoxes != _enable)
+    this->dataPtr->contactCache.clear();
+  this->dataPtr->orientedBoxes = _enable;
+}
+
+//////////////////////////////////////////////////
+bool CollisionDetector::GetOrientedBoundingBoxes() const
+{
+  return this->dataPtr->orientedBoxes;
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetShapeContacts(bool _enable)
+{
+  if (this->dataPtr->shapeContacts != _enable)
+    this->dataPtr->contactCache.clear();
+  this->dataPtr->shapeContacts = _enable;
+}
+
+//////////////////////////////////////////////////
+bool CollisionDetector::GetShapeContacts() const
+{
+  return this->dataPtr->shapeContacts;
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetTreeRebuildFactor(double _factor)
+{
+  this->dataPtr->treeRebuildFactor = _factor;
+  this->dataPtr->builtTreeRatio = 0.0;
+}
+
+//////////////////////////////////////////////////
+double CollisionDetector::GetTreeRebuildFactor() const
+{
+  return this->dataPtr->treeRebuildFactor;
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetSinglePrecisionTree(bool _enable)
+{
+  if (this->dataPtr->aabbTree.GetSinglePrecision() == _enable)
+    return;
+
+  // the tree is emptied, so all nodes are added again in one pass by the
+  // next call to UpdateTree
+  this->dataPtr->aabbTree.SetSinglePrecision(_enable);
+  this->dataPtr->nodeIds.clear();
+  this->dataPtr->overlaps.clear();
+  this->dataPtr->movedNodeIds.clear();
+  this->dataPtr->builtTreeRatio = 0.0;
+}
+
+//////////////////////////////////////////////////
+bool CollisionDetector::GetSinglePrecisionTree() const
+{
+  return this->dataPtr->aabbTree.GetSinglePrecision();
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetBroadphaseGridCellSize(double _cellSize)
+{
+  if (math::equal(this->dataPtr->aabbTree.GetGridCellSize(), _cellSize))
+    return;
+
+  // as with SetSinglePrecisionTree, the broadphase is emptied and filled
+  // again by the next call to UpdateTree
+  this->dataPtr->aabbTree.SetGridCellSize(_cellSize);
+  if (!math::equal(this->dataPtr->aabbTree.GetGridCellSize(), _cellSize))
+    return;
+  this->dataPtr->nodeIds.clear();
+  this->dataPtr->overlaps.clear();
+  this->dataPtr->movedNodeIds.clear();
+  this->dataPtr->builtTreeRatio = 0.0;
+}
+
+//////////////////////////////////////////////////
+double CollisionDetector::GetBroadphaseGridCellSize() const
+{
+  return this->dataPtr->aabbTree.GetGridCellSize();
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetNumThreads(std::size_t _numThreads)
+{
+  this->dataPtr->numThreads = std::max<std::size_t>(_numThreads, 1u);
+}
+
+//////////////////////////////////////////////////
+std::size_t CollisionDetector::GetNumThreads() const
+{
+  return this->dataPtr->numThreads;
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetTaskRunner(TaskRunner _runner)
+{
+  this->dataPtr->taskRunner = std::move(_runner);
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetEntityStatistics(bool _enable)
+{
+  this->dataPtr->entityStatistics = _enable;
+}
+
+//////////////////////////////////////////////////
+bool CollisionDetector::GetEntityStatistics() const
+{
+  return this->dataPtr->entityStatistics;
+}
+
+//////////////////////////////////////////////////
+void CollisionDetector::SetAllocationCounter(AllocationCounter _counter)
+{
+  this->dataPtr->allocationCounter = _counter;
+}
+
+/////////////////////////////////////////////////
+AllocationCounter CollisionDetector::GetAllocationCounter() const
+{
+  return this->dataPtr->allocationCounter;
+}
 
-  /// \brief Keep track of pairs of node ids that collided. The map is cleared
-  /// after each collision detection iteration. The key and value are:
-  ///   std::unorderd_map<node_a_id, std::unordered_map<node_b_id, collided>
-  public: std::unordered_map<std::size_t, std::unordered_map<std::size_t, bool>>
-    collisionStateMap;
-};
+/////////////////////////////////////////////////
+const CollisionStatistics &CollisionDetector::GetStatistics() const
+{
+  return this->dataPtr->statistics;
+}
 
-using namespace gz;
-using namespace physics;
-using namespace tpelib;
+//////////////////////////////////////////////////
+std::size_t CollisionDetector::GetMemoryBytes() const
+{
+  std::size_t bytes = sizeof(CollisionDetectorPrivate) +
+      this->dataPtr->aabbTree.GetMemoryBytes() +
+      treeBytes(this->dataPtr->nodeIds) +
+      treeBytes(this->dataPtr->overlaps) +
+      vectorBytes(this->dataPtr->movedNodeIds) +
+      vectorBytes(this->dataPtr->queryResult) +
+      vectorBytes(this->dataPtr->pairs) +
+      vectorBytes(this->dataPtr->candidates) +
+      this->dataPtr->boxes1.GetMemoryBytes() +
+      this->dataPtr->boxes2.GetMemoryBytes() +
+      this->dataPtr->intersections.GetMemoryBytes() +
+      vectorBytes(this->dataPtr->hits) +
+      treeBytes(this->dataPtr->contactCache) +
+      vectorBytes(this->dataPtr->reuseContacts) +
+      vectorBytes(this->dataPtr->scratch) +
+      vectorBytes(this->dataPtr->queryShapes);
+  for (const auto &overlap : this->dataPtr->overlaps)
+    bytes += treeBytes(overlap.second);
+  for (const auto &cached : this->dataPtr->contactCache)
+    bytes += vectorBytes(cached.second.contacts);
+  for (const auto &scratch : this->dataPtr->scratch)
+  {
+    bytes += vectorBytes(scratch.shapes1) + vectorBytes(scratch.shapes2) +
+        vectorBytes(scratch.contacts) + vectorBytes(scratch.created);
+  }
+  return bytes;
+}
 
 //////////////////////////////////////////////////
-CollisionDetector::CollisionDetector()
-  : dataPtr(new CollisionDetectorPrivate)
+bool CollisionDetector::GetIntersectionPoints(const math::AxisAlignedBox &_b1,
+    const math::AxisAlignedBox &_b2,
+    std::vector<math::Vector3d> &_points, bool _singleContact)
 {
+  GZ_PROFILE("CollisionDetector::GetIntersectionPoints");
+  // fast intersection check
+  if (_b1.Intersects(_b2))
+  {
+    // when two boxes intersect, the overlapping region is a small box
+    // get all corners of this intersection box
+    math::Vector3d min;
+    math::Vector3d max;
+    min.X() = std::max(_b1.Min().X(), _b2.Min().X());
+    min.Y() = std::max(_b1.Min().Y(), _b2.Min().Y());
+    min.Z() = std::max(_b1.Min().Z(), _b2.Min().Z());
+
+    max.X() = std::min(_b1.Max().X(), _b2.Max().X());
+    max.Y() = std::min(_b1.Max().Y(), _b2.Max().Y());
+    max.Z() = std::min(_b1.Max().Z(), _b2.Max().Z());
+
+    if (_singleContact)
+    {
+      // return center of intersecting region
+      _points.push_back(min + 0.5*(max-min));
+      return true;
+    }
+
+    auto corners = intersectionCorners(min, max);
+    _points.insert(_points.end(), corners.begin(), corners.end());
+
+    return true;
+  }
+  return false;
 }
 
 //////////////////////////////////////////////////
-CollisionDetector::~CollisionDetector() = default;
+void CollisionDetectorPrivate::PairContacts(
+    const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
+    std::size_t _begin, std::size_t _end, bool _singleContact,
+    NarrowphaseScratch &_scratch, std::vector<Contact> &_contacts) const
+{
+  // the cache is only read here, and updated by CacheContacts once all
+  // ranges are tested
+  auto pairContact = [&](std::size_t _index)
+  {
+    const auto &[id1, id2] = this->candidates[_index];
+    if (this->reuseContacts[_index])
+    {
+      const auto &cached = this->contactCache.at(
+          {std::min(id1, id2), std::max(id1, id2)}).contacts;
+      for (Contact c : cached)
+      {
+        if (c.entity1 != id1)
+        {
+          std::swap(c.entity1, c.entity2);
+          std::swap(c.collision1, c.collision2);
+        }
+        _contacts.push_back(c);
+      }
+      return;
+    }
+
+    CreatedContacts created;
+    created.index = _index;
+    created.begin = _contacts.size();
+    this->PairContact(_entities, _index, _singleContact, _scratch,
+        _contacts);
+    created.end = _contacts.size();
+    _scratch.created.push_back(created);
+  };
+
+  for (std::size_t i = _begin; i < _end; ++i)
+  {
+    if (!this->hits[i])
+      continue;
+
+    if (!this->entityStatistics)
+    {
+      pairContact(i);
+      continue;
+    }
+
+    const auto pairStart = std::chrono::steady_clock::now();
+    const std::size_t contactCount = _contacts.size();
+    pairContact(i);
+    PairStatistics pair;
+    pair.index = i;
+    pair.contactCount = _contacts.size() - contactCount;
+    pair.time = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - pairStart).count();
+    _scratch.pairStatistics.push_back(pair);
+  }
+}
 
 //////////////////////////////////////////////////
-std::vector<Contact> CollisionDetector::CheckCollisions(
+void CollisionDetectorPrivate::PairContact(
     const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
-    bool _singleContact)
+    std::size_t _index, bool _singleContact,
+    NarrowphaseScratch &_scratch, std::vector<Contact> &_contacts) const
 {
-  GZ_PROFILE("tpelib::CollisionDetector::CheckCollisions");
+  Contact c;
+  // TPE checks collisions in the model level so contacts are associated
+  // with models and not collisions!
+  c.entity1 = this->candidates[_index].first;
+  c.entity2 = this->candidates[_index].second;
+  const auto &in = this->intersections;
+  math::Vector3d min(in.minX[_index], in.minY[_index], in.minZ[_index]);
+  math::Vector3d max(in.maxX[_index], in.maxY[_index], in.maxZ[_index]);
 
-  // contacts to be filled and returned
-  std::vector<Contact> contacts;
+  const Entity &e1 = *_entities.at(c.entity1);
+  const Entity &e2 = *_entities.at(c.entity2);
+  if (this->shapeContacts)
+  {
+    this->ShapeContacts(e1, e2, math::AxisAlignedBox(min, max),
+        _singleContact, _scratch, _contacts);
+    return;
+  }
 
-  // update AABB tree
-  // remove nodes that no longer exist
-  auto nodesToCheckForRemoval = this->dataPtr->nodeIds;
-  for (auto id : nodesToCheckForRemoval)
+  if (this->orientedBoxes)
+  {
+    const math::AxisAlignedBox region = this->OrientedOverlap(
+        e1, e2, math::AxisAlignedBox(min, max), _scratch);
+    if (region == math::AxisAlignedBox())
+      return;
+    min = region.Min();
+    max = region.Max();
+  }
+
+  // limit the region of intersection to the triangles of meshes that
+  // have a triangle hierarchy and to the part below heightmaps, and drop
+  // the pair if they miss it
+  const bool refine1 = hasRefinedShape(e1);
+  const bool refine2 = hasRefinedShape(e2);
+  if (refine1 || refine2)
   {
-    if (_entities.find(id) == _entities.end())
+    math::AxisAlignedBox region(min, max);
+    for (const Entity *e : {refine1 ? &e1 : nullptr, refine2 ? &e2 : nullptr})
     {
-      this->dataPtr->aabbTree.RemoveNode(id);
-      this->dataPtr->nodeIds.erase(id);
+      if (!e || region == math::AxisAlignedBox())
+        continue;
+      math::AxisAlignedBox touched;
+      touchedRegion(*e, e->GetPose(), region, touched);
+      region = touched;
     }
+    if (region == math::AxisAlignedBox())
+      return;
+    min = region.Min();
+    max = region.Max();
   }
 
-  // add and update nodes in the tree
-  for (auto it = _entities.begin(); it != _entities.end(); ++it)
+  this->PushContacts(c, min, max, _singleContact, _contacts);
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::PushContacts(Contact _contact,
+    const math::Vector3d &_min, const math::Vector3d &_max,
+    bool _singleContact, std::vector<Contact> &_contacts) const
+{
+  const std::size_t maxContacts = this->maxPairContacts;
+  if (maxContacts == 0u)
+    return;
+
+  if (_singleContact || maxContacts == 1u)
   {
-    std::shared_ptr<Entity> e = it->second;
-    // add new nodes
-    if (!this->dataPtr->aabbTree.HasNode(it->first))
+    _contact.point = _min + 0.5 * (_max - _min);
+    _contacts.push_back(_contact);
+    return;
+  }
+
+  const auto corners = intersectionCorners(_min, _max);
+  if (maxContacts >= corners.size())
+  {
+    for (const auto &p : corners)
     {
-      math::AxisAlignedBox b = e->GetBoundingBox();
+      _contact.point = p;
+      _contacts.push_back(_contact);
+    }
+    return;
+  }
+
+  // the corners are equally deep, so they are picked to spread over the
+  // region: starting from the first one, each next corner is the one
+  // farthest from those already picked
+  std::array<double, 8> distances;
+  distances.fill(std::numeric_limits<double>::infinity());
+  std::array<bool, 8> picked{};
+  std::size_t next = 0u;
+  for (std::size_t k = 0u; k < maxContacts; ++k)
+  {
+    picked[next] = true;
+    _contact.point = corners[next];
+    _contacts.push_back(_contact);
 
-      if (b == math::AxisAlignedBox())
+    const math::Vector3d &last = corners[next];
+    std::size_t farthest = next;
+    for (std::size_t j = 0u; j < corners.size(); ++j)
+    {
+      if (picked[j])
         continue;
+      distances[j] = std::min(distances[j],
+          (corners[j] - last).SquaredLength());
+      if (farthest == next || distances[j] > distances[farthest])
+        farthest = j;
+    }
+    next = farthest;
+  }
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::ShapeContacts(const Entity &_e1,
+    const Entity &_e2, const math::AxisAlignedBox &_region,
+    bool _singleContact, NarrowphaseScratch &_scratch,
+    std::vector<Contact> &_contacts) const
+{
+  // only the collisions that reach into the region of the model pair are
+  // refined, so the cost is proportional to the pairs that the broadphase
+  // found
+  _scratch.shapes1.clear();
+  collectShapes(_e1, _e1.GetPose(), _region, _scratch.shapes1);
+  if (_scratch.shapes1.empty())
+    return;
 
-      // convert to world aabb
-      math::AxisAlignedBox aabb;
-      math::Pose3d p = e->GetPose();
-      aabb = transformAxisAlignedBox(b, p);
-      this->dataPtr->aabbTree.AddNode(e->GetId(), aabb);
+  _scratch.shapes2.clear();
+  collectShapes(_e2, _e2.GetPose(), _region, _scratch.shapes2);
 
-      this->dataPtr->nodeIds.insert(it->first);
-    }
-    // update existing nodes
-    else if (e->PoseDirty())
+  Contact c;
+  c.entity1 = _e1.GetId();
+  c.entity2 = _e2.GetId();
+  for (const auto &a : _scratch.shapes1)
+  {
+    for (const auto &b : _scratch.shapes2)
     {
-      math::AxisAlignedBox b = e->GetBoundingBox();
+      if (!a.box.Intersects(b.box) ||
+          (this->orientedBoxes && !shapesOverlap(a, b)))
+      {
+        continue;
+      }
 
-      if (b == math::AxisAlignedBox())
+      math::AxisAlignedBox region = clipAxisAlignedBox(
+          clipAxisAlignedBox(a.box, b.box), _region);
+      region = refineRegion(*b.shape, b.pose,
+          refineRegion(*a.shape, a.pose, region));
+      if (region == math::AxisAlignedBox())
         continue;
 
-      // convert to world aabb
-      math::AxisAlignedBox aabb;
-      math::Pose3d p = e->GetPose();
-      aabb = transformAxisAlignedBox(b, p);
-      this->dataPtr->aabbTree.UpdateNode(e->GetId(), aabb);
+      c.collision1 = a.id;
+      c.collision2 = b.id;
+      this->PushContacts(c, region.Min(), region.Max(), _singleContact,
+          _contacts);
     }
   }
+}
 
-  // query AABB tree for collisions
-  for (auto it = _entities.begin(); it != _entities.end(); ++it)
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::FindReusableContacts(bool _singleContact)
+{
+  ++this->callCount;
+  if (this->cachedSingleContact != _singleContact)
   {
-    std::shared_ptr<Entity> e = it->second;
-    // Skip if the entity is static
-    if (e->GetStatic())
-      continue;
+    this->contactCache.clear();
+    this->cachedSingleContact = _singleContact;
+  }
 
-    math::AxisAlignedBox b = e->GetBoundingBox();
-    if (b == math::AxisAlignedBox())
-        continue;
+  // movedNodeIds is sorted and holds every node that was added or refit
+  // since the last call, which covers changes of the poses of models and
+  // their links, of their shapes and of their collide bitmasks
+  const auto &moved = this->movedNodeIds;
+  auto hasMoved = [&moved](std::size_t _id)
+  {
+    return std::binary_search(moved.begin(), moved.end(), _id);
+  };
 
-    // check collisions
-    auto result = this->dataPtr->aabbTree.Collisions(e->GetId());
-    if (result.empty())
+  const std::size_t count = this->candidates.size();
+  this->reuseContacts.assign(count, 0u);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (!this->hits[i])
       continue;
 
-    math::AxisAlignedBox wb1 = this->dataPtr->aabbTree.AABB(e->GetId());
+    const auto &[id1, id2] = this->candidates[i];
+    if (hasMoved(id1) || hasMoved(id2))
+      continue;
 
-    // Get collide bitmask for entity 1
-    uint16_t cb1 = e->GetCollideBitmask();
+    auto it = this->contactCache.find({std::min(id1, id2),
+        std::max(id1, id2)});
+    if (it == this->contactCache.end())
+      continue;
 
-    // Check intersection
-    for (const auto &nId : result)
+    it->second.call = this->callCount;
+    this->reuseContacts[i] = 1u;
+  }
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::CacheContacts(std::size_t _chunks,
+    const std::vector<Contact> &_contacts)
+{
+  for (std::size_t c = 0u; c < _chunks; ++c)
+  {
+    for (const CreatedContacts &created : this->scratch[c].created)
     {
-      // skip if we have already checked collision for this pair of nodes
-      if (this->dataPtr->CheckDuplicateCollisionPair(e->GetId(), nId))
-        continue;
+      const auto &[id1, id2] = this->candidates[created.index];
+      CachedContacts &cached =
+          this->contactCache[{std::min(id1, id2), std::max(id1, id2)}];
+      cached.contacts.assign(_contacts.begin() + created.begin,
+          _contacts.begin() + created.end);
+      cached.call = this->callCount;
+    }
+  }
 
-      // Get collide bitmask for entity 2
-      uint16_t cb2 = _entities.at(nId)->GetCollideBitmask();
+  // a pair that was not tested in this call may have moved unnoticed, e.g.
+  // while it was asleep, so its contacts are dropped
+  for (auto it = this->contactCache.begin(); it != this->contactCache.end();)
+  {
+    if (it->second.call != this->callCount)
+      it = this->contactCache.erase(it);
+    else
+      ++it;
+  }
+}
 
-      // collision filtering using collide bitmask
-      if ((cb1 & cb2) == 0)
-        continue;
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::CollectEntityStatistics(std::size_t _chunks)
+{
+  auto &entities = this->statistics.entities;
+  for (const auto &[id1, id2] : this->candidates)
+  {
+    ++entities[id1].candidatePairCount;
+    ++entities[id2].candidatePairCount;
+  }
 
-      std::vector<math::Vector3d> points;
-      math::AxisAlignedBox wb2 = this->dataPtr->aabbTree.AABB(nId);
-      if (this->GetIntersectionPoints(wb1, wb2, points, _singleContact))
+  for (std::size_t c = 0u; c < _chunks; ++c)
+  {
+    for (const PairStatistics &pair : this->scratch[c].pairStatistics)
+    {
+      const auto &[id1, id2] = this->candidates[pair.index];
+      for (const std::size_t id : {id1, id2})
       {
-        Contact c;
-        // TPE checks collisions in the model level so contacts are associated
-        // with models and not collisions!
-        c.entity1 = e->GetId();
-        c.entity2 = nId;
-        for (const auto &p : points)
-        {
-          c.point = p;
-          contacts.push_back(c);
-        }
+        EntityCollisionStatistics &entity = entities[id];
+        entity.contactCount += pair.contactCount;
+        entity.narrowphaseTime += pair.time;
       }
     }
   }
+}
 
-  this->dataPtr->collisionStateMap.clear();
-  return contacts;
+//////////////////////////////////////////////////
+math::AxisAlignedBox CollisionDetectorPrivate::OrientedOverlap(
+    const Entity &_e1, const Entity &_e2, const math::AxisAlignedBox &_region,
+    NarrowphaseScratch &_scratch) const
+{
+  math::AxisAlignedBox result;
+  _scratch.shapes1.clear();
+  collectShapes(_e1, _e1.GetPose(), _region, _scratch.shapes1);
+  if (_scratch.shapes1.empty())
+    return result;
+
+  _scratch.shapes2.clear();
+  collectShapes(_e2, _e2.GetPose(), _region, _scratch.shapes2);
+  for (const auto &a : _scratch.shapes1)
+  {
+    for (const auto &b : _scratch.shapes2)
+    {
+      if (!a.box.Intersects(b.box) || !shapesOverlap(a, b))
+        continue;
+      const math::AxisAlignedBox overlap = clipAxisAlignedBox(
+          clipAxisAlignedBox(a.box, b.box), _region);
+      if (overlap != math::AxisAlignedBox())
+        result.Merge(overlap);
+    }
+  }
+  return result;
 }
 
 //////////////////////////////////////////////////
-bool CollisionDetector::GetIntersectionPoints(const math::AxisAlignedBox &_b1,
-    const math::AxisAlignedBox &_b2,
-    std::vector<math::Vector3d> &_points, bool _singleContact)
+void CollisionDetectorPrivate::UpdateTree(
+    const std::map<std::size_t, std::shared_ptr<Entity>> &_entities)
 {
-  GZ_PROFILE("CollisionDetector::GetIntersectionPoints");
-  // fast intersection check
-  if (_b1.Intersects(_b2))
+  // remove nodes that no longer exist
+  for (auto idIt = this->nodeIds.begin(); idIt != this->nodeIds.end();)
   {
-    // when two boxes intersect, the overlapping region is a small box
-    // get all corners of this intersection box
-    math::Vector3d min;
-    math::Vector3d max;
-    min.X() = std::max(_b1.Min().X(), _b2.Min().X());
-    min.Y() = std::max(_b1.Min().Y(), _b2.Min().Y());
-    min.Z() = std::max(_b1.Min().Z(), _b2.Min().Z());
+    if (_entities.find(*idIt) == _entities.end())
+    {
+      this->aabbTree.RemoveNode(*idIt);
+      this->RemoveOverlaps(*idIt);
+      idIt = this->nodeIds.erase(idIt);
+    }
+    else
+    {
+      ++idIt;
+    }
+  }
+  for (auto planeIt = this->planes.begin(); planeIt != this->planes.end();)
+  {
+    if (_entities.find(planeIt->first) == _entities.end())
+      planeIt = this->planes.erase(planeIt);
+    else
+      ++planeIt;
+  }
 
-    max.X() = std::min(_b1.Max().X(), _b2.Max().X());
-    max.Y() = std::min(_b1.Max().Y(), _b2.Max().Y());
-    max.Z() = std::min(_b1.Max().Z(), _b2.Max().Z());
+  // add and update nodes in the tree. Entities cache their local bounding
+  // box and only recompute it after a shape, a child or the pose of a child
+  // changed, so the world box of a node only has to be refit when its pose
+  // or its local box changed.
+  for (auto it = _entities.begin(); it != _entities.end(); ++it)
+  {
+    const std::shared_ptr<Entity> &e = it->second;
+    const bool inTree = this->aabbTree.HasNode(it->first);
+    if (inTree && !e->WorldBoundingBoxDirty())
+      continue;
 
-    if (_singleContact)
+    // entities that are not in the tree, such as those that only have
+    // planes, are few, so their planes are collected on every call
+    this->UpdatePlanes(it->first, *e);
+
+    // entities without collisions, or whose collisions collide with
+    // nothing, are not in the tree. The collide bitmask is cached, so
+    // checking it first skips computing the box of such entities.
+    const bool collides = e->GetCollideBitmask() != 0u;
+    const math::AxisAlignedBox aabb = collides ?
+        transformAxisAlignedBox(e->GetBoundingBox(), e->GetPose()) :
+        math::AxisAlignedBox();
+    if (aabb == math::AxisAlignedBox())
     {
-      // return center of intersecting region
-      _points.push_back(min + 0.5*(max-min));
-      return true;
+      if (inTree)
+      {
+        this->aabbTree.RemoveNode(it->first);
+        this->RemoveOverlaps(it->first);
+        this->nodeIds.erase(it->first);
+      }
+      continue;
     }
 
-    // min min min
-    math::Vector3d corner = min;
-    _points.push_back(corner);
+    // new nodes are added together after the loop, so that many entities
+    // created between two steps are bulk built into the tree.
+    if (!inTree)
+    {
+      this->addedNodes.push_back({it->first, aabb});
+      continue;
+    }
 
-    // min min max
-    corner.Z() = max.Z();
-    _points.push_back(corner);
+    this->aabbTree.UpdateNode(it->first, aabb);
+    // pairs whose bitmasks share no bit are pruned while querying the tree.
+    // A changed bitmask marks the box of the entity as changed, so it is
+    // picked up here.
+    this->aabbTree.SetNodeMask(it->first, e->GetCollideBitmask());
+    this->movedNodeIds.push_back(it->first);
+  }
 
-    // min max max
-    corner.Y() = max.Y();
-    _points.push_back(corner);
+  if (!this->addedNodes.empty())
+  {
+    this->aabbTree.AddNodes(this->addedNodes);
+    for (const auto &node : this->addedNodes)
+    {
+      this->nodeIds.insert(node.first);
+      this->aabbTree.SetNodeMask(
+          node.first, _entities.at(node.first)->GetCollideBitmask());
+      this->movedNodeIds.push_back(node.first);
+    }
+    this->addedNodes.clear();
 
-    // min max min
-    corner.Z() = min.Z();
-    _points.push_back(corner);
+    // the new nodes were bulk built, measure the tree again
+    this->builtTreeRatio = 0.0;
+  }
 
-    // max max min
-    corner.X() = max.X();
-    _points.push_back(corner);
+  this->RebuildTreeIfDegraded();
+}
 
-    // max max max
-    corner.Z() = max.Z();
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::UpdatePlanes(
+    std::size_t _id, const Entity &_entity)
+{
+  this->collectedPlanes.clear();
+  if (_entity.GetCollideBitmask() != 0u)
+    collectPlanes(_entity, _entity.GetPose(), this->collectedPlanes);
 
-    // max min max
-    corner.Y() = min.Y();
-    _points.push_back(corner);
+  if (this->collectedPlanes.empty())
+  {
+    this->planes.erase(_id);
+    return;
+  }
+  this->planes[_id].assign(
+      this->collectedPlanes.begin(), this->collectedPlanes.end());
+}
 
-    // max min min
-    corner.Z() = min.Z();
-    _points.push_back(corner);
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::PlaneContacts(
+    const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
+    bool _singleContact, NarrowphaseScratch &_scratch,
+    std::vector<Contact> &_contacts) const
+{
+  for (const auto &[planeId, entityPlanes] : this->planes)
+  {
+    const Entity &planeEntity = *_entities.at(planeId);
+    const bool planeAwake =
+        !planeEntity.GetStatic() && !planeEntity.GetSleeping();
+    for (auto id : this->nodeIds)
+    {
+      const Entity &e = *_entities.at(id);
+      // like in the tree, pairs of static or sleeping entities are skipped
+      if (id == planeId ||
+          (!planeAwake && (e.GetStatic() || e.GetSleeping())) ||
+          (e.GetCollideBitmask() & planeEntity.GetCollideBitmask()) == 0u)
+      {
+        continue;
+      }
 
-    return true;
+      const math::AxisAlignedBox box = this->aabbTree.AABB(id);
+      for (const WorldPlane &plane : entityPlanes)
+      {
+        math::AxisAlignedBox region = clipBelowPlane(box, plane);
+        if (region == math::AxisAlignedBox())
+          continue;
+
+        Contact c;
+        c.entity1 = id;
+        c.entity2 = planeId;
+        if (this->shapeContacts)
+        {
+          _scratch.shapes1.clear();
+          collectShapes(e, e.GetPose(), region, _scratch.shapes1);
+          c.collision2 = plane.id;
+          for (const auto &a : _scratch.shapes1)
+          {
+            const math::AxisAlignedBox shapeRegion = refineRegion(
+                *a.shape, a.pose, clipBelowPlane(a.box, plane));
+            if (shapeRegion == math::AxisAlignedBox())
+              continue;
+            c.collision1 = a.id;
+            this->PushContacts(c, shapeRegion.Min(), shapeRegion.Max(),
+                _singleContact, _contacts);
+          }
+          continue;
+        }
+
+        if (hasRefinedShape(e))
+        {
+          math::AxisAlignedBox touched;
+          touchedRegion(e, e.GetPose(), region, touched);
+          region = touched;
+          if (region == math::AxisAlignedBox())
+            continue;
+        }
+        this->PushContacts(c, region.Min(), region.Max(), _singleContact,
+            _contacts);
+      }
+    }
   }
-  return false;
 }
 
 //////////////////////////////////////////////////
-bool CollisionDetectorPrivate::CheckDuplicateCollisionPair(
-    std::size_t _a, std::size_t _b)
+void CollisionDetectorPrivate::RebuildTreeIfDegraded()
 {
-  // use a 2d map to keep track of pairs of collisions
-  // mark the corresponding elements in the 2d map to true to indicate
-  // the check is done
-  bool duplicate = true;
-  auto aIt = this->collisionStateMap.find(_a);
-  if (aIt == this->collisionStateMap.end())
+  if (this->treeRebuildFactor <= 0.0 || this->movedNodeIds.empty())
+    return;
+
+  const double ratio = this->aabbTree.SurfaceAreaRatio();
+  if (this->builtTreeRatio <= 0.0)
   {
-    duplicate = false;
+    this->builtTreeRatio = ratio;
+    return;
   }
-  else
+
+  if (ratio > this->treeRebuildFactor * this->builtTreeRatio)
   {
-    auto bIt = aIt->second.find(_b);
-    if (bIt == aIt->second.end())
-    {
-      duplicate = false;
-    }
+    // rebuilding only changes the structure of the tree, so the cached
+    // overlaps stay valid
+    this->aabbTree.Rebuild();
+    this->builtTreeRatio = this->aabbTree.SurfaceAreaRatio();
+  }
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::RemoveOverlaps(std::size_t _id)
+{
+  auto it = this->overlaps.find(_id);
+  if (it == this->overlaps.end())
+    return;
+
+  for (auto nId : it->second)
+  {
+    auto nIt = this->overlaps.find(nId);
+    if (nIt == this->overlaps.end())
+      continue;
+    nIt->second.erase(_id);
+    if (nIt->second.empty())
+      this->overlaps.erase(nIt);
+  }
+  this->overlaps.erase(it);
+}
+
+//////////////////////////////////////////////////
+void CollisionDetectorPrivate::UpdateOverlaps(std::size_t _id)
+{
+  this->queryResult.clear();
+  this->aabbTree.Collisions(_id, this->queryResult);
+  std::sort(this->queryResult.begin(), this->queryResult.end());
+  this->queryResult.erase(std::unique(this->queryResult.begin(),
+      this->queryResult.end()), this->queryResult.end());
+
+  // Erasing and inserting the same pairs again would free and allocate the
+  // nodes of the cache on every call while bodies rest on each other.
+  auto it = this->overlaps.find(_id);
+  if (it == this->overlaps.end() ? this->queryResult.empty() :
+      std::equal(it->second.begin(), it->second.end(),
+          this->queryResult.begin(), this->queryResult.end()))
+  {
+    return;
   }
 
-  if (!duplicate)
+  this->RemoveOverlaps(_id);
+  for (auto nId : this->queryResult)
   {
-    this->collisionStateMap[_a][_b] = true;
-    this->collisionStateMap[_b][_a] = true;
+    this->overlaps[_id].insert(nId);
+    this->overlaps[nId].insert(_id);
+  }
+}
+
+//////////////////////////////////////////////////
+bool CollisionDetectorPrivate::OverlapsMatch(
+    const std::vector<std::pair<std::size_t, std::size_t>> &_pairs) const
+{
+  // The cache is symmetric, so each pair is visited once from its smaller
+  // node, in the same order as the sorted pairs.
+  auto pair = _pairs.begin();
+  for (const auto &[id, result] : this->overlaps)
+  {
+    for (auto it = result.upper_bound(id); it != result.end(); ++it)
+    {
+      if (pair == _pairs.end() || pair->first != id || pair->second != *it)
+        return false;
+      ++pair;
+    }
   }
-  return duplicate;
+  return pair == _pairs.end();
 }
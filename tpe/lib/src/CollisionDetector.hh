@@ -18,6 +18,7 @@
 #ifndef GZ_PHYSICS_TPE_LIB_SRC_COLLISIONDETECTOR_HH_
 #define GZ_PHYSICS_TPE_LIB_SRC_COLLISIONDETECTOR_HH_
 
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -29,6 +30,8 @@
 #include "gz/physics/tpelib/Export.hh"
 
 #include "Entity.hh"
+#include "Shape.hh"
+#include "Utils.hh"
 
 #include "AABBTree.hh"
 
@@ -39,6 +42,11 @@ namespace tpelib {
 // forward declaration
 class CollisionDetectorPrivate;
 
+/// \brief Function that returns the number of heap allocations made so far,
+/// such as gz::physics::AllocationCount. The difference of two calls is the
+/// number of allocations made in between.
+using AllocationCounter = std::size_t (*)();
+
 /// \brief A data structure to store contact properties
 class GZ_PHYSICS_TPELIB_VISIBLE Contact
 {
@@ -48,12 +56,108 @@ class GZ_PHYSICS_TPELIB_VISIBLE Contact
   /// \brief Id of second collision entity
   public: std::size_t entity2 = kNullEntityId;
 
+  /// \brief Id of the collision of entity1 in contact, kNullEntityId
+  /// unless shape contacts are enabled, see
+  /// CollisionDetector::SetShapeContacts
+  public: std::size_t collision1 = kNullEntityId;
+
+  /// \brief Id of the collision of entity2 in contact, kNullEntityId
+  /// unless shape contacts are enabled
+  public: std::size_t collision2 = kNullEntityId;
+
   GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
   /// \brief Point of contact in world frame;
   public: math::Vector3d point;
   GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
 };
 
+/// \brief Closest hit of a ray cast with CollisionDetector::CastRay
+class GZ_PHYSICS_TPELIB_VISIBLE RayHit
+{
+  /// \brief Id of the collision entity that was hit, kNullEntityId if the
+  /// ray hit nothing
+  public: std::size_t entity = kNullEntityId;
+
+  /// \brief Distance from the start of the ray to the hit, infinity if the
+  /// ray hit nothing
+  public: double distance = std::numeric_limits<double>::infinity();
+
+  GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Unit surface normal at the hit in world frame
+  public: math::Vector3d normal;
+  GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+};
+
+/// \brief A sphere or box to sweep with CollisionDetector::CastVolume or to
+/// test with CollisionDetector::Overlaps
+class GZ_PHYSICS_TPELIB_VISIBLE QueryVolume
+{
+  /// \brief ShapeType::SPHERE or ShapeType::BOX
+  public: ShapeType type = ShapeType::SPHERE;
+
+  GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Pose of the center of the volume in world frame
+  public: math::Pose3d pose;
+  GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+  /// \brief Radius of a sphere
+  public: double radius = 0.0;
+
+  GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Size of a box along its axes
+  public: math::Vector3d size;
+  GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+};
+
+
+/// \brief Counters and timings of one entity in a call to
+/// CollisionDetector::CheckCollisions. A candidate pair counts for both of
+/// its entities, so the counters of all entities add up to twice those of
+/// the call.
+class GZ_PHYSICS_TPELIB_VISIBLE EntityCollisionStatistics
+{
+  /// \brief Number of candidate pairs of the entity
+  public: std::size_t candidatePairCount = 0u;
+
+  /// \brief Number of contacts created for the pairs of the entity
+  public: std::size_t contactCount = 0u;
+
+  /// \brief Time spent testing the pairs of the entity whose boxes
+  /// intersect, in seconds
+  public: double narrowphaseTime = 0.0;
+};
+
+/// \brief Counters and timings of a call to CollisionDetector::CheckCollisions
+class GZ_PHYSICS_TPELIB_VISIBLE CollisionStatistics
+{
+  /// \brief Time spent updating the AABB tree and gathering the candidate
+  /// pairs, in seconds
+  public: double broadphaseTime = 0.0;
+
+  /// \brief Time spent testing the candidate pairs and creating contacts, in
+  /// seconds
+  public: double narrowphaseTime = 0.0;
+
+  /// \brief Number of candidate pairs tested by the narrowphase
+  public: std::size_t candidatePairCount = 0u;
+
+  /// \brief Number of candidate pairs whose contacts were reused from the
+  /// previous call because neither of their entities moved since
+  public: std::size_t reusedPairCount = 0u;
+
+  /// \brief Heap allocations of the broadphase, see
+  /// CollisionDetector::SetAllocationCounter. 0 without a counter.
+  public: std::size_t broadphaseAllocations = 0u;
+
+  /// \brief Heap allocations of the narrowphase. 0 without a counter.
+  public: std::size_t narrowphaseAllocations = 0u;
+
+  /// \brief Counters and timings of each entity that is in a candidate
+  /// pair, see CollisionDetector::SetEntityStatistics. Empty if they are
+  /// not collected.
+  public: std::map<std::size_t, EntityCollisionStatistics> entities;
+};
+
 /// \brief Collision Detector that checks collisions between a list of entities
 class GZ_PHYSICS_TPELIB_VISIBLE CollisionDetector
 {
@@ -73,6 +177,201 @@ class GZ_PHYSICS_TPELIB_VISIBLE CollisionDetector
       const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
       bool _singleContact = false);
 
+  /// \brief Check collisions between a list entities and get all contact
+  /// points. Same as the function above but writes into a caller provided
+  /// vector so that its capacity can be reused across calls. The contacts
+  /// of a pair of entities are reused from the previous call if neither
+  /// entity moved or changed since, and the pair was tested in that call
+  /// with the same options.
+  /// \param[in] _entities List of entities
+  /// \param[out] _contacts Contact points. The vector is cleared first.
+  /// \param[in] _singleContact Get only 1 contact point for each pair of
+  /// collisions.
+  /// The contact point will be at the center of all points
+  public: void CheckCollisions(
+      const std::map<std::size_t, std::shared_ptr<Entity>> &_entities,
+      std::vector<Contact> &_contacts,
+      bool _singleContact = false);
+
+  /// \brief Prepare queries against a list of entities. The AABB tree is
+  /// brought up to date and the world pose of every collision is cached, so
+  /// that CastRay, CastVolume and Overlaps only read the detector. Call again
+  /// once the entities moved or changed. Entities whose collide bitmask is 0
+  /// are not in the tree and are not found by queries.
+  /// \param[in] _entities List of entities
+  public: void PrepareQueries(
+      const std::map<std::size_t, std::shared_ptr<Entity>> &_entities);
+
+  /// \brief Cast a ray against the collisions of the entities of the last
+  /// call to PrepareQueries. Rays that start inside a solid shape do not
+  /// hit it. The detector is only read, so rays can be cast concurrently.
+  /// \param[in] _from Start of the ray in world frame
+  /// \param[in] _to End of the ray in world frame
+  /// \return Closest hit between _from and _to
+  public: RayHit CastRay(
+      const math::Vector3d &_from, const math::Vector3d &_to) const;
+
+  /// \brief Sweep a volume without rotating it against the collisions of
+  /// the entities of the last call to PrepareQueries. Spheres are swept
+  /// exactly against spheres. Every other pair is swept as the oriented
+  /// bounding box of the collision grown by the extent of the volume, which
+  /// may report hits slightly early near edges and corners. Collisions that
+  /// the volume overlaps at the start, or starts within that margin of, are
+  /// hit at distance 0, with a normal opposite to the sweep. The detector is
+  /// only read, so volumes can be swept concurrently.
+  /// \param[in] _volume Volume at the start of the sweep
+  /// \param[in] _to End of the sweep of the center of the volume in world
+  /// frame
+  /// \return Closest hit of the sweep, the distance being how far the
+  /// volume travelled
+  public: RayHit CastVolume(
+      const QueryVolume &_volume, const math::Vector3d &_to) const;
+
+  /// \brief Find the collisions of the entities of the last call to
+  /// PrepareQueries that overlap a volume. The same tests as the oriented
+  /// narrowphase of CheckCollisions are used: spheres and capsules by
+  /// distance, every other pair by oriented bounding boxes. The detector is
+  /// only read, so volumes can be tested concurrently.
+  /// \param[in] _volume Volume to test
+  /// \param[out] _ids Ids of the overlapping collision entities are
+  /// appended to this vector
+  public: void Overlaps(
+      const QueryVolume &_volume, std::vector<std::size_t> &_ids) const;
+
+  /// \brief Set the maximum number of contacts created for a pair of
+  /// entities, or of collisions when shape contacts are enabled. A pair
+  /// whose region of intersection has more corners than that keeps the
+  /// corners that are spread the widest over the region, and a maximum of
+  /// 1 creates a single contact at its center, as _singleContact of
+  /// CheckCollisions does. Unlimited by default.
+  /// \param[in] _maxContacts Maximum number of contacts per pair, 0 to
+  /// create no contacts
+  public: void SetMaxContactsPerPair(std::size_t _maxContacts);
+
+  /// \brief Get the maximum number of contacts created for a pair
+  /// \return Maximum number of contacts per pair
+  public: std::size_t GetMaxContactsPerPair() const;
+
+  /// \brief Set whether the narrowphase tests the oriented bounding boxes of
+  /// collisions. The broadphase always uses world axis aligned boxes of the
+  /// models. When enabled, models whose world axis aligned boxes overlap are
+  /// only in contact if a pair of their collisions overlaps as oriented
+  /// boxes. Spheres and capsules are tested by distance instead. Disabled
+  /// by default.
+  /// \param[in] _enable True to enable oriented bounding boxes
+  public: void SetOrientedBoundingBoxes(bool _enable);
+
+  /// \brief Get whether the narrowphase tests oriented bounding boxes
+  /// \return True if oriented bounding boxes are enabled
+  public: bool GetOrientedBoundingBoxes() const;
+
+  /// \brief Set whether contacts are created between collisions rather
+  /// than between models. The broadphase still pairs the world axis aligned
+  /// boxes of the models, and only the pairs whose boxes intersect collect
+  /// their collisions within the region of intersection. A contact is then
+  /// created for each pair of collisions whose world boxes intersect, or
+  /// overlap as oriented boxes when those are enabled, over the region
+  /// where they do, and Contact::collision1 and Contact::collision2 name
+  /// the collisions. Contact::entity1 and Contact::entity2 are still the
+  /// models. Disabled by default.
+  /// \param[in] _enable True to create contacts between collisions
+  public: void SetShapeContacts(bool _enable);
+
+  /// \brief Get whether contacts are created between collisions
+  /// \return True if shape contacts are enabled
+  public: bool GetShapeContacts() const;
+
+  /// \brief Set when the AABB tree is rebuilt. Moving nodes are reinserted
+  /// or refit one at a time, which slowly degrades the tree. When enabled,
+  /// the tree is rebuilt once its surface area ratio, see
+  /// AABBTree::SurfaceAreaRatio, exceeds _factor times the ratio measured
+  /// after it was last built. Checking the ratio visits every node of the
+  /// tree in each call that moved nodes. Disabled by default.
+  /// \param[in] _factor Factor larger than 1, or 0 to disable rebuilding
+  public: void SetTreeRebuildFactor(double _factor);
+
+  /// \brief Get when the AABB tree is rebuilt
+  /// \return Factor set by SetTreeRebuildFactor, 0 if disabled
+  public: double GetTreeRebuildFactor() const;
+
+  /// \brief Set whether the AABB tree stores the boxes of its nodes as
+  /// float, see AABBTree::SetSinglePrecision. This makes traversals of large
+  /// trees cheaper, but the regions of intersection that contacts are
+  /// generated in then come from the rounded boxes and may grow by a float
+  /// rounding step. Changing the precision empties the tree, which is
+  /// filled again by the next call to CheckCollisions. Disabled by default.
+  /// \param[in] _enable True to store the boxes as float
+  public: void SetSinglePrecisionTree(bool _enable);
+
+  /// \brief Get whether the AABB tree stores the boxes of its nodes as float
+  /// \return True if the boxes are stored as float
+  public: bool GetSinglePrecisionTree() const;
+
+  /// \brief Set whether the broadphase keeps the boxes of the collisions in
+  /// a uniform grid of hashed cells instead of the AABB tree, see
+  /// AABBTree::SetGridCellSize. The grid is cheaper to update when many
+  /// collisions of about one cell each move every step. The contacts are
+  /// the same with either. Changing the cell size empties the broadphase,
+  /// which is filled again by the next call to CheckCollisions. Disabled by
+  /// default.
+  /// \param[in] _cellSize Edge length of the cells, 0 to use the tree
+  public: void SetBroadphaseGridCellSize(double _cellSize);
+
+  /// \brief Get the edge length of the cells of the broadphase grid
+  /// \return Cell size, 0 if the broadphase uses the AABB tree
+  public: double GetBroadphaseGridCellSize() const;
+
+  /// \brief Set the number of threads that test the candidate pairs of
+  /// CheckCollisions. The pairs are split into contiguous ranges, one per
+  /// thread, and the contacts of the ranges are concatenated in order, so
+  /// the contacts are the same as with a single thread. A value of 0 or 1
+  /// (default) tests all pairs in the calling thread.
+  /// \param[in] _numThreads Number of threads to use
+  public: void SetNumThreads(std::size_t _numThreads);
+
+  /// \brief Get the number of threads that test the candidate pairs
+  /// \return Number of threads
+  public: std::size_t GetNumThreads() const;
+
+  /// \brief Set the task runner that tests the ranges of candidate pairs
+  /// when there are several threads. The ranges are the same as without a
+  /// runner, so the contacts do not change.
+  /// \param[in] _runner Task runner, or an empty function (default) for
+  /// the detector to test the ranges on a worker pool of its own.
+  public: void SetTaskRunner(TaskRunner _runner);
+
+  /// \brief Set whether CheckCollisions collects counters and timings of
+  /// each entity, see CollisionStatistics::entities. This reads the clock
+  /// twice for each candidate pair whose boxes intersect. Disabled by
+  /// default.
+  /// \param[in] _enable True to collect the statistics of each entity
+  public: void SetEntityStatistics(bool _enable);
+
+  /// \brief Get whether CheckCollisions collects the statistics of each
+  /// entity
+  /// \return True if the statistics of each entity are collected
+  public: bool GetEntityStatistics() const;
+
+  /// \brief Set the function that CheckCollisions uses to count the heap
+  /// allocations of its phases, which are reported in CollisionStatistics.
+  /// The counter is called a few times per call, from the calling thread.
+  /// \param[in] _counter Allocation counter, nullptr (default) to not count
+  /// allocations
+  public: void SetAllocationCounter(AllocationCounter _counter);
+
+  /// \brief Get the function that counts heap allocations
+  /// \return Allocation counter, nullptr if allocations are not counted
+  public: AllocationCounter GetAllocationCounter() const;
+
+  /// \brief Get counters and timings of the last call to CheckCollisions
+  /// \return Statistics of the last collision check
+  public: const CollisionStatistics &GetStatistics() const;
+
+  /// \brief Estimate the memory kept by the detector between calls
+  /// \return Bytes used by the AABB tree, the overlap cache and the scratch
+  /// buffers
+  public: std::size_t GetMemoryBytes() const;
+
   /// \brief Get a vector of intersection points between two axis aligned boxes
   /// \param[in] _b1 Axis aligned box 1
   /// \param[in] _b2 Axis aligned box 2
@@ -16,6 +16,17 @@
 */
 
 #include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <limits>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gz/common/Mesh.hh>
+#include <gz/common/SubMesh.hh>
 #include <gz/math/AxisAlignedBox.hh>
 
 #include "Collision.hh"
@@ -403,3 +414,871 @@ TEST(CollisionDetector, CheckStaticCollisionFiltering)
   std::vector<Contact> contacts = cd.CheckCollisions(entities);
   EXPECT_TRUE(contacts.empty());
 }
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, IncrementalPairCache)
+{
+  // create three boxes and only move some of them between checks
+  std::vector<std::shared_ptr<Model>> models;
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  for (int i = 0; i < 3; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(2, 2, 2));
+    collision->SetShape(boxShape);
+    model->SetPose(math::Pose3d(10.0 * i, 0, 0, 0, 0, 0));
+    entities[model->GetId()] = model;
+    models.push_back(model);
+  }
+
+  auto resetDirty = [&models]()
+  {
+    for (auto &m : models)
+      m->ResetPoseDirty();
+  };
+
+  CollisionDetector cd;
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+  resetDirty();
+
+  // move model 1 onto model 0
+  models[1]->SetPose(math::Pose3d(1, 0, 0, 0, 0, 0));
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(models[0]->GetId(), contacts[0].entity1);
+  EXPECT_EQ(models[1]->GetId(), contacts[0].entity2);
+  resetDirty();
+
+  // nothing moved, the cached pair is still reported
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(models[0]->GetId(), contacts[0].entity1);
+  EXPECT_EQ(models[1]->GetId(), contacts[0].entity2);
+
+  // move model 2 onto model 1 while model 0 and 1 stay at rest
+  models[2]->SetPose(math::Pose3d(1.5, 0, 0, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(3u, contacts.size());
+  resetDirty();
+
+  // move model 0 away. Its pairs should be removed but the pair between
+  // model 1 and 2 remains
+  models[0]->SetPose(math::Pose3d(-50, 0, 0, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(models[1]->GetId(), contacts[0].entity1);
+  EXPECT_EQ(models[2]->GetId(), contacts[0].entity2);
+  resetDirty();
+
+  // removing an entity removes its cached pairs
+  entities.erase(models[2]->GetId());
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, ContactCache)
+{
+  // a row of three overlapping boxes
+  std::vector<std::shared_ptr<Model>> models;
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  for (int i = 0; i < 3; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Entity &collisionEnt = static_cast<Link &>(linkEnt).AddCollision();
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(2, 2, 2));
+    static_cast<Collision &>(collisionEnt).SetShape(boxShape);
+    model->SetPose(math::Pose3d(1.5 * i, 0, 0, 0, 0, 0));
+    entities[model->GetId()] = model;
+    models.push_back(model);
+  }
+
+  auto resetDirty = [&models]()
+  {
+    for (auto &m : models)
+      m->ResetPoseDirty();
+  };
+
+  CollisionDetector cd;
+  std::vector<Contact> first = cd.CheckCollisions(entities, false);
+  ASSERT_EQ(16u, first.size());
+  EXPECT_EQ(0u, cd.GetStatistics().reusedPairCount);
+  resetDirty();
+
+  // nothing moved, both pairs reuse their contacts
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, false);
+  EXPECT_EQ(2u, cd.GetStatistics().reusedPairCount);
+  ASSERT_EQ(first.size(), contacts.size());
+  for (std::size_t i = 0; i < first.size(); ++i)
+  {
+    EXPECT_EQ(first[i].entity1, contacts[i].entity1);
+    EXPECT_EQ(first[i].entity2, contacts[i].entity2);
+    EXPECT_EQ(first[i].point, contacts[i].point);
+  }
+
+  // the pair of the model that moved is created again
+  models[2]->SetPose(math::Pose3d(2.5, 0, 0, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(0u, cd.GetStatistics().reusedPairCount);
+  resetDirty();
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(2u, cd.GetStatistics().reusedPairCount);
+  models[2]->SetPose(math::Pose3d(2.2, 0, 0, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(1u, cd.GetStatistics().reusedPairCount);
+  ASSERT_EQ(2u, contacts.size());
+  for (const Contact &c : contacts)
+  {
+    if (c.entity2 == models[2]->GetId())
+      EXPECT_NEAR(1.85, c.point.X(), 1e-9);
+    else
+      EXPECT_NEAR(0.75, c.point.X(), 1e-9);
+  }
+  resetDirty();
+
+  // changing how contacts are created drops the cache
+  cd.SetOrientedBoundingBoxes(true);
+  EXPECT_EQ(2u, cd.CheckCollisions(entities, true).size());
+  EXPECT_EQ(0u, cd.GetStatistics().reusedPairCount);
+
+  // pairs that stop being tested are forgotten, even if they do not move
+  models[0]->SetStatic(true);
+  models[1]->SetStatic(true);
+  EXPECT_EQ(1u, cd.CheckCollisions(entities, true).size());
+  models[0]->SetStatic(false);
+  EXPECT_EQ(2u, cd.CheckCollisions(entities, true).size());
+  EXPECT_EQ(1u, cd.GetStatistics().reusedPairCount);
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, TreeRebuild)
+{
+  // boxes scattered at pseudo random positions that move between checks,
+  // checked by a detector that rebuilds its tree and one that does not.
+  // Reinserting the moved boxes one by one degrades the tree.
+  unsigned int seed = 1u;
+  auto randomPose = [&seed]()
+  {
+    auto next = [&seed]()
+    {
+      seed = seed * 1103515245u + 12345u;
+      return static_cast<double>((seed >> 16) % 1000u) / 1000.0;
+    };
+    double x = 20.0 * next();
+    double y = 20.0 * next();
+    return math::Pose3d(x, y, 0, 0, 0, 0);
+  };
+
+  std::vector<std::shared_ptr<Model>> models;
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  const int count = 256;
+  for (int i = 0; i < count; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(1, 1, 1));
+    collision->SetShape(boxShape);
+    model->SetPose(randomPose());
+    entities[model->GetId()] = model;
+    models.push_back(model);
+  }
+
+  CollisionDetector cd;
+  EXPECT_DOUBLE_EQ(0.0, cd.GetTreeRebuildFactor());
+  cd.SetTreeRebuildFactor(1.05);
+  EXPECT_DOUBLE_EQ(1.05, cd.GetTreeRebuildFactor());
+  CollisionDetector reference;
+
+  auto contactPairs = [](const std::vector<Contact> &_contacts)
+  {
+    std::set<std::pair<std::size_t, std::size_t>> result;
+    for (const auto &c : _contacts)
+      result.insert({c.entity1, c.entity2});
+    return result;
+  };
+
+  for (int step = 0; step < 20; ++step)
+  {
+    std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+    std::vector<Contact> expected = reference.CheckCollisions(entities, true);
+    EXPECT_EQ(contactPairs(expected), contactPairs(contacts));
+    for (auto &m : models)
+      m->ResetPoseDirty();
+
+    // move every other box
+    for (int i = step % 2; i < count; i += 2)
+      models[i]->SetPose(randomPose());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, SinglePrecisionTree)
+{
+  // boxes scattered at pseudo random positions that move between checks,
+  // checked by a detector whose tree stores float boxes and one that
+  // stores double boxes. The positions never make two boxes touch, where
+  // rounding the boxes outwards could make them overlap.
+  unsigned int seed = 7u;
+  auto randomPose = [&seed]()
+  {
+    auto next = [&seed]()
+    {
+      seed = seed * 1103515245u + 12345u;
+      return static_cast<double>((seed >> 16) % 1000u) / 1000.0;
+    };
+    double x = 17.3 * next();
+    double y = 17.3 * next();
+    return math::Pose3d(x, y, 0.1, 0, 0, 0);
+  };
+
+  std::vector<std::shared_ptr<Model>> models;
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  const int count = 128;
+  for (int i = 0; i < count; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(1, 1, 1));
+    collision->SetShape(boxShape);
+    model->SetPose(randomPose());
+    entities[model->GetId()] = model;
+    models.push_back(model);
+  }
+
+  CollisionDetector cd;
+  EXPECT_FALSE(cd.GetSinglePrecisionTree());
+  cd.SetSinglePrecisionTree(true);
+  EXPECT_TRUE(cd.GetSinglePrecisionTree());
+  CollisionDetector reference;
+
+  auto contactPairs = [](const std::vector<Contact> &_contacts)
+  {
+    std::set<std::pair<std::size_t, std::size_t>> result;
+    for (const auto &c : _contacts)
+      result.insert({c.entity1, c.entity2});
+    return result;
+  };
+
+  for (int step = 0; step < 10; ++step)
+  {
+    // switching the precision while entities are in the tree adds them
+    // all again
+    if (step == 5)
+    {
+      cd.SetSinglePrecisionTree(false);
+      cd.SetSinglePrecisionTree(true);
+    }
+
+    std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+    std::vector<Contact> expected = reference.CheckCollisions(entities, true);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(contactPairs(expected), contactPairs(contacts));
+    for (auto &m : models)
+      m->ResetPoseDirty();
+
+    // move every other box
+    for (int i = step % 2; i < count; i += 2)
+      models[i]->SetPose(randomPose());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, BroadphaseGrid)
+{
+  // boxes scattered at pseudo random positions over a ground box that
+  // covers them all, checked by a detector with a grid broadphase and one
+  // with the tree
+  unsigned int seed = 11u;
+  auto randomPose = [&seed]()
+  {
+    auto next = [&seed]()
+    {
+      seed = seed * 1103515245u + 12345u;
+      return static_cast<double>((seed >> 16) % 1000u) / 1000.0;
+    };
+    double x = 17.3 * next() - 8.0;
+    double y = 17.3 * next() - 8.0;
+    return math::Pose3d(x, y, 0.45, 0, 0, 0);
+  };
+
+  std::vector<std::shared_ptr<Model>> models;
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  const int count = 128;
+  for (int i = 0; i <= count; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    if (i == count)
+    {
+      boxShape.SetSize(math::Vector3d(40, 40, 1));
+      model->SetPose(math::Pose3d(0, 0, -0.5, 0, 0, 0));
+    }
+    else
+    {
+      boxShape.SetSize(math::Vector3d(1, 1, 1));
+      model->SetPose(randomPose());
+      models.push_back(model);
+    }
+    collision->SetShape(boxShape);
+    entities[model->GetId()] = model;
+  }
+
+  CollisionDetector cd;
+  EXPECT_DOUBLE_EQ(0.0, cd.GetBroadphaseGridCellSize());
+  cd.SetBroadphaseGridCellSize(1.2);
+  EXPECT_DOUBLE_EQ(1.2, cd.GetBroadphaseGridCellSize());
+  CollisionDetector reference;
+
+  auto contactPairs = [](const std::vector<Contact> &_contacts)
+  {
+    std::set<std::pair<std::size_t, std::size_t>> result;
+    for (const auto &c : _contacts)
+      result.insert(std::minmax(c.entity1, c.entity2));
+    return result;
+  };
+
+  for (int step = 0; step < 10; ++step)
+  {
+    // changing the cell size while entities are in the broadphase adds
+    // them all again
+    if (step == 5)
+      cd.SetBroadphaseGridCellSize(2.0);
+
+    std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+    std::vector<Contact> expected = reference.CheckCollisions(entities, true);
+    EXPECT_GT(expected.size(), static_cast<std::size_t>(count));
+    EXPECT_EQ(expected.size(), contacts.size());
+    EXPECT_EQ(contactPairs(expected), contactPairs(contacts));
+    for (auto &m : models)
+      m->ResetPoseDirty();
+
+    // move every other box
+    for (int i = step % 2; i < count; i += 2)
+      models[i]->SetPose(randomPose());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, TriangleMeshContacts)
+{
+  // a static square ramp on the plane z = x
+  common::SubMesh subMesh;
+  subMesh.AddVertex(math::Vector3d(0, 0, 0));
+  subMesh.AddVertex(math::Vector3d(4, 0, 4));
+  subMesh.AddVertex(math::Vector3d(4, 4, 4));
+  subMesh.AddVertex(math::Vector3d(0, 4, 0));
+  for (unsigned int i : {0u, 1u, 2u, 0u, 2u, 3u})
+    subMesh.AddIndex(i);
+  common::Mesh mesh;
+  mesh.AddSubMesh(subMesh);
+
+  std::shared_ptr<Model> ramp(new Model);
+  ramp->SetStatic(true);
+  Entity &rampLinkEnt = ramp->AddLink();
+  Link *rampLink = static_cast<Link *>(&rampLinkEnt);
+  Entity &rampCollisionEnt = rampLink->AddCollision();
+  Collision *rampCollision = static_cast<Collision *>(&rampCollisionEnt);
+  MeshShape meshShape;
+  meshShape.SetMesh(mesh);
+  rampCollision->SetShape(meshShape);
+
+  // a small box under the ramp, inside its bounding box
+  std::shared_ptr<Model> box(new Model);
+  Entity &boxLinkEnt = box->AddLink();
+  Link *boxLink = static_cast<Link *>(&boxLinkEnt);
+  Entity &boxCollisionEnt = boxLink->AddCollision();
+  Collision *boxCollision = static_cast<Collision *>(&boxCollisionEnt);
+  BoxShape boxShape;
+  boxShape.SetSize(math::Vector3d(0.4, 0.4, 0.4));
+  boxCollision->SetShape(boxShape);
+  box->SetPose(math::Pose3d(3.5, 2, 0.5, 0, 0, 0));
+
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  entities[ramp->GetId()] = ramp;
+  entities[box->GetId()] = box;
+
+  // without a triangle hierarchy the bounding boxes are in contact
+  {
+    CollisionDetector cd;
+    EXPECT_EQ(1u, cd.CheckCollisions(entities, true).size());
+  }
+
+  // with a triangle hierarchy the box misses the triangles
+  meshShape.SetMesh(mesh, true);
+  rampCollision->SetShape(meshShape);
+  CollisionDetector cd;
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+
+  // a box crossing the surface of the ramp is still in contact
+  box->SetPose(math::Pose3d(2, 2, 2, 0, 0, 0));
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(math::Vector3d(2, 2, 2), contacts[0].point);
+
+  // the triangles are checked in the frame of the rotated ramp, whose
+  // surface is now on the plane z = y
+  ramp->SetPose(math::Pose3d(0, 0, 0, 0, 0, GZ_PI / 2.0));
+  box->SetPose(math::Pose3d(-2, 3.5, 0.5, 0, 0, 0));
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+
+  box->SetPose(math::Pose3d(-2, 2, 2, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_NEAR(0.0, (contacts[0].point - math::Vector3d(-2, 2, 2)).Length(),
+      1e-6);
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, HeightmapContacts)
+{
+  // a static flat terrain of 4 x 4 cells with a bump in the middle
+  auto heights = std::make_shared<std::vector<float>>(25u, 0.0f);
+  (*heights)[12] = 1.0f;
+  std::shared_ptr<Model> terrain(new Model);
+  terrain->SetStatic(true);
+  Entity &terrainLinkEnt = terrain->AddLink();
+  Link *terrainLink = static_cast<Link *>(&terrainLinkEnt);
+  Entity &terrainCollisionEnt = terrainLink->AddCollision();
+  Collision *terrainCollision =
+      static_cast<Collision *>(&terrainCollisionEnt);
+  HeightmapShape heightmapShape;
+  ASSERT_TRUE(heightmapShape.SetHeights(
+      std::shared_ptr<const float>(heights, heights->data()), 5u, 5u));
+  heightmapShape.SetSize(math::Vector3d(4, 4, 1));
+  terrainCollision->SetShape(heightmapShape);
+
+  // a small box above the flat part, inside the bounding box of the terrain
+  std::shared_ptr<Model> box(new Model);
+  Entity &boxLinkEnt = box->AddLink();
+  Link *boxLink = static_cast<Link *>(&boxLinkEnt);
+  Entity &boxCollisionEnt = boxLink->AddCollision();
+  Collision *boxCollision = static_cast<Collision *>(&boxCollisionEnt);
+  BoxShape boxShape;
+  boxShape.SetSize(math::Vector3d(0.4, 0.4, 0.4));
+  boxCollision->SetShape(boxShape);
+  box->SetPose(math::Pose3d(-1.5, -1.5, 0.4, 0, 0, 0));
+
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  entities[terrain->GetId()] = terrain;
+  entities[box->GetId()] = box;
+
+  CollisionDetector cd;
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+
+  // the bottom of a box sinking into the terrain is in contact
+  box->SetPose(math::Pose3d(-1.5, -1.5, 0.1, 0, 0, 0));
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(math::Vector3d(-1.5, -1.5, 0), contacts[0].point);
+  EXPECT_EQ(8u, cd.CheckCollisions(entities).size());
+
+  // the same height above the ground is in contact next to the bump
+  box->SetPose(math::Pose3d(0.5, 0.5, 0.6, 0, 0, 0));
+  EXPECT_EQ(1u, cd.CheckCollisions(entities, true).size());
+
+  // the terrain is checked in its own frame
+  terrain->SetPose(math::Pose3d(0, 0, -1, 0, 0, 0));
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+  box->SetPose(math::Pose3d(-1.5, -1.5, -0.9, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(math::Vector3d(-1.5, -1.5, -1), contacts[0].point);
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, PlaneContacts)
+{
+  // a static ground plane, which is not part of the broadphase
+  std::shared_ptr<Model> ground(new Model);
+  ground->SetStatic(true);
+  Entity &groundLinkEnt = ground->AddLink();
+  Link *groundLink = static_cast<Link *>(&groundLinkEnt);
+  Entity &groundCollisionEnt = groundLink->AddCollision();
+  Collision *groundCollision = static_cast<Collision *>(&groundCollisionEnt);
+  groundCollision->SetShape(PlaneShape());
+  EXPECT_EQ(math::AxisAlignedBox(), ground->GetBoundingBox());
+
+  // boxes far apart from each other above the plane
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  entities[ground->GetId()] = ground;
+  std::vector<std::shared_ptr<Model>> boxes;
+  for (int i = 0; i < 3; ++i)
+  {
+    std::shared_ptr<Model> box(new Model);
+    Entity &boxLinkEnt = box->AddLink();
+    Link *boxLink = static_cast<Link *>(&boxLinkEnt);
+    Entity &boxCollisionEnt = boxLink->AddCollision();
+    Collision *boxCollision = static_cast<Collision *>(&boxCollisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(1, 1, 1));
+    boxCollision->SetShape(boxShape);
+    box->SetPose(math::Pose3d(10.0 * i, 0, 1, 0, 0, 0));
+    entities[box->GetId()] = box;
+    boxes.push_back(box);
+  }
+
+  CollisionDetector cd;
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+  EXPECT_EQ(0u, cd.GetStatistics().candidatePairCount);
+
+  // a box sinking into the plane touches it over its bottom, without
+  // candidate pairs
+  boxes[1]->SetPose(math::Pose3d(10, 0, 0.4, 0, 0, 0));
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  EXPECT_EQ(0u, cd.GetStatistics().candidatePairCount);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(boxes[1]->GetId(), contacts[0].entity1);
+  EXPECT_EQ(ground->GetId(), contacts[0].entity2);
+  EXPECT_EQ(math::Vector3d(10, 0, -0.05), contacts[0].point);
+  contacts = cd.CheckCollisions(entities);
+  ASSERT_EQ(8u, contacts.size());
+  for (const auto &c : contacts)
+  {
+    EXPECT_GE(1e-9, std::abs(c.point.Z() + 0.05) - 0.05);
+    EXPECT_NEAR(10, c.point.X(), 0.5 + 1e-9);
+  }
+
+  // rays hit the plane between the boxes
+  cd.PrepareQueries(entities);
+  const RayHit hit = cd.CastRay(math::Vector3d(5, 0, 5),
+      math::Vector3d(5, 0, -5));
+  EXPECT_EQ(groundCollision->GetId(), hit.entity);
+  EXPECT_NEAR(5.0, hit.distance, 1e-9);
+
+  // the plane is checked in its own frame: tilted about y, it rises above
+  // the boxes away from the origin
+  ground->SetPose(math::Pose3d(0, 0, 0, 0, -0.1, 0));
+  boxes[1]->SetPose(math::Pose3d(10, 0, 1, 0, 0, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(2u, contacts.size());
+  EXPECT_EQ(boxes[1]->GetId(), contacts[0].entity1);
+  EXPECT_EQ(boxes[2]->GetId(), contacts[1].entity1);
+
+  // shape contacts name the plane collision
+  cd.SetShapeContacts(true);
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(2u, contacts.size());
+  EXPECT_EQ(groundCollision->GetId(), contacts[0].collision2);
+
+  // planes stop colliding once their bitmask shares no bit
+  groundCollision->SetCollideBitmask(0x01);
+  for (auto &box : boxes)
+    static_cast<Collision *>(box->GetChildren().begin()->second->
+        GetChildren().begin()->second.get())->SetCollideBitmask(0x02);
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, OrientedBoundingBoxes)
+{
+  // a long thin box rotated by 45 degrees about z
+  std::shared_ptr<Model> rod(new Model);
+  Entity &rodLinkEnt = rod->AddLink();
+  Link *rodLink = static_cast<Link *>(&rodLinkEnt);
+  Entity &rodCollisionEnt = rodLink->AddCollision();
+  Collision *rodCollision = static_cast<Collision *>(&rodCollisionEnt);
+  BoxShape rodShape;
+  rodShape.SetSize(math::Vector3d(10, 0.2, 0.2));
+  rodCollision->SetShape(rodShape);
+  rod->SetPose(math::Pose3d(0, 0, 0, 0, 0, GZ_PI * 0.25));
+
+  // a sphere and a capsule next to the rod, inside its world box
+  std::shared_ptr<Model> ball(new Model);
+  Entity &ballLinkEnt = ball->AddLink();
+  Link *ballLink = static_cast<Link *>(&ballLinkEnt);
+  Entity &ballCollisionEnt = ballLink->AddCollision();
+  Collision *ballCollision = static_cast<Collision *>(&ballCollisionEnt);
+  SphereShape ballShape;
+  ballShape.SetRadius(0.5);
+  ballCollision->SetShape(ballShape);
+  ball->SetPose(math::Pose3d(2.5, -2.5, 0, 0, 0, 0));
+
+  std::shared_ptr<Model> pill(new Model);
+  Entity &pillLinkEnt = pill->AddLink();
+  Link *pillLink = static_cast<Link *>(&pillLinkEnt);
+  Entity &pillCollisionEnt = pillLink->AddCollision();
+  Collision *pillCollision = static_cast<Collision *>(&pillCollisionEnt);
+  CapsuleShape pillShape;
+  pillShape.SetRadius(0.25);
+  pillShape.SetLength(2);
+  pillCollision->SetShape(pillShape);
+  pill->SetPose(math::Pose3d(-2.5, 2.5, 0, 0, 0, 0));
+
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  entities[rod->GetId()] = rod;
+  entities[ball->GetId()] = ball;
+  entities[pill->GetId()] = pill;
+
+  CollisionDetector cd;
+  EXPECT_FALSE(cd.GetOrientedBoundingBoxes());
+  EXPECT_EQ(2u, cd.CheckCollisions(entities, true).size());
+
+  cd.SetOrientedBoundingBoxes(true);
+  EXPECT_TRUE(cd.GetOrientedBoundingBoxes());
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+
+  // move the sphere onto the rod
+  ball->SetPose(math::Pose3d(2.0, 2.3, 0, 0, 0, 0));
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(rod->GetId(), std::min(contacts[0].entity1, contacts[0].entity2));
+
+  // lay the capsule across the sphere
+  ball->SetPose(math::Pose3d(-2.5, 2.5, 0.6, 0, 0, 0));
+  pill->SetPose(math::Pose3d(-2.5, 2.5, 0, 0, GZ_PI * 0.5, 0));
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(ball->GetId(), std::min(contacts[0].entity1, contacts[0].entity2));
+
+  // move the sphere just past the rounded end of the capsule, where their
+  // world boxes still overlap
+  ball->SetPose(math::Pose3d(-0.95, 2.5, 0.55, 0, 0, 0));
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, ShapeContacts)
+{
+  // a model with two links, each with a unit box, 2 m apart along x
+  std::shared_ptr<Model> pair(new Model);
+  std::vector<std::size_t> pairCollisions;
+  for (double x : {-1.0, 1.0})
+  {
+    Entity &linkEnt = pair->AddLink();
+    linkEnt.SetPose(math::Pose3d(x, 0, 0, 0, 0, 0));
+    Entity &collisionEnt = static_cast<Link &>(linkEnt).AddCollision();
+    BoxShape shape;
+    shape.SetSize(math::Vector3d::One);
+    static_cast<Collision &>(collisionEnt).SetShape(shape);
+    pairCollisions.push_back(collisionEnt.GetId());
+  }
+
+  // a small box resting on the second link
+  std::shared_ptr<Model> box(new Model);
+  Entity &boxLinkEnt = box->AddLink();
+  Entity &boxCollisionEnt = static_cast<Link &>(boxLinkEnt).AddCollision();
+  BoxShape boxShape;
+  boxShape.SetSize(math::Vector3d(0.5, 0.5, 0.5));
+  static_cast<Collision &>(boxCollisionEnt).SetShape(boxShape);
+  box->SetPose(math::Pose3d(1, 0, 0.7, 0, 0, 0));
+
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  entities[pair->GetId()] = pair;
+  entities[box->GetId()] = box;
+
+  // without shape contacts only the models are known
+  CollisionDetector cd;
+  EXPECT_FALSE(cd.GetShapeContacts());
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(kNullEntityId, contacts[0].collision1);
+  EXPECT_EQ(kNullEntityId, contacts[0].collision2);
+
+  cd.SetShapeContacts(true);
+  EXPECT_TRUE(cd.GetShapeContacts());
+  contacts = cd.CheckCollisions(entities, true);
+  ASSERT_EQ(1u, contacts.size());
+  const bool pairFirst = contacts[0].entity1 == pair->GetId();
+  EXPECT_EQ(pairCollisions[1],
+      pairFirst ? contacts[0].collision1 : contacts[0].collision2);
+  EXPECT_EQ(boxCollisionEnt.GetId(),
+      pairFirst ? contacts[0].collision2 : contacts[0].collision1);
+  EXPECT_NEAR(1.0, contacts[0].point.X(), 1e-9);
+  EXPECT_NEAR(0.475, contacts[0].point.Z(), 1e-9);
+  EXPECT_EQ(1u, cd.GetStatistics().candidatePairCount);
+
+  // a box over the gap overlaps the box of the model but no collision
+  box->SetPose(math::Pose3d(0, 0, 0.7, 0, 0, 0));
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+
+  // a box across both links touches each of them
+  boxShape.SetSize(math::Vector3d(3, 0.5, 0.5));
+  static_cast<Collision &>(boxCollisionEnt).SetShape(boxShape);
+  contacts = cd.CheckCollisions(entities, false);
+  ASSERT_EQ(16u, contacts.size());
+  std::set<std::size_t> touched;
+  for (const Contact &c : contacts)
+  {
+    touched.insert(c.entity1 == pair->GetId() ? c.collision1 : c.collision2);
+    EXPECT_GE(std::abs(c.point.X()), 0.5);
+  }
+  EXPECT_EQ(2u, touched.size());
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, MaxContactsPerPair)
+{
+  // two boxes that overlap in a region from (0.5, -1, -1) to (1, 1, 1)
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  for (double x : {0.0, 1.5})
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Entity &collisionEnt = static_cast<Link &>(linkEnt).AddCollision();
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(2, 2, 2));
+    static_cast<Collision &>(collisionEnt).SetShape(boxShape);
+    model->SetPose(math::Pose3d(x, 0, 0, 0, 0, 0));
+    entities[model->GetId()] = model;
+  }
+
+  CollisionDetector cd;
+  EXPECT_EQ(std::numeric_limits<std::size_t>::max(),
+      cd.GetMaxContactsPerPair());
+  EXPECT_EQ(8u, cd.CheckCollisions(entities, false).size());
+
+  // the kept corners start at the minimum corner and spread out from there
+  cd.SetMaxContactsPerPair(2u);
+  EXPECT_EQ(2u, cd.GetMaxContactsPerPair());
+  std::vector<Contact> contacts = cd.CheckCollisions(entities, false);
+  ASSERT_EQ(2u, contacts.size());
+  EXPECT_EQ(math::Vector3d(0.5, -1, -1), contacts[0].point);
+  EXPECT_EQ(math::Vector3d(1, 1, 1), contacts[1].point);
+
+  cd.SetMaxContactsPerPair(4u);
+  contacts = cd.CheckCollisions(entities, false);
+  ASSERT_EQ(4u, contacts.size());
+  std::set<std::tuple<double, double, double>> points;
+  for (const Contact &c : contacts)
+    points.insert({c.point.X(), c.point.Y(), c.point.Z()});
+  EXPECT_EQ(4u, points.size());
+
+  // a single contact is at the center of the region
+  cd.SetMaxContactsPerPair(1u);
+  contacts = cd.CheckCollisions(entities, false);
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(math::Vector3d(0.75, 0, 0), contacts[0].point);
+
+  cd.SetMaxContactsPerPair(0u);
+  EXPECT_TRUE(cd.CheckCollisions(entities, false).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, LinkPoseRefit)
+{
+  // two models at rest whose links move relative to them
+  std::vector<std::shared_ptr<Model>> models;
+  std::vector<Link *> links;
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  for (int i = 0; i < 2; ++i)
+  {
+    std::shared_ptr<Model> model(new Model);
+    Entity &linkEnt = model->AddLink();
+    Link *link = static_cast<Link *>(&linkEnt);
+    Entity &collisionEnt = link->AddCollision();
+    Collision *collision = static_cast<Collision *>(&collisionEnt);
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(1, 1, 1));
+    collision->SetShape(boxShape);
+    model->SetPose(math::Pose3d(5.0 * i, 0, 0, 0, 0, 0));
+    entities[model->GetId()] = model;
+    models.push_back(model);
+    links.push_back(link);
+  }
+
+  auto resetDirty = [&]()
+  {
+    for (auto &m : models)
+      m->ResetPoseDirty();
+    for (auto *l : links)
+      l->ResetPoseDirty();
+  };
+
+  CollisionDetector cd;
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+  resetDirty();
+
+  // move the link of model 1 onto model 0. The model itself does not move.
+  links[1]->SetPose(math::Pose3d(-4.5, 0, 0, 0, 0, 0));
+  EXPECT_FALSE(models[1]->PoseDirty());
+  EXPECT_EQ(1u, cd.CheckCollisions(entities, true).size());
+  resetDirty();
+
+  // move the link just out of contact again
+  links[1]->SetPose(math::Pose3d(-3, 0, 0, 0, 0, 0));
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+  resetDirty();
+
+  // growing the collision of model 0 while both models are at rest brings
+  // them back in contact
+  auto *collision = static_cast<Collision *>(
+      &links[0]->GetChildByIndex(0u));
+  BoxShape bigBox;
+  bigBox.SetSize(math::Vector3d(4, 4, 4));
+  collision->SetShape(bigBox);
+  EXPECT_EQ(1u, cd.CheckCollisions(entities, true).size());
+  resetDirty();
+
+  // removing the collision of model 0 removes it from the tree
+  links[0]->RemoveChildById(collision->GetId());
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+  resetDirty();
+  EXPECT_TRUE(cd.CheckCollisions(entities, true).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(CollisionDetector, ParallelNarrowphase)
+{
+  // a grid of rotated boxes that overlap their neighbors along x
+  BoxShape shape;
+  shape.SetSize(math::Vector3d(1.2, 0.5, 0.5));
+  std::map<std::size_t, std::shared_ptr<Entity>> entities;
+  for (int i = 0; i < 20; ++i)
+  {
+    for (int j = 0; j < 20; ++j)
+    {
+      std::shared_ptr<Model> model(new Model);
+      Entity &linkEnt = model->AddLink();
+      Link *link = static_cast<Link *>(&linkEnt);
+      Entity &collisionEnt = link->AddCollision();
+      Collision *collision = static_cast<Collision *>(&collisionEnt);
+      collision->SetShape(shape);
+      model->SetPose(math::Pose3d(i, 2.0 * j, 0, 0, 0, 0.1 * (i + j)));
+      entities[model->GetId()] = model;
+    }
+  }
+
+  CollisionDetector serial;
+  serial.SetOrientedBoundingBoxes(true);
+  EXPECT_EQ(1u, serial.GetNumThreads());
+  const std::vector<Contact> expected =
+      serial.CheckCollisions(entities, false);
+  EXPECT_FALSE(expected.empty());
+
+  CollisionDetector parallel;
+  parallel.SetOrientedBoundingBoxes(true);
+  parallel.SetNumThreads(4u);
+  EXPECT_EQ(4u, parallel.GetNumThreads());
+  const std::vector<Contact> contacts =
+      parallel.CheckCollisions(entities, false);
+
+  // the contacts are the same and in the same order
+  ASSERT_EQ(expected.size(), contacts.size());
+  for (std::size_t i = 0; i < contacts.size(); ++i)
+  {
+    EXPECT_EQ(expected[i].entity1, contacts[i].entity1);
+    EXPECT_EQ(expected[i].entity2, contacts[i].entity2);
+    EXPECT_EQ(expected[i].point, contacts[i].point);
+  }
+
+  parallel.SetNumThreads(0u);
+  EXPECT_EQ(1u, parallel.GetNumThreads());
+}
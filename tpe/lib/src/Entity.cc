@@ -30,6 +30,9 @@ class gz::physics::tpelib::EntityPrivate
   /// \brief Indicate if the object is static
   public: bool isStatic = false;
 
+  /// \brief Indicate if the object is sleeping
+  public: bool isSleeping = false;
+
   /// \brief Entity Id
   public: std::size_t id = 0u;
 
@@ -42,9 +45,14 @@ class gz::physics::tpelib::EntityPrivate
   /// \brief Collide bitmask
   public: uint16_t collideBitmask = 0xFF;
 
-  /// \brief Flag to indicate if bounding box changed
+  /// \brief Flag to indicate if bounding box changed and has to be
+  /// recomputed from the children
   public: bool bboxDirty = true;
 
+  /// \brief Flag to indicate if bounding box changed since the dirty flags
+  /// were last reset
+  public: bool bboxChanged = true;
+
   /// \brief Flag to indicate if pose changed
   public: bool poseDirty = false;
 
@@ -53,13 +61,32 @@ class gz::physics::tpelib::EntityPrivate
 
   /// \brief Parent of this entity
   public: Entity *parent = nullptr;
+
+  /// \brief Ids of the entities of a world, and the memory they are
+  /// allocated from
+  public: struct IdSpace
+  {
+    /// \brief First id of the space, which is the id of the world
+    std::size_t base = 0u;
+
+    /// \brief Local index of the next entity
+    std::size_t next = 1u;
+
+    /// \brief Memory resource of the entities, nullptr for the global heap
+    std::shared_ptr<MemoryResource> memoryResource;
+  };
+
+  /// \brief Id space that the children of this entity get their ids from,
+  /// shared with the world it belongs to. Null if it belongs to no world.
+  public: std::shared_ptr<IdSpace> idSpace;
 };
 
 using namespace gz;
 using namespace physics;
 using namespace tpelib;
 
-std::size_t Entity::nextId = 0;
+std::atomic<std::size_t> Entity::nextId{0u};
+std::atomic<std::size_t> Entity::nextIdSpace{1u};
 Entity Entity::kNullEntity = Entity(kNullEntityId);
 
 //////////////////////////////////////////////////
@@ -79,6 +106,7 @@ Entity::Entity(const Entity &_other)
   this->dataPtr->children = _other.dataPtr->children;
   this->dataPtr->bbox = _other.dataPtr->bbox;
   this->dataPtr->collideBitmask = _other.dataPtr->collideBitmask;
+  this->dataPtr->idSpace = _other.dataPtr->idSpace;
 }
 
 //////////////////////////////////////////////////
@@ -134,6 +162,8 @@ void Entity::SetPose(const math::Pose3d &_pose)
 {
   this->dataPtr->pose = _pose;
   this->dataPtr->poseDirty = true;
+  if (this->dataPtr->parent)
+    this->dataPtr->parent->ChildPoseChanged();
 }
 
 //////////////////////////////////////////////////
@@ -163,6 +193,18 @@ bool Entity::GetStatic() const
   return this->dataPtr->isStatic;
 }
 
+//////////////////////////////////////////////////
+void Entity::SetSleeping(bool _sleeping)
+{
+  this->dataPtr->isSleeping = _sleeping;
+}
+
+//////////////////////////////////////////////////
+bool Entity::GetSleeping() const
+{
+  return this->dataPtr->isSleeping;
+}
+
 //////////////////////////////////////////////////
 void Entity::SetId(std::size_t _id)
 {
@@ -254,6 +296,13 @@ size_t Entity::GetChildCount() const
   return this->dataPtr->children.size();
 }
 
+//////////////////////////////////////////////////
+std::size_t Entity::GetMemoryBytes() const
+{
+  return sizeof(Entity) + sizeof(EntityPrivate) +
+      this->dataPtr->name.capacity() + treeBytes(this->dataPtr->children);
+}
+
 //////////////////////////////////////////////////
 math::AxisAlignedBox Entity::GetBoundingBox(bool _force)
 {
@@ -303,26 +352,89 @@ std::map<std::size_t, std::shared_ptr<Entity>> &Entity::GetChildren() const
   return this->dataPtr->children;
 }
 
+//////////////////////////////////////////////////
+std::size_t Entity::GetLocalIndex(std::size_t _id)
+{
+  return _id & ((std::size_t(1u) << kLocalIdBits) - 1u);
+}
+
 //////////////////////////////////////////////////
 std::size_t Entity::GetNextId()
 {
-  return nextId++;
+  if (this->dataPtr->idSpace)
+  {
+    auto &space = *this->dataPtr->idSpace;
+    return space.base | space.next++;
+  }
+  return nextId.fetch_add(1u, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void Entity::CreateIdSpace()
+{
+  const std::size_t space =
+      nextIdSpace.fetch_add(1u, std::memory_order_relaxed);
+  this->dataPtr->idSpace = std::make_shared<EntityPrivate::IdSpace>();
+  this->dataPtr->idSpace->base = space << kLocalIdBits;
+  this->dataPtr->id = this->dataPtr->idSpace->base;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<MemoryResource> Entity::GetMemoryResource() const
+{
+  if (!this->dataPtr->idSpace)
+    return nullptr;
+  return this->dataPtr->idSpace->memoryResource;
+}
+
+//////////////////////////////////////////////////
+void Entity::SetMemoryResource(std::shared_ptr<MemoryResource> _resource)
+{
+  if (this->dataPtr->idSpace)
+    this->dataPtr->idSpace->memoryResource = std::move(_resource);
 }
 
 //////////////////////////////////////////////////
 void Entity::ChildrenChanged()
 {
   this->dataPtr->bboxDirty = true;
+  this->dataPtr->bboxChanged = true;
   this->dataPtr->collideBitmaskDirty = true;
 
   if (this->dataPtr->parent)
     this->dataPtr->parent->ChildrenChanged();
 }
 
+//////////////////////////////////////////////////
+void Entity::ChildPoseChanged()
+{
+  this->dataPtr->bboxDirty = true;
+  this->dataPtr->bboxChanged = true;
+
+  if (this->dataPtr->parent)
+    this->dataPtr->parent->ChildPoseChanged();
+}
+
+//////////////////////////////////////////////////
+void Entity::SetStepPose(const math::Pose3d &_pose)
+{
+  this->dataPtr->pose = _pose;
+  this->dataPtr->poseDirty = true;
+}
+
+//////////////////////////////////////////////////
+void Entity::InvalidateBoundingBox()
+{
+  this->dataPtr->bboxDirty = true;
+  this->dataPtr->bboxChanged = true;
+}
+
 //////////////////////////////////////////////////
 void Entity::SetParent(Entity *_parent)
 {
   this->dataPtr->parent = _parent;
+  if (_parent)
+    this->dataPtr->idSpace = _parent->dataPtr->idSpace;
 }
 
 //////////////////////////////////////////////////
@@ -337,8 +449,15 @@ bool Entity::PoseDirty() const
   return this->dataPtr->poseDirty;
 }
 
+//////////////////////////////////////////////////
+bool Entity::WorldBoundingBoxDirty() const
+{
+  return this->dataPtr->poseDirty || this->dataPtr->bboxChanged;
+}
+
 //////////////////////////////////////////////////
 void Entity::ResetPoseDirty()
 {
   this->dataPtr->poseDirty = false;
+  this->dataPtr->bboxChanged = false;
 }
@@ -18,6 +18,7 @@
 #ifndef GZ_PHYSICS_TPE_LIB_SRC_ENTITY_HH_
 #define GZ_PHYSICS_TPE_LIB_SRC_ENTITY_HH_
 
+#include <atomic>
 #include <cstddef>
 #include <map>
 #include <memory>
@@ -25,6 +26,7 @@
 
 #include <gz/math/AxisAlignedBox.hh>
 #include <gz/math/Pose3.hh>
+#include <gz/physics/MemoryResource.hh>
 #include "gz/physics/tpelib/Export.hh"
 
 namespace gz {
@@ -86,6 +88,15 @@ class GZ_PHYSICS_TPELIB_VISIBLE Entity
   /// \return Static property
   public: virtual bool GetStatic() const;
 
+  /// \brief Set whether the entity is sleeping. Sleeping entities are at
+  /// rest and are neither integrated nor collided against each other.
+  /// \param[in] _sleeping True if the entity is sleeping
+  public: void SetSleeping(bool _sleeping);
+
+  /// \brief Get whether the entity is sleeping
+  /// \return True if the entity is sleeping
+  public: bool GetSleeping() const;
+
   /// \brief Set the id of the entity
   /// \param[in] _unique Id
   public: virtual void SetId(std::size_t _id);
@@ -147,6 +158,10 @@ class GZ_PHYSICS_TPELIB_VISIBLE Entity
   /// \return Collision's collide bitmask
   public: virtual uint16_t GetCollideBitmask() const;
 
+  /// \brief Estimate the memory used by this entity, without its children
+  /// \return Bytes used by the entity and its private data
+  public: virtual std::size_t GetMemoryBytes() const;
+
   /// \internal
   /// \brief Set the parent of this entity.
   /// \param[in] _parent Parent to set to
@@ -163,13 +178,38 @@ class GZ_PHYSICS_TPELIB_VISIBLE Entity
   public: bool PoseDirty() const;
 
   /// \internal
-  /// \brief Reset the pose dirty flag
+  /// \brief Get whether the world bounding box of the entity has to be
+  /// refit, because its pose or its bounding box changed
+  /// \return True if the pose or the bounding box changed since the dirty
+  /// flags were last reset, false otherwise
+  public: bool WorldBoundingBoxDirty() const;
+
+  /// \internal
+  /// \brief Reset the pose dirty flag, and the flag that the bounding box
+  /// changed
   public: void ResetPoseDirty();
 
   /// \internal
   /// \brief Mark that the children of the entity has changed, e.g. a child
   /// entity is added or removed, or child entity properties changed.
-  public: void ChildrenChanged();
+  public: virtual void ChildrenChanged();
+
+  /// \internal
+  /// \brief Mark that the pose of a child of the entity changed. Only the
+  /// bounding boxes of the entity and its ancestors are invalidated.
+  public: void ChildPoseChanged();
+
+  /// \internal
+  /// \brief Set the pose of the entity as integrated by World::Step. Unlike
+  /// SetPose, the bounding boxes of the ancestors are not invalidated,
+  /// which World::Step does once per parent with InvalidateBoundingBox.
+  /// \param[in] _pose Pose of entity to set to
+  public: void SetStepPose(const math::Pose3d &_pose);
+
+  /// \internal
+  /// \brief Invalidate the bounding box of the entity only, not those of
+  /// its ancestors. See SetStepPose.
+  public: void InvalidateBoundingBox();
 
   /// \brief Get number of children
   /// \return Map of child id's to child entities
@@ -183,12 +223,44 @@ class GZ_PHYSICS_TPELIB_VISIBLE Entity
   /// \brief An invalid vertex.
   public: static Entity kNullEntity;
 
-  /// \brief Get the id of next entity
+  /// \brief Number of low bits of an entity id that hold the index of the
+  /// entity within the id space of its world. The high bits hold the id
+  /// space, so that ids stay unique across worlds.
+  public: static constexpr std::size_t kLocalIdBits =
+      sizeof(std::size_t) >= 8u ? 32u : 20u;
+
+  /// \brief Get the index of an entity within the id space of its world.
+  /// A world has index 0, and the entities added to it get indices from 1
+  /// up in the order they are added, so they can index dense arrays.
+  /// \param[in] _id Id of the entity
+  /// \return Index of the entity within its id space
+  public: static std::size_t GetLocalIndex(std::size_t _id);
+
+  /// \brief Get the id of next entity. Entities that belong to a world get
+  /// it from the id space of the world, which only the thread building the
+  /// world touches. Other entities share a process wide counter.
   /// \return size_t id of next entity
-  protected: static std::size_t GetNextId();
+  protected: std::size_t GetNextId();
+
+  /// \brief Give this entity an id space of its own, and the first id in
+  /// it. Entities added under it get their ids from the space.
+  protected: void CreateIdSpace();
+
+  /// \brief Get the memory resource that entities added under this one
+  /// are allocated from, shared by all entities of a world.
+  /// \return Resource, or nullptr for the global heap.
+  public: std::shared_ptr<MemoryResource> GetMemoryResource() const;
+
+  /// \brief Set the memory resource of the entities of the world that this
+  /// entity belongs to. Does nothing if it belongs to no world.
+  /// \param[in] _resource Resource, or nullptr for the global heap.
+  protected: void SetMemoryResource(std::shared_ptr<MemoryResource> _resource);
+
+  /// \brief Entity id counter of entities without an id space
+  private: static std::atomic<std::size_t> nextId;
 
-  /// \brief Entity id counter
-  private: static std::size_t nextId;
+  /// \brief Counter of id spaces. Space 0 is that of nextId.
+  private: static std::atomic<std::size_t> nextIdSpace;
 
   /// \brief Pointer to private data class
   private: EntityPrivate *dataPtr = nullptr;
@@ -0,0 +1,571 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "HashGrid.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+#include "Utils.hh"
+
+using namespace gz;
+using namespace physics;
+using namespace tpelib;
+
+/// \brief Bits of each cell coordinate in a cell key. Cells further apart
+/// than this share keys, which only adds candidates that fail the box test.
+static constexpr unsigned int kKeyBits = 21u;
+
+//////////////////////////////////////////////////
+/// \brief Whether a ray crosses a box within a distance
+/// \param[in] _aabb Box
+/// \param[in] _origin Start of the ray
+/// \param[in] _direction Direction of the ray
+/// \param[in] _maxDistance Length of the ray
+/// \param[out] _enter Distance at which the ray enters the box
+/// \param[out] _exit Distance at which the ray leaves the box
+/// \return True if the ray crosses the box
+static bool rayCrossesBox(const HashGrid::AABB &_aabb,
+    const std::vector<double> &_origin, const std::vector<double> &_direction,
+    double _maxDistance, double &_enter, double &_exit)
+{
+  _enter = 0.0;
+  _exit = _maxDistance;
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    if (std::fpclassify(_direction[i]) == FP_ZERO)
+    {
+      if (_origin[i] < _aabb.lowerBound[i] ||
+          _origin[i] > _aabb.upperBound[i])
+      {
+        return false;
+      }
+      continue;
+    }
+
+    double t1 = (_aabb.lowerBound[i] - _origin[i]) / _direction[i];
+    double t2 = (_aabb.upperBound[i] - _origin[i]) / _direction[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    _enter = std::max(_enter, t1);
+    _exit = std::min(_exit, t2);
+    if (_enter > _exit)
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+HashGrid::HashGrid(double _cellSize)
+  : cellSize(_cellSize)
+{
+}
+
+//////////////////////////////////////////////////
+double HashGrid::GetCellSize() const
+{
+  return this->cellSize;
+}
+
+//////////////////////////////////////////////////
+void HashGrid::insertParticle(unsigned int _particle,
+    const std::vector<double> &_lowerBound,
+    const std::vector<double> &_upperBound)
+{
+  Particle &particle = this->particles[_particle];
+  particle.aabb = AABB(_lowerBound, _upperBound);
+  particle.mask = ALL_MASKS;
+  this->Link(_particle, particle);
+}
+
+//////////////////////////////////////////////////
+void HashGrid::insertParticles(const std::vector<unsigned int> &_particles,
+    const std::vector<std::vector<double>> &_lowerBounds,
+    const std::vector<std::vector<double>> &_upperBounds)
+{
+  this->particles.reserve(this->particles.size() + _particles.size());
+  for (std::size_t i = 0; i < _particles.size(); ++i)
+    this->insertParticle(_particles[i], _lowerBounds[i], _upperBounds[i]);
+}
+
+//////////////////////////////////////////////////
+unsigned int HashGrid::nParticles() const
+{
+  return static_cast<unsigned int>(this->particles.size());
+}
+
+//////////////////////////////////////////////////
+bool HashGrid::hasParticle(unsigned int _particle) const
+{
+  return this->particles.find(_particle) != this->particles.end();
+}
+
+//////////////////////////////////////////////////
+void HashGrid::setParticleMask(unsigned int _particle, unsigned int _mask)
+{
+  this->particles.at(_particle).mask = _mask;
+}
+
+//////////////////////////////////////////////////
+void HashGrid::removeParticle(unsigned int _particle)
+{
+  auto it = this->particles.find(_particle);
+  if (it == this->particles.end())
+    return;
+  this->Unlink(_particle, it->second);
+  this->particles.erase(it);
+}
+
+//////////////////////////////////////////////////
+bool HashGrid::updateParticle(unsigned int _particle,
+    const std::vector<double> &_lowerBound,
+    const std::vector<double> &_upperBound)
+{
+  Particle &particle = this->particles.at(_particle);
+  const AABB aabb(_lowerBound, _upperBound);
+
+  // a box that stays within the cells it covers only needs its bounds
+  // updated
+  Cell lower;
+  Cell upper;
+  if (this->CellRange(aabb, lower, upper) && !particle.large &&
+      lower == particle.lower && upper == particle.upper)
+  {
+    particle.aabb = aabb;
+    return false;
+  }
+
+  this->Unlink(_particle, particle);
+  particle.aabb = aabb;
+  this->Link(_particle, particle);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void HashGrid::refitParticles(const std::vector<unsigned int> &_particles,
+    const std::vector<std::vector<double>> &_lowerBounds,
+    const std::vector<std::vector<double>> &_upperBounds)
+{
+  for (std::size_t i = 0; i < _particles.size(); ++i)
+    this->updateParticle(_particles[i], _lowerBounds[i], _upperBounds[i]);
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> HashGrid::query(unsigned int _particle)
+{
+  std::vector<unsigned int> result;
+  this->query(_particle, result);
+  return result;
+}
+
+//////////////////////////////////////////////////
+void HashGrid::query(unsigned int _particle,
+    std::vector<unsigned int> &_particles)
+{
+  const auto it = this->particles.find(_particle);
+  if (it == this->particles.end())
+    return;
+  const Particle &p = it->second;
+
+  const auto pairs = [&p](const Particle &_q)
+  {
+    return (p.mask & _q.mask) != 0u && p.aabb.overlaps(_q.aabb, true);
+  };
+
+  if (p.large)
+  {
+    for (const auto &[id, q] : this->particles)
+    {
+      if (id != _particle && pairs(q))
+        _particles.push_back(id);
+    }
+    return;
+  }
+
+  // a pair of boxes in the cells is reported from the first cell that both
+  // cover, so that it is reported once
+  Cell cell;
+  for (cell[0] = p.lower[0]; cell[0] <= p.upper[0]; ++cell[0])
+  {
+    for (cell[1] = p.lower[1]; cell[1] <= p.upper[1]; ++cell[1])
+    {
+      for (cell[2] = p.lower[2]; cell[2] <= p.upper[2]; ++cell[2])
+      {
+        const auto bucket = this->cells.find(Key(cell));
+        if (bucket == this->cells.end())
+          continue;
+        for (unsigned int id : bucket->second)
+        {
+          if (id == _particle)
+            continue;
+          const Particle &q = this->particles.at(id);
+          if (std::max(p.lower[0], q.lower[0]) == cell[0] &&
+              std::max(p.lower[1], q.lower[1]) == cell[1] &&
+              std::max(p.lower[2], q.lower[2]) == cell[2] && pairs(q))
+          {
+            _particles.push_back(id);
+          }
+        }
+      }
+    }
+  }
+
+  for (unsigned int id : this->largeParticles)
+  {
+    if (pairs(this->particles.at(id)))
+      _particles.push_back(id);
+  }
+}
+
+//////////////////////////////////////////////////
+void HashGrid::queryPairs(
+    std::vector<std::pair<unsigned int, unsigned int>> &_pairs)
+{
+  const auto pairs = [](const Particle &_p, const Particle &_q)
+  {
+    return (_p.mask & _q.mask) != 0u && _p.aabb.overlaps(_q.aabb, true);
+  };
+
+  for (const auto &[key, ids] : this->cells)
+  {
+    for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+      const Particle &p = this->particles.at(ids[i]);
+      for (std::size_t j = i + 1u; j < ids.size(); ++j)
+      {
+        const Particle &q = this->particles.at(ids[j]);
+        const Cell first{std::max(p.lower[0], q.lower[0]),
+            std::max(p.lower[1], q.lower[1]),
+            std::max(p.lower[2], q.lower[2])};
+        if (Key(first) == key && pairs(p, q))
+          _pairs.push_back(std::minmax(ids[i], ids[j]));
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < this->largeParticles.size(); ++i)
+  {
+    const unsigned int largeId = this->largeParticles[i];
+    const Particle &large = this->particles.at(largeId);
+    for (const auto &[id, q] : this->particles)
+    {
+      // pairs of large particles are reported from the first of them in
+      // largeParticles
+      if (id == largeId || (q.large && std::find(
+            this->largeParticles.begin(), this->largeParticles.begin() + i,
+            id) != this->largeParticles.begin() + i))
+      {
+        continue;
+      }
+      if (pairs(large, q))
+        _pairs.push_back(std::minmax(largeId, id));
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void HashGrid::queryRay(const std::vector<double> &_origin,
+    const std::vector<double> &_direction, double _maxDistance,
+    const std::function<double(unsigned int, double)> &_callback) const
+{
+  double enter = 0.0;
+  double exit = 0.0;
+  for (unsigned int id : this->largeParticles)
+  {
+    if (rayCrossesBox(this->particles.at(id).aabb, _origin, _direction,
+          _maxDistance, enter, exit))
+    {
+      _maxDistance = _callback(id, _maxDistance);
+    }
+  }
+
+  double boundsEnter = 0.0;
+  double boundsExit = 0.0;
+  if (this->cellBoundsEmpty || !rayCrossesBox(this->cellBounds, _origin,
+        _direction, _maxDistance, boundsEnter, boundsExit))
+  {
+    return;
+  }
+
+  // walk the cells crossed by the ray within the bounds of the boxes in
+  // the cells, in the order the ray crosses them
+  const std::array<double, 3> start{
+      _origin[0] + boundsEnter * _direction[0],
+      _origin[1] + boundsEnter * _direction[1],
+      _origin[2] + boundsEnter * _direction[2]};
+  const Cell first = this->CellOf({this->cellBounds.lowerBound[0],
+      this->cellBounds.lowerBound[1], this->cellBounds.lowerBound[2]});
+  const Cell last = this->CellOf({this->cellBounds.upperBound[0],
+      this->cellBounds.upperBound[1], this->cellBounds.upperBound[2]});
+  Cell cell = this->CellOf(start);
+  std::array<std::int64_t, 3> step{};
+  std::array<double, 3> next{};
+  std::array<double, 3> delta{};
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    cell[i] = std::clamp(cell[i], first[i], last[i]);
+    if (std::fpclassify(_direction[i]) == FP_ZERO)
+    {
+      next[i] = std::numeric_limits<double>::infinity();
+      delta[i] = std::numeric_limits<double>::infinity();
+      continue;
+    }
+    step[i] = _direction[i] > 0.0 ? 1 : -1;
+    const double boundary = static_cast<double>(
+        cell[i] + (_direction[i] > 0.0 ? 1 : 0)) * this->cellSize;
+    next[i] = (boundary - _origin[i]) / _direction[i];
+    delta[i] = this->cellSize / std::abs(_direction[i]);
+  }
+
+  std::unordered_set<unsigned int> visited;
+  while (true)
+  {
+    const auto bucket = this->cells.find(Key(cell));
+    if (bucket != this->cells.end())
+    {
+      for (unsigned int id : bucket->second)
+      {
+        if (visited.insert(id).second && rayCrossesBox(
+              this->particles.at(id).aabb, _origin, _direction,
+              _maxDistance, enter, exit))
+        {
+          _maxDistance = _callback(id, _maxDistance);
+        }
+      }
+    }
+
+    const unsigned int axis = next[0] < next[1] ?
+        (next[0] < next[2] ? 0u : 2u) : (next[1] < next[2] ? 1u : 2u);
+    if (next[axis] > std::min(boundsExit, _maxDistance))
+      break;
+    cell[axis] += step[axis];
+    if (cell[axis] < first[axis] || cell[axis] > last[axis])
+      break;
+    next[axis] += delta[axis];
+  }
+}
+
+//////////////////////////////////////////////////
+void HashGrid::queryRegion(const AABB &_region,
+    std::vector<unsigned int> &_particles) const
+{
+  for (unsigned int id : this->largeParticles)
+  {
+    if (_region.overlaps(this->particles.at(id).aabb, true))
+      _particles.push_back(id);
+  }
+
+  Cell lower;
+  Cell upper;
+  if (!this->CellRange(_region, lower, upper))
+  {
+    // large regions test every box instead of walking their cells
+    for (const auto &[id, q] : this->particles)
+    {
+      if (!q.large && _region.overlaps(q.aabb, true))
+        _particles.push_back(id);
+    }
+    return;
+  }
+
+  Cell cell;
+  for (cell[0] = lower[0]; cell[0] <= upper[0]; ++cell[0])
+  {
+    for (cell[1] = lower[1]; cell[1] <= upper[1]; ++cell[1])
+    {
+      for (cell[2] = lower[2]; cell[2] <= upper[2]; ++cell[2])
+      {
+        const auto bucket = this->cells.find(Key(cell));
+        if (bucket == this->cells.end())
+          continue;
+        for (unsigned int id : bucket->second)
+        {
+          const Particle &q = this->particles.at(id);
+          if (std::max(lower[0], q.lower[0]) == cell[0] &&
+              std::max(lower[1], q.lower[1]) == cell[1] &&
+              std::max(lower[2], q.lower[2]) == cell[2] &&
+              _region.overlaps(q.aabb, true))
+          {
+            _particles.push_back(id);
+          }
+        }
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+const HashGrid::AABB &HashGrid::getAABB(unsigned int _particle)
+{
+  return this->particles.at(_particle).aabb;
+}
+
+//////////////////////////////////////////////////
+void HashGrid::rebuild()
+{
+  for (auto it = this->cells.begin(); it != this->cells.end();)
+  {
+    if (it->second.empty())
+      it = this->cells.erase(it);
+    else
+      ++it;
+  }
+
+  this->cellBoundsEmpty = true;
+  for (const auto &[id, p] : this->particles)
+  {
+    if (p.large)
+      continue;
+    if (this->cellBoundsEmpty)
+      this->cellBounds = p.aabb;
+    else
+      this->cellBounds.merge(this->cellBounds, p.aabb);
+    this->cellBoundsEmpty = false;
+  }
+}
+
+//////////////////////////////////////////////////
+double HashGrid::computeSurfaceAreaRatio() const
+{
+  return 1.0;
+}
+
+//////////////////////////////////////////////////
+std::size_t HashGrid::GetMemoryBytes() const
+{
+  // each entry of a hash map has a link and a hash bucket
+  const std::size_t entryBytes = 2u * sizeof(void *);
+  std::size_t bytes = sizeof(HashGrid) +
+      this->particles.size() * (sizeof(Particle) + entryBytes) +
+      vectorBytes(this->largeParticles);
+  for (const auto &cell : this->cells)
+  {
+    bytes += sizeof(cell) + entryBytes + vectorBytes(cell.second);
+  }
+  return bytes;
+}
+
+//////////////////////////////////////////////////
+bool HashGrid::CellRange(const AABB &_aabb, Cell &_lower, Cell &_upper) const
+{
+  // boxes far from the origin or unbounded would overflow the cell
+  // coordinates, and cover too many cells anyway
+  const double limit = std::ldexp(1.0, 52);
+  double count = 1.0;
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    const double lower = std::floor(_aabb.lowerBound[i] / this->cellSize);
+    const double upper = std::floor(_aabb.upperBound[i] / this->cellSize);
+    if (!(std::abs(lower) < limit) || !(std::abs(upper) < limit))
+      return false;
+    _lower[i] = static_cast<std::int64_t>(lower);
+    _upper[i] = static_cast<std::int64_t>(upper);
+    count *= upper - lower + 1.0;
+  }
+  return count <= static_cast<double>(kMaxCellsPerParticle);
+}
+
+//////////////////////////////////////////////////
+HashGrid::Cell HashGrid::CellOf(const std::array<double, 3> &_point) const
+{
+  Cell cell;
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    cell[i] = static_cast<std::int64_t>(
+        std::floor(_point[i] / this->cellSize));
+  }
+  return cell;
+}
+
+//////////////////////////////////////////////////
+std::uint64_t HashGrid::Key(const Cell &_cell)
+{
+  const std::uint64_t mask = (std::uint64_t(1) << kKeyBits) - 1u;
+  return ((static_cast<std::uint64_t>(_cell[0]) & mask) << (2u * kKeyBits)) |
+      ((static_cast<std::uint64_t>(_cell[1]) & mask) << kKeyBits) |
+      (static_cast<std::uint64_t>(_cell[2]) & mask);
+}
+
+//////////////////////////////////////////////////
+void HashGrid::Link(unsigned int _id, Particle &_particle)
+{
+  _particle.large =
+      !this->CellRange(_particle.aabb, _particle.lower, _particle.upper);
+  if (_particle.large)
+  {
+    this->largeParticles.push_back(_id);
+    return;
+  }
+
+  Cell cell;
+  for (cell[0] = _particle.lower[0]; cell[0] <= _particle.upper[0]; ++cell[0])
+  {
+    for (cell[1] = _particle.lower[1]; cell[1] <= _particle.upper[1];
+         ++cell[1])
+    {
+      for (cell[2] = _particle.lower[2]; cell[2] <= _particle.upper[2];
+           ++cell[2])
+      {
+        this->cells[Key(cell)].push_back(_id);
+      }
+    }
+  }
+
+  if (this->cellBoundsEmpty)
+    this->cellBounds = _particle.aabb;
+  else
+    this->cellBounds.merge(this->cellBounds, _particle.aabb);
+  this->cellBoundsEmpty = false;
+}
+
+//////////////////////////////////////////////////
+void HashGrid::Unlink(unsigned int _id, const Particle &_particle)
+{
+  if (_particle.large)
+  {
+    this->largeParticles.erase(std::remove(this->largeParticles.begin(),
+        this->largeParticles.end(), _id), this->largeParticles.end());
+    return;
+  }
+
+  Cell cell;
+  for (cell[0] = _particle.lower[0]; cell[0] <= _particle.upper[0]; ++cell[0])
+  {
+    for (cell[1] = _particle.lower[1]; cell[1] <= _particle.upper[1];
+         ++cell[1])
+    {
+      for (cell[2] = _particle.lower[2]; cell[2] <= _particle.upper[2];
+           ++cell[2])
+      {
+        // empty buckets are kept, since moving boxes tend to come back to
+        // the same cells, and dropped by rebuild
+        auto bucket = this->cells.find(Key(cell));
+        if (bucket == this->cells.end())
+          continue;
+        auto &ids = bucket->second;
+        auto it = std::find(ids.begin(), ids.end(), _id);
+        if (it != ids.end())
+        {
+          *it = ids.back();
+          ids.pop_back();
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_TPE_LIB_SRC_HASHGRID_HH_
+#define GZ_PHYSICS_TPE_LIB_SRC_HASHGRID_HH_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "aabb_tree/AABB.h"
+
+namespace gz {
+namespace physics {
+namespace tpelib {
+
+/// \brief Broadphase that keeps boxes in the cells of a uniform grid, found
+/// through a hash map of the occupied cells. A box that moves within the
+/// cells it covers is updated in place, and otherwise costs a few hash
+/// inserts, instead of a tree reinsertion. Suited to many boxes of similar
+/// size, about one cell each. Boxes that cover more than
+/// kMaxCellsPerParticle cells, e.g. the ground, are kept in a separate list
+/// and tested against every other box.
+///
+/// The member functions follow the part of the interface of aabb::TreeT
+/// that AABBTree uses, so that AABBTree can keep its nodes in either.
+/// Touching boxes overlap, and two boxes are only paired if their masks
+/// share a bit, as in the tree.
+class HashGrid
+{
+  /// \brief Box type of the grid
+  public: using AABB = aabb::AABBT<double>;
+
+  /// \brief Boxes covering more cells than this are tested against every
+  /// other box instead of being put in the cells
+  public: static constexpr std::size_t kMaxCellsPerParticle = 64u;
+
+  /// \brief Constructor
+  /// \param[in] _cellSize Edge length of the cells, greater than 0
+  public: explicit HashGrid(double _cellSize);
+
+  /// \brief Get the edge length of the cells
+  /// \return Cell size
+  public: double GetCellSize() const;
+
+  /// \brief Insert a particle
+  /// \param[in] _particle Particle index, not in the grid yet
+  /// \param[in] _lowerBound Lower bound of its box
+  /// \param[in] _upperBound Upper bound of its box
+  public: void insertParticle(unsigned int _particle,
+      const std::vector<double> &_lowerBound,
+      const std::vector<double> &_upperBound);
+
+  /// \brief Insert many particles
+  /// \param[in] _particles Particle indices, not in the grid yet
+  /// \param[in] _lowerBounds Lower bound of the box of each particle
+  /// \param[in] _upperBounds Upper bound of the box of each particle
+  public: void insertParticles(const std::vector<unsigned int> &_particles,
+      const std::vector<std::vector<double>> &_lowerBounds,
+      const std::vector<std::vector<double>> &_upperBounds);
+
+  /// \brief Get the number of particles
+  /// \return Number of particles
+  public: unsigned int nParticles() const;
+
+  /// \brief Get whether a particle is in the grid
+  /// \param[in] _particle Particle index
+  /// \return True if the particle is in the grid
+  public: bool hasParticle(unsigned int _particle) const;
+
+  /// \brief Set the collision mask of a particle in the grid
+  /// \param[in] _particle Particle index
+  /// \param[in] _mask Collision mask
+  public: void setParticleMask(unsigned int _particle, unsigned int _mask);
+
+  /// \brief Remove a particle in the grid
+  /// \param[in] _particle Particle index
+  public: void removeParticle(unsigned int _particle);
+
+  /// \brief Update the box of a particle in the grid
+  /// \param[in] _particle Particle index
+  /// \param[in] _lowerBound New lower bound of its box
+  /// \param[in] _upperBound New upper bound of its box
+  /// \return True if the particle moved to other cells
+  public: bool updateParticle(unsigned int _particle,
+      const std::vector<double> &_lowerBound,
+      const std::vector<double> &_upperBound);
+
+  /// \brief Update the boxes of many particles in the grid
+  /// \param[in] _particles Particle indices
+  /// \param[in] _lowerBounds New lower bound of the box of each particle
+  /// \param[in] _upperBounds New upper bound of the box of each particle
+  public: void refitParticles(const std::vector<unsigned int> &_particles,
+      const std::vector<std::vector<double>> &_lowerBounds,
+      const std::vector<std::vector<double>> &_upperBounds);
+
+  /// \brief Get the particles whose boxes overlap that of a particle
+  /// \param[in] _particle Particle index
+  /// \return Overlapping particles, without _particle
+  public: std::vector<unsigned int> query(unsigned int _particle);
+
+  /// \brief Get the particles whose boxes overlap that of a particle
+  /// \param[in] _particle Particle index
+  /// \param[out] _particles Overlapping particles are appended to this
+  /// vector, without _particle
+  public: void query(unsigned int _particle,
+      std::vector<unsigned int> &_particles);
+
+  /// \brief Get all pairs of particles whose boxes overlap. Each pair is
+  /// appended once, with the smaller index first.
+  /// \param[out] _pairs Vector to append the pairs to
+  public: void queryPairs(
+      std::vector<std::pair<unsigned int, unsigned int>> &_pairs);
+
+  /// \brief Visit the particles whose box is crossed by a ray, walking the
+  /// cells along it
+  /// \param[in] _origin Start of the ray
+  /// \param[in] _direction Direction of the ray
+  /// \param[in] _maxDistance Length of the ray, in multiples of _direction
+  /// \param[in] _callback Called with each particle crossed within the
+  /// current maximum distance, returns the new maximum distance
+  public: void queryRay(const std::vector<double> &_origin,
+      const std::vector<double> &_direction, double _maxDistance,
+      const std::function<double(unsigned int, double)> &_callback) const;
+
+  /// \brief Get the particles whose boxes overlap a region
+  /// \param[in] _region Region to test
+  /// \param[out] _particles Overlapping particles are appended to this
+  /// vector
+  public: void queryRegion(const AABB &_region,
+      std::vector<unsigned int> &_particles) const;
+
+  /// \brief Get the box of a particle in the grid
+  /// \param[in] _particle Particle index
+  /// \return Box of the particle
+  public: const AABB &getAABB(unsigned int _particle);
+
+  /// \brief Drop the hash buckets of cells that are no longer occupied and
+  /// recompute the bounds of the boxes in the cells
+  public: void rebuild();
+
+  /// \brief The grid has no hierarchy to degrade, so its quality is
+  /// constant
+  /// \return 1
+  public: double computeSurfaceAreaRatio() const;
+
+  /// \brief Estimate the memory used by the grid
+  /// \return Bytes used by the particles and the occupied cells
+  public: std::size_t GetMemoryBytes() const;
+
+  /// \brief Integer coordinates of a cell
+  private: using Cell = std::array<std::int64_t, 3>;
+
+  /// \brief A particle in the grid
+  private: struct Particle
+  {
+    /// \brief Box of the particle
+    AABB aabb;
+
+    /// \brief Collision mask of the particle
+    unsigned int mask = ALL_MASKS;
+
+    /// \brief First and last cell covered by the box, if it is in the cells
+    Cell lower{};
+    Cell upper{};
+
+    /// \brief True if the box covers too many cells and is in largeParticles
+    bool large = false;
+  };
+
+  /// \brief Find the range of cells covered by a box
+  /// \param[in] _aabb Box
+  /// \param[out] _lower First cell covered by the box
+  /// \param[out] _upper Last cell covered by the box
+  /// \return False if the box covers more than kMaxCellsPerParticle cells
+  private: bool CellRange(const AABB &_aabb, Cell &_lower, Cell &_upper) const;
+
+  /// \brief Get the cell that contains a coordinate along each axis
+  /// \param[in] _point Coordinates
+  /// \return Cell
+  private: Cell CellOf(const std::array<double, 3> &_point) const;
+
+  /// \brief Hash key of a cell
+  /// \param[in] _cell Cell
+  /// \return Key of the cell in cells
+  private: static std::uint64_t Key(const Cell &_cell);
+
+  /// \brief Add a particle to the cells it covers, or to largeParticles
+  /// \param[in] _id Particle index
+  /// \param[in,out] _particle Particle, whose cell range is updated
+  private: void Link(unsigned int _id, Particle &_particle);
+
+  /// \brief Remove a particle from the cells it covers, or from
+  /// largeParticles
+  /// \param[in] _id Particle index
+  /// \param[in] _particle Particle
+  private: void Unlink(unsigned int _id, const Particle &_particle);
+
+  /// \brief Edge length of the cells
+  private: double cellSize;
+
+  /// \brief Particles by index
+  private: std::unordered_map<unsigned int, Particle> particles;
+
+  /// \brief Particles in each occupied cell, by cell key. A particle is in
+  /// every cell its box covers.
+  private: std::unordered_map<std::uint64_t, std::vector<unsigned int>>
+      cells;
+
+  /// \brief Particles covering more than kMaxCellsPerParticle cells
+  private: std::vector<unsigned int> largeParticles;
+
+  /// \brief Union of the boxes of the particles in the cells, which bounds
+  /// the walk of queryRay. Only grows between calls to rebuild.
+  private: AABB cellBounds;
+
+  /// \brief True if cellBounds holds no box yet
+  private: bool cellBoundsEmpty = true;
+};
+
+}
+}
+}
+
+#endif
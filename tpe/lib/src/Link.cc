@@ -17,6 +17,7 @@
 
 #include "Collision.hh"
 #include "Link.hh"
+#include "Model.hh"
 
 using namespace gz;
 using namespace physics;
@@ -37,7 +38,8 @@ Entity &Link::AddCollision()
 {
   std::size_t collisionId = Entity::GetNextId();
   const auto[it, success] = this->GetChildren().insert(
-    {collisionId, std::make_shared<Collision>(collisionId)});
+    {collisionId,
+     MakeShared<Collision>(this->GetMemoryResource(), collisionId)});
   it->second->SetParent(this);
   this->ChildrenChanged();
   return *it->second;
@@ -47,6 +49,10 @@ Entity &Link::AddCollision()
 void Link::SetLinearVelocity(const math::Vector3d &_velocity)
 {
   this->linearVelocity = _velocity;
+  if (_velocity == math::Vector3d::Zero)
+    return;
+  if (auto *model = dynamic_cast<Model *>(this->GetParent()))
+    model->Wake();
 }
 
 //////////////////////////////////////////////////
@@ -59,6 +65,10 @@ math::Vector3d Link::GetLinearVelocity() const
 void Link::SetAngularVelocity(const math::Vector3d &_velocity)
 {
   this->angularVelocity = _velocity;
+  if (_velocity == math::Vector3d::Zero)
+    return;
+  if (auto *model = dynamic_cast<Model *>(this->GetParent()))
+    model->Wake();
 }
 
 //////////////////////////////////////////////////
@@ -15,6 +15,9 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -25,6 +28,8 @@
 
 #include "Link.hh"
 #include "Model.hh"
+#include "Trajectory.hh"
+#include "Utils.hh"
 
 /// \brief Private data class for Model
 class gz::physics::tpelib::ModelPrivate
@@ -40,6 +45,18 @@ class gz::physics::tpelib::ModelPrivate
 
   /// \brief Nested models
   public: std::vector<std::size_t> nestedModelIds;
+
+  /// \brief Number of consecutive steps the model has been at rest
+  public: std::size_t restSteps = 0u;
+
+  /// \brief Trajectory the model follows, if any
+  public: std::unique_ptr<Trajectory> trajectory;
+
+  /// \brief Updates per second, 0 to update in every step
+  public: double updateRate = 0.0;
+
+  /// \brief Number of steps since the last update
+  public: std::size_t skippedSteps = 0u;
 };
 
 using namespace gz;
@@ -77,7 +94,7 @@ Entity &Model::AddLink()
   }
 
   const auto[it, success]  = this->GetChildren().insert(
-      {linkId, std::make_shared<Link>(linkId)});
+      {linkId, MakeShared<Link>(this->GetMemoryResource(), linkId)});
   this->dataPtr->linkIds.push_back(linkId);
 
   it->second->SetParent(this);
@@ -96,7 +113,7 @@ Entity &Model::AddModel()
 {
   std::size_t modelId = Entity::GetNextId();
   const auto[it, success]  = this->GetChildren().insert(
-      {modelId, std::make_shared<Model>(modelId)});
+      {modelId, MakeShared<Model>(this->GetMemoryResource(), modelId)});
   this->dataPtr->nestedModelIds.push_back(modelId);
 
   it->second->SetParent(this);
@@ -153,6 +170,8 @@ Entity &Model::GetCanonicalLink()
 void Model::SetLinearVelocity(const math::Vector3d &_velocity)
 {
   this->linearVelocity = _velocity;
+  if (_velocity != math::Vector3d::Zero)
+    this->Wake();
 }
 
 //////////////////////////////////////////////////
@@ -166,6 +185,8 @@ math::Vector3d Model::GetLinearVelocity() const
 void Model::SetAngularVelocity(const math::Vector3d &_velocity)
 {
   this->angularVelocity = _velocity;
+  if (_velocity != math::Vector3d::Zero)
+    this->Wake();
 }
 
 //////////////////////////////////////////////////
@@ -191,6 +212,145 @@ void Model::UpdatePose(double _timeStep)
   this->SetPose(nextPose);
 }
 
+//////////////////////////////////////////////////
+void Model::SetPose(const math::Pose3d &_pose)
+{
+  Entity::SetPose(_pose);
+  this->Wake();
+}
+
+//////////////////////////////////////////////////
+void Model::SetTrajectory(const Trajectory &_trajectory)
+{
+  if (_trajectory.GetWaypoints().empty())
+  {
+    this->ClearTrajectory();
+    return;
+  }
+
+  this->dataPtr->trajectory = std::make_unique<Trajectory>(_trajectory);
+  this->Wake();
+}
+
+//////////////////////////////////////////////////
+void Model::ClearTrajectory()
+{
+  if (!this->dataPtr->trajectory)
+    return;
+
+  this->dataPtr->trajectory.reset();
+  this->linearVelocity = math::Vector3d::Zero;
+  this->angularVelocity = math::Vector3d::Zero;
+}
+
+//////////////////////////////////////////////////
+const Trajectory *Model::GetTrajectory() const
+{
+  return this->dataPtr->trajectory.get();
+}
+
+//////////////////////////////////////////////////
+bool Model::FollowTrajectory(double _time, double _timeStep,
+    math::Pose3d &_pose)
+{
+  const Trajectory *trajectory = this->dataPtr->trajectory.get();
+  if (nullptr == trajectory || _timeStep <= 0.0 ||
+      _time + _timeStep < trajectory->GetStartTime())
+  {
+    return false;
+  }
+
+  // the end was reached in the last step
+  if (_time >= trajectory->GetEndTime())
+  {
+    this->ClearTrajectory();
+    return false;
+  }
+
+  // the velocities are those that take the model to the next pose in one
+  // step, so that they are reported like those of a model moved by
+  // SetLinearVelocity and SetAngularVelocity
+  const math::Pose3d current = this->GetPose();
+  _pose = trajectory->Pose(_time + _timeStep);
+  this->linearVelocity = (_pose.Pos() - current.Pos()) / _timeStep;
+
+  math::Quaterniond delta = _pose.Rot() * current.Rot().Inverse();
+  if (delta.W() < 0.0)
+  {
+    delta = math::Quaterniond(-delta.W(), -delta.X(), -delta.Y(),
+        -delta.Z());
+  }
+  const math::Vector3d axis(delta.X(), delta.Y(), delta.Z());
+  const double sine = axis.Length();
+  this->angularVelocity = sine > 0.0 ?
+      axis * (2.0 * std::atan2(sine, delta.W()) / (sine * _timeStep)) :
+      math::Vector3d::Zero;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Model::SetUpdateRate(double _rate)
+{
+  // the steps skipped so far are caught up with by the next update
+  this->dataPtr->updateRate = std::max(_rate, 0.0);
+}
+
+//////////////////////////////////////////////////
+double Model::GetUpdateRate() const
+{
+  return this->dataPtr->updateRate;
+}
+
+//////////////////////////////////////////////////
+bool Model::ScheduleUpdate(std::size_t _step, double _timeStep,
+    double &_elapsed)
+{
+  const std::size_t pending = this->dataPtr->skippedSteps + 1u;
+  _elapsed = static_cast<double>(pending) * _timeStep;
+  if (this->dataPtr->updateRate <= 0.0 || _timeStep <= 0.0)
+  {
+    this->dataPtr->skippedSteps = 0u;
+    return true;
+  }
+
+  const std::size_t interval = static_cast<std::size_t>(std::max(1.0,
+      std::round(1.0 / (this->dataPtr->updateRate * _timeStep))));
+
+  // the phase of the model within its period is set by its ID, and an
+  // update is never later than a period after the previous one, e.g. when
+  // the rate or the step changed
+  if (pending < interval && (_step + this->GetId()) % interval != 0u)
+  {
+    this->dataPtr->skippedSteps = pending;
+    return false;
+  }
+
+  this->dataPtr->skippedSteps = 0u;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Model::UpdateSleeping(bool _atRest, std::size_t _sleepSteps)
+{
+  if (!_atRest || _sleepSteps == 0u)
+  {
+    this->dataPtr->restSteps = 0u;
+    return;
+  }
+
+  if (++this->dataPtr->restSteps >= _sleepSteps)
+    this->SetSleeping(true);
+}
+
+//////////////////////////////////////////////////
+void Model::Wake()
+{
+  this->dataPtr->restSteps = 0u;
+  this->SetSleeping(false);
+  if (auto *parent = dynamic_cast<Model *>(this->GetParent()))
+    parent->Wake();
+}
+
 //////////////////////////////////////////////////
 bool Model::RemoveModelById(std::size_t _id)
 {
@@ -231,6 +391,17 @@ bool Model::RemoveChildByName(const std::string &_name)
   return this->RemoveChildEntityBasedOnType(&ent);
 }
 
+//////////////////////////////////////////////////
+std::size_t Model::GetMemoryBytes() const
+{
+  return Entity::GetMemoryBytes() + sizeof(Model) - sizeof(Entity) +
+      sizeof(ModelPrivate) + vectorBytes(this->dataPtr->linkIds) +
+      vectorBytes(this->dataPtr->nestedModelIds) +
+      (this->dataPtr->trajectory ? sizeof(Trajectory) +
+       this->dataPtr->trajectory->GetWaypoints().capacity() *
+       (sizeof(Trajectory::Waypoint) + sizeof(math::Vector3d)) : 0u);
+}
+
 //////////////////////////////////////////////////
 bool Model::RemoveChildEntityBasedOnType(const Entity *_ent)
 {
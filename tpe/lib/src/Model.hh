@@ -30,6 +30,7 @@ namespace tpelib {
 
 // forward declaration
 class ModelPrivate;
+class Trajectory;
 
 /// \brief Model class
 class GZ_PHYSICS_TPELIB_VISIBLE Model : public Entity
@@ -88,6 +89,69 @@ class GZ_PHYSICS_TPELIB_VISIBLE Model : public Entity
   /// \param[in] _timeStep current world timestep in seconds
   public: virtual void UpdatePose(double _timeStep);
 
+  /// \brief Set the pose of the model. Wakes the model up.
+  /// \param[in] _pose Pose of the model
+  public: void SetPose(const math::Pose3d &_pose) override;
+
+  /// \brief Make the model follow a trajectory. From the time of its first
+  /// waypoint, World::Step sets the pose of the model from the trajectory
+  /// instead of integrating its velocities, and sets the velocities to
+  /// those that reach the pose, until the last waypoint. The model then
+  /// stops and the trajectory is cleared. Wakes the model up.
+  /// \param[in] _trajectory Trajectory, whose poses are relative to the
+  /// parent of the model. An empty trajectory clears the current one.
+  public: void SetTrajectory(const Trajectory &_trajectory);
+
+  /// \brief Stop following the trajectory, if any. The model stops moving.
+  public: void ClearTrajectory();
+
+  /// \brief Get the trajectory the model follows
+  /// \return Trajectory, or nullptr if the model follows none
+  public: const Trajectory *GetTrajectory() const;
+
+  /// \brief Follow the trajectory over a step, setting the velocities of
+  /// the model to reach the pose at the end of the step. Clears the
+  /// trajectory once its end was reached. The pose is not set.
+  /// \param[in] _time World time at the start of the step
+  /// \param[in] _timeStep Length of the step
+  /// \param[out] _pose Pose of the model at the end of the step
+  /// \return True if the trajectory gives the pose, false if the model
+  /// integrates its velocities instead
+  public: bool FollowTrajectory(double _time, double _timeStep,
+      math::Pose3d &_pose);
+
+  /// \brief Set how often the model is updated
+  /// \param[in] _rate Updates per second, 0 to update the model in every
+  /// step of its world
+  public: void SetUpdateRate(double _rate);
+
+  /// \brief Get how often the model is updated
+  /// \return Updates per second, 0 if the model is updated in every step
+  public: double GetUpdateRate() const;
+
+  /// \brief Count a step of the world and decide whether the model is
+  /// updated in it. Models with the same rate are spread over the steps of
+  /// their period by their ID.
+  /// \param[in] _step Number of the step
+  /// \param[in] _timeStep Length of the step
+  /// \param[out] _elapsed Time since the last update of the model, which
+  /// is the time it integrates if it is updated
+  /// \return True if the model is updated in this step
+  public: bool ScheduleUpdate(std::size_t _step, double _timeStep,
+      double &_elapsed);
+
+  /// \brief Count the steps that the model has been at rest, and put it to
+  /// sleep once it has been at rest long enough
+  /// \param[in] _atRest True if the model and its links did not move in
+  /// the last step
+  /// \param[in] _sleepSteps Number of steps at rest after which the model
+  /// sleeps
+  public: void UpdateSleeping(bool _atRest, std::size_t _sleepSteps);
+
+  /// \brief Wake the model up and restart counting the steps it is at rest.
+  /// Waking a nested model wakes the model it belongs to.
+  public: void Wake();
+
   /// \brief Removes a child entity (either a link or model) from the
   /// appropriate child entity containers
   /// \param[in] _ent Pointer to entity
@@ -103,6 +167,9 @@ class GZ_PHYSICS_TPELIB_VISIBLE Model : public Entity
   /// \return True if child entity was removed, false otherwise
   public: bool RemoveChildByName(const std::string &_name) override;
 
+  // Documentation inherited
+  public: std::size_t GetMemoryBytes() const override;
+
   GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
   /// \brief linear velocity of model
   protected: math::Vector3d linearVelocity;
@@ -206,6 +206,56 @@ TEST(Model, BoundingBox)
   EXPECT_EQ(expectedBoxModelFrame, model.GetBoundingBox());
 }
 
+/////////////////////////////////////////////////
+TEST(Model, BoundingBoxDirty)
+{
+  Model model;
+  Entity &linkEnt = model.AddLink();
+  Link *link = static_cast<Link *>(&linkEnt);
+  Entity &collisionEnt = link->AddCollision();
+  Collision *collision = static_cast<Collision *>(&collisionEnt);
+  BoxShape boxShape;
+  boxShape.SetSize(math::Vector3d(2, 2, 2));
+  collision->SetShape(boxShape);
+
+  EXPECT_TRUE(model.WorldBoundingBoxDirty());
+  EXPECT_EQ(math::Vector3d(1, 1, 1), model.GetBoundingBox().Max());
+  model.ResetPoseDirty();
+  EXPECT_FALSE(model.WorldBoundingBoxDirty());
+
+  // the cached box is returned until something below the model changes
+  EXPECT_EQ(math::Vector3d(1, 1, 1), model.GetBoundingBox().Max());
+  EXPECT_FALSE(model.WorldBoundingBoxDirty());
+
+  // moving a link invalidates the box of the model, but not its pose
+  linkEnt.SetPose(math::Pose3d(1, 0, 0, 0, 0, 0));
+  EXPECT_FALSE(model.PoseDirty());
+  EXPECT_TRUE(model.WorldBoundingBoxDirty());
+  EXPECT_EQ(math::Vector3d(2, 1, 1), model.GetBoundingBox().Max());
+  model.ResetPoseDirty();
+
+  // moving a collision invalidates the boxes of the link and the model
+  collisionEnt.SetPose(math::Pose3d(0, 1, 0, 0, 0, 0));
+  EXPECT_TRUE(linkEnt.WorldBoundingBoxDirty());
+  EXPECT_TRUE(model.WorldBoundingBoxDirty());
+  EXPECT_EQ(math::Vector3d(2, 2, 1), model.GetBoundingBox().Max());
+  model.ResetPoseDirty();
+
+  // changing the shape of a collision invalidates the box of the model
+  boxShape.SetSize(math::Vector3d(4, 4, 4));
+  collision->SetShape(boxShape);
+  EXPECT_TRUE(model.WorldBoundingBoxDirty());
+  EXPECT_EQ(math::Vector3d(3, 3, 2), model.GetBoundingBox().Max());
+  model.ResetPoseDirty();
+
+  // moving the model only sets its pose dirty
+  model.SetPose(math::Pose3d(5, 0, 0, 0, 0, 0));
+  EXPECT_TRUE(model.PoseDirty());
+  EXPECT_TRUE(model.WorldBoundingBoxDirty());
+  model.ResetPoseDirty();
+  EXPECT_FALSE(model.WorldBoundingBoxDirty());
+}
+
 /////////////////////////////////////////////////
 TEST(Model, CollideBitmask)
 {
@@ -15,12 +15,62 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include <gz/math/Helpers.hh>
+
 #include "Shape.hh"
+#include "Utils.hh"
 
 using namespace gz;
 using namespace physics;
 using namespace tpelib;
 
+//////////////////////////////////////////////////
+/// \brief Intersect a ray with the side of a cylinder around the z axis.
+/// Rays that start inside the infinite cylinder do not hit the side.
+/// \param[in] _origin Start of the ray in the frame of the cylinder
+/// \param[in] _direction Unit direction of the ray
+/// \param[in] _radius Radius of the cylinder
+/// \param[in] _halfLength Half of the length of the side
+/// \param[in] _maxDistance Only hits up to this distance are reported
+/// \param[out] _distance Distance from _origin to the hit
+/// \param[out] _normal Unit surface normal at the hit
+/// \return True if the ray hits the side within _maxDistance
+static bool rayIntersectsCylinderSide(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _radius, double _halfLength,
+    double _maxDistance, double &_distance, math::Vector3d &_normal)
+{
+  const double a = _direction.X() * _direction.X() +
+      _direction.Y() * _direction.Y();
+  const double b = _origin.X() * _direction.X() +
+      _origin.Y() * _direction.Y();
+  const double c = _origin.X() * _origin.X() + _origin.Y() * _origin.Y() -
+      _radius * _radius;
+  if (a <= 0.0 || c <= 0.0 || b > 0.0)
+    return false;
+
+  const double discriminant = b * b - a * c;
+  if (discriminant < 0.0)
+    return false;
+
+  const double t = (-b - std::sqrt(discriminant)) / a;
+  const double z = _origin.Z() + t * _direction.Z();
+  if (t > _maxDistance || std::abs(z) > _halfLength)
+    return false;
+
+  _distance = t;
+  _normal = math::Vector3d(_origin.X() + t * _direction.X(),
+      _origin.Y() + t * _direction.Y(), 0.0);
+  _normal.Normalize();
+  return true;
+}
+
 //////////////////////////////////////////////////
 Shape::Shape()
 {
@@ -50,6 +100,15 @@ ShapeType Shape::GetType() const
   return this->type;
 }
 
+//////////////////////////////////////////////////
+bool Shape::RayIntersection(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    double &_distance, math::Vector3d &_normal) const
+{
+  return rayIntersectsAxisAlignedBox(
+      _origin, _direction, this->bbox, _maxDistance, _distance, _normal);
+}
+
 //////////////////////////////////////////////////
 BoxShape::BoxShape() : Shape()
 {
@@ -108,6 +167,44 @@ void CapsuleShape::SetLength(double _length)
   this->dirty = true;
 }
 
+//////////////////////////////////////////////////
+bool CapsuleShape::RayIntersection(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    double &_distance, math::Vector3d &_normal) const
+{
+  const double halfLength = 0.5 * this->length;
+  const math::Vector3d p(0, 0, -halfLength);
+  const math::Vector3d q(0, 0, halfLength);
+  if (squaredSegmentDistance(_origin, _origin, p, q) <=
+      this->radius * this->radius)
+  {
+    return false;
+  }
+
+  bool hit = false;
+  double distance = _maxDistance;
+  math::Vector3d normal;
+  if (rayIntersectsCylinderSide(_origin, _direction, this->radius,
+      halfLength, distance, distance, normal))
+  {
+    hit = true;
+    _normal = normal;
+  }
+  for (const math::Vector3d &center : {p, q})
+  {
+    if (rayIntersectsSphere(_origin, _direction, center, this->radius,
+        distance, distance, normal))
+    {
+      hit = true;
+      _normal = normal;
+    }
+  }
+
+  if (hit)
+    _distance = distance;
+  return hit;
+}
+
 //////////////////////////////////////////////////
 void CapsuleShape::UpdateBoundingBox()
 {
@@ -147,6 +244,46 @@ void CylinderShape::SetLength(double _length)
   this->dirty = true;
 }
 
+//////////////////////////////////////////////////
+bool CylinderShape::RayIntersection(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    double &_distance, math::Vector3d &_normal) const
+{
+  const double halfLength = 0.5 * this->length;
+  const double radius2 = this->radius * this->radius;
+  const double originRadius2 =
+      _origin.X() * _origin.X() + _origin.Y() * _origin.Y();
+  if (originRadius2 <= radius2 && std::abs(_origin.Z()) <= halfLength)
+    return false;
+
+  bool hit = false;
+  double distance = _maxDistance;
+  if (rayIntersectsCylinderSide(_origin, _direction, this->radius,
+      halfLength, distance, distance, _normal))
+  {
+    hit = true;
+  }
+
+  // caps, only reachable from outside of their plane
+  for (const double side : {-1.0, 1.0})
+  {
+    if (side * _origin.Z() < halfLength || side * _direction.Z() >= 0.0)
+      continue;
+    const double t = (side * halfLength - _origin.Z()) / _direction.Z();
+    const double x = _origin.X() + t * _direction.X();
+    const double y = _origin.Y() + t * _direction.Y();
+    if (t > distance || x * x + y * y > radius2)
+      continue;
+    hit = true;
+    distance = t;
+    _normal = math::Vector3d(0, 0, side);
+  }
+
+  if (hit)
+    _distance = distance;
+  return hit;
+}
+
 //////////////////////////////////////////////////
 void CylinderShape::UpdateBoundingBox()
 {
@@ -173,6 +310,41 @@ void EllipsoidShape::SetRadii(const math::Vector3d &_radii)
   this->dirty = true;
 }
 
+//////////////////////////////////////////////////
+bool EllipsoidShape::RayIntersection(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    double &_distance, math::Vector3d &_normal) const
+{
+  if (this->radii.X() <= 0.0 || this->radii.Y() <= 0.0 ||
+      this->radii.Z() <= 0.0)
+  {
+    return false;
+  }
+
+  // the ellipsoid is a unit sphere once scaled by the inverse of its radii.
+  // The direction is scaled as well, so distances along the ray are kept.
+  const math::Vector3d o = _origin / this->radii;
+  const math::Vector3d d = _direction / this->radii;
+  const double a = d.SquaredLength();
+  const double b = o.Dot(d);
+  const double c = o.SquaredLength() - 1.0;
+  if (c <= 0.0 || b > 0.0)
+    return false;
+
+  const double discriminant = b * b - a * c;
+  if (discriminant < 0.0)
+    return false;
+
+  const double t = (-b - std::sqrt(discriminant)) / a;
+  if (t > _maxDistance)
+    return false;
+
+  _distance = t;
+  _normal = (o + d * t) / this->radii;
+  _normal.Normalize();
+  return true;
+}
+
 //////////////////////////////////////////////////
 void EllipsoidShape::UpdateBoundingBox()
 {
@@ -180,6 +352,52 @@ void EllipsoidShape::UpdateBoundingBox()
   this->bbox = math::AxisAlignedBox(-halfSize, halfSize);
 }
 
+//////////////////////////////////////////////////
+PlaneShape::PlaneShape() : Shape()
+{
+  this->type = ShapeType::PLANE;
+}
+
+//////////////////////////////////////////////////
+math::Vector3d PlaneShape::GetNormal() const
+{
+  return this->normal;
+}
+
+//////////////////////////////////////////////////
+void PlaneShape::SetNormal(const math::Vector3d &_normal)
+{
+  this->normal = _normal.Normalized();
+  this->dirty = true;
+}
+
+//////////////////////////////////////////////////
+bool PlaneShape::RayIntersection(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    double &_distance, math::Vector3d &_normal) const
+{
+  // rays that start below the plane are inside of it, and rays parallel to
+  // it never reach it
+  const double height = this->normal.Dot(_origin);
+  const double speed = this->normal.Dot(_direction);
+  if (height < 0.0 || speed >= 0.0)
+    return false;
+
+  const double t = -height / speed;
+  if (t > _maxDistance)
+    return false;
+
+  _distance = t;
+  _normal = this->normal;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void PlaneShape::UpdateBoundingBox()
+{
+  this->bbox = math::AxisAlignedBox();
+}
+
 //////////////////////////////////////////////////
 SphereShape::SphereShape() : Shape()
 {
@@ -199,6 +417,15 @@ void SphereShape::SetRadius(double _radius)
   this->dirty = true;
 }
 
+//////////////////////////////////////////////////
+bool SphereShape::RayIntersection(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    double &_distance, math::Vector3d &_normal) const
+{
+  return rayIntersectsSphere(_origin, _direction, math::Vector3d::Zero,
+      this->radius, _maxDistance, _distance, _normal);
+}
+
 //////////////////////////////////////////////////
 void SphereShape::UpdateBoundingBox()
 {
@@ -226,13 +453,91 @@ void MeshShape::SetScale(math::Vector3d _scale)
 }
 
 //////////////////////////////////////////////////
-void MeshShape::SetMesh(const common::Mesh &_mesh)
+void MeshShape::SetMesh(const common::Mesh &_mesh, bool _buildTriangleBvh)
 {
   math::Vector3d center;
   math::Vector3d min;
   math::Vector3d max;
   _mesh.AABB(center, min, max);
   this->meshAABB = math::AxisAlignedBox(min, max);
+  this->triangleBvh.reset();
+  if (_buildTriangleBvh)
+    this->triangleBvh = TriangleBvh::FromMesh(_mesh);
+  this->dirty = true;
+}
+
+//////////////////////////////////////////////////
+void MeshShape::SetTriangleBvh(std::shared_ptr<const TriangleBvh> _bvh)
+{
+  this->triangleBvh = std::move(_bvh);
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<const TriangleBvh> MeshShape::GetTriangleBvh() const
+{
+  return this->triangleBvh;
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox MeshShape::GetTriangleOverlap(
+    const math::AxisAlignedBox &_box)
+{
+  if (_box == math::AxisAlignedBox())
+    return _box;
+
+  const bool scaled = !math::equal(this->scale.X(), 0.0) &&
+      !math::equal(this->scale.Y(), 0.0) && !math::equal(this->scale.Z(), 0.0);
+  if (!this->triangleBvh || !scaled)
+  {
+    const math::AxisAlignedBox bounds = this->GetBoundingBox();
+    if (!bounds.Intersects(_box))
+      return math::AxisAlignedBox();
+    math::Vector3d min = bounds.Min();
+    math::Vector3d max = bounds.Max();
+    min.Max(_box.Min());
+    max.Min(_box.Max());
+    return math::AxisAlignedBox(min, max);
+  }
+
+  // The constructor sorts the corners, which handles negative scales
+  const math::AxisAlignedBox overlap = this->triangleBvh->Overlap(
+      math::AxisAlignedBox(_box.Min() / this->scale, _box.Max() / this->scale));
+  if (overlap == math::AxisAlignedBox())
+    return overlap;
+  return math::AxisAlignedBox(
+      overlap.Min() * this->scale, overlap.Max() * this->scale);
+}
+
+//////////////////////////////////////////////////
+bool MeshShape::RayIntersection(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    double &_distance, math::Vector3d &_normal) const
+{
+  const bool scaled = !math::equal(this->scale.X(), 0.0) &&
+      !math::equal(this->scale.Y(), 0.0) && !math::equal(this->scale.Z(), 0.0);
+  if (!this->triangleBvh || !scaled)
+  {
+    return Shape::RayIntersection(
+        _origin, _direction, _maxDistance, _distance, _normal);
+  }
+
+  // the triangles are in the frame of the unscaled mesh. Scaling the
+  // direction as well keeps distances along the ray, and normals transform
+  // with the inverse scale.
+  if (!this->triangleBvh->RayIntersection(_origin / this->scale,
+      _direction / this->scale, _maxDistance, _distance, _normal))
+  {
+    return false;
+  }
+  _normal = _normal / this->scale;
+  _normal.Normalize();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void MeshShape::SetMeshBoundingBox(const math::AxisAlignedBox &_box)
+{
+  this->meshAABB = _box;
   this->dirty = true;
 }
 
@@ -242,3 +547,345 @@ void MeshShape::UpdateBoundingBox()
   this->bbox = math::AxisAlignedBox(
       this->scale * this->meshAABB.Min(), this->scale * this->meshAABB.Max());
 }
+
+//////////////////////////////////////////////////
+HeightmapShape::HeightmapShape() : Shape()
+{
+  this->type = ShapeType::HEIGHTMAP;
+}
+
+//////////////////////////////////////////////////
+bool HeightmapShape::SetHeights(std::shared_ptr<const float> _heights,
+    std::size_t _width, std::size_t _depth)
+{
+  if (!_heights || _width < 2u || _depth < 2u)
+    return false;
+
+  const float *data = _heights.get();
+  const auto range = std::minmax_element(data, data + _width * _depth);
+  this->minHeight = *range.first;
+  this->maxHeight = *range.second;
+  this->heights = std::move(_heights);
+  this->width = _width;
+  this->depth = _depth;
+  this->dirty = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<const float> HeightmapShape::GetHeights() const
+{
+  return this->heights;
+}
+
+//////////////////////////////////////////////////
+std::size_t HeightmapShape::GetWidth() const
+{
+  return this->width;
+}
+
+//////////////////////////////////////////////////
+std::size_t HeightmapShape::GetDepth() const
+{
+  return this->depth;
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::SetSize(const math::Vector3d &_size)
+{
+  this->size = _size;
+  this->dirty = true;
+}
+
+//////////////////////////////////////////////////
+math::Vector3d HeightmapShape::GetSize() const
+{
+  return this->size;
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::Cell(double _x, double _y, std::size_t &_col,
+    std::size_t &_row, double &_u, double &_v) const
+{
+  const auto axis = [](double _p, double _extent, std::size_t _samples,
+      std::size_t &_index, double &_fraction)
+  {
+    const double cells = static_cast<double>(_samples - 1u);
+    double f = 0.0;
+    if (_extent > 0.0)
+      f = std::clamp((_p / _extent + 0.5) * cells, 0.0, cells);
+    _index = std::min(static_cast<std::size_t>(f), _samples - 2u);
+    _fraction = f - static_cast<double>(_index);
+  };
+  axis(_x, std::abs(this->size.X()), this->width, _col, _u);
+  axis(_y, std::abs(this->size.Y()), this->depth, _row, _v);
+}
+
+//////////////////////////////////////////////////
+double HeightmapShape::Sample(std::size_t _col, std::size_t _row) const
+{
+  return this->heights.get()[_row * this->width + _col] * this->size.Z();
+}
+
+//////////////////////////////////////////////////
+double HeightmapShape::GetHeight(double _x, double _y) const
+{
+  if (!this->heights)
+    return 0.0;
+
+  std::size_t col = 0u;
+  std::size_t row = 0u;
+  double u = 0.0;
+  double v = 0.0;
+  this->Cell(_x, _y, col, row, u, v);
+  const double h00 = this->Sample(col, row);
+  const double h11 = this->Sample(col + 1u, row + 1u);
+  if (u >= v)
+  {
+    const double h10 = this->Sample(col + 1u, row);
+    return h00 + u * (h10 - h00) + v * (h11 - h10);
+  }
+  const double h01 = this->Sample(col, row + 1u);
+  return h00 + v * (h01 - h00) + u * (h11 - h01);
+}
+
+//////////////////////////////////////////////////
+math::Vector3d HeightmapShape::GetNormal(double _x, double _y) const
+{
+  if (!this->heights)
+    return math::Vector3d::UnitZ;
+
+  std::size_t col = 0u;
+  std::size_t row = 0u;
+  double u = 0.0;
+  double v = 0.0;
+  this->Cell(_x, _y, col, row, u, v);
+  const double h00 = this->Sample(col, row);
+  const double h11 = this->Sample(col + 1u, row + 1u);
+  double dx = 0.0;
+  double dy = 0.0;
+  if (u >= v)
+  {
+    const double h10 = this->Sample(col + 1u, row);
+    dx = h10 - h00;
+    dy = h11 - h10;
+  }
+  else
+  {
+    const double h01 = this->Sample(col, row + 1u);
+    dx = h11 - h01;
+    dy = h01 - h00;
+  }
+
+  // the normal of the triangle is the cross product of its edges along x
+  // and y, scaled by the size of the cell
+  const double cellX = std::abs(this->size.X()) / (this->width - 1u);
+  const double cellY = std::abs(this->size.Y()) / (this->depth - 1u);
+  math::Vector3d normal(-dx * cellY, -dy * cellX, cellX * cellY);
+  if (normal == math::Vector3d::Zero)
+    return math::Vector3d::UnitZ;
+  normal.Normalize();
+  return normal;
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox HeightmapShape::GetHeightOverlap(
+    const math::AxisAlignedBox &_box) const
+{
+  if (!this->heights || _box == math::AxisAlignedBox())
+    return math::AxisAlignedBox();
+
+  const double halfX = 0.5 * std::abs(this->size.X());
+  const double halfY = 0.5 * std::abs(this->size.Y());
+  math::Vector3d min = _box.Min();
+  math::Vector3d max = _box.Max();
+  min.X(std::max(min.X(), -halfX));
+  min.Y(std::max(min.Y(), -halfY));
+  max.X(std::min(max.X(), halfX));
+  max.Y(std::min(max.Y(), halfY));
+  if (min.X() > max.X() || min.Y() > max.Y())
+    return math::AxisAlignedBox();
+
+  // the terrain is interpolated between the samples, so it is below the
+  // highest sample of the cells under the box
+  std::size_t col0 = 0u;
+  std::size_t row0 = 0u;
+  std::size_t col1 = 0u;
+  std::size_t row1 = 0u;
+  double u = 0.0;
+  double v = 0.0;
+  this->Cell(min.X(), min.Y(), col0, row0, u, v);
+  this->Cell(max.X(), max.Y(), col1, row1, u, v);
+  double top = -std::numeric_limits<double>::infinity();
+  for (std::size_t row = row0; row <= row1 + 1u; ++row)
+  {
+    for (std::size_t col = col0; col <= col1 + 1u; ++col)
+      top = std::max(top, this->Sample(col, row));
+  }
+
+  if (top < min.Z())
+    return math::AxisAlignedBox();
+  max.Z(std::min(max.Z(), top));
+  return math::AxisAlignedBox(min, max);
+}
+
+//////////////////////////////////////////////////
+bool HeightmapShape::RayIntersection(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    double &_distance, math::Vector3d &_normal) const
+{
+  if (!this->heights || this->bbox == math::AxisAlignedBox())
+    return false;
+
+  // clip the ray to the bounding box
+  double enter = 0.0;
+  double exit = _maxDistance;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (std::abs(_direction[i]) < 1e-12)
+    {
+      if (_origin[i] < this->bbox.Min()[i] || _origin[i] > this->bbox.Max()[i])
+        return false;
+      continue;
+    }
+    double t1 = (this->bbox.Min()[i] - _origin[i]) / _direction[i];
+    double t2 = (this->bbox.Max()[i] - _origin[i]) / _direction[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    enter = std::max(enter, t1);
+    exit = std::min(exit, t2);
+  }
+  if (enter > exit)
+    return false;
+
+  // walk the cells under the ray in order, see Amanatides and Woo, A Fast
+  // Voxel Traversal Algorithm for Ray Tracing. Triangles of a cell are
+  // within its column, so the first cell with a hit has the closest one.
+  const double cellX = std::abs(this->size.X()) / (this->width - 1u);
+  const double cellY = std::abs(this->size.Y()) / (this->depth - 1u);
+  const double minX = -0.5 * std::abs(this->size.X());
+  const double minY = -0.5 * std::abs(this->size.Y());
+  const math::Vector3d start = _origin + _direction * enter;
+  std::size_t col = 0u;
+  std::size_t row = 0u;
+  double u = 0.0;
+  double v = 0.0;
+  this->Cell(start.X(), start.Y(), col, row, u, v);
+
+  const auto crossing = [](double _p, double _d, double _cellMin,
+      double _cell, double &_next, double &_delta)
+  {
+    if (_d > 1e-12 && _cell > 0.0)
+    {
+      _next = (_cellMin + _cell - _p) / _d;
+      _delta = _cell / _d;
+    }
+    else if (_d < -1e-12 && _cell > 0.0)
+    {
+      _next = (_cellMin - _p) / _d;
+      _delta = -_cell / _d;
+    }
+    else
+    {
+      _next = std::numeric_limits<double>::infinity();
+      _delta = _next;
+    }
+  };
+  double nextX = 0.0;
+  double nextY = 0.0;
+  double deltaX = 0.0;
+  double deltaY = 0.0;
+  crossing(_origin.X(), _direction.X(), minX + col * cellX, cellX, nextX,
+      deltaX);
+  crossing(_origin.Y(), _direction.Y(), minY + row * cellY, cellY, nextY,
+      deltaY);
+
+  const auto vertex = [&](std::size_t _c, std::size_t _r)
+  {
+    return math::Vector3d(minX + _c * cellX, minY + _r * cellY,
+        this->Sample(_c, _r));
+  };
+  while (true)
+  {
+    const math::Vector3d v00 = vertex(col, row);
+    const math::Vector3d v10 = vertex(col + 1u, row);
+    const math::Vector3d v01 = vertex(col, row + 1u);
+    const math::Vector3d v11 = vertex(col + 1u, row + 1u);
+    bool hit = false;
+    double closest = exit;
+    for (const auto &[a, b, c] : {std::make_tuple(v00, v10, v11),
+        std::make_tuple(v00, v11, v01)})
+    {
+      // Moller-Trumbore, see Ericson, Real-Time Collision Detection,
+      // section 5.3.4. The triangles face up, and only rays going down
+      // through them hit, so rays from below the terrain do not.
+      const math::Vector3d e1 = b - a;
+      const math::Vector3d e2 = c - a;
+      const math::Vector3d normal = e1.Cross(e2);
+      if (normal.Dot(_direction) >= 0.0)
+        continue;
+      const math::Vector3d p = _direction.Cross(e2);
+      const double invDet = 1.0 / e1.Dot(p);
+      const math::Vector3d s = _origin - a;
+      const double bu = s.Dot(p) * invDet;
+      if (bu < 0.0 || bu > 1.0)
+        continue;
+      const math::Vector3d q = s.Cross(e1);
+      const double bv = _direction.Dot(q) * invDet;
+      if (bv < 0.0 || bu + bv > 1.0)
+        continue;
+      const double distance = e2.Dot(q) * invDet;
+      if (distance < 0.0 || distance > closest)
+        continue;
+
+      hit = true;
+      closest = distance;
+      _normal = normal;
+    }
+    if (hit)
+    {
+      _distance = closest;
+      _normal.Normalize();
+      return true;
+    }
+
+    // step into the next cell along the ray, until the ray leaves the grid
+    // or the maximum distance
+    if (nextX < nextY)
+    {
+      if (nextX > exit)
+        return false;
+      if (_direction.X() > 0.0 ? col + 2u >= this->width : col == 0u)
+        return false;
+      col = _direction.X() > 0.0 ? col + 1u : col - 1u;
+      nextX += deltaX;
+    }
+    else
+    {
+      if (nextY > exit)
+        return false;
+      if (_direction.Y() > 0.0 ? row + 2u >= this->depth : row == 0u)
+        return false;
+      row = _direction.Y() > 0.0 ? row + 1u : row - 1u;
+      nextY += deltaY;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::UpdateBoundingBox()
+{
+  if (!this->heights)
+  {
+    this->bbox = math::AxisAlignedBox();
+    return;
+  }
+
+  const double low = this->minHeight * this->size.Z();
+  const double high = this->maxHeight * this->size.Z();
+  const math::Vector3d half(0.5 * std::abs(this->size.X()),
+      0.5 * std::abs(this->size.Y()), 0.0);
+  this->bbox = math::AxisAlignedBox(
+      math::Vector3d(-half.X(), -half.Y(), std::min(low, high)),
+      math::Vector3d(half.X(), half.Y(), std::max(low, high)));
+}
@@ -18,8 +18,10 @@
 #ifndef GZ_PHYSICS_TPE_LIB_SRC_SHAPE_HH_
 #define GZ_PHYSICS_TPE_LIB_SRC_SHAPE_HH_
 
+#include <cstddef>
 #include <string>
 #include <map>
+#include <memory>
 
 #include <gz/common/Mesh.hh>
 #include <gz/math/Vector3.hh>
@@ -28,6 +30,8 @@
 
 #include "gz/physics/tpelib/Export.hh"
 
+#include "TriangleBvh.hh"
+
 namespace gz {
 namespace physics {
 namespace tpelib {
@@ -59,6 +63,9 @@ enum class GZ_PHYSICS_TPELIB_VISIBLE ShapeType
 
   /// \brief A ellipsoid shape.
   ELLIPSOID = 7,
+
+  /// \brief A heightmap shape.
+  HEIGHTMAP = 8,
 };
 
 
@@ -79,6 +86,22 @@ class GZ_PHYSICS_TPELIB_VISIBLE Shape
   /// \return Type of shape
   public: virtual ShapeType GetType() const;
 
+  /// \brief Intersect a ray with the shape. Rays that start inside a solid
+  /// shape do not hit it. The base implementation intersects the bounding
+  /// box. The bounding box must be up to date, see GetBoundingBox(). The
+  /// shape is only read, so rays can be cast concurrently.
+  /// \param[in] _origin Start of the ray in the frame of the shape
+  /// \param[in] _direction Unit direction of the ray in the frame of the
+  /// shape
+  /// \param[in] _maxDistance Only hits up to this distance are reported
+  /// \param[out] _distance Distance from _origin to the hit
+  /// \param[out] _normal Unit surface normal at the hit in the frame of the
+  /// shape
+  /// \return True if the ray hits the shape within _maxDistance
+  public: virtual bool RayIntersection(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      double &_distance, math::Vector3d &_normal) const;
+
   /// \brief Update the shape's bounding box
   protected: virtual void UpdateBoundingBox();
 
@@ -143,6 +166,11 @@ class GZ_PHYSICS_TPELIB_VISIBLE CapsuleShape : public Shape
   /// \param[in] _length Cylinder length
   public: void SetLength(double _length);
 
+  // Documentation inherited
+  public: bool RayIntersection(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      double &_distance, math::Vector3d &_normal) const override;
+
   // Documentation inherited
   protected: virtual void UpdateBoundingBox() override;
 
@@ -178,6 +206,11 @@ class GZ_PHYSICS_TPELIB_VISIBLE CylinderShape : public Shape
   /// \param[in] _length Cylinder length
   public: void SetLength(double _length);
 
+  // Documentation inherited
+  public: bool RayIntersection(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      double &_distance, math::Vector3d &_normal) const override;
+
   // Documentation inherited
   protected: virtual void UpdateBoundingBox() override;
 
@@ -205,6 +238,11 @@ class GZ_PHYSICS_TPELIB_VISIBLE EllipsoidShape : public Shape
   /// \param[in] _radius ellipsoid radius
   public: void SetRadii(const math::Vector3d &_radii);
 
+  // Documentation inherited
+  public: bool RayIntersection(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      double &_distance, math::Vector3d &_normal) const override;
+
   // Documentation inherited
   protected: virtual void UpdateBoundingBox() override;
 
@@ -214,6 +252,40 @@ class GZ_PHYSICS_TPELIB_VISIBLE EllipsoidShape : public Shape
   GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
 };
 
+/// \brief Infinite plane through the origin of its frame, which is solid
+/// below the plane. Its bounding box is empty, so it does not grow the
+/// boxes of the entities it belongs to. CollisionDetector keeps planes out
+/// of its broadphase and tests the other entities against them directly.
+class GZ_PHYSICS_TPELIB_VISIBLE PlaneShape : public Shape
+{
+  /// \brief Constructor
+  public: PlaneShape();
+
+  /// \brief Destructor
+  public: ~PlaneShape() = default;
+
+  /// \brief Get the normal of the plane
+  /// \return Unit normal, pointing out of the solid side
+  public: math::Vector3d GetNormal() const;
+
+  /// \brief Set the normal of the plane
+  /// \param[in] _normal Normal, which is normalized
+  public: void SetNormal(const math::Vector3d &_normal);
+
+  // Documentation inherited
+  public: bool RayIntersection(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      double &_distance, math::Vector3d &_normal) const override;
+
+  // Documentation inherited
+  protected: virtual void UpdateBoundingBox() override;
+
+  GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Unit normal of the plane
+  private: math::Vector3d normal = math::Vector3d::UnitZ;
+  GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+};
+
 /// \brief Sphere geometry
 class GZ_PHYSICS_TPELIB_VISIBLE SphereShape : public Shape
 {
@@ -231,6 +303,11 @@ class GZ_PHYSICS_TPELIB_VISIBLE SphereShape : public Shape
   /// \param[in] _radius Sphere radius
   public: void SetRadius(double _radius);
 
+  // Documentation inherited
+  public: bool RayIntersection(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      double &_distance, math::Vector3d &_normal) const override;
+
   // Documentation inherited
   protected: virtual void UpdateBoundingBox() override;
 
@@ -249,7 +326,33 @@ class GZ_PHYSICS_TPELIB_VISIBLE MeshShape : public Shape
 
   /// \brief Set mesh
   /// \param[in] _mesh Mesh object
-  public: void SetMesh(const common::Mesh &_mesh);
+  /// \param[in] _buildTriangleBvh True to also build a hierarchy over the
+  /// triangles of the mesh, so that contacts can be limited to the
+  /// triangles instead of the whole bounding box.
+  public: void SetMesh(const common::Mesh &_mesh,
+      bool _buildTriangleBvh = false);
+
+  /// \brief Set the triangle hierarchy of the unscaled mesh directly. The
+  /// hierarchy is shared with copies of this shape.
+  /// \param[in] _bvh Triangle hierarchy, or nullptr to remove it.
+  public: void SetTriangleBvh(std::shared_ptr<const TriangleBvh> _bvh);
+
+  /// \brief Get the triangle hierarchy of the unscaled mesh
+  /// \return Triangle hierarchy, or nullptr if the mesh has none
+  public: std::shared_ptr<const TriangleBvh> GetTriangleBvh() const;
+
+  /// \brief Find the part of a box that the mesh reaches into
+  /// \param[in] _box Box in the frame of the shape
+  /// \return Part of _box covered by the bounding boxes of the triangles that
+  /// intersect it, or by the bounding box of the shape if the mesh has no
+  /// triangle hierarchy. An empty box if the mesh does not reach into _box.
+  public: math::AxisAlignedBox GetTriangleOverlap(
+      const math::AxisAlignedBox &_box);
+
+  /// \brief Set the bounding box of the unscaled mesh directly, for meshes
+  /// that do not come from a common::Mesh.
+  /// \param[in] _box Bounding box of the mesh vertices
+  public: void SetMeshBoundingBox(const math::AxisAlignedBox &_box);
 
   /// \brief Get mesh scale
   /// \return Mesh scale
@@ -259,6 +362,11 @@ class GZ_PHYSICS_TPELIB_VISIBLE MeshShape : public Shape
   /// \param[in] _scale Mesh scale
   public: void SetScale(math::Vector3d _scale);
 
+  // Documentation inherited
+  public: bool RayIntersection(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      double &_distance, math::Vector3d &_normal) const override;
+
   // Documentation inherited
   protected: virtual void UpdateBoundingBox() override;
 
@@ -269,6 +377,126 @@ class GZ_PHYSICS_TPELIB_VISIBLE MeshShape : public Shape
 
   /// \brief Mesh object
   private: math::AxisAlignedBox meshAABB;
+
+  GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Triangle hierarchy of the unscaled mesh
+  private: std::shared_ptr<const TriangleBvh> triangleBvh;
+  GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+};
+
+/// \brief Heightmap geometry: a regular grid of heights over the x-y plane
+/// of the shape, centered on its origin. Between the samples the terrain is
+/// made of two triangles per cell, split along the diagonal from the minimum
+/// to the maximum corner of the cell, so the height and normal at a point
+/// are looked up from a single cell.
+class GZ_PHYSICS_TPELIB_VISIBLE HeightmapShape : public Shape
+{
+  /// \brief Constructor
+  public: HeightmapShape();
+
+  /// \brief Destructor
+  public: virtual ~HeightmapShape() = default;
+
+  /// \brief Set the grid of heights. The grid is shared with copies of this
+  /// shape and is never written, so it can e.g. point into a memory mapped
+  /// file that the deleter of _heights unmaps.
+  /// \param[in] _heights Heights of the samples, row by row. Rows go along
+  /// +y and the samples of a row along +x.
+  /// \param[in] _width Number of samples of each row, at least 2
+  /// \param[in] _depth Number of rows, at least 2
+  /// \return False if the grid has less than 2 samples along an axis, in
+  /// which case the shape is not changed
+  public: bool SetHeights(std::shared_ptr<const float> _heights,
+      std::size_t _width, std::size_t _depth);
+
+  /// \brief Get the grid of heights
+  /// \return Heights of the samples, or nullptr if none were set
+  public: std::shared_ptr<const float> GetHeights() const;
+
+  /// \brief Get the number of samples of each row
+  /// \return Number of samples along x
+  public: std::size_t GetWidth() const;
+
+  /// \brief Get the number of rows
+  /// \return Number of samples along y
+  public: std::size_t GetDepth() const;
+
+  /// \brief Set the size of the heightmap
+  /// \param[in] _size Extent of the grid along x and y, and factor that the
+  /// heights are multiplied by along z
+  public: void SetSize(const math::Vector3d &_size);
+
+  /// \brief Get the size of the heightmap
+  /// \return Extent along x and y, and factor of the heights
+  public: math::Vector3d GetSize() const;
+
+  /// \brief Get the height of the terrain at a point. Points outside of the
+  /// grid get the height of its closest edge.
+  /// \param[in] _x X coordinate in the frame of the shape
+  /// \param[in] _y Y coordinate in the frame of the shape
+  /// \return Height in the frame of the shape, 0 if no heights were set
+  public: double GetHeight(double _x, double _y) const;
+
+  /// \brief Get the normal of the terrain at a point, see GetHeight()
+  /// \param[in] _x X coordinate in the frame of the shape
+  /// \param[in] _y Y coordinate in the frame of the shape
+  /// \return Unit normal in the frame of the shape, pointing up
+  public: math::Vector3d GetNormal(double _x, double _y) const;
+
+  /// \brief Find the part of a box that is below the terrain. The box is
+  /// limited to the grid along x and y, and its top to the highest sample
+  /// under it, so a box resting on the terrain overlaps it at its bottom.
+  /// \param[in] _box Box in the frame of the shape
+  /// \return Part of _box below the highest sample under it, or an empty
+  /// box if _box is above the terrain or outside of the grid
+  public: math::AxisAlignedBox GetHeightOverlap(
+      const math::AxisAlignedBox &_box) const;
+
+  // Documentation inherited
+  public: bool RayIntersection(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      double &_distance, math::Vector3d &_normal) const override;
+
+  // Documentation inherited
+  protected: virtual void UpdateBoundingBox() override;
+
+  /// \brief Find the cell of the grid below a point
+  /// \param[in] _x X coordinate in the frame of the shape
+  /// \param[in] _y Y coordinate in the frame of the shape
+  /// \param[out] _col Column of the minimum corner of the cell
+  /// \param[out] _row Row of the minimum corner of the cell
+  /// \param[out] _u Position of the point within the cell along x, in
+  /// [0, 1]
+  /// \param[out] _v Position of the point within the cell along y, in
+  /// [0, 1]
+  private: void Cell(double _x, double _y, std::size_t &_col,
+      std::size_t &_row, double &_u, double &_v) const;
+
+  /// \brief Get the scaled height of a sample
+  /// \param[in] _col Column of the sample
+  /// \param[in] _row Row of the sample
+  /// \return Height in the frame of the shape
+  private: double Sample(std::size_t _col, std::size_t _row) const;
+
+  GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Heights of the samples, shared with copies of this shape
+  private: std::shared_ptr<const float> heights;
+
+  /// \brief Extent along x and y, and factor of the heights
+  private: math::Vector3d size{1.0, 1.0, 1.0};
+  GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+  /// \brief Number of samples of each row
+  private: std::size_t width = 0u;
+
+  /// \brief Number of rows
+  private: std::size_t depth = 0u;
+
+  /// \brief Lowest of the unscaled heights
+  private: float minHeight = 0.0f;
+
+  /// \brief Highest of the unscaled heights
+  private: float maxHeight = 0.0f;
 };
 
 }
@@ -17,6 +17,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <memory>
+#include <vector>
+
 #include <gz/common/Mesh.hh>
 #include <gz/common/SubMesh.hh>
 
@@ -127,6 +131,32 @@ TEST(Shape, SphereShape)
   EXPECT_EQ(math::Vector3d(30.2, 30.2, 30.2), bbox.Max());
 }
 
+/////////////////////////////////////////////////
+TEST(Shape, PlaneShape)
+{
+  PlaneShape shape;
+  EXPECT_EQ(ShapeType::PLANE, shape.GetType());
+  EXPECT_EQ(math::Vector3d::UnitZ, shape.GetNormal());
+
+  // the plane is infinite, so it has no bounding box
+  EXPECT_EQ(math::AxisAlignedBox(), shape.GetBoundingBox());
+
+  shape.SetNormal(math::Vector3d(0, 0, 2));
+  EXPECT_EQ(math::Vector3d::UnitZ, shape.GetNormal());
+
+  // rays hit it from above, and not from below
+  double distance = 0.0;
+  math::Vector3d normal;
+  EXPECT_TRUE(shape.RayIntersection(math::Vector3d(1, 2, 3),
+      -math::Vector3d::UnitZ, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(3.0, distance);
+  EXPECT_EQ(math::Vector3d::UnitZ, normal);
+  EXPECT_FALSE(shape.RayIntersection(math::Vector3d(1, 2, 3),
+      -math::Vector3d::UnitZ, 2.0, distance, normal));
+  EXPECT_FALSE(shape.RayIntersection(math::Vector3d(1, 2, -3),
+      math::Vector3d::UnitZ, 10.0, distance, normal));
+}
+
 /////////////////////////////////////////////////
 TEST(Shape, MeshShape)
 {
@@ -154,3 +184,232 @@ TEST(Shape, MeshShape)
   EXPECT_EQ(v0, bbox.Min());
   EXPECT_EQ(v2, bbox.Max());
 }
+
+/////////////////////////////////////////////////
+TEST(Shape, MeshShapeBoundingBox)
+{
+  MeshShape shape;
+  shape.SetMeshBoundingBox(math::AxisAlignedBox(
+      math::Vector3d(-1, -2, -3), math::Vector3d(1, 2, 3)));
+  shape.SetScale(math::Vector3d(2.0, 1.0, 0.5));
+  math::AxisAlignedBox bbox = shape.GetBoundingBox();
+  EXPECT_EQ(math::Vector3d(-2, -2, -1.5), bbox.Min());
+  EXPECT_EQ(math::Vector3d(2, 2, 1.5), bbox.Max());
+}
+
+/////////////////////////////////////////////////
+TEST(Shape, MeshShapeTriangleOverlap)
+{
+  // a single triangle on the plane x = 0
+  common::Mesh mesh;
+  common::SubMesh submesh;
+  submesh.AddVertex(math::Vector3d(0, 0, 0));
+  submesh.AddVertex(math::Vector3d(0, 1, 0));
+  submesh.AddVertex(math::Vector3d(0, 1, 1));
+  mesh.AddSubMesh(submesh);
+
+  MeshShape shape;
+  shape.SetMesh(mesh);
+  shape.SetScale(math::Vector3d(1.0, 2.0, 2.0));
+  EXPECT_EQ(nullptr, shape.GetTriangleBvh());
+
+  // without a triangle hierarchy the overlap is clipped to the bounding box.
+  // The box below overlaps the bounding box but not the triangle.
+  const math::AxisAlignedBox box(
+      math::Vector3d(-0.5, 0.1, 1.5), math::Vector3d(0.5, 0.5, 1.9));
+  math::AxisAlignedBox overlap = shape.GetTriangleOverlap(box);
+  EXPECT_EQ(math::Vector3d(0, 0.1, 1.5), overlap.Min());
+  EXPECT_EQ(math::Vector3d(0, 0.5, 1.9), overlap.Max());
+
+  shape.SetMesh(mesh, true);
+  ASSERT_NE(nullptr, shape.GetTriangleBvh());
+  EXPECT_EQ(1u, shape.GetTriangleBvh()->TriangleCount());
+  EXPECT_EQ(math::AxisAlignedBox(), shape.GetTriangleOverlap(box));
+
+  // the hierarchy is in the frame of the unscaled mesh
+  overlap = shape.GetTriangleOverlap(math::AxisAlignedBox(
+      math::Vector3d(-0.5, 1.5, 0.5), math::Vector3d(0.5, 1.9, 1.5)));
+  EXPECT_EQ(math::Vector3d(0, 1.5, 0.5), overlap.Min());
+  EXPECT_EQ(math::Vector3d(0, 1.9, 1.5), overlap.Max());
+
+  // copies share the hierarchy
+  MeshShape copy(shape);
+  EXPECT_EQ(shape.GetTriangleBvh(), copy.GetTriangleBvh());
+}
+
+/////////////////////////////////////////////////
+TEST(Shape, HeightmapShape)
+{
+  HeightmapShape shape;
+  EXPECT_EQ(ShapeType::HEIGHTMAP, shape.GetType());
+  EXPECT_EQ(math::AxisAlignedBox(), shape.GetBoundingBox());
+
+  // grids need at least 2 samples along each axis
+  auto heights = std::make_shared<std::vector<float>>(
+      std::vector<float>{0, 1, 2, 0, 1, 2, 0, 1, 2});
+  std::shared_ptr<const float> grid(heights, heights->data());
+  EXPECT_FALSE(shape.SetHeights(grid, 1u, 9u));
+  EXPECT_EQ(nullptr, shape.GetHeights());
+
+  // a ramp on the plane z = (x + 2) / 2
+  EXPECT_TRUE(shape.SetHeights(grid, 3u, 3u));
+  shape.SetSize(math::Vector3d(4, 4, 1));
+  EXPECT_EQ(math::Vector3d(4, 4, 1), shape.GetSize());
+  EXPECT_EQ(3u, shape.GetWidth());
+  EXPECT_EQ(3u, shape.GetDepth());
+
+  math::AxisAlignedBox bbox = shape.GetBoundingBox();
+  EXPECT_EQ(math::Vector3d(-2, -2, 0), bbox.Min());
+  EXPECT_EQ(math::Vector3d(2, 2, 2), bbox.Max());
+
+  EXPECT_DOUBLE_EQ(1.0, shape.GetHeight(0, 0));
+  EXPECT_DOUBLE_EQ(1.5, shape.GetHeight(1, -1.5));
+  EXPECT_DOUBLE_EQ(0.25, shape.GetHeight(-1.5, 0.7));
+  // points outside of the grid get the height of its closest edge
+  EXPECT_DOUBLE_EQ(2.0, shape.GetHeight(10, 0));
+  EXPECT_DOUBLE_EQ(0.0, shape.GetHeight(-10, -10));
+
+  for (const auto &p : {math::Vector3d(0.3, 0.7, 0),
+      math::Vector3d(-1.2, -0.5, 0), math::Vector3d(1.9, 1.9, 0)})
+  {
+    const math::Vector3d normal = shape.GetNormal(p.X(), p.Y());
+    EXPECT_NEAR(-0.5 / std::sqrt(1.25), normal.X(), 1e-9);
+    EXPECT_NEAR(0.0, normal.Y(), 1e-9);
+    EXPECT_NEAR(1.0 / std::sqrt(1.25), normal.Z(), 1e-9);
+  }
+
+  // boxes are limited to the highest sample under them
+  math::AxisAlignedBox overlap = shape.GetHeightOverlap(math::AxisAlignedBox(
+      math::Vector3d(-1.5, -0.2, 0.5), math::Vector3d(-1.2, 0.2, 1.5)));
+  EXPECT_EQ(math::Vector3d(-1.5, -0.2, 0.5), overlap.Min());
+  EXPECT_EQ(math::Vector3d(-1.2, 0.2, 1.0), overlap.Max());
+  overlap = shape.GetHeightOverlap(math::AxisAlignedBox(
+      math::Vector3d(1.5, 1.5, -1), math::Vector3d(3, 3, 1)));
+  EXPECT_EQ(math::Vector3d(1.5, 1.5, -1), overlap.Min());
+  EXPECT_EQ(math::Vector3d(2, 2, 1), overlap.Max());
+  EXPECT_EQ(math::AxisAlignedBox(), shape.GetHeightOverlap(
+      math::AxisAlignedBox(
+          math::Vector3d(-1.5, -0.2, 1.2), math::Vector3d(-1.2, 0.2, 1.5))));
+  EXPECT_EQ(math::AxisAlignedBox(), shape.GetHeightOverlap(
+      math::AxisAlignedBox(
+          math::Vector3d(3, 3, -1), math::Vector3d(4, 4, 1))));
+
+  // rays down, along the ramp and from below it
+  double distance = 0.0;
+  math::Vector3d normal;
+  EXPECT_TRUE(shape.RayIntersection(math::Vector3d(1, 0, 5),
+      math::Vector3d(0, 0, -1), 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(3.5, distance);
+  EXPECT_NEAR(-0.5 / std::sqrt(1.25), normal.X(), 1e-9);
+  EXPECT_NEAR(1.0 / std::sqrt(1.25), normal.Z(), 1e-9);
+  EXPECT_FALSE(shape.RayIntersection(math::Vector3d(1, 0, 5),
+      math::Vector3d(0, 0, -1), 3.0, distance, normal));
+  EXPECT_TRUE(shape.RayIntersection(math::Vector3d(-3, 0.5, 0.25),
+      math::Vector3d::UnitX, 10.0, distance, normal));
+  EXPECT_NEAR(1.5, distance, 1e-9);
+  EXPECT_TRUE(shape.RayIntersection(math::Vector3d(2, -1.5, 3),
+      math::Vector3d(-0.6, 0, -0.8), 10.0, distance, normal));
+  EXPECT_NEAR(2.0, distance, 1e-9);
+  EXPECT_FALSE(shape.RayIntersection(math::Vector3d(-3, 0.5, 2.5),
+      math::Vector3d::UnitX, 10.0, distance, normal));
+  EXPECT_FALSE(shape.RayIntersection(math::Vector3d(1, 0, -1),
+      math::Vector3d::UnitZ, 10.0, distance, normal));
+
+  // copies share the grid
+  HeightmapShape copy(shape);
+  EXPECT_EQ(shape.GetHeights(), copy.GetHeights());
+  EXPECT_DOUBLE_EQ(1.0, copy.GetHeight(0, 0));
+}
+
+/////////////////////////////////////////////////
+TEST(Shape, RayIntersection)
+{
+  double distance = 0.0;
+  math::Vector3d normal;
+  const math::Vector3d down(0, 0, -1);
+
+  BoxShape box;
+  box.SetSize(math::Vector3d(2, 2, 2));
+  box.GetBoundingBox();
+  EXPECT_TRUE(box.RayIntersection(
+      math::Vector3d(0.5, 0, 5), down, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(4.0, distance);
+  EXPECT_EQ(math::Vector3d::UnitZ, normal);
+  // too short, starting inside and missing
+  EXPECT_FALSE(box.RayIntersection(
+      math::Vector3d(0.5, 0, 5), down, 3.0, distance, normal));
+  EXPECT_FALSE(box.RayIntersection(
+      math::Vector3d::Zero, down, 10.0, distance, normal));
+  EXPECT_FALSE(box.RayIntersection(
+      math::Vector3d(2, 0, 5), down, 10.0, distance, normal));
+
+  SphereShape sphere;
+  sphere.SetRadius(1.0);
+  EXPECT_TRUE(sphere.RayIntersection(
+      math::Vector3d(0, 0, 5), down, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(4.0, distance);
+  EXPECT_EQ(math::Vector3d::UnitZ, normal);
+  // passes the corner of the bounding box but misses the sphere
+  EXPECT_FALSE(sphere.RayIntersection(
+      math::Vector3d(0.9, 0.9, 5), down, 10.0, distance, normal));
+
+  CylinderShape cylinder;
+  cylinder.SetRadius(1.0);
+  cylinder.SetLength(2.0);
+  EXPECT_TRUE(cylinder.RayIntersection(
+      math::Vector3d(0.5, 0, 5), down, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(4.0, distance);
+  EXPECT_EQ(math::Vector3d::UnitZ, normal);
+  EXPECT_TRUE(cylinder.RayIntersection(math::Vector3d(-5, 0, 0.5),
+      math::Vector3d::UnitX, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(4.0, distance);
+  EXPECT_EQ(-math::Vector3d::UnitX, normal);
+  EXPECT_FALSE(cylinder.RayIntersection(
+      math::Vector3d(0.9, 0.9, 5), down, 10.0, distance, normal));
+
+  CapsuleShape capsule;
+  capsule.SetRadius(1.0);
+  capsule.SetLength(2.0);
+  EXPECT_TRUE(capsule.RayIntersection(
+      math::Vector3d(0, 0, 5), down, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(3.0, distance);
+  EXPECT_EQ(math::Vector3d::UnitZ, normal);
+  EXPECT_TRUE(capsule.RayIntersection(math::Vector3d(-5, 0, 0.5),
+      math::Vector3d::UnitX, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(4.0, distance);
+  EXPECT_FALSE(capsule.RayIntersection(
+      math::Vector3d(0, 0, 1.5), down, 10.0, distance, normal));
+
+  EllipsoidShape ellipsoid;
+  ellipsoid.SetRadii(math::Vector3d(1, 2, 3));
+  EXPECT_TRUE(ellipsoid.RayIntersection(
+      math::Vector3d(0, 0, 5), down, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(2.0, distance);
+  EXPECT_EQ(math::Vector3d::UnitZ, normal);
+  EXPECT_TRUE(ellipsoid.RayIntersection(math::Vector3d(0, -5, 0),
+      math::Vector3d::UnitY, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(3.0, distance);
+  EXPECT_EQ(-math::Vector3d::UnitY, normal);
+
+  // a mesh without a triangle hierarchy is hit on its bounding box
+  MeshShape mesh;
+  mesh.SetMeshBoundingBox(math::AxisAlignedBox(
+      -math::Vector3d::One, math::Vector3d::One));
+  mesh.SetScale(math::Vector3d(1, 1, 2));
+  mesh.GetBoundingBox();
+  EXPECT_TRUE(mesh.RayIntersection(
+      math::Vector3d(0, 0, 5), down, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(3.0, distance);
+
+  // a scaled ramp on the plane z = x
+  mesh.SetTriangleBvh(std::make_shared<TriangleBvh>(
+      std::vector<math::Vector3d>{
+        math::Vector3d(0, 0, 0), math::Vector3d(1, 0, 1),
+        math::Vector3d(1, 1, 1), math::Vector3d(0, 0, 0),
+        math::Vector3d(1, 1, 1), math::Vector3d(0, 1, 0)}));
+  EXPECT_TRUE(mesh.RayIntersection(
+      math::Vector3d(0.5, 0.5, 5), down, 10.0, distance, normal));
+  EXPECT_DOUBLE_EQ(4.0, distance);
+  EXPECT_NEAR(0.0, (normal - math::Vector3d(-2, 0, 1).Normalize()).Length(),
+      1e-9);
+}
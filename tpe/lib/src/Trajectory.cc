@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+
+#include "Trajectory.hh"
+
+using namespace gz;
+using namespace physics;
+using namespace tpelib;
+
+//////////////////////////////////////////////////
+bool Trajectory::SetWaypoints(const std::vector<Waypoint> &_waypoints,
+    Interpolation _interpolation)
+{
+  if (_waypoints.empty())
+    return false;
+  for (std::size_t i = 1; i < _waypoints.size(); ++i)
+  {
+    if (!(_waypoints[i].time > _waypoints[i - 1u].time))
+      return false;
+  }
+
+  this->waypoints = _waypoints;
+  this->interpolation = _interpolation;
+  this->tangents.clear();
+  if (_interpolation != Interpolation::CUBIC || _waypoints.size() < 2u)
+    return true;
+
+  // Catmull-Rom tangents for uneven time steps, one sided at the ends
+  const std::size_t n = _waypoints.size();
+  this->tangents.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const Waypoint &prev = _waypoints[i > 0u ? i - 1u : i];
+    const Waypoint &next = _waypoints[i + 1u < n ? i + 1u : i];
+    this->tangents[i] = (next.pose.Pos() - prev.pose.Pos()) /
+        (next.time - prev.time);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+const std::vector<Trajectory::Waypoint> &Trajectory::GetWaypoints() const
+{
+  return this->waypoints;
+}
+
+//////////////////////////////////////////////////
+Trajectory::Interpolation Trajectory::GetInterpolation() const
+{
+  return this->interpolation;
+}
+
+//////////////////////////////////////////////////
+double Trajectory::GetStartTime() const
+{
+  return this->waypoints.empty() ? 0.0 : this->waypoints.front().time;
+}
+
+//////////////////////////////////////////////////
+double Trajectory::GetEndTime() const
+{
+  return this->waypoints.empty() ? 0.0 : this->waypoints.back().time;
+}
+
+//////////////////////////////////////////////////
+math::Pose3d Trajectory::Pose(double _time) const
+{
+  if (this->waypoints.empty())
+    return math::Pose3d::Zero;
+  if (_time <= this->waypoints.front().time)
+    return this->waypoints.front().pose;
+  if (_time >= this->waypoints.back().time)
+    return this->waypoints.back().pose;
+
+  // first waypoint after _time, and the segment ending at it
+  const auto it = std::upper_bound(this->waypoints.begin(),
+      this->waypoints.end(), _time,
+      [](double _t, const Waypoint &_waypoint)
+      {
+        return _t < _waypoint.time;
+      });
+  const std::size_t i = static_cast<std::size_t>(
+      it - this->waypoints.begin()) - 1u;
+  const Waypoint &a = this->waypoints[i];
+  const Waypoint &b = this->waypoints[i + 1u];
+  const double h = b.time - a.time;
+  const double s = (_time - a.time) / h;
+
+  math::Vector3d pos;
+  if (this->tangents.empty())
+  {
+    pos = a.pose.Pos() + (b.pose.Pos() - a.pose.Pos()) * s;
+  }
+  else
+  {
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+    pos = a.pose.Pos() * (2.0 * s3 - 3.0 * s2 + 1.0) +
+        this->tangents[i] * (h * (s3 - 2.0 * s2 + s)) +
+        b.pose.Pos() * (3.0 * s2 - 2.0 * s3) +
+        this->tangents[i + 1u] * (h * (s3 - s2));
+  }
+
+  return math::Pose3d(pos,
+      math::Quaterniond::Slerp(s, a.pose.Rot(), b.pose.Rot(), true));
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_TPE_LIB_SRC_TRAJECTORY_HH_
+#define GZ_PHYSICS_TPE_LIB_SRC_TRAJECTORY_HH_
+
+#include <vector>
+
+#include <gz/math/Pose3.hh>
+#include <gz/math/Vector3.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+#include "gz/physics/tpelib/Export.hh"
+
+namespace gz {
+namespace physics {
+namespace tpelib {
+
+/// \brief Timed path of poses for a model to follow, see
+/// Model::SetTrajectory. Positions are interpolated linearly or with a
+/// cubic Hermite spline through the waypoints, and orientations with
+/// spherical linear interpolation.
+class GZ_PHYSICS_TPELIB_VISIBLE Trajectory
+{
+  /// \brief How positions are interpolated between waypoints
+  public: enum class Interpolation
+  {
+    /// \brief Straight segments between waypoints
+    LINEAR,
+
+    /// \brief Catmull-Rom spline through the waypoints, whose velocity is
+    /// continuous at the waypoints
+    CUBIC
+  };
+
+  /// \brief A pose to reach at a time
+  public: struct Waypoint
+  {
+    /// \brief Time of the waypoint, in world time
+    double time = 0.0;
+
+    /// \brief Pose of the model at the time, relative to its parent
+    math::Pose3d pose;
+  };
+
+  /// \brief Set the waypoints of the trajectory
+  /// \param[in] _waypoints Waypoints, at least one, in strictly increasing
+  /// order of time
+  /// \param[in] _interpolation How positions are interpolated
+  /// \return False if the waypoints are empty or out of order, in which case
+  /// the trajectory is not changed
+  public: bool SetWaypoints(const std::vector<Waypoint> &_waypoints,
+      Interpolation _interpolation = Interpolation::LINEAR);
+
+  /// \brief Get the waypoints of the trajectory
+  /// \return Waypoints
+  public: const std::vector<Waypoint> &GetWaypoints() const;
+
+  /// \brief Get how positions are interpolated
+  /// \return Interpolation
+  public: Interpolation GetInterpolation() const;
+
+  /// \brief Get the time of the first waypoint
+  /// \return Start time, 0 if there are no waypoints
+  public: double GetStartTime() const;
+
+  /// \brief Get the time of the last waypoint
+  /// \return End time, 0 if there are no waypoints
+  public: double GetEndTime() const;
+
+  /// \brief Evaluate the trajectory
+  /// \param[in] _time World time. Times before the first or after the last
+  /// waypoint give the pose of that waypoint.
+  /// \return Pose at the time
+  public: math::Pose3d Pose(double _time) const;
+
+  GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Waypoints in order of time
+  private: std::vector<Waypoint> waypoints;
+
+  /// \brief Velocity of the spline at each waypoint, for CUBIC
+  private: std::vector<math::Vector3d> tangents;
+  GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+  /// \brief How positions are interpolated
+  private: Interpolation interpolation = Interpolation::LINEAR;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include <gz/common/SubMesh.hh>
+#include <gz/math/Helpers.hh>
+
+#include "TriangleBvh.hh"
+#include "Utils.hh"
+
+using namespace gz;
+using namespace physics;
+using namespace tpelib;
+
+/// \brief Maximum number of triangles in a leaf
+static constexpr uint32_t kMaxLeafTriangles = 4u;
+
+//////////////////////////////////////////////////
+/// \brief Check whether two ranges [_min1, _max1] and [_min2, _max2] overlap
+/// in every axis
+static bool boundsOverlap(const math::Vector3d &_min1,
+    const math::Vector3d &_max1, const math::Vector3d &_min2,
+    const math::Vector3d &_max2)
+{
+  return _min1.X() <= _max2.X() && _max1.X() >= _min2.X() &&
+         _min1.Y() <= _max2.Y() && _max1.Y() >= _min2.Y() &&
+         _min1.Z() <= _max2.Z() && _max1.Z() >= _min2.Z();
+}
+
+//////////////////////////////////////////////////
+/// \brief Separating axis test between a triangle and a box, for the axes
+/// that are not box faces. The box faces are covered by the bounds check of
+/// the triangle.
+/// \param[in] _v0 First corner of the triangle, relative to the box center
+/// \param[in] _v1 Second corner of the triangle, relative to the box center
+/// \param[in] _v2 Third corner of the triangle, relative to the box center
+/// \param[in] _half Half size of the box
+/// \return True if no separating axis was found
+static bool triangleIntersectsBox(const math::Vector3d &_v0,
+    const math::Vector3d &_v1, const math::Vector3d &_v2,
+    const math::Vector3d &_half)
+{
+  auto separated = [&](const math::Vector3d &_axis)
+  {
+    const double p0 = _axis.Dot(_v0);
+    const double p1 = _axis.Dot(_v1);
+    const double p2 = _axis.Dot(_v2);
+    const double r = _half.X() * std::abs(_axis.X()) +
+        _half.Y() * std::abs(_axis.Y()) + _half.Z() * std::abs(_axis.Z());
+    return std::min({p0, p1, p2}) > r || std::max({p0, p1, p2}) < -r;
+  };
+
+  const math::Vector3d edges[3] = {_v1 - _v0, _v2 - _v1, _v0 - _v2};
+
+  // triangle normal
+  if (separated(edges[0].Cross(edges[1])))
+    return false;
+
+  // cross products of the triangle edges with the box axes
+  for (const auto &edge : edges)
+  {
+    if (separated(math::Vector3d::UnitX.Cross(edge)) ||
+        separated(math::Vector3d::UnitY.Cross(edge)) ||
+        separated(math::Vector3d::UnitZ.Cross(edge)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether a ray crosses the bounds [_min, _max] within a
+/// maximum distance
+static bool rayCrossesBounds(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, const math::Vector3d &_min,
+    const math::Vector3d &_max, double _maxDistance)
+{
+  double tEnter = 0.0;
+  double tExit = _maxDistance;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (std::fpclassify(_direction[i]) == FP_ZERO)
+    {
+      if (_origin[i] < _min[i] || _origin[i] > _max[i])
+        return false;
+      continue;
+    }
+
+    double t1 = (_min[i] - _origin[i]) / _direction[i];
+    double t2 = (_max[i] - _origin[i]) / _direction[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    tEnter = std::max(tEnter, t1);
+    tExit = std::min(tExit, t2);
+    if (tEnter > tExit)
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+TriangleBvh::TriangleBvh(const std::vector<math::Vector3d> &_triangles)
+  : vertices(_triangles.begin(), _triangles.begin() +
+      static_cast<std::ptrdiff_t>((_triangles.size() / 3u) * 3u))
+{
+  const auto triangleCount = static_cast<uint32_t>(this->vertices.size() / 3u);
+  if (triangleCount == 0u)
+    return;
+
+  std::vector<math::Vector3d> centroids(triangleCount);
+  this->triangleOrder.resize(triangleCount);
+  for (uint32_t i = 0; i < triangleCount; ++i)
+  {
+    centroids[i] = (this->vertices[3*i] + this->vertices[3*i + 1] +
+        this->vertices[3*i + 2]) / 3.0;
+    this->triangleOrder[i] = i;
+  }
+
+  // a binary tree with at least one triangle per leaf has fewer than twice
+  // as many nodes as triangles
+  this->nodes.reserve(2u * triangleCount);
+  this->Build(0u, triangleCount, centroids);
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<TriangleBvh> TriangleBvh::FromMesh(const common::Mesh &_mesh)
+{
+  std::vector<math::Vector3d> triangles;
+  for (unsigned int i = 0; i < _mesh.SubMeshCount(); ++i)
+  {
+    const auto subMesh = _mesh.SubMeshByIndex(i).lock();
+    if (!subMesh ||
+        subMesh->SubMeshPrimitiveType() != common::SubMesh::TRIANGLES)
+    {
+      continue;
+    }
+
+    if (subMesh->IndexCount() == 0u)
+    {
+      for (unsigned int v = 0; v < subMesh->VertexCount(); ++v)
+        triangles.push_back(subMesh->Vertex(v));
+      triangles.resize((triangles.size() / 3u) * 3u);
+      continue;
+    }
+
+    for (unsigned int j = 0; j + 2u < subMesh->IndexCount(); j += 3u)
+    {
+      for (unsigned int k = 0; k < 3u; ++k)
+      {
+        triangles.push_back(subMesh->Vertex(
+            static_cast<unsigned int>(subMesh->Index(j + k))));
+      }
+    }
+  }
+
+  if (triangles.empty())
+    return nullptr;
+  return std::make_shared<TriangleBvh>(triangles);
+}
+
+//////////////////////////////////////////////////
+std::size_t TriangleBvh::TriangleCount() const
+{
+  return this->triangleOrder.size();
+}
+
+//////////////////////////////////////////////////
+std::size_t TriangleBvh::GetMemoryBytes() const
+{
+  return sizeof(TriangleBvh) + vectorBytes(this->vertices) +
+      vectorBytes(this->triangleOrder) + vectorBytes(this->nodes);
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox TriangleBvh::Bounds() const
+{
+  if (this->nodes.empty())
+    return math::AxisAlignedBox();
+  return math::AxisAlignedBox(this->nodes[0].min, this->nodes[0].max);
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox TriangleBvh::Overlap(
+    const math::AxisAlignedBox &_box) const
+{
+  math::AxisAlignedBox result;
+  if (this->nodes.empty() || _box == math::AxisAlignedBox())
+    return result;
+
+  const math::Vector3d &boxMin = _box.Min();
+  const math::Vector3d &boxMax = _box.Max();
+  const math::Vector3d center = 0.5 * (boxMin + boxMax);
+  const math::Vector3d half = 0.5 * (boxMax - boxMin);
+
+  uint32_t stack[64];
+  std::size_t stackSize = 0u;
+  stack[stackSize++] = 0u;
+  while (stackSize > 0u)
+  {
+    const Node &node = this->nodes[stack[--stackSize]];
+    if (!boundsOverlap(node.min, node.max, boxMin, boxMax))
+      continue;
+
+    if (node.count == 0u)
+    {
+      stack[stackSize++] = node.index;
+      stack[stackSize++] =
+          static_cast<uint32_t>(&node - this->nodes.data()) + 1u;
+      continue;
+    }
+
+    for (uint32_t i = node.index; i < node.index + node.count; ++i)
+    {
+      const uint32_t t = this->triangleOrder[i];
+      const math::Vector3d &v0 = this->vertices[3*t];
+      const math::Vector3d &v1 = this->vertices[3*t + 1];
+      const math::Vector3d &v2 = this->vertices[3*t + 2];
+
+      math::Vector3d triMin = v0;
+      math::Vector3d triMax = v0;
+      triMin.Min(v1);
+      triMin.Min(v2);
+      triMax.Max(v1);
+      triMax.Max(v2);
+      if (!boundsOverlap(triMin, triMax, boxMin, boxMax) ||
+          !triangleIntersectsBox(v0 - center, v1 - center, v2 - center, half))
+      {
+        continue;
+      }
+
+      triMin.Max(boxMin);
+      triMax.Min(boxMax);
+      result.Merge(math::AxisAlignedBox(triMin, triMax));
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+bool TriangleBvh::RayIntersection(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double _maxDistance,
+    double &_distance, math::Vector3d &_normal) const
+{
+  if (this->nodes.empty())
+    return false;
+
+  bool hit = false;
+  double closest = _maxDistance;
+  uint32_t stack[64];
+  std::size_t stackSize = 0u;
+  stack[stackSize++] = 0u;
+  while (stackSize > 0u)
+  {
+    const Node &node = this->nodes[stack[--stackSize]];
+    if (!rayCrossesBounds(_origin, _direction, node.min, node.max, closest))
+      continue;
+
+    if (node.count == 0u)
+    {
+      stack[stackSize++] = node.index;
+      stack[stackSize++] =
+          static_cast<uint32_t>(&node - this->nodes.data()) + 1u;
+      continue;
+    }
+
+    for (uint32_t i = node.index; i < node.index + node.count; ++i)
+    {
+      // Moller-Trumbore, see Ericson, Real-Time Collision Detection,
+      // section 5.3.4
+      const uint32_t t = this->triangleOrder[i];
+      const math::Vector3d &v0 = this->vertices[3*t];
+      const math::Vector3d e1 = this->vertices[3*t + 1] - v0;
+      const math::Vector3d e2 = this->vertices[3*t + 2] - v0;
+      const math::Vector3d p = _direction.Cross(e2);
+      const double det = e1.Dot(p);
+      if (std::abs(det) < 1e-12)
+        continue;
+
+      const double invDet = 1.0 / det;
+      const math::Vector3d s = _origin - v0;
+      const double u = s.Dot(p) * invDet;
+      if (u < 0.0 || u > 1.0)
+        continue;
+      const math::Vector3d q = s.Cross(e1);
+      const double v = _direction.Dot(q) * invDet;
+      if (v < 0.0 || u + v > 1.0)
+        continue;
+      const double distance = e2.Dot(q) * invDet;
+      if (distance < 0.0 || distance > closest)
+        continue;
+
+      hit = true;
+      closest = distance;
+      _normal = e1.Cross(e2);
+      if (_normal.Dot(_direction) > 0.0)
+        _normal = -_normal;
+    }
+  }
+
+  if (!hit)
+    return false;
+  _distance = closest;
+  _normal.Normalize();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void TriangleBvh::Build(uint32_t _begin, uint32_t _end,
+    const std::vector<math::Vector3d> &_centroids)
+{
+  const auto nodeIndex = static_cast<uint32_t>(this->nodes.size());
+  this->nodes.emplace_back();
+
+  math::Vector3d min(math::MAX_D, math::MAX_D, math::MAX_D);
+  math::Vector3d max(math::LOW_D, math::LOW_D, math::LOW_D);
+  math::Vector3d centroidMin = min;
+  math::Vector3d centroidMax = max;
+  for (uint32_t i = _begin; i < _end; ++i)
+  {
+    const uint32_t t = this->triangleOrder[i];
+    for (uint32_t k = 0; k < 3u; ++k)
+    {
+      min.Min(this->vertices[3*t + k]);
+      max.Max(this->vertices[3*t + k]);
+    }
+    centroidMin.Min(_centroids[t]);
+    centroidMax.Max(_centroids[t]);
+  }
+  this->nodes[nodeIndex].min = min;
+  this->nodes[nodeIndex].max = max;
+
+  const math::Vector3d extent = centroidMax - centroidMin;
+  if (_end - _begin <= kMaxLeafTriangles || extent == math::Vector3d::Zero)
+  {
+    this->nodes[nodeIndex].index = _begin;
+    this->nodes[nodeIndex].count = _end - _begin;
+    return;
+  }
+
+  // split at the median centroid along the longest axis of the centroids
+  std::size_t axis = 0u;
+  if (extent.Y() > extent[axis])
+    axis = 1u;
+  if (extent.Z() > extent[axis])
+    axis = 2u;
+
+  const uint32_t mid = _begin + (_end - _begin) / 2u;
+  std::nth_element(
+      this->triangleOrder.begin() + _begin,
+      this->triangleOrder.begin() + mid,
+      this->triangleOrder.begin() + _end,
+      [&](uint32_t _a, uint32_t _b)
+      {
+        return _centroids[_a][axis] < _centroids[_b][axis];
+      });
+
+  this->Build(_begin, mid, _centroids);
+  this->nodes[nodeIndex].index = static_cast<uint32_t>(this->nodes.size());
+  this->Build(mid, _end, _centroids);
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_PHYSICS_TPE_LIB_SRC_TRIANGLEBVH_HH_
+#define GZ_PHYSICS_TPE_LIB_SRC_TRIANGLEBVH_HH_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gz/common/Mesh.hh>
+#include <gz/math/AxisAlignedBox.hh>
+#include <gz/math/Vector3.hh>
+#include <gz/utils/SuppressWarning.hh>
+
+#include "gz/physics/tpelib/Export.hh"
+
+namespace gz {
+namespace physics {
+namespace tpelib {
+
+/// \brief Static bounding volume hierarchy over the triangles of a mesh.
+///
+/// The hierarchy is built once, by splitting the triangles at the median of
+/// their centroids along the longest axis, and is never refit. It is used to
+/// find which triangles of a mesh reach into a region whose bounding boxes
+/// already overlap, so that contacts can be limited to the triangles instead
+/// of the bounding box of the whole mesh.
+class GZ_PHYSICS_TPELIB_VISIBLE TriangleBvh
+{
+  /// \brief Constructor
+  /// \param[in] _triangles Corners of the triangles, three consecutive
+  /// vertices per triangle. Trailing vertices that do not make up a full
+  /// triangle are ignored.
+  public: explicit TriangleBvh(const std::vector<math::Vector3d> &_triangles);
+
+  /// \brief Build a hierarchy over the triangle submeshes of a mesh.
+  /// \param[in] _mesh Mesh to read the triangles from
+  /// \return The hierarchy, or nullptr if the mesh has no triangles
+  public: static std::shared_ptr<TriangleBvh> FromMesh(
+      const common::Mesh &_mesh);
+
+  /// \brief Get the number of triangles
+  /// \return Number of triangles in the hierarchy
+  public: std::size_t TriangleCount() const;
+
+  /// \brief Get the bounding box of all triangles
+  /// \return Bounding box of the triangles, or an empty box if there are none
+  public: math::AxisAlignedBox Bounds() const;
+
+  /// \brief Find the part of a box that the triangles reach into
+  /// \param[in] _box Box in the frame of the mesh vertices
+  /// \return Bounding box of the parts of _box covered by the bounding
+  /// boxes of the triangles that intersect it, or an empty box if no
+  /// triangle intersects it
+  public: math::AxisAlignedBox Overlap(const math::AxisAlignedBox &_box) const;
+
+  /// \brief Find the closest triangle hit by a ray. Triangles are hit from
+  /// both sides.
+  /// \param[in] _origin Start of the ray in the frame of the mesh vertices
+  /// \param[in] _direction Direction of the ray. Distances are measured in
+  /// multiples of it.
+  /// \param[in] _maxDistance Only hits up to this distance are reported
+  /// \param[out] _distance Distance from _origin to the hit
+  /// \param[out] _normal Unit normal of the triangle that was hit, facing
+  /// against the ray
+  /// \return True if a triangle was hit within _maxDistance
+  public: bool RayIntersection(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, double _maxDistance,
+      double &_distance, math::Vector3d &_normal) const;
+
+  /// \brief Get the memory used by the hierarchy
+  /// \return Bytes used by the hierarchy and its triangles
+  public: std::size_t GetMemoryBytes() const;
+
+  /// \brief Node of the hierarchy. The left child of an inner node directly
+  /// follows it.
+  private: struct Node
+  {
+    /// \brief Bounds of the triangles below this node
+    math::Vector3d min;
+    math::Vector3d max;
+
+    /// \brief Index of the right child of an inner node, or of the first
+    /// triangle in triangleOrder of a leaf
+    uint32_t index = 0u;
+
+    /// \brief Number of triangles of a leaf, 0 for inner nodes
+    uint32_t count = 0u;
+  };
+
+  /// \brief Build the subtree over a range of triangleOrder
+  /// \param[in] _begin First triangle of the range
+  /// \param[in] _end One past the last triangle of the range
+  /// \param[in] _centroids Centroid of each triangle
+  private: void Build(uint32_t _begin, uint32_t _end,
+      const std::vector<math::Vector3d> &_centroids);
+
+  GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+  /// \brief Corners of the triangles
+  private: std::vector<math::Vector3d> vertices;
+
+  /// \brief Triangle indices, ordered so the triangles of a leaf are
+  /// contiguous
+  private: std::vector<uint32_t> triangleOrder;
+
+  /// \brief Nodes in depth first order, the root is the first node
+  private: std::vector<Node> nodes;
+  GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <gz/common/Mesh.hh>
+#include <gz/common/SubMesh.hh>
+
+#include "TriangleBvh.hh"
+
+using namespace gz;
+using namespace physics;
+using namespace tpelib;
+
+/////////////////////////////////////////////////
+TEST(TriangleBvh, Empty)
+{
+  TriangleBvh bvh({math::Vector3d(0, 0, 0), math::Vector3d(1, 0, 0)});
+  EXPECT_EQ(0u, bvh.TriangleCount());
+  EXPECT_EQ(math::AxisAlignedBox(), bvh.Bounds());
+  EXPECT_EQ(math::AxisAlignedBox(), bvh.Overlap(math::AxisAlignedBox(
+      math::Vector3d(-1, -1, -1), math::Vector3d(1, 1, 1))));
+
+  common::Mesh mesh;
+  EXPECT_EQ(nullptr, TriangleBvh::FromMesh(mesh));
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleBvh, Ramp)
+{
+  // a square ramp on the plane z = x
+  common::SubMesh subMesh;
+  subMesh.AddVertex(math::Vector3d(0, 0, 0));
+  subMesh.AddVertex(math::Vector3d(1, 0, 1));
+  subMesh.AddVertex(math::Vector3d(1, 1, 1));
+  subMesh.AddVertex(math::Vector3d(0, 1, 0));
+  for (unsigned int i : {0u, 1u, 2u, 0u, 2u, 3u})
+    subMesh.AddIndex(i);
+  common::Mesh mesh;
+  mesh.AddSubMesh(subMesh);
+
+  auto bvh = TriangleBvh::FromMesh(mesh);
+  ASSERT_NE(nullptr, bvh);
+  EXPECT_EQ(2u, bvh->TriangleCount());
+  EXPECT_EQ(math::Vector3d(0, 0, 0), bvh->Bounds().Min());
+  EXPECT_EQ(math::Vector3d(1, 1, 1), bvh->Bounds().Max());
+
+  // inside the bounding box of the ramp but below its surface
+  EXPECT_EQ(math::AxisAlignedBox(), bvh->Overlap(math::AxisAlignedBox(
+      math::Vector3d(0.8, 0.4, 0.0), math::Vector3d(0.9, 0.6, 0.1))));
+
+  // crossing the surface
+  math::AxisAlignedBox overlap = bvh->Overlap(math::AxisAlignedBox(
+      math::Vector3d(0.4, 0.4, 0.4), math::Vector3d(0.6, 0.6, 0.6)));
+  EXPECT_EQ(math::Vector3d(0.4, 0.4, 0.4), overlap.Min());
+  EXPECT_EQ(math::Vector3d(0.6, 0.6, 0.6), overlap.Max());
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleBvh, Grid)
+{
+  // a flat 16 x 16 grid of cells on z = 0 and a second level at z = 1
+  // that only covers x < 4
+  std::vector<math::Vector3d> triangles;
+  auto addCell = [&](double _x, double _y, double _z)
+  {
+    const math::Vector3d p0(_x, _y, _z);
+    const math::Vector3d p1(_x + 1, _y, _z);
+    const math::Vector3d p2(_x + 1, _y + 1, _z);
+    const math::Vector3d p3(_x, _y + 1, _z);
+    triangles.insert(triangles.end(), {p0, p1, p2, p0, p2, p3});
+  };
+  for (int x = 0; x < 16; ++x)
+  {
+    for (int y = 0; y < 16; ++y)
+    {
+      addCell(x, y, 0);
+      if (x < 4)
+        addCell(x, y, 1);
+    }
+  }
+
+  TriangleBvh bvh(triangles);
+  EXPECT_EQ(triangles.size() / 3u, bvh.TriangleCount());
+  EXPECT_EQ(math::Vector3d(0, 0, 0), bvh.Bounds().Min());
+  EXPECT_EQ(math::Vector3d(16, 16, 1), bvh.Bounds().Max());
+
+  // a box between the two levels touches no triangle
+  EXPECT_EQ(math::AxisAlignedBox(), bvh.Overlap(math::AxisAlignedBox(
+      math::Vector3d(1.5, 1.5, 0.25), math::Vector3d(2.5, 2.5, 0.75))));
+
+  // a box crossing the ground is clipped to the ground
+  math::AxisAlignedBox overlap = bvh.Overlap(math::AxisAlignedBox(
+      math::Vector3d(8.2, 3.3, -0.5), math::Vector3d(9.7, 5.1, 0.5)));
+  EXPECT_EQ(math::Vector3d(8.2, 3.3, 0), overlap.Min());
+  EXPECT_EQ(math::Vector3d(9.7, 5.1, 0), overlap.Max());
+
+  // a box crossing both levels is clipped to them
+  overlap = bvh.Overlap(math::AxisAlignedBox(
+      math::Vector3d(2.5, 2.5, -0.5), math::Vector3d(3.5, 3.5, 1.5)));
+  EXPECT_EQ(math::Vector3d(2.5, 2.5, 0), overlap.Min());
+  EXPECT_EQ(math::Vector3d(3.5, 3.5, 1), overlap.Max());
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleBvh, RayIntersection)
+{
+  // a grid of squares on the plane z = 0, two triangles each
+  std::vector<math::Vector3d> triangles;
+  for (int x = 0; x < 8; ++x)
+  {
+    for (int y = 0; y < 8; ++y)
+    {
+      const math::Vector3d a(x, y, 0);
+      const math::Vector3d b(x + 1, y, 0);
+      const math::Vector3d c(x + 1, y + 1, 0);
+      const math::Vector3d d(x, y + 1, 0);
+      triangles.insert(triangles.end(), {a, b, c, a, c, d});
+    }
+  }
+  TriangleBvh bvh(triangles);
+
+  double distance = 0.0;
+  math::Vector3d normal;
+  EXPECT_TRUE(bvh.RayIntersection(math::Vector3d(3.3, 4.6, 2),
+      math::Vector3d(0, 0, -1), 5.0, distance, normal));
+  EXPECT_DOUBLE_EQ(2.0, distance);
+  EXPECT_EQ(math::Vector3d::UnitZ, normal);
+
+  // hit from below, the normal faces the ray
+  EXPECT_TRUE(bvh.RayIntersection(math::Vector3d(3.3, 4.6, -1),
+      math::Vector3d(0, 0, 2), 5.0, distance, normal));
+  EXPECT_DOUBLE_EQ(0.5, distance);
+  EXPECT_EQ(-math::Vector3d::UnitZ, normal);
+
+  // too short, outside and parallel to the grid
+  EXPECT_FALSE(bvh.RayIntersection(math::Vector3d(3.3, 4.6, 2),
+      math::Vector3d(0, 0, -1), 1.5, distance, normal));
+  EXPECT_FALSE(bvh.RayIntersection(math::Vector3d(9, 4, 2),
+      math::Vector3d(0, 0, -1), 5.0, distance, normal));
+  EXPECT_FALSE(bvh.RayIntersection(math::Vector3d(-1, 4, 1),
+      math::Vector3d(1, 0, 0), 20.0, distance, normal));
+}
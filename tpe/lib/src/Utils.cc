@@ -15,6 +15,11 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
 #include "Utils.hh"
 
 namespace gz {
@@ -97,6 +102,483 @@ math::AxisAlignedBox transformAxisAlignedBox(
   return math::AxisAlignedBox(newMin, newMax);
 }
 
+//////////////////////////////////////////////////
+void AxisAlignedBoxBatch::Clear()
+{
+  this->Resize(0u);
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxBatch::Resize(std::size_t _size)
+{
+  this->minX.resize(_size);
+  this->minY.resize(_size);
+  this->minZ.resize(_size);
+  this->maxX.resize(_size);
+  this->maxY.resize(_size);
+  this->maxZ.resize(_size);
+}
+
+//////////////////////////////////////////////////
+std::size_t AxisAlignedBoxBatch::Size() const
+{
+  return this->minX.size();
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxBatch::PushBack(const math::AxisAlignedBox &_box)
+{
+  this->minX.push_back(_box.Min().X());
+  this->minY.push_back(_box.Min().Y());
+  this->minZ.push_back(_box.Min().Z());
+  this->maxX.push_back(_box.Max().X());
+  this->maxY.push_back(_box.Max().Y());
+  this->maxZ.push_back(_box.Max().Z());
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox AxisAlignedBoxBatch::Box(std::size_t _index) const
+{
+  return math::AxisAlignedBox(
+      math::Vector3d(this->minX[_index], this->minY[_index],
+                     this->minZ[_index]),
+      math::Vector3d(this->maxX[_index], this->maxY[_index],
+                     this->maxZ[_index]));
+}
+
+//////////////////////////////////////////////////
+std::size_t AxisAlignedBoxBatch::GetMemoryBytes() const
+{
+  return vectorBytes(this->minX) + vectorBytes(this->minY) +
+      vectorBytes(this->minZ) + vectorBytes(this->maxX) +
+      vectorBytes(this->maxY) + vectorBytes(this->maxZ);
+}
+
+//////////////////////////////////////////////////
+void PoseBatch::Clear()
+{
+  for (auto *array : {&this->posX, &this->posY, &this->posZ, &this->rotW,
+      &this->rotX, &this->rotY, &this->rotZ, &this->linX, &this->linY,
+      &this->linZ, &this->angX, &this->angY, &this->angZ})
+  {
+    array->clear();
+  }
+}
+
+//////////////////////////////////////////////////
+std::size_t PoseBatch::Size() const
+{
+  return this->posX.size();
+}
+
+//////////////////////////////////////////////////
+void PoseBatch::PushBack(const math::Pose3d &_pose,
+    const math::Vector3d &_linearVelocity,
+    const math::Vector3d &_angularVelocity)
+{
+  this->posX.push_back(_pose.Pos().X());
+  this->posY.push_back(_pose.Pos().Y());
+  this->posZ.push_back(_pose.Pos().Z());
+  this->rotW.push_back(_pose.Rot().W());
+  this->rotX.push_back(_pose.Rot().X());
+  this->rotY.push_back(_pose.Rot().Y());
+  this->rotZ.push_back(_pose.Rot().Z());
+  this->linX.push_back(_linearVelocity.X());
+  this->linY.push_back(_linearVelocity.Y());
+  this->linZ.push_back(_linearVelocity.Z());
+  this->angX.push_back(_angularVelocity.X());
+  this->angY.push_back(_angularVelocity.Y());
+  this->angZ.push_back(_angularVelocity.Z());
+}
+
+//////////////////////////////////////////////////
+math::Pose3d PoseBatch::Pose(std::size_t _index) const
+{
+  return math::Pose3d(
+      math::Vector3d(this->posX[_index], this->posY[_index],
+                     this->posZ[_index]),
+      math::Quaterniond(this->rotW[_index], this->rotX[_index],
+                        this->rotY[_index], this->rotZ[_index]));
+}
+
+//////////////////////////////////////////////////
+std::size_t PoseBatch::GetMemoryBytes() const
+{
+  std::size_t bytes = 0u;
+  for (const auto *array : {&this->posX, &this->posY, &this->posZ,
+      &this->rotW, &this->rotX, &this->rotY, &this->rotZ, &this->linX,
+      &this->linY, &this->linZ, &this->angX, &this->angY, &this->angZ})
+  {
+    bytes += vectorBytes(*array);
+  }
+  return bytes;
+}
+
+//////////////////////////////////////////////////
+void integratePoses(PoseBatch &_batch, double _timeStep)
+{
+  const std::size_t n = _batch.Size();
+
+  // positions, one component at a time
+  double *pos[3] = {_batch.posX.data(), _batch.posY.data(),
+      _batch.posZ.data()};
+  const double *lin[3] = {_batch.linX.data(), _batch.linY.data(),
+      _batch.linZ.data()};
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    double *p = pos[axis];
+    const double *v = lin[axis];
+    for (std::size_t i = 0; i < n; ++i)
+      p[i] += v[i] * _timeStep;
+  }
+
+  // orientations, following math::Quaterniond::Integrate
+  double *qw = _batch.rotW.data();
+  double *qx = _batch.rotX.data();
+  double *qy = _batch.rotY.data();
+  double *qz = _batch.rotZ.data();
+  const double *angX = _batch.angX.data();
+  const double *angY = _batch.angY.data();
+  const double *angZ = _batch.angZ.data();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const double tx = angX[i] * _timeStep * 0.5;
+    const double ty = angY[i] * _timeStep * 0.5;
+    const double tz = angZ[i] * _timeStep * 0.5;
+    const double thetaMagSq = tx * tx + ty * ty + tz * tz;
+    double dw;
+    double s;
+    if (thetaMagSq * thetaMagSq / 24.0 < std::numeric_limits<double>::min())
+    {
+      dw = 1.0 - thetaMagSq / 2.0;
+      s = 1.0 - thetaMagSq / 6.0;
+    }
+    else
+    {
+      const double thetaMag = std::sqrt(thetaMagSq);
+      dw = std::cos(thetaMag);
+      s = std::sin(thetaMag) / thetaMag;
+    }
+    const double dx = tx * s;
+    const double dy = ty * s;
+    const double dz = tz * s;
+
+    const double w = dw * qw[i] - dx * qx[i] - dy * qy[i] - dz * qz[i];
+    const double x = dw * qx[i] + dx * qw[i] + dy * qz[i] - dz * qy[i];
+    const double y = dw * qy[i] - dx * qz[i] + dy * qw[i] + dz * qx[i];
+    const double z = dw * qz[i] + dx * qy[i] - dy * qx[i] + dz * qw[i];
+    qw[i] = w;
+    qx[i] = x;
+    qy[i] = y;
+    qz[i] = z;
+  }
+}
+
+//////////////////////////////////////////////////
+std::size_t intersectAxisAlignedBoxes(
+    const AxisAlignedBoxBatch &_a, const AxisAlignedBoxBatch &_b,
+    AxisAlignedBoxBatch &_intersections, std::vector<uint8_t> &_hits)
+{
+  const std::size_t n = std::min(_a.Size(), _b.Size());
+  _intersections.Resize(n);
+  _hits.resize(n);
+
+  // Compute the overlapping region one component at a time. Each loop only
+  // reads and writes contiguous arrays, which lets the compiler use SIMD
+  // min / max instructions.
+  const double *aMin[3] = {_a.minX.data(), _a.minY.data(), _a.minZ.data()};
+  const double *aMax[3] = {_a.maxX.data(), _a.maxY.data(), _a.maxZ.data()};
+  const double *bMin[3] = {_b.minX.data(), _b.minY.data(), _b.minZ.data()};
+  const double *bMax[3] = {_b.maxX.data(), _b.maxY.data(), _b.maxZ.data()};
+  double *iMin[3] = {_intersections.minX.data(), _intersections.minY.data(),
+      _intersections.minZ.data()};
+  double *iMax[3] = {_intersections.maxX.data(), _intersections.maxY.data(),
+      _intersections.maxZ.data()};
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    const double *aMinAxis = aMin[axis];
+    const double *bMinAxis = bMin[axis];
+    const double *aMaxAxis = aMax[axis];
+    const double *bMaxAxis = bMax[axis];
+    double *iMinAxis = iMin[axis];
+    double *iMaxAxis = iMax[axis];
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      iMinAxis[i] = std::max(aMinAxis[i], bMinAxis[i]);
+      iMaxAxis[i] = std::min(aMaxAxis[i], bMaxAxis[i]);
+    }
+  }
+
+  // Two boxes intersect if the overlapping region is not empty along any
+  // axis. This matches math::AxisAlignedBox::Intersects, i.e. touching
+  // boxes intersect.
+  uint8_t *hits = _hits.data();
+  const double *minX = _intersections.minX.data();
+  const double *minY = _intersections.minY.data();
+  const double *minZ = _intersections.minZ.data();
+  const double *maxX = _intersections.maxX.data();
+  const double *maxY = _intersections.maxY.data();
+  const double *maxZ = _intersections.maxZ.data();
+  std::size_t count = 0u;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    hits[i] = static_cast<uint8_t>(
+        (minX[i] <= maxX[i]) & (minY[i] <= maxY[i]) & (minZ[i] <= maxZ[i]));
+    count += hits[i];
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+bool orientedBoxesIntersect(
+    const math::AxisAlignedBox &_box1, const math::Pose3d &_pose1,
+    const math::AxisAlignedBox &_box2, const math::Pose3d &_pose2)
+{
+  if (_box1 == math::AxisAlignedBox() || _box2 == math::AxisAlignedBox())
+    return false;
+
+  // axes, centers and half sizes of both boxes in the world frame
+  const math::Vector3d a[3] = {_pose1.Rot() * math::Vector3d::UnitX,
+      _pose1.Rot() * math::Vector3d::UnitY,
+      _pose1.Rot() * math::Vector3d::UnitZ};
+  const math::Vector3d b[3] = {_pose2.Rot() * math::Vector3d::UnitX,
+      _pose2.Rot() * math::Vector3d::UnitY,
+      _pose2.Rot() * math::Vector3d::UnitZ};
+  const math::Vector3d ea = 0.5 * (_box1.Max() - _box1.Min());
+  const math::Vector3d eb = 0.5 * (_box2.Max() - _box2.Min());
+  const math::Vector3d ca = _pose1.Rot() * _box1.Center() + _pose1.Pos();
+  const math::Vector3d cb = _pose2.Rot() * _box2.Center() + _pose2.Pos();
+
+  // rotation of the second box in the frame of the first box, and the
+  // offset between the centers in the frame of the first box. A small
+  // epsilon is added to the rotation terms so that nearly parallel edges do
+  // not produce a zero cross product axis that reports a false separation.
+  const double kEpsilon = 1e-9;
+  double r[3][3];
+  double absR[3][3];
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      r[i][j] = a[i].Dot(b[j]);
+      absR[i][j] = std::abs(r[i][j]) + kEpsilon;
+    }
+  }
+  const math::Vector3d d = cb - ca;
+  const double t[3] = {d.Dot(a[0]), d.Dot(a[1]), d.Dot(a[2])};
+
+  // face axes of the first box
+  for (int i = 0; i < 3; ++i)
+  {
+    const double rb =
+        eb[0] * absR[i][0] + eb[1] * absR[i][1] + eb[2] * absR[i][2];
+    if (std::abs(t[i]) > ea[i] + rb)
+      return false;
+  }
+
+  // face axes of the second box
+  for (int j = 0; j < 3; ++j)
+  {
+    const double ra =
+        ea[0] * absR[0][j] + ea[1] * absR[1][j] + ea[2] * absR[2][j];
+    const double tj = t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j];
+    if (std::abs(tj) > ra + eb[j])
+      return false;
+  }
+
+  // cross products of the edges of both boxes
+  for (int i = 0; i < 3; ++i)
+  {
+    const int i1 = (i + 1) % 3;
+    const int i2 = (i + 2) % 3;
+    for (int j = 0; j < 3; ++j)
+    {
+      const int j1 = (j + 1) % 3;
+      const int j2 = (j + 2) % 3;
+      const double ra = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j];
+      const double rb = eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+      const double tij = t[i2] * r[i1][j] - t[i1] * r[i2][j];
+      if (std::abs(tij) > ra + rb)
+        return false;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+double squaredDistanceToOrientedBox(const math::Vector3d &_point,
+    const math::AxisAlignedBox &_box, const math::Pose3d &_pose)
+{
+  // distance to the box in its own frame, where it is axis aligned
+  const math::Vector3d local =
+      _pose.Rot().RotateVectorReverse(_point - _pose.Pos());
+  double dist = 0.0;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (local[i] < _box.Min()[i])
+      dist += (_box.Min()[i] - local[i]) * (_box.Min()[i] - local[i]);
+    else if (local[i] > _box.Max()[i])
+      dist += (local[i] - _box.Max()[i]) * (local[i] - _box.Max()[i]);
+  }
+  return dist;
+}
+
+//////////////////////////////////////////////////
+double squaredSegmentDistance(
+    const math::Vector3d &_p1, const math::Vector3d &_q1,
+    const math::Vector3d &_p2, const math::Vector3d &_q2)
+{
+  // closest points of two segments, see Ericson, Real-Time Collision
+  // Detection, section 5.1.9
+  const double kEpsilon = 1e-12;
+  const math::Vector3d d1 = _q1 - _p1;
+  const math::Vector3d d2 = _q2 - _p2;
+  const math::Vector3d r = _p1 - _p2;
+  const double a = d1.SquaredLength();
+  const double e = d2.SquaredLength();
+  const double f = d2.Dot(r);
+
+  double s = 0.0;
+  double t = 0.0;
+  if (a <= kEpsilon && e <= kEpsilon)
+    return r.SquaredLength();
+
+  if (a <= kEpsilon)
+  {
+    t = std::clamp(f / e, 0.0, 1.0);
+  }
+  else
+  {
+    const double c = d1.Dot(r);
+    if (e <= kEpsilon)
+    {
+      s = std::clamp(-c / a, 0.0, 1.0);
+    }
+    else
+    {
+      const double b = d1.Dot(d2);
+      const double denom = a * e - b * b;
+      if (denom > kEpsilon)
+        s = std::clamp((b * f - c * e) / denom, 0.0, 1.0);
+      t = (b * s + f) / e;
+      if (t < 0.0)
+      {
+        t = 0.0;
+        s = std::clamp(-c / a, 0.0, 1.0);
+      }
+      else if (t > 1.0)
+      {
+        t = 1.0;
+        s = std::clamp((b - c) / a, 0.0, 1.0);
+      }
+    }
+  }
+
+  return ((_p1 + d1 * s) - (_p2 + d2 * t)).SquaredLength();
+}
+
+//////////////////////////////////////////////////
+bool rayIntersectsAxisAlignedBox(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, const math::AxisAlignedBox &_box,
+    double _maxDistance, double &_distance, math::Vector3d &_normal)
+{
+  if (_box == math::AxisAlignedBox())
+    return false;
+
+  // slab test, see Ericson, Real-Time Collision Detection, section 5.3.3
+  double tEnter = -std::numeric_limits<double>::infinity();
+  double tExit = std::numeric_limits<double>::infinity();
+  int enterAxis = -1;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double o = _origin[i];
+    const double d = _direction[i];
+    const double lo = _box.Min()[i];
+    const double hi = _box.Max()[i];
+    if (std::fpclassify(d) == FP_ZERO)
+    {
+      if (o < lo || o > hi)
+        return false;
+      continue;
+    }
+
+    double t1 = (lo - o) / d;
+    double t2 = (hi - o) / d;
+    if (t1 > t2)
+      std::swap(t1, t2);
+    if (t1 > tEnter)
+    {
+      tEnter = t1;
+      enterAxis = i;
+    }
+    tExit = std::min(tExit, t2);
+    if (tEnter > tExit)
+      return false;
+  }
+
+  if (enterAxis < 0 || tEnter < 0.0 || tEnter > _maxDistance)
+    return false;
+
+  _distance = tEnter;
+  _normal = math::Vector3d::Zero;
+  _normal[enterAxis] = _direction[enterAxis] > 0.0 ? -1.0 : 1.0;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool rayIntersectsSphere(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, const math::Vector3d &_center,
+    double _radius, double _maxDistance, double &_distance,
+    math::Vector3d &_normal)
+{
+  if (_radius <= 0.0)
+    return false;
+
+  // see Ericson, Real-Time Collision Detection, section 5.3.2
+  const math::Vector3d m = _origin - _center;
+  const double b = m.Dot(_direction);
+  const double c = m.SquaredLength() - _radius * _radius;
+  // the ray starts inside the sphere, or outside and points away from it
+  if (c <= 0.0 || b > 0.0)
+    return false;
+
+  const double discriminant = b * b - c;
+  if (discriminant < 0.0)
+    return false;
+
+  const double t = std::max(0.0, -b - std::sqrt(discriminant));
+  if (t > _maxDistance)
+    return false;
+
+  _distance = t;
+  _normal = (m + _direction * t) / _radius;
+  _normal.Normalize();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void runTasks(const TaskRunner &_runner,
+    std::unique_ptr<common::WorkerPool> &_pool, std::size_t &_poolThreads,
+    std::size_t _numThreads, std::size_t _count,
+    const std::function<void(std::size_t)> &_task)
+{
+  if (_runner)
+  {
+    _runner(_count, _task);
+    return;
+  }
+
+  if (!_pool || _poolThreads != _numThreads)
+  {
+    _pool = std::make_unique<common::WorkerPool>(
+        static_cast<unsigned int>(_numThreads));
+    _poolThreads = _numThreads;
+  }
+  for (std::size_t i = 0u; i < _count; ++i)
+    _pool->AddWork([&_task, i]() { _task(i); });
+  _pool->WaitForResults();
+}
+
 }
 }
 }
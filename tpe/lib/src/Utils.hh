@@ -15,8 +15,19 @@
  *
 */
 
+#ifndef GZ_PHYSICS_TPE_LIB_SRC_UTILS_HH_
+#define GZ_PHYSICS_TPE_LIB_SRC_UTILS_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <gz/common/WorkerPool.hh>
 #include <gz/math/AxisAlignedBox.hh>
 #include <gz/math/Pose3.hh>
+#include <gz/utils/SuppressWarning.hh>
 
 #include "gz/physics/tpelib/Export.hh"
 
@@ -32,9 +43,245 @@ namespace tpelib {
   GZ_PHYSICS_TPELIB_VISIBLE
   math::AxisAlignedBox transformAxisAlignedBox(
       const math::AxisAlignedBox &_box, const math::Pose3d &_pose);
+
+  /// \brief Axis aligned boxes stored as packed arrays of their bounds so
+  /// that many boxes can be processed in tight, vectorizable loops.
+  /// The i-th box spans [minX[i], maxX[i]] x [minY[i], maxY[i]] x
+  /// [minZ[i], maxZ[i]].
+  class GZ_PHYSICS_TPELIB_VISIBLE AxisAlignedBoxBatch
+  {
+    /// \brief Remove all boxes
+    public: void Clear();
+
+    /// \brief Resize the batch
+    /// \param[in] _size New number of boxes
+    public: void Resize(std::size_t _size);
+
+    /// \brief Get the number of boxes
+    /// \return Number of boxes in the batch
+    public: std::size_t Size() const;
+
+    /// \brief Append a box
+    /// \param[in] _box Box to append
+    public: void PushBack(const math::AxisAlignedBox &_box);
+
+    /// \brief Get a box
+    /// \param[in] _index Index of the box
+    /// \return The box at the given index
+    public: math::AxisAlignedBox Box(std::size_t _index) const;
+
+    /// \brief Get the heap memory used by the bounds
+    /// \return Bytes allocated for the capacity of the bound arrays
+    public: std::size_t GetMemoryBytes() const;
+
+    GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+    /// \brief Minimum x of each box
+    public: std::vector<double> minX;
+
+    /// \brief Minimum y of each box
+    public: std::vector<double> minY;
+
+    /// \brief Minimum z of each box
+    public: std::vector<double> minZ;
+
+    /// \brief Maximum x of each box
+    public: std::vector<double> maxX;
+
+    /// \brief Maximum y of each box
+    public: std::vector<double> maxY;
+
+    /// \brief Maximum z of each box
+    public: std::vector<double> maxZ;
+    GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+  };
+
+  /// \brief Poses and velocities of entities stored as packed arrays, so
+  /// that many entities can be integrated in tight, vectorizable loops. See
+  /// integratePoses.
+  class GZ_PHYSICS_TPELIB_VISIBLE PoseBatch
+  {
+    /// \brief Remove all entries
+    public: void Clear();
+
+    /// \brief Get the number of entries
+    /// \return Number of entries in the batch
+    public: std::size_t Size() const;
+
+    /// \brief Append an entry
+    /// \param[in] _pose Pose to integrate
+    /// \param[in] _linearVelocity Linear velocity, in the frame of the pose
+    /// \param[in] _angularVelocity Angular velocity, in the frame of the
+    /// pose
+    public: void PushBack(const math::Pose3d &_pose,
+        const math::Vector3d &_linearVelocity,
+        const math::Vector3d &_angularVelocity);
+
+    /// \brief Get the pose of an entry
+    /// \param[in] _index Index of the entry
+    /// \return The pose at the given index
+    public: math::Pose3d Pose(std::size_t _index) const;
+
+    /// \brief Get the heap memory used by the arrays
+    /// \return Bytes allocated for the capacity of the arrays
+    public: std::size_t GetMemoryBytes() const;
+
+    GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+    /// \brief Position of each pose, x, y, z
+    public: std::vector<double> posX;
+    public: std::vector<double> posY;
+    public: std::vector<double> posZ;
+
+    /// \brief Orientation of each pose, w, x, y, z
+    public: std::vector<double> rotW;
+    public: std::vector<double> rotX;
+    public: std::vector<double> rotY;
+    public: std::vector<double> rotZ;
+
+    /// \brief Linear velocity of each entry, x, y, z
+    public: std::vector<double> linX;
+    public: std::vector<double> linY;
+    public: std::vector<double> linZ;
+
+    /// \brief Angular velocity of each entry, x, y, z
+    public: std::vector<double> angX;
+    public: std::vector<double> angY;
+    public: std::vector<double> angZ;
+    GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+  };
+
+  /// \brief Integrate the poses of a batch by their velocities over a time
+  /// step, in place. Gives the same poses as
+  /// Pose3d(pos + linear * dt, rot.Integrate(angular, dt)) for each entry.
+  /// Entries are read from contiguous arrays, and the positions are updated
+  /// in loops that the compiler can vectorize.
+  /// \param[in,out] _batch Poses and velocities
+  /// \param[in] _timeStep Time step
+  GZ_PHYSICS_TPELIB_VISIBLE
+  void integratePoses(PoseBatch &_batch, double _timeStep);
+
+  /// \brief Intersect pairs of axis aligned boxes. Box i of _a is tested
+  /// against box i of _b. The loops are branch free so that the compiler
+  /// can vectorize them.
+  /// \param[in] _a First box of each pair
+  /// \param[in] _b Second box of each pair. Must be the same size as _a.
+  /// \param[out] _intersections Region of intersection of each pair. Only
+  /// valid for pairs that intersect.
+  /// \param[out] _hits 1 if the pair intersects, 0 otherwise
+  /// \return Number of pairs that intersect
+  GZ_PHYSICS_TPELIB_VISIBLE
+  std::size_t intersectAxisAlignedBoxes(
+      const AxisAlignedBoxBatch &_a, const AxisAlignedBoxBatch &_b,
+      AxisAlignedBoxBatch &_intersections, std::vector<uint8_t> &_hits);
+
+  /// \brief Check whether two oriented boxes intersect, using the separating
+  /// axis test. Each box is an axis aligned box in its own frame that is
+  /// placed in the world by a pose.
+  /// \param[in] _box1 First box in its own frame
+  /// \param[in] _pose1 World pose of the frame of the first box
+  /// \param[in] _box2 Second box in its own frame
+  /// \param[in] _pose2 World pose of the frame of the second box
+  /// \return True if the boxes intersect or touch
+  GZ_PHYSICS_TPELIB_VISIBLE
+  bool orientedBoxesIntersect(
+      const math::AxisAlignedBox &_box1, const math::Pose3d &_pose1,
+      const math::AxisAlignedBox &_box2, const math::Pose3d &_pose2);
+
+  /// \brief Get the squared distance from a point to an oriented box
+  /// \param[in] _point Point in the world frame
+  /// \param[in] _box Box in its own frame
+  /// \param[in] _pose World pose of the frame of the box
+  /// \return Squared distance, 0 if the point is inside the box
+  GZ_PHYSICS_TPELIB_VISIBLE
+  double squaredDistanceToOrientedBox(const math::Vector3d &_point,
+      const math::AxisAlignedBox &_box, const math::Pose3d &_pose);
+
+  /// \brief Get the squared distance between two line segments
+  /// \param[in] _p1 Start of the first segment
+  /// \param[in] _q1 End of the first segment
+  /// \param[in] _p2 Start of the second segment
+  /// \param[in] _q2 End of the second segment
+  /// \return Squared distance between the closest points of the segments
+  GZ_PHYSICS_TPELIB_VISIBLE
+  double squaredSegmentDistance(
+      const math::Vector3d &_p1, const math::Vector3d &_q1,
+      const math::Vector3d &_p2, const math::Vector3d &_q2);
+
+  /// \brief Intersect a ray with an axis aligned box. Rays that start
+  /// inside the box do not hit it.
+  /// \param[in] _origin Start of the ray
+  /// \param[in] _direction Unit direction of the ray
+  /// \param[in] _box Box, in the frame of the ray
+  /// \param[in] _maxDistance Only hits up to this distance are reported
+  /// \param[out] _distance Distance from _origin to where the ray enters the
+  /// box
+  /// \param[out] _normal Unit normal of the face the ray enters through
+  /// \return True if the ray enters the box within _maxDistance
+  GZ_PHYSICS_TPELIB_VISIBLE
+  bool rayIntersectsAxisAlignedBox(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, const math::AxisAlignedBox &_box,
+      double _maxDistance, double &_distance, math::Vector3d &_normal);
+
+  /// \brief Intersect a ray with a sphere. Rays that start inside the
+  /// sphere do not hit it.
+  /// \param[in] _origin Start of the ray
+  /// \param[in] _direction Unit direction of the ray
+  /// \param[in] _center Center of the sphere, in the frame of the ray
+  /// \param[in] _radius Radius of the sphere
+  /// \param[in] _maxDistance Only hits up to this distance are reported
+  /// \param[out] _distance Distance from _origin to the hit
+  /// \param[out] _normal Unit surface normal at the hit
+  /// \return True if the ray hits the sphere within _maxDistance
+  GZ_PHYSICS_TPELIB_VISIBLE
+  bool rayIntersectsSphere(const math::Vector3d &_origin,
+      const math::Vector3d &_direction, const math::Vector3d &_center,
+      double _radius, double _maxDistance, double &_distance,
+      math::Vector3d &_normal);
+
+  /// \brief Runs _task(i) for each i in [0, _count), possibly
+  /// concurrently, and returns once all of the calls returned, see
+  /// World::SetTaskRunner.
+  using TaskRunner = std::function<void(
+      std::size_t _count, const std::function<void(std::size_t)> &_task)>;
+
+  /// \brief Run tasks concurrently, on a task runner if there is one and
+  /// on a worker pool otherwise.
+  /// \param[in] _runner Task runner, may be empty.
+  /// \param[in,out] _pool Worker pool, created if it is needed and null or
+  /// of another number of threads.
+  /// \param[in,out] _poolThreads Number of threads of _pool.
+  /// \param[in] _numThreads Number of threads of the worker pool.
+  /// \param[in] _count Number of tasks.
+  /// \param[in] _task Task to call with the index of each task.
+  GZ_PHYSICS_TPELIB_VISIBLE
+  void runTasks(const TaskRunner &_runner,
+      std::unique_ptr<common::WorkerPool> &_pool, std::size_t &_poolThreads,
+      std::size_t _numThreads, std::size_t _count,
+      const std::function<void(std::size_t)> &_task);
+
+  /// \brief Estimate the heap memory of the elements of a vector
+  /// \param[in] _vector Vector to measure
+  /// \return Bytes allocated for the capacity of the vector
+  template <typename T>
+  std::size_t vectorBytes(const std::vector<T> &_vector)
+  {
+    return _vector.capacity() * sizeof(T);
+  }
+
+  /// \brief Estimate the heap memory of the nodes of a std::map or std::set
+  /// \param[in] _tree Map or set to measure
+  /// \return Bytes allocated for the nodes, assuming three links and a color
+  /// per node
+  template <typename TreeT>
+  std::size_t treeBytes(const TreeT &_tree)
+  {
+    return _tree.size() *
+        (sizeof(typename TreeT::value_type) + 4u * sizeof(void *));
+  }
 }
 }
 }
 
+#endif
+
 
 
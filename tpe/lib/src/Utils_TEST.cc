@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <tuple>
+#include <vector>
+
 #include "Utils.hh"
 
 using namespace gz;
@@ -53,3 +56,192 @@ TEST(Utils, TransformAxisAlignedBox)
   EXPECT_EQ(math::AxisAlignedBox(math::Vector3d(-1, 0, 1),
       math::Vector3d(5, 4, 3)), box2TransformedRot);
 }
+
+/////////////////////////////////////////////////
+TEST(Utils, IntersectAxisAlignedBoxes)
+{
+  AxisAlignedBoxBatch a;
+  AxisAlignedBoxBatch b;
+  AxisAlignedBoxBatch intersections;
+  std::vector<uint8_t> hits;
+  EXPECT_EQ(0u, intersectAxisAlignedBoxes(a, b, intersections, hits));
+  EXPECT_TRUE(hits.empty());
+
+  std::vector<math::AxisAlignedBox> boxesA = {
+    // overlapping
+    math::AxisAlignedBox(math::Vector3d(-2, -2, -2), math::Vector3d(2, 2, 2)),
+    // separated along z
+    math::AxisAlignedBox(math::Vector3d(0, 0, 0), math::Vector3d(1, 1, 1)),
+    // touching
+    math::AxisAlignedBox(math::Vector3d(0, 0, 0), math::Vector3d(1, 1, 1)),
+    // invalid box
+    math::AxisAlignedBox(),
+    // contained
+    math::AxisAlignedBox(math::Vector3d(-5, -5, -5), math::Vector3d(5, 5, 5))};
+  std::vector<math::AxisAlignedBox> boxesB = {
+    math::AxisAlignedBox(math::Vector3d(-1, -1, -1), math::Vector3d(3, 3, 3)),
+    math::AxisAlignedBox(math::Vector3d(0, 0, 2), math::Vector3d(1, 1, 3)),
+    math::AxisAlignedBox(math::Vector3d(1, 0, 0), math::Vector3d(2, 1, 1)),
+    math::AxisAlignedBox(math::Vector3d(0, 0, 0), math::Vector3d(1, 1, 1)),
+    math::AxisAlignedBox(math::Vector3d(-1, -2, -3), math::Vector3d(1, 2, 3))};
+
+  for (std::size_t i = 0; i < boxesA.size(); ++i)
+  {
+    a.PushBack(boxesA[i]);
+    b.PushBack(boxesB[i]);
+  }
+  EXPECT_EQ(boxesA.size(), a.Size());
+  EXPECT_EQ(boxesA[1], a.Box(1u));
+
+  EXPECT_EQ(3u, intersectAxisAlignedBoxes(a, b, intersections, hits));
+  ASSERT_EQ(boxesA.size(), hits.size());
+  ASSERT_EQ(boxesA.size(), intersections.Size());
+
+  // the batched result matches math::AxisAlignedBox::Intersects
+  for (std::size_t i = 0; i < boxesA.size(); ++i)
+    EXPECT_EQ(boxesA[i].Intersects(boxesB[i]), hits[i] != 0u) << i;
+
+  EXPECT_EQ(math::AxisAlignedBox(math::Vector3d(-1, -1, -1),
+      math::Vector3d(2, 2, 2)), intersections.Box(0u));
+  EXPECT_EQ(math::Vector3d(1, 0.5, 0.5), intersections.Box(2u).Center());
+  EXPECT_EQ(boxesB[4], intersections.Box(4u));
+
+  a.Clear();
+  EXPECT_EQ(0u, a.Size());
+}
+
+/////////////////////////////////////////////////
+TEST(Utils, IntegratePoses)
+{
+  // poses integrated in a batch match those of Pose3d and
+  // Quaterniond::Integrate, including at rest and for tiny rotations
+  const std::vector<std::tuple<math::Pose3d, math::Vector3d, math::Vector3d>>
+      entries{
+      {math::Pose3d(1, 2, 3, 0.1, 0.2, 0.3), math::Vector3d(1, -2, 0.5),
+          math::Vector3d(0.3, -0.2, 4.0)},
+      {math::Pose3d(-4, 0, 1, 0, 0, 1.5), math::Vector3d::Zero,
+          math::Vector3d::Zero},
+      {math::Pose3d(0, 0, 0, 2.0, -1.0, 0.5), math::Vector3d(0, 0, -9.8),
+          math::Vector3d(1e-90, 0, 0)},
+      {math::Pose3d(5, 5, 5, 0, 0.4, 0), math::Vector3d::Zero,
+          math::Vector3d(-20, 10, 3)}};
+
+  PoseBatch batch;
+  for (const auto &[pose, linear, angular] : entries)
+    batch.PushBack(pose, linear, angular);
+  EXPECT_EQ(entries.size(), batch.Size());
+  EXPECT_GT(batch.GetMemoryBytes(), 0u);
+
+  const double dt = 0.01;
+  integratePoses(batch, dt);
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    const auto &[pose, linear, angular] = entries[i];
+    const math::Vector3d pos = pose.Pos() + linear * dt;
+    const math::Quaterniond rot = pose.Rot().Integrate(angular, dt);
+    const math::Pose3d integrated = batch.Pose(i);
+    EXPECT_NEAR(pos.X(), integrated.Pos().X(), 1e-12);
+    EXPECT_NEAR(pos.Y(), integrated.Pos().Y(), 1e-12);
+    EXPECT_NEAR(pos.Z(), integrated.Pos().Z(), 1e-12);
+    EXPECT_NEAR(rot.W(), integrated.Rot().W(), 1e-12);
+    EXPECT_NEAR(rot.X(), integrated.Rot().X(), 1e-12);
+    EXPECT_NEAR(rot.Y(), integrated.Rot().Y(), 1e-12);
+    EXPECT_NEAR(rot.Z(), integrated.Rot().Z(), 1e-12);
+  }
+
+  batch.Clear();
+  EXPECT_EQ(0u, batch.Size());
+  integratePoses(batch, dt);
+}
+
+/////////////////////////////////////////////////
+TEST(Utils, OrientedBoxesIntersect)
+{
+  // a long thin box along x, and a small cube
+  const math::AxisAlignedBox rod(
+      math::Vector3d(-5, -0.1, -0.1), math::Vector3d(5, 0.1, 0.1));
+  const math::AxisAlignedBox cube(
+      math::Vector3d(-0.5, -0.5, -0.5), math::Vector3d(0.5, 0.5, 0.5));
+
+  EXPECT_FALSE(orientedBoxesIntersect(
+      math::AxisAlignedBox(), math::Pose3d::Zero, cube, math::Pose3d::Zero));
+  EXPECT_TRUE(orientedBoxesIntersect(
+      rod, math::Pose3d::Zero, cube, math::Pose3d::Zero));
+
+  // the rod rotated by 45 degrees about z. The cube sits inside its world
+  // axis aligned box but away from the rod itself.
+  const math::Pose3d rodPose(0, 0, 0, 0, 0, GZ_PI * 0.25);
+  const math::Pose3d cubePose(2.5, -2.5, 0, 0, 0, 0);
+  EXPECT_TRUE(transformAxisAlignedBox(rod, rodPose).Intersects(
+      transformAxisAlignedBox(cube, cubePose)));
+  EXPECT_FALSE(orientedBoxesIntersect(rod, rodPose, cube, cubePose));
+  EXPECT_FALSE(orientedBoxesIntersect(cube, cubePose, rod, rodPose));
+
+  // the cube on the rod
+  EXPECT_TRUE(orientedBoxesIntersect(
+      rod, rodPose, cube, math::Pose3d(2.5, 2.5, 0, 0, 0, 0)));
+
+  // two crossing rods, one passing over the other
+  const math::Pose3d rodPose2(0, 0, 1, GZ_PI * 0.5, 0, GZ_PI * 0.5);
+  EXPECT_FALSE(orientedBoxesIntersect(rod, rodPose, rod, rodPose2));
+  EXPECT_TRUE(orientedBoxesIntersect(rod, rodPose, rod,
+      math::Pose3d(0, 0, 0.15, GZ_PI * 0.5, 0, GZ_PI * 0.5)));
+
+  // boxes whose local bounds are not centered on their frame
+  const math::AxisAlignedBox offset(
+      math::Vector3d(2, -0.5, -0.5), math::Vector3d(3, 0.5, 0.5));
+  EXPECT_TRUE(orientedBoxesIntersect(offset, math::Pose3d::Zero,
+      cube, math::Pose3d(2.5, 0, 0, 0, 0, 0)));
+  EXPECT_FALSE(orientedBoxesIntersect(offset, math::Pose3d::Zero,
+      cube, math::Pose3d::Zero));
+}
+
+/////////////////////////////////////////////////
+TEST(Utils, SquaredDistanceToOrientedBox)
+{
+  const math::AxisAlignedBox box(
+      math::Vector3d(-1, -1, -1), math::Vector3d(1, 1, 1));
+  EXPECT_DOUBLE_EQ(0.0, squaredDistanceToOrientedBox(
+      math::Vector3d(0.5, 0.5, 0.5), box, math::Pose3d::Zero));
+  EXPECT_DOUBLE_EQ(4.0, squaredDistanceToOrientedBox(
+      math::Vector3d(3, 0, 0), box, math::Pose3d::Zero));
+
+  // the corner of the box rotated by 45 degrees about z points along x
+  const math::Pose3d pose(0, 0, 0, 0, 0, GZ_PI * 0.25);
+  EXPECT_NEAR(0.0, squaredDistanceToOrientedBox(
+      math::Vector3d(std::sqrt(2.0) - 1e-3, 0, 0), box, pose), 1e-12);
+  EXPECT_NEAR(1.0, squaredDistanceToOrientedBox(
+      math::Vector3d(std::sqrt(2.0) + 1.0, 0, 0), box, pose), 1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST(Utils, SquaredSegmentDistance)
+{
+  // crossing segments
+  EXPECT_DOUBLE_EQ(0.0, squaredSegmentDistance(
+      math::Vector3d(-1, 0, 0), math::Vector3d(1, 0, 0),
+      math::Vector3d(0, -1, 0), math::Vector3d(0, 1, 0)));
+
+  // skew segments one unit apart
+  EXPECT_DOUBLE_EQ(1.0, squaredSegmentDistance(
+      math::Vector3d(-1, 0, 0), math::Vector3d(1, 0, 0),
+      math::Vector3d(0, -1, 1), math::Vector3d(0, 1, 1)));
+
+  // parallel segments
+  EXPECT_DOUBLE_EQ(4.0, squaredSegmentDistance(
+      math::Vector3d(0, 0, 0), math::Vector3d(1, 0, 0),
+      math::Vector3d(0, 2, 0), math::Vector3d(1, 2, 0)));
+
+  // closest points at the ends of the segments
+  EXPECT_DOUBLE_EQ(2.0, squaredSegmentDistance(
+      math::Vector3d(0, 0, 0), math::Vector3d(1, 0, 0),
+      math::Vector3d(2, 1, 0), math::Vector3d(3, 1, 0)));
+
+  // degenerate segments are points
+  EXPECT_DOUBLE_EQ(9.0, squaredSegmentDistance(
+      math::Vector3d(0, 0, 0), math::Vector3d(0, 0, 0),
+      math::Vector3d(0, 0, 3), math::Vector3d(0, 0, 3)));
+  EXPECT_DOUBLE_EQ(1.0, squaredSegmentDistance(
+      math::Vector3d(0, 0, 1), math::Vector3d(0, 0, 1),
+      math::Vector3d(-1, 0, 0), math::Vector3d(1, 0, 0)));
+}
@@ -15,15 +15,23 @@
  *
 */
 
+#include <algorithm>
+#include <chrono>
 #include <string>
 #include <memory>
+#include <unordered_set>
+#include <utility>
 
 #include <gz/common/Profiler.hh>
 
 #include <gz/math/Pose3.hh>
 #include "World.hh"
+#include "Collision.hh"
 #include "Model.hh"
 #include "Link.hh"
+#include "Shape.hh"
+#include "TriangleBvh.hh"
+#include "Utils.hh"
 
 using namespace gz;
 using namespace physics;
@@ -32,6 +40,8 @@ using namespace tpelib;
 /////////////////////////////////////////////////
 World::World() : Entity()
 {
+  this->CreateIdSpace();
+  this->collisionDetector.SetMaxContactsPerPair(1u);
 }
 
 /////////////////////////////////////////////////
@@ -59,38 +69,630 @@ double World::GetTimeStep() const
 }
 
 /////////////////////////////////////////////////
-void World::Step()
+void World::SetNumThreads(std::size_t _numThreads)
 {
-  GZ_PROFILE("tpelib::World::Step");
-  // apply updates to each model
+  this->numThreads = std::max<std::size_t>(_numThreads, 1u);
+  this->collisionDetector.SetNumThreads(this->numThreads);
+}
+
+/////////////////////////////////////////////////
+std::size_t World::GetNumThreads() const
+{
+  return this->numThreads;
+}
+
+/////////////////////////////////////////////////
+void World::SetTaskRunner(TaskRunner _runner)
+{
+  this->taskRunner = std::move(_runner);
+  this->collisionDetector.SetTaskRunner(this->taskRunner);
+}
+
+/////////////////////////////////////////////////
+const TaskRunner &World::GetTaskRunner() const
+{
+  return this->taskRunner;
+}
+
+/////////////////////////////////////////////////
+void World::SetMemoryResource(std::shared_ptr<MemoryResource> _resource)
+{
+  Entity::SetMemoryResource(std::move(_resource));
+}
+
+/////////////////////////////////////////////////
+void World::SetSleepSteps(std::size_t _sleepSteps)
+{
+  this->sleepSteps = _sleepSteps;
+  if (this->sleepSteps > 0u)
+    return;
+
+  for (auto &it : this->GetChildren())
+  {
+    if (auto *model = dynamic_cast<Model *>(it.second.get()))
+      model->Wake();
+  }
+}
+
+/////////////////////////////////////////////////
+std::size_t World::GetSleepSteps() const
+{
+  return this->sleepSteps;
+}
+
+/////////////////////////////////////////////////
+void World::SetOrientedBoundingBoxes(bool _enable)
+{
+  this->collisionDetector.SetOrientedBoundingBoxes(_enable);
+}
+
+/////////////////////////////////////////////////
+bool World::GetOrientedBoundingBoxes() const
+{
+  return this->collisionDetector.GetOrientedBoundingBoxes();
+}
+
+/////////////////////////////////////////////////
+void World::SetCollisionPairMaxContacts(std::size_t _maxContacts)
+{
+  this->collisionDetector.SetMaxContactsPerPair(_maxContacts);
+}
+
+/////////////////////////////////////////////////
+std::size_t World::GetCollisionPairMaxContacts() const
+{
+  return this->collisionDetector.GetMaxContactsPerPair();
+}
+
+/////////////////////////////////////////////////
+void World::SetShapeContacts(bool _enable)
+{
+  this->collisionDetector.SetShapeContacts(_enable);
+}
+
+/////////////////////////////////////////////////
+bool World::GetShapeContacts() const
+{
+  return this->collisionDetector.GetShapeContacts();
+}
+
+/////////////////////////////////////////////////
+void World::SetTreeRebuildFactor(double _factor)
+{
+  this->collisionDetector.SetTreeRebuildFactor(_factor);
+}
+
+/////////////////////////////////////////////////
+double World::GetTreeRebuildFactor() const
+{
+  return this->collisionDetector.GetTreeRebuildFactor();
+}
+
+/////////////////////////////////////////////////
+void World::SetSinglePrecisionTree(bool _enable)
+{
+  this->collisionDetector.SetSinglePrecisionTree(_enable);
+}
+
+/////////////////////////////////////////////////
+bool World::GetSinglePrecisionTree() const
+{
+  return this->collisionDetector.GetSinglePrecisionTree();
+}
+
+/////////////////////////////////////////////////
+void World::SetBroadphaseGridCellSize(double _cellSize)
+{
+  this->collisionDetector.SetBroadphaseGridCellSize(_cellSize);
+}
+
+/////////////////////////////////////////////////
+double World::GetBroadphaseGridCellSize() const
+{
+  return this->collisionDetector.GetBroadphaseGridCellSize();
+}
+
+/////////////////////////////////////////////////
+void World::SetModelStatistics(bool _enable)
+{
+  this->collisionDetector.SetEntityStatistics(_enable);
+}
+
+/////////////////////////////////////////////////
+bool World::GetModelStatistics() const
+{
+  return this->collisionDetector.GetEntityStatistics();
+}
+
+/////////////////////////////////////////////////
+void World::SetAllocationCounter(AllocationCounter _counter)
+{
+  this->collisionDetector.SetAllocationCounter(_counter);
+}
+
+/////////////////////////////////////////////////
+AllocationCounter World::GetAllocationCounter() const
+{
+  return this->collisionDetector.GetAllocationCounter();
+}
+
+/////////////////////////////////////////////////
+void World::SetCollisionInterval(std::size_t _steps)
+{
+  this->collisionInterval = _steps;
+}
+
+/////////////////////////////////////////////////
+std::size_t World::GetCollisionInterval() const
+{
+  return this->collisionInterval;
+}
+
+/////////////////////////////////////////////////
+void World::ChildrenChanged()
+{
+  this->stepTablesDirty = true;
+  Entity::ChildrenChanged();
+}
+
+/////////////////////////////////////////////////
+std::size_t World::GetStepModelCount() const
+{
+  return this->stepModels.size();
+}
+
+/////////////////////////////////////////////////
+const StepStatistics &World::GetStepStatistics() const
+{
+  return this->stepStatistics;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the size of a shape of a given type
+/// \param[in] _shape Shape to measure
+/// \return Bytes used by the shape, without a triangle hierarchy or the
+/// grid of a heightmap
+static std::size_t shapeBytes(const Shape &_shape)
+{
+  switch (_shape.GetType())
+  {
+    case ShapeType::BOX:
+      return sizeof(BoxShape);
+    case ShapeType::CAPSULE:
+      return sizeof(CapsuleShape);
+    case ShapeType::CYLINDER:
+      return sizeof(CylinderShape);
+    case ShapeType::ELLIPSOID:
+      return sizeof(EllipsoidShape);
+    case ShapeType::SPHERE:
+      return sizeof(SphereShape);
+    case ShapeType::MESH:
+      return sizeof(MeshShape);
+    case ShapeType::HEIGHTMAP:
+      return sizeof(HeightmapShape);
+    default:
+      return sizeof(Shape);
+  }
+}
+
+/////////////////////////////////////////////////
+MemoryUsage World::GetMemoryUsage() const
+{
+  MemoryUsage usage;
+  std::unordered_set<const TriangleBvh *> bvhs;
+  std::unordered_set<const float *> grids;
+  std::vector<const Entity *> entities;
+  for (const auto &child : this->GetChildren())
+    entities.push_back(child.second.get());
+
+  while (!entities.empty())
+  {
+    const Entity *entity = entities.back();
+    entities.pop_back();
+    usage.entityBytes += entity->GetMemoryBytes();
+    for (const auto &child : entity->GetChildren())
+      entities.push_back(child.second.get());
+
+    const auto *collision = dynamic_cast<const Collision *>(entity);
+    const Shape *shape = collision ? collision->GetShape() : nullptr;
+    if (nullptr == shape)
+      continue;
+
+    usage.geometryBytes += shapeBytes(*shape);
+    const auto *mesh = dynamic_cast<const MeshShape *>(shape);
+    const auto bvh = mesh ? mesh->GetTriangleBvh() : nullptr;
+    if (bvh && bvhs.insert(bvh.get()).second)
+      usage.geometryBytes += bvh->GetMemoryBytes();
+
+    // heightmaps share their grid with their copies, like meshes their
+    // triangle hierarchy
+    const auto *heightmap = dynamic_cast<const HeightmapShape *>(shape);
+    const auto grid = heightmap ? heightmap->GetHeights() : nullptr;
+    if (grid && grids.insert(grid.get()).second)
+    {
+      usage.geometryBytes +=
+          heightmap->GetWidth() * heightmap->GetDepth() * sizeof(float);
+    }
+  }
+
+  usage.solverBytes = this->collisionDetector.GetMemoryBytes() +
+      vectorBytes(this->contacts) + vectorBytes(this->nextContacts) +
+      vectorBytes(this->stepModels) + vectorBytes(this->stepModelParents) +
+      vectorBytes(this->stepTreeOffsets) + vectorBytes(this->stepLinkOffsets) +
+      vectorBytes(this->stepLinks) + vectorBytes(this->poseBatches) +
+      vectorBytes(this->poseBatchEntities);
+  for (std::size_t i = 0; i < this->poseBatches.size(); ++i)
+  {
+    usage.solverBytes += this->poseBatches[i].GetMemoryBytes() +
+        vectorBytes(this->poseBatchEntities[i]);
+  }
+  return usage;
+}
+
+/////////////////////////////////////////////////
+void World::UpdateStepTables()
+{
+  if (!this->stepTablesDirty)
+    return;
+
+  GZ_PROFILE("tpelib::World::UpdateStepTables");
   auto &children = this->GetChildren();
+  this->stepModels.clear();
+  this->stepModelParents.clear();
+  this->stepTreeOffsets.clear();
+  this->stepLinks.clear();
+  this->stepLinkOffsets.clear();
+  this->stepModels.reserve(children.size());
+  this->stepModelParents.reserve(children.size());
+  this->stepTreeOffsets.reserve(children.size() + 1u);
+  this->stepLinkOffsets.reserve(children.size() + 1u);
+
+  // the models are visited depth first with a stack of (model, index of
+  // its parent), so that Step goes through them in one linear pass. The
+  // children are pushed in reverse to keep the order of their ids.
+  std::vector<std::pair<Model *, std::size_t>> stack;
   for (auto it = children.begin(); it != children.end(); ++it)
   {
-    auto model = std::dynamic_pointer_cast<Model>(it->second);
-    model->UpdatePose(this->timeStep);
-    auto &ents = model->GetChildren();
-    for (auto linkIt = ents.begin(); linkIt != ents.end(); ++linkIt)
+    auto *root = dynamic_cast<Model *>(it->second.get());
+    if (!root)
+      continue;
+
+    this->stepTreeOffsets.push_back(this->stepModels.size());
+    stack.push_back({root, kNullEntityId});
+    while (!stack.empty())
     {
-      // if child of model is link
-      auto link = std::dynamic_pointer_cast<Link>(linkIt->second);
-      if (link)
+      auto [model, parent] = stack.back();
+      stack.pop_back();
+      const std::size_t index = this->stepModels.size();
+      this->stepModels.push_back(model);
+      this->stepModelParents.push_back(parent);
+      this->stepLinkOffsets.push_back(this->stepLinks.size());
+
+      auto &ents = model->GetChildren();
+      for (auto entIt = ents.rbegin(); entIt != ents.rend(); ++entIt)
       {
-        link->UpdatePose(this->timeStep);
+        if (auto *link = dynamic_cast<Link *>(entIt->second.get()))
+          this->stepLinks.push_back(link);
+        else if (auto *nested = dynamic_cast<Model *>(entIt->second.get()))
+          stack.push_back({nested, index});
       }
+      std::reverse(this->stepLinks.begin() + this->stepLinkOffsets.back(),
+          this->stepLinks.end());
     }
   }
+  this->stepTreeOffsets.push_back(this->stepModels.size());
+  this->stepLinkOffsets.push_back(this->stepLinks.size());
+  this->stepTablesDirty = false;
+}
 
-  // check colliisions
-  // the last bool arg tells the collision checker to return one single contact
-  // point for each pair of collisions
-  this->contacts = std::move(
-      this->collisionDetector.CheckCollisions(children, true));
+/////////////////////////////////////////////////
+void World::Step()
+{
+  GZ_PROFILE("tpelib::World::Step");
+  const auto start = std::chrono::steady_clock::now();
+  const AllocationCounter allocations =
+      this->collisionDetector.GetAllocationCounter();
+  const std::size_t startAllocations = allocations ? allocations() : 0u;
+  this->UpdateStepTables();
 
-  for (auto it = children.begin(); it != children.end(); ++it)
-    it->second->ResetPoseDirty();
+  std::size_t islandCount = 0u;
+  const std::size_t count = this->stepTreeOffsets.size() - 1u;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const Model *model = this->stepModels[this->stepTreeOffsets[i]];
+    if (!model->GetStatic() && !model->GetSleeping())
+      ++islandCount;
+  }
+
+  // apply updates to each model of the world, its nested models and their
+  // child links
+  const double dt = this->timeStep;
+  const std::size_t steps = this->sleepSteps;
+  const std::size_t chunks = (this->numThreads <= 1u || count < 2u) ?
+      1u : std::min(this->numThreads, count);
+  if (this->poseBatches.size() < chunks)
+  {
+    this->poseBatches.resize(chunks);
+    this->poseBatchEntities.resize(chunks);
+  }
+
+  // The velocities of the moving models and links of a chunk are gathered
+  // into a batch that is integrated in one pass, and the poses written back
+  // without virtual calls. Moving models are awake already, so the Wake of
+  // Model::SetPose is not needed.
+  const std::size_t step = this->stepCount++;
+  auto updatePoses = [this, dt, steps, step](std::size_t _chunk,
+      std::size_t _start, std::size_t _end)
+  {
+    PoseBatch &batch = this->poseBatches[_chunk];
+    std::vector<Entity *> &entities = this->poseBatchEntities[_chunk];
+    batch.Clear();
+    entities.clear();
+    for (std::size_t i = _start; i < _end; ++i)
+    {
+      const std::size_t treeStart = this->stepTreeOffsets[i];
+      const std::size_t treeEnd = this->stepTreeOffsets[i + 1u];
+      Model *root = this->stepModels[treeStart];
+      if (root->GetSleeping())
+        continue;
+
+      // models with a lower update rate skip steps, keeping their poses and
+      // bounding boxes, and integrate the time since their last update by
+      // scaling their velocities in the batch. Nested models follow the
+      // schedule of the model of the world they belong to.
+      double elapsed = dt;
+      if (!root->ScheduleUpdate(step, dt, elapsed))
+        continue;
+      const double scale = dt > 0.0 ? elapsed / dt : 1.0;
+
+      // the bounding boxes of the models above a moving nested model or
+      // link are invalidated up to, but not including, the world
+      auto invalidateFrom = [this](std::size_t _index)
+      {
+        for (std::size_t j = _index; j != kNullEntityId;
+             j = this->stepModelParents[j])
+        {
+          this->stepModels[j]->InvalidateBoundingBox();
+        }
+      };
+
+      bool atRest = true;
+      for (std::size_t m = treeStart; m < treeEnd; ++m)
+      {
+        Model *model = this->stepModels[m];
+
+        // models following a trajectory are batched with their next pose
+        // and no velocity, which leaves the pose as is
+        math::Pose3d trajectoryPose;
+        const bool following = model->FollowTrajectory(
+            this->time + dt - elapsed, elapsed, trajectoryPose);
+        const math::Vector3d linear = model->GetLinearVelocity();
+        const math::Vector3d angular = model->GetAngularVelocity();
+        const bool still = linear == math::Vector3d::Zero &&
+            angular == math::Vector3d::Zero;
+        atRest = atRest && still;
+        if (following)
+        {
+          batch.PushBack(trajectoryPose, math::Vector3d::Zero,
+              math::Vector3d::Zero);
+          entities.push_back(model);
+        }
+        else if (!still)
+        {
+          batch.PushBack(model->GetPose(), linear * scale, angular * scale);
+          entities.push_back(model);
+        }
+        if ((following || !still) && m != treeStart)
+          invalidateFrom(this->stepModelParents[m]);
+
+        bool linksMoved = false;
+        for (std::size_t l = this->stepLinkOffsets[m];
+             l < this->stepLinkOffsets[m + 1u]; ++l)
+        {
+          Link *link = this->stepLinks[l];
+          const math::Vector3d linkLinear = link->GetLinearVelocity();
+          const math::Vector3d linkAngular = link->GetAngularVelocity();
+          if (linkLinear == math::Vector3d::Zero &&
+              linkAngular == math::Vector3d::Zero)
+          {
+            continue;
+          }
+          batch.PushBack(link->GetPose(), linkLinear * scale,
+              linkAngular * scale);
+          entities.push_back(link);
+          linksMoved = true;
+          atRest = false;
+        }
+
+        if (linksMoved)
+          invalidateFrom(m);
+      }
+
+      if (steps > 0u)
+        root->UpdateSleeping(atRest, steps);
+    }
+
+    integratePoses(batch, dt);
+    for (std::size_t k = 0; k < entities.size(); ++k)
+      entities[k]->SetStepPose(batch.Pose(k));
+  };
+
+  if (chunks == 1u)
+  {
+    updatePoses(0u, 0u, count);
+  }
+  else
+  {
+    GZ_PROFILE("tpelib::World::Step::ParallelUpdatePose");
+    // Each model is updated by exactly one task and models do not share
+    // state, so the result does not depend on scheduling.
+    const std::size_t chunkSize = (count + chunks - 1u) / chunks;
+    runTasks(this->taskRunner, this->workerPool, this->workerPoolThreads,
+        this->numThreads, (count + chunkSize - 1u) / chunkSize,
+        [&updatePoses, chunkSize, count](std::size_t _chunk)
+        {
+          const std::size_t begin = _chunk * chunkSize;
+          updatePoses(_chunk, begin, std::min(begin + chunkSize, count));
+        });
+  }
+
+  // the bounding box of the world is invalidated once for all models,
+  // instead of by each of them from the worker threads
+  for (std::size_t chunk = 0u; chunk < chunks; ++chunk)
+  {
+    if (!this->poseBatchEntities[chunk].empty())
+    {
+      this->InvalidateBoundingBox();
+      break;
+    }
+  }
+
+  const auto integrationEnd = std::chrono::steady_clock::now();
+  const std::size_t integrationAllocations = allocations ?
+      allocations() - startAllocations : 0u;
+
+  // Models that moved while contacts were not checked keep their dirty
+  // flags, so the next check refits them.
+  ++this->stepsSinceCollisionCheck;
+  const bool checkCollisions = this->collisionInterval > 0u &&
+      this->stepsSinceCollisionCheck >= this->collisionInterval;
+  if (checkCollisions)
+    this->CheckCollisions();
 
   // increment world time by step size
   this->time += this->timeStep;
+
+  auto &stats = this->stepStatistics;
+  stats.integrationTime =
+      std::chrono::duration<double>(integrationEnd - start).count();
+  stats.collision = checkCollisions ?
+      this->collisionDetector.GetStatistics() : CollisionStatistics();
+  stats.contactCount = this->contacts.size();
+  stats.islandCount = islandCount;
+  stats.stepTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  stats.integrationAllocations = integrationAllocations;
+  stats.stepAllocations = allocations ? allocations() - startAllocations : 0u;
+}
+
+/////////////////////////////////////////////////
+void World::CastRays(const math::Vector3d *_from, const math::Vector3d *_to,
+    std::size_t _count, std::vector<RayHit> &_hits, std::size_t _numThreads)
+{
+  GZ_PROFILE("tpelib::World::CastRays");
+  _hits.resize(_count);
+  this->RunQueries(_count, _numThreads,
+      [&](std::size_t _begin, std::size_t _end)
+      {
+        for (std::size_t i = _begin; i < _end; ++i)
+          _hits[i] = this->collisionDetector.CastRay(_from[i], _to[i]);
+      });
+}
+
+/////////////////////////////////////////////////
+void World::CastVolumes(const QueryVolume *_volumes,
+    const math::Vector3d *_to, std::size_t _count,
+    std::vector<RayHit> &_hits, std::size_t _numThreads)
+{
+  GZ_PROFILE("tpelib::World::CastVolumes");
+  _hits.resize(_count);
+  this->RunQueries(_count, _numThreads,
+      [&](std::size_t _begin, std::size_t _end)
+      {
+        for (std::size_t i = _begin; i < _end; ++i)
+          _hits[i] = this->collisionDetector.CastVolume(_volumes[i], _to[i]);
+      });
+}
+
+/////////////////////////////////////////////////
+void World::FindOverlaps(const QueryVolume *_volumes, std::size_t _count,
+    std::vector<std::vector<std::size_t>> &_overlaps,
+    std::size_t _numThreads)
+{
+  GZ_PROFILE("tpelib::World::FindOverlaps");
+  _overlaps.resize(_count);
+  this->RunQueries(_count, _numThreads,
+      [&](std::size_t _begin, std::size_t _end)
+      {
+        for (std::size_t i = _begin; i < _end; ++i)
+        {
+          _overlaps[i].clear();
+          this->collisionDetector.Overlaps(_volumes[i], _overlaps[i]);
+        }
+      });
+}
+
+/////////////////////////////////////////////////
+void World::RunQueries(std::size_t _count, std::size_t _numThreads,
+    const std::function<void(std::size_t, std::size_t)> &_query)
+{
+  if (_count == 0u)
+    return;
+
+  this->collisionDetector.PrepareQueries(this->GetChildren());
+
+  if (_numThreads <= 1u || _count < 2u)
+  {
+    _query(0u, _count);
+    return;
+  }
+
+  // Each query only reads the detector and writes its own result.
+  const std::size_t chunks = std::min(_numThreads, _count);
+  const std::size_t chunkSize = (_count + chunks - 1u) / chunks;
+  runTasks(this->taskRunner, this->queryWorkerPool,
+      this->queryWorkerPoolThreads, _numThreads,
+      (_count + chunkSize - 1u) / chunkSize,
+      [&_query, chunkSize, _count](std::size_t _chunk)
+      {
+        const std::size_t start = _chunk * chunkSize;
+        _query(start, std::min(start + chunkSize, _count));
+      });
+}
+
+/////////////////////////////////////////////////
+void World::CheckCollisions()
+{
+  GZ_PROFILE("tpelib::World::CheckCollisions");
+  auto &children = this->GetChildren();
+  this->UpdateStepTables();
+
+  // the number of contacts of each pair is limited by the maximum of the
+  // detector, which gives a single contact at the center by default
+  this->collisionDetector.CheckCollisions(
+      children, this->nextContacts, false);
+  this->contacts.swap(this->nextContacts);
+  this->stepsSinceCollisionCheck = 0u;
+
+  // wake sleeping models that an awake model ran into. They are picked up
+  // from the next step on.
+  if (this->sleepSteps > 0u)
+  {
+    for (const auto &contact : this->contacts)
+    {
+      const auto it1 = children.find(contact.entity1);
+      const auto it2 = children.find(contact.entity2);
+      if (it1 == children.end() || it2 == children.end())
+        continue;
+
+      Entity *e1 = it1->second.get();
+      Entity *e2 = it2->second.get();
+      if (e1->GetSleeping() == e2->GetSleeping())
+        continue;
+
+      Entity *sleeping = e1->GetSleeping() ? e1 : e2;
+      Entity *awake = e1->GetSleeping() ? e2 : e1;
+      if (awake->GetStatic() || sleeping->GetStatic())
+        continue;
+      if (auto *model = dynamic_cast<Model *>(sleeping))
+        model->Wake();
+    }
+  }
+
+  for (auto *model : this->stepModels)
+    model->ResetPoseDirty();
+  for (auto *link : this->stepLinks)
+    link->ResetPoseDirty();
 }
 
 /////////////////////////////////////////////////
@@ -98,7 +700,9 @@ Entity &World::AddModel()
 {
   std::size_t modelId = Entity::GetNextId();
   const auto[it, success] = this->GetChildren().insert(
-    {modelId, std::make_shared<Model>(modelId)});
+    {modelId, MakeShared<Model>(this->GetMemoryResource(), modelId)});
+  it->second->SetParent(this);
+  this->ChildrenChanged();
   return *it->second;
 }
 
@@ -107,3 +711,9 @@ std::vector<Contact> World::GetContacts() const
 {
   return this->contacts;
 }
+
+/////////////////////////////////////////////////
+const std::vector<Contact> &World::GetContactsRef() const
+{
+  return this->contacts;
+}
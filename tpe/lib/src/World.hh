@@ -18,20 +18,68 @@
 #ifndef GZ_PHYSICS_TPE_LIB_SRC_WORLD_HH_
 #define GZ_PHYSICS_TPE_LIB_SRC_WORLD_HH_
 
+#include <functional>
+#include <memory>
 #include <vector>
+
+#include <gz/common/WorkerPool.hh>
 #include <gz/utils/SuppressWarning.hh>
 
 #include "gz/physics/tpelib/Export.hh"
 
 #include "CollisionDetector.hh"
 #include "Entity.hh"
+#include "Utils.hh"
 
 namespace gz {
 namespace physics {
 namespace tpelib {
 
+class Link;
 class Model;
 
+/// \brief Counters and timings of a call to World::Step
+class GZ_PHYSICS_TPELIB_VISIBLE StepStatistics
+{
+  /// \brief Time of the whole step, in seconds
+  public: double stepTime = 0.0;
+
+  /// \brief Time spent integrating the poses of models and links, in seconds
+  public: double integrationTime = 0.0;
+
+  /// \brief Heap allocations of the whole step, see
+  /// World::SetAllocationCounter. 0 without a counter.
+  public: std::size_t stepAllocations = 0u;
+
+  /// \brief Heap allocations of integrating the poses of models and links.
+  /// 0 without a counter.
+  public: std::size_t integrationAllocations = 0u;
+
+  /// \brief Counters and timings of the collision check of the step
+  public: CollisionStatistics collision;
+
+  /// \brief Number of contacts found
+  public: std::size_t contactCount = 0u;
+
+  /// \brief Number of models that are neither static nor sleeping. Models
+  /// do not interact with each other, so each of them is its own island.
+  public: std::size_t islandCount = 0u;
+};
+
+/// \brief Estimated memory used by a world, in bytes
+class GZ_PHYSICS_TPELIB_VISIBLE MemoryUsage
+{
+  /// \brief Collision shapes and the triangle hierarchies of meshes. A
+  /// hierarchy shared by several shapes is counted once.
+  public: std::size_t geometryBytes = 0u;
+
+  /// \brief Models, links and collisions
+  public: std::size_t entityBytes = 0u;
+
+  /// \brief The collision detector, contact buffers and step tables
+  public: std::size_t solverBytes = 0u;
+};
+
 /// \brief World Class
 class GZ_PHYSICS_TPELIB_VISIBLE World : public Entity
 {
@@ -57,9 +105,197 @@ class GZ_PHYSICS_TPELIB_VISIBLE World : public Entity
   /// \return double current timestep of the world
   public: double GetTimeStep() const;
 
+  /// \brief Set the number of threads used to integrate model poses in
+  /// Step(). Models are partitioned into contiguous chunks, one per thread.
+  /// A value of 0 or 1 (default) integrates all models serially in the
+  /// calling thread. The resulting poses are identical in both modes. The
+  /// narrowphase of collision checks uses the same number of threads, see
+  /// CollisionDetector::SetNumThreads.
+  /// \param[in] _numThreads Number of threads to use
+  public: void SetNumThreads(std::size_t _numThreads);
+
+  /// \brief Get the number of threads used to integrate model poses
+  /// \return Number of threads
+  public: std::size_t GetNumThreads() const;
+
+  /// \brief Set the task runner that runs the parallel work of Step(),
+  /// its collision check, and of CastRays, CastVolumes and FindOverlaps.
+  /// The work is split as without a runner, so the results do not change.
+  /// \param[in] _runner Task runner, or an empty function (default) for
+  /// the world to run the work on worker pools of its own.
+  public: void SetTaskRunner(TaskRunner _runner);
+
+  /// \brief Get the task runner of the world
+  /// \return Task runner, empty if the world uses worker pools of its own
+  public: const TaskRunner &GetTaskRunner() const;
+
+  /// \brief Set the memory resource that the models, links and collisions
+  /// added to the world afterwards are allocated from. Entities keep the
+  /// resource alive while they exist.
+  /// \param[in] _resource Resource, or nullptr (default) for the global
+  /// heap.
+  public: void SetMemoryResource(std::shared_ptr<MemoryResource> _resource);
+
+  /// \brief Set the number of consecutive steps after which a model whose
+  /// velocity and link velocities are zero falls asleep. Sleeping models are
+  /// not integrated, and are not collided against other sleeping or static
+  /// models. A model wakes up when its pose or a non zero velocity is set,
+  /// or when it is in contact with an awake model.
+  /// \param[in] _sleepSteps Number of steps, 0 (default) disables sleeping
+  public: void SetSleepSteps(std::size_t _sleepSteps);
+
+  /// \brief Get the number of consecutive steps at rest after which a model
+  /// falls asleep
+  /// \return Number of steps, 0 if sleeping is disabled
+  public: std::size_t GetSleepSteps() const;
+
+  /// \brief Set whether collisions are checked against their oriented
+  /// bounding boxes. See CollisionDetector::SetOrientedBoundingBoxes.
+  /// \param[in] _enable True to enable oriented bounding boxes
+  public: void SetOrientedBoundingBoxes(bool _enable);
+
+  /// \brief Get whether collisions are checked against their oriented
+  /// bounding boxes
+  /// \return True if oriented bounding boxes are enabled
+  public: bool GetOrientedBoundingBoxes() const;
+
+  /// \brief Set the maximum number of contacts of a pair of models, or of
+  /// collisions with shape contacts. See
+  /// CollisionDetector::SetMaxContactsPerPair.
+  /// \param[in] _maxContacts Maximum number of contacts per pair. 1
+  /// (default) creates a contact at the center of the region where a pair
+  /// intersects, larger values up to its 8 corners.
+  public: void SetCollisionPairMaxContacts(std::size_t _maxContacts);
+
+  /// \brief Get the maximum number of contacts of a pair
+  /// \return Maximum number of contacts per pair
+  public: std::size_t GetCollisionPairMaxContacts() const;
+
+  /// \brief Set whether contacts are created between collisions rather
+  /// than between models. See CollisionDetector::SetShapeContacts.
+  /// \param[in] _enable True to create contacts between collisions
+  public: void SetShapeContacts(bool _enable);
+
+  /// \brief Get whether contacts are created between collisions
+  /// \return True if shape contacts are enabled
+  public: bool GetShapeContacts() const;
+
+  /// \brief Set when the AABB tree of the collision detector is rebuilt.
+  /// See CollisionDetector::SetTreeRebuildFactor.
+  /// \param[in] _factor Factor larger than 1, or 0 (default) to disable
+  /// rebuilding
+  public: void SetTreeRebuildFactor(double _factor);
+
+  /// \brief Get when the AABB tree of the collision detector is rebuilt
+  /// \return Factor, 0 if rebuilding is disabled
+  public: double GetTreeRebuildFactor() const;
+
+  /// \brief Set whether the AABB tree of the collision detector stores its
+  /// boxes as float. See CollisionDetector::SetSinglePrecisionTree.
+  /// \param[in] _enable True to store the boxes as float, false (default)
+  /// to store them as double
+  public: void SetSinglePrecisionTree(bool _enable);
+
+  /// \brief Get whether the AABB tree of the collision detector stores its
+  /// boxes as float
+  /// \return True if the boxes are stored as float
+  public: bool GetSinglePrecisionTree() const;
+
+  /// \brief Set whether the collision detector keeps the boxes of the
+  /// collisions in a uniform grid instead of an AABB tree. See
+  /// CollisionDetector::SetBroadphaseGridCellSize.
+  /// \param[in] _cellSize Edge length of the cells, 0 (default) to use the
+  /// tree
+  public: void SetBroadphaseGridCellSize(double _cellSize);
+
+  /// \brief Get the edge length of the cells of the broadphase grid of the
+  /// collision detector
+  /// \return Cell size, 0 if the collision detector uses the tree
+  public: double GetBroadphaseGridCellSize() const;
+
+  /// \brief Set whether the collision detector collects counters and
+  /// timings of each model, which are reported in
+  /// StepStatistics::collision. See CollisionDetector::SetEntityStatistics.
+  /// \param[in] _enable True to collect the statistics of each model,
+  /// false (default) to not collect them
+  public: void SetModelStatistics(bool _enable);
+
+  /// \brief Get whether the collision detector collects counters and
+  /// timings of each model
+  /// \return True if the statistics of each model are collected
+  public: bool GetModelStatistics() const;
+
+  /// \brief Set the function that Step() uses to count the heap
+  /// allocations of its phases, which are reported in StepStatistics. The
+  /// collision detector uses it too, see
+  /// CollisionDetector::SetAllocationCounter.
+  /// \param[in] _counter Allocation counter, nullptr (default) to not count
+  /// allocations
+  public: void SetAllocationCounter(AllocationCounter _counter);
+
+  /// \brief Get the function that counts heap allocations
+  /// \return Allocation counter, nullptr if allocations are not counted
+  public: AllocationCounter GetAllocationCounter() const;
+
+  /// \brief Set how often Step() detects contacts. Kinematic simulations
+  /// that only need contacts now and then can check them every few steps,
+  /// or only when CheckCollisions() is called. Between checks the contacts
+  /// of the last check are kept, and the collision detector is not updated.
+  /// \param[in] _steps Detect contacts every _steps steps. 1 (default)
+  /// detects them on every step, 0 only when CheckCollisions() is called.
+  public: void SetCollisionInterval(std::size_t _steps);
+
+  /// \brief Get how often Step() detects contacts
+  /// \return Number of steps between checks, 0 if contacts are only
+  /// detected on demand
+  public: std::size_t GetCollisionInterval() const;
+
+  /// \brief Detect contacts between the models at their current poses,
+  /// replacing the contacts of the last check. Step() calls this according
+  /// to the collision interval.
+  public: void CheckCollisions();
+
   /// \brief Step forward at a constant timestep
   public: void Step();
 
+  /// \brief Cast rays against the collisions of the models at their
+  /// current poses, see CollisionDetector::CastRay.
+  /// \param[in] _from Start of each ray in world frame
+  /// \param[in] _to End of each ray in world frame
+  /// \param[in] _count Number of rays
+  /// \param[out] _hits Closest hit of each ray. The vector is resized to
+  /// _count.
+  /// \param[in] _numThreads Number of threads to cast the rays with. 0 or 1
+  /// casts them in the calling thread. The hits do not depend on it.
+  public: void CastRays(const math::Vector3d *_from,
+      const math::Vector3d *_to, std::size_t _count,
+      std::vector<RayHit> &_hits, std::size_t _numThreads = 1u);
+
+  /// \brief Sweep volumes against the collisions of the models at their
+  /// current poses, see CollisionDetector::CastVolume.
+  /// \param[in] _volumes Volumes at the start of their sweep
+  /// \param[in] _to End of the sweep of each volume in world frame
+  /// \param[in] _count Number of volumes
+  /// \param[out] _hits Closest hit of each sweep. The vector is resized to
+  /// _count.
+  /// \param[in] _numThreads Number of threads to sweep the volumes with, as
+  /// in CastRays.
+  public: void CastVolumes(const QueryVolume *_volumes,
+      const math::Vector3d *_to, std::size_t _count,
+      std::vector<RayHit> &_hits, std::size_t _numThreads = 1u);
+
+  /// \brief Find the collisions of the models at their current poses that
+  /// overlap volumes, see CollisionDetector::Overlaps.
+  /// \param[in] _volumes Volumes to test
+  /// \param[in] _count Number of volumes
+  /// \param[out] _overlaps Ids of the collisions overlapping each volume.
+  /// The vector is resized to _count.
+  /// \param[in] _numThreads Number of threads to test the volumes with, as
+  /// in CastRays.
+  public: void FindOverlaps(const QueryVolume *_volumes, std::size_t _count,
+      std::vector<std::vector<std::size_t>> &_overlaps,
+      std::size_t _numThreads = 1u);
+
   /// \brief Add a model to this world
   /// \return Model added to the world
   public: Entity &AddModel();
@@ -68,18 +304,132 @@ class GZ_PHYSICS_TPELIB_VISIBLE World : public Entity
   /// \return Contacts from last step
   public: std::vector<Contact> GetContacts() const;
 
+  /// \brief Get a const reference to the contacts from last step. Contacts
+  /// are double buffered: the reference stays valid and its contents are
+  /// unchanged until the end of the next call to Step(), and reading it does
+  /// not copy or allocate.
+  /// \return Contacts from last step
+  public: const std::vector<Contact> &GetContactsRef() const;
+
+  /// \brief Mark the dense step tables as out of date so they are rebuilt
+  /// at the start of the next step.
+  public: void ChildrenChanged() override;
+
+  /// \brief Get the number of entries in the dense model table used by
+  /// Step(), nested models included. The table is rebuilt before each step
+  /// if the world structure changed.
+  /// \return Number of models in the step table
+  public: std::size_t GetStepModelCount() const;
+
+  /// \brief Get counters and timings of the last step. They are collected
+  /// on every step, independent of the profiler.
+  /// \return Statistics of the last step
+  public: const StepStatistics &GetStepStatistics() const;
+
+  /// \brief Estimate the memory used by this world and its entities
+  /// \return Bytes used, per category
+  public: MemoryUsage GetMemoryUsage() const;
+
+  /// \brief Rebuild the dense model and link tables if needed
+  private: void UpdateStepTables();
+
+  /// \brief Prepare the collision detector for queries and run them,
+  /// possibly on taskRunner or queryWorkerPool
+  /// \param[in] _count Number of queries
+  /// \param[in] _numThreads Number of threads, 0 or 1 for the calling
+  /// thread
+  /// \param[in] _query Runs the queries of a range [_begin, _end). Ranges
+  /// run concurrently, so it must only write the results of its range.
+  private: void RunQueries(std::size_t _count, std::size_t _numThreads,
+      const std::function<void(std::size_t, std::size_t)> &_query);
+
   /// \brief World time
   protected: double time{0.0};
 
   /// \brief Time step size
   protected: double timeStep{0.1};
 
+  /// \brief Number of threads used to integrate model poses
+  protected: std::size_t numThreads{1u};
+
+  /// \brief Number of steps at rest after which a model sleeps, 0 to
+  /// disable sleeping
+  protected: std::size_t sleepSteps{0u};
+
+  /// \brief Number of steps between contact checks, 0 to only check on
+  /// demand
+  protected: std::size_t collisionInterval{1u};
+
+  /// \brief Number of steps since contacts were last checked
+  protected: std::size_t stepsSinceCollisionCheck{0u};
+
+  /// \brief Number of steps taken, which schedules the updates of models
+  /// with an update rate
+  protected: std::size_t stepCount{0u};
+
   /// \brief Collision detector
   protected: CollisionDetector collisionDetector;
 
   GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
   /// \brief list of contacts
   protected: std::vector<Contact> contacts;
+
+  /// \brief Back buffer that contacts are written to during a step before
+  /// being swapped with contacts. Both buffers keep their capacity.
+  protected: std::vector<Contact> nextContacts;
+
+  /// \brief Counters and timings of the last step
+  protected: StepStatistics stepStatistics;
+
+  /// \brief Flag to indicate that the step tables need to be rebuilt
+  protected: bool stepTablesDirty{true};
+
+  /// \brief Models to integrate, indexed by dense model handle. Each model
+  /// of the world is followed by its nested models, depth first, so parents
+  /// come before their children.
+  protected: std::vector<Model *> stepModels;
+
+  /// \brief Index in stepModels of the parent of each model, or
+  /// kNullEntityId for models of the world.
+  protected: std::vector<std::size_t> stepModelParents;
+
+  /// \brief Offsets into stepModels for each model of the world. Model i of
+  /// the world and its nested models are stored in
+  /// [stepTreeOffsets[i], stepTreeOffsets[i+1]).
+  protected: std::vector<std::size_t> stepTreeOffsets;
+
+  /// \brief Offsets into stepLinks for each model. The links of model i
+  /// are stored in [stepLinkOffsets[i], stepLinkOffsets[i+1]).
+  protected: std::vector<std::size_t> stepLinkOffsets;
+
+  /// \brief Child links of all models stored contiguously
+  protected: std::vector<Link *> stepLinks;
+
+  /// \brief Poses and velocities of the moving models and links of each
+  /// chunk of the step, integrated in one pass
+  protected: std::vector<PoseBatch> poseBatches;
+
+  /// \brief Entities of the entries of each of poseBatches
+  protected: std::vector<std::vector<Entity *>> poseBatchEntities;
+
+  /// \brief Runs the parallel work of the world, see SetTaskRunner
+  protected: TaskRunner taskRunner;
+
+  /// \brief Worker pool used when numThreads is greater than 1 and there is
+  /// no task runner. Created lazily on the first parallel step, and
+  /// recreated when the number of threads changes.
+  protected: std::unique_ptr<common::WorkerPool> workerPool;
+
+  /// \brief Number of threads of workerPool
+  protected: std::size_t workerPoolThreads{0u};
+
+  /// \brief Worker pool of CastRays, CastVolumes and FindOverlaps. Created
+  /// lazily on the first parallel call, and recreated when the number of
+  /// threads changes.
+  protected: std::unique_ptr<common::WorkerPool> queryWorkerPool;
+
+  /// \brief Number of threads of queryWorkerPool
+  protected: std::size_t queryWorkerPoolThreads{0u};
   GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
 };
 
@@ -17,13 +17,58 @@
 
 #include <gtest/gtest.h>
 
-#include "World.hh"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "Collision.hh"
+#include "Link.hh"
 #include "Model.hh"
+#include "Shape.hh"
+#include "Trajectory.hh"
+#include "World.hh"
 
 using namespace gz;
 using namespace physics;
 using namespace tpelib;
 
+/// \brief Number of allocations made through operator new, for
+/// World.SteadyStateAllocations
+static std::atomic<std::size_t> gAllocations{0u};
+
+/////////////////////////////////////////////////
+void *operator new(std::size_t _size)
+{
+  ++gAllocations;
+  if (void *ptr = std::malloc(_size > 0u ? _size : 1u))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr) noexcept
+{
+  std::free(_ptr);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_ptr, std::size_t) noexcept
+{
+  std::free(_ptr);
+}
+
+/////////////////////////////////////////////////
+static std::size_t allocationCount()
+{
+  return gAllocations;
+}
+
 /////////////////////////////////////////////////
 TEST(World, BasicAPI)
 {
@@ -91,3 +136,901 @@ TEST(World, Model)
   Entity nullEnt = world.GetChildById(modelId);
   EXPECT_EQ(Entity::kNullEntity.GetId(), nullEnt.GetId());
 }
+
+/////////////////////////////////////////////////
+TEST(World, IdSpaces)
+{
+  // worlds built in parallel allocate ids from their own spaces, so the
+  // ids are unique across worlds and dense within each of them
+  constexpr std::size_t kWorlds = 4u;
+  constexpr std::size_t kModels = 100u;
+  std::vector<std::unique_ptr<World>> worlds(kWorlds);
+  std::vector<std::vector<std::size_t>> ids(kWorlds);
+  std::vector<std::thread> threads;
+  for (std::size_t w = 0; w < kWorlds; ++w)
+  {
+    threads.emplace_back([&worlds, &ids, w]()
+    {
+      worlds[w] = std::make_unique<World>();
+      for (std::size_t m = 0; m < kModels; ++m)
+      {
+        Entity &model = worlds[w]->AddModel();
+        Entity &link = static_cast<Model &>(model).AddLink();
+        Entity &collision = static_cast<Link &>(link).AddCollision();
+        ids[w].push_back(model.GetId());
+        ids[w].push_back(link.GetId());
+        ids[w].push_back(collision.GetId());
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  std::vector<std::size_t> all;
+  for (std::size_t w = 0; w < kWorlds; ++w)
+  {
+    EXPECT_EQ(0u, Entity::GetLocalIndex(worlds[w]->GetId()));
+    for (std::size_t i = 0; i < ids[w].size(); ++i)
+    {
+      EXPECT_EQ(i + 1u, Entity::GetLocalIndex(ids[w][i]));
+      EXPECT_EQ(worlds[w]->GetId(), ids[w][i] - (i + 1u));
+    }
+    all.insert(all.end(), ids[w].begin(), ids[w].end());
+  }
+  std::sort(all.begin(), all.end());
+  EXPECT_EQ(all.end(), std::adjacent_find(all.begin(), all.end()));
+
+  // contacts report the full ids of the colliding models
+  World &world = *worlds[0];
+  for (std::size_t i = 0; i < 2u; ++i)
+  {
+    Link &link = static_cast<Link &>(
+        static_cast<Model &>(world.GetChildById(ids[0][i * 3u])).
+        GetCanonicalLink());
+    Collision &collision = static_cast<Collision &>(
+        link.GetChildById(ids[0][i * 3u + 2u]));
+    BoxShape shape;
+    shape.SetSize(math::Vector3d::One);
+    collision.SetShape(shape);
+  }
+  world.Step();
+  const std::vector<Contact> &contacts = world.GetContactsRef();
+  ASSERT_EQ(1u, contacts.size());
+  const Contact &contact = contacts[0];
+  EXPECT_EQ(std::min(ids[0][0], ids[0][3]),
+      std::min(contact.entity1, contact.entity2));
+  EXPECT_EQ(std::max(ids[0][0], ids[0][3]),
+      std::max(contact.entity1, contact.entity2));
+}
+
+/////////////////////////////////////////////////
+TEST(World, ParallelStep)
+{
+  // Build identical worlds and step one serially, one in parallel, and one
+  // on a task runner that runs the tasks in reverse order
+  World serialWorld;
+  World parallelWorld;
+  World runnerWorld;
+  EXPECT_EQ(1u, parallelWorld.GetNumThreads());
+  parallelWorld.SetNumThreads(4u);
+  EXPECT_EQ(4u, parallelWorld.GetNumThreads());
+
+  std::size_t runnerTasks = 0u;
+  EXPECT_FALSE(runnerWorld.GetTaskRunner());
+  runnerWorld.SetNumThreads(4u);
+  runnerWorld.SetTaskRunner(
+      [&runnerTasks](std::size_t _count,
+                     const std::function<void(std::size_t)> &_task)
+      {
+        runnerTasks += _count;
+        for (std::size_t i = _count; i > 0u; --i)
+          _task(i - 1u);
+      });
+  EXPECT_TRUE(runnerWorld.GetTaskRunner());
+
+  const std::size_t modelCount = 50u;
+  for (World *world : {&serialWorld, &parallelWorld, &runnerWorld})
+  {
+    world->SetTimeStep(0.01);
+    for (std::size_t i = 0; i < modelCount; ++i)
+    {
+      auto *model = static_cast<Model *>(&world->AddModel());
+      model->SetPose(math::Pose3d(static_cast<double>(i), 0, 0, 0, 0, 0));
+      model->SetLinearVelocity(math::Vector3d(0.1 * i, 0, 0.5));
+      model->SetAngularVelocity(math::Vector3d(0, 0, 0.01 * i));
+      auto *link = static_cast<Link *>(&model->AddLink());
+      link->SetLinearVelocity(math::Vector3d(0, 0.2, 0));
+    }
+  }
+
+  for (int i = 0; i < 10; ++i)
+  {
+    serialWorld.Step();
+    parallelWorld.Step();
+    runnerWorld.Step();
+  }
+  EXPECT_NEAR(serialWorld.GetTime(), parallelWorld.GetTime(), 1e-9);
+  EXPECT_EQ(40u, runnerTasks);
+
+  ASSERT_EQ(modelCount, serialWorld.GetChildCount());
+  ASSERT_EQ(modelCount, parallelWorld.GetChildCount());
+  for (unsigned int i = 0; i < modelCount; ++i)
+  {
+    Entity &serialModel = serialWorld.GetChildByIndex(i);
+    Entity &parallelModel = parallelWorld.GetChildByIndex(i);
+    EXPECT_EQ(serialModel.GetPose(), parallelModel.GetPose());
+    EXPECT_EQ(serialModel.GetChildByIndex(0u).GetPose(),
+              parallelModel.GetChildByIndex(0u).GetPose());
+    EXPECT_EQ(serialModel.GetPose(),
+              runnerWorld.GetChildByIndex(i).GetPose());
+  }
+
+  // setting 0 threads falls back to the serial path
+  parallelWorld.SetNumThreads(0u);
+  EXPECT_EQ(1u, parallelWorld.GetNumThreads());
+}
+
+/////////////////////////////////////////////////
+TEST(World, StepTables)
+{
+  World world;
+  EXPECT_EQ(0u, world.GetStepModelCount());
+
+  auto *model = static_cast<Model *>(&world.AddModel());
+  model->SetLinearVelocity(math::Vector3d(1, 0, 0));
+  auto *link = static_cast<Link *>(&model->AddLink());
+  link->SetLinearVelocity(math::Vector3d(0, 1, 0));
+  EXPECT_EQ(&world, model->GetParent());
+
+  world.SetTimeStep(0.5);
+  world.Step();
+  EXPECT_EQ(1u, world.GetStepModelCount());
+  EXPECT_EQ(math::Pose3d(0.5, 0, 0, 0, 0, 0), model->GetPose());
+  EXPECT_EQ(math::Pose3d(0, 0.5, 0, 0, 0, 0), link->GetPose());
+  EXPECT_FALSE(model->PoseDirty());
+  EXPECT_FALSE(link->PoseDirty());
+
+  // a link added after the first step is picked up by the next step
+  auto *link2 = static_cast<Link *>(&model->AddLink());
+  link2->SetLinearVelocity(math::Vector3d(0, 0, 1));
+  world.Step();
+  EXPECT_EQ(math::Pose3d(0, 0, 0.5, 0, 0, 0), link2->GetPose());
+
+  // add and remove models
+  Entity &model2 = world.AddModel();
+  world.Step();
+  EXPECT_EQ(2u, world.GetStepModelCount());
+
+  EXPECT_TRUE(world.RemoveChildById(model2.GetId()));
+  world.Step();
+  EXPECT_EQ(1u, world.GetStepModelCount());
+  EXPECT_EQ(math::Pose3d(2.0, 0, 0, 0, 0, 0), model->GetPose());
+}
+
+/////////////////////////////////////////////////
+TEST(World, NestedStepTables)
+{
+  World world;
+  world.SetTimeStep(0.5);
+
+  // a model with a nested model, which has a nested model of its own
+  auto *model = static_cast<Model *>(&world.AddModel());
+  auto *nested = static_cast<Model *>(&model->AddModel());
+  auto *nestedLink = static_cast<Link *>(&nested->AddLink());
+  auto *inner = static_cast<Model *>(&nested->AddModel());
+  auto *innerLink = static_cast<Link *>(&inner->AddLink());
+  auto &collision =
+      static_cast<Collision &>(innerLink->AddCollision());
+  BoxShape box;
+  box.SetSize(math::Vector3d::One);
+  collision.SetShape(box);
+
+  // nested models and their links are integrated in their parent frames
+  nested->SetLinearVelocity(math::Vector3d(1, 0, 0));
+  nestedLink->SetLinearVelocity(math::Vector3d(0, 1, 0));
+  inner->SetLinearVelocity(math::Vector3d(0, 0, 1));
+  EXPECT_EQ(math::AxisAlignedBox(math::Vector3d(-0.5, -0.5, -0.5),
+      math::Vector3d(0.5, 0.5, 0.5)), model->GetBoundingBox());
+
+  world.Step();
+  EXPECT_EQ(3u, world.GetStepModelCount());
+  EXPECT_EQ(1u, world.GetStepStatistics().islandCount);
+  EXPECT_EQ(math::Pose3d::Zero, model->GetPose());
+  EXPECT_EQ(math::Pose3d(0.5, 0, 0, 0, 0, 0), nested->GetPose());
+  EXPECT_EQ(math::Pose3d(0, 0.5, 0, 0, 0, 0), nestedLink->GetPose());
+  EXPECT_EQ(math::Pose3d(0, 0, 0.5, 0, 0, 0), inner->GetPose());
+
+  // the bounding boxes above the moving models follow them
+  EXPECT_EQ(math::AxisAlignedBox(math::Vector3d(0, -0.5, 0),
+      math::Vector3d(1, 0.5, 1)), model->GetBoundingBox());
+
+  // removing a nested model removes it from the step
+  EXPECT_TRUE(nested->RemoveChildById(inner->GetId()));
+  world.Step();
+  EXPECT_EQ(2u, world.GetStepModelCount());
+  EXPECT_EQ(math::Pose3d(1.0, 0, 0, 0, 0, 0), nested->GetPose());
+}
+
+/////////////////////////////////////////////////
+TEST(World, ContactsBuffer)
+{
+  World world;
+  world.SetTimeStep(0.1);
+
+  // two overlapping boxes
+  for (int i = 0; i < 2; ++i)
+  {
+    auto *model = static_cast<Model *>(&world.AddModel());
+    model->SetPose(math::Pose3d(0.5 * i, 0, 0, 0, 0, 0));
+    auto *link = static_cast<Link *>(&model->AddLink());
+    auto *collision = static_cast<Collision *>(&link->AddCollision());
+    BoxShape shape;
+    shape.SetSize(math::Vector3d::One);
+    collision->SetShape(shape);
+  }
+
+  const std::vector<Contact> &contacts = world.GetContactsRef();
+  EXPECT_TRUE(contacts.empty());
+
+  world.Step();
+  ASSERT_EQ(1u, contacts.size());
+  EXPECT_EQ(math::Vector3d(0.25, 0, 0), contacts[0].point);
+  EXPECT_EQ(world.GetContacts().size(), contacts.size());
+
+  // the two contact buffers alternate between steps and their capacity is
+  // reused, so every other step returns the same storage
+  world.Step();
+  const Contact *data = world.GetContactsRef().data();
+  world.Step();
+  world.Step();
+  ASSERT_EQ(1u, world.GetContactsRef().size());
+  EXPECT_EQ(data, world.GetContactsRef().data());
+}
+
+/////////////////////////////////////////////////
+TEST(World, Sleeping)
+{
+  World world;
+  world.SetTimeStep(0.1);
+  EXPECT_EQ(0u, world.GetSleepSteps());
+  world.SetSleepSteps(3u);
+  EXPECT_EQ(3u, world.GetSleepSteps());
+
+  // two boxes side by side, one of them with a moving link
+  auto addBox = [&world](double _x) -> Model *
+  {
+    Model *model = static_cast<Model *>(&world.AddModel());
+    Link *link = static_cast<Link *>(&model->AddLink());
+    Collision *collision = static_cast<Collision *>(&link->AddCollision());
+    BoxShape boxShape;
+    boxShape.SetSize(math::Vector3d(1, 1, 1));
+    collision->SetShape(boxShape);
+    model->SetPose(math::Pose3d(_x, 0, 0, 0, 0, 0));
+    return model;
+  };
+  Model *modelA = addBox(0);
+  Model *modelB = addBox(5);
+  Link *linkB = static_cast<Link *>(&modelB->GetCanonicalLink());
+  linkB->SetLinearVelocity(math::Vector3d(0, 0, 1));
+
+  // model A falls asleep after 3 steps at rest, model B keeps moving
+  for (int i = 0; i < 2; ++i)
+  {
+    world.Step();
+    EXPECT_FALSE(modelA->GetSleeping());
+  }
+  world.Step();
+  EXPECT_TRUE(modelA->GetSleeping());
+  EXPECT_FALSE(modelB->GetSleeping());
+
+  // setting a zero velocity does not wake it up
+  modelA->SetLinearVelocity(math::Vector3d::Zero);
+  EXPECT_TRUE(modelA->GetSleeping());
+
+  // setting a velocity wakes it up
+  modelA->SetLinearVelocity(math::Vector3d(1, 0, 0));
+  EXPECT_FALSE(modelA->GetSleeping());
+  world.Step();
+  EXPECT_NEAR(0.1, modelA->GetPose().Pos().X(), 1e-6);
+  modelA->SetLinearVelocity(math::Vector3d::Zero);
+  for (int i = 0; i < 3; ++i)
+    world.Step();
+  EXPECT_TRUE(modelA->GetSleeping());
+
+  // setting the pose wakes it up
+  modelA->SetPose(math::Pose3d(0, 0, 0, 0, 0, 0));
+  EXPECT_FALSE(modelA->GetSleeping());
+  for (int i = 0; i < 3; ++i)
+    world.Step();
+  EXPECT_TRUE(modelA->GetSleeping());
+
+  // an awake model running into a sleeping model wakes it up
+  linkB->SetLinearVelocity(math::Vector3d::Zero);
+  linkB->SetPose(math::Pose3d::Zero);
+  modelB->SetPose(math::Pose3d(0.9, 0, 0, 0, 0, 0));
+  modelB->SetLinearVelocity(math::Vector3d(-1, 0, 0));
+  world.Step();
+  ASSERT_EQ(1u, world.GetContacts().size());
+  EXPECT_FALSE(modelA->GetSleeping());
+
+  // two sleeping models in contact are not collided
+  modelB->SetLinearVelocity(math::Vector3d::Zero);
+  for (int i = 0; i < 4; ++i)
+    world.Step();
+  EXPECT_TRUE(modelA->GetSleeping());
+  EXPECT_TRUE(modelB->GetSleeping());
+  EXPECT_TRUE(world.GetContacts().empty());
+
+  // disabling sleeping wakes all models
+  world.SetSleepSteps(0u);
+  EXPECT_FALSE(modelA->GetSleeping());
+  EXPECT_FALSE(modelB->GetSleeping());
+  world.Step();
+  EXPECT_EQ(1u, world.GetContacts().size());
+}
+
+/////////////////////////////////////////////////
+TEST(World, Trajectory)
+{
+  World world;
+  world.SetTimeStep(0.125);
+  world.SetSleepSteps(2u);
+  Model *model = static_cast<Model *>(&world.AddModel());
+  model->AddLink();
+  Model *other = static_cast<Model *>(&world.AddModel());
+  other->AddLink();
+  other->SetLinearVelocity(math::Vector3d(0, 1, 0));
+
+  // waypoints out of order are rejected
+  Trajectory trajectory;
+  EXPECT_FALSE(trajectory.SetWaypoints({}));
+  EXPECT_FALSE(trajectory.SetWaypoints({
+      {1.0, math::Pose3d::Zero}, {1.0, math::Pose3d::Zero}}));
+
+  // a straight line from x = 0 to x = 2 and a quarter turn about z, starting
+  // after the first step. The times are exact in binary, so that the steps
+  // land on the waypoints.
+  const std::vector<Trajectory::Waypoint> waypoints{
+      {0.25, math::Pose3d(0, 0, 0, 0, 0, 0)},
+      {0.75, math::Pose3d(1, 0, 0, 0, 0, GZ_PI / 4.0)},
+      {1.25, math::Pose3d(2, 0, 0, 0, 0, GZ_PI / 2.0)}};
+  ASSERT_TRUE(trajectory.SetWaypoints(waypoints));
+  EXPECT_DOUBLE_EQ(0.25, trajectory.GetStartTime());
+  EXPECT_DOUBLE_EQ(1.25, trajectory.GetEndTime());
+  EXPECT_NEAR(0.5, trajectory.Pose(0.5).Pos().X(), 1e-9);
+  EXPECT_NEAR(GZ_PI / 8.0, trajectory.Pose(0.5).Rot().Euler().Z(), 1e-9);
+  EXPECT_EQ(waypoints.front().pose, trajectory.Pose(-1.0));
+  EXPECT_EQ(waypoints.back().pose, trajectory.Pose(2.0));
+
+  model->SetPose(math::Pose3d(-1, 0, 0, 0, 0, 0));
+  model->SetTrajectory(trajectory);
+  ASSERT_NE(nullptr, model->GetTrajectory());
+
+  // the model does not move before the first waypoint, and then follows the
+  // trajectory with the velocities that reach each pose
+  world.Step();
+  EXPECT_NEAR(-1.0, model->GetPose().Pos().X(), 1e-9);
+  world.Step();
+  EXPECT_NEAR(0.0, model->GetPose().Pos().X(), 1e-9);
+  EXPECT_NEAR(8.0, model->GetLinearVelocity().X(), 1e-9);
+  for (int i = 0; i < 4; ++i)
+  {
+    world.Step();
+    EXPECT_NEAR(2.0, model->GetLinearVelocity().X(), 1e-9);
+    EXPECT_NEAR(GZ_PI / 2.0, model->GetAngularVelocity().Z(), 1e-9);
+  }
+  EXPECT_NEAR(1.0, model->GetPose().Pos().X(), 1e-9);
+  EXPECT_NEAR(GZ_PI / 4.0, model->GetPose().Rot().Euler().Z(), 1e-9);
+  EXPECT_NEAR(0.75, other->GetPose().Pos().Y(), 1e-9);
+
+  // the model stops at the last waypoint, and then sleeps
+  for (int i = 0; i < 4; ++i)
+  {
+    world.Step();
+    EXPECT_FALSE(model->GetSleeping());
+  }
+  EXPECT_NEAR(2.0, model->GetPose().Pos().X(), 1e-9);
+  EXPECT_NEAR(GZ_PI / 2.0, model->GetPose().Rot().Euler().Z(), 1e-9);
+  world.Step();
+  EXPECT_EQ(nullptr, model->GetTrajectory());
+  EXPECT_EQ(math::Vector3d::Zero, model->GetLinearVelocity());
+  world.Step();
+  world.Step();
+  EXPECT_TRUE(model->GetSleeping());
+  EXPECT_NEAR(2.0, model->GetPose().Pos().X(), 1e-9);
+
+  // a spline passes through the waypoints with a continuous velocity, and
+  // setting a trajectory wakes the model up
+  const double now = world.GetTime();
+  ASSERT_TRUE(trajectory.SetWaypoints({
+      {now, math::Pose3d(2, 0, 0, 0, 0, 0)},
+      {now + 0.5, math::Pose3d(3, 1, 0, 0, 0, 0)},
+      {now + 1.0, math::Pose3d(4, 0, 0, 0, 0, 0)}},
+      Trajectory::Interpolation::CUBIC));
+  EXPECT_EQ(Trajectory::Interpolation::CUBIC, trajectory.GetInterpolation());
+  EXPECT_NEAR(1.0, trajectory.Pose(now + 0.5).Pos().Y(), 1e-9);
+  EXPECT_GT(trajectory.Pose(now + 0.49).Pos().Y(), 0.99);
+  EXPECT_GT(trajectory.Pose(now + 0.51).Pos().Y(), 0.99);
+  model->SetTrajectory(trajectory);
+  EXPECT_FALSE(model->GetSleeping());
+  for (int i = 0; i < 4; ++i)
+    world.Step();
+  EXPECT_NEAR(3.0, model->GetPose().Pos().X(), 1e-9);
+  EXPECT_NEAR(1.0, model->GetPose().Pos().Y(), 1e-9);
+
+  // clearing the trajectory stops the model
+  model->ClearTrajectory();
+  EXPECT_EQ(nullptr, model->GetTrajectory());
+  world.Step();
+  EXPECT_NEAR(3.0, model->GetPose().Pos().X(), 1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST(World, StepStatistics)
+{
+  World world;
+  world.SetTimeStep(0.1);
+  EXPECT_EQ(0u, world.GetStepStatistics().contactCount);
+  EXPECT_DOUBLE_EQ(0.0, world.GetStepStatistics().stepTime);
+
+  // two overlapping boxes and a static box far away
+  for (int i = 0; i < 3; ++i)
+  {
+    auto *model = static_cast<Model *>(&world.AddModel());
+    model->SetPose(math::Pose3d(i < 2 ? 0.5 * i : 10.0, 0, 0, 0, 0, 0));
+    model->SetStatic(i == 2);
+    auto *link = static_cast<Link *>(&model->AddLink());
+    auto *collision = static_cast<Collision *>(&link->AddCollision());
+    BoxShape shape;
+    shape.SetSize(math::Vector3d::One);
+    collision->SetShape(shape);
+  }
+
+  world.Step();
+  const StepStatistics &stats = world.GetStepStatistics();
+  EXPECT_EQ(1u, stats.collision.candidatePairCount);
+  EXPECT_EQ(1u, stats.contactCount);
+  EXPECT_EQ(2u, stats.islandCount);
+  EXPECT_GE(stats.integrationTime, 0.0);
+  EXPECT_GE(stats.collision.broadphaseTime, 0.0);
+  EXPECT_GE(stats.collision.narrowphaseTime, 0.0);
+  EXPECT_LE(stats.integrationTime + stats.collision.broadphaseTime +
+      stats.collision.narrowphaseTime, stats.stepTime + 1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST(World, ModelStatistics)
+{
+  World world;
+  world.SetTimeStep(0.1);
+  EXPECT_FALSE(world.GetModelStatistics());
+
+  // a row of three boxes, the middle one overlapping both others
+  std::vector<std::size_t> ids;
+  for (int i = 0; i < 3; ++i)
+  {
+    auto *model = static_cast<Model *>(&world.AddModel());
+    model->SetPose(math::Pose3d(0.6 * i, 0, 0, 0, 0, 0));
+    auto *link = static_cast<Link *>(&model->AddLink());
+    auto *collision = static_cast<Collision *>(&link->AddCollision());
+    BoxShape shape;
+    shape.SetSize(math::Vector3d::One);
+    collision->SetShape(shape);
+    ids.push_back(model->GetId());
+  }
+
+  world.Step();
+  EXPECT_TRUE(world.GetStepStatistics().collision.entities.empty());
+
+  world.SetModelStatistics(true);
+  EXPECT_TRUE(world.GetModelStatistics());
+  for (std::size_t numThreads : {1u, 2u})
+  {
+    world.SetNumThreads(numThreads);
+    world.Step();
+    const auto &entities = world.GetStepStatistics().collision.entities;
+    ASSERT_EQ(3u, entities.size());
+    EXPECT_EQ(1u, entities.at(ids[0]).candidatePairCount);
+    EXPECT_EQ(2u, entities.at(ids[1]).candidatePairCount);
+    EXPECT_EQ(1u, entities.at(ids[2]).candidatePairCount);
+    EXPECT_EQ(1u, entities.at(ids[0]).contactCount);
+    EXPECT_EQ(2u, entities.at(ids[1]).contactCount);
+    EXPECT_EQ(1u, entities.at(ids[2]).contactCount);
+    for (const auto &[id, entity] : entities)
+    {
+      EXPECT_GE(entity.narrowphaseTime, 0.0);
+      EXPECT_LE(entity.narrowphaseTime,
+          world.GetStepStatistics().collision.narrowphaseTime + 1e-9);
+    }
+  }
+
+  world.SetModelStatistics(false);
+  world.Step();
+  EXPECT_TRUE(world.GetStepStatistics().collision.entities.empty());
+}
+
+/////////////////////////////////////////////////
+TEST(World, SteadyStateAllocations)
+{
+  World world;
+  world.SetTimeStep(0.01);
+  EXPECT_EQ(nullptr, world.GetAllocationCounter());
+
+  // a static ground, rows of boxes resting on it and moving along it
+  // together, so that their pairs stay the same from step to step, and a
+  // box following a trajectory
+  auto addBox = [&world](const math::Pose3d &_pose) -> Model *
+  {
+    auto *model = static_cast<Model *>(&world.AddModel());
+    model->SetPose(_pose);
+    auto *link = static_cast<Link *>(&model->AddLink());
+    auto *collision = static_cast<Collision *>(&link->AddCollision());
+    BoxShape shape;
+    shape.SetSize(math::Vector3d::One);
+    collision->SetShape(shape);
+    return model;
+  };
+  Model *ground = addBox(math::Pose3d(0, 0, -0.5, 0, 0, 0));
+  ground->SetStatic(true);
+  for (int i = 0; i < 4; ++i)
+  {
+    for (int j = 0; j < 4; ++j)
+    {
+      Model *model = addBox(math::Pose3d(0.9 * i, 3.0 * j, 0.45, 0, 0, 0));
+      model->SetLinearVelocity(math::Vector3d(0.1, 0, 0));
+    }
+  }
+  Model *follower = addBox(math::Pose3d(0, -3, 0.45, 0, 0, 0));
+  Trajectory trajectory;
+  ASSERT_TRUE(trajectory.SetWaypoints({
+      {0.0, math::Pose3d(0, -3, 0.45, 0, 0, 0)},
+      {10.0, math::Pose3d(1, -3, 0.45, 0, 0, 0)}}));
+  follower->SetTrajectory(trajectory);
+
+  // the allocations are 0 without a counter
+  world.Step();
+  EXPECT_EQ(0u, world.GetStepStatistics().stepAllocations);
+
+  world.SetAllocationCounter(&allocationCount);
+  EXPECT_EQ(&allocationCount, world.GetAllocationCounter());
+  for (std::size_t numThreads : {1u, 2u})
+  {
+    world.SetNumThreads(numThreads);
+
+    // the first steps size the buffers that are reused afterwards
+    for (int i = 0; i < 5; ++i)
+      world.Step();
+
+    for (int i = 0; i < 20; ++i)
+    {
+      world.Step();
+      const StepStatistics &stats = world.GetStepStatistics();
+      EXPECT_GT(stats.contactCount, 0u);
+      if (numThreads > 1u)
+      {
+        // handing work to the worker threads allocates
+        EXPECT_GE(stats.stepAllocations, stats.integrationAllocations +
+            stats.collision.broadphaseAllocations +
+            stats.collision.narrowphaseAllocations);
+        continue;
+      }
+      EXPECT_EQ(0u, stats.stepAllocations) << i;
+      EXPECT_EQ(0u, stats.integrationAllocations);
+      EXPECT_EQ(0u, stats.collision.broadphaseAllocations);
+      EXPECT_EQ(0u, stats.collision.narrowphaseAllocations);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(World, MemoryUsage)
+{
+  World world;
+  world.SetTimeStep(0.1);
+  const MemoryUsage empty = world.GetMemoryUsage();
+  EXPECT_EQ(0u, empty.geometryBytes);
+  EXPECT_EQ(0u, empty.entityBytes);
+
+  auto addBox = [&world](double _x)
+  {
+    auto *model = static_cast<Model *>(&world.AddModel());
+    model->SetPose(math::Pose3d(_x, 0, 0, 0, 0, 0));
+    auto *link = static_cast<Link *>(&model->AddLink());
+    auto *collision = static_cast<Collision *>(&link->AddCollision());
+    BoxShape shape;
+    shape.SetSize(math::Vector3d::One);
+    collision->SetShape(shape);
+  };
+
+  addBox(0.0);
+  const MemoryUsage one = world.GetMemoryUsage();
+  EXPECT_EQ(sizeof(BoxShape), one.geometryBytes);
+  EXPECT_GT(one.entityBytes, 0u);
+
+  addBox(0.5);
+  world.Step();
+  const MemoryUsage two = world.GetMemoryUsage();
+  EXPECT_EQ(2 * sizeof(BoxShape), two.geometryBytes);
+  EXPECT_GT(two.entityBytes, one.entityBytes);
+  EXPECT_GT(two.solverBytes, empty.solverBytes);
+}
+
+/////////////////////////////////////////////////
+TEST(World, MemoryResource)
+{
+  auto arena = std::make_shared<gz::physics::ArenaMemoryResource>();
+  std::weak_ptr<gz::physics::ArenaMemoryResource> weak = arena;
+  {
+    World world;
+    world.SetTimeStep(0.1);
+    EXPECT_EQ(nullptr, world.GetMemoryResource());
+    world.SetMemoryResource(arena);
+    EXPECT_EQ(arena, world.GetMemoryResource());
+
+    // Entities added afterwards are allocated from the resource, and share
+    // it with the entities of their world
+    auto &model = world.AddModel();
+    EXPECT_EQ(arena, model.GetMemoryResource());
+    auto &link = static_cast<Model &>(model).AddLink();
+    auto &collision = static_cast<Link &>(link).AddCollision();
+    EXPECT_EQ(arena, collision.GetMemoryResource());
+    const std::size_t inUse = arena->GetBytesInUse();
+    EXPECT_GT(inUse, sizeof(Model) + sizeof(Link) + sizeof(Collision));
+
+    arena.reset();
+    EXPECT_FALSE(weak.expired());
+    world.Step();
+
+    EXPECT_TRUE(world.RemoveChildById(model.GetId()));
+    EXPECT_LT(weak.lock()->GetBytesInUse(), inUse);
+  }
+  EXPECT_TRUE(weak.expired());
+}
+
+/////////////////////////////////////////////////
+TEST(World, CollisionInterval)
+{
+  World world;
+  world.SetTimeStep(0.1);
+  EXPECT_EQ(1u, world.GetCollisionInterval());
+
+  // two overlapping boxes
+  std::vector<Collision *> collisions;
+  for (int i = 0; i < 2; ++i)
+  {
+    auto *model = static_cast<Model *>(&world.AddModel());
+    model->SetPose(math::Pose3d(0.5 * i, 0, 0, 0, 0, 0));
+    auto *link = static_cast<Link *>(&model->AddLink());
+    auto *collision = static_cast<Collision *>(&link->AddCollision());
+    BoxShape shape;
+    shape.SetSize(math::Vector3d::One);
+    collision->SetShape(shape);
+    collisions.push_back(collision);
+  }
+
+  // only check on demand
+  world.SetCollisionInterval(0u);
+  world.Step();
+  EXPECT_TRUE(world.GetContacts().empty());
+  EXPECT_EQ(0u, world.GetStepStatistics().collision.candidatePairCount);
+  world.CheckCollisions();
+  EXPECT_EQ(1u, world.GetContacts().size());
+
+  // check every third step, keeping the contacts in between
+  world.SetCollisionInterval(3u);
+  collisions[0]->SetCollideBitmask(0x00);
+  world.Step();
+  world.Step();
+  EXPECT_EQ(1u, world.GetContacts().size());
+  world.Step();
+  EXPECT_TRUE(world.GetContacts().empty());
+
+  // a zero collide bitmask keeps the model out of the collision detector
+  world.SetCollisionInterval(1u);
+  world.Step();
+  EXPECT_TRUE(world.GetContacts().empty());
+  EXPECT_EQ(0u, world.GetStepStatistics().collision.candidatePairCount);
+
+  collisions[0]->SetCollideBitmask(0xFF);
+  world.Step();
+  EXPECT_EQ(1u, world.GetContacts().size());
+}
+
+/////////////////////////////////////////////////
+TEST(World, UpdateRate)
+{
+  World world;
+  world.SetTimeStep(0.01);
+
+  // two models moving at 1 m/s, one of them updated at 25 Hz
+  Model *slow = static_cast<Model *>(&world.AddModel());
+  slow->AddLink();
+  slow->SetLinearVelocity(math::Vector3d(1, 0, 0));
+  Model *fast = static_cast<Model *>(&world.AddModel());
+  fast->AddLink();
+  fast->SetLinearVelocity(math::Vector3d(1, 0, 0));
+  EXPECT_DOUBLE_EQ(0.0, slow->GetUpdateRate());
+  slow->SetUpdateRate(25.0);
+  EXPECT_DOUBLE_EQ(25.0, slow->GetUpdateRate());
+
+  // the slow model is updated every fourth step, and each update catches up
+  // with the time of the world
+  std::size_t updates = 0u;
+  for (int i = 0; i < 8; ++i)
+  {
+    const double x = slow->GetPose().Pos().X();
+    world.Step();
+    EXPECT_NEAR(world.GetTime(), fast->GetPose().Pos().X(), 1e-9);
+    if (std::abs(slow->GetPose().Pos().X() - x) > 1e-9)
+    {
+      ++updates;
+      EXPECT_NEAR(world.GetTime(), slow->GetPose().Pos().X(), 1e-9);
+    }
+  }
+  EXPECT_EQ(2u, updates);
+
+  // a rate at or above the step rate updates the model in every step
+  slow->SetUpdateRate(200.0);
+  for (int i = 0; i < 2; ++i)
+  {
+    world.Step();
+    EXPECT_NEAR(world.GetTime(), slow->GetPose().Pos().X(), 1e-9);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(World, CastRays)
+{
+  World world;
+
+  // a row of spheres along x, at x = 0, 3, 6, ...
+  std::vector<std::size_t> collisionIds;
+  for (int i = 0; i < 4; ++i)
+  {
+    auto *model = static_cast<Model *>(&world.AddModel());
+    model->SetPose(math::Pose3d(3.0 * i, 0, 0, 0, 0, 0));
+    auto *link = static_cast<Link *>(&model->AddLink());
+    auto *collision = static_cast<Collision *>(&link->AddCollision());
+    SphereShape shape;
+    shape.SetRadius(1.0);
+    collision->SetShape(shape);
+    collisionIds.push_back(collision->GetId());
+  }
+
+  // one ray down onto each sphere and one between them
+  std::vector<math::Vector3d> from;
+  std::vector<math::Vector3d> to;
+  for (int i = 0; i < 4; ++i)
+  {
+    from.emplace_back(3.0 * i, 0, 5);
+    to.emplace_back(3.0 * i, 0, -5);
+  }
+  from.emplace_back(1.5, 0, 5);
+  to.emplace_back(1.5, 0, -5);
+
+  std::vector<RayHit> hits;
+  world.CastRays(from.data(), to.data(), from.size(), hits);
+  ASSERT_EQ(from.size(), hits.size());
+  for (std::size_t i = 0; i < collisionIds.size(); ++i)
+  {
+    EXPECT_EQ(collisionIds[i], hits[i].entity);
+    EXPECT_DOUBLE_EQ(4.0, hits[i].distance);
+    EXPECT_EQ(math::Vector3d::UnitZ, hits[i].normal);
+  }
+  EXPECT_EQ(kNullEntityId, hits.back().entity);
+  EXPECT_TRUE(std::isinf(hits.back().distance));
+
+  // a ray along the row hits the closest sphere only
+  const math::Vector3d start(-5, 0, 0);
+  const math::Vector3d end(20, 0, 0);
+  world.CastRays(&start, &end, 1u, hits);
+  ASSERT_EQ(1u, hits.size());
+  EXPECT_EQ(collisionIds[0], hits[0].entity);
+  EXPECT_DOUBLE_EQ(4.0, hits[0].distance);
+
+  // rays follow the models once they move, and the hits do not depend on
+  // the number of threads
+  auto *model = static_cast<Model *>(&world.AddModel());
+  model->SetPose(math::Pose3d(0, 0, 2.5, 0, 0, 0));
+  auto *link = static_cast<Link *>(&model->AddLink());
+  auto *collision = static_cast<Collision *>(&link->AddCollision());
+  BoxShape box;
+  box.SetSize(math::Vector3d::One);
+  collision->SetShape(box);
+  world.CastRays(from.data(), to.data(), from.size(), hits);
+  EXPECT_EQ(collision->GetId(), hits[0].entity);
+  EXPECT_DOUBLE_EQ(2.0, hits[0].distance);
+
+  std::vector<RayHit> parallelHits;
+  world.CastRays(from.data(), to.data(), from.size(), parallelHits, 3u);
+  ASSERT_EQ(hits.size(), parallelHits.size());
+  for (std::size_t i = 0; i < hits.size(); ++i)
+  {
+    EXPECT_EQ(hits[i].entity, parallelHits[i].entity);
+    EXPECT_EQ(hits[i].distance, parallelHits[i].distance);
+  }
+  EXPECT_TRUE(world.GetContacts().empty());
+}
+
+/////////////////////////////////////////////////
+TEST(World, ShapeQueries)
+{
+  World world;
+
+  // two spheres along x, at x = 0 and 3, and a box at x = 20
+  std::vector<std::size_t> collisionIds;
+  for (int i = 0; i < 3; ++i)
+  {
+    auto *model = static_cast<Model *>(&world.AddModel());
+    model->SetPose(math::Pose3d(i < 2 ? 3.0 * i : 20.0, 0, 0, 0, 0, 0));
+    auto *link = static_cast<Link *>(&model->AddLink());
+    auto *collision = static_cast<Collision *>(&link->AddCollision());
+    if (i < 2)
+    {
+      SphereShape shape;
+      shape.SetRadius(1.0);
+      collision->SetShape(shape);
+    }
+    else
+    {
+      BoxShape shape;
+      shape.SetSize(math::Vector3d(2, 2, 2));
+      collision->SetShape(shape);
+    }
+    collisionIds.push_back(collision->GetId());
+  }
+
+  QueryVolume sphere;
+  sphere.type = ShapeType::SPHERE;
+  sphere.radius = 0.5;
+  QueryVolume box;
+  box.type = ShapeType::BOX;
+  box.size = math::Vector3d::One;
+
+  // a sphere dropped onto the first sphere, a box dropped onto the box, and
+  // a sphere that already overlaps the second sphere
+  std::vector<QueryVolume> volumes = {sphere, box, sphere};
+  volumes[0].pose.Set(0, 0, 5, 0, 0, 0);
+  volumes[1].pose.Set(20, 0, 5, 0, 0, 0);
+  volumes[2].pose.Set(3, 0, 1.2, 0, 0, 0);
+  std::vector<math::Vector3d> to = {
+      {0, 0, -5}, {20, 0, -5}, {3, 0, -5}};
+
+  std::vector<RayHit> hits;
+  world.CastVolumes(volumes.data(), to.data(), volumes.size(), hits);
+  ASSERT_EQ(3u, hits.size());
+  EXPECT_EQ(collisionIds[0], hits[0].entity);
+  EXPECT_DOUBLE_EQ(3.5, hits[0].distance);
+  EXPECT_EQ(math::Vector3d::UnitZ, hits[0].normal);
+  EXPECT_EQ(collisionIds[2], hits[1].entity);
+  EXPECT_DOUBLE_EQ(3.5, hits[1].distance);
+  EXPECT_EQ(math::Vector3d::UnitZ, hits[1].normal);
+  EXPECT_EQ(collisionIds[1], hits[2].entity);
+  EXPECT_DOUBLE_EQ(0.0, hits[2].distance);
+
+  // a sphere touching both spheres, a small box between them, and a
+  // rotated box inside the box
+  volumes[0].pose.Set(1.5, 0, 0, 0, 0, 0);
+  volumes[0].radius = 0.6;
+  volumes[1].pose.Set(1.5, 0, 0, 0, 0, 0);
+  volumes[1].size = math::Vector3d(0.2, 0.2, 0.2);
+  volumes[2] = box;
+  volumes[2].pose.Set(20, 0, 0, 0, 0, GZ_PI / 4);
+
+  std::vector<std::vector<std::size_t>> overlaps;
+  world.FindOverlaps(volumes.data(), volumes.size(), overlaps);
+  ASSERT_EQ(3u, overlaps.size());
+  std::sort(overlaps[0].begin(), overlaps[0].end());
+  EXPECT_EQ((std::vector<std::size_t>{collisionIds[0], collisionIds[1]}),
+      overlaps[0]);
+  EXPECT_TRUE(overlaps[1].empty());
+  EXPECT_EQ(std::vector<std::size_t>{collisionIds[2]}, overlaps[2]);
+
+  // the results do not depend on the number of threads
+  std::vector<std::vector<std::size_t>> parallelOverlaps;
+  world.FindOverlaps(volumes.data(), volumes.size(), parallelOverlaps, 2u);
+  ASSERT_EQ(overlaps.size(), parallelOverlaps.size());
+  std::sort(parallelOverlaps[0].begin(), parallelOverlaps[0].end());
+  EXPECT_EQ(overlaps, parallelOverlaps);
+  EXPECT_TRUE(world.GetContacts().empty());
+}
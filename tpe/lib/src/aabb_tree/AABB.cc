@@ -22,6 +22,10 @@
 
   This code was adapted from parts of the Box2D Physics Engine,
   http://www.box2d.org
+
+  This is an altered version of the original aabbcc source: batched pair
+  queries, leaf refitting and bulk building were added for gz-physics, and
+  the tree was restricted to 3D so that nodes store their bounds inline.
 */
 
 #include <cmath>
@@ -29,97 +33,77 @@
 
 namespace aabb
 {
-    AABB::AABB()
+    template <typename Scalar>
+    AABBT<Scalar>::AABBT() : surfaceArea(0)
     {
+        lowerBound.fill(0);
+        upperBound.fill(0);
     }
 
-    AABB::AABB(unsigned int dimension)
+    template <typename Scalar>
+    AABBT<Scalar>::AABBT(unsigned int dimension) : AABBT()
     {
-        assert(dimension >= 2);
-
-        lowerBound.resize(dimension);
-        upperBound.resize(dimension);
+        assert(dimension == DIMENSION);
+        (void) dimension;
     }
 
-    AABB::AABB(const std::vector<double>& lowerBound_, const std::vector<double>& upperBound_) :
-        lowerBound(lowerBound_), upperBound(upperBound_)
+    template <typename Scalar>
+    AABBT<Scalar>::AABBT(const std::vector<double>& lowerBound_, const std::vector<double>& upperBound_)
     {
         // Validate the dimensionality of the bounds vectors.
-        if (lowerBound.size() != upperBound.size())
+        if ((lowerBound_.size() != DIMENSION) || (upperBound_.size() != DIMENSION))
         {
             throw std::invalid_argument("[ERROR]: Dimensionality mismatch!");
         }
 
         // Validate that the upper bounds exceed the lower bounds.
-        for (unsigned int i=0;i<lowerBound.size();i++)
+        for (unsigned int i=0;i<DIMENSION;i++)
         {
             // Validate the bound.
-            if (lowerBound[i] > upperBound[i])
+            if (lowerBound_[i] > upperBound_[i])
             {
                 throw std::invalid_argument("[ERROR]: AABB lower bound is greater than the upper bound!");
             }
+
+            lowerBound[i] = roundDown(lowerBound_[i]);
+            upperBound[i] = roundUp(upperBound_[i]);
         }
 
         surfaceArea = computeSurfaceArea();
-        centre = computeCentre();
     }
 
-    double AABB::computeSurfaceArea() const
+    template <typename Scalar>
+    double AABBT<Scalar>::computeSurfaceArea() const
     {
-        // Sum of "area" of all the sides.
-        double sum = 0;
-
-        // General formula for one side: hold one dimension constant
-        // and multiply by all the other ones.
-        for (unsigned int d1 = 0; d1 < lowerBound.size(); d1++)
-        {
-            // "Area" of current side.
-            double product = 1;
-
-            for (unsigned int d2 = 0; d2 < lowerBound.size(); d2++)
-            {
-                if (d1 == d2)
-                    continue;
-
-                double dx = upperBound[d2] - lowerBound[d2];
-                product *= dx;
-            }
-
-            // Update the sum.
-            sum += product;
-        }
-
-        return 2.0 * sum;
+        // Sum of the areas of all the sides.
+        double dx = upperBound[0] - lowerBound[0];
+        double dy = upperBound[1] - lowerBound[1];
+        double dz = upperBound[2] - lowerBound[2];
+        return 2.0 * (dx * dy + dy * dz + dz * dx);
     }
 
-    double AABB::getSurfaceArea() const
+    template <typename Scalar>
+    double AABBT<Scalar>::getSurfaceArea() const
     {
         return surfaceArea;
     }
 
-    void AABB::merge(const AABB& aabb1, const AABB& aabb2)
+    template <typename Scalar>
+    void AABBT<Scalar>::merge(const AABBT& aabb1, const AABBT& aabb2)
     {
-        assert(aabb1.lowerBound.size() == aabb2.lowerBound.size());
-        assert(aabb1.upperBound.size() == aabb2.upperBound.size());
-
-        lowerBound.resize(aabb1.lowerBound.size());
-        upperBound.resize(aabb1.lowerBound.size());
-
-        for (unsigned int i=0;i<lowerBound.size();i++)
+        for (unsigned int i=0;i<DIMENSION;i++)
         {
             lowerBound[i] = std::min(aabb1.lowerBound[i], aabb2.lowerBound[i]);
             upperBound[i] = std::max(aabb1.upperBound[i], aabb2.upperBound[i]);
         }
 
         surfaceArea = computeSurfaceArea();
-        centre = computeCentre();
     }
 
-    bool AABB::contains(const AABB& aabb) const
+    template <typename Scalar>
+    bool AABBT<Scalar>::contains(const AABBT& aabb) const
     {
-        assert(aabb.lowerBound.size() == lowerBound.size());
-
-        for (unsigned int i=0;i<lowerBound.size();i++)
+        for (unsigned int i=0;i<DIMENSION;i++)
         {
             if (aabb.lowerBound[i] < lowerBound[i]) return false;
             if (aabb.upperBound[i] > upperBound[i]) return false;
@@ -128,15 +112,14 @@ namespace aabb
         return true;
     }
 
-    bool AABB::overlaps(const AABB& aabb, bool touchIsOverlap) const
+    template <typename Scalar>
+    bool AABBT<Scalar>::overlaps(const AABBT& aabb, bool touchIsOverlap) const
     {
-        assert(aabb.lowerBound.size() == lowerBound.size());
-
         bool rv = true;
 
         if (touchIsOverlap)
         {
-            for (unsigned int i = 0; i < lowerBound.size(); ++i)
+            for (unsigned int i = 0; i < DIMENSION; ++i)
             {
                 if (aabb.upperBound[i] < lowerBound[i] || aabb.lowerBound[i] > upperBound[i])
                 {
@@ -147,7 +130,7 @@ namespace aabb
         }
         else
         {
-            for (unsigned int i = 0; i < lowerBound.size(); ++i)
+            for (unsigned int i = 0; i < DIMENSION; ++i)
             {
                 if (aabb.upperBound[i] <= lowerBound[i] || aabb.lowerBound[i] >= upperBound[i])
                 {
@@ -160,34 +143,48 @@ namespace aabb
         return rv;
     }
 
-    std::vector<double> AABB::computeCentre()
+    template <typename Scalar>
+    std::array<double, DIMENSION> AABBT<Scalar>::computeCentre() const
     {
-        std::vector<double> position(lowerBound.size());
+        std::array<double, DIMENSION> position;
 
-        for (unsigned int i=0;i<position.size();i++)
+        for (unsigned int i=0;i<DIMENSION;i++)
             position[i] = 0.5 * (lowerBound[i] + upperBound[i]);
 
         return position;
     }
 
-    void AABB::setDimension(unsigned int dimension)
+    template <typename Scalar>
+    Scalar AABBT<Scalar>::roundDown(double bound)
     {
-        assert(dimension >= 2);
+        Scalar rounded = static_cast<Scalar>(bound);
+        if (rounded > bound)
+            rounded = std::nextafter(rounded, -std::numeric_limits<Scalar>::infinity());
+        return rounded;
+    }
 
-        lowerBound.resize(dimension);
-        upperBound.resize(dimension);
+    template <typename Scalar>
+    Scalar AABBT<Scalar>::roundUp(double bound)
+    {
+        Scalar rounded = static_cast<Scalar>(bound);
+        if (rounded < bound)
+            rounded = std::nextafter(rounded, std::numeric_limits<Scalar>::infinity());
+        return rounded;
     }
 
-    Node::Node()
+    template <typename Scalar>
+    NodeT<Scalar>::NodeT()
     {
     }
 
-    bool Node::isLeaf() const
+    template <typename Scalar>
+    bool NodeT<Scalar>::isLeaf() const
     {
         return (left == NULL_NODE);
     }
 
-    Tree::Tree(unsigned int dimension_,
+    template <typename Scalar>
+    TreeT<Scalar>::TreeT(unsigned int dimension_,
                double skinThickness_,
                unsigned int nParticles,
                bool touchIsOverlap_) :
@@ -195,7 +192,7 @@ namespace aabb
         touchIsOverlap(touchIsOverlap_)
     {
         // Validate the dimensionality.
-        if ((dimension < 2))
+        if (dimension != DIMENSION)
         {
             throw std::invalid_argument("[ERROR]: Invalid dimensionality!");
         }
@@ -223,7 +220,8 @@ namespace aabb
         freeList = 0;
     }
 
-    Tree::Tree(unsigned int dimension_,
+    template <typename Scalar>
+    TreeT<Scalar>::TreeT(unsigned int dimension_,
                double skinThickness_,
                const std::vector<bool>& periodicity_,
                const std::vector<double>& boxSize_,
@@ -234,7 +232,7 @@ namespace aabb
         touchIsOverlap(touchIsOverlap_)
     {
         // Validate the dimensionality.
-        if (dimension < 2)
+        if (dimension != DIMENSION)
         {
             throw std::invalid_argument("[ERROR]: Invalid dimensionality!");
         }
@@ -278,17 +276,20 @@ namespace aabb
         }
     }
 
-    void Tree::setPeriodicity(const std::vector<bool>& periodicity_)
+    template <typename Scalar>
+    void TreeT<Scalar>::setPeriodicity(const std::vector<bool>& periodicity_)
     {
         periodicity = periodicity_;
     }
 
-    void Tree::setBoxSize(const std::vector<double>& boxSize_)
+    template <typename Scalar>
+    void TreeT<Scalar>::setBoxSize(const std::vector<double>& boxSize_)
     {
         boxSize = boxSize_;
     }
 
-    unsigned int Tree::allocateNode()
+    template <typename Scalar>
+    unsigned int TreeT<Scalar>::allocateNode()
     {
         // Exand the node pool as needed.
         if (freeList == NULL_NODE)
@@ -319,13 +320,14 @@ namespace aabb
         nodes[node].left = NULL_NODE;
         nodes[node].right = NULL_NODE;
         nodes[node].height = 0;
-        nodes[node].aabb.setDimension(dimension);
+        nodes[node].mask = ALL_MASKS;
         nodeCount++;
 
         return node;
     }
 
-    void Tree::freeNode(unsigned int node)
+    template <typename Scalar>
+    void TreeT<Scalar>::freeNode(unsigned int node)
     {
         assert(node < nodeCapacity);
         assert(0 < nodeCount);
@@ -336,7 +338,8 @@ namespace aabb
         nodeCount--;
     }
 
-    void Tree::insertParticle(unsigned int particle, std::vector<double>& position, double radius)
+    template <typename Scalar>
+    void TreeT<Scalar>::insertParticle(unsigned int particle, std::vector<double>& position, double radius)
     {
         // Make sure the particle doesn't already exist.
         if (particleMap.count(particle) != 0)
@@ -359,19 +362,18 @@ namespace aabb
         // Compute the AABB limits.
         for (unsigned int i=0;i<dimension;i++)
         {
-            nodes[node].aabb.lowerBound[i] = position[i] - radius;
-            nodes[node].aabb.upperBound[i] = position[i] + radius;
-            size[i] = nodes[node].aabb.upperBound[i] - nodes[node].aabb.lowerBound[i];
+            size[i] = 2 * radius;
         }
 
         // Fatten the AABB.
         for (unsigned int i=0;i<dimension;i++)
         {
-            nodes[node].aabb.lowerBound[i] -= skinThickness * size[i];
-            nodes[node].aabb.upperBound[i] += skinThickness * size[i];
+            nodes[node].aabb.lowerBound[i] =
+                AABB::roundDown(position[i] - radius - skinThickness * size[i]);
+            nodes[node].aabb.upperBound[i] =
+                AABB::roundUp(position[i] + radius + skinThickness * size[i]);
         }
         nodes[node].aabb.surfaceArea = nodes[node].aabb.computeSurfaceArea();
-        nodes[node].aabb.centre = nodes[node].aabb.computeCentre();
 
         // Zero the height.
         nodes[node].height = 0;
@@ -386,7 +388,8 @@ namespace aabb
         nodes[node].particle = particle;
     }
 
-    void Tree::insertParticle(unsigned int particle, std::vector<double>& lowerBound, std::vector<double>& upperBound)
+    template <typename Scalar>
+    void TreeT<Scalar>::insertParticle(unsigned int particle, std::vector<double>& lowerBound, std::vector<double>& upperBound)
     {
         // Make sure the particle doesn't already exist.
         if (particleMap.count(particle) != 0)
@@ -415,19 +418,18 @@ namespace aabb
                 throw std::invalid_argument("[ERROR]: AABB lower bound is greater than the upper bound!");
             }
 
-            nodes[node].aabb.lowerBound[i] = lowerBound[i];
-            nodes[node].aabb.upperBound[i] = upperBound[i];
             size[i] = upperBound[i] - lowerBound[i];
         }
 
         // Fatten the AABB.
         for (unsigned int i=0;i<dimension;i++)
         {
-            nodes[node].aabb.lowerBound[i] -= skinThickness * size[i];
-            nodes[node].aabb.upperBound[i] += skinThickness * size[i];
+            nodes[node].aabb.lowerBound[i] =
+                AABB::roundDown(lowerBound[i] - skinThickness * size[i]);
+            nodes[node].aabb.upperBound[i] =
+                AABB::roundUp(upperBound[i] + skinThickness * size[i]);
         }
         nodes[node].aabb.surfaceArea = nodes[node].aabb.computeSurfaceArea();
-        nodes[node].aabb.centre = nodes[node].aabb.computeCentre();
 
         // Zero the height.
         nodes[node].height = 0;
@@ -442,12 +444,109 @@ namespace aabb
         nodes[node].particle = particle;
     }
 
-    unsigned int Tree::nParticles()
+    template <typename Scalar>
+    void TreeT<Scalar>::insertParticles(const std::vector<unsigned int>& particles,
+        const std::vector<std::vector<double>>& lowerBounds,
+        const std::vector<std::vector<double>>& upperBounds)
+    {
+        if ((particles.size() != lowerBounds.size()) ||
+            (particles.size() != upperBounds.size()))
+        {
+            throw std::invalid_argument("[ERROR]: Size mismatch!");
+        }
+
+        // Validate all particles first, so that the tree is left untouched
+        // if any of them is invalid.
+        std::unordered_set<unsigned int> inserted;
+        for (unsigned int n=0;n<particles.size();n++)
+        {
+            if ((particleMap.count(particles[n]) != 0) ||
+                !inserted.insert(particles[n]).second)
+            {
+                throw std::invalid_argument("[ERROR]: Particle already exists in tree!");
+            }
+
+            if ((lowerBounds[n].size() != dimension) ||
+                (upperBounds[n].size() != dimension))
+            {
+                throw std::invalid_argument("[ERROR]: Dimensionality mismatch!");
+            }
+
+            for (unsigned int i=0;i<dimension;i++)
+            {
+                if (lowerBounds[n][i] > upperBounds[n][i])
+                {
+                    throw std::invalid_argument("[ERROR]: AABB lower bound is greater than the upper bound!");
+                }
+            }
+        }
+
+        if (particles.empty())
+            return;
+
+        // Allocate and fatten the leaves.
+        std::vector<unsigned int> leaves(particles.size());
+        for (unsigned int n=0;n<particles.size();n++)
+        {
+            unsigned int node = allocateNode();
+            AABB& aabb = nodes[node].aabb;
+            for (unsigned int i=0;i<dimension;i++)
+            {
+                double size = upperBounds[n][i] - lowerBounds[n][i];
+                aabb.lowerBound[i] = AABB::roundDown(lowerBounds[n][i] - skinThickness * size);
+                aabb.upperBound[i] = AABB::roundUp(upperBounds[n][i] + skinThickness * size);
+            }
+            aabb.surfaceArea = aabb.computeSurfaceArea();
+
+            nodes[node].height = 0;
+            nodes[node].particle = particles[n];
+            particleMap.insert(std::unordered_map<unsigned int, unsigned int>::value_type(particles[n], node));
+            leaves[n] = node;
+        }
+
+        // Build the new leaves into a subtree and insert it as a whole. A
+        // tree that is built from scratch is also laid out for traversal.
+        bool wasEmpty = (root == NULL_NODE);
+        insertLeaf(buildSubtree(leaves, 0, leaves.size()));
+        if (wasEmpty)
+            reorderNodes();
+    }
+
+    template <typename Scalar>
+    unsigned int TreeT<Scalar>::nParticles()
     {
         return particleMap.size();
     }
 
-    void Tree::removeParticle(unsigned int particle)
+    template <typename Scalar>
+    bool TreeT<Scalar>::hasParticle(unsigned int particle) const
+    {
+        return particleMap.count(particle) != 0;
+    }
+
+    template <typename Scalar>
+    void TreeT<Scalar>::setParticleMask(unsigned int particle, unsigned int mask)
+    {
+        auto it = particleMap.find(particle);
+        if (it == particleMap.end())
+        {
+            throw std::invalid_argument("[ERROR]: Invalid particle index!");
+        }
+
+        unsigned int node = it->second;
+        if (nodes[node].mask == mask) return;
+        nodes[node].mask = mask;
+
+        // Recompute the masks of the ancestors.
+        for (node = nodes[node].parent; node != NULL_NODE; node = nodes[node].parent)
+        {
+            nodes[node].mask = nodes[nodes[node].left].mask |
+                nodes[nodes[node].right].mask;
+        }
+    }
+
+    template <typename Scalar>
+    void TreeT<Scalar>::removeParticle(unsigned int particle)
     {
         // Map iterator.
         std::unordered_map<unsigned int, unsigned int>::iterator it;
@@ -474,7 +573,8 @@ namespace aabb
         freeNode(node);
     }
 
-    void Tree::removeAll()
+    template <typename Scalar>
+    void TreeT<Scalar>::removeAll()
     {
         // Iterator pointing to the start of the particle map.
         std::unordered_map<unsigned int, unsigned int>::iterator it = particleMap.begin();
@@ -498,7 +598,8 @@ namespace aabb
         particleMap.clear();
     }
 
-    bool Tree::updateParticle(unsigned int particle, std::vector<double>& position, double radius,
+    template <typename Scalar>
+    bool TreeT<Scalar>::updateParticle(unsigned int particle, std::vector<double>& position, double radius,
                               bool alwaysReinsert)
     {
         // Validate the dimensionality of the position vector.
@@ -522,7 +623,8 @@ namespace aabb
         return updateParticle(particle, lowerBound, upperBound, alwaysReinsert);
     }
 
-    bool Tree::updateParticle(unsigned int particle, std::vector<double>& lowerBound,
+    template <typename Scalar>
+    bool TreeT<Scalar>::updateParticle(unsigned int particle, std::vector<double>& lowerBound,
                               std::vector<double>& upperBound, bool alwaysReinsert)
     {
         // Validate the dimensionality of the bounds vectors.
@@ -549,19 +651,13 @@ namespace aabb
         assert(node < nodeCapacity);
         assert(nodes[node].isLeaf());
 
-        // AABB size in each dimension.
-        std::vector<double> size(dimension);
-
-        // Compute the AABB limits.
+        // Validate the bounds.
         for (unsigned int i=0;i<dimension;i++)
         {
-            // Validate the bound.
             if (lowerBound[i] > upperBound[i])
             {
                 throw std::invalid_argument("[ERROR]: AABB lower bound is greater than the upper bound!");
             }
-
-            size[i] = upperBound[i] - lowerBound[i];
         }
 
         // Create the new AABB.
@@ -576,8 +672,9 @@ namespace aabb
         // Fatten the new AABB.
         for (unsigned int i=0;i<dimension;i++)
         {
-            aabb.lowerBound[i] -= skinThickness * size[i];
-            aabb.upperBound[i] += skinThickness * size[i];
+            const double size = upperBound[i] - lowerBound[i];
+            aabb.lowerBound[i] = AABB::roundDown(lowerBound[i] - skinThickness * size);
+            aabb.upperBound[i] = AABB::roundUp(upperBound[i] + skinThickness * size);
         }
 
         // Assign the new AABB.
@@ -585,7 +682,6 @@ namespace aabb
 
         // Update the surface area and centroid.
         nodes[node].aabb.surfaceArea = nodes[node].aabb.computeSurfaceArea();
-        nodes[node].aabb.centre = nodes[node].aabb.computeCentre();
 
         // Insert a new leaf node.
         insertLeaf(node);
@@ -593,7 +689,8 @@ namespace aabb
         return true;
     }
 
-    std::vector<unsigned int> Tree::query(unsigned int particle)
+    template <typename Scalar>
+    std::vector<unsigned int> TreeT<Scalar>::query(unsigned int particle)
     {
         // Make sure that this is a valid particle.
         if (particleMap.count(particle) == 0)
@@ -605,8 +702,13 @@ namespace aabb
         return query(particle, nodes[particleMap.find(particle)->second].aabb);
     }
 
-    std::vector<unsigned int> Tree::query(unsigned int particle, const AABB& aabb)
+    template <typename Scalar>
+    std::vector<unsigned int> TreeT<Scalar>::query(unsigned int particle, const AABB& aabb)
     {
+        auto it = particleMap.find(particle);
+        const unsigned int mask =
+            it == particleMap.end() ? ALL_MASKS : nodes[it->second].mask;
+
         std::vector<unsigned int> stack;
         stack.reserve(256);
         stack.push_back(root);
@@ -623,12 +725,17 @@ namespace aabb
 
             if (node == NULL_NODE) continue;
 
+            // No particle of this subtree collides with the particle.
+            if ((nodes[node].mask & mask) == 0) continue;
+
             if (isPeriodic)
             {
                 std::vector<double> separation(dimension);
                 std::vector<double> shift(dimension);
+                std::array<double, DIMENSION> nodeCentre = nodeAABB.computeCentre();
+                std::array<double, DIMENSION> centre = aabb.computeCentre();
                 for (unsigned int i=0;i<dimension;i++)
-                    separation[i] = nodeAABB.centre[i] - aabb.centre[i];
+                    separation[i] = nodeCentre[i] - centre[i];
 
                 bool isShifted = minimumImage(separation, shift);
 
@@ -666,7 +773,8 @@ namespace aabb
         return particles;
     }
 
-    std::vector<unsigned int> Tree::query(const AABB& aabb)
+    template <typename Scalar>
+    std::vector<unsigned int> TreeT<Scalar>::query(const AABB& aabb)
     {
         // Make sure the tree isn't empty.
         if (particleMap.size() == 0)
@@ -678,12 +786,313 @@ namespace aabb
         return query(std::numeric_limits<unsigned int>::max(), aabb);
     }
 
-    const AABB& Tree::getAABB(unsigned int particle)
+    template <typename Scalar>
+    void TreeT<Scalar>::query(unsigned int particle, std::vector<unsigned int>& particles)
+    {
+        // Make sure that this is a valid particle.
+        auto it = particleMap.find(particle);
+        if (it == particleMap.end())
+        {
+            throw std::invalid_argument("[ERROR]: Invalid particle index!");
+        }
+
+        const AABB& aabb = nodes[it->second].aabb;
+        const unsigned int mask = nodes[it->second].mask;
+
+        // Periodic boxes need shifted copies of the node AABBs.
+        if (isPeriodic)
+        {
+            auto result = query(particle, aabb);
+            particles.insert(particles.end(), result.begin(), result.end());
+            return;
+        }
+
+        std::vector<unsigned int> stack;
+        stack.reserve(256);
+        stack.push_back(root);
+
+        while (stack.size() > 0)
+        {
+            unsigned int node = stack.back();
+            stack.pop_back();
+
+            if (node == NULL_NODE) continue;
+
+            // No particle of this subtree collides with the particle.
+            if ((nodes[node].mask & mask) == 0) continue;
+
+            // Test for overlap between the AABBs.
+            if (aabb.overlaps(nodes[node].aabb, touchIsOverlap))
+            {
+                // Check that we're at a leaf node.
+                if (nodes[node].isLeaf())
+                {
+                    // Can't interact with itself.
+                    if (nodes[node].particle != particle)
+                    {
+                        particles.push_back(nodes[node].particle);
+                    }
+                }
+                else
+                {
+                    stack.push_back(nodes[node].left);
+                    stack.push_back(nodes[node].right);
+                }
+            }
+        }
+    }
+
+    /// Whether a ray enters an AABB within a maximum distance.
+    template <typename Scalar>
+    static bool rayCrossesAABB(const AABBT<Scalar>& aabb,
+        const std::vector<double>& origin,
+        const std::vector<double>& direction, double maxDistance)
+    {
+        double tEnter = 0;
+        double tExit = maxDistance;
+        for (unsigned int i=0;i<origin.size();i++)
+        {
+            if (std::fpclassify(direction[i]) == FP_ZERO)
+            {
+                if (origin[i] < aabb.lowerBound[i] ||
+                    origin[i] > aabb.upperBound[i]) return false;
+                continue;
+            }
+
+            double t1 = (aabb.lowerBound[i] - origin[i]) / direction[i];
+            double t2 = (aabb.upperBound[i] - origin[i]) / direction[i];
+            if (t1 > t2) std::swap(t1, t2);
+            tEnter = std::max(tEnter, t1);
+            tExit = std::min(tExit, t2);
+            if (tEnter > tExit) return false;
+        }
+
+        return true;
+    }
+
+    template <typename Scalar>
+    void TreeT<Scalar>::queryRay(const std::vector<double>& origin,
+        const std::vector<double>& direction, double maxDistance,
+        const std::function<double(unsigned int, double)>& callback) const
+    {
+        // Make sure the tree isn't empty.
+        if (particleMap.size() == 0) return;
+
+        std::vector<unsigned int> stack;
+        stack.reserve(256);
+        stack.push_back(root);
+
+        while (stack.size() > 0)
+        {
+            unsigned int node = stack.back();
+            stack.pop_back();
+
+            if (node == NULL_NODE) continue;
+
+            if (!rayCrossesAABB(nodes[node].aabb, origin, direction, maxDistance))
+                continue;
+
+            if (nodes[node].isLeaf())
+            {
+                maxDistance = callback(nodes[node].particle, maxDistance);
+            }
+            else
+            {
+                stack.push_back(nodes[node].left);
+                stack.push_back(nodes[node].right);
+            }
+        }
+    }
+
+    template <typename Scalar>
+    void TreeT<Scalar>::queryRegion(const AABB& aabb,
+        std::vector<unsigned int>& particles) const
+    {
+        // Make sure the tree isn't empty.
+        if (particleMap.size() == 0) return;
+
+        std::vector<unsigned int> stack;
+        stack.reserve(256);
+        stack.push_back(root);
+
+        while (stack.size() > 0)
+        {
+            unsigned int node = stack.back();
+            stack.pop_back();
+
+            if (node == NULL_NODE) continue;
+
+            if (!aabb.overlaps(nodes[node].aabb, touchIsOverlap)) continue;
+
+            if (nodes[node].isLeaf())
+            {
+                particles.push_back(nodes[node].particle);
+            }
+            else
+            {
+                stack.push_back(nodes[node].left);
+                stack.push_back(nodes[node].right);
+            }
+        }
+    }
+
+    template <typename Scalar>
+    void TreeT<Scalar>::queryPairs(std::vector<std::pair<unsigned int, unsigned int>>& pairs)
+    {
+        if (root == NULL_NODE) return;
+
+        // Periodic boxes need shifted copies of the node AABBs, fall back to
+        // per particle queries and keep each pair once.
+        if (isPeriodic)
+        {
+            for (const auto& entry : particleMap)
+            {
+                auto result = query(entry.first);
+                for (auto other : result)
+                {
+                    if (entry.first < other)
+                        pairs.emplace_back(entry.first, other);
+                }
+            }
+            return;
+        }
+
+        // Internal nodes whose two subtrees have to be tested against each
+        // other, and pairs of subtrees that may contain overlapping leaves.
+        // The stacks are members, so that their storage is reused by the
+        // queries of later steps.
+        std::vector<unsigned int>& selfStack = pairsSelfStack;
+        std::vector<std::pair<unsigned int, unsigned int>>& pairStack = pairsPairStack;
+        selfStack.clear();
+        pairStack.clear();
+        selfStack.reserve(256);
+        pairStack.reserve(256);
+        selfStack.push_back(root);
+
+        while (selfStack.size() > 0)
+        {
+            unsigned int node = selfStack.back();
+            selfStack.pop_back();
+
+            if (nodes[node].isLeaf()) continue;
+
+            selfStack.push_back(nodes[node].left);
+            selfStack.push_back(nodes[node].right);
+            pairStack.emplace_back(nodes[node].left, nodes[node].right);
+
+            while (pairStack.size() > 0)
+            {
+                auto [a, b] = pairStack.back();
+                pairStack.pop_back();
+
+                const Node& nodeA = nodes[a];
+                const Node& nodeB = nodes[b];
+                // No particle of one subtree collides with the other.
+                if ((nodeA.mask & nodeB.mask) == 0) continue;
+                if (!nodeA.aabb.overlaps(nodeB.aabb, touchIsOverlap)) continue;
+
+                bool leafA = nodeA.isLeaf();
+                bool leafB = nodeB.isLeaf();
+                if (leafA && leafB)
+                {
+                    if (nodeA.particle < nodeB.particle)
+                        pairs.emplace_back(nodeA.particle, nodeB.particle);
+                    else
+                        pairs.emplace_back(nodeB.particle, nodeA.particle);
+                }
+                // Descend into the larger subtree first.
+                else if (leafB || (!leafA &&
+                    nodeA.aabb.getSurfaceArea() >= nodeB.aabb.getSurfaceArea()))
+                {
+                    pairStack.emplace_back(nodeA.left, b);
+                    pairStack.emplace_back(nodeA.right, b);
+                }
+                else
+                {
+                    pairStack.emplace_back(a, nodeB.left);
+                    pairStack.emplace_back(a, nodeB.right);
+                }
+            }
+        }
+    }
+
+    template <typename Scalar>
+    void TreeT<Scalar>::refitParticles(const std::vector<unsigned int>& particles,
+        const std::vector<std::vector<double>>& lowerBounds,
+        const std::vector<std::vector<double>>& upperBounds)
+    {
+        if ((particles.size() != lowerBounds.size()) ||
+            (particles.size() != upperBounds.size()))
+        {
+            throw std::invalid_argument("[ERROR]: Size mismatch!");
+        }
+
+        // Internal nodes that need their bounds recomputed.
+        std::vector<unsigned int> ancestors;
+
+        for (unsigned int n=0;n<particles.size();n++)
+        {
+            auto it = particleMap.find(particles[n]);
+            if (it == particleMap.end())
+            {
+                throw std::invalid_argument("[ERROR]: Invalid particle index!");
+            }
+
+            const std::vector<double>& lowerBound = lowerBounds[n];
+            const std::vector<double>& upperBound = upperBounds[n];
+            if ((lowerBound.size() != dimension) || (upperBound.size() != dimension))
+            {
+                throw std::invalid_argument("[ERROR]: Dimensionality mismatch!");
+            }
+
+            unsigned int node = it->second;
+            AABB& aabb = nodes[node].aabb;
+            for (unsigned int i=0;i<dimension;i++)
+            {
+                if (lowerBound[i] > upperBound[i])
+                {
+                    throw std::invalid_argument("[ERROR]: AABB lower bound is greater than the upper bound!");
+                }
+
+                // Fatten the new AABB.
+                double size = upperBound[i] - lowerBound[i];
+                aabb.lowerBound[i] = AABB::roundDown(lowerBound[i] - skinThickness * size);
+                aabb.upperBound[i] = AABB::roundUp(upperBound[i] + skinThickness * size);
+            }
+            aabb.surfaceArea = aabb.computeSurfaceArea();
+
+            for (unsigned int p = nodes[node].parent; p != NULL_NODE; p = nodes[p].parent)
+                ancestors.push_back(p);
+        }
+
+        // A parent is always higher than its children, so recomputing the
+        // ancestors in order of increasing height visits children first.
+        std::sort(ancestors.begin(), ancestors.end(),
+            [this](unsigned int lhs, unsigned int rhs)
+            {
+                return nodes[lhs].height < nodes[rhs].height ||
+                    (nodes[lhs].height == nodes[rhs].height && lhs < rhs);
+            });
+        ancestors.erase(std::unique(ancestors.begin(), ancestors.end()),
+            ancestors.end());
+
+        for (auto node : ancestors)
+        {
+            nodes[node].aabb.merge(nodes[nodes[node].left].aabb,
+                nodes[nodes[node].right].aabb);
+            nodes[node].mask = nodes[nodes[node].left].mask |
+                nodes[nodes[node].right].mask;
+        }
+    }
+
+    template <typename Scalar>
+    const AABBT<Scalar>& TreeT<Scalar>::getAABB(unsigned int particle)
     {
         return nodes[particleMap[particle]].aabb;
     }
 
-    void Tree::insertLeaf(unsigned int leaf)
+    template <typename Scalar>
+    void TreeT<Scalar>::insertLeaf(unsigned int leaf)
     {
         if (root == NULL_NODE)
         {
@@ -764,7 +1173,8 @@ namespace aabb
         unsigned int newParent = allocateNode();
         nodes[newParent].parent = oldParent;
         nodes[newParent].aabb.merge(leafAABB, nodes[sibling].aabb);
-        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].mask = nodes[leaf].mask | nodes[sibling].mask;
+        nodes[newParent].height = 1 + std::max(nodes[sibling].height, nodes[leaf].height);
 
         // The sibling was not the root.
         if (oldParent != NULL_NODE)
@@ -801,12 +1211,155 @@ namespace aabb
 
             nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
             nodes[index].aabb.merge(nodes[left].aabb, nodes[right].aabb);
+            nodes[index].mask = nodes[left].mask | nodes[right].mask;
 
             index = nodes[index].parent;
         }
     }
 
-    void Tree::removeLeaf(unsigned int leaf)
+    template <typename Scalar>
+    unsigned int TreeT<Scalar>::buildSubtree(std::vector<unsigned int>& leaves,
+        unsigned int begin, unsigned int end)
+    {
+        if (end - begin == 1)
+            return leaves[begin];
+
+        auto centre = [this](unsigned int leaf, unsigned int i)
+        {
+            return 0.5 * (nodes[leaf].aabb.lowerBound[i] + nodes[leaf].aabb.upperBound[i]);
+        };
+
+        // Split along the axis in which the centres spread the most.
+        std::array<double, DIMENSION> lower;
+        std::array<double, DIMENSION> upper;
+        lower.fill(std::numeric_limits<double>::max());
+        upper.fill(std::numeric_limits<double>::lowest());
+        for (unsigned int n=begin;n<end;n++)
+        {
+            for (unsigned int i=0;i<DIMENSION;i++)
+            {
+                lower[i] = std::min(lower[i], centre(leaves[n], i));
+                upper[i] = std::max(upper[i], centre(leaves[n], i));
+            }
+        }
+
+        unsigned int axis = 0;
+        for (unsigned int i=1;i<DIMENSION;i++)
+        {
+            if ((upper[i] - lower[i]) > (upper[axis] - lower[axis]))
+                axis = i;
+        }
+
+        unsigned int middle = begin + (end - begin) / 2;
+        double extent = upper[axis] - lower[axis];
+        if ((end - begin > 2) && (extent > 0))
+        {
+            // Binned surface area heuristic: sort the centres into bins
+            // along the axis and split between the two bins for which the
+            // areas of both halves weighted by their leaf counts are
+            // smallest.
+            const unsigned int nBins = 16;
+            std::array<unsigned int, nBins> binCount;
+            std::array<AABB, nBins> bins;
+            binCount.fill(0);
+            for (AABB& bin : bins)
+            {
+                bin.lowerBound.fill(std::numeric_limits<double>::max());
+                bin.upperBound.fill(std::numeric_limits<double>::lowest());
+            }
+            auto binOf = [&](unsigned int leaf)
+            {
+                double t = (centre(leaf, axis) - lower[axis]) / extent;
+                return std::min(nBins - 1, static_cast<unsigned int>(t * nBins));
+            };
+
+            for (unsigned int n=begin;n<end;n++)
+            {
+                const AABB& aabb = nodes[leaves[n]].aabb;
+                unsigned int bin = binOf(leaves[n]);
+                binCount[bin]++;
+                for (unsigned int i=0;i<DIMENSION;i++)
+                {
+                    bins[bin].lowerBound[i] = std::min(bins[bin].lowerBound[i], aabb.lowerBound[i]);
+                    bins[bin].upperBound[i] = std::max(bins[bin].upperBound[i], aabb.upperBound[i]);
+                }
+            }
+
+            // Sweep from the right to get the cost of the right halves,
+            // then from the left to find the cheapest split.
+            std::array<double, nBins> rightCost;
+            rightCost.fill(0);
+            AABB half;
+            half.lowerBound.fill(std::numeric_limits<double>::max());
+            half.upperBound.fill(std::numeric_limits<double>::lowest());
+            unsigned int count = 0;
+            for (unsigned int b=nBins-1;b>0;b--)
+            {
+                count += binCount[b];
+                if (binCount[b] != 0)
+                    half.merge(half, bins[b]);
+                rightCost[b - 1] = count ? count * half.getSurfaceArea() : 0;
+            }
+
+            half.lowerBound.fill(std::numeric_limits<double>::max());
+            half.upperBound.fill(std::numeric_limits<double>::lowest());
+            count = 0;
+            double minCost = std::numeric_limits<double>::max();
+            unsigned int split = nBins;
+            for (unsigned int b=0;b<nBins-1;b++)
+            {
+                count += binCount[b];
+                if (binCount[b] != 0)
+                    half.merge(half, bins[b]);
+                if ((count == 0) || (count == end - begin)) continue;
+
+                double cost = count * half.getSurfaceArea() + rightCost[b];
+                if (cost < minCost)
+                {
+                    minCost = cost;
+                    split = b;
+                }
+            }
+
+            if (split < nBins)
+            {
+                auto it = std::partition(leaves.begin() + begin,
+                    leaves.begin() + end,
+                    [&](unsigned int leaf) { return binOf(leaf) <= split; });
+                middle = static_cast<unsigned int>(it - leaves.begin());
+            }
+        }
+        else
+        {
+            // Too few leaves to bin, or all centres coincide along every
+            // axis: split at the median.
+            std::nth_element(leaves.begin() + begin, leaves.begin() + middle,
+                leaves.begin() + end,
+                [&](unsigned int lhs, unsigned int rhs)
+                {
+                    return centre(lhs, axis) < centre(rhs, axis);
+                });
+        }
+
+        unsigned int left = buildSubtree(leaves, begin, middle);
+        unsigned int right = buildSubtree(leaves, middle, end);
+
+        // Allocate the parent after its children, since allocating may
+        // resize the node pool.
+        unsigned int node = allocateNode();
+        nodes[node].left = left;
+        nodes[node].right = right;
+        nodes[node].height = 1 + std::max(nodes[left].height, nodes[right].height);
+        nodes[node].aabb.merge(nodes[left].aabb, nodes[right].aabb);
+        nodes[node].mask = nodes[left].mask | nodes[right].mask;
+        nodes[left].parent = node;
+        nodes[right].parent = node;
+
+        return node;
+    }
+
+    template <typename Scalar>
+    void TreeT<Scalar>::removeLeaf(unsigned int leaf)
     {
         if (leaf == root)
         {
@@ -840,6 +1393,8 @@ namespace aabb
                 unsigned int right = nodes[index].right;
 
                 nodes[index].aabb.merge(nodes[left].aabb, nodes[right].aabb);
+
+                nodes[index].mask = nodes[left].mask | nodes[right].mask;
                 nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
 
                 index = nodes[index].parent;
@@ -853,7 +1408,8 @@ namespace aabb
         }
     }
 
-    unsigned int Tree::balance(unsigned int node)
+    template <typename Scalar>
+    unsigned int TreeT<Scalar>::balance(unsigned int node)
     {
         assert(node != NULL_NODE);
 
@@ -901,7 +1457,9 @@ namespace aabb
                 nodes[node].right = rightRight;
                 nodes[rightRight].parent = node;
                 nodes[node].aabb.merge(nodes[left].aabb, nodes[rightRight].aabb);
+                nodes[node].mask = nodes[left].mask | nodes[rightRight].mask;
                 nodes[right].aabb.merge(nodes[node].aabb, nodes[rightLeft].aabb);
+                nodes[right].mask = nodes[node].mask | nodes[rightLeft].mask;
 
                 nodes[node].height = 1 + std::max(nodes[left].height, nodes[rightRight].height);
                 nodes[right].height = 1 + std::max(nodes[node].height, nodes[rightLeft].height);
@@ -912,7 +1470,9 @@ namespace aabb
                 nodes[node].right = rightLeft;
                 nodes[rightLeft].parent = node;
                 nodes[node].aabb.merge(nodes[left].aabb, nodes[rightLeft].aabb);
+                nodes[node].mask = nodes[left].mask | nodes[rightLeft].mask;
                 nodes[right].aabb.merge(nodes[node].aabb, nodes[rightRight].aabb);
+                nodes[right].mask = nodes[node].mask | nodes[rightRight].mask;
 
                 nodes[node].height = 1 + std::max(nodes[left].height, nodes[rightLeft].height);
                 nodes[right].height = 1 + std::max(nodes[node].height, nodes[rightRight].height);
@@ -954,7 +1514,9 @@ namespace aabb
                 nodes[node].left = leftRight;
                 nodes[leftRight].parent = node;
                 nodes[node].aabb.merge(nodes[right].aabb, nodes[leftRight].aabb);
+                nodes[node].mask = nodes[right].mask | nodes[leftRight].mask;
                 nodes[left].aabb.merge(nodes[node].aabb, nodes[leftLeft].aabb);
+                nodes[left].mask = nodes[node].mask | nodes[leftLeft].mask;
 
                 nodes[node].height = 1 + std::max(nodes[right].height, nodes[leftRight].height);
                 nodes[left].height = 1 + std::max(nodes[node].height, nodes[leftLeft].height);
@@ -965,7 +1527,9 @@ namespace aabb
                 nodes[node].left = leftLeft;
                 nodes[leftLeft].parent = node;
                 nodes[node].aabb.merge(nodes[right].aabb, nodes[leftLeft].aabb);
+                nodes[node].mask = nodes[right].mask | nodes[leftLeft].mask;
                 nodes[left].aabb.merge(nodes[node].aabb, nodes[leftRight].aabb);
+                nodes[left].mask = nodes[node].mask | nodes[leftRight].mask;
 
                 nodes[node].height = 1 + std::max(nodes[right].height, nodes[leftLeft].height);
                 nodes[left].height = 1 + std::max(nodes[node].height, nodes[leftRight].height);
@@ -977,12 +1541,14 @@ namespace aabb
         return node;
     }
 
-    unsigned int Tree::computeHeight() const
+    template <typename Scalar>
+    unsigned int TreeT<Scalar>::computeHeight() const
     {
         return computeHeight(root);
     }
 
-    unsigned int Tree::computeHeight(unsigned int node) const
+    template <typename Scalar>
+    unsigned int TreeT<Scalar>::computeHeight(unsigned int node) const
     {
         assert(node < nodeCapacity);
 
@@ -994,18 +1560,21 @@ namespace aabb
         return 1 + std::max(height1, height2);
     }
 
-    unsigned int Tree::getHeight() const
+    template <typename Scalar>
+    unsigned int TreeT<Scalar>::getHeight() const
     {
         if (root == NULL_NODE) return 0;
         return nodes[root].height;
     }
 
-    unsigned int Tree::getNodeCount() const
+    template <typename Scalar>
+    unsigned int TreeT<Scalar>::getNodeCount() const
     {
         return nodeCount;
     }
 
-    unsigned int Tree::computeMaximumBalance() const
+    template <typename Scalar>
+    unsigned int TreeT<Scalar>::computeMaximumBalance() const
     {
         unsigned int maxBalance = 0;
         for (unsigned int i=0; i<nodeCapacity; i++)
@@ -1022,7 +1591,8 @@ namespace aabb
         return maxBalance;
     }
 
-    double Tree::computeSurfaceAreaRatio() const
+    template <typename Scalar>
+    double TreeT<Scalar>::computeSurfaceAreaRatio() const
     {
         if (root == NULL_NODE) return 0.0;
 
@@ -1039,7 +1609,8 @@ namespace aabb
         return totalArea / rootArea;
     }
 
-    void Tree::validate() const
+    template <typename Scalar>
+    void TreeT<Scalar>::validate() const
     {
 #ifndef NDEBUG
         validateStructure(root);
@@ -1060,10 +1631,13 @@ namespace aabb
 #endif
     }
 
-    void Tree::rebuild()
+    template <typename Scalar>
+    void TreeT<Scalar>::rebuild()
     {
-        std::vector<unsigned int> nodeIndices(nodeCount);
-        unsigned int count = 0;
+        if (root == NULL_NODE) return;
+
+        std::vector<unsigned int> leaves;
+        leaves.reserve(particleMap.size());
 
         for (unsigned int i=0;i<nodeCapacity;i++)
         {
@@ -1073,61 +1647,88 @@ namespace aabb
             if (nodes[i].isLeaf())
             {
                 nodes[i].parent = NULL_NODE;
-                nodeIndices[count] = i;
-                count++;
+                leaves.push_back(i);
             }
             else freeNode(i);
         }
 
-        while (count > 1)
-        {
-            double minCost = std::numeric_limits<double>::max();
-            int iMin = -1, jMin = -1;
+        root = buildSubtree(leaves, 0, leaves.size());
+        nodes[root].parent = NULL_NODE;
+        reorderNodes();
 
-            for (unsigned int i=0;i<count;i++)
-            {
-                AABB aabbi = nodes[nodeIndices[i]].aabb;
+        validate();
+    }
 
-                for (unsigned int j=i+1;j<count;j++)
-                {
-                    AABB aabbj = nodes[nodeIndices[j]].aabb;
-                    AABB aabb;
-                    aabb.merge(aabbi, aabbj);
-                    double cost = aabb.getSurfaceArea();
+    template <typename Scalar>
+    void TreeT<Scalar>::reorderNodes()
+    {
+        if (root == NULL_NODE) return;
 
-                    if (cost < minCost)
-                    {
-                        iMin = i;
-                        jMin = j;
-                        minCost = cost;
-                    }
-                }
-            }
+        std::vector<Node> ordered;
+        ordered.reserve(nodeCapacity);
+        std::vector<unsigned int> index(nodeCapacity, NULL_NODE);
+
+        // Copy the nodes in depth-first order, left child first.
+        std::vector<unsigned int> stack;
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            unsigned int node = stack.back();
+            stack.pop_back();
 
-            unsigned int index1 = nodeIndices[iMin];
-            unsigned int index2 = nodeIndices[jMin];
+            index[node] = ordered.size();
+            ordered.push_back(nodes[node]);
 
-            unsigned int parent = allocateNode();
-            nodes[parent].left = index1;
-            nodes[parent].right = index2;
-            nodes[parent].height = 1 + std::max(nodes[index1].height, nodes[index2].height);
-            nodes[parent].aabb.merge(nodes[index1].aabb, nodes[index2].aabb);
-            nodes[parent].parent = NULL_NODE;
+            if (!nodes[node].isLeaf())
+            {
+                stack.push_back(nodes[node].right);
+                stack.push_back(nodes[node].left);
+            }
+        }
 
-            nodes[index1].parent = parent;
-            nodes[index2].parent = parent;
+        // Every allocated node is part of the tree.
+        unsigned int count = ordered.size();
+        assert(count == nodeCount);
 
-            nodeIndices[jMin] = nodeIndices[count-1];
-            nodeIndices[iMin] = parent;
-            count--;
+        // Relink the copies.
+        for (unsigned int i=0;i<count;i++)
+        {
+            Node& node = ordered[i];
+            if (node.parent != NULL_NODE) node.parent = index[node.parent];
+            if (node.isLeaf())
+            {
+                particleMap[node.particle] = i;
+            }
+            else
+            {
+                node.left = index[node.left];
+                node.right = index[node.right];
+            }
         }
 
-        root = nodeIndices[0];
+        // Move the free nodes to the end of the pool.
+        ordered.resize(nodeCapacity);
+        for (unsigned int i=count;i<nodeCapacity;i++)
+        {
+            ordered[i].next = i + 1;
+            ordered[i].height = -1;
+        }
+        if (count < nodeCapacity)
+        {
+            ordered[nodeCapacity-1].next = NULL_NODE;
+            freeList = count;
+        }
+        else
+        {
+            freeList = NULL_NODE;
+        }
 
-        validate();
+        nodes.swap(ordered);
+        root = 0;
     }
 
-    void Tree::validateStructure(unsigned int node) const
+    template <typename Scalar>
+    void TreeT<Scalar>::validateStructure(unsigned int node) const
     {
         if (node == NULL_NODE) return;
 
@@ -1154,7 +1755,8 @@ namespace aabb
         validateStructure(right);
     }
 
-    void Tree::validateMetrics(unsigned int node) const
+    template <typename Scalar>
+    void TreeT<Scalar>::validateMetrics(unsigned int node) const
     {
         if (node == NULL_NODE) return;
 
@@ -1177,6 +1779,7 @@ namespace aabb
         int height = 1 + std::max(height1, height2);
         (void)height; // Unused variable in Release build
         assert(nodes[node].height == height);
+        assert(nodes[node].mask == (nodes[left].mask | nodes[right].mask));
 
         AABB aabb;
         aabb.merge(nodes[left].aabb, nodes[right].aabb);
@@ -1191,7 +1794,8 @@ namespace aabb
         validateMetrics(right);
     }
 
-    void Tree::periodicBoundaries(std::vector<double>& position)
+    template <typename Scalar>
+    void TreeT<Scalar>::periodicBoundaries(std::vector<double>& position)
     {
         for (unsigned int i=0;i<dimension;i++)
         {
@@ -1209,7 +1813,8 @@ namespace aabb
         }
     }
 
-    bool Tree::minimumImage(std::vector<double>& separation, std::vector<double>& shift)
+    template <typename Scalar>
+    bool TreeT<Scalar>::minimumImage(std::vector<double>& separation, std::vector<double>& shift)
     {
         bool isShifted = false;
 
@@ -1235,4 +1840,11 @@ namespace aabb
 
         return isShifted;
     }
+
+    template class AABBT<float>;
+    template class AABBT<double>;
+    template struct NodeT<float>;
+    template struct NodeT<double>;
+    template class TreeT<float>;
+    template class TreeT<double>;
 }
@@ -22,46 +22,65 @@
 
   This code was adapted from parts of the Box2D Physics Engine,
   http://www.box2d.org
+
+  This is an altered version of the original aabbcc source: batched pair
+  queries, leaf refitting and bulk building were added for gz-physics, and
+  the tree was restricted to 3D so that nodes store their bounds inline,
+  and templated on the scalar type of the bounds.
 */
 
 #ifndef _AABB_H
 #define _AABB_H
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 /// Null node flag.
 const unsigned int NULL_NODE = 0xffffffff;
 
+/// Collision mask that collides with every other mask.
+const unsigned int ALL_MASKS = 0xffffffff;
+
+/// Dimensionality of the boxes and the tree.
+const unsigned int DIMENSION = 3;
+
 namespace aabb
 {
     /*! \brief The axis-aligned bounding box object.
 
         Axis-aligned bounding boxes (AABBs) store information for the minimum
-        orthorhombic bounding-box for an object. Support is provided for
-        dimensions >= 2. (In 2D the bounding box is either a rectangle,
-        in 3D it is a rectangular prism.)
+        orthorhombic bounding-box for an object. Only 3D boxes are supported,
+        whose bounds are stored inline so that boxes can be copied and
+        stored in contiguous arrays without any allocation. The bounds are
+        stored as Scalar, float or double; bounds given as double are
+        rounded outwards so that a box of a lower precision still contains
+        them.
 
         Class member functions provide functionality for merging AABB objects
         and testing overlap with other AABBs.
      */
-    class AABB
+    template <typename Scalar>
+    class AABBT
     {
     public:
         /// Constructor.
-        AABB();
+        AABBT();
 
         //! Constructor.
         /*! \param dimension
                 The dimensionality of the system.
          */
-        explicit AABB(unsigned int);
+        explicit AABBT(unsigned int);
 
         //! Constructor.
         /*! \param lowerBound_
@@ -70,7 +89,7 @@ namespace aabb
             \param upperBound_
                 The upper bound in each dimension.
          */
-        AABB(const std::vector<double>&, const std::vector<double>&);
+        AABBT(const std::vector<double>&, const std::vector<double>&);
 
         /// Compute the surface area of the box.
         double computeSurfaceArea() const;
@@ -85,7 +104,7 @@ namespace aabb
             \param aabb2
                 A reference to the second AABB.
          */
-        void merge(const AABB&, const AABB&);
+        void merge(const AABBT&, const AABBT&);
 
         //! Test whether the AABB is contained within this one.
         /*! \param aabb
@@ -94,7 +113,7 @@ namespace aabb
             \return
                 Whether the AABB is fully contained.
          */
-        bool contains(const AABB&) const;
+        bool contains(const AABBT&) const;
 
         //! Test whether the AABB overlaps this one.
         /*! \param aabb
@@ -106,28 +125,38 @@ namespace aabb
             \return
                 Whether the AABB overlaps.
          */
-        bool overlaps(const AABB&, bool touchIsOverlap) const;
+        bool overlaps(const AABBT&, bool touchIsOverlap) const;
 
         //! Compute the centre of the AABB.
         /*! \returns
                 The position vector of the AABB centre.
          */
-        std::vector<double> computeCentre();
+        std::array<double, DIMENSION> computeCentre() const;
 
-        //! Set the dimensionality of the AABB.
-        /*! \param dimension
-                The dimensionality of the system.
+        //! Round a lower bound to the scalar type.
+        /*! \param bound
+                The lower bound.
+
+            \return
+                The largest scalar that is not greater than the bound, so
+                that a box of a lower precision never shrinks.
          */
-        void setDimension(unsigned int);
+        static Scalar roundDown(double);
+
+        //! Round an upper bound to the scalar type.
+        /*! \param bound
+                The upper bound.
+
+            \return
+                The smallest scalar that is not less than the bound.
+         */
+        static Scalar roundUp(double);
 
         /// Lower bound of AABB in each dimension.
-        std::vector<double> lowerBound;
+        std::array<Scalar, DIMENSION> lowerBound;
 
         /// Upper bound of AABB in each dimension.
-        std::vector<double> upperBound;
-
-        /// The position of the AABB centre.
-        std::vector<double> centre;
+        std::array<Scalar, DIMENSION> upperBound;
 
         /// The AABB's surface area.
         double surfaceArea;
@@ -145,13 +174,14 @@ namespace aabb
         function allows the tree to query whether the node is a leaf, i.e. to
         determine whether it holds a single particle.
      */
-    struct Node
+    template <typename Scalar>
+    struct NodeT
     {
         /// Constructor.
-        Node();
+        NodeT();
 
         /// The fattened axis-aligned bounding box.
-        AABB aabb;
+        AABBT<Scalar> aabb;
 
         /// Index of the parent node.
         unsigned int parent;
@@ -171,6 +201,11 @@ namespace aabb
         /// The index of the particle that the node contains (leaf nodes only).
         unsigned int particle;
 
+        /// Collision mask of the particle for a leaf, and the union of the
+        /// masks of its subtree otherwise. Two particles are only reported
+        /// as overlapping if their masks share a bit.
+        unsigned int mask;
+
         //! Test whether the node is a leaf.
         /*! \return
                 Whether the node is a leaf node.
@@ -186,9 +221,16 @@ namespace aabb
         periodic and non-periodic boxes, as well as boxes with partial
         periodicity, e.g. periodic along specific axes.
      */
-    class Tree
+    template <typename Scalar>
+    class TreeT
     {
     public:
+        /// The box type of the tree.
+        using AABB = AABBT<Scalar>;
+
+        /// The node type of the tree.
+        using Node = NodeT<Scalar>;
+
         //! Constructor (non-periodic).
         /*! \param dimension_
                 The dimensionality of the system.
@@ -203,7 +245,7 @@ namespace aabb
             \param touchIsOverlap
                 Does touching count as overlapping in query operations?
          */
-        Tree(unsigned int dimension_= 3, double skinThickness_ = 0.05,
+        TreeT(unsigned int dimension_= 3, double skinThickness_ = 0.05,
             unsigned int nParticles = 16, bool touchIsOverlap=true);
 
         //! Constructor (custom periodicity).
@@ -226,7 +268,7 @@ namespace aabb
             \param touchIsOverlap
                 Does touching count as overlapping in query operations?
          */
-        Tree(unsigned int, double, const std::vector<bool>&, const std::vector<double>&,
+        TreeT(unsigned int, double, const std::vector<bool>&, const std::vector<double>&,
             unsigned int nParticles = 16, bool touchIsOverlap=true);
 
         //! Set the periodicity of the simulation box.
@@ -265,9 +307,50 @@ namespace aabb
          */
         void insertParticle(unsigned int, std::vector<double>&, std::vector<double>&);
 
+        //! Insert many particles into the tree in a single pass.
+        /*! The leaves are built into a subtree top-down, splitting them
+            along the widest axis of their centres with the binned surface
+            area heuristic, and the subtree
+            is then inserted like a single leaf. This is much cheaper than
+            inserting the particles one by one, where every insertion
+            searches the tree for a sibling and rebalances the path to the
+            root.
+
+            \param particles
+                The particle indices.
+
+            \param lowerBounds
+                The lower bound of each particle.
+
+            \param upperBounds
+                The upper bound of each particle.
+         */
+        void insertParticles(const std::vector<unsigned int>&,
+            const std::vector<std::vector<double>>&,
+            const std::vector<std::vector<double>>&);
+
         /// Return the number of particles in the tree.
         unsigned int nParticles();
 
+        //! Test whether a particle is in the tree.
+        /*! \param particle
+                The particle index.
+
+            \return
+                Whether the particle is in the tree.
+         */
+        bool hasParticle(unsigned int) const;
+
+        //! Set the collision mask of a particle.
+        /*! Queries skip subtrees whose masks share no bit with the mask of
+            the queried particle. Particles are inserted with ALL_MASKS.
+            \param particle
+                The particle index.
+            \param mask
+                The collision mask.
+         */
+        void setParticleMask(unsigned int, unsigned int);
+
         //! Remove a particle from the tree.
         /*! \param particle
                 The particle index (particleMap will be used to map the node).
@@ -340,6 +423,85 @@ namespace aabb
          */
         std::vector<unsigned int> query(const AABB&);
 
+        //! Query the tree for all pairs of particles with overlapping AABBs.
+        /*! Each pair is reported exactly once, with the smaller particle
+            index first. Existing contents of the output vector are kept.
+
+            \param pairs
+                The vector to append particle index pairs to.
+         */
+        void queryPairs(std::vector<std::pair<unsigned int, unsigned int>>&);
+
+        //! Query the tree to find candidate interactions for a particle.
+        /*! Same as query(unsigned int) but appends to a caller provided
+            vector to avoid allocating a new one for each query.
+
+            \param particle
+                The particle index.
+
+            \param particles
+                The vector to append particle indices to.
+         */
+        void query(unsigned int, std::vector<unsigned int>&);
+
+        //! Query the tree for the particles whose AABB is crossed by a ray.
+        /*! Subtrees whose AABB the ray does not cross within the current
+            maximum distance are skipped. The callback returns the new
+            maximum distance, e.g. the distance to the closest hit found so
+            far, which prunes the rest of the traversal. Periodic boxes are
+            not supported. The tree is not modified, so rays can be cast
+            concurrently.
+
+            \param origin
+                The start of the ray.
+
+            \param direction
+                The direction of the ray. Distances are measured in
+                multiples of it.
+
+            \param maxDistance
+                The length of the ray.
+
+            \param callback
+                Called with each particle crossed by the ray and the current
+                maximum distance.
+         */
+        void queryRay(const std::vector<double>&, const std::vector<double>&,
+            double, const std::function<double(unsigned int, double)>&) const;
+
+        //! Query the tree for the particles whose AABB overlaps a region.
+        /*! Unlike query(const AABB&), the region does not have to belong to
+            a particle and the tree is not modified, so regions can be
+            queried concurrently. Periodic boxes are not supported.
+
+            \param aabb
+                The region.
+
+            \param particles
+                The vector to append particle indices to.
+         */
+        void queryRegion(const AABB&, std::vector<unsigned int>&) const;
+
+        //! Refit the AABBs of many particles in a single pass.
+        /*! Unlike updateParticle, the leaves are not removed and reinserted.
+            The new (fattened) AABBs are assigned to the leaves and the
+            bounds of all affected ancestors are recomputed bottom-up. This
+            is cheaper when many particles move by small amounts, but the
+            tree quality may degrade over time; call rebuild() to restore it.
+
+            \param particles
+                The particle indices.
+
+            \param lowerBounds
+                The lower bound of each particle.
+
+            \param upperBounds
+                The upper bound of each particle.
+         */
+        void refitParticles(const std::vector<unsigned int>&,
+            const std::vector<std::vector<double>>&,
+            const std::vector<std::vector<double>>&);
+
         //! Get a particle AABB.
         /*! \param particle
                 The particle index.
@@ -375,7 +537,12 @@ namespace aabb
         /// Validate the tree.
         void validate() const;
 
-        /// Rebuild an optimal tree.
+        //! Rebuild the tree from its leaves.
+        /*! The tree is built top-down in O(n log n) with the binned surface
+            area heuristic, see insertParticles, and its nodes are laid out
+            in depth-first order. Use this to restore the quality of a tree
+            after many refits or updates.
+         */
         void rebuild();
 
     private:
@@ -421,6 +588,12 @@ namespace aabb
         /// Does touching count as overlapping in tree queries?
         bool touchIsOverlap;
 
+        /// Stack of internal nodes of queryPairs, reused across calls.
+        std::vector<unsigned int> pairsSelfStack;
+
+        /// Stack of pairs of subtrees of queryPairs, reused across calls.
+        std::vector<std::pair<unsigned int, unsigned int>> pairsPairStack;
+
         //! Allocate a new node.
         /*! \return
                 The index of the allocated node.
@@ -439,6 +612,30 @@ namespace aabb
          */
         void insertLeaf(unsigned int);
 
+        //! Build a subtree from a range of leaf nodes.
+        /*! \param leaves
+                The leaf node indices, reordered while building.
+
+            \param begin
+                The first leaf of the range.
+
+            \param end
+                One past the last leaf of the range.
+
+            \return
+                The index of the root node of the subtree.
+         */
+        unsigned int buildSubtree(std::vector<unsigned int>&, unsigned int,
+            unsigned int);
+
+        //! Lay the nodes out in depth-first order.
+        /*! The children of a node are stored next to it or after its left
+            subtree, and the leaves of a subtree are stored together, so that
+            traversals walk the node pool mostly forward. Free nodes are moved
+            to the end of the pool.
+         */
+        void reorderNodes();
+
         //! Remove a leaf from the tree.
         /*! \param leaf
                 The index of the leaf node.
@@ -496,6 +693,18 @@ namespace aabb
          */
         bool minimumImage(std::vector<double>&, std::vector<double>&);
     };
+
+    /// Boxes, nodes and trees of double precision.
+    using AABB = AABBT<double>;
+    using Node = NodeT<double>;
+    using Tree = TreeT<double>;
+
+    extern template class AABBT<float>;
+    extern template class AABBT<double>;
+    extern template struct NodeT<float>;
+    extern template struct NodeT<double>;
+    extern template class TreeT<float>;
+    extern template class TreeT<double>;
 }
 
 #endif /* _AABB_H */
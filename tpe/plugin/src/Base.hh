@@ -19,10 +19,15 @@
 #define GZ_PHYSICS_TPE_PLUGIN_SRC_BASE_HH_
 
 #include <gz/physics/Implements.hh>
+#include <gz/physics/MemoryResource.hh>
+#include <gz/physics/TaskScheduler.hh>
+#include <gz/physics/WorldPlacement.hh>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "lib/src/World.hh"
 #include "lib/src/Engine.hh"
@@ -42,16 +47,50 @@ namespace tpeplugin {
 struct WorldInfo
 {
   std::shared_ptr<tpelib::World> world;
+
+  /// \brief Time spent writing the poses of the last step, in seconds
+  double poseWriteTime = 0.0;
+
+  /// \brief Heap allocations of writing the poses of the last step
+  std::size_t poseWriteAllocations = 0u;
+
+  /// \brief Placement of the world, see WorldPlacementFeature
+  WorldPlacement placement;
+
+  /// \brief Threads pinned to the cores of the placement, nullptr if the
+  /// world is not placed
+  std::shared_ptr<TaskScheduler> placementScheduler;
+
+  /// \brief Memory on the node of the placement, nullptr if the world is
+  /// not placed
+  std::shared_ptr<MemoryResource> placementMemory;
 };
 
 struct ModelInfo
 {
   tpelib::Model *model;
+
+  /// \brief Pose that the last change of the model was compared to when
+  /// writing the changed poses of a step
+  math::Pose3d reportedPose;
+
+  /// \brief Whether reportedPose is set
+  bool hasReportedPose = false;
 };
 
 struct LinkInfo
 {
   tpelib::Link *link;
+
+  /// \brief Pose of the link that was last written to the changed poses
+  math::Pose3d reportedPose;
+
+  /// \brief Whether reportedPose is set
+  bool hasReportedPose = false;
+
+  /// \brief Number of the last write of the changed poses that reported
+  /// the link, see SimulationFeatures::Write
+  std::size_t reportedWrite = 0u;
 };
 
 struct CollisionInfo
@@ -125,8 +164,9 @@ class Base : public Implements3d<FeatureList<Feature>>
   public: inline Identity AddWorld(std::shared_ptr<tpelib::World> _world)
   {
     size_t worldId = _world->GetId();
-    auto worldPtr = std::make_shared<WorldInfo>();
+    auto worldPtr = MakeShared<WorldInfo>(this->memoryResource);
     worldPtr->world = _world;
+    this->UpdateWorldResources(*worldPtr);
     this->worlds.insert({worldId, worldPtr});
     this->childIdToParentId.insert({worldId, -1});
     return this->GenerateIdentity(worldId, worldPtr);
@@ -134,7 +174,7 @@ class Base : public Implements3d<FeatureList<Feature>>
 
   public: inline Identity AddModel(std::size_t _parentId, tpelib::Model &_model)
   {
-    auto modelPtr = std::make_shared<ModelInfo>();
+    auto modelPtr = MakeShared<ModelInfo>(this->memoryResource);
     modelPtr->model = &_model;
     size_t modelId = _model.GetId();
     this->models.insert({modelId, modelPtr});
@@ -146,7 +186,7 @@ class Base : public Implements3d<FeatureList<Feature>>
 
   public: inline Identity AddLink(std::size_t _modelId, tpelib::Link &_link)
   {
-    auto linkPtr = std::make_shared<LinkInfo>();
+    auto linkPtr = MakeShared<LinkInfo>(this->memoryResource);
     linkPtr->link = &_link;
     size_t linkId = _link.GetId();
     this->links.insert({linkId, linkPtr});
@@ -159,7 +199,7 @@ class Base : public Implements3d<FeatureList<Feature>>
   public: inline Identity AddCollision(std::size_t _linkId,
     tpelib::Collision &_collision)
   {
-    auto collisionPtr = std::make_shared<CollisionInfo>();
+    auto collisionPtr = MakeShared<CollisionInfo>(this->memoryResource);
     collisionPtr->collision = &_collision;
     size_t collisionId = _collision.GetId();
     this->collisions.insert({collisionId, collisionPtr});
@@ -223,6 +263,59 @@ class Base : public Implements3d<FeatureList<Feature>>
     return result;
   }
 
+  /// \brief Set the task scheduler of the engine and of its worlds
+  /// \param[in] _scheduler Scheduler, or nullptr for worker pools
+  public: inline void SetTaskScheduler(
+      std::shared_ptr<TaskScheduler> _scheduler)
+  {
+    this->taskScheduler = std::move(_scheduler);
+    this->taskRunner = nullptr;
+    if (this->taskScheduler)
+    {
+      std::shared_ptr<TaskScheduler> scheduler = this->taskScheduler;
+      this->taskRunner = [scheduler](std::size_t _count,
+          const std::function<void(std::size_t)> &_task)
+      {
+        scheduler->Run(_count, _task);
+      };
+    }
+
+    for (auto &world : this->worlds)
+      this->UpdateWorldResources(*world.second);
+  }
+
+  /// \brief Give a world the task runner and memory resource of the engine,
+  /// or those of its placement if it is placed and the engine has none
+  /// \param[in] _info World to update
+  public: inline void UpdateWorldResources(WorldInfo &_info) const
+  {
+    tpelib::TaskRunner runner = this->taskRunner;
+    if (_info.placementScheduler)
+    {
+      std::shared_ptr<TaskScheduler> scheduler = _info.placementScheduler;
+      runner = [scheduler](std::size_t _count,
+          const std::function<void(std::size_t)> &_task)
+      {
+        scheduler->Run(_count, _task);
+      };
+    }
+    _info.world->SetTaskRunner(runner);
+    _info.world->SetMemoryResource(
+        this->memoryResource ? this->memoryResource : _info.placementMemory);
+  }
+
+  /// \brief Scheduler of the parallel work of the engine, nullptr if the
+  /// engine uses worker pools of its own, see TaskSchedulerFeature
+  public: std::shared_ptr<TaskScheduler> taskScheduler;
+
+  /// \brief Runs tasks on taskScheduler, empty without a scheduler
+  public: tpelib::TaskRunner taskRunner;
+
+  /// \brief Memory that the worlds, their entities and the structs above
+  /// are allocated from, nullptr for the global heap, see
+  /// MemoryResourceFeature
+  public: std::shared_ptr<MemoryResource> memoryResource;
+
   public: std::map<std::size_t, std::shared_ptr<WorldInfo>> worlds;
   public: std::map<std::size_t, std::shared_ptr<ModelInfo>> models;
   public: std::map<std::size_t, std::shared_ptr<LinkInfo>> links;
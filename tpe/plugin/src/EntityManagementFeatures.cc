@@ -15,7 +15,11 @@
  *
 */
 
+#include <memory>
 #include <string>
+#include <utility>
+
+#include <gz/physics/AllocationCounter.hh>
 
 #include "EntityManagementFeatures.hh"
 
@@ -440,8 +444,13 @@ bool EntityManagementFeatures::RemoveNestedModelByName(
 Identity EntityManagementFeatures::ConstructEmptyWorld(
   const Identity &, const std::string &_name)
 {
-  auto world = std::make_shared<tpelib::World>();
+  auto world = MakeShared<tpelib::World>(this->memoryResource);
   world->SetName(_name);
+  // Contacts are reported between shapes, so the models that the
+  // broadphase pairs are refined to their collisions
+  world->SetShapeContacts(true);
+  if (AllocationCountingEnabled())
+    world->SetAllocationCounter(&AllocationCount);
   return this->AddWorld(world);
 }
 
@@ -517,3 +526,22 @@ void EntityManagementFeatures::RemoveCollisionFilterMask(
   // remove = reset to default bitmask
   collision->SetCollideBitmask(0xFF);
 }
+
+/////////////////////////////////////////////////
+void EntityManagementFeatures::SetEngineMemoryResource(
+    const Identity &/*_engineID*/, std::shared_ptr<MemoryResource> _resource)
+{
+  this->memoryResource = std::move(_resource);
+
+  // Entities added to existing worlds are allocated from the new resource
+  for (auto &world : this->worlds)
+    this->UpdateWorldResources(*world.second);
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<MemoryResource>
+EntityManagementFeatures::GetEngineMemoryResource(
+    const Identity &/*_engineID*/) const
+{
+  return this->memoryResource;
+}
@@ -18,6 +18,7 @@
 #ifndef GZ_PHYSICS_TPE_PLUGIN_SRC_GETENTITIESFEATURE_HH_
 #define GZ_PHYSICS_TPE_PLUGIN_SRC_GETENTITIESFEATURE_HH_
 
+#include <memory>
 #include <string>
 
 #include <gz/physics/ConstructEmpty.hh>
@@ -25,6 +26,7 @@
 #include <gz/physics/GetEntities.hh>
 #include <gz/physics/RemoveEntities.hh>
 #include <gz/physics/Implements.hh>
+#include <gz/physics/MemoryResourceFeature.hh>
 
 #include "Base.hh"
 
@@ -44,7 +46,8 @@ struct EntityManagementFeatureList : FeatureList<
   ConstructEmptyModelFeature,
   ConstructEmptyNestedModelFeature,
   ConstructEmptyLinkFeature,
-  CollisionFilterMaskFeature
+  CollisionFilterMaskFeature,
+  MemoryResourceFeature
 > { };
 
 class EntityManagementFeatures :
@@ -166,6 +169,14 @@ class EntityManagementFeatures :
       const Identity &_shapeID) const override;
 
   public: void RemoveCollisionFilterMask(const Identity &_shapeID) override;
+
+  // ----- Memory resource -----
+  public: void SetEngineMemoryResource(
+      const Identity &_engineID,
+      std::shared_ptr<MemoryResource> _resource) override;
+
+  public: std::shared_ptr<MemoryResource> GetEngineMemoryResource(
+      const Identity &_engineID) const override;
 };
 
 }
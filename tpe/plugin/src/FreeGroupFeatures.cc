@@ -97,7 +97,7 @@ Identity FreeGroupFeatures::GetFreeGroupRootLink(const Identity &_groupID) const
     auto *rootLink = FindModelRootLink(modelIt->second->model);
     if (nullptr != rootLink)
     {
-      auto linkPtr = std::make_shared<LinkInfo>();
+      auto linkPtr = MakeShared<LinkInfo>(this->memoryResource);
       linkPtr->link = rootLink;
       return this->GenerateIdentity(rootLink->GetId(), linkPtr);
     }
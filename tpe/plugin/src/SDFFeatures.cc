@@ -21,6 +21,7 @@
 #include <sdf/Capsule.hh>
 #include <sdf/Cylinder.hh>
 #include <sdf/Ellipsoid.hh>
+#include <sdf/Plane.hh>
 #include <sdf/Sphere.hh>
 #include <sdf/Geometry.hh>
 #include <sdf/World.hh>
@@ -134,6 +135,25 @@ Identity SDFFeatures::ConstructSdfModel(
   return modelIdentity;
 }
 
+/////////////////////////////////////////////////
+std::vector<Identity> SDFFeatures::ConstructSdfModels(
+  const Identity &_worldID,
+  const std::vector<const ::sdf::Model *> &_sdfModels)
+{
+  // tpelib adds new collisions to its AABB tree on the next step, in one
+  // pass for all the collisions created since the previous step.
+  std::vector<Identity> result;
+  result.reserve(_sdfModels.size());
+  for (const ::sdf::Model *sdfModel : _sdfModels)
+  {
+    if (sdfModel)
+      result.push_back(this->ConstructSdfModel(_worldID, *sdfModel));
+    else
+      result.push_back(this->GenerateInvalidId());
+  }
+  return result;
+}
+
 /////////////////////////////////////////////////
 Identity SDFFeatures::ConstructSdfNestedModel(
   const Identity &_parentID,
@@ -307,6 +327,14 @@ Identity SDFFeatures::ConstructSdfCollision(
     shape.SetRadii(ellipsoidSdf->Radii());
     collision->SetShape(shape);
   }
+  else if (geom->Type() == ::sdf::GeometryType::PLANE)
+  {
+    // planes are infinite, see tpelib::PlaneShape. Their size is ignored.
+    const auto planeSdf = geom->PlaneShape();
+    tpelib::PlaneShape shape;
+    shape.SetNormal(planeSdf->Normal());
+    collision->SetShape(shape);
+  }
   else if (geom->Type() == ::sdf::GeometryType::SPHERE)
   {
     const auto sphereSdf = geom->SphereShape();
@@ -18,6 +18,8 @@
 #ifndef GZ_PHYSICS_TPE_PLUGIN_SRC_SDFFEATURES_HH_
 #define GZ_PHYSICS_TPE_PLUGIN_SRC_SDFFEATURES_HH_
 
+#include <vector>
+
 #include <gz/physics/sdf/ConstructCollision.hh>
 #include <gz/physics/sdf/ConstructLink.hh>
 #include <gz/physics/sdf/ConstructModel.hh>
@@ -35,6 +37,7 @@ namespace tpeplugin {
 using SDFFeatureList = FeatureList<
   sdf::ConstructSdfWorld,
   sdf::ConstructSdfModel,
+  sdf::ConstructSdfModels,
   sdf::ConstructSdfNestedModel,
   sdf::ConstructSdfLink,
   sdf::ConstructSdfCollision
@@ -52,6 +55,10 @@ class SDFFeatures :
     const Identity &_worldID,
     const ::sdf::Model &_sdfModel) override;
 
+  public: std::vector<Identity> ConstructSdfModels(
+    const Identity &_worldID,
+    const std::vector<const ::sdf::Model *> &_sdfModels) override;
+
   public: Identity ConstructSdfNestedModel(
     const Identity &_parentID,
     const ::sdf::Model &_sdfModel) override;
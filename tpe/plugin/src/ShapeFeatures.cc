@@ -15,9 +15,16 @@
  *
 */
 
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <gz/math/eigen3/Conversions.hh>
 #include <gz/math/Pose3.hh>
 #include <gz/common/Console.hh>
+#include <gz/common/geospatial/HeightmapData.hh>
+#include <gz/math/Helpers.hh>
 
 #include "ShapeFeatures.hh"
 
@@ -25,6 +32,76 @@ using namespace gz;
 using namespace physics;
 using namespace tpeplugin;
 
+/////////////////////////////////////////////////
+/// \brief Add the world bounding boxes of the collisions below an entity.
+/// \param[in] _entity Entity whose descendants are visited.
+/// \param[in] _pose World pose of _entity.
+/// \param[out] _storage Storage to add the bounding boxes to.
+static void AddCollisionBoundingBoxes(const tpelib::Entity &_entity,
+    const math::Pose3d &_pose,
+    ShapeFeatures::ShapeBoundingBoxStorage &_storage)
+{
+  for (const auto &[id, child] : _entity.GetChildren())
+  {
+    const math::Pose3d pose = _pose * child->GetPose();
+    const auto *collision = dynamic_cast<tpelib::Collision *>(child.get());
+    if (collision)
+    {
+      // The shape keeps its bounding box until its size changes
+      tpelib::Shape *shape = collision->GetShape();
+      if (shape)
+      {
+        _storage.Add(id, math::eigen3::convert(pose),
+            math::eigen3::convert(shape->GetBoundingBox()));
+      }
+      continue;
+    }
+
+    AddCollisionBoundingBoxes(*child, pose, _storage);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Add the world bounding boxes of the links and models below an
+/// entity.
+/// \param[in] _entity World or model whose descendants are visited.
+/// \param[in] _pose World pose of _entity.
+/// \param[out] _links Storage to add the link bounding boxes to, or nullptr.
+/// \param[out] _models Storage to add the model bounding boxes to, or
+/// nullptr.
+static void AddLinkBoundingBoxes(const tpelib::Entity &_entity,
+    const math::Pose3d &_pose,
+    ShapeFeatures::BoundingBoxStorage *_links,
+    ShapeFeatures::BoundingBoxStorage *_models)
+{
+  AlignedBox3d modelBox;
+  for (const auto &[id, child] : _entity.GetChildren())
+  {
+    const math::Pose3d pose = _pose * child->GetPose();
+    if (dynamic_cast<tpelib::Link *>(child.get()))
+    {
+      // The link keeps the bounding box of its collisions until they change
+      const AlignedBox3d localBox =
+          math::eigen3::convert(child->GetBoundingBox());
+      if (localBox.isEmpty())
+        continue;
+
+      const AlignedBox3d box = physics::detail::TransformAlignedBox(
+          math::eigen3::convert(pose), localBox);
+      if (_links)
+        _links->Add(id, box);
+      modelBox.extend(box);
+    }
+    else if (dynamic_cast<tpelib::Model *>(child.get()))
+    {
+      AddLinkBoundingBoxes(*child, pose, _links, _models);
+    }
+  }
+
+  if (_models && !modelBox.isEmpty())
+    _models->Add(_entity.GetId(), modelBox);
+}
+
 /////////////////////////////////////////////////
 Identity ShapeFeatures::CastToBoxShape(const Identity &_shapeID) const
 {
@@ -347,6 +424,81 @@ Identity ShapeFeatures::AttachSphereShape(
   return this->GenerateInvalidId();
 }
 
+/////////////////////////////////////////////////
+Identity ShapeFeatures::CastToHeightmapShape(
+  const Identity &_shapeID) const
+{
+  auto it = this->collisions.find(_shapeID);
+  if (it != this->collisions.end() && it->second != nullptr)
+  {
+    auto *shape = it->second->collision->GetShape();
+    if (shape != nullptr && dynamic_cast<tpelib::HeightmapShape*>(shape))
+      return this->GenerateIdentity(_shapeID, it->second);
+  }
+  return this->GenerateInvalidId();
+}
+
+/////////////////////////////////////////////////
+LinearVector3d ShapeFeatures::GetHeightmapShapeSize(
+  const Identity &_heightmapID) const
+{
+  auto it = this->collisions.find(_heightmapID);
+  if (it != this->collisions.end() && it->second != nullptr)
+  {
+    auto *shape = it->second->collision->GetShape();
+    if (shape != nullptr)
+      return math::eigen3::convert(shape->GetBoundingBox().Size());
+  }
+  // return invalid size if collision not found
+  return math::eigen3::convert(math::Vector3d(-1.0, -1.0, -1.0));
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachHeightmapShape(
+  const Identity &_linkID,
+  const std::string &_name,
+  const common::HeightmapData &_heightmapData,
+  const Pose3d &_pose,
+  const LinearVector3d &_size,
+  int _subSampling)
+{
+  auto it = this->links.find(_linkID);
+  if (it == this->links.end() || it->second == nullptr)
+    return this->GenerateInvalidId();
+
+  // The heights are sampled the same way as by the other engines, already
+  // scaled to _size along z. Rows of the data go along -y, so they are
+  // flipped to go along +y like the rows of tpelib heightmaps.
+  const int vertSize =
+      (_heightmapData.Width() * _subSampling) - _subSampling + 1;
+  const float rangeZ =
+      _heightmapData.MaxElevation() - _heightmapData.MinElevation();
+  const math::Vector3d size = math::eigen3::convert(_size);
+  math::Vector3d scale(size.X() / vertSize, size.Y() / vertSize,
+      math::equal(rangeZ, 0.0f) ? 1.0 : std::abs(size.Z()) / rangeZ);
+  auto heights = std::make_shared<std::vector<float>>();
+  _heightmapData.FillHeightMap(_subSampling, vertSize, size, scale, true,
+      *heights);
+
+  tpelib::HeightmapShape heightmap;
+  if (!heightmap.SetHeights(
+      std::shared_ptr<const float>(heights, heights->data()),
+      static_cast<std::size_t>(vertSize), static_cast<std::size_t>(vertSize)))
+  {
+    gzerr << "Heightmap of shape [" << _name << "] has less than 2 samples "
+          << "along an edge\n";
+    return this->GenerateInvalidId();
+  }
+  heightmap.SetSize(math::Vector3d(size.X(), size.Y(), 1.0));
+
+  auto &collision = static_cast<tpelib::Collision&>(
+    it->second->link->AddCollision());
+  collision.SetName(_name);
+  collision.SetPose(math::eigen3::convert(_pose));
+  collision.SetShape(heightmap);
+  return this->AddCollision(_linkID, collision);
+}
+
 /////////////////////////////////////////////////
 Identity ShapeFeatures::CastToMeshShape(
   const Identity &_shapeID) const
@@ -414,7 +566,52 @@ Identity ShapeFeatures::AttachMeshShape(
     collision.SetPose(math::eigen3::convert(_pose));
 
     tpelib::MeshShape mesh;
-    mesh.SetMesh(_mesh);
+    mesh.SetMesh(_mesh, true);
+    mesh.SetScale(math::eigen3::convert(_scale));
+    collision.SetShape(mesh);
+
+    return this->AddCollision(_linkID, collision);
+  }
+  return this->GenerateInvalidId();
+}
+
+/////////////////////////////////////////////////
+Identity ShapeFeatures::AttachMeshViewShape(
+  const Identity &_linkID,
+  const std::string &_name,
+  const mesh::TriangleMeshView &_view,
+  const Pose3d &_pose,
+  const LinearVector3d &_scale)
+{
+  if (!mesh::ValidTriangleMeshView(_view))
+  {
+    gzerr << "Mesh view of shape [" << _name << "] has no triangles or an "
+          << "index out of range\n";
+    return this->GenerateInvalidId();
+  }
+
+  auto it = this->links.find(_linkID);
+  if (it != this->links.end() && it->second != nullptr)
+  {
+    // The triangles are copied into the hierarchy of the shape once here,
+    // and the view is not kept.
+    std::vector<math::Vector3d> triangles;
+    triangles.reserve(_view.indexCount);
+    for (std::size_t i = 0; i < _view.indexCount; ++i)
+    {
+      const float *v = _view.vertices + 3u * _view.indices[i];
+      triangles.emplace_back(v[0], v[1], v[2]);
+    }
+    auto bvh = std::make_shared<tpelib::TriangleBvh>(triangles);
+
+    auto &collision = static_cast<tpelib::Collision&>(
+      it->second->link->AddCollision());
+    collision.SetName(_name);
+    collision.SetPose(math::eigen3::convert(_pose));
+
+    tpelib::MeshShape mesh;
+    mesh.SetMeshBoundingBox(bvh->Bounds());
+    mesh.SetTriangleBvh(std::move(bvh));
     mesh.SetScale(math::eigen3::convert(_scale));
     collision.SetShape(mesh);
 
@@ -437,3 +634,54 @@ AlignedBox3d ShapeFeatures::GetShapeAxisAlignedBoundingBox(
   // return invalid bounding box if collision not found
   return math::eigen3::convert(math::AxisAlignedBox());
 }
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldShapeBoundingBoxes(
+    const Identity &_worldID) const -> ShapeBoundingBoxBatch
+{
+  this->shapeBoundingBoxes.Clear();
+
+  const auto it = this->worlds.find(_worldID);
+  if (it != this->worlds.end() && it->second != nullptr)
+  {
+    const tpelib::World &world = *it->second->world;
+    AddCollisionBoundingBoxes(
+        world, world.GetPose(), this->shapeBoundingBoxes);
+  }
+
+  return this->shapeBoundingBoxes.View();
+}
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldLinkBoundingBoxes(
+    const Identity &_worldID) const -> BoundingBoxBatch
+{
+  this->linkBoundingBoxes.Clear();
+
+  const auto it = this->worlds.find(_worldID);
+  if (it != this->worlds.end() && it->second != nullptr)
+  {
+    const tpelib::World &world = *it->second->world;
+    AddLinkBoundingBoxes(
+        world, world.GetPose(), &this->linkBoundingBoxes, nullptr);
+  }
+
+  return this->linkBoundingBoxes.View();
+}
+
+/////////////////////////////////////////////////
+auto ShapeFeatures::GetWorldModelBoundingBoxes(
+    const Identity &_worldID) const -> BoundingBoxBatch
+{
+  this->modelBoundingBoxes.Clear();
+
+  const auto it = this->worlds.find(_worldID);
+  if (it != this->worlds.end() && it->second != nullptr)
+  {
+    const tpelib::World &world = *it->second->world;
+    AddLinkBoundingBoxes(
+        world, world.GetPose(), nullptr, &this->modelBoundingBoxes);
+  }
+
+  return this->modelBoundingBoxes.View();
+}
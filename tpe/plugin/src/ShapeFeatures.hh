@@ -25,6 +25,8 @@
 #include <gz/physics/CapsuleShape.hh>
 #include <gz/physics/CylinderShape.hh>
 #include <gz/physics/EllipsoidShape.hh>
+#include <gz/physics/GetBoundingBox.hh>
+#include <gz/physics/heightmap/HeightmapShape.hh>
 #include <gz/physics/mesh/MeshShape.hh>
 #include <gz/physics/SphereShape.hh>
 
@@ -38,6 +40,8 @@ struct ShapeFeatureList : FeatureList<
   GetBoxShapeProperties,
   AttachBoxShapeFeature,
   GetShapeBoundingBox,
+  GetWorldShapeBoundingBoxes,
+  GetWorldLinkBoundingBoxes,
 
   GetCapsuleShapeProperties,
   AttachCapsuleShapeFeature,
@@ -51,14 +55,27 @@ struct ShapeFeatureList : FeatureList<
   GetSphereShapeProperties,
   AttachSphereShapeFeature,
 
+  heightmap::GetHeightmapShapeProperties,
+  heightmap::AttachHeightmapShapeFeature,
+
   mesh::GetMeshShapeProperties,
-  mesh::AttachMeshShapeFeature
+  mesh::AttachMeshShapeFeature,
+  mesh::AttachMeshViewShapeFeature
 > { };
 
 class ShapeFeatures :
     public virtual Base,
     public virtual Implements3d<ShapeFeatureList>
 {
+  public: using ShapeBoundingBoxBatch =
+    GetWorldShapeBoundingBoxes::ShapeBoundingBoxBatchT<FeaturePolicy3d>;
+  public: using ShapeBoundingBoxStorage = GetWorldShapeBoundingBoxes::
+    Implementation<FeaturePolicy3d>::ShapeBoundingBoxStorage;
+  public: using BoundingBoxBatch =
+    GetWorldLinkBoundingBoxes::BoundingBoxBatchT<FeaturePolicy3d>;
+  public: using BoundingBoxStorage = GetWorldLinkBoundingBoxes::
+    Implementation<FeaturePolicy3d>::BoundingBoxStorage;
+
   // ----- Box Features -----
   public: Identity CastToBoxShape(
     const Identity &_shapeID) const override;
@@ -133,6 +150,21 @@ class ShapeFeatures :
     const Pose3d &_pose) override;
 
 
+  // ----- Heightmap Features -----
+  public: Identity CastToHeightmapShape(
+    const Identity &_shapeID) const override;
+
+  public: LinearVector3d GetHeightmapShapeSize(
+    const Identity &_heightmapID) const override;
+
+  public: Identity AttachHeightmapShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const common::HeightmapData &_heightmapData,
+    const Pose3d &_pose,
+    const LinearVector3d &_size,
+    int _subSampling) override;
+
   // ----- Mesh Features -----
   public: Identity CastToMeshShape(
     const Identity &_shapeID) const override;
@@ -150,9 +182,36 @@ class ShapeFeatures :
     const Pose3d &_pose,
     const LinearVector3d &_scale) override;
 
+  public: Identity AttachMeshViewShape(
+    const Identity &_linkID,
+    const std::string &_name,
+    const mesh::TriangleMeshView &_view,
+    const Pose3d &_pose,
+    const LinearVector3d &_scale) override;
+
   // ----- Boundingbox Features -----
   public: AlignedBox3d GetShapeAxisAlignedBoundingBox(
     const Identity &_shapeID) const override;
+
+  public: ShapeBoundingBoxBatch GetWorldShapeBoundingBoxes(
+    const Identity &_worldID) const override;
+
+  public: BoundingBoxBatch GetWorldLinkBoundingBoxes(
+    const Identity &_worldID) const override;
+
+  public: BoundingBoxBatch GetWorldModelBoundingBoxes(
+    const Identity &_worldID) const override;
+
+  /// \brief Buffers backing the views returned by
+  /// GetWorldShapeBoundingBoxes.
+  private: mutable ShapeBoundingBoxStorage shapeBoundingBoxes;
+
+  /// \brief Buffers backing the views returned by GetWorldLinkBoundingBoxes.
+  private: mutable BoundingBoxStorage linkBoundingBoxes;
+
+  /// \brief Buffers backing the views returned by
+  /// GetWorldModelBoundingBoxes.
+  private: mutable BoundingBoxStorage modelBoundingBoxes;
 };
 
 }
@@ -15,8 +15,14 @@
  *
 */
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <gz/common/Console.hh>
 #include <gz/common/Profiler.hh>
@@ -24,16 +30,51 @@
 #include <gz/math/Pose3.hh>
 #include <gz/math/eigen3/Conversions.hh>
 
+#include <gz/physics/AllocationCounter.hh>
+#include <gz/physics/detail/WorldStateSnapshot.hh>
+
+#include "lib/src/Trajectory.hh"
+
 #include "SimulationFeatures.hh"
 
 using namespace gz;
 using namespace physics;
 using namespace tpeplugin;
 
+/// \brief Identifies a tpe world state snapshot.
+static constexpr std::uint32_t kSnapshotMagic = 0x54535753;  // "SWST"
+
+/// \brief Version of the snapshot layout.
+static constexpr std::uint32_t kSnapshotVersion = 1;
+
+/// \brief Number of values stored for each model: position, orientation,
+/// linear velocity and angular velocity.
+static constexpr std::size_t kSnapshotModelValues = 13;
+
+using detail::AppendToSnapshot;
+using detail::ReadFromSnapshot;
+using detail::SnapshotReader;
+
+/////////////////////////////////////////////////
+/// \brief Collect the models of an entity and of their nested models, in the
+/// order of their IDs.
+static void CollectModels(
+  tpelib::Entity &_entity, std::vector<tpelib::Model *> &_models)
+{
+  for (auto &child : _entity.GetChildren())
+  {
+    auto *model = dynamic_cast<tpelib::Model *>(child.second.get());
+    if (nullptr == model)
+      continue;
+    _models.push_back(model);
+    CollectModels(*model, _models);
+  }
+}
+
 void SimulationFeatures::WorldForwardStep(
   const Identity &_worldID,
   ForwardStep::Output & _h,
-  ForwardStep::State & /*_x*/,
+  ForwardStep::State & _x,
   const ForwardStep::Input & _u)
 {
   GZ_PROFILE("SimulationFeatures::WorldForwardStep");
@@ -47,58 +88,333 @@ void SimulationFeatures::WorldForwardStep(
     return;
   }
   std::shared_ptr<tpelib::World> world = it->second->world;
+  this->UpdateTimeStep(*world, _u);
+
+  auto *stateSnapshot = _x.Query<WorldStateSnapshot>();
+  Snapshot liveState;
+  if (!detail::BeginSnapshotStep(*this, _worldID, stateSnapshot, liveState))
+    return;
+
+  world->Step();
+  const auto writeStart = std::chrono::steady_clock::now();
+  const std::size_t writeAllocations = AllocationCount();
+  this->Write(_h.Get<ChangedWorldPoses>());
+  this->WriteTwists(_h);
+  it->second->poseWriteTime = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - writeStart).count();
+  it->second->poseWriteAllocations = AllocationCount() - writeAllocations;
+
+  detail::EndSnapshotStep(*this, _worldID, stateSnapshot, liveState);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::StepEngineWorlds(
+  const Identity &/*_engineID*/,
+  const std::size_t *_worldIDs,
+  std::size_t _count,
+  ForwardStep::Output &_h,
+  ForwardStep::State &/*_x*/,
+  const ForwardStep::Input &_u,
+  std::size_t _numThreads)
+{
+  GZ_PROFILE("SimulationFeatures::StepEngineWorlds");
+  std::vector<tpelib::World *> stepWorlds;
+  stepWorlds.reserve(_count);
+
+  // Worlds that are not placed, and the placed ones grouped by the threads
+  // pinned to their cores
+  std::vector<tpelib::World *> unplacedWorlds;
+  std::vector<std::pair<TaskScheduler *, std::vector<tpelib::World *>>>
+    placedWorlds;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    auto it = this->worlds.find(_worldIDs[i]);
+    tpelib::World *world =
+      it == this->worlds.end() ? nullptr : it->second->world.get();
+    if (!world ||
+        std::find(stepWorlds.begin(), stepWorlds.end(), world) !=
+        stepWorlds.end())
+    {
+      gzerr << "Entity [" << _worldIDs[i] << "] is not a world, or is given "
+        << "more than once. It will not be stepped\n";
+      continue;
+    }
+    this->UpdateTimeStep(*world, _u);
+    stepWorlds.push_back(world);
+
+    TaskScheduler *scheduler = it->second->placementScheduler.get();
+    if (!scheduler)
+    {
+      unplacedWorlds.push_back(world);
+      continue;
+    }
+    auto group = std::find_if(placedWorlds.begin(), placedWorlds.end(),
+      [scheduler](const auto &_group) { return _group.first == scheduler; });
+    if (group == placedWorlds.end())
+    {
+      group = placedWorlds.emplace(
+        group, scheduler, std::vector<tpelib::World *>());
+    }
+    group->second.push_back(world);
+  }
+
+  // Worlds that are not placed are stepped on the threads of the engine
+  auto stepUnplaced = [&]()
+  {
+    std::size_t numThreads = _numThreads;
+    if (numThreads == 0)
+      numThreads = std::max(1u, std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, unplacedWorlds.size());
+
+    if (numThreads <= 1u)
+    {
+      for (auto *world : unplacedWorlds)
+        world->Step();
+    }
+    else
+    {
+      // Worlds share no state, so they can be stepped concurrently.
+      tpelib::runTasks(this->taskRunner, this->stepWorldsPool,
+        this->stepWorldsPoolThreads, numThreads, unplacedWorlds.size(),
+        [&unplacedWorlds](std::size_t _i) { unplacedWorlds[_i]->Step(); });
+    }
+  };
+
+  if (placedWorlds.empty())
+  {
+    stepUnplaced();
+  }
+  else
+  {
+    // Each group is stepped on its cores while the others are, so the
+    // dispatching threads only wait for them
+    const std::size_t groups = placedWorlds.size() + 1u;
+    if (!this->placementDispatch ||
+        this->placementDispatch->GetNumThreads() != groups)
+    {
+      this->placementDispatch =
+        std::make_unique<ThreadPoolTaskScheduler>(groups);
+    }
+    this->placementDispatch->Run(groups, [&](std::size_t _i)
+    {
+      if (_i == placedWorlds.size())
+      {
+        stepUnplaced();
+        return;
+      }
+      const auto &group = placedWorlds[_i];
+      group.first->Run(group.second.size(), [&group](std::size_t _w)
+      {
+        group.second[_w]->Step();
+      });
+    });
+  }
+
+  const auto writeStart = std::chrono::steady_clock::now();
+  const std::size_t writeAllocations = AllocationCount();
+  this->Write(_h.Get<ChangedWorldPoses>());
+  this->WriteTwists(_h);
+  const double poseWriteTime = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - writeStart).count();
+  const std::size_t poseWriteAllocations =
+    AllocationCount() - writeAllocations;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    auto it = this->worlds.find(_worldIDs[i]);
+    if (it != this->worlds.end())
+    {
+      it->second->poseWriteTime = poseWriteTime;
+      it->second->poseWriteAllocations = poseWriteAllocations;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+std::shared_future<void> SimulationFeatures::StartWorldStep(
+    const Identity &_worldID,
+    const ForwardStep::Input &_u)
+{
+  return this->asyncSteppers.Start(_worldID, _u);
+}
+
+/////////////////////////////////////////////////
+const ForwardStep::Output &SimulationFeatures::FinishWorldStep(
+    const Identity &_worldID)
+{
+  return this->asyncSteppers.Finish(_worldID);
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::UpdateTimeStep(
+  tpelib::World &_world, const ForwardStep::Input &_u) const
+{
   auto *dtDur =
     _u.Query<std::chrono::steady_clock::duration>();
   const double tol = 1e-6;
   if (dtDur)
   {
     std::chrono::duration<double> dt = *dtDur;
-    if (std::fabs(dt.count() - world->GetTimeStep()) > tol)
+    if (std::fabs(dt.count() - _world.GetTimeStep()) > tol)
     {
-      world->SetTimeStep(dt.count());
+      _world.SetTimeStep(dt.count());
       gzdbg << "Simulation timestep set to: "
-        << world->GetTimeStep()
+        << _world.GetTimeStep()
         << std::endl;
     }
   }
-  world->Step();
-  this->Write(_h.Get<ChangedWorldPoses>());
 }
 
+/////////////////////////////////////////////////
+WorldStateSnapshotFeature::Snapshot SimulationFeatures::GetWorldStateSnapshot(
+  const Identity &_worldID) const
+{
+  const auto &world = this->worlds.at(_worldID)->world;
+  std::vector<tpelib::Model *> models;
+  CollectModels(*world, models);
+
+  // Contacts are found from scratch on every step, so only the pose and
+  // velocity of the models are needed.
+  Snapshot snapshot;
+  snapshot.reserve(2 * sizeof(std::uint32_t) + sizeof(double) +
+    sizeof(std::uint64_t) + models.size() *
+    (sizeof(std::uint64_t) + kSnapshotModelValues * sizeof(double)));
+
+  AppendToSnapshot(snapshot, kSnapshotMagic);
+  AppendToSnapshot(snapshot, kSnapshotVersion);
+  AppendToSnapshot(snapshot, world->GetTime());
+  AppendToSnapshot(snapshot, static_cast<std::uint64_t>(models.size()));
+  for (const auto *model : models)
+  {
+    const math::Pose3d pose = model->GetPose();
+    const math::Vector3d linVel = model->GetLinearVelocity();
+    const math::Vector3d angVel = model->GetAngularVelocity();
+    AppendToSnapshot(snapshot, static_cast<std::uint64_t>(model->GetId()));
+    for (const double value : {
+      pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z(),
+      pose.Rot().W(), pose.Rot().X(), pose.Rot().Y(), pose.Rot().Z(),
+      linVel.X(), linVel.Y(), linVel.Z(),
+      angVel.X(), angVel.Y(), angVel.Z()})
+    {
+      AppendToSnapshot(snapshot, value);
+    }
+  }
+
+  return snapshot;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::SetWorldStateSnapshot(
+  const Identity &_worldID, const Snapshot &_snapshot)
+{
+  const auto &world = this->worlds.at(_worldID)->world;
+  std::vector<tpelib::Model *> models;
+  CollectModels(*world, models);
+
+  SnapshotReader reader(_snapshot);
+  std::uint32_t magic = 0;
+  std::uint32_t version = 0;
+  double time = 0.0;
+  std::uint64_t numModels = 0;
+  bool ok = ReadFromSnapshot(reader, magic) && magic == kSnapshotMagic &&
+    ReadFromSnapshot(reader, version) && version == kSnapshotVersion &&
+    ReadFromSnapshot(reader, time) &&
+    ReadFromSnapshot(reader, numModels) && numModels == models.size();
+
+  std::vector<double> values(models.size() * kSnapshotModelValues);
+  for (std::size_t i = 0; ok && i < models.size(); ++i)
+  {
+    std::uint64_t id = 0;
+    ok = ReadFromSnapshot(reader, id) && id == models[i]->GetId() &&
+      ReadFromSnapshot(reader, &values[i * kSnapshotModelValues],
+                       kSnapshotModelValues);
+  }
+
+  if (!ok || !reader.AtEnd())
+  {
+    gzerr << "Snapshot does not match the state of world ["
+      << world->GetName() << "]" << std::endl;
+    return false;
+  }
+
+  world->SetTime(time);
+  for (std::size_t i = 0; i < models.size(); ++i)
+  {
+    const double *v = &values[i * kSnapshotModelValues];
+    models[i]->SetPose(math::Pose3d(
+      math::Vector3d(v[0], v[1], v[2]),
+      math::Quaterniond(v[3], v[4], v[5], v[6])));
+    models[i]->SetLinearVelocity(math::Vector3d(v[7], v[8], v[9]));
+    models[i]->SetAngularVelocity(math::Vector3d(v[10], v[11], v[12]));
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
 void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
 {
   // remove link poses from the previous iteration
   _changedPoses.entries.clear();
   _changedPoses.entries.reserve(this->links.size());
 
-  std::unordered_map<std::size_t, math::Pose3d> newPoses;
-  // Store the updated links to avoid duplicated entries in _changedPoses
-  std::unordered_set<std::size_t> updatedLinkIds;
+  // The last reported pose of each entity lives in its info, which also
+  // drops it when the entity is removed, so that nothing has to be
+  // allocated to cache them. Links whose pose is reported are marked with
+  // the number of this write, to avoid duplicated entries in _changedPoses.
+  const std::size_t write = ++this->poseWriteCount;
 
-  for (const auto &[id, info] : this->links)
+  // Compare a link against its previous pose. Only changes the info of the
+  // link, so links can be checked concurrently.
+  auto writeLink = [write](std::size_t _id, LinkInfo &_info,
+                           std::vector<WorldPose> &_entries)
   {
-    // make sure the link exists
-    if (info)
+    const auto nextPose = _info.link->GetPose();
+
+    // If the link's pose is new or has changed, save this new pose and
+    // add it to the output poses. Otherwise, keep the existing link pose
+    if (!_info.hasReportedPose ||
+        !_info.reportedPose.Pos().Equal(nextPose.Pos(), 1e-6) ||
+        !_info.reportedPose.Rot().Equal(nextPose.Rot(), 1e-6))
     {
-      const auto nextPose = info->link->GetPose();
-      auto iter = this->prevEntityPoses.find(id);
+      WorldPose wp;
+      wp.pose = nextPose;
+      wp.body = _id;
+      _entries.push_back(wp);
+      _info.reportedPose = nextPose;
+      _info.hasReportedPose = true;
+      _info.reportedWrite = write;
+    }
+  };
 
-      // If the link's pose is new or has changed, save this new pose and
-      // add it to the output poses. Otherwise, keep the existing link pose
-      if ((iter == this->prevEntityPoses.end()) ||
-          !iter->second.Pos().Equal(nextPose.Pos(), 1e-6) ||
-          !iter->second.Rot().Equal(nextPose.Rot(), 1e-6))
-      {
-        WorldPose wp;
-        wp.pose = nextPose;
-        wp.body = id;
-        _changedPoses.entries.push_back(wp);
-        updatedLinkIds.insert(id);
-        newPoses[id] = nextPose;
-      }
-      else
-        newPoses[id] = iter->second;
+  if (!this->poseWriter.IsParallel(this->links.size()))
+  {
+    for (const auto &[id, info] : this->links)
+    {
+      // make sure the link exists
+      if (info)
+        writeLink(id, *info, _changedPoses.entries);
+    }
+  }
+  else
+  {
+    this->poseWriteLinks.clear();
+    for (const auto &[id, info] : this->links)
+    {
+      if (info)
+        this->poseWriteLinks.emplace_back(id, info.get());
     }
+
+    this->poseWriter.Write(this->poseWriteLinks.size(),
+      this->taskScheduler.get(), _changedPoses.entries,
+      [&](std::size_t _begin, std::size_t _end,
+          std::vector<WorldPose> &_entries)
+      {
+        for (std::size_t i = _begin; i < _end; ++i)
+        {
+          const auto &[id, info] = this->poseWriteLinks[i];
+          writeLink(id, *info, _entries);
+        }
+      });
   }
 
   // Iterate over models to make sure link velocities for moving models
@@ -111,40 +427,350 @@ void SimulationFeatures::Write(ChangedWorldPoses &_changedPoses) const
       if (info->model->GetStatic())
         continue;
       const auto nextPose = info->model->GetPose();
-      // Note, now prevEntityPoses also contains prevModelPoses
-      // Data structure has been kept to avoid breaking ABI
-      auto iter = this->prevEntityPoses.find(id);
 
       // If the models's pose is new or has changed, calculate and add all
       // the children links' poses to the output poses
-      if ((iter == this->prevEntityPoses.end()) ||
-          !iter->second.Pos().Equal(nextPose.Pos(), 1e-6) ||
-          !iter->second.Rot().Equal(nextPose.Rot(), 1e-6))
+      if (!info->hasReportedPose ||
+          !info->reportedPose.Pos().Equal(nextPose.Pos(), 1e-6) ||
+          !info->reportedPose.Rot().Equal(nextPose.Rot(), 1e-6))
       {
+        info->hasReportedPose = false;
         for (const auto &linkEnt : info->model->GetChildren())
         {
           // Avoid pushing if the link was already updated in the previous loop
           auto linkId = linkEnt.second->GetId();
-          if (updatedLinkIds.find(linkId) == updatedLinkIds.end())
+          auto linkIt = this->links.find(linkId);
+          LinkInfo *linkInfo = linkIt == this->links.end() ?
+            nullptr : linkIt->second.get();
+          if (!linkInfo || linkInfo->reportedWrite != write)
           {
             WorldPose wp;
             wp.pose = linkEnt.second->GetPose();
             wp.body = linkId;
             _changedPoses.entries.push_back(wp);
-            updatedLinkIds.insert(linkId);
+            if (linkInfo)
+              linkInfo->reportedWrite = write;
           }
-          newPoses[id] = linkEnt.second->GetPose();
+          info->reportedPose = linkEnt.second->GetPose();
+          info->hasReportedPose = true;
         }
       }
-      else
-        newPoses[id] = iter->second;
     }
   }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(WorldTwists &_twists) const
+{
+  _twists.entries.clear();
+  _twists.entries.reserve(this->links.size());
+  for (const auto &[id, info] : this->links)
+  {
+    if (!info)
+      continue;
+    WorldTwist twist;
+    twist.body = id;
+    this->LinkWorldTwist(*info->link, twist);
+    _twists.entries.push_back(twist);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::Write(ChangedWorldTwists &_changedTwists,
+    const ChangedWorldPoses &_changedPoses) const
+{
+  _changedTwists.entries.clear();
+  _changedTwists.entries.reserve(_changedPoses.entries.size());
+  for (const auto &wp : _changedPoses.entries)
+  {
+    WorldTwist twist;
+    twist.body = wp.body;
+    auto linkIt = this->links.find(wp.body);
+    if (linkIt != this->links.end() && linkIt->second)
+      this->LinkWorldTwist(*linkIt->second->link, twist);
+    _changedTwists.entries.push_back(twist);
+  }
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::WriteTwists(ForwardStep::Output &_h) const
+{
+  if (auto *twists = _h.Query<WorldTwists>())
+    this->Write(*twists);
+  if (auto *changedTwists = _h.Query<ChangedWorldTwists>())
+    this->Write(*changedTwists, _h.Get<ChangedWorldPoses>());
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::LinkWorldTwist(
+    const tpelib::Link &_link, WorldTwist &_twist) const
+{
+  // Same as FrameDataRelativeToWorld: link velocities are stored relative to
+  // their model
+  auto modelIt = this->models.find(_link.GetParent()->GetId());
+  if (modelIt == this->models.end() || !modelIt->second)
+    return;
+  const auto *model = modelIt->second->model;
+  const auto rot = model->GetWorldPose().Rot().Inverse();
+  _twist.linearVelocity =
+    rot * _link.GetLinearVelocity() + model->GetLinearVelocity();
+  _twist.angularVelocity =
+    rot * _link.GetAngularVelocity() + model->GetAngularVelocity();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEnginePoseWriteThreads(
+  const Identity &/*_engineID*/,
+  std::size_t _numThreads,
+  std::size_t _minLinks)
+{
+  this->poseWriter.Set(_numThreads, _minLinks);
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::GetEnginePoseWriteThreads(
+  const Identity &/*_engineID*/) const
+{
+  return this->poseWriter.GetThreads();
+}
+
+/////////////////////////////////////////////////
+std::size_t SimulationFeatures::GetEnginePoseWriteMinLinks(
+  const Identity &/*_engineID*/) const
+{
+  return this->poseWriter.GetMinLinks();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldContactFilter(
+  const Identity &_worldID, const std::vector<std::size_t> &_entities)
+{
+  if (_entities.empty())
+  {
+    this->contactFilters.erase(_worldID.id);
+  }
+  else
+  {
+    this->contactFilters.insert_or_assign(
+        _worldID.id, ContactFilter(_entities));
+  }
+}
 
-  // Save the new poses so that they can be used to check for updates in the
-  // next iteration. Re-setting this->prevEntityPoses with the contents of
-  // newPoses ensures that we aren't caching data for links that were removed
-  this->prevEntityPoses = std::move(newPoses);
+/////////////////////////////////////////////////
+std::vector<std::size_t> SimulationFeatures::GetWorldContactFilter(
+  const Identity &_worldID) const
+{
+  const auto *filter = this->FindContactFilter(_worldID);
+  if (!filter)
+    return {};
+  return filter->Entities();
+}
+
+/////////////////////////////////////////////////
+auto SimulationFeatures::FindContactFilter(const Identity &_worldID) const
+  -> const ContactFilter *
+{
+  const auto it = this->contactFilters.find(_worldID.id);
+  return it == this->contactFilters.end() ? nullptr : &it->second;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEngineDeterministic(
+  const Identity &/*_engineID*/, bool _deterministic)
+{
+  this->deterministic = _deterministic;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetEngineDeterministic(
+  const Identity &/*_engineID*/) const
+{
+  return this->deterministic;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetEngineTaskScheduler(
+  const Identity &/*_engineID*/, std::shared_ptr<TaskScheduler> _scheduler)
+{
+  this->SetTaskScheduler(std::move(_scheduler));
+
+  // The pools are not used while there is a scheduler
+  if (this->taskScheduler)
+  {
+    this->stepWorldsPool.reset();
+    this->stepWorldsPoolThreads = 0u;
+    this->poseWriter.ReleasePool();
+  }
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<TaskScheduler> SimulationFeatures::GetEngineTaskScheduler(
+  const Identity &/*_engineID*/) const
+{
+  return this->taskScheduler;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldPlacement(
+  const Identity &_worldID, const WorldPlacement &_placement)
+{
+  auto it = this->worlds.find(_worldID.id);
+  if (it == this->worlds.end())
+    return;
+
+  WorldInfo &info = *it->second;
+  info.placement = _placement;
+  info.placementScheduler.reset();
+  info.placementMemory.reset();
+
+  const std::vector<std::size_t> cores = _placement.Cores();
+  if (!cores.empty())
+  {
+    Placement &placement = this->placements[cores];
+    if (!placement.scheduler)
+    {
+      placement.scheduler = std::make_shared<ThreadPoolTaskScheduler>(cores);
+
+      // Pages are placed on the node of the thread that first writes them
+      ArenaMemoryResource::Options options;
+      std::shared_ptr<TaskScheduler> scheduler = placement.scheduler;
+      options.firstTouch = [scheduler](void *_block, std::size_t _size)
+      {
+        scheduler->Run(1u, [_block, _size](std::size_t)
+        {
+          std::memset(_block, 0, _size);
+        });
+      };
+      placement.arena = std::make_shared<ArenaMemoryResource>(options);
+    }
+    info.placementScheduler = placement.scheduler;
+    info.placementMemory = placement.arena;
+  }
+  this->UpdateWorldResources(info);
+
+  // Placements that no world uses any more are forgotten. Their threads
+  // stop once the entities allocated from their arenas are destroyed.
+  for (auto p = this->placements.begin(); p != this->placements.end();)
+  {
+    const bool used = std::any_of(this->worlds.begin(), this->worlds.end(),
+      [&p](const auto &_world)
+      {
+        return _world.second->placementScheduler == p->second.scheduler;
+      });
+    p = used ? std::next(p) : this->placements.erase(p);
+  }
+}
+
+/////////////////////////////////////////////////
+WorldPlacement SimulationFeatures::GetWorldPlacement(
+  const Identity &_worldID) const
+{
+  auto it = this->worlds.find(_worldID.id);
+  if (it == this->worlds.end())
+    return WorldPlacement();
+  return it->second->placement;
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::SetModelTrajectory(
+  const Identity &_modelID,
+  const std::vector<Waypoint> &_waypoints,
+  ModelTrajectoryFeature::Interpolation _interpolation)
+{
+  auto it = this->models.find(_modelID.id);
+  if (it == this->models.end() || it->second == nullptr)
+    return false;
+
+  // tpelib only steps the models of the world, whose poses are in the
+  // world frame
+  tpelib::Model *model = it->second->model;
+  if (nullptr == dynamic_cast<tpelib::World *>(model->GetParent()))
+  {
+    gzerr << "Unable to set the trajectory of nested model ["
+          << model->GetName() << "]. Only models of the world can follow "
+          << "trajectories." << std::endl;
+    return false;
+  }
+
+  std::vector<tpelib::Trajectory::Waypoint> waypoints;
+  waypoints.reserve(_waypoints.size());
+  for (const auto &waypoint : _waypoints)
+    waypoints.push_back({waypoint.time, math::eigen3::convert(waypoint.pose)});
+
+  tpelib::Trajectory trajectory;
+  if (!trajectory.SetWaypoints(waypoints,
+        _interpolation == ModelTrajectoryFeature::Interpolation::CUBIC ?
+        tpelib::Trajectory::Interpolation::CUBIC :
+        tpelib::Trajectory::Interpolation::LINEAR))
+  {
+    gzerr << "Unable to set the trajectory of model ["
+          << model->GetName() << "]. The waypoints must not be empty and "
+          << "their times must increase." << std::endl;
+    return false;
+  }
+
+  model->SetTrajectory(trajectory);
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::ClearModelTrajectory(const Identity &_modelID)
+{
+  auto it = this->models.find(_modelID.id);
+  if (it != this->models.end() && it->second != nullptr)
+    it->second->model->ClearTrajectory();
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::GetModelHasTrajectory(
+  const Identity &_modelID) const
+{
+  auto it = this->models.find(_modelID.id);
+  return it != this->models.end() && it->second != nullptr &&
+      it->second->model->GetTrajectory() != nullptr;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetModelUpdateRate(
+  const Identity &_modelID, double _rate)
+{
+  auto it = this->models.find(_modelID.id);
+  if (it == this->models.end() || it->second == nullptr)
+    return;
+
+  // tpelib only schedules the models of the world, and nested models move
+  // with them
+  tpelib::Model *model = it->second->model;
+  if (nullptr == dynamic_cast<tpelib::World *>(model->GetParent()))
+  {
+    gzerr << "Unable to set the update rate of nested model ["
+          << model->GetName() << "]. Only models of the world have update "
+          << "rates." << std::endl;
+    return;
+  }
+  model->SetUpdateRate(_rate);
+}
+
+/////////////////////////////////////////////////
+double SimulationFeatures::GetModelUpdateRate(
+  const Identity &_modelID) const
+{
+  auto it = this->models.find(_modelID.id);
+  if (it == this->models.end() || it->second == nullptr)
+    return 0.0;
+  return it->second->model->GetUpdateRate();
+}
+
+void SimulationFeatures::SetWorldCollisionPairMaxContacts(
+  const Identity &_id, std::size_t _maxContacts)
+{
+  this->worlds.at(_id)->world->SetCollisionPairMaxContacts(_maxContacts);
+}
+
+std::size_t SimulationFeatures::GetWorldCollisionPairMaxContacts(
+  const Identity &_id) const
+{
+  return this->worlds.at(_id)->world->GetCollisionPairMaxContacts();
 }
 
 std::vector<SimulationFeatures::ContactInternal>
@@ -152,18 +778,29 @@ SimulationFeatures::GetContactsFromLastStep(const Identity &_worldID) const
 {
   GZ_PROFILE("SimulationFeatures::GetContactFromLastStep");
   std::vector<SimulationFeatures::ContactInternal> outContacts;
-  auto const world = this->ReferenceInterface<WorldInfo>(_worldID)->world;
-  const auto contacts = world->GetContacts();
+  auto const &world = this->ReferenceInterface<WorldInfo>(_worldID)->world;
+  const auto &contacts = world->GetContactsRef();
+  const ContactFilter *filter = this->FindContactFilter(_worldID);
+  if (!filter)
+    outContacts.reserve(contacts.size());
 
   for (const auto &c : contacts)
   {
+    if (filter &&
+        !this->ModelPassesFilter(*filter, c.entity1, c.collision1) &&
+        !this->ModelPassesFilter(*filter, c.entity2, c.collision2))
+    {
+      continue;
+    }
+
     CompositeData extraData;
+    extraData.SetQueryTracking(false);
 
     // Contact expects identity to be associated with shapes not models
-    // but tpe computes collisions between models
-    // Workaround is to return the first shape of a model
-    auto s1 = this->GetModelCollision(c.entity1);
-    auto s2 = this->GetModelCollision(c.entity2);
+    const tpelib::Entity &s1 =
+        this->GetContactCollision(c.entity1, c.collision1);
+    const tpelib::Entity &s2 =
+        this->GetContactCollision(c.entity2, c.collision2);
 
     outContacts.push_back(
         {this->GenerateIdentity(s1.GetId(), this->collisions.at(s1.GetId())),
@@ -171,12 +808,162 @@ SimulationFeatures::GetContactsFromLastStep(const Identity &_worldID) const
          math::eigen3::convert(c.point), extraData});
   }
 
+  if (this->deterministic)
+    SortContacts(outContacts);
   return outContacts;
 }
 
+/////////////////////////////////////////////////
+SimulationFeatures::ContactEventBatch SimulationFeatures::GetContactEvents(
+    const Identity &_worldID) const
+{
+  GZ_PROFILE("SimulationFeatures::GetContactEvents");
+  auto const &world = this->ReferenceInterface<WorldInfo>(_worldID)->world;
+  const ContactFilter *filter = this->FindContactFilter(_worldID);
+  ContactEventTracker &tracker = this->contactEvents[_worldID.id];
+
+  // tpelib reports up to 8 contacts for each pair of collisions that
+  // overlap, and the tracker only keeps one of them
+  for (const auto &c : world->GetContactsRef())
+  {
+    if (filter &&
+        !this->ModelPassesFilter(*filter, c.entity1, c.collision1) &&
+        !this->ModelPassesFilter(*filter, c.entity2, c.collision2))
+    {
+      continue;
+    }
+    tracker.AddContact(
+        this->GetContactCollision(c.entity1, c.collision1).GetId(),
+        this->GetContactCollision(c.entity2, c.collision2).GetId());
+  }
+  tracker.Update();
+  return tracker.View();
+}
+
+/////////////////////////////////////////////////
+bool SimulationFeatures::ModelPassesFilter(const ContactFilter &_filter,
+    std::size_t _modelID, std::size_t _collisionID) const
+{
+  if (_filter.Contains(_modelID))
+    return true;
+  const tpelib::Entity &collision =
+      this->GetContactCollision(_modelID, _collisionID);
+  return _filter.Contains(collision.GetId()) ||
+      (collision.GetParent() &&
+       _filter.Contains(collision.GetParent()->GetId()));
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::RayIntersectionBatch SimulationFeatures::CastWorldRays(
+    const Identity &_worldID,
+    const LinearVector3d *_from,
+    const LinearVector3d *_to,
+    std::size_t _count,
+    std::size_t _numThreads) const
+{
+  GZ_PROFILE("SimulationFeatures::CastWorldRays");
+  const auto &world = this->worlds.at(_worldID)->world;
+
+  this->rayFrom.resize(_count);
+  this->rayTo.resize(_count);
+  for (std::size_t i = 0u; i < _count; ++i)
+  {
+    this->rayFrom[i] = math::eigen3::convert(_from[i]);
+    this->rayTo[i] = math::eigen3::convert(_to[i]);
+  }
+
+  if (_numThreads == 0u)
+    _numThreads = std::max(1u, std::thread::hardware_concurrency());
+  world->CastRays(this->rayFrom.data(), this->rayTo.data(), _count,
+      this->tpeRayHits, _numThreads);
+
+  return this->ConvertRayHits();
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::RayIntersectionBatch SimulationFeatures::CastWorldShapes(
+    const Identity &_worldID,
+    const QueryVolume *_volumes,
+    const LinearVector3d *_to,
+    std::size_t _count,
+    std::size_t _numThreads) const
+{
+  GZ_PROFILE("SimulationFeatures::CastWorldShapes");
+  const auto &world = this->worlds.at(_worldID)->world;
+
+  this->ConvertQueryVolumes(_volumes, _count);
+  this->rayTo.resize(_count);
+  for (std::size_t i = 0u; i < _count; ++i)
+    this->rayTo[i] = math::eigen3::convert(_to[i]);
+
+  if (_numThreads == 0u)
+    _numThreads = std::max(1u, std::thread::hardware_concurrency());
+  world->CastVolumes(this->queryVolumes.data(), this->rayTo.data(), _count,
+      this->tpeRayHits, _numThreads);
+  return this->ConvertRayHits();
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::OverlapBatch SimulationFeatures::FindWorldOverlaps(
+    const Identity &_worldID,
+    const QueryVolume *_volumes,
+    std::size_t _count,
+    std::size_t _numThreads) const
+{
+  GZ_PROFILE("SimulationFeatures::FindWorldOverlaps");
+  const auto &world = this->worlds.at(_worldID)->world;
+
+  this->ConvertQueryVolumes(_volumes, _count);
+  if (_numThreads == 0u)
+    _numThreads = std::max(1u, std::thread::hardware_concurrency());
+  world->FindOverlaps(this->queryVolumes.data(), _count, this->tpeOverlaps,
+      _numThreads);
+  this->overlaps.Assign(this->tpeOverlaps);
+  return this->overlaps.View();
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::ConvertQueryVolumes(
+    const QueryVolume *_volumes, std::size_t _count) const
+{
+  this->queryVolumes.resize(_count);
+  for (std::size_t i = 0u; i < _count; ++i)
+  {
+    tpelib::QueryVolume &volume = this->queryVolumes[i];
+    if (_volumes[i].type == QueryVolume::Type::BOX)
+    {
+      volume.type = tpelib::ShapeType::BOX;
+      volume.size = math::eigen3::convert(_volumes[i].size);
+    }
+    else
+    {
+      volume.type = tpelib::ShapeType::SPHERE;
+      volume.radius = _volumes[i].radius;
+    }
+    volume.pose = math::eigen3::convert(_volumes[i].pose);
+  }
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::RayIntersectionBatch
+SimulationFeatures::ConvertRayHits() const
+{
+  const std::size_t count = this->tpeRayHits.size();
+  this->rayHits.Reset(count);
+  for (std::size_t i = 0u; i < count; ++i)
+  {
+    const tpelib::RayHit &hit = this->tpeRayHits[i];
+    if (hit.entity == tpelib::kNullEntityId)
+      continue;
+    this->rayHits.Set(i, hit.distance, math::eigen3::convert(hit.normal),
+        hit.entity);
+  }
+  return this->rayHits.View();
+}
+
 tpelib::Entity &SimulationFeatures::GetModelCollision(std::size_t _id) const
 {
-  auto m = this->models.at(_id);
+  const auto &m = this->models.at(_id);
   if (!m || !m->model)
     return tpelib::Entity::kNullEntity;
 
@@ -186,3 +973,119 @@ tpelib::Entity &SimulationFeatures::GetModelCollision(std::size_t _id) const
 
   return link.GetChildByIndex(0u);
 }
+
+/////////////////////////////////////////////////
+tpelib::Entity &SimulationFeatures::GetContactCollision(
+    std::size_t _modelID, std::size_t _collisionID) const
+{
+  const auto it = this->collisions.find(_collisionID);
+  if (it != this->collisions.end() && it->second && it->second->collision)
+    return *it->second->collision;
+  return this->GetModelCollision(_modelID);
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::StepStatistics SimulationFeatures::GetWorldStepStatistics(
+  const Identity &_worldID) const
+{
+  const auto &worldInfo = this->worlds.at(_worldID);
+  const tpelib::StepStatistics &stats = worldInfo->world->GetStepStatistics();
+
+  // TPE has no constraint solver, so its solver time is always 0
+  StepStatistics result;
+  result.stepTime = stats.stepTime + worldInfo->poseWriteTime;
+  result.broadphaseTime = stats.collision.broadphaseTime;
+  result.narrowphaseTime = stats.collision.narrowphaseTime;
+  result.integrationTime = stats.integrationTime;
+  result.poseWriteTime = worldInfo->poseWriteTime;
+  result.candidatePairCount = stats.collision.candidatePairCount;
+  result.contactCount = stats.contactCount;
+  result.islandCount = stats.islandCount;
+  result.stepAllocations =
+    stats.stepAllocations + worldInfo->poseWriteAllocations;
+  result.broadphaseAllocations = stats.collision.broadphaseAllocations;
+  result.narrowphaseAllocations = stats.collision.narrowphaseAllocations;
+  result.integrationAllocations = stats.integrationAllocations;
+  result.poseWriteAllocations = worldInfo->poseWriteAllocations;
+  return result;
+}
+
+/////////////////////////////////////////////////
+void SimulationFeatures::SetWorldModelStepStatisticsEnabled(
+  const Identity &_worldID, bool _enable)
+{
+  this->worlds.at(_worldID)->world->SetModelStatistics(_enable);
+}
+
+/////////////////////////////////////////////////
+std::vector<SimulationFeatures::ModelStepStatistics>
+SimulationFeatures::GetWorldModelStepStatistics(
+  const Identity &_worldID) const
+{
+  const auto &worldInfo = this->worlds.at(_worldID);
+  const tpelib::StepStatistics &stats = worldInfo->world->GetStepStatistics();
+
+  // Collisions are checked between models, and TPE has no constraint
+  // solver, so the models have no constraint rows
+  std::vector<ModelStepStatistics> result;
+  result.reserve(stats.collision.entities.size());
+  for (const auto &[id, entity] : stats.collision.entities)
+  {
+    ModelStepStatistics model;
+    model.model = id;
+    model.candidatePairCount = entity.candidatePairCount;
+    model.narrowphaseTime = entity.narrowphaseTime;
+    model.contactCount = entity.contactCount;
+    result.push_back(model);
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Estimate the bytes used by one entry of an info map, including
+/// the tree node, the info struct and its shared_ptr control block.
+template <typename MapT>
+static std::size_t InfoEntryBytes(const MapT &)
+{
+  using InfoT = typename MapT::mapped_type::element_type;
+  return sizeof(typename MapT::value_type) + 4 * sizeof(void *) +
+      sizeof(InfoT) + 2 * sizeof(void *) + sizeof(std::size_t);
+}
+
+/////////////////////////////////////////////////
+SimulationFeatures::MemoryUsage SimulationFeatures::GetWorldMemoryUsage(
+  const Identity &_worldID) const
+{
+  const auto &worldInfo = this->worlds.at(_worldID);
+  const tpelib::MemoryUsage usage = worldInfo->world->GetMemoryUsage();
+
+  MemoryUsage result;
+  result.geometryBytes = usage.geometryBytes;
+  result.solverBytes = usage.solverBytes;
+  result.entityBytes = usage.entityBytes + InfoEntryBytes(this->worlds);
+
+  // Add the plugin's own info entries for the entities of this world
+  const std::size_t parentEntryBytes =
+      sizeof(std::pair<const std::size_t, std::size_t>) + 4 * sizeof(void *);
+  std::vector<const tpelib::Entity *> entities;
+  for (const auto &child : worldInfo->world->GetChildren())
+    entities.push_back(child.second.get());
+  while (!entities.empty())
+  {
+    const tpelib::Entity *entity = entities.back();
+    entities.pop_back();
+    for (const auto &child : entity->GetChildren())
+      entities.push_back(child.second.get());
+
+    const std::size_t id = entity->GetId();
+    if (this->models.find(id) != this->models.end())
+      result.entityBytes += InfoEntryBytes(this->models);
+    else if (this->links.find(id) != this->links.end())
+      result.entityBytes += InfoEntryBytes(this->links);
+    else if (this->collisions.find(id) != this->collisions.end())
+      result.entityBytes += InfoEntryBytes(this->collisions);
+    if (this->childIdToParentId.find(id) != this->childIdToParentId.end())
+      result.entityBytes += parentEntryBytes;
+  }
+  return result;
+}
@@ -18,15 +18,28 @@
 #ifndef GZ_PHYSICS_TPE_PLUGIN_SRC_SIMULATIONFEATURES_HH_
 #define GZ_PHYSICS_TPE_PLUGIN_SRC_SIMULATIONFEATURES_HH_
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 
+#include <gz/common/WorkerPool.hh>
 #include <gz/math/Pose3.hh>
+#include <gz/math/Vector3.hh>
 
 #include <gz/physics/CanWriteData.hh>
 #include <gz/physics/ForwardStep.hh>
 #include <gz/physics/GetContacts.hh>
+#include <gz/physics/ModelUpdateRate.hh>
+#include <gz/physics/RayIntersection.hh>
+#include <gz/physics/ShapeQueries.hh>
 #include <gz/physics/SpecifyData.hh>
+#include <gz/physics/TaskScheduler.hh>
+#include <gz/physics/Trajectory.hh>
+#include <gz/physics/World.hh>
+#include <gz/physics/WorldPlacement.hh>
 
 #include "Base.hh"
 
@@ -36,7 +49,24 @@ namespace tpeplugin {
 
 struct SimulationFeatureList : FeatureList<
   ForwardStep,
-  GetContactsFromLastStepFeature
+  StepWorldsFeature,
+  AsyncForwardStepFeature,
+  GetContactsFromLastStepFeature,
+  ContactFilterFeature,
+  ContactEventsFeature,
+  WorldStateSnapshotFeature,
+  GetStepStatisticsFeature,
+  GetModelStepStatisticsFeature,
+  GetMemoryUsageFeature,
+  ParallelPoseWriteFeature,
+  DeterministicStepFeature,
+  RayIntersectionFeature,
+  ShapeQueryFeature,
+  ModelTrajectoryFeature,
+  ModelUpdateRateFeature,
+  CollisionPairMaxContacts,
+  TaskSchedulerFeature,
+  WorldPlacementFeature
 > { };
 
 class SimulationFeatures :
@@ -45,26 +75,301 @@ class SimulationFeatures :
   public virtual Base,
   public virtual Implements3d<SimulationFeatureList>
 {
+  public: using ContactFilter =
+    ContactFilterFeature::Implementation<FeaturePolicy3d>::ContactFilter;
+  public: using ContactEventBatch = ContactEventsFeature::ContactEventBatch;
+  public: using ContactEventTracker =
+    ContactEventsFeature::Implementation<FeaturePolicy3d>::ContactEventTracker;
+  public: using Snapshot = WorldStateSnapshotFeature::Snapshot;
+  public: using StepStatistics = GetStepStatisticsFeature::StepStatistics;
+  public: using ModelStepStatistics =
+    GetModelStepStatisticsFeature::ModelStepStatistics;
+  public: using MemoryUsage = GetMemoryUsageFeature::MemoryUsage;
+  public: using RayIntersectionBatch =
+    RayIntersectionFeature::RayIntersectionBatchT<FeaturePolicy3d>;
+  public: using QueryVolume =
+    ShapeQueryFeature::QueryVolumeT<FeaturePolicy3d>;
+  public: using OverlapBatch =
+    ShapeQueryFeature::OverlapBatchT<FeaturePolicy3d>;
+  public: using Waypoint = ModelTrajectoryFeature::WaypointT<FeaturePolicy3d>;
+
   public: void WorldForwardStep(
     const Identity &_worldID,
     ForwardStep::Output &_h,
     ForwardStep::State &_x,
     const ForwardStep::Input &_u) override;
 
+  public: void StepEngineWorlds(
+    const Identity &_engineID,
+    const std::size_t *_worldIDs,
+    std::size_t _count,
+    ForwardStep::Output &_h,
+    ForwardStep::State &_x,
+    const ForwardStep::Input &_u,
+    std::size_t _numThreads) override;
+
+  public: std::shared_future<void> StartWorldStep(
+    const Identity &_worldID,
+    const ForwardStep::Input &_u) override;
+
+  public: const ForwardStep::Output &FinishWorldStep(
+    const Identity &_worldID) override;
+
   public: void Write(ChangedWorldPoses &_changedPoses) const;
 
+  public: void Write(WorldTwists &_twists) const;
+
+  public: void Write(ChangedWorldTwists &_changedTwists,
+    const ChangedWorldPoses &_changedPoses) const;
+
   public: std::vector<ContactInternal> GetContactsFromLastStep(
     const Identity &_worldID) const override;
 
+  public: void SetWorldContactFilter(
+    const Identity &_worldID,
+    const std::vector<std::size_t> &_entities) override;
+
+  public: std::vector<std::size_t> GetWorldContactFilter(
+    const Identity &_worldID) const override;
+
+  public: ContactEventBatch GetContactEvents(
+    const Identity &_worldID) const override;
+
+  public: Snapshot GetWorldStateSnapshot(
+    const Identity &_worldID) const override;
+
+  public: bool SetWorldStateSnapshot(
+    const Identity &_worldID, const Snapshot &_snapshot) override;
+
+  public: StepStatistics GetWorldStepStatistics(
+    const Identity &_worldID) const override;
+
+  public: void SetWorldModelStepStatisticsEnabled(
+    const Identity &_worldID, bool _enable) override;
+
+  public: std::vector<ModelStepStatistics> GetWorldModelStepStatistics(
+    const Identity &_worldID) const override;
+
+  public: MemoryUsage GetWorldMemoryUsage(
+    const Identity &_worldID) const override;
+
+  public: void SetEnginePoseWriteThreads(
+    const Identity &_engineID,
+    std::size_t _numThreads,
+    std::size_t _minLinks) override;
+
+  public: std::size_t GetEnginePoseWriteThreads(
+    const Identity &_engineID) const override;
+
+  public: std::size_t GetEnginePoseWriteMinLinks(
+    const Identity &_engineID) const override;
+
+  public: void SetEngineDeterministic(
+    const Identity &_engineID, bool _deterministic) override;
+
+  public: bool GetEngineDeterministic(
+    const Identity &_engineID) const override;
+
+  public: void SetEngineTaskScheduler(
+    const Identity &_engineID,
+    std::shared_ptr<TaskScheduler> _scheduler) override;
+
+  public: std::shared_ptr<TaskScheduler> GetEngineTaskScheduler(
+    const Identity &_engineID) const override;
+
+  public: void SetWorldPlacement(
+    const Identity &_worldID, const WorldPlacement &_placement) override;
+
+  public: WorldPlacement GetWorldPlacement(
+    const Identity &_worldID) const override;
+
+  public: RayIntersectionBatch CastWorldRays(
+    const Identity &_worldID,
+    const LinearVector3d *_from,
+    const LinearVector3d *_to,
+    std::size_t _count,
+    std::size_t _numThreads) const override;
+
+  public: RayIntersectionBatch CastWorldShapes(
+    const Identity &_worldID,
+    const QueryVolume *_volumes,
+    const LinearVector3d *_to,
+    std::size_t _count,
+    std::size_t _numThreads) const override;
+
+  public: OverlapBatch FindWorldOverlaps(
+    const Identity &_worldID,
+    const QueryVolume *_volumes,
+    std::size_t _count,
+    std::size_t _numThreads) const override;
+
+  public: bool SetModelTrajectory(
+    const Identity &_modelID,
+    const std::vector<Waypoint> &_waypoints,
+    ModelTrajectoryFeature::Interpolation _interpolation) override;
+
+  public: void ClearModelTrajectory(const Identity &_modelID) override;
+
+  public: bool GetModelHasTrajectory(
+    const Identity &_modelID) const override;
+
+  public: void SetModelUpdateRate(
+    const Identity &_modelID, double _rate) override;
+
+  public: double GetModelUpdateRate(
+    const Identity &_modelID) const override;
+
+  public: void SetWorldCollisionPairMaxContacts(
+    const Identity &_id, std::size_t _maxContacts) override;
+
+  public: std::size_t GetWorldCollisionPairMaxContacts(
+    const Identity &_id) const override;
+
+  /// \brief Write the twists requested by the output of a step, if any.
+  /// Must be called after the changed poses of the step are written.
+  /// \param[in] _h Output of the step.
+  private: void WriteTwists(ForwardStep::Output &_h) const;
+
+  /// \brief Get the world velocity of a link, as reported by
+  /// FrameDataRelativeToWorld.
+  /// \param[in] _link Link to get the velocity of.
+  /// \param[out] _twist Twist to write the velocity to.
+  private: void LinkWorldTwist(
+    const tpelib::Link &_link, WorldTwist &_twist) const;
+
+  /// \brief Convert query volumes for tpelib into queryVolumes
+  /// \param[in] _volumes Volumes to convert
+  /// \param[in] _count Number of volumes
+  private: void ConvertQueryVolumes(
+    const QueryVolume *_volumes, std::size_t _count) const;
+
+  /// \brief Fill rayHits from tpeRayHits
+  /// \return View of rayHits
+  private: RayIntersectionBatch ConvertRayHits() const;
+
+  /// \brief Find the contact filter of a world.
+  /// \param[in] _worldID World to get the filter of.
+  /// \return The filter, or nullptr if the world reports all contacts.
+  private: const ContactFilter *FindContactFilter(
+    const Identity &_worldID) const;
+
+  /// \brief Check whether a side of a contact passes a contact filter.
+  /// \param[in] _filter Filter of the world
+  /// \param[in] _modelID Model ID
+  /// \param[in] _collisionID Collision ID of the contact, see
+  /// GetContactCollision
+  /// \return True if the model, or its collision or link, is in _filter
+  private: bool ModelPassesFilter(const ContactFilter &_filter,
+    std::size_t _modelID, std::size_t _collisionID) const;
+
   /// \brief Get a collision from the canonical link of a model
   /// \param[in] _id Model ID
   /// \return Collision entity
   private: tpelib::Entity &GetModelCollision(std::size_t _id) const;
 
-  /// \brief entity poses from the most recent pose change/update.
-  /// The key is the entity's ID, and the value is the entity's pose
-  private: mutable std::unordered_map<std::size_t, math::Pose3d>
-     prevEntityPoses;
+  /// \brief Get the collision of a side of a contact. tpelib names the
+  /// collisions in contact when shape contacts are enabled, and only the
+  /// models otherwise, in which case the first collision of the canonical
+  /// link of the model is used.
+  /// \param[in] _modelID Model ID
+  /// \param[in] _collisionID Collision ID, kNullEntityId if unknown
+  /// \return Collision entity
+  private: tpelib::Entity &GetContactCollision(
+    std::size_t _modelID, std::size_t _collisionID) const;
+
+  /// \brief Set the time step of a world from the input of a step, if the
+  /// input has one.
+  /// \param[in] _world World to update.
+  /// \param[in] _u Input of the step.
+  private: void UpdateTimeStep(
+    tpelib::World &_world, const ForwardStep::Input &_u) const;
+
+  /// \brief Thread pool used by StepEngineWorlds without a task
+  /// scheduler. Created on first use.
+  private: std::unique_ptr<gz::common::WorkerPool> stepWorldsPool;
+
+  /// \brief Number of threads of stepWorldsPool.
+  private: std::size_t stepWorldsPoolThreads = 0;
+
+  /// \brief Threads and memory of the placed worlds with the same cores
+  private: struct Placement
+  {
+    /// \brief Threads pinned to the cores
+    std::shared_ptr<ThreadPoolTaskScheduler> scheduler;
+
+    /// \brief Arena whose blocks are first written by the threads
+    std::shared_ptr<ArenaMemoryResource> arena;
+  };
+
+  /// \brief Placements of the worlds, by their cores
+  private: std::map<std::vector<std::size_t>, Placement> placements;
+
+  /// \brief Runs the groups of placed worlds, and the worlds that are not
+  /// placed, concurrently in StepEngineWorlds. Created on first use.
+  private: std::unique_ptr<ThreadPoolTaskScheduler> placementDispatch;
+
+  /// \brief Settings, threads and buffers of the parallel pose write-out.
+  private: mutable ParallelPoseWriteFeature::Implementation<
+      FeaturePolicy3d>::PoseWriter poseWriter;
+
+  /// \brief Links of the parallel pose write-out, flattened so that ranges
+  /// of them can be handed to the pose write threads.
+  private: mutable std::vector<std::pair<std::size_t, LinkInfo *>>
+     poseWriteLinks;
+
+  /// \brief Number of calls to Write(ChangedWorldPoses &), see
+  /// LinkInfo::reportedWrite.
+  private: mutable std::size_t poseWriteCount = 0u;
+
+  /// \brief Contact filters by world ID, for worlds that have one. See
+  /// ContactFilterFeature.
+  private: std::unordered_map<std::size_t, ContactFilter> contactFilters;
+
+  /// \brief Pairs in contact and events by world ID, for worlds whose
+  /// events were requested. See ContactEventsFeature.
+  private: mutable std::unordered_map<std::size_t, ContactEventTracker>
+     contactEvents;
+
+  /// \brief Whether worlds are stepped deterministically, see
+  /// DeterministicStepFeature. tpelib integrates models in fixed chunks and
+  /// links are kept ordered by ID, so this only sorts the contacts.
+  private: bool deterministic = false;
+
+  /// \brief Hits of the most recent CastWorldRays or CastWorldShapes call.
+  private: mutable RayIntersectionStorage rayHits;
+
+  /// \brief Ray ends of the most recent CastWorldRays call, converted for
+  /// tpelib.
+  private: mutable std::vector<math::Vector3d> rayFrom;
+
+  /// \brief See rayFrom.
+  private: mutable std::vector<math::Vector3d> rayTo;
+
+  /// \brief Hits reported by tpelib for the most recent CastWorldRays or
+  /// CastWorldShapes call.
+  private: mutable std::vector<tpelib::RayHit> tpeRayHits;
+
+  /// \brief Volumes of the most recent CastWorldShapes or FindWorldOverlaps
+  /// call, converted for tpelib.
+  private: mutable std::vector<tpelib::QueryVolume> queryVolumes;
+
+  /// \brief Collisions overlapping each volume of the most recent
+  /// FindWorldOverlaps call.
+  private: mutable std::vector<std::vector<std::size_t>> tpeOverlaps;
+
+  /// \brief Buffers backing the views returned by FindWorldOverlaps.
+  private: mutable OverlapStorage overlaps;
+
+  /// \brief Steppers of the worlds stepped through AsyncForwardStepFeature.
+  /// Declared last, so the steps in flight finish before the other members
+  /// are destroyed.
+  private: AsyncForwardStepFeature::Implementation<FeaturePolicy3d>::
+      AsyncSteppers asyncSteppers{
+          [this](const Identity &_worldID, ForwardStep::Output &_h,
+                 ForwardStep::State &_x, const ForwardStep::Input &_u)
+          {
+            this->WorldForwardStep(_worldID, _h, _x, _u);
+          }};
 };
 
 }
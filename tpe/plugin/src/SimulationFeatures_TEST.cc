@@ -481,6 +481,52 @@ TEST_P(SimulationFeatures_TEST, FreeGroup)
   }
 }
 
+TEST_P(SimulationFeatures_TEST, ModelTrajectory)
+{
+  const std::string library = GetParam();
+  if (library.empty())
+    return;
+
+  const auto worlds = LoadWorlds(library, common_test::worlds::kShapesWorld);
+
+  for (const auto &world : worlds)
+  {
+    auto model = world->GetModel("sphere");
+    ASSERT_NE(nullptr, model);
+    EXPECT_FALSE(model->HasTrajectory());
+
+    using Waypoint = physics::ModelTrajectoryFeature::WaypointT<
+        physics::FeaturePolicy3d>;
+    EXPECT_FALSE(model->SetTrajectory({}));
+    EXPECT_FALSE(model->HasTrajectory());
+
+    // a slow straight line along x, far above the other shapes
+    Waypoint start;
+    start.time = 0.0;
+    start.pose = math::eigen3::convert(math::Pose3d(0, 0, 20, 0, 0, 0));
+    Waypoint end;
+    end.time = 1000.0;
+    end.pose = math::eigen3::convert(math::Pose3d(1000, 0, 20, 0, 0, 0));
+    ASSERT_TRUE(model->SetTrajectory({start, end}));
+    EXPECT_TRUE(model->HasTrajectory());
+
+    StepWorld(world, true, 10);
+    auto frameData = model->GetLink(0)->FrameDataRelativeToWorld();
+    const math::Pose3d pose = math::eigen3::convert(frameData.pose);
+    EXPECT_GT(pose.Pos().X(), 0.0);
+    EXPECT_NEAR(20.0, pose.Pos().Z(), 1e-6);
+    EXPECT_NEAR(1.0, math::eigen3::convert(frameData.linearVelocity).X(),
+        1e-6);
+
+    // clearing the trajectory stops the model
+    model->ClearTrajectory();
+    EXPECT_FALSE(model->HasTrajectory());
+    StepWorld(world, false);
+    frameData = model->GetLink(0)->FrameDataRelativeToWorld();
+    EXPECT_NEAR(pose.Pos().X(), frameData.pose.translation().x(), 1e-6);
+  }
+}
+
 TEST_P(SimulationFeatures_TEST, NestedFreeGroup)
 {
   const std::string library = GetParam();